@@ -8,7 +8,8 @@
 @echo off
 @setlocal
 
-set QLT=-q 9 -w 22
+set QLT=-q 9
+set WIN=-w 22
 set ARGS=
 
 :Begin
@@ -46,10 +47,24 @@ if "%1"=="-q" (
   goto Begin
 )
 
+if "%1"=="-w" (
+  set WIN=%1 %2
+  shift
+  shift
+  goto Begin
+)
+
+if "%1"=="-D" (
+  set ARGS=%ARGS% %1 %2
+  shift
+  shift
+  goto Begin
+)
+
 set ARGS=%ARGS% %1
 shift
 goto Begin
 
 :End
-Brotli %QLT% %ARGS%
+Brotli %QLT% %WIN% %ARGS%
 @echo on
@@ -0,0 +1,118 @@
+## @file
+# Generate a raw Brotli dictionary from the images of a platform.
+#
+# The chunks that appear in the most images are kept, up to the size budget.
+# Brotli prefers the short distances, so the most useful chunks are stored
+# at the end of the dictionary.
+#
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+'''
+GenBrotliDictionary
+'''
+from __future__ import print_function
+
+import sys
+import argparse
+
+#
+# Globals for help information
+#
+__prog__        = 'GenBrotliDictionary'
+__copyright__   = 'Copyright (c) Microsoft Corporation. All rights reserved.'
+__description__ = 'Generate a raw Brotli dictionary from the content shared by several images.\n'
+
+def GenerateDictionary (Images, ChunkSize, Stride, MaxSize):
+    #
+    # Count the images each chunk appears in, and its total number of uses.
+    #
+    Count = {}
+    for Image in Images:
+        Seen = set ()
+        for Offset in range (0, len (Image) - ChunkSize + 1, Stride):
+            Chunk = Image[Offset:Offset + ChunkSize]
+            if Chunk.count (Chunk[0:1]) == ChunkSize:
+                #
+                # Runs of a single byte are cheap for the compressor already.
+                #
+                continue
+            Files, Uses = Count.get (Chunk, (0, 0))
+            if Chunk not in Seen:
+                Seen.add (Chunk)
+                Files += 1
+            Count[Chunk] = (Files, Uses + 1)
+
+    Candidates = [(Files, Uses, Chunk) for Chunk, (Files, Uses) in Count.items () if Files > 1]
+    Candidates.sort (key = lambda Item: (Item[0], Item[1]), reverse = True)
+
+    #
+    # The chunks overlap with the stride, skip the ones mostly held already.
+    #
+    Selected = []
+    Window   = ChunkSize // 2
+    for Files, Uses, Chunk in Candidates:
+        if len (Selected) >= MaxSize // ChunkSize:
+            break
+        if any (Chunk[:Window] in Other or Chunk[-Window:] in Other for Other in Selected):
+            continue
+        Selected.append (Chunk)
+    Selected.reverse ()
+    return b''.join (Selected)
+
+if __name__ == '__main__':
+    def ValidateUnsignedInteger (Argument):
+        try:
+            Value = int (Argument, 0)
+        except:
+            Message = '{Argument} is not a valid integer value.'.format (Argument = Argument)
+            raise argparse.ArgumentTypeError (Message)
+        if Value <= 0:
+            Message = '{Argument} is not a positive value.'.format (Argument = Argument)
+            raise argparse.ArgumentTypeError (Message)
+        return Value
+
+    #
+    # Create command line argument parser object
+    #
+    parser = argparse.ArgumentParser (prog = __prog__,
+                                      description = __description__ + __copyright__,
+                                      conflict_handler = 'resolve')
+    parser.add_argument ("-i", "--input", dest = 'InputFile', type = argparse.FileType ('rb'), action='append', required = True,
+                         help = "Input image filename.  This option may be given more than once.")
+    parser.add_argument ("-o", "--output", dest = 'OutputFile', type = argparse.FileType ('wb'), required = True,
+                         help = "Output dictionary filename.")
+    parser.add_argument ("-s", "--max-size", dest = 'MaxSize', type = ValidateUnsignedInteger, default = 0x8000,
+                         help = "Maximum size of the dictionary in bytes.  Default is 0x8000.")
+    parser.add_argument ("-c", "--chunk-size", dest = 'ChunkSize', type = ValidateUnsignedInteger, default = 64,
+                         help = "Size of the chunks in bytes.  Default is 64.")
+    parser.add_argument ("--stride", dest = 'Stride', type = ValidateUnsignedInteger, default = 16,
+                         help = "Distance in bytes between two chunks of an image.  Default is 16.")
+    parser.add_argument ("-v", "--verbose", dest = 'Verbose', action = "store_true",
+                         help = "Increase output messages")
+
+    #
+    # Parse command line arguments
+    #
+    args = parser.parse_args ()
+
+    Images = []
+    for File in args.InputFile:
+        try:
+            Images.append (File.read ())
+            File.close ()
+        except:
+            print ('GenBrotliDictionary: error: can not read binary input file {File}'.format (File = File))
+            sys.exit (1)
+
+    Dictionary = GenerateDictionary (Images, args.ChunkSize, args.Stride, args.MaxSize)
+    if args.Verbose:
+        print ('GenBrotliDictionary: {Size:#x} bytes from {Count} images'.format (Size = len (Dictionary), Count = len (Images)))
+
+    try:
+        args.OutputFile.write (Dictionary)
+        args.OutputFile.close ()
+    except:
+        print ('GenBrotliDictionary: error: can not write binary output file {File}'.format (File = args.OutputFile))
+        sys.exit (1)
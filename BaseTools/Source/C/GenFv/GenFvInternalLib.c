@@ -41,12 +41,19 @@ BOOLEAN mArm = FALSE;
 BOOLEAN mRiscV = FALSE;
 STATIC UINT32   MaxFfsAlignment = 0;
 BOOLEAN VtfFileFlag = FALSE;
+STATIC UINTN    mFvPadSize = 0;
+STATIC UINT32   mFvPadFileCount = 0;
+STATIC UINT32   mFvFileIndexSize = 0;
 
 EFI_GUID  mEfiFirmwareVolumeTopFileGuid       = EFI_FFS_VOLUME_TOP_FILE_GUID;
 EFI_GUID  mFileGuidArray [MAX_NUMBER_OF_FILES_IN_FV];
+STATIC UINT32 mFileOffsetArray [MAX_NUMBER_OF_FILES_IN_FV];
 EFI_GUID  mZeroGuid                           = {0x0, 0x0, 0x0, {0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0}};
 EFI_GUID  mDefaultCapsuleGuid                 = {0x3B6686BD, 0x0D76, 0x4030, { 0xB7, 0x0E, 0xB5, 0x51, 0x9E, 0x2F, 0xC5, 0xA0 }};
 EFI_GUID  mEfiFfsSectionAlignmentPaddingGuid  = EFI_FFS_SECTION_ALIGNMENT_PADDING_GUID;
+EFI_GUID  mPeiAprioriFileGuid                 = {0x1B45CC0A, 0x156A, 0x428A, { 0xAF, 0x62, 0x49, 0x86, 0x4D, 0xA0, 0xE6, 0xE6 }};
+EFI_GUID  mDxeAprioriFileGuid                 = {0xFC510EE7, 0xFFDC, 0x11D4, { 0xBD, 0x41, 0x00, 0x80, 0xC7, 0x3C, 0x88, 0x81 }};
+EFI_GUID  mFvFileIndexGuid                    = EDKII_FV_FILE_INDEX_GUID;
 
 CHAR8      *mFvbAttributeName[] = {
   EFI_FVB2_READ_DISABLED_CAP_STRING,
@@ -296,6 +303,32 @@ Returns:
     }
   }
 
+  //
+  // Read placement optimization flag
+  //
+  Status = FindToken (InfFile, ATTRIBUTES_SECTION_STRING, EFI_FV_OPTIMIZE_PLACEMENT_STRING, 0, Value);
+  if (Status == EFI_SUCCESS) {
+    if ((strcmp (Value, TRUE_STRING) == 0) || (strcmp (Value, ONE_STRING) == 0)) {
+      FvInfo->OptimizePlacement = TRUE;
+    } else if ((strcmp (Value, FALSE_STRING) != 0) && (strcmp (Value, ZERO_STRING) != 0)) {
+      Error (NULL, 0, 2000, "Invalid parameter", "Optimize placement value expected one of TRUE, FALSE, 1 or 0.");
+      return EFI_ABORTED;
+    }
+  }
+
+  //
+  // Read file index flag
+  //
+  Status = FindToken (InfFile, ATTRIBUTES_SECTION_STRING, EFI_FV_FILE_INDEX_STRING, 0, Value);
+  if (Status == EFI_SUCCESS) {
+    if ((strcmp (Value, TRUE_STRING) == 0) || (strcmp (Value, ONE_STRING) == 0)) {
+      FvInfo->FileIndex = TRUE;
+    } else if ((strcmp (Value, FALSE_STRING) != 0) && (strcmp (Value, ZERO_STRING) != 0)) {
+      Error (NULL, 0, 2000, "Invalid parameter", "File index value expected one of TRUE, FALSE, 1 or 0.");
+      return EFI_ABORTED;
+    }
+  }
+
   //
   // Read block maps
   //
@@ -1202,6 +1235,7 @@ Returns:
   EFI_STATUS            Status;
   UINTN                 Index1;
   UINT8                 FileGuidString[PRINTED_GUID_BUFFER_SIZE];
+  CHAR8                 *PadStart;
 
   Index1 = 0;
   //
@@ -1346,6 +1380,7 @@ Returns:
       // copy VTF File
       //
       memcpy (*VtfFileImage, FileBuffer, FileSize);
+      mFileOffsetArray [Index] = (UINT32) ((UINTN) *VtfFileImage - (UINTN) FvImage->FileImage);
 
       PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
       fprintf (FvReportFile, "0x%08X %s\n", (unsigned)(UINTN) (((UINT8 *)*VtfFileImage) - (UINTN)FvImage->FileImage), FileGuidString);
@@ -1368,12 +1403,17 @@ Returns:
   //
   if (!AdjustInternalFfsPadding ((EFI_FFS_FILE_HEADER *) FileBuffer, FvImage,
          1 << CurrentFileAlignment, &FileSize)) {
+    PadStart = FvImage->CurrentFilePointer;
     Status = AddPadFile (FvImage, 1 << CurrentFileAlignment, *VtfFileImage, NULL, FileSize);
     if (EFI_ERROR (Status)) {
       Error (NULL, 0, 4002, "Resource", "FV space is full, could not add pad file for data alignment property.");
       free (FileBuffer);
       return EFI_ABORTED;
     }
+    if (FvImage->CurrentFilePointer != PadStart) {
+      mFvPadSize += (UINTN) (FvImage->CurrentFilePointer - PadStart);
+      mFvPadFileCount++;
+    }
   }
   //
   // Add file
@@ -1392,6 +1432,7 @@ Returns:
     // Copy the file
     //
     memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
+    mFileOffsetArray [Index] = (UINT32) ((UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage);
     PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
     fprintf (FvReportFile, "0x%08X %s\n", (unsigned) (FvImage->CurrentFilePointer - FvImage->FileImage), FileGuidString);
     FvImage->CurrentFilePointer += FileSize;
@@ -2492,6 +2533,465 @@ Returns:
   return EFI_SUCCESS;
 }
 
+STATIC
+UINTN
+GetPlacementPadSize (
+  IN UINTN                Offset,
+  IN FFS_PLACEMENT_INFO   *File
+  )
+/*++
+
+Routine Description:
+
+  This function returns the size of the pad file that AddPadFile inserts
+  before a FFS file placed at the given offset of the FV.
+
+Arguments:
+
+  Offset        The offset of the FFS file in the FV.
+  File          The placement information of the FFS file.
+
+Returns:
+
+  The size of the pad file, zero when no pad file is needed.
+
+--*/
+{
+  if (((Offset + File->HeaderSize) % File->Alignment) == 0) {
+    return 0;
+  }
+  return ((Offset + File->HeaderSize + sizeof (EFI_FFS_FILE_HEADER) + File->Alignment - 1) & ~((UINTN) File->Alignment - 1)) -
+         File->HeaderSize - Offset;
+}
+
+STATIC
+UINTN
+GetPlacementPadTotal (
+  IN UINTN                Offset,
+  IN FFS_PLACEMENT_INFO   *Files,
+  IN UINTN                *Order,
+  IN UINTN                Count
+  )
+/*++
+
+Routine Description:
+
+  This function returns the total size of the pad files of a FFS file order.
+
+Arguments:
+
+  Offset        The offset of the first FFS file in the FV.
+  Files         The placement information of the FFS files.
+  Order         The indexes of the FFS files, in the placement order.
+  Count         The number of FFS files.
+
+Returns:
+
+  The total size of the pad files.
+
+--*/
+{
+  UINTN   Index;
+  UINTN   PadSize;
+  UINTN   PadTotal;
+
+  PadTotal = 0;
+  for (Index = 0; Index < Count; Index++) {
+    PadSize   = GetPlacementPadSize (Offset, &Files[Order[Index]]);
+    PadTotal += PadSize;
+    Offset   += PadSize + Files[Order[Index]].Size;
+  }
+  return PadTotal;
+}
+
+STATIC
+EFI_STATUS
+OptimizeFilePlacement (
+  IN OUT FV_INFO                          *FvInfo,
+  IN     EFI_FIRMWARE_VOLUME_EXT_HEADER   *ExtHeader
+  )
+/*++
+
+Routine Description:
+
+  This function reorders the FFS files of the FV to reduce the size of the pad
+  files inserted for their data alignment.
+
+  The files that must keep their position are pinned: the XIP files (SEC, PEI
+  core and PEIMs, whose order is the PEI dispatch order), the apriori files,
+  the files with the FFS_ATTRIB_FIXED attribute and the VTF file. The other
+  files are only reordered between two pinned files. Among them, a file with a
+  large alignment is placed as soon as it needs no pad file, and the gap before
+  its next aligned offset is filled with the largest files that fit.
+
+  The order of the files without apriori ordering changes the DXE dispatch
+  order when several drivers have their dependencies satisfied.
+
+Arguments:
+
+  FvInfo        Pointer to information about the FV, its file list is updated.
+  ExtHeader     PI FvExtHeader Optional
+
+Returns:
+
+  EFI_SUCCESS              The function completed successfully.
+  EFI_ABORTED              A FFS file could not be read.
+  EFI_OUT_OF_RESOURCES     Memory could not be allocated.
+
+--*/
+{
+  EFI_STATUS              Status;
+  FILE                    *FfsFile;
+  EFI_FFS_FILE_HEADER     FfsHeader;
+  UINTN                   FileSize;
+  UINT32                  Alignment;
+  UINTN                   Count;
+  UINTN                   Index;
+  UINTN                   Start;
+  UINTN                   End;
+  UINTN                   Placed;
+  UINTN                   Best;
+  UINTN                   Next;
+  UINTN                   Gap;
+  UINTN                   PadSize;
+  UINTN                   Offset;
+  UINTN                   StartOffset;
+  UINTN                   OriginalPadSize;
+  UINTN                   OptimizedPadSize;
+  FFS_PLACEMENT_INFO      *Files;
+  UINTN                   *Order;
+  UINTN                   *OriginalOrder;
+  BOOLEAN                 *IsPlaced;
+  CHAR8                   (*FileNames)[MAX_LONG_FILE_PATH];
+  UINT32                  *FileTakenSizes;
+
+  for (Count = 0; Count < MAX_NUMBER_OF_FILES_IN_FV && FvInfo->FvFiles[Count][0] != 0; Count++) {
+  }
+  if (Count < 2) {
+    return EFI_SUCCESS;
+  }
+
+  Status         = EFI_SUCCESS;
+  Files          = calloc (Count, sizeof (FFS_PLACEMENT_INFO));
+  Order          = calloc (Count, sizeof (UINTN));
+  OriginalOrder  = calloc (Count, sizeof (UINTN));
+  IsPlaced       = calloc (Count, sizeof (BOOLEAN));
+  FileNames      = NULL;
+  FileTakenSizes = NULL;
+  if (Files == NULL || Order == NULL || OriginalOrder == NULL || IsPlaced == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
+  //
+  // Offset of the first file, as computed by CalculateFvSize
+  //
+  StartOffset = sizeof (EFI_FIRMWARE_VOLUME_HEADER);
+  for (Index = 1;; Index ++) {
+    StartOffset += sizeof (EFI_FV_BLOCK_MAP_ENTRY);
+    if (FvInfo->FvBlocks[Index].NumBlocks == 0 || FvInfo->FvBlocks[Index].Length == 0) {
+      break;
+    }
+  }
+  if (ExtHeader != NULL) {
+    if (sizeof (EFI_FFS_FILE_HEADER) + ExtHeader->ExtHeaderSize >= MAX_FFS_SIZE) {
+      StartOffset += sizeof (EFI_FFS_FILE_HEADER2) + ExtHeader->ExtHeaderSize;
+    } else {
+      StartOffset += sizeof (EFI_FFS_FILE_HEADER) + ExtHeader->ExtHeaderSize;
+    }
+    StartOffset = (StartOffset + 7) & (~7);
+  }
+
+  //
+  // Read the size, the alignment and the type of the files
+  //
+  for (Index = 0; Index < Count; Index++) {
+    FfsFile = fopen (LongFilePath (FvInfo->FvFiles[Index]), "rb");
+    if (FfsFile == NULL) {
+      Error (NULL, 0, 0001, "Error opening file", FvInfo->FvFiles[Index]);
+      Status = EFI_ABORTED;
+      goto Finish;
+    }
+    FileSize = _filelength (fileno (FfsFile));
+    if (fread (&FfsHeader, sizeof (EFI_FFS_FILE_HEADER), 1, FfsFile) != 1) {
+      fclose (FfsFile);
+      Error (NULL, 0, 0004, "Error reading file", FvInfo->FvFiles[Index]);
+      Status = EFI_ABORTED;
+      goto Finish;
+    }
+    fclose (FfsFile);
+
+    OriginalOrder[Index] = Index;
+    if (IsVtfFile (&FfsHeader)) {
+      //
+      // The VTF file is placed at the end of the FV
+      //
+      Files[Index].Size       = 0;
+      Files[Index].HeaderSize = sizeof (EFI_FFS_FILE_HEADER);
+      Files[Index].Alignment  = 1;
+      Files[Index].Pinned     = TRUE;
+      continue;
+    }
+
+    if (FvInfo->SizeofFvFiles[Index] > FileSize) {
+      FileSize = FvInfo->SizeofFvFiles[Index];
+    }
+    ReadFfsAlignment (&FfsHeader, &Alignment);
+    Files[Index].Size       = (FileSize + EFI_FFS_FILE_HEADER_ALIGNMENT - 1) & ~(EFI_FFS_FILE_HEADER_ALIGNMENT - 1);
+    Files[Index].HeaderSize = (FileSize >= MAX_FFS_SIZE) ? sizeof (EFI_FFS_FILE_HEADER2) : sizeof (EFI_FFS_FILE_HEADER);
+    Files[Index].Alignment  = 1 << Alignment;
+    Files[Index].Pinned     = (BOOLEAN) (FfsHeader.Type == EFI_FV_FILETYPE_SECURITY_CORE ||
+                                         FfsHeader.Type == EFI_FV_FILETYPE_PEI_CORE ||
+                                         FfsHeader.Type == EFI_FV_FILETYPE_PEIM ||
+                                         FfsHeader.Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER ||
+                                         (FfsHeader.Attributes & FFS_ATTRIB_FIXED) != 0 ||
+                                         CompareGuid (&FfsHeader.Name, &mPeiAprioriFileGuid) == 0 ||
+                                         CompareGuid (&FfsHeader.Name, &mDxeAprioriFileGuid) == 0);
+  }
+
+  //
+  // Reorder the files between two pinned files
+  //
+  Offset = StartOffset;
+  Placed = 0;
+  for (Start = 0; Start < Count; Start = End + 1) {
+    for (End = Start; End < Count && !Files[End].Pinned; End++) {
+    }
+
+    while (Placed < End) {
+      //
+      // Place the file with the largest alignment that needs no pad file
+      //
+      Best = Count;
+      for (Index = Start; Index < End; Index++) {
+        if (!IsPlaced[Index] && Files[Index].Alignment > EFI_FFS_FILE_HEADER_ALIGNMENT &&
+            GetPlacementPadSize (Offset, &Files[Index]) == 0 &&
+            (Best == Count || Files[Index].Alignment > Files[Best].Alignment)) {
+          Best = Index;
+        }
+      }
+
+      if (Best == Count) {
+        //
+        // Find the aligned file with the smallest gap, and fill the gap with
+        // the largest file that leaves an empty gap or room for a pad file.
+        //
+        Next = Count;
+        Gap  = 0;
+        for (Index = Start; Index < End; Index++) {
+          if (!IsPlaced[Index] && Files[Index].Alignment > EFI_FFS_FILE_HEADER_ALIGNMENT) {
+            PadSize = GetPlacementPadSize (Offset, &Files[Index]);
+            if (Next == Count || PadSize < Gap) {
+              Next = Index;
+              Gap  = PadSize;
+            }
+          }
+        }
+        for (Index = Start; Index < End; Index++) {
+          if (!IsPlaced[Index] && Files[Index].Alignment <= EFI_FFS_FILE_HEADER_ALIGNMENT &&
+              (Next == Count || Files[Index].Size == Gap || Files[Index].Size + sizeof (EFI_FFS_FILE_HEADER) <= Gap) &&
+              (Best == Count || (Next != Count && Files[Index].Size > Files[Best].Size))) {
+            Best = Index;
+          }
+        }
+        if (Best == Count) {
+          Best = Next;
+        }
+      }
+
+      Order[Placed++] = Best;
+      IsPlaced[Best]  = TRUE;
+      Offset         += GetPlacementPadSize (Offset, &Files[Best]) + Files[Best].Size;
+    }
+
+    if (End < Count) {
+      Order[Placed++] = End;
+      IsPlaced[End]   = TRUE;
+      Offset         += GetPlacementPadSize (Offset, &Files[End]) + Files[End].Size;
+    }
+  }
+
+  OriginalPadSize  = GetPlacementPadTotal (StartOffset, Files, OriginalOrder, Count);
+  OptimizedPadSize = GetPlacementPadTotal (StartOffset, Files, Order, Count);
+  if (OptimizedPadSize >= OriginalPadSize) {
+    VerboseMsg ("the file placement can't reduce the 0x%x bytes of pad files", (unsigned) OriginalPadSize);
+    goto Finish;
+  }
+  VerboseMsg ("the file placement reduces the pad files from 0x%x to 0x%x bytes", (unsigned) OriginalPadSize, (unsigned) OptimizedPadSize);
+
+  //
+  // Update the file list
+  //
+  FileNames      = malloc (Count * MAX_LONG_FILE_PATH);
+  FileTakenSizes = malloc (Count * sizeof (UINT32));
+  if (FileNames == NULL || FileTakenSizes == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+  memcpy (FileNames, FvInfo->FvFiles, Count * MAX_LONG_FILE_PATH);
+  memcpy (FileTakenSizes, FvInfo->SizeofFvFiles, Count * sizeof (UINT32));
+  for (Index = 0; Index < Count; Index++) {
+    memcpy (FvInfo->FvFiles[Index], FileNames[Order[Index]], MAX_LONG_FILE_PATH);
+    FvInfo->SizeofFvFiles[Index] = FileTakenSizes[Order[Index]];
+    DebugMsg (NULL, 0, 9, "FV component file", "the %uth name is %s", (unsigned) Index, FvInfo->FvFiles[Index]);
+  }
+
+Finish:
+  free (Files);
+  free (Order);
+  free (OriginalOrder);
+  free (IsPlaced);
+  free (FileNames);
+  free (FileTakenSizes);
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+AddFileIndexEntry (
+  IN OUT EFI_FIRMWARE_VOLUME_EXT_HEADER   **ExtHeader,
+  IN     FV_INFO                          *FvInfo
+  )
+/*++
+
+Routine Description:
+
+  This function appends an empty file index entry to the FV extension header.
+  The entry has room for every FFS file of the FV, it is filled by
+  UpdateFileIndexEntry once the files are placed.
+
+Arguments:
+
+  ExtHeader     PI FvExtHeader, reallocated with the file index entry.
+  FvInfo        Pointer to information about the FV.
+
+Returns:
+
+  EFI_SUCCESS              The function completed successfully.
+  EFI_OUT_OF_RESOURCES     Memory could not be allocated.
+
+--*/
+{
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *NewExtHeader;
+  EDKII_FV_FILE_INDEX_EXT_ENTRY   *IndexEntry;
+  UINTN                           Count;
+  UINTN                           EntrySize;
+  UINT32                          ExtHeaderSize;
+
+  for (Count = 0; Count < MAX_NUMBER_OF_FILES_IN_FV && FvInfo->FvFiles[Count][0] != 0; Count++) {
+  }
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+
+  EntrySize = sizeof (EDKII_FV_FILE_INDEX_EXT_ENTRY) + Count * sizeof (EDKII_FV_FILE_INDEX_ENTRY);
+  if (EntrySize > MAX_UINT16) {
+    Warning (NULL, 0, 0, "Too many files for the FV file index", "the file index is not added to the FV.");
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Extension entries start on a 4 byte boundary.
+  //
+  ExtHeaderSize = ((*ExtHeader)->ExtHeaderSize + 3) & ~3;
+  NewExtHeader  = malloc (ExtHeaderSize + EntrySize);
+  if (NewExtHeader == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    return EFI_OUT_OF_RESOURCES;
+  }
+  memset (NewExtHeader, 0, ExtHeaderSize + EntrySize);
+  memcpy (NewExtHeader, *ExtHeader, (*ExtHeader)->ExtHeaderSize);
+
+  IndexEntry = (EDKII_FV_FILE_INDEX_EXT_ENTRY *) ((UINT8 *) NewExtHeader + ExtHeaderSize);
+  IndexEntry->Hdr.ExtEntryType = EFI_FV_EXT_TYPE_GUID_TYPE;
+  IndexEntry->Hdr.ExtEntrySize = (UINT16) EntrySize;
+  memcpy (&IndexEntry->FormatType, &mFvFileIndexGuid, sizeof (EFI_GUID));
+
+  mFvFileIndexSize            = (UINT32) (ExtHeaderSize + EntrySize - (*ExtHeader)->ExtHeaderSize);
+  NewExtHeader->ExtHeaderSize = (UINT32) (ExtHeaderSize + EntrySize);
+  free (*ExtHeader);
+  *ExtHeader = NewExtHeader;
+  return EFI_SUCCESS;
+}
+
+STATIC
+int
+CompareFileIndexEntry (
+  IN CONST VOID  *Entry1,
+  IN CONST VOID  *Entry2
+  )
+{
+  return memcmp (
+           &((EDKII_FV_FILE_INDEX_ENTRY *) Entry1)->Name,
+           &((EDKII_FV_FILE_INDEX_ENTRY *) Entry2)->Name,
+           sizeof (EFI_GUID)
+           );
+}
+
+STATIC
+VOID
+UpdateFileIndexEntry (
+  IN MEMORY_FILE    *FvImage,
+  IN FV_INFO        *FvInfo
+  )
+/*++
+
+Routine Description:
+
+  This function fills the file index entry of the FV extension header with
+  the name and the offset of the files added to the FV, sorted by name.
+
+Arguments:
+
+  FvImage       The memory image of the FV, its files are placed.
+  FvInfo        Pointer to information about the FV.
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_FIRMWARE_VOLUME_HEADER      *FvHeader;
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *ExtHeader;
+  EFI_FIRMWARE_VOLUME_EXT_ENTRY   *ExtEntry;
+  EDKII_FV_FILE_INDEX_EXT_ENTRY   *IndexEntry;
+  EDKII_FV_FILE_INDEX_ENTRY       *Entry;
+  UINT32                          Offset;
+  UINTN                           Index;
+
+  FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *) FvImage->FileImage;
+  if (FvHeader->ExtHeaderOffset == 0) {
+    return;
+  }
+
+  ExtHeader  = (EFI_FIRMWARE_VOLUME_EXT_HEADER *) (FvImage->FileImage + FvHeader->ExtHeaderOffset);
+  IndexEntry = NULL;
+  for (Offset = sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER); Offset < ExtHeader->ExtHeaderSize; Offset += ExtEntry->ExtEntrySize) {
+    ExtEntry = (EFI_FIRMWARE_VOLUME_EXT_ENTRY *) ((UINT8 *) ExtHeader + Offset);
+    if (ExtEntry->ExtEntrySize == 0) {
+      break;
+    }
+    if (ExtEntry->ExtEntryType == EFI_FV_EXT_TYPE_GUID_TYPE &&
+        CompareGuid (&((EDKII_FV_FILE_INDEX_EXT_ENTRY *) ExtEntry)->FormatType, &mFvFileIndexGuid) == 0) {
+      IndexEntry = (EDKII_FV_FILE_INDEX_EXT_ENTRY *) ExtEntry;
+    }
+  }
+  if (IndexEntry == NULL) {
+    return;
+  }
+
+  Entry = (EDKII_FV_FILE_INDEX_ENTRY *) (IndexEntry + 1);
+  for (Index = 0; Index < MAX_NUMBER_OF_FILES_IN_FV && FvInfo->FvFiles[Index][0] != 0; Index++) {
+    memcpy (&Entry[Index].Name, &mFileGuidArray[Index], sizeof (EFI_GUID));
+    Entry[Index].Offset = mFileOffsetArray[Index];
+  }
+  qsort (Entry, Index, sizeof (EDKII_FV_FILE_INDEX_ENTRY), CompareFileIndexEntry);
+  IndexEntry->Count = (UINT32) Index;
+}
+
 EFI_STATUS
 GenerateFvImage (
   IN CHAR8                *InfFileImage,
@@ -2733,6 +3233,30 @@ Returns:
   strcpy (FvReportName, FvFileName);
   strcat (FvReportName, ".txt");
 
+  //
+  // Reserve the file index in the FV extension header, when requested.
+  //
+  if (mFvDataInfo.FileIndex && mFvDataInfo.IsPiFvImage) {
+    if (FvExtHeader == NULL) {
+      Warning (NULL, 0, 0, "No FV extension header", "the file index needs the FV name GUID, it is not added to the FV.");
+    } else {
+      Status = AddFileIndexEntry (&FvExtHeader, &mFvDataInfo);
+      if (EFI_ERROR (Status)) {
+        goto Finish;
+      }
+    }
+  }
+
+  //
+  // Reorder the FFS files to reduce the pad files, when requested.
+  //
+  if (mFvDataInfo.OptimizePlacement && mFvDataInfo.IsPiFvImage) {
+    Status = OptimizeFilePlacement (&mFvDataInfo, FvExtHeader);
+    if (EFI_ERROR (Status)) {
+      goto Finish;
+    }
+  }
+
   //
   // Calculate the FV size and Update Fv Size based on the actual FFS files.
   // And Update mFvDataInfo data.
@@ -2914,6 +3438,19 @@ Returns:
     }
   }
 
+  //
+  // Fill the file index now that the files are placed.
+  //
+  if (mFvFileIndexSize != 0) {
+    UpdateFileIndexEntry (&FvImageMemoryFile, &mFvDataInfo);
+  }
+
+  //
+  // record the space taken by the pad files of the FFS file alignment.
+  //
+  fprintf (FvMapFile, "%s = 0x%x\n", EFI_FV_PAD_SIZE_STRING, (unsigned) mFvPadSize);
+  fprintf (FvMapFile, "%s = %u\n\n", EFI_FV_PAD_FILES_STRING, (unsigned) mFvPadFileCount);
+
   //
   // If there is a VTF file, some special actions need to occur.
   //
@@ -3186,7 +3723,7 @@ Returns:
       Error (NULL, 0, 0001, "Error opening file", mFvDataInfo.FvExtHeaderFile);
       return EFI_ABORTED;
     }
-    FvExtendHeaderSize = _filelength (fileno (fpin));
+    FvExtendHeaderSize = _filelength (fileno (fpin)) + mFvFileIndexSize;
     fclose (fpin);
     if (sizeof (EFI_FFS_FILE_HEADER) + FvExtendHeaderSize >= MAX_FFS_SIZE) {
       CurrentOffset += sizeof (EFI_FFS_FILE_HEADER2) + FvExtendHeaderSize;
@@ -3196,7 +3733,7 @@ Returns:
     }
     CurrentOffset = (CurrentOffset + 7) & (~7);
   } else if (mFvDataInfo.FvNameGuidSet) {
-    CurrentOffset += sizeof (EFI_FFS_FILE_HEADER) + sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER);
+    CurrentOffset += sizeof (EFI_FFS_FILE_HEADER) + sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER) + mFvFileIndexSize;
     CurrentOffset = (CurrentOffset + 7) & (~7);
   }
 
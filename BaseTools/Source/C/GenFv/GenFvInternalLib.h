@@ -21,6 +21,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Common/PiFirmwareFile.h>
 #include <Common/PiFirmwareVolume.h>
 #include <Guid/PiFirmwareFileSystem.h>
+#include <Guid/FvFileIndex.h>
 #include <IndustryStandard/PeImage.h>
 
 #include "CommonLib.h"
@@ -75,6 +76,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define EFI_FV_TOTAL_SIZE_STRING    "EFI_FV_TOTAL_SIZE"
 #define EFI_FV_TAKEN_SIZE_STRING    "EFI_FV_TAKEN_SIZE"
 #define EFI_FV_SPACE_SIZE_STRING    "EFI_FV_SPACE_SIZE"
+#define EFI_FV_PAD_SIZE_STRING      "EFI_FV_PAD_SIZE"
+#define EFI_FV_PAD_FILES_STRING     "EFI_FV_PAD_FILES"
 
 //
 // Attributes section
@@ -133,6 +136,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define EFI_FVB2_ALIGNMENT_2G_STRING      "EFI_FVB2_ALIGNMENT_2G"
 
 #define EFI_FV_WEAK_ALIGNMENT_STRING      "EFI_WEAK_ALIGNMENT"
+#define EFI_FV_OPTIMIZE_PLACEMENT_STRING  "EFI_OPTIMIZE_PLACEMENT"
+#define EFI_FV_FILE_INDEX_STRING          "EFI_FILE_INDEX"
 
 //
 // File sections
@@ -213,8 +218,20 @@ typedef struct {
   UINT32                  SizeofFvFiles[MAX_NUMBER_OF_FILES_IN_FV];
   BOOLEAN                 IsPiFvImage;
   INT8                    ForceRebase;
+  BOOLEAN                 OptimizePlacement;
+  BOOLEAN                 FileIndex;
 } FV_INFO;
 
+//
+// Placement information of a FFS file, used to reorder the files of the FV
+//
+typedef struct {
+  UINTN                   Size;
+  UINT32                  HeaderSize;
+  UINT32                  Alignment;
+  BOOLEAN                 Pinned;
+} FFS_PLACEMENT_INFO;
+
 typedef struct {
   EFI_GUID                CapGuid;
   UINT32                  HeaderSize;
@@ -89,6 +89,18 @@ STATIC Elf_Ehdr *mEhdr;
 STATIC Elf_Shdr *mShdrBase;
 STATIC Elf_Phdr *mPhdrBase;
 
+//
+// Section name and symbol name string tables, looked up once.
+//
+STATIC CHAR8    *mShStrtab = NULL;
+STATIC Elf_Shdr *mStrtabShdr = NULL;
+
+STATIC
+Elf_Shdr *
+FindStrtabShdr (
+  VOID
+  );
+
 //
 // GOT information
 //
@@ -97,6 +109,8 @@ STATIC UINT32   mGOTShindex = 0;
 STATIC UINT32   *mGOTCoffEntries = NULL;
 STATIC UINT32   mGOTMaxCoffEntries = 0;
 STATIC UINT32   mGOTNumCoffEntries = 0;
+STATIC UINT8    *mGOTCoffEntryMap = NULL;
+STATIC UINT32   mGOTCoffEntryMapSize = 0;
 
 //
 // Coff information
@@ -108,6 +122,11 @@ STATIC UINT32 mCoffAlignment = 0x20;
 //
 STATIC const UINT16 mCoffNbrSections = 4;
 
+//
+// TRUE if .text and .data are laid out as a single PE section.
+//
+STATIC BOOLEAN mCoffMergeSections = FALSE;
+
 //
 // ELF sections to offset in Coff file.
 //
@@ -177,6 +196,18 @@ InitializeElf64 (
   mShdrBase  = (Elf_Shdr *)((UINT8 *)mEhdr + mEhdr->e_shoff);
   mPhdrBase = (Elf_Phdr *)((UINT8 *)mEhdr + mEhdr->e_phoff);
 
+  //
+  // Look up the string tables once, they are used for every section and
+  // symbol name comparison.
+  //
+  VerboseMsg ("Find String Tables");
+  if (mEhdr->e_shstrndx >= mEhdr->e_shnum) {
+    Error (NULL, 0, 3000, "Invalid", "ELF e_shstrndx (%u) is too high.", (unsigned) mEhdr->e_shstrndx);
+    return FALSE;
+  }
+  mShStrtab = (CHAR8 *)mEhdr + ((Elf_Shdr *)((UINT8 *)mShdrBase + mEhdr->e_shstrndx * mEhdr->e_shentsize))->sh_offset;
+  mStrtabShdr = FindStrtabShdr ();
+
   //
   // Create COFF Section offset buffer and zero.
   //
@@ -256,9 +287,7 @@ IsHiiRsrcShdr (
   Elf_Shdr *Shdr
   )
 {
-  Elf_Shdr *Namedr = GetShdrByIndex(mEhdr->e_shstrndx);
-
-  return (BOOLEAN) (strcmp((CHAR8*)mEhdr + Namedr->sh_offset + Shdr->sh_name, ELF_HII_SECTION_NAME) == 0);
+  return (BOOLEAN) (strcmp(mShStrtab + Shdr->sh_name, ELF_HII_SECTION_NAME) == 0);
 }
 
 STATIC
@@ -279,9 +308,7 @@ IsStrtabShdr (
   Elf_Shdr *Shdr
   )
 {
-  Elf_Shdr *Namedr = GetShdrByIndex(mEhdr->e_shstrndx);
-
-  return (BOOLEAN) (strcmp((CHAR8*)mEhdr + Namedr->sh_offset + Shdr->sh_name, ELF_STRTAB_SECTION_NAME) == 0);
+  return (BOOLEAN) (strcmp(mShStrtab + Shdr->sh_name, ELF_STRTAB_SECTION_NAME) == 0);
 }
 
 STATIC
@@ -315,7 +342,7 @@ GetSymName (
     return NULL;
   }
 
-  StrtabShdr = FindStrtabShdr();
+  StrtabShdr = mStrtabShdr;
   if (StrtabShdr == NULL) {
     return NULL;
   }
@@ -371,8 +398,9 @@ FindElfGOTSectionFromGOTEntryElfRva (
 //
 // Stores locations of GOT entries in COFF image.
 //   Returns TRUE if GOT entry is new.
-//   Simple implementation as number of GOT
-//   entries is expected to be low.
+//   Entries already seen are tracked in a byte
+//   map of the COFF image, so each lookup is
+//   constant time however large the GOT is.
 //
 
 STATIC
@@ -381,14 +409,23 @@ AccumulateCoffGOTEntries (
   UINT32 GOTCoffEntry
   )
 {
-  UINT32 i;
-  if (mGOTCoffEntries != NULL) {
-    for (i = 0; i < mGOTNumCoffEntries; i++) {
-      if (mGOTCoffEntries[i] == GOTCoffEntry) {
-        return FALSE;
-      }
+  if (mGOTCoffEntryMap == NULL) {
+    mGOTCoffEntryMapSize = mCoffOffset;
+    mGOTCoffEntryMap = (UINT8*)calloc(mGOTCoffEntryMapSize / 8 + 1, 1);
+    if (mGOTCoffEntryMap == NULL) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
     }
+    assert (mGOTCoffEntryMap != NULL);
+  }
+  if (GOTCoffEntry >= mGOTCoffEntryMapSize) {
+    Error (NULL, 0, 3000, "Invalid", "AccumulateCoffGOTEntries: GOT entry 0x%08X is outside the image.", GOTCoffEntry);
+    exit(EXIT_FAILURE);
+  }
+  if ((mGOTCoffEntryMap[GOTCoffEntry / 8] & (1 << (GOTCoffEntry % 8))) != 0) {
+    return FALSE;
   }
+  mGOTCoffEntryMap[GOTCoffEntry / 8] |= (UINT8)(1 << (GOTCoffEntry % 8));
+
   if (mGOTCoffEntries == NULL) {
     mGOTCoffEntries = (UINT32*)malloc(5 * sizeof *mGOTCoffEntries);
     if (mGOTCoffEntries == NULL) {
@@ -459,6 +496,9 @@ EmitGOTRelocations (
   mGOTCoffEntries = NULL;
   mGOTMaxCoffEntries = 0;
   mGOTNumCoffEntries = 0;
+  free(mGOTCoffEntryMap);
+  mGOTCoffEntryMap = NULL;
+  mGOTCoffEntryMapSize = 0;
 }
 //
 // RISC-V 64 specific Elf WriteSection function.
@@ -664,6 +704,21 @@ ScanSections64 (
     assert (FALSE);
   }
 
+  //
+  // Merging .text and .data is only done for X64 images whose section
+  // alignment is below the page size. Such images cannot get per section
+  // page attributes at load time anyway, so the padding between the two
+  // sections and the extra section header are pure overhead.
+  //
+  mCoffMergeSections = FALSE;
+  if (mMergeSections) {
+    if ((mEhdr->e_machine == EM_X86_64) && (mCoffAlignment < EFI_PAGE_SIZE)) {
+      mCoffMergeSections = TRUE;
+    } else {
+      Warning (NULL, 0, 0, NULL, "Sections in %s are not merged, the image is not X64 or its section alignment is 0x%x.", mInImageName, (unsigned) mCoffAlignment);
+    }
+  }
+
 
   //
   // Move the PE/COFF header right before the first section. This will help us
@@ -721,7 +776,9 @@ ScanSections64 (
   }
 
   mDebugOffset = DebugRvaAlign(mCoffOffset);
-  mCoffOffset = CoffAlign(mCoffOffset);
+  if (!mCoffMergeSections) {
+    mCoffOffset = CoffAlign(mCoffOffset);
+  }
 
   if (SectionCount > 1 && mOutImageType == FW_EFI_IMAGE) {
     Warning (NULL, 0, 0, NULL, "Multiple sections in %s are merged into 1 text section. Source level debug might not work correctly.", mInImageName);
@@ -880,7 +937,14 @@ ScanSections64 (
   //
   // Section headers.
   //
-  if ((mDataOffset - mTextOffset) > 0) {
+  if (mCoffMergeSections && ((mHiiRsrcOffset - mTextOffset) > 0)) {
+    CreateSectionHeader (".text", mTextOffset, mHiiRsrcOffset - mTextOffset,
+            EFI_IMAGE_SCN_CNT_CODE
+            | EFI_IMAGE_SCN_CNT_INITIALIZED_DATA
+            | EFI_IMAGE_SCN_MEM_EXECUTE
+            | EFI_IMAGE_SCN_MEM_WRITE
+            | EFI_IMAGE_SCN_MEM_READ);
+  } else if ((mDataOffset - mTextOffset) > 0) {
     CreateSectionHeader (".text", mTextOffset, mDataOffset - mTextOffset,
             EFI_IMAGE_SCN_CNT_CODE
             | EFI_IMAGE_SCN_MEM_EXECUTE
@@ -890,13 +954,13 @@ ScanSections64 (
     NtHdr->Pe32Plus.FileHeader.NumberOfSections--;
   }
 
-  if ((mHiiRsrcOffset - mDataOffset) > 0) {
+  if (!mCoffMergeSections && ((mHiiRsrcOffset - mDataOffset) > 0)) {
     CreateSectionHeader (".data", mDataOffset, mHiiRsrcOffset - mDataOffset,
             EFI_IMAGE_SCN_CNT_INITIALIZED_DATA
             | EFI_IMAGE_SCN_MEM_WRITE
             | EFI_IMAGE_SCN_MEM_READ);
   } else {
-    // Don't make a section of size 0.
+    // Don't make a section of size 0, nor one already merged into .text.
     NtHdr->Pe32Plus.FileHeader.NumberOfSections--;
   }
 
@@ -87,6 +87,7 @@ UINT32 mImageTimeStamp = 0;
 UINT32 mImageSize = 0;
 UINT32 mOutImageType = FW_DUMMY_IMAGE;
 BOOLEAN mIsConvertXip = FALSE;
+BOOLEAN mMergeSections = FALSE;
 
 
 STATIC
@@ -248,6 +249,11 @@ Returns:
   fprintf (stdout, "  --keepzeropending     Don't strip zero pending of .reloc.\n\
                         This option can be used together with -e or -t.\n\
                         It doesn't work for other options.\n");
+  fprintf (stdout, "  --merge-sections      Place the code and data of an X64 ELF image in one\n\
+                        PE section without padding between them. It is ignored\n\
+                        if the section alignment is 4K or more, because the\n\
+                        sections of such images can be protected separately.\n\
+                        This option is only used together with -e option.\n");
   fprintf (stdout, "  -r, --replace         Overwrite the input file with the output content.\n\
                         If more input files are specified,\n\
                         the last input file will be as the output file.\n");
@@ -1304,6 +1310,13 @@ Returns:
       continue;
     }
 
+    if (stricmp (argv[0], "--merge-sections") == 0) {
+      mMergeSections = TRUE;
+      argc --;
+      argv ++;
+      continue;
+    }
+
     if ((stricmp (argv[0], "-m") == 0) || (stricmp (argv[0], "--mcifile") == 0)) {
       mOutImageType = FW_MCI_IMAGE;
       argc --;
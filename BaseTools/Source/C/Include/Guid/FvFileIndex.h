@@ -0,0 +1,32 @@
+/** @file
+  File index of a firmware volume, stored in the FV extension header as an
+  EFI_FV_EXT_TYPE_GUID_TYPE entry. The entries are sorted by file name.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __FV_FILE_INDEX_GUID_H__
+#define __FV_FILE_INDEX_GUID_H__
+
+#define EDKII_FV_FILE_INDEX_GUID \
+  { \
+    0x9B553911, 0xB8CD, 0x4955, {0x90, 0x4F, 0x22, 0xF2, 0x85, 0x48, 0xA8, 0xA8 } \
+  }
+
+typedef struct {
+  EFI_GUID                         Name;
+  UINT32                           Offset;
+  UINT32                           Reserved;
+} EDKII_FV_FILE_INDEX_ENTRY;
+
+typedef struct {
+  EFI_FIRMWARE_VOLUME_EXT_ENTRY    Hdr;
+  EFI_GUID                         FormatType;
+  UINT32                           Count;
+  UINT32                           Reserved;
+} EDKII_FV_FILE_INDEX_EXT_ENTRY;
+
+#endif
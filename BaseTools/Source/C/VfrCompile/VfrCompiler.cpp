@@ -10,6 +10,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include <new>
 #include "VfrCompiler.h"
 #include "CommonLib.h"
 #include "EfiUtilityMsgs.h"
@@ -79,6 +80,9 @@ CVfrCompiler::OptionInitialization (
   mOptions.AutoDefault                   = FALSE;
   mOptions.CheckDefault                  = FALSE;
   memset (&mOptions.OverrideClassGuid, 0, sizeof (EFI_GUID));
+  mVfrFileList                           = NULL;
+  mVfrFileCount                          = 0;
+  mVfrFileIndex                          = 0;
 
   if (Argc == 1) {
     Usage ();
@@ -169,16 +173,17 @@ CVfrCompiler::OptionInitialization (
     }
   }
 
-  if (Index != Argc - 1) {
+  if (Index >= Argc) {
     DebugError (NULL, 0, 1001, "Missing option", "VFR file name is not specified.");
     goto Fail;
   } else {
-    mOptions.VfrFileName = (CHAR8 *) malloc (strlen (Argv[Index]) + 1);
-    if (mOptions.VfrFileName == NULL) {
-      DebugError (NULL, 0, 4001, "Resource: memory can't be allocated", NULL);
-      goto Fail;
-    }
-    strcpy (mOptions.VfrFileName, Argv[Index]);
+    //
+    // All the remaining arguments are VFR files, they are compiled one
+    // after the other with the same options.
+    //
+    mVfrFileList  = &Argv[Index];
+    mVfrFileCount = Argc - Index;
+    mVfrFileIndex = 0;
 
     if (mOptions.OutputDirectory == NULL) {
       mOptions.OutputDirectory = (CHAR8 *) malloc (1);
@@ -190,19 +195,7 @@ CVfrCompiler::OptionInitialization (
     }
   }
 
-  if (SetBaseFileName() != 0) {
-    goto Fail;
-  }
-  if (SetPkgOutputFileName () != 0) {
-    goto Fail;
-  }
-  if (SetCOutputFileName() != 0) {
-    goto Fail;
-  }
-  if (SetPreprocessorOutputFileName () != 0) {
-    goto Fail;
-  }
-  if (SetRecordListFileName () != 0) {
+  if (SetVfrFileName (mVfrFileList[mVfrFileIndex]) != 0) {
     goto Fail;
   }
   return;
@@ -251,6 +244,72 @@ Fail:
   }
 }
 
+INT8
+CVfrCompiler::SetVfrFileName (
+  IN CHAR8      *VfrFileName
+  )
+{
+  mOptions.VfrFileName = (CHAR8 *) malloc (strlen (VfrFileName) + 1);
+  if (mOptions.VfrFileName == NULL) {
+    DebugError (NULL, 0, 4001, "Resource: memory can't be allocated", NULL);
+    return -1;
+  }
+  strcpy (mOptions.VfrFileName, VfrFileName);
+
+  if (SetBaseFileName() != 0) {
+    return -1;
+  }
+  if (SetPkgOutputFileName () != 0) {
+    return -1;
+  }
+  if (SetCOutputFileName() != 0) {
+    return -1;
+  }
+  if (SetPreprocessorOutputFileName () != 0) {
+    return -1;
+  }
+  if (SetRecordListFileName () != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+VOID
+CVfrCompiler::FreeVfrFileNames (
+  VOID
+  )
+{
+  if (mOptions.VfrFileName != NULL) {
+    free (mOptions.VfrFileName);
+    mOptions.VfrFileName = NULL;
+  }
+
+  if (mOptions.VfrBaseFileName != NULL) {
+    free (mOptions.VfrBaseFileName);
+    mOptions.VfrBaseFileName = NULL;
+  }
+
+  if (mOptions.PkgOutputFileName != NULL) {
+    free (mOptions.PkgOutputFileName);
+    mOptions.PkgOutputFileName = NULL;
+  }
+
+  if (mOptions.COutputFileName != NULL) {
+    free (mOptions.COutputFileName);
+    mOptions.COutputFileName = NULL;
+  }
+
+  if (mOptions.PreprocessorOutputFileName != NULL) {
+    free (mOptions.PreprocessorOutputFileName);
+    mOptions.PreprocessorOutputFileName = NULL;
+  }
+
+  if (mOptions.RecordListFile != NULL) {
+    free (mOptions.RecordListFile);
+    mOptions.RecordListFile = NULL;
+  }
+}
+
 VOID
 CVfrCompiler::AppendIncludePath (
   IN CHAR8      *PathStr
@@ -486,41 +545,13 @@ CVfrCompiler::~CVfrCompiler (
   VOID
   )
 {
-  if (mOptions.VfrFileName != NULL) {
-    free (mOptions.VfrFileName);
-    mOptions.VfrFileName = NULL;
-  }
-
-  if (mOptions.VfrBaseFileName != NULL) {
-    free (mOptions.VfrBaseFileName);
-    mOptions.VfrBaseFileName = NULL;
-  }
+  FreeVfrFileNames ();
 
   if (mOptions.OutputDirectory != NULL) {
     free (mOptions.OutputDirectory);
     mOptions.OutputDirectory = NULL;
   }
 
-  if (mOptions.PkgOutputFileName != NULL) {
-    free (mOptions.PkgOutputFileName);
-    mOptions.PkgOutputFileName = NULL;
-  }
-
-  if (mOptions.COutputFileName != NULL) {
-    free (mOptions.COutputFileName);
-    mOptions.COutputFileName = NULL;
-  }
-
-  if (mOptions.PreprocessorOutputFileName != NULL) {
-    free (mOptions.PreprocessorOutputFileName);
-    mOptions.PreprocessorOutputFileName = NULL;
-  }
-
-  if (mOptions.RecordListFile != NULL) {
-    free (mOptions.RecordListFile);
-    mOptions.RecordListFile = NULL;
-  }
-
   if (mOptions.IncludePaths != NULL) {
     delete[] mOptions.IncludePaths;
     mOptions.IncludePaths = NULL;
@@ -545,7 +576,10 @@ CVfrCompiler::Usage (
     "VfrCompile version " VFR_COMPILER_VERSION "Build " __BUILD_VERSION,
     "Copyright (c) 2004-2016 Intel Corporation. All rights reserved.",
     " ",
-    "Usage: VfrCompile [options] VfrFile",
+    "Usage: VfrCompile [options] VfrFile [VfrFile ...]",
+    " ",
+    "All VfrFiles are compiled with the same options in one invocation,",
+    "the output files of each are named after it.",
     " ",
     "Options:",
     "  -h, --help     prints this help",
@@ -589,6 +623,73 @@ CVfrCompiler::Version (
   }
 }
 
+//
+// Put the global databases back to their initial state, so the next VFR
+// file is compiled as if by a new VfrCompile process.
+//
+static
+VOID
+ResetGlobalState (
+  VOID
+  )
+{
+  if (gCBuffer.Buffer != NULL) {
+    delete[] gCBuffer.Buffer;
+  }
+  gCBuffer.Buffer = NULL;
+  gCBuffer.Size   = 0;
+
+  if (gRBuffer.Buffer != NULL) {
+    delete[] gRBuffer.Buffer;
+  }
+  gRBuffer.Buffer = NULL;
+  gRBuffer.Size   = 0;
+
+  gCFormPkg.~CFormPkg ();
+  new (&gCFormPkg) CFormPkg ();
+  gCIfrRecordInfoDB.~CIfrRecordInfoDB ();
+  new (&gCIfrRecordInfoDB) CIfrRecordInfoDB ();
+  gCVfrErrorHandle.~CVfrErrorHandle ();
+  new (&gCVfrErrorHandle) CVfrErrorHandle ();
+  gCVfrBufferConfig.~CVfrBufferConfig ();
+  new (&gCVfrBufferConfig) CVfrBufferConfig ();
+  gCVfrVarDataTypeDB.~CVfrVarDataTypeDB ();
+  new (&gCVfrVarDataTypeDB) CVfrVarDataTypeDB ();
+  gCVfrDefaultStore.~CVfrDefaultStore ();
+  new (&gCVfrDefaultStore) CVfrDefaultStore ();
+  gCVfrDataStorage.~CVfrDataStorage ();
+  new (&gCVfrDataStorage) CVfrDataStorage ();
+  memset (CIfrFormId::FormIdBitMap, 0, sizeof (CIfrFormId::FormIdBitMap));
+
+  gAdjustOpcodeOffset = 0;
+  gNeedAdjustOpcode   = FALSE;
+  gAdjustOpcodeLen    = 0;
+  gCreateOp           = TRUE;
+  gScopeCount         = 0;
+}
+
+BOOLEAN
+CVfrCompiler::NextVfrFile (
+  VOID
+  )
+{
+  if (!IS_RUN_STATUS(STATUS_FINISHED) || (mVfrFileIndex + 1 >= mVfrFileCount)) {
+    return FALSE;
+  }
+
+  mVfrFileIndex++;
+  FreeVfrFileNames ();
+  ResetGlobalState ();
+
+  if (SetVfrFileName (mVfrFileList[mVfrFileIndex]) != 0) {
+    SET_RUN_STATUS (STATUS_FAILED);
+    return FALSE;
+  }
+
+  SET_RUN_STATUS (STATUS_INITIALIZED);
+  return TRUE;
+}
+
 VOID
 CVfrCompiler::PreProcess (
   VOID
@@ -915,12 +1016,14 @@ main (
   SetPrintLevel(WARNING_LOG_LEVEL);
   CVfrCompiler         Compiler(Argc, Argv);
 
-  Compiler.PreProcess();
-  Compiler.Compile();
-  Compiler.AdjustBin();
-  Compiler.GenBinary();
-  Compiler.GenCFile();
-  Compiler.GenRecordListFile ();
+  do {
+    Compiler.PreProcess();
+    Compiler.Compile();
+    Compiler.AdjustBin();
+    Compiler.GenBinary();
+    Compiler.GenCFile();
+    Compiler.GenRecordListFile ();
+  } while (Compiler.NextVfrFile ());
 
   Status = Compiler.RunStatus ();
   if ((Status == STATUS_DEAD) || (Status == STATUS_FAILED)) {
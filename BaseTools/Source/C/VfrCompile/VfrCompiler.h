@@ -71,8 +71,13 @@ private:
   OPTIONS              mOptions;
   CHAR8                *mPreProcessCmd;
   CHAR8                *mPreProcessOpt;
+  CHAR8                **mVfrFileList;
+  INT32                mVfrFileCount;
+  INT32                mVfrFileIndex;
 
   VOID    OptionInitialization (IN INT32 , IN CHAR8 **);
+  INT8    SetVfrFileName (IN CHAR8 *);
+  VOID    FreeVfrFileNames (VOID);
   VOID    AppendIncludePath (IN CHAR8 *);
   VOID    AppendCPreprocessorOptions (IN CHAR8 *);
   INT8    SetBaseFileName (VOID);
@@ -102,6 +107,7 @@ public:
   VOID                GenBinary (VOID);
   VOID                GenCFile (VOID);
   VOID                GenRecordListFile (VOID);
+  BOOLEAN             NextVfrFile (VOID);
   VOID                DebugError (IN CHAR8*, IN UINT32, IN UINT32, IN CONST CHAR8*, IN CONST CHAR8*, ...);
 };
 
@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "stdio.h"
+#include "stdlib.h"
 #include "assert.h"
 #include "VfrFormPkg.h"
 
@@ -1028,6 +1029,13 @@ CIfrRecordInfoDB::CIfrRecordInfoDB (
   for (UINT8 i = 0; i < EFI_HII_MAX_SUPPORT_DEFAULT_TYPE; i++) {
     mAllDefaultIdArray[i] = 0xffff;
   }
+  mRecordIndex       = NULL;
+  mRecordIndexSize   = 0;
+  mRecordIndexCount  = 0;
+  mRecordIndexValid  = TRUE;
+  mLineIndex         = NULL;
+  mLineIndexCount    = 0;
+  mLineIndexValid    = FALSE;
 }
 
 CIfrRecordInfoDB::~CIfrRecordInfoDB (
@@ -1041,6 +1049,96 @@ CIfrRecordInfoDB::~CIfrRecordInfoDB (
     mIfrRecordListHead = mIfrRecordListHead->mNext;
     delete pNode;
   }
+
+  if (mRecordIndex != NULL) {
+    delete[] mRecordIndex;
+  }
+
+  if (mLineIndex != NULL) {
+    delete[] mLineIndex;
+  }
+}
+
+BOOLEAN
+CIfrRecordInfoDB::RecordIndexAdd (
+  IN SIfrRecord *Record
+  )
+{
+  SIfrRecord **NewIndex;
+
+  if (mRecordIndexCount == mRecordIndexSize) {
+    NewIndex = new SIfrRecord *[mRecordIndexSize * 2 + 256];
+    if (NewIndex == NULL) {
+      return FALSE;
+    }
+    if (mRecordIndex != NULL) {
+      memcpy (NewIndex, mRecordIndex, mRecordIndexCount * sizeof (SIfrRecord *));
+      delete[] mRecordIndex;
+    }
+    mRecordIndex     = NewIndex;
+    mRecordIndexSize = mRecordIndexSize * 2 + 256;
+  }
+
+  mRecordIndex[mRecordIndexCount++] = Record;
+  return TRUE;
+}
+
+static
+int
+CompareRecordLine (
+  IN CONST VOID *Left,
+  IN CONST VOID *Right
+  )
+{
+  CONST SIfrRecordLine *L = (CONST SIfrRecordLine *) Left;
+  CONST SIfrRecordLine *R = (CONST SIfrRecordLine *) Right;
+
+  if (L->mRecord->mLineNo != R->mRecord->mLineNo) {
+    return (L->mRecord->mLineNo < R->mRecord->mLineNo) ? -1 : 1;
+  }
+
+  return (L->mPosition < R->mPosition) ? -1 : (L->mPosition > R->mPosition);
+}
+
+/**
+  Sort the records by line number, records of the same line stay in list
+  order. The listing file is written line by line and used to search the
+  whole record list for every line of the VFR file.
+
+**/
+BOOLEAN
+CIfrRecordInfoDB::LineIndexBuild (
+  VOID
+  )
+{
+  SIfrRecord *pNode;
+  UINT32     Count;
+
+  if (mLineIndex != NULL) {
+    delete[] mLineIndex;
+    mLineIndex = NULL;
+  }
+  mLineIndexCount = 0;
+
+  Count = 0;
+  for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+    Count++;
+  }
+
+  if (Count != 0) {
+    if ((mLineIndex = new SIfrRecordLine[Count]) == NULL) {
+      return FALSE;
+    }
+    for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+      mLineIndex[mLineIndexCount].mRecord   = pNode;
+      mLineIndex[mLineIndexCount].mPosition = mLineIndexCount;
+      mLineIndexCount++;
+    }
+    qsort (mLineIndex, mLineIndexCount, sizeof (SIfrRecordLine), CompareRecordLine);
+  }
+
+  mLineIndexValid = TRUE;
+  return TRUE;
 }
 
 SIfrRecord *
@@ -1048,19 +1146,35 @@ CIfrRecordInfoDB::GetRecordInfoFromIdx (
   IN UINT32 RecordIdx
   )
 {
-  UINT32     Idx;
+  UINT32     Pos;
   SIfrRecord *pNode = NULL;
 
   if (RecordIdx == EFI_IFR_RECORDINFO_IDX_INVALUD) {
     return NULL;
   }
 
-  for (Idx = (EFI_IFR_RECORDINFO_IDX_START + 1), pNode = mIfrRecordListHead;
-       (Idx != RecordIdx) && (pNode != NULL);
-       Idx++, pNode = pNode->mNext)
-  ;
+  //
+  // The record index is the position of the record in the list. Look it up
+  // in mRecordIndex instead of walking the list, which made every opcode
+  // emission linear in the size of the formset.
+  //
+  if (!mRecordIndexValid) {
+    mRecordIndexCount = 0;
+    for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
+      if (!RecordIndexAdd (pNode)) {
+        mRecordIndexCount = 0;
+        return NULL;
+      }
+    }
+    mRecordIndexValid = TRUE;
+  }
+
+  Pos = RecordIdx - (EFI_IFR_RECORDINFO_IDX_START + 1);
+  if (Pos >= mRecordIndexCount) {
+    return NULL;
+  }
 
-  return pNode;
+  return mRecordIndex[Pos];
 }
 
 UINT32
@@ -1090,6 +1204,11 @@ CIfrRecordInfoDB::IfrRecordRegister (
   }
   mRecordCount++;
 
+  if (mRecordIndexValid && !RecordIndexAdd (pNew)) {
+    mRecordIndexValid = FALSE;
+  }
+  mLineIndexValid = FALSE;
+
   return mRecordCount;
 }
 
@@ -1177,6 +1296,8 @@ CIfrRecordInfoDB::IfrRecordOutput (
   SIfrRecord *pNode;
   UINT8      Index;
   UINT32     TotalSize;
+  UINT32     Low;
+  UINT32     High;
 
   if (mSwitch == FALSE) {
     return;
@@ -1188,6 +1309,33 @@ CIfrRecordInfoDB::IfrRecordOutput (
 
   TotalSize = 0;
 
+  if ((LineNo != 0) && (mLineIndexValid || LineIndexBuild ())) {
+    //
+    // Find the first record of LineNo in the records sorted by line.
+    //
+    Low  = 0;
+    High = mLineIndexCount;
+    while (Low < High) {
+      if (mLineIndex[(Low + High) / 2].mRecord->mLineNo < LineNo) {
+        Low = (Low + High) / 2 + 1;
+      } else {
+        High = (Low + High) / 2;
+      }
+    }
+
+    for (; (Low < mLineIndexCount) && (mLineIndex[Low].mRecord->mLineNo == LineNo); Low++) {
+      pNode = mLineIndex[Low].mRecord;
+      fprintf (File, ">%08X: ", pNode->mOffset);
+      if (pNode->mIfrBinBuf != NULL) {
+        for (Index = 0; Index < pNode->mBinBufLen; Index++) {
+          fprintf (File, "%02X ", (UINT8)(pNode->mIfrBinBuf[Index]));
+        }
+      }
+      fprintf (File, "\n");
+    }
+    return;
+  }
+
   for (pNode = mIfrRecordListHead; pNode != NULL; pNode = pNode->mNext) {
     if (pNode->mLineNo == LineNo || LineNo == 0) {
       fprintf (File, ">%08X: ", pNode->mOffset);
@@ -1348,6 +1496,8 @@ CIfrRecordInfoDB::IfrAdjustDynamicOpcodeInRecords (
   //
   // Adjust the node. pPreNode save the Node before mIfrRecordListTail
   //
+  mRecordIndexValid = FALSE;
+  mLineIndexValid   = FALSE;
   pNodeBeforeAdjust->mNext = pNodeBeforeDynamic->mNext;
   if (CreateOpcodeAfterParsingVfr) {
     //
@@ -1439,6 +1589,8 @@ CIfrRecordInfoDB::IfrRecordAdjust (
   pNode = mIfrRecordListHead;
   preNode = pNode;
   QuestionScope = 0;
+  mRecordIndexValid = FALSE;
+  mLineIndexValid   = FALSE;
   while (pNode != NULL) {
     OpHead = (EFI_IFR_OP_HEADER *) pNode->mIfrBinBuf;
 
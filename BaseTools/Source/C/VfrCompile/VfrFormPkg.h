@@ -167,6 +167,7 @@ extern CFormPkg       gCFormPkg;
 extern CVfrStringDB   gCVfrStringDB;
 extern UINT32         gAdjustOpcodeOffset;
 extern BOOLEAN        gNeedAdjustOpcode;
+extern UINT32         gAdjustOpcodeLen;
 
 struct SIfrRecord {
   UINT32     mLineNo;
@@ -180,6 +181,11 @@ struct SIfrRecord {
 };
 
 
+struct SIfrRecordLine {
+  SIfrRecord *mRecord;
+  UINT32     mPosition;           // position of mRecord in the record list
+};
+
 #define EFI_IFR_RECORDINFO_IDX_INVALUD 0xFFFFFF
 #define EFI_IFR_RECORDINFO_IDX_START   0x0
 #define EFI_HII_MAX_SUPPORT_DEFAULT_TYPE  0x08
@@ -205,8 +211,17 @@ private:
   SIfrRecord *mIfrRecordListTail;
   UINT8      mAllDefaultTypeCount;
   UINT16     mAllDefaultIdArray[EFI_HII_MAX_SUPPORT_DEFAULT_TYPE];
+  SIfrRecord **mRecordIndex;       // records in list order, so a record index is found directly
+  UINT32     mRecordIndexSize;
+  UINT32     mRecordIndexCount;
+  BOOLEAN    mRecordIndexValid;    // FALSE once the list is reordered, the index is rebuilt on next use
+  SIfrRecordLine *mLineIndex;      // records sorted by line number for the listing file
+  UINT32     mLineIndexCount;
+  BOOLEAN    mLineIndexValid;
 
   SIfrRecord * GetRecordInfoFromIdx (IN UINT32);
+  BOOLEAN          RecordIndexAdd (IN SIfrRecord *);
+  BOOLEAN          LineIndexBuild (VOID);
   BOOLEAN          CheckQuestionOpCode (IN UINT8);
   BOOLEAN          CheckIdOpCode (IN UINT8);
   EFI_QUESTION_ID  GetOpcodeQuestionId (IN EFI_IFR_OP_HEADER *);
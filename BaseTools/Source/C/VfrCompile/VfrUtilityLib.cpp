@@ -131,6 +131,7 @@ SConfigItem::SConfigItem (
   mGuid          = NULL;
   mId            = NULL;
   mInfoStrList = NULL;
+  mOffsetMap   = NULL;
   mNext        = NULL;
 
   if (Name != NULL) {
@@ -166,6 +167,7 @@ SConfigItem::SConfigItem (
   mGuid        = NULL;
   mId          = NULL;
   mInfoStrList = NULL;
+  mOffsetMap   = NULL;
   mNext        = NULL;
 
   if (Name != NULL) {
@@ -198,6 +200,7 @@ SConfigItem::~SConfigItem (
   ARRAY_SAFE_FREE (mName);
   ARRAY_SAFE_FREE (mGuid);
   ARRAY_SAFE_FREE (mId);
+  ARRAY_SAFE_FREE (mOffsetMap);
   while (mInfoStrList != NULL) {
     Info = mInfoStrList;
     mInfoStrList = mInfoStrList->mNext;
@@ -320,17 +323,29 @@ CVfrBufferConfig::Write (
       }
       mItemListPos = pItem;
     } else {
-      // tranverse the list to find out if there's already the value for the same offset
-      for (pInfo = mItemListPos->mInfoStrList; pInfo != NULL; pInfo = pInfo->mNext) {
-        if (pInfo->mOffset == Offset) {
-          return 0;
+      //
+      // Check if there's already the value for the same offset. The offsets
+      // are kept in a bitmap, tranversing the list for every default made
+      // large formsets quadratic.
+      //
+      if (mItemListPos->mOffsetMap == NULL) {
+        if ((mItemListPos->mOffsetMap = new UINT8[CONFIG_ITEM_OFFSET_MAP_SIZE]) == NULL) {
+          return 2;
+        }
+        memset (mItemListPos->mOffsetMap, 0, CONFIG_ITEM_OFFSET_MAP_SIZE);
+        for (pInfo = mItemListPos->mInfoStrList; pInfo != NULL; pInfo = pInfo->mNext) {
+          mItemListPos->mOffsetMap[pInfo->mOffset / 8] |= (UINT8) (1 << (pInfo->mOffset % 8));
         }
       }
+      if ((mItemListPos->mOffsetMap[Offset / 8] & (1 << (Offset % 8))) != 0) {
+        return 0;
+      }
       if((pInfo = new SConfigInfo (Type, Offset, Width, Value)) == NULL) {
         return 2;
       }
       pInfo->mNext = mItemListPos->mInfoStrList;
       mItemListPos->mInfoStrList = pInfo;
+      mItemListPos->mOffsetMap[Offset / 8] |= (UINT8) (1 << (Offset % 8));
     }
     break;
 
@@ -1135,6 +1150,8 @@ CVfrVarDataTypeDB::DataTypeAddBitField (
   if (FieldName != NULL) {
     strncpy (pNewField->mFieldName, FieldName, MAX_NAME_LEN - 1);
     pNewField->mFieldName[MAX_NAME_LEN - 1] = 0;
+  } else {
+    pNewField->mFieldName[0] = '\0';
   }
   pNewField->mFieldType    = pFieldType;
   pNewField->mIsBitField   = TRUE;
@@ -3438,6 +3455,8 @@ CVfrQuestionDB::FindQuestion (
 CVfrStringDB::CVfrStringDB ()
 {
   mStringFileName = NULL;
+  mStringFileData = NULL;
+  mStringFileSize = 0;
 }
 
 CVfrStringDB::~CVfrStringDB ()
@@ -3446,6 +3465,10 @@ CVfrStringDB::~CVfrStringDB ()
     delete[] mStringFileName;
   }
   mStringFileName = NULL;
+  if (mStringFileData != NULL) {
+    delete[] mStringFileData;
+  }
+  mStringFileData = NULL;
 }
 
 
@@ -3461,6 +3484,11 @@ CVfrStringDB::SetStringFileName(IN CHAR8 *StringFileName)
   if (mStringFileName != NULL) {
     delete[] mStringFileName;
   }
+  if (mStringFileData != NULL) {
+    delete[] mStringFileData;
+    mStringFileData = NULL;
+    mStringFileSize = 0;
+  }
 
   FileLen = strlen (StringFileName) + 1;
   mStringFileName = new CHAR8[FileLen];
@@ -3572,34 +3600,43 @@ CVfrStringDB::GetVarStoreNameFormStringId (
     return NULL;
   }
 
-  if ((pInFile = fopen (LongFilePath (mStringFileName), "rb")) == NULL) {
-    return NULL;
-  }
-
   //
-  // Get file length.
+  // The string package file is read once and kept, it is searched for
+  // every name/value varstore of every VFR file compiled.
   //
-  fseek (pInFile, 0, SEEK_END);
-  Length = ftell (pInFile);
-  fseek (pInFile, 0, SEEK_SET);
+  if (mStringFileData == NULL) {
+    if ((pInFile = fopen (LongFilePath (mStringFileName), "rb")) == NULL) {
+      return NULL;
+    }
 
-  //
-  // Get file data.
-  //
-  StringPtr = new UINT8[Length];
-  if (StringPtr == NULL) {
+    //
+    // Get file length.
+    //
+    fseek (pInFile, 0, SEEK_END);
+    Length = ftell (pInFile);
+    fseek (pInFile, 0, SEEK_SET);
+
+    //
+    // Get file data.
+    //
+    mStringFileData = new UINT8[Length];
+    if (mStringFileData == NULL) {
+      fclose (pInFile);
+      return NULL;
+    }
+    fread ((char *)mStringFileData, sizeof (UINT8), Length, pInFile);
     fclose (pInFile);
-    return NULL;
+    mStringFileSize = Length;
   }
-  fread ((char *)StringPtr, sizeof (UINT8), Length, pInFile);
-  fclose (pInFile);
+
+  StringPtr = mStringFileData;
+  Length    = mStringFileSize;
 
   PkgHeader = (EFI_HII_STRING_PACKAGE_HDR *) StringPtr;
   //
   // Check the String package.
   //
   if (PkgHeader->Header.Type != EFI_HII_PACKAGE_STRINGS) {
-    delete[] StringPtr;
     return NULL;
   }
 
@@ -3626,7 +3663,6 @@ CVfrStringDB::GetVarStoreNameFormStringId (
   //
   Status = FindStringBlock(Current, StringId, &NameOffset, &BlockType);
   if (Status != EFI_SUCCESS) {
-    delete[] StringPtr;
     return NULL;
   }
 
@@ -3659,8 +3695,6 @@ CVfrStringDB::GetVarStoreNameFormStringId (
     break;
   }
 
-  delete[] StringPtr;
-
   return VarStoreName;
 }
 
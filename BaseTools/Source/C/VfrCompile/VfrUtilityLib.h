@@ -56,11 +56,14 @@ private:
   SConfigInfo& operator= (IN CONST SConfigInfo&);  // Prevent assignment
 };
 
+#define CONFIG_ITEM_OFFSET_MAP_SIZE        (0x10000 / 8)
+
 struct SConfigItem {
   CHAR8         *mName;         // varstore name
   EFI_GUID      *mGuid;         // varstore guid, varstore name + guid deside one varstore
   CHAR8         *mId;           // default ID
   SConfigInfo   *mInfoStrList;  // list of Offset/Value in the varstore
+  UINT8         *mOffsetMap;    // bitmap of the offsets in mInfoStrList, built on first use
   SConfigItem   *mNext;
 
 public:
@@ -501,6 +504,8 @@ private:
 class CVfrStringDB {
 private:
   CHAR8   *mStringFileName;
+  UINT8   *mStringFileData;  // content of mStringFileName, read once
+  UINT32  mStringFileSize;
 
   EFI_STATUS FindStringBlock (
     IN  UINT8            *StringData,
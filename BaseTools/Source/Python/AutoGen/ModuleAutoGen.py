@@ -198,6 +198,7 @@ class ModuleAutoGen(AutoGen):
     ## Cache the timestamps of metafiles of every module in a class attribute
     #
     TimeDict = {}
+    FileDigestDict = {}  # MU_CHANGE - Incremental AutoGen
 
     def __new__(cls, Workspace, MetaFile, Target, Toolchain, Arch, *args, **kwargs):
 #         check if this module is employed by active platform
@@ -1761,6 +1762,10 @@ class ModuleAutoGen(AutoGen):
 
             SaveFileOnChange(self.TimeStampPath, "\n".join(FileSet), False)
 
+            # MU_CHANGE [BEGIN] - Incremental AutoGen
+            SaveFileOnChange(self.AutoGenDigestPath, "\n".join([str(self.AutoGenInputDigest), self.FfsCommandDigest]), False)
+            # MU_CHANGE [END]
+
         # Ignore generating makefile when it is a binary module
         if self.IsBinaryModule:
             return
@@ -1772,7 +1777,8 @@ class ModuleAutoGen(AutoGen):
                 LibraryAutoGen.CreateMakeFile()
 
         # CanSkip uses timestamps to determine build skipping
-        if self.CanSkip():
+        # MU_CHANGE - The FFS commands come from the FDF, check them as well
+        if self.CanSkip() and self.FfsCommandDigest in self.SavedAutoGenDigest[1:]:
             return
 
         if len(self.CustomMakefile) == 0:
@@ -2439,8 +2445,15 @@ class ModuleAutoGen(AutoGen):
         DstTimeStamp = os.stat(self.TimeStampPath)[8]
 
         SrcTimeStamp = self.Workspace._SrcTimeStamp
+        # MU_CHANGE [BEGIN] - Incremental AutoGen
+        # A platform meta file changed. Reuse the AutoGen files when the
+        # part of the platform this module consumes is unchanged.
+        InputsChecked = False
         if SrcTimeStamp > DstTimeStamp:
-            return False
+            if not self.AutoGenInputDigest or self.SavedAutoGenDigest[:1] != [self.AutoGenInputDigest]:
+                return False
+            InputsChecked = True
+        # MU_CHANGE [END]
 
         with open(self.TimeStampPath,'r') as f:
             for source in f:
@@ -2451,9 +2464,84 @@ class ModuleAutoGen(AutoGen):
                     ModuleAutoGen.TimeDict[source] = os.stat(source)[8]
                 if ModuleAutoGen.TimeDict[source] > DstTimeStamp:
                     return False
+        # MU_CHANGE [BEGIN] - Incremental AutoGen
+        if InputsChecked:
+            EdkLogger.debug(EdkLogger.DEBUG_9, "Reused the AutoGen files of module %s [%s]" % (self.Name, self.Arch))
+            os.utime(self.TimeStampPath, None)
+        # MU_CHANGE [END]
         GlobalData.gSikpAutoGenCache.add(self.MakeFileDir)
         return True
 
+    # MU_CHANGE [BEGIN] - Incremental AutoGen
+    ## Digest of the part of the platform the AutoGen files of the module depend on
+    #
+    #   Any change to the DSC, FDF, DEC or Conf files makes all AutoGenTimeStamp
+    #   files out of date. The digest covers the meta files of the module, its
+    #   library instances and their packages, and the PCDs, build options, tools
+    #   and depex the module uses, so that CanSkip() reuses the AutoGen files of
+    #   the modules such a change does not affect.
+    #
+    #   @retval     string      The digest
+    #   @retval     None        The module always regenerates its AutoGen files
+    #
+    @cached_property
+    def AutoGenInputDigest(self):
+        # The PCD database depends on the dynamic PCDs of all modules
+        if self.PcdIsDriver:
+            return None
+
+        m = hashlib.md5()
+        FileSet = {self.MetaFile.Path}
+        for Package in self.Module.Packages:
+            FileSet.add(Package.MetaFile.Path)
+        for Lib in self.DependentLibraryList:
+            FileSet.add(Lib.MetaFile.Path)
+            for Package in Lib.Packages:
+                FileSet.add(Package.MetaFile.Path)
+        for File in sorted(FileSet):
+            if File not in ModuleAutoGen.FileDigestDict:
+                try:
+                    with open(LongFilePath(File), 'rb') as f:
+                        ModuleAutoGen.FileDigestDict[File] = hashlib.md5(f.read()).hexdigest()
+                except:
+                    return None
+            m.update(("%s %s\n" % (File, ModuleAutoGen.FileDigestDict[File])).encode())
+
+        m.update(str([str(Lib.MetaFile) for Lib in self.DependentLibraryList]).encode())
+        for Pcd in self.ModulePcdList + self.LibraryPcdList:
+            PcdInfo = [Pcd.TokenSpaceGuidCName, Pcd.TokenCName, Pcd.Type, Pcd.DatumType, Pcd.DefaultValue,
+                       Pcd.MaxDatumSize, Pcd.TokenValue, self.PlatformInfo.PcdTokenNumber.get((Pcd.TokenCName, Pcd.TokenSpaceGuidCName))]
+            if Pcd.SkuInfoList:
+                PcdInfo.extend(str(Pcd.SkuInfoList[Sku]) for Sku in sorted(Pcd.SkuInfoList))
+            m.update(str(PcdInfo).encode())
+
+        m.update(str([self.Guid, self.Name, self.ModuleType, self.BuildType]).encode())
+        m.update(json.dumps(self.BuildOption, sort_keys=True, default=str).encode())
+        m.update(json.dumps(self.Macros, sort_keys=True, default=str).encode())
+        m.update(json.dumps(self.DepexList, sort_keys=True, default=str).encode())
+        m.update(json.dumps(self.PlatformInfo.ToolDefinition, sort_keys=True, default=str).encode())
+        m.update("".join(getattr(self.PlatformInfo.BuildRule, "RuleContent", [])).encode())
+        return m.hexdigest()
+
+    ## Digest of the FFS commands of the module, generated from the FDF into its makefile
+    @property
+    def FfsCommandDigest(self):
+        return hashlib.md5(str(sorted(str(Cmd) for Cmd in self.GenFfsList)).encode()).hexdigest()
+
+    @cached_property
+    def AutoGenDigestPath(self):
+        return os.path.join(self.MakeFileDir, 'AutoGenInputDigest')
+
+    ## The digests saved with the AutoGen files: AutoGenInputDigest, FfsCommandDigest
+    @cached_property
+    def SavedAutoGenDigest(self):
+        try:
+            with open(LongFilePath(self.AutoGenDigestPath), 'r') as f:
+                return f.read().split()
+        except:
+            return []
+    # MU_CHANGE [END]
+
     @cached_property
     def TimeStampPath(self):
         return os.path.join(self.MakeFileDir, 'AutoGenTimeStamp')
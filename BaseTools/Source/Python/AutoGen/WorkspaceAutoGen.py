@@ -899,6 +899,8 @@ class WorkspaceAutoGen(AutoGen):
             FdsCommandDict["quiet"] = True
 
         FdsCommandDict["GenfdsMultiThread"] = GlobalData.gEnableGenfdsMultiThread
+        FdsCommandDict["ThreadNumber"] = GlobalData.gGenfdsThreadNumber
+        FdsCommandDict["GenfdsCache"] = GlobalData.gEnableGenfdsCache
         if GlobalData.gIgnoreSource:
             FdsCommandDict["IgnoreSources"] = True
 
@@ -118,6 +118,8 @@ gModuleAllCacheStatus = None
 gModuleCacheHit = None
 
 gEnableGenfdsMultiThread = True
+gEnableGenfdsCache = False
+gGenfdsThreadNumber = 1
 gSikpAutoGenCache = set()
 # Common lock for the file access in multiple process AutoGens
 file_lock = None
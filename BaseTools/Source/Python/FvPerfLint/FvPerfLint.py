@@ -0,0 +1,726 @@
+## @file
+# Report the boot performance hazards of the modules in a firmware device or
+# firmware volume image.
+#
+# The tool walks every firmware volume found in the input images, including
+# the volumes nested in compressed and GUID defined sections, and ranks the
+# modules by the number of image bytes their issues affect.
+#
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import Common.LongFilePathOs as os
+import re
+import sys
+import struct
+import shutil
+import tempfile
+from subprocess import Popen, PIPE
+from optparse import OptionParser
+from optparse import make_option
+from Common.BuildToolError import *
+from Common.BuildVersion import gBUILD_VERSION
+import Common.EdkLogger as EdkLogger
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+# Version and Copyright
+__version_number__ = ("0.10" + " " + gBUILD_VERSION)
+__version__ = "%prog Version " + __version_number__
+__copyright__ = "Copyright (c) Microsoft Corporation. All rights reserved."
+
+## Firmware volume, FFS file and section layouts of the PI specification
+gFvHeader          = struct.Struct("<16x16sQIIHHHxB")
+gFvExtHeader       = struct.Struct("<16sI")
+gFfsHeader         = struct.Struct("<16sHBB3sB")
+gFfsHeader2Size    = struct.Struct("<Q")
+gSectionHeader     = struct.Struct("<3sB")
+gSectionHeader2    = struct.Struct("<3sBI")
+gCompressionHeader = struct.Struct("<IB")
+gGuidDefinedHeader = struct.Struct("<16sHH")
+
+FV_SIGNATURE                        = b'_FVH'
+EFI_FVB2_ERASE_POLARITY             = 0x00000800
+FFS_ATTRIB_LARGE_FILE               = 0x01
+EFI_FILE_DATA_VALID                 = 0x04
+EFI_FILE_DELETED                    = 0x10
+EFI_FILE_HEADER_INVALID             = 0x20
+EFI_NOT_COMPRESSED                  = 0x00
+EFI_GUIDED_SECTION_PROCESSING_REQUIRED = 0x01
+
+## FFS file types
+EFI_FV_FILETYPE_RAW                   = 0x01
+EFI_FV_FILETYPE_FREEFORM              = 0x02
+EFI_FV_FILETYPE_SECURITY_CORE         = 0x03
+EFI_FV_FILETYPE_PEI_CORE              = 0x04
+EFI_FV_FILETYPE_DXE_CORE              = 0x05
+EFI_FV_FILETYPE_PEIM                  = 0x06
+EFI_FV_FILETYPE_DRIVER                = 0x07
+EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER  = 0x08
+EFI_FV_FILETYPE_APPLICATION           = 0x09
+EFI_FV_FILETYPE_MM                    = 0x0A
+EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE = 0x0B
+EFI_FV_FILETYPE_COMBINED_MM_DXE       = 0x0C
+EFI_FV_FILETYPE_MM_CORE               = 0x0D
+EFI_FV_FILETYPE_MM_STANDALONE         = 0x0E
+EFI_FV_FILETYPE_MM_CORE_STANDALONE    = 0x0F
+EFI_FV_FILETYPE_FFS_PAD               = 0xF0
+
+gFileTypeName = {
+    EFI_FV_FILETYPE_RAW                   : "RAW",
+    EFI_FV_FILETYPE_FREEFORM              : "FREEFORM",
+    EFI_FV_FILETYPE_SECURITY_CORE         : "SEC",
+    EFI_FV_FILETYPE_PEI_CORE              : "PEI_CORE",
+    EFI_FV_FILETYPE_DXE_CORE              : "DXE_CORE",
+    EFI_FV_FILETYPE_PEIM                  : "PEIM",
+    EFI_FV_FILETYPE_DRIVER                : "DRIVER",
+    EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER  : "PEIM_DRIVER",
+    EFI_FV_FILETYPE_APPLICATION           : "APPLICATION",
+    EFI_FV_FILETYPE_MM                    : "MM",
+    EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE : "FV_IMAGE",
+    EFI_FV_FILETYPE_COMBINED_MM_DXE       : "MM_DXE",
+    EFI_FV_FILETYPE_MM_CORE               : "MM_CORE",
+    EFI_FV_FILETYPE_MM_STANDALONE         : "MM_STANDALONE",
+    EFI_FV_FILETYPE_MM_CORE_STANDALONE    : "MM_CORE_STANDALONE",
+}
+
+## File types executed in place from flash before memory is available
+gXipFileTypes = (
+    EFI_FV_FILETYPE_SECURITY_CORE,
+    EFI_FV_FILETYPE_PEI_CORE,
+    EFI_FV_FILETYPE_PEIM,
+    EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER,
+    )
+
+## File types the DXE or MM dispatcher orders with a dependency expression
+gDepexFileTypes = (
+    EFI_FV_FILETYPE_DRIVER,
+    EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER,
+    EFI_FV_FILETYPE_MM,
+    EFI_FV_FILETYPE_COMBINED_MM_DXE,
+    )
+
+## Section types
+EFI_SECTION_COMPRESSION           = 0x01
+EFI_SECTION_GUID_DEFINED          = 0x02
+EFI_SECTION_PE32                  = 0x10
+EFI_SECTION_TE                    = 0x12
+EFI_SECTION_DXE_DEPEX             = 0x13
+EFI_SECTION_USER_INTERFACE        = 0x15
+EFI_SECTION_FIRMWARE_VOLUME_IMAGE = 0x17
+EFI_SECTION_MM_DEPEX              = 0x1C
+
+## Decompression tools of the GUID defined sections, as in tools_def.txt
+gGuidToolDict = {
+    "EE4E5898-3914-4259-9D6E-DC7BD79403CF" : "LzmaCompress",
+    "D42AE6BD-1352-4BFB-909A-CA72A6EAE889" : "LzmaF86Compress",
+    "A31280AD-481E-41B6-95E8-127F4C984779" : "TianoCompress",
+    "3D532050-5CDA-4FD0-879E-0F7F630D5AFB" : "BrotliCompress",
+}
+
+## PE/COFF and TE image layouts
+EFI_IMAGE_DOS_SIGNATURE           = b'MZ'
+EFI_IMAGE_NT_SIGNATURE            = b'PE\0\0'
+EFI_TE_IMAGE_HEADER_SIGNATURE     = b'VZ'
+EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC = 0x10B
+EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC = 0x20B
+EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC = 5
+EFI_IMAGE_DIRECTORY_ENTRY_DEBUG     = 6
+EFI_IMAGE_DEBUG_TYPE_CODEVIEW       = 2
+
+gCoffHeader       = struct.Struct("<HHIIIHH")
+gTeHeader         = struct.Struct("<2sHBBHIIQIIII")
+gSectionTableItem = struct.Struct("<8sIIII16x")
+gDataDirectory    = struct.Struct("<II")
+gDebugDirectory   = struct.Struct("<12xIIII")
+
+## CodeView signatures and the offset of the PDB path behind them
+gCodeViewPdbOffset = {
+    b'NB10' : 16,
+    b'RSDS' : 24,
+    b'MTOC' : 20,
+}
+
+## Build target in the path of the debug symbols, e.g. Build/Ovmf/DEBUG_GCC5/
+gBuildTargetPattern = re.compile(r"[\\/](DEBUG|RELEASE|NOOPT)_[^\\/]+[\\/]")
+
+## Assert message format of the DebugLib instances that print
+gDebugLibAssertFormat = b"ASSERT [%a] %a(%d): %a"
+
+## Issue kinds
+ISSUE_UNCOMPRESSED_FV = "UNCOMPRESSED_FV"
+ISSUE_UNCOMPRESSED    = "UNCOMPRESSED"
+ISSUE_OVERSIZED       = "OVERSIZED"
+ISSUE_DEBUG_BUILD     = "DEBUG_BUILD"
+ISSUE_DEBUG_OUTPUT    = "DEBUG_OUTPUT"
+ISSUE_RELOCATION      = "RELOCATION"
+ISSUE_NO_DEPEX        = "NO_DEPEX"
+
+## Format a GUID in registry format from its binary form
+#
+#  @param  Buffer:    The 16 byte GUID
+#
+#  @retval String     The GUID string
+#
+def GuidToString(Buffer):
+    Data1, Data2, Data3 = struct.unpack_from("<IHH", Buffer)
+    return "%08X-%04X-%04X-%s-%s" % (Data1, Data2, Data3,
+                                     Buffer[8:10].hex().upper(), Buffer[10:16].hex().upper())
+
+## Get the 24 bit size field of an FFS or section header
+def Get24BitSize(Buffer):
+    return Buffer[0] | (Buffer[1] << 8) | (Buffer[2] << 16)
+
+## PeImage() class
+#
+#  The fields of a PE32 or TE image that matter for loading it
+#
+class PeImage(object):
+    def __init__(self, Buffer, Offset, Size):
+        self.Kind = None
+        self.ImageBase = 0
+        self.SizeOfImage = Size
+        self.RelocSize = 0
+        self.PdbPath = ''
+        self.HasDebugLib = False
+        self._Sections = []
+        self._RvaAdjust = 0
+
+        Image = Buffer[Offset : Offset + Size]
+        try:
+            if Image[0:2] == EFI_TE_IMAGE_HEADER_SIGNATURE:
+                self._ParseTe(Image)
+            else:
+                self._ParsePe(Image)
+            self._ParseDebugDirectory(Image)
+        except (struct.error, IndexError):
+            EdkLogger.verbose("Malformed image at offset 0x%X" % Offset)
+        self.HasDebugLib = Image.find(gDebugLibAssertFormat) != -1
+
+    def _ParsePe(self, Image):
+        PeOffset = 0
+        if Image[0:2] == EFI_IMAGE_DOS_SIGNATURE:
+            PeOffset = struct.unpack_from("<I", Image, 0x3C)[0]
+        if Image[PeOffset : PeOffset + 4] != EFI_IMAGE_NT_SIGNATURE:
+            return
+        CoffOffset = PeOffset + 4
+        Machine, NumberOfSections, _, _, _, SizeOfOptionalHeader, _ = gCoffHeader.unpack_from(Image, CoffOffset)
+        OptionalOffset = CoffOffset + gCoffHeader.size
+        Magic = struct.unpack_from("<H", Image, OptionalOffset)[0]
+        if Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC:
+            self.ImageBase = struct.unpack_from("<I", Image, OptionalOffset + 28)[0]
+            NumberOfRvaAndSizes = struct.unpack_from("<I", Image, OptionalOffset + 92)[0]
+            DirectoryOffset = OptionalOffset + 96
+        elif Magic == EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC:
+            self.ImageBase = struct.unpack_from("<Q", Image, OptionalOffset + 24)[0]
+            NumberOfRvaAndSizes = struct.unpack_from("<I", Image, OptionalOffset + 108)[0]
+            DirectoryOffset = OptionalOffset + 112
+        else:
+            return
+        self.Kind = "PE32"
+        self.SizeOfImage = struct.unpack_from("<I", Image, OptionalOffset + 56)[0]
+        self._Directories = []
+        for Index in range(min(NumberOfRvaAndSizes, EFI_IMAGE_DIRECTORY_ENTRY_DEBUG + 1)):
+            self._Directories.append(gDataDirectory.unpack_from(Image, DirectoryOffset + Index * gDataDirectory.size))
+        self._ReadSectionTable(Image, OptionalOffset + SizeOfOptionalHeader, NumberOfSections)
+
+    def _ParseTe(self, Image):
+        _, Machine, NumberOfSections, _, StrippedSize, _, _, ImageBase, RelocRva, RelocSize, DebugRva, DebugSize = \
+            gTeHeader.unpack_from(Image, 0)
+        self.Kind = "TE"
+        self.ImageBase = ImageBase
+        self._RvaAdjust = StrippedSize - gTeHeader.size
+        self._Directories = [(0, 0)] * EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC
+        self._Directories += [(RelocRva, RelocSize), (DebugRva, DebugSize)]
+        self._ReadSectionTable(Image, gTeHeader.size, NumberOfSections)
+        # TE images do not keep SizeOfImage, so take the end of the last section
+        self.SizeOfImage = max([Va + VirtualSize for (Va, VirtualSize, _, _) in self._Sections] + [len(Image)])
+
+    def _ReadSectionTable(self, Image, Offset, NumberOfSections):
+        for Index in range(NumberOfSections):
+            _, VirtualSize, VirtualAddress, SizeOfRawData, PointerToRawData = \
+                gSectionTableItem.unpack_from(Image, Offset + Index * gSectionTableItem.size)
+            self._Sections.append((VirtualAddress, max(VirtualSize, SizeOfRawData), SizeOfRawData, PointerToRawData))
+
+    def _RvaToOffset(self, Rva):
+        for (VirtualAddress, VirtualSize, SizeOfRawData, PointerToRawData) in self._Sections:
+            if VirtualAddress <= Rva < VirtualAddress + SizeOfRawData:
+                return Rva - VirtualAddress + PointerToRawData - self._RvaAdjust
+        return Rva - self._RvaAdjust
+
+    def _ParseDebugDirectory(self, Image):
+        if self.Kind is None:
+            return
+        if len(self._Directories) > EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC:
+            self.RelocSize = self._Directories[EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC][1]
+        if len(self._Directories) <= EFI_IMAGE_DIRECTORY_ENTRY_DEBUG:
+            return
+        DebugRva, DebugSize = self._Directories[EFI_IMAGE_DIRECTORY_ENTRY_DEBUG]
+        if DebugRva == 0 or DebugSize == 0:
+            return
+        DebugOffset = self._RvaToOffset(DebugRva)
+        for Index in range(DebugSize // gDebugDirectory.size):
+            Type, SizeOfData, AddressOfRawData, PointerToRawData = gDebugDirectory.unpack_from(Image, DebugOffset + Index * gDebugDirectory.size)
+            if Type != EFI_IMAGE_DEBUG_TYPE_CODEVIEW or SizeOfData == 0:
+                continue
+            CodeViewOffset = self._RvaToOffset(AddressOfRawData)
+            Signature = Image[CodeViewOffset : CodeViewOffset + 4]
+            if Signature not in gCodeViewPdbOffset:
+                continue
+            PathStart = CodeViewOffset + gCodeViewPdbOffset[Signature]
+            PathEnd = Image.find(b'\0', PathStart, CodeViewOffset + SizeOfData)
+            if PathEnd == -1:
+                PathEnd = CodeViewOffset + SizeOfData
+            self.PdbPath = Image[PathStart : PathEnd].decode('utf-8', 'replace')
+            return
+
+    ## Get the build target recorded in the path of the debug symbols
+    def _GetBuildTarget(self):
+        Match = gBuildTargetPattern.search(self.PdbPath)
+        if Match:
+            return Match.group(1)
+        return None
+
+    BuildTarget = property(_GetBuildTarget)
+
+## FfsFile() class
+#
+#  One FFS file of a firmware volume and what was found in its sections
+#
+class FfsFile(object):
+    def __init__(self, Guid, Type, Size, FvName):
+        self.Guid = Guid
+        self.Type = Type
+        self.Size = Size
+        self.FvName = FvName
+        self.InReportedFv = False
+        self.UiName = ''
+        self.HasDepex = False
+        self.Images = []        # [(PeImage, SectionSize, Compressed, FlashAddress)]
+        self.FvImages = []      # [(SectionSize, Compressed)]
+        self.Issues = []        # [(Cost, Kind, Detail)]
+
+    def _GetName(self):
+        if self.UiName:
+            return self.UiName
+        return self.Guid
+
+    def _GetTypeName(self):
+        return gFileTypeName.get(self.Type, "0x%02X" % self.Type)
+
+    def _GetCost(self):
+        return sum([Issue[0] for Issue in self.Issues])
+
+    def AddIssue(self, Cost, Kind, Detail):
+        self.Issues.append((Cost, Kind, Detail))
+
+    Name = property(_GetName)
+    TypeName = property(_GetTypeName)
+    Cost = property(_GetCost)
+
+## FvPerfLint() class
+#
+#  Parse the firmware volumes of an image and check each of their files
+#
+class FvPerfLint(object):
+    def __init__(self, BaseAddress=None, MaxModuleSize=0x20000, MaxUncompressedSize=0x8000):
+        self.BaseAddress = BaseAddress
+        self.MaxModuleSize = MaxModuleSize
+        self.MaxUncompressedSize = MaxUncompressedSize
+        self.FileList = []
+        self.FvCount = 0
+        self._TempDir = None
+        self._MissingTools = set()
+
+    ## Parse every firmware volume found in an FD or FV file
+    #
+    #  @param  FileName:    The image file
+    #
+    def ParseImageFile(self, FileName):
+        with open(FileName, 'rb') as File:
+            Buffer = File.read()
+        Offset = 0
+        Position = Buffer.find(FV_SIGNATURE)
+        while Position != -1:
+            FvOffset = Position - 40
+            if FvOffset >= Offset and FvOffset % 8 == 0 and self._IsFvHeader(Buffer, FvOffset):
+                FvLength = gFvHeader.unpack_from(Buffer, FvOffset)[1]
+                FvName = "%s@0x%X" % (os.path.basename(FileName), FvOffset)
+                self._ParseFv(Buffer, FvOffset, FvName, False, True, False)
+                Offset = FvOffset + FvLength
+                Position = Buffer.find(FV_SIGNATURE, Offset)
+            else:
+                Position = Buffer.find(FV_SIGNATURE, Position + 1)
+
+    ## Check that a firmware volume header is complete and its checksum valid
+    def _IsFvHeader(self, Buffer, Offset):
+        if Offset + gFvHeader.size > len(Buffer):
+            return False
+        _, FvLength, _, _, HeaderLength, _, _, _ = gFvHeader.unpack_from(Buffer, Offset)
+        if HeaderLength < gFvHeader.size or HeaderLength % 2 != 0 or FvLength < HeaderLength \
+           or Offset + FvLength > len(Buffer):
+            return False
+        return sum(struct.unpack_from("<%dH" % (HeaderLength // 2), Buffer, Offset)) & 0xFFFF == 0
+
+    ## Walk the FFS files of one firmware volume
+    #
+    #  @param  Buffer:      The buffer holding the firmware volume
+    #  @param  FvOffset:    The offset of the firmware volume in the buffer
+    #  @param  FvName:      The name to report the files of this volume with
+    #  @param  Compressed:  Whether the volume was decompressed from its container
+    #  @param  InFlash:     Whether the offsets of the buffer are offsets in the input file
+    #  @param  InReportedFv: Whether the volume is in an FV image reported as uncompressed
+    #
+    def _ParseFv(self, Buffer, FvOffset, FvName, Compressed, InFlash, InReportedFv):
+        if not self._IsFvHeader(Buffer, FvOffset):
+            EdkLogger.verbose("Invalid firmware volume header in %s" % FvName)
+            return
+        self.FvCount += 1
+        _, FvLength, _, Attributes, HeaderLength, _, ExtHeaderOffset, _ = gFvHeader.unpack_from(Buffer, FvOffset)
+        ErasedByte = 0xFF if Attributes & EFI_FVB2_ERASE_POLARITY else 0x00
+        FileOffset = HeaderLength
+        if ExtHeaderOffset != 0:
+            FvNameGuid, ExtHeaderSize = gFvExtHeader.unpack_from(Buffer, FvOffset + ExtHeaderOffset)
+            FvName = GuidToString(FvNameGuid)
+            FileOffset = ExtHeaderOffset + ExtHeaderSize
+        FileOffset = (FileOffset + 7) & ~7
+
+        while FileOffset + gFfsHeader.size <= FvLength:
+            HeaderStart = FvOffset + FileOffset
+            Header = Buffer[HeaderStart : HeaderStart + gFfsHeader.size]
+            if Header.count(ErasedByte) == len(Header):
+                break
+            Name, _, Type, FileAttributes, Size, State = gFfsHeader.unpack(Header)
+            Size = Get24BitSize(Size)
+            HeaderSize = gFfsHeader.size
+            if FileAttributes & FFS_ATTRIB_LARGE_FILE:
+                Size = gFfsHeader2Size.unpack_from(Buffer, HeaderStart + HeaderSize)[0]
+                HeaderSize += gFfsHeader2Size.size
+            if Size < HeaderSize or FileOffset + Size > FvLength:
+                EdkLogger.verbose("Invalid FFS file at offset 0x%X of %s" % (FileOffset, FvName))
+                break
+            if ErasedByte == 0xFF:
+                State ^= 0xFF
+            if (State & EFI_FILE_DATA_VALID) != 0 and (State & (EFI_FILE_DELETED | EFI_FILE_HEADER_INVALID)) == 0 \
+               and Type != EFI_FV_FILETYPE_FFS_PAD:
+                Ffs = FfsFile(GuidToString(Name), Type, Size, FvName)
+                Ffs.InReportedFv = InReportedFv
+                self.FileList.append(Ffs)
+                if Type != EFI_FV_FILETYPE_RAW:
+                    self._ParseSections(Ffs, Buffer, HeaderStart + HeaderSize, HeaderStart + Size, Compressed, InFlash)
+            FileOffset = (FileOffset + Size + 7) & ~7
+
+    ## Walk the sections of an FFS file, including the encapsulated ones
+    #
+    #  @param  Ffs:         The FfsFile the sections belong to
+    #  @param  Buffer:      The buffer holding the sections
+    #  @param  Start:       The offset of the first section
+    #  @param  End:         The offset following the last section
+    #  @param  Compressed:  Whether the sections were decompressed from their container
+    #  @param  InFlash:     Whether the offsets of the buffer are offsets in the input file
+    #
+    def _ParseSections(self, Ffs, Buffer, Start, End, Compressed, InFlash):
+        Offset = Start
+        while Offset + gSectionHeader.size <= End:
+            Size, Type = gSectionHeader.unpack_from(Buffer, Offset)
+            Size = Get24BitSize(Size)
+            HeaderSize = gSectionHeader.size
+            if Size == 0xFFFFFF:
+                Size = gSectionHeader2.unpack_from(Buffer, Offset)[2]
+                HeaderSize = gSectionHeader2.size
+            if Size < HeaderSize or Offset + Size > End:
+                break
+            DataStart = Offset + HeaderSize
+            DataEnd = Offset + Size
+
+            if Type == EFI_SECTION_PE32 or Type == EFI_SECTION_TE:
+                FlashAddress = None
+                if InFlash:
+                    FlashAddress = DataStart
+                Ffs.Images.append((PeImage(Buffer, DataStart, DataEnd - DataStart), Size, Compressed, FlashAddress))
+            elif Type == EFI_SECTION_DXE_DEPEX or Type == EFI_SECTION_MM_DEPEX:
+                Ffs.HasDepex = True
+            elif Type == EFI_SECTION_USER_INTERFACE:
+                Ffs.UiName = Buffer[DataStart : DataEnd].decode('utf-16-le', 'replace').rstrip('\0')
+            elif Type == EFI_SECTION_FIRMWARE_VOLUME_IMAGE:
+                Ffs.FvImages.append((Size, Compressed))
+                InReportedFv = Ffs.InReportedFv or (not Compressed and Size >= self.MaxUncompressedSize)
+                self._ParseFv(Buffer, DataStart, "%s/%s" % (Ffs.FvName, Ffs.Guid), Compressed, InFlash, InReportedFv)
+            elif Type == EFI_SECTION_COMPRESSION:
+                _, CompressionType = gCompressionHeader.unpack_from(Buffer, DataStart)
+                Data = Buffer[DataStart + gCompressionHeader.size : DataEnd]
+                if CompressionType == EFI_NOT_COMPRESSED:
+                    self._ParseSections(Ffs, Buffer, DataStart + gCompressionHeader.size, DataEnd, Compressed, InFlash)
+                else:
+                    Data = self._Decompress("TianoCompress", ["--uefi"], Data)
+                    if Data is not None:
+                        self._ParseSections(Ffs, Data, 0, len(Data), True, False)
+            elif Type == EFI_SECTION_GUID_DEFINED:
+                Guid, DataOffset, Attributes = gGuidDefinedHeader.unpack_from(Buffer, DataStart)
+                Guid = GuidToString(Guid)
+                if (Attributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0:
+                    self._ParseSections(Ffs, Buffer, Offset + DataOffset, DataEnd, Compressed, InFlash)
+                elif Guid in gGuidToolDict:
+                    Data = self._Decompress(gGuidToolDict[Guid], [], Buffer[Offset + DataOffset : DataEnd])
+                    if Data is not None:
+                        self._ParseSections(Ffs, Data, 0, len(Data), True, False)
+                else:
+                    EdkLogger.verbose("No tool to process GUID defined section %s in %s" % (Guid, Ffs.Guid))
+
+            Offset = (Offset + Size + 3) & ~3
+
+    ## Decompress a section with the BaseTools compression tools
+    #
+    #  @param  Tool:        The tool to run
+    #  @param  Options:     The options selecting the algorithm of the tool
+    #  @param  Data:        The compressed data
+    #
+    #  @retval Data         The decompressed data, or None if the tool failed
+    #
+    def _Decompress(self, Tool, Options, Data):
+        if Tool in self._MissingTools:
+            return None
+        if self._TempDir is None:
+            self._TempDir = tempfile.mkdtemp(prefix="FvPerfLint")
+        InputFile = os.path.join(self._TempDir, "Compressed.bin")
+        OutputFile = os.path.join(self._TempDir, "Decompressed.bin")
+        with open(InputFile, 'wb') as File:
+            File.write(Data)
+        if os.path.exists(OutputFile):
+            os.remove(OutputFile)
+        Cmd = [Tool, "-d"] + Options + ["-o", OutputFile, InputFile]
+        Process = Popen(' '.join(Cmd), stdout=PIPE, stderr=PIPE, shell=True)
+        Process.communicate()
+        if Process.returncode != 0 or not os.path.exists(OutputFile):
+            EdkLogger.warn("FvPerfLint", "Failed to run %s, modules compressed with it are not checked" % Tool)
+            self._MissingTools.add(Tool)
+            return None
+        with open(OutputFile, 'rb') as File:
+            return File.read()
+
+    ## Remove the files of the decompression tools
+    def Cleanup(self):
+        if self._TempDir is not None:
+            shutil.rmtree(self._TempDir, True)
+            self._TempDir = None
+
+    ## Check every parsed FFS file and record its issues
+    def Check(self):
+        for Ffs in self.FileList:
+            self._CheckFvImages(Ffs)
+            self._CheckDepex(Ffs)
+            for (Image, SectionSize, Compressed, FlashAddress) in Ffs.Images:
+                if Image.Kind is None:
+                    continue
+                self._CheckCompression(Ffs, Image, SectionSize, Compressed)
+                self._CheckSize(Ffs, Image)
+                self._CheckDebug(Ffs, Image)
+                self._CheckRelocation(Ffs, Image, Compressed, FlashAddress)
+
+    ## Volumes stored uncompressed are read from flash in full by the loader
+    def _CheckFvImages(self, Ffs):
+        for (SectionSize, Compressed) in Ffs.FvImages:
+            if not Compressed and SectionSize >= self.MaxUncompressedSize:
+                Ffs.AddIssue(SectionSize, ISSUE_UNCOMPRESSED_FV,
+                             "firmware volume of %d bytes is stored uncompressed" % SectionSize)
+
+    ## Drivers without DEPEX only run once all architectural protocols are installed
+    def _CheckDepex(self, Ffs):
+        if Ffs.Type in gDepexFileTypes and not Ffs.HasDepex:
+            Ffs.AddIssue(0, ISSUE_NO_DEPEX,
+                         "no DEPEX, dispatched only after all architectural protocols are installed")
+
+    ## Images loaded to memory should be compressed so that less flash is read,
+    #  the files of an uncompressed FV image are already reported with the volume
+    def _CheckCompression(self, Ffs, Image, SectionSize, Compressed):
+        if Compressed or Ffs.InReportedFv or Ffs.Type in gXipFileTypes or SectionSize < self.MaxUncompressedSize:
+            return
+        Ffs.AddIssue(SectionSize, ISSUE_UNCOMPRESSED,
+                     "%s image of %d bytes is stored uncompressed" % (Image.Kind, SectionSize))
+
+    def _CheckSize(self, Ffs, Image):
+        if Image.SizeOfImage > self.MaxModuleSize:
+            Ffs.AddIssue(Image.SizeOfImage - self.MaxModuleSize, ISSUE_OVERSIZED,
+                         "image size %d bytes exceeds %d bytes" % (Image.SizeOfImage, self.MaxModuleSize))
+
+    ## Debug builds are larger and slower, and print over slow consoles
+    def _CheckDebug(self, Ffs, Image):
+        Target = Image.BuildTarget
+        if Target in ("DEBUG", "NOOPT"):
+            Ffs.AddIssue(Image.SizeOfImage, ISSUE_DEBUG_BUILD, "%s build (%s)" % (Target, Image.PdbPath))
+        elif Image.HasDebugLib:
+            Ffs.AddIssue(Image.SizeOfImage, ISSUE_DEBUG_OUTPUT,
+                         "%s build links a DebugLib instance that prints" % (Target or "unknown target"))
+
+    ## Images executed before memory is available must be linked at their flash address
+    def _CheckRelocation(self, Ffs, Image, Compressed, FlashAddress):
+        if Ffs.Type not in gXipFileTypes:
+            return
+        if Compressed:
+            Ffs.AddIssue(Image.SizeOfImage, ISSUE_RELOCATION,
+                         "compressed, so it is decompressed and relocated in memory before it runs")
+            return
+        if FlashAddress is None:
+            return
+        if self.BaseAddress is None:
+            if Image.ImageBase == 0 and Image.RelocSize != 0:
+                Ffs.AddIssue(Image.SizeOfImage, ISSUE_RELOCATION,
+                             "linked at address 0, so it is not rebased to execute in place")
+            return
+        ExpectedBase = self.BaseAddress + FlashAddress
+        if Image.Kind == "TE":
+            ExpectedBase -= Image._RvaAdjust
+        if Image.ImageBase != ExpectedBase and Image.RelocSize != 0:
+            Ffs.AddIssue(Image.SizeOfImage, ISSUE_RELOCATION,
+                         "linked at 0x%X but stored at 0x%X, so it is relocated in memory before it runs" % \
+                         (Image.ImageBase, ExpectedBase))
+
+    ## Write the files with issues, most costly first
+    #
+    #  @param  Output:      The stream to write the report to
+    #  @param  InputFiles:  The names of the images the report is for
+    #
+    def Report(self, Output, InputFiles):
+        IssueFiles = [Ffs for Ffs in self.FileList if Ffs.Issues]
+        IssueFiles.sort(key=lambda Ffs: (-Ffs.Cost, Ffs.Name))
+        Output.write("Boot performance report for %s\n" % ", ".join(InputFiles))
+        Output.write("%d firmware volumes, %d files, %d files with issues\n" % \
+                     (self.FvCount, len(self.FileList), len(IssueFiles)))
+        Output.write("Cost is the number of image bytes affected by the issues of the file.\n\n")
+        Output.write("%4s %10s  %-36s %-14s %s\n" % ("Rank", "Cost", "Module", "Type", "FV"))
+        Rank = 0
+        for Ffs in IssueFiles:
+            Rank += 1
+            Output.write("%4d %10d  %-36s %-14s %s\n" % (Rank, Ffs.Cost, Ffs.Name, Ffs.TypeName, Ffs.FvName))
+            for (Cost, Kind, Detail) in sorted(Ffs.Issues, key=lambda Issue: -Issue[0]):
+                Output.write("%4s %10d    %-15s %s\n" % ("", Cost, Kind, Detail))
+
+        KindCount = {}
+        for Ffs in IssueFiles:
+            for Issue in Ffs.Issues:
+                KindCount[Issue[1]] = KindCount.get(Issue[1], 0) + 1
+        if KindCount:
+            Output.write("\nSummary:\n")
+            for Kind in sorted(KindCount):
+                Output.write("  %-15s %d\n" % (Kind, KindCount[Kind]))
+
+## Parse a number given on the command line
+def ParseNumber(Option, Value):
+    try:
+        return int(Value, 0)
+    except ValueError:
+        EdkLogger.error("FvPerfLint", OPTION_VALUE_INVALID, "Invalid value of %s: %s" % (Option, Value))
+
+## Parse command line options
+#
+# Using standard Python module optparse to parse command line option of this tool.
+#
+#  @retval Options   A optparse.Values object containing the parsed options
+#  @retval Args      Target of build command
+#
+def Options():
+    OptionList = [
+        make_option("-o", "--output", dest="OutputFile",
+                          help="File to store the report in, in addition to the console"),
+        make_option("-b", "--base-address", dest="BaseAddress",
+                          help="Address of the first byte of the input image in flash, used to check that " \
+                               "execute in place images are rebased"),
+        make_option("--max-module-size", dest="MaxModuleSize", default="0x20000",
+                          help="Report images larger than this size in memory [default: %default]"),
+        make_option("--max-uncompressed-size", dest="MaxUncompressedSize", default="0x8000",
+                          help="Report uncompressed images and volumes from this size on [default: %default]"),
+        make_option("-v", "--verbose", dest="LogLevel", action="store_const", const=EdkLogger.VERBOSE,
+                          help="Run verbosely"),
+        make_option("-d", "--debug", dest="LogLevel", type="int",
+                          help="Run with debug information"),
+        make_option("-q", "--quiet", dest="LogLevel", action="store_const", const=EdkLogger.QUIET,
+                          help="Run quietly"),
+        make_option("-?", action="help", help="show this help message and exit"),
+    ]
+
+    # use clearer usage to override default usage message
+    UsageString = "%prog [-o <output_file>] [-b <base_address>] [--max-module-size <size>] " \
+                  "[--max-uncompressed-size <size>] [-v|-d <debug_level>|-q] <fd_or_fv_file> [<fd_or_fv_file> ...]"
+
+    Parser = OptionParser(description=__copyright__, version=__version__, option_list=OptionList, usage=UsageString)
+    Parser.set_defaults(LogLevel=EdkLogger.INFO)
+
+    Options, Args = Parser.parse_args()
+
+    # error check
+    if len(Args) == 0:
+        EdkLogger.error("FvPerfLint", OPTION_MISSING, ExtraData=Parser.get_usage())
+    for InputFile in Args:
+        if not os.path.isfile(InputFile):
+            EdkLogger.error("FvPerfLint", FILE_NOT_FOUND, ExtraData=InputFile)
+
+    return Options, Args
+
+## Entrance method
+#
+# This method mainly dispatch specific methods per the command line options.
+# If no error found, return zero value so the caller of this tool can know
+# if it's executed successfully or not.
+#
+#  @retval 0     Tool was successful
+#  @retval 1     Tool failed
+#
+def Main():
+    try:
+        EdkLogger.Initialize()
+        CommandOptions, InputFiles = Options()
+        if CommandOptions.LogLevel < EdkLogger.DEBUG_9:
+            EdkLogger.SetLevel(CommandOptions.LogLevel + 1)
+        else:
+            EdkLogger.SetLevel(CommandOptions.LogLevel)
+        BaseAddress = None
+        if CommandOptions.BaseAddress is not None:
+            BaseAddress = ParseNumber("--base-address", CommandOptions.BaseAddress)
+        MaxModuleSize = ParseNumber("--max-module-size", CommandOptions.MaxModuleSize)
+        MaxUncompressedSize = ParseNumber("--max-uncompressed-size", CommandOptions.MaxUncompressedSize)
+    except FatalError as X:
+        return 1
+
+    Lint = FvPerfLint(BaseAddress, MaxModuleSize, MaxUncompressedSize)
+    try:
+        for InputFile in InputFiles:
+            Lint.ParseImageFile(InputFile)
+        if Lint.FvCount == 0:
+            EdkLogger.error("FvPerfLint", FORMAT_INVALID, "No firmware volume found", ExtraData=", ".join(InputFiles))
+        Lint.Check()
+        Lint.Report(sys.stdout, InputFiles)
+        if CommandOptions.OutputFile is not None:
+            with open(CommandOptions.OutputFile, 'w') as Output:
+                Lint.Report(Output, InputFiles)
+    except FatalError as X:
+        import platform
+        import traceback
+        if CommandOptions is not None and CommandOptions.LogLevel <= EdkLogger.DEBUG_9:
+            EdkLogger.quiet("(Python %s on %s) " % (platform.python_version(), sys.platform) + traceback.format_exc())
+        return 1
+    except:
+        import traceback
+        import platform
+        EdkLogger.error(
+                    "\nFvPerfLint",
+                    CODE_ERROR,
+                    "Unknown fatal error when checking [%s]" % ", ".join(InputFiles),
+                    ExtraData="\n(Please send email to %s for help, attaching following call stack trace!)\n" % MSG_EDKII_MAIL_ADDR,
+                    RaiseError=False
+                    )
+        EdkLogger.quiet("(Python %s on %s) " % (platform.python_version(), sys.platform) + traceback.format_exc())
+        return 1
+    finally:
+        Lint.Cleanup()
+
+    return 0
+
+if __name__ == '__main__':
+    r = Main()
+    ## 0-127 is a safe return range, and 1 is a standard default error
+    if r < 0 or r > 127: r = 1
+    sys.exit(r)
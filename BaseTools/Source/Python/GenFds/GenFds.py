@@ -18,6 +18,7 @@ from glob import glob
 from struct import unpack
 from linecache import getlines
 from io import BytesIO
+from concurrent.futures import ThreadPoolExecutor, wait, FIRST_COMPLETED
 
 import Common.LongFilePathOs as os
 from Common.TargetTxtClassObject import TargetTxtDict
@@ -33,7 +34,7 @@ from Common.BuildToolError import FatalError, GENFDS_ERROR, CODE_ERROR, FORMAT_I
 from Workspace.WorkspaceDatabase import WorkspaceDatabase
 
 from .FdfParser import FdfParser, Warning
-from .GenFdsGlobalVariable import GenFdsGlobalVariable
+from .GenFdsGlobalVariable import GenFdsGlobalVariable, LargeFileFlagStack
 from .FfsFileStatement import FileStatement
 import Common.DataType as DataType
 from struct import Struct
@@ -94,8 +95,11 @@ def resetFdsGlobalVariable():
     GenFdsGlobalVariable.CopyList   = []
     GenFdsGlobalVariable.ModuleFile = ''
     GenFdsGlobalVariable.EnableGenfdsMultiThread = True
+    GenFdsGlobalVariable.ThreadNumber = 1
+    GenFdsGlobalVariable.EnableGenfdsCache = False
+    GenFdsGlobalVariable.ToolHashDict = {}
 
-    GenFdsGlobalVariable.LargeFileInFvFlags = []
+    GenFdsGlobalVariable.LargeFileInFvFlags = LargeFileFlagStack()
     GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
     GenFdsGlobalVariable.LARGE_FILE_SIZE = 0x1000000
 
@@ -119,6 +123,12 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
         if FdsCommandDict.get("FixedAddress"):
             GenFdsGlobalVariable.FixedLoadAddress = True
 
+        if FdsCommandDict.get("ThreadNumber"):
+            GenFdsGlobalVariable.ThreadNumber = FdsCommandDict.get("ThreadNumber")
+
+        if FdsCommandDict.get("GenfdsCache"):
+            GenFdsGlobalVariable.EnableGenfdsCache = True
+
         if FdsCommandDict.get("quiet"):
             EdkLogger.SetLevel(EdkLogger.QUIET)
         if FdsCommandDict.get("debug"):
@@ -407,6 +417,8 @@ def OptionsToCommandDict(Options):
     FdsCommandDict["debug"] = Options.debug
     FdsCommandDict["Workspace"] = Options.Workspace
     FdsCommandDict["GenfdsMultiThread"] = not Options.NoGenfdsMultiThread
+    FdsCommandDict["ThreadNumber"] = Options.ThreadNumber
+    FdsCommandDict["GenfdsCache"] = Options.GenfdsCache
     FdsCommandDict["fdf_file"] = [PathClass(Options.filename)] if Options.filename else []
     FdsCommandDict["build_target"] = Options.BuildTarget
     FdsCommandDict["toolchain_tag"] = Options.ToolChain
@@ -465,6 +477,8 @@ def myOptionParser():
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
     Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
     Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+    Parser.add_option("-n", action="store", type="int", dest="ThreadNumber", default=1, help="Generate the FV images that are not in a FD region with up to ThreadNumber threads.")
+    Parser.add_option("--genfds-cache", action="store_true", dest="GenfdsCache", default=False, help="Reuse the outputs of the external tools of a previous run when their inputs are unchanged.")
 
     Options, _ = Parser.parse_args()
     return Options
@@ -506,6 +520,8 @@ class GenFds(object):
                 FdObj.GenFd()
                 return
         elif GenFds.OnlyGenerateThisFd is None and GenFds.OnlyGenerateThisFv is None:
+            if GenFds.OnlyGenerateThisCap is None and GenFdsGlobalVariable.ThreadNumber > 1:
+                GenFds.GenFvsInParallel(GenFdsGlobalVariable.ThreadNumber)
             for FdObj in GenFdsGlobalVariable.FdfParser.Profile.FdDict.values():
                 FdObj.GenFd()
 
@@ -534,6 +550,110 @@ class GenFds(object):
                 for OptRomObj in GenFdsGlobalVariable.FdfParser.Profile.OptRomDict.values():
                     OptRomObj.AddToBuffer(None)
 
+    ## GetFvDependencies()
+    #
+    #   @param  FvObj           The FV object
+    #   @retval set             The names of the FVs that FvObj contains, through
+    #                           FILE statements and FV_IMAGE sections
+    #   @retval None            FvObj contains a FD
+    #
+    @staticmethod
+    def GetFvDependencies(FvObj):
+        Dependencies = set()
+        SectionList = []
+        for FfsFile in FvObj.FfsList:
+            if isinstance(FfsFile, FileStatement):
+                if FfsFile.FdName:
+                    return None
+                if FfsFile.FvName:
+                    Dependencies.add(FfsFile.FvName.upper())
+                SectionList.extend(FfsFile.SectionList)
+        while SectionList:
+            Section = SectionList.pop()
+            if getattr(Section, 'FvName', None):
+                Dependencies.add(Section.FvName.upper())
+            elif getattr(Section, 'Fv', None) is not None:
+                NestedDependencies = GenFds.GetFvDependencies(Section.Fv)
+                if NestedDependencies is None:
+                    return None
+                Dependencies |= NestedDependencies
+            SectionList.extend(getattr(Section, 'SectionList', []))
+        return Dependencies
+
+    ## GenFvsInParallel()
+    #
+    #   Generate the FVs that are neither in a FD region nor in a capsule, before
+    #   the FDs, with a pool of threads. A FV is only generated once the FVs it
+    #   contains are generated, the FDs and the FVs that contain it then find it
+    #   in ImageBinDict.
+    #
+    #   @param  ThreadNumber    The maximum number of FVs generated at the same time
+    #
+    @staticmethod
+    def GenFvsInParallel(ThreadNumber):
+        FvDict = GenFdsGlobalVariable.FdfParser.Profile.FvDict
+        RegionFvSet = set()
+        for FdObj in GenFdsGlobalVariable.FdfParser.Profile.FdDict.values():
+            for RegionObj in FdObj.RegionList:
+                if RegionObj.RegionType == BINARY_FILE_TYPE_FV:
+                    for RegionData in RegionObj.RegionDataList:
+                        if RegionData is not None:
+                            RegionFvSet.add(RegionData.upper())
+
+        DependencyDict = {}
+        for FvName, FvObj in FvDict.items():
+            if FvName in RegionFvSet or FvObj.CapsuleName is not None:
+                continue
+            Dependencies = GenFds.GetFvDependencies(FvObj)
+            if Dependencies is not None:
+                DependencyDict[FvName] = Dependencies
+
+        #
+        # Leave the FVs that contain a FV generated later to the serial generation.
+        #
+        Changed = True
+        while Changed:
+            Changed = False
+            for FvName in list(DependencyDict):
+                if not DependencyDict[FvName] <= set(DependencyDict):
+                    del DependencyDict[FvName]
+                    Changed = True
+        if len(DependencyDict) < 2:
+            return
+
+        GenFdsGlobalVariable.VerboseLogger("\n Generate %d FV images with %d threads! " % (len(DependencyDict), ThreadNumber))
+        Done = set()
+        Running = {}
+        with ThreadPoolExecutor(max_workers=ThreadNumber) as Executor:
+            while DependencyDict:
+                for FvName in [Name for Name in DependencyDict if DependencyDict[Name] <= Done]:
+                    del DependencyDict[FvName]
+                    Running[Executor.submit(GenFds.GenFvInThread, FvDict[FvName])] = FvName
+                if not Running:
+                    # A cycle, reported by the serial generation
+                    break
+                Finished, _ = wait(Running, return_when=FIRST_COMPLETED)
+                for Future in Finished:
+                    Done.add(Running.pop(Future))
+                    Future.result()
+            for Future in Running:
+                Future.result()
+
+    ## GenFvInThread()
+    #
+    #   @param  FvObj           The FV object to generate
+    #
+    @staticmethod
+    def GenFvInThread(FvObj):
+        with GenFdsGlobalVariable.ParallelLock:
+            GenFdsGlobalVariable.ParallelThread.Locked = True
+            try:
+                Buffer = BytesIO()
+                FvObj.AddToBuffer(Buffer)
+                Buffer.close()
+            finally:
+                GenFdsGlobalVariable.ParallelThread.Locked = False
+
     @staticmethod
     def GenFfsMakefile(OutputDir, FdfParserObject, WorkSpace, ArchList, GlobalData):
         GenFdsGlobalVariable.SetEnv(FdfParserObject, WorkSpace, ArchList, GlobalData)
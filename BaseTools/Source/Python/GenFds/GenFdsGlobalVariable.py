@@ -14,6 +14,9 @@ from __future__ import absolute_import
 
 import Common.LongFilePathOs as os
 import sys
+import hashlib
+import shutil
+import threading
 from sys import stdout
 from subprocess import PIPE,Popen
 from struct import Struct
@@ -21,7 +24,7 @@ from array import array
 
 from Common.BuildToolError import COMMAND_FAILURE,GENFDS_ERROR
 from Common import EdkLogger
-from Common.Misc import SaveFileOnChange
+from Common.Misc import SaveFileOnChange, CreateDirectory
 
 from Common.TargetTxtClassObject import TargetTxtDict
 from Common.ToolDefClassObject import ToolDefDict
@@ -29,9 +32,34 @@ from AutoGen.BuildEngine import ToolBuildRule
 import Common.DataType as DataType
 from Common.Misc import PathClass
 from Common.LongFilePathSupport import OpenLongFilePath as open
+from Common.LongFilePathSupport import CopyLongFilePath
 from Common.MultipleWorkspace import MultipleWorkspace as mws
 import Common.GlobalData as GlobalData
 
+## Stack of the large file flags of the FVs generated by the current thread
+#
+#   The FVs are generated by several threads when GenFds runs with more than
+#   one thread, each thread keeps the flags of its own nested FVs.
+#
+class LargeFileFlagStack(threading.local):
+    def __init__(self):
+        self.Flags = []
+
+    def append(self, Flag):
+        self.Flags.append(Flag)
+
+    def pop(self):
+        return self.Flags.pop()
+
+    def __getitem__(self, Index):
+        return self.Flags[Index]
+
+    def __setitem__(self, Index, Flag):
+        self.Flags[Index] = Flag
+
+    def __len__(self):
+        return len(self.Flags)
+
 ## Global variables
 #
 #
@@ -71,6 +99,18 @@ class GenFdsGlobalVariable:
     CopyList   = []
     ModuleFile = ''
     EnableGenfdsMultiThread = True
+    ThreadNumber = 1
+    EnableGenfdsCache = False
+    ToolHashDict = {}
+
+    #
+    # The Python part of the FV generation is serialized by ParallelLock, the
+    # lock is only released while an external tool runs. The FVs generated by
+    # several threads then only run their tools in parallel, and the global
+    # variables of this class do not need any other protection.
+    #
+    ParallelLock = threading.Lock()
+    ParallelThread = threading.local()
 
     #
     # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
@@ -81,7 +121,7 @@ class GenFdsGlobalVariable:
     # At the end of generation of FV, pop the flag.
     # List is used as a stack to handle nested FV generation.
     #
-    LargeFileInFvFlags = []
+    LargeFileInFvFlags = LargeFileFlagStack()
     EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
     LARGE_FILE_SIZE = 0x1000000
 
@@ -483,7 +523,7 @@ class GenFdsGlobalVariable:
             else:
                 if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                     return
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallCachedTool(Cmd, Output, "Failed to generate section")
         else:
             Cmd += ("-o", Output)
             Cmd += Input
@@ -498,7 +538,7 @@ class GenFdsGlobalVariable:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallCachedTool(Cmd, Output, "Failed to generate section")
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
                     GenFdsGlobalVariable.LargeFileInFvFlags):
                     GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
@@ -554,7 +594,7 @@ class GenFdsGlobalVariable:
         else:
             if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 return
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            GenFdsGlobalVariable.CallCachedTool(Cmd, Output, "Failed to generate FFS")
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
@@ -682,7 +722,64 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue)
+            GenFdsGlobalVariable.CallCachedTool(Cmd, Output, "Failed to call " + ToolPath, returnValue)
+
+    ## CallCachedTool()
+    #
+    #   Call an external tool, or restore its output from the GenFds cache when
+    #   the tool already ran with the same command line and the same input file
+    #   contents. The cache is in the FV directory, so it is kept between the
+    #   incremental builds of a platform.
+    #
+    #   @param  Cmd             The command line of the tool
+    #   @param  Output          The output file of the tool
+    #   @param  errorMess       The error message when the tool fails
+    #   @param  returnValue     See CallExternalTool()
+    #
+    @staticmethod
+    def CallCachedTool(Cmd, Output, errorMess, returnValue=[]):
+        if not GenFdsGlobalVariable.EnableGenfdsCache:
+            GenFdsGlobalVariable.CallExternalTool(Cmd, errorMess, returnValue)
+            return
+
+        #
+        # The key hashes the tool binary, the arguments and the content of the
+        # arguments that are files. The output file is left out.
+        #
+        Hash = hashlib.sha256()
+        ToolFile = shutil.which(Cmd[0])
+        if ToolFile:
+            if ToolFile not in GenFdsGlobalVariable.ToolHashDict:
+                with open(ToolFile, 'rb') as File:
+                    GenFdsGlobalVariable.ToolHashDict[ToolFile] = hashlib.sha256(File.read()).digest()
+            Hash.update(GenFdsGlobalVariable.ToolHashDict[ToolFile])
+        for Arg in Cmd:
+            if Arg == Output:
+                continue
+            Hash.update(Arg.encode('utf-8') + b'\0')
+            if os.path.isfile(Arg):
+                with open(Arg, 'rb') as File:
+                    Hash.update(File.read())
+        CacheDir = os.path.join(GenFdsGlobalVariable.FvDir, 'GenFdsCache')
+        CacheFile = os.path.join(CacheDir, Hash.hexdigest())
+
+        if os.path.isfile(CacheFile):
+            GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s restored from %s" % (Output, CacheFile))
+            CopyLongFilePath(CacheFile, Output)
+            return
+
+        GenFdsGlobalVariable.CallExternalTool(Cmd, errorMess, returnValue)
+        if returnValue != [] and returnValue[0] != 0:
+            return
+        if os.path.isfile(Output):
+            #
+            # Copy to a temporary file first, a concurrent build must never
+            # read a partial cache file.
+            #
+            CreateDirectory(CacheDir)
+            TempFile = '%s.%d' % (CacheFile, threading.get_ident())
+            CopyLongFilePath(Output, TempFile)
+            os.replace(TempFile, CacheFile)
 
     @staticmethod
     def CallExternalTool (cmd, errorMess, returnValue=[]):
@@ -704,11 +801,21 @@ class GenFdsGlobalVariable:
             if GenFdsGlobalVariable.SharpCounter % GenFdsGlobalVariable.SharpNumberPerLine == 0:
                 stdout.write('\n')
 
+        #
+        # Let the other FV generation threads run while the tool runs.
+        #
+        Locked = getattr(GenFdsGlobalVariable.ParallelThread, 'Locked', False)
+        if Locked:
+            GenFdsGlobalVariable.ParallelLock.release()
         try:
-            PopenObject = Popen(' '.join(cmd), stdout=PIPE, stderr=PIPE, shell=True)
-        except Exception as X:
-            EdkLogger.error("GenFds", COMMAND_FAILURE, ExtraData="%s: %s" % (str(X), cmd[0]))
-        (out, error) = PopenObject.communicate()
+            try:
+                PopenObject = Popen(' '.join(cmd), stdout=PIPE, stderr=PIPE, shell=True)
+            except Exception as X:
+                EdkLogger.error("GenFds", COMMAND_FAILURE, ExtraData="%s: %s" % (str(X), cmd[0]))
+            (out, error) = PopenObject.communicate()
+        finally:
+            if Locked:
+                GenFdsGlobalVariable.ParallelLock.acquire()
 
         while PopenObject.returncode is None:
             PopenObject.wait()
@@ -750,6 +750,7 @@ class Build():
         GlobalData.gBinCacheDest   = BuildOptions.BinCacheDest
         GlobalData.gBinCacheSource = BuildOptions.BinCacheSource
         GlobalData.gEnableGenfdsMultiThread = not BuildOptions.NoGenfdsMultiThread
+        GlobalData.gEnableGenfdsCache = BuildOptions.GenfdsCache
         GlobalData.gDisableIncludePathCheck = BuildOptions.DisableIncludePathCheck
 
         if GlobalData.gBinCacheDest and not GlobalData.gUseHashCache:
@@ -953,6 +954,7 @@ class Build():
 
             self.PlatformFile = PathClass(NormFile(PlatformFile, self.WorkspaceDir), self.WorkspaceDir)
         self.ThreadNumber   = ThreadNum()
+        GlobalData.gGenfdsThreadNumber = self.ThreadNumber
     ## Initialize build configuration
     #
     #   This method will parse DSC file and merge the configurations from
@@ -620,6 +620,60 @@ DumpMemoryProfileMemoryRange (
   return (VOID *) Descriptor;
 }
 
+// MU_CHANGE [BEGIN] - Fixed size allocation event ring
+/**
+  Dump memory profile allocation event ring.
+
+  @param[in] EventRing          Pointer to memory profile event ring.
+  @param[in] IsForSmm           TRUE  - SMRAM profile.
+                                FALSE - UEFI memory profile.
+
+  @return Pointer to the end of memory profile event ring buffer.
+
+**/
+VOID *
+DumpMemoryProfileEventRing (
+  IN MEMORY_PROFILE_EVENT_RING      *EventRing,
+  IN BOOLEAN                        IsForSmm
+  )
+{
+  MEMORY_PROFILE_EVENT          *Event;
+  UINTN                         EventIndex;
+
+  if (EventRing->Header.Signature != MEMORY_PROFILE_EVENT_RING_SIGNATURE) {
+    return NULL;
+  }
+  Print (L"MEMORY_PROFILE_EVENT_RING\n");
+  Print (L"  Signature                     - 0x%08x\n", EventRing->Header.Signature);
+  Print (L"  Length                        - 0x%04x\n", EventRing->Header.Length);
+  Print (L"  Revision                      - 0x%04x\n", EventRing->Header.Revision);
+  Print (L"  EventCount                    - 0x%08x\n", EventRing->EventCount);
+  Print (L"  RingSize                      - 0x%08x\n", EventRing->RingSize);
+  Print (L"  TotalEventCount               - 0x%016lx\n", EventRing->TotalEventCount);
+  Print (L"  TimestampFrequency            - 0x%016lx\n", EventRing->TimestampFrequency);
+
+  Event = (MEMORY_PROFILE_EVENT *) ((UINTN) EventRing + EventRing->Header.Length);
+  for (EventIndex = 0; EventIndex < EventRing->EventCount; EventIndex++) {
+    if (Event->Header.Signature != MEMORY_PROFILE_EVENT_SIGNATURE) {
+      return NULL;
+    }
+    Print (
+      L"  Event (0x%x) - 0x%016lx %a 0x%016lx 0x%016lx %a\n",
+      EventIndex,
+      Event->Timestamp,
+      ProfileActionToStr (Event->Action, NULL, IsForSmm),
+      Event->Buffer,
+      Event->Size,
+      ProfileMemoryTypeToStr (Event->MemoryType)
+      );
+    Print (L"                   Caller - 0x%016lx\n", Event->CallerAddress);
+    Event = (MEMORY_PROFILE_EVENT *) ((UINTN) Event + Event->Header.Length);
+  }
+
+  return (VOID *) Event;
+}
+// MU_CHANGE [END]
+
 /**
   Scan memory profile by Signature.
 
@@ -678,6 +732,7 @@ DumpMemoryProfile (
   MEMORY_PROFILE_CONTEXT        *Context;
   MEMORY_PROFILE_FREE_MEMORY    *FreeMemory;
   MEMORY_PROFILE_MEMORY_RANGE   *MemoryRange;
+  MEMORY_PROFILE_EVENT_RING     *EventRing;     // MU_CHANGE
 
   Context = (MEMORY_PROFILE_CONTEXT *) ScanMemoryProfileBySignature (ProfileBuffer, ProfileSize, MEMORY_PROFILE_CONTEXT_SIGNATURE);
   if (Context != NULL) {
@@ -693,6 +748,13 @@ DumpMemoryProfile (
   if (MemoryRange != NULL) {
     DumpMemoryProfileMemoryRange (MemoryRange);
   }
+
+  // MU_CHANGE [BEGIN] - Fixed size allocation event ring
+  EventRing = (MEMORY_PROFILE_EVENT_RING *) ScanMemoryProfileBySignature (ProfileBuffer, ProfileSize, MEMORY_PROFILE_EVENT_RING_SIGNATURE);
+  if (EventRing != NULL) {
+    DumpMemoryProfileEventRing (EventRing, IsForSmm);
+  }
+  // MU_CHANGE [END]
 }
 
 /**
@@ -28,6 +28,11 @@ CHAR8 mNameString[PROFILE_NAME_STRING_LENGTH + 1];
 VOID   *mSmiHandlerProfileDatabase;
 UINTN  mSmiHandlerProfileDatabaseSize;
 
+// MU_CHANGE [BEGIN] - Add SMI history
+EFI_SMM_COMMUNICATION_PROTOCOL  *mSmmCommunication;
+UINT8                           *mCommBuffer;
+// MU_CHANGE [END]
+
 /**
   This function dump raw data.
 
@@ -103,6 +108,11 @@ GetSmiHandlerProfileDatabase(
   ASSERT(Index < PiSmmCommunicationRegionTable->NumberOfEntries);
   CommBuffer = (UINT8 *)(UINTN)Entry->PhysicalStart;
 
+  // MU_CHANGE [BEGIN] - Add SMI history
+  mSmmCommunication = SmmCommunication;
+  mCommBuffer       = CommBuffer;
+  // MU_CHANGE [END]
+
   //
   // Get Size
   //
@@ -324,6 +334,35 @@ GetImageFromRef (
   return NULL;
 }
 
+// MU_CHANGE [BEGIN] - Add SMI history
+/**
+  Get image structure from an address inside the image.
+
+  @param Address   the address inside the image
+
+  @return image structure
+**/
+SMM_CORE_IMAGE_DATABASE_STRUCTURE *
+GetImageFromAddress (
+  IN PHYSICAL_ADDRESS Address
+  )
+{
+  SMM_CORE_IMAGE_DATABASE_STRUCTURE  *ImageStruct;
+
+  ImageStruct = (VOID *)mSmiHandlerProfileDatabase;
+  while ((UINTN)ImageStruct < (UINTN)mSmiHandlerProfileDatabase + mSmiHandlerProfileDatabaseSize) {
+    if (ImageStruct->Header.Signature == SMM_CORE_IMAGE_DATABASE_SIGNATURE) {
+      if ((Address >= ImageStruct->ImageBase) && (Address - ImageStruct->ImageBase < ImageStruct->ImageSize)) {
+        return ImageStruct;
+      }
+    }
+    ImageStruct = (VOID *)((UINTN)ImageStruct + ImageStruct->Header.Length);
+  }
+
+  return NULL;
+}
+// MU_CHANGE [END]
+
 /**
   Dump SMM loaded image information.
 **/
@@ -612,6 +651,11 @@ DumpSmiHandler(
           Print(L"         <RVA>0x%x</RVA>\n", (UINTN) (SmiHandlerStruct->CallerAddr - ImageStruct->ImageBase));
         }
         Print(L"      </Caller>\n", SmiHandlerStruct->Handler);
+        // MU_CHANGE [BEGIN] - Add handler statistics
+        if ((SmiStruct->Header.Revision >= 0x0002) && (HandlerCategory != SmmCoreSmiHandlerCategoryHardwareHandler)) {
+          Print(L"      <Statistics HitCount=\"%ld\" TotalTimeNs=\"%ld\" MaxTimeNs=\"%ld\" />\n", SmiHandlerStruct->HitCount, SmiHandlerStruct->TotalTime, SmiHandlerStruct->MaxTime);
+        }
+        // MU_CHANGE [END]
         SmiHandlerStruct = (VOID *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
         Print(L"    </SmiHandler>\n");
       }
@@ -623,6 +667,69 @@ DumpSmiHandler(
   return;
 }
 
+// MU_CHANGE [BEGIN] - Add SMI history
+/**
+  Get and dump the SMI history: the SMI latency histogram, the highest SMI
+  rate seen and the last SMIs.
+**/
+VOID
+DumpSmiHistory(
+  VOID
+  )
+{
+  EFI_STATUS                                     Status;
+  UINTN                                          CommSize;
+  EFI_SMM_COMMUNICATE_HEADER                     *CommHeader;
+  SMI_HANDLER_PROFILE_PARAMETER_GET_SMI_HISTORY  *CommGetHistory;
+  SMI_HANDLER_PROFILE_SMI_RECORD                 *Record;
+  SMM_CORE_IMAGE_DATABASE_STRUCTURE              *ImageStruct;
+  UINTN                                          Index;
+
+  if (mCommBuffer == NULL) {
+    return;
+  }
+
+  CommHeader = (EFI_SMM_COMMUNICATE_HEADER *)&mCommBuffer[0];
+  CopyMem(&CommHeader->HeaderGuid, &gSmiHandlerProfileGuid, sizeof(gSmiHandlerProfileGuid));
+  CommHeader->MessageLength = sizeof(SMI_HANDLER_PROFILE_PARAMETER_GET_SMI_HISTORY);
+
+  CommGetHistory = (SMI_HANDLER_PROFILE_PARAMETER_GET_SMI_HISTORY *)&mCommBuffer[OFFSET_OF(EFI_SMM_COMMUNICATE_HEADER, Data)];
+  CommGetHistory->Header.Command = SMI_HANDLER_PROFILE_COMMAND_GET_SMI_HISTORY;
+  CommGetHistory->Header.DataLength = sizeof(*CommGetHistory);
+  CommGetHistory->Header.ReturnStatus = (UINT64)-1;
+
+  CommSize = sizeof(EFI_GUID) + sizeof(UINTN) + CommHeader->MessageLength;
+  Status = mSmmCommunication->Communicate(mSmmCommunication, mCommBuffer, &CommSize);
+  if (EFI_ERROR(Status) || (CommGetHistory->Header.ReturnStatus != 0)) {
+    Print(L"<!-- SMI history not supported -->\n");
+    return;
+  }
+
+  Print(L"<SmiHistory SmiCount=\"%ld\" MaxSmiPerSecond=\"%ld\">\n", CommGetHistory->SmiCount, CommGetHistory->MaxSmiPerSecond);
+  Print(L"  <!-- Time spent in SmmCore per SMI, the bucket counts the SMIs from MinUs up to the next bucket -->\n");
+  Print(L"  <LatencyHistogram>\n");
+  for (Index = 0; Index < SMI_HANDLER_PROFILE_LATENCY_BUCKET_COUNT; Index++) {
+    Print(L"    <Bucket MinUs=\"%d\" Count=\"%ld\" />\n", (Index == 0) ? 0 : (UINTN)1 << (Index - 1), CommGetHistory->LatencyHistogram[Index]);
+  }
+  Print(L"  </LatencyHistogram>\n");
+
+  Print(L"  <!-- The last SMIs, oldest first -->\n");
+  for (Index = 0; Index < CommGetHistory->RecordCount && Index < SMI_HANDLER_PROFILE_SMI_RECORD_COUNT; Index++) {
+    Record = &CommGetHistory->Records[Index];
+    Print(L"  <Smi EntryTimeNs=\"%ld\" DurationNs=\"%ld\"", Record->EntryTime, Record->Duration);
+    if (!IsZeroGuid (&Record->HandlerType)) {
+      Print(L" HandlerType=\"%g\"", &Record->HandlerType);
+    }
+    if (Record->Handler != 0) {
+      ImageStruct = GetImageFromAddress (Record->Handler);
+      Print(L" Handler=\"0x%lx\" Module=\"%a\"", Record->Handler, GetDriverNameString (ImageStruct));
+    }
+    Print(L" />\n");
+  }
+  Print(L"</SmiHistory>\n");
+}
+// MU_CHANGE [END]
+
 /**
   The Entry Point for SMI handler profile info application.
 
@@ -676,7 +783,9 @@ SmiHandlerProfileInfoEntrypoint (
   DumpSmiHandler(SmmCoreSmiHandlerCategoryHardwareHandler);
   Print(L"  </SmiHandlerCategory>\n\n");
 
-  Print(L"</SmiHandlerDatabase>\n");
+  Print(L"</SmiHandlerDatabase>\n\n");
+
+  DumpSmiHistory();  // MU_CHANGE - Add SMI history
   Print(L"</SmiHandlerProfile>\n");
 
   if (mSmiHandlerProfileDatabase != NULL) {
@@ -0,0 +1,442 @@
+/** @file
+  A shell application that measures the latency of the UEFI variable services.
+
+  GetVariable (), GetNextVariableName (), QueryVariableInfo () and SetVariable ()
+  are timed with the performance counter while the volatile variable store is
+  filled with an increasing number of test variables. The results are printed
+  as minimum, average and maximum latency and as a histogram with power of two
+  microsecond buckets. All test variables are deleted before the application
+  exits.
+
+  The services are called through the runtime services table, so the path
+  that is measured (variable driver, runtime cache or SMM) is the one the
+  platform is built with. If the variable driver collects statistics, the
+  read and cache hit counters of the test variables are printed as well.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include <Guid/VariableFormat.h>
+
+#define VARIABLE_PERF_ITERATIONS      200
+#define VARIABLE_PERF_HISTOGRAM_SIZE  16
+#define VARIABLE_PERF_DATA_SIZE       32
+#define VARIABLE_PERF_NAME_LENGTH     16
+#define VARIABLE_PERF_ATTRIBUTES      EFI_VARIABLE_BOOTSERVICE_ACCESS
+
+typedef enum {
+  VariablePerfGet,
+  VariablePerfGetNext,
+  VariablePerfQuery,
+  VariablePerfSet,
+  VariablePerfMax
+} VARIABLE_PERF_SERVICE;
+
+///
+/// Latency of one service at one fill level, in nanoseconds. Histogram[Index]
+/// counts the calls that took less than 2^(Index + 1) microseconds, the last
+/// bucket also counts all slower calls.
+///
+typedef struct {
+  UINT64    Count;
+  UINT64    Total;
+  UINT64    Min;
+  UINT64    Max;
+  UINT64    Histogram[VARIABLE_PERF_HISTOGRAM_SIZE];
+} VARIABLE_PERF_RESULT;
+
+//
+// Number of test variables in the store for each measurement.
+//
+UINTN  mFillLevels[] = { 0, 32, 128, 512 };
+
+CHAR16  *mServiceNames[VariablePerfMax] = {
+  L"GetVariable",
+  L"GetNextVariableName",
+  L"QueryVariableInfo",
+  L"SetVariable"
+};
+
+EFI_GUID  mVariablePerfGuid = {
+  0x25e961a6, 0xaec8, 0x4482, { 0xae, 0xbe, 0x0d, 0xc9, 0xe9, 0x43, 0x47, 0x5d }
+};
+
+CHAR16  mTargetName[] = L"VariablePerfTarget";
+
+UINT64  mCounterStart;
+UINT64  mCounterEnd;
+
+/**
+  Return the time between two performance counter values.
+
+  @param[in] Start    Counter value before the call.
+  @param[in] End      Counter value after the call.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+ElapsedNanoSeconds (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  if (mCounterEnd >= mCounterStart) {
+    return GetTimeInNanoSecond (End - Start);
+  }
+
+  return GetTimeInNanoSecond (Start - End);
+}
+
+/**
+  Add one call to a result.
+
+  @param[in, out] Result    The result to update.
+  @param[in]      Start     Counter value before the call.
+  @param[in]      End       Counter value after the call.
+
+**/
+VOID
+RecordLatency (
+  IN OUT VARIABLE_PERF_RESULT  *Result,
+  IN     UINT64                Start,
+  IN     UINT64                End
+  )
+{
+  UINT64  Latency;
+  INTN    Bucket;
+
+  Latency = ElapsedNanoSeconds (Start, End);
+
+  if ((Result->Count == 0) || (Latency < Result->Min)) {
+    Result->Min = Latency;
+  }
+
+  if (Latency > Result->Max) {
+    Result->Max = Latency;
+  }
+
+  Result->Count++;
+  Result->Total += Latency;
+
+  Bucket = HighBitSet64 (DivU64x32 (Latency, 1000) | 1);
+  if (Bucket >= VARIABLE_PERF_HISTOGRAM_SIZE) {
+    Bucket = VARIABLE_PERF_HISTOGRAM_SIZE - 1;
+  }
+
+  Result->Histogram[Bucket]++;
+}
+
+/**
+  Print one result.
+
+  @param[in] Service    The service that was measured.
+  @param[in] Result     The result to print.
+
+**/
+VOID
+PrintResult (
+  IN VARIABLE_PERF_SERVICE  Service,
+  IN VARIABLE_PERF_RESULT   *Result
+  )
+{
+  UINTN  Index;
+
+  if (Result->Count == 0) {
+    Print (L"  %-20s no samples\n", mServiceNames[Service]);
+    return;
+  }
+
+  Print (
+    L"  %-20s n=%ld min=%ldns avg=%ldns max=%ldns\n",
+    mServiceNames[Service],
+    Result->Count,
+    Result->Min,
+    DivU64x64Remainder (Result->Total, Result->Count, NULL),
+    Result->Max
+    );
+
+  Print (L"    histogram (<2^(n+1) us):");
+  for (Index = 0; Index < VARIABLE_PERF_HISTOGRAM_SIZE; Index++) {
+    Print (L" %ld", Result->Histogram[Index]);
+  }
+
+  Print (L"\n");
+}
+
+/**
+  Create the test variables from First up to, but not including, Count.
+
+  @param[in] First    Index of the first test variable to create.
+  @param[in] Count    Number of test variables that exist on return.
+
+  @retval EFI_SUCCESS   The test variables exist.
+  @retval Others        SetVariable () failed.
+
+**/
+EFI_STATUS
+FillStore (
+  IN UINTN  First,
+  IN UINTN  Count
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  CHAR16      Name[VARIABLE_PERF_NAME_LENGTH];
+  UINT8       Data[VARIABLE_PERF_DATA_SIZE];
+
+  SetMem (Data, sizeof (Data), 0x5A);
+
+  for (Index = First; Index < Count; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"VarPerf%04d", Index);
+    Status = gRT->SetVariable (Name, &mVariablePerfGuid, VARIABLE_PERF_ATTRIBUTES, sizeof (Data), Data);
+    if (EFI_ERROR (Status)) {
+      Print (L"Failed to create %s - %r\n", Name, Status);
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Delete all test variables.
+
+  @param[in] Count    Number of test variables that may exist.
+
+**/
+VOID
+CleanStore (
+  IN UINTN  Count
+  )
+{
+  UINTN   Index;
+  CHAR16  Name[VARIABLE_PERF_NAME_LENGTH];
+
+  for (Index = 0; Index < Count; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"VarPerf%04d", Index);
+    gRT->SetVariable (Name, &mVariablePerfGuid, 0, 0, NULL);
+  }
+
+  gRT->SetVariable (mTargetName, &mVariablePerfGuid, 0, 0, NULL);
+}
+
+/**
+  Measure all services with the current content of the variable store.
+
+  The target variable is written last, so GetVariable () has to walk past all
+  test variables to find it.
+
+  @param[out] Results   Returns one result per service.
+
+  @retval EFI_SUCCESS   The services were measured.
+  @retval Others        A variable service failed.
+
+**/
+EFI_STATUS
+MeasureServices (
+  OUT VARIABLE_PERF_RESULT  *Results
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Iteration;
+  UINT64      Start;
+  UINT64      End;
+  UINT8       Data[VARIABLE_PERF_DATA_SIZE];
+  UINTN       DataSize;
+  UINT64      MaximumVariableStorageSize;
+  UINT64      RemainingVariableStorageSize;
+  UINT64      MaximumVariableSize;
+  CHAR16      Name[128];
+  EFI_GUID    Guid;
+  UINTN       NameSize;
+
+  ZeroMem (Results, sizeof (VARIABLE_PERF_RESULT) * VariablePerfMax);
+  SetMem (Data, sizeof (Data), 0xA5);
+
+  gRT->SetVariable (mTargetName, &mVariablePerfGuid, 0, 0, NULL);
+  Status = gRT->SetVariable (mTargetName, &mVariablePerfGuid, VARIABLE_PERF_ATTRIBUTES, sizeof (Data), Data);
+  if (EFI_ERROR (Status)) {
+    Print (L"Failed to create %s - %r\n", mTargetName, Status);
+    return Status;
+  }
+
+  for (Iteration = 0; Iteration < VARIABLE_PERF_ITERATIONS; Iteration++) {
+    DataSize = sizeof (Data);
+    Start    = GetPerformanceCounter ();
+    Status   = gRT->GetVariable (mTargetName, &mVariablePerfGuid, NULL, &DataSize, Data);
+    End      = GetPerformanceCounter ();
+    if (EFI_ERROR (Status)) {
+      Print (L"GetVariable failed - %r\n", Status);
+      return Status;
+    }
+
+    RecordLatency (&Results[VariablePerfGet], Start, End);
+
+    Start  = GetPerformanceCounter ();
+    Status = gRT->QueryVariableInfo (
+                    VARIABLE_PERF_ATTRIBUTES,
+                    &MaximumVariableStorageSize,
+                    &RemainingVariableStorageSize,
+                    &MaximumVariableSize
+                    );
+    End = GetPerformanceCounter ();
+    if (EFI_ERROR (Status)) {
+      Print (L"QueryVariableInfo failed - %r\n", Status);
+      return Status;
+    }
+
+    RecordLatency (&Results[VariablePerfQuery], Start, End);
+  }
+
+  //
+  // Time every GetNextVariableName () call of one full walk of the stores.
+  //
+  Name[0] = L'\0';
+  ZeroMem (&Guid, sizeof (Guid));
+  while (TRUE) {
+    NameSize = sizeof (Name);
+    Start    = GetPerformanceCounter ();
+    Status   = gRT->GetNextVariableName (&NameSize, Name, &Guid);
+    End      = GetPerformanceCounter ();
+    if (Status == EFI_NOT_FOUND) {
+      break;
+    }
+
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      Print (L"GetNextVariableName walk stopped at a name longer than %d bytes\n", sizeof (Name));
+      break;
+    }
+
+    if (EFI_ERROR (Status)) {
+      Print (L"GetNextVariableName failed - %r\n", Status);
+      return Status;
+    }
+
+    RecordLatency (&Results[VariablePerfGetNext], Start, End);
+  }
+
+  for (Iteration = 0; Iteration < VARIABLE_PERF_ITERATIONS; Iteration++) {
+    Data[0] = (UINT8)Iteration;
+    Start   = GetPerformanceCounter ();
+    Status  = gRT->SetVariable (mTargetName, &mVariablePerfGuid, VARIABLE_PERF_ATTRIBUTES, sizeof (Data), Data);
+    End     = GetPerformanceCounter ();
+    if (EFI_ERROR (Status)) {
+      Print (L"SetVariable failed - %r\n", Status);
+      return Status;
+    }
+
+    RecordLatency (&Results[VariablePerfSet], Start, End);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Print the statistics the variable driver collected for the test variables.
+
+**/
+VOID
+PrintStatistics (
+  VOID
+  )
+{
+  EFI_STATUS           Status;
+  VARIABLE_INFO_ENTRY  *Entry;
+  UINT64               ReadCount;
+  UINT64               CacheCount;
+  UINT64               WriteCount;
+  UINT64               DeleteCount;
+
+  Status = EfiGetSystemConfigurationTable (&gEfiVariableGuid, (VOID **)&Entry);
+  if (EFI_ERROR (Status) || (Entry == NULL)) {
+    Status = EfiGetSystemConfigurationTable (&gEfiAuthenticatedVariableGuid, (VOID **)&Entry);
+  }
+
+  if (EFI_ERROR (Status) || (Entry == NULL)) {
+    Print (L"Variable statistics are not available, set PcdVariableCollectStatistics to collect them.\n");
+    return;
+  }
+
+  ReadCount   = 0;
+  CacheCount  = 0;
+  WriteCount  = 0;
+  DeleteCount = 0;
+  for ( ; Entry != NULL; Entry = Entry->Next) {
+    if (CompareGuid (&Entry->VendorGuid, &mVariablePerfGuid)) {
+      ReadCount   += Entry->ReadCount;
+      CacheCount  += Entry->CacheCount;
+      WriteCount  += Entry->WriteCount;
+      DeleteCount += Entry->DeleteCount;
+    }
+  }
+
+  Print (
+    L"Test variable statistics: R%ld(%ld) W%ld D%ld\n",
+    ReadCount,
+    CacheCount,
+    WriteCount,
+    DeleteCount
+    );
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the image goes into a library that calls this
+  function.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Level;
+  UINTN                 Service;
+  VARIABLE_PERF_RESULT  Results[VariablePerfMax];
+
+  GetPerformanceCounterProperties (&mCounterStart, &mCounterEnd);
+
+  Status = EFI_SUCCESS;
+  for (Level = 0; Level < ARRAY_SIZE (mFillLevels); Level++) {
+    Status = FillStore ((Level == 0) ? 0 : mFillLevels[Level - 1], mFillLevels[Level]);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Status = MeasureServices (Results);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Print (L"%d test variables:\n", mFillLevels[Level]);
+    for (Service = 0; Service < VariablePerfMax; Service++) {
+      PrintResult ((VARIABLE_PERF_SERVICE)Service, &Results[Service]);
+    }
+  }
+
+  PrintStatistics ();
+  CleanStore (mFillLevels[ARRAY_SIZE (mFillLevels) - 1]);
+
+  return Status;
+}
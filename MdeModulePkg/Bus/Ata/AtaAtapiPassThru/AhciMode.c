@@ -1860,6 +1860,81 @@ AhciPacketCommandExecute (
   return Status;
 }
 
+/**
+  Allocate the per-slot command tables used by NCQ commands.
+
+  NCQ is an optimization only, so a failure here leaves AhciNcqCommandTable
+  NULL and the controller keeps working with one command at a time.
+
+  @param  PciIo                 The PCI IO protocol instance.
+  @param  AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+  @param  MaxCommandSlotNumber  The number of command slots per port supported by the HBA.
+  @param  Support64Bit          Whether the HBA supports 64-bit addressing.
+
+**/
+VOID
+EFIAPI
+AhciCreateNcqCommandTable (
+  IN     EFI_PCI_IO_PROTOCOL    *PciIo,
+  IN OUT EFI_AHCI_REGISTERS     *AhciRegisters,
+  IN     UINT8                  MaxCommandSlotNumber,
+  IN     BOOLEAN                Support64Bit
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Bytes;
+  VOID                  *Buffer;
+  UINT64                MaxNcqCommandTableSize;
+  EFI_PHYSICAL_ADDRESS  AhciNcqCommandTablePciAddr;
+
+  AhciRegisters->AhciNcqCommandTable     = NULL;
+  AhciRegisters->MaxNcqCommandSlotNumber = 0;
+  AhciRegisters->NcqActiveSlots          = 0;
+
+  Buffer                 = NULL;
+  MaxNcqCommandTableSize = MaxCommandSlotNumber * sizeof (AHCI_NCQ_COMMAND_TABLE);
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES ((UINTN) MaxNcqCommandTableSize),
+                    &Buffer,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  ZeroMem (Buffer, (UINTN)MaxNcqCommandTableSize);
+  Bytes  = (UINTN)MaxNcqCommandTableSize;
+
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &AhciNcqCommandTablePciAddr,
+                    &AhciRegisters->MapNcqCommandTable
+                    );
+  if (EFI_ERROR (Status) || (Bytes != MaxNcqCommandTableSize) ||
+      ((!Support64Bit) && (AhciNcqCommandTablePciAddr > 0x100000000ULL))) {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, AhciRegisters->MapNcqCommandTable);
+    }
+    PciIo->FreeBuffer (
+             PciIo,
+             EFI_SIZE_TO_PAGES ((UINTN) MaxNcqCommandTableSize),
+             Buffer
+             );
+    return;
+  }
+
+  AhciRegisters->AhciNcqCommandTable        = Buffer;
+  AhciRegisters->AhciNcqCommandTablePciAddr = (AHCI_NCQ_COMMAND_TABLE *)(UINTN)AhciNcqCommandTablePciAddr;
+  AhciRegisters->MaxNcqCommandTableSize     = MaxNcqCommandTableSize;
+  AhciRegisters->MaxNcqCommandSlotNumber    = MaxCommandSlotNumber;
+}
+
 /**
   Allocate transfer-related data struct which is used at AHCI mode.
 
@@ -2067,6 +2142,10 @@ AhciCreateTransferDescriptor (
   }
   AhciRegisters->AhciCommandTablePciAddr = (EFI_AHCI_COMMAND_TABLE *)(UINTN)AhciCommandTablePciAddr;
 
+  if ((Capability & EFI_AHCI_CAP_SNCQ) != 0) {
+    AhciCreateNcqCommandTable (PciIo, AhciRegisters, MaxCommandSlotNumber, Support64Bit);
+  }
+
   return EFI_SUCCESS;
   //
   // Map error or unable to map the whole CmdList buffer into a contiguous region.
@@ -2147,26 +2226,444 @@ AhciReadLogExt (
   ZeroMem (&AtaStatusBlock, sizeof (EFI_ATA_STATUS_BLOCK));
   ZeroMem (Buffer, 512);
 
-  AtaCommandBlock.AtaCommand      = ATA_CMD_READ_LOG_EXT;
-  AtaCommandBlock.AtaSectorCount  = 1;
-  AtaCommandBlock.AtaSectorNumber = LogNumber;
-  AtaCommandBlock.AtaCylinderLow  = PageNumber;
+  AtaCommandBlock.AtaCommand      = ATA_CMD_READ_LOG_EXT;
+  AtaCommandBlock.AtaSectorCount  = 1;
+  AtaCommandBlock.AtaSectorNumber = LogNumber;
+  AtaCommandBlock.AtaCylinderLow  = PageNumber;
+
+  return AhciPioTransfer (
+           PciIo,
+           AhciRegisters,
+           Port,
+           PortMultiplier,
+           NULL,
+           0,
+           TRUE,
+           &AtaCommandBlock,
+           &AtaStatusBlock,
+           Buffer,
+           512,
+           ATA_ATAPI_TIMEOUT,
+           NULL
+           );
+}
+
+/**
+  Build the command list entry and the per-slot command table of an NCQ command.
+
+  @param    AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+  @param    PortMultiplier        The port multiplier port number.
+  @param    CommandFis            The control fis will be used for the transfer.
+  @param    CommandList           The command list will be used for the transfer.
+  @param    CommandSlotNumber     The command slot will be used for the transfer.
+  @param    DataPhysicalAddr      The pointer to the data buffer pci bus master address.
+  @param    DataLength            The data count to be transferred.
+
+**/
+VOID
+EFIAPI
+AhciBuildNcqCommand (
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      PortMultiplier,
+  IN     EFI_AHCI_COMMAND_FIS       *CommandFis,
+  IN     EFI_AHCI_COMMAND_LIST      *CommandList,
+  IN     UINT8                      CommandSlotNumber,
+  IN OUT VOID                       *DataPhysicalAddr,
+  IN     UINT32                     DataLength
+  )
+{
+  AHCI_NCQ_COMMAND_TABLE  *CommandTable;
+  UINT32                  PrdtNumber;
+  UINT32                  PrdtIndex;
+  UINTN                   RemainedData;
+  UINTN                   MemAddr;
+  DATA_64                 Data64;
+
+  PrdtNumber   = (UINT32)DivU64x32 (((UINT64)DataLength + EFI_AHCI_MAX_DATA_PER_PRDT - 1), EFI_AHCI_MAX_DATA_PER_PRDT);
+  ASSERT (PrdtNumber <= AHCI_NCQ_MAX_PRDT_ENTRIES);
+
+  CommandTable = &AhciRegisters->AhciNcqCommandTable[CommandSlotNumber];
+  ZeroMem (CommandTable, sizeof (AHCI_NCQ_COMMAND_TABLE));
+
+  CommandFis->AhciCFisPmNum = PortMultiplier;
+  CopyMem (&CommandTable->CommandFis, CommandFis, sizeof (EFI_AHCI_COMMAND_FIS));
+
+  RemainedData = (UINTN) DataLength;
+  MemAddr      = (UINTN) DataPhysicalAddr;
+  CommandList->AhciCmdPrdtl = PrdtNumber;
+
+  for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+    if (RemainedData < EFI_AHCI_MAX_DATA_PER_PRDT) {
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = (UINT32)RemainedData - 1;
+    } else {
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = EFI_AHCI_MAX_DATA_PER_PRDT - 1;
+    }
+
+    Data64.Uint64 = (UINT64)MemAddr;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDba  = Data64.Uint32.Lower32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbau = Data64.Uint32.Upper32;
+    RemainedData -= EFI_AHCI_MAX_DATA_PER_PRDT;
+    MemAddr      += EFI_AHCI_MAX_DATA_PER_PRDT;
+  }
+
+  if (PrdtNumber > 0) {
+    CommandTable->PrdtTable[PrdtNumber - 1].AhciPrdtIoc = 1;
+  }
+
+  CopyMem (
+    &AhciRegisters->AhciCmdList[CommandSlotNumber],
+    CommandList,
+    sizeof (EFI_AHCI_COMMAND_LIST)
+    );
+
+  Data64.Uint64 = (UINT64)(UINTN) &AhciRegisters->AhciNcqCommandTablePciAddr[CommandSlotNumber];
+  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdCtba  = Data64.Uint32.Lower32;
+  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdCtbau = Data64.Uint32.Upper32;
+  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdPmp   = PortMultiplier;
+}
+
+/**
+  Check whether an NCQ command slot on a port has completed.
+
+  @param[in]       PciIo             The PCI IO protocol instance.
+  @param[in]       Port              The number of port.
+  @param[in]       CommandSlot       The command slot used by the NCQ command.
+  @param[in, out]  Task              Optional. Pointer to the ATA_NONBLOCK_TASK used by
+                                     non-blocking mode. If NULL, then just try once.
+
+  @retval EFI_NOT_READY     The command is still outstanding.
+  @retval EFI_TIMEOUT       The command retry times out.
+  @retval EFI_DEVICE_ERROR  The port reported a task file error.
+  @retval EFI_SUCCESS       The command completed successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciCheckNcqSlot (
+  IN     EFI_PCI_IO_PROTOCOL       *PciIo,
+  IN     UINT8                     Port,
+  IN     UINT8                     CommandSlot,
+  IN OUT ATA_NONBLOCK_TASK         *Task
+  )
+{
+  UINT32     Offset;
+  UINT32     SlotBit;
+  UINT32     Outstanding;
+
+  if (Task != NULL) {
+    Task->RetryTimes--;
+  }
+
+  SlotBit = (UINT32) (1 << CommandSlot);
+  Offset  = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH;
+
+  //
+  // A task file error stops the port, so it must be checked before the slot
+  // bits which will then never clear on their own.
+  //
+  if ((AhciReadReg (PciIo, Offset + EFI_AHCI_PORT_IS) & (EFI_AHCI_PORT_IS_TFES | EFI_AHCI_PORT_IS_HBFS | EFI_AHCI_PORT_IS_IFS)) != 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Outstanding = AhciReadReg (PciIo, Offset + EFI_AHCI_PORT_CI) | AhciReadReg (PciIo, Offset + EFI_AHCI_PORT_SACT);
+  if ((Outstanding & SlotBit) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if ((Task != NULL) && !Task->InfiniteWait && (Task->RetryTimes == 0)) {
+    return EFI_TIMEOUT;
+  } else {
+    return EFI_NOT_READY;
+  }
+}
+
+/**
+  Recover a port after an NCQ command failed.
+
+  The device aborts every outstanding queued command when one of them fails.
+  The command engine is stopped, which clears PxCI and PxSACT, and the NCQ
+  error log is read so that the device leaves its error state.
+
+  @param[in]  PciIo               The PCI IO protocol instance.
+  @param[in]  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  Port                The number of port.
+  @param[in]  PortMultiplier      The port multiplier port number.
+  @param[in]  Timeout             The timeout value of stop, uses 100ns as a unit.
+
+**/
+VOID
+EFIAPI
+AhciNcqRecover (
+  IN EFI_PCI_IO_PROTOCOL        *PciIo,
+  IN EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN UINT8                      Port,
+  IN UINT8                      PortMultiplier,
+  IN UINT64                     Timeout
+  )
+{
+  UINT8    *LogData;
+
+  AhciStopCommand (PciIo, Port, Timeout);
+  AhciClearPortStatus (PciIo, Port);
+  AhciRegisters->NcqActiveSlots = 0;
+
+  LogData = AllocateZeroPool (512);
+  if (LogData != NULL) {
+    AhciReadLogExt (PciIo, AhciRegisters, Port, PortMultiplier, LogData, AHCI_NCQ_LOG_PAGE, 0);
+    DEBUG ((DEBUG_ERROR, "AhciNcqRecover: Port %d NCQ error log tag %x status %x error %x\n",
+            Port, LogData[0] & 0x1F, LogData[2], LogData[3]));
+    FreePool (LogData);
+  }
+
+  AhciStopCommand (PciIo, Port, Timeout);
+  AhciDisableFisReceive (PciIo, Port, Timeout);
+}
+
+/**
+  Start an NCQ (READ/WRITE FPDMA QUEUED) data transfer on specific port.
+
+  In non-blocking mode the command is issued in any free command slot and the
+  function returns EFI_NOT_READY until it completes, so up to the queue depth
+  of the device and the HBA can be outstanding on one port. In blocking mode
+  the command is issued in slot 0 and waited for.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The port multiplier port number.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of data transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_DEVICE_ERROR    The NCQ data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_NOT_READY       The command is not started or not finished yet.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer can't be described by one NCQ command.
+  @retval EFI_UNSUPPORTED     The HBA doesn't support native command queuing.
+  @retval EFI_SUCCESS         The NCQ data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciNcqTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE *Instance,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     UINT8                      PortMultiplier,
+  IN     BOOLEAN                    Read,
+  IN     EFI_ATA_COMMAND_BLOCK      *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
+  IN OUT VOID                       *MemoryAddr,
+  IN     UINT32                     DataCount,
+  IN     UINT64                     Timeout,
+  IN     ATA_NONBLOCK_TASK          *Task
+  )
+{
+  EFI_STATUS                    Status;
+  UINT32                        Offset;
+  EFI_PHYSICAL_ADDRESS          PhyAddr;
+  VOID                          *Map;
+  UINTN                         MapLength;
+  EFI_PCI_IO_PROTOCOL_OPERATION Flag;
+  EFI_AHCI_COMMAND_FIS          CFis;
+  EFI_AHCI_COMMAND_LIST         CmdList;
+  UINT8                         Slot;
+  UINT8                         QueueDepth;
+  UINT32                        SlotBit;
+  UINT64                        Delay;
+  EFI_PCI_IO_PROTOCOL           *PciIo;
+  EFI_TPL                       OldTpl;
+
+  Map   = NULL;
+  PciIo = Instance->PciIo;
+
+  if (PciIo == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (AhciRegisters->AhciNcqCommandTable == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (DivU64x32 ((UINT64)DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1, EFI_AHCI_MAX_DATA_PER_PRDT) > AHCI_NCQ_MAX_PRDT_ENTRIES) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  //
+  // Before starting the Blocking BlockIO operation, push to finish all non-blocking
+  // BlockIO tasks.
+  // Delay 100us to simulate the blocking time out checking.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while ((Task == NULL) && (!IsListEmpty (&Instance->NonBlockingTaskList))) {
+    AsyncNonBlockingTransferRoutine (NULL, Instance);
+    //
+    // Stall for 100us.
+    //
+    MicroSecondDelay (100);
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if ((Task == NULL) || (!Task->IsStart)) {
+    //
+    // All ports share one command list, so queued commands can only be
+    // outstanding on one port (and port multiplier port) at a time.
+    //
+    if ((AhciRegisters->NcqActiveSlots != 0) &&
+        ((AhciRegisters->NcqPort != Port) || (AhciRegisters->NcqPortMultiplier != PortMultiplier))) {
+      return EFI_NOT_READY;
+    }
+
+    QueueDepth = 1;
+    if (Task != NULL) {
+      QueueDepth = MIN (AhciRegisters->MaxNcqCommandSlotNumber, Task->NcqQueueDepth);
+    }
+    for (Slot = 0; Slot < QueueDepth; Slot++) {
+      if ((AhciRegisters->NcqActiveSlots & (UINT32) (1 << Slot)) == 0) {
+        break;
+      }
+    }
+    if (Slot == QueueDepth) {
+      return EFI_NOT_READY;
+    }
+    SlotBit = (UINT32) (1 << Slot);
+
+    if (Read) {
+      Flag = EfiPciIoOperationBusMasterWrite;
+    } else {
+      Flag = EfiPciIoOperationBusMasterRead;
+    }
+
+    MapLength = DataCount;
+    Status = PciIo->Map (
+                      PciIo,
+                      Flag,
+                      MemoryAddr,
+                      &MapLength,
+                      &PhyAddr,
+                      &Map
+                      );
+
+    if (EFI_ERROR (Status) || (DataCount != MapLength)) {
+      if (!EFI_ERROR (Status)) {
+        PciIo->Unmap (PciIo, Map);
+      }
+      return EFI_BAD_BUFFER_SIZE;
+    }
+
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH;
+    if (AhciRegisters->NcqActiveSlots == 0) {
+      //
+      // The first queued command starts the port the same way AhciStartCommand
+      // does. Later commands are only added to PxSACT and PxCI.
+      //
+      AhciClearPortStatus (PciIo, Port);
+      Status = AhciEnableFisReceive (PciIo, Port, Timeout);
+      if (EFI_ERROR (Status)) {
+        PciIo->Unmap (PciIo, Map);
+        return Status;
+      }
+      AhciAndReg (PciIo, Offset + EFI_AHCI_PORT_CMD, (UINT32)~(EFI_AHCI_PORT_CMD_DLAE | EFI_AHCI_PORT_CMD_ATAPI));
+      AhciOrReg (PciIo, Offset + EFI_AHCI_PORT_CMD, EFI_AHCI_PORT_CMD_ST);
+
+      AhciRegisters->NcqPort           = Port;
+      AhciRegisters->NcqPortMultiplier = PortMultiplier;
+    }
+
+    //
+    // The NCQ tag lives in bits 7:3 of the sector count register and must match
+    // the command slot. Bit 7 of the device register is FUA, so it is taken from
+    // the caller as is rather than forced on by AhciBuildCommandFis.
+    //
+    AhciBuildCommandFis (&CFis, AtaCommandBlock);
+    CFis.AhciCFisSecCount = (UINT8) (Slot << 3);
+    CFis.AhciCFisDevHead  = (UINT8) (AtaCommandBlock->AtaDeviceHead | BIT6);
+
+    ZeroMem (&CmdList, sizeof (EFI_AHCI_COMMAND_LIST));
+    CmdList.AhciCmdCfl = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+    CmdList.AhciCmdW   = Read ? 0 : 1;
+
+    AhciBuildNcqCommand (
+      AhciRegisters,
+      PortMultiplier,
+      &CFis,
+      &CmdList,
+      Slot,
+      (VOID *)(UINTN)PhyAddr,
+      DataCount
+      );
+
+    AhciRegisters->NcqActiveSlots |= SlotBit;
+    if (Task != NULL) {
+      Task->IsStart = TRUE;
+      Task->Map     = Map;
+      Task->NcqSlot = Slot;
+    }
+
+    //
+    // PxSACT must be set before PxCI. Writing zeros has no effect on either.
+    //
+    AhciWriteReg (PciIo, Offset + EFI_AHCI_PORT_SACT, SlotBit);
+    AhciWriteReg (PciIo, Offset + EFI_AHCI_PORT_CI, SlotBit);
+  } else {
+    Slot    = Task->NcqSlot;
+    SlotBit = (UINT32) (1 << Slot);
+    Map     = Task->Map;
+  }
+
+  //
+  // Wait for command complete
+  //
+  if (Task != NULL) {
+    Status = AhciCheckNcqSlot (PciIo, Port, Slot, Task);
+    if (Status == EFI_NOT_READY) {
+      return Status;
+    }
+  } else {
+    Delay = DivU64x32 (Timeout, 1000) + 1;
+    do {
+      Status = AhciCheckNcqSlot (PciIo, Port, Slot, NULL);
+      if (Status != EFI_NOT_READY) {
+        break;
+      }
+      //
+      // Stall for 100 microseconds.
+      //
+      MicroSecondDelay (100);
+      Delay--;
+    } while ((Timeout == 0) || (Delay > 0));
+
+    if (Status == EFI_NOT_READY) {
+      Status = EFI_TIMEOUT;
+    }
+  }
+
+  AhciDumpPortStatus (PciIo, AhciRegisters, Port, AtaStatusBlock);
+
+  if (EFI_ERROR (Status)) {
+    AhciNcqRecover (PciIo, AhciRegisters, Port, PortMultiplier, Timeout);
+    if (AtaStatusBlock != NULL) {
+      AtaStatusBlock->AtaStatus |= BIT0;
+    }
+  } else {
+    AhciRegisters->NcqActiveSlots &= ~SlotBit;
+    if (AhciRegisters->NcqActiveSlots == 0) {
+      AhciStopCommand (PciIo, Port, Timeout);
+      AhciDisableFisReceive (PciIo, Port, Timeout);
+    }
+  }
+
+  PciIo->Unmap (PciIo, Map);
+  if (Task != NULL) {
+    Task->Map = NULL;
+  }
 
-  return AhciPioTransfer (
-           PciIo,
-           AhciRegisters,
-           Port,
-           PortMultiplier,
-           NULL,
-           0,
-           TRUE,
-           &AtaCommandBlock,
-           &AtaStatusBlock,
-           Buffer,
-           512,
-           ATA_ATAPI_TIMEOUT,
-           NULL
-           );
+  return Status;
 }
 
 /**
@@ -2445,6 +2942,265 @@ AhciPuisEnable (
   return Status;
 }
 
+/**
+  Identify and configure the device attached to a port whose link is up and
+  whose first D2H register FIS has been received.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port              The number of port.
+
+**/
+VOID
+EFIAPI
+AhciConfigurePortDevice (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE    *Instance,
+  IN  UINT8                           Port
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_PCI_IO_PROTOCOL              *PciIo;
+  EFI_IDE_CONTROLLER_INIT_PROTOCOL *IdeInit;
+  EFI_AHCI_REGISTERS               *AhciRegisters;
+  UINT32                           Offset;
+  UINT32                           Data;
+  EFI_IDENTIFY_DATA                Buffer;
+  EFI_ATA_DEVICE_TYPE              DeviceType;
+  EFI_ATA_COLLECTIVE_MODE          *SupportedModes;
+  EFI_ATA_TRANSFER_MODE            TransferMode;
+
+  PciIo         = Instance->PciIo;
+  IdeInit       = Instance->IdeControllerInit;
+  AhciRegisters = &Instance->AhciRegisters;
+
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SIG;
+  Data   = AhciReadReg (PciIo, Offset);
+  if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATAPI_DEVICE_SIG) {
+    Status = AhciIdentifyPacket (PciIo, AhciRegisters, Port, 0, &Buffer);
+
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+
+    DeviceType = EfiIdeCdrom;
+  } else if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATA_DEVICE_SIG) {
+    Status = AhciIdentify (PciIo, AhciRegisters, Port, 0, &Buffer);
+
+    if (EFI_ERROR (Status)) {
+      REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_EC_NOT_DETECTED));
+      return;
+    }
+
+    DEBUG ((
+      DEBUG_INFO, "IDENTIFY DEVICE: [0] = %016x, [2] = %016x, [83] = %016x, [86] = %016x\n",
+      Buffer.AtaData.config, Buffer.AtaData.specific_config,
+      Buffer.AtaData.command_set_supported_83, Buffer.AtaData.command_set_feature_enb_86
+      ));
+    if ((Buffer.AtaData.config & BIT2) != 0) {
+      //
+      // SpinUp disk if device reported incomplete IDENTIFY DEVICE.
+      //
+      Status = AhciSpinUpDisk (
+                 PciIo,
+                 AhciRegisters,
+                 Port,
+                 0,
+                 &Buffer
+                 );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "Spin up standby device failed - %r\n", Status));
+        return;
+      }
+    }
+
+    DeviceType = EfiIdeHarddisk;
+  } else {
+    return;
+  }
+  DEBUG ((DEBUG_INFO, "port [%d] port multitplier [%d] has a [%a]\n",
+          Port, 0, DeviceType == EfiIdeCdrom ? "cdrom" : "harddisk"));
+
+  //
+  // If the device is a hard disk, then try to enable S.M.A.R.T feature
+  //
+  if ((DeviceType == EfiIdeHarddisk) && PcdGetBool (PcdAtaSmartEnable)) {
+    AhciAtaSmartSupport (
+      PciIo,
+      AhciRegisters,
+      Port,
+      0,
+      &Buffer,
+      NULL
+      );
+  }
+
+  //
+  // Submit identify data to IDE controller init driver
+  //
+  IdeInit->SubmitData (IdeInit, Port, 0, &Buffer);
+
+  //
+  // Now start to config ide device parameter and transfer mode.
+  //
+  Status = IdeInit->CalculateMode (
+                      IdeInit,
+                      Port,
+                      0,
+                      &SupportedModes
+                      );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "Calculate Mode Fail, Status = %r\n", Status));
+    return;
+  }
+
+  //
+  // Set best supported PIO mode on this IDE device
+  //
+  if (SupportedModes->PioMode.Mode <= EfiAtaPioMode2) {
+    TransferMode.ModeCategory = EFI_ATA_MODE_DEFAULT_PIO;
+  } else {
+    TransferMode.ModeCategory = EFI_ATA_MODE_FLOW_PIO;
+  }
+
+  TransferMode.ModeNumber = (UINT8) (SupportedModes->PioMode.Mode);
+
+  //
+  // Set supported DMA mode on this IDE device. Note that UDMA & MDMA can't
+  // be set together. Only one DMA mode can be set to a device. If setting
+  // DMA mode operation fails, we can continue moving on because we only use
+  // PIO mode at boot time. DMA modes are used by certain kind of OS booting
+  //
+  if (SupportedModes->UdmaMode.Valid) {
+    TransferMode.ModeCategory = EFI_ATA_MODE_UDMA;
+    TransferMode.ModeNumber = (UINT8) (SupportedModes->UdmaMode.Mode);
+  } else if (SupportedModes->MultiWordDmaMode.Valid) {
+    TransferMode.ModeCategory = EFI_ATA_MODE_MDMA;
+    TransferMode.ModeNumber = (UINT8) SupportedModes->MultiWordDmaMode.Mode;
+  }
+
+  Status = AhciDeviceSetFeature (PciIo, AhciRegisters, Port, 0, 0x03, (UINT32)(*(UINT8 *)&TransferMode), ATA_ATAPI_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "Set transfer Mode Fail, Status = %r\n", Status));
+    return;
+  }
+
+  //
+  // Found a ATA or ATAPI device, add it into the device list.
+  //
+  CreateNewDeviceInfo (Instance, Port, 0xFFFF, DeviceType, &Buffer);
+  if (DeviceType == EfiIdeHarddisk) {
+    REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_PC_ENABLE));
+    AhciEnableDevSlp (
+      PciIo,
+      AhciRegisters,
+      Port,
+      0,
+      &Buffer
+      );
+  }
+
+  //
+  // Enable/disable PUIS according to policy setting if PUIS is capable (Word[83].BIT5 is set).
+  //
+  if ((Buffer.AtaData.command_set_supported_83 & BIT5) != 0) {
+    Status = AhciPuisEnable (
+               PciIo,
+               AhciRegisters,
+               Port,
+               0
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "PUIS enable/disable failed, Status = %r\n", Status));
+    }
+  }
+}
+
+/**
+  Advance the bring-up state machine of one port by one timer tick.
+
+  Every step only samples the port registers, so the links of all ports are
+  brought up and their drives spin up at the same time.
+
+  @param[in]       PciIo          The PCI IO protocol instance.
+  @param[in]       Port           The number of port.
+  @param[in, out]  PortContext    The bring-up context of the port.
+
+**/
+VOID
+EFIAPI
+AhciPollPortInitialization (
+  IN     EFI_PCI_IO_PROTOCOL          *PciIo,
+  IN     UINT8                        Port,
+  IN OUT AHCI_PORT_INIT_CONTEXT       *PortContext
+  )
+{
+  UINT32                           Offset;
+  UINT32                           Data;
+
+  switch (PortContext->State) {
+    case AhciPortInitLinkWait:
+      //
+      // Wait for the Phy to detect the presence of a device.
+      //
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SSTS;
+      Data   = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_SSTS_DET_MASK;
+      if ((Data == EFI_AHCI_PORT_SSTS_DET_PCE) || (Data == EFI_AHCI_PORT_SSTS_DET)) {
+        //
+        // According to SATA1.0a spec section 5.2, we need to wait for PxTFD.BSY and PxTFD.DRQ
+        // and PxTFD.ERR to be zero. The maximum wait time is 16s which is defined at ATA spec.
+        //
+        PortContext->State     = AhciPortInitDeviceReadyWait;
+        PortContext->Remaining = 16 * 1000;
+      } else if (PortContext->Remaining == 0) {
+        //
+        // No device detected at this port.
+        // Clear PxCMD.SUD for those ports at which there are no device present.
+        //
+        Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+        AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_SUD));
+        PortContext->State = AhciPortInitDone;
+        return;
+      }
+      break;
+
+    case AhciPortInitDeviceReadyWait:
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SERR;
+      if (AhciReadReg(PciIo, Offset) != 0) {
+        AhciWriteReg (PciIo, Offset, AhciReadReg(PciIo, Offset));
+      }
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+
+      Data = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_TFD_MASK;
+      if (Data == 0) {
+        //
+        // When the first D2H register FIS is received, the content of PxSIG register is updated.
+        //
+        PortContext->State     = AhciPortInitSignatureWait;
+        PortContext->Remaining = 16 * 1000;
+      } else if (PortContext->Remaining == 0) {
+        DEBUG ((EFI_D_ERROR, "Port %d Device presence detected but phy not ready (TFD=0x%X)\n", Port, Data));
+        PortContext->State = AhciPortInitDone;
+        return;
+      }
+      break;
+
+    case AhciPortInitSignatureWait:
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SIG;
+      if ((AhciReadReg (PciIo, Offset) & 0x0000FFFF) == 0x00000101) {
+        PortContext->State = AhciPortInitDeviceReady;
+        return;
+      } else if (PortContext->Remaining == 0) {
+        PortContext->State = AhciPortInitDone;
+        return;
+      }
+      break;
+
+    default:
+      return;
+  }
+
+  PortContext->Remaining--;
+}
+
 /**
   Initialize ATA host controller at AHCI mode.
 
@@ -2472,12 +3228,9 @@ AhciModeInitialization (
   DATA_64                          Data64;
   UINT32                           Offset;
   UINT32                           Data;
-  EFI_IDENTIFY_DATA                Buffer;
-  EFI_ATA_DEVICE_TYPE              DeviceType;
-  EFI_ATA_COLLECTIVE_MODE          *SupportedModes;
-  EFI_ATA_TRANSFER_MODE            TransferMode;
-  UINT32                           PhyDetectDelay;
   UINT32                           Value;
+  AHCI_PORT_INIT_CONTEXT           PortContext[EFI_AHCI_MAX_PORTS];
+  UINTN                            PendingPorts;
 
   if (Instance == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -2542,6 +3295,13 @@ AhciModeInitialization (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Set up every implemented port first so that all links train and all
+  // drives spin up at the same time.
+  //
+  ZeroMem (PortContext, sizeof (PortContext));
+  PendingPorts = 0;
+
   for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port ++) {
     if ((PortImplementBitMap & (((UINT32)BIT0) << Port)) != 0) {
       //
@@ -2552,7 +3312,7 @@ AhciModeInitialization (
         // Should never be here.
         //
         ASSERT (FALSE);
-        return EFI_SUCCESS;
+        break;
       }
 
       IdeInit->NotifyPhase (IdeInit, EfiIdeBeforeChannelEnumeration, Port);
@@ -2604,212 +3364,39 @@ AhciModeInitialization (
       Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
       AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_FRE);
 
-      //
-      // Wait for the Phy to detect the presence of a device.
-      //
-      PhyDetectDelay = EFI_AHCI_BUS_PHY_DETECT_TIMEOUT;
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SSTS;
-      do {
-        Data = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_SSTS_DET_MASK;
-        if ((Data == EFI_AHCI_PORT_SSTS_DET_PCE) || (Data == EFI_AHCI_PORT_SSTS_DET)) {
-          break;
-        }
-
-        MicroSecondDelay (1000);
-        PhyDetectDelay--;
-      } while (PhyDetectDelay > 0);
-
-      if (PhyDetectDelay == 0) {
-        //
-        // No device detected at this port.
-        // Clear PxCMD.SUD for those ports at which there are no device present.
-        //
-        Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
-        AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_SUD));
-        continue;
-      }
-
-      //
-      // According to SATA1.0a spec section 5.2, we need to wait for PxTFD.BSY and PxTFD.DRQ
-      // and PxTFD.ERR to be zero. The maximum wait time is 16s which is defined at ATA spec.
-      //
-      PhyDetectDelay = 16 * 1000;
-      do {
-        Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SERR;
-        if (AhciReadReg(PciIo, Offset) != 0) {
-          AhciWriteReg (PciIo, Offset, AhciReadReg(PciIo, Offset));
-        }
-        Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
-
-        Data = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_TFD_MASK;
-        if (Data == 0) {
-          break;
-        }
-
-        MicroSecondDelay (1000);
-        PhyDetectDelay--;
-      } while (PhyDetectDelay > 0);
-
-      if (PhyDetectDelay == 0) {
-        DEBUG ((EFI_D_ERROR, "Port %d Device presence detected but phy not ready (TFD=0x%X)\n", Port, Data));
-        continue;
-      }
-
-      //
-      // When the first D2H register FIS is received, the content of PxSIG register is updated.
-      //
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SIG;
-      Status = AhciWaitMmioSet (
-                 PciIo,
-                 Offset,
-                 0x0000FFFF,
-                 0x00000101,
-                 EFI_TIMER_PERIOD_SECONDS(16)
-                 );
-      if (EFI_ERROR (Status)) {
-        continue;
-      }
-
-      Data = AhciReadReg (PciIo, Offset);
-      if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATAPI_DEVICE_SIG) {
-        Status = AhciIdentifyPacket (PciIo, AhciRegisters, Port, 0, &Buffer);
-
-        if (EFI_ERROR (Status)) {
-          continue;
-        }
-
-        DeviceType = EfiIdeCdrom;
-      } else if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATA_DEVICE_SIG) {
-        Status = AhciIdentify (PciIo, AhciRegisters, Port, 0, &Buffer);
-
-        if (EFI_ERROR (Status)) {
-          REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_EC_NOT_DETECTED));
-          continue;
-        }
-
-        DEBUG ((
-          DEBUG_INFO, "IDENTIFY DEVICE: [0] = %016x, [2] = %016x, [83] = %016x, [86] = %016x\n",
-          Buffer.AtaData.config, Buffer.AtaData.specific_config,
-          Buffer.AtaData.command_set_supported_83, Buffer.AtaData.command_set_feature_enb_86
-          ));
-        if ((Buffer.AtaData.config & BIT2) != 0) {
-          //
-          // SpinUp disk if device reported incomplete IDENTIFY DEVICE.
-          //
-          Status = AhciSpinUpDisk (
-                     PciIo,
-                     AhciRegisters,
-                     Port,
-                     0,
-                     &Buffer
-                     );
-          if (EFI_ERROR (Status)) {
-            DEBUG ((DEBUG_ERROR, "Spin up standby device failed - %r\n", Status));
-            continue;
-          }
-        }
-
-        DeviceType = EfiIdeHarddisk;
-      } else {
-        continue;
-      }
-      DEBUG ((DEBUG_INFO, "port [%d] port multitplier [%d] has a [%a]\n",
-              Port, 0, DeviceType == EfiIdeCdrom ? "cdrom" : "harddisk"));
-
-      //
-      // If the device is a hard disk, then try to enable S.M.A.R.T feature
-      //
-      if ((DeviceType == EfiIdeHarddisk) && PcdGetBool (PcdAtaSmartEnable)) {
-        AhciAtaSmartSupport (
-          PciIo,
-          AhciRegisters,
-          Port,
-          0,
-          &Buffer,
-          NULL
-          );
-      }
-
-      //
-      // Submit identify data to IDE controller init driver
-      //
-      IdeInit->SubmitData (IdeInit, Port, 0, &Buffer);
+      PortContext[Port].State     = AhciPortInitLinkWait;
+      PortContext[Port].Remaining = EFI_AHCI_BUS_PHY_DETECT_TIMEOUT;
+      PendingPorts++;
+    }
+  }
 
-      //
-      // Now start to config ide device parameter and transfer mode.
-      //
-      Status = IdeInit->CalculateMode (
-                          IdeInit,
-                          Port,
-                          0,
-                          &SupportedModes
-                          );
-      if (EFI_ERROR (Status)) {
-        DEBUG ((EFI_D_ERROR, "Calculate Mode Fail, Status = %r\n", Status));
+  //
+  // Drive the per-port state machines from a single 1ms tick. A port whose
+  // device is ready is identified and configured right away; the commands
+  // share one command list, so that part is done one port at a time while
+  // the other ports keep coming up.
+  //
+  while (PendingPorts > 0) {
+    for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port ++) {
+      if ((PortContext[Port].State == AhciPortInitIdle) ||
+          (PortContext[Port].State == AhciPortInitDone)) {
         continue;
       }
 
-      //
-      // Set best supported PIO mode on this IDE device
-      //
-      if (SupportedModes->PioMode.Mode <= EfiAtaPioMode2) {
-        TransferMode.ModeCategory = EFI_ATA_MODE_DEFAULT_PIO;
-      } else {
-        TransferMode.ModeCategory = EFI_ATA_MODE_FLOW_PIO;
-      }
-
-      TransferMode.ModeNumber = (UINT8) (SupportedModes->PioMode.Mode);
+      AhciPollPortInitialization (PciIo, Port, &PortContext[Port]);
 
-      //
-      // Set supported DMA mode on this IDE device. Note that UDMA & MDMA can't
-      // be set together. Only one DMA mode can be set to a device. If setting
-      // DMA mode operation fails, we can continue moving on because we only use
-      // PIO mode at boot time. DMA modes are used by certain kind of OS booting
-      //
-      if (SupportedModes->UdmaMode.Valid) {
-        TransferMode.ModeCategory = EFI_ATA_MODE_UDMA;
-        TransferMode.ModeNumber = (UINT8) (SupportedModes->UdmaMode.Mode);
-      } else if (SupportedModes->MultiWordDmaMode.Valid) {
-        TransferMode.ModeCategory = EFI_ATA_MODE_MDMA;
-        TransferMode.ModeNumber = (UINT8) SupportedModes->MultiWordDmaMode.Mode;
-      }
-
-      Status = AhciDeviceSetFeature (PciIo, AhciRegisters, Port, 0, 0x03, (UINT32)(*(UINT8 *)&TransferMode), ATA_ATAPI_TIMEOUT);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((EFI_D_ERROR, "Set transfer Mode Fail, Status = %r\n", Status));
-        continue;
+      if (PortContext[Port].State == AhciPortInitDeviceReady) {
+        AhciConfigurePortDevice (Instance, Port);
+        PortContext[Port].State = AhciPortInitDone;
       }
 
-      //
-      // Found a ATA or ATAPI device, add it into the device list.
-      //
-      CreateNewDeviceInfo (Instance, Port, 0xFFFF, DeviceType, &Buffer);
-      if (DeviceType == EfiIdeHarddisk) {
-        REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_PC_ENABLE));
-        AhciEnableDevSlp (
-          PciIo,
-          AhciRegisters,
-          Port,
-          0,
-          &Buffer
-          );
+      if (PortContext[Port].State == AhciPortInitDone) {
+        PendingPorts--;
       }
+    }
 
-      //
-      // Enable/disable PUIS according to policy setting if PUIS is capable (Word[83].BIT5 is set).
-      //
-      if ((Buffer.AtaData.command_set_supported_83 & BIT5) != 0) {
-        Status = AhciPuisEnable (
-                   PciIo,
-                   AhciRegisters,
-                   Port,
-                   0
-                   );
-        if (EFI_ERROR (Status)) {
-          DEBUG ((DEBUG_ERROR, "PUIS enable/disable failed, Status = %r\n", Status));
-          continue;
-        }
-      }
+    if (PendingPorts > 0) {
+      MicroSecondDelay (1000);
     }
   }
 
@@ -13,6 +13,7 @@
 #define EFI_AHCI_CAPABILITY_OFFSET             0x0000
 #define   EFI_AHCI_CAP_SAM                     BIT18
 #define   EFI_AHCI_CAP_SSS                     BIT27
+#define   EFI_AHCI_CAP_SNCQ                    BIT30
 #define   EFI_AHCI_CAP_S64A                    BIT31
 #define EFI_AHCI_GHC_OFFSET                    0x0004
 #define   EFI_AHCI_GHC_RESET                   BIT0
@@ -61,6 +62,13 @@ typedef union {
 //
 #define EFI_AHCI_MAX_DATA_PER_PRDT             0x400000
 
+//
+// Each NCQ command slot owns a small command table. 64 PRDT entries cover the
+// largest single transfer of 0x10000 sectors with 4KB logical sectors.
+//
+#define AHCI_NCQ_MAX_PRDT_ENTRIES              64
+#define AHCI_NCQ_LOG_PAGE                      0x10
+
 #define EFI_AHCI_FIS_REGISTER_H2D              0x27      //Register FIS - Host to Device
 #define   EFI_AHCI_FIS_REGISTER_H2D_LENGTH     20
 #define EFI_AHCI_FIS_REGISTER_D2H              0x34      //Register FIS - Device to Host
@@ -272,6 +280,18 @@ typedef struct {
   EFI_AHCI_COMMAND_PRDT     PrdtTable[65535];     // The scatter/gather list for data transfer
 } EFI_AHCI_COMMAND_TABLE;
 
+//
+// Command table used by the NCQ command slots. It shares the layout of
+// EFI_AHCI_COMMAND_TABLE but only carries AHCI_NCQ_MAX_PRDT_ENTRIES PRDT
+// entries, which keeps each table a multiple of the required 128 bytes.
+//
+typedef struct {
+  EFI_AHCI_COMMAND_FIS      CommandFis;
+  EFI_AHCI_ATAPI_COMMAND    AtapiCmd;
+  UINT8                     Reserved[0x30];
+  EFI_AHCI_COMMAND_PRDT     PrdtTable[AHCI_NCQ_MAX_PRDT_ENTRIES];
+} AHCI_NCQ_COMMAND_TABLE;
+
 //
 // Received FIS structure
 //
@@ -311,8 +331,38 @@ typedef struct {
   VOID                      *MapRFis;
   VOID                      *MapCmdList;
   VOID                      *MapCommandTable;
+  //
+  // NCQ resources. AhciNcqCommandTable is NULL when the HBA doesn't support
+  // native command queuing. Only one port may have NCQ commands outstanding
+  // at a time because all ports share the single command list.
+  //
+  AHCI_NCQ_COMMAND_TABLE    *AhciNcqCommandTable;
+  AHCI_NCQ_COMMAND_TABLE    *AhciNcqCommandTablePciAddr;
+  UINT64                    MaxNcqCommandTableSize;
+  VOID                      *MapNcqCommandTable;
+  UINT8                     MaxNcqCommandSlotNumber;
+  UINT8                     NcqPort;
+  UINT8                     NcqPortMultiplier;
+  UINT32                    NcqActiveSlots;
 } EFI_AHCI_REGISTERS;
 
+//
+// States of the per-port bring-up done by AhciModeInitialization().
+//
+typedef enum {
+  AhciPortInitIdle,               // Port not implemented
+  AhciPortInitLinkWait,           // Waiting for PxSSTS.DET to report a device
+  AhciPortInitDeviceReadyWait,    // Waiting for PxTFD.BSY/DRQ/ERR to clear
+  AhciPortInitSignatureWait,      // Waiting for the first D2H FIS to update PxSIG
+  AhciPortInitDeviceReady,        // Device can be identified
+  AhciPortInitDone
+} AHCI_PORT_INIT_STATE;
+
+typedef struct {
+  AHCI_PORT_INIT_STATE      State;
+  UINT32                    Remaining;    // Ticks of 1ms left in the current state
+} AHCI_PORT_INIT_CONTEXT;
+
 /**
   This function is used to send out ATAPI commands conforms to the Packet Command
   with PIO Protocol.
@@ -367,6 +367,21 @@ AtaPassThruPassThruExecute (
                      Task
                      );
           break;
+        case EFI_ATA_PASS_THRU_PROTOCOL_FPDMA:
+          Status = AhciNcqTransfer (
+                     Instance,
+                     &Instance->AhciRegisters,
+                     (UINT8)Port,
+                     (UINT8)PortMultiplierPort,
+                     (BOOLEAN) (Packet->InDataBuffer != NULL),
+                     Packet->Acb,
+                     Packet->Asb,
+                     (Packet->InDataBuffer != NULL) ? Packet->InDataBuffer : Packet->OutDataBuffer,
+                     (Packet->InDataBuffer != NULL) ? Packet->InTransferLength : Packet->OutTransferLength,
+                     Packet->Timeout,
+                     Task
+                     );
+          break;
         default :
           return EFI_UNSUPPORTED;
       }
@@ -400,19 +415,23 @@ AsyncNonBlockingTransferRoutine (
   ATA_NONBLOCK_TASK            *Task;
   EFI_STATUS                   Status;
   ATA_ATAPI_PASS_THRU_INSTANCE *Instance;
+  BOOLEAN                      IsQueued;
 
   Instance   = (ATA_ATAPI_PASS_THRU_INSTANCE *) Context;
   EntryHeader = &Instance->NonBlockingTaskList;
   //
   // Get the Tasks from the Tasks List and execute it, until there is
   // no task in the list or the device is busy with task (EFI_NOT_READY).
-  //
-  while (TRUE) {
-    if (!IsListEmpty (EntryHeader)) {
-      Entry = GetFirstNode (EntryHeader);
-      Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
-    } else {
-      return;
+  // NCQ tasks don't block the tasks queued behind them, so several of them
+  // can be outstanding at once. Any other task waits until it reaches the
+  // head of the list, which means all the NCQ tasks before it are done.
+  //
+  Entry = GetFirstNode (EntryHeader);
+  while (!IsNull (EntryHeader, Entry)) {
+    Task     = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    IsQueued = (BOOLEAN) (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA);
+    if (!IsQueued && (Entry != GetFirstNode (EntryHeader))) {
+      break;
     }
 
     Status = AtaPassThruPassThruExecute (
@@ -437,9 +456,12 @@ AsyncNonBlockingTransferRoutine (
     // is not finished yet. Otherwise the operation is successful.
     //
     if (Status == EFI_NOT_READY) {
-      break;
+      if (!IsQueued) {
+        break;
+      }
+      Entry = GetNextNode (EntryHeader, Entry);
     } else {
-      RemoveEntryList (&Task->Link);
+      Entry = RemoveEntryList (&Task->Link);
       gBS->SignalEvent (Task->Event);
       FreePool (Task);
     }
@@ -941,6 +963,17 @@ AtaAtapiPassThruStop (
   //
   if (Instance->Mode == EfiAtaAhciMode) {
     AhciRegisters = &Instance->AhciRegisters;
+    if (AhciRegisters->AhciNcqCommandTable != NULL) {
+      PciIo->Unmap (
+               PciIo,
+               AhciRegisters->MapNcqCommandTable
+               );
+      PciIo->FreeBuffer (
+               PciIo,
+               EFI_SIZE_TO_PAGES ((UINTN) AhciRegisters->MaxNcqCommandTableSize),
+               AhciRegisters->AhciNcqCommandTable
+               );
+    }
     PciIo->Unmap (
              PciIo,
              AhciRegisters->MapCommandTable
@@ -1064,6 +1097,8 @@ CreateNewDeviceInfo (
   )
 {
   EFI_ATA_DEVICE_INFO  *DeviceInfo;
+  EFI_ATA_DEVICE_INFO  *NextDeviceInfo;
+  LIST_ENTRY           *Node;
 
   DeviceInfo = AllocateZeroPool (sizeof (EFI_ATA_DEVICE_INFO));
 
@@ -1084,7 +1119,21 @@ CreateNewDeviceInfo (
     }
   }
 
-  InsertTailList (&Instance->DeviceList, &DeviceInfo->Link);
+  //
+  // AHCI ports are brought up concurrently and may be found in any order.
+  // Keep the list sorted by port and port multiplier port, which is what
+  // GetNextPort() and GetNextDevice() rely on.
+  //
+  for (Node = GetFirstNode (&Instance->DeviceList);
+       !IsNull (&Instance->DeviceList, Node);
+       Node = GetNextNode (&Instance->DeviceList, Node)) {
+    NextDeviceInfo = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
+    if ((NextDeviceInfo->Port > Port) ||
+        ((NextDeviceInfo->Port == Port) && (NextDeviceInfo->PortMultiplier > PortMultiplier))) {
+      break;
+    }
+  }
+  InsertTailList (Node, &DeviceInfo->Link);
 
   return EFI_SUCCESS;
 }
@@ -1139,6 +1188,15 @@ DestroyAsynTaskList (
   EFI_TPL              OldTpl;
 
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  //
+  // Stop the port which still has NCQ commands outstanding before their
+  // buffers are unmapped below.
+  //
+  if ((Instance->Mode == EfiAtaAhciMode) && (Instance->AhciRegisters.NcqActiveSlots != 0)) {
+    AhciStopCommand (Instance->PciIo, Instance->AhciRegisters.NcqPort, ATA_ATAPI_TIMEOUT);
+    Instance->AhciRegisters.NcqActiveSlots = 0;
+  }
+
   if (!IsListEmpty (&Instance->NonBlockingTaskList)) {
     //
     // Free the Subtask list.
@@ -1151,6 +1209,9 @@ DestroyAsynTaskList (
       Task     = ATA_NON_BLOCK_TASK_FROM_ENTRY (DelEntry);
 
       RemoveEntryList (DelEntry);
+      if ((Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) && (Task->Map != NULL)) {
+        Instance->PciIo->Unmap (Instance->PciIo, Task->Map);
+      }
       if (IsSigEvent) {
         Task->Packet->Asb->AtaStatus = 0x01;
         gBS->SignalEvent (Task->Event);
@@ -1331,6 +1392,19 @@ AtaPassThruPassThru (
     }
   }
 
+  //
+  // NCQ commands are only supported in AHCI mode, when both the HBA (CAP.SNCQ)
+  // and the device (IDENTIFY word 76 bit 8) support native command queuing.
+  //
+  if (Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+    if ((Instance->Mode != EfiAtaAhciMode) ||
+        (Instance->AhciRegisters.AhciNcqCommandTable == NULL) ||
+        (IdentifyData->AtaData.serial_ata_capabilities == 0xFFFF) ||
+        ((IdentifyData->AtaData.serial_ata_capabilities & BIT8) == 0)) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
   //
   // convert the transfer length from sector count to byte.
   //
@@ -1372,6 +1446,7 @@ AtaPassThruPassThru (
     Task->Packet         = Packet;
     Task->Event          = Event;
     Task->IsStart        = FALSE;
+    Task->NcqQueueDepth  = (UINT8) ((IdentifyData->AtaData.queue_depth & 0x1F) + 1);
     Task->RetryTimes     = DivU64x32(Packet->Timeout, 1000) + 1;
     if (Packet->Timeout == 0) {
       Task->InfiniteWait = TRUE;
@@ -78,6 +78,7 @@ ATA_DEVICE gAtaDeviceTemplate = {
   NULL,                        // Asb
   FALSE,                       // UdmaValid
   FALSE,                       // Lba48Bit
+  FALSE,                       // NcqValid
   NULL,                        // IdentifyData
   NULL,                        // ControllerNameTable
   {L'\0', },                   // ModelName
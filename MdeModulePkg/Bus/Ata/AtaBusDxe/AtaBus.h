@@ -115,6 +115,11 @@ typedef struct {
 
   BOOLEAN                               UdmaValid;
   BOOLEAN                               Lba48Bit;
+  //
+  // Use READ/WRITE FPDMA QUEUED for non-blocking transfers. Cleared for good
+  // once the ATA pass thru instance reports it can't queue commands.
+  //
+  BOOLEAN                               NcqValid;
 
   //
   // Cached data for ATA identify data
@@ -25,6 +25,9 @@
 #define ATA_CMD_TRUST_SEND        0x5E
 #define ATA_CMD_TRUST_SEND_DMA    0x5F
 
+#define ATA_CMD_READ_FPDMA_QUEUED   0x60
+#define ATA_CMD_WRITE_FPDMA_QUEUED  0x61
+
 //
 // Look up table (UdmaValid, IsWrite) for EFI_ATA_PASS_THRU_CMD_PROTOCOL
 //
@@ -79,6 +82,13 @@ UINT8 mAtaTrustCommands[2][2] = {
   }
 };
 
+//
+// Look up table (IsWrite) for NCQ ATA_CMD
+//
+UINT8 mAtaNcqCommands[2] = {
+  ATA_CMD_READ_FPDMA_QUEUED,
+  ATA_CMD_WRITE_FPDMA_QUEUED
+};
 
 //
 // Look up table (Lba48Bit) for maximum transfer block number
@@ -324,6 +334,16 @@ IdentifyAtaDevice (
     }
   }
 
+  //
+  // Check whether the WORD 76 (Serial ATA capabilities) reports native command
+  // queuing. NCQ commands are DMA commands, so UDMA support is required too.
+  //
+  if (AtaDevice->UdmaValid &&
+      (IdentifyData->serial_ata_capabilities != 0xFFFF) &&
+      ((IdentifyData->serial_ata_capabilities & BIT8) != 0)) {
+    AtaDevice->NcqValid = TRUE;
+  }
+
   Capacity = GetAtapi6Capacity (AtaDevice);
   if (Capacity > MAX_28BIT_ADDRESSING_CAPACITY) {
     //
@@ -472,8 +492,10 @@ TransferAtaDevice (
   IN EFI_EVENT                            Event OPTIONAL
   )
 {
+  EFI_STATUS                        Status;
   EFI_ATA_COMMAND_BLOCK             *Acb;
   EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  BOOLEAN                           UseNcq;
 
   //
   // Ensure AtaDevice->UdmaValid, AtaDevice->Lba48Bit and IsWrite are valid boolean values
@@ -482,22 +504,45 @@ TransferAtaDevice (
   ASSERT ((UINTN) AtaDevice->Lba48Bit < 2);
   ASSERT ((UINTN) IsWrite < 2);
   //
+  // Only non-blocking transfers are queued. Blocking ones are issued one at a
+  // time anyway and keep using the plain DMA commands.
+  //
+  UseNcq = (BOOLEAN) (AtaDevice->NcqValid && (Event != NULL));
+  //
   // Prepare for ATA command block.
   //
   Acb = ZeroMem (&AtaDevice->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
-  Acb->AtaCommand = mAtaCommands[AtaDevice->UdmaValid][AtaDevice->Lba48Bit][IsWrite];
-  Acb->AtaSectorNumber = (UINT8) StartLba;
-  Acb->AtaCylinderLow = (UINT8) RShiftU64 (StartLba, 8);
-  Acb->AtaCylinderHigh = (UINT8) RShiftU64 (StartLba, 16);
-  Acb->AtaDeviceHead = (UINT8) (BIT7 | BIT6 | BIT5 | (AtaDevice->PortMultiplierPort == 0xFFFF ? 0 : (AtaDevice->PortMultiplierPort << 4)));
-  Acb->AtaSectorCount = (UINT8) TransferLength;
-  if (AtaDevice->Lba48Bit) {
+  if (UseNcq) {
+    //
+    // READ/WRITE FPDMA QUEUED always use 48-bit LBA and take the sector count
+    // from the feature registers. The sector count register carries the tag,
+    // which is filled in by the host controller driver.
+    //
+    Acb->AtaCommand         = mAtaNcqCommands[IsWrite];
+    Acb->AtaSectorNumber    = (UINT8) StartLba;
+    Acb->AtaCylinderLow     = (UINT8) RShiftU64 (StartLba, 8);
+    Acb->AtaCylinderHigh    = (UINT8) RShiftU64 (StartLba, 16);
     Acb->AtaSectorNumberExp = (UINT8) RShiftU64 (StartLba, 24);
-    Acb->AtaCylinderLowExp = (UINT8) RShiftU64 (StartLba, 32);
+    Acb->AtaCylinderLowExp  = (UINT8) RShiftU64 (StartLba, 32);
     Acb->AtaCylinderHighExp = (UINT8) RShiftU64 (StartLba, 40);
-    Acb->AtaSectorCountExp = (UINT8) (TransferLength >> 8);
+    Acb->AtaFeatures        = (UINT8) TransferLength;
+    Acb->AtaFeaturesExp     = (UINT8) (TransferLength >> 8);
+    Acb->AtaDeviceHead      = BIT6;
   } else {
-    Acb->AtaDeviceHead = (UINT8) (Acb->AtaDeviceHead | RShiftU64 (StartLba, 24));
+    Acb->AtaCommand = mAtaCommands[AtaDevice->UdmaValid][AtaDevice->Lba48Bit][IsWrite];
+    Acb->AtaSectorNumber = (UINT8) StartLba;
+    Acb->AtaCylinderLow = (UINT8) RShiftU64 (StartLba, 8);
+    Acb->AtaCylinderHigh = (UINT8) RShiftU64 (StartLba, 16);
+    Acb->AtaDeviceHead = (UINT8) (BIT7 | BIT6 | BIT5 | (AtaDevice->PortMultiplierPort == 0xFFFF ? 0 : (AtaDevice->PortMultiplierPort << 4)));
+    Acb->AtaSectorCount = (UINT8) TransferLength;
+    if (AtaDevice->Lba48Bit) {
+      Acb->AtaSectorNumberExp = (UINT8) RShiftU64 (StartLba, 24);
+      Acb->AtaCylinderLowExp = (UINT8) RShiftU64 (StartLba, 32);
+      Acb->AtaCylinderHighExp = (UINT8) RShiftU64 (StartLba, 40);
+      Acb->AtaSectorCountExp = (UINT8) (TransferLength >> 8);
+    } else {
+      Acb->AtaDeviceHead = (UINT8) (Acb->AtaDeviceHead | RShiftU64 (StartLba, 24));
+    }
   }
 
   //
@@ -517,7 +562,11 @@ TransferAtaDevice (
     Packet->InTransferLength = TransferLength;
   }
 
-  Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
+  if (UseNcq) {
+    Packet->Protocol = EFI_ATA_PASS_THRU_PROTOCOL_FPDMA;
+  } else {
+    Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
+  }
   Packet->Length = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
   //
   // |------------------------|-----------------|------------------------|-----------------|
@@ -552,7 +601,24 @@ TransferAtaDevice (
     Packet->Timeout  = EFI_TIMER_PERIOD_SECONDS (DivU64x32 (MultU64x32 (TransferLength, AtaDevice->BlockMedia.BlockSize), 3300000) + 31);
   }
 
-  return AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  Status = AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  if (UseNcq && (Status == EFI_UNSUPPORTED)) {
+    //
+    // The ATA pass thru instance can't queue commands for this device. Stop
+    // using NCQ and resend the transfer as a plain DMA command.
+    //
+    DEBUG ((EFI_D_INFO, "AtaBus - NCQ unsupported on Port %x PortMultiplierPort %x\n", AtaDevice->Port, AtaDevice->PortMultiplierPort));
+    if (Packet->Asb != NULL) {
+      FreeAlignedBuffer (Packet->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+    }
+    if (Packet->Acb != NULL) {
+      FreePool (Packet->Acb);
+    }
+    AtaDevice->NcqValid = FALSE;
+    Status = TransferAtaDevice (AtaDevice, TaskPacket, Buffer, StartLba, TransferLength, IsWrite, Event);
+  }
+
+  return Status;
 }
 
 /**
@@ -807,7 +873,12 @@ AccessAtaDevice(
   if ((Token != NULL) && (Token->Event != NULL)) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-    if (!IsListEmpty (&AtaDevice->AtaSubTaskList)) {
+    //
+    // Without NCQ the sub tasks of one token are executed one after another, so
+    // a new token waits until the previous one is done. With NCQ the tokens
+    // are handed down right away and kept outstanding together.
+    //
+    if (!IsListEmpty (&AtaDevice->AtaSubTaskList) && !AtaDevice->NcqValid) {
       AtaTask = AllocateZeroPool (sizeof (ATA_BUS_ASYN_TASK));
       if (AtaTask == NULL) {
         gBS->RestoreTPL (OldTpl);
@@ -509,6 +509,126 @@ UnregisterNvmeNamespace (
   return EFI_SUCCESS;
 }
 
+// MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+/**
+  Complete the asynchronous PassThru requests of one I/O completion queue.
+
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                        structure.
+  @param[in]  QueueId   The ID of the asynchronous I/O queue pair.
+
+**/
+STATIC
+VOID
+ProcessAsyncCompletionQueue (
+  IN NVME_CONTROLLER_PRIVATE_DATA     *Private,
+  IN UINT16                           QueueId
+  )
+{
+  EFI_PCI_IO_PROTOCOL                  *PciIo;
+  NVME_CQ                              *Cq;
+  UINT32                               Data;
+  LIST_ENTRY                           *Link;
+  LIST_ENTRY                           *NextLink;
+  NVME_PASS_THRU_ASYNC_REQ             *AsyncRequest;
+  BOOLEAN                              HasNewItem;
+
+  UINT16 QueueSize = PcdGetBool(PcdSupportAlternativeQueueSize) ?
+    NVME_ALTERNATIVE_MAX_QUEUE_SIZE : NVME_ASYNC_CCQ_SIZE;
+
+  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+  HasNewItem = FALSE;
+  PciIo      = Private->PciIo;
+
+  while (Cq->Pt != Private->Pt[QueueId]) {
+    ASSERT (Cq->Sqid == QueueId);
+
+    HasNewItem = TRUE;
+
+    //
+    // Find the command with given Command Id.
+    //
+    for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
+         !IsNull (&Private->AsyncPassThruQueue, Link);
+         Link = NextLink) {
+      NextLink = GetNextNode (&Private->AsyncPassThruQueue, Link);
+      AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
+      if ((AsyncRequest->QueueId == QueueId) &&
+          (AsyncRequest->CommandId == Cq->Cid)) {
+        //
+        // Copy the Respose Queue entry for this command to the callers
+        // response buffer.
+        //
+        CopyMem (
+          AsyncRequest->Packet->NvmeCompletion,
+          Cq,
+          sizeof(EFI_NVM_EXPRESS_COMPLETION)
+          );
+
+        //
+        // Free the resources allocated before cmd submission
+        //
+        if (AsyncRequest->MapData != NULL) {
+          // MS_CHANGE - Add extra debugging for IOMMU error tracking.
+          DEBUG ((DEBUG_VERBOSE, "%a - Unmapping Data Buffer:\n", __FUNCTION__));
+          DEBUG ((DEBUG_VERBOSE, "\tMapData - 0x%lx\n", AsyncRequest->MapData));
+          PciIo->Unmap (PciIo, AsyncRequest->MapData);
+        }
+        if (AsyncRequest->MapMeta != NULL) {
+          // MS_CHANGE - Add extra debugging for IOMMU error tracking.
+          DEBUG ((DEBUG_VERBOSE, "%a - Unmapping MetaData Buffer:\n", __FUNCTION__));
+          DEBUG ((DEBUG_VERBOSE, "\tMapMeta - 0x%lx\n", AsyncRequest->MapMeta));
+          PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
+        }
+        if (AsyncRequest->MapPrpList != NULL) {
+          // MS_CHANGE - Add extra debugging for IOMMU error tracking.
+          DEBUG ((DEBUG_VERBOSE, "%a - Unmapping PrpList Buffer:\n", __FUNCTION__));
+          DEBUG ((DEBUG_VERBOSE, "\tPrpListMapping - 0x%lx\n", AsyncRequest->MapPrpList));
+          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
+        }
+        if (AsyncRequest->PrpListHost != NULL) {
+          PciIo->FreeBuffer (
+                   PciIo,
+                   AsyncRequest->PrpListNo,
+                   AsyncRequest->PrpListHost
+                   );
+        }
+
+        RemoveEntryList (Link);
+        gBS->SignalEvent (AsyncRequest->CallerEvent);
+        FreePool (AsyncRequest);
+
+        //
+        // Update submission queue head.
+        //
+        Private->AsyncSqHead[QueueId] = Cq->Sqhd;
+        break;
+      }
+    }
+
+    Private->CqHdbl[QueueId].Cqh++;
+    if (Private->CqHdbl[QueueId].Cqh > MIN (QueueSize, Private->Cap.Mqes)) {
+      Private->CqHdbl[QueueId].Cqh = 0;
+      Private->Pt[QueueId] ^= 1;
+    }
+
+    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+  }
+
+  if (HasNewItem) {
+    Data  = ReadUnaligned32 ((UINT32*)&Private->CqHdbl[QueueId]);
+    PciIo->Mem.Write (
+                 PciIo,
+                 EfiPciIoWidthUint32,
+                 NVME_BAR,
+                 NVME_CQHDBL_OFFSET(QueueId, Private->Cap.Dstrd),
+                 1,
+                 &Data
+                 );
+  }
+}
+// MU_CHANGE [END]
+
 /**
   Call back function when the timer event is signaled.
 
@@ -525,32 +645,20 @@ ProcessAsyncTaskList (
   )
 {
   NVME_CONTROLLER_PRIVATE_DATA         *Private;
-  EFI_PCI_IO_PROTOCOL                  *PciIo;
-  NVME_CQ                              *Cq;
   UINT16                               QueueId;
-  UINT32                               Data;
   LIST_ENTRY                           *Link;
   LIST_ENTRY                           *NextLink;
-  NVME_PASS_THRU_ASYNC_REQ             *AsyncRequest;
   NVME_BLKIO2_SUBTASK                  *Subtask;
   NVME_BLKIO2_REQUEST                  *BlkIo2Request;
   EFI_BLOCK_IO2_TOKEN                  *Token;
-  BOOLEAN                              HasNewItem;
   EFI_STATUS                           Status;
 
-  // MU_CHANGE - Support alternative hardware queue sizes in NVME driver
-  UINT16 QueueSize = PcdGetBool(PcdSupportAlternativeQueueSize) ?
-    NVME_ALTERNATIVE_MAX_QUEUE_SIZE : NVME_ASYNC_CCQ_SIZE;
-
   Private    = (NVME_CONTROLLER_PRIVATE_DATA*)Context;
-  QueueId    = 2;
-  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  HasNewItem = FALSE;
-  PciIo      = Private->PciIo;
 
   //
   // Submit asynchronous subtasks to the NVMe Submission Queue
   //
+  Private->DeferSqDoorbell = TRUE;    // MU_CHANGE
   for (Link = GetFirstNode (&Private->UnsubmittedSubtasks);
        !IsNull (&Private->UnsubmittedSubtasks, Link);
        Link = NextLink) {
@@ -619,93 +727,77 @@ ProcessAsyncTaskList (
     }
   }
 
-  while (Cq->Pt != Private->Pt[QueueId]) {
-    ASSERT (Cq->Sqid == QueueId);
+  // MU_CHANGE [BEGIN] - Batch async doorbells and adapt the poll interval
+  //
+  // Ring each submission queue doorbell once for all the subtasks above.
+  //
+  NvmeFlushSubmissionDoorbells (Private);
+  // MU_CHANGE [END]
+
+  // MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+  for (QueueId = NVME_ASYNC_QUEUE_ID;
+       QueueId < NVME_ASYNC_QUEUE_ID + Private->AsyncQueueCount;
+       QueueId++) {
+    ProcessAsyncCompletionQueue (Private, QueueId);
+  }
+  // MU_CHANGE [END]
 
-    HasNewItem = TRUE;
+  NvmeUpdateAsyncTimer (Private);   // MU_CHANGE
+}
 
-    //
-    // Find the command with given Command Id.
-    //
-    for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
-         !IsNull (&Private->AsyncPassThruQueue, Link);
-         Link = NextLink) {
-      NextLink = GetNextNode (&Private->AsyncPassThruQueue, Link);
-      AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
-      if (AsyncRequest->CommandId == Cq->Cid) {
-        //
-        // Copy the Respose Queue entry for this command to the callers
-        // response buffer.
-        //
-        CopyMem (
-          AsyncRequest->Packet->NvmeCompletion,
-          Cq,
-          sizeof(EFI_NVM_EXPRESS_COMPLETION)
-          );
+// MU_CHANGE [BEGIN] - Batch async doorbells and adapt the poll interval
+/**
+  Set the period of the asynchronous task timer from the number of
+  outstanding asynchronous requests.
 
-        //
-        // Free the resources allocated before cmd submission
-        //
-        if (AsyncRequest->MapData != NULL) {
-          // MS_CHANGE - Add extra debugging for IOMMU error tracking.
-          DEBUG ((DEBUG_VERBOSE, "%a - Unmapping Data Buffer:\n", __FUNCTION__));
-          DEBUG ((DEBUG_VERBOSE, "\tMapData - 0x%lx\n", AsyncRequest->MapData));
-          PciIo->Unmap (PciIo, AsyncRequest->MapData);
-        }
-        if (AsyncRequest->MapMeta != NULL) {
-          // MS_CHANGE - Add extra debugging for IOMMU error tracking.
-          DEBUG ((DEBUG_VERBOSE, "%a - Unmapping MetaData Buffer:\n", __FUNCTION__));
-          DEBUG ((DEBUG_VERBOSE, "\tMapMeta - 0x%lx\n", AsyncRequest->MapMeta));
-          PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
-        }
-        if (AsyncRequest->MapPrpList != NULL) {
-          // MS_CHANGE - Add extra debugging for IOMMU error tracking.
-          DEBUG ((DEBUG_VERBOSE, "%a - Unmapping PrpList Buffer:\n", __FUNCTION__));
-          DEBUG ((DEBUG_VERBOSE, "\tPrpListMapping - 0x%lx\n", AsyncRequest->MapPrpList));
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-        }
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
-                   PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
-                   );
-        }
+  The caller must be at TPL_NOTIFY.
 
-        RemoveEntryList (Link);
-        gBS->SignalEvent (AsyncRequest->CallerEvent);
-        FreePool (AsyncRequest);
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                        structure.
 
-        //
-        // Update submission queue head.
-        //
-        Private->AsyncSqHead = Cq->Sqhd;
-        break;
-      }
-    }
+**/
+VOID
+NvmeUpdateAsyncTimer (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  )
+{
+  LIST_ENTRY                         *Link;
+  UINTN                              Outstanding;
+  UINT64                             Period;
 
-    Private->CqHdbl[QueueId].Cqh++;
-    // MU_CHANGE - Support alternative hardware queue sizes in NVME driver
-    if (Private->CqHdbl[QueueId].Cqh > MIN (QueueSize, Private->Cap.Mqes)) {
-      Private->CqHdbl[QueueId].Cqh = 0;
-      Private->Pt[QueueId] ^= 1;
-    }
+  //
+  // Leave the timer alone while a controller reset has it cancelled.
+  //
+  if (Private->AsyncTimerPeriod == 0) {
+    return;
+  }
 
-    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+  //
+  // Only count up to the light load threshold.
+  //
+  Outstanding = 0;
+  for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
+       !IsNull (&Private->AsyncPassThruQueue, Link) &&
+       (Outstanding <= NVME_ASYNC_LIGHT_LOAD_REQUESTS);
+       Link = GetNextNode (&Private->AsyncPassThruQueue, Link)) {
+    Outstanding++;
   }
 
-  if (HasNewItem) {
-    Data  = ReadUnaligned32 ((UINT32*)&Private->CqHdbl[QueueId]);
-    PciIo->Mem.Write (
-                 PciIo,
-                 EfiPciIoWidthUint32,
-                 NVME_BAR,
-                 NVME_CQHDBL_OFFSET(QueueId, Private->Cap.Dstrd),
-                 1,
-                 &Data
-                 );
+  if ((Outstanding == 0) && IsListEmpty (&Private->UnsubmittedSubtasks)) {
+    Period = NVME_HC_ASYNC_IDLE_TIMER;
+  } else if (Outstanding <= NVME_ASYNC_LIGHT_LOAD_REQUESTS) {
+    Period = NVME_HC_ASYNC_LIGHT_LOAD_TIMER;
+  } else {
+    Period = NVME_HC_ASYNC_TIMER;
+  }
+
+  if (Period != Private->AsyncTimerPeriod) {
+    if (!EFI_ERROR (gBS->SetTimer (Private->TimerEvent, TimerPeriodic, Period))) {
+      Private->AsyncTimerPeriod = Period;
+    }
   }
 }
+// MU_CHANGE [END]
 
 /**
   Tests to see if this driver supports a given controller. If a child device is provided,
@@ -922,7 +1014,7 @@ NvmExpressDriverBindingStart (
 
   // MU_CHANGE - Support alternative hardware queue sizes in NVME driver
   UINTN QueuePageCount = PcdGetBool(PcdSupportAlternativeQueueSize) ?
-    NVME_ALTERNATIVE_TOTAL_QUEUE_BUFFER_IN_PAGES : 6;
+    NVME_ALTERNATIVE_TOTAL_QUEUE_BUFFER_IN_PAGES : NVME_TOTAL_QUEUE_BUFFER_IN_PAGES;
 
   DEBUG ((EFI_D_INFO, "NvmExpressDriverBindingStart: start\n"));
 
@@ -1067,6 +1159,7 @@ NvmExpressDriverBindingStart (
     if (EFI_ERROR (Status)) {
       goto Exit;
     }
+    Private->AsyncTimerPeriod = NVME_HC_ASYNC_TIMER;    // MU_CHANGE
 
     Status = gBS->InstallMultipleProtocolInterfaces (
                     &Controller,
@@ -1211,7 +1304,7 @@ NvmExpressDriverBindingStop (
 
   // MU_CHANGE - Support alternative hardware queue sizes in NVME driver
   UINT16 QueuePageCount = PcdGetBool(PcdSupportAlternativeQueueSize) ?
-    NVME_ALTERNATIVE_TOTAL_QUEUE_BUFFER_IN_PAGES : 6;
+    NVME_ALTERNATIVE_TOTAL_QUEUE_BUFFER_IN_PAGES : NVME_TOTAL_QUEUE_BUFFER_IN_PAGES;
 
   if (NumberOfChildren == 0) {
     Status = gBS->OpenProtocol (
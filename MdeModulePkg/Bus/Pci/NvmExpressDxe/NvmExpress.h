@@ -82,7 +82,33 @@ extern EFI_GUID                                   gNVMeEnableCompleteEventGroupG
 //
 #define NVME_ASYNC_CCQ_SIZE                       255
 
-#define NVME_MAX_QUEUES                           3     // Number of queues supported by the driver
+// MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+//
+// Queue pair #0 is the admin queue and #1 takes blocking I/O. Non-blocking
+// I/O is spread across up to NVME_MAX_ASYNC_QUEUES queue pairs, starting at
+// NVME_ASYNC_QUEUE_ID. The controller may grant fewer of them.
+//
+#define NVME_ASYNC_QUEUE_ID                       2
+#define NVME_MAX_ASYNC_QUEUES                     4
+
+#define NVME_MAX_QUEUES                           (NVME_ASYNC_QUEUE_ID + NVME_MAX_ASYNC_QUEUES)     // Number of queues supported by the driver
+
+//
+// Each submission queue and each completion queue takes one page.
+//
+#define NVME_TOTAL_QUEUE_BUFFER_IN_PAGES          (NVME_MAX_QUEUES * 2)
+
+//
+// Blocking reads and writes larger than the maximum transfer size keep up to
+// this many commands outstanding on the asynchronous I/O queues.
+//
+#define NVME_MAX_BATCHED_COMMANDS                 8
+
+//
+// Feature identifier of the Number of Queues feature.
+//
+#define NVME_FEATURE_NUMBER_OF_QUEUES             0x07
+// MU_CHANGE [END]
 
 // MU_CHANGE [BEGIN] - Support alternative hardware queue sizes in NVME driver
 
@@ -111,6 +137,20 @@ extern EFI_GUID                                   gNVMeEnableCompleteEventGroupG
 //
 #define NVME_HC_ASYNC_TIMER                       EFI_TIMER_PERIOD_MILLISECONDS (1)
 
+// MU_CHANGE [BEGIN] - Batch async doorbells and adapt the poll interval
+//
+// With up to NVME_ASYNC_LIGHT_LOAD_REQUESTS asynchronous requests
+// outstanding, the completion queues are polled every
+// NVME_HC_ASYNC_LIGHT_LOAD_TIMER so that each request completes with little
+// latency. With more requests outstanding, the NVME_HC_ASYNC_TIMER interval
+// lets each poll drain several completions. An idle controller is polled
+// every NVME_HC_ASYNC_IDLE_TIMER.
+//
+#define NVME_HC_ASYNC_LIGHT_LOAD_TIMER            EFI_TIMER_PERIOD_MICROSECONDS (100)
+#define NVME_HC_ASYNC_IDLE_TIMER                  EFI_TIMER_PERIOD_MILLISECONDS (10)
+#define NVME_ASYNC_LIGHT_LOAD_REQUESTS            4
+// MU_CHANGE [END]
+
 //
 // Unique signature for private data structure.
 //
@@ -139,15 +179,18 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   //
   NVME_ADMIN_CONTROLLER_DATA          *ControllerData;
 
+  // MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // NVME_TOTAL_QUEUE_BUFFER_IN_PAGES x 4kB aligned buffers will be carved out
+  // of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // Each following pair of boundaries is the start of the submission and
+  // completion queue of one asynchronous I/O queue pair.
   //
+  // MU_CHANGE [END]
   UINT8                               *Buffer;
   UINT8                               *BufferPciAddr;
 
@@ -164,7 +207,16 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   //
   NVME_SQTDBL                         SqTdbl[NVME_MAX_QUEUES];
   NVME_CQHDBL                         CqHdbl[NVME_MAX_QUEUES];
-  UINT16                              AsyncSqHead;
+  UINT16                              AsyncSqHead[NVME_MAX_QUEUES];   // MU_CHANGE
+
+  // MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+  //
+  // Number of asynchronous I/O queue pairs created, and the one that takes
+  // the next non-blocking request.
+  //
+  UINT16                              AsyncQueueCount;
+  UINT16                              NextAsyncQueue;
+  // MU_CHANGE [END]
 
   //
   // Flag to indicate internal IO queue creation.
@@ -187,6 +239,21 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   EFI_EVENT                           TimerEvent;
   LIST_ENTRY                          AsyncPassThruQueue;
   LIST_ENTRY                          UnsubmittedSubtasks;
+
+  // MU_CHANGE [BEGIN] - Batch async doorbells and adapt the poll interval
+  //
+  // Period of TimerEvent, 0 while it is cancelled.
+  //
+  UINT64                              AsyncTimerPeriod;
+
+  //
+  // While DeferSqDoorbell is set, non-blocking submissions only mark their
+  // queue in SqDoorbellPending, and NvmeFlushSubmissionDoorbells() rings the
+  // doorbells.
+  //
+  BOOLEAN                             DeferSqDoorbell;
+  BOOLEAN                             SqDoorbellPending[NVME_MAX_QUEUES];
+  // MU_CHANGE [END]
 };
 
 #define NVME_CONTROLLER_PRIVATE_DATA_FROM_PASS_THRU(a) \
@@ -316,6 +383,7 @@ typedef struct {
   LIST_ENTRY                               Link;
 
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET *Packet;
+  UINT16                                   QueueId;     // MU_CHANGE
   UINT16                                   CommandId;
   VOID                                     *MapPrpList;
   UINTN                                    PrpListNo;
@@ -746,6 +814,69 @@ NvmeDumpStatus (
   IN NVME_CQ             *Cq
   );
 
+// MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT                    Event,
+  IN VOID*                        Context
+  );
+
+/**
+  Set the period of the asynchronous task timer from the number of
+  outstanding asynchronous requests.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                        structure.
+
+**/
+VOID
+NvmeUpdateAsyncTimer (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  );
+
+/**
+  Ring the submission queue doorbells of the non-blocking commands placed
+  since DeferSqDoorbell was set, and clear DeferSqDoorbell.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                        structure.
+
+**/
+VOID
+NvmeFlushSubmissionDoorbells (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  );
+
+/**
+  Reset the controller after an NVMe command timed out, and abort the
+  outstanding asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_TIMEOUT       The controller has been reset.
+  @return Others            The controller cannot be reset.
+
+**/
+EFI_STATUS
+NvmeResetAfterTimeout (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  );
+// MU_CHANGE [END]
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
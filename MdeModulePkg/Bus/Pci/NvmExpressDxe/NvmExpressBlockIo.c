@@ -141,6 +141,199 @@ WriteSectors (
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Keep several commands outstanding for large transfers
+typedef struct {
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                  Command;
+  EFI_NVM_EXPRESS_COMPLETION               Completion;
+  EFI_EVENT                                Event;
+  BOOLEAN                                  InFlight;
+} NVME_BATCHED_COMMAND;
+
+/**
+  Read or write blocks with several commands outstanding.
+
+  The transfer is split in commands of MaxTransferBlocks blocks. Up to
+  NVME_MAX_BATCHED_COMMANDS of them are submitted to the asynchronous I/O
+  queues before the completions are polled, so the controller works on
+  several commands at once instead of one.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Buffer                 The buffer of the data.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred.
+  @param  MaxTransferBlocks      The maximum block number of one command.
+  @param  IsRead                 TRUE to read from the device, FALSE to write to it.
+
+  @retval EFI_SUCCESS            All the blocks are transferred.
+  @retval Others                 Fail to transfer all the blocks.
+
+**/
+STATIC
+EFI_STATUS
+NvmeBatchedTransfer (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN OUT VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     UINT32                         MaxTransferBlocks,
+  IN     BOOLEAN                        IsRead
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA     *Private;
+  NVME_BATCHED_COMMAND             Commands[NVME_MAX_BATCHED_COMMANDS];
+  NVME_BATCHED_COMMAND             *Batched;
+  NVME_CQ                          *Cq;
+  EFI_EVENT                        TimerEvent;
+  EFI_STATUS                       Status;
+  EFI_STATUS                       SubmitStatus;
+  EFI_TPL                          OldTpl;
+  UINTN                            Index;
+  UINTN                            Outstanding;
+  UINT32                           TransferBlocks;
+  BOOLEAN                          Completed;
+
+  Private     = Device->Controller;
+  TimerEvent  = NULL;
+  Outstanding = 0;
+  ZeroMem (Commands, sizeof (Commands));
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < NVME_MAX_BATCHED_COMMANDS; Index++) {
+    Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Commands[Index].Event);
+    if (EFI_ERROR (Status)) {
+      goto EXIT;
+    }
+  }
+
+  Status = gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    goto EXIT;
+  }
+
+  while (((Blocks > 0) && !EFI_ERROR (Status)) || (Outstanding > 0)) {
+    //
+    // Submit a command in each free slot. Stop when the queues are full, and
+    // stop submitting at all after an error. The asynchronous I/O queues are
+    // also fed from the timer event, so the submissions are made at
+    // TPL_NOTIFY, and each doorbell is rung once for all of them.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Private->DeferSqDoorbell = TRUE;
+    for (Index = 0; (Index < NVME_MAX_BATCHED_COMMANDS) && (Blocks > 0) && !EFI_ERROR (Status); Index++) {
+      Batched = &Commands[Index];
+      if (Batched->InFlight) {
+        continue;
+      }
+
+      TransferBlocks = (UINT32)MIN (Blocks, MaxTransferBlocks);
+
+      ZeroMem (&Batched->CommandPacket, sizeof(EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+      ZeroMem (&Batched->Command, sizeof(EFI_NVM_EXPRESS_COMMAND));
+      ZeroMem (&Batched->Completion, sizeof(EFI_NVM_EXPRESS_COMPLETION));
+
+      Batched->CommandPacket.NvmeCmd        = &Batched->Command;
+      Batched->CommandPacket.NvmeCompletion = &Batched->Completion;
+
+      Batched->Command.Cdw0.Opcode = IsRead ? NVME_IO_READ_OPC : NVME_IO_WRITE_OPC;
+      Batched->Command.Nsid        = Device->NamespaceId;
+
+      Batched->CommandPacket.TransferBuffer = Buffer;
+      Batched->CommandPacket.TransferLength = TransferBlocks * Device->Media.BlockSize;
+      Batched->CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+      Batched->CommandPacket.QueueType      = NVME_IO_QUEUE;
+
+      Batched->Command.Cdw10 = (UINT32)Lba;
+      Batched->Command.Cdw11 = (UINT32)RShiftU64 (Lba, 32);
+      Batched->Command.Cdw12 = (TransferBlocks - 1) & 0xFFFF;
+      if (!IsRead) {
+        //
+        // Set Force Unit Access bit (bit 30) to use write-through behaviour
+        //
+        Batched->Command.Cdw12 |= BIT30;
+      }
+      Batched->Command.Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
+
+      SubmitStatus = Private->Passthru.PassThru (
+                                         &Private->Passthru,
+                                         Device->NamespaceId,
+                                         &Batched->CommandPacket,
+                                         Batched->Event
+                                         );
+      if (SubmitStatus == EFI_NOT_READY) {
+        break;
+      } else if (EFI_ERROR (SubmitStatus)) {
+        Status = SubmitStatus;
+        break;
+      }
+
+      Batched->InFlight = TRUE;
+      Outstanding++;
+      Blocks -= TransferBlocks;
+      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + TransferBlocks * Device->Media.BlockSize);
+      Lba    += TransferBlocks;
+    }
+    NvmeFlushSubmissionDoorbells (Private);
+
+    //
+    // Poll the completion queues instead of waiting for the timer event.
+    //
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+
+    Completed = FALSE;
+    for (Index = 0; Index < NVME_MAX_BATCHED_COMMANDS; Index++) {
+      Batched = &Commands[Index];
+      if (!Batched->InFlight || EFI_ERROR (gBS->CheckEvent (Batched->Event))) {
+        continue;
+      }
+
+      Batched->InFlight = FALSE;
+      Outstanding--;
+      Completed = TRUE;
+
+      Cq = (NVME_CQ *)&Batched->Completion;
+      if ((Cq->Sct != 0) || (Cq->Sc != 0)) {
+        Status = EFI_DEVICE_ERROR;
+
+        //
+        // Dump completion entry status for debugging.
+        //
+        DEBUG_CODE_BEGIN();
+          NvmeDumpStatus (Cq);
+        DEBUG_CODE_END();
+      }
+    }
+
+    if (Completed) {
+      gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+    } else if (!EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      //
+      // No command completed in time. Resetting the controller aborts the
+      // outstanding commands and signals their events.
+      //
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for an NVMe command.\n", __FUNCTION__));
+      Status = NvmeResetAfterTimeout (Private);
+      break;
+    }
+  }
+
+EXIT:
+  for (Index = 0; Index < NVME_MAX_BATCHED_COMMANDS; Index++) {
+    if (Commands[Index].Event != NULL) {
+      gBS->CloseEvent (Commands[Index].Event);
+    }
+  }
+  gBS->CloseEvent (TimerEvent);
+
+  return Status;
+}
+// MU_CHANGE [END]
+
 /**
   Read some blocks from the device.
 
@@ -195,7 +388,16 @@ NvmeRead (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
+  // MU_CHANGE [BEGIN] - Keep several commands outstanding for large transfers
+  if (Blocks > MaxTransferBlocks) {
+    Status = NvmeBatchedTransfer (Device, Buffer, Lba, Blocks, MaxTransferBlocks, TRUE);
+    if (!EFI_ERROR (Status)) {
+      Blocks = 0;
+    }
+  }
+  // MU_CHANGE [END]
+
+  while (!EFI_ERROR (Status) && (Blocks > 0)) {   // MU_CHANGE
     if (Blocks > MaxTransferBlocks) {
       Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
 
@@ -273,7 +475,16 @@ NvmeWrite (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
+  // MU_CHANGE [BEGIN] - Keep several commands outstanding for large transfers
+  if (Blocks > MaxTransferBlocks) {
+    Status = NvmeBatchedTransfer (Device, Buffer, Lba, Blocks, MaxTransferBlocks, FALSE);
+    if (!EFI_ERROR (Status)) {
+      Blocks = 0;
+    }
+  }
+  // MU_CHANGE [END]
+
+  while (!EFI_ERROR (Status) && (Blocks > 0)) {   // MU_CHANGE
     if (Blocks > MaxTransferBlocks) {
       Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
 
@@ -512,6 +723,7 @@ AsyncReadSectors (
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   InsertTailList (&Private->UnsubmittedSubtasks, &Subtask->Link);
   Request->UnsubmittedSubtaskNum++;
+  NvmeUpdateAsyncTimer (Private);     // MU_CHANGE
   gBS->RestoreTPL (OldTpl);
 
   return EFI_SUCCESS;
@@ -654,6 +866,7 @@ AsyncWriteSectors (
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   InsertTailList (&Private->UnsubmittedSubtasks, &Subtask->Link);
   Request->UnsubmittedSubtaskNum++;
+  NvmeUpdateAsyncTimer (Private);     // MU_CHANGE
   gBS->RestoreTPL (OldTpl);
 
   return EFI_SUCCESS;
@@ -575,6 +575,79 @@ NvmeIdentifyNamespace (
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+/**
+  Ask the controller for the I/O queue pairs of the driver, and record how
+  many asynchronous I/O queue pairs can be created.
+
+  A single asynchronous I/O queue pair is used when the controller does not
+  report the number of queues it allocated.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeSetNumberOfQueues (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private
+  )
+{
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                  Command;
+  EFI_NVM_EXPRESS_COMPLETION               Completion;
+  EFI_STATUS                               Status;
+  NVME_ADMIN_SET_FEATURES                  SetFeatures;
+  UINT32                                   Allocated;
+
+  Private->AsyncQueueCount = 1;
+  Private->NextAsyncQueue  = 0;
+
+  ZeroMem (&CommandPacket, sizeof(EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+  ZeroMem (&Command, sizeof(EFI_NVM_EXPRESS_COMMAND));
+  ZeroMem (&Completion, sizeof(EFI_NVM_EXPRESS_COMPLETION));
+  ZeroMem (&SetFeatures, sizeof(NVME_ADMIN_SET_FEATURES));
+
+  CommandPacket.NvmeCmd        = &Command;
+  CommandPacket.NvmeCompletion = &Completion;
+
+  Command.Cdw0.Opcode = NVME_ADMIN_SET_FEATURES_CMD;
+  CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+  CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
+
+  //
+  // The numbers of I/O submission and completion queues are 0-based.
+  //
+  SetFeatures.Fid = NVME_FEATURE_NUMBER_OF_QUEUES;
+  CopyMem (&CommandPacket.NvmeCmd->Cdw10, &SetFeatures, sizeof (NVME_ADMIN_SET_FEATURES));
+  CommandPacket.NvmeCmd->Cdw11 = ((NVME_MAX_QUEUES - 2) << 16) | (NVME_MAX_QUEUES - 2);
+  CommandPacket.NvmeCmd->Flags = CDW10_VALID | CDW11_VALID;
+
+  Status = Private->Passthru.PassThru (
+                               &Private->Passthru,
+                               0,
+                               &CommandPacket,
+                               NULL
+                               );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: Number of Queues feature cannot be set - %r\n", __FUNCTION__, Status));
+    return;
+  }
+
+  //
+  // Dword 0 holds the 0-based numbers of submission queues (bits 15:0) and
+  // completion queues (bits 31:16) allocated. One pair is for blocking I/O.
+  //
+  Allocated = MIN (Completion.DW0 & 0xFFFF, Completion.DW0 >> 16);
+  if (Allocated > NVME_MAX_ASYNC_QUEUES) {
+    Allocated = NVME_MAX_ASYNC_QUEUES;
+  }
+  if (Allocated > 1) {
+    Private->AsyncQueueCount = (UINT16)Allocated;
+  }
+
+  DEBUG ((DEBUG_INFO, "%a: %d asynchronous I/O queue pairs\n", __FUNCTION__, Private->AsyncQueueCount));
+}
+// MU_CHANGE [END]
+
 /**
   Create io completion queue.
 
@@ -600,7 +673,7 @@ NvmeCreateIoCompletionQueue (
   Status = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_ID + Private->AsyncQueueCount; Index++) {   // MU_CHANGE
     ZeroMem (&CommandPacket, sizeof(EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof(EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof(EFI_NVM_EXPRESS_COMPLETION));
@@ -674,7 +747,7 @@ NvmeCreateIoSubmissionQueue (
   Status = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_ID + Private->AsyncQueueCount; Index++) {   // MU_CHANGE
     ZeroMem (&CommandPacket, sizeof(EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof(EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof(EFI_NVM_EXPRESS_COMPLETION));
@@ -694,8 +767,8 @@ NvmeCreateIoSubmissionQueue (
       QueueSize = MIN (NVME_ALTERNATIVE_MAX_QUEUE_SIZE, Private->Cap.Mqes);
     } else if (Index == 1) {
       QueueSize = NVME_CCQ_SIZE;
-    } else if (Private->Cap.Mqes > NVME_ASYNC_CCQ_SIZE) {
-      QueueSize = NVME_ASYNC_CCQ_SIZE;
+    } else if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
+      QueueSize = NVME_ASYNC_CSQ_SIZE;
     } else {
       QueueSize = Private->Cap.Mqes;
     }
@@ -747,6 +820,7 @@ NvmeControllerInit (
   NVME_ACQ                        Acq;
   UINT8                           Sn[21];
   UINT8                           Mn[41];
+  UINTN                           Index;      // MU_CHANGE
   //
   // Save original PCI attributes and enable this controller.
   //
@@ -815,19 +889,17 @@ NvmeControllerInit (
   //
   ASSERT ((Private->Cap.Mpsmin + 12) <= EFI_PAGE_SHIFT);
 
-  Private->Cid[0] = 0;
-  Private->Cid[1] = 0;
-  Private->Cid[2] = 0;
-  Private->Pt[0]  = 0;
-  Private->Pt[1]  = 0;
-  Private->Pt[2]  = 0;
-  Private->SqTdbl[0].Sqt = 0;
-  Private->SqTdbl[1].Sqt = 0;
-  Private->SqTdbl[2].Sqt = 0;
-  Private->CqHdbl[0].Cqh = 0;
-  Private->CqHdbl[1].Cqh = 0;
-  Private->CqHdbl[2].Cqh = 0;
-  Private->AsyncSqHead   = 0;
+  // MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+  for (Index = 0; Index < NVME_MAX_QUEUES; Index++) {
+    Private->Cid[Index]          = 0;
+    Private->Pt[Index]           = 0;
+    Private->SqTdbl[Index].Sqt   = 0;
+    Private->CqHdbl[Index].Cqh   = 0;
+    Private->AsyncSqHead[Index]  = 0;
+    Private->SqDoorbellPending[Index] = FALSE;
+  }
+  Private->DeferSqDoorbell = FALSE;
+  // MU_CHANGE [END]
 
   Status = NvmeDisableController (Private);
 
@@ -864,33 +936,25 @@ NvmeControllerInit (
   // Address of I/O submission & completion queue.
   //
   if (PcdGetBool(PcdSupportAlternativeQueueSize)) {
+    //
+    // Each queue pair takes a 4 page submission queue and a 1 page
+    // completion queue.
+    //
     ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (NVME_ALTERNATIVE_TOTAL_QUEUE_BUFFER_IN_PAGES));
-    Private->SqBuffer[0]        = (NVME_SQ *)(UINTN)(Private->Buffer);
-    Private->SqBufferPciAddr[0] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr);
-    Private->CqBuffer[0]        = (NVME_CQ *)(UINTN)(Private->Buffer + 4 * EFI_PAGE_SIZE);
-    Private->CqBufferPciAddr[0] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 4 * EFI_PAGE_SIZE);
-    Private->SqBuffer[1]        = (NVME_SQ *)(UINTN)(Private->Buffer + 5 * EFI_PAGE_SIZE);
-    Private->SqBufferPciAddr[1] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 5 * EFI_PAGE_SIZE);
-    Private->CqBuffer[1]        = (NVME_CQ *)(UINTN)(Private->Buffer + 9 * EFI_PAGE_SIZE);
-    Private->CqBufferPciAddr[1] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 9 * EFI_PAGE_SIZE);
-    Private->SqBuffer[2]        = (NVME_SQ *)(UINTN)(Private->Buffer + 10 * EFI_PAGE_SIZE);
-    Private->SqBufferPciAddr[2] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 10 * EFI_PAGE_SIZE);
-    Private->CqBuffer[2]        = (NVME_CQ *)(UINTN)(Private->Buffer + 14 * EFI_PAGE_SIZE);
-    Private->CqBufferPciAddr[2] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 14 * EFI_PAGE_SIZE);
+    for (Index = 0; Index < NVME_MAX_QUEUES; Index++) {
+      Private->SqBuffer[Index]        = (NVME_SQ *)(UINTN)(Private->Buffer + (Index * 5) * EFI_PAGE_SIZE);
+      Private->SqBufferPciAddr[Index] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + (Index * 5) * EFI_PAGE_SIZE);
+      Private->CqBuffer[Index]        = (NVME_CQ *)(UINTN)(Private->Buffer + (Index * 5 + 4) * EFI_PAGE_SIZE);
+      Private->CqBufferPciAddr[Index] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + (Index * 5 + 4) * EFI_PAGE_SIZE);
+    }
   } else {
-    ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (6));
-    Private->SqBuffer[0]        = (NVME_SQ *)(UINTN)(Private->Buffer);
-    Private->SqBufferPciAddr[0] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr);
-    Private->CqBuffer[0]        = (NVME_CQ *)(UINTN)(Private->Buffer + 1 * EFI_PAGE_SIZE);
-    Private->CqBufferPciAddr[0] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 1 * EFI_PAGE_SIZE);
-    Private->SqBuffer[1]        = (NVME_SQ *)(UINTN)(Private->Buffer + 2 * EFI_PAGE_SIZE);
-    Private->SqBufferPciAddr[1] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 2 * EFI_PAGE_SIZE);
-    Private->CqBuffer[1]        = (NVME_CQ *)(UINTN)(Private->Buffer + 3 * EFI_PAGE_SIZE);
-    Private->CqBufferPciAddr[1] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 3 * EFI_PAGE_SIZE);
-    Private->SqBuffer[2]        = (NVME_SQ *)(UINTN)(Private->Buffer + 4 * EFI_PAGE_SIZE);
-    Private->SqBufferPciAddr[2] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 4 * EFI_PAGE_SIZE);
-    Private->CqBuffer[2]        = (NVME_CQ *)(UINTN)(Private->Buffer + 5 * EFI_PAGE_SIZE);
-    Private->CqBufferPciAddr[2] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 5 * EFI_PAGE_SIZE);
+    ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (NVME_TOTAL_QUEUE_BUFFER_IN_PAGES));
+    for (Index = 0; Index < NVME_MAX_QUEUES; Index++) {
+      Private->SqBuffer[Index]        = (NVME_SQ *)(UINTN)(Private->Buffer + (Index * 2) * EFI_PAGE_SIZE);
+      Private->SqBufferPciAddr[Index] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + (Index * 2) * EFI_PAGE_SIZE);
+      Private->CqBuffer[Index]        = (NVME_CQ *)(UINTN)(Private->Buffer + (Index * 2 + 1) * EFI_PAGE_SIZE);
+      Private->CqBufferPciAddr[Index] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + (Index * 2 + 1) * EFI_PAGE_SIZE);
+    }
   }
   // MU_CHANGE [END]
 
@@ -901,8 +965,12 @@ NvmeControllerInit (
   DEBUG ((EFI_D_INFO, "Admin     Completion Queue (CqBuffer[0]) = [%016X]\n", Private->CqBuffer[0]));
   DEBUG ((EFI_D_INFO, "Sync  I/O Submission Queue (SqBuffer[1]) = [%016X]\n", Private->SqBuffer[1]));
   DEBUG ((EFI_D_INFO, "Sync  I/O Completion Queue (CqBuffer[1]) = [%016X]\n", Private->CqBuffer[1]));
-  DEBUG ((EFI_D_INFO, "Async I/O Submission Queue (SqBuffer[2]) = [%016X]\n", Private->SqBuffer[2]));
-  DEBUG ((EFI_D_INFO, "Async I/O Completion Queue (CqBuffer[2]) = [%016X]\n", Private->CqBuffer[2]));
+  // MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+  for (Index = NVME_ASYNC_QUEUE_ID; Index < NVME_MAX_QUEUES; Index++) {
+    DEBUG ((EFI_D_INFO, "Async I/O Submission Queue (SqBuffer[%d]) = [%016X]\n", (UINT32)Index, Private->SqBuffer[Index]));
+    DEBUG ((EFI_D_INFO, "Async I/O Completion Queue (CqBuffer[%d]) = [%016X]\n", (UINT32)Index, Private->CqBuffer[Index]));
+  }
+  // MU_CHANGE [END]
 
   //
   // Program admin queue attributes.
@@ -978,18 +1046,22 @@ NvmeControllerInit (
   DEBUG ((EFI_D_INFO, "    CQES      : 0x%x\n", Private->ControllerData->Cqes));
   DEBUG ((EFI_D_INFO, "    NN        : 0x%x\n", Private->ControllerData->Nn));
 
+  // MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+  NvmeSetNumberOfQueues (Private);
+
   //
-  // Create two I/O completion queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Create the I/O completion queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
+  // MU_CHANGE [END]
   Status = NvmeCreateIoCompletionQueue (Private);
   if (EFI_ERROR(Status)) {
    return Status;
   }
 
   //
-  // Create two I/O Submission queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Create the I/O Submission queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
   Status = NvmeCreateIoSubmissionQueue (Private);
 
@@ -411,6 +411,105 @@ AbortAsyncPassThruTasks (
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Batch async doorbells and adapt the poll interval
+/**
+  Ring the submission queue doorbells of the non-blocking commands placed
+  since DeferSqDoorbell was set, and clear DeferSqDoorbell.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data
+                        structure.
+
+**/
+VOID
+NvmeFlushSubmissionDoorbells (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  )
+{
+  EFI_PCI_IO_PROTOCOL                *PciIo;
+  UINT16                             QueueId;
+  UINT32                             Data;
+
+  PciIo = Private->PciIo;
+  Private->DeferSqDoorbell = FALSE;
+
+  for (QueueId = NVME_ASYNC_QUEUE_ID; QueueId < NVME_MAX_QUEUES; QueueId++) {
+    if (!Private->SqDoorbellPending[QueueId]) {
+      continue;
+    }
+
+    Private->SqDoorbellPending[QueueId] = FALSE;
+    Data = ReadUnaligned32 ((UINT32*)&Private->SqTdbl[QueueId]);
+    PciIo->Mem.Write (
+                 PciIo,
+                 EfiPciIoWidthUint32,
+                 NVME_BAR,
+                 NVME_SQTDBL_OFFSET(QueueId, Private->Cap.Dstrd),
+                 1,
+                 &Data
+                 );
+  }
+}
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+/**
+  Reset the controller after an NVMe command timed out, and abort the
+  outstanding asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_TIMEOUT       The controller has been reset.
+  @return Others            The controller cannot be reset.
+
+**/
+EFI_STATUS
+NvmeResetAfterTimeout (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  )
+{
+  EFI_STATUS                         Status;
+
+  //
+  // Disable the timer to trigger the process of async transfers temporarily.
+  //
+  Status = gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  Private->AsyncTimerPeriod = 0;    // MU_CHANGE
+
+  //
+  // Reset the NVMe controller.
+  //
+  Status = NvmeControllerInit (Private);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Status = AbortAsyncPassThruTasks (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Re-enable the timer to trigger the process of async transfers.
+  //
+  Status = gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  Private->AsyncTimerPeriod = NVME_HC_ASYNC_TIMER;    // MU_CHANGE
+
+  //
+  // Return EFI_TIMEOUT to indicate a timeout occurs for NVMe PassThru command.
+  //
+  return EFI_TIMEOUT;
+}
+// MU_CHANGE [END]
+
 // MS_CHANGE [BEGIN] - Add extra debugging for IOMMU error tracking.
 /**
   Dump PassThru packet info
@@ -523,6 +622,7 @@ NvmExpressPassThru (
   UINT32                         Data;
   NVME_PASS_THRU_ASYNC_REQ       *AsyncRequest;
   EFI_TPL                        OldTpl;
+  UINT16                         Index;         // MU_CHANGE
 
   //
   // check the data fields in Packet parameter.
@@ -623,15 +723,29 @@ NvmExpressPassThru (
     if (Event == NULL) {
       QueueId = 1;
     } else {
-      QueueId = 2;
+      // MU_CHANGE [BEGIN] - Spread non-blocking I/O across several queue pairs
+      //
+      // Use the asynchronous I/O queues in turn, and skip the full ones.
+      //
+      QueueId = NVME_ASYNC_QUEUE_ID;
+      for (Index = 0; Index < Private->AsyncQueueCount; Index++) {
+        QueueId = (UINT16)(NVME_ASYNC_QUEUE_ID +
+                           (Private->NextAsyncQueue + Index) % Private->AsyncQueueCount);
+        if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize !=
+            Private->AsyncSqHead[QueueId]) {
+          break;
+        }
+      }
 
       //
       // Submission queue full check.
       //
-      if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize ==
-          Private->AsyncSqHead) {
+      if (Index == Private->AsyncQueueCount) {
         return EFI_NOT_READY;
       }
+
+      Private->NextAsyncQueue = (UINT16)((QueueId - NVME_ASYNC_QUEUE_ID + 1) % Private->AsyncQueueCount);
+      // MU_CHANGE [END]
     }
   }
   Sq  = Private->SqBuffer[QueueId] + Private->SqTdbl[QueueId].Sqt;
@@ -826,19 +940,28 @@ NvmExpressPassThru (
   }
   // MU_CHANGE [END]
 
-  Data = ReadUnaligned32 ((UINT32*)&Private->SqTdbl[QueueId]);
-  Status = PciIo->Mem.Write (
-               PciIo,
-               EfiPciIoWidthUint32,
-               NVME_BAR,
-               NVME_SQTDBL_OFFSET(QueueId, Private->Cap.Dstrd),
-               1,
-               &Data
-               );
+  // MU_CHANGE [BEGIN] - Batch async doorbells and adapt the poll interval
+  if (Private->DeferSqDoorbell && (Event != NULL) && (QueueId != 0)) {
+    //
+    // The caller rings the doorbell once for the whole batch.
+    //
+    Private->SqDoorbellPending[QueueId] = TRUE;
+  } else {
+    Data = ReadUnaligned32 ((UINT32*)&Private->SqTdbl[QueueId]);
+    Status = PciIo->Mem.Write (
+                 PciIo,
+                 EfiPciIoWidthUint32,
+                 NVME_BAR,
+                 NVME_SQTDBL_OFFSET(QueueId, Private->Cap.Dstrd),
+                 1,
+                 &Data
+                 );
 
-  if (EFI_ERROR (Status)) {
-    goto EXIT;
+    if (EFI_ERROR (Status)) {
+      goto EXIT;
+    }
   }
+  // MU_CHANGE [END]
 
   //
   // For non-blocking requests, return directly if the command is placed
@@ -853,6 +976,7 @@ NvmExpressPassThru (
 
     AsyncRequest->Signature     = NVME_PASS_THRU_ASYNC_REQ_SIG;
     AsyncRequest->Packet        = Packet;
+    AsyncRequest->QueueId       = QueueId;    // MU_CHANGE
     AsyncRequest->CommandId     = Sq->Cid;
     AsyncRequest->CallerEvent   = Event;
     AsyncRequest->MapData       = MapData;
@@ -863,6 +987,7 @@ NvmExpressPassThru (
 
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
     InsertTailList (&Private->AsyncPassThruQueue, &AsyncRequest->Link);
+    NvmeUpdateAsyncTimer (Private);     // MU_CHANGE
     gBS->RestoreTPL (OldTpl);
 
     return EFI_SUCCESS;
@@ -926,36 +1051,7 @@ NvmExpressPassThru (
     //
     DEBUG ((DEBUG_ERROR, "NvmExpressPassThru: Timeout occurs for an NVMe command.\n"));
 
-    //
-    // Disable the timer to trigger the process of async transfers temporarily.
-    //
-    Status = gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
-    if (EFI_ERROR (Status)) {
-      goto EXIT;
-    }
-
-    //
-    // Reset the NVMe controller.
-    //
-    Status = NvmeControllerInit (Private);
-    if (!EFI_ERROR (Status)) {
-      Status = AbortAsyncPassThruTasks (Private);
-      if (!EFI_ERROR (Status)) {
-        //
-        // Re-enable the timer to trigger the process of async transfers.
-        //
-        Status = gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
-        if (!EFI_ERROR (Status)) {
-          //
-          // Return EFI_TIMEOUT to indicate a timeout occurs for NVMe PassThru command.
-          //
-          Status = EFI_TIMEOUT;
-        }
-      }
-    } else {
-      Status = EFI_DEVICE_ERROR;
-    }
-
+    Status = NvmeResetAfterTimeout (Private);   // MU_CHANGE
     goto EXIT;
   }
 
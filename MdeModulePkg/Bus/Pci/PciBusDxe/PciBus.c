@@ -38,6 +38,7 @@ EFI_PCI_PLATFORM_PROTOCOL                     *gPciPlatformProtocol;
 EFI_PCI_OVERRIDE_PROTOCOL                     *gPciOverrideProtocol;
 EDKII_IOMMU_PROTOCOL                          *mIoMmuProtocol;
 EDKII_DEVICE_SECURITY_PROTOCOL                *mDeviceSecurityProtocol;
+EDKII_MEMORY_PROXIMITY_PROTOCOL               *mMemoryProximityProtocol;   // MU_CHANGE
 
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_PCI_HOTPLUG_REQUEST_PROTOCOL mPciHotPlugRequest = {
   PciHotPlugRequestNotify
@@ -301,6 +302,16 @@ PciBusDriverBindingStart (
           );
   }
 
+  // MU_CHANGE [BEGIN] - Allocate DMA buffers close to the root bridge
+  if (mMemoryProximityProtocol == NULL) {
+    gBS->LocateProtocol (
+          &gEdkiiMemoryProximityProtocolGuid,
+          NULL,
+          (VOID **) &mMemoryProximityProtocol
+          );
+  }
+  // MU_CHANGE [END]
+
   if (PcdGetBool (PcdPciDisableBusEnumeration)) {
     gFullEnumeration = FALSE;
   } else {
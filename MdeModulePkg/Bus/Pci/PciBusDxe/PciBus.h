@@ -30,6 +30,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/PciEnumerationComplete.h>
 #include <Protocol/IoMmu.h>
 #include <Protocol/DeviceSecurity.h>
+#include <Protocol/MemoryProximity.h>  // MU_CHANGE
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -41,6 +42,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>  // MU_CHANGE
 
 #include <IndustryStandard/Pci.h>
 #include <IndustryStandard/PeImage.h>
@@ -57,7 +57,9 @@ PciEnumerator (
   //
   // Start the bus allocation phase
   //
+  PERF_INMODULE_BEGIN ("PciHostBridgeEnumerator");  // MU_CHANGE
   Status = PciHostBridgeEnumerator (PciResAlloc);
+  PERF_INMODULE_END ("PciHostBridgeEnumerator");    // MU_CHANGE
 
   if (EFI_ERROR (Status)) {
     return Status;
@@ -66,7 +68,9 @@ PciEnumerator (
   //
   // Submit the resource request
   //
+  PERF_INMODULE_BEGIN ("PciHostBridgeResourceAllocator");  // MU_CHANGE
   Status = PciHostBridgeResourceAllocator (PciResAlloc);
+  PERF_INMODULE_END ("PciHostBridgeResourceAllocator");    // MU_CHANGE
 
   if (EFI_ERROR (Status)) {
     return Status;
@@ -107,6 +107,12 @@ PciPciDeviceInfoCollector (
   SecBus  = 0;
 
   for (Device = 0; Device <= PCI_MAX_DEVICE; Device++) {
+    //
+    // Below a PCI Express port only device 0 can respond
+    //
+    if (Device == 1 && PciBusHasOnlyDevice0 (Bridge)) {
+      break;
+    }
 
     for (Func = 0; Func <= PCI_MAX_FUNC; Func++) {
 
@@ -471,6 +477,7 @@ GatherDeviceInfo (
   UINTN                           Offset;
   UINTN                           BarIndex;
   PCI_IO_DEVICE                   *PciIoDevice;
+  PCI_BAR_PROBE                   Probe;
 
   PciIoDevice = CreatePciIoDevice (
                   Bridge,
@@ -494,10 +501,11 @@ GatherDeviceInfo (
   }
 
   //
-  // Start to parse the bars
+  // Start to parse the bars, all of them are sized at once
   //
+  PciProbeBars (PciIoDevice, &Probe);
   for (Offset = 0x10, BarIndex = 0; Offset <= 0x24 && BarIndex < PCI_MAX_BAR; BarIndex++) {
-    Offset = PciParseBar (PciIoDevice, Offset, BarIndex);
+    Offset = PciParseProbedBar (PciIoDevice, Offset, BarIndex, &Probe);
   }
 
   //
@@ -911,6 +919,96 @@ BarExisted (
   }
 }
 
+/**
+  Size the six BARs of a device at once.
+
+  The BARs are read, written with all ones, read back and restored with one
+  configuration access each, instead of four accesses for each BAR.
+
+  @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
+  @param Probe             Returns the values read back and the original values.
+
+**/
+VOID
+PciProbeBars (
+  IN  PCI_IO_DEVICE *PciIoDevice,
+  OUT PCI_BAR_PROBE *Probe
+  )
+{
+  EFI_PCI_IO_PROTOCOL *PciIo;
+  UINT32              AllOnes[PCI_MAX_BAR];
+  EFI_TPL             OldTpl;
+
+  PciIo = &PciIoDevice->PciIo;
+  SetMem32 (AllOnes, sizeof (AllOnes), MAX_UINT32);
+
+  //
+  // Preserve the original values
+  //
+  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, PCI_MAX_BAR, Probe->OriginalValue);
+
+  //
+  // Raise TPL to high level to disable timer interrupt while the BARs are probed
+  //
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, PCI_MAX_BAR, AllOnes);
+  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, PCI_MAX_BAR, Probe->Value);
+
+  //
+  // Write back the original values
+  //
+  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint32, PCI_BASE_ADDRESSREG_OFFSET, PCI_MAX_BAR, Probe->OriginalValue);
+
+  //
+  // Restore TPL to its original level
+  //
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Check whether the bar is existed or not, from the values of PciProbeBars()
+  when the bar is one of the six BARs of the device.
+
+  @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
+  @param Offset            The offset.
+  @param Probe             The values returned by PciProbeBars(), or NULL.
+  @param BarLengthValue    The bar length value returned.
+  @param OriginalBarValue  The original bar value returned.
+
+  @retval EFI_NOT_FOUND    The bar doesn't exist.
+  @retval EFI_SUCCESS      The bar exist.
+
+**/
+STATIC
+EFI_STATUS
+ProbedBarExisted (
+  IN  PCI_IO_DEVICE       *PciIoDevice,
+  IN  UINTN               Offset,
+  IN  CONST PCI_BAR_PROBE *Probe OPTIONAL,
+  OUT UINT32              *BarLengthValue,
+  OUT UINT32              *OriginalBarValue
+  )
+{
+  UINTN  Index;
+
+  if (Probe == NULL ||
+      Offset < PCI_BASE_ADDRESSREG_OFFSET ||
+      Offset >= PCI_BASE_ADDRESSREG_OFFSET + PCI_MAX_BAR * sizeof (UINT32)) {
+    return BarExisted (PciIoDevice, Offset, BarLengthValue, OriginalBarValue);
+  }
+
+  Index             = (Offset - PCI_BASE_ADDRESSREG_OFFSET) / sizeof (UINT32);
+  *BarLengthValue   = Probe->Value[Index];
+  *OriginalBarValue = Probe->OriginalValue[Index];
+
+  if (*BarLengthValue == 0) {
+    return EFI_NOT_FOUND;
+  } else {
+    return EFI_SUCCESS;
+  }
+}
+
 /**
   Test whether the device can support given attributes.
 
@@ -1796,6 +1894,30 @@ PciParseBar (
   IN UINTN          Offset,
   IN UINTN          BarIndex
   )
+{
+  return PciParseProbedBar (PciIoDevice, Offset, BarIndex, NULL);
+}
+
+/**
+  Parse PCI bar information and fill them into PCI device instance, using the
+  values of PciProbeBars() for the six BARs of the device.
+
+  @param PciIoDevice  Pci device instance.
+  @param Offset       Bar offset.
+  @param BarIndex     Bar index.
+  @param Probe        The values returned by PciProbeBars(), or NULL to size
+                      the bar now.
+
+  @return Next bar offset.
+
+**/
+UINTN
+PciParseProbedBar (
+  IN PCI_IO_DEVICE        *PciIoDevice,
+  IN UINTN                Offset,
+  IN UINTN                BarIndex,
+  IN CONST PCI_BAR_PROBE  *Probe OPTIONAL
+  )
 {
   UINT32      Value;
   UINT32      OriginalValue;
@@ -1805,9 +1927,10 @@ PciParseBar (
   OriginalValue = 0;
   Value         = 0;
 
-  Status = BarExisted (
+  Status = ProbedBarExisted (
              PciIoDevice,
              Offset,
+             Probe,
              &Value,
              &OriginalValue
              );
@@ -1913,9 +2036,10 @@ PciParseBar (
       //
       Offset += 4;
 
-      Status = BarExisted (
+      Status = ProbedBarExisted (
                  PciIoDevice,
                  Offset,
+                 Probe,
                  &Value,
                  &OriginalValue
                  );
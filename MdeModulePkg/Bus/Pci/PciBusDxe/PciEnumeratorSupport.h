@@ -192,6 +192,27 @@ BarExisted (
   OUT UINT32        *OriginalBarValue
   );
 
+///
+/// The six BARs of a device, sized at once by PciProbeBars().
+///
+typedef struct {
+  UINT32  Value[PCI_MAX_BAR];           ///< The values read back after writing all ones
+  UINT32  OriginalValue[PCI_MAX_BAR];
+} PCI_BAR_PROBE;
+
+/**
+  Size the six BARs of a device at once.
+
+  @param PciIoDevice       A pointer to the PCI_IO_DEVICE.
+  @param Probe             Returns the values read back and the original values.
+
+**/
+VOID
+PciProbeBars (
+  IN  PCI_IO_DEVICE *PciIoDevice,
+  OUT PCI_BAR_PROBE *Probe
+  );
+
 /**
   Test whether the device can support given attributes.
 
@@ -302,6 +323,27 @@ PciParseBar (
   IN UINTN          BarIndex
   );
 
+/**
+  Parse PCI bar information and fill them into PCI device instance, using the
+  values of PciProbeBars() for the six BARs of the device.
+
+  @param PciIoDevice  Pci device instance.
+  @param Offset       Bar offset.
+  @param BarIndex     Bar index.
+  @param Probe        The values returned by PciProbeBars(), or NULL to size
+                      the bar now.
+
+  @return Next bar offset.
+
+**/
+UINTN
+PciParseProbedBar (
+  IN PCI_IO_DEVICE        *PciIoDevice,
+  IN UINTN                Offset,
+  IN UINTN                BarIndex,
+  IN CONST PCI_BAR_PROBE  *Probe OPTIONAL
+  );
+
 /**
   Parse PCI IOV VF bar information and fill them into PCI device instance.
 
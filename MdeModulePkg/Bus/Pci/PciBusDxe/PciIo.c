@@ -9,6 +9,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "PciBus.h"
 
 extern EDKII_IOMMU_PROTOCOL                          *mIoMmuProtocol;
+extern EDKII_MEMORY_PROXIMITY_PROTOCOL               *mMemoryProximityProtocol;   // MU_CHANGE
 
 //
 // Pci Io Protocol Interface
@@ -1126,6 +1127,9 @@ PciIoAllocateBuffer (
 {
   EFI_STATUS    Status;
   PCI_IO_DEVICE *PciIoDevice;
+  UINT32        ProximityDomain;  // MU_CHANGE
+  UINT32        PreviousDomain;   // MU_CHANGE
+  BOOLEAN       HintSet;          // MU_CHANGE
 
   if ((Attributes &
       (~(EFI_PCI_ATTRIBUTE_MEMORY_WRITE_COMBINE | EFI_PCI_ATTRIBUTE_MEMORY_CACHED))) != 0){
@@ -1138,6 +1142,30 @@ PciIoAllocateBuffer (
     Attributes |= EFI_PCI_ATTRIBUTE_DUAL_ADDRESS_CYCLE;
   }
 
+  // MU_CHANGE [BEGIN] - Allocate DMA buffers close to the root bridge
+  //
+  // Let the DXE core prefer memory of the device's proximity domain for the
+  // pages the root bridge allocates.
+  //
+  HintSet = FALSE;
+  if (mMemoryProximityProtocol != NULL) {
+    Status = mMemoryProximityProtocol->GetPciProximityDomain (
+                                         mMemoryProximityProtocol,
+                                         PciIoDevice->PciRootBridgeIo->SegmentNumber,
+                                         PciIoDevice->BusNumber,
+                                         &ProximityDomain
+                                         );
+    if (!EFI_ERROR (Status)) {
+      Status = mMemoryProximityProtocol->SetAllocationHint (
+                                           mMemoryProximityProtocol,
+                                           ProximityDomain,
+                                           &PreviousDomain
+                                           );
+      HintSet = !EFI_ERROR (Status);
+    }
+  }
+  // MU_CHANGE [END]
+
   Status = PciIoDevice->PciRootBridgeIo->AllocateBuffer (
                                           PciIoDevice->PciRootBridgeIo,
                                           Type,
@@ -1147,6 +1175,12 @@ PciIoAllocateBuffer (
                                           Attributes
                                           );
 
+  // MU_CHANGE [BEGIN] - Allocate DMA buffers close to the root bridge
+  if (HintSet) {
+    mMemoryProximityProtocol->SetAllocationHint (mMemoryProximityProtocol, PreviousDomain, NULL);
+  }
+  // MU_CHANGE [END]
+
   if (EFI_ERROR (Status)) {
     REPORT_STATUS_CODE_WITH_DEVICE_PATH (
       EFI_ERROR_CODE | EFI_ERROR_MINOR,
@@ -963,6 +963,65 @@ PciAllocateBusNumber (
   return EFI_OUT_OF_RESOURCES;
 }
 
+/**
+  Check whether device 0 is the only device that can be on the secondary bus
+  of a bridge.
+
+  The link below a PCI Express Root Port or Downstream Port leads to a single
+  device, so the configuration reads of devices 1 - 31 on its secondary bus
+  only return Unsupported Request. When ARI Forwarding is enabled in the port
+  these device numbers select functions 8 - 255 of device 0, and still have
+  to be scanned.
+
+  @param  Bridge           Bridge device instance.
+
+  @retval TRUE             Only device 0 can be on the secondary bus.
+  @retval FALSE            Devices 1 - 31 have to be scanned too.
+
+**/
+BOOLEAN
+PciBusHasOnlyDevice0 (
+  IN PCI_IO_DEVICE                      *Bridge
+  )
+{
+  EFI_STATUS                            Status;
+  PCI_REG_PCIE_CAPABILITY               Capability;
+  UINT16                                DeviceControl2;
+
+  if (Bridge->Parent == NULL || !Bridge->IsPciExp) {
+    return FALSE;
+  }
+
+  Status = Bridge->PciIo.Pci.Read (
+                               &Bridge->PciIo,
+                               EfiPciIoWidthUint16,
+                               Bridge->PciExpressCapabilityOffset + OFFSET_OF (PCI_CAPABILITY_PCIEXP, Capability),
+                               1,
+                               &Capability
+                               );
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  if (Capability.Bits.DevicePortType != PCIE_DEVICE_PORT_TYPE_ROOT_PORT &&
+      Capability.Bits.DevicePortType != PCIE_DEVICE_PORT_TYPE_DOWNSTREAM_PORT) {
+    return FALSE;
+  }
+
+  Status = Bridge->PciIo.Pci.Read (
+                               &Bridge->PciIo,
+                               EfiPciIoWidthUint16,
+                               Bridge->PciExpressCapabilityOffset + EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_OFFSET,
+                               1,
+                               &DeviceControl2
+                               );
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN) ((DeviceControl2 & EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_ARI_FORWARDING) == 0);
+}
+
 /**
   Scan pci bus and assign bus number to the given PCI bus system.
 
@@ -1018,6 +1077,14 @@ PciScanBus (
   PciAddress      = 0;
 
   for (Device = 0; Device <= PCI_MAX_DEVICE; Device++) {
+    //
+    // Below a PCI Express port only device 0 can respond. This is checked
+    // after device 0 has been scanned, which may have enabled ARI Forwarding.
+    //
+    if (Device == 1 && PciBusHasOnlyDevice0 (Bridge)) {
+      break;
+    }
+
     TempReservedBusNum = 0;
     for (Func = 0; Func <= PCI_MAX_FUNC; Func++) {
 
@@ -89,6 +89,21 @@ PciAllocateBusNumber (
   OUT UINT8                             *NextBusNumber
   );
 
+/**
+  Check whether device 0 is the only device that can be on the secondary bus
+  of a bridge.
+
+  @param  Bridge           Bridge device instance.
+
+  @retval TRUE             Only device 0 can be on the secondary bus.
+  @retval FALSE            Devices 1 - 31 have to be scanned too.
+
+**/
+BOOLEAN
+PciBusHasOnlyDevice0 (
+  IN PCI_IO_DEVICE                      *Bridge
+  );
+
 /**
   Scan pci bus and assign bus number to the given PCI bus system.
 
@@ -391,6 +391,7 @@ LoadOpRomImage (
   UINT32                    LegacyImageLength;
   UINT8                     *RomInMemory;
   UINT8                     CodeType;
+  BOOLEAN                   HasEfiImage;
 
   RomSize       = PciDevice->RomSize;
 
@@ -398,6 +399,7 @@ LoadOpRomImage (
   RomImageSize  = 0;
   RomInMemory   = NULL;
   CodeType      = 0xFF;
+  HasEfiImage   = FALSE;
 
   //
   // Get the RomBarIndex
@@ -443,12 +445,18 @@ LoadOpRomImage (
   FirstCheck    = TRUE;
   LegacyImageLength = 0;
 
+  //
+  // Each read of the ROM BAR is a non-posted request to the device, so the
+  // ROM is read in the widest units its layout allows: images start on 512
+  // byte boundaries, the PCI Data Structure is DWORD aligned and a multiple
+  // of DWORDs long, and the header is a multiple of WORDs long.
+  //
   do {
     PciDevice->PciRootBridgeIo->Mem.Read (
                                       PciDevice->PciRootBridgeIo,
-                                      EfiPciWidthUint8,
+                                      EfiPciWidthUint16,
                                       RomBarOffset,
-                                      sizeof (PCI_EXPANSION_ROM_HEADER),
+                                      sizeof (PCI_EXPANSION_ROM_HEADER) / sizeof (UINT16),
                                       (UINT8 *) RomHeader
                                       );
 
@@ -475,9 +483,9 @@ LoadOpRomImage (
     }
     PciDevice->PciRootBridgeIo->Mem.Read (
                                       PciDevice->PciRootBridgeIo,
-                                      EfiPciWidthUint8,
+                                      EfiPciWidthUint32,
                                       RomBarOffset + OffsetPcir,
-                                      sizeof (PCI_DATA_STRUCTURE),
+                                      sizeof (PCI_DATA_STRUCTURE) / sizeof (UINT32),
                                       (UINT8 *) RomPcir
                                       );
     //
@@ -493,6 +501,9 @@ LoadOpRomImage (
       CodeType = PCI_CODE_TYPE_PCAT_IMAGE;
       LegacyImageLength = ((UINT32)((EFI_LEGACY_EXPANSION_ROM_HEADER *)RomHeader)->Size512) * 512;
     }
+    if (RomPcir->CodeType == PCI_CODE_TYPE_EFI_IMAGE) {
+      HasEfiImage = TRUE;
+    }
     Indicator     = RomPcir->Indicator;
     RomImageSize  = RomImageSize + RomPcir->ImageLength * 512;
     RomBarOffset  = RomBarOffset + RomPcir->ImageLength * 512;
@@ -506,6 +517,14 @@ LoadOpRomImage (
     RomImageSize = MAX (RomImageSize, LegacyImageLength);
   }
 
+  //
+  // Only EFI images are dispatched from the copy in memory, so a ROM without
+  // one is left on the device when the platform does not need it.
+  //
+  if (FeaturePcdGet (PcdPciLoadOnlyEfiOptionRom) && !HasEfiImage) {
+    RomImageSize = 0;
+  }
+
   if (RomImageSize > 0) {
     RetStatus = EFI_SUCCESS;
     Image     = AllocatePool ((UINT32) RomImageSize);
@@ -517,13 +536,13 @@ LoadOpRomImage (
     }
 
     //
-    // Copy Rom image into memory
+    // Copy Rom image into memory, RomImageSize is a multiple of 512 bytes
     //
     PciDevice->PciRootBridgeIo->Mem.Read (
                                       PciDevice->PciRootBridgeIo,
-                                      EfiPciWidthUint8,
+                                      EfiPciWidthUint32,
                                       RomBar,
-                                      (UINT32) RomImageSize,
+                                      (UINT32) RomImageSize / sizeof (UINT32),
                                       Image
                                       );
     RomInMemory = Image;
@@ -83,47 +83,97 @@ SkipIsaAliasAperture (
 }
 
 /**
-  This function inserts a resource node into the resource list.
-  The resource list is sorted in descend order.
+  Insert a resource node into the resource list of a bridge, starting the
+  search for its position at StartLink.
 
-  @param Bridge  PCI resource node for bridge.
-  @param ResNode Resource node want to be inserted.
+  The list is kept in descending order of alignment, so every node before
+  StartLink must have a larger alignment than ResNode. The node is inserted
+  before the first node it would have been swapped with by a walk from the
+  head of the list, and a node with an alignment below that of the last node
+  is appended directly.
+
+  @param Bridge     PCI resource node for bridge.
+  @param ResNode    Resource node want to be inserted.
+  @param StartLink  The link to start the search from.
+
+  @return The link of the first node whose alignment isn't larger than the
+          alignment of ResNode, which can be used as StartLink for a node
+          with the same or a smaller alignment.
 
 **/
-VOID
-InsertResourceNode (
+STATIC
+LIST_ENTRY *
+InsertResourceNodeFrom (
   IN OUT PCI_RESOURCE_NODE   *Bridge,
-  IN     PCI_RESOURCE_NODE   *ResNode
+  IN     PCI_RESOURCE_NODE   *ResNode,
+  IN     LIST_ENTRY          *StartLink
   )
 {
   LIST_ENTRY        *CurrentLink;
+  LIST_ENTRY        *BucketLink;
   PCI_RESOURCE_NODE *Temp;
   UINT64            ResNodeAlignRest;
   UINT64            TempAlignRest;
 
-  ASSERT (Bridge  != NULL);
-  ASSERT (ResNode != NULL);
+  BucketLink  = NULL;
+  CurrentLink = StartLink;
 
-  InsertHeadList (&Bridge->ChildList, &ResNode->Link);
+  if (!IsListEmpty (&Bridge->ChildList) &&
+      ResNode->Alignment < RESOURCE_NODE_FROM_LINK (Bridge->ChildList.BackLink)->Alignment) {
+    CurrentLink = &Bridge->ChildList;
+  }
 
-  CurrentLink = Bridge->ChildList.ForwardLink->ForwardLink;
+  ResNodeAlignRest = ResNode->Length & ResNode->Alignment;
   while (CurrentLink != &Bridge->ChildList) {
     Temp = RESOURCE_NODE_FROM_LINK (CurrentLink);
 
+    if ((BucketLink == NULL) && (Temp->Alignment <= ResNode->Alignment)) {
+      BucketLink = CurrentLink;
+    }
+
     if (ResNode->Alignment > Temp->Alignment) {
       break;
     } else if (ResNode->Alignment == Temp->Alignment) {
-      ResNodeAlignRest  = ResNode->Length & ResNode->Alignment;
-      TempAlignRest     = Temp->Length & Temp->Alignment;
+      TempAlignRest = Temp->Length & Temp->Alignment;
       if ((ResNodeAlignRest == 0) || (ResNodeAlignRest >= TempAlignRest)) {
         break;
       }
     }
 
-    SwapListEntries (&ResNode->Link, CurrentLink);
+    CurrentLink = CurrentLink->ForwardLink;
+  }
+
+  //
+  // Inserting at the tail of the list headed by CurrentLink places ResNode
+  // right before CurrentLink.
+  //
+  InsertTailList (CurrentLink, &ResNode->Link);
 
-    CurrentLink = ResNode->Link.ForwardLink;
+  if ((BucketLink == NULL) || (BucketLink == CurrentLink)) {
+    BucketLink = &ResNode->Link;
   }
+
+  return BucketLink;
+}
+
+/**
+  This function inserts a resource node into the resource list.
+  The resource list is sorted in descend order.
+
+  @param Bridge  PCI resource node for bridge.
+  @param ResNode Resource node want to be inserted.
+
+**/
+VOID
+InsertResourceNode (
+  IN OUT PCI_RESOURCE_NODE   *Bridge,
+  IN     PCI_RESOURCE_NODE   *ResNode
+  )
+{
+  ASSERT (Bridge  != NULL);
+  ASSERT (ResNode != NULL);
+
+  InsertResourceNodeFrom (Bridge, ResNode, Bridge->ChildList.ForwardLink);
 }
 
 /**
@@ -153,11 +203,18 @@ MergeResourceTree (
 {
 
   LIST_ENTRY        *CurrentLink;
+  LIST_ENTRY        *StartLink;
   PCI_RESOURCE_NODE *Temp;
 
   ASSERT (Dst != NULL);
   ASSERT (Res != NULL);
 
+  //
+  // The nodes of Res come in descending order of alignment, so the search
+  // for the position of each node resumes where the alignment bucket of the
+  // previous node starts in Dst instead of at the head of the list.
+  //
+  StartLink = Dst->ChildList.ForwardLink;
   while (!IsListEmpty (&Res->ChildList)) {
     CurrentLink = Res->ChildList.ForwardLink;
 
@@ -168,7 +225,7 @@ MergeResourceTree (
     }
 
     RemoveEntryList (CurrentLink);
-    InsertResourceNode (Dst, Temp);
+    StartLink = InsertResourceNodeFrom (Dst, Temp, StartLink);
   }
 }
 
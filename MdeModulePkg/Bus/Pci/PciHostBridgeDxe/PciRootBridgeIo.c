@@ -1153,6 +1153,22 @@ RootBridgeIoPciAccess (
   InStride  = mInStride[Width];
   OutStride = mOutStride[Width];
   Size      = (UINTN) (1 << (Width & 0x03));
+
+  //
+  // A run of DWORD or QWORD registers is handed to PciSegmentLib in one call,
+  // which still accesses every DWORD with a 32-bit access. The range was
+  // checked to be within the configuration space of one function. Byte and
+  // word accesses stay one by one, so their width is kept.
+  //
+  if (Width >= EfiPciWidthUint32 && Width <= EfiPciWidthUint64) {
+    if (Read) {
+      PciSegmentReadBuffer (Address, Size * Count, Buffer);
+    } else {
+      PciSegmentWriteBuffer (Address, Size * Count, Buffer);
+    }
+    return EFI_SUCCESS;
+  }
+
   for (Uint8Buffer = Buffer; Count > 0; Address += InStride, Uint8Buffer += OutStride, Count--) {
     if (Read) {
       PciSegmentReadBuffer (Address, Size, Uint8Buffer);
@@ -139,6 +139,71 @@ InitializeSdMmcPciHcDxe (
   return Status;
 }
 
+/**
+  Complete the ADMA3 transfer executing the TRBs at the head of the async
+  queue.
+
+  On success every TRB of the transfer is completed. On failure the host
+  controller has been recovered and the TRBs are left in the queue to be
+  executed one by one, so errors are reported and retried per command.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The first TRB of the ADMA3 transfer.
+  @param[in] Status         The result of the ADMA3 transfer.
+
+**/
+VOID
+SdMmcCompleteAdma3 (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN SD_MMC_HC_TRB                    *Trb,
+  IN EFI_STATUS                       Status
+  )
+{
+  LIST_ENTRY                          *Link;
+  LIST_ENTRY                          *NextLink;
+  UINT32                              Index;
+  UINT32                              Response[4];
+  EFI_EVENT                           TrbEvent;
+
+  SdMmcStopAdma3 (Private, Trb->Slot);
+
+  Link = &Trb->TrbList;
+  for (Index = 0; Index < Private->Adma3TrbCount; Index++) {
+    NextLink = GetNextNode (&Private->Queue, Link);
+    Trb      = SD_MMC_HC_TRB_FROM_THIS (Link);
+    if (EFI_ERROR (Status)) {
+      Trb->NoAdma3 = TRUE;
+      Trb->Started = FALSE;
+      Trb->Timeout = Trb->Packet->Timeout;
+    } else {
+      //
+      // The response of Auto CMD23 is stored in the upper dword of the
+      // Response register, and the one of the data command in the lower.
+      //
+      ZeroMem (Response, sizeof (Response));
+      SdMmcHcRwMmio (
+        Private->PciIo,
+        Trb->Slot,
+        ((Index % 2) == 0) ? SD_MMC_HC_RESPONSE + 3 * sizeof (UINT32) : SD_MMC_HC_RESPONSE,
+        TRUE,
+        sizeof (UINT32),
+        &Response[0]
+        );
+      CopyMem (Trb->Packet->SdMmcStatusBlk, Response, sizeof (Response));
+
+      RemoveEntryList (Link);
+      Trb->Packet->TransactionStatus = EFI_SUCCESS;
+      TrbEvent = Trb->Event;
+      SdMmcFreeTrb (Trb);
+      DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p with %r\n", TrbEvent, EFI_SUCCESS));
+      gBS->SignalEvent (TrbEvent);
+    }
+    Link = NextLink;
+  }
+
+  Private->Adma3TrbCount = 0;
+}
+
 /**
   Call back function when the timer event is signaled.
 
@@ -161,6 +226,9 @@ ProcessAsyncTaskList (
   EFI_SD_MMC_PASS_THRU_COMMAND_PACKET *Packet;
   BOOLEAN                             InfiniteWait;
   EFI_EVENT                           TrbEvent;
+  UINT32                              Count;
+  UINT32                              Index;
+  SD_MMC_HC_TRB                       *ChainTrb;
 
   Private = (SD_MMC_HC_PRIVATE_DATA*)Context;
 
@@ -174,14 +242,51 @@ ProcessAsyncTaskList (
     Trb = SD_MMC_HC_TRB_FROM_THIS (Link);
     if (!Private->Slot[Trb->Slot].MediaPresent) {
       Status = EFI_NO_MEDIA;
+      if (Private->Adma3TrbCount != 0) {
+        SdMmcCompleteAdma3 (Private, Trb, Status);
+      }
       goto Done;
     }
+    if (Private->Adma3TrbCount != 0) {
+      Status = SdMmcCheckAdma3Result (Private, Trb);
+      if ((Status == EFI_NOT_READY) && (Trb->Packet->Timeout != 0) && (Trb->Timeout-- == 0)) {
+        DEBUG ((DEBUG_ERROR, "ADMA3 transfer timeout\n"));
+        SdMmcSoftwareReset (Private, Trb->Slot, BIT0 | BIT4);
+        Status = EFI_TIMEOUT;
+      }
+      if (Status != EFI_NOT_READY) {
+        SdMmcCompleteAdma3 (Private, Trb, Status);
+      }
+      return;
+    }
     if (!Trb->Started) {
       //
       // Check whether the cmd/data line is ready for transfer.
       //
       Status = SdMmcCheckTrbEnv (Private, Trb);
       if (!EFI_ERROR (Status)) {
+        //
+        // Execute the queued eMMC block transfers by one ADMA3 transfer
+        // when the host controller supports it.
+        //
+        Count = SdMmcGetAdma3Chain (Private, Trb);
+        if (Count != 0) {
+          Status = SdMmcExecAdma3 (Private, Trb, Count);
+          if (Status == EFI_NOT_READY) {
+            goto Done;
+          }
+        }
+        if ((Count != 0) && !EFI_ERROR (Status)) {
+          Private->Adma3TrbCount = Count;
+          for (Index = 0; Index < Count; Index++, Link = GetNextNode (&Private->Queue, Link)) {
+            ChainTrb          = SD_MMC_HC_TRB_FROM_THIS (Link);
+            ChainTrb->Started = TRUE;
+            if (ChainTrb != Trb) {
+              Trb->Timeout += ChainTrb->Timeout;
+            }
+          }
+          return;
+        }
         Trb->Started = TRUE;
         Status = SdMmcExecTrb (Private, Trb);
         if (EFI_ERROR (Status)) {
@@ -937,6 +1042,7 @@ SdMmcPciHcDriverBindingStop (
     gBS->SignalEvent (Trb->Event);
     SdMmcFreeTrb (Trb);
   }
+  SdMmcFreeAdma3Table (Private);
 
   //
   // Uninstall Block I/O protocol from the device handle
@@ -1415,6 +1521,7 @@ SdMmcPassThruResetDevice (
     gBS->SignalEvent (Trb->Event);
     SdMmcFreeTrb (Trb);
   }
+  SdMmcFreeAdma3Table (Private);
 
   gBS->RestoreTPL (OldTpl);
 
@@ -120,6 +120,15 @@ typedef struct {
   // value stored in Capabilities Register 1.
   //
   UINT32                              BaseClkFreq[SD_MMC_HC_MAX_SLOT];
+
+  //
+  // ADMA3 descriptor table, and the number of TRBs at the head of Queue
+  // being executed by one ADMA3 transfer through it.
+  //
+  SD_MMC_HC_ADMA3_TABLE               *Adma3Table;
+  EFI_PHYSICAL_ADDRESS                Adma3TablePhy;
+  VOID                                *Adma3TableMap;
+  UINT32                              Adma3TrbCount;
 } SD_MMC_HC_PRIVATE_DATA;
 
 typedef struct {
@@ -161,6 +170,12 @@ typedef struct {
   BOOLEAN                             PioModeTransferCompleted;
   UINT32                              PioBlockIndex;
 
+  //
+  // Set when an ADMA3 transfer including the TRB failed, so the TRB is
+  // executed by itself afterwards.
+  //
+  BOOLEAN                             NoAdma3;
+
   SD_MMC_HC_ADMA_32_DESC_LINE         *Adma32Desc;
   SD_MMC_HC_ADMA_64_V3_DESC_LINE      *Adma64V3Desc;
   SD_MMC_HC_ADMA_64_V4_DESC_LINE      *Adma64V4Desc;
@@ -768,6 +783,102 @@ SdMmcWaitTrbResult (
   IN SD_MMC_HC_TRB                    *Trb
   );
 
+/**
+  Performs SW reset based on passed error status mask.
+
+  @param[in]  Private       Pointer to driver private data.
+  @param[in]  Slot          Index of the slot to reset.
+  @param[in]  ErrIntStatus  Error interrupt status mask.
+
+  @retval EFI_SUCCESS  Software reset performed successfully.
+  @retval Other        Software reset failed.
+**/
+EFI_STATUS
+SdMmcSoftwareReset (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN UINT16                  ErrIntStatus
+  );
+
+/**
+  Check if the TRB at the head of a run of queued TRBs can be executed by
+  ADMA3 together with the ones following it, and count them.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the first SD_MMC_HC_TRB instance of the run.
+
+  @return The number of TRBs, starting from Trb, that can be executed by ADMA3.
+          0 means Trb has to be executed by itself.
+
+**/
+UINT32
+SdMmcGetAdma3Chain (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN SD_MMC_HC_TRB                    *Trb
+  );
+
+/**
+  Free the ADMA3 descriptor table of the host controller.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+
+**/
+VOID
+SdMmcFreeAdma3Table (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private
+  );
+
+/**
+  Execute a run of queued TRBs by one ADMA3 transfer.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the first SD_MMC_HC_TRB instance of the run.
+  @param[in] Count          The number of TRBs returned by SdMmcGetAdma3Chain().
+
+  @retval EFI_SUCCESS       The ADMA3 transfer is started.
+  @retval EFI_NOT_READY     The cmd/data line isn't ready for the transfer.
+  @retval Others            The ADMA3 transfer isn't started, the TRBs have
+                            to be executed one by one.
+
+**/
+EFI_STATUS
+SdMmcExecAdma3 (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN SD_MMC_HC_TRB                    *Trb,
+  IN UINT32                           Count
+  );
+
+/**
+  Switch the DMA Select field of the slot back from ADMA3 after an ADMA3
+  transfer.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot of the ADMA3 transfer.
+
+**/
+VOID
+SdMmcStopAdma3 (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN UINT8                            Slot
+  );
+
+/**
+  Check the result of the ADMA3 transfer started by SdMmcExecAdma3().
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the first SD_MMC_HC_TRB instance of the run.
+
+  @retval EFI_SUCCESS       All the commands of the ADMA3 transfer are executed successfully.
+  @retval EFI_NOT_READY     The ADMA3 transfer is not completed.
+  @retval Others            Some erros happen when executing the ADMA3 transfer.
+
+**/
+EFI_STATUS
+SdMmcCheckAdma3Result (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN SD_MMC_HC_TRB                    *Trb
+  );
+
 /**
   Execute EMMC device identification procedure.
 
@@ -70,6 +70,7 @@ DumpCapabilityReg (
   DEBUG ((DEBUG_INFO, "   SDR50 Tuning      %a\n", Capability->TuningSDR50 ? "TRUE" : "FALSE"));
   DEBUG ((DEBUG_INFO, "   Retuning Mode     Mode %d\n", Capability->RetuningMod + 1));
   DEBUG ((DEBUG_INFO, "   Clock Multiplier  M = %d\n", Capability->ClkMultiplier + 1));
+  DEBUG ((DEBUG_INFO, "   ADMA3 Support     %a\n", Capability->Adma3 ? "TRUE" : "FALSE"));
   DEBUG ((DEBUG_INFO, "   HS 400            %a\n", Capability->Hs400 ? "TRUE" : "FALSE"));
   return;
 }
@@ -2836,3 +2837,395 @@ SdMmcWaitTrbResult (
   return EFI_TIMEOUT;
 }
 
+/**
+  Check if the TRB at the head of a run of queued TRBs can be executed by
+  ADMA3 together with the ones following it, and count them.
+
+  Only eMMC CMD23 SET_BLOCK_COUNT + CMD18/CMD25 pairs using 64b V4 ADMA2 are
+  chained. Each pair becomes one ADMA3 command descriptor issuing the data
+  command with Auto CMD23, so its block count has to match the CMD23
+  argument exactly.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the first SD_MMC_HC_TRB instance of the run.
+
+  @return The number of TRBs, starting from Trb, that can be executed by ADMA3.
+          0 means Trb has to be executed by itself.
+
+**/
+UINT32
+SdMmcGetAdma3Chain (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN SD_MMC_HC_TRB                    *Trb
+  )
+{
+  LIST_ENTRY                          *Link;
+  SD_MMC_HC_TRB                       *SetBlkCntTrb;
+  SD_MMC_HC_TRB                       *DataTrb;
+  EFI_SD_MMC_COMMAND_BLOCK            *CmdBlk;
+  UINT32                              Count;
+  UINT8                               Slot;
+
+  Slot = Trb->Slot;
+  if ((Private->Slot[Slot].CardType != EmmcCardType) ||
+      (Private->ControllerVersion[Slot] < SD_MMC_HC_CTRL_VER_410) ||
+      (Private->Capability[Slot].Adma3 == 0) ||
+      (Private->Capability[Slot].SysBus64V4 == 0)) {
+    return 0;
+  }
+
+  Count = 0;
+  Link  = &Trb->TrbList;
+  while ((Count < SD_MMC_ADMA3_MAX_CMDS * 2) && !IsNull (&Private->Queue, Link)) {
+    SetBlkCntTrb = SD_MMC_HC_TRB_FROM_THIS (Link);
+    Link         = GetNextNode (&Private->Queue, Link);
+    if (IsNull (&Private->Queue, Link)) {
+      break;
+    }
+    DataTrb = SD_MMC_HC_TRB_FROM_THIS (Link);
+    Link    = GetNextNode (&Private->Queue, Link);
+
+    if ((SetBlkCntTrb->Slot != Slot) || (DataTrb->Slot != Slot) ||
+        SetBlkCntTrb->Started || DataTrb->Started ||
+        SetBlkCntTrb->NoAdma3 || DataTrb->NoAdma3) {
+      break;
+    }
+
+    //
+    // CMD23 without reliable write, packed or context flags.
+    //
+    CmdBlk = SetBlkCntTrb->Packet->SdMmcCmdBlk;
+    if ((CmdBlk->CommandIndex != EMMC_SET_BLOCK_COUNT) ||
+        (SetBlkCntTrb->Mode != SdMmcNoData) ||
+        ((CmdBlk->CommandArgument & 0xFFFF0000) != 0) ||
+        (CmdBlk->CommandArgument == 0)) {
+      break;
+    }
+
+    if (((DataTrb->Packet->SdMmcCmdBlk->CommandIndex != EMMC_READ_MULTIPLE_BLOCK) &&
+         (DataTrb->Packet->SdMmcCmdBlk->CommandIndex != EMMC_WRITE_MULTIPLE_BLOCK)) ||
+        (DataTrb->Mode != SdMmcAdma64bV4Mode) ||
+        (DataTrb->BlockSize != 0x200) ||
+        ((DataTrb->DataLen % DataTrb->BlockSize) != 0) ||
+        ((DataTrb->DataLen / DataTrb->BlockSize) != CmdBlk->CommandArgument)) {
+      break;
+    }
+
+    Count += 2;
+  }
+
+  return Count;
+}
+
+/**
+  Free the ADMA3 descriptor table of the host controller.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+
+**/
+VOID
+SdMmcFreeAdma3Table (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private
+  )
+{
+  EFI_PCI_IO_PROTOCOL                 *PciIo;
+
+  PciIo = Private->PciIo;
+
+  if (Private->Adma3TableMap != NULL) {
+    PciIo->Unmap (PciIo, Private->Adma3TableMap);
+    Private->Adma3TableMap = NULL;
+  }
+  if (Private->Adma3Table != NULL) {
+    PciIo->FreeBuffer (
+             PciIo,
+             EFI_SIZE_TO_PAGES (sizeof (SD_MMC_HC_ADMA3_TABLE)),
+             Private->Adma3Table
+             );
+    Private->Adma3Table = NULL;
+  }
+}
+
+/**
+  Allocate the ADMA3 descriptor table of the host controller. The table is
+  shared by all the slots, as only the TRBs at the head of the async queue
+  are executed at a time. It is kept until the controller is stopped.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+
+  @retval EFI_SUCCESS           The ADMA3 descriptor table is allocated.
+  @retval EFI_OUT_OF_RESOURCES  The ADMA3 descriptor table isn't allocated.
+
+**/
+EFI_STATUS
+SdMmcAllocateAdma3Table (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private
+  )
+{
+  EFI_PCI_IO_PROTOCOL                 *PciIo;
+  EFI_STATUS                          Status;
+  UINTN                               Bytes;
+  VOID                                *Table;
+
+  if (Private->Adma3Table != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  PciIo  = Private->PciIo;
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES (sizeof (SD_MMC_HC_ADMA3_TABLE)),
+                    &Table,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Private->Adma3Table = Table;
+
+  Bytes  = sizeof (SD_MMC_HC_ADMA3_TABLE);
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Table,
+                    &Bytes,
+                    &Private->Adma3TablePhy,
+                    &Private->Adma3TableMap
+                    );
+  if (EFI_ERROR (Status) || (Bytes != sizeof (SD_MMC_HC_ADMA3_TABLE))) {
+    SdMmcFreeAdma3Table (Private);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Execute a run of queued TRBs by one ADMA3 transfer.
+
+  Refer to SD Host Controller Simplified spec 4.2 Section 1.13.5 for details.
+  Every CMD23 + data command pair of the run is issued as one command
+  descriptor with Auto CMD23, and Response Error Check is used so the card
+  status of each command is verified by the host controller without a
+  Command Complete interrupt in between.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the first SD_MMC_HC_TRB instance of the run.
+  @param[in] Count          The number of TRBs returned by SdMmcGetAdma3Chain().
+
+  @retval EFI_SUCCESS       The ADMA3 transfer is started.
+  @retval EFI_NOT_READY     The cmd/data line isn't ready for the transfer.
+  @retval Others            The ADMA3 transfer isn't started, the TRBs have
+                            to be executed one by one.
+
+**/
+EFI_STATUS
+SdMmcExecAdma3 (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN SD_MMC_HC_TRB                    *Trb,
+  IN UINT32                           Count
+  )
+{
+  EFI_STATUS                          Status;
+  EFI_PCI_IO_PROTOCOL                 *PciIo;
+  SD_MMC_HC_ADMA3_TABLE               *Table;
+  SD_MMC_HC_ADMA3_DESC_SET            *DescSet;
+  SD_MMC_HC_TRB                       *DataTrb;
+  LIST_ENTRY                          *Link;
+  EFI_PHYSICAL_ADDRESS                Address;
+  UINT32                              Index;
+  UINT32                              BlkCount;
+  UINT16                              TransMode;
+  UINT16                              Cmd;
+  UINT16                              IntStatus;
+  UINT8                               HostCtrl1;
+  UINT64                              IdAddr;
+
+  PciIo = Private->PciIo;
+
+  Status = SdMmcHcCheckMmioSet (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL2, sizeof (UINT16),
+                                SD_MMC_HC_64_ADDR_EN, SD_MMC_HC_64_ADDR_EN);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The data commands need both Command Inhibit (CMD) and Command
+  // Inhibit (DAT) in the Present State register to be 0.
+  //
+  Status = SdMmcHcCheckMmioSet (PciIo, Trb->Slot, SD_MMC_HC_PRESENT_STATE, sizeof (UINT32),
+                                BIT0 | BIT1, 0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcAllocateAdma3Table (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Table = Private->Adma3Table;
+  ZeroMem (Table, sizeof (SD_MMC_HC_ADMA3_TABLE));
+
+  Link = &Trb->TrbList;
+  for (Index = 0; Index < Count / 2; Index++) {
+    //
+    // Skip the CMD23 TRB, it is issued as Auto CMD23 of the data command.
+    //
+    Link     = GetNextNode (&Private->Queue, Link);
+    DataTrb  = SD_MMC_HC_TRB_FROM_THIS (Link);
+    Link     = GetNextNode (&Private->Queue, Link);
+    DescSet  = &Table->DescSet[Index];
+    BlkCount = DataTrb->DataLen / DataTrb->BlockSize;
+
+    TransMode = BIT0 | BIT1 | BIT3 | BIT5 | BIT7 | BIT8;
+    if (DataTrb->Read) {
+      TransMode |= BIT4;
+    }
+    Cmd = (UINT16)(DataTrb->Packet->SdMmcCmdBlk->CommandIndex << 8) | BIT1 | BIT3 | BIT4 | BIT5;
+
+    DescSet->Command[0].Data = BlkCount;
+    DescSet->Command[1].Data = DataTrb->BlockSize;
+    DescSet->Command[2].Data = DataTrb->Packet->SdMmcCmdBlk->CommandArgument;
+    DescSet->Command[3].Data = TransMode | ((UINT32)Cmd << 16);
+    DescSet->Command[0].Valid = 1;
+    DescSet->Command[0].Act   = ADMA3_ACT_CMD;
+    DescSet->Command[1].Valid = 1;
+    DescSet->Command[1].Act   = ADMA3_ACT_CMD;
+    DescSet->Command[2].Valid = 1;
+    DescSet->Command[2].Act   = ADMA3_ACT_CMD;
+    DescSet->Command[3].Valid = 1;
+    DescSet->Command[3].Act   = ADMA3_ACT_CMD;
+    DescSet->Command[3].End   = 1;
+
+    DescSet->Link.Valid        = 1;
+    DescSet->Link.Act          = ADMA2_ACT_LINK;
+    DescSet->Link.LowerAddress = (UINT32)DataTrb->AdmaDescPhy;
+    DescSet->Link.UpperAddress = (UINT32)RShiftU64 (DataTrb->AdmaDescPhy, 32);
+
+    Address = Private->Adma3TablePhy + OFFSET_OF (SD_MMC_HC_ADMA3_TABLE, DescSet) +
+              Index * sizeof (SD_MMC_HC_ADMA3_DESC_SET);
+    Table->Integrated[Index].Valid        = 1;
+    Table->Integrated[Index].Act          = ADMA3_ACT_INTEGRATED;
+    Table->Integrated[Index].LowerAddress = (UINT32)Address;
+    Table->Integrated[Index].UpperAddress = (UINT32)RShiftU64 (Address, 32);
+  }
+  Table->Integrated[Index - 1].End = 1;
+
+  //
+  // Clear all bits in Error Interrupt Status Register, and Normal Interrupt
+  // Status Register excepts for Card Removal & Card Insertion bits.
+  //
+  IntStatus = 0xFFFF;
+  Status    = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ERR_INT_STS, FALSE, sizeof (IntStatus), &IntStatus);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+  IntStatus = 0xFF3F;
+  Status    = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_NOR_INT_STS, FALSE, sizeof (IntStatus), &IntStatus);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Set Host Control 1 register DMA Select field to ADMA3.
+  //
+  HostCtrl1 = BIT4 | BIT3;
+  Status = SdMmcHcOrMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  SdMmcHcLedOnOff (PciIo, Trb->Slot, TRUE);
+
+  //
+  // Writing the ADMA3 Integrated Descriptor Address starts the transfer.
+  //
+  IdAddr = (UINT64)Private->Adma3TablePhy;
+  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ADMA3_ID_ADDR, FALSE, sizeof (IdAddr), &IdAddr);
+  if (EFI_ERROR (Status)) {
+    SdMmcStopAdma3 (Private, Trb->Slot);
+  }
+  return Status;
+}
+
+/**
+  Switch the DMA Select field of the slot back from ADMA3 after an ADMA3
+  transfer, so the next TRB executed by SdMmcExecTrb() gets the DMA mode it
+  selects.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot of the ADMA3 transfer.
+
+**/
+VOID
+SdMmcStopAdma3 (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN UINT8                            Slot
+  )
+{
+  UINT8                               HostCtrl1;
+
+  HostCtrl1 = (UINT8)~BIT3;
+  SdMmcHcAndMmio (Private->PciIo, Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+  SdMmcHcLedOnOff (Private->PciIo, Slot, FALSE);
+}
+
+/**
+  Check the result of the ADMA3 transfer started by SdMmcExecAdma3().
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the first SD_MMC_HC_TRB instance of the run.
+
+  @retval EFI_SUCCESS       All the commands of the ADMA3 transfer are executed successfully.
+  @retval EFI_NOT_READY     The ADMA3 transfer is not completed.
+  @retval Others            Some erros happen when executing the ADMA3 transfer.
+
+**/
+EFI_STATUS
+SdMmcCheckAdma3Result (
+  IN SD_MMC_HC_PRIVATE_DATA           *Private,
+  IN SD_MMC_HC_TRB                    *Trb
+  )
+{
+  EFI_STATUS                          Status;
+  UINT16                              IntStatus;
+
+  Status = SdMmcHcRwMmio (
+             Private->PciIo,
+             Trb->Slot,
+             SD_MMC_HC_NOR_INT_STS,
+             TRUE,
+             sizeof (IntStatus),
+             &IntStatus
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Response errors of the commands are reported through the error
+  // interrupt status as Response Error Check is enabled.
+  //
+  Status = SdMmcCheckAndRecoverErrors (Private, Trb->Slot, IntStatus);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "ADMA3 transfer failed with %r\n", Status));
+    return Status;
+  }
+
+  if ((IntStatus & BIT1) == 0) {
+    return EFI_NOT_READY;
+  }
+
+  IntStatus = BIT0 | BIT1;
+  return SdMmcHcRwMmio (
+           Private->PciIo,
+           Trb->Slot,
+           SD_MMC_HC_NOR_INT_STS,
+           FALSE,
+           sizeof (IntStatus),
+           &IntStatus
+           );
+}
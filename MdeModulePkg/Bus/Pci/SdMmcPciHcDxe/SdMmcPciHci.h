@@ -53,6 +53,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define SD_MMC_HC_ADMA_ERR_STS        0x54
 #define SD_MMC_HC_ADMA_SYS_ADDR       0x58
 #define SD_MMC_HC_PRESET_VAL          0x60
+#define SD_MMC_HC_ADMA3_ID_ADDR       0x78
 #define SD_MMC_HC_SHARED_BUS_CTRL     0xE0
 #define SD_MMC_HC_SLOT_INT_STS        0xFC
 #define SD_MMC_HC_CTRL_VER            0xFE
@@ -145,6 +146,66 @@ typedef struct {
 #define SD_MMC_SDMA_BOUNDARY          512 * 1024
 #define SD_MMC_SDMA_ROUND_UP(x, n)    (((x) + n) & ~(n - 1))
 
+//
+// ADMA3 descriptor Act values, the Act field of ADMA3 takes bit 3:5 of the
+// attribute. Refer to SD Host Controller Simplified spec 4.2 Section 1.13.5.
+//
+#define ADMA3_ACT_CMD                  0x1
+#define ADMA3_ACT_INTEGRATED           0x7
+
+//
+// The ADMA2 Act value of a link descriptor line.
+//
+#define ADMA2_ACT_LINK                 0x3
+
+//
+// The maximum number of data commands executed by one ADMA3 transfer.
+//
+#define SD_MMC_ADMA3_MAX_CMDS          16
+
+//
+// ADMA3 command descriptor line. A command descriptor consists of four lines
+// which program 32-bit Block Count, Block Size/16-bit Block Count, Argument
+// and Transfer Mode/Command registers in that order.
+//
+typedef struct {
+  UINT32 Valid:1;
+  UINT32 End:1;
+  UINT32 Int:1;
+  UINT32 Act:3;
+  UINT32 Reserved:26;
+  UINT32 Data;
+} SD_MMC_HC_ADMA3_CMD_DESC_LINE;
+
+//
+// ADMA3 integrated descriptor line for 64b addressing in V4 mode.
+//
+typedef struct {
+  UINT32 Valid:1;
+  UINT32 End:1;
+  UINT32 Int:1;
+  UINT32 Act:3;
+  UINT32 Reserved:26;
+  UINT32 LowerAddress;
+  UINT32 UpperAddress;
+  UINT32 Reserved1;
+} SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE;
+
+//
+// ADMA3 descriptor set of one data command. The command descriptor is
+// followed by an ADMA2 link line pointing to the ADMA2 descriptor table
+// which was built for the TRB of the command.
+//
+typedef struct {
+  SD_MMC_HC_ADMA3_CMD_DESC_LINE       Command[4];
+  SD_MMC_HC_ADMA_64_V4_DESC_LINE      Link;
+} SD_MMC_HC_ADMA3_DESC_SET;
+
+typedef struct {
+  SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE  Integrated[SD_MMC_ADMA3_MAX_CMDS];
+  SD_MMC_HC_ADMA3_DESC_SET              DescSet[SD_MMC_ADMA3_MAX_CMDS];
+} SD_MMC_HC_ADMA3_TABLE;
+
 typedef struct {
   UINT8    FirstBar:3;        // bit 0:2
   UINT8    Reserved:1;        // bit 3
@@ -184,7 +245,9 @@ typedef struct {
   UINT32   TuningSDR50:1;     // bit 45
   UINT32   RetuningMod:2;     // bit 46:47
   UINT32   ClkMultiplier:8;   // bit 48:55
-  UINT32   Reserved5:7;       // bit 56:62
+  UINT32   Reserved5:3;       // bit 56:58
+  UINT32   Adma3:1;           // bit 59
+  UINT32   Reserved6:3;       // bit 60:62
   UINT32   Hs400:1;           // bit 63
 } SD_MMC_HC_SLOT_CAP;
 
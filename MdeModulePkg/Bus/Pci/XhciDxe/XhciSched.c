@@ -204,6 +204,32 @@ XhcFreeUrb (
   FreePool (Urb);
 }
 
+/**
+  Compute the TD Size field of a transfer TRB, that is the number of packets
+  the TD still has to transfer after this TRB, capped at 31.
+
+  @param  Remaining   The number of bytes of the TD after this TRB.
+  @param  MaxPacket   The max packet length of the endpoint.
+
+  @return The TD Size value.
+
+**/
+UINT32
+XhcTdSize (
+  IN UINTN                      Remaining,
+  IN UINTN                      MaxPacket
+  )
+{
+  UINTN                         Packets;
+
+  if ((Remaining == 0) || (MaxPacket == 0)) {
+    return 0;
+  }
+
+  Packets = (Remaining + MaxPacket - 1) / MaxPacket;
+  return (UINT32) MIN (Packets, 31);
+}
+
 /**
   Create a transfer TRB.
 
@@ -238,10 +264,11 @@ XhcCreateTransferTrb (
     return EFI_DEVICE_ERROR;
   }
 
-  Urb->Finished  = FALSE;
-  Urb->StartDone = FALSE;
-  Urb->EndDone   = FALSE;
-  Urb->Completed = 0;
+  Urb->Finished    = FALSE;
+  Urb->StartDone   = FALSE;
+  Urb->EndDone     = FALSE;
+  Urb->ShortPacket = FALSE;
+  Urb->Completed   = 0;
   Urb->Result    = EFI_USB_NOERROR;
 
   Dci       = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
@@ -372,25 +399,33 @@ XhcCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
+      //
+      // Build the whole request as one TD of chained Normal TRBs, so the
+      // device sees a single transfer and only the last TRB interrupts.
+      // A short packet on any TRB is still reported through ISP. Each
+      // TRB buffer stops at a 64KB boundary as required by the XHCI spec.
+      //
       TotalLen = 0;
       Len      = 0;
       TrbNum   = 0;
       TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
       while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
-          Len = Urb->DataLen - TotalLen;
-        } else {
-          Len = 0x10000;
-        }
+        PhyAddr = (EFI_PHYSICAL_ADDRESS) ((UINTN) Urb->DataPhy + TotalLen);
+        Len     = MIN (Urb->DataLen - TotalLen, 0x10000 - (UINTN) (PhyAddr & 0xFFFF));
+
         TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
-        TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT((UINT8 *) Urb->DataPhy + TotalLen);
-        TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT((UINT8 *) Urb->DataPhy + TotalLen);
+        TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT (PhyAddr);
+        TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT (PhyAddr);
         TrbStart->TrbNormal.Length    = (UINT32) Len;
-        TrbStart->TrbNormal.TDSize    = 0;
+        TrbStart->TrbNormal.TDSize    = XhcTdSize (Urb->DataLen - TotalLen - Len, Urb->Ep.MaxPacket);
         TrbStart->TrbNormal.IntTarget = 0;
         TrbStart->TrbNormal.ISP       = 1;
-        TrbStart->TrbNormal.IOC       = 1;
         TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
+        if (TotalLen + Len < Urb->DataLen) {
+          TrbStart->TrbNormal.CH      = 1;
+        } else {
+          TrbStart->TrbNormal.IOC     = 1;
+        }
         //
         // Update the cycle bit
         //
@@ -401,8 +436,26 @@ XhcCreateTransferTrb (
         TotalLen += Len;
       }
 
-      Urb->TrbNum = TrbNum;
-      Urb->TrbEnd = (TRB_TEMPLATE *)(UINTN)TrbStart;
+      if (TrbNum == 0) {
+        //
+        // A zero length request still needs a TRB to complete on.
+        //
+        TrbStart->TrbNormal.IntTarget = 0;
+        TrbStart->TrbNormal.ISP       = 1;
+        TrbStart->TrbNormal.IOC       = 1;
+        TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
+        TrbStart->TrbNormal.CycleBit  = EPRing->RingPCS & BIT0;
+
+        XhcSyncTrsRing (Xhc, EPRing);
+        TrbNum++;
+      }
+
+      //
+      // Only the last TRB of the chained TD generates an event on success.
+      //
+      Urb->StartDone = TRUE;
+      Urb->TrbNum    = TrbNum;
+      Urb->TrbEnd    = (TRB_TEMPLATE *)(UINTN)TrbStart;
       break;
 
     case ED_INTERRUPT_OUT:
@@ -1064,6 +1117,32 @@ IsAsyncIntTrb (
 }
 
 
+/**
+  Check whether the event ring holds events not consumed yet.
+
+  Only the ring memory is read: either events found by a previous sync of the
+  ring are still pending, or the controller has written a new event at the
+  dequeue pointer.
+
+  @param  Xhc             The XHCI Instance.
+
+  @retval TRUE            The event ring has pending events.
+  @retval FALSE           The event ring is empty.
+
+**/
+BOOLEAN
+XhcHasPendingEvent (
+  IN  USB_XHCI_INSTANCE   *Xhc
+  )
+{
+  EVENT_RING              *EvtRing;
+
+  EvtRing = &Xhc->EventRing;
+
+  return (BOOLEAN) ((EvtRing->EventRingDequeue != EvtRing->EventRingEnqueue) ||
+                    (EvtRing->EventRingDequeue->CycleBit == EvtRing->EventRingCCS));
+}
+
 /**
   Check the URB's execution result and update the URB's
   result accordingly.
@@ -1091,11 +1170,14 @@ XhcCheckUrbResult (
   UINT32                  High;
   UINT32                  Low;
   EFI_PHYSICAL_ADDRESS    PhyAddr;
+  EFI_PHYSICAL_ADDRESS    TrbData;
+  BOOLEAN                 EventHandled;
 
   ASSERT ((Xhc != NULL) && (Urb != NULL));
 
-  Status   = EFI_SUCCESS;
-  AsyncUrb = NULL;
+  Status       = EFI_SUCCESS;
+  AsyncUrb     = NULL;
+  EventHandled = FALSE;
 
   if (Urb->Finished) {
     goto EXIT;
@@ -1121,6 +1203,8 @@ XhcCheckUrbResult (
       goto EXIT;
     }
 
+    EventHandled = TRUE;
+
     //
     // Only handle COMMAND_COMPLETETION_EVENT and TRANSFER_EVENT.
     //
@@ -1196,9 +1280,26 @@ XhcCheckUrbResult (
 // END
 
         TRBType = (UINT8) (TRBPtr->Type);
-        if ((TRBType == TRB_TYPE_DATA_STAGE) ||
-            (TRBType == TRB_TYPE_NORMAL) ||
-            (TRBType == TRB_TYPE_ISOCH)) {
+        if ((TRBType == TRB_TYPE_NORMAL) && (CheckedUrb->Ep.Type == XHC_BULK_TRANSFER)) {
+          //
+          // Bulk TRBs are chained into one TD that only reports its last TRB
+          // and short packets, so count the length from the start of the
+          // buffer. A short packet ends the TD. XHCI 1.0 controllers report
+          // it again on the last TRB, which must not change the length.
+          //
+          if (!CheckedUrb->ShortPacket) {
+            TrbData = (EFI_PHYSICAL_ADDRESS) (((TRANSFER_TRB_NORMAL*)TRBPtr)->TRBPtrLo |
+                                              LShiftU64 ((UINT64) ((TRANSFER_TRB_NORMAL*)TRBPtr)->TRBPtrHi, 32));
+            CheckedUrb->Completed = (UINTN) (TrbData - (UINTN) CheckedUrb->DataPhy) +
+                                    ((TRANSFER_TRB_NORMAL*)TRBPtr)->Length - EvtTrb->Length;
+            if (EvtTrb->Completecode == TRB_COMPLETION_SHORT_PACKET) {
+              CheckedUrb->ShortPacket = TRUE;
+              CheckedUrb->EndDone     = TRUE;
+            }
+          }
+        } else if ((TRBType == TRB_TYPE_DATA_STAGE) ||
+                   (TRBType == TRB_TYPE_NORMAL) ||
+                   (TRBType == TRB_TYPE_ISOCH)) {
           CheckedUrb->Completed += (((TRANSFER_TRB_NORMAL*)TRBPtr)->Length - EvtTrb->Length);
         }
 
@@ -1230,6 +1331,14 @@ XhcCheckUrbResult (
 
 EXIT:
 
+  //
+  // Nothing to acknowledge when no event was consumed, which saves the
+  // register accesses while polling an idle ring.
+  //
+  if (!EventHandled) {
+    return Urb->Finished;
+  }
+
   //
   // Advance event ring to last available entry
   //
@@ -1304,9 +1413,16 @@ XhcExecTransfer (
   XhcRingDoorBell (Xhc, SlotId, Dci);
 
   for (Index = 0; Index < Loop; Index++) {
-    Finished = XhcCheckUrbResult (Xhc, Urb);
-    if (Finished) {
-      break;
+    //
+    // Only walk the event ring once the controller has written a new event
+    // to it, or once a millisecond to notice a halted controller. Polling
+    // the ring memory avoids register accesses on every iteration.
+    //
+    if (XhcHasPendingEvent (Xhc) || ((Index % XHC_1_MILLISECOND) == 0)) {
+      Finished = XhcCheckUrbResult (Xhc, Urb);
+      if (Finished) {
+        break;
+      }
     }
     gBS->Stall (XHC_1_MICROSECOND);
   }
@@ -1578,29 +1694,56 @@ XhcMonitorAsyncRequests (
   UINT8                   SlotId;
   EFI_STATUS              Status;
   EFI_TPL                 OldTpl;
+  TRB_TEMPLATE            *EvtDequeue;
 
   OldTpl = gBS->RaiseTPL (XHC_TPL);
 
   Xhc    = (USB_XHCI_INSTANCE*) Context;
 
+  //
+  // Consume the new events once for all the asynchronous transfers. Each
+  // transfer event marks the interrupt URB it completes as finished, so the
+  // endpoints without events cost nothing more than a flag check below.
+  // XhcCheckUrbResult() returns at once for a finished URB and stops at an
+  // error event, so pick an active URB each time and go on as long as it
+  // makes progress.
+  //
+  while (XhcHasPendingEvent (Xhc)) {
+    Urb = NULL;
+    BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncIntTransfers) {
+      if (!EFI_LIST_CONTAINER (Entry, URB, UrbList)->Finished) {
+        Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+        break;
+      }
+    }
+
+    if (Urb == NULL) {
+      break;
+    }
+
+    EvtDequeue = Xhc->EventRing.EventRingDequeue;
+    XhcCheckUrbResult (Xhc, Urb);
+    if (EvtDequeue == Xhc->EventRing.EventRingDequeue) {
+      break;
+    }
+  }
+
   BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncIntTransfers) {
     Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
 
     //
-    // Make sure that the device is available before every check.
+    // The URBs may also have been finished by the events consumed during a
+    // synchronous transfer. If it is still active, check the next one.
     //
-    SlotId = XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
-    if (SlotId == 0) {
+    if (!Urb->Finished) {
       continue;
     }
 
     //
-    // Check the result of URB execution. If it is still
-    // active, check the next one.
+    // Make sure that the device is available before every check.
     //
-    XhcCheckUrbResult (Xhc, Urb);
-
-    if (!Urb->Finished) {
+    SlotId = XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
+    if (SlotId == 0) {
       continue;
     }
 
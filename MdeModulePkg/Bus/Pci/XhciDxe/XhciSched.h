@@ -190,6 +190,10 @@ typedef struct _URB {
   BOOLEAN                         StartDone;
   BOOLEAN                         EndDone;
   BOOLEAN                         Finished;
+  //
+  // A short packet ended the chained bulk TD, its length is final
+  //
+  BOOLEAN                         ShortPacket;
 
   TRB_TEMPLATE                    *EvtTrb;
 } URB;
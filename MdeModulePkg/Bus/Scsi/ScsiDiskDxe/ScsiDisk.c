@@ -2609,6 +2609,12 @@ ScsiDiskInquiryDevice (
               ScsiDiskDevice->EraseBlock.EraseLengthGranularity = 1;
             }
 
+            ScsiDiskDevice->MaxTransferBlocks =
+              (BlockLimits->MaximumTransferLength4 << 24) |
+              (BlockLimits->MaximumTransferLength3 << 16) |
+              (BlockLimits->MaximumTransferLength2 << 8)  |
+              BlockLimits->MaximumTransferLength1;
+
             ScsiDiskDevice->BlockLimitsVpdSupported = TRUE;
           }
 
@@ -3348,6 +3354,100 @@ ParseInquiryData (
   ScsiDiskDevice->BlkIoMedia.RemovableMedia = (BOOLEAN) (!ScsiDiskDevice->FixedDevice);
 }
 
+/**
+  Get the maximum number of blocks that can be transferred by one Read/Write
+  command to the SCSI disk.
+
+  The limit is the one imposed by the CDB format (Read(10)/Write(10) or
+  Read(16)/Write(16)), further reduced by the maximum transfer length reported
+  in the Block Limits VPD page when the device provides one.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+
+  @return The maximum number of blocks per command.
+
+**/
+UINT32
+ScsiDiskGetMaxTransferBlocks (
+  IN   SCSI_DISK_DEV     *ScsiDiskDevice
+  )
+{
+  UINT32              MaxBlock;
+
+  if (!ScsiDiskDevice->Cdb16Byte) {
+    MaxBlock         = 0xFFFF;
+  } else {
+    MaxBlock         = 0xFFFFFFFF;
+  }
+
+  if ((ScsiDiskDevice->MaxTransferBlocks != 0) &&
+      (ScsiDiskDevice->MaxTransferBlocks < MaxBlock)) {
+    MaxBlock = ScsiDiskDevice->MaxTransferBlocks;
+  }
+
+  return MaxBlock;
+}
+
+/**
+  Read sector from SCSI Disk by keeping several Read(10) or Read(16) commands
+  in flight at the same time.
+
+  The request is handed to the BlockIo2 read path, which submits all the
+  sub-commands at once, and this function then waits for all of them to
+  complete. When the underlying pass thru does not support non-blocking I/O,
+  the sub-commands simply complete one after another.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+  @param  Buffer          The buffer to fill in the read out data
+  @param  Lba             Logic block address
+  @param  NumberOfBlocks  The number of blocks to read
+
+  @retval EFI_DEVICE_ERROR      Indicates a device error.
+  @retval EFI_OUT_OF_RESOURCES  The request could not be started due to a lack
+                                of resources.
+  @retval EFI_SUCCESS           Operation is successful.
+
+**/
+EFI_STATUS
+ScsiDiskPipelinedReadSectors (
+  IN   SCSI_DISK_DEV     *ScsiDiskDevice,
+  OUT  VOID              *Buffer,
+  IN   EFI_LBA           Lba,
+  IN   UINTN             NumberOfBlocks
+  )
+{
+  EFI_STATUS            Status;
+  EFI_BLOCK_IO2_TOKEN   Token;
+
+  Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Token.TransactionStatus = EFI_SUCCESS;
+  Status = ScsiDiskAsyncReadSectors (
+             ScsiDiskDevice,
+             Buffer,
+             Lba,
+             NumberOfBlocks,
+             &Token
+             );
+  if (!EFI_ERROR (Status)) {
+    //
+    // The sub-commands are completed by ScsiDiskNotify() at TPL_NOTIFY, which
+    // is above the TPL of the BlockIo callers.
+    //
+    while (gBS->CheckEvent (Token.Event) == EFI_NOT_READY) {
+      CpuPause ();
+    }
+    Status = Token.TransactionStatus;
+  }
+
+  gBS->CloseEvent (Token.Event);
+
+  return Status;
+}
+
 /**
   Read sector from SCSI Disk.
 
@@ -3389,10 +3489,18 @@ ScsiDiskReadSectors (
   //
   // limit the data bytes that can be transferred by one Read(10) or Read(16) Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock         = 0xFFFF;
-  } else {
-    MaxBlock         = 0xFFFFFFFF;
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
+
+  //
+  // When the request spans several commands, keep them in flight together
+  // rather than waiting for each one before issuing the next.
+  //
+  if (NumberOfBlocks > MaxBlock) {
+    Status = ScsiDiskPipelinedReadSectors (ScsiDiskDevice, Buffer, Lba, NumberOfBlocks);
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      return Status;
+    }
+    Status = EFI_SUCCESS;
   }
 
   PtrBuffer = Buffer;
@@ -3554,11 +3662,7 @@ ScsiDiskWriteSectors (
   //
   // limit the data bytes that can be transferred by one Read(10) or Read(16) Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock         = 0xFFFF;
-  } else {
-    MaxBlock         = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3737,11 +3841,7 @@ ScsiDiskAsyncReadSectors (
   // Limit the data bytes that can be transferred by one Read(10) or Read(16)
   // Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock         = 0xFFFF;
-  } else {
-    MaxBlock         = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3856,8 +3956,12 @@ ScsiDiskAsyncReadSectors (
         //
         // There are previous SCSI commands still running, EFI_SUCCESS should
         // be returned to make sure that the caller does not free resources
-        // still using by these SCSI commands.
+        // still using by these SCSI commands. The remaining blocks were never
+        // submitted, so report the failure through the token.
         //
+        OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+        Token->TransactionStatus = EFI_DEVICE_ERROR;
+        gBS->RestoreTPL (OldTpl);
         Status = EFI_SUCCESS;
         goto Done;
       }
@@ -3954,11 +4058,7 @@ ScsiDiskAsyncWriteSectors (
   // Limit the data bytes that can be transferred by one Read(10) or Read(16)
   // Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock         = 0xFFFF;
-  } else {
-    MaxBlock         = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
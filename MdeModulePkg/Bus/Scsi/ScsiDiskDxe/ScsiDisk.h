@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/StorageSecurityCommand.h>
 
 
+#include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiLib.h>
@@ -88,6 +89,12 @@ typedef struct {
   SCSI_UNMAP_PARAM_INFO     UnmapInfo;
   BOOLEAN                   BlockLimitsVpdSupported;
 
+  //
+  // Maximum transfer length (in blocks) reported by the Block Limits VPD page,
+  // 0 if the device does not report a limit
+  //
+  UINT32                    MaxTransferBlocks;
+
   //
   // The flag indicates if 16-byte command can be used
   //
@@ -1058,6 +1065,43 @@ ParseInquiryData (
   IN OUT SCSI_DISK_DEV   *ScsiDiskDevice
   );
 
+/**
+  Get the maximum number of blocks that can be transferred by one Read/Write
+  command to the SCSI disk.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+
+  @return The maximum number of blocks per command.
+
+**/
+UINT32
+ScsiDiskGetMaxTransferBlocks (
+  IN   SCSI_DISK_DEV     *ScsiDiskDevice
+  );
+
+/**
+  Read sector from SCSI Disk by keeping several Read(10) or Read(16) commands
+  in flight at the same time.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+  @param  Buffer          The buffer to fill in the read out data
+  @param  Lba             Logic block address
+  @param  NumberOfBlocks  The number of blocks to read
+
+  @retval EFI_DEVICE_ERROR      Indicates a device error.
+  @retval EFI_OUT_OF_RESOURCES  The request could not be started due to a lack
+                                of resources.
+  @retval EFI_SUCCESS           Operation is successful.
+
+**/
+EFI_STATUS
+ScsiDiskPipelinedReadSectors (
+  IN   SCSI_DISK_DEV     *ScsiDiskDevice,
+  OUT  VOID              *Buffer,
+  IN   EFI_LBA           Lba,
+  IN   UINTN             NumberOfBlocks
+  );
+
 /**
   Read sector from SCSI Disk.
 
@@ -62,6 +62,11 @@ typedef struct _UFS_PASS_THRU_PRIVATE_DATA {
 
   VOID                                *UtpTrlBase;
   UINT8                               Nutrs;
+  //
+  // Slots of the transfer request list owned by a request, which may still
+  // be waiting to be reaped after the controller has cleared its doorbell.
+  //
+  UINT32                              TrlSlotsInUse;
   VOID                                *TrlMapping;
   VOID                                *UtpTmrlBase;
   UINT8                               Nutmrs;
@@ -705,7 +705,11 @@ UfsCreateNopCommandDesc (
 }
 
 /**
-  Find out available slot in transfer list of a UFS device.
+  Find out available slot in transfer list of a UFS device and claim it.
+
+  A slot is available when its doorbell is clear and no other request owns it.
+  The latter matters for non-blocking requests, whose doorbell is cleared by
+  the controller before the completion is reaped by the async timer.
 
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[out] Slot          The available slot.
@@ -724,24 +728,53 @@ UfsFindAvailableSlotInTrl (
   UINT8            Index;
   UINT32           Data;
   EFI_STATUS       Status;
+  EFI_TPL          OldTpl;
 
   ASSERT ((Private != NULL) && (Slot != NULL));
 
+  OldTpl  = gBS->RaiseTPL (TPL_NOTIFY);
+
   Status  = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
+    gBS->RestoreTPL (OldTpl);
     return Status;
   }
 
+  Data   |= Private->TrlSlotsInUse;
   Nutrs   = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
+  Status  = EFI_NOT_READY;
 
   for (Index = 0; Index < Nutrs; Index++) {
     if ((Data & (BIT0 << Index)) == 0) {
-      *Slot = Index;
-      return EFI_SUCCESS;
+      Private->TrlSlotsInUse |= BIT0 << Index;
+      *Slot  = Index;
+      Status = EFI_SUCCESS;
+      break;
     }
   }
 
-  return EFI_NOT_READY;
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Release a slot of the transfer list claimed by UfsFindAvailableSlotInTrl().
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to be released.
+
+**/
+VOID
+UfsReleaseSlotInTrl (
+  IN  UFS_PASS_THRU_PRIVATE_DATA   *Private,
+  IN  UINT8                        Slot
+  )
+{
+  EFI_TPL          OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Private->TrlSlotsInUse &= ~(BIT0 << Slot);
+  gBS->RestoreTPL (OldTpl);
 }
 
 
@@ -925,6 +958,7 @@ UfsSendDmRequestRetry (
   Status = UfsCreateDMCommandDesc (Private, Packet, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to create DM command descriptor\n"));
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -941,7 +975,7 @@ UfsSendDmRequestRetry (
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0, 0, Packet->Timeout);
+  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, Packet->Timeout);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -970,6 +1004,7 @@ Exit:
   UfsHc->Flush (UfsHc);
 
   UfsStopExecCmd (Private, Slot);
+  UfsReleaseSlotInTrl (Private, Slot);
 
   if (CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, CmdDescMapping);
@@ -1270,6 +1305,7 @@ UfsExecNopCmds (
   Trd    = ((UTP_TRD*)Private->UtpTrlBase) + Slot;
   Status = UfsCreateNopCommandDesc (Private, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -1304,6 +1340,7 @@ Exit:
   UfsHc->Flush (UfsHc);
 
   UfsStopExecCmd (Private, Slot);
+  UfsReleaseSlotInTrl (Private, Slot);
 
   if (CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, CmdDescMapping);
@@ -1507,6 +1544,7 @@ UfsExecScsiCmds (
   //
   Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
   if (EFI_ERROR (Status)) {
+    FreePool (TransReq);
     return Status;
   }
 
@@ -1524,6 +1562,8 @@ UfsExecScsiCmds (
              &TransReq->CmdDescMapping
              );
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, TransReq->Slot);
+    FreePool (TransReq);
     return Status;
   }
 
@@ -1620,6 +1660,8 @@ Exit:
   UfsReconcileDataTransferBuffer (Private, TransReq);
 
 Exit1:
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
+
   if (TransReq->CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
   }
@@ -1658,9 +1700,10 @@ UfsExecUicCommands (
 
   if ((Data & UFS_HC_IS_UCCS) == UFS_HC_IS_UCCS) {
     //
-    // Clear IS.BIT10 UIC Command Completion Status (UCCS) at first.
+    // Clear IS.BIT10 UIC Command Completion Status (UCCS) at first. Leave the
+    // other bits alone, the async timer relies on the UTRCS bit.
     //
-    Status = UfsMmioWrite32 (Private, UFS_HC_IS_OFFSET, Data);
+    Status = UfsMmioWrite32 (Private, UFS_HC_IS_OFFSET, UFS_HC_IS_UCCS);
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -2236,6 +2279,8 @@ SignalCallerEvent (
 
   UfsReconcileDataTransferBuffer (Private, TransReq);
 
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
+
   if (TransReq->CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
   }
@@ -2275,27 +2320,39 @@ ProcessAsyncTaskList (
   UTP_RESPONSE_UPIU                             *Response;
   UINT16                                        SenseDataLen;
   UINT32                                        ResTranCount;
-  UINT32                                        SlotsMap;
   UINT32                                        Value;
+  UINT32                                        Doorbell;
+  BOOLEAN                                       Completed;
   EFI_STATUS                                    Status;
 
   Private   = (UFS_PASS_THRU_PRIVATE_DATA*) Context;
-  SlotsMap  = 0;
 
   //
   // Check the entries in the async I/O queue are done or not.
   //
   if (!IsListEmpty(&Private->Queue)) {
+    //
+    // The UTP Transfer Request Completion Status bit is set whenever one of
+    // the outstanding requests completes, so the doorbell only needs to be
+    // read once per tick and only when something completed since the last
+    // one. The bit is cleared before the doorbell is read so that a request
+    // completing in between is picked up by the next tick.
+    //
+    Completed = FALSE;
+    Doorbell  = 0;
+    Status    = UfsMmioRead32 (Private, UFS_HC_IS_OFFSET, &Value);
+    if (!EFI_ERROR (Status) && ((Value & UFS_HC_IS_UTRCS) != 0)) {
+      Status = UfsMmioWrite32 (Private, UFS_HC_IS_OFFSET, UFS_HC_IS_UTRCS);
+      if (!EFI_ERROR (Status)) {
+        Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Doorbell);
+        Completed = TRUE;
+      }
+    }
+
     BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->Queue) {
       TransReq  = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
       Packet    = TransReq->Packet;
 
-      if ((SlotsMap & (BIT0 << TransReq->Slot)) != 0) {
-        return;
-      }
-      SlotsMap |= BIT0 << TransReq->Slot;
-
-      Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
       if (EFI_ERROR (Status)) {
         //
         // TODO: Should find/add a proper host adapter return status for this
@@ -2307,7 +2364,7 @@ ProcessAsyncTaskList (
         continue;
       }
 
-      if ((Value & (BIT0 << TransReq->Slot)) != 0) {
+      if (!Completed || ((Doorbell & (BIT0 << TransReq->Slot)) != 0)) {
         //
         // Scsi cmd not finished yet.
         //
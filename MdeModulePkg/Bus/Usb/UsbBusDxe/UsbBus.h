@@ -60,6 +60,12 @@ typedef struct _USB_HUB_API    USB_HUB_API;
 #define USB_ROOTHUB_POLL_INTERVAL (100 * 10000U)
 #define USB_HUB_POLL_INTERVAL     64
 
+//
+// A hub reports its number of ports in a byte, so port
+// indexes are below this value.
+//
+#define USB_MAX_HUB_PORTS         255
+
 //
 // Wait for port stable to work, refers to specification
 // [USB20-9.1.2]
@@ -285,6 +291,7 @@ struct _USB_HUB_API{
   USB_HUB_SET_PORT_FEATURE    SetPortFeature;
   USB_HUB_CLEAR_PORT_FEATURE  ClearPortFeature;
   USB_HUB_RESET_PORT          ResetPort;
+  USB_HUB_RESET_PORTS         ResetPorts;
   USB_HUB_RELEASE             Release;
 };
 
@@ -656,6 +656,8 @@ UsbFindChild (
 
 /**
   Enumerate and configure the new device on the port of this HUB interface.
+  The caller has already waited USB_WAIT_PORT_STABLE_STALL for the
+  connection to debounce.
 
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
@@ -687,8 +689,6 @@ UsbEnumerateNewDev (
   HubApi  = HubIf->HubApi;
   Address = Bus->MaxDevices;
 
-  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
-
   //
   // Hub resets the device for at least 10 milliseconds.
   // Host learns device speed. If device is of low/full speed
@@ -879,20 +879,27 @@ ON_ERROR:
 
 
 /**
-  Process the events on the port.
+  Check the events on the port and remove the device that was
+  attached to it. If a new device is connected, the caller must
+  wait for the port to be stable, enumerate the device by
+  UsbEnumerateNewDev and then clear the port change.
 
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
+  @param  NewDevice             Whether a new device is connected to the port.
+  @param  ResetIsNeeded         Whether the port needs to be reset before the
+                                new device is enumerated.
 
-  @retval EFI_SUCCESS           The device is enumerated (added or removed).
-  @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
-  @retval Others                Failed to enumerate the device.
+  @retval EFI_SUCCESS           The events on the port are processed.
+  @retval Others                Failed to process the events on the port.
 
 **/
 EFI_STATUS
-UsbEnumeratePort (
-  IN USB_INTERFACE        *HubIf,
-  IN UINT8                Port
+UsbCheckPortChange (
+  IN  USB_INTERFACE       *HubIf,
+  IN  UINT8               Port,
+  OUT BOOLEAN             *NewDevice,
+  OUT BOOLEAN             *ResetIsNeeded
   )
 {
   USB_HUB_API             *HubApi;
@@ -900,8 +907,10 @@ UsbEnumeratePort (
   EFI_USB_PORT_STATUS     PortState;
   EFI_STATUS              Status;
 
-  Child   = NULL;
-  HubApi  = HubIf->HubApi;
+  Child          = NULL;
+  HubApi         = HubIf->HubApi;
+  *NewDevice     = FALSE;
+  *ResetIsNeeded = FALSE;
 
   //
   // Host learns of the new device by polling the hub for port changes.
@@ -985,21 +994,153 @@ UsbEnumeratePort (
     // Now, new device connected, enumerate and configure the device
     //
     DEBUG (( EFI_D_INFO, "UsbEnumeratePort: new device connected at port %d\n", Port));
-    if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
-      Status = UsbEnumerateNewDev (HubIf, Port, FALSE);
-    } else {
-      Status = UsbEnumerateNewDev (HubIf, Port, TRUE);
-    }
-
-  } else {
-    DEBUG (( EFI_D_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
+    *NewDevice     = TRUE;
+    *ResetIsNeeded = (BOOLEAN) !USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET);
+    return EFI_SUCCESS;
   }
 
+  DEBUG (( EFI_D_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
   HubApi->ClearPortChange (HubIf, Port);
   return Status;
 }
 
 
+
+/**
+  Process the events on the port.
+
+  @param  HubIf                 The HUB that has the device connected.
+  @param  Port                  The port index of the hub (started with zero).
+
+  @retval EFI_SUCCESS           The device is enumerated (added or removed).
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
+  @retval Others                Failed to enumerate the device.
+
+**/
+EFI_STATUS
+UsbEnumeratePort (
+  IN USB_INTERFACE        *HubIf,
+  IN UINT8                Port
+  )
+{
+  BOOLEAN                 NewDevice;
+  BOOLEAN                 ResetIsNeeded;
+  EFI_STATUS              Status;
+
+  Status = UsbCheckPortChange (HubIf, Port, &NewDevice, &ResetIsNeeded);
+
+  if (EFI_ERROR (Status) || !NewDevice) {
+    return Status;
+  }
+
+  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+
+  Status = UsbEnumerateNewDev (HubIf, Port, ResetIsNeeded);
+
+  HubIf->HubApi->ClearPortChange (HubIf, Port);
+  return Status;
+}
+
+
+/**
+  Process the events on a set of ports of the hub.
+
+  The events on every port are checked first, so the ports with a new
+  device share one wait for the connection to debounce. On XHCI, where
+  each device is addressed through its own slot, those ports are then
+  reset together. Other host controllers address a reset device through
+  the default address, so their ports are still reset one at a time
+  right before the device is addressed. The new devices are enumerated
+  one by one in the end, as UsbEnumeratePort does.
+
+  @param  HubIf                 The HUB to enumerate.
+  @param  Ports                 The port indexes of the hub (started with zero).
+  @param  Count                 The number of ports in Ports.
+
+**/
+VOID
+UsbEnumeratePorts (
+  IN USB_INTERFACE        *HubIf,
+  IN UINT8                *Ports,
+  IN UINT8                Count
+  )
+{
+  USB_BUS                 *Bus;
+  UINT8                   NewPorts[USB_MAX_HUB_PORTS];
+  BOOLEAN                 ResetIsNeeded[USB_MAX_HUB_PORTS];
+  UINT8                   ResetPorts[USB_MAX_HUB_PORTS];
+  EFI_STATUS              ResetResults[USB_MAX_HUB_PORTS];
+  UINT8                   NumOfNew;
+  UINT8                   NumOfReset;
+  UINT8                   Index;
+  BOOLEAN                 NewDevice;
+  EFI_STATUS              Status;
+
+  Bus      = HubIf->Device->Bus;
+  NumOfNew = 0;
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = UsbCheckPortChange (HubIf, Ports[Index], &NewDevice, &ResetIsNeeded[NumOfNew]);
+
+    if (!EFI_ERROR (Status) && NewDevice) {
+      NewPorts[NumOfNew++] = Ports[Index];
+    }
+  }
+
+  if (NumOfNew == 0) {
+    return ;
+  }
+
+  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+
+  if ((NumOfNew > 1) && (Bus->Usb2Hc != NULL) && (Bus->Usb2Hc->MajorRevision == 0x3)) {
+    NumOfReset = 0;
+
+    for (Index = 0; Index < NumOfNew; Index++) {
+      if (ResetIsNeeded[Index]) {
+        ResetPorts[NumOfReset++] = NewPorts[Index];
+      }
+    }
+
+    if (NumOfReset > 0) {
+      HubIf->HubApi->ResetPorts (HubIf, ResetPorts, NumOfReset, ResetResults);
+    }
+
+    //
+    // Both lists keep the order of the ports, so they can be walked together.
+    //
+    NumOfReset = 0;
+
+    for (Index = 0; Index < NumOfNew; Index++) {
+      if (!ResetIsNeeded[Index]) {
+        continue;
+      }
+
+      Status = ResetResults[NumOfReset++];
+
+      if (EFI_ERROR (Status)) {
+        DEBUG ((EFI_D_ERROR, "UsbEnumeratePorts: failed to reset port %d - %r\n", NewPorts[Index], Status));
+        HubIf->HubApi->ClearPortChange (HubIf, NewPorts[Index]);
+        NewPorts[Index] = USB_MAX_HUB_PORTS;
+        continue;
+      }
+
+      DEBUG (( EFI_D_INFO, "UsbEnumeratePorts: hub port %d is reset\n", NewPorts[Index]));
+      ResetIsNeeded[Index] = FALSE;
+    }
+  }
+
+  for (Index = 0; Index < NumOfNew; Index++) {
+    if (NewPorts[Index] == USB_MAX_HUB_PORTS) {
+      continue;
+    }
+
+    UsbEnumerateNewDev (HubIf, NewPorts[Index], ResetIsNeeded[Index]);
+    HubIf->HubApi->ClearPortChange (HubIf, NewPorts[Index]);
+  }
+}
+
+
 /**
   Enumerate all the changed hub ports.
 
@@ -1018,6 +1159,8 @@ UsbHubEnumeration (
   UINT8                   Byte;
   UINT8                   Bit;
   UINT8                   Index;
+  UINT8                   Count;
+  UINT8                   Ports[USB_MAX_HUB_PORTS];
   USB_DEVICE              *Child;
 
   ASSERT (Context != NULL);
@@ -1041,15 +1184,18 @@ UsbHubEnumeration (
   //
   Byte  = 0;
   Bit   = 1;
+  Count = 0;
 
   for (Index = 0; Index < HubIf->NumOfPort; Index++) {
     if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
-      UsbEnumeratePort (HubIf, Index);
+      Ports[Count++] = Index;
     }
 
     USB_NEXT_BIT (Byte, Bit);
   }
 
+  UsbEnumeratePorts (HubIf, Ports, Count);
+
   UsbHubAckHubStatus (HubIf->Device);
 
   gBS->FreePool (HubIf->ChangeMap);
@@ -1074,6 +1220,7 @@ UsbRootHubEnumeration (
 {
   USB_INTERFACE           *RootHub;
   UINT8                   Index;
+  UINT8                   Ports[USB_MAX_HUB_PORTS];
   USB_DEVICE              *Child;
 
   RootHub = (USB_INTERFACE *) Context;
@@ -1092,6 +1239,8 @@ UsbRootHubEnumeration (
       UsbRemoveDevice (Child);
     }
 
-    UsbEnumeratePort (RootHub, Index);
+    Ports[Index] = Index;
   }
+
+  UsbEnumeratePorts (RootHub, Ports, RootHub->NumOfPort);
 }
@@ -79,6 +79,20 @@ EFI_STATUS
   IN UINT8                Port
   );
 
+//
+// Reset a set of ports together, sharing the reset and
+// recovery waits. The result of each port is returned
+// in Results.
+//
+typedef
+VOID
+(*USB_HUB_RESET_PORTS) (
+  IN  USB_INTERFACE       *UsbIf,
+  IN  UINT8               *Ports,
+  IN  UINT8               Count,
+  OUT EFI_STATUS          *Results
+  );
+
 typedef
 EFI_STATUS
 (*USB_HUB_RELEASE) (
@@ -840,30 +840,48 @@ UsbHubClearPortFeature (
 
 
 /**
-  Interface function to reset the port.
+  Interface function to reset a set of ports of the hub together. The
+  reset signal is driven on all the ports at once so the reset and recovery
+  waits are paid once rather than once per port.
 
   @param  HubIf                 The hub interface.
-  @param  Port                  The port to reset.
-
-  @retval EFI_SUCCESS           The hub port is reset.
-  @retval EFI_TIMEOUT           Failed to reset the port in time.
-  @retval Others                Failed to reset the port.
+  @param  Ports                 The ports to reset.
+  @param  Count                 The number of ports in Ports.
+  @param  Results               The result of the reset of each port:
+                                EFI_SUCCESS if the port is reset,
+                                EFI_TIMEOUT if it failed to reset in time,
+                                or other errors if it failed to reset.
 
 **/
-EFI_STATUS
-UsbHubResetPort (
-  IN USB_INTERFACE        *HubIf,
-  IN UINT8                Port
+VOID
+UsbHubResetPorts (
+  IN  USB_INTERFACE       *HubIf,
+  IN  UINT8               *Ports,
+  IN  UINT8               Count,
+  OUT EFI_STATUS          *Results
   )
 {
   EFI_USB_PORT_STATUS     PortState;
   UINTN                   Index;
+  UINT8                   Slot;
+  UINT8                   Pending;
+  BOOLEAN                 Recover;
   EFI_STATUS              Status;
 
-  Status  = UsbHubSetPortFeature (HubIf, Port, (EFI_USB_PORT_FEATURE) USB_HUB_PORT_RESET);
+  Pending = 0;
+  Recover = FALSE;
 
-  if (EFI_ERROR (Status)) {
-    return Status;
+  for (Slot = 0; Slot < Count; Slot++) {
+    Results[Slot] = UsbHubSetPortFeature (HubIf, Ports[Slot], (EFI_USB_PORT_FEATURE) USB_HUB_PORT_RESET);
+
+    if (!EFI_ERROR (Results[Slot])) {
+      Results[Slot] = EFI_NOT_READY;
+      Pending++;
+    }
+  }
+
+  if (Pending == 0) {
+    return ;
   }
 
   //
@@ -877,23 +895,62 @@ UsbHubResetPort (
   //
   ZeroMem (&PortState, sizeof (EFI_USB_PORT_STATUS));
 
-  for (Index = 0; Index < USB_WAIT_PORT_STS_CHANGE_LOOP; Index++) {
-    Status = UsbHubGetPortStatus (HubIf, Port, &PortState);
+  for (Index = 0; (Index < USB_WAIT_PORT_STS_CHANGE_LOOP) && (Pending > 0); Index++) {
+    for (Slot = 0; Slot < Count; Slot++) {
+      if (Results[Slot] != EFI_NOT_READY) {
+        continue;
+      }
 
-    if (EFI_ERROR (Status)) {
-      return Status;
+      Status = UsbHubGetPortStatus (HubIf, Ports[Slot], &PortState);
+
+      if (EFI_ERROR (Status)) {
+        Results[Slot] = Status;
+        Pending--;
+      } else if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
+        Results[Slot] = EFI_SUCCESS;
+        Recover       = TRUE;
+        Pending--;
+      }
     }
 
-    if (!EFI_ERROR (Status) &&
-        USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
-      gBS->Stall (USB_SET_PORT_RECOVERY_STALL);
-      return EFI_SUCCESS;
+    if (Pending > 0) {
+      gBS->Stall (USB_WAIT_PORT_STS_CHANGE_STALL);
     }
+  }
+
+  for (Slot = 0; Slot < Count; Slot++) {
+    if (Results[Slot] == EFI_NOT_READY) {
+      Results[Slot] = EFI_TIMEOUT;
+    }
+  }
 
-    gBS->Stall (USB_WAIT_PORT_STS_CHANGE_STALL);
+  if (Recover) {
+    gBS->Stall (USB_SET_PORT_RECOVERY_STALL);
   }
+}
+
+
+/**
+  Interface function to reset the port.
+
+  @param  HubIf                 The hub interface.
+  @param  Port                  The port to reset.
+
+  @retval EFI_SUCCESS           The hub port is reset.
+  @retval EFI_TIMEOUT           Failed to reset the port in time.
+  @retval Others                Failed to reset the port.
 
-  return EFI_TIMEOUT;
+**/
+EFI_STATUS
+UsbHubResetPort (
+  IN USB_INTERFACE        *HubIf,
+  IN UINT8                Port
+  )
+{
+  EFI_STATUS              Status;
+
+  UsbHubResetPorts (HubIf, &Port, 1, &Status);
+  return Status;
 }
 
 
@@ -1150,28 +1207,37 @@ UsbRootHubClearPortFeature (
 
 
 /**
-  Interface function to reset the root hub port.
+  Interface function to reset a set of root hub ports together. The reset
+  signal is driven on all the ports at once so the reset waits are paid
+  once rather than once per port.
 
   @param  RootIf                The root hub interface.
-  @param  Port                  The port to reset.
-
-  @retval EFI_SUCCESS           The hub port is reset.
-  @retval EFI_TIMEOUT           Failed to reset the port in time.
-  @retval EFI_NOT_FOUND         The low/full speed device connected to high  speed.
-                                root hub is released to the companion UHCI.
-  @retval Others                Failed to reset the port.
+  @param  Ports                 The ports to reset.
+  @param  Count                 The number of ports in Ports.
+  @param  Results               The result of the reset of each port:
+                                EFI_SUCCESS if the port is reset,
+                                EFI_TIMEOUT if it failed to reset in time,
+                                EFI_NOT_FOUND if the low/full speed device
+                                connected to high speed root hub is released
+                                to the companion UHCI,
+                                or other errors if it failed to reset.
 
 **/
-EFI_STATUS
-UsbRootHubResetPort (
-  IN USB_INTERFACE        *RootIf,
-  IN UINT8                Port
+VOID
+UsbRootHubResetPorts (
+  IN  USB_INTERFACE       *RootIf,
+  IN  UINT8               *Ports,
+  IN  UINT8               Count,
+  OUT EFI_STATUS          *Results
   )
 {
   USB_BUS                 *Bus;
   EFI_STATUS              Status;
   EFI_USB_PORT_STATUS     PortState;
   UINTN                   Index;
+  UINT8                   Slot;
+  UINT8                   Pending;
+  BOOLEAN                 Enabled;
 
   //
   // Notice: although EHCI requires that ENABLED bit be cleared
@@ -1179,12 +1245,21 @@ UsbRootHubResetPort (
   // should be handled in the EHCI driver.
   //
   Bus     = RootIf->Device->Bus;
+  Pending = 0;
+  Enabled = FALSE;
 
-  Status  = UsbHcSetRootHubPortFeature (Bus, Port, EfiUsbPortReset);
+  for (Slot = 0; Slot < Count; Slot++) {
+    Results[Slot] = UsbHcSetRootHubPortFeature (Bus, Ports[Slot], EfiUsbPortReset);
 
-  if (EFI_ERROR (Status)) {
-    DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: failed to start reset on port %d\n", Port));
-    return Status;
+    if (EFI_ERROR (Results[Slot])) {
+      DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: failed to start reset on port %d\n", Ports[Slot]));
+    } else {
+      Pending++;
+    }
+  }
+
+  if (Pending == 0) {
+    return ;
   }
 
   //
@@ -1193,11 +1268,25 @@ UsbRootHubResetPort (
   //
   gBS->Stall (USB_SET_ROOT_PORT_RESET_STALL);
 
-  Status = UsbHcClearRootHubPortFeature (Bus, Port, EfiUsbPortReset);
+  Pending = 0;
 
-  if (EFI_ERROR (Status)) {
-    DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: failed to clear reset on port %d\n", Port));
-    return Status;
+  for (Slot = 0; Slot < Count; Slot++) {
+    if (EFI_ERROR (Results[Slot])) {
+      continue;
+    }
+
+    Results[Slot] = UsbHcClearRootHubPortFeature (Bus, Ports[Slot], EfiUsbPortReset);
+
+    if (EFI_ERROR (Results[Slot])) {
+      DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: failed to clear reset on port %d\n", Ports[Slot]));
+    } else {
+      Results[Slot] = EFI_NOT_READY;
+      Pending++;
+    }
+  }
+
+  if (Pending == 0) {
+    return ;
   }
 
   gBS->Stall (USB_CLR_ROOT_PORT_RESET_STALL);
@@ -1208,52 +1297,94 @@ UsbRootHubResetPort (
   //
   ZeroMem (&PortState, sizeof (EFI_USB_PORT_STATUS));
 
-  for (Index = 0; Index < USB_WAIT_PORT_STS_CHANGE_LOOP; Index++) {
-    Status = UsbHcGetRootHubPortStatus (Bus, Port, &PortState);
+  for (Index = 0; (Index < USB_WAIT_PORT_STS_CHANGE_LOOP) && (Pending > 0); Index++) {
+    for (Slot = 0; Slot < Count; Slot++) {
+      if (Results[Slot] != EFI_NOT_READY) {
+        continue;
+      }
 
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+      Status = UsbHcGetRootHubPortStatus (Bus, Ports[Slot], &PortState);
 
-    if (!USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_RESET)) {
-      break;
-    }
+      if (EFI_ERROR (Status)) {
+        Results[Slot] = Status;
+        Pending--;
+        continue;
+      }
 
-    gBS->Stall (USB_WAIT_PORT_STS_CHANGE_STALL);
-  }
+      if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_RESET)) {
+        continue;
+      }
 
-  if (Index == USB_WAIT_PORT_STS_CHANGE_LOOP) {
-    DEBUG ((EFI_D_ERROR, "UsbRootHubResetPort: reset not finished in time on port %d\n", Port));
-    return EFI_TIMEOUT;
-  }
+      Pending--;
+      Results[Slot] = EFI_SUCCESS;
 
-  if (!USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_ENABLE)) {
-    //
-    // OK, the port is reset. If root hub is of high speed and
-    // the device is of low/full speed, release the ownership to
-    // companion UHCI. If root hub is of full speed, it won't
-    // automatically enable the port, we need to enable it manually.
-    //
-    if (RootIf->MaxSpeed == EFI_USB_SPEED_HIGH) {
-      DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: release low/full speed device (%d) to UHCI\n", Port));
+      if (!USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_ENABLE)) {
+        //
+        // OK, the port is reset. If root hub is of high speed and
+        // the device is of low/full speed, release the ownership to
+        // companion UHCI. If root hub is of full speed, it won't
+        // automatically enable the port, we need to enable it manually.
+        //
+        if (RootIf->MaxSpeed == EFI_USB_SPEED_HIGH) {
+          DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: release low/full speed device (%d) to UHCI\n", Ports[Slot]));
 
-      UsbRootHubSetPortFeature (RootIf, Port, EfiUsbPortOwner);
-      return EFI_NOT_FOUND;
+          UsbRootHubSetPortFeature (RootIf, Ports[Slot], EfiUsbPortOwner);
+          Results[Slot] = EFI_NOT_FOUND;
 
-    } else {
+        } else {
 
-      Status = UsbRootHubSetPortFeature (RootIf, Port, EfiUsbPortEnable);
+          Results[Slot] = UsbRootHubSetPortFeature (RootIf, Ports[Slot], EfiUsbPortEnable);
 
-      if (EFI_ERROR (Status)) {
-        DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: failed to enable port %d for UHCI\n", Port));
-        return Status;
+          if (EFI_ERROR (Results[Slot])) {
+            DEBUG (( EFI_D_ERROR, "UsbRootHubResetPort: failed to enable port %d for UHCI\n", Ports[Slot]));
+          } else {
+            Enabled = TRUE;
+          }
+        }
       }
+    }
 
-      gBS->Stall (USB_SET_ROOT_PORT_ENABLE_STALL);
+    if (Pending > 0) {
+      gBS->Stall (USB_WAIT_PORT_STS_CHANGE_STALL);
     }
   }
 
-  return EFI_SUCCESS;
+  for (Slot = 0; Slot < Count; Slot++) {
+    if (Results[Slot] == EFI_NOT_READY) {
+      DEBUG ((EFI_D_ERROR, "UsbRootHubResetPort: reset not finished in time on port %d\n", Ports[Slot]));
+      Results[Slot] = EFI_TIMEOUT;
+    }
+  }
+
+  if (Enabled) {
+    gBS->Stall (USB_SET_ROOT_PORT_ENABLE_STALL);
+  }
+}
+
+
+/**
+  Interface function to reset the root hub port.
+
+  @param  RootIf                The root hub interface.
+  @param  Port                  The port to reset.
+
+  @retval EFI_SUCCESS           The hub port is reset.
+  @retval EFI_TIMEOUT           Failed to reset the port in time.
+  @retval EFI_NOT_FOUND         The low/full speed device connected to high  speed.
+                                root hub is released to the companion UHCI.
+  @retval Others                Failed to reset the port.
+
+**/
+EFI_STATUS
+UsbRootHubResetPort (
+  IN USB_INTERFACE        *RootIf,
+  IN UINT8                Port
+  )
+{
+  EFI_STATUS              Status;
+
+  UsbRootHubResetPorts (RootIf, &Port, 1, &Status);
+  return Status;
 }
 
 
@@ -1286,6 +1417,7 @@ USB_HUB_API mUsbHubApi = {
   UsbHubSetPortFeature,
   UsbHubClearPortFeature,
   UsbHubResetPort,
+  UsbHubResetPorts,
   UsbHubRelease
 };
 
@@ -1296,5 +1428,6 @@ USB_HUB_API mUsbRootHubApi = {
   UsbRootHubSetPortFeature,
   UsbRootHubClearPortFeature,
   UsbRootHubResetPort,
+  UsbRootHubResetPorts,
   UsbRootHubRelease
 };
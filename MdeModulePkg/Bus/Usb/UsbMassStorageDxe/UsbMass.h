@@ -31,6 +31,7 @@ typedef struct _USB_MASS_DEVICE    USB_MASS_DEVICE;
 
 #include "UsbMassBot.h"
 #include "UsbMassCbi.h"
+#include "UsbMassUas.h"
 #include "UsbMassBoot.h"
 #include "UsbMassDiskInfo.h"
 #include "UsbMassImpl.h"
@@ -153,7 +154,7 @@ EFI_STATUS
 ///
 /// This structure contains information necessary to select the
 /// proper transport protocol. The mass storage class defines
-/// two transport protocols. One is the CBI, and the other is BOT.
+/// three transport protocols: CBI, BOT and UAS.
 /// CBI is being obseleted. The design is made modular by this
 /// structure so that the CBI protocol can be easily removed when
 /// it is no longer necessary.
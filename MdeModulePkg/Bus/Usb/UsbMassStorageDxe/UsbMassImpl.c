@@ -8,11 +8,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "UsbMass.h"
 
-#define USB_MASS_TRANSPORT_COUNT    3
+#define USB_MASS_TRANSPORT_COUNT    4
 //
-// Array of USB transport interfaces.
+// Array of USB transport interfaces. UAS comes first so that it is preferred
+// over the Bulk-Only alternate setting UAS devices usually default to.
 //
 USB_MASS_TRANSPORT *mUsbMassTransport[USB_MASS_TRANSPORT_COUNT] = {
+  &mUsbUasTransport,
   &mUsbCbi0Transport,
   &mUsbCbi1Transport,
   &mUsbBotTransport,
@@ -426,9 +428,15 @@ UsbMassInitTransport (
   for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
     *Transport = mUsbMassTransport[Index];
 
-    if (Interface.InterfaceProtocol == (*Transport)->Protocol) {
+    //
+    // UAS usually lives in an alternate setting, its Init() looks for it.
+    //
+    if ((Interface.InterfaceProtocol == (*Transport)->Protocol) ||
+        ((*Transport)->Protocol == USB_MASS_STORE_UAS)) {
       Status  = (*Transport)->Init (UsbIo, Context);
-      break;
+      if (!EFI_ERROR (Status) || ((*Transport)->Protocol != USB_MASS_STORE_UAS)) {
+        break;
+      }
     }
   }
 
@@ -750,9 +758,15 @@ USBMassDriverBindingSupported (
   //
   for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
     Transport = mUsbMassTransport[Index];
-    if (Interface.InterfaceProtocol == Transport->Protocol) {
+    //
+    // UAS usually lives in an alternate setting, its Init() looks for it.
+    //
+    if ((Interface.InterfaceProtocol == Transport->Protocol) ||
+        (Transport->Protocol == USB_MASS_STORE_UAS)) {
       Status = Transport->Init (UsbIo, NULL);
-      break;
+      if (!EFI_ERROR (Status) || (Transport->Protocol != USB_MASS_STORE_UAS)) {
+        break;
+      }
     }
   }
 
@@ -0,0 +1,754 @@
+/** @file
+  Implementation of the USB Attached SCSI (UAS) transport, according to
+  USB Mass Storage Class USB Attached SCSI Protocol, Revision 1.0.
+
+  USB I/O Protocol can't address bulk streams, so the transport is only used
+  when the device runs its UAS interface without them, that is below
+  SuperSpeed. The device then announces each data phase with a READ READY or
+  WRITE READY IU on the status pipe. Devices that need streams keep using
+  their Bulk-Only alternate setting.
+
+Copyright (c) Microsoft Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbMass.h"
+
+//
+// Definition of USB UAS Transport Protocol
+//
+USB_MASS_TRANSPORT mUsbUasTransport = {
+  USB_MASS_STORE_UAS,
+  UsbUasInit,
+  UsbUasExecCommand,
+  UsbUasResetDevice,
+  NULL,
+  UsbUasCleanUp
+};
+
+/**
+  Select an alternate setting of the mass storage interface.
+
+  The request goes through the USB I/O Protocol, so the USB bus driver also
+  switches the endpoints it exposes to those of the new setting.
+
+  @param  UsbUas                The USB UAS device
+  @param  AlternateSetting      The alternate setting to select
+
+  @retval EFI_SUCCESS           The alternate setting is selected.
+  @retval Others                Failed to select the alternate setting.
+
+**/
+EFI_STATUS
+UsbUasSelectSetting (
+  IN USB_UAS_PROTOCOL       *UsbUas,
+  IN UINT8                  AlternateSetting
+  )
+{
+  EFI_USB_DEVICE_REQUEST    Request;
+  EFI_STATUS                Status;
+  UINT32                    Result;
+  UINT32                    Timeout;
+
+  Request.RequestType = 0x01;
+  Request.Request     = USB_REQ_SET_INTERFACE;
+  Request.Value       = AlternateSetting;
+  Request.Index       = UsbUas->Interface.InterfaceNumber;
+  Request.Length      = 0;
+  Timeout             = USB_UAS_GENERAL_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  Status = UsbUas->UsbIo->UsbControlTransfer (
+                            UsbUas->UsbIo,
+                            &Request,
+                            EfiUsbNoData,
+                            Timeout,
+                            NULL,
+                            0,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "UsbUasSelectSetting: setting %d (%r)\n", AlternateSetting, Status));
+    return Status;
+  }
+
+  return UsbUas->UsbIo->UsbGetInterfaceDescriptor (UsbUas->UsbIo, &UsbUas->Interface);
+}
+
+/**
+  Read the whole active configuration descriptor of the device.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  TotalLength           Return the length of the configuration descriptor
+
+  @return The configuration descriptor allocated from pool, or NULL on failure.
+
+**/
+UINT8 *
+UsbUasGetConfigDescriptor (
+  IN  EFI_USB_IO_PROTOCOL       *UsbIo,
+  OUT UINT16                    *TotalLength
+  )
+{
+  EFI_USB_DEVICE_DESCRIPTOR     DevDesc;
+  EFI_USB_CONFIG_DESCRIPTOR     ConfigDesc;
+  EFI_USB_DEVICE_REQUEST        Request;
+  EFI_STATUS                    Status;
+  UINT8                         *Buffer;
+  UINT8                         Index;
+  UINT32                        Result;
+  UINT32                        Timeout;
+
+  Status = UsbIo->UsbGetDeviceDescriptor (UsbIo, &DevDesc);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Status = UsbIo->UsbGetConfigDescriptor (UsbIo, &ConfigDesc);
+  if (EFI_ERROR (Status) ||
+      (ConfigDesc.TotalLength < sizeof (EFI_USB_CONFIG_DESCRIPTOR)) ||
+      (ConfigDesc.TotalLength > USB_UAS_MAX_CONFIG_LEN)) {
+    return NULL;
+  }
+
+  Buffer = AllocateZeroPool (ConfigDesc.TotalLength);
+  if (Buffer == NULL) {
+    return NULL;
+  }
+
+  //
+  // USB I/O Protocol only returns the header of the active configuration,
+  // fetch the whole descriptor whose configuration value matches it.
+  //
+  Timeout = USB_UAS_GENERAL_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  for (Index = 0; Index < DevDesc.NumConfigurations; Index++) {
+    Request.RequestType = 0x80;
+    Request.Request     = USB_REQ_GET_DESCRIPTOR;
+    Request.Value       = (UINT16) ((USB_DESC_TYPE_CONFIG << 8) | Index);
+    Request.Index       = 0;
+    Request.Length      = ConfigDesc.TotalLength;
+
+    Status = UsbIo->UsbControlTransfer (
+                      UsbIo,
+                      &Request,
+                      EfiUsbDataIn,
+                      Timeout,
+                      Buffer,
+                      ConfigDesc.TotalLength,
+                      &Result
+                      );
+    if (!EFI_ERROR (Status) &&
+        (((EFI_USB_CONFIG_DESCRIPTOR *) Buffer)->ConfigurationValue == ConfigDesc.ConfigurationValue)) {
+      *TotalLength = ConfigDesc.TotalLength;
+      return Buffer;
+    }
+  }
+
+  FreePool (Buffer);
+  return NULL;
+}
+
+/**
+  Find the alternate setting of the mass storage interface implementing UAS
+  and save its pipes.
+
+  @param  UsbUas                The USB UAS device
+
+  @retval EFI_SUCCESS           A usable UAS alternate setting is found.
+  @retval EFI_UNSUPPORTED       The interface has no usable UAS alternate setting.
+
+**/
+EFI_STATUS
+UsbUasFindSetting (
+  IN OUT USB_UAS_PROTOCOL       *UsbUas
+  )
+{
+  UINT8                         *Buffer;
+  UINT16                        TotalLength;
+  UINTN                         Offset;
+  UINT8                         Length;
+  UINT8                         Type;
+  EFI_USB_INTERFACE_DESCRIPTOR  *Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR   *Endpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR   *Pipe;
+  USB_UAS_PIPE_USAGE_DESCRIPTOR *PipeUsage;
+  BOOLEAN                       InUasSetting;
+  BOOLEAN                       StreamsRequired;
+  UINT8                         PipeMask;
+
+  Buffer = UsbUasGetConfigDescriptor (UsbUas->UsbIo, &TotalLength);
+  if (Buffer == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Endpoint        = NULL;
+  InUasSetting    = FALSE;
+  StreamsRequired = FALSE;
+  PipeMask        = 0;
+
+  //
+  // Walk the descriptors of the UAS alternate setting. Each endpoint is
+  // followed by a Pipe Usage descriptor telling which pipe it implements,
+  // and on SuperSpeed by an endpoint companion descriptor.
+  //
+  for (Offset = 0; Offset + 2 <= TotalLength; Offset += Length) {
+    Length = Buffer[Offset];
+    Type   = Buffer[Offset + 1];
+
+    if ((Length < 2) || (Offset + Length > TotalLength)) {
+      break;
+    }
+
+    if (Type == USB_DESC_TYPE_INTERFACE) {
+      if (InUasSetting) {
+        break;
+      }
+
+      Interface = (EFI_USB_INTERFACE_DESCRIPTOR *) (Buffer + Offset);
+      if ((Length >= sizeof (EFI_USB_INTERFACE_DESCRIPTOR)) &&
+          (Interface->InterfaceNumber == UsbUas->Interface.InterfaceNumber) &&
+          (Interface->InterfaceClass == USB_MASS_STORE_CLASS) &&
+          (Interface->InterfaceSubClass == USB_MASS_STORE_SCSI) &&
+          (Interface->InterfaceProtocol == USB_MASS_STORE_UAS)) {
+        InUasSetting        = TRUE;
+        UsbUas->UasSetting  = Interface->AlternateSetting;
+      }
+    } else if (!InUasSetting) {
+      continue;
+    } else if (Type == USB_DESC_TYPE_ENDPOINT) {
+      Endpoint = NULL;
+      if (Length >= sizeof (EFI_USB_ENDPOINT_DESCRIPTOR)) {
+        Endpoint = (EFI_USB_ENDPOINT_DESCRIPTOR *) (Buffer + Offset);
+      }
+    } else if (Type == USB_UAS_DESC_TYPE_SS_EP_COMPANION) {
+      StreamsRequired = TRUE;
+    } else if ((Type == USB_UAS_DESC_TYPE_PIPE_USAGE) &&
+               (Length >= sizeof (USB_UAS_PIPE_USAGE_DESCRIPTOR)) &&
+               (Endpoint != NULL)) {
+      PipeUsage = (USB_UAS_PIPE_USAGE_DESCRIPTOR *) (Buffer + Offset);
+
+      switch (PipeUsage->PipeId) {
+      case USB_UAS_PIPE_ID_COMMAND:
+        Pipe = &UsbUas->CommandEndpoint;
+        break;
+
+      case USB_UAS_PIPE_ID_STATUS:
+        Pipe = &UsbUas->StatusEndpoint;
+        break;
+
+      case USB_UAS_PIPE_ID_DATA_IN:
+        Pipe = &UsbUas->DataInEndpoint;
+        break;
+
+      case USB_UAS_PIPE_ID_DATA_OUT:
+        Pipe = &UsbUas->DataOutEndpoint;
+        break;
+
+      default:
+        Pipe = NULL;
+        break;
+      }
+
+      if (Pipe != NULL) {
+        CopyMem (Pipe, Endpoint, sizeof (EFI_USB_ENDPOINT_DESCRIPTOR));
+        PipeMask |= (UINT8) (1 << PipeUsage->PipeId);
+      }
+    }
+  }
+
+  FreePool (Buffer);
+
+  if (!InUasSetting) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (StreamsRequired) {
+    DEBUG ((EFI_D_INFO, "UsbUasFindSetting: UAS needs bulk streams, not supported\n"));
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // All four pipes must be bulk endpoints with the expected direction.
+  //
+  if ((PipeMask != (BIT1 | BIT2 | BIT3 | BIT4)) ||
+      !USB_IS_BULK_ENDPOINT (UsbUas->CommandEndpoint.Attributes) ||
+      !USB_IS_OUT_ENDPOINT (UsbUas->CommandEndpoint.EndpointAddress) ||
+      !USB_IS_BULK_ENDPOINT (UsbUas->StatusEndpoint.Attributes) ||
+      !USB_IS_IN_ENDPOINT (UsbUas->StatusEndpoint.EndpointAddress) ||
+      !USB_IS_BULK_ENDPOINT (UsbUas->DataInEndpoint.Attributes) ||
+      !USB_IS_IN_ENDPOINT (UsbUas->DataInEndpoint.EndpointAddress) ||
+      !USB_IS_BULK_ENDPOINT (UsbUas->DataOutEndpoint.Attributes) ||
+      !USB_IS_OUT_ENDPOINT (UsbUas->DataOutEndpoint.EndpointAddress)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Initializes USB UAS protocol.
+
+  This function looks for an alternate setting of the interface that
+  implements USB Attached SCSI and, when Context isn't NULL, selects it and
+  saves its context which is a USB_UAS_PROTOCOL structure in the Context.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The transport protocol doesn't support the device.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL       *UsbIo,
+  OUT VOID                      **Context OPTIONAL
+  )
+{
+  USB_UAS_PROTOCOL              *UsbUas;
+  EFI_STATUS                    Status;
+
+  UsbUas = AllocateZeroPool (sizeof (USB_UAS_PROTOCOL));
+  if (UsbUas == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  UsbUas->UsbIo = UsbIo;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &UsbUas->Interface);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (UsbUas->Interface.InterfaceClass != USB_MASS_STORE_CLASS) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_ERROR;
+  }
+
+  UsbUas->BaseSetting = UsbUas->Interface.AlternateSetting;
+
+  Status = UsbUasFindSetting (UsbUas);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Context == NULL) {
+    FreePool (UsbUas);
+    return EFI_SUCCESS;
+  }
+
+  //
+  // UAS devices usually expose Bulk-Only as the default alternate setting.
+  //
+  if (UsbUas->BaseSetting != UsbUas->UasSetting) {
+    Status = UsbUasSelectSetting (UsbUas, UsbUas->UasSetting);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  *Context = UsbUas;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  FreePool (UsbUas);
+  return Status;
+}
+
+/**
+  Send an information unit to the device using the command pipe.
+
+  @param  UsbUas                The USB UAS device
+  @param  Iu                    The information unit to send
+  @param  IuLen                 The length of the information unit
+
+  @retval EFI_SUCCESS           The information unit is sent to the device.
+  @retval EFI_NOT_READY         The device return NAK to the transfer
+  @retval Others                Failed to send the information unit
+
+**/
+EFI_STATUS
+UsbUasSendIu (
+  IN USB_UAS_PROTOCOL         *UsbUas,
+  IN VOID                     *Iu,
+  IN UINTN                    IuLen
+  )
+{
+  EFI_STATUS                Status;
+  UINT32                    Result;
+  UINTN                     Timeout;
+
+  Result  = 0;
+  Timeout = USB_UAS_SEND_IU_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            UsbUas->CommandEndpoint.EndpointAddress,
+                            Iu,
+                            &IuLen,
+                            Timeout,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+      UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->CommandEndpoint.EndpointAddress);
+    } else if (USB_IS_ERROR (Result, EFI_USB_ERR_NAK)) {
+      Status = EFI_NOT_READY;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Get the next information unit for a tag from the status pipe.
+
+  Information units carrying another tag are left over from an aborted
+  command and are dropped.
+
+  @param  UsbUas                The USB UAS device
+  @param  StatusIu              The buffer to hold the information unit
+  @param  Tag                   The tag of the expected information unit
+  @param  Timeout               The time to wait for the information unit
+
+  @retval EFI_SUCCESS           An information unit is received.
+  @retval Others                Failed to get an information unit.
+
+**/
+EFI_STATUS
+UsbUasGetStatusIu (
+  IN  USB_UAS_PROTOCOL      *UsbUas,
+  OUT USB_UAS_SENSE_IU      *StatusIu,
+  IN  UINT16                Tag,
+  IN  UINT32                Timeout
+  )
+{
+  EFI_STATUS                Status;
+  UINT32                    Result;
+  UINTN                     Len;
+  UINT32                    Index;
+
+  Status  = EFI_DEVICE_ERROR;
+  Timeout = Timeout / USB_MASS_1_MILLISECOND;
+
+  for (Index = 0; Index < USB_UAS_RECV_STATUS_RETRY; Index++) {
+    ZeroMem (StatusIu, sizeof (USB_UAS_SENSE_IU));
+    Result = 0;
+    Len    = sizeof (USB_UAS_SENSE_IU);
+    Status = UsbUas->UsbIo->UsbBulkTransfer (
+                              UsbUas->UsbIo,
+                              UsbUas->StatusEndpoint.EndpointAddress,
+                              StatusIu,
+                              &Len,
+                              Timeout,
+                              &Result
+                              );
+    if (EFI_ERROR (Status)) {
+      if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+        UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->StatusEndpoint.EndpointAddress);
+      }
+      return Status;
+    }
+
+    if ((Len >= sizeof (USB_UAS_READY_IU)) && (SwapBytes16 (StatusIu->Tag) == Tag)) {
+      return EFI_SUCCESS;
+    }
+
+    DEBUG ((EFI_D_INFO, "UsbUasGetStatusIu: drop IU 0x%x of tag 0x%x\n", StatusIu->IuId, SwapBytes16 (StatusIu->Tag)));
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  return Status;
+}
+
+/**
+  Transfer the data between the device and host using the data pipes.
+
+  @param  UsbUas                The USB UAS device
+  @param  DataDir               The direction of the data
+  @param  Data                  The buffer to hold data
+  @param  TransLen              The expected length of the data
+  @param  Timeout               The time to wait the command to complete
+
+  @retval EFI_SUCCESS           The data is transferred
+  @retval EFI_NOT_READY         The device return NAK to the transfer
+  @retval Others                Failed to transfer data
+
+**/
+EFI_STATUS
+UsbUasDataTransfer (
+  IN USB_UAS_PROTOCOL         *UsbUas,
+  IN EFI_USB_DATA_DIRECTION   DataDir,
+  IN OUT UINT8                *Data,
+  IN OUT UINTN                *TransLen,
+  IN UINT32                   Timeout
+  )
+{
+  EFI_USB_ENDPOINT_DESCRIPTOR *Endpoint;
+  EFI_STATUS                  Status;
+  UINT32                      Result;
+
+  if (DataDir == EfiUsbDataIn) {
+    Endpoint = &UsbUas->DataInEndpoint;
+  } else {
+    Endpoint = &UsbUas->DataOutEndpoint;
+  }
+
+  Result  = 0;
+  Timeout = Timeout / USB_MASS_1_MILLISECOND;
+
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            Endpoint->EndpointAddress,
+                            Data,
+                            TransLen,
+                            Timeout,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+      DEBUG ((EFI_D_INFO, "UsbUasDataTransfer: (%r) Stall\n", Status));
+      UsbClearEndpointStall (UsbUas->UsbIo, Endpoint->EndpointAddress);
+    } else if (USB_IS_ERROR (Result, EFI_USB_ERR_NAK)) {
+      Status = EFI_NOT_READY;
+    } else {
+      DEBUG ((EFI_D_ERROR, "UsbUasDataTransfer: (%r)\n", Status));
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Call the USB Mass Storage Class UAS protocol to issue
+  the command/data/status sequence to execute the commands.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  )
+{
+  USB_UAS_PROTOCOL          *UsbUas;
+  USB_UAS_COMMAND_IU        CommandIu;
+  USB_UAS_SENSE_IU          StatusIu;
+  EFI_STATUS                Status;
+  UINTN                     TransLen;
+  UINT8                     ReadyIuId;
+
+  ASSERT ((CmdLen > 0) && (CmdLen <= USB_UAS_MAX_CMDLEN));
+
+  *CmdStatus  = USB_MASS_CMD_FAIL;
+  UsbUas      = (USB_UAS_PROTOCOL *) Context;
+
+  //
+  // The device reports the sense data in the Sense IU of the failing command
+  // and doesn't keep it, so complete the following REQUEST SENSE from the
+  // saved copy.
+  //
+  if ((*(UINT8 *) Cmd == USB_BOOT_REQUEST_SENSE_OPCODE) &&
+      (DataDir == EfiUsbDataIn) && (UsbUas->SenseLength != 0)) {
+    ZeroMem (Data, DataLen);
+    CopyMem (Data, UsbUas->SenseData, MIN (DataLen, UsbUas->SenseLength));
+    UsbUas->SenseLength = 0;
+    *CmdStatus          = USB_MASS_CMD_SUCCESS;
+    return EFI_SUCCESS;
+  }
+
+  UsbUas->SenseLength = 0;
+
+  //
+  // Send the Command IU. Return immediately if device rejects it.
+  //
+  ZeroMem (&CommandIu, sizeof (USB_UAS_COMMAND_IU));
+  CommandIu.IuId   = USB_UAS_IU_ID_COMMAND;
+  CommandIu.Tag    = SwapBytes16 (USB_UAS_COMMAND_TAG);
+  CommandIu.Lun[1] = Lun;
+  CopyMem (CommandIu.Cdb, Cmd, CmdLen);
+
+  Status = UsbUasSendIu (UsbUas, &CommandIu, sizeof (USB_UAS_COMMAND_IU));
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "UsbUasExecCommand: UsbUasSendIu (%r)\n", Status));
+    return Status;
+  }
+
+  //
+  // Without streams the device asks for the data phase on the status pipe.
+  // It may also complete the command right away with a Sense IU.
+  //
+  Status = UsbUasGetStatusIu (UsbUas, &StatusIu, USB_UAS_COMMAND_TAG, Timeout);
+  if (!EFI_ERROR (Status) && (DataDir != EfiUsbNoData) && (DataLen != 0) &&
+      (StatusIu.IuId != USB_UAS_IU_ID_SENSE)) {
+    ReadyIuId = (UINT8) ((DataDir == EfiUsbDataIn) ? USB_UAS_IU_ID_READ_READY : USB_UAS_IU_ID_WRITE_READY);
+    if (StatusIu.IuId != ReadyIuId) {
+      DEBUG ((EFI_D_ERROR, "UsbUasExecCommand: unexpected IU 0x%x for data phase\n", StatusIu.IuId));
+      return EFI_DEVICE_ERROR;
+    }
+
+    //
+    // Don't return immediately even if data transfer failed. The device
+    // still reports the command status on the status pipe.
+    //
+    TransLen = (UINTN) DataLen;
+    Status   = UsbUasDataTransfer (UsbUas, DataDir, Data, &TransLen, Timeout);
+    if (Status == EFI_TIMEOUT) {
+      UsbUasResetDevice (UsbUas, FALSE);
+      return Status;
+    }
+
+    Status = UsbUasGetStatusIu (UsbUas, &StatusIu, USB_UAS_COMMAND_TAG, USB_UAS_RECV_STATUS_TIMEOUT);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "UsbUasExecCommand: UsbUasGetStatusIu (%r)\n", Status));
+    return Status;
+  }
+
+  if (StatusIu.IuId != USB_UAS_IU_ID_SENSE) {
+    DEBUG ((EFI_D_ERROR, "UsbUasExecCommand: unexpected IU 0x%x for status\n", StatusIu.IuId));
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (StatusIu.Status == USB_UAS_STATUS_GOOD) {
+    *CmdStatus = USB_MASS_CMD_SUCCESS;
+  } else {
+    UsbUas->SenseLength = MIN (SwapBytes16 (StatusIu.Length), USB_UAS_MAX_SENSE_LEN);
+    CopyMem (UsbUas->SenseData, StatusIu.SenseData, UsbUas->SenseLength);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue an I_T NEXUS RESET task
+                                management function.
+                                If TRUE, additionally reset parent hub port.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID                    *Context,
+  IN  BOOLEAN                 ExtendedVerification
+  )
+{
+  USB_UAS_PROTOCOL        *UsbUas;
+  USB_UAS_TASK_MGMT_IU    TaskMgmtIu;
+  USB_UAS_SENSE_IU        StatusIu;
+  USB_UAS_RESPONSE_IU     *ResponseIu;
+  EFI_STATUS              Status;
+
+  UsbUas = (USB_UAS_PROTOCOL *) Context;
+
+  if (ExtendedVerification) {
+    //
+    // If we need to do strictly reset, reset its parent hub port. The port
+    // reset brings the interface back to its default alternate setting.
+    //
+    Status = UsbUas->UsbIo->UsbPortReset (UsbUas->UsbIo);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    Status = UsbUasSelectSetting (UsbUas, UsbUas->UasSetting);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  UsbUas->SenseLength = 0;
+
+  //
+  // Clear the stall condition of all the pipes.
+  //
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->CommandEndpoint.EndpointAddress);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->StatusEndpoint.EndpointAddress);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataInEndpoint.EndpointAddress);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataOutEndpoint.EndpointAddress);
+
+  //
+  // UAS has no class specific reset request. Abort whatever the device is
+  // still doing with an I_T NEXUS RESET task management function.
+  //
+  ZeroMem (&TaskMgmtIu, sizeof (USB_UAS_TASK_MGMT_IU));
+  TaskMgmtIu.IuId     = USB_UAS_IU_ID_TASK_MGMT;
+  TaskMgmtIu.Tag      = SwapBytes16 (USB_UAS_TASK_MGMT_TAG);
+  TaskMgmtIu.Function = USB_UAS_TMF_I_T_NEXUS_RESET;
+
+  Status = UsbUasSendIu (UsbUas, &TaskMgmtIu, sizeof (USB_UAS_TASK_MGMT_IU));
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Status = UsbUasGetStatusIu (UsbUas, &StatusIu, USB_UAS_TASK_MGMT_TAG, USB_UAS_GENERAL_TIMEOUT);
+  if (EFI_ERROR (Status) || (StatusIu.IuId != USB_UAS_IU_ID_RESPONSE)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  ResponseIu = (USB_UAS_RESPONSE_IU *) &StatusIu;
+  if ((ResponseIu->ResponseCode != USB_UAS_RC_TMF_COMPLETE) &&
+      (ResponseIu->ResponseCode != USB_UAS_RC_TMF_SUCCEEDED)) {
+    DEBUG ((EFI_D_ERROR, "UsbUasResetDevice: response code 0x%x\n", ResponseIu->ResponseCode));
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  The interface is returned to the alternate setting it had before the UAS
+  one was selected.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID                    *Context
+  )
+{
+  USB_UAS_PROTOCOL        *UsbUas;
+
+  UsbUas = (USB_UAS_PROTOCOL *) Context;
+
+  if (UsbUas->BaseSetting != UsbUas->UasSetting) {
+    UsbUasSelectSetting (UsbUas, UsbUas->BaseSetting);
+  }
+
+  FreePool (UsbUas);
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,251 @@
+/** @file
+  Definition for the USB Attached SCSI (UAS) transport,
+  based on the "Universal Serial Bus Mass Storage Class USB Attached SCSI
+  Protocol (UASP)" Revision 1.0, June 24, 2009.
+
+Copyright (c) Microsoft Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _EFI_USBMASS_UAS_H_
+#define _EFI_USBMASS_UAS_H_
+
+extern USB_MASS_TRANSPORT mUsbUasTransport;
+
+#define USB_MASS_STORE_UAS          0x62 ///< USB Attached SCSI
+
+//
+// Pipe Usage class specific descriptor and the pipe IDs it carries
+//
+#define USB_UAS_DESC_TYPE_PIPE_USAGE      0x24
+#define USB_UAS_DESC_TYPE_SS_EP_COMPANION 0x30
+#define USB_UAS_PIPE_ID_COMMAND           0x01
+#define USB_UAS_PIPE_ID_STATUS            0x02
+#define USB_UAS_PIPE_ID_DATA_IN           0x03
+#define USB_UAS_PIPE_ID_DATA_OUT          0x04
+
+//
+// Information Unit IDs
+//
+#define USB_UAS_IU_ID_COMMAND       0x01
+#define USB_UAS_IU_ID_SENSE         0x03
+#define USB_UAS_IU_ID_RESPONSE      0x04
+#define USB_UAS_IU_ID_TASK_MGMT     0x05
+#define USB_UAS_IU_ID_READ_READY    0x06
+#define USB_UAS_IU_ID_WRITE_READY   0x07
+
+//
+// Task management function, SCSI status and response codes used by the driver
+//
+#define USB_UAS_TMF_I_T_NEXUS_RESET 0x10
+#define USB_UAS_STATUS_GOOD         0x00
+#define USB_UAS_RC_TMF_COMPLETE     0x00
+#define USB_UAS_RC_TMF_SUCCEEDED    0x08
+
+//
+// Only one command is outstanding at a time, so fixed tags are used for
+// commands and task management functions.
+//
+#define USB_UAS_COMMAND_TAG         0x0001
+#define USB_UAS_TASK_MGMT_TAG       0x0002
+
+#define USB_UAS_MAX_CMDLEN          16
+#define USB_UAS_MAX_SENSE_LEN       252
+#define USB_UAS_MAX_CONFIG_LEN      0x1000
+
+//
+// Usb UAS retry to get a status IU with the expected tag, set by experience
+//
+#define USB_UAS_RECV_STATUS_RETRY   3
+
+//
+// Usb UAS transport timeout, set by experience
+//
+#define USB_UAS_SEND_IU_TIMEOUT     (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RECV_STATUS_TIMEOUT (3 * USB_MASS_1_SECOND)
+#define USB_UAS_GENERAL_TIMEOUT     (3 * USB_MASS_1_SECOND)
+
+#pragma pack(1)
+///
+/// Pipe Usage descriptor, follows each endpoint descriptor of a UAS interface.
+///
+typedef struct {
+  UINT8               Length;
+  UINT8               DescriptorType;
+  UINT8               PipeId;
+  UINT8               Reserved;
+} USB_UAS_PIPE_USAGE_DESCRIPTOR;
+
+///
+/// Command IU, sent on the command pipe.
+///
+typedef struct {
+  UINT8               IuId;
+  UINT8               Reserved0;
+  UINT16              Tag;              ///< Big endian
+  UINT8               TaskAttribute;    ///< Bits 0~2, 0 ~ SIMPLE
+  UINT8               Reserved1;
+  UINT8               AddCdbLength;     ///< Bits 2~7, in dwords
+  UINT8               Reserved2;
+  UINT8               Lun[8];
+  UINT8               Cdb[USB_UAS_MAX_CMDLEN];
+} USB_UAS_COMMAND_IU;
+
+///
+/// Task Management IU, sent on the command pipe.
+///
+typedef struct {
+  UINT8               IuId;
+  UINT8               Reserved0;
+  UINT16              Tag;              ///< Big endian
+  UINT8               Function;
+  UINT8               Reserved1;
+  UINT16              TaskTag;          ///< Big endian
+  UINT8               Lun[8];
+} USB_UAS_TASK_MGMT_IU;
+
+///
+/// Sense IU, returned on the status pipe when a command completes.
+///
+typedef struct {
+  UINT8               IuId;
+  UINT8               Reserved0;
+  UINT16              Tag;              ///< Big endian
+  UINT16              StatusQualifier;  ///< Big endian
+  UINT8               Status;
+  UINT8               Reserved1[7];
+  UINT16              Length;           ///< Big endian, length of SenseData
+  UINT8               SenseData[USB_UAS_MAX_SENSE_LEN];
+} USB_UAS_SENSE_IU;
+
+///
+/// Response IU, returned on the status pipe for task management functions
+/// and for commands the device could not accept.
+///
+typedef struct {
+  UINT8               IuId;
+  UINT8               Reserved0;
+  UINT16              Tag;              ///< Big endian
+  UINT8               AdditionalInfo[3];
+  UINT8               ResponseCode;
+} USB_UAS_RESPONSE_IU;
+
+///
+/// READ READY and WRITE READY IUs, returned on the status pipe before the
+/// data phase when the device operates without bulk streams.
+///
+typedef struct {
+  UINT8               IuId;
+  UINT8               Reserved0;
+  UINT16              Tag;              ///< Big endian
+} USB_UAS_READY_IU;
+#pragma pack()
+
+typedef struct {
+  //
+  // Put Interface at the first field to make it easy to distinguish BOT/CBI/UAS Protocol instance
+  //
+  EFI_USB_INTERFACE_DESCRIPTOR  Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR   CommandEndpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR   StatusEndpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR   DataInEndpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR   DataOutEndpoint;
+  UINT8                         UasSetting;     ///< Alternate setting implementing UAS
+  UINT8                         BaseSetting;    ///< Alternate setting active before UAS was selected
+  //
+  // Sense data returned by the last failing command. The next REQUEST SENSE
+  // command is completed from it, since the device discards its sense data
+  // once it has reported it in the Sense IU.
+  //
+  UINT8                         SenseData[USB_UAS_MAX_SENSE_LEN];
+  UINT16                        SenseLength;
+  EFI_USB_IO_PROTOCOL           *UsbIo;
+} USB_UAS_PROTOCOL;
+
+/**
+  Initializes USB UAS protocol.
+
+  This function looks for an alternate setting of the interface that
+  implements USB Attached SCSI and, when Context isn't NULL, selects it and
+  saves its context which is a USB_UAS_PROTOCOL structure in the Context.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The transport protocol doesn't support the device.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL       *UsbIo,
+  OUT VOID                      **Context OPTIONAL
+  );
+
+/**
+  Call the USB Mass Storage Class UAS protocol to issue
+  the command/data/status sequence to execute the commands.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  );
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue an I_T NEXUS RESET task
+                                management function.
+                                If TRUE, additionally reset parent hub port.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID                    *Context,
+  IN  BOOLEAN                 ExtendedVerification
+  );
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID                    *Context
+  );
+
+#endif
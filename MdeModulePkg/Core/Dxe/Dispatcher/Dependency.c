@@ -213,6 +213,8 @@ CoreIsSchedulable (
   BOOLEAN     Operator2;
   EFI_GUID    DriverGuid;
   VOID        *Interface;
+  BOOLEAN     AndOnly;
+  UINT8       *BlockingGuid;
 
   Operator = FALSE;
   Operator2 = FALSE;
@@ -241,12 +243,34 @@ CoreIsSchedulable (
     return TRUE;
   }
 
+  //
+  // If the last evaluation found a protocol whose absence alone makes the
+  // Depex FALSE, there is no need to evaluate the whole Depex again until
+  // that protocol has been installed.
+  //
+  if (DriverEntry->DepexBlockingGuid != NULL) {
+    CopyMem (&DriverGuid, DriverEntry->DepexBlockingGuid, sizeof (EFI_GUID));
+    Status = CoreLocateProtocol (&DriverGuid, NULL, &Interface);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_DISPATCH, "  PUSH GUID(%g) = FALSE\n", &DriverGuid));
+      DEBUG ((DEBUG_DISPATCH, "  RESULT = FALSE (Still blocked)\n"));
+      return FALSE;
+    }
+    DriverEntry->DepexBlockingGuid = NULL;
+  }
+
   //
   // Clean out memory leaks in Depex Boolean stack. Leaks are only caused by
   // incorrectly formed DEPEX expressions
   //
   mDepexEvaluationStackPointer = mDepexEvaluationStack;
 
+  //
+  // Track whether the Depex only ANDs protocols together, and the first
+  // protocol that is missing in that case.
+  //
+  AndOnly      = TRUE;
+  BlockingGuid = NULL;
 
   Iterator = DriverEntry->Depex;
 
@@ -301,6 +325,9 @@ CoreIsSchedulable (
 
       if (EFI_ERROR (Status)) {
         DEBUG ((DEBUG_DISPATCH, "  PUSH GUID(%g) = FALSE\n", &DriverGuid));
+        if (BlockingGuid == NULL) {
+          BlockingGuid = Iterator + 1;
+        }
         Status = PushBool (FALSE);
       } else {
         DEBUG ((DEBUG_DISPATCH, "  PUSH GUID(%g) = TRUE\n", &DriverGuid));
@@ -338,6 +365,7 @@ CoreIsSchedulable (
 
     case EFI_DEP_OR:
       DEBUG ((DEBUG_DISPATCH, "  OR\n"));
+      AndOnly = FALSE;
       Status = PopBool (&Operator);
       if (EFI_ERROR (Status)) {
         DEBUG ((DEBUG_DISPATCH, "  RESULT = FALSE (Unexpected error)\n"));
@@ -359,6 +387,7 @@ CoreIsSchedulable (
 
     case EFI_DEP_NOT:
       DEBUG ((DEBUG_DISPATCH, "  NOT\n"));
+      AndOnly = FALSE;
       Status = PopBool (&Operator);
       if (EFI_ERROR (Status)) {
         DEBUG ((DEBUG_DISPATCH, "  RESULT = FALSE (Unexpected error)\n"));
@@ -398,6 +427,9 @@ CoreIsSchedulable (
         return FALSE;
       }
       DEBUG ((DEBUG_DISPATCH, "  RESULT = %a\n", Operator ? "TRUE" : "FALSE"));
+      if (!Operator && AndOnly) {
+        DriverEntry->DepexBlockingGuid = BlockingGuid;
+      }
       return Operator;
 
     case EFI_DEP_REPLACE_TRUE:
@@ -246,6 +246,7 @@ CoreGetDepexSectionAndPreProccess (
 
 
   Fv = DriverEntry->Fv;
+  DriverEntry->DepexBlockingGuid = NULL;
 
   //
   // Grab Depex info, it will never be free'ed.
@@ -998,6 +999,112 @@ GetFvUsedSize (
   return FALSE;
 }
 
+/**
+  Read one firmware volume image section of a file. When the volume requires
+  an alignment that pool memory does not provide, the section is read straight
+  into pages of that alignment. The caller then does not need to read the
+  whole (possibly decompressed) volume into pool and copy it a second time.
+
+  @param  Fv                    The FIRMWARE_VOLUME protocol installed on the FV.
+  @param  FileName              The file name guid specified.
+  @param  Index                 Instance of the firmware volume image section.
+  @param  Buffer                Returns the pool buffer holding the section, or
+                                NULL if AlignedBuffer was used.
+  @param  AlignedBuffer         Returns the aligned pages holding the section, or
+                                NULL if Buffer was used.
+  @param  BufferSize            Returns the size of the section.
+  @param  AuthenticationStatus  Returns the authentication status of the section.
+
+  @retval EFI_SUCCESS           The section was read.
+  @retval EFI_OUT_OF_RESOURCES  No enough memory.
+  @retval Others                The section could not be read.
+
+**/
+EFI_STATUS
+CoreReadFvImageSection (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL   *Fv,
+  IN  EFI_GUID                        *FileName,
+  IN  UINTN                           Index,
+  OUT VOID                            **Buffer,
+  OUT VOID                            **AlignedBuffer,
+  OUT UINTN                           *BufferSize,
+  OUT UINT32                          *AuthenticationStatus
+  )
+{
+  EFI_STATUS                          Status;
+  EFI_FIRMWARE_VOLUME_HEADER          FvHeader;
+  VOID                                *HeaderBuffer;
+  UINTN                               HeaderSize;
+  UINT32                              FvAlignment;
+
+  *Buffer        = NULL;
+  *AlignedBuffer = NULL;
+  *BufferSize    = 0;
+
+  //
+  // Read just the volume header first. The section stream keeps the extracted
+  // data of the file, so this neither decompresses twice nor copies the whole
+  // volume, but it tells the size and alignment of the volume.
+  //
+  HeaderBuffer = &FvHeader;
+  HeaderSize   = sizeof (FvHeader);
+  Status = Fv->ReadSection (
+                 Fv,
+                 FileName,
+                 EFI_SECTION_FIRMWARE_VOLUME_IMAGE,
+                 Index,
+                 &HeaderBuffer,
+                 &HeaderSize,
+                 AuthenticationStatus
+                 );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Status == EFI_WARN_BUFFER_TOO_SMALL) &&
+      ((FvHeader.Attributes & EFI_FVB2_WEAK_ALIGNMENT) != EFI_FVB2_WEAK_ALIGNMENT)) {
+    FvAlignment = 1 << ((FvHeader.Attributes & EFI_FVB2_ALIGNMENT) >> 16);
+    if (FvAlignment > 8) {
+      *AlignedBuffer = AllocateAlignedPages (EFI_SIZE_TO_PAGES (HeaderSize), (UINTN) FvAlignment);
+      if (*AlignedBuffer == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      *BufferSize = HeaderSize;
+      Status = Fv->ReadSection (
+                     Fv,
+                     FileName,
+                     EFI_SECTION_FIRMWARE_VOLUME_IMAGE,
+                     Index,
+                     AlignedBuffer,
+                     BufferSize,
+                     AuthenticationStatus
+                     );
+      if (Status != EFI_SUCCESS) {
+        FreeAlignedPages (*AlignedBuffer, EFI_SIZE_TO_PAGES (HeaderSize));
+        *AlignedBuffer = NULL;
+        *BufferSize    = 0;
+        return EFI_ERROR (Status) ? Status : EFI_VOLUME_CORRUPTED;
+      }
+      return EFI_SUCCESS;
+    }
+  }
+
+  //
+  // Pool alignment is good enough, let ReadSection allocate the buffer.
+  //
+  return Fv->ReadSection (
+               Fv,
+               FileName,
+               EFI_SECTION_FIRMWARE_VOLUME_IMAGE,
+               Index,
+               Buffer,
+               BufferSize,
+               AuthenticationStatus
+               );
+}
+
+
 /**
   Get Fv image(s) from the FV through file name, and produce FVB protocol for every Fv image(s).
 
@@ -1017,7 +1124,6 @@ CoreProcessFvImageFile (
   )
 {
   EFI_STATUS                          Status;
-  EFI_SECTION_TYPE                    SectionType;
   UINT32                              AuthenticationStatus;
   VOID                                *Buffer;
   VOID                                *AlignedBuffer;
@@ -1032,24 +1138,19 @@ CoreProcessFvImageFile (
   //
   // Read firmware volume section(s)
   //
-  SectionType   = EFI_SECTION_FIRMWARE_VOLUME_IMAGE;
-
   Index = 0;
   do {
     FvHeader      = NULL;
     FvAlignment   = 0;
-    Buffer        = NULL;
-    BufferSize    = 0;
-    AlignedBuffer = NULL;
-    Status = Fv->ReadSection (
-                   Fv,
-                   FileName,
-                   SectionType,
-                   Index,
-                   &Buffer,
-                   &BufferSize,
-                   &AuthenticationStatus
-                   );
+    Status = CoreReadFvImageSection (
+               Fv,
+               FileName,
+               Index,
+               &Buffer,
+               &AlignedBuffer,
+               &BufferSize,
+               &AuthenticationStatus
+               );
     if (!EFI_ERROR (Status)) {
        //
       // Evaluate the authentication status of the Firmware Volume through
@@ -1073,6 +1174,9 @@ CoreProcessFvImageFile (
           if (Buffer != NULL) {
             FreePool (Buffer);
           }
+          if (AlignedBuffer != NULL) {
+            FreeAlignedPages (AlignedBuffer, EFI_SIZE_TO_PAGES (BufferSize));
+          }
           break;
         }
       }
@@ -1080,7 +1184,7 @@ CoreProcessFvImageFile (
       //
       // FvImage should be at its required alignment.
       //
-      FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *) Buffer;
+      FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *) ((AlignedBuffer != NULL) ? AlignedBuffer : Buffer);
       //
       // If EFI_FVB2_WEAK_ALIGNMENT is set in the volume header then the first byte of the volume
       // can be aligned on any power-of-two boundary. A weakly aligned volume can not be moved from
@@ -48,10 +48,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/SmmBase2.h>
 #include <Protocol/PeCoffImageEmulator.h>
+#include <Protocol/MemoryProximity.h>  // MU_CHANGE
+#include <Protocol/TicklessTimer.h>    // MU_CHANGE
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/HobList.h>
+#include <Guid/GuidHobIndex.h>        // MU_CHANGE
+#include <Guid/MemoryProximityHob.h>   // MU_CHANGE
+#include <Guid/FvFileIndex.h>          // MU_CHANGE
 #include <Guid/DebugImageInfoTable.h>
 #include <Guid/FileInfo.h>
 #include <Guid/Apriori.h>
@@ -152,6 +157,11 @@ typedef struct {
 
   VOID                            *Depex;
   UINTN                           DepexSize;
+  ///
+  /// GUID inside Depex whose absence made the last evaluation of an AND-only
+  /// Depex FALSE. The Depex cannot become TRUE until it is installed.
+  ///
+  VOID                            *DepexBlockingGuid;
 
   BOOLEAN                         Before;
   BOOLEAN                         After;
@@ -187,6 +197,44 @@ typedef struct {
 } EFI_GCD_MAP_ENTRY;
 
 
+// MU_CHANGE [BEGIN] - Boot cost accounting of the images
+typedef enum {
+  ImageBootCostEntryPoint,
+  ImageBootCostSupported,
+  ImageBootCostStart,
+  ImageBootCostNotify
+} IMAGE_BOOT_COST_TYPE;
+
+///
+/// Phases of the load of an image.
+///
+typedef enum {
+  ImageLoadPhaseLocate,       ///< Find the device the image is loaded from.
+  ImageLoadPhaseRead,         ///< Read the image file.
+  ImageLoadPhaseDecompress,   ///< Extract the image from encapsulation sections.
+  ImageLoadPhaseAuthenticate, ///< Security handlers, that verify and measure the image.
+  ImageLoadPhaseLoad,         ///< Copy the headers and sections to the image pages.
+  ImageLoadPhaseRelocate,
+  ImageLoadPhaseProtect,      ///< Apply the memory protection of the image.
+  ImageLoadPhaseMax
+} IMAGE_LOAD_PHASE;
+
+///
+/// Time spent in an image, in performance counter ticks.
+///
+typedef struct {
+  LIST_ENTRY                  Link;
+  UINT64                      EntryPointTicks;
+  UINT64                      SupportedTicks;
+  UINT64                      StartTicks;
+  UINT64                      NotifyTicks;
+  UINT64                      LoadPhaseTicks[ImageLoadPhaseMax];
+  UINT32                      SupportedCount;
+  UINT32                      StartCount;
+  UINT32                      NotifyCount;
+} IMAGE_BOOT_COST;
+// MU_CHANGE [END]
+
 #define LOADED_IMAGE_PRIVATE_DATA_SIGNATURE   SIGNATURE_32('l','d','r','i')
 
 typedef struct {
@@ -231,6 +279,8 @@ typedef struct {
   PE_COFF_LOADER_IMAGE_CONTEXT  ImageContext;
   /// Status returned by LoadImage() service.
   EFI_STATUS                  LoadImageStatus;
+  /// Boot cost of the image          // MU_CHANGE
+  IMAGE_BOOT_COST             BootCost; // MU_CHANGE
 } LOADED_IMAGE_PRIVATE_DATA;
 
 #define LOADED_IMAGE_PRIVATE_DATA_FROM_THIS(a) \
@@ -278,6 +328,7 @@ extern EFI_SECURITY_ARCH_PROTOCOL               *gSecurity;
 extern EFI_SECURITY2_ARCH_PROTOCOL              *gSecurity2;
 extern EFI_BDS_ARCH_PROTOCOL                    *gBds;
 extern EFI_SMM_BASE2_PROTOCOL                   *gSmmBase2;
+extern EDKII_TICKLESS_TIMER_PROTOCOL            *gTicklessTimer;        // MU_CHANGE
 
 extern volatile EFI_TPL                         gEfiCurrentTpl;         // MS_CHANGE
 
@@ -459,6 +510,22 @@ CalculateEfiHdrCrc (
   IN  OUT EFI_TABLE_HEADER    *Hdr
   );
 
+// MU_CHANGE [BEGIN] - Publish an index of the GUID HOBs.
+/**
+  Build an index over the GUID extension HOBs of the HOB list and install it
+  into the EFI System Configuration Table.
+
+  The HOB list must not get new GUID extension HOBs after this call.
+
+  @param  HobStart               Pointer to the start of the HOB list.
+
+**/
+VOID
+CoreInstallGuidHobIndexTable (
+  IN  VOID                    *HobStart
+  );
+// MU_CHANGE [END]
+
 
 /**
   Called by the platform code to process a tick.
@@ -473,6 +540,20 @@ CoreTimerTick (
   IN UINT64   Duration
   );
 
+// MU_CHANGE [BEGIN] - Tickless timer support
+/**
+  Report the earliest pending timer event to the tickless timer driver.
+
+  Called when the EDKII_TICKLESS_TIMER_PROTOCOL is installed, so that timer
+  events queued before it was available are programmed.
+
+**/
+VOID
+CoreUpdateTicklessTimer (
+  VOID
+  );
+// MU_CHANGE [END]
+
 
 /**
   Initialize the dispatcher. Initialize the notification function that runs when
@@ -1362,6 +1443,32 @@ CoreInternalAllocatePool (
   OUT VOID            **Buffer
   );
 
+// MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+/**
+  Allocate and clear pool of a particular type.
+
+  Large allocations of EfiBootServicesData are taken from the zeroed page
+  cache when it has pages available, and are not cleared again.
+
+  @param  PoolType               Type of pool to allocate
+  @param  Size                   The amount of pool to allocate
+  @param  Buffer                 The address to return a pointer to the allocated
+                                 pool
+
+  @retval EFI_INVALID_PARAMETER  PoolType not valid or Buffer is NULL
+  @retval EFI_OUT_OF_RESOURCES   Size exceeds max pool size or allocation failed.
+  @retval EFI_SUCCESS            Pool successfully allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreAllocateZeroPool (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            Size,
+  OUT VOID            **Buffer
+  );
+// MU_CHANGE [END]
+
 /**
   Frees pool.
 
@@ -2725,6 +2832,140 @@ MemoryProfileInit (
   IN VOID   *HobStart
   );
 
+// MU_CHANGE [BEGIN] - Proximity domain hint for page allocations
+/**
+  Read the memory proximity HOB and install the Memory Proximity Protocol.
+
+  Nothing is installed when the platform did not produce the HOB.
+
+  @param  HobStart               The start address of the HOB list.
+
+**/
+VOID
+CoreInitializeMemoryProximity (
+  IN VOID  *HobStart
+  );
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Boot cost accounting of the images
+/**
+  Start the boot cost accounting of the images, if performance measurement is
+  enabled.
+
+**/
+VOID
+CoreInitializeImageBootCost (
+  VOID
+  );
+
+/**
+  Start timing a call into an image.
+
+  @return The current value of the performance counter, or 0 when the boot
+          cost is not accounted.
+
+**/
+UINT64
+CoreImageBootCostBegin (
+  VOID
+  );
+
+/**
+  Account the time of a call into an image.
+
+  @param  Image                  The image called, or NULL if unknown.
+  @param  Type                   The kind of call.
+  @param  Begin                  The value returned by CoreImageBootCostBegin()
+                                 before the call.
+
+**/
+VOID
+CoreImageBootCostEnd (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image,
+  IN IMAGE_BOOT_COST_TYPE       Type,
+  IN UINT64                     Begin
+  );
+
+/**
+  Account the time of a phase of the load of an image.
+
+  @param  Ticks                  The ticks of the phase, updated.
+  @param  Begin                  The value returned by CoreImageBootCostBegin()
+                                 before the phase.
+
+**/
+VOID
+CoreImageLoadPhaseEnd (
+  IN OUT UINT64  *Ticks,
+  IN     UINT64  Begin
+  );
+
+/**
+  Add a loaded image to the images whose boot cost is accounted.
+
+  @param  Image                  The image.
+
+**/
+VOID
+CoreImageBootCostRegisterImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  );
+
+/**
+  Remove an image that is unloaded from the images whose boot cost is
+  accounted. Its cost is lost.
+
+  @param  Image                  The image.
+
+**/
+VOID
+CoreImageBootCostUnregisterImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  );
+
+/**
+  Find the image an address, such as the one of an event notification
+  function, belongs to.
+
+  @param  Address                The address.
+
+  @return The image, or NULL if the address isn't in a loaded image or the boot
+          cost is not accounted.
+
+**/
+LOADED_IMAGE_PRIVATE_DATA *
+CoreImageBootCostFindImage (
+  IN VOID  *Address
+  );
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Timing of the event notification functions and of raised TPL
+/**
+  Start the timing of the notification functions and of the time spent at
+  raised TPL, as configured by PcdDxeNotifyTimingThreshold and
+  PcdDxeRaisedTplTimingThreshold.
+
+**/
+VOID
+CoreInitializeNotifyTiming (
+  VOID
+  );
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+/**
+  Set up the zeroed page cache.
+
+  The cache is filled from the idle loop. Nothing is done when
+  PcdDxeZeroedPageCacheSize is 0.
+
+**/
+VOID
+CoreInitializeZeroedPageCache (
+  VOID
+  );
+// MU_CHANGE [END]
+
 /**
   Install memory profile protocol.
 
@@ -29,6 +29,7 @@ EFI_WATCHDOG_TIMER_ARCH_PROTOCOL  *gWatchdogTimer = NULL;
 // DXE Core globals for optional protocol dependencies
 //
 EFI_SMM_BASE2_PROTOCOL            *gSmmBase2      = NULL;
+EDKII_TICKLESS_TIMER_PROTOCOL     *gTicklessTimer = NULL;    // MU_CHANGE
 
 //
 // DXE Core Global used to update core loaded image protocol handle
@@ -326,6 +327,11 @@ DxeMain (
   Status = CoreInstallConfigurationTable (&gEfiHobListGuid, HobStart);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Install the index of the GUID HOBs into the EFI System Tables's Configuration Table
+  //
+  CoreInstallGuidHobIndexTable (HobStart);  // MU_CHANGE
+
   //
   // Install Memory Type Information Table into the EFI System Tables's Configuration Table
   //
@@ -426,6 +432,10 @@ DxeMain (
 
   CoreInitializeMemoryAttributesTable ();
   CoreInitializeMemoryProtection ();
+  CoreInitializeMemoryProximity (HobStart);   // MU_CHANGE
+  CoreInitializeZeroedPageCache ();           // MU_CHANGE
+  CoreInitializeImageBootCost ();             // MU_CHANGE
+  CoreInitializeNotifyTiming ();              // MU_CHANGE
 
   //
   // Get persisted vector hand-off info from GUIDeed HOB again due to HobStart may be updated,
@@ -721,6 +731,92 @@ CalculateEfiHdrCrc (
   Hdr->CRC32 = Crc;
 }
 
+// MU_CHANGE [BEGIN] - Publish an index of the GUID HOBs.
+/**
+  Build an index over the GUID extension HOBs of the HOB list and install it
+  into the EFI System Configuration Table.
+
+  The HOB list must not get new GUID extension HOBs after this call.
+
+  @param  HobStart               Pointer to the start of the HOB list.
+
+**/
+VOID
+CoreInstallGuidHobIndexTable (
+  IN  VOID                    *HobStart
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PEI_HOB_POINTERS  Hob;
+  UINT32                EntryCount;
+  UINT32                BucketCount;
+  UINT32                Index;
+  UINT32                Bucket;
+  GUID_HOB_INDEX_TABLE  *Table;
+  GUID_HOB_INDEX_ENTRY  *Entries;
+  UINT32                *Buckets;
+
+  EntryCount = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      EntryCount++;
+    }
+  }
+
+  //
+  // Use about two entries per bucket.
+  //
+  BucketCount = 1;
+  while ((BucketCount < MAX_UINT16) && (BucketCount * 2 < EntryCount)) {
+    BucketCount <<= 1;
+  }
+
+  Table = AllocatePool (
+            sizeof (GUID_HOB_INDEX_TABLE) +
+            EntryCount * sizeof (GUID_HOB_INDEX_ENTRY) +
+            BucketCount * sizeof (UINT32)
+            );
+  if (Table == NULL) {
+    return;
+  }
+
+  Table->Revision    = GUID_HOB_INDEX_TABLE_REVISION;
+  Table->BucketCount = BucketCount;
+  Table->EntryCount  = EntryCount;
+  Table->Reserved    = 0;
+  Table->HobList     = HobStart;
+  Entries            = GUID_HOB_INDEX_ENTRIES (Table);
+  Buckets            = GUID_HOB_INDEX_BUCKETS (Table);
+
+  Index = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Entries[Index].Hob      = Hob.Guid;
+      Entries[Index].Reserved = 0;
+      Index++;
+    }
+  }
+  Table->HobListEnd = Hob.Raw;
+
+  //
+  // Link the entries from the last to the first, so every bucket chain is in
+  // HOB list order.
+  //
+  SetMem32 (Buckets, BucketCount * sizeof (UINT32), GUID_HOB_INDEX_NONE);
+  for (Index = EntryCount; Index > 0; Index--) {
+    Bucket = GUID_HOB_INDEX_BUCKET (Table, &Entries[Index - 1].Hob->Name);
+    Entries[Index - 1].Next = Buckets[Bucket];
+    Buckets[Bucket]         = Index - 1;
+  }
+
+  Status = CoreInstallConfigurationTable (&gMuGuidHobIndexTableGuid, Table);
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    FreePool (Table);
+  }
+}
+// MU_CHANGE [END]
+
 
 /**
   Terminates all boot services.
@@ -42,6 +42,7 @@ EFI_CORE_PROTOCOL_NOTIFY_ENTRY  mOptionalProtocols[] = {
   { &gEfiSecurity2ArchProtocolGuid,        (VOID **)&gSecurity2,     NULL, NULL, FALSE },
   { &gEfiSmmBase2ProtocolGuid,             (VOID **)&gSmmBase2,      NULL, NULL, FALSE },
   { &gEfiCpu2ProtocolGuid,                 (VOID **)&gCpu2,          NULL, NULL, FALSE },     // MS_CHANGE
+  { &gEdkiiTicklessTimerProtocolGuid,      (VOID **)&gTicklessTimer, NULL, NULL, FALSE },     // MU_CHANGE
   { NULL,                                  (VOID **)NULL,            NULL, NULL, FALSE }
 };
 
@@ -156,6 +157,15 @@ GenericProtocolNotify (
     gTimer->RegisterHandler (gTimer, CoreTimerTick);
   }
 
+  // MU_CHANGE [BEGIN] - Tickless timer support
+  if (CompareGuid (Entry->ProtocolGuid, &gEdkiiTicklessTimerProtocolGuid)) {
+    //
+    // Program the timer events that were queued before the protocol was installed
+    //
+    CoreUpdateTicklessTimer ();
+  }
+  // MU_CHANGE [END]
+
   if (CompareGuid (Entry->ProtocolGuid, &gEfiRuntimeArchProtocolGuid)) {
     //
     // When runtime architectural protocol is available, updates CRC32 in the Debug Table
@@ -162,6 +162,7 @@ CoreDispatchEventNotifies (
 {
   IEVENT          *Event;
   LIST_ENTRY      *Head;
+  UINT64          Begin;            // MU_CHANGE
 
   CoreAcquireEventLock ();
   ASSERT (gEventQueueLock.OwnerTpl == Priority);
@@ -193,7 +194,9 @@ CoreDispatchEventNotifies (
     ASSERT (Event->NotifyFunction != NULL);
     ASSERT (gEfiCurrentTpl == Event->NotifyTpl);  // MS_CHANGE
 
+    Begin = CoreNotifyTimingBegin ();                 // MU_CHANGE
     Event->NotifyFunction (Event, Event->NotifyContext);
+    CoreNotifyTimingEnd (Event, Begin);               // MU_CHANGE
 
     //
     // Check for next pending event
@@ -475,6 +478,9 @@ CoreCreateEventInternal (
   IEvent->NotifyTpl      = NotifyTpl;
   IEvent->NotifyFunction = NotifyFunction;
   IEvent->NotifyContext  = (VOID *)NotifyContext;
+  if (NotifyFunction != NULL) {                                                   // MU_CHANGE
+    IEvent->Image = CoreImageBootCostFindImage ((VOID *)(UINTN)NotifyFunction);  // MU_CHANGE
+  }                                                                               // MU_CHANGE
   if (EventGroup != NULL) {
     CopyGuid (&IEvent->EventGroup, EventGroup);
     IEvent->ExFlag |= EVT_EXFLAG_EVENT_GROUP;
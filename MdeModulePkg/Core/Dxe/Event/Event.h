@@ -59,6 +59,10 @@ typedef struct {
   ///
   EFI_RUNTIME_EVENT_ENTRY RuntimeData;
   TIMER_EVENT_INFO        Timer;
+  ///
+  /// MU_CHANGE - The image of the notification function, for its boot cost
+  ///
+  LOADED_IMAGE_PRIVATE_DATA  *Image;
 } IEVENT;
 
 //
@@ -78,6 +82,56 @@ CoreDispatchEventNotifies (
   IN EFI_TPL      Priority
   );
 
+// MU_CHANGE [BEGIN] - Timing of the event notification functions and of raised TPL
+/**
+  Start timing a notification function.
+
+  @return The current value of the performance counter, or 0 when neither the
+          notification functions nor the boot cost of the images are timed.
+
+**/
+UINT64
+CoreNotifyTimingBegin (
+  VOID
+  );
+
+/**
+  Account the time of a notification function.
+
+  @param  Event                  The event notified.
+  @param  Begin                  The value returned by CoreNotifyTimingBegin()
+                                 before the notification function was called.
+
+**/
+VOID
+CoreNotifyTimingEnd (
+  IN IEVENT  *Event,
+  IN UINT64  Begin
+  );
+
+/**
+  Note that the TPL was raised from below TPL_CALLBACK.
+
+  @param  Caller                 The caller of RaiseTpl().
+
+**/
+VOID
+CoreRaisedTplTimingBegin (
+  IN VOID  *Caller
+  );
+
+/**
+  Note that the TPL is restored below TPL_CALLBACK.
+
+  @param  Tpl                    The TPL restored from.
+
+**/
+VOID
+CoreRaisedTplTimingEnd (
+  IN EFI_TPL  Tpl
+  );
+// MU_CHANGE [END]
+
 
 /**
   Initializes timer support.
@@ -0,0 +1,364 @@
+/** @file
+  Timing of the event notification functions and of the time spent at raised
+  TPL.
+
+  When PcdDxeNotifyTimingThreshold is not 0, every notification function is
+  timed, and the calls that take longer than the threshold are outliers. When
+  PcdDxeRaisedTplTimingThreshold is not 0, the time from a raise of the TPL
+  from below TPL_CALLBACK to the restore below TPL_CALLBACK is timed, and the
+  intervals longer than the threshold are outliers. The longest outliers of
+  each kind are kept, logged at ReadyToBoot and added to the performance
+  records.
+
+  Outliers are found at any TPL, where PerformanceLib can't be called, so the
+  records are only created at ReadyToBoot, with the original timestamps.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Event.h"
+#include <Library/TimerLib.h>
+
+//
+// Number of the longest outliers kept of each kind
+//
+#define TIMING_OUTLIER_COUNT  16
+
+typedef struct {
+  UINT64     Begin;           ///< Performance counter at the start
+  UINT64     Ticks;           ///< Duration in performance counter ticks
+  VOID       *Address;        ///< Notification function, or caller of RaiseTpl()
+  EFI_TPL    Tpl;             ///< TPL of the notification, or TPL restored from
+} TIMING_OUTLIER;
+
+typedef struct {
+  CONST CHAR8       *Token;
+  UINT64            ThresholdTicks;   ///< 0 when this kind of timing is disabled
+  UINT64            OutlierTotal;     ///< Number of outliers, kept or not
+  UINTN             Count;
+  TIMING_OUTLIER    Outliers[TIMING_OUTLIER_COUNT];
+} TIMING_OUTLIER_TABLE;
+
+TIMING_OUTLIER_TABLE  mNotifyOutliers     = { "EventNotify", 0 };
+TIMING_OUTLIER_TABLE  mRaisedTplOutliers  = { "RaisedTpl", 0 };
+BOOLEAN               mTimingCountUp      = TRUE;
+UINT64                mRaisedTplBegin     = 0;
+VOID                  *mRaisedTplCaller   = NULL;
+
+/**
+  Get the ticks between two values of the performance counter.
+
+  @param  Begin                  The first value.
+  @param  End                    The second value.
+
+  @return The elapsed ticks.
+
+**/
+STATIC
+UINT64
+TimingElapsedTicks (
+  IN UINT64  Begin,
+  IN UINT64  End
+  )
+{
+  return mTimingCountUp ? (End - Begin) : (Begin - End);
+}
+
+/**
+  Keep an outlier if it is one of the longest of its table.
+
+  Outliers are added at any TPL, so interrupts are disabled while the table
+  is updated.
+
+  @param  Table                  The outlier table.
+  @param  Begin                  Performance counter at the start.
+  @param  Ticks                  Duration in performance counter ticks.
+  @param  Address                Code responsible for the duration.
+  @param  Tpl                    TPL of the outlier.
+
+**/
+STATIC
+VOID
+AddTimingOutlier (
+  IN OUT TIMING_OUTLIER_TABLE  *Table,
+  IN     UINT64                Begin,
+  IN     UINT64                Ticks,
+  IN     VOID                  *Address,
+  IN     EFI_TPL               Tpl
+  )
+{
+  BOOLEAN  InterruptState;
+  UINTN    Index;
+
+  InterruptState = SaveAndDisableInterrupts ();
+
+  Table->OutlierTotal++;
+
+  //
+  // The table is sorted from the longest outlier to the shortest.
+  //
+  Index = Table->Count;
+  if (Index == TIMING_OUTLIER_COUNT) {
+    if (Table->Outliers[Index - 1].Ticks >= Ticks) {
+      SetInterruptState (InterruptState);
+      return;
+    }
+
+    Index--;
+  } else {
+    Table->Count++;
+  }
+
+  for ( ; Index > 0 && Table->Outliers[Index - 1].Ticks < Ticks; Index--) {
+    Table->Outliers[Index] = Table->Outliers[Index - 1];
+  }
+
+  Table->Outliers[Index].Begin   = Begin;
+  Table->Outliers[Index].Ticks   = Ticks;
+  Table->Outliers[Index].Address = Address;
+  Table->Outliers[Index].Tpl     = Tpl;
+
+  SetInterruptState (InterruptState);
+}
+
+/**
+  Start timing a notification function.
+
+  @return The current value of the performance counter, or 0 when neither the
+          notification functions nor the boot cost of the images are timed.
+
+**/
+UINT64
+CoreNotifyTimingBegin (
+  VOID
+  )
+{
+  if (mNotifyOutliers.ThresholdTicks == 0) {
+    return CoreImageBootCostBegin ();
+  }
+
+  return GetPerformanceCounter ();
+}
+
+/**
+  Account the time of a notification function.
+
+  @param  Event                  The event notified.
+  @param  Begin                  The value returned by CoreNotifyTimingBegin()
+                                 before the notification function was called.
+
+**/
+VOID
+CoreNotifyTimingEnd (
+  IN IEVENT  *Event,
+  IN UINT64  Begin
+  )
+{
+  UINT64  Ticks;
+
+  if (Begin == 0) {
+    return;
+  }
+
+  CoreImageBootCostEnd (Event->Image, ImageBootCostNotify, Begin);
+
+  if (mNotifyOutliers.ThresholdTicks != 0) {
+    Ticks = TimingElapsedTicks (Begin, GetPerformanceCounter ());
+    if (Ticks >= mNotifyOutliers.ThresholdTicks) {
+      AddTimingOutlier (&mNotifyOutliers, Begin, Ticks, (VOID *)(UINTN)Event->NotifyFunction, Event->NotifyTpl);
+    }
+  }
+}
+
+/**
+  Note that the TPL was raised from below TPL_CALLBACK.
+
+  @param  Caller                 The caller of RaiseTpl().
+
+**/
+VOID
+CoreRaisedTplTimingBegin (
+  IN VOID  *Caller
+  )
+{
+  if (mRaisedTplOutliers.ThresholdTicks == 0) {
+    return;
+  }
+
+  mRaisedTplBegin  = GetPerformanceCounter ();
+  mRaisedTplCaller = Caller;
+}
+
+/**
+  Note that the TPL is restored below TPL_CALLBACK.
+
+  @param  Tpl                    The TPL restored from.
+
+**/
+VOID
+CoreRaisedTplTimingEnd (
+  IN EFI_TPL  Tpl
+  )
+{
+  UINT64  Ticks;
+
+  if ((mRaisedTplOutliers.ThresholdTicks == 0) || (mRaisedTplBegin == 0)) {
+    return;
+  }
+
+  Ticks = TimingElapsedTicks (mRaisedTplBegin, GetPerformanceCounter ());
+  if (Ticks >= mRaisedTplOutliers.ThresholdTicks) {
+    AddTimingOutlier (&mRaisedTplOutliers, mRaisedTplBegin, Ticks, mRaisedTplCaller, Tpl);
+  }
+
+  mRaisedTplBegin = 0;
+}
+
+/**
+  Log the outliers of a table and add them to the performance records, then
+  empty the table.
+
+  @param  Table                  The outlier table.
+
+**/
+STATIC
+VOID
+ReportTimingOutliers (
+  IN OUT TIMING_OUTLIER_TABLE  *Table
+  )
+{
+  TIMING_OUTLIER             Outliers[TIMING_OUTLIER_COUNT];
+  UINTN                      Count;
+  UINT64                     OutlierTotal;
+  UINTN                      Index;
+  BOOLEAN                    InterruptState;
+  LOADED_IMAGE_PRIVATE_DATA  *Image;
+  EFI_HANDLE                 Handle;
+
+  if (Table->ThresholdTicks == 0) {
+    return;
+  }
+
+  InterruptState = SaveAndDisableInterrupts ();
+  Count          = Table->Count;
+  OutlierTotal   = Table->OutlierTotal;
+  CopyMem (Outliers, Table->Outliers, Count * sizeof (TIMING_OUTLIER));
+  Table->Count        = 0;
+  Table->OutlierTotal = 0;
+  SetInterruptState (InterruptState);
+
+  DEBUG ((DEBUG_INFO, "%a: %ld outliers over %ld us\n", Table->Token, OutlierTotal, DivU64x32 (GetTimeInNanoSecond (Table->ThresholdTicks), 1000)));
+  for (Index = 0; Index < Count; Index++) {
+    Image  = CoreImageBootCostFindImage (Outliers[Index].Address);
+    Handle = (Image != NULL) ? Image->Handle : NULL;
+    DEBUG ((
+      DEBUG_INFO,
+      "  %8ld us TPL %d at %p (image %p)\n",
+      DivU64x32 (GetTimeInNanoSecond (Outliers[Index].Ticks), 1000),
+      Outliers[Index].Tpl,
+      Outliers[Index].Address,
+      (Image != NULL) ? Image->Info.ImageBase : NULL
+      ));
+
+    StartPerformanceMeasurementEx (Handle, Table->Token, NULL, Outliers[Index].Begin, 0);
+    EndPerformanceMeasurementEx (
+      Handle,
+      Table->Token,
+      NULL,
+      mTimingCountUp ? (Outliers[Index].Begin + Outliers[Index].Ticks) : (Outliers[Index].Begin - Outliers[Index].Ticks),
+      0
+      );
+  }
+}
+
+/**
+  Report the timing outliers at ReadyToBoot.
+
+  @param  Event                  The Event this notify function registered to.
+  @param  Context                Pointer to the context data registered to the Event.
+
+**/
+VOID
+EFIAPI
+ReportTimingOutliersOnReadyToBoot (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  ReportTimingOutliers (&mNotifyOutliers);
+  ReportTimingOutliers (&mRaisedTplOutliers);
+}
+
+/**
+  Convert a threshold in microseconds to performance counter ticks.
+
+  @param  Frequency              Frequency of the performance counter in Hz.
+  @param  MicroSeconds           The threshold in microseconds.
+
+  @return The threshold in ticks, at least 1 when MicroSeconds is not 0.
+
+**/
+STATIC
+UINT64
+TimingThresholdTicks (
+  IN UINT64  Frequency,
+  IN UINT32  MicroSeconds
+  )
+{
+  UINT64  Ticks;
+
+  if (MicroSeconds == 0) {
+    return 0;
+  }
+
+  Ticks = DivU64x32 (MultU64x32 (Frequency, MicroSeconds), 1000000);
+  return (Ticks == 0) ? 1 : Ticks;
+}
+
+/**
+  Start the timing of the notification functions and of the time spent at
+  raised TPL, as configured by PcdDxeNotifyTimingThreshold and
+  PcdDxeRaisedTplTimingThreshold.
+
+**/
+VOID
+CoreInitializeNotifyTiming (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   ReadyToBootEvent;
+  UINT64      Frequency;
+  UINT64      StartValue;
+  UINT64      EndValue;
+
+  if ((PcdGet32 (PcdDxeNotifyTimingThreshold) == 0) && (PcdGet32 (PcdDxeRaisedTplTimingThreshold) == 0)) {
+    return;
+  }
+
+  Frequency = GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (Frequency == 0) {
+    return;
+  }
+
+  mTimingCountUp = (BOOLEAN)(EndValue >= StartValue);
+
+  Status = CoreCreateEventInternal (
+             EVT_NOTIFY_SIGNAL,
+             TPL_CALLBACK,
+             ReportTimingOutliersOnReadyToBoot,
+             NULL,
+             &gEfiEventReadyToBootGuid,
+             &ReadyToBootEvent
+             );
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  mNotifyOutliers.ThresholdTicks    = TimingThresholdTicks (Frequency, PcdGet32 (PcdDxeNotifyTimingThreshold));
+  mRaisedTplOutliers.ThresholdTicks = TimingThresholdTicks (Frequency, PcdGet32 (PcdDxeRaisedTplTimingThreshold));
+}
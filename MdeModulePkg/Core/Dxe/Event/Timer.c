@@ -21,6 +21,11 @@ EFI_EVENT        mEfiCheckTimerEvent = NULL;
 EFI_LOCK         mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64           mEfiSystemTime = 0;
 
+//
+// MU_CHANGE - Trigger time last reported to the tickless timer driver
+//
+UINT64           mEfiTicklessTriggerTime = MAX_UINT64;
+
 //
 // Timer functions
 //
@@ -48,17 +53,20 @@ CoreInsertEventTimer (
   TriggerTime = Event->Timer.TriggerTime;
 
   //
-  // Insert the timer into the timer database in assending sorted order
+  // Insert the timer into the timer database in assending sorted order.
+  // New and re-armed periodic timers almost always expire after the timers
+  // already queued, so search from the tail for the last timer that does not
+  // expire later. Timers with the same trigger time stay in insertion order.
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
+  for (Link = mEfiTimerList.BackLink; Link != &mEfiTimerList; Link = Link->BackLink) {
     Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
+    if (Event2->Timer.TriggerTime <= TriggerTime) {
       break;
     }
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  InsertHeadList (Link, &Event->Timer.Link);
 }
 
 /**
@@ -81,6 +89,75 @@ CoreCurrentSystemTime (
   return SystemTime;
 }
 
+// MU_CHANGE [BEGIN] - Tickless timer support
+/**
+  Report the trigger time of the earliest timer event to the tickless timer
+  driver, if it changed since the last report.
+
+  @param  Force                  Report the trigger time even if it did not
+                                 change.
+
+**/
+VOID
+CoreProgramTicklessTimer (
+  IN BOOLEAN  Force
+  )
+{
+  UINT64          TriggerTime;
+  UINT64          SystemTime;
+  UINT64          TimeToNextEvent;
+  IEVENT          *Event;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  if (gTicklessTimer == NULL) {
+    return;
+  }
+
+  TriggerTime = MAX_UINT64;
+  if (!IsListEmpty (&mEfiTimerList)) {
+    Event       = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+    TriggerTime = Event->Timer.TriggerTime;
+  }
+
+  if (!Force && (TriggerTime == mEfiTicklessTriggerTime)) {
+    return;
+  }
+
+  mEfiTicklessTriggerTime = TriggerTime;
+
+  //
+  // The time to the next event is relative to the system time, which is the
+  // time the timer driver last reported through CoreTimerTick().
+  //
+  if (TriggerTime == MAX_UINT64) {
+    TimeToNextEvent = EDKII_TICKLESS_TIMER_NO_EVENT;
+  } else {
+    SystemTime = CoreCurrentSystemTime ();
+    TimeToNextEvent = (TriggerTime > SystemTime) ? (TriggerTime - SystemTime) : 0;
+  }
+
+  gTicklessTimer->SetNextEvent (gTicklessTimer, TimeToNextEvent);
+}
+
+/**
+  Report the earliest pending timer event to the tickless timer driver.
+
+  Called when the EDKII_TICKLESS_TIMER_PROTOCOL is installed, so that timer
+  events queued before it was available are programmed.
+
+**/
+VOID
+CoreUpdateTicklessTimer (
+  VOID
+  )
+{
+  CoreAcquireLock (&mEfiTimerLock);
+  CoreProgramTicklessTimer (TRUE);
+  CoreReleaseLock (&mEfiTimerLock);
+}
+// MU_CHANGE [END]
+
 /**
   Checks the sorted timer list against the current system time.
   Signals any expired event timer.
@@ -151,6 +228,12 @@ CoreCheckTimers (
     }
   }
 
+  //
+  // MU_CHANGE - Always re-arm the tickless timer here. Its interrupt for the
+  //             head event may have come a fraction of a tick early.
+  //
+  CoreProgramTicklessTimer (TRUE);
+
   CoreReleaseLock (&mEfiTimerLock);
 }
 
@@ -259,6 +342,17 @@ CoreSetTimer (
     return EFI_INVALID_PARAMETER;
   }
 
+  // MU_CHANGE [BEGIN] - Tickless timer support
+  //
+  // A tickless timer only reports the elapsed time when an event is due, so
+  // the system time may be far behind. Bring it up to date before it is used
+  // as the base of the new trigger time.
+  //
+  if ((gTicklessTimer != NULL) && (gTimer != NULL) && (Type != TimerCancel)) {
+    gTimer->GenerateSoftInterrupt (gTimer);
+  }
+  // MU_CHANGE [END]
+
   CoreAcquireLock (&mEfiTimerLock);
 
   //
@@ -289,6 +383,8 @@ CoreSetTimer (
     }
   }
 
+  CoreProgramTicklessTimer (FALSE);   // MU_CHANGE
+
   CoreReleaseLock (&mEfiTimerLock);
 
   return EFI_SUCCESS;
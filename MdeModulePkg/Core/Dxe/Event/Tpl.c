@@ -77,6 +77,12 @@ CoreRaiseTpl (
   //
   gEfiCurrentTpl = NewTpl;
 
+  // MU_CHANGE [BEGIN] - Timing of the time spent at raised TPL
+  if ((OldTpl < TPL_CALLBACK) && (NewTpl >= TPL_CALLBACK)) {
+    CoreRaisedTplTimingBegin (RETURN_ADDRESS (0));
+  }
+  // MU_CHANGE [END]
+
   return OldTpl;
 }
 
@@ -106,6 +112,12 @@ CoreRestoreTpl (
   }
   ASSERT (VALID_TPL (NewTpl));
 
+  // MU_CHANGE [BEGIN] - Timing of the time spent at raised TPL
+  if ((OldTpl >= TPL_CALLBACK) && (NewTpl < TPL_CALLBACK)) {
+    CoreRaisedTplTimingEnd (OldTpl);
+  }
+  // MU_CHANGE [END]
+
   //
   // If lowering below HIGH_LEVEL, make sure
   // interrupts are enabled
@@ -42,7 +42,9 @@ FV_DEVICE mFvDevice = {
   0,
   0,
   FALSE,
-  FALSE
+  FALSE,
+  NULL,
+  0
 };
 
 
@@ -282,6 +284,12 @@ FreeFvDeviceResource (
     FfsFileEntry = (FFS_FILE_LIST_ENTRY *) NextEntry;
   }
 
+  if (FvDevice->FileIndex != NULL) {
+    CoreFreePool (FvDevice->FileIndex);
+    FvDevice->FileIndex      = NULL;
+    FvDevice->FileIndexCount = 0;
+  }
+
   if (!FvDevice->IsMemoryMapped) {
     //
     // Free the cached FV buffer.
@@ -299,6 +307,247 @@ FreeFvDeviceResource (
 
 
 
+/**
+  Sort the FFS file list entries of a firmware volume by name with the file
+  index that GenFv stores in the FV extension header.
+
+  The index only gives the order of the names: every non-pad file of the list
+  must have its name in the index, and the index must have no other entry, so
+  an index that does not match the volume is not used.
+
+  @param  FvDevice         The FV_DEVICE whose FfsFileListHeader is complete.
+  @param  FileIndex        The array to fill, sorted by file name.
+  @param  Count            The number of non-pad files in the list.
+
+  @retval TRUE             FileIndex is filled.
+  @retval FALSE            The volume has no file index, or it does not match
+                           the volume.
+
+**/
+BOOLEAN
+FvSortFilesWithFvFileIndex (
+  IN     FV_DEVICE            *FvDevice,
+  OUT    FFS_FILE_LIST_ENTRY  **FileIndex,
+  IN     UINTN                Count
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER      *FwVolHeader;
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *FwVolExtHeader;
+  EFI_FIRMWARE_VOLUME_EXT_ENTRY   *ExtEntry;
+  EDKII_FV_FILE_INDEX_EXT_ENTRY   *FvFileIndex;
+  EDKII_FV_FILE_INDEX_ENTRY       *Entry;
+  LIST_ENTRY                      *Link;
+  FFS_FILE_LIST_ENTRY             *FfsFileEntry;
+  UINT32                          Offset;
+  UINTN                           Low;
+  UINTN                           High;
+  UINTN                           Middle;
+
+  FwVolHeader = FvDevice->FwVolHeader;
+  if ((FwVolHeader->ExtHeaderOffset == 0) ||
+      ((UINT64) FwVolHeader->ExtHeaderOffset + sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER) > FwVolHeader->FvLength)) {
+    return FALSE;
+  }
+
+  FwVolExtHeader = (EFI_FIRMWARE_VOLUME_EXT_HEADER *) (FvDevice->CachedFv + FwVolHeader->ExtHeaderOffset);
+  if ((UINT64) FwVolHeader->ExtHeaderOffset + FwVolExtHeader->ExtHeaderSize > FwVolHeader->FvLength) {
+    return FALSE;
+  }
+
+  //
+  // Find the file index entry of the extension header
+  //
+  FvFileIndex = NULL;
+  Offset      = sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER);
+  while ((UINT64) Offset + sizeof (EFI_FIRMWARE_VOLUME_EXT_ENTRY) <= FwVolExtHeader->ExtHeaderSize) {
+    ExtEntry = (EFI_FIRMWARE_VOLUME_EXT_ENTRY *) ((UINT8 *) FwVolExtHeader + Offset);
+    if ((ExtEntry->ExtEntrySize < sizeof (EFI_FIRMWARE_VOLUME_EXT_ENTRY)) ||
+        ((UINT64) Offset + ExtEntry->ExtEntrySize > FwVolExtHeader->ExtHeaderSize)) {
+      return FALSE;
+    }
+
+    if ((ExtEntry->ExtEntryType == EFI_FV_EXT_TYPE_GUID_TYPE) &&
+        (ExtEntry->ExtEntrySize >= sizeof (EDKII_FV_FILE_INDEX_EXT_ENTRY)) &&
+        CompareGuid (&((EDKII_FV_FILE_INDEX_EXT_ENTRY *) ExtEntry)->FormatType, &gEdkiiFvFileIndexGuid)) {
+      FvFileIndex = (EDKII_FV_FILE_INDEX_EXT_ENTRY *) ExtEntry;
+      break;
+    }
+
+    Offset += ExtEntry->ExtEntrySize;
+  }
+
+  if ((FvFileIndex == NULL) || (FvFileIndex->Count != Count) ||
+      (sizeof (EDKII_FV_FILE_INDEX_EXT_ENTRY) + MultU64x32 (FvFileIndex->Count, sizeof (EDKII_FV_FILE_INDEX_ENTRY)) > FvFileIndex->Hdr.ExtEntrySize)) {
+    return FALSE;
+  }
+
+  //
+  // Put each file at the position of its name in the index. A name that
+  // appears more than once takes the next free position, in list order, as
+  // the stable sort of FvBuildFileIndex() would do.
+  //
+  Entry = (EDKII_FV_FILE_INDEX_ENTRY *) (FvFileIndex + 1);
+  ZeroMem (FileIndex, Count * sizeof (FFS_FILE_LIST_ENTRY *));
+  for (Link = FvDevice->FfsFileListHeader.ForwardLink;
+       Link != &FvDevice->FfsFileListHeader;
+       Link = Link->ForwardLink) {
+    FfsFileEntry = (FFS_FILE_LIST_ENTRY *) Link;
+    if (FfsFileEntry->FfsHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+      continue;
+    }
+
+    Low  = 0;
+    High = Count;
+    while (Low < High) {
+      Middle = Low + (High - Low) / 2;
+      if (CompareMem (&Entry[Middle].Name, &FfsFileEntry->FfsHeader->Name, sizeof (EFI_GUID)) < 0) {
+        Low = Middle + 1;
+      } else {
+        High = Middle;
+      }
+    }
+
+    while ((Low < Count) && (FileIndex[Low] != NULL) &&
+           CompareGuid (&Entry[Low].Name, &FfsFileEntry->FfsHeader->Name)) {
+      Low++;
+    }
+
+    if ((Low == Count) || !CompareGuid (&Entry[Low].Name, &FfsFileEntry->FfsHeader->Name)) {
+      return FALSE;
+    }
+    FileIndex[Low] = FfsFileEntry;
+  }
+
+  return TRUE;
+}
+
+
+/**
+  Build the sorted file name index of a firmware volume from its FFS file list.
+  If the index cannot be allocated, FvDevice->FileIndex is left NULL and file
+  lookups fall back to walking the list.
+
+  @param  FvDevice         The FV_DEVICE whose FfsFileListHeader is complete.
+
+**/
+VOID
+FvBuildFileIndex (
+  IN OUT FV_DEVICE  *FvDevice
+  )
+{
+  LIST_ENTRY                  *Link;
+  FFS_FILE_LIST_ENTRY         *FfsFileEntry;
+  FFS_FILE_LIST_ENTRY         **FileIndex;
+  UINTN                       Count;
+  UINTN                       Index;
+
+  Count = 0;
+  for (Link = FvDevice->FfsFileListHeader.ForwardLink;
+       Link != &FvDevice->FfsFileListHeader;
+       Link = Link->ForwardLink) {
+    FfsFileEntry = (FFS_FILE_LIST_ENTRY *) Link;
+    if (FfsFileEntry->FfsHeader->Type != EFI_FV_FILETYPE_FFS_PAD) {
+      Count++;
+    }
+  }
+
+  if (Count == 0) {
+    return;
+  }
+
+  FileIndex = AllocatePool (Count * sizeof (FFS_FILE_LIST_ENTRY *));
+  if (FileIndex == NULL) {
+    return;
+  }
+
+  //
+  // The file index built by GenFv saves sorting the names
+  //
+  if (FvSortFilesWithFvFileIndex (FvDevice, FileIndex, Count)) {
+    FvDevice->FileIndex      = FileIndex;
+    FvDevice->FileIndexCount = Count;
+    return;
+  }
+
+  //
+  // Insertion sort in list order. The sort is stable, so when a name appears
+  // more than once the first match in the index is also the first one in the
+  // volume, the same file a linear search would find.
+  //
+  Count = 0;
+  for (Link = FvDevice->FfsFileListHeader.ForwardLink;
+       Link != &FvDevice->FfsFileListHeader;
+       Link = Link->ForwardLink) {
+    FfsFileEntry = (FFS_FILE_LIST_ENTRY *) Link;
+    if (FfsFileEntry->FfsHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+      continue;
+    }
+
+    for (Index = Count; Index > 0; Index--) {
+      if (CompareMem (
+            &FileIndex[Index - 1]->FfsHeader->Name,
+            &FfsFileEntry->FfsHeader->Name,
+            sizeof (EFI_GUID)
+            ) <= 0) {
+        break;
+      }
+      FileIndex[Index] = FileIndex[Index - 1];
+    }
+    FileIndex[Index] = FfsFileEntry;
+    Count++;
+  }
+
+  FvDevice->FileIndex      = FileIndex;
+  FvDevice->FileIndexCount = Count;
+}
+
+
+/**
+  Look up a file by name in the sorted file index of a firmware volume.
+
+  @param  FvDevice         The FV_DEVICE to search.
+  @param  NameGuid         The name of the file to find.
+
+  @return The first FFS file list entry with that name in the volume, or NULL
+          if there is no such file.
+
+**/
+FFS_FILE_LIST_ENTRY *
+FvFindFileInIndex (
+  IN FV_DEVICE       *FvDevice,
+  IN CONST EFI_GUID  *NameGuid
+  )
+{
+  UINTN                       Low;
+  UINTN                       High;
+  UINTN                       Middle;
+  INTN                        Result;
+
+  //
+  // Find the lowest entry whose name is not below NameGuid
+  //
+  Low  = 0;
+  High = FvDevice->FileIndexCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareMem (&FvDevice->FileIndex[Middle]->FfsHeader->Name, NameGuid, sizeof (EFI_GUID));
+    if (Result < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < FvDevice->FileIndexCount) &&
+      CompareGuid (&FvDevice->FileIndex[Low]->FfsHeader->Name, NameGuid)) {
+    return FvDevice->FileIndex[Low];
+  }
+
+  return NULL;
+}
+
+
+
 /**
   Check if an FV is consistent and allocate cache for it.
 
@@ -559,6 +808,8 @@ Done:
       FileCached = FALSE;
     }
     FreeFvDeviceResource (FvDevice);
+  } else {
+    FvBuildFileIndex (FvDevice);
   }
 
   return Status;
@@ -41,10 +41,72 @@ typedef struct {
   UINT8                                   ErasePolarity;
   BOOLEAN                                 IsFfs3Fv;
   BOOLEAN                                 IsMemoryMapped;
+
+  //
+  // Non-pad entries of FfsFileListHeader sorted by file name, so that
+  // FvReadFile() can binary search instead of walking the list.
+  //
+  FFS_FILE_LIST_ENTRY                     **FileIndex;
+  UINTN                                   FileIndexCount;
 } FV_DEVICE;
 
 #define FV_DEVICE_FROM_THIS(a) CR(a, FV_DEVICE, Fv, FV2_DEVICE_SIGNATURE)
 
+/**
+  Sort the FFS file list entries of a firmware volume by name with the file
+  index that GenFv stores in the FV extension header.
+
+  The index only gives the order of the names: every non-pad file of the list
+  must have its name in the index, and the index must have no other entry, so
+  an index that does not match the volume is not used.
+
+  @param  FvDevice         The FV_DEVICE whose FfsFileListHeader is complete.
+  @param  FileIndex        The array to fill, sorted by file name.
+  @param  Count            The number of non-pad files in the list.
+
+  @retval TRUE             FileIndex is filled.
+  @retval FALSE            The volume has no file index, or it does not match
+                           the volume.
+
+**/
+BOOLEAN
+FvSortFilesWithFvFileIndex (
+  IN     FV_DEVICE            *FvDevice,
+  OUT    FFS_FILE_LIST_ENTRY  **FileIndex,
+  IN     UINTN                Count
+  );
+
+/**
+  Build the sorted file name index of a firmware volume from its FFS file list.
+  If the index cannot be allocated, FvDevice->FileIndex is left NULL and file
+  lookups fall back to walking the list.
+
+  @param  FvDevice         The FV_DEVICE whose FfsFileListHeader is complete.
+
+**/
+VOID
+FvBuildFileIndex (
+  IN OUT FV_DEVICE  *FvDevice
+  );
+
+
+/**
+  Look up a file by name in the sorted file index of a firmware volume.
+
+  @param  FvDevice         The FV_DEVICE to search.
+  @param  NameGuid         The name of the file to find.
+
+  @return The first FFS file list entry with that name in the volume, or NULL
+          if there is no such file.
+
+**/
+FFS_FILE_LIST_ENTRY *
+FvFindFileInIndex (
+  IN FV_DEVICE       *FvDevice,
+  IN CONST EFI_GUID  *NameGuid
+  );
+
+
 /**
   Retrieves attributes, insures positive polarity of attribute bits, returns
   resulting attributes in output parameter.
@@ -288,6 +288,8 @@ FvReadFile (
   EFI_FFS_FILE_HEADER               *FfsHeader;
   UINTN                             InputBufferSize;
   UINTN                             WholeFileSize;
+  EFI_FV_ATTRIBUTES                 FvAttributes;
+  FFS_FILE_LIST_ENTRY               *FfsFileEntry;
 
   if (NameGuid == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -295,6 +297,30 @@ FvReadFile (
 
   FvDevice = FV_DEVICE_FROM_THIS (This);
 
+  if (FvDevice->FileIndex != NULL) {
+    //
+    // Binary search the file name index. Apply the same read status check
+    // as FvGetNextFile().
+    //
+    Status = FvGetVolumeAttributes (This, &FvAttributes);
+    if (EFI_ERROR (Status) || ((FvAttributes & EFI_FV2_READ_STATUS) == 0)) {
+      return EFI_NOT_FOUND;
+    }
+
+    FfsFileEntry = FvFindFileInIndex (FvDevice, NameGuid);
+    if (FfsFileEntry == NULL) {
+      return EFI_NOT_FOUND;
+    }
+
+    FvDevice->LastKey = FfsFileEntry;
+    FfsHeader = FfsFileEntry->FfsHeader;
+    if (IS_FFS_FILE2 (FfsHeader)) {
+      FileSize = FFS_FILE2_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER2);
+    } else {
+      FileSize = FFS_FILE_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER);
+    }
+    goto Found;
+  }
 
   //
   // Keep looking until we find the matching NameGuid.
@@ -316,6 +342,7 @@ FvReadFile (
     }
   } while (!CompareGuid (&SearchNameGuid, NameGuid));
 
+Found:
   //
   // Get a pointer to the header
   //
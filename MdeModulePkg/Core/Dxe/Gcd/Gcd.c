@@ -43,6 +43,14 @@ EFI_LOCK           mGcdIoSpaceLock     = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIF
 LIST_ENTRY         mGcdMemorySpaceMap  = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
 LIST_ENTRY         mGcdIoSpaceMap      = INITIALIZE_LIST_HEAD_VARIABLE (mGcdIoSpaceMap);
 
+//
+// The entry most recently found by CoreSearchGcdMapEntry() in each map.
+// Attribute and allocation updates tend to walk a region in address order,
+// so the next search usually starts at or next to this entry.
+//
+LIST_ENTRY         *mGcdMemorySpaceMapHint = NULL;
+LIST_ENTRY         *mGcdIoSpaceMapHint     = NULL;
+
 EFI_GCD_MAP_ENTRY mGcdMemorySpaceMapEntryTemplate = {
   EFI_GCD_MAP_SIGNATURE,
   {
@@ -449,6 +457,28 @@ CoreInsertGcdMapEntry (
 }
 
 
+/**
+  Return the search hint that belongs to a GCD map.
+
+  @param  Map                    Either mGcdMemorySpaceMap or mGcdIoSpaceMap.
+
+  @return The address of the hint for Map.
+
+**/
+LIST_ENTRY **
+CoreGetGcdMapHint (
+  IN LIST_ENTRY      *Map
+  )
+{
+  if (Map == &mGcdMemorySpaceMap) {
+    return &mGcdMemorySpaceMapHint;
+  }
+
+  ASSERT (Map == &mGcdIoSpaceMap);
+  return &mGcdIoSpaceMapHint;
+}
+
+
 /**
   Merge the Gcd region specified by Link and its adjacent entry.
 
@@ -515,6 +545,9 @@ CoreMergeGcdMapEntry (
   } else {
     Entry->BaseAddress = AdjacentEntry->BaseAddress;
   }
+  if (*CoreGetGcdMapHint (Map) == AdjacentLink) {
+    *CoreGetGcdMapHint (Map) = Link;
+  }
   RemoveEntryList (AdjacentLink);
   CoreFreePool (AdjacentEntry);
 
@@ -589,13 +622,33 @@ CoreSearchGcdMapEntry (
 {
   LIST_ENTRY         *Link;
   EFI_GCD_MAP_ENTRY  *Entry;
+  LIST_ENTRY         **Hint;
 
   ASSERT (Length != 0);
 
   *StartLink = NULL;
   *EndLink   = NULL;
 
-  Link = Map->ForwardLink;
+  //
+  // The map is sorted by address, so back up from the hint to the last entry
+  // that starts at or below BaseAddress. No earlier entry can contain it.
+  //
+  Hint = CoreGetGcdMapHint (Map);
+  Link = *Hint;
+  if (Link == NULL) {
+    Link = Map->ForwardLink;
+  }
+  while (Link != Map) {
+    Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    if (BaseAddress >= Entry->BaseAddress) {
+      break;
+    }
+    Link = Link->BackLink;
+  }
+  if (Link == Map) {
+    Link = Map->ForwardLink;
+  }
+
   while (Link != Map) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
     if (BaseAddress >= Entry->BaseAddress && BaseAddress <= Entry->EndAddress) {
@@ -605,6 +658,7 @@ CoreSearchGcdMapEntry (
       if ((BaseAddress + Length - 1) >= Entry->BaseAddress &&
           (BaseAddress + Length - 1) <= Entry->EndAddress     ) {
         *EndLink = Link;
+        *Hint    = *StartLink;
         return EFI_SUCCESS;
       }
     }
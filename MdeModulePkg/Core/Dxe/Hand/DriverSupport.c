@@ -402,6 +402,7 @@ CoreConnectSingleController (
   UINTN                                      SortIndex;
   BOOLEAN                                    OneStarted;
   BOOLEAN                                    DriverFound;
+  UINT64                                     Begin;       // MU_CHANGE
 
   //
   // Initialize local variables
@@ -622,11 +623,17 @@ CoreConnectSingleController (
       if (SortedDriverBindingProtocols[Index] != NULL) {
         DriverBinding = SortedDriverBindingProtocols[Index];
         PERF_DRIVER_BINDING_SUPPORT_BEGIN (DriverBinding->DriverBindingHandle, ControllerHandle);
+        Begin  = CoreImageBootCostBegin ();   // MU_CHANGE
         Status = DriverBinding->Supported(
                                   DriverBinding,
                                   ControllerHandle,
                                   RemainingDevicePath
                                   );
+        // MU_CHANGE [BEGIN] - Boot cost accounting of the images
+        if (Begin != 0) {
+          CoreImageBootCostEnd (CoreImageBootCostFindImage ((VOID *)(UINTN)DriverBinding->Supported), ImageBootCostSupported, Begin);
+        }
+        // MU_CHANGE [END]
         PERF_DRIVER_BINDING_SUPPORT_END (DriverBinding->DriverBindingHandle, ControllerHandle);
         if (!EFI_ERROR (Status)) {
           SortedDriverBindingProtocols[Index] = NULL;
@@ -637,11 +644,17 @@ CoreConnectSingleController (
           // on ControllerHandle.
           //
           PERF_DRIVER_BINDING_START_BEGIN (DriverBinding->DriverBindingHandle, ControllerHandle);
+          Begin  = CoreImageBootCostBegin ();   // MU_CHANGE
           Status = DriverBinding->Start (
                                     DriverBinding,
                                     ControllerHandle,
                                     RemainingDevicePath
                                     );
+          // MU_CHANGE [BEGIN] - Boot cost accounting of the images
+          if (Begin != 0) {
+            CoreImageBootCostEnd (CoreImageBootCostFindImage ((VOID *)(UINTN)DriverBinding->Start), ImageBootCostStart, Begin);
+          }
+          // MU_CHANGE [END]
           PERF_DRIVER_BINDING_START_END (DriverBinding->DriverBindingHandle, ControllerHandle);
 
           if (!EFI_ERROR (Status)) {
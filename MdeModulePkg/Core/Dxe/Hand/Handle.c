@@ -11,8 +11,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// mProtocolDatabase     - A list of all protocols in the system.
+// mProtocolHashTable    - Hash index of mProtocolDatabase keyed by protocol GUID
 // gHandleList           - A list of all the handles in the system
+// mHandleHashTable      - Hash index of gHandleList keyed by handle address
+// mDevicePathHashTable  - Hash index of the device path protocol interfaces
+//                         keyed by the bytes of the device path
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
@@ -21,6 +25,15 @@ LIST_ENTRY      gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleLi
 EFI_LOCK        gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64          gHandleDatabaseKey    = 0;
 
+LIST_ENTRY      mProtocolHashTable[PROTOCOL_HASH_BUCKETS];
+BOOLEAN         mProtocolHashTableReady = FALSE;
+
+LIST_ENTRY      mHandleHashTable[HANDLE_HASH_BUCKETS];
+BOOLEAN         mHandleHashTableReady = FALSE;
+
+LIST_ENTRY      mDevicePathHashTable[DEVICE_PATH_HASH_BUCKETS];
+BOOLEAN         mDevicePathHashTableReady = FALSE;
+
 
 
 /**
@@ -51,6 +64,41 @@ CoreReleaseProtocolLock (
 
 
 
+/**
+  Returns the mHandleHashTable bucket that holds the requested handle.
+
+  @param  UserHandle             The handle to look up
+
+  @return The head of the bucket list.
+
+**/
+LIST_ENTRY *
+CoreGetHandleHashBucket (
+  IN EFI_HANDLE   UserHandle
+  )
+{
+  UINTN               Hash;
+  UINTN               Index;
+
+  if (!mHandleHashTableReady) {
+    for (Index = 0; Index < HANDLE_HASH_BUCKETS; Index++) {
+      InitializeListHead (&mHandleHashTable[Index]);
+    }
+    mHandleHashTableReady = TRUE;
+  }
+
+  //
+  // Handles are pool allocations, so the low bits are always clear. Drop
+  // them and fold in the higher bits to spread handles across the buckets.
+  //
+  Hash  = (UINTN)UserHandle >> 3;
+  Hash ^= Hash >> 7;
+  Hash ^= Hash >> 14;
+
+  return &mHandleHashTable[Hash & (HANDLE_HASH_BUCKETS - 1)];
+}
+
+
 /**
   Check whether a handle is a valid EFI_HANDLE
 
@@ -67,13 +115,20 @@ CoreValidateHandle (
 {
   IHANDLE             *Handle;
   LIST_ENTRY          *Link;
+  LIST_ENTRY          *Bucket;
 
   if (UserHandle == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  for (Link = gHandleList.BackLink; Link != &gHandleList; Link = Link->BackLink) {
-    Handle = CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE);
+  //
+  // Every Supported() and Start() call made while connecting controllers
+  // opens protocols by handle, so only walk the bucket this handle hashes to
+  // instead of the whole handle database.
+  //
+  Bucket = CoreGetHandleHashBucket (UserHandle);
+  for (Link = Bucket->BackLink; Link != Bucket; Link = Link->BackLink) {
+    Handle = CR (Link, IHANDLE, HashEntries, EFI_HANDLE_SIGNATURE);
     if (Handle == (IHANDLE *) UserHandle) {
       return EFI_SUCCESS;
     }
@@ -83,6 +138,214 @@ CoreValidateHandle (
 }
 
 
+/**
+  Add the bytes of a device path to a device path hash.
+
+  The hash is FNV-1a, so that the hash of each prefix of a device path is
+  computed in turn while walking its nodes.
+
+  @param  Hash                   The hash of the bytes before Buffer
+  @param  Buffer                 The bytes to add
+  @param  Length                 The number of bytes to add
+
+  @return The hash of the bytes before Buffer followed by those of Buffer.
+
+**/
+UINT32
+CoreHashDevicePath (
+  IN UINT32                     Hash,
+  IN CONST VOID                 *Buffer,
+  IN UINTN                      Length
+  )
+{
+  CONST UINT8         *Bytes;
+
+  for (Bytes = Buffer; Length > 0; Length--, Bytes++) {
+    Hash = (Hash ^ *Bytes) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+
+/**
+  Returns the mDevicePathHashTable bucket that holds the device paths with
+  the requested hash.
+
+  @param  Hash                   The device path hash
+
+  @return The head of the bucket list.
+
+**/
+LIST_ENTRY *
+CoreGetDevicePathHashBucket (
+  IN UINT32                     Hash
+  )
+{
+  UINTN               Index;
+
+  if (!mDevicePathHashTableReady) {
+    for (Index = 0; Index < DEVICE_PATH_HASH_BUCKETS; Index++) {
+      InitializeListHead (&mDevicePathHashTable[Index]);
+    }
+    mDevicePathHashTableReady = TRUE;
+  }
+
+  return &mDevicePathHashTable[(Hash ^ (Hash >> 16)) & (DEVICE_PATH_HASH_BUCKETS - 1)];
+}
+
+
+/**
+  Index a protocol interface by its device path, if it is a device path
+  protocol interface. The gProtocolDatabaseLock must be owned.
+
+  @param  Prot                   The protocol interface, already linked in
+                                 the database
+
+**/
+VOID
+CoreAddDevicePathIndex (
+  IN PROTOCOL_INTERFACE         *Prot
+  )
+{
+  UINTN               Size;
+
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  InitializeListHead (&Prot->DevicePathHashEntries);
+  if ((Prot->Interface == NULL) ||
+      !CompareGuid (&Prot->Protocol->ProtocolID, &gEfiDevicePathProtocolGuid)) {
+    return;
+  }
+
+  //
+  // A malformed device path can't be matched, so leave it out.
+  //
+  Size = GetDevicePathSize (Prot->Interface);
+  if (Size < END_DEVICE_PATH_LENGTH) {
+    return;
+  }
+
+  Prot->DevicePathSize = Size - END_DEVICE_PATH_LENGTH;
+  Prot->DevicePathHash = CoreHashDevicePath (DEVICE_PATH_HASH_SEED, Prot->Interface, Prot->DevicePathSize);
+  InsertTailList (CoreGetDevicePathHashBucket (Prot->DevicePathHash), &Prot->DevicePathHashEntries);
+}
+
+
+/**
+  Remove a protocol interface from the device path index, if it is in it.
+  The gProtocolDatabaseLock must be owned.
+
+  @param  Prot                   The protocol interface
+
+**/
+VOID
+CoreRemoveDevicePathIndex (
+  IN PROTOCOL_INTERFACE         *Prot
+  )
+{
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  if (!IsListEmpty (&Prot->DevicePathHashEntries)) {
+    RemoveEntryList (&Prot->DevicePathHashEntries);
+    InitializeListHead (&Prot->DevicePathHashEntries);
+  }
+}
+
+
+/**
+  Find the handle whose device path is exactly the first Size bytes of
+  DevicePath, and that supports Protocol. The gProtocolDatabaseLock must be
+  owned.
+
+  @param  Protocol               The protocol the handle must support
+  @param  DevicePath             The device path to match
+  @param  Size                   The number of bytes of DevicePath to match
+  @param  Hash                   CoreHashDevicePath() of those bytes
+
+  @return The handle, or NULL if no handle matches.
+
+**/
+IHANDLE *
+CoreFindDevicePathHandle (
+  IN EFI_GUID                   *Protocol,
+  IN EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN UINTN                      Size,
+  IN UINT32                     Hash
+  )
+{
+  LIST_ENTRY          *Bucket;
+  LIST_ENTRY          *Link;
+  PROTOCOL_INTERFACE  *Prot;
+  IHANDLE             *Match;
+
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  Match  = NULL;
+  Bucket = CoreGetDevicePathHashBucket (Hash);
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, DevicePathHashEntries, PROTOCOL_INTERFACE_SIGNATURE);
+    if ((Prot->DevicePathHash != Hash) ||
+        (Prot->DevicePathSize != Size) ||
+        (CompareMem (Prot->Interface, DevicePath, Size) != 0) ||
+        (CoreGetProtocolInterface (Prot->Handle, Protocol) == NULL)) {
+      continue;
+    }
+
+    //
+    // Two handles with the same device path that both support Protocol are
+    // ambiguous. Keep the first one in the index.
+    //
+    ASSERT (Match == NULL);
+    if (Match == NULL) {
+      Match = Prot->Handle;
+    }
+  }
+
+  return Match;
+}
+
+
+
+/**
+  Returns the mProtocolHashTable bucket that holds the protocol entry for
+  the requested protocol GUID.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The head of the bucket list.
+
+**/
+LIST_ENTRY *
+CoreGetProtocolHashBucket (
+  IN EFI_GUID   *Protocol
+  )
+{
+  UINT32              Hash;
+  UINTN               Index;
+
+  if (!mProtocolHashTableReady) {
+    for (Index = 0; Index < PROTOCOL_HASH_BUCKETS; Index++) {
+      InitializeListHead (&mProtocolHashTable[Index]);
+    }
+    mProtocolHashTableReady = TRUE;
+  }
+
+  //
+  // Protocol GUIDs are effectively random, so folding the four 32-bit words
+  // together spreads them evenly across the buckets.
+  //
+  Hash  = ReadUnaligned32 ((UINT32 *)Protocol);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 1);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 2);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return &mProtocolHashTable[Hash & (PROTOCOL_HASH_BUCKETS - 1)];
+}
+
+
 
 /**
   Finds the protocol entry for the requested protocol.
@@ -100,6 +363,7 @@ CoreFindProtocolEntry (
   IN BOOLEAN    Create
   )
 {
+  LIST_ENTRY          *Bucket;
   LIST_ENTRY          *Link;
   PROTOCOL_ENTRY      *Item;
   PROTOCOL_ENTRY      *ProtEntry;
@@ -107,15 +371,16 @@ CoreFindProtocolEntry (
   ASSERT_LOCKED(&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket for the matching GUID
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  Bucket    = CoreGetProtocolHashBucket (Protocol);
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink) {
 
-    Item = CR(Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    Item = CR(Link, PROTOCOL_ENTRY, HashEntries, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
 
       //
@@ -144,9 +409,10 @@ CoreFindProtocolEntry (
       InitializeListHead (&ProtEntry->Notify);
 
       //
-      // Add it to protocol database
+      // Add it to protocol database and its hash bucket
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertTailList (Bucket, &ProtEntry->HashEntries);
     }
   }
 
@@ -427,6 +693,7 @@ CoreInstallProtocolInterfaceNotify (
     // in the system
     //
     InsertTailList (&gHandleList, &Handle->AllHandles);
+    InsertTailList (CoreGetHandleHashBucket (Handle), &Handle->HashEntries);
   } else {
     Status = CoreValidateHandle (Handle);
     if (EFI_ERROR (Status)) {
@@ -465,6 +732,7 @@ CoreInstallProtocolInterfaceNotify (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  CoreAddDevicePathIndex (Prot);
 
   //
   // Notify the notification list for this protocol
@@ -789,6 +1057,7 @@ CoreUninstallProtocolInterface (
   if (IsListEmpty (&Handle->Protocols)) {
     Handle->Signature = 0;
     RemoveEntryList (&Handle->AllHandles);
+    RemoveEntryList (&Handle->HashEntries);
     CoreFreePool (Handle);
   }
 
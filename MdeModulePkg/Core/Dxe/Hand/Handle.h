@@ -19,6 +19,8 @@ typedef struct {
   UINTN               Signature;
   /// All handles list of IHANDLE
   LIST_ENTRY          AllHandles;
+  /// Link Entry inserted to the mHandleHashTable bucket for this handle
+  LIST_ENTRY          HashEntries;
   /// List of PROTOCOL_INTERFACE's for this handle
   LIST_ENTRY          Protocols;
   UINTN               LocateRequest;
@@ -39,6 +41,8 @@ typedef struct {
   UINTN               Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY          AllEntries;
+  /// Link Entry inserted to the mProtocolHashTable bucket for ProtocolID
+  LIST_ENTRY          HashEntries;
   /// ID of the protocol
   EFI_GUID            ProtocolID;
   /// All protocol interfaces
@@ -48,6 +52,24 @@ typedef struct {
 } PROTOCOL_ENTRY;
 
 
+///
+/// Number of buckets in the protocol database hash index. Must be a power of 2.
+///
+#define PROTOCOL_HASH_BUCKETS           64
+
+///
+/// Number of buckets in the handle hash index used by CoreValidateHandle().
+/// Must be a power of 2.
+///
+#define HANDLE_HASH_BUCKETS             128
+
+///
+/// Number of buckets in the device path index used by CoreLocateDevicePath().
+/// Must be a power of 2.
+///
+#define DEVICE_PATH_HASH_BUCKETS        128
+#define DEVICE_PATH_HASH_SEED           0x811C9DC5
+
 #define PROTOCOL_INTERFACE_SIGNATURE  SIGNATURE_32('p','i','f','c')
 
 ///
@@ -69,6 +91,12 @@ typedef struct {
   /// OPEN_PROTOCOL_DATA list
   LIST_ENTRY                  OpenList;
   UINTN                       OpenListCount;
+  /// Link Entry inserted to the mDevicePathHashTable bucket for a device path
+  /// protocol interface. Points to itself for other interfaces.
+  LIST_ENTRY                  DevicePathHashEntries;
+  /// Size of the device path, without the end node, and hash of its bytes
+  UINTN                       DevicePathSize;
+  UINT32                      DevicePathHash;
 
 } PROTOCOL_INTERFACE;
 
@@ -254,6 +282,89 @@ CoreValidateHandle (
   IN  EFI_HANDLE                UserHandle
   );
 
+
+/**
+  Locate a certain GUID protocol interface in a Handle's protocols.
+
+  @param  UserHandle             The handle to obtain the protocol interface on
+  @param  Protocol               The GUID of the protocol
+
+  @return The requested protocol interface for the handle
+
+**/
+PROTOCOL_INTERFACE  *
+CoreGetProtocolInterface (
+  IN  EFI_HANDLE                UserHandle,
+  IN  EFI_GUID                  *Protocol
+  );
+
+
+/**
+  Add the bytes of a device path to a device path hash.
+
+  @param  Hash                   The hash of the bytes before Buffer
+  @param  Buffer                 The bytes to add
+  @param  Length                 The number of bytes to add
+
+  @return The hash of the bytes before Buffer followed by those of Buffer.
+
+**/
+UINT32
+CoreHashDevicePath (
+  IN UINT32                     Hash,
+  IN CONST VOID                 *Buffer,
+  IN UINTN                      Length
+  );
+
+
+/**
+  Index a protocol interface by its device path, if it is a device path
+  protocol interface. The gProtocolDatabaseLock must be owned.
+
+  @param  Prot                   The protocol interface, already linked in
+                                 the database
+
+**/
+VOID
+CoreAddDevicePathIndex (
+  IN PROTOCOL_INTERFACE         *Prot
+  );
+
+
+/**
+  Remove a protocol interface from the device path index, if it is in it.
+  The gProtocolDatabaseLock must be owned.
+
+  @param  Prot                   The protocol interface
+
+**/
+VOID
+CoreRemoveDevicePathIndex (
+  IN PROTOCOL_INTERFACE         *Prot
+  );
+
+
+/**
+  Find the handle whose device path is exactly the first Size bytes of
+  DevicePath, and that supports Protocol. The gProtocolDatabaseLock must be
+  owned.
+
+  @param  Protocol               The protocol the handle must support
+  @param  DevicePath             The device path to match
+  @param  Size                   The number of bytes of DevicePath to match
+  @param  Hash                   CoreHashDevicePath() of those bytes
+
+  @return The handle, or NULL if no handle matches.
+
+**/
+IHANDLE *
+CoreFindDevicePathHandle (
+  IN EFI_GUID                   *Protocol,
+  IN EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN UINTN                      Size,
+  IN UINT32                     Hash
+  );
+
 //
 // Externs
 //
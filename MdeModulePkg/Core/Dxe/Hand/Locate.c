@@ -423,17 +423,13 @@ CoreLocateDevicePath (
   OUT EFI_HANDLE                    *Device
   )
 {
-  INTN                        SourceSize;
   INTN                        Size;
   INTN                        BestMatch;
-  UINTN                       HandleCount;
-  UINTN                       Index;
-  EFI_STATUS                  Status;
-  EFI_HANDLE                  *Handles;
-  EFI_HANDLE                  Handle;
   EFI_HANDLE                  BestDevice;
   EFI_DEVICE_PATH_PROTOCOL    *SourcePath;
   EFI_DEVICE_PATH_PROTOCOL    *TmpDevicePath;
+  IHANDLE                     *Handle;
+  UINT32                      Hash;
 
   if (Protocol == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -443,66 +439,41 @@ CoreLocateDevicePath (
     return EFI_INVALID_PARAMETER;
   }
 
-  Handles = NULL;
   BestDevice = NULL;
   SourcePath = *DevicePath;
-  TmpDevicePath = SourcePath;
-  while (!IsDevicePathEnd (TmpDevicePath)) {
-    if (IsDevicePathEndInstance (TmpDevicePath)) {
-      //
-      // If DevicePath is a multi-instance device path,
-      // the function will operate on the first instance
-      //
-      break;
-    }
-    TmpDevicePath = NextDevicePathNode (TmpDevicePath);
-  }
-
-  SourceSize = (UINTN) TmpDevicePath - (UINTN) SourcePath;
 
   //
-  // Get a list of all handles that support the requested protocol
+  // Look up each prefix of the first instance of DevicePath, shortest first,
+  // in the device path index, instead of comparing the device path of every
+  // handle that supports Protocol. The longest prefix found wins.
   //
-  Status = CoreLocateHandleBuffer (ByProtocol, Protocol, NULL, &HandleCount, &Handles);
-  if (EFI_ERROR (Status) || HandleCount == 0) {
-    return EFI_NOT_FOUND;
-  }
+  CoreAcquireProtocolLock ();
 
-  BestMatch = -1;
-  for(Index = 0; Index < HandleCount; Index += 1) {
-    Handle = Handles[Index];
-    Status = CoreHandleProtocol (Handle, &gEfiDevicePathProtocolGuid, (VOID **)&TmpDevicePath);
-    if (EFI_ERROR (Status)) {
-      //
-      // If this handle doesn't support device path, then skip it
-      //
-      continue;
+  BestMatch     = -1;
+  Size          = 0;
+  Hash          = DEVICE_PATH_HASH_SEED;
+  TmpDevicePath = SourcePath;
+  for ( ; ; ) {
+    Handle = CoreFindDevicePathHandle (Protocol, SourcePath, (UINTN)Size, Hash);
+    if (Handle != NULL) {
+      BestMatch  = Size;
+      BestDevice = Handle;
     }
 
     //
-    // Check if DevicePath is first part of SourcePath
+    // If DevicePath is a multi-instance device path,
+    // the function will operate on the first instance
     //
-    Size = GetDevicePathSize (TmpDevicePath) - sizeof(EFI_DEVICE_PATH_PROTOCOL);
-    ASSERT (Size >= 0);
-    if ((Size <= SourceSize) && CompareMem (SourcePath, TmpDevicePath, (UINTN) Size) == 0) {
-      //
-      // If the size is equal to the best match, then we
-      // have a duplicate device path for 2 different device
-      // handles
-      //
-      ASSERT (Size != BestMatch);
-
-      //
-      // We've got a match, see if it's the best match so far
-      //
-      if (Size > BestMatch) {
-        BestMatch = Size;
-        BestDevice = Handle;
-      }
+    if (IsDevicePathEnd (TmpDevicePath) || IsDevicePathEndInstance (TmpDevicePath)) {
+      break;
     }
+
+    Hash          = CoreHashDevicePath (Hash, TmpDevicePath, DevicePathNodeLength (TmpDevicePath));
+    Size         += DevicePathNodeLength (TmpDevicePath);
+    TmpDevicePath = NextDevicePathNode (TmpDevicePath);
   }
 
-  CoreFreePool (Handles);
+  CoreReleaseProtocolLock ();
 
   //
   // If there wasn't any match, then no parts of the device path was found.
@@ -79,6 +79,7 @@ CoreRemoveInterfaceFromProtocol (
     // Remove the protocol interface entry
     //
     RemoveEntryList (&Prot->ByProtocol);
+    CoreRemoveDevicePathIndex (Prot);
   }
 
   return Prot;
@@ -249,6 +250,7 @@ CoreReinstallProtocolInterface (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  CoreAddDevicePathIndex (Prot);
 
   //
   // Update the Key to show that the handle has been created/modified
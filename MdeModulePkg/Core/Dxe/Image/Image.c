@@ -242,6 +242,7 @@ CoreInitializeImageServices (
   mDxeCoreImageMachineType = PeCoffLoaderGetMachineType (Image->Info.ImageBase);
   gDxeCoreImageHandle = Image->Handle;
   gDxeCoreLoadedImage = &Image->Info;
+  CoreImageBootCostRegisterImage (Image);   // MU_CHANGE
 
   //
   // Create the PE/COFF emulator protocol registration event
@@ -565,7 +566,9 @@ CoreLoadPeImage (
   EFI_STATUS                Status;
   BOOLEAN                   DstBufAlocated;
   UINTN                     Size;
+  EFI_PHYSICAL_ADDRESS      LinkedAddress;
   UINT64*                   SecurityCookieAddress;   // MS_CHANGE_? - TODO
+  UINT64                    Begin;                   // MU_CHANGE
 
   ZeroMem (&Image->ImageContext, sizeof (Image->ImageContext));
 
@@ -591,6 +594,12 @@ CoreLoadPeImage (
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // Remember the address the image was linked at, so a load that needs the
+  // base relocations applied can be told apart from one that does not.
+  //
+  LinkedAddress = Image->ImageContext.ImageAddress;
+
   //
   // Set EFI memory type based on ImageType
   //
@@ -715,7 +724,9 @@ CoreLoadPeImage (
   //
   // Load the image from the file into the allocated memory
   //
+  Begin  = CoreImageBootCostBegin ();     // MU_CHANGE
   Status = PeCoffLoaderLoadImage (&Image->ImageContext);
+  CoreImageLoadPhaseEnd (&Image->BootCost.LoadPhaseTicks[ImageLoadPhaseLoad], Begin);   // MU_CHANGE
   if (EFI_ERROR (Status)) {
     goto Done;
   }
@@ -738,11 +749,23 @@ CoreLoadPeImage (
   //
   // Relocate the image in memory
   //
+  Begin  = CoreImageBootCostBegin ();     // MU_CHANGE
   Status = PeCoffLoaderRelocateImage (&Image->ImageContext);
+  CoreImageLoadPhaseEnd (&Image->BootCost.LoadPhaseTicks[ImageLoadPhaseRelocate], Begin);   // MU_CHANGE
   if (EFI_ERROR (Status)) {
     goto Done;
   }
 
+  //
+  // PeCoffLoaderRelocateImage() skips the fixup pass when the image landed at
+  // its linked address. Report the images that did not, so platforms using a
+  // fixed image layout (PcdLoadModuleAtFixAddressEnable) can find the ones
+  // still paying for relocation on every boot.
+  //
+  if (Image->ImageContext.ImageAddress != LinkedAddress) {
+    DEBUG ((DEBUG_VERBOSE | DEBUG_LOAD, "Image relocated from 0x%lx to 0x%lx\n", LinkedAddress, Image->ImageContext.ImageAddress));
+  }
+
   //
   // Flush the Instruction Cache
   //
@@ -949,6 +972,8 @@ CoreUnloadAndCloseImage (
     UnregisterMemoryProfileImage (Image);
   }
 
+  CoreImageBootCostUnregisterImage (Image);   // MU_CHANGE
+
   UnprotectUefiImage (&Image->Info, Image->LoadedImageDevicePath);
 
   if (Image->PeCoffEmu != NULL) {
@@ -1077,6 +1102,131 @@ CoreUnloadAndCloseImage (
 }
 
 
+// MU_CHANGE [BEGIN] - Read images from a FV with a single read of their file
+/**
+  Read an image from a firmware volume with a single read of its FFS file.
+
+  The PE32 section is used in place in the file buffer, instead of being
+  extracted by ReadSection() into another buffer. Files with encapsulation
+  sections, such as compressed or GUIDed ones, are left to ReadSection() so
+  that the section extraction and its authentication status are unchanged.
+
+  @param  DeviceHandle           The handle of the firmware volume.
+  @param  FilePath               The remaining device path, the FV file node.
+  @param  FileBuffer             The file buffer, to free when the image is
+                                 no longer read.
+  @param  FHand                  The image file handle, its source is set to
+                                 the PE32 section data.
+  @param  AuthenticationStatus   The authentication status of the file.
+
+  @retval EFI_SUCCESS            The image was read.
+  @retval EFI_UNSUPPORTED        The image must be read with ReadSection().
+  @retval Others                 The file could not be read.
+
+**/
+STATIC
+EFI_STATUS
+CoreReadImageFromFv (
+  IN  EFI_HANDLE                DeviceHandle,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  OUT VOID                      **FileBuffer,
+  OUT IMAGE_FILE_HANDLE         *FHand,
+  OUT UINT32                    *AuthenticationStatus
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv;
+  EFI_GUID                       *NameGuid;
+  EFI_FV_FILETYPE                Type;
+  EFI_FV_FILE_ATTRIBUTES         Attrib;
+  UINTN                          FileSize;
+  UINTN                          End;
+  EFI_COMMON_SECTION_HEADER      *Section;
+  UINTN                          SectionSize;
+  UINTN                          HeaderSize;
+  VOID                           *Pe32;
+  UINTN                          Pe32Size;
+
+  NameGuid = EfiGetNameGuidFromFwVolDevicePathNode ((MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)FilePath);
+  if ((NameGuid == NULL) || !IsDevicePathEnd (NextDevicePathNode (FilePath))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = CoreHandleProtocol (DeviceHandle, &gEfiFirmwareVolume2ProtocolGuid, (VOID **)&Fv);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *FileBuffer = NULL;
+  FileSize    = 0;
+  Status      = Fv->ReadFile (Fv, NameGuid, FileBuffer, &FileSize, &Type, &Attrib, AuthenticationStatus);
+  if (EFI_ERROR (Status)) {
+    *FileBuffer = NULL;
+    return Status;
+  }
+
+  if (Type == EFI_FV_FILETYPE_RAW) {
+    Status = EFI_UNSUPPORTED;
+    goto Done;
+  }
+
+  //
+  // Look for the PE32 section among the leaf sections of the file.
+  //
+  Pe32     = NULL;
+  Pe32Size = 0;
+  End      = (UINTN)*FileBuffer + FileSize;
+  Section  = (EFI_COMMON_SECTION_HEADER *)*FileBuffer;
+  while ((UINTN)Section + sizeof (EFI_COMMON_SECTION_HEADER) <= End) {
+    if (IS_SECTION2 (Section)) {
+      if ((UINTN)Section + sizeof (EFI_COMMON_SECTION_HEADER2) > End) {
+        break;
+      }
+
+      SectionSize = SECTION2_SIZE (Section);
+      HeaderSize  = sizeof (EFI_COMMON_SECTION_HEADER2);
+    } else {
+      SectionSize = SECTION_SIZE (Section);
+      HeaderSize  = sizeof (EFI_COMMON_SECTION_HEADER);
+    }
+
+    if ((SectionSize < HeaderSize) || (SectionSize > End - (UINTN)Section)) {
+      break;
+    }
+
+    if ((Section->Type == EFI_SECTION_COMPRESSION) ||
+        (Section->Type == EFI_SECTION_GUID_DEFINED) ||
+        (Section->Type == EFI_SECTION_DISPOSABLE))
+    {
+      Status = EFI_UNSUPPORTED;
+      goto Done;
+    }
+
+    if ((Section->Type == EFI_SECTION_PE32) && (Pe32 == NULL)) {
+      Pe32     = (UINT8 *)Section + HeaderSize;
+      Pe32Size = SectionSize - HeaderSize;
+    }
+
+    Section = (EFI_COMMON_SECTION_HEADER *)((UINTN)Section + ALIGN_VALUE (SectionSize, 4));
+  }
+
+  if ((Pe32 == NULL) || (Pe32Size == 0)) {
+    Status = EFI_UNSUPPORTED;
+    goto Done;
+  }
+
+  FHand->Source     = Pe32;
+  FHand->SourceSize = Pe32Size;
+  return EFI_SUCCESS;
+
+Done:
+  CoreFreePool (*FileBuffer);
+  *FileBuffer           = NULL;
+  *AuthenticationStatus = 0;
+  return Status;
+}
+// MU_CHANGE [END]
+
 /**
   Loads an EFI image into memory and returns a handle to the image.
 
@@ -1149,8 +1299,13 @@ CoreLoadImageCommon (
   UINTN                      FilePathSize;
   BOOLEAN                    ImageIsFromFv;
   BOOLEAN                    ImageIsFromLoadFile;
+  UINT64                     LoadPhaseTicks[ImageLoadPhaseMax];  // MU_CHANGE
+  UINT64                     Begin;                              // MU_CHANGE
+  VOID                       *FileBuffer;                        // MU_CHANGE
 
   SecurityStatus = EFI_SUCCESS;
+  ZeroMem (LoadPhaseTicks, sizeof (LoadPhaseTicks));             // MU_CHANGE
+  FileBuffer     = NULL;                                         // MU_CHANGE
 
   ASSERT (gEfiCurrentTpl < TPL_NOTIFY);
   ParentImage = NULL;
@@ -1202,6 +1357,7 @@ CoreLoadImageCommon (
     //
     // Try to get the image device handle by checking the match protocol.
     //
+    Begin  = CoreImageBootCostBegin ();     // MU_CHANGE
     Node   = NULL;
     Status = CoreLocateDevicePath (&gEfiFirmwareVolume2ProtocolGuid, &HandleFilePath, &DeviceHandle);
     if (!EFI_ERROR (Status)) {
@@ -1225,26 +1381,43 @@ CoreLoadImageCommon (
       }
     }
 
-    //
-    // Get the source file buffer by its device path.
-    //
-    FHand.Source = GetFileBufferByFilePath (
-                      BootPolicy,
-                      FilePath,
-                      &FHand.SourceSize,
-                      &AuthenticationStatus
-                      );
-    if (FHand.Source == NULL) {
-      Status = EFI_NOT_FOUND;
+    CoreImageLoadPhaseEnd (&LoadPhaseTicks[ImageLoadPhaseLocate], Begin);   // MU_CHANGE
+
+    // MU_CHANGE [BEGIN] - Read images from a FV with a single read of their file
+    if (ImageIsFromFv) {
+      Begin = CoreImageBootCostBegin ();
+      CoreReadImageFromFv (DeviceHandle, HandleFilePath, &FileBuffer, &FHand, &AuthenticationStatus);
+      CoreImageLoadPhaseEnd (&LoadPhaseTicks[ImageLoadPhaseRead], Begin);
+    }
+
+    if (FHand.Source != NULL) {
+      Status = EFI_SUCCESS;
     } else {
-      FHand.FreeBuffer = TRUE;
-      if (ImageIsFromLoadFile) {
-        //
-        // LoadFile () may cause the device path of the Handle be updated.
-        //
-        OriginalFilePath = AppendDevicePath (DevicePathFromHandle (DeviceHandle), Node);
+      //
+      // Get the source file buffer by its device path. For an image in a FV,
+      // this extracts it from the encapsulation sections of its file.
+      //
+      Begin        = CoreImageBootCostBegin ();
+      FHand.Source = GetFileBufferByFilePath (
+                        BootPolicy,
+                        FilePath,
+                        &FHand.SourceSize,
+                        &AuthenticationStatus
+                        );
+      CoreImageLoadPhaseEnd (&LoadPhaseTicks[ImageIsFromFv ? ImageLoadPhaseDecompress : ImageLoadPhaseRead], Begin);
+      if (FHand.Source == NULL) {
+        Status = EFI_NOT_FOUND;
+      } else {
+        FHand.FreeBuffer = TRUE;
+        if (ImageIsFromLoadFile) {
+          //
+          // LoadFile () may cause the device path of the Handle be updated.
+          //
+          OriginalFilePath = AppendDevicePath (DevicePathFromHandle (DeviceHandle), Node);
+        }
       }
     }
+    // MU_CHANGE [END]
   }
 
   if (EFI_ERROR (Status)) {
@@ -1252,6 +1425,7 @@ CoreLoadImageCommon (
     goto Done;
   }
 
+  Begin = CoreImageBootCostBegin ();     // MU_CHANGE
   if (gSecurity2 != NULL) {
     //
     // Verify File Authentication through the Security2 Architectural Protocol
@@ -1290,6 +1464,8 @@ CoreLoadImageCommon (
                                   );
   }
 
+  CoreImageLoadPhaseEnd (&LoadPhaseTicks[ImageLoadPhaseAuthenticate], Begin);   // MU_CHANGE
+
   //
   // Check Security Status.
   //
@@ -1335,7 +1511,7 @@ CoreLoadImageCommon (
   Image->Info.Revision     = EFI_LOADED_IMAGE_PROTOCOL_REVISION;
   Image->Info.FilePath     = DuplicateDevicePath (FilePath);
   Image->Info.ParentHandle = ParentImageHandle;
-
+  CopyMem (Image->BootCost.LoadPhaseTicks, LoadPhaseTicks, sizeof (LoadPhaseTicks));   // MU_CHANGE
 
   if (NumberOfPages != NULL) {
     Image->NumberOfPages = *NumberOfPages ;
@@ -1430,7 +1606,10 @@ CoreLoadImageCommon (
       goto Done;
     }
   }
+  Begin = CoreImageBootCostBegin ();     // MU_CHANGE
   ProtectUefiImage (&Image->Info, Image->LoadedImageDevicePath);
+  CoreImageLoadPhaseEnd (&Image->BootCost.LoadPhaseTicks[ImageLoadPhaseProtect], Begin);   // MU_CHANGE
+  CoreImageBootCostRegisterImage (Image);   // MU_CHANGE
 
   //
   // Success.  Return the image handle
@@ -1445,6 +1624,9 @@ Done:
   if (FHand.FreeBuffer) {
     CoreFreePool (FHand.Source);
   }
+  if (FileBuffer != NULL) {
+    CoreFreePool (FileBuffer);      // MU_CHANGE
+  }
   if (OriginalFilePath != InputFilePath) {
     CoreFreePool (OriginalFilePath);
   }
@@ -1583,6 +1765,7 @@ CoreStartImage (
   UINT64                        HandleDatabaseKey;
   UINTN                         SetJumpFlag;
   EFI_HANDLE                    Handle;
+  UINT64                        Begin;    // MU_CHANGE
 
   Handle = ImageHandle;
 
@@ -1656,6 +1839,11 @@ CoreStartImage (
   }
   Image->JumpContext = ALIGN_POINTER (Image->JumpBuffer, BASE_LIBRARY_JUMP_BUFFER_ALIGNMENT);
 
+  //
+  // MU_CHANGE - Begin is not modified between SetJump() and LongJump(), so it
+  // keeps its value when Exit() returns here.
+  //
+  Begin = CoreImageBootCostBegin ();
   SetJumpFlag = SetJump (Image->JumpContext);
   //
   // The initial call to SetJump() must always return 0.
@@ -1688,6 +1876,8 @@ CoreStartImage (
   //
   mCurrentImage = LastImage;
 
+  CoreImageBootCostEnd (Image, ImageBootCostEntryPoint, Begin);   // MU_CHANGE
+
   //
   // UEFI Specification - StartImage() - EFI 1.10 Extension
   // To maintain compatibility with UEFI drivers that are written to the EFI
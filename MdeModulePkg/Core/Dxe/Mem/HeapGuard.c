@@ -10,6 +10,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Imem.h"
 #include "HeapGuard.h"
 
+#include <Library/TimerLib.h>   // MU_CHANGE
+
 //
 // Global to avoid infinite reentrance of memory allocation when updating
 // page table attributes, which may need allocate pages for new PDE/PTE.
@@ -43,6 +45,22 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN mLevelMask[GUARDED_HEAP_MAP_TABLE_DEPTH]
 //
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_PHYSICAL_ADDRESS mLastPromotedPage = BASE_4GB;
 
+// MU_CHANGE [BEGIN] - Cache the last map table lookup and sample guarded allocations.
+//
+// The L4 map table found by the last lookup, and the number of the 256MB map
+// unit it tracks. A map table never moves or gets freed once it is allocated,
+// so the cached pointer stays valid.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64 *mLastGuardedMapTable = NULL;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64 mLastGuardedMapUnit = 0;
+
+//
+// State of the xorshift generator picking the allocations to guard when
+// PcdHeapGuardSampleRate is above 1.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32 mGuardSampleState = 0;
+// MU_CHANGE [END]
+
 /**
   Set corresponding bits in bitmap table to 1 according to the address.
 
@@ -224,6 +242,20 @@ FindGuardedMemoryMap (
   UINTN                   Size;
   UINTN                   BitsToUnitEnd;
   EFI_STATUS              Status;
+  UINT64                  *MapTable;    // MU_CHANGE
+
+  // MU_CHANGE [BEGIN] - Cache the last map table lookup and sample guarded allocations.
+  //
+  // Alloc and free look up the same few pages several times in a row, so
+  // skip the walk if Address falls into the map unit of the last lookup.
+  //
+  if ((mLastGuardedMapTable != NULL) &&
+      (RShiftU64 (Address, GUARDED_HEAP_MAP_TABLE_SHIFT) == mLastGuardedMapUnit)) {
+    *BitMap = mLastGuardedMapTable + GUARDED_HEAP_MAP_ENTRY_INDEX (Address);
+    return GUARDED_HEAP_MAP_BITS - GUARDED_HEAP_MAP_BIT_INDEX (Address);
+  }
+  MapTable = NULL;
+  // MU_CHANGE [END]
 
   MapMemory = 0;
 
@@ -286,12 +318,32 @@ FindGuardedMemoryMap (
       *GuardMap = MapMemory;
     }
 
+    // MU_CHANGE [BEGIN] - Cache the last map table lookup and sample guarded allocations.
+    if (Level == GUARDED_HEAP_MAP_TABLE_DEPTH - 1) {
+      MapTable = (UINT64 *)(UINTN)(*GuardMap);
+    }
+    // MU_CHANGE [END]
+
     Index     = (UINTN)RShiftU64 (Address, mLevelShift[Level]);
     Index     &= mLevelMask[Level];
     GuardMap  = (UINT64 *)(UINTN)((*GuardMap) + Index * sizeof (UINT64));
 
   }
 
+  // MU_CHANGE [BEGIN] - Cache the last map table lookup and sample guarded allocations.
+  //
+  // Only cache a table when the current depth really covers Address. A
+  // lookup beyond it, without AllocMapUnit, does not grow the map and must
+  // not be remembered.
+  //
+  if ((GuardMap != NULL) &&
+      ((mMapLevel == GUARDED_HEAP_MAP_TABLE_DEPTH) ||
+       (RShiftU64 (Address, mLevelShift[GUARDED_HEAP_MAP_TABLE_DEPTH - mMapLevel - 1]) == 0))) {
+    mLastGuardedMapTable = MapTable;
+    mLastGuardedMapUnit  = RShiftU64 (Address, GUARDED_HEAP_MAP_TABLE_SHIFT);
+  }
+  // MU_CHANGE [END]
+
   BitsToUnitEnd = GUARDED_HEAP_MAP_BITS - GUARDED_HEAP_MAP_BIT_INDEX (Address);
   *BitMap       = GuardMap;
 
@@ -673,6 +725,51 @@ IsHeapGuardEnabled (
   return IsMemoryTypeToGuard (EfiMaxMemoryType, AllocateAnyPages, GuardType);
 }
 
+// MU_CHANGE [BEGIN] - Cache the last map table lookup and sample guarded allocations.
+/**
+  Check to see if an allocation which is eligible for Guard is picked by the
+  sampling mode to really get Guard pages.
+
+  If PcdHeapGuardSampleRate is 0 or 1, every eligible allocation is guarded.
+  Otherwise about one in PcdHeapGuardSampleRate of them is, picked by a
+  xorshift generator seeded from the performance counter.
+
+  Only the allocation paths may call this function. The free paths must keep
+  relying on the Guard bitmap, since whether an allocation was sampled is not
+  known at free time otherwise.
+
+  @return TRUE  The allocation should be guarded.
+  @return FALSE The allocation should not be guarded.
+**/
+BOOLEAN
+IsGuardSampleHit (
+  VOID
+  )
+{
+  UINT32  SampleRate;
+  UINT64  Seed;
+
+  SampleRate = PcdGet32 (PcdHeapGuardSampleRate);
+  if (SampleRate <= 1) {
+    return TRUE;
+  }
+
+  if (mGuardSampleState == 0) {
+    Seed              = GetPerformanceCounter ();
+    mGuardSampleState = (UINT32)Seed ^ (UINT32)RShiftU64 (Seed, 32);
+    if (mGuardSampleState == 0) {
+      mGuardSampleState = 0x9E3779B9;
+    }
+  }
+
+  mGuardSampleState ^= mGuardSampleState << 13;
+  mGuardSampleState ^= mGuardSampleState >> 17;
+  mGuardSampleState ^= mGuardSampleState << 5;
+
+  return (BOOLEAN)((mGuardSampleState % SampleRate) == 0);
+}
+// MU_CHANGE [END]
+
 /**
   Set head Guard and tail Guard for the given memory range.
 
@@ -304,6 +304,20 @@ IsPoolTypeToGuard (
   IN EFI_MEMORY_TYPE        MemoryType
   );
 
+// MU_CHANGE [BEGIN] - Sample guarded allocations.
+/**
+  Check to see if an allocation which is eligible for Guard is picked by the
+  sampling mode (PcdHeapGuardSampleRate) to really get Guard pages.
+
+  @return TRUE  The allocation should be guarded.
+  @return FALSE The allocation should not be guarded.
+**/
+BOOLEAN
+IsGuardSampleHit (
+  VOID
+  );
+// MU_CHANGE [END]
+
 /**
   Check to see if the page at the given address should be guarded or not.
 
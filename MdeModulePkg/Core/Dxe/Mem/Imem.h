@@ -93,6 +93,9 @@ CoreFreePoolPages (
   @param  PoolType               Type of pool to allocate
   @param  Size                   The amount of pool to allocate
   @param  NeedGuard              Flag to indicate Guard page is needed or not
+  @param  IsZeroed               If not NULL, the pages of a large allocation may
+                                 be taken from the zeroed page cache, and this
+                                 returns TRUE when the pool is already zero.
 
   @return The allocate pool, or NULL
 
@@ -101,7 +104,8 @@ VOID *
 CoreAllocatePoolI (
   IN EFI_MEMORY_TYPE  PoolType,
   IN UINTN            Size,
-  IN BOOLEAN          NeedGuard
+  IN BOOLEAN          NeedGuard,
+  OUT BOOLEAN         *IsZeroed OPTIONAL    // MU_CHANGE
   );
 
 
@@ -173,6 +177,102 @@ CoreInternalAllocatePages (
   IN BOOLEAN                NeedGuard
   );
 
+// MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+/**
+  Frees previous allocated pages.
+
+  @param  Memory                 Base address of memory being freed
+  @param  NumberOfPages          The number of pages to free
+  @param  MemoryType             Pointer to memory type
+
+  @retval EFI_NOT_FOUND          Could not find the entry that covers the range
+  @retval EFI_INVALID_PARAMETER  Address not aligned
+  @return EFI_SUCCESS         -Pages successfully freed.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreInternalFreePages (
+  IN EFI_PHYSICAL_ADDRESS   Memory,
+  IN UINTN                  NumberOfPages,
+  OUT EFI_MEMORY_TYPE       *MemoryType OPTIONAL
+  );
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Proximity domain hint for page allocations
+/**
+  Internal function. Finds a consecutive free page range below
+  the requested address.
+
+  @param  MaxAddress             The address that the range must be below
+  @param  MinAddress             The address that the range must be above
+  @param  NumberOfPages          Number of pages needed
+  @param  NewType                The type of memory the range is going to be
+                                 turned into
+  @param  Alignment              Bits to align with
+  @param  NeedGuard              Flag to indicate Guard page is needed or not
+
+  @return The base address of the range, or 0 if the range was not found
+
+**/
+UINT64
+CoreFindFreePagesI (
+  IN UINT64           MaxAddress,
+  IN UINT64           MinAddress,
+  IN UINT64           NumberOfPages,
+  IN EFI_MEMORY_TYPE  NewType,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard
+  );
+
+/**
+  Find free pages of the hinted proximity domain.
+
+  The caller must hold the memory lock.
+
+  @param  MaxAddress             The address that the range must be below
+  @param  NoPages                Number of pages needed
+  @param  NewType                The type of memory the range is going to be
+                                 turned into
+  @param  Alignment              Bits to align with
+  @param  NeedGuard              Flag to indicate Guard page is needed or not
+
+  @return The base address of the range, or 0 if no memory of the domain
+          satisfies the request.
+**/
+UINT64
+CoreFindProximityFreePages (
+  IN UINT64           MaxAddress,
+  IN UINT64           NoPages,
+  IN EFI_MEMORY_TYPE  NewType,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard
+  );
+
+extern UINT32             mMemoryProximityHint;
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+/**
+  Take zeroed pages from the cache.
+
+  The pages are already allocated as EfiBootServicesData and protected as
+  such. The caller owns them and frees them with the regular page services.
+
+  @param  MemoryType             The type of memory the pages are for
+  @param  NoPages                Number of pages needed
+
+  @return The base address of the zeroed pages, or NULL if the cache cannot
+          satisfy the request.
+
+**/
+VOID *
+CoreTakeZeroedPages (
+  IN EFI_MEMORY_TYPE  MemoryType,
+  IN UINTN            NoPages
+  );
+// MU_CHANGE [END]
+
 //
 // Internal Global data
 //
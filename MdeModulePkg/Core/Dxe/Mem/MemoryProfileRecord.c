@@ -9,6 +9,8 @@
 #include "DxeMain.h"
 #include "Imem.h"
 
+#include <Library/TimerLib.h>   // MU_CHANGE
+
 #define IS_UEFI_MEMORY_PROFILE_ENABLED ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT0) != 0)
 
 #define GET_OCCUPIED_SIZE(ActualSize, Alignment) \
@@ -63,6 +65,17 @@ GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN mMemoryProfileRecordingEnable = MEMORY_PRO
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_DEVICE_PATH_PROTOCOL *mMemoryProfileDriverPath;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN                    mMemoryProfileDriverPathSize;
 
+// MU_CHANGE [BEGIN] - Fixed size allocation event ring
+//
+// When the ring is allocated, allocate and free actions are only written to the
+// ring. mMemoryProfileEventNext is the ring entry that the next event goes to.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED MEMORY_PROFILE_EVENT     *mMemoryProfileEventRing = NULL;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32                   mMemoryProfileEventRingSize = 0;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32                   mMemoryProfileEventNext = 0;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                   mMemoryProfileEventCount = 0;
+// MU_CHANGE [END]
+
 /**
   Get memory profile data.
 
@@ -577,6 +590,167 @@ RegisterDxeCore (
   return TRUE;
 }
 
+// MU_CHANGE [BEGIN] - Fixed size allocation event ring
+/**
+  Allocate the allocation event ring if PcdMemoryProfileEventRingSize asks for it.
+
+  This is the only allocation the ring does. If it fails, the full alloc info
+  records are kept instead.
+
+**/
+STATIC
+VOID
+MemoryProfileInitEventRing (
+  VOID
+  )
+{
+  UINT32    RingSize;
+  UINT32    Index;
+
+  RingSize = PcdGet32 (PcdMemoryProfileEventRingSize);
+  if (RingSize == 0) {
+    return;
+  }
+
+  mMemoryProfileEventRing = AllocateZeroPool (RingSize * sizeof (MEMORY_PROFILE_EVENT));
+  if (mMemoryProfileEventRing == NULL) {
+    DEBUG ((DEBUG_WARN, "MemoryProfileInit: no memory for %d ring events\n", RingSize));
+    return;
+  }
+
+  //
+  // Fill in the headers now so that recording only writes the event payload.
+  //
+  for (Index = 0; Index < RingSize; Index++) {
+    mMemoryProfileEventRing[Index].Header.Signature = MEMORY_PROFILE_EVENT_SIGNATURE;
+    mMemoryProfileEventRing[Index].Header.Length    = sizeof (MEMORY_PROFILE_EVENT);
+    mMemoryProfileEventRing[Index].Header.Revision  = MEMORY_PROFILE_EVENT_REVISION;
+  }
+  mMemoryProfileEventRingSize = RingSize;
+  mMemoryProfileEventNext     = 0;
+  mMemoryProfileEventCount    = 0;
+}
+
+/**
+  Write one allocate or free action to the allocation event ring.
+
+  The oldest event is overwritten once the ring is full.
+  The caller must hold the memory profile lock.
+
+  @param CallerAddress  Address of caller who call Allocate or Free.
+  @param Action         This Allocate or Free action.
+  @param MemoryType     Memory type.
+  @param Size           Buffer size.
+  @param Buffer         Buffer address.
+
+**/
+STATIC
+VOID
+CoreRecordProfileEvent (
+  IN PHYSICAL_ADDRESS       CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer
+  )
+{
+  MEMORY_PROFILE_EVENT      *Event;
+
+  Event = &mMemoryProfileEventRing[mMemoryProfileEventNext];
+  Event->Action        = Action;
+  Event->MemoryType    = MemoryType;
+  Event->CallerAddress = CallerAddress;
+  Event->Buffer        = (PHYSICAL_ADDRESS) (UINTN) Buffer;
+  Event->Size          = Size;
+  Event->Timestamp     = GetPerformanceCounter ();
+
+  mMemoryProfileEventNext++;
+  if (mMemoryProfileEventNext == mMemoryProfileEventRingSize) {
+    mMemoryProfileEventNext = 0;
+  }
+  mMemoryProfileEventCount++;
+}
+
+/**
+  Get the number of events held in the allocation event ring.
+
+  @return The number of valid ring events.
+
+**/
+STATIC
+UINT32
+MemoryProfileGetEventCount (
+  VOID
+  )
+{
+  if (mMemoryProfileEventCount < mMemoryProfileEventRingSize) {
+    return (UINT32) mMemoryProfileEventCount;
+  }
+
+  return mMemoryProfileEventRingSize;
+}
+
+/**
+  Get the size of the allocation event ring in memory profile data.
+
+  @return Event ring data size, 0 if there is no event ring.
+
+**/
+STATIC
+UINTN
+MemoryProfileGetEventRingSize (
+  VOID
+  )
+{
+  if (mMemoryProfileEventRing == NULL) {
+    return 0;
+  }
+
+  return sizeof (MEMORY_PROFILE_EVENT_RING) + MemoryProfileGetEventCount () * sizeof (MEMORY_PROFILE_EVENT);
+}
+
+/**
+  Copy the allocation event ring to memory profile data, oldest event first.
+
+  @param ProfileBuffer  The buffer to hold the event ring data.
+
+**/
+STATIC
+VOID
+MemoryProfileCopyEventRing (
+  OUT VOID  *ProfileBuffer
+  )
+{
+  MEMORY_PROFILE_EVENT_RING *EventRing;
+  MEMORY_PROFILE_EVENT      *Event;
+  UINT32                    EventCount;
+  UINT32                    Oldest;
+
+  if (mMemoryProfileEventRing == NULL) {
+    return;
+  }
+
+  EventCount = MemoryProfileGetEventCount ();
+
+  EventRing = ProfileBuffer;
+  EventRing->Header.Signature   = MEMORY_PROFILE_EVENT_RING_SIGNATURE;
+  EventRing->Header.Length      = sizeof (MEMORY_PROFILE_EVENT_RING);
+  EventRing->Header.Revision    = MEMORY_PROFILE_EVENT_RING_REVISION;
+  EventRing->EventCount         = EventCount;
+  EventRing->RingSize           = mMemoryProfileEventRingSize;
+  EventRing->TotalEventCount    = mMemoryProfileEventCount;
+  EventRing->TimestampFrequency = GetPerformanceCounterProperties (NULL, NULL);
+
+  //
+  // Once the ring has wrapped, the oldest event is the one written next.
+  //
+  Event  = (MEMORY_PROFILE_EVENT *) (EventRing + 1);
+  Oldest = (EventCount == mMemoryProfileEventRingSize) ? mMemoryProfileEventNext : 0;
+  CopyMem (Event, &mMemoryProfileEventRing[Oldest], (EventCount - Oldest) * sizeof (MEMORY_PROFILE_EVENT));
+  CopyMem (Event + (EventCount - Oldest), mMemoryProfileEventRing, Oldest * sizeof (MEMORY_PROFILE_EVENT));
+}
+// MU_CHANGE [END]
+
 /**
   Initialize memory profile.
 
@@ -607,6 +781,7 @@ MemoryProfileInit (
   }
   mMemoryProfileDriverPathSize = PcdGetSize (PcdMemoryProfileDriverPath);
   mMemoryProfileDriverPath = AllocateCopyPool (mMemoryProfileDriverPathSize, PcdGetPtr (PcdMemoryProfileDriverPath));
+  MemoryProfileInitEventRing ();  // MU_CHANGE
   mMemoryProfileContextPtr = &mMemoryProfileContext;
 
   RegisterDxeCore (HobStart, &mMemoryProfileContext);
@@ -1376,6 +1551,13 @@ CoreUpdateProfile (
   }
 
   CoreAcquireMemoryProfileLock ();
+  // MU_CHANGE [BEGIN] - Fixed size allocation event ring
+  if (mMemoryProfileEventRing != NULL) {
+    CoreRecordProfileEvent (CallerAddress, Action, MemoryType, Size, Buffer);
+    CoreReleaseMemoryProfileLock ();
+    return EFI_SUCCESS;
+  }
+  // MU_CHANGE [END]
   switch (BasicAction) {
     case MemoryProfileActionAllocatePages:
       Status = CoreUpdateProfileAllocate (CallerAddress, Action, MemoryType, Size, Buffer, ActionString);
@@ -1455,6 +1637,8 @@ MemoryProfileGetDataSize (
     }
   }
 
+  TotalSize += MemoryProfileGetEventRingSize ();   // MU_CHANGE
+
   return TotalSize;
 }
 
@@ -1528,6 +1712,8 @@ MemoryProfileCopyData (
 
     DriverInfo = (MEMORY_PROFILE_DRIVER_INFO *)  AllocInfo;
   }
+
+  MemoryProfileCopyEventRing (DriverInfo);    // MU_CHANGE
 }
 
 /**
@@ -0,0 +1,227 @@
+/** @file
+  Proximity domain hint for page allocations.
+
+  The platform describes which memory ranges and PCI buses belong to which
+  proximity domain in a memory proximity HOB. A driver sets a hint through
+  the Memory Proximity Protocol, and CoreInternalAllocatePages() then tries
+  the free memory of that domain first.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Imem.h"
+
+EFI_STATUS
+EFIAPI
+CoreSetAllocationHint (
+  IN  CONST EDKII_MEMORY_PROXIMITY_PROTOCOL  *This,
+  IN        UINT32                           ProximityDomain,
+  OUT       UINT32                           *PreviousDomain OPTIONAL
+  );
+
+EFI_STATUS
+EFIAPI
+CoreGetPciProximityDomain (
+  IN  CONST EDKII_MEMORY_PROXIMITY_PROTOCOL  *This,
+  IN        UINT32                           Segment,
+  IN        UINT8                            Bus,
+  OUT       UINT32                           *ProximityDomain
+  );
+
+EDKII_MEMORY_PROXIMITY_PROTOCOL  mMemoryProximityProtocol = {
+  EDKII_MEMORY_PROXIMITY_PROTOCOL_REVISION,
+  CoreSetAllocationHint,
+  CoreGetPciProximityDomain
+};
+
+EFI_HANDLE                       mMemoryProximityHandle = NULL;
+
+EDKII_MEMORY_PROXIMITY_RANGE     *mMemoryProximityRanges     = NULL;
+UINTN                            mMemoryProximityRangeCount  = 0;
+EDKII_PCI_ROOT_BRIDGE_PROXIMITY  *mPciRootBridgeProximity    = NULL;
+UINTN                            mPciRootBridgeProximityCount = 0;
+UINT32                           mMemoryProximityHint        = EDKII_MEMORY_PROXIMITY_DOMAIN_NONE;
+
+/**
+  Set the proximity domain that page allocations should prefer.
+
+  @param[in]  This                The EDKII_MEMORY_PROXIMITY_PROTOCOL instance.
+  @param[in]  ProximityDomain     The proximity domain to prefer, or
+                                  EDKII_MEMORY_PROXIMITY_DOMAIN_NONE.
+  @param[out] PreviousDomain      The hint before this call. May be NULL.
+
+  @retval EFI_SUCCESS             The hint has been set.
+  @retval EFI_NOT_FOUND           No memory belongs to ProximityDomain. The
+                                  hint has not been changed.
+**/
+EFI_STATUS
+EFIAPI
+CoreSetAllocationHint (
+  IN  CONST EDKII_MEMORY_PROXIMITY_PROTOCOL  *This,
+  IN        UINT32                           ProximityDomain,
+  OUT       UINT32                           *PreviousDomain OPTIONAL
+  )
+{
+  UINTN  Index;
+
+  if (ProximityDomain != EDKII_MEMORY_PROXIMITY_DOMAIN_NONE) {
+    for (Index = 0; Index < mMemoryProximityRangeCount; Index++) {
+      if (mMemoryProximityRanges[Index].ProximityDomain == ProximityDomain) {
+        break;
+      }
+    }
+    if (Index == mMemoryProximityRangeCount) {
+      return EFI_NOT_FOUND;
+    }
+  }
+
+  if (PreviousDomain != NULL) {
+    *PreviousDomain = mMemoryProximityHint;
+  }
+  mMemoryProximityHint = ProximityDomain;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the proximity domain of a PCI bus.
+
+  @param[in]  This                The EDKII_MEMORY_PROXIMITY_PROTOCOL instance.
+  @param[in]  Segment             The PCI segment number.
+  @param[in]  Bus                 The PCI bus number.
+  @param[out] ProximityDomain     The proximity domain of the bus.
+
+  @retval EFI_SUCCESS             ProximityDomain has been returned.
+  @retval EFI_INVALID_PARAMETER   ProximityDomain is NULL.
+  @retval EFI_NOT_FOUND           The platform did not describe this bus.
+**/
+EFI_STATUS
+EFIAPI
+CoreGetPciProximityDomain (
+  IN  CONST EDKII_MEMORY_PROXIMITY_PROTOCOL  *This,
+  IN        UINT32                           Segment,
+  IN        UINT8                            Bus,
+  OUT       UINT32                           *ProximityDomain
+  )
+{
+  UINTN  Index;
+
+  if (ProximityDomain == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < mPciRootBridgeProximityCount; Index++) {
+    if ((mPciRootBridgeProximity[Index].Segment == Segment) &&
+        (mPciRootBridgeProximity[Index].BusBase <= Bus) &&
+        (mPciRootBridgeProximity[Index].BusLimit >= Bus)) {
+      *ProximityDomain = mPciRootBridgeProximity[Index].ProximityDomain;
+      return EFI_SUCCESS;
+    }
+  }
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Find free pages of the hinted proximity domain.
+
+  The caller must hold the memory lock.
+
+  @param  MaxAddress             The address that the range must be below
+  @param  NoPages                Number of pages needed
+  @param  NewType                The type of memory the range is going to be
+                                 turned into
+  @param  Alignment              Bits to align with
+  @param  NeedGuard              Flag to indicate Guard page is needed or not
+
+  @return The base address of the range, or 0 if no memory of the domain
+          satisfies the request.
+**/
+UINT64
+CoreFindProximityFreePages (
+  IN UINT64           MaxAddress,
+  IN UINT64           NoPages,
+  IN EFI_MEMORY_TYPE  NewType,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard
+  )
+{
+  UINTN                         Index;
+  EDKII_MEMORY_PROXIMITY_RANGE  *Range;
+  UINT64                        RangeMax;
+  UINT64                        Start;
+
+  for (Index = 0; Index < mMemoryProximityRangeCount; Index++) {
+    Range = &mMemoryProximityRanges[Index];
+    if ((Range->ProximityDomain != mMemoryProximityHint) ||
+        (Range->Length == 0) ||
+        (Range->BaseAddress > MaxAddress)) {
+      continue;
+    }
+
+    RangeMax = Range->BaseAddress + (Range->Length - 1);
+    if (RangeMax > MaxAddress) {
+      RangeMax = MaxAddress;
+    }
+
+    Start = CoreFindFreePagesI (RangeMax, Range->BaseAddress, NoPages, NewType, Alignment, NeedGuard);
+    if (Start != 0) {
+      return Start;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  Read the memory proximity HOB and install the Memory Proximity Protocol.
+
+  Nothing is installed when the platform did not produce the HOB.
+
+  @param  HobStart               The start address of the HOB list.
+
+**/
+VOID
+CoreInitializeMemoryProximity (
+  IN VOID  *HobStart
+  )
+{
+  EFI_HOB_GUID_TYPE           *GuidHob;
+  EDKII_MEMORY_PROXIMITY_HOB  *ProximityHob;
+  UINTN                       DataSize;
+  EFI_STATUS                  Status;
+
+  GuidHob = GetNextGuidHob (&gEdkiiMemoryProximityHobGuid, HobStart);
+  if (GuidHob == NULL) {
+    return;
+  }
+
+  ProximityHob = GET_GUID_HOB_DATA (GuidHob);
+  DataSize     = GET_GUID_HOB_DATA_SIZE (GuidHob);
+  if ((DataSize < sizeof (EDKII_MEMORY_PROXIMITY_HOB)) ||
+      (ProximityHob->Revision != EDKII_MEMORY_PROXIMITY_HOB_REVISION) ||
+      (DataSize < sizeof (EDKII_MEMORY_PROXIMITY_HOB) +
+                  (UINT64)ProximityHob->MemoryRangeCount * sizeof (EDKII_MEMORY_PROXIMITY_RANGE) +
+                  (UINT64)ProximityHob->RootBridgeCount * sizeof (EDKII_PCI_ROOT_BRIDGE_PROXIMITY))) {
+    DEBUG ((DEBUG_ERROR, "Memory proximity HOB is not valid\n"));
+    return;
+  }
+
+  //
+  // The HOB list stays in memory for the whole DXE phase, so the entries are
+  // used in place.
+  //
+  mMemoryProximityRanges       = EDKII_MEMORY_PROXIMITY_HOB_RANGES (ProximityHob);
+  mMemoryProximityRangeCount   = ProximityHob->MemoryRangeCount;
+  mPciRootBridgeProximity      = EDKII_MEMORY_PROXIMITY_HOB_ROOT_BRIDGES (ProximityHob);
+  mPciRootBridgeProximityCount = ProximityHob->RootBridgeCount;
+
+  Status = CoreInstallMultipleProtocolInterfaces (
+             &mMemoryProximityHandle,
+             &gEdkiiMemoryProximityProtocolGuid,
+             &mMemoryProximityProtocol,
+             NULL
+             );
+  ASSERT_EFI_ERROR (Status);
+}
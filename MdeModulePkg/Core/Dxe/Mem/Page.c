@@ -44,6 +44,13 @@ UINTN         mFreeMapStack = 0;
 ///
 LIST_ENTRY   mFreeMemoryMapEntryList = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN      mMemoryTypeInformationInitialized = FALSE;
+///
+/// The memory map descriptor most recently found or selected. Allocations
+/// convert the descriptor CoreFindFreePagesI() picked and frees usually hit
+/// the descriptor just allocated from, so checking it first avoids a scan of
+/// gMemoryMap. It is only ever NULL or a descriptor linked on gMemoryMap.
+///
+MEMORY_MAP   *mMemoryMapHint = NULL;
 
 EFI_MEMORY_TYPE_STATISTICS mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
@@ -135,6 +142,10 @@ RemoveMemoryMapEntry (
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
+  if (mMemoryMapHint == Entry) {
+    mMemoryMapHint = NULL;
+  }
+
   if (Entry->FromPages) {
     //
     // Insert the free memory map descriptor to the end of mFreeMemoryMapEntryList
@@ -362,6 +373,10 @@ CoreFreeMemoryMapStack (
       CopyMem (Entry , &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
 
+      if (mMemoryMapHint == &mMapStack[mMapDepth]) {
+        mMemoryMapHint = Entry;
+      }
+
       //
       // Find insertion location
       //
@@ -386,6 +401,43 @@ CoreFreeMemoryMapStack (
   mFreeMapStack -= 1;
 }
 
+/**
+  Internal function.  Finds the memory map descriptor that covers the
+  specified address.  The descriptor that was found most recently is checked
+  before the whole of gMemoryMap is searched.
+
+  @param  Address                The address to look up
+
+  @return The descriptor covering Address, or NULL if there is none.
+
+**/
+MEMORY_MAP *
+CoreFindMemoryMapEntry (
+  IN UINT64           Address
+  )
+{
+  LIST_ENTRY      *Link;
+  MEMORY_MAP      *Entry;
+
+  ASSERT_LOCKED (&gMemoryLock);
+
+  if ((mMemoryMapHint != NULL) &&
+      (mMemoryMapHint->Start <= Address) && (mMemoryMapHint->End > Address)) {
+    return mMemoryMapHint;
+  }
+
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+
+    if (Entry->Start <= Address && Entry->End > Address) {
+      mMemoryMapHint = Entry;
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Find untested but initialized memory regions in GCD map and convert them to be DXE allocatable.
 
@@ -736,7 +788,6 @@ CoreConvertPagesEx (
   UINT64          RangeEnd;
   UINT64          Attribute;
   EFI_MEMORY_TYPE MemType;
-  LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
 
   Entry = NULL;
@@ -762,15 +813,8 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-      if (Entry->Start <= Start && Entry->End > Start) {
-        break;
-      }
-    }
-
-    if (Link == &gMemoryMap) {
+    Entry = CoreFindMemoryMapEntry (Start);
+    if (Entry == NULL) {
       DEBUG ((DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));  // MS_CHANGE_316852
       return EFI_NOT_FOUND;
     }
@@ -1041,6 +1085,7 @@ CoreFindFreePagesI (
   UINT64          DescNumberOfBytes;
   LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
+  MEMORY_MAP      *TargetEntry;
 
   if ((MaxAddress < EFI_PAGE_MASK) ||(NumberOfPages == 0)) {
     return 0;
@@ -1070,6 +1115,7 @@ CoreFindFreePagesI (
 
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target = 0;
+  TargetEntry = NULL;
 
   for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
     Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
@@ -1135,6 +1181,7 @@ CoreFindFreePagesI (
         }
 
         Target = DescEnd;
+        TargetEntry = Entry;
       }
     }
   }
@@ -1151,6 +1198,11 @@ CoreFindFreePagesI (
     return 0;
   }
 
+  //
+  // The caller converts the range next, so remember where it lives
+  //
+  mMemoryMapHint = TargetEntry;
+
   return Target;
 }
 
@@ -1378,8 +1430,22 @@ CoreInternalAllocatePages (
   // If not a specific address, then find an address to allocate
   //
   if (Type != AllocateAddress) {
-    Start = FindFreePages (MaxAddress, NumberOfPages, MemoryType, Alignment,
-                           NeedGuard);
+    // MU_CHANGE [BEGIN] - Proximity domain hint for page allocations
+    //
+    // Memory types kept in fixed bins must stay in their bins, so the hint
+    // only applies to the other types.
+    //
+    Start = 0;
+    if ((mMemoryProximityHint != EDKII_MEMORY_PROXIMITY_DOMAIN_NONE) &&
+        ((UINT32)MemoryType < EfiMaxMemoryType) &&
+        !mMemoryTypeStatistics[MemoryType].Special) {
+      Start = CoreFindProximityFreePages (MaxAddress, NumberOfPages, MemoryType, Alignment, NeedGuard);
+    }
+    if (Start == 0) {
+      Start = FindFreePages (MaxAddress, NumberOfPages, MemoryType, Alignment,
+                             NeedGuard);
+    }
+    // MU_CHANGE [END]
     if (Start == 0) {
       Status = EFI_OUT_OF_RESOURCES;
       goto Done;
@@ -1438,7 +1504,7 @@ CoreAllocatePages (
   EFI_STATUS  Status;
   BOOLEAN     NeedGuard;
 
-  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding;
+  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding && IsGuardSampleHit ();   // MU_CHANGE
   Status = CoreInternalAllocatePages (Type, MemoryType, NumberOfPages, Memory,
                                       NeedGuard);
   if (!EFI_ERROR (Status)) {
@@ -1478,7 +1544,6 @@ CoreInternalFreePages (
   )
 {
   EFI_STATUS      Status;
-  LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
   UINTN           Alignment;
   BOOLEAN         IsGuarded;
@@ -1492,14 +1557,8 @@ CoreInternalFreePages (
   // Find the entry that the covers the range
   //
   IsGuarded = FALSE;
-  Entry = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR(Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if (Entry->Start <= Memory && Entry->End > Memory) {
-        break;
-    }
-  }
-  if (Link == &gMemoryMap) {
+  Entry = CoreFindMemoryMapEntry (Memory);
+  if (Entry == NULL) {
     Status = EFI_NOT_FOUND;
     goto Done;
   }
@@ -165,7 +165,7 @@ LookupPoolHead (
       }
     }
 
-    Pool = CoreAllocatePoolI (EfiBootServicesData, sizeof (POOL), FALSE);
+    Pool = CoreAllocatePoolI (EfiBootServicesData, sizeof (POOL), FALSE, NULL);    // MU_CHANGE
     if (Pool == NULL) {
       return NULL;
     }
@@ -187,11 +187,13 @@ LookupPoolHead (
 
 
 
+// MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
 /**
-  Allocate pool of a particular type.
+  Allocate pool of a particular type, and optionally clear it.
 
   @param  PoolType               Type of pool to allocate
   @param  Size                   The amount of pool to allocate
+  @param  NeedZero               TRUE if the pool must be cleared
   @param  Buffer                 The address to return a pointer to the allocated
                                  pool
 
@@ -202,16 +204,19 @@ LookupPoolHead (
   @retval EFI_SUCCESS            Pool successfully allocated.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-CoreInternalAllocatePool (
+CoreAllocatePoolWorker (
   IN EFI_MEMORY_TYPE  PoolType,
   IN UINTN            Size,
+  IN BOOLEAN          NeedZero,
   OUT VOID            **Buffer
   )
 {
   EFI_STATUS            Status;
   BOOLEAN               NeedGuard;
+  BOOLEAN               IsZeroed;
+// MU_CHANGE [END]
 
   //
   // If it's not a valid type, fail it
@@ -235,7 +240,7 @@ CoreInternalAllocatePool (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding;
+  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding && IsGuardSampleHit ();   // MU_CHANGE
 
   //
   // Acquire the memory lock and make the allocation
@@ -245,11 +250,94 @@ CoreInternalAllocatePool (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  *Buffer = CoreAllocatePoolI (PoolType, Size, NeedGuard);
+  // MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+  IsZeroed = FALSE;
+  *Buffer  = CoreAllocatePoolI (PoolType, Size, NeedGuard, NeedZero ? &IsZeroed : NULL);
   CoreReleaseLock (&mPoolMemoryLock);
-  return (*Buffer != NULL) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+  if (*Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Clear the pool after the lock is released, so that other allocations do
+  // not wait for it.
+  //
+  if (NeedZero && !IsZeroed) {
+    ZeroMem (*Buffer, Size);
+  }
+  return EFI_SUCCESS;
 }
 
+/**
+  Allocate pool of a particular type.
+
+  @param  PoolType               Type of pool to allocate
+  @param  Size                   The amount of pool to allocate
+  @param  Buffer                 The address to return a pointer to the allocated
+                                 pool
+
+  @retval EFI_INVALID_PARAMETER  Buffer is NULL.
+                                 PoolType is in the range EfiMaxMemoryType..0x6FFFFFFF.
+                                 PoolType is EfiPersistentMemory.
+  @retval EFI_OUT_OF_RESOURCES   Size exceeds max pool size or allocation failed.
+  @retval EFI_SUCCESS            Pool successfully allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreInternalAllocatePool (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            Size,
+  OUT VOID            **Buffer
+  )
+{
+  return CoreAllocatePoolWorker (PoolType, Size, FALSE, Buffer);
+}
+
+/**
+  Allocate and clear pool of a particular type.
+
+  Large allocations of EfiBootServicesData are taken from the zeroed page
+  cache when it has pages available, and are not cleared again.
+
+  @param  PoolType               Type of pool to allocate
+  @param  Size                   The amount of pool to allocate
+  @param  Buffer                 The address to return a pointer to the allocated
+                                 pool
+
+  @retval EFI_INVALID_PARAMETER  Buffer is NULL.
+                                 PoolType is in the range EfiMaxMemoryType..0x6FFFFFFF.
+                                 PoolType is EfiPersistentMemory.
+  @retval EFI_OUT_OF_RESOURCES   Size exceeds max pool size or allocation failed.
+  @retval EFI_SUCCESS            Pool successfully allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreAllocateZeroPool (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            Size,
+  OUT VOID            **Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = CoreAllocatePoolWorker (PoolType, Size, TRUE, Buffer);
+  if (!EFI_ERROR (Status)) {
+    CoreUpdateProfile (
+      (EFI_PHYSICAL_ADDRESS) (UINTN) RETURN_ADDRESS (0),
+      MemoryProfileActionAllocatePool,
+      PoolType,
+      Size,
+      *Buffer,
+      NULL
+      );
+    InstallMemoryAttributesTableOnMemoryAllocation (PoolType);
+  }
+  return Status;
+}
+// MU_CHANGE [END]
+
 /**
   Allocate pool of a particular type.
 
@@ -339,6 +427,9 @@ CoreAllocatePoolPagesI (
   @param  PoolType               Type of pool to allocate
   @param  Size                   The amount of pool to allocate
   @param  NeedGuard              Flag to indicate Guard page is needed or not
+  @param  IsZeroed               If not NULL, the pages of a large allocation may
+                                 be taken from the zeroed page cache, and this
+                                 returns TRUE when the pool is already zero.
 
   @return The allocate pool, or NULL
 
@@ -347,7 +438,8 @@ VOID *
 CoreAllocatePoolI (
   IN EFI_MEMORY_TYPE  PoolType,
   IN UINTN            Size,
-  IN BOOLEAN          NeedGuard
+  IN BOOLEAN          NeedGuard,
+  OUT BOOLEAN         *IsZeroed OPTIONAL    // MU_CHANGE
   )
 {
   POOL        *Pool;
@@ -409,7 +501,15 @@ CoreAllocatePoolI (
     }
     NoPages = EFI_SIZE_TO_PAGES (Size) + EFI_SIZE_TO_PAGES (Granularity) - 1;
     NoPages &= ~(UINTN)(EFI_SIZE_TO_PAGES (Granularity) - 1);
-    Head = CoreAllocatePoolPagesI (PoolType, NoPages, Granularity, NeedGuard);
+    // MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+    if ((IsZeroed != NULL) && !NeedGuard && !PageAsPool) {
+      Head      = CoreTakeZeroedPages (PoolType, NoPages);
+      *IsZeroed = (Head != NULL);
+    }
+    if (Head == NULL) {
+      Head = CoreAllocatePoolPagesI (PoolType, NoPages, Granularity, NeedGuard);
+    }
+    // MU_CHANGE [END]
     if (NeedGuard) {
       Head = AdjustPoolHeadA ((EFI_PHYSICAL_ADDRESS)(UINTN)Head, NoPages, Size);
     }
@@ -424,6 +524,17 @@ CoreAllocatePoolI (
     Offset = LIST_TO_SIZE (Index);
     MaxOffset = Granularity;
 
+    //
+    // Small size classes may be refilled slab style: a fresh page is carved
+    // into blocks of the requested size (any tail goes to the smaller bins),
+    // so a run of same-sized allocations is served from the free list instead
+    // of splitting larger bins again on every miss.
+    //
+    if (LIST_TO_SIZE (Index) <= PcdGet32 (PcdPoolSlabCarveMaxSize)) {
+      Index++;
+      goto AllocatePage;
+    }
+
     //
     // Check the bins holding larger blocks, and carve one up if needed
     //
@@ -440,6 +551,7 @@ CoreAllocatePoolI (
     //
     // Get another page
     //
+AllocatePage:
     NewPage = CoreAllocatePoolPagesI (PoolType, EFI_SIZE_TO_PAGES (Granularity),
                                       Granularity, NeedGuard);
     if (NewPage == NULL) {
@@ -510,7 +622,11 @@ Done:
       Size -= SIZE_OF_POOL_HEAD;
     }
 
-    DEBUG_CLEAR_MEMORY (Buffer, Size);
+    // MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+    if ((IsZeroed == NULL) || !*IsZeroed) {
+      DEBUG_CLEAR_MEMORY (Buffer, Size);
+    }
+    // MU_CHANGE [END]
 
     DEBUG ((
       DEBUG_POOL,
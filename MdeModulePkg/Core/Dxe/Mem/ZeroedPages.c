@@ -0,0 +1,193 @@
+/** @file
+  Cache of zeroed pages for zero pool allocations.
+
+  When PcdDxeZeroedPageCacheSize is not 0, the DXE core keeps a few 2MB blocks
+  of EfiBootServicesData memory that are already zero. The blocks are
+  allocated and cleared from the idle loop, so the time spent clearing memory
+  moves out of the allocation path. CoreAllocateZeroPool() takes the pages of
+  a large allocation from these blocks and skips the ZeroMem().
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Imem.h"
+
+#define ZEROED_PAGE_BLOCK_PAGES    EFI_SIZE_TO_PAGES (SIZE_2MB)
+#define ZEROED_PAGE_REFILL_PAGES   (ZEROED_PAGE_BLOCK_PAGES / 8)
+#define ZEROED_PAGE_MAX_BLOCKS     16
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS  BaseAddress;
+  UINTN                 Pages;
+} ZEROED_PAGE_BLOCK;
+
+EFI_LOCK           mZeroedPageLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
+ZEROED_PAGE_BLOCK  mZeroedPageBlocks[ZEROED_PAGE_MAX_BLOCKS];
+UINTN              mZeroedPageBlockCount = 0;
+EFI_EVENT          mZeroedPageFillEvent  = NULL;
+
+/**
+  Take zeroed pages from the cache.
+
+  The pages are already allocated as EfiBootServicesData and protected as
+  such. The caller owns them and frees them with the regular page services.
+
+  @param  MemoryType             The type of memory the pages are for
+  @param  NoPages                Number of pages needed
+
+  @return The base address of the zeroed pages, or NULL if the cache cannot
+          satisfy the request.
+
+**/
+VOID *
+CoreTakeZeroedPages (
+  IN EFI_MEMORY_TYPE  MemoryType,
+  IN UINTN            NoPages
+  )
+{
+  ZEROED_PAGE_BLOCK  *Block;
+  UINTN              Index;
+  VOID               *Buffer;
+
+  if ((mZeroedPageBlockCount == 0) ||
+      (MemoryType != EfiBootServicesData) ||
+      (NoPages == 0) ||
+      (NoPages > ZEROED_PAGE_BLOCK_PAGES)) {
+    return NULL;
+  }
+
+  CoreAcquireLock (&mZeroedPageLock);
+
+  //
+  // Use the smallest block that fits, so that the larger blocks stay
+  // available for larger requests.
+  //
+  Block = NULL;
+  for (Index = 0; Index < mZeroedPageBlockCount; Index++) {
+    if ((mZeroedPageBlocks[Index].Pages >= NoPages) &&
+        ((Block == NULL) || (mZeroedPageBlocks[Index].Pages < Block->Pages))) {
+      Block = &mZeroedPageBlocks[Index];
+    }
+  }
+
+  Buffer = NULL;
+  if (Block != NULL) {
+    Buffer              = (VOID *)(UINTN)Block->BaseAddress;
+    Block->BaseAddress += EFI_PAGES_TO_SIZE (NoPages);
+    Block->Pages       -= NoPages;
+  }
+
+  CoreReleaseLock (&mZeroedPageLock);
+  return Buffer;
+}
+
+/**
+  Refill one block of the zeroed page cache.
+
+  This is called from the idle loop. A block that has fewer than
+  ZEROED_PAGE_REFILL_PAGES pages left is replaced by a new zeroed block, and
+  its remaining pages are freed.
+
+  @param  Event                  The idle loop event.
+  @param  Context                Not used.
+
+**/
+VOID
+EFIAPI
+CoreFillZeroedPages (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Index;
+  EFI_PHYSICAL_ADDRESS  Memory;
+  EFI_PHYSICAL_ADDRESS  OldBaseAddress;
+  UINTN                 OldPages;
+
+  for (Index = 0; Index < mZeroedPageBlockCount; Index++) {
+    if (mZeroedPageBlocks[Index].Pages < ZEROED_PAGE_REFILL_PAGES) {
+      break;
+    }
+  }
+  if (Index == mZeroedPageBlockCount) {
+    return;
+  }
+
+  Status = CoreInternalAllocatePages (
+             AllocateAnyPages,
+             EfiBootServicesData,
+             ZEROED_PAGE_BLOCK_PAGES,
+             &Memory,
+             FALSE
+             );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  ApplyMemoryProtectionPolicy (EfiConventionalMemory, EfiBootServicesData, Memory,
+    EFI_PAGES_TO_SIZE (ZEROED_PAGE_BLOCK_PAGES));
+  ZeroMem ((VOID *)(UINTN)Memory, EFI_PAGES_TO_SIZE (ZEROED_PAGE_BLOCK_PAGES));
+
+  //
+  // The block may have been used while the new one was cleared, so its
+  // remaining pages are only read under the lock.
+  //
+  CoreAcquireLock (&mZeroedPageLock);
+  OldBaseAddress                        = mZeroedPageBlocks[Index].BaseAddress;
+  OldPages                              = mZeroedPageBlocks[Index].Pages;
+  mZeroedPageBlocks[Index].BaseAddress  = Memory;
+  mZeroedPageBlocks[Index].Pages        = ZEROED_PAGE_BLOCK_PAGES;
+  CoreReleaseLock (&mZeroedPageLock);
+
+  if (OldPages != 0) {
+    Status = CoreInternalFreePages (OldBaseAddress, OldPages, NULL);
+    if (!EFI_ERROR (Status)) {
+      ApplyMemoryProtectionPolicy (EfiBootServicesData, EfiConventionalMemory, OldBaseAddress,
+        EFI_PAGES_TO_SIZE (OldPages));
+    }
+  }
+}
+
+/**
+  Set up the zeroed page cache.
+
+  The cache is filled from the idle loop. Nothing is done when
+  PcdDxeZeroedPageCacheSize is 0.
+
+**/
+VOID
+CoreInitializeZeroedPageCache (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       BlockCount;
+
+  BlockCount = EFI_SIZE_TO_PAGES ((UINTN)PcdGet32 (PcdDxeZeroedPageCacheSize));
+  BlockCount = (BlockCount + ZEROED_PAGE_BLOCK_PAGES - 1) / ZEROED_PAGE_BLOCK_PAGES;
+  if (BlockCount == 0) {
+    return;
+  }
+  if (BlockCount > ZEROED_PAGE_MAX_BLOCKS) {
+    BlockCount = ZEROED_PAGE_MAX_BLOCKS;
+  }
+
+  Status = CoreCreateEventEx (
+             EVT_NOTIFY_SIGNAL,
+             TPL_CALLBACK,
+             CoreFillZeroedPages,
+             NULL,
+             &gIdleLoopEventGuid,
+             &mZeroedPageFillEvent
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Zeroed page cache cannot be set up - %r\n", Status));
+    return;
+  }
+
+  mZeroedPageBlockCount = BlockCount;
+}
@@ -0,0 +1,403 @@
+/** @file
+  Boot cost accounting of the DXE images.
+
+  When performance measurement is enabled, the DXE core times the phases of
+  the load of each image, its entry point, the Supported() and Start()
+  services of its driver binding protocols and its event notification
+  functions, and accumulates the times in the image private data. At
+  ReadyToBoot the accumulated costs are published in the
+  EDKII_IMAGE_BOOT_COST_TABLE configuration table.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include <Library/TimerLib.h>
+#include <Guid/ImageBootCost.h>
+
+//
+// Number of images with the highest cost shown in the debug log
+//
+#define IMAGE_BOOT_COST_DEBUG_COUNT  10
+
+//
+// The images that are loaded, to find the image of an event notification
+// function. Notification functions may look an image up at any TPL, so the
+// list is protected at TPL_HIGH_LEVEL.
+//
+EFI_LOCK    mImageBootCostLock    = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
+LIST_ENTRY  mImageBootCostList    = INITIALIZE_LIST_HEAD_VARIABLE (mImageBootCostList);
+BOOLEAN     mImageBootCostEnabled = FALSE;
+BOOLEAN     mImageBootCostCountUp = TRUE;
+
+EDKII_IMAGE_BOOT_COST_TABLE  *mImageBootCostTable = NULL;
+
+/**
+  Start timing a call into an image.
+
+  @return The current value of the performance counter, or 0 when the boot
+          cost is not accounted.
+
+**/
+UINT64
+CoreImageBootCostBegin (
+  VOID
+  )
+{
+  if (!mImageBootCostEnabled) {
+    return 0;
+  }
+
+  return GetPerformanceCounter ();
+}
+
+/**
+  Account the time of a call into an image.
+
+  @param  Image                  The image called, or NULL if unknown.
+  @param  Type                   The kind of call.
+  @param  Begin                  The value returned by CoreImageBootCostBegin()
+                                 before the call.
+
+**/
+VOID
+CoreImageBootCostEnd (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image,
+  IN IMAGE_BOOT_COST_TYPE       Type,
+  IN UINT64                     Begin
+  )
+{
+  UINT64  End;
+  UINT64  Ticks;
+
+  if ((Begin == 0) || (Image == NULL)) {
+    return;
+  }
+
+  End   = GetPerformanceCounter ();
+  Ticks = mImageBootCostCountUp ? (End - Begin) : (Begin - End);
+
+  switch (Type) {
+    case ImageBootCostEntryPoint:
+      Image->BootCost.EntryPointTicks += Ticks;
+      break;
+    case ImageBootCostSupported:
+      Image->BootCost.SupportedTicks += Ticks;
+      Image->BootCost.SupportedCount++;
+      break;
+    case ImageBootCostStart:
+      Image->BootCost.StartTicks += Ticks;
+      Image->BootCost.StartCount++;
+      break;
+    case ImageBootCostNotify:
+      Image->BootCost.NotifyTicks += Ticks;
+      Image->BootCost.NotifyCount++;
+      break;
+    default:
+      ASSERT (FALSE);
+      break;
+  }
+}
+
+/**
+  Account the time of a phase of the load of an image.
+
+  @param  Ticks                  The ticks of the phase, updated.
+  @param  Begin                  The value returned by CoreImageBootCostBegin()
+                                 before the phase.
+
+**/
+VOID
+CoreImageLoadPhaseEnd (
+  IN OUT UINT64  *Ticks,
+  IN     UINT64  Begin
+  )
+{
+  UINT64  End;
+
+  if (Begin == 0) {
+    return;
+  }
+
+  End     = GetPerformanceCounter ();
+  *Ticks += mImageBootCostCountUp ? (End - Begin) : (Begin - End);
+}
+
+/**
+  Add a loaded image to the images whose boot cost is accounted.
+
+  @param  Image                  The image.
+
+**/
+VOID
+CoreImageBootCostRegisterImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  )
+{
+  CoreAcquireLock (&mImageBootCostLock);
+  InsertTailList (&mImageBootCostList, &Image->BootCost.Link);
+  CoreReleaseLock (&mImageBootCostLock);
+}
+
+/**
+  Remove an image that is unloaded from the images whose boot cost is
+  accounted. Its cost is lost.
+
+  @param  Image                  The image.
+
+**/
+VOID
+CoreImageBootCostUnregisterImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  )
+{
+  if (Image->BootCost.Link.ForwardLink == NULL) {
+    return;
+  }
+
+  CoreAcquireLock (&mImageBootCostLock);
+  RemoveEntryList (&Image->BootCost.Link);
+  CoreReleaseLock (&mImageBootCostLock);
+  Image->BootCost.Link.ForwardLink = NULL;
+}
+
+/**
+  Find the image an address, such as the one of an event notification
+  function, belongs to.
+
+  @param  Address                The address.
+
+  @return The image, or NULL if the address isn't in a loaded image or the boot
+          cost is not accounted.
+
+**/
+LOADED_IMAGE_PRIVATE_DATA *
+CoreImageBootCostFindImage (
+  IN VOID  *Address
+  )
+{
+  LIST_ENTRY                 *Link;
+  LOADED_IMAGE_PRIVATE_DATA  *Image;
+  LOADED_IMAGE_PRIVATE_DATA  *Found;
+
+  if (!mImageBootCostEnabled) {
+    return NULL;
+  }
+
+  Found = NULL;
+  CoreAcquireLock (&mImageBootCostLock);
+  for (Link = mImageBootCostList.ForwardLink; Link != &mImageBootCostList; Link = Link->ForwardLink) {
+    Image = BASE_CR (Link, LOADED_IMAGE_PRIVATE_DATA, BootCost.Link);
+    if (((UINTN)Address >= (UINTN)Image->Info.ImageBase) &&
+        ((UINTN)Address < (UINTN)Image->Info.ImageBase + Image->Info.ImageSize))
+    {
+      Found = Image;
+      break;
+    }
+  }
+
+  CoreReleaseLock (&mImageBootCostLock);
+  return Found;
+}
+
+/**
+  Fill in the boot cost table entry of an image.
+
+  @param  Image                  The image.
+  @param  Entry                  The table entry.
+
+**/
+STATIC
+VOID
+FillImageBootCostEntry (
+  IN  LOADED_IMAGE_PRIVATE_DATA    *Image,
+  OUT EDKII_IMAGE_BOOT_COST_ENTRY  *Entry
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  EFI_GUID                  *FileName;
+
+  ZeroMem (Entry, sizeof (*Entry));
+
+  //
+  // The FFS file name is the last node of the image file path.
+  //
+  FileName   = NULL;
+  DevicePath = Image->Info.FilePath;
+  if (DevicePath != NULL) {
+    while (!IsDevicePathEnd (DevicePath)) {
+      FileName   = EfiGetNameGuidFromFwVolDevicePathNode ((MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)DevicePath);
+      DevicePath = NextDevicePathNode (DevicePath);
+    }
+  }
+
+  if (FileName != NULL) {
+    CopyGuid (&Entry->FileName, FileName);
+  } else if (Image->Handle == gDxeCoreImageHandle) {
+    CopyGuid (&Entry->FileName, &gEfiCallerIdGuid);
+  }
+
+  Entry->ImageBase      = (EFI_PHYSICAL_ADDRESS)(UINTN)Image->Info.ImageBase;
+  Entry->ImageSize      = Image->Info.ImageSize;
+  Entry->EntryPointTime = GetTimeInNanoSecond (Image->BootCost.EntryPointTicks);
+  Entry->SupportedTime  = GetTimeInNanoSecond (Image->BootCost.SupportedTicks);
+  Entry->StartTime      = GetTimeInNanoSecond (Image->BootCost.StartTicks);
+  Entry->NotifyTime     = GetTimeInNanoSecond (Image->BootCost.NotifyTicks);
+  Entry->SupportedCount = Image->BootCost.SupportedCount;
+  Entry->StartCount     = Image->BootCost.StartCount;
+  Entry->NotifyCount    = Image->BootCost.NotifyCount;
+
+  Entry->LocateTime       = GetTimeInNanoSecond (Image->BootCost.LoadPhaseTicks[ImageLoadPhaseLocate]);
+  Entry->ReadTime         = GetTimeInNanoSecond (Image->BootCost.LoadPhaseTicks[ImageLoadPhaseRead]);
+  Entry->DecompressTime   = GetTimeInNanoSecond (Image->BootCost.LoadPhaseTicks[ImageLoadPhaseDecompress]);
+  Entry->AuthenticateTime = GetTimeInNanoSecond (Image->BootCost.LoadPhaseTicks[ImageLoadPhaseAuthenticate]);
+  Entry->LoadTime         = GetTimeInNanoSecond (Image->BootCost.LoadPhaseTicks[ImageLoadPhaseLoad]);
+  Entry->RelocateTime     = GetTimeInNanoSecond (Image->BootCost.LoadPhaseTicks[ImageLoadPhaseRelocate]);
+  Entry->ProtectTime      = GetTimeInNanoSecond (Image->BootCost.LoadPhaseTicks[ImageLoadPhaseProtect]);
+
+  Entry->TotalTime = Entry->EntryPointTime + Entry->SupportedTime + Entry->StartTime + Entry->NotifyTime +
+                     Entry->LocateTime + Entry->ReadTime + Entry->DecompressTime + Entry->AuthenticateTime +
+                     Entry->LoadTime + Entry->RelocateTime + Entry->ProtectTime;
+}
+
+/**
+  Publish the boot cost of the images at ReadyToBoot.
+
+  The table is rebuilt each time ReadyToBoot is signaled, so a boot option
+  that returns to the boot manager is accounted in the next table.
+
+  @param  Event                  The Event this notify function registered to.
+  @param  Context                Pointer to the context data registered to the Event.
+
+**/
+VOID
+EFIAPI
+PublishImageBootCostOnReadyToBoot (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS                   Status;
+  LIST_ENTRY                   *Link;
+  UINTN                        Count;
+  UINTN                        Index;
+  UINTN                        Index2;
+  UINTN                        Length;
+  EDKII_IMAGE_BOOT_COST_TABLE  *Table;
+  EDKII_IMAGE_BOOT_COST_ENTRY  *Entries;
+  EDKII_IMAGE_BOOT_COST_ENTRY  Entry;
+
+  //
+  // Images are only loaded and unloaded at TPL_CALLBACK or below, so the list
+  // doesn't change while this runs.
+  //
+  Count = 0;
+  for (Link = mImageBootCostList.ForwardLink; Link != &mImageBootCostList; Link = Link->ForwardLink) {
+    Count++;
+  }
+
+  Length = sizeof (EDKII_IMAGE_BOOT_COST_TABLE) + Count * sizeof (EDKII_IMAGE_BOOT_COST_ENTRY);
+  Status = CoreAllocatePool (EfiACPIReclaimMemory, Length, (VOID **)&Table);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: out of resources for %d images\n", __FUNCTION__, Count));
+    return;
+  }
+
+  Table->Signature  = EDKII_IMAGE_BOOT_COST_TABLE_SIGNATURE;
+  Table->Revision   = EDKII_IMAGE_BOOT_COST_TABLE_REVISION;
+  Table->Length     = (UINT32)Length;
+  Table->EntryCount = (UINT32)Count;
+  Entries           = (EDKII_IMAGE_BOOT_COST_ENTRY *)(Table + 1);
+
+  //
+  // Sort the entries from the highest cost to the lowest, by insertion.
+  //
+  Index = 0;
+  for (Link = mImageBootCostList.ForwardLink; Link != &mImageBootCostList; Link = Link->ForwardLink) {
+    FillImageBootCostEntry (BASE_CR (Link, LOADED_IMAGE_PRIVATE_DATA, BootCost.Link), &Entry);
+    for (Index2 = Index; Index2 > 0 && Entries[Index2 - 1].TotalTime < Entry.TotalTime; Index2--) {
+      CopyMem (&Entries[Index2], &Entries[Index2 - 1], sizeof (Entry));
+    }
+
+    CopyMem (&Entries[Index2], &Entry, sizeof (Entry));
+    Index++;
+  }
+
+  DEBUG_CODE_BEGIN ();
+  DEBUG ((DEBUG_INFO, "Images with the highest boot cost:\n"));
+  for (Index = 0; Index < Count && Index < IMAGE_BOOT_COST_DEBUG_COUNT; Index++) {
+    DEBUG ((
+      DEBUG_INFO,
+      "  %g %8ld us (load %ld, entry %ld, supported %ld x%d, start %ld x%d, notify %ld x%d)\n",
+      &Entries[Index].FileName,
+      DivU64x32 (Entries[Index].TotalTime, 1000),
+      DivU64x32 (
+        Entries[Index].LocateTime + Entries[Index].ReadTime + Entries[Index].DecompressTime +
+        Entries[Index].AuthenticateTime + Entries[Index].LoadTime + Entries[Index].RelocateTime +
+        Entries[Index].ProtectTime,
+        1000
+        ),
+      DivU64x32 (Entries[Index].EntryPointTime, 1000),
+      DivU64x32 (Entries[Index].SupportedTime, 1000),
+      Entries[Index].SupportedCount,
+      DivU64x32 (Entries[Index].StartTime, 1000),
+      Entries[Index].StartCount,
+      DivU64x32 (Entries[Index].NotifyTime, 1000),
+      Entries[Index].NotifyCount
+      ));
+  }
+  DEBUG_CODE_END ();
+
+  Status = CoreInstallConfigurationTable (&gEdkiiImageBootCostTableGuid, Table);
+  if (EFI_ERROR (Status)) {
+    CoreFreePool (Table);
+    return;
+  }
+
+  if (mImageBootCostTable != NULL) {
+    CoreFreePool (mImageBootCostTable);
+  }
+
+  mImageBootCostTable = Table;
+}
+
+/**
+  Start the boot cost accounting of the images, if performance measurement is
+  enabled.
+
+**/
+VOID
+CoreInitializeImageBootCost (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   ReadyToBootEvent;
+  UINT64      StartValue;
+  UINT64      EndValue;
+
+  if (!PerformanceMeasurementEnabled ()) {
+    return;
+  }
+
+  if (GetPerformanceCounterProperties (&StartValue, &EndValue) == 0) {
+    return;
+  }
+
+  mImageBootCostCountUp = (BOOLEAN)(EndValue >= StartValue);
+
+  Status = CoreCreateEventInternal (
+             EVT_NOTIFY_SIGNAL,
+             TPL_CALLBACK,
+             PublishImageBootCostOnReadyToBoot,
+             NULL,
+             &gEfiEventReadyToBootGuid,
+             &ReadyToBootEvent
+             );
+  ASSERT_EFI_ERROR (Status);
+  if (!EFI_ERROR (Status)) {
+    mImageBootCostEnabled = TRUE;
+  }
+}
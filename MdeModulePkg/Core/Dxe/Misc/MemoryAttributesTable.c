@@ -23,10 +23,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "HeapGuard.h"
 
 /**
-  This function for GetMemoryMap() with properties table capability.
+  This function for GetMemoryMap() with properties table capability, returning
+  the runtime entries only.
 
-  It calls original GetMemoryMap() to get the original memory map information. Then
-  plus the additional memory map entries for PE Code/Data seperation.
+  It calls original GetMemoryMap() to get the original memory map information.
+  Then it drops every entry that is not EfiRuntimeServicesCode or
+  EfiRuntimeServicesData, and adds the additional memory map entries for PE Code/Data
+  seperation. Only runtime images have image records, so dropping the other
+  entries first keeps the split, sort and merge down to the entries that go into
+  the Memory Attributes Table.
 
   @param  MemoryMapSize          A pointer to the size, in bytes, of the
                                  MemoryMap buffer. On input, this is the size of
@@ -54,9 +59,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   @retval EFI_INVALID_PARAMETER  One of the parameters has an invalid value.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-CoreGetMemoryMapWithSeparatedImageSection (
+CoreGetRuntimeMemoryMapWithSeparatedImageSection (   // MU_CHANGE
   IN OUT UINTN                  *MemoryMapSize,
   IN OUT EFI_MEMORY_DESCRIPTOR  *MemoryMap,
   OUT UINTN                     *MapKey,
@@ -90,6 +95,18 @@ BOOLEAN                      mMemoryAttributesTableEndOfDxe = FALSE;
 EFI_MEMORY_ATTRIBUTES_TABLE  *mMemoryAttributesTable = NULL;
 BOOLEAN                      mMemoryAttributesTableReadyToBoot = FALSE;
 
+// MU_CHANGE [BEGIN] - Reuse the table and memory map buffers
+//
+// Extra descriptors allocated with the memory map buffer and the table, so
+// that rebuilding the table for a few more runtime entries reuses them.
+//
+#define MEMORY_ATTRIBUTES_TABLE_EXTRA_ENTRY_COUNT  8
+
+STATIC EFI_MEMORY_DESCRIPTOR  *mMemoryAttributesTableMemoryMap = NULL;
+STATIC UINTN                  mMemoryAttributesTableMemoryMapSize = 0;
+STATIC UINTN                  mMemoryAttributesTableEntryMax = 0;
+// MU_CHANGE [END]
+
 /**
   Install MemoryAttributesTable.
 
@@ -110,6 +127,7 @@ InstallMemoryAttributesTable (
   UINT32                         RuntimeEntryCount;
   EFI_MEMORY_ATTRIBUTES_TABLE    *MemoryAttributesTable;
   EFI_MEMORY_DESCRIPTOR          *MemoryAttributesEntry;
+  UINTN                          EntryMax;                // MU_CHANGE
 
   if (gMemoryMapTerminated) {
     //
@@ -134,33 +152,41 @@ InstallMemoryAttributesTable (
     ASSERT_EFI_ERROR (Status);
   }
 
-  MemoryMapSize = 0;
-  MemoryMap = NULL;
-  Status = CoreGetMemoryMapWithSeparatedImageSection (
-             &MemoryMapSize,
-             MemoryMap,
-             &MapKey,
-             &DescriptorSize,
-             &DescriptorVersion
-             );
-  ASSERT (Status == EFI_BUFFER_TOO_SMALL);
-
+  // MU_CHANGE [BEGIN] - Reuse the table and memory map buffers
+  //
+  // The memory map buffer is kept from the last build and only grows. It is
+  // allocated with some extra descriptors, as the allocation itself may add
+  // entries to the memory map.
+  //
   do {
-    MemoryMap = AllocatePool (MemoryMapSize);
-    ASSERT (MemoryMap != NULL);
-
-    Status = CoreGetMemoryMapWithSeparatedImageSection (
+    MemoryMapSize = mMemoryAttributesTableMemoryMapSize;
+    Status = CoreGetRuntimeMemoryMapWithSeparatedImageSection (
                &MemoryMapSize,
-               MemoryMap,
+               mMemoryAttributesTableMemoryMap,
                &MapKey,
                &DescriptorSize,
                &DescriptorVersion
                );
-    if (EFI_ERROR (Status)) {
-      FreePool (MemoryMap);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      if (mMemoryAttributesTableMemoryMap != NULL) {
+        FreePool (mMemoryAttributesTableMemoryMap);
+      }
+      mMemoryAttributesTableMemoryMapSize = MemoryMapSize + DescriptorSize * MEMORY_ATTRIBUTES_TABLE_EXTRA_ENTRY_COUNT;
+      mMemoryAttributesTableMemoryMap     = AllocatePool (mMemoryAttributesTableMemoryMapSize);
+      ASSERT (mMemoryAttributesTableMemoryMap != NULL);
+      if (mMemoryAttributesTableMemoryMap == NULL) {
+        mMemoryAttributesTableMemoryMapSize = 0;
+        return;
+      }
     }
   } while (Status == EFI_BUFFER_TOO_SMALL);
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
 
+  MemoryMap = mMemoryAttributesTableMemoryMap;
+  // MU_CHANGE [END]
   MemoryMapStart = MemoryMap;
   RuntimeEntryCount = 0;
   for (Index = 0; Index < MemoryMapSize/DescriptorSize; Index++) {
@@ -173,10 +199,19 @@ InstallMemoryAttributesTable (
     MemoryMap = NEXT_MEMORY_DESCRIPTOR(MemoryMap, DescriptorSize);
   }
 
+  // MU_CHANGE [BEGIN] - Reuse the table and memory map buffers
   //
-  // Allocate MemoryAttributesTable
+  // Allocate MemoryAttributesTable, unless the current one has room for the
+  // new entries.
   //
-  MemoryAttributesTable = AllocatePool (sizeof(EFI_MEMORY_ATTRIBUTES_TABLE) + DescriptorSize * RuntimeEntryCount);
+  if ((mMemoryAttributesTable != NULL) && (RuntimeEntryCount <= mMemoryAttributesTableEntryMax)) {
+    MemoryAttributesTable = mMemoryAttributesTable;
+    EntryMax              = mMemoryAttributesTableEntryMax;
+  } else {
+    EntryMax              = RuntimeEntryCount + MEMORY_ATTRIBUTES_TABLE_EXTRA_ENTRY_COUNT;
+    MemoryAttributesTable = AllocatePool (sizeof(EFI_MEMORY_ATTRIBUTES_TABLE) + DescriptorSize * EntryMax);
+  }
+  // MU_CHANGE [END]
   ASSERT (MemoryAttributesTable != NULL);
   MemoryAttributesTable->Version         = EFI_MEMORY_ATTRIBUTES_TABLE_VERSION;
   MemoryAttributesTable->NumberOfEntries = RuntimeEntryCount;
@@ -205,8 +240,6 @@ InstallMemoryAttributesTable (
     }
     MemoryMap = NEXT_MEMORY_DESCRIPTOR(MemoryMap, DescriptorSize);
   }
-  MemoryMap = MemoryMapStart;
-  FreePool (MemoryMap);
 
   //
   // Update configuratoin table for MemoryAttributesTable.
@@ -214,10 +247,11 @@ InstallMemoryAttributesTable (
   Status = gBS->InstallConfigurationTable (&gEfiMemoryAttributesTableGuid, MemoryAttributesTable);
   ASSERT_EFI_ERROR (Status);
 
-  if (mMemoryAttributesTable != NULL) {
+  if ((mMemoryAttributesTable != NULL) && (mMemoryAttributesTable != MemoryAttributesTable)) {  // MU_CHANGE
     FreePool (mMemoryAttributesTable);
   }
-  mMemoryAttributesTable = MemoryAttributesTable;
+  mMemoryAttributesTable         = MemoryAttributesTable;
+  mMemoryAttributesTableEntryMax = EntryMax;  // MU_CHANGE
 }
 
 /**
@@ -402,27 +436,33 @@ SortMemoryMap (
   )
 {
   EFI_MEMORY_DESCRIPTOR       *MemoryMapEntry;
-  EFI_MEMORY_DESCRIPTOR       *NextMemoryMapEntry;
+  EFI_MEMORY_DESCRIPTOR       *InsertEntry;
   EFI_MEMORY_DESCRIPTOR       *MemoryMapEnd;
   EFI_MEMORY_DESCRIPTOR       TempMemoryMap;
 
-  MemoryMapEntry = MemoryMap;
-  NextMemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
+  //
+  // MU_CHANGE [BEGIN] - Insertion sort
+  // The memory map from CoreGetMemoryMap() is nearly sorted already, only the
+  // GCD entries at its end are out of place, so an insertion sort is close to
+  // a single pass over the map.
+  //
+  MemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMap, DescriptorSize);
   MemoryMapEnd = (EFI_MEMORY_DESCRIPTOR *) ((UINT8 *) MemoryMap + MemoryMapSize);
   while (MemoryMapEntry < MemoryMapEnd) {
-    while (NextMemoryMapEntry < MemoryMapEnd) {
-      if (MemoryMapEntry->PhysicalStart > NextMemoryMapEntry->PhysicalStart) {
-        CopyMem (&TempMemoryMap, MemoryMapEntry, sizeof(EFI_MEMORY_DESCRIPTOR));
-        CopyMem (MemoryMapEntry, NextMemoryMapEntry, sizeof(EFI_MEMORY_DESCRIPTOR));
-        CopyMem (NextMemoryMapEntry, &TempMemoryMap, sizeof(EFI_MEMORY_DESCRIPTOR));
-      }
-
-      NextMemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (NextMemoryMapEntry, DescriptorSize);
+    if (PREVIOUS_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize)->PhysicalStart > MemoryMapEntry->PhysicalStart) {
+      CopyMem (&TempMemoryMap, MemoryMapEntry, sizeof(EFI_MEMORY_DESCRIPTOR));
+      InsertEntry = MemoryMapEntry;
+      do {
+        CopyMem (InsertEntry, PREVIOUS_MEMORY_DESCRIPTOR (InsertEntry, DescriptorSize), sizeof(EFI_MEMORY_DESCRIPTOR));
+        InsertEntry = PREVIOUS_MEMORY_DESCRIPTOR (InsertEntry, DescriptorSize);
+      } while ((InsertEntry > MemoryMap) &&
+               (PREVIOUS_MEMORY_DESCRIPTOR (InsertEntry, DescriptorSize)->PhysicalStart > TempMemoryMap.PhysicalStart));
+      CopyMem (InsertEntry, &TempMemoryMap, sizeof(EFI_MEMORY_DESCRIPTOR));
     }
 
-    MemoryMapEntry      = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
-    NextMemoryMapEntry  = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
+    MemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
   }
+  // MU_CHANGE [END]
 
   return ;
 }
@@ -939,11 +979,17 @@ SplitTable (
   return ;
 }
 
+// MU_CHANGE [BEGIN] - Build the table from the runtime entries only
 /**
-  This function for GetMemoryMap() with properties table capability.
+  This function for GetMemoryMap() with properties table capability, returning
+  the runtime entries only.
 
-  It calls original GetMemoryMap() to get the original memory map information. Then
-  plus the additional memory map entries for PE Code/Data seperation.
+  It calls original GetMemoryMap() to get the original memory map information.
+  Then it drops every entry that is not EfiRuntimeServicesCode or
+  EfiRuntimeServicesData, and adds the additional memory map entries for PE Code/Data
+  seperation. Only runtime images have image records, so dropping the other
+  entries first keeps the split, sort and merge down to the entries that go into
+  the Memory Attributes Table.
 
   @param  MemoryMapSize          A pointer to the size, in bytes, of the
                                  MemoryMap buffer. On input, this is the size of
@@ -971,9 +1017,9 @@ SplitTable (
   @retval EFI_INVALID_PARAMETER  One of the parameters has an invalid value.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-CoreGetMemoryMapWithSeparatedImageSection (
+CoreGetRuntimeMemoryMapWithSeparatedImageSection (
   IN OUT UINTN                  *MemoryMapSize,
   IN OUT EFI_MEMORY_DESCRIPTOR  *MemoryMap,
   OUT UINTN                     *MapKey,
@@ -981,16 +1027,13 @@ CoreGetMemoryMapWithSeparatedImageSection (
   OUT UINT32                    *DescriptorVersion
   )
 {
-  EFI_STATUS  Status;
-  UINTN       OldMemoryMapSize;
-  UINTN       AdditionalRecordCount;
-
-  //
-  // If PE code/data is not aligned, just return.
-  //
-  if (!mMemoryAttributesTableEnable) {
-    return CoreGetMemoryMap (MemoryMapSize, MemoryMap, MapKey, DescriptorSize, DescriptorVersion);
-  }
+  EFI_STATUS              Status;
+  UINTN                   OldMemoryMapSize;
+  UINTN                   FullMemoryMapSize;
+  UINTN                   AdditionalRecordCount;
+  EFI_MEMORY_DESCRIPTOR   *MemoryMapEntry;
+  EFI_MEMORY_DESCRIPTOR   *MemoryMapEnd;
+  EFI_MEMORY_DESCRIPTOR   *RuntimeEntry;
 
   if (MemoryMapSize == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -1006,8 +1049,27 @@ CoreGetMemoryMapWithSeparatedImageSection (
     *MemoryMapSize = *MemoryMapSize + (*DescriptorSize) * AdditionalRecordCount;
   } else if (Status == EFI_SUCCESS) {
     ASSERT (MemoryMap != NULL);
+    //
+    // Keep the runtime entries only, in their original order.
+    //
+    FullMemoryMapSize = *MemoryMapSize;
+    MemoryMapEntry    = MemoryMap;
+    MemoryMapEnd      = (EFI_MEMORY_DESCRIPTOR *) ((UINT8 *) MemoryMap + FullMemoryMapSize);
+    RuntimeEntry      = MemoryMap;
+    while (MemoryMapEntry < MemoryMapEnd) {
+      if ((MemoryMapEntry->Type == EfiRuntimeServicesCode) ||
+          (MemoryMapEntry->Type == EfiRuntimeServicesData)) {
+        if (RuntimeEntry != MemoryMapEntry) {
+          CopyMem (RuntimeEntry, MemoryMapEntry, *DescriptorSize);
+        }
+        RuntimeEntry = NEXT_MEMORY_DESCRIPTOR (RuntimeEntry, *DescriptorSize);
+      }
+      MemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, *DescriptorSize);
+    }
+    *MemoryMapSize = (UINTN) RuntimeEntry - (UINTN) MemoryMap;
+
     if (OldMemoryMapSize - *MemoryMapSize < (*DescriptorSize) * AdditionalRecordCount) {
-      *MemoryMapSize = *MemoryMapSize + (*DescriptorSize) * AdditionalRecordCount;
+      *MemoryMapSize = FullMemoryMapSize + (*DescriptorSize) * AdditionalRecordCount;
       //
       // Need update status to buffer too small
       //
@@ -1023,6 +1085,7 @@ CoreGetMemoryMapWithSeparatedImageSection (
   CoreReleasemMemoryAttributesTableLock ();
   return Status;
 }
+// MU_CHANGE [END]
 
 //
 // Below functions are for ImageRecord
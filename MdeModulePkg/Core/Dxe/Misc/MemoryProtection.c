@@ -39,6 +39,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/FirmwareVolume2.h>
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/HeapGuardDebug.h> // MS_CHANGE
+#include <Protocol/CpuMemoryAttributeBatch.h>  // MU_CHANGE
 
 #include "DxeMain.h"
 #include "Mem/HeapGuard.h"
@@ -66,6 +67,8 @@ UINT32   mImageProtectionPolicy;
 extern LIST_ENTRY         mGcdMemorySpaceMap;
 
 STATIC LIST_ENTRY         mProtectedImageRecordList;
+
+STATIC EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *mCpuMemoryAttributeBatch = NULL;  // MU_CHANGE
 //MS_CHANGE - START
 STATIC HEAP_GUARD_DEBUG_PROTOCOL mHeapGuardDebug = {
   IsGuardPage
@@ -232,6 +235,42 @@ SetUefiImageMemoryAttributes (
   gCpu->SetMemoryAttributes (gCpu, BaseAddress, Length, FinalAttributes);
 }
 
+// MU_CHANGE [BEGIN] - Protect all sections of an image with one CPU driver call.
+/**
+  Protect one range of a UEFI image.
+
+  If Entries is NULL, the range is protected right away. Otherwise it is
+  appended to Entries, to be applied together with the other ranges.
+
+  @param[in, out]  Entries        Optional list of pending ranges.
+  @param[in, out]  EntryCount     Number of ranges in Entries.
+  @param[in]       BaseAddress    Specified start address
+  @param[in]       Length         Specified length
+  @param[in]       Attributes     Specified attributes
+**/
+STATIC
+VOID
+ProtectUefiImageRange (
+  IN OUT EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY   *Entries OPTIONAL,
+  IN OUT UINTN                                    *EntryCount,
+  IN     UINT64                                   BaseAddress,
+  IN     UINT64                                   Length,
+  IN     UINT64                                   Attributes
+  )
+{
+  if (Entries == NULL) {
+    SetUefiImageMemoryAttributes (BaseAddress, Length, Attributes);
+    return;
+  }
+
+  Entries[*EntryCount].BaseAddress = BaseAddress;
+  Entries[*EntryCount].Length      = Length;
+  Entries[*EntryCount].Attributes  = Attributes;
+  Entries[*EntryCount].Status      = EFI_NOT_STARTED;
+  *EntryCount += 1;
+}
+// MU_CHANGE [END]
+
 /**
   Set UEFI image protection attributes.
 
@@ -248,6 +287,21 @@ SetUefiImageProtectionAttributes (
   LIST_ENTRY                                *ImageRecordCodeSectionList;
   UINT64                                    CurrentBase;
   UINT64                                    ImageEnd;
+  EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY    *Entries;     // MU_CHANGE
+  UINTN                                     EntryCount;   // MU_CHANGE
+
+  // MU_CHANGE [BEGIN] - Protect all sections of an image with one CPU driver call.
+  //
+  // Every code section is preceded by at most one data range, plus the data
+  // range after the last code section. If the list cannot be allocated, fall
+  // back to protecting the ranges one by one.
+  //
+  Entries    = NULL;
+  EntryCount = 0;
+  if (mCpuMemoryAttributeBatch != NULL) {
+    Entries = AllocatePool ((2 * ImageRecord->CodeSegmentCount + 1) * sizeof (*Entries));
+  }
+  // MU_CHANGE [END]
 
   ImageRecordCodeSectionList = &ImageRecord->CodeSegmentList;
 
@@ -270,7 +324,9 @@ SetUefiImageProtectionAttributes (
       //
       // DATA
       //
-      SetUefiImageMemoryAttributes (
+      ProtectUefiImageRange (     // MU_CHANGE
+        Entries,                  // MU_CHANGE
+        &EntryCount,              // MU_CHANGE
         CurrentBase,
         ImageRecordCodeSection->CodeSegmentBase - CurrentBase,
         EFI_MEMORY_XP
@@ -279,7 +335,9 @@ SetUefiImageProtectionAttributes (
     //
     // CODE
     //
-    SetUefiImageMemoryAttributes (
+    ProtectUefiImageRange (       // MU_CHANGE
+      Entries,                    // MU_CHANGE
+      &EntryCount,                // MU_CHANGE
       ImageRecordCodeSection->CodeSegmentBase,
       ImageRecordCodeSection->CodeSegmentSize,
       EFI_MEMORY_RO
@@ -294,12 +352,28 @@ SetUefiImageProtectionAttributes (
     //
     // DATA
     //
-    SetUefiImageMemoryAttributes (
+    ProtectUefiImageRange (       // MU_CHANGE
+      Entries,                    // MU_CHANGE
+      &EntryCount,                // MU_CHANGE
       CurrentBase,
       ImageEnd - CurrentBase,
       EFI_MEMORY_XP
       );
   }
+
+  // MU_CHANGE [BEGIN] - Protect all sections of an image with one CPU driver call.
+  if (Entries != NULL) {
+    DEBUG ((
+      DEBUG_INFO,
+      "SetUefiImageProtectionAttributes - 0x%016lx - 0x%016lx (%ld ranges)\n",
+      ImageRecord->ImageBase,
+      ImageRecord->ImageSize,
+      (UINT64)EntryCount
+      ));
+    mCpuMemoryAttributeBatch->SetMemoryAttributes (mCpuMemoryAttributeBatch, EntryCount, Entries);
+    FreePool (Entries);
+  }
+  // MU_CHANGE [END]
   return ;
 }
 
@@ -672,27 +746,33 @@ SortMemoryMap (
   )
 {
   EFI_MEMORY_DESCRIPTOR       *MemoryMapEntry;
-  EFI_MEMORY_DESCRIPTOR       *NextMemoryMapEntry;
+  EFI_MEMORY_DESCRIPTOR       *InsertEntry;
   EFI_MEMORY_DESCRIPTOR       *MemoryMapEnd;
   EFI_MEMORY_DESCRIPTOR       TempMemoryMap;
 
-  MemoryMapEntry = MemoryMap;
-  NextMemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
+  //
+  // MU_CHANGE [BEGIN] - Insertion sort
+  // The memory map from CoreGetMemoryMap() is nearly sorted already, only the
+  // GCD entries at its end are out of place, so an insertion sort is close to
+  // a single pass over the map.
+  //
+  MemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMap, DescriptorSize);
   MemoryMapEnd = (EFI_MEMORY_DESCRIPTOR *) ((UINT8 *) MemoryMap + MemoryMapSize);
   while (MemoryMapEntry < MemoryMapEnd) {
-    while (NextMemoryMapEntry < MemoryMapEnd) {
-      if (MemoryMapEntry->PhysicalStart > NextMemoryMapEntry->PhysicalStart) {
-        CopyMem (&TempMemoryMap, MemoryMapEntry, sizeof(EFI_MEMORY_DESCRIPTOR));
-        CopyMem (MemoryMapEntry, NextMemoryMapEntry, sizeof(EFI_MEMORY_DESCRIPTOR));
-        CopyMem (NextMemoryMapEntry, &TempMemoryMap, sizeof(EFI_MEMORY_DESCRIPTOR));
-      }
-
-      NextMemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (NextMemoryMapEntry, DescriptorSize);
+    if (PREVIOUS_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize)->PhysicalStart > MemoryMapEntry->PhysicalStart) {
+      CopyMem (&TempMemoryMap, MemoryMapEntry, sizeof(EFI_MEMORY_DESCRIPTOR));
+      InsertEntry = MemoryMapEntry;
+      do {
+        CopyMem (InsertEntry, PREVIOUS_MEMORY_DESCRIPTOR (InsertEntry, DescriptorSize), sizeof(EFI_MEMORY_DESCRIPTOR));
+        InsertEntry = PREVIOUS_MEMORY_DESCRIPTOR (InsertEntry, DescriptorSize);
+      } while ((InsertEntry > MemoryMap) &&
+               (PREVIOUS_MEMORY_DESCRIPTOR (InsertEntry, DescriptorSize)->PhysicalStart > TempMemoryMap.PhysicalStart));
+      CopyMem (InsertEntry, &TempMemoryMap, sizeof(EFI_MEMORY_DESCRIPTOR));
     }
 
-    MemoryMapEntry      = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
-    NextMemoryMapEntry  = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
+    MemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize);
   }
+  // MU_CHANGE [END]
 }
 
 /**
@@ -974,6 +1054,17 @@ MemoryProtectionCpuArchProtocolNotify (
     goto Done;
   }
 
+  // MU_CHANGE [BEGIN] - Protect all sections of an image with one CPU driver call.
+  //
+  // The CPU driver that can apply a list of ranges at once installs this
+  // protocol together with the CPU Arch Protocol.
+  //
+  Status = CoreLocateProtocol (&gEdkiiCpuMemoryAttributeBatchProtocolGuid, NULL, (VOID **)&mCpuMemoryAttributeBatch);
+  if (EFI_ERROR (Status)) {
+    mCpuMemoryAttributeBatch = NULL;
+  }
+  // MU_CHANGE [END]
+
   //
   // Apply the memory protection policy on non-BScode/RTcode regions.
   //
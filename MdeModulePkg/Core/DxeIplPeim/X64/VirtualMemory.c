@@ -461,6 +461,97 @@ Split1GPageTo2M (
   }
 }
 
+// MU_CHANGE [BEGIN] - Size the page table pool for the split pages up front
+/**
+  Count the page table pages needed to split the large pages that cover the
+  ranges with finer attributes.
+
+  The ranges are the NULL page, the stack and the GHCB pages. Only the large
+  pages touching them are checked with ToSplitPageTable(), the same way the
+  page table is built.
+
+  @param[in] Page1GSupport  Whether the page table uses 1GB pages.
+  @param[in] StackBase      Base address of stack.
+  @param[in] StackSize      Size of stack.
+  @param[in] GhcbBase       Base address of GHCB pages.
+  @param[in] GhcbSize       Size of GHCB area.
+
+  @return The number of page table pages the splits allocate.
+
+**/
+UINTN
+CountSplitPageTablePages (
+  IN BOOLEAN                            Page1GSupport,
+  IN EFI_PHYSICAL_ADDRESS               StackBase,
+  IN UINTN                              StackSize,
+  IN EFI_PHYSICAL_ADDRESS               GhcbBase,
+  IN UINTN                              GhcbSize
+  )
+{
+  EFI_PHYSICAL_ADDRESS                  RangeBase[3];
+  UINT64                                RangeLimit[3];
+  UINTN                                 RangeCount;
+  UINTN                                 Index;
+  UINTN                                 Prior;
+  UINT64                                PageSize;
+  EFI_PHYSICAL_ADDRESS                  Address;
+  EFI_PHYSICAL_ADDRESS                  Address2M;
+  BOOLEAN                               Counted;
+  UINTN                                 Pages;
+
+  RangeCount = 0;
+  if (IsNullDetectionEnabled ()) {
+    RangeBase[RangeCount]  = 0;
+    RangeLimit[RangeCount] = SIZE_4KB;
+    RangeCount++;
+  }
+
+  if (PcdGetBool (PcdCpuStackGuard) || PcdGetBool (PcdSetNxForStack)) {
+    RangeBase[RangeCount]  = StackBase;
+    RangeLimit[RangeCount] = StackBase + MAX (StackSize, SIZE_4KB);
+    RangeCount++;
+  }
+
+  if (GhcbBase != 0) {
+    RangeBase[RangeCount]  = GhcbBase;
+    RangeLimit[RangeCount] = GhcbBase + GhcbSize;
+    RangeCount++;
+  }
+
+  PageSize = Page1GSupport ? SIZE_1GB : SIZE_2MB;
+  Pages    = 0;
+  for (Index = 0; Index < RangeCount; Index++) {
+    for (Address = RangeBase[Index] & ~(PageSize - 1); Address < RangeLimit[Index]; Address += PageSize) {
+      //
+      // Skip the large pages already checked for an earlier range.
+      //
+      Counted = FALSE;
+      for (Prior = 0; Prior < Index; Prior++) {
+        if ((RangeBase[Prior] < Address + PageSize) && (RangeLimit[Prior] > Address)) {
+          Counted = TRUE;
+          break;
+        }
+      }
+
+      if (Counted || !ToSplitPageTable (Address, (UINTN)PageSize, StackBase, StackSize, GhcbBase, GhcbSize)) {
+        continue;
+      }
+
+      Pages++;
+      if (Page1GSupport) {
+        for (Address2M = Address; Address2M < Address + SIZE_1GB; Address2M += SIZE_2MB) {
+          if (ToSplitPageTable (Address2M, SIZE_2MB, StackBase, StackSize, GhcbBase, GhcbSize)) {
+            Pages++;
+          }
+        }
+      }
+    }
+  }
+
+  return Pages;
+}
+// MU_CHANGE [END]
+
 /**
   Set one page of page table pool memory to be read-only.
 
@@ -679,6 +770,7 @@ CreateIdentityMappingPageTables (
   PAGE_MAP_AND_DIRECTORY_POINTER                *PageDirectoryPointerEntry;
   PAGE_TABLE_ENTRY                              *PageDirectoryEntry;
   UINTN                                         TotalPagesNum;
+  UINTN                                         SplitPagesNum;    // MU_CHANGE
   UINTN                                         BigPageAddress;
   VOID                                          *Hob;
   BOOLEAN                                       Page5LevelSupport;
@@ -782,9 +874,23 @@ CreateIdentityMappingPageTables (
     TotalPagesNum--;
   }
 
-  DEBUG ((DEBUG_INFO, "Pml5=%u Pml4=%u Pdp=%u TotalPage=%Lu\n",
+  // MU_CHANGE [BEGIN] - Size the page table pool for the split pages up front
+  //
+  // Reserve the pages of the large pages split below in the same pool, so
+  // that a split does not allocate another PAGE_TABLE_POOL_UNIT_PAGES pool.
+  //
+  SplitPagesNum = CountSplitPageTablePages (Page1GSupport, StackBase, StackSize, GhcbBase, GhcbSize);
+
+  DEBUG ((DEBUG_INFO, "Pml5=%u Pml4=%u Pdp=%u TotalPage=%Lu SplitPage=%Lu\n",
     NumberOfPml5EntriesNeeded, NumberOfPml4EntriesNeeded,
-    NumberOfPdpEntriesNeeded, (UINT64)TotalPagesNum));
+    NumberOfPdpEntriesNeeded, (UINT64)TotalPagesNum, (UINT64)SplitPagesNum));
+
+  if ((mPageTablePool == NULL) || (mPageTablePool->FreePages < TotalPagesNum + SplitPagesNum)) {
+    if (!InitializePageTablePool (TotalPagesNum + SplitPagesNum)) {
+      ASSERT (FALSE);
+    }
+  }
+  // MU_CHANGE [END]
 
   BigPageAddress = (UINTN) AllocatePageTableMemory (TotalPagesNum);
   ASSERT (BigPageAddress != 0);
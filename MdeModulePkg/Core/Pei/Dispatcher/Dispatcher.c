@@ -208,7 +208,7 @@ DelayedDispatchDispatcher (IN DELAYED_DISPATCH_TABLE *DelayedDispatchTable,
             TimeCurrent =  GET_TIME_IN_US();
             if (TimeCurrent >= Entry->DispatchTime) {
                 // Time expired, invoked the function
-                DEBUG((DEBUG_ERROR,
+                DEBUG((DEBUG_VERBOSE,   // MU_CHANGE - Polling entries run often, keep them off the error log.
                         "Delayed dispatch entry %d @ %p, Target=%d, Act=%d Disp=%d\n",
                         Index1,
                         Entry->Function,
@@ -220,7 +220,7 @@ DelayedDispatchDispatcher (IN DELAYED_DISPATCH_TABLE *DelayedDispatchTable,
                 Entry->Function (
                         &Entry->Context,
                         &Entry->usDelay);
-                DEBUG((DEBUG_ERROR,"Delayed dispatch Function returned delay=%d\n",Entry->usDelay));
+                DEBUG((DEBUG_VERBOSE,"Delayed dispatch Function returned delay=%d\n",Entry->usDelay)); // MU_CHANGE
                 if (0 == Entry->usDelay) {
                     // NewTime = 0 = delete this entry from the table
                     DelayedDispatchTable->Count--;
@@ -432,8 +432,11 @@ DiscoverPeimsAndOrderWithApriori (
   // Record PeimCount, allocate buffer for PeimState and FvFileHandles.
   //
   CoreFileHandle->PeimCount = PeimCount;
-  CoreFileHandle->PeimState = AllocateZeroPool (sizeof (UINT8) * PeimCount);
+  // MU_CHANGE [BEGIN] - Only evaluate a depex again after a PPI was installed.
+  CoreFileHandle->PeimState = AllocateZeroPool ((sizeof (UINT8) + sizeof (UINT32)) * PeimCount);
   ASSERT (CoreFileHandle->PeimState != NULL);
+  SetMem (PEIM_DEPEX_GENERATION (CoreFileHandle, 0), sizeof (UINT32) * PeimCount, 0xFF);
+  // MU_CHANGE [END]
   CoreFileHandle->FvFileHandles = AllocateZeroPool (sizeof (EFI_PEI_FILE_HANDLE) * PeimCount);
   ASSERT (CoreFileHandle->FvFileHandles != NULL);
 
@@ -998,24 +1001,39 @@ PeiCheckAndSwitchStack (
   EFI_PHYSICAL_ADDRESS                  TempBase2;
   UINTN                                 TempSize2;
   UINTN                                 Index;
+  UINT32                                *StackPointer;      // MU_CHANGE
+  EDKII_PEI_TEMP_RAM_USAGE              *TempRamUsage;      // MU_CHANGE
 
   PeiServices = (CONST EFI_PEI_SERVICES **) &Private->Ps;
 
   if (Private->SwitchStackSignal) {
     //
     // Before switch stack from temporary memory to permanent memory, calculate the heap and stack
-    // usage in temporary memory for debugging.
+    // usage in temporary memory.
     //
+    for (StackPointer = (UINT32*)SecCoreData->StackBase;
+         (StackPointer < (UINT32*)((UINTN)SecCoreData->StackBase + SecCoreData->StackSize)) \
+         && (*StackPointer == PcdGet32 (PcdInitValueInTempStack));
+         StackPointer ++) {
+    }
+
+    // MU_CHANGE [BEGIN] - Hand the temporary RAM usage to later phases.
+    TempRamUsage = BuildGuidHob (&gEdkiiPeiTempRamUsageHobGuid, sizeof (EDKII_PEI_TEMP_RAM_USAGE));
+    if (TempRamUsage != NULL) {
+      ZeroMem (TempRamUsage, sizeof (EDKII_PEI_TEMP_RAM_USAGE));
+      TempRamUsage->Revision         = EDKII_PEI_TEMP_RAM_USAGE_REVISION;
+      TempRamUsage->TemporaryRamSize = SecCoreData->TemporaryRamSize;
+      TempRamUsage->StackSize        = SecCoreData->StackSize;
+      TempRamUsage->StackUsed        = SecCoreData->StackSize - ((UINTN) StackPointer - (UINTN)SecCoreData->StackBase);
+      TempRamUsage->HeapSize         = SecCoreData->PeiTemporaryRamSize;
+      TempRamUsage->HeapUsed         = (Private->HobList.HandoffInformationTable->EfiFreeMemoryBottom - (UINTN)Private->HobList.Raw) +
+                                       (Private->HobList.HandoffInformationTable->EfiMemoryTop - Private->HobList.HandoffInformationTable->EfiFreeMemoryTop);
+    }
+    // MU_CHANGE [END]
+
     DEBUG_CODE_BEGIN ();
-      UINT32                *StackPointer;
       EFI_PEI_HOB_POINTERS  Hob;
 
-      for (StackPointer = (UINT32*)SecCoreData->StackBase;
-           (StackPointer < (UINT32*)((UINTN)SecCoreData->StackBase + SecCoreData->StackSize)) \
-           && (*StackPointer == PcdGet32 (PcdInitValueInTempStack));
-           StackPointer ++) {
-      }
-
       DEBUG ((DEBUG_INFO, "Temp Stack : BaseAddress=0x%p Length=0x%X\n", SecCoreData->StackBase, (UINT32)SecCoreData->StackSize));
       DEBUG ((DEBUG_INFO, "Temp Heap  : BaseAddress=0x%p Length=0x%X\n", SecCoreData->PeiTemporaryRamBase, (UINT32)SecCoreData->PeiTemporaryRamSize));
       DEBUG ((DEBUG_INFO, "Total temporary memory:    %d bytes.\n", (UINT32)SecCoreData->TemporaryRamSize));
@@ -1097,6 +1115,12 @@ PeiCheckAndSwitchStack (
     PeiTemporaryRamSize = SecCoreData->PeiTemporaryRamSize;
     PeiTemporaryRamBase = SecCoreData->PeiTemporaryRamBase;
 
+    //
+    // MU_CHANGE - Start timing the switch. Private is still in temporary RAM,
+    // so the value is carried over to permanent memory with it.
+    //
+    Private->TempRamMigrationBegin = GetPerformanceCounter ();
+
     //
     // TemporaryRamSupportPpi is produced by platform's SEC
     //
@@ -1121,6 +1145,10 @@ PeiCheckAndSwitchStack (
 
       DEBUG ((EFI_D_INFO, "Heap Offset = 0x%lX Stack Offset = 0x%lX\n", (UINT64) Private->HeapOffset, (UINT64) Private->StackOffset));
 
+      if (TempRamUsage != NULL) {
+        TempRamUsage->MigratedBytes = TemporaryRamSize;   // MU_CHANGE
+      }
+
       //
       // Calculate new HandOffTable and PrivateData address in permanent memory's stack
       //
@@ -1194,6 +1222,9 @@ PeiCheckAndSwitchStack (
       //
       HeapTemporaryRamSize = (UINTN) (Private->HobList.HandoffInformationTable->EfiFreeMemoryBottom - Private->HobList.HandoffInformationTable->EfiMemoryBottom);
       ASSERT (BaseOfNewHeap + HeapTemporaryRamSize <= Private->FreePhysicalMemoryTop);
+      if (TempRamUsage != NULL) {
+        TempRamUsage->MigratedBytes = HeapTemporaryRamSize + TemporaryStackSize + HoleMemSize;   // MU_CHANGE
+      }
       CopyMem ((UINT8 *) (UINTN) BaseOfNewHeap, PeiTemporaryRamBase, HeapTemporaryRamSize);
 
       //
@@ -1469,6 +1500,131 @@ MigrateSecModulesInFv (
   return EFI_SUCCESS;
 }
 
+// MU_CHANGE [BEGIN] - Migrate only the PEIMs still needed after memory
+/**
+  Check whether an address is in a range.
+
+  @param Address          The address.
+  @param Base             The start of the range.
+  @param Limit            The end of the range, excluded.
+
+  @retval TRUE            The address is in the range.
+  @retval FALSE           The address is not in the range.
+
+**/
+STATIC
+BOOLEAN
+IsAddressInRange (
+  IN CONST VOID  *Address,
+  IN UINTN       Base,
+  IN UINTN       Limit
+  )
+{
+  return (BOOLEAN)(((UINTN)Address >= Base) && ((UINTN)Address < Limit));
+}
+
+/**
+  Check whether a PEIM runs again after memory is discovered, or left
+  something in use behind.
+
+  A PEIM that is not dispatched yet, or that registered for shadow, runs
+  again. A PEIM that was dispatched is still in use when an installed PPI, a
+  notification or a status code callback is in its file.
+
+  @param Private          PeiCore's private data structure
+  @param FvIndex          The index of the FV of the PEIM.
+  @param FileIndex        The index of the PEIM in the FV.
+  @param FileHandle       The handle to the PEIM in temporary memory.
+
+  @retval TRUE            The PEIM must be migrated.
+  @retval FALSE           The PEIM won't run again.
+
+**/
+STATIC
+BOOLEAN
+IsPeimNeededAfterMemory (
+  IN PEI_CORE_INSTANCE    *Private,
+  IN UINTN                FvIndex,
+  IN UINTN                FileIndex,
+  IN EFI_PEI_FILE_HANDLE  FileHandle
+  )
+{
+  UINT8                 PeimState;
+  UINTN                 Base;
+  UINTN                 Limit;
+  UINTN                 Index;
+  EFI_PEI_HOB_POINTERS  Hob;
+  UINTN                 *NumberOfEntries;
+  UINTN                 *CallbackEntry;
+
+  PeimState = Private->Fv[FvIndex].PeimState[FileIndex];
+  if ((PeimState == PEIM_STATE_NOT_DISPATCHED) || (PeimState == PEIM_STATE_REGISTER_FOR_SHADOW)) {
+    return TRUE;
+  }
+
+  Base  = (UINTN)FileHandle;
+  Limit = Base + FFS_FILE_SIZE ((EFI_FFS_FILE_HEADER *)FileHandle);
+
+  for (Index = 0; Index < Private->PpiData.PpiList.CurrentCount; Index++) {
+    if (IsAddressInRange (Private->PpiData.PpiList.PpiPtrs[Index].Raw, Base, Limit) ||
+        IsAddressInRange (Private->PpiData.PpiList.PpiPtrs[Index].Ppi->Ppi, Base, Limit))
+    {
+      return TRUE;
+    }
+  }
+
+  for (Index = 0; Index < Private->PpiData.CallbackNotifyList.CurrentCount; Index++) {
+    if (IsAddressInRange (Private->PpiData.CallbackNotifyList.NotifyPtrs[Index].Raw, Base, Limit) ||
+        IsAddressInRange ((VOID *)(UINTN)Private->PpiData.CallbackNotifyList.NotifyPtrs[Index].Notify->Notify, Base, Limit))
+    {
+      return TRUE;
+    }
+  }
+
+  for (Index = 0; Index < Private->PpiData.DispatchNotifyList.CurrentCount; Index++) {
+    if (IsAddressInRange (Private->PpiData.DispatchNotifyList.NotifyPtrs[Index].Raw, Base, Limit) ||
+        IsAddressInRange ((VOID *)(UINTN)Private->PpiData.DispatchNotifyList.NotifyPtrs[Index].Notify->Notify, Base, Limit))
+    {
+      return TRUE;
+    }
+  }
+
+  for (Hob.Raw = GetFirstGuidHob (&gStatusCodeCallbackGuid); Hob.Raw != NULL; Hob.Raw = GetNextGuidHob (&gStatusCodeCallbackGuid, GET_NEXT_HOB (Hob))) {
+    NumberOfEntries = GET_GUID_HOB_DATA (Hob);
+    CallbackEntry   = NumberOfEntries + 1;
+    for (Index = 0; Index < *NumberOfEntries; Index++) {
+      if (IsAddressInRange ((VOID *)CallbackEntry[Index], Base, Limit)) {
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Get the temporary RAM usage HOB built at the stack switch.
+
+  @return The HOB data, or NULL if it was not built.
+
+**/
+STATIC
+EDKII_PEI_TEMP_RAM_USAGE *
+GetTempRamUsage (
+  VOID
+  )
+{
+  VOID  *GuidHob;
+
+  GuidHob = GetFirstGuidHob (&gEdkiiPeiTempRamUsageHobGuid);
+  if (GuidHob == NULL) {
+    return NULL;
+  }
+
+  return GET_GUID_HOB_DATA (GuidHob);
+}
+// MU_CHANGE [END]
+
 /**
   Migrates PEIMs in the given firmware volume.
 
@@ -1494,11 +1650,14 @@ MigratePeimsInFv (
   volatile UINTN          FileIndex;
   EFI_PEI_FILE_HANDLE     MigratedFileHandle;
   EFI_PEI_FILE_HANDLE     FileHandle;
+  EDKII_PEI_TEMP_RAM_USAGE  *TempRamUsage;    // MU_CHANGE
 
   if (Private == NULL || FvIndex >= Private->FvCount) {
     return EFI_INVALID_PARAMETER;
   }
 
+  TempRamUsage = GetTempRamUsage ();          // MU_CHANGE
+
   if (Private->Fv[FvIndex].ScanFv) {
     for (FileIndex = 0; FileIndex < Private->Fv[FvIndex].PeimCount; FileIndex++) {
       if (Private->Fv[FvIndex].FvFileHandles[FileIndex] != NULL) {
@@ -1506,10 +1665,32 @@ MigratePeimsInFv (
 
         MigratedFileHandle = (EFI_PEI_FILE_HANDLE) ((UINTN) FileHandle - OrgFvHandle + FvHandle);
 
-        DEBUG ((DEBUG_VERBOSE, "    Migrating FileHandle %2d ", FileIndex));
-        Status = MigratePeim (FileHandle, MigratedFileHandle);
-        DEBUG ((DEBUG_VERBOSE, "\n"));
-        ASSERT_EFI_ERROR (Status);
+        // MU_CHANGE [BEGIN] - Migrate only the PEIMs still needed after memory
+        //
+        // A PEIM that won't run again is left in the migrated FV as it was
+        // copied, without being rebased.
+        //
+        if (PcdGetBool (PcdMigrateNeededPeimsOnly) &&
+            !IsPeimNeededAfterMemory (Private, FvIndex, FileIndex, FileHandle))
+        {
+          DEBUG ((DEBUG_VERBOSE, "    Skipping FileHandle %2d\n", FileIndex));
+          if (TempRamUsage != NULL) {
+            TempRamUsage->SkippedPeimCount++;
+            TempRamUsage->SkippedPeimBytes += FFS_FILE_SIZE ((EFI_FFS_FILE_HEADER *)FileHandle);
+          }
+
+          Status = EFI_SUCCESS;
+        } else {
+          DEBUG ((DEBUG_VERBOSE, "    Migrating FileHandle %2d ", FileIndex));
+          Status = MigratePeim (FileHandle, MigratedFileHandle);
+          DEBUG ((DEBUG_VERBOSE, "\n"));
+          ASSERT_EFI_ERROR (Status);
+          if (TempRamUsage != NULL) {
+            TempRamUsage->MigratedPeimCount++;
+            TempRamUsage->MigratedPeimBytes += FFS_FILE_SIZE ((EFI_FFS_FILE_HEADER *)FileHandle);
+          }
+        }
+        // MU_CHANGE [END]
 
         if (!EFI_ERROR (Status)) {
           Private->Fv[FvIndex].FvFileHandles[FileIndex] = MigratedFileHandle;
@@ -1556,6 +1737,7 @@ EvacuateTempRam (
   PEI_CORE_FV_HANDLE            PeiCoreFvHandle;
   EFI_PEI_CORE_FV_LOCATION_PPI  *PeiCoreFvLocationPpi;
   EDKII_MIGRATED_FV_INFO        MigratedFvInfo;
+  EDKII_PEI_TEMP_RAM_USAGE      *TempRamUsage;    // MU_CHANGE
 
   ASSERT (Private->PeiMemoryInstalled);
 
@@ -1627,8 +1809,19 @@ EvacuateTempRam (
       // PcdMigrateTemporaryRamFirmwareVolumes is FALSE, because the PCD control the
       // feature.
       //
+      // MU_CHANGE - Copy the raw FV from temporary RAM too. Temporary RAM is
+      //             still cached, while reading back MigratedFvHeader would
+      //             fetch the lines just written from permanent memory.
+      //
       CopyMem (MigratedFvHeader, FvHeader, (UINTN) FvHeader->FvLength);
-      CopyMem (RawDataFvHeader, MigratedFvHeader, (UINTN) FvHeader->FvLength);
+      CopyMem (RawDataFvHeader, FvHeader, (UINTN) FvHeader->FvLength);
+      // MU_CHANGE [BEGIN] - Account the FVs copied out of temporary RAM.
+      TempRamUsage = GetTempRamUsage ();
+      if (TempRamUsage != NULL) {
+        TempRamUsage->MigratedFvCount++;
+        TempRamUsage->MigratedFvBytes += FvHeader->FvLength;
+      }
+      // MU_CHANGE [END]
       MigratedFvInfo.FvOrgBase  = (UINT32) (UINTN) FvHeader;
       MigratedFvInfo.FvNewBase  = (UINT32) (UINTN) MigratedFvHeader;
       MigratedFvInfo.FvDataBase = (UINT32) (UINTN) RawDataFvHeader;
@@ -1650,9 +1843,12 @@ EvacuateTempRam (
           MigratedChildFvHeader = (EFI_FIRMWARE_VOLUME_HEADER *) ((UINTN) MigratedFvHeader + ChildFvOffset);
           Private->Fv[FvChildIndex].FvHeader = MigratedChildFvHeader;
           Private->Fv[FvChildIndex].FvHandle = (EFI_PEI_FV_HANDLE) MigratedChildFvHeader;
+          Private->Fv[FvChildIndex].ValidatedFileOffset = 0;    // MU_CHANGE - The migrated PEIMs are rebased.
           DEBUG ((DEBUG_VERBOSE, "    Child migrated FV header at 0x%x.\n", (UINTN) MigratedChildFvHeader));
 
+          PERF_INMODULE_BEGIN ("MigratePeimsInFv");   // MU_CHANGE
           Status =  MigratePeimsInFv (Private, FvChildIndex, (UINTN) ChildFvHeader, (UINTN) MigratedChildFvHeader);
+          PERF_INMODULE_END ("MigratePeimsInFv");     // MU_CHANGE
           ASSERT_EFI_ERROR (Status);
 
           ConvertPpiPointersFv (
@@ -1673,8 +1869,11 @@ EvacuateTempRam (
       }
       Private->Fv[FvIndex].FvHeader = MigratedFvHeader;
       Private->Fv[FvIndex].FvHandle = (EFI_PEI_FV_HANDLE) MigratedFvHeader;
+      Private->Fv[FvIndex].ValidatedFileOffset = 0;             // MU_CHANGE - The migrated PEIMs are rebased.
 
+      PERF_INMODULE_BEGIN ("MigratePeimsInFv");       // MU_CHANGE
       Status = MigratePeimsInFv (Private, FvIndex, (UINTN) FvHeader, (UINTN) MigratedFvHeader);
+      PERF_INMODULE_END ("MigratePeimsInFv");         // MU_CHANGE
       ASSERT_EFI_ERROR (Status);
 
       ConvertPpiPointersFv (
@@ -1696,6 +1895,22 @@ EvacuateTempRam (
 
   RemoveFvHobsInTemporaryMemory (Private);
 
+  // MU_CHANGE [BEGIN] - Report what the evacuation rebased and skipped.
+  TempRamUsage = GetTempRamUsage ();
+  if (TempRamUsage != NULL) {
+    DEBUG ((
+      DEBUG_INFO,
+      "Evacuated %d FVs (%ld bytes): rebased %d PEIMs (%ld bytes), skipped %d PEIMs (%ld bytes)\n",
+      TempRamUsage->MigratedFvCount,
+      TempRamUsage->MigratedFvBytes,
+      TempRamUsage->MigratedPeimCount,
+      TempRamUsage->MigratedPeimBytes,
+      TempRamUsage->SkippedPeimCount,
+      TempRamUsage->SkippedPeimBytes
+      ));
+  }
+  // MU_CHANGE [END]
+
   return Status;
 }
 
@@ -1863,9 +2078,18 @@ PeiDispatcher (
         PeimFileHandle = Private->CurrentFileHandle = Private->CurrentFvFileHandles[PeimCount];
 
         if (Private->Fv[FvCount].PeimState[PeimCount] == PEIM_STATE_NOT_DISPATCHED) {
-          if (!DepexSatisfied (Private, PeimFileHandle, PeimCount)) {
+          // MU_CHANGE [BEGIN] - Only evaluate a depex again after a PPI was installed.
+          //
+          // A depex only references PPIs, so its result can only change when the
+          // PPI database changes.
+          //
+          if (ReadUnaligned32 (PEIM_DEPEX_GENERATION (&Private->Fv[FvCount], PeimCount)) == Private->PpiInstallGeneration) {
+            Private->PeimNeedingDispatch = TRUE;
+          } else if (!DepexSatisfied (Private, PeimFileHandle, PeimCount)) {
+            WriteUnaligned32 (PEIM_DEPEX_GENERATION (&Private->Fv[FvCount], PeimCount), Private->PpiInstallGeneration);
             Private->PeimNeedingDispatch = TRUE;
           } else {
+          // MU_CHANGE [END]
             Status = CoreFvHandle->FvPpi->GetFileInfo (CoreFvHandle->FvPpi, PeimFileHandle, &FvFileInfo);
             ASSERT_EFI_ERROR (Status);
             if (FvFileInfo.FileType == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE) {
@@ -2010,7 +2234,7 @@ PeiDispatcher (
         }
 
         // MSCHANGE Start - Dispatch pending delalyed dispatch requests
-        if (NULL != Private->DelayedDispatchTable) {
+        if ((NULL != Private->DelayedDispatchTable) && (Private->DelayedDispatchTable->Count > 0)) {  // MU_CHANGE - Skip the timer reads when nothing is pending.
             if (DelayedDispatchDispatcher (Private->DelayedDispatchTable, NULL)) {
                 ProcessDispatchNotifyList(Private);
             }
@@ -242,6 +242,161 @@ FileHandleToVolume (
   return NULL;
 }
 
+// MU_CHANGE [BEGIN] - Look up files in the file index built by GenFv.
+/**
+  Find the file index that GenFv stores in the extension header of a
+  firmware volume.
+
+  @param FwVolHeader     Pointer to the FV header of the volume.
+
+  @return Pointer to the file index extension entry, or NULL if the volume
+          has no valid file index.
+**/
+EDKII_FV_FILE_INDEX_EXT_ENTRY *
+FindFvFileIndex (
+  IN EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader
+  )
+{
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *FwVolExtHeader;
+  EFI_FIRMWARE_VOLUME_EXT_ENTRY   *ExtEntry;
+  EDKII_FV_FILE_INDEX_EXT_ENTRY   *FileIndex;
+  UINT32                          Offset;
+
+  if ((FwVolHeader->ExtHeaderOffset == 0) ||
+      ((UINT64) FwVolHeader->ExtHeaderOffset + sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER) > FwVolHeader->FvLength)) {
+    return NULL;
+  }
+
+  FwVolExtHeader = (EFI_FIRMWARE_VOLUME_EXT_HEADER *) ((UINT8 *) FwVolHeader + FwVolHeader->ExtHeaderOffset);
+  if ((UINT64) FwVolHeader->ExtHeaderOffset + FwVolExtHeader->ExtHeaderSize > FwVolHeader->FvLength) {
+    return NULL;
+  }
+
+  Offset = sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER);
+  while ((UINT64) Offset + sizeof (EFI_FIRMWARE_VOLUME_EXT_ENTRY) <= FwVolExtHeader->ExtHeaderSize) {
+    ExtEntry = (EFI_FIRMWARE_VOLUME_EXT_ENTRY *) ((UINT8 *) FwVolExtHeader + Offset);
+    if ((ExtEntry->ExtEntrySize < sizeof (EFI_FIRMWARE_VOLUME_EXT_ENTRY)) ||
+        ((UINT64) Offset + ExtEntry->ExtEntrySize > FwVolExtHeader->ExtHeaderSize)) {
+      return NULL;
+    }
+
+    if ((ExtEntry->ExtEntryType == EFI_FV_EXT_TYPE_GUID_TYPE) &&
+        (ExtEntry->ExtEntrySize >= sizeof (EDKII_FV_FILE_INDEX_EXT_ENTRY))) {
+      FileIndex = (EDKII_FV_FILE_INDEX_EXT_ENTRY *) ExtEntry;
+      if (CompareGuid (&FileIndex->FormatType, &gEdkiiFvFileIndexGuid)) {
+        if (sizeof (EDKII_FV_FILE_INDEX_EXT_ENTRY) + MultU64x32 (FileIndex->Count, sizeof (EDKII_FV_FILE_INDEX_ENTRY)) > ExtEntry->ExtEntrySize) {
+          return NULL;
+        }
+        return FileIndex;
+      }
+    }
+
+    Offset += ExtEntry->ExtEntrySize;
+  }
+
+  return NULL;
+}
+
+/**
+  Look up a file by name in the file index of a firmware volume. The file
+  found is checked as FindFileEx() checks the files it walks through.
+
+  @param FwVolHeader     Pointer to the FV header of the volume to search.
+  @param FileName        Name of the file to find.
+
+  @return Pointer to the FFS file header, or NULL if the volume has no file
+          index, the file is not in it or the file does not pass the checks.
+**/
+EFI_FFS_FILE_HEADER *
+FindFileInFvFileIndex (
+  IN EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader,
+  IN CONST EFI_GUID              *FileName
+  )
+{
+  EDKII_FV_FILE_INDEX_EXT_ENTRY   *FileIndex;
+  EDKII_FV_FILE_INDEX_ENTRY       *Entry;
+  EFI_FFS_FILE_HEADER             *FfsFileHeader;
+  UINTN                           Low;
+  UINTN                           High;
+  UINTN                           Middle;
+  INTN                            Result;
+  UINT32                          FileLength;
+  UINT32                          HeaderLength;
+  UINT8                           ErasePolarity;
+  UINT8                           FileState;
+  UINT8                           DataCheckSum;
+
+  FileIndex = FindFvFileIndex (FwVolHeader);
+  if (FileIndex == NULL) {
+    return NULL;
+  }
+
+  Entry = (EDKII_FV_FILE_INDEX_ENTRY *) (FileIndex + 1);
+  Low   = 0;
+  High  = FileIndex->Count;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareMem (&Entry[Middle].Name, FileName, sizeof (EFI_GUID));
+    if (Result == 0) {
+      break;
+    }
+    if (Result < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+  if (Low >= High) {
+    return NULL;
+  }
+
+  //
+  // The volume may have been updated since the index was built
+  //
+  if ((Entry[Middle].Offset < FwVolHeader->HeaderLength) ||
+      ((UINT64) Entry[Middle].Offset + sizeof (EFI_FFS_FILE_HEADER) > FwVolHeader->FvLength)) {
+    return NULL;
+  }
+  FfsFileHeader = (EFI_FFS_FILE_HEADER *) ((UINT8 *) FwVolHeader + Entry[Middle].Offset);
+  if (!CompareGuid (&FfsFileHeader->Name, FileName)) {
+    return NULL;
+  }
+
+  ErasePolarity = (UINT8) (((FwVolHeader->Attributes & EFI_FVB2_ERASE_POLARITY) != 0) ? 1 : 0);
+  FileState     = GetFileState (ErasePolarity, FfsFileHeader);
+  if ((FileState != EFI_FILE_DATA_VALID) && (FileState != EFI_FILE_MARKED_FOR_UPDATE)) {
+    return NULL;
+  }
+
+  if (IS_FFS_FILE2 (FfsFileHeader)) {
+    if (!CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid) ||
+        ((UINT64) Entry[Middle].Offset + sizeof (EFI_FFS_FILE_HEADER2) > FwVolHeader->FvLength)) {
+      return NULL;
+    }
+    FileLength   = FFS_FILE2_SIZE (FfsFileHeader);
+    HeaderLength = sizeof (EFI_FFS_FILE_HEADER2);
+  } else {
+    FileLength   = FFS_FILE_SIZE (FfsFileHeader);
+    HeaderLength = sizeof (EFI_FFS_FILE_HEADER);
+  }
+  if ((FileLength < HeaderLength) ||
+      ((UINT64) Entry[Middle].Offset + FileLength > FwVolHeader->FvLength) ||
+      (CalculateHeaderChecksum (FfsFileHeader) != 0)) {
+    return NULL;
+  }
+
+  DataCheckSum = FFS_FIXED_CHECKSUM;
+  if ((FfsFileHeader->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
+    DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *) FfsFileHeader + HeaderLength, FileLength - HeaderLength);
+  }
+  if (FfsFileHeader->IntegrityCheck.Checksum.File != DataCheckSum) {
+    return NULL;
+  }
+
+  return FfsFileHeader;
+}
+// MU_CHANGE [END]
+
 /**
   Given the input file pointer, search for the first matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
@@ -282,6 +437,10 @@ FindFileEx (
   UINT8                                 FileState;
   UINT8                                 DataCheckSum;
   BOOLEAN                               IsFfs3Fv;
+  PEI_CORE_FV_HANDLE                    *CoreFvHandle;      // MU_CHANGE
+  UINT32                                CurrentFileOffset;  // MU_CHANGE
+  BOOLEAN                               Validated;          // MU_CHANGE
+  EFI_FFS_FILE_HEADER                   *MatchedFileHeader; // MU_CHANGE
 
   //
   // Convert the handle of FV to FV header for memory-mapped firmware volume
@@ -298,6 +457,20 @@ FindFileEx (
     ErasePolarity = 0;
   }
 
+  // MU_CHANGE [BEGIN] - Look up files in the file index built by GenFv.
+  //
+  // A file missing from the index may have been added after the volume was
+  // built, so the volume is still searched below.
+  //
+  if (FileName != NULL) {
+    FfsFileHeader = FindFileInFvFileIndex (FwVolHeader, FileName);
+    if (FfsFileHeader != NULL) {
+      *FileHeader = FfsFileHeader;
+      return EFI_SUCCESS;
+    }
+  }
+  // MU_CHANGE [END]
+
   //
   // If FileHeader is not specified (NULL) or FileName is not NULL,
   // start with the first file in the firmware volume.  Otherwise,
@@ -334,7 +507,27 @@ FindFileEx (
   FileOffset = (UINT32) ((UINT8 *)FfsFileHeader - (UINT8 *)FwVolHeader);
   ASSERT (FileOffset <= 0xFFFFFFFF);
 
+  // MU_CHANGE [BEGIN] - Skip checksums of the files already checked.
+  //
+  // The files in front of ValidatedFileOffset passed the checks below in an
+  // earlier search, so they do not have to be read again. The offset only
+  // grows while a search walks on from it, so every file in front of it has
+  // been checked.
+  //
+  CoreFvHandle = FvHandleToCoreHandle (FvHandle);
+  if ((CoreFvHandle != NULL) && (CoreFvHandle->ValidatedFileOffset == 0) &&
+      ((*FileHeader == NULL) || (FileName != NULL))) {
+    CoreFvHandle->ValidatedFileOffset = FileOffset;
+  }
+  MatchedFileHeader = NULL;
+  // MU_CHANGE [END]
+
   while (FileOffset < (FvLength - sizeof (EFI_FFS_FILE_HEADER))) {
+    // MU_CHANGE [BEGIN] - Skip checksums of the files already checked.
+    CurrentFileOffset = FileOffset;
+    Validated         = (BOOLEAN) ((CoreFvHandle != NULL) && (FileOffset < CoreFvHandle->ValidatedFileOffset));
+    // MU_CHANGE [END]
+
     //
     // Get FileState which is the highest bit of the State
     //
@@ -357,7 +550,7 @@ FindFileEx (
 
     case EFI_FILE_DATA_VALID:
     case EFI_FILE_MARKED_FOR_UPDATE:
-      if (CalculateHeaderChecksum (FfsFileHeader) != 0) {
+      if (!Validated && (CalculateHeaderChecksum (FfsFileHeader) != 0)) {   // MU_CHANGE
         ASSERT (FALSE);
         *FileHeader = NULL;
         return EFI_NOT_FOUND;
@@ -378,32 +571,33 @@ FindFileEx (
         FileOccupiedSize = GET_OCCUPIED_SIZE (FileLength, 8);
       }
 
-      DataCheckSum = FFS_FIXED_CHECKSUM;
-      if ((FfsFileHeader->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
-        if (IS_FFS_FILE2 (FfsFileHeader)) {
-          DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *) FfsFileHeader + sizeof (EFI_FFS_FILE_HEADER2), FileLength - sizeof(EFI_FFS_FILE_HEADER2));
-        } else {
-          DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *) FfsFileHeader + sizeof (EFI_FFS_FILE_HEADER), FileLength - sizeof(EFI_FFS_FILE_HEADER));
+      if (!Validated) {   // MU_CHANGE
+        DataCheckSum = FFS_FIXED_CHECKSUM;
+        if ((FfsFileHeader->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
+          if (IS_FFS_FILE2 (FfsFileHeader)) {
+            DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *) FfsFileHeader + sizeof (EFI_FFS_FILE_HEADER2), FileLength - sizeof(EFI_FFS_FILE_HEADER2));
+          } else {
+            DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *) FfsFileHeader + sizeof (EFI_FFS_FILE_HEADER), FileLength - sizeof(EFI_FFS_FILE_HEADER));
+          }
         }
-      }
-      if (FfsFileHeader->IntegrityCheck.Checksum.File != DataCheckSum) {
-        ASSERT (FALSE);
-        *FileHeader = NULL;
-        return EFI_NOT_FOUND;
-      }
+        if (FfsFileHeader->IntegrityCheck.Checksum.File != DataCheckSum) {
+          ASSERT (FALSE);
+          *FileHeader = NULL;
+          return EFI_NOT_FOUND;
+        }
+      }   // MU_CHANGE
 
+      // MU_CHANGE [BEGIN] - Step past a matching file before returning it, so ValidatedFileOffset can move on.
       if (FileName != NULL) {
         if (CompareGuid (&FfsFileHeader->Name, (EFI_GUID*)FileName)) {
-          *FileHeader = FfsFileHeader;
-          return EFI_SUCCESS;
+          MatchedFileHeader = FfsFileHeader;
         }
       } else if (SearchType == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE) {
         if ((FfsFileHeader->Type == EFI_FV_FILETYPE_PEIM) ||
             (FfsFileHeader->Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
             (FfsFileHeader->Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE)) {
 
-          *FileHeader = FfsFileHeader;
-          return EFI_SUCCESS;
+          MatchedFileHeader = FfsFileHeader;
         } else if (AprioriFile != NULL) {
           if (FfsFileHeader->Type == EFI_FV_FILETYPE_FREEFORM) {
             if (CompareGuid (&FfsFileHeader->Name, &gPeiAprioriFileNameGuid)) {
@@ -413,9 +607,9 @@ FindFileEx (
         }
       } else if (((SearchType == FfsFileHeader->Type) || (SearchType == EFI_FV_FILETYPE_ALL)) &&
                  (FfsFileHeader->Type != EFI_FV_FILETYPE_FFS_PAD)) {
-        *FileHeader = FfsFileHeader;
-        return EFI_SUCCESS;
+        MatchedFileHeader = FfsFileHeader;
       }
+      // MU_CHANGE [END]
 
       FileOffset    += FileOccupiedSize;
       FfsFileHeader =  (EFI_FFS_FILE_HEADER *)((UINT8 *)FfsFileHeader + FileOccupiedSize);
@@ -440,6 +634,17 @@ FindFileEx (
       *FileHeader = NULL;
       return EFI_NOT_FOUND;
     }
+
+    // MU_CHANGE [BEGIN] - Skip checksums of the files already checked.
+    if ((CoreFvHandle != NULL) && (CurrentFileOffset == CoreFvHandle->ValidatedFileOffset)) {
+      CoreFvHandle->ValidatedFileOffset = FileOffset;
+    }
+
+    if (MatchedFileHeader != NULL) {
+      *FileHeader = MatchedFileHeader;
+      return EFI_SUCCESS;
+    }
+    // MU_CHANGE [END]
   }
 
   *FileHeader = NULL;
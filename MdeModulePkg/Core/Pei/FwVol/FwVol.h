@@ -276,6 +276,38 @@ FvHandleToCoreHandle (
   IN EFI_PEI_FV_HANDLE  FvHandle
   );
 
+// MU_CHANGE [BEGIN] - Look up files in the file index built by GenFv.
+/**
+  Find the file index that GenFv stores in the extension header of a
+  firmware volume.
+
+  @param FwVolHeader     Pointer to the FV header of the volume.
+
+  @return Pointer to the file index extension entry, or NULL if the volume
+          has no valid file index.
+**/
+EDKII_FV_FILE_INDEX_EXT_ENTRY *
+FindFvFileIndex (
+  IN EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader
+  );
+
+/**
+  Look up a file by name in the file index of a firmware volume. The file
+  found is checked as FindFileEx() checks the files it walks through.
+
+  @param FwVolHeader     Pointer to the FV header of the volume to search.
+  @param FileName        Name of the file to find.
+
+  @return Pointer to the FFS file header, or NULL if the volume has no file
+          index, the file is not in it or the file does not pass the checks.
+**/
+EFI_FFS_FILE_HEADER *
+FindFileInFvFileIndex (
+  IN EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader,
+  IN CONST EFI_GUID              *FileName
+  );
+// MU_CHANGE [END]
+
 /**
   Given the input file pointer, search for the next matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
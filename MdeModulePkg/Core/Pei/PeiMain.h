@@ -48,6 +48,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/AprioriFileName.h>
 #include <Guid/MigratedFvInfo.h>
+#include <Guid/PeiTempRamUsage.h>     // MU_CHANGE
+#include <Guid/FvFileIndex.h>          // MU_CHANGE
 
 ///
 /// It is an FFS type extension used for PeiFindFileEx. It indicates current
@@ -71,6 +73,20 @@ typedef union {
 #define CALLBACK_NOTIFY_GROWTH_STEP 32
 #define DISPATCH_NOTIFY_GROWTH_STEP 8
 
+// MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+//
+// When PcdPeiCorePpiHashIndex is TRUE, the PpiPtrs buffer of PEI_PPI_LIST is
+// followed by one UINT16 per entry that links the entry to the next higher
+// index in the same hash bucket. The chains are kept in ascending order so a
+// walk returns PPI instances in install order.
+//
+#define PPI_HASH_BUCKET_COUNT       PPI_GROWTH_STEP
+#define PPI_HASH_INDEX_NONE         MAX_UINT16
+#define PPI_HASH_BUCKET(Guid)       ((((UINT32 *) (Guid))[0] ^ ((UINT32 *) (Guid))[3]) & (PPI_HASH_BUCKET_COUNT - 1))
+#define PPI_HASH_NEXT(PpiList, Index) \
+  (((UINT16 *) ((PpiList)->PpiPtrs + (PpiList)->MaxCount))[Index])
+// MU_CHANGE [END]
+
 typedef struct {
   UINTN                 CurrentCount;
   UINTN                 MaxCount;
@@ -79,6 +95,14 @@ typedef struct {
   /// MaxCount number of entries.
   ///
   PEI_PPI_LIST_POINTERS *PpiPtrs;
+  // MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+  ///
+  /// First and last entry of each hash bucket, or PPI_HASH_INDEX_NONE.
+  /// Only maintained when PcdPeiCorePpiHashIndex is TRUE.
+  ///
+  UINT16                HashHead[PPI_HASH_BUCKET_COUNT];
+  UINT16                HashTail[PPI_HASH_BUCKET_COUNT];
+  // MU_CHANGE [END]
 } PEI_PPI_LIST;
 
 typedef struct {
@@ -129,6 +153,17 @@ typedef struct {
 #define PEIM_STATE_REGISTER_FOR_SHADOW    0x02
 #define PEIM_STATE_DONE                   0x03
 
+// MU_CHANGE [BEGIN] - Only evaluate a depex again after a PPI was installed.
+//
+// The PeimState buffer of a PEI_CORE_FV_HANDLE is followed by one unaligned
+// UINT32 per PEIM. It holds the PpiInstallGeneration at which the depex of the
+// PEIM last evaluated to FALSE, or PEIM_DEPEX_GENERATION_NONE.
+//
+#define PEIM_DEPEX_GENERATION_NONE        MAX_UINT32
+#define PEIM_DEPEX_GENERATION(CoreFvHandle, Index) \
+  ((UINT32 *) ((CoreFvHandle)->PeimState + (CoreFvHandle)->PeimCount) + (Index))
+// MU_CHANGE [END]
+
 //
 // Number of FV instances to grow by each time we run out of room
 //
@@ -149,6 +184,13 @@ typedef struct {
   EFI_PEI_FILE_HANDLE                 *FvFileHandles;
   BOOLEAN                             ScanFv;
   UINT32                              AuthenticationStatus;
+  // MU_CHANGE [BEGIN] - Skip checksums of the files already checked.
+  //
+  // Offset of the first file in the FV whose header and data checksums have
+  // not been verified yet, 0 if no file has been verified yet.
+  //
+  UINT32                              ValidatedFileOffset;
+  // MU_CHANGE [END]
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
@@ -244,6 +286,12 @@ struct _PEI_CORE_INSTANCE {
   ///
   EFI_PEI_SERVICES                   *Ps;
   PEI_PPI_DATABASE                   PpiData;
+  // MU_CHANGE [BEGIN] - Only evaluate a depex again after a PPI was installed.
+  ///
+  /// Incremented each time a PPI is installed or reinstalled.
+  ///
+  UINT32                             PpiInstallGeneration;
+  // MU_CHANGE [END]
 
   ///
   /// The count of FVs which contains FFS and could be dispatched by PeiCore.
@@ -335,6 +383,12 @@ struct _PEI_CORE_INSTANCE {
   HOLE_MEMORY_DATA                  HoleData[HOLE_MAX_NUMBER];
 
   DELAYED_DISPATCH_TABLE            *DelayedDispatchTable;    // MS_CHANGE
+
+  //
+  // MU_CHANGE - Performance counter when the switch from temporary RAM
+  // started, 0 once it is recorded.
+  //
+  UINT64                            TempRamMigrationBegin;
 };
 
 ///
@@ -683,6 +737,33 @@ ProcessDispatchNotifyList (
   IN PEI_CORE_INSTANCE  *PrivateData
   );
 
+// MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+/**
+  Append an entry of the PPI list to the tail of its hash bucket.
+
+  @param PpiList    Points to the PPI list.
+  @param Index      Index of the entry. It must be higher than the index of
+                    any entry already in the hash index.
+
+**/
+VOID
+PpiHashIndexAppend (
+  IN OUT PEI_PPI_LIST  *PpiList,
+  IN     UINTN         Index
+  );
+
+/**
+  Build the hash index again from all the entries of the PPI list.
+
+  @param PpiList    Points to the PPI list.
+
+**/
+VOID
+PpiHashIndexRebuild (
+  IN OUT PEI_PPI_LIST  *PpiList
+  );
+// MU_CHANGE [END]
+
 /**
 
   Process notifications.
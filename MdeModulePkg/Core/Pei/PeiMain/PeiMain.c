@@ -457,6 +457,14 @@ PeiCore (
     }
 // END
   } else {
+    // MU_CHANGE [BEGIN] - Record the time of the switch from temporary RAM.
+    if (PrivateData.TempRamMigrationBegin != 0) {
+      PERF_START_EX (&gEfiCallerIdGuid, "TempRamMigration", NULL, PrivateData.TempRamMigrationBegin, 0);
+      PERF_END_EX (&gEfiCallerIdGuid, "TempRamMigration", NULL, 0, 0);
+      PrivateData.TempRamMigrationBegin = 0;
+    }
+    // MU_CHANGE [END]
+
     if (PcdGetBool (PcdMigrateTemporaryRamFirmwareVolumes)) {
       //
       // When PcdMigrateTemporaryRamFirmwareVolumes is TRUE, alway shadow all
@@ -468,7 +476,9 @@ PeiCore (
       //
       // Migrate installed content from Temporary RAM to Permanent RAM
       //
+      PERF_INMODULE_BEGIN ("EvacuateTempRam");     // MU_CHANGE
       EvacuateTempRam (&PrivateData, SecCoreData);
+      PERF_INMODULE_END ("EvacuateTempRam");       // MU_CHANGE
 
       DEBUG ((DEBUG_VERBOSE, "PPI lists after temporary RAM evacuation:\n"));
       DumpPpiList (&PrivateData);
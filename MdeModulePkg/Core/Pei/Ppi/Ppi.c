@@ -419,6 +419,56 @@ DumpPpiList (
   DEBUG_CODE_END ();
 }
 
+// MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+/**
+  Append an entry of the PPI list to the tail of its hash bucket.
+
+  @param PpiList    Points to the PPI list.
+  @param Index      Index of the entry. It must be higher than the index of
+                    any entry already in the hash index.
+
+**/
+VOID
+PpiHashIndexAppend (
+  IN OUT PEI_PPI_LIST  *PpiList,
+  IN     UINTN         Index
+  )
+{
+  UINTN   Bucket;
+
+  ASSERT (Index < PPI_HASH_INDEX_NONE);
+
+  Bucket = PPI_HASH_BUCKET (PpiList->PpiPtrs[Index].Ppi->Guid);
+  PPI_HASH_NEXT (PpiList, Index) = PPI_HASH_INDEX_NONE;
+  if (PpiList->HashTail[Bucket] == PPI_HASH_INDEX_NONE) {
+    PpiList->HashHead[Bucket] = (UINT16) Index;
+  } else {
+    PPI_HASH_NEXT (PpiList, PpiList->HashTail[Bucket]) = (UINT16) Index;
+  }
+  PpiList->HashTail[Bucket] = (UINT16) Index;
+}
+
+/**
+  Build the hash index again from all the entries of the PPI list.
+
+  @param PpiList    Points to the PPI list.
+
+**/
+VOID
+PpiHashIndexRebuild (
+  IN OUT PEI_PPI_LIST  *PpiList
+  )
+{
+  UINTN   Index;
+
+  SetMem16 (PpiList->HashHead, sizeof (PpiList->HashHead), PPI_HASH_INDEX_NONE);
+  SetMem16 (PpiList->HashTail, sizeof (PpiList->HashTail), PPI_HASH_INDEX_NONE);
+  for (Index = 0; Index < PpiList->CurrentCount; Index++) {
+    PpiHashIndexAppend (PpiList, Index);
+  }
+}
+// MU_CHANGE [END]
+
 /**
 
   This function installs an interface in the PEI PPI database by GUID.
@@ -482,10 +532,32 @@ InternalPeiInstallPpi (
       //
       // Run out of room, grow the buffer.
       //
-      TempPtr = AllocateZeroPool (
-                  sizeof (PEI_PPI_LIST_POINTERS) * (PpiListPointer->MaxCount + PPI_GROWTH_STEP)
-                  );
-      ASSERT (TempPtr != NULL);
+      // MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+      if (FeaturePcdGet (PcdPeiCorePpiHashIndex)) {
+        //
+        // The hash chain links follow the PPI pointers in the same buffer.
+        //
+        TempPtr = AllocateZeroPool (
+                    (sizeof (PEI_PPI_LIST_POINTERS) + sizeof (UINT16)) * (PpiListPointer->MaxCount + PPI_GROWTH_STEP)
+                    );
+        ASSERT (TempPtr != NULL);
+        if (PpiListPointer->MaxCount == 0) {
+          SetMem16 (PpiListPointer->HashHead, sizeof (PpiListPointer->HashHead), PPI_HASH_INDEX_NONE);
+          SetMem16 (PpiListPointer->HashTail, sizeof (PpiListPointer->HashTail), PPI_HASH_INDEX_NONE);
+        } else {
+          CopyMem (
+            (PEI_PPI_LIST_POINTERS *) TempPtr + PpiListPointer->MaxCount + PPI_GROWTH_STEP,
+            PpiListPointer->PpiPtrs + PpiListPointer->MaxCount,
+            sizeof (UINT16) * PpiListPointer->MaxCount
+            );
+        }
+      } else {
+        TempPtr = AllocateZeroPool (
+                    sizeof (PEI_PPI_LIST_POINTERS) * (PpiListPointer->MaxCount + PPI_GROWTH_STEP)
+                    );
+        ASSERT (TempPtr != NULL);
+      }
+      // MU_CHANGE [END]
       CopyMem (
         TempPtr,
         PpiListPointer->PpiPtrs,
@@ -518,6 +590,19 @@ InternalPeiInstallPpi (
     PpiList++;
   }
 
+  PrivateData->PpiInstallGeneration++;  // MU_CHANGE
+
+  // MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+  //
+  // Index the new PPIs only now, so a rejected list leaves no stale links.
+  //
+  if (FeaturePcdGet (PcdPeiCorePpiHashIndex)) {
+    for (Index = LastCount; Index < PpiListPointer->CurrentCount; Index++) {
+      PpiHashIndexAppend (PpiListPointer, Index);
+    }
+  }
+  // MU_CHANGE [END]
+
   //
   // Process any callback level notifies for newly installed PPIs.
   //
@@ -615,6 +700,16 @@ PeiReInstallPpi (
   //
   DEBUG((EFI_D_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
   PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *) NewPpi;
+  PrivateData->PpiInstallGeneration++;  // MU_CHANGE
+
+  // MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+  //
+  // The new PPI may use a different GUID, which moves it to another bucket.
+  //
+  if (FeaturePcdGet (PcdPeiCorePpiHashIndex) && !CompareGuid (OldPpi->Guid, NewPpi->Guid)) {
+    PpiHashIndexRebuild (&PrivateData->PpiData.PpiList);
+  }
+  // MU_CHANGE [END]
 
   //
   // Process any callback level notifies for the newly installed PPI.
@@ -665,6 +760,45 @@ PeiLocatePpi (
 
   PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS(PeiServices);
 
+  // MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+  //
+  // Only walk the entries of the bucket of Guid. The chain is in install
+  // order, so the instance numbers match the linear search below.
+  //
+  if (FeaturePcdGet (PcdPeiCorePpiHashIndex)) {
+    if (PrivateData->PpiData.PpiList.MaxCount == 0) {
+      return EFI_NOT_FOUND;
+    }
+
+    for (Index = PrivateData->PpiData.PpiList.HashHead[PPI_HASH_BUCKET (Guid)];
+         Index != PPI_HASH_INDEX_NONE;
+         Index = PPI_HASH_NEXT (&PrivateData->PpiData.PpiList, Index)) {
+      TempPtr = PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi;
+      CheckGuid = TempPtr->Guid;
+
+      if ((((INT32 *)Guid)[0] == ((INT32 *)CheckGuid)[0]) &&
+          (((INT32 *)Guid)[1] == ((INT32 *)CheckGuid)[1]) &&
+          (((INT32 *)Guid)[2] == ((INT32 *)CheckGuid)[2]) &&
+          (((INT32 *)Guid)[3] == ((INT32 *)CheckGuid)[3])) {
+        if (Instance == 0) {
+          if (PpiDescriptor != NULL) {
+            *PpiDescriptor = TempPtr;
+          }
+
+          if (Ppi != NULL) {
+            *Ppi = TempPtr->Ppi;
+          }
+
+          return EFI_SUCCESS;
+        }
+        Instance--;
+      }
+    }
+
+    return EFI_NOT_FOUND;
+  }
+  // MU_CHANGE [END]
+
   //
   // Search the data base for the matching instance of the GUIDed PPI.
   //
@@ -957,6 +1091,22 @@ ProcessNotify (
   EFI_GUID                      *SearchGuid;
   EFI_GUID                      *CheckGuid;
   EFI_PEI_NOTIFY_DESCRIPTOR     *NotifyDescriptor;
+  // MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+  UINT64                        InstallBuckets;
+  UINTN                         Bucket;
+
+  //
+  // Collect the buckets of the installed PPIs, so notify descriptors that
+  // cannot match any of them are skipped without comparing GUIDs.
+  //
+  InstallBuckets = 0;
+  if (FeaturePcdGet (PcdPeiCorePpiHashIndex)) {
+    for (Index2 = InstallStartIndex; Index2 < InstallStopIndex; Index2++) {
+      Bucket = PPI_HASH_BUCKET (PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi->Guid);
+      InstallBuckets |= LShiftU64 (1, Bucket);
+    }
+  }
+  // MU_CHANGE [END]
 
   for (Index1 = NotifyStartIndex; Index1 < NotifyStopIndex; Index1++) {
     if (NotifyType == EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK) {
@@ -967,6 +1117,45 @@ ProcessNotify (
 
     CheckGuid = NotifyDescriptor->Guid;
 
+    // MU_CHANGE [BEGIN] - Optional GUID hash index over the PPI list.
+    if (FeaturePcdGet (PcdPeiCorePpiHashIndex)) {
+      Bucket = PPI_HASH_BUCKET (CheckGuid);
+      if ((InstallBuckets & LShiftU64 (1, Bucket)) == 0) {
+        continue;
+      }
+
+      //
+      // Walk the bucket in install order. The link is read again after the
+      // notify function returns, because it may have grown the PPI list.
+      //
+      for (Index2 = PrivateData->PpiData.PpiList.HashHead[Bucket];
+           (Index2 != PPI_HASH_INDEX_NONE) && (Index2 < InstallStopIndex);
+           Index2 = PPI_HASH_NEXT (&PrivateData->PpiData.PpiList, Index2)) {
+        if (Index2 < InstallStartIndex) {
+          continue;
+        }
+
+        SearchGuid = PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi->Guid;
+        if ((((INT32 *)SearchGuid)[0] == ((INT32 *)CheckGuid)[0]) &&
+            (((INT32 *)SearchGuid)[1] == ((INT32 *)CheckGuid)[1]) &&
+            (((INT32 *)SearchGuid)[2] == ((INT32 *)CheckGuid)[2]) &&
+            (((INT32 *)SearchGuid)[3] == ((INT32 *)CheckGuid)[3])) {
+          DEBUG ((EFI_D_INFO, "Notify: PPI Guid: %g, Peim notify entry point: %p\n",
+            SearchGuid,
+            NotifyDescriptor->Notify
+            ));
+          NotifyDescriptor->Notify (
+                              (EFI_PEI_SERVICES **) GetPeiServicesTablePointer (),
+                              NotifyDescriptor,
+                              (PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi)->Ppi
+                              );
+        }
+      }
+
+      continue;
+    }
+    // MU_CHANGE [END]
+
     for (Index2 = InstallStartIndex; Index2 < InstallStopIndex; Index2++) {
       SearchGuid = PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi->Guid;
       //
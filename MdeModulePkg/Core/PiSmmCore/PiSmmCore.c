@@ -662,6 +662,12 @@ SmmEntryPoint (
   gSmmCoreSmst.CpuSaveStateSize      = SmmEntryContext->CpuSaveStateSize;
   gSmmCoreSmst.CpuSaveState          = SmmEntryContext->CpuSaveState;
 
+  // MU_CHANGE [BEGIN] - Add SMI history
+  if (mSmiHandlerProfileStatistics) {
+    SmiHandlerProfileSmiEnter ();
+  }
+  // MU_CHANGE [END]
+
   //
   // Call platform hook before Smm Dispatch
   //
@@ -736,6 +742,12 @@ SmmEntryPoint (
   //
   PlatformHookAfterSmmDispatch ();
 
+  // MU_CHANGE [BEGIN] - Add SMI history
+  if (mSmiHandlerProfileStatistics) {
+    SmiHandlerProfileSmiExit ();
+  }
+  // MU_CHANGE [END]
+
   //
   // If a legacy boot has occurred, then make sure gSmmCorePrivate is not accessed
   //
@@ -916,5 +928,7 @@ SmmMain (
 
   SmmCoreInitializeSmiHandlerProfile ();
 
+  SmmCoreInitializeScratchBuffer ();    // MU_CHANGE
+
   return EFI_SUCCESS;
 }
@@ -28,6 +28,7 @@
 #include <Protocol/SmmReadyToBoot.h>
 #include <Protocol/SmmMemoryAttribute.h>
 #include <Protocol/SmmSxDispatch2.h>
+#include <Protocol/SmmScratchBuffer.h>    // MU_CHANGE
 
 #include <Guid/Apriori.h>
 #include <Guid/EventGroup.h>
@@ -55,6 +56,7 @@
 #include <Library/HobLib.h>
 #include <Library/SmmMemLib.h>
 #include <Library/BaseBinSecurityLib.h>          // MS_CHANGE_?
+#include <Library/TimerLib.h>                    // MU_CHANGE
 
 #include "PiSmmCorePrivateData.h"
 #include "HeapGuard.h"
@@ -75,14 +77,24 @@ typedef struct {
 
 #define SMI_ENTRY_SIGNATURE  SIGNATURE_32('s','m','i','e')
 
- typedef struct {
+ typedef struct _SMI_ENTRY {
   UINTN       Signature;
   LIST_ENTRY  AllEntries;  // All entries
 
   EFI_GUID    HandlerType; // Type of interrupt
   LIST_ENTRY  SmiHandlers; // All handlers
+  struct _SMI_ENTRY  *HashNext;    // Next entry in the same hash bucket  // MU_CHANGE
 } SMI_ENTRY;
 
+// MU_CHANGE [BEGIN] - Find SMI entries through a hash table.
+//
+// Number of hash buckets for SMI entries. It must be a power of two.
+//
+#define SMI_ENTRY_HASH_BUCKET_COUNT  32
+#define SMI_ENTRY_HASH_BUCKET(Guid) \
+  ((((CONST UINT32 *) (Guid))[0] ^ ((CONST UINT32 *) (Guid))[3]) & (SMI_ENTRY_HASH_BUCKET_COUNT - 1))
+// MU_CHANGE [END]
+
 #define SMI_HANDLER_SIGNATURE  SIGNATURE_32('s','m','i','h')
 
  typedef struct {
@@ -93,6 +105,11 @@ typedef struct {
   SMI_ENTRY                     *SmiEntry;
   VOID                          *Context;    // for profile
   UINTN                         ContextSize; // for profile
+  // MU_CHANGE [BEGIN] - Add handler statistics
+  UINT64                        HitCount;    // for profile
+  UINT64                        TotalTicks;  // for profile
+  UINT64                        MaxTicks;    // for profile
+  // MU_CHANGE [END]
 } SMI_HANDLER;
 
 //
@@ -1149,6 +1166,99 @@ SmmCoreInitializeSmiHandlerProfile (
   VOID
   );
 
+// MU_CHANGE [BEGIN] - Add handler statistics
+/**
+  Record one call of an SMI handler by SmiManage().
+
+  The handler may have unregistered itself, so it is only updated when it is
+  still registered for HandlerType.
+
+  @param HandlerType  The handler type passed to SmiManage(), or NULL for root SMI handlers.
+  @param SmiHandler   The SMI handler that was called.
+  @param StartTicks   The performance counter before the handler was called.
+  @param EndTicks     The performance counter after the handler returned.
+
+**/
+VOID
+SmiHandlerProfileRecordHit (
+  IN CONST EFI_GUID  *HandlerType  OPTIONAL,
+  IN SMI_HANDLER     *SmiHandler,
+  IN UINT64          StartTicks,
+  IN UINT64          EndTicks
+  );
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Add SMI history
+/**
+  Start the SMI history record of the SMI being entered.
+**/
+VOID
+SmiHandlerProfileSmiEnter (
+  VOID
+  );
+
+/**
+  Record the first handler that handled the current SMI.
+
+  @param HandlerType  The handler type passed to SmiManage(), or NULL for root SMI handlers.
+  @param SmiHandler   The SMI handler that handled the SMI.
+
+**/
+VOID
+SmiHandlerProfileRecordSource (
+  IN CONST EFI_GUID  *HandlerType  OPTIONAL,
+  IN SMI_HANDLER     *SmiHandler
+  );
+
+/**
+  Complete the SMI history record of the SMI being exited.
+**/
+VOID
+SmiHandlerProfileSmiExit (
+  VOID
+  );
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Scratch buffers released when the SMI handler returns
+///
+/// Scratch buffer state saved by SmiManage() around one SMI handler call.
+///
+typedef struct {
+  UINTN   Offset;
+  VOID    *Overflow;
+} SMM_SCRATCH_BUFFER_MARK;
+
+/**
+  Record the scratch buffer state before SmiManage() calls an SMI handler.
+
+  @param[out] Mark              The state to pass to SmmScratchBufferLeave().
+**/
+VOID
+SmmScratchBufferEnter (
+  OUT SMM_SCRATCH_BUFFER_MARK  *Mark
+  );
+
+/**
+  Release the scratch buffers allocated since the matching
+  SmmScratchBufferEnter().
+
+  @param[in]  Mark              The state returned by SmmScratchBufferEnter().
+**/
+VOID
+SmmScratchBufferLeave (
+  IN CONST SMM_SCRATCH_BUFFER_MARK  *Mark
+  );
+
+/**
+  Allocate the scratch buffer arena and install the SMM Scratch Buffer
+  Protocol.
+**/
+VOID
+SmmCoreInitializeScratchBuffer (
+  VOID
+  );
+// MU_CHANGE [END]
+
 /**
   This function is called by SmmChildDispatcher module to report
   a new SMI handler is registered, to SmmCore.
@@ -1214,6 +1324,11 @@ extern EFI_SMM_DRIVER_ENTRY       *mSmmCoreDriverEntry;
 
 extern EFI_LOADED_IMAGE_PROTOCOL  *mSmmCoreLoadedImage;
 
+//
+// Set when SmiManage() must record the SMI handler statistics.
+//
+extern BOOLEAN                    mSmiHandlerProfileStatistics;  // MU_CHANGE
+
 //
 // Page management
 //
@@ -15,8 +15,15 @@ SMI_ENTRY   mRootSmiEntry = {
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.AllEntries),
   {0},
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.SmiHandlers),
+  NULL
 };
 
+//
+// SMI entries hashed by HandlerType. Each bucket keeps the entry found last
+// at its head, so the handler types that trigger most SMIs are found first.
+//
+SMI_ENTRY   *mSmiEntryHash[SMI_ENTRY_HASH_BUCKET_COUNT];  // MU_CHANGE
+
 /**
   Finds the SMI entry for the requested handler type.
 
@@ -33,27 +40,34 @@ SmmCoreFindSmiEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY  *Link;
   SMI_ENTRY   *Item;
   SMI_ENTRY   *SmiEntry;
+  // MU_CHANGE [BEGIN] - Find SMI entries through a hash table.
+  SMI_ENTRY   *Previous;
+  UINTN       Bucket;
 
   //
-  // Search the SMI entry list for the matching GUID
+  // Search the hash bucket for the matching GUID
   //
   SmiEntry = NULL;
-  for (Link = mSmiEntryList.ForwardLink;
-       Link != &mSmiEntryList;
-       Link = Link->ForwardLink) {
-
-    Item = CR (Link, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+  Previous = NULL;
+  Bucket   = SMI_ENTRY_HASH_BUCKET (HandlerType);
+  for (Item = mSmiEntryHash[Bucket]; Item != NULL; Item = Item->HashNext) {
     if (CompareGuid (&Item->HandlerType, HandlerType)) {
       //
-      // This is the SMI entry
+      // This is the SMI entry. Move it to the head of the bucket.
       //
+      if (Previous != NULL) {
+        Previous->HashNext    = Item->HashNext;
+        Item->HashNext        = mSmiEntryHash[Bucket];
+        mSmiEntryHash[Bucket] = Item;
+      }
       SmiEntry = Item;
       break;
     }
+    Previous = Item;
   }
+  // MU_CHANGE [END]
 
   //
   // If the protocol entry was not found and Create is TRUE, then
@@ -73,6 +87,11 @@ SmmCoreFindSmiEntry (
       // Add it to SMI entry list
       //
       InsertTailList (&mSmiEntryList, &SmiEntry->AllEntries);
+
+      // MU_CHANGE [BEGIN] - Find SMI entries through a hash table.
+      SmiEntry->HashNext    = mSmiEntryHash[Bucket];
+      mSmiEntryHash[Bucket] = SmiEntry;
+      // MU_CHANGE [END]
     }
   }
   return SmiEntry;
@@ -107,8 +126,11 @@ SmiManage (
   SMI_HANDLER  *SmiHandler;
   BOOLEAN      SuccessReturn;
   EFI_STATUS   Status;
+  UINT64       StartTicks;  // MU_CHANGE
+  SMM_SCRATCH_BUFFER_MARK  ScratchMark;  // MU_CHANGE
 
   Status = EFI_NOT_FOUND;
+  StartTicks = 0;  // MU_CHANGE
   SuccessReturn = FALSE;
   if (HandlerType == NULL) {
     //
@@ -132,6 +154,14 @@ SmiManage (
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
     SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
 
+    // MU_CHANGE [BEGIN] - Add handler statistics
+    if (mSmiHandlerProfileStatistics) {
+      StartTicks = GetPerformanceCounter ();
+    }
+    // MU_CHANGE [END]
+
+    SmmScratchBufferEnter (&ScratchMark);   // MU_CHANGE
+
     Status = SmiHandler->Handler (
                (EFI_HANDLE) SmiHandler,
                Context,
@@ -139,6 +169,17 @@ SmiManage (
                CommBufferSize
                );
 
+    SmmScratchBufferLeave (&ScratchMark);   // MU_CHANGE
+
+    // MU_CHANGE [BEGIN] - Add handler statistics
+    if (mSmiHandlerProfileStatistics) {
+      SmiHandlerProfileRecordHit (HandlerType, SmiHandler, StartTicks, GetPerformanceCounter ());
+      if ((Status == EFI_SUCCESS) || (Status == EFI_WARN_INTERRUPT_SOURCE_QUIESCED)) {
+        SmiHandlerProfileRecordSource (HandlerType, SmiHandler);  // MU_CHANGE - Add SMI history
+      }
+    }
+    // MU_CHANGE [END]
+
     switch (Status) {
     case EFI_INTERRUPT_PENDING:
       //
@@ -272,6 +313,7 @@ SmiHandlerUnRegister (
   SMI_ENTRY    *SmiEntry;
   LIST_ENTRY   *EntryLink;
   LIST_ENTRY   *HandlerLink;
+  SMI_ENTRY    **Previous;  // MU_CHANGE
 
   if (DispatchHandle == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -326,6 +368,17 @@ SmiHandlerUnRegister (
     //
     RemoveEntryList (&SmiEntry->AllEntries);
 
+    // MU_CHANGE [BEGIN] - Find SMI entries through a hash table.
+    for (Previous = &mSmiEntryHash[SMI_ENTRY_HASH_BUCKET (&SmiEntry->HandlerType)];
+         *Previous != NULL;
+         Previous = &(*Previous)->HashNext) {
+      if (*Previous == SmiEntry) {
+        *Previous = SmiEntry->HashNext;
+        break;
+      }
+    }
+    // MU_CHANGE [END]
+
     FreePool (SmiEntry);
   }
 
@@ -53,6 +53,24 @@ BuildSmiHandlerProfileDatabase(
   VOID
   );
 
+// MU_CHANGE [BEGIN] - Add handler statistics
+/**
+  Finds the SMI entry for the requested handler type.
+
+  @param  HandlerType            The type of the interrupt
+  @param  Create                 Create a new entry if not found
+
+  @return SMI entry
+
+**/
+SMI_ENTRY  *
+EFIAPI
+SmmCoreFindSmiEntry (
+  IN EFI_GUID  *HandlerType,
+  IN BOOLEAN   Create
+  );
+// MU_CHANGE [END]
+
 /**
   Retrieves and returns a pointer to the entry point to a PE/COFF image that has been loaded
   into system memory with the PE/COFF Loader Library functions.
@@ -104,6 +122,25 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmHardwareSmiDatabaseSize;
 
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN  mSmiHandlerProfileRecordingStatus;
 
+// MU_CHANGE [BEGIN] - Add handler statistics
+GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN  mSmiHandlerProfileStatistics = FALSE;
+GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN  mSmiHandlerProfileCounterCountsUp;
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Add SMI history
+#define SMI_HANDLER_PROFILE_STORM_WINDOW  1000000000ULL
+
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mSmiHistoryBaseTicks;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mSmiHistoryEntryTicks;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mSmiHistoryWindowStart;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mSmiHistoryWindowCount;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mSmiHistorySmiCount;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mSmiHistoryMaxSmiPerSecond;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mSmiHistoryLatencyHistogram[SMI_HANDLER_PROFILE_LATENCY_BUCKET_COUNT];
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32                          mSmiHistoryNextRecord;
+GLOBAL_REMOVE_IF_UNREFERENCED SMI_HANDLER_PROFILE_SMI_RECORD  mSmiHistoryRecords[SMI_HANDLER_PROFILE_SMI_RECORD_COUNT];
+// MU_CHANGE [END]
+
 GLOBAL_REMOVE_IF_UNREFERENCED SMI_HANDLER_PROFILE_PROTOCOL  mSmiHandlerProfile = {
   SmiHandlerProfileRegisterHandler,
   SmiHandlerProfileUnregisterHandler,
@@ -717,6 +754,11 @@ GetSmmSmiHandlerDataOnSmiEntry(
     SmiHandlerStruct->Handler = (UINTN)SmiHandler->Handler;
     SmiHandlerStruct->ImageRef = AddressToImageRef((UINTN)SmiHandler->Handler);
     SmiHandlerStruct->ContextBufferSize = (UINT32)SmiHandler->ContextSize;
+    // MU_CHANGE [BEGIN] - Add handler statistics
+    SmiHandlerStruct->HitCount  = SmiHandler->HitCount;
+    SmiHandlerStruct->TotalTime = GetTimeInNanoSecond (SmiHandler->TotalTicks);
+    SmiHandlerStruct->MaxTime   = GetTimeInNanoSecond (SmiHandler->MaxTicks);
+    // MU_CHANGE [END]
     if (SmiHandler->ContextSize != 0) {
       SmiHandlerStruct->ContextBufferOffset = sizeof(SMM_CORE_SMI_HANDLER_STRUCTURE);
       CopyMem ((UINT8 *)SmiHandlerStruct + SmiHandlerStruct->ContextBufferOffset, SmiHandler->Context, SmiHandler->ContextSize);
@@ -885,6 +927,256 @@ SmiHandlerProfileCopyData(
   *DataOffset = *DataOffset + *DataSize;
 }
 
+// MU_CHANGE [BEGIN] - Add handler statistics
+/**
+  Get the number of performance counter ticks between two counter values.
+
+  @param StartTicks  The earlier performance counter value.
+  @param EndTicks    The later performance counter value.
+
+  @return The number of ticks elapsed.
+**/
+UINT64
+SmiHandlerProfileElapsedTicks (
+  IN UINT64  StartTicks,
+  IN UINT64  EndTicks
+  )
+{
+  return mSmiHandlerProfileCounterCountsUp ? (EndTicks - StartTicks) : (StartTicks - EndTicks);
+}
+
+/**
+  Record one call of an SMI handler by SmiManage().
+
+  The handler may have unregistered itself, so it is only updated when it is
+  still registered for HandlerType.
+
+  @param HandlerType  The handler type passed to SmiManage(), or NULL for root SMI handlers.
+  @param SmiHandler   The SMI handler that was called.
+  @param StartTicks   The performance counter before the handler was called.
+  @param EndTicks     The performance counter after the handler returned.
+
+**/
+VOID
+SmiHandlerProfileRecordHit (
+  IN CONST EFI_GUID  *HandlerType  OPTIONAL,
+  IN SMI_HANDLER     *SmiHandler,
+  IN UINT64          StartTicks,
+  IN UINT64          EndTicks
+  )
+{
+  SMI_ENTRY       *SmiEntry;
+  LIST_ENTRY      *Link;
+  SMI_HANDLER     *Item;
+  UINT64          Ticks;
+
+  if (HandlerType == NULL) {
+    SmiEntry = &mRootSmiEntry;
+  } else {
+    SmiEntry = SmmCoreFindSmiEntry ((EFI_GUID *) HandlerType, FALSE);
+    if (SmiEntry == NULL) {
+      return;
+    }
+  }
+
+  for (Link = SmiEntry->SmiHandlers.ForwardLink;
+       Link != &SmiEntry->SmiHandlers;
+       Link = Link->ForwardLink) {
+    Item = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
+    if (Item == SmiHandler) {
+      Ticks = SmiHandlerProfileElapsedTicks (StartTicks, EndTicks);
+      SmiHandler->HitCount++;
+      SmiHandler->TotalTicks += Ticks;
+      if (Ticks > SmiHandler->MaxTicks) {
+        SmiHandler->MaxTicks = Ticks;
+      }
+      return;
+    }
+  }
+}
+
+/**
+  Copy the current statistics of the root and GUID SMI handlers into the SMI
+  handler profile database.
+**/
+VOID
+UpdateSmiHandlerProfileStatistics (
+  VOID
+  )
+{
+  SMM_CORE_SMI_DATABASE_STRUCTURE  *SmiStruct;
+  SMM_CORE_SMI_HANDLER_STRUCTURE   *SmiHandlerStruct;
+  SMI_ENTRY                        *SmiEntry;
+  LIST_ENTRY                       *Link;
+  SMI_HANDLER                      *SmiHandler;
+  UINT32                           Index;
+
+  SmiStruct = mSmiHandlerProfileDatabase;
+  while ((UINTN)SmiStruct < (UINTN)mSmiHandlerProfileDatabase + mSmiHandlerProfileDatabaseSize) {
+    if ((SmiStruct->Header.Signature != SMM_CORE_SMI_DATABASE_SIGNATURE) ||
+        (SmiStruct->HandlerCategory == SmmCoreSmiHandlerCategoryHardwareHandler)) {
+      SmiStruct = (VOID *)((UINTN)SmiStruct + SmiStruct->Header.Length);
+      continue;
+    }
+
+    if (SmiStruct->HandlerCategory == SmmCoreSmiHandlerCategoryRootHandler) {
+      SmiEntry = &mRootSmiEntry;
+    } else {
+      SmiEntry = SmmCoreFindSmiEntry (&SmiStruct->HandlerType, FALSE);
+    }
+
+    SmiHandlerStruct = (VOID *)(SmiStruct + 1);
+    for (Index = 0; Index < SmiStruct->HandlerCount; Index++) {
+      if (SmiEntry != NULL) {
+        for (Link = SmiEntry->SmiHandlers.ForwardLink;
+             Link != &SmiEntry->SmiHandlers;
+             Link = Link->ForwardLink) {
+          SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
+          if (((UINTN)SmiHandler->Handler == SmiHandlerStruct->Handler) &&
+              ((UINTN)SmiHandler->CallerAddr == SmiHandlerStruct->CallerAddr)) {
+            SmiHandlerStruct->HitCount  = SmiHandler->HitCount;
+            SmiHandlerStruct->TotalTime = GetTimeInNanoSecond (SmiHandler->TotalTicks);
+            SmiHandlerStruct->MaxTime   = GetTimeInNanoSecond (SmiHandler->MaxTicks);
+            break;
+          }
+        }
+      }
+      SmiHandlerStruct = (VOID *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
+    }
+
+    SmiStruct = (VOID *)((UINTN)SmiStruct + SmiStruct->Header.Length);
+  }
+}
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Add SMI history
+/**
+  Start the SMI history record of the SMI being entered.
+**/
+VOID
+SmiHandlerProfileSmiEnter (
+  VOID
+  )
+{
+  SMI_HANDLER_PROFILE_SMI_RECORD  *Record;
+
+  mSmiHistoryEntryTicks = GetPerformanceCounter ();
+
+  Record = &mSmiHistoryRecords[mSmiHistoryNextRecord];
+  ZeroMem (&Record->HandlerType, sizeof (Record->HandlerType));
+  Record->Handler = 0;
+}
+
+/**
+  Record the first handler that handled the current SMI.
+
+  @param HandlerType  The handler type passed to SmiManage(), or NULL for root SMI handlers.
+  @param SmiHandler   The SMI handler that handled the SMI.
+
+**/
+VOID
+SmiHandlerProfileRecordSource (
+  IN CONST EFI_GUID  *HandlerType  OPTIONAL,
+  IN SMI_HANDLER     *SmiHandler
+  )
+{
+  SMI_HANDLER_PROFILE_SMI_RECORD  *Record;
+
+  Record = &mSmiHistoryRecords[mSmiHistoryNextRecord];
+  if (Record->Handler != 0) {
+    return;
+  }
+
+  Record->Handler = (PHYSICAL_ADDRESS)(UINTN)SmiHandler->Handler;
+  if (HandlerType != NULL) {
+    CopyGuid (&Record->HandlerType, HandlerType);
+  }
+}
+
+/**
+  Complete the SMI history record of the SMI being exited.
+**/
+VOID
+SmiHandlerProfileSmiExit (
+  VOID
+  )
+{
+  SMI_HANDLER_PROFILE_SMI_RECORD  *Record;
+  UINT64                          ExitTicks;
+  UINT64                          Microseconds;
+  UINTN                           Bucket;
+
+  ExitTicks = GetPerformanceCounter ();
+
+  Record            = &mSmiHistoryRecords[mSmiHistoryNextRecord];
+  Record->EntryTime = GetTimeInNanoSecond (SmiHandlerProfileElapsedTicks (mSmiHistoryBaseTicks, mSmiHistoryEntryTicks));
+  Record->Duration  = GetTimeInNanoSecond (SmiHandlerProfileElapsedTicks (mSmiHistoryEntryTicks, ExitTicks));
+
+  mSmiHistoryNextRecord = (mSmiHistoryNextRecord + 1) % SMI_HANDLER_PROFILE_SMI_RECORD_COUNT;
+  mSmiHistorySmiCount++;
+
+  Microseconds = DivU64x32 (Record->Duration, 1000);
+  Bucket       = (Microseconds == 0) ? 0 : (UINTN)HighBitSet64 (Microseconds) + 1;
+  if (Bucket >= SMI_HANDLER_PROFILE_LATENCY_BUCKET_COUNT) {
+    Bucket = SMI_HANDLER_PROFILE_LATENCY_BUCKET_COUNT - 1;
+  }
+
+  mSmiHistoryLatencyHistogram[Bucket]++;
+
+  //
+  // Count the SMIs of the current one second window.
+  //
+  if ((mSmiHistoryWindowCount == 0) || (Record->EntryTime - mSmiHistoryWindowStart >= SMI_HANDLER_PROFILE_STORM_WINDOW)) {
+    mSmiHistoryWindowStart = Record->EntryTime;
+    mSmiHistoryWindowCount = 0;
+  }
+
+  mSmiHistoryWindowCount++;
+  if (mSmiHistoryWindowCount > mSmiHistoryMaxSmiPerSecond) {
+    mSmiHistoryMaxSmiPerSecond = mSmiHistoryWindowCount;
+  }
+}
+
+/**
+  SMI handler profile handler to get the SMI history.
+
+  @param SmiHandlerProfileParameterGetSmiHistory   The parameter of SMI handler profile get SMI history.
+
+**/
+VOID
+SmiHandlerProfileHandlerGetSmiHistory (
+  OUT SMI_HANDLER_PROFILE_PARAMETER_GET_SMI_HISTORY  *SmiHandlerProfileParameterGetSmiHistory
+  )
+{
+  UINT32  RecordCount;
+  UINT32  Oldest;
+  UINT32  Index;
+
+  //
+  // The current SMI is still open, so it isn't reported.
+  //
+  RecordCount = (UINT32)MIN (mSmiHistorySmiCount, SMI_HANDLER_PROFILE_SMI_RECORD_COUNT);
+  Oldest      = (mSmiHistoryNextRecord + SMI_HANDLER_PROFILE_SMI_RECORD_COUNT - RecordCount) % SMI_HANDLER_PROFILE_SMI_RECORD_COUNT;
+  for (Index = 0; Index < RecordCount; Index++) {
+    CopyMem (
+      &SmiHandlerProfileParameterGetSmiHistory->Records[Index],
+      &mSmiHistoryRecords[(Oldest + Index) % SMI_HANDLER_PROFILE_SMI_RECORD_COUNT],
+      sizeof (SMI_HANDLER_PROFILE_SMI_RECORD)
+      );
+  }
+
+  SmiHandlerProfileParameterGetSmiHistory->SmiCount        = mSmiHistorySmiCount;
+  SmiHandlerProfileParameterGetSmiHistory->MaxSmiPerSecond = mSmiHistoryMaxSmiPerSecond;
+  CopyMem (
+    SmiHandlerProfileParameterGetSmiHistory->LatencyHistogram,
+    mSmiHistoryLatencyHistogram,
+    sizeof (mSmiHistoryLatencyHistogram)
+    );
+  SmiHandlerProfileParameterGetSmiHistory->RecordCount         = RecordCount;
+  SmiHandlerProfileParameterGetSmiHistory->Header.ReturnStatus = 0;
+}
+// MU_CHANGE [END]
+
 /**
   SMI handler profile handler to get info.
 
@@ -901,6 +1193,8 @@ SmiHandlerProfileHandlerGetInfo(
   SmiHandlerProfileRecordingStatus = mSmiHandlerProfileRecordingStatus;
   mSmiHandlerProfileRecordingStatus = FALSE;
 
+  UpdateSmiHandlerProfileStatistics ();  // MU_CHANGE
+
   SmiHandlerProfileParameterGetInfo->DataSize = mSmiHandlerProfileDatabaseSize;
   SmiHandlerProfileParameterGetInfo->Header.ReturnStatus = 0;
 
@@ -1015,6 +1309,16 @@ SmiHandlerProfileHandler(
     }
     SmiHandlerProfileHandlerGetDataByOffset((SMI_HANDLER_PROFILE_PARAMETER_GET_DATA_BY_OFFSET *)(UINTN)CommBuffer);
     break;
+  // MU_CHANGE [BEGIN] - Add SMI history
+  case SMI_HANDLER_PROFILE_COMMAND_GET_SMI_HISTORY:
+    DEBUG((DEBUG_ERROR, "SmiHandlerProfileHandlerGetSmiHistory\n"));
+    if (TempCommBufferSize != sizeof(SMI_HANDLER_PROFILE_PARAMETER_GET_SMI_HISTORY)) {
+      DEBUG((DEBUG_ERROR, "SmiHandlerProfileHandler: SMM communication buffer size invalid!\n"));
+      return EFI_SUCCESS;
+    }
+    SmiHandlerProfileHandlerGetSmiHistory((SMI_HANDLER_PROFILE_PARAMETER_GET_SMI_HISTORY *)(UINTN)CommBuffer);
+    break;
+  // MU_CHANGE [END]
   default:
     break;
   }
@@ -1354,10 +1658,19 @@ SmmCoreInitializeSmiHandlerProfile (
   EFI_STATUS  Status;
   VOID        *Registration;
   EFI_HANDLE  Handle;
+  UINT64      StartValue;  // MU_CHANGE
+  UINT64      EndValue;    // MU_CHANGE
 
   if ((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x1) != 0) {
     InsertTailList (&mRootSmiEntryList, &mRootSmiEntry.AllEntries);
 
+    // MU_CHANGE [BEGIN] - Add handler statistics
+    GetPerformanceCounterProperties (&StartValue, &EndValue);
+    mSmiHandlerProfileCounterCountsUp = (BOOLEAN)(EndValue >= StartValue);
+    mSmiHistoryBaseTicks              = GetPerformanceCounter ();  // MU_CHANGE - Add SMI history
+    mSmiHandlerProfileStatistics      = TRUE;
+    // MU_CHANGE [END]
+
     Status = gSmst->SmmRegisterProtocolNotify (
                       &gEfiSmmReadyToLockProtocolGuid,
                       SmmReadyToLockInSmiHandlerProfile,
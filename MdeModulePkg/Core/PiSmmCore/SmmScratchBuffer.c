@@ -0,0 +1,179 @@
+/** @file
+  SMM scratch buffers for SMI handlers.
+
+  Scratch buffers are carved from a fixed SMRAM arena with a bump pointer.
+  SmiManage() records the arena position before it calls an SMI handler and
+  moves it back when the handler returns, so the buffers are released without
+  individual frees. When the arena is full, or PcdSmmScratchBufferSize is 0,
+  the buffers come from the SMM pool and are freed at the same point.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PiSmmCore.h"
+
+//
+// Header of a scratch buffer that did not fit in the arena.
+//
+typedef struct _SMM_SCRATCH_BUFFER_OVERFLOW  SMM_SCRATCH_BUFFER_OVERFLOW;
+struct _SMM_SCRATCH_BUFFER_OVERFLOW {
+  SMM_SCRATCH_BUFFER_OVERFLOW   *Next;
+  UINT64                        Size;
+};
+
+EFI_STATUS
+EFIAPI
+SmmAllocateScratchBuffer (
+  IN  CONST EDKII_SMM_SCRATCH_BUFFER_PROTOCOL  *This,
+  IN        UINTN                              Size,
+  OUT       VOID                               **Buffer
+  );
+
+EDKII_SMM_SCRATCH_BUFFER_PROTOCOL  mSmmScratchBufferProtocol = {
+  EDKII_SMM_SCRATCH_BUFFER_PROTOCOL_REVISION,
+  SmmAllocateScratchBuffer
+};
+
+UINT8                       *mSmmScratchBuffer        = NULL;
+UINTN                       mSmmScratchBufferSize     = 0;
+UINTN                       mSmmScratchBufferOffset   = 0;
+SMM_SCRATCH_BUFFER_OVERFLOW *mSmmScratchBufferOverflow = NULL;
+UINTN                       mSmmScratchBufferDepth    = 0;
+
+/**
+  Allocate a scratch buffer for the SMI handler that is running.
+
+  @param[in]  This          The EDKII_SMM_SCRATCH_BUFFER_PROTOCOL instance.
+  @param[in]  Size          The size of the buffer in bytes.
+  @param[out] Buffer        On return, the allocated buffer.
+
+  @retval EFI_SUCCESS           The buffer was allocated.
+  @retval EFI_INVALID_PARAMETER Size is 0, or Buffer is NULL.
+  @retval EFI_NOT_READY         No SMI handler is running.
+  @retval EFI_OUT_OF_RESOURCES  The buffer cannot be allocated.
+**/
+EFI_STATUS
+EFIAPI
+SmmAllocateScratchBuffer (
+  IN  CONST EDKII_SMM_SCRATCH_BUFFER_PROTOCOL  *This,
+  IN        UINTN                              Size,
+  OUT       VOID                               **Buffer
+  )
+{
+  SMM_SCRATCH_BUFFER_OVERFLOW  *Overflow;
+  EFI_STATUS                   Status;
+
+  if ((Size == 0) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Nothing would release a buffer allocated outside of an SMI handler.
+  //
+  if (mSmmScratchBufferDepth == 0) {
+    return EFI_NOT_READY;
+  }
+
+  if (Size <= mSmmScratchBufferSize - mSmmScratchBufferOffset) {
+    *Buffer = mSmmScratchBuffer + mSmmScratchBufferOffset;
+    mSmmScratchBufferOffset += ALIGN_VALUE (Size, sizeof (UINT64));
+    if (mSmmScratchBufferOffset > mSmmScratchBufferSize) {
+      mSmmScratchBufferOffset = mSmmScratchBufferSize;
+    }
+    return EFI_SUCCESS;
+  }
+
+  if (Size > MAX_UINTN - sizeof (SMM_SCRATCH_BUFFER_OVERFLOW)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = SmmInternalAllocatePool (
+             EfiRuntimeServicesData,
+             sizeof (SMM_SCRATCH_BUFFER_OVERFLOW) + Size,
+             (VOID **)&Overflow
+             );
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Overflow->Next            = mSmmScratchBufferOverflow;
+  Overflow->Size            = Size;
+  mSmmScratchBufferOverflow = Overflow;
+  *Buffer                   = Overflow + 1;
+  return EFI_SUCCESS;
+}
+
+/**
+  Record the scratch buffer state before SmiManage() calls an SMI handler.
+
+  @param[out] Mark              The state to pass to SmmScratchBufferLeave().
+**/
+VOID
+SmmScratchBufferEnter (
+  OUT SMM_SCRATCH_BUFFER_MARK  *Mark
+  )
+{
+  Mark->Offset   = mSmmScratchBufferOffset;
+  Mark->Overflow = mSmmScratchBufferOverflow;
+  mSmmScratchBufferDepth++;
+}
+
+/**
+  Release the scratch buffers allocated since the matching
+  SmmScratchBufferEnter().
+
+  @param[in]  Mark              The state returned by SmmScratchBufferEnter().
+**/
+VOID
+SmmScratchBufferLeave (
+  IN CONST SMM_SCRATCH_BUFFER_MARK  *Mark
+  )
+{
+  SMM_SCRATCH_BUFFER_OVERFLOW  *Overflow;
+
+  ASSERT (mSmmScratchBufferDepth != 0);
+  mSmmScratchBufferDepth--;
+
+  while (mSmmScratchBufferOverflow != Mark->Overflow) {
+    ASSERT (mSmmScratchBufferOverflow != NULL);
+    Overflow                  = mSmmScratchBufferOverflow;
+    mSmmScratchBufferOverflow = Overflow->Next;
+    SmmInternalFreePool (Overflow);
+  }
+  mSmmScratchBufferOffset = Mark->Offset;
+}
+
+/**
+  Allocate the scratch buffer arena and install the SMM Scratch Buffer
+  Protocol.
+**/
+VOID
+SmmCoreInitializeScratchBuffer (
+  VOID
+  )
+{
+  EFI_HANDLE  Handle;
+  EFI_STATUS  Status;
+  UINTN       Pages;
+
+  Pages = EFI_SIZE_TO_PAGES ((UINTN)PcdGet32 (PcdSmmScratchBufferSize));
+  if (Pages != 0) {
+    mSmmScratchBuffer = AllocatePages (Pages);
+    if (mSmmScratchBuffer != NULL) {
+      mSmmScratchBufferSize = EFI_PAGES_TO_SIZE (Pages);
+    } else {
+      DEBUG ((DEBUG_WARN, "SMM scratch buffer arena of %ld pages cannot be allocated\n", (UINT64)Pages));
+    }
+  }
+
+  Handle = NULL;
+  Status = SmmInstallProtocolInterface (
+             &Handle,
+             &gEdkiiSmmScratchBufferProtocolGuid,
+             EFI_NATIVE_INTERFACE,
+             &mSmmScratchBufferProtocol
+             );
+  ASSERT_EFI_ERROR (Status);
+}
@@ -77,6 +77,17 @@ GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN mSmramProfileRecordingEnable = MEMORY_PROF
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_DEVICE_PATH_PROTOCOL *mSmramProfileDriverPath;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN                    mSmramProfileDriverPathSize;
 
+// MU_CHANGE [BEGIN] - Fixed size allocation event ring
+//
+// When the ring is allocated, allocate and free actions are only written to the
+// ring. mSmramProfileEventNext is the ring entry that the next event goes to.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED MEMORY_PROFILE_EVENT     *mSmramProfileEventRing = NULL;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32                   mSmramProfileEventRingSize = 0;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32                   mSmramProfileEventNext = 0;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                   mSmramProfileEventCount = 0;
+// MU_CHANGE [END]
+
 /**
   Dump SMRAM information.
 
@@ -637,6 +648,106 @@ RegisterSmmCore (
   return TRUE;
 }
 
+// MU_CHANGE [BEGIN] - Fixed size allocation event ring
+/**
+  Allocate the allocation event ring if PcdMemoryProfileEventRingSize asks for it.
+
+  This is the only allocation the ring does. If it fails, the full alloc info
+  records are kept instead.
+
+**/
+STATIC
+VOID
+SmramProfileInitEventRing (
+  VOID
+  )
+{
+  UINT32    RingSize;
+  UINT32    Index;
+
+  RingSize = PcdGet32 (PcdMemoryProfileEventRingSize);
+  if (RingSize == 0) {
+    return;
+  }
+
+  mSmramProfileEventRing = AllocateZeroPool (RingSize * sizeof (MEMORY_PROFILE_EVENT));
+  if (mSmramProfileEventRing == NULL) {
+    DEBUG ((DEBUG_WARN, "SmramProfileInit: no memory for %d ring events\n", RingSize));
+    return;
+  }
+
+  //
+  // Fill in the headers now so that recording only writes the event payload.
+  //
+  for (Index = 0; Index < RingSize; Index++) {
+    mSmramProfileEventRing[Index].Header.Signature = MEMORY_PROFILE_EVENT_SIGNATURE;
+    mSmramProfileEventRing[Index].Header.Length    = sizeof (MEMORY_PROFILE_EVENT);
+    mSmramProfileEventRing[Index].Header.Revision  = MEMORY_PROFILE_EVENT_REVISION;
+  }
+  mSmramProfileEventRingSize = RingSize;
+  mSmramProfileEventNext     = 0;
+  mSmramProfileEventCount    = 0;
+}
+
+/**
+  Write one allocate or free action to the allocation event ring.
+
+  The oldest event is overwritten once the ring is full.
+
+  @param CallerAddress  Address of caller who call Allocate or Free.
+  @param Action         This Allocate or Free action.
+  @param MemoryType     Memory type.
+  @param Size           Buffer size.
+  @param Buffer         Buffer address.
+
+**/
+STATIC
+VOID
+SmmCoreRecordProfileEvent (
+  IN PHYSICAL_ADDRESS       CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer
+  )
+{
+  MEMORY_PROFILE_EVENT      *Event;
+
+  Event = &mSmramProfileEventRing[mSmramProfileEventNext];
+  Event->Action        = Action;
+  Event->MemoryType    = MemoryType;
+  Event->CallerAddress = CallerAddress;
+  Event->Buffer        = (PHYSICAL_ADDRESS) (UINTN) Buffer;
+  Event->Size          = Size;
+  Event->Timestamp     = GetPerformanceCounter ();
+
+  mSmramProfileEventNext++;
+  if (mSmramProfileEventNext == mSmramProfileEventRingSize) {
+    mSmramProfileEventNext = 0;
+  }
+  mSmramProfileEventCount++;
+}
+
+/**
+  Get the number of events held in the allocation event ring.
+
+  @return The number of valid ring events.
+
+**/
+STATIC
+UINT32
+SmramProfileGetEventCount (
+  VOID
+  )
+{
+  if (mSmramProfileEventCount < mSmramProfileEventRingSize) {
+    return (UINT32) mSmramProfileEventCount;
+  }
+
+  return mSmramProfileEventRingSize;
+}
+// MU_CHANGE [END]
+
 /**
   Initialize SMRAM profile.
 
@@ -672,6 +783,7 @@ SmramProfileInit (
   }
   mSmramProfileDriverPathSize = PcdGetSize (PcdMemoryProfileDriverPath);
   mSmramProfileDriverPath = AllocateCopyPool (mSmramProfileDriverPathSize, PcdGetPtr (PcdMemoryProfileDriverPath));
+  SmramProfileInitEventRing ();   // MU_CHANGE
   mSmramProfileContextPtr = &mSmramProfileContext;
 
   RegisterSmmCore (&mSmramProfileContext);
@@ -1495,6 +1607,13 @@ SmmCoreUpdateProfile (
     return EFI_UNSUPPORTED;
   }
 
+  // MU_CHANGE [BEGIN] - Fixed size allocation event ring
+  if (mSmramProfileEventRing != NULL) {
+    SmmCoreRecordProfileEvent (CallerAddress, Action, MemoryType, Size, Buffer);
+    return EFI_SUCCESS;
+  }
+  // MU_CHANGE [END]
+
   switch (BasicAction) {
     case MemoryProfileActionAllocatePages:
       Status = SmmCoreUpdateProfileAllocate (CallerAddress, Action, MemoryType, Size, Buffer, ActionString);
@@ -1621,6 +1740,12 @@ SmramProfileGetDataSize (
   TotalSize += (sizeof (MEMORY_PROFILE_FREE_MEMORY) + Index * sizeof (MEMORY_PROFILE_DESCRIPTOR));
   TotalSize += (sizeof (MEMORY_PROFILE_MEMORY_RANGE) + mFullSmramRangeCount * sizeof (MEMORY_PROFILE_DESCRIPTOR));
 
+  // MU_CHANGE [BEGIN] - Fixed size allocation event ring
+  if (mSmramProfileEventRing != NULL) {
+    TotalSize += (sizeof (MEMORY_PROFILE_EVENT_RING) + SmramProfileGetEventCount () * sizeof (MEMORY_PROFILE_EVENT));
+  }
+  // MU_CHANGE [END]
+
   return TotalSize;
 }
 
@@ -1666,6 +1791,9 @@ SmramProfileCopyData (
   UINTN                           PdbSize;
   UINTN                           ActionStringSize;
   UINTN                           SmmPoolTypeIndex;
+  MEMORY_PROFILE_EVENT_RING       *EventRing;     // MU_CHANGE
+  UINT32                          EventCount;     // MU_CHANGE
+  UINT32                          EventIndex;     // MU_CHANGE
 
   ContextData = GetSmramProfileContext ();
   if (ContextData == NULL) {
@@ -1860,6 +1988,51 @@ SmramProfileCopyData (
     Offset += sizeof (MEMORY_PROFILE_DESCRIPTOR);
   }
 
+  // MU_CHANGE [BEGIN] - Fixed size allocation event ring
+  if (mSmramProfileEventRing != NULL) {
+    EventCount = SmramProfileGetEventCount ();
+    if (*ProfileOffset < (Offset + sizeof (MEMORY_PROFILE_EVENT_RING))) {
+      if (RemainingSize >= sizeof (MEMORY_PROFILE_EVENT_RING)) {
+        EventRing = ProfileBuffer;
+        EventRing->Header.Signature = MEMORY_PROFILE_EVENT_RING_SIGNATURE;
+        EventRing->Header.Length = sizeof (MEMORY_PROFILE_EVENT_RING);
+        EventRing->Header.Revision = MEMORY_PROFILE_EVENT_RING_REVISION;
+        EventRing->EventCount = EventCount;
+        EventRing->RingSize = mSmramProfileEventRingSize;
+        EventRing->TotalEventCount = mSmramProfileEventCount;
+        EventRing->TimestampFrequency = GetPerformanceCounterProperties (NULL, NULL);
+
+        RemainingSize -= sizeof (MEMORY_PROFILE_EVENT_RING);
+        ProfileBuffer = (UINT8 *) ProfileBuffer + sizeof (MEMORY_PROFILE_EVENT_RING);
+      } else {
+        goto Done;
+      }
+    }
+    Offset += sizeof (MEMORY_PROFILE_EVENT_RING);
+    //
+    // Oldest event first. Once the ring has wrapped, the oldest event is the one written next.
+    //
+    EventIndex = (EventCount == mSmramProfileEventRingSize) ? mSmramProfileEventNext : 0;
+    for (Index = 0; Index < EventCount; Index++) {
+      if (*ProfileOffset < (Offset + sizeof (MEMORY_PROFILE_EVENT))) {
+        if (RemainingSize >= sizeof (MEMORY_PROFILE_EVENT)) {
+          CopyMem (ProfileBuffer, &mSmramProfileEventRing[EventIndex], sizeof (MEMORY_PROFILE_EVENT));
+
+          RemainingSize -= sizeof (MEMORY_PROFILE_EVENT);
+          ProfileBuffer = (UINT8 *) ProfileBuffer + sizeof (MEMORY_PROFILE_EVENT);
+        } else {
+          goto Done;
+        }
+      }
+      Offset += sizeof (MEMORY_PROFILE_EVENT);
+      EventIndex++;
+      if (EventIndex == mSmramProfileEventRingSize) {
+        EventIndex = 0;
+      }
+    }
+  }
+  // MU_CHANGE [END]
+
 Done:
   //
   // On output, actual profile data size copied.
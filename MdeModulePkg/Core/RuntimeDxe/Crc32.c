@@ -16,9 +16,62 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 #include <Library/BaseLib.h>
 
+//
+// Reflected CRC32 polynomial of ITU-T V.42, as used by CalculateCrc32().
+//
+#define CRC32_POLYNOMIAL  0xEDB88320
+
+//
+// Tables for the "slice-by-8" algorithm, which consumes 8 bytes per step
+// instead of 1. mCrc32Table[0] is the classic byte-wise table, entry N of
+// mCrc32Table[K] is the CRC of byte N followed by K zero bytes. They are built
+// at entry rather than stored in the image to keep the driver small.
+//
+UINT32   mCrc32Table[8][256];
+BOOLEAN  mCrc32TableReady = FALSE;
+
+/**
+  Build the tables used by RuntimeDriverCalculateCrc32().
+
+**/
+VOID
+RuntimeDriverInitializeCrc32Table (
+  VOID
+  )
+{
+  UINTN   Index;
+  UINTN   Slice;
+  UINTN   Bit;
+  UINT32  Value;
+
+  for (Index = 0; Index < 256; Index++) {
+    Value = (UINT32) Index;
+    for (Bit = 0; Bit < 8; Bit++) {
+      Value = (Value >> 1) ^ (((Value & 1) != 0) ? CRC32_POLYNOMIAL : 0);
+    }
+
+    mCrc32Table[0][Index] = Value;
+  }
+
+  for (Index = 0; Index < 256; Index++) {
+    Value = mCrc32Table[0][Index];
+    for (Slice = 1; Slice < 8; Slice++) {
+      Value = (Value >> 8) ^ mCrc32Table[0][Value & 0xFF];
+      mCrc32Table[Slice][Index] = Value;
+    }
+  }
+
+  mCrc32TableReady = TRUE;
+}
+
 /**
   Calculate CRC32 for target data.
 
+  The result is the same as the one of CalculateCrc32() of BaseLib, computed
+  8 bytes at a time. Large buffers, e.g. GPT partition entry arrays or
+  firmware volumes, are checked several times faster.
+
+
   @param  Data                  The target data.
   @param  DataSize              The target data size.
   @param  CrcOut                The CRC32 for target data.
@@ -36,10 +89,48 @@ RuntimeDriverCalculateCrc32 (
   OUT UINT32  *CrcOut
   )
 {
+  UINT8   *Ptr;
+  UINT32  Crc;
+  UINT32  One;
+  UINT32  Two;
+
   if (Data == NULL || DataSize == 0 || CrcOut == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  *CrcOut = CalculateCrc32 (Data, DataSize);
+  if (!mCrc32TableReady) {
+    *CrcOut = CalculateCrc32 (Data, DataSize);
+    return EFI_SUCCESS;
+  }
+
+  Ptr = (UINT8 *) Data;
+  Crc = 0xFFFFFFFF;
+
+  //
+  // All the supported CPUs are little endian, so the low byte of the first
+  // UINT32 is the first byte of the slice.
+  //
+  while (DataSize >= 8) {
+    One = ReadUnaligned32 ((UINT32 *) Ptr) ^ Crc;
+    Two = ReadUnaligned32 ((UINT32 *) (Ptr + 4));
+    Crc = mCrc32Table[7][One & 0xFF] ^
+          mCrc32Table[6][(One >> 8) & 0xFF] ^
+          mCrc32Table[5][(One >> 16) & 0xFF] ^
+          mCrc32Table[4][One >> 24] ^
+          mCrc32Table[3][Two & 0xFF] ^
+          mCrc32Table[2][(Two >> 8) & 0xFF] ^
+          mCrc32Table[1][(Two >> 16) & 0xFF] ^
+          mCrc32Table[0][Two >> 24];
+    Ptr      += 8;
+    DataSize -= 8;
+  }
+
+  while (DataSize != 0) {
+    Crc = (Crc >> 8) ^ mCrc32Table[0][(Crc ^ *Ptr) & 0xFF];
+    Ptr++;
+    DataSize--;
+  }
+
+  *CrcOut = Crc ^ 0xFFFFFFFF;
   return EFI_SUCCESS;
 }
@@ -402,6 +402,8 @@ RuntimeDriverInitialize (
   ASSERT_EFI_ERROR (Status);
   mMyImageBase = MyLoadedImage->ImageBase;
 
+  RuntimeDriverInitializeCrc32Table ();
+
   //
   // Fill in the entries of the EFI Boot Services and EFI Runtime Services Tables
   //
@@ -28,6 +28,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Function Prototypes
 //
+/**
+  Build the tables used by RuntimeDriverCalculateCrc32().
+
+**/
+VOID
+RuntimeDriverInitializeCrc32Table (
+  VOID
+  );
+
 /**
   Calculate CRC32 for target data.
 
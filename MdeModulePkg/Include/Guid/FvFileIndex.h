@@ -0,0 +1,47 @@
+/** @file
+  File index of a firmware volume, stored by GenFv in the FV extension header.
+
+  The index is an EFI_FV_EXT_TYPE_GUID_TYPE extension entry whose FormatType
+  is gEdkiiFvFileIndexGuid. It lists the name and the offset of every file
+  of the volume, pad files excepted, sorted by name in CompareMem() order, so
+  that the FV drivers can find a file with a binary search.
+
+  The index describes the volume as built. A consumer must check the file it
+  finds through the index, and search the volume as usual when the file is
+  not in the index, since the volume may have been updated since it was built.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __FV_FILE_INDEX_H__
+#define __FV_FILE_INDEX_H__
+
+#define EDKII_FV_FILE_INDEX_GUID \
+  { \
+    0x9b553911, 0xb8cd, 0x4955, { 0x90, 0x4f, 0x22, 0xf2, 0x85, 0x48, 0xa8, 0xa8 } \
+  }
+
+///
+/// One file of the volume.
+///
+typedef struct {
+  EFI_GUID                         Name;
+  UINT32                           Offset;      ///< Offset of the FFS file header from the FV header.
+  UINT32                           Reserved;
+} EDKII_FV_FILE_INDEX_ENTRY;
+
+///
+/// The extension entry, followed by Count EDKII_FV_FILE_INDEX_ENTRY entries.
+///
+typedef struct {
+  EFI_FIRMWARE_VOLUME_EXT_ENTRY    Hdr;         ///< Hdr.ExtEntryType is EFI_FV_EXT_TYPE_GUID_TYPE.
+  EFI_GUID                         FormatType;  ///< gEdkiiFvFileIndexGuid
+  UINT32                           Count;
+  UINT32                           Reserved;
+} EDKII_FV_FILE_INDEX_EXT_ENTRY;
+
+extern EFI_GUID gEdkiiFvFileIndexGuid;
+
+#endif
@@ -0,0 +1,72 @@
+/** @file
+  Boot cost of the DXE images, published by the DXE core as a configuration
+  table at ReadyToBoot.
+
+  The DXE core accounts the time spent loading each image, in its entry point,
+  in the Supported() and Start() services of its driver binding protocols, and
+  in its event notification functions. The times are inclusive: time spent in
+  a nested call to another image, for example a ConnectController() from an
+  entry point, is accounted to both images.
+
+  The accounting is only done when PcdPerformanceLibraryPropertyMask enables
+  performance measurement. The table is allocated as EfiACPIReclaimMemory, so
+  the OS can read it after ExitBootServices().
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __IMAGE_BOOT_COST_H__
+#define __IMAGE_BOOT_COST_H__
+
+#define EDKII_IMAGE_BOOT_COST_TABLE_GUID \
+  { \
+    0x4ddbfe8b, 0x1ee4, 0x4517, { 0xb1, 0x91, 0x2c, 0x56, 0x6b, 0x23, 0xfa, 0xbf } \
+  }
+
+#define EDKII_IMAGE_BOOT_COST_TABLE_SIGNATURE  SIGNATURE_32 ('I', 'B', 'C', 'T')
+#define EDKII_IMAGE_BOOT_COST_TABLE_REVISION   2
+
+///
+/// Boot cost of one image. The times are in nanoseconds.
+///
+typedef struct {
+  EFI_GUID                FileName;         ///< FFS file name, zero when the image was not loaded from a FV.
+  EFI_PHYSICAL_ADDRESS    ImageBase;
+  UINT64                  ImageSize;
+  UINT64                  TotalTime;        ///< Sum of the times below.
+  UINT64                  EntryPointTime;
+  UINT64                  SupportedTime;
+  UINT64                  StartTime;
+  UINT64                  NotifyTime;
+  UINT32                  SupportedCount;
+  UINT32                  StartCount;
+  UINT32                  NotifyCount;
+  UINT32                  Reserved;
+  //
+  // Phases of the load of the image, added in revision 2.
+  //
+  UINT64                  LocateTime;       ///< Find the device the image is loaded from.
+  UINT64                  ReadTime;         ///< Read the image file.
+  UINT64                  DecompressTime;   ///< Extract the image from compressed or GUIDed sections.
+  UINT64                  AuthenticateTime; ///< Security handlers, that verify and measure the image.
+  UINT64                  LoadTime;         ///< Copy the headers and sections to the image pages.
+  UINT64                  RelocateTime;
+  UINT64                  ProtectTime;      ///< Apply the memory protection of the image.
+} EDKII_IMAGE_BOOT_COST_ENTRY;
+
+///
+/// The table header, followed by EntryCount entries sorted from the highest
+/// TotalTime to the lowest.
+///
+typedef struct {
+  UINT32                  Signature;
+  UINT32                  Revision;
+  UINT32                  Length;           ///< Length of the table, entries included.
+  UINT32                  EntryCount;
+} EDKII_IMAGE_BOOT_COST_TABLE;
+
+extern EFI_GUID gEdkiiImageBootCostTableGuid;
+
+#endif
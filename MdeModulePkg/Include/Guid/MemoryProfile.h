@@ -179,6 +179,39 @@ typedef struct {
   //MEMORY_PROFILE_DESCRIPTOR     MemoryDescriptor[MemoryRangeCount];
 } MEMORY_PROFILE_MEMORY_RANGE;
 
+// MU_CHANGE [BEGIN] - Fixed size allocation event ring
+//
+// The event ring is only reported when PcdMemoryProfileEventRingSize is not 0.
+// It holds the most recent allocate and free events, oldest first.
+// TotalEventCount larger than EventCount means older events were overwritten.
+// Timestamp is the raw performance counter value, see TimestampFrequency.
+//
+#define MEMORY_PROFILE_EVENT_RING_SIGNATURE SIGNATURE_32 ('M','P','E','R')
+#define MEMORY_PROFILE_EVENT_RING_REVISION 0x0001
+
+typedef struct {
+  MEMORY_PROFILE_COMMON_HEADER  Header;
+  UINT32                        EventCount;
+  UINT32                        RingSize;
+  UINT64                        TotalEventCount;
+  UINT64                        TimestampFrequency;
+  //MEMORY_PROFILE_EVENT          Event[EventCount];
+} MEMORY_PROFILE_EVENT_RING;
+
+#define MEMORY_PROFILE_EVENT_SIGNATURE SIGNATURE_32 ('M','P','E','V')
+#define MEMORY_PROFILE_EVENT_REVISION 0x0001
+
+typedef struct {
+  MEMORY_PROFILE_COMMON_HEADER  Header;
+  MEMORY_PROFILE_ACTION         Action;
+  EFI_MEMORY_TYPE               MemoryType;
+  PHYSICAL_ADDRESS              CallerAddress;
+  PHYSICAL_ADDRESS              Buffer;
+  UINT64                        Size;
+  UINT64                        Timestamp;
+} MEMORY_PROFILE_EVENT;
+// MU_CHANGE [END]
+
 //
 // UEFI memory profile layout:
 // +--------------------------------+
@@ -196,6 +229,10 @@ typedef struct {
 // +--------------------------------+
 // | ALLOC_INFO(n, mn)              |
 // +--------------------------------+
+// | EVENT_RING (optional)          |  // MU_CHANGE
+// +--------------------------------+  // MU_CHANGE
+// | EVENT(1 .. EventCount)         |  // MU_CHANGE
+// +--------------------------------+  // MU_CHANGE
 //
 
 typedef struct _EDKII_MEMORY_PROFILE_PROTOCOL EDKII_MEMORY_PROFILE_PROTOCOL;
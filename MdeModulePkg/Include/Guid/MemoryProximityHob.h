@@ -0,0 +1,63 @@
+/** @file
+  Proximity domains of system memory and PCI root bridges, handed from PEI
+  to the DXE core in a GUIDed HOB. The content mirrors the memory affinity
+  entries of the ACPI SRAT and the _PXM of the PCI root bridges.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __MEMORY_PROXIMITY_HOB_H__
+#define __MEMORY_PROXIMITY_HOB_H__
+
+#define EDKII_MEMORY_PROXIMITY_HOB_GUID \
+  { \
+    0x5d2f7a31, 0xc86e, 0x4b09, { 0x93, 0x1d, 0x7e, 0x4a, 0x6c, 0x0b, 0xe2, 0x58 } \
+  }
+
+#define EDKII_MEMORY_PROXIMITY_HOB_REVISION  1
+
+///
+/// One range of system memory and the proximity domain it belongs to.
+///
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    BaseAddress;
+  UINT64                  Length;
+  UINT32                  ProximityDomain;
+  UINT32                  Reserved;
+} EDKII_MEMORY_PROXIMITY_RANGE;
+
+///
+/// The proximity domain of the PCI devices on a range of buses of a segment.
+///
+typedef struct {
+  UINT32                  Segment;
+  UINT16                  BusBase;
+  UINT16                  BusLimit;
+  UINT32                  ProximityDomain;
+  UINT32                  Reserved;
+} EDKII_PCI_ROOT_BRIDGE_PROXIMITY;
+
+///
+/// The HOB data is this header, followed by MemoryRangeCount
+/// EDKII_MEMORY_PROXIMITY_RANGE entries and then RootBridgeCount
+/// EDKII_PCI_ROOT_BRIDGE_PROXIMITY entries.
+///
+typedef struct {
+  UINT32                  Revision;
+  UINT32                  MemoryRangeCount;
+  UINT32                  RootBridgeCount;
+  UINT32                  Reserved;
+} EDKII_MEMORY_PROXIMITY_HOB;
+
+#define EDKII_MEMORY_PROXIMITY_HOB_RANGES(Hob) \
+  ((EDKII_MEMORY_PROXIMITY_RANGE *)((EDKII_MEMORY_PROXIMITY_HOB *)(Hob) + 1))
+
+#define EDKII_MEMORY_PROXIMITY_HOB_ROOT_BRIDGES(Hob) \
+  ((EDKII_PCI_ROOT_BRIDGE_PROXIMITY *)(EDKII_MEMORY_PROXIMITY_HOB_RANGES (Hob) + \
+                                       ((EDKII_MEMORY_PROXIMITY_HOB *)(Hob))->MemoryRangeCount))
+
+extern EFI_GUID gEdkiiMemoryProximityHobGuid;
+
+#endif
@@ -0,0 +1,48 @@
+/** @file
+  Temporary RAM usage and evacuation statistics of the PEI core, handed to
+  later phases in a GUIDed HOB.
+
+  The PEI core builds the HOB when it switches from temporary RAM to
+  permanent memory. The times of the switch and of the evacuation of the FVs
+  are in the performance records, with the "TempRamMigration" and
+  "EvacuateTempRam" tokens.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __PEI_TEMP_RAM_USAGE_H__
+#define __PEI_TEMP_RAM_USAGE_H__
+
+#define EDKII_PEI_TEMP_RAM_USAGE_HOB_GUID \
+  { \
+    0x3d3d9635, 0x2b41, 0x4f68, { 0x9c, 0x7c, 0xd2, 0x56, 0x30, 0xaa, 0xfe, 0xb9 } \
+  }
+
+#define EDKII_PEI_TEMP_RAM_USAGE_REVISION  2
+
+typedef struct {
+  UINT32    Revision;
+  UINT32    Reserved;
+  UINT64    TemporaryRamSize;
+  UINT64    StackSize;
+  UINT64    StackUsed;          ///< High-water mark of the temporary stack
+  UINT64    HeapSize;
+  UINT64    HeapUsed;           ///< HOB list and pages allocated in the temporary heap
+  UINT64    MigratedBytes;      ///< Bytes copied from temporary RAM at the stack switch
+  UINT64    MigratedFvBytes;    ///< Bytes of the FVs copied out of temporary RAM
+  UINT32    MigratedFvCount;
+  UINT32    MigratedPeimCount;  ///< PEIMs rebased in the migrated FVs
+  UINT32    SkippedPeimCount;   ///< PEIMs left as they are, see PcdMigrateNeededPeimsOnly
+  UINT32    Reserved2;
+  //
+  // Revision 2
+  //
+  UINT64    MigratedPeimBytes;  ///< Bytes of the PEIMs rebased in the migrated FVs
+  UINT64    SkippedPeimBytes;   ///< Bytes of the PEIMs left as they are, not rebased
+} EDKII_PEI_TEMP_RAM_USAGE;
+
+extern EFI_GUID gEdkiiPeiTempRamUsageHobGuid;
+
+#endif
@@ -42,7 +42,7 @@ typedef struct {
 } SMM_CORE_IMAGE_DATABASE_STRUCTURE;
 
 #define SMM_CORE_SMI_DATABASE_SIGNATURE SIGNATURE_32 ('S','C','S','D')
-#define SMM_CORE_SMI_DATABASE_REVISION  0x0001
+#define SMM_CORE_SMI_DATABASE_REVISION  0x0002  // MU_CHANGE - Add handler statistics
 
 typedef enum {
   SmmCoreSmiHandlerCategoryRootHandler,
@@ -85,6 +85,16 @@ typedef struct {
   UINT16                ContextBufferOffset;
   UINT8                 Reserved[2];
   UINT32                ContextBufferSize;
+  // MU_CHANGE [BEGIN] - Add handler statistics
+  //
+  // Number of times SmiManage() called the handler, and the total and the
+  // longest time the handler took, in nanoseconds. They are only recorded
+  // for root and GUID handlers, and only since SMM_CORE_SMI_DATABASE_REVISION 2.
+  //
+  UINT64                HitCount;
+  UINT64                TotalTime;
+  UINT64                MaxTime;
+  // MU_CHANGE [END]
 //UINT8                 ContextBuffer[];
 } SMM_CORE_SMI_HANDLER_STRUCTURE;
 
@@ -112,6 +122,7 @@ typedef struct {
 //
 #define SMI_HANDLER_PROFILE_COMMAND_GET_INFO           0x1
 #define SMI_HANDLER_PROFILE_COMMAND_GET_DATA_BY_OFFSET 0x2
+#define SMI_HANDLER_PROFILE_COMMAND_GET_SMI_HISTORY    0x3  // MU_CHANGE - Add SMI history
 
 typedef struct {
   UINT32                            Command;
@@ -139,6 +150,59 @@ typedef struct {
   UINT64                                  DataOffset;
 } SMI_HANDLER_PROFILE_PARAMETER_GET_DATA_BY_OFFSET;
 
+// MU_CHANGE [BEGIN] - Add SMI history
+#define SMI_HANDLER_PROFILE_SMI_RECORD_COUNT      64
+#define SMI_HANDLER_PROFILE_LATENCY_BUCKET_COUNT  16
+
+//
+// One SMI, timed from the entry to the exit of the SMM Core, after the
+// processors have rendezvoused.
+//
+typedef struct {
+  //
+  // Time of the SMM Core entry, in nanoseconds since the SMI handler profile
+  // started.
+  //
+  UINT64                EntryTime;
+  //
+  // Time spent in the SMM Core, in nanoseconds.
+  //
+  UINT64                Duration;
+  //
+  // The first handler that handled the SMI, and the handler type it is
+  // registered for. Handler is 0 if no handler claimed the SMI, HandlerType
+  // is zero for root SMI handlers.
+  //
+  EFI_GUID              HandlerType;
+  PHYSICAL_ADDRESS      Handler;
+} SMI_HANDLER_PROFILE_SMI_RECORD;
+
+typedef struct {
+  SMI_HANDLER_PROFILE_PARAMETER_HEADER    Header;
+  //
+  // Number of SMIs since the SMI handler profile started.
+  //
+  UINT64                                  SmiCount;
+  //
+  // Highest number of SMIs seen within one second of the first SMI of a
+  // window, to detect SMI storms.
+  //
+  UINT64                                  MaxSmiPerSecond;
+  //
+  // Bucket 0 counts the SMIs shorter than 1 microsecond, bucket N the ones
+  // taking from 2^(N-1) up to 2^N microseconds. The last bucket counts all
+  // the longer ones.
+  //
+  UINT64                                  LatencyHistogram[SMI_HANDLER_PROFILE_LATENCY_BUCKET_COUNT];
+  //
+  // The last RecordCount SMIs, oldest first.
+  //
+  UINT32                                  RecordCount;
+  UINT8                                   Reserved[4];
+  SMI_HANDLER_PROFILE_SMI_RECORD          Records[SMI_HANDLER_PROFILE_SMI_RECORD_COUNT];
+} SMI_HANDLER_PROFILE_PARAMETER_GET_SMI_HISTORY;
+// MU_CHANGE [END]
+
 #define SMI_HANDLER_PROFILE_GUID {0x49174342, 0x7108, 0x409b, {0x8b, 0xbe, 0x65, 0xfd, 0xa8, 0x53, 0x89, 0xf5}}
 
 extern EFI_GUID gSmiHandlerProfileGuid;
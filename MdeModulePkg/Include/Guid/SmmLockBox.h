@@ -22,6 +22,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define EFI_SMM_LOCK_BOX_COMMAND_RESTORE              0x3
 #define EFI_SMM_LOCK_BOX_COMMAND_SET_ATTRIBUTES       0x4
 #define EFI_SMM_LOCK_BOX_COMMAND_RESTORE_ALL_IN_PLACE 0x5
+#define EFI_SMM_LOCK_BOX_COMMAND_RESTORE_MULTIPLE     0x6 // MU_CHANGE - Restore several LockBoxes at once
 
 typedef struct {
   UINT32                         Command;
@@ -61,6 +62,21 @@ typedef struct {
   EFI_SMM_LOCK_BOX_PARAMETER_HEADER  Header;
 } EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_ALL_IN_PLACE;
 
+// MU_CHANGE [BEGIN] - Restore several LockBoxes at once
+typedef struct {
+  GUID                               Guid;
+  PHYSICAL_ADDRESS                   Buffer;
+  UINT64                             Length;
+  UINT64                             ReturnStatus;
+} EFI_SMM_LOCK_BOX_RESTORE_ENTRY;
+
+typedef struct {
+  EFI_SMM_LOCK_BOX_PARAMETER_HEADER  Header;
+  UINT64                             Count;
+//EFI_SMM_LOCK_BOX_RESTORE_ENTRY     Entry[Count];
+} EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE;
+// MU_CHANGE [END]
+
 extern EFI_GUID gEfiSmmLockBoxCommunicationGuid;
 
 #endif
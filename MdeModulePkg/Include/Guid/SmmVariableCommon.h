@@ -81,6 +81,16 @@ typedef struct {
 // It is a notify event, no extra payload for this function.             MU_CHANGE
 //                                                                       MU_CHANGE
 #define SMM_VARIABLE_FUNCTION_ADDRESS_CHANGE_EVENT    15            //   MU_CHANGE
+// MU_CHANGE [BEGIN]
+//
+// The payload for this function is SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH.
+//
+#define SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH      16
+//
+// The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS.
+//
+#define SMM_VARIABLE_FUNCTION_GET_QUERY_VARIABLE_INFO_LIMITS  17
+// MU_CHANGE [END]
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -103,6 +113,31 @@ typedef struct {
   CHAR16      Name[1];
 } SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE;
 
+// MU_CHANGE [BEGIN]
+///
+/// One SetVariable() request in SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH.
+/// Each entry starts on a UINTN boundary, so its size is
+/// ALIGN_VALUE (SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE + NameSize + DataSize, sizeof (UINTN)).
+/// Status returns the result of the request.
+///
+typedef struct {
+  EFI_STATUS                                  Status;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE    Variable;
+} SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY;
+
+#define SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE \
+  (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY, Variable) + \
+   OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name))
+
+///
+/// This structure is used to communicate with SMI handler by the batched SetVariable().
+/// EntryCount SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY structures follow it.
+///
+typedef struct {
+  UINTN       EntryCount;
+} SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH;
+// MU_CHANGE [END]
+
 ///
 /// This structure is used to communicate with SMI handler by GetNextVariableName.
 ///
@@ -151,4 +186,22 @@ typedef struct {
   BOOLEAN                 AuthenticatedVariableUsage;
 } SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO;
 
+// MU_CHANGE [BEGIN]
+///
+/// This structure is used to get the fixed runtime limits used by QueryVariableInfo,
+/// so the runtime variable cache can answer QueryVariableInfo without a SMI.
+/// The sizes are returned as they are kept in SMM and still include the variable header.
+///
+typedef struct {
+  UINT64                  CommonRuntimeVariableSpace;
+  UINT64                  HwErrStorageSize;
+  UINT64                  VolatileStorageSize;
+  UINT64                  MaxVariableSize;
+  UINT64                  MaxAuthVariableSize;
+  UINT64                  MaxVolatileVariableSize;
+  UINT64                  MaxHardwareErrorVariableSize;
+  BOOLEAN                 AuthSupport;
+} SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS;
+// MU_CHANGE [END]
+
 #endif // _SMM_VARIABLE_COMMON_H_
@@ -0,0 +1,31 @@
+/** @file
+  Memory copy of the non-volatile variable storage, built by the variable PEIM
+  once permanent memory is installed and handed to the DXE/SMM variable driver
+  in a GUIDed HOB.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_STORE_CACHE_HOB_H__
+#define __VARIABLE_STORE_CACHE_HOB_H__
+
+#define EDKII_VARIABLE_STORE_CACHE_HOB_GUID \
+  { \
+    0x89e1cfd9, 0x2606, 0x4d8e, { 0xa7, 0xc7, 0x1a, 0x1c, 0x4a, 0x2e, 0xcc, 0x42 } \
+  }
+
+///
+/// CacheBase holds NvStorageSize bytes starting at NvStorageBase, with any data
+/// that the last fault tolerant write left in the spare block already merged in.
+///
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    NvStorageBase;  // Flash address of the NV storage FV
+  UINT32                  NvStorageSize;  // Size of the NV storage FV
+  EFI_PHYSICAL_ADDRESS    CacheBase;      // Address of the memory copy
+} EDKII_VARIABLE_STORE_CACHE;
+
+extern EFI_GUID gEdkiiVariableStoreCacheHobGuid;
+
+#endif
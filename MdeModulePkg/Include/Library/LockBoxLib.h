@@ -134,4 +134,51 @@ RestoreAllLockBoxInPlace (
   VOID
   );
 
+// MU_CHANGE [BEGIN] - Restore several LockBoxes at once.
+///
+/// A LockBox to restore with RestoreMultipleLockBox().
+///
+typedef struct {
+  ///
+  /// The guid to identify the confidential information.
+  ///
+  GUID            *Guid;
+  ///
+  /// The address of the restored confidential information.
+  /// NULL means restored to original address.
+  ///
+  VOID            *Buffer;
+  ///
+  /// On input, the length of Buffer. On output, the length of the confidential
+  /// information. Ignored if Buffer is NULL.
+  ///
+  UINTN           Length;
+  ///
+  /// On output, the status of the restore of this LockBox, as returned by
+  /// RestoreLockBox().
+  ///
+  RETURN_STATUS   Status;
+} LOCK_BOX_RESTORE_ENTRY;
+
+/**
+  This function will restore confidential information from several lockboxes.
+
+  Each entry is restored as RestoreLockBox() would do. The implementation may
+  restore all of them at once, e.g. with a single SMM communication.
+
+  @param Entries  the lockboxes to restore, the status of each one is returned in its entry
+  @param Count    the number of entries
+
+  @retval RETURN_SUCCESS            all the lockboxes are restored successfully.
+  @retval RETURN_INVALID_PARAMETER  Entries is NULL and Count is not 0, or the Guid of an entry is NULL.
+  @return others                    the status of the first entry that failed to restore.
+**/
+RETURN_STATUS
+EFIAPI
+RestoreMultipleLockBox (
+  IN OUT LOCK_BOX_RESTORE_ENTRY   *Entries,
+  IN     UINTN                    Count
+  );
+// MU_CHANGE [END]
+
 #endif
@@ -559,6 +559,19 @@ EfiBootManagerConnectAll (
   VOID
   );
 
+/**
+  This function will connect the platform default console and the devices
+  of the active boot options in BootOrder only. It can be used instead of
+  EfiBootManagerConnectAll() when the platform doesn't need the other
+  devices before booting; those can still be connected on demand later.
+  Boot options with short-form device paths are connected when booted.
+**/
+VOID
+EFIAPI
+EfiBootManagerConnectBootOrder (
+  VOID
+  );
+
 /**
   This function will create all handles associate with every device
   path node. If the handle associate with one device path node can not
@@ -0,0 +1,75 @@
+/** @file -- CpuMemoryAttributeBatch.h
+
+  CPU Memory Attribute Batch Protocol lets a caller change the paging
+  attributes of a list of memory ranges with one request to the CPU driver.
+  The driver opens the page table for write once, preallocates page table
+  memory for the whole list and flushes the TLB once at the end.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CPU_MEMORY_ATTRIBUTE_BATCH_H__
+#define __CPU_MEMORY_ATTRIBUTE_BATCH_H__
+
+#define EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL_GUID \
+  { \
+    0x6e3c3ecf, 0xb4ff, 0x4d88, { 0x9e, 0xaf, 0x2c, 0x3d, 0x30, 0x21, 0xaa, 0x83 } \
+  }
+
+#define EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL_REVISION  0x0000000000010000
+
+typedef struct _EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL;
+
+///
+/// One range in a batch. BaseAddress, Length and Attributes match the
+/// parameters of EFI_CPU_ARCH_PROTOCOL.SetMemoryAttributes(), and Status
+/// returns the result for this range.
+///
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    BaseAddress;
+  UINT64                  Length;
+  UINT64                  Attributes;
+  EFI_STATUS              Status;
+} EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY;
+
+/**
+  Set the paging attributes of a list of memory ranges.
+
+  The entries are applied in order, and each one assigns its Attributes the
+  same way EFI_CPU_ARCH_PROTOCOL.SetMemoryAttributes() does for the bits in
+  EFI_MEMORY_ATTRIBUTE_MASK. Entries with cache attributes fail with
+  EFI_UNSUPPORTED, since those go through the MTRRs and must be synchronized
+  with every processor.
+  A failing entry does not stop the entries after it.
+
+  The new attributes are only guaranteed to be in effect once this function
+  returns. The caller must not depend on the attributes of one entry while a
+  later entry of the same list is applied.
+
+  @param[in]      This          The EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    Number of entries in Entries.
+  @param[in, out] Entries       The ranges. On return, the Status field of each
+                                entry holds its result.
+
+  @retval EFI_SUCCESS           Every entry was applied successfully.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+  @retval Others                The Status of the first entry that failed.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_SET_ATTRIBUTES) (
+  IN CONST EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *This,
+  IN       UINTN                                      EntryCount,
+  IN OUT   EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY     *Entries
+  );
+
+struct _EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL {
+  UINT64                                            Revision;
+  EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_SET_ATTRIBUTES   SetMemoryAttributes;
+};
+
+extern EFI_GUID gEdkiiCpuMemoryAttributeBatchProtocolGuid;
+
+#endif
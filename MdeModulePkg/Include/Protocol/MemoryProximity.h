@@ -0,0 +1,87 @@
+/** @file -- MemoryProximity.h
+
+  Memory Proximity Protocol lets a driver ask the DXE core to prefer memory of
+  one proximity domain for the pages it allocates next, typically DMA buffers
+  of a device attached to that domain. It is produced by the DXE core when the
+  platform describes the proximity domains in a memory proximity HOB.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __MEMORY_PROXIMITY_H__
+#define __MEMORY_PROXIMITY_H__
+
+#define EDKII_MEMORY_PROXIMITY_PROTOCOL_GUID \
+  { \
+    0xa2c6e04b, 0x1f93, 0x47d5, { 0xb8, 0x2e, 0x64, 0x0d, 0x9f, 0x17, 0xc3, 0x7a } \
+  }
+
+#define EDKII_MEMORY_PROXIMITY_PROTOCOL_REVISION  0x0000000000010000
+
+///
+/// No proximity domain. Allocations use the default policy.
+///
+#define EDKII_MEMORY_PROXIMITY_DOMAIN_NONE  MAX_UINT32
+
+typedef struct _EDKII_MEMORY_PROXIMITY_PROTOCOL  EDKII_MEMORY_PROXIMITY_PROTOCOL;
+
+/**
+  Set the proximity domain that page allocations should prefer.
+
+  The hint applies to AllocateAnyPages and AllocateMaxAddress requests for
+  memory types that are not kept in fixed bins, such as EfiBootServicesData.
+  When no free memory of the domain satisfies a request, the default policy
+  is used, so the hint never makes an allocation fail.
+
+  The hint stays in effect until it is set again. A caller should put back
+  the previous hint when it is done.
+
+  @param[in]  This                The EDKII_MEMORY_PROXIMITY_PROTOCOL instance.
+  @param[in]  ProximityDomain     The proximity domain to prefer, or
+                                  EDKII_MEMORY_PROXIMITY_DOMAIN_NONE.
+  @param[out] PreviousDomain      The hint before this call. May be NULL.
+
+  @retval EFI_SUCCESS             The hint has been set.
+  @retval EFI_NOT_FOUND           No memory belongs to ProximityDomain. The
+                                  hint has not been changed.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MEMORY_PROXIMITY_SET_ALLOCATION_HINT) (
+  IN  CONST EDKII_MEMORY_PROXIMITY_PROTOCOL  *This,
+  IN        UINT32                           ProximityDomain,
+  OUT       UINT32                           *PreviousDomain OPTIONAL
+  );
+
+/**
+  Get the proximity domain of a PCI bus.
+
+  @param[in]  This                The EDKII_MEMORY_PROXIMITY_PROTOCOL instance.
+  @param[in]  Segment             The PCI segment number.
+  @param[in]  Bus                 The PCI bus number.
+  @param[out] ProximityDomain     The proximity domain of the bus.
+
+  @retval EFI_SUCCESS             ProximityDomain has been returned.
+  @retval EFI_INVALID_PARAMETER   ProximityDomain is NULL.
+  @retval EFI_NOT_FOUND           The platform did not describe this bus.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MEMORY_PROXIMITY_GET_PCI_DOMAIN) (
+  IN  CONST EDKII_MEMORY_PROXIMITY_PROTOCOL  *This,
+  IN        UINT32                           Segment,
+  IN        UINT8                            Bus,
+  OUT       UINT32                           *ProximityDomain
+  );
+
+struct _EDKII_MEMORY_PROXIMITY_PROTOCOL {
+  UINT64                                        Revision;
+  EDKII_MEMORY_PROXIMITY_SET_ALLOCATION_HINT    SetAllocationHint;
+  EDKII_MEMORY_PROXIMITY_GET_PCI_DOMAIN         GetPciProximityDomain;
+};
+
+extern EFI_GUID gEdkiiMemoryProximityProtocolGuid;
+
+#endif
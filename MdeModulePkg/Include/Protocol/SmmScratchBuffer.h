@@ -0,0 +1,55 @@
+/** @file -- SmmScratchBuffer.h
+
+  SMM Scratch Buffer Protocol lets an SMI handler get temporary buffers that
+  do not need to be freed. The PiSmmCore releases every scratch buffer that
+  an SMI handler allocated when that handler returns to SmiManage().
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __SMM_SCRATCH_BUFFER_H__
+#define __SMM_SCRATCH_BUFFER_H__
+
+#define EDKII_SMM_SCRATCH_BUFFER_PROTOCOL_GUID \
+  { \
+    0x3c0b5e7d, 0x92a4, 0x4c1f, { 0x8e, 0x61, 0xd4, 0x27, 0x5b, 0x9a, 0x0f, 0x3e } \
+  }
+
+#define EDKII_SMM_SCRATCH_BUFFER_PROTOCOL_REVISION  0x0000000000010000
+
+typedef struct _EDKII_SMM_SCRATCH_BUFFER_PROTOCOL  EDKII_SMM_SCRATCH_BUFFER_PROTOCOL;
+
+/**
+  Allocate a scratch buffer for the SMI handler that is running.
+
+  The buffer is 8-byte aligned and stays valid until the SMI handler that
+  called this function returns. It must not be passed to SmmFreePool() and
+  must not be used after the handler returns.
+
+  @param[in]  This          The EDKII_SMM_SCRATCH_BUFFER_PROTOCOL instance.
+  @param[in]  Size          The size of the buffer in bytes.
+  @param[out] Buffer        On return, the allocated buffer.
+
+  @retval EFI_SUCCESS           The buffer was allocated.
+  @retval EFI_INVALID_PARAMETER Size is 0, or Buffer is NULL.
+  @retval EFI_NOT_READY         No SMI handler is running.
+  @retval EFI_OUT_OF_RESOURCES  The buffer cannot be allocated.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SMM_SCRATCH_BUFFER_ALLOCATE) (
+  IN  CONST EDKII_SMM_SCRATCH_BUFFER_PROTOCOL  *This,
+  IN        UINTN                              Size,
+  OUT       VOID                               **Buffer
+  );
+
+struct _EDKII_SMM_SCRATCH_BUFFER_PROTOCOL {
+  UINT64                              Revision;
+  EDKII_SMM_SCRATCH_BUFFER_ALLOCATE   AllocateScratchBuffer;
+};
+
+extern EFI_GUID gEdkiiSmmScratchBufferProtocolGuid;
+
+#endif
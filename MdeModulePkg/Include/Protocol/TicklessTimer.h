@@ -0,0 +1,71 @@
+/** @file -- TicklessTimer.h
+
+  Tickless Timer Protocol lets the DXE Core tell the timer driver when the
+  next timer event is due. A timer driver that produces this protocol only
+  interrupts the processor when an event is due, instead of at every period
+  of EFI_TIMER_ARCH_PROTOCOL, so that idle firmware is not woken needlessly
+  and short timers do not wait for the next periodic tick.
+
+  The timer driver keeps passing the elapsed time to the handler registered
+  with EFI_TIMER_ARCH_PROTOCOL.RegisterHandler(). The interval between two
+  calls may be longer than the timer period while nothing is due.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __TICKLESS_TIMER_H__
+#define __TICKLESS_TIMER_H__
+
+#define EDKII_TICKLESS_TIMER_PROTOCOL_GUID \
+  { \
+    0x968255bc, 0x83fa, 0x402f, { 0xb3, 0x37, 0x8b, 0x26, 0x71, 0x93, 0x67, 0x7f } \
+  }
+
+#define EDKII_TICKLESS_TIMER_PROTOCOL_REVISION  0x0000000000010000
+
+///
+/// Value of TimeToNextEvent when no timer event is pending.
+///
+#define EDKII_TICKLESS_TIMER_NO_EVENT  MAX_UINT64
+
+typedef struct _EDKII_TICKLESS_TIMER_PROTOCOL  EDKII_TICKLESS_TIMER_PROTOCOL;
+
+/**
+  Program the timer interrupt for the next due timer event.
+
+  TimeToNextEvent is relative to the time last passed to the handler
+  registered with EFI_TIMER_ARCH_PROTOCOL.RegisterHandler(). The timer driver
+  calls that handler no later than TimeToNextEvent after that time, rounded
+  up to the resolution of the timer hardware. If the time has already passed,
+  the handler is called as soon as possible.
+
+  While no event is pending, the timer driver may wait up to a platform
+  defined maximum idle period between two calls of the handler.
+
+  This function may be called at any TPL up to and including TPL_HIGH_LEVEL - 1.
+
+  @param[in]  This              The EDKII_TICKLESS_TIMER_PROTOCOL instance.
+  @param[in]  TimeToNextEvent   The time until the next timer event is due in
+                                100 ns units, or EDKII_TICKLESS_TIMER_NO_EVENT.
+
+  @retval EFI_SUCCESS           The timer interrupt was programmed.
+  @retval EFI_NOT_READY         The timer interrupt is disabled. The request
+                                is recorded and applies when it is enabled.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TICKLESS_TIMER_SET_NEXT_EVENT) (
+  IN EDKII_TICKLESS_TIMER_PROTOCOL  *This,
+  IN UINT64                         TimeToNextEvent
+  );
+
+struct _EDKII_TICKLESS_TIMER_PROTOCOL {
+  UINT64                                Revision;
+  EDKII_TICKLESS_TIMER_SET_NEXT_EVENT   SetNextEvent;
+};
+
+extern EFI_GUID gEdkiiTicklessTimerProtocolGuid;
+
+#endif
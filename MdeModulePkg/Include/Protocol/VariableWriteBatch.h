@@ -0,0 +1,68 @@
+/** @file -- VariableWriteBatch.h
+
+  Variable Write Batch Protocol lets a boot-time caller set several variables
+  with one request to the variable service. The SMM variable wrapper driver
+  packs the requests into as few SMM communicate calls as possible.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_WRITE_BATCH_H__
+#define __VARIABLE_WRITE_BATCH_H__
+
+#define EDKII_VARIABLE_WRITE_BATCH_PROTOCOL_GUID \
+  { \
+    0x66b4bb1c, 0x8391, 0x42f0, { 0xab, 0xa4, 0x6f, 0x85, 0xe8, 0x6c, 0xf8, 0xd6 } \
+  }
+
+#define EDKII_VARIABLE_WRITE_BATCH_PROTOCOL_REVISION  0x0000000000010000
+
+typedef struct _EDKII_VARIABLE_WRITE_BATCH_PROTOCOL  EDKII_VARIABLE_WRITE_BATCH_PROTOCOL;
+
+///
+/// One SetVariable() request in a batch. The fields match the parameters of
+/// SetVariable(), and Status returns the result of this request.
+///
+typedef struct {
+  CHAR16        *VariableName;
+  EFI_GUID      *VendorGuid;
+  UINT32        Attributes;
+  UINTN         DataSize;
+  VOID          *Data;
+  EFI_STATUS    Status;
+} EDKII_VARIABLE_WRITE_BATCH_ENTRY;
+
+/**
+  Set a list of variables.
+
+  The entries are applied in order, and each one behaves exactly like a
+  separate call to SetVariable() with the same parameters. A failing entry
+  does not stop the entries after it.
+
+  @param[in]      This          The EDKII_VARIABLE_WRITE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    Number of entries in Entries.
+  @param[in, out] Entries       The requests. On return, the Status field of
+                                each entry holds its SetVariable() result.
+
+  @retval EFI_SUCCESS           Every entry was set successfully.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+  @retval Others                The Status of the first entry that failed.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_VARIABLE_WRITE_BATCH_SET_VARIABLES) (
+  IN CONST EDKII_VARIABLE_WRITE_BATCH_PROTOCOL  *This,
+  IN       UINTN                                EntryCount,
+  IN OUT   EDKII_VARIABLE_WRITE_BATCH_ENTRY     *Entries
+  );
+
+struct _EDKII_VARIABLE_WRITE_BATCH_PROTOCOL {
+  UINT64                                      Revision;
+  EDKII_VARIABLE_WRITE_BATCH_SET_VARIABLES    SetVariables;
+};
+
+extern EFI_GUID gEdkiiVariableWriteBatchProtocolGuid;
+
+#endif
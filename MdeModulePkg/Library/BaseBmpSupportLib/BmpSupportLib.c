@@ -92,11 +92,11 @@ TranslateBmpToGopBlt (
   BMP_COLOR_MAP                  *BmpColorMap;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Palette[256];
   UINT32                         BltBufferSize;
   UINTN                          Index;
   UINTN                          Height;
   UINTN                          Width;
-  UINTN                          ImageIndex;
   UINT32                         DataSizePerLine;
   BOOLEAN                        IsAllocated;
   UINT32                         ColorMapNum;
@@ -229,6 +229,7 @@ TranslateBmpToGopBlt (
   //
   Image = BmpImage;
   BmpColorMap = (BMP_COLOR_MAP *)(Image + sizeof (BMP_IMAGE_HEADER));
+  ColorMapNum = 0;
   if (BmpHeader->ImageOffset < sizeof (BMP_IMAGE_HEADER)) {
     return RETURN_UNSUPPORTED;
   }
@@ -331,98 +332,95 @@ TranslateBmpToGopBlt (
   DEBUG ((DEBUG_INFO, "BmpHeader->HeaderSize 0x%X\n", BmpHeader->HeaderSize));
   DEBUG ((DEBUG_INFO, "BmpHeader->Size 0x%X\n", BmpHeader->Size));
 
+  // MU_CHANGE [BEGIN] - Translate BMP rows with a per-row pixel format dispatch
   //
-  // Translate image from BMP to Blt buffer format
+  // Expand the color map into GOP pixels once, so palette images cost one
+  // table lookup per pixel. Entries the image does not provide stay black.
+  //
+  ZeroMem (Palette, sizeof (Palette));
+  for (Index = 0; Index < ColorMapNum; Index++) {
+    Palette[Index].Blue  = BmpColorMap[Index].Blue;
+    Palette[Index].Green = BmpColorMap[Index].Green;
+    Palette[Index].Red   = BmpColorMap[Index].Red;
+  }
+
+  //
+  // Translate image from BMP to Blt buffer format. The pixel format is
+  // resolved once per row rather than once per pixel, and rows are located
+  // by their 32-bit aligned stride.
   //
   BltBuffer = *GopBlt;
   for (Height = 0; Height < BmpHeader->PixelHeight; Height++) {
-    Blt = &BltBuffer[ (BmpHeader->PixelHeight - Height - 1) * BmpHeader->PixelWidth];
-    for (Width = 0; Width < BmpHeader->PixelWidth; Width++, Image++, Blt++) {
-      switch (BmpHeader->BitPerPixel) {
-      case 1:
-        //
-        // Translate 1-bit (2 colors) BMP to 24-bit color
-        //
-        for (Index = 0; Index < 8 && Width < BmpHeader->PixelWidth; Index++) {
-          Blt->Red   = BmpColorMap[ ((*Image) >> (7 - Index)) & 0x1].Red;
-          Blt->Green = BmpColorMap[ ((*Image) >> (7 - Index)) & 0x1].Green;
-          Blt->Blue  = BmpColorMap[ ((*Image) >> (7 - Index)) & 0x1].Blue;
-          Blt++;
-          Width++;
-        }
-
-        Blt--;
-        Width--;
-        break;
-
-      case 4:
-        //
-        // Translate 4-bit (16 colors) BMP Palette to 24-bit color
-        //
-        Index = (*Image) >> 4;
-        Blt->Red   = BmpColorMap[Index].Red;
-        Blt->Green = BmpColorMap[Index].Green;
-        Blt->Blue  = BmpColorMap[Index].Blue;
-        if (Width < (BmpHeader->PixelWidth - 1)) {
-          Blt++;
-          Width++;
-          Index = (*Image) & 0x0f;
-          Blt->Red   = BmpColorMap[Index].Red;
-          Blt->Green = BmpColorMap[Index].Green;
-          Blt->Blue  = BmpColorMap[Index].Blue;
-        }
-        break;
-
-      case 8:
-        //
-        // Translate 8-bit (256 colors) BMP Palette to 24-bit color
-        //
-        Blt->Red   = BmpColorMap[*Image].Red;
-        Blt->Green = BmpColorMap[*Image].Green;
-        Blt->Blue  = BmpColorMap[*Image].Blue;
-        break;
-
-      case 24:
-        //
-        // It is 24-bit BMP.
-        //
-        Blt->Blue  = *Image++;
-        Blt->Green = *Image++;
-        Blt->Red   = *Image;
-        break;
-
-      case 32:
-        //
-        //Conver 32 bit to 24bit bmp - just ignore the final byte of each pixel
-        Blt->Blue  = *Image++;
-        Blt->Green = *Image++;
-        Blt->Red   = *Image++;
-        break;
-
-      default:
-        //
-        // Other bit format BMP is not supported.
-        //
-        if (IsAllocated) {
-          FreePool (*GopBlt);
-          *GopBlt = NULL;
-        }
-        DEBUG ((DEBUG_ERROR, "Bmp Bit format not supported.  0x%X\n", BmpHeader->BitPerPixel));
-        return RETURN_UNSUPPORTED;
-        break;
-      };
+    Image = ImageHeader + Height * (UINTN)DataSizePerLine;
+    Blt   = &BltBuffer[(BmpHeader->PixelHeight - Height - 1) * (UINTN)BmpHeader->PixelWidth];
+    switch (BmpHeader->BitPerPixel) {
+    case 1:
+      //
+      // Translate 1-bit (2 colors) BMP to 24-bit color
+      //
+      for (Width = 0; Width < BmpHeader->PixelWidth; Width++) {
+        Blt[Width] = Palette[(Image[Width >> 3] >> (7 - (Width & 0x7))) & 0x1];
+      }
+      break;
 
-    }
+    case 4:
+      //
+      // Translate 4-bit (16 colors) BMP Palette to 24-bit color
+      //
+      for (Width = 0; Width < BmpHeader->PixelWidth; Width++) {
+        Blt[Width] = Palette[(Image[Width >> 1] >> (((Width & 0x1) == 0) ? 4 : 0)) & 0x0f];
+      }
+      break;
 
-    ImageIndex = (UINTN)Image - (UINTN)ImageHeader;
-    if ((ImageIndex % 4) != 0) {
+    case 8:
       //
-      // Bmp Image starts each row on a 32-bit boundary!
+      // Translate 8-bit (256 colors) BMP Palette to 24-bit color
       //
-      Image = Image + (4 - (ImageIndex % 4));
+      for (Width = 0; Width < BmpHeader->PixelWidth; Width++) {
+        Blt[Width] = Palette[Image[Width]];
+      }
+      break;
+
+    case 24:
+      //
+      // It is 24-bit BMP.
+      //
+      for (Width = 0; Width < BmpHeader->PixelWidth; Width++, Image += 3) {
+        Blt[Width].Blue     = Image[0];
+        Blt[Width].Green    = Image[1];
+        Blt[Width].Red      = Image[2];
+        Blt[Width].Reserved = 0;
+      }
+      break;
+
+    case 32:
+      //
+      // Convert 32 bit to 24bit bmp - just ignore the final byte of each pixel
+      //
+      for (Width = 0; Width < BmpHeader->PixelWidth; Width++, Image += 4) {
+        Blt[Width].Blue     = Image[0];
+        Blt[Width].Green    = Image[1];
+        Blt[Width].Red      = Image[2];
+        Blt[Width].Reserved = 0;
+      }
+      break;
+
+    default:
+      //
+      // Other bit format BMP is not supported.
+      //
+      if (IsAllocated) {
+        FreePool (*GopBlt);
+        *GopBlt = NULL;
+      }
+      DEBUG ((DEBUG_ERROR, "Bmp Bit format not supported.  0x%X\n", BmpHeader->BitPerPixel));
+      return RETURN_UNSUPPORTED;
+      break;
     }
   }
 
+  // MU_CHANGE [END]
+
   return RETURN_SUCCESS;
 }
 
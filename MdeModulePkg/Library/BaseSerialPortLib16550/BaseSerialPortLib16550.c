@@ -601,6 +601,7 @@ SerialPortWrite (
   UINTN  Result;
   UINTN  Index;
   UINTN  FifoSize;
+  UINT8  ReadyMask;
 
   if (Buffer == NULL) {
     return 0;
@@ -631,22 +632,29 @@ SerialPortWrite (
   //
   // Compute the maximum size of the Tx FIFO
   //
-  FifoSize = 1;
+  // On a standard 16550, TXRDY is only set once the transmit holding register
+  // or the whole 16-byte FIFO is empty, so the next block can be queued while
+  // the shift register still sends the last byte. Extended FIFO UARTs may
+  // report TXRDY at a trigger level instead, so also wait for TEMT on them.
+  //
+  FifoSize  = 1;
+  ReadyMask = B_UART_LSR_TXRDY;
   if ((PcdGet8 (PcdSerialFifoControl) & B_UART_FCR_FIFOE) != 0) {
     if ((PcdGet8 (PcdSerialFifoControl) & B_UART_FCR_FIFO64) == 0) {
       FifoSize = 16;
     } else {
-      FifoSize = PcdGet32 (PcdSerialExtendedTxFifoSize);
+      FifoSize  = PcdGet32 (PcdSerialExtendedTxFifoSize);
+      ReadyMask = B_UART_LSR_TEMT | B_UART_LSR_TXRDY;
     }
   }
 
   Result = NumberOfBytes;
   while (NumberOfBytes != 0) {
     //
-    // Wait for the serial port to be ready, to make sure both the transmit FIFO
-    // and shift register empty.
+    // Wait for the serial port to be ready, to make sure the transmit FIFO
+    // is empty.
     //
-    while ((SerialPortReadRegister (SerialRegisterBase, R_UART_LSR) & (B_UART_LSR_TEMT | B_UART_LSR_TXRDY)) != (B_UART_LSR_TEMT | B_UART_LSR_TXRDY));
+    while ((SerialPortReadRegister (SerialRegisterBase, R_UART_LSR) & ReadyMask) != ReadyMask);
 
     //
     // Fill then entire Tx FIFO
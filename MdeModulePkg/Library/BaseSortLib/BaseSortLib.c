@@ -13,6 +13,275 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/SortLib.h>
 
+// MU_CHANGE [BEGIN] - Replace the recursive quicksort with an introsort
+
+//
+// Partitions at or below this many elements are finished with an insertion
+// sort, which beats further partitioning on short runs.
+//
+#define SORT_INSERTION_THRESHOLD  16
+
+//
+// Elements up to this size are staged on the stack so PerformQuickSort does
+// not have to allocate a scratch buffer.
+//
+#define SORT_STACK_BUFFER_SIZE  64
+
+#define SORT_ELEMENT(Base, Index, ElementSize)  ((UINT8 *)(Base) + (Index) * (ElementSize))
+
+/**
+  Swap two equally sized elements in place.
+
+  @param[in, out] Element1     The first element.
+  @param[in, out] Element2     The second element.
+  @param[in]      ElementSize  Size of an element in bytes.
+**/
+STATIC
+VOID
+SortSwapElements (
+  IN OUT UINT8  *Element1,
+  IN OUT UINT8  *Element2,
+  IN     UINTN  ElementSize
+  )
+{
+  UINTN  Index;
+  UINTN  Word;
+  UINT8  Byte;
+
+  if (Element1 == Element2) {
+    return;
+  }
+
+  if ((((UINTN)Element1 | (UINTN)Element2 | ElementSize) & (sizeof (UINTN) - 1)) == 0) {
+    for (Index = 0; Index < ElementSize; Index += sizeof (UINTN)) {
+      Word                         = *(UINTN *)(Element1 + Index);
+      *(UINTN *)(Element1 + Index) = *(UINTN *)(Element2 + Index);
+      *(UINTN *)(Element2 + Index) = Word;
+    }
+
+    return;
+  }
+
+  for (Index = 0; Index < ElementSize; Index++) {
+    Byte            = Element1[Index];
+    Element1[Index] = Element2[Index];
+    Element2[Index] = Byte;
+  }
+}
+
+/**
+  Sort a short run of elements with a stable insertion sort.
+
+  @param[in, out] BufferToSort     The elements to sort.
+  @param[in]      Count            The number of elements in BufferToSort.
+  @param[in]      ElementSize      Size of an element in bytes.
+  @param[in]      CompareFunction  The function used to compare two elements.
+  @param[in]      Buffer           Scratch buffer of ElementSize bytes.
+**/
+STATIC
+VOID
+SortInsertion (
+  IN OUT VOID          *BufferToSort,
+  IN     UINTN         Count,
+  IN     UINTN         ElementSize,
+  IN     SORT_COMPARE  CompareFunction,
+  IN     VOID          *Buffer
+  )
+{
+  UINTN  Index;
+  UINTN  Insert;
+  UINT8  *Element;
+
+  for (Index = 1; Index < Count; Index++) {
+    Element = SORT_ELEMENT (BufferToSort, Index, ElementSize);
+    Insert  = Index;
+    while ((Insert > 0) && (CompareFunction (SORT_ELEMENT (BufferToSort, Insert - 1, ElementSize), Element) > 0)) {
+      Insert--;
+    }
+
+    if (Insert != Index) {
+      CopyMem (Buffer, Element, ElementSize);
+      CopyMem (
+        SORT_ELEMENT (BufferToSort, Insert + 1, ElementSize),
+        SORT_ELEMENT (BufferToSort, Insert, ElementSize),
+        (Index - Insert) * ElementSize
+        );
+      CopyMem (SORT_ELEMENT (BufferToSort, Insert, ElementSize), Buffer, ElementSize);
+    }
+  }
+}
+
+/**
+  Restore the max-heap property below Root.
+
+  @param[in, out] BufferToSort     The heap.
+  @param[in]      Root             Index of the element to sift down.
+  @param[in]      Count            The number of elements in the heap.
+  @param[in]      ElementSize      Size of an element in bytes.
+  @param[in]      CompareFunction  The function used to compare two elements.
+**/
+STATIC
+VOID
+SortSiftDown (
+  IN OUT VOID          *BufferToSort,
+  IN     UINTN         Root,
+  IN     UINTN         Count,
+  IN     UINTN         ElementSize,
+  IN     SORT_COMPARE  CompareFunction
+  )
+{
+  UINTN  Child;
+
+  while ((Child = 2 * Root + 1) < Count) {
+    if ((Child + 1 < Count) &&
+        (CompareFunction (SORT_ELEMENT (BufferToSort, Child, ElementSize), SORT_ELEMENT (BufferToSort, Child + 1, ElementSize)) < 0))
+    {
+      Child++;
+    }
+
+    if (CompareFunction (SORT_ELEMENT (BufferToSort, Root, ElementSize), SORT_ELEMENT (BufferToSort, Child, ElementSize)) >= 0) {
+      return;
+    }
+
+    SortSwapElements (
+      SORT_ELEMENT (BufferToSort, Root, ElementSize),
+      SORT_ELEMENT (BufferToSort, Child, ElementSize),
+      ElementSize
+      );
+    Root = Child;
+  }
+}
+
+/**
+  Heap sort fallback used once partitioning stops making progress, which
+  bounds the worst case at O(n log n).
+
+  @param[in, out] BufferToSort     The elements to sort.
+  @param[in]      Count            The number of elements in BufferToSort.
+  @param[in]      ElementSize      Size of an element in bytes.
+  @param[in]      CompareFunction  The function used to compare two elements.
+**/
+STATIC
+VOID
+SortHeap (
+  IN OUT VOID          *BufferToSort,
+  IN     UINTN         Count,
+  IN     UINTN         ElementSize,
+  IN     SORT_COMPARE  CompareFunction
+  )
+{
+  UINTN  Index;
+
+  for (Index = Count / 2; Index > 0; Index--) {
+    SortSiftDown (BufferToSort, Index - 1, Count, ElementSize, CompareFunction);
+  }
+
+  for (Index = Count - 1; Index > 0; Index--) {
+    SortSwapElements (
+      SORT_ELEMENT (BufferToSort, 0, ElementSize),
+      SORT_ELEMENT (BufferToSort, Index, ElementSize),
+      ElementSize
+      );
+    SortSiftDown (BufferToSort, 0, Index, ElementSize, CompareFunction);
+  }
+}
+
+/**
+  Introsort: median-of-three quicksort that recurses only into the smaller
+  partition, falls back to heap sort when DepthLimit runs out and finishes
+  short runs with insertion sort.
+
+  @param[in, out] BufferToSort     The elements to sort.
+  @param[in]      Count            The number of elements in BufferToSort.
+  @param[in]      ElementSize      Size of an element in bytes.
+  @param[in]      CompareFunction  The function used to compare two elements.
+  @param[in]      Buffer           Scratch buffer of ElementSize bytes.
+  @param[in]      DepthLimit       Partitioning rounds left before heap sort.
+**/
+STATIC
+VOID
+SortIntroWorker (
+  IN OUT VOID          *BufferToSort,
+  IN     UINTN         Count,
+  IN     UINTN         ElementSize,
+  IN     SORT_COMPARE  CompareFunction,
+  IN     VOID          *Buffer,
+  IN     UINTN         DepthLimit
+  )
+{
+  UINTN  Last;
+  UINTN  Middle;
+  UINTN  Left;
+  UINTN  Right;
+  UINT8  *Pivot;
+
+  while (Count > SORT_INSERTION_THRESHOLD) {
+    if (DepthLimit == 0) {
+      SortHeap (BufferToSort, Count, ElementSize, CompareFunction);
+      return;
+    }
+
+    DepthLimit--;
+
+    //
+    // Order the first, middle and last elements so they act as sentinels for
+    // the partition scans, then park the median just before the last one.
+    //
+    Last   = Count - 1;
+    Middle = Count / 2;
+    if (CompareFunction (SORT_ELEMENT (BufferToSort, Middle, ElementSize), SORT_ELEMENT (BufferToSort, 0, ElementSize)) < 0) {
+      SortSwapElements (SORT_ELEMENT (BufferToSort, Middle, ElementSize), SORT_ELEMENT (BufferToSort, 0, ElementSize), ElementSize);
+    }
+
+    if (CompareFunction (SORT_ELEMENT (BufferToSort, Last, ElementSize), SORT_ELEMENT (BufferToSort, Middle, ElementSize)) < 0) {
+      SortSwapElements (SORT_ELEMENT (BufferToSort, Last, ElementSize), SORT_ELEMENT (BufferToSort, Middle, ElementSize), ElementSize);
+      if (CompareFunction (SORT_ELEMENT (BufferToSort, Middle, ElementSize), SORT_ELEMENT (BufferToSort, 0, ElementSize)) < 0) {
+        SortSwapElements (SORT_ELEMENT (BufferToSort, Middle, ElementSize), SORT_ELEMENT (BufferToSort, 0, ElementSize), ElementSize);
+      }
+    }
+
+    SortSwapElements (SORT_ELEMENT (BufferToSort, Middle, ElementSize), SORT_ELEMENT (BufferToSort, Last - 1, ElementSize), ElementSize);
+    Pivot = SORT_ELEMENT (BufferToSort, Last - 1, ElementSize);
+
+    //
+    // Both scans stop on elements equal to the pivot, so runs of duplicates
+    // split evenly instead of degrading to quadratic time.
+    //
+    Left  = 0;
+    Right = Last - 1;
+    for ( ; ;) {
+      while (CompareFunction (SORT_ELEMENT (BufferToSort, ++Left, ElementSize), Pivot) < 0) {
+      }
+
+      while (CompareFunction (SORT_ELEMENT (BufferToSort, --Right, ElementSize), Pivot) > 0) {
+      }
+
+      if (Left >= Right) {
+        break;
+      }
+
+      SortSwapElements (SORT_ELEMENT (BufferToSort, Left, ElementSize), SORT_ELEMENT (BufferToSort, Right, ElementSize), ElementSize);
+    }
+
+    SortSwapElements (SORT_ELEMENT (BufferToSort, Left, ElementSize), Pivot, ElementSize);
+
+    //
+    // Recurse into the smaller side and loop on the larger one to keep the
+    // stack depth logarithmic.
+    //
+    if (Left < Count - Left - 1) {
+      SortIntroWorker (BufferToSort, Left, ElementSize, CompareFunction, Buffer, DepthLimit);
+      BufferToSort = SORT_ELEMENT (BufferToSort, Left + 1, ElementSize);
+      Count        = Count - Left - 1;
+    } else {
+      SortIntroWorker (SORT_ELEMENT (BufferToSort, Left + 1, ElementSize), Count - Left - 1, ElementSize, CompareFunction, Buffer, DepthLimit);
+      Count = Left;
+    }
+  }
+
+  SortInsertion (BufferToSort, Count, ElementSize, CompareFunction, Buffer);
+}
+
 /**
   Worker function for QuickSorting.  This function is identical to PerformQuickSort,
   except that is uses the pre-allocated buffer so the in place sorting does not need to
@@ -33,7 +302,7 @@
   @param[in] ElementSize         Size of an element in bytes
   @param[in] CompareFunction     The function to call to perform the comparison
                                  of any 2 elements
-  @param[in] Buffer              Buffer of size ElementSize for use in swapping
+  @param[in] Buffer              Scratch buffer of size ElementSize
 **/
 VOID
 EFIAPI
@@ -45,10 +314,6 @@ QuickSortWorker (
   IN VOID                               *Buffer
   )
 {
-  VOID        *Pivot;
-  UINTN       LoopCount;
-  UINTN       NextSwapLocation;
-
   ASSERT(BufferToSort     != NULL);
   ASSERT(CompareFunction  != NULL);
   ASSERT(Buffer  != NULL);
@@ -59,68 +324,18 @@ QuickSortWorker (
     return;
   }
 
-  NextSwapLocation = 0;
-
-  //
-  // pick a pivot (we choose last element)
-  //
-  Pivot = ((UINT8*)BufferToSort+((Count-1)*ElementSize));
-
-  //
-  // Now get the pivot such that all on "left" are below it
-  // and everything "right" are above it
-  //
-  for ( LoopCount = 0
-      ; LoopCount < Count -1
-      ; LoopCount++
-     ){
-    //
-    // if the element is less than the pivot
-    //
-    if (CompareFunction((VOID*)((UINT8*)BufferToSort+((LoopCount)*ElementSize)),Pivot) <= 0){
-      //
-      // swap
-      //
-      CopyMem (Buffer, (UINT8*)BufferToSort+(NextSwapLocation*ElementSize), ElementSize);
-      CopyMem ((UINT8*)BufferToSort+(NextSwapLocation*ElementSize), (UINT8*)BufferToSort+((LoopCount)*ElementSize), ElementSize);
-      CopyMem ((UINT8*)BufferToSort+((LoopCount)*ElementSize), Buffer, ElementSize);
-
-      //
-      // increment NextSwapLocation
-      //
-      NextSwapLocation++;
-    }
-  }
-  //
-  // swap pivot to it's final position (NextSwapLocaiton)
-  //
-  CopyMem (Buffer, Pivot, ElementSize);
-  CopyMem (Pivot, (UINT8*)BufferToSort+(NextSwapLocation*ElementSize), ElementSize);
-  CopyMem ((UINT8*)BufferToSort+(NextSwapLocation*ElementSize), Buffer, ElementSize);
-
-  //
-  // Now recurse on 2 paritial lists.  neither of these will have the 'pivot' element
-  // IE list is sorted left half, pivot element, sorted right half...
-  //
-  if (NextSwapLocation >= 2) {
-    QuickSortWorker(
-      BufferToSort,
-      NextSwapLocation,
-      ElementSize,
-      CompareFunction,
-      Buffer);
-  }
-
-  if ((Count - NextSwapLocation - 1) >= 2) {
-    QuickSortWorker(
-      (UINT8 *)BufferToSort + (NextSwapLocation+1) * ElementSize,
-      Count - NextSwapLocation - 1,
-      ElementSize,
-      CompareFunction,
-      Buffer);
-  }
-  return;
+  SortIntroWorker (
+    BufferToSort,
+    Count,
+    ElementSize,
+    CompareFunction,
+    Buffer,
+    2 * (UINTN)HighBitSet64 (Count)
+    );
 }
+
+// MU_CHANGE [END]
+
 /**
   Function to perform a Quick Sort alogrithm on a buffer of comparable elements.
 
@@ -148,13 +363,22 @@ PerformQuickSort (
   IN       SORT_COMPARE                 CompareFunction
   )
 {
-  VOID  *Buffer;
+  // MU_CHANGE [BEGIN] - Stage small elements on the stack
+  UINT64  StackBuffer[SORT_STACK_BUFFER_SIZE / sizeof (UINT64)];
+  VOID    *Buffer;
 
   ASSERT(BufferToSort     != NULL);
   ASSERT(CompareFunction  != NULL);
 
-  Buffer = AllocateZeroPool(ElementSize);
-  ASSERT(Buffer != NULL);
+  if (ElementSize <= sizeof (StackBuffer)) {
+    Buffer = StackBuffer;
+  } else {
+    Buffer = AllocatePool (ElementSize);
+    ASSERT(Buffer != NULL);
+    if (Buffer == NULL) {
+      return;
+    }
+  }
 
   QuickSortWorker(
     BufferToSort,
@@ -163,7 +387,10 @@ PerformQuickSort (
     CompareFunction,
     Buffer);
 
-  FreePool(Buffer);
+  if (Buffer != StackBuffer) {
+    FreePool(Buffer);
+  }
+  // MU_CHANGE [END]
   return;
 }
 
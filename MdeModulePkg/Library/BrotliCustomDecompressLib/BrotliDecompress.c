@@ -93,12 +93,18 @@ BrFree (
   @param  Destination The destination buffer to store the decompressed data.
   @param  DestSize    The destination buffer size.
   @param  BuffInfo    The pointer to the BROTLI_BUFF instance.
+  @param  Dictionary  The custom dictionary the data was compressed with,
+                      NULL if there is none.
+  @param  DictionarySize
+                      The size of the custom dictionary.
 
   @retval EFI_SUCCESS Decompression completed successfully, and
                       the uncompressed buffer is returned in Destination.
   @retval EFI_INVALID_PARAMETER
                       The source buffer specified by Source is corrupted
                       (not in a valid compressed format).
+  @retval EFI_UNSUPPORTED
+                      The Brotli decoder does not support custom dictionaries.
 **/
 EFI_STATUS
 BrotliDecompress (
@@ -106,7 +112,9 @@ BrotliDecompress (
   IN UINTN        SourceSize,
   IN OUT VOID*    Destination,
   IN OUT UINTN    DestSize,
-  IN VOID *       BuffInfo
+  IN VOID *       BuffInfo,
+  IN CONST VOID*  Dictionary,     OPTIONAL
+  IN UINTN        DictionarySize
   )
 {
   UINT8 *        Input;
@@ -129,6 +137,21 @@ BrotliDecompress (
   if (BroState == NULL) {
     return EFI_INVALID_PARAMETER;
   }
+
+  //
+  // The dictionary is used in place, the decoder does not copy it.
+  //
+  if (Dictionary != NULL) {
+#if BROTLI_VERSION >= BROTLI_DICTIONARY_VERSION
+    if (!BrotliDecoderAttachDictionary (BroState, BROTLI_SHARED_DICTIONARY_RAW, DictionarySize, Dictionary)) {
+      BrotliDecoderDestroyInstance(BroState);
+      return EFI_INVALID_PARAMETER;
+    }
+#else
+    BrotliDecoderDestroyInstance(BroState);
+    return EFI_UNSUPPORTED;
+#endif
+  }
   Input = (UINT8 *)BrAlloc(BuffInfo, FILE_BUFFER_SIZE);
   Output = (UINT8 *)BrAlloc(BuffInfo, FILE_BUFFER_SIZE);
   if ((Input==NULL) || (Output==NULL)) {
@@ -276,12 +299,18 @@ BrotliUefiDecompressGetInfo (
   @param  Scratch     A temporary scratch buffer that is used to perform the decompression.
                       This is an optional parameter that may be NULL if the
                       required scratch buffer size is 0.
+  @param  Dictionary  The custom dictionary the data was compressed with,
+                      NULL if there is none.
+  @param  DictionarySize
+                      The size of the custom dictionary.
 
   @retval EFI_SUCCESS Decompression completed successfully, and
                       the uncompressed buffer is returned in Destination.
   @retval EFI_INVALID_PARAMETER
                       The source buffer specified by Source is corrupted
                       (not in a valid compressed format).
+  @retval EFI_UNSUPPORTED
+                      The Brotli decoder does not support custom dictionaries.
 **/
 EFI_STATUS
 EFIAPI
@@ -289,7 +318,9 @@ BrotliUefiDecompress (
   IN CONST VOID *   Source,
   IN UINTN          SourceSize,
   IN OUT VOID *     Destination,
-  IN OUT VOID *     Scratch
+  IN OUT VOID *     Scratch,
+  IN CONST VOID *   Dictionary,     OPTIONAL
+  IN UINTN          DictionarySize
   )
 {
   UINTN          DestSize = 0;
@@ -309,7 +340,9 @@ BrotliUefiDecompress (
             SourceSize - BROTLI_SCRATCH_MAX,
             Destination,
             DestSize,
-            (VOID *)(&BroBuff)
+            (VOID *)(&BroBuff),
+            Dictionary,
+            DictionarySize
             );
 
   return Status;
@@ -12,9 +12,18 @@
 #define __BROTLI_DECOMPRESS_INTERNAL_H__
 
 #include <PiPei.h>
+#include <Guid/FirmwareFileSystem2.h>
+#include <Guid/FirmwareFileSystem3.h>
 #include <Library/ExtractGuidedSectionLib.h>
+#include <Library/HobLib.h>
 #include <brotli/c/include/brotli/types.h>
 #include <brotli/c/include/brotli/decode.h>
+#include <brotli/c/common/version.h>
+
+//
+// Brotli attaches custom dictionaries to the decoder from version 1.1.0.
+//
+#define BROTLI_DICTIONARY_VERSION  0x1001000
 
 typedef struct
 {
@@ -42,7 +51,25 @@ BrotliUefiDecompress (
   IN CONST VOID  *Source,
   IN UINTN       SourceSize,
   IN OUT VOID    *Destination,
-  IN OUT VOID    *Scratch
+  IN OUT VOID    *Scratch,
+  IN CONST VOID  *Dictionary,      OPTIONAL
+  IN UINTN       DictionarySize
+  );
+
+/**
+  Find the shared Brotli dictionary of the platform in the firmware volumes
+  described by the FV HOBs.
+
+  @param  Dictionary      On return, pointer to the dictionary.
+  @param  DictionarySize  On return, size of the dictionary.
+
+  @retval EFI_SUCCESS     The dictionary is found.
+  @retval EFI_NOT_FOUND   No firmware volume has the dictionary.
+**/
+EFI_STATUS
+BrotliGetDictionary (
+  OUT CONST VOID  **Dictionary,
+  OUT UINTN       *DictionarySize
   );
 
 #endif
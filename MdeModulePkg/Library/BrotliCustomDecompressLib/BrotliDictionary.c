@@ -0,0 +1,205 @@
+/** @file
+  Find the shared Brotli dictionary of the platform.
+
+  The dictionary is the RAW section of the FREEFORM file gBrotliDictionaryFileGuid,
+  stored once in a firmware volume described by a FV HOB. The sections compressed
+  with it are GUIDed sections of type gBrotliDictionaryDecompressGuid. The
+  dictionary is used in place, in the memory mapped firmware volume.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <BrotliDecompressLibInternal.h>
+
+/**
+  Get the state of a FFS file, set by the highest bit of its State field.
+
+  @param  ErasePolarity   Erase polarity of the firmware volume.
+  @param  FfsHeader       Pointer to the FFS file header.
+
+  @return The state of the file.
+**/
+EFI_FFS_FILE_STATE
+BrGetFileState (
+  IN UINT8                ErasePolarity,
+  IN EFI_FFS_FILE_HEADER  *FfsHeader
+  )
+{
+  EFI_FFS_FILE_STATE  FileState;
+  EFI_FFS_FILE_STATE  HighestBit;
+
+  FileState = FfsHeader->State;
+  if (ErasePolarity != 0) {
+    FileState = (EFI_FFS_FILE_STATE) ~FileState;
+  }
+
+  HighestBit = 0x80;
+  while ((HighestBit != 0) && ((HighestBit & FileState) == 0)) {
+    HighestBit >>= 1;
+  }
+
+  return HighestBit;
+}
+
+/**
+  Find the RAW section of a FFS file.
+
+  @param  FfsHeader       Pointer to the FFS file header.
+  @param  FileSize        Size of the FFS file, header included.
+  @param  Data            On return, pointer to the data of the section.
+  @param  DataSize        On return, size of the data of the section.
+
+  @retval EFI_SUCCESS     The section is found.
+  @retval EFI_NOT_FOUND   The file has no RAW section.
+**/
+EFI_STATUS
+BrFindRawSection (
+  IN  EFI_FFS_FILE_HEADER  *FfsHeader,
+  IN  UINT64               FileSize,
+  OUT CONST VOID           **Data,
+  OUT UINTN                *DataSize
+  )
+{
+  EFI_COMMON_SECTION_HEADER  *Section;
+  UINT64                     Offset;
+  UINT32                     SectionSize;
+  UINT32                     HeaderSize;
+
+  Offset = IS_FFS_FILE2 (FfsHeader) ? sizeof (EFI_FFS_FILE_HEADER2) : sizeof (EFI_FFS_FILE_HEADER);
+  while (Offset + sizeof (EFI_COMMON_SECTION_HEADER) <= FileSize) {
+    Section = (EFI_COMMON_SECTION_HEADER *) ((UINT8 *) FfsHeader + Offset);
+    if (IS_SECTION2 (Section)) {
+      if (Offset + sizeof (EFI_COMMON_SECTION_HEADER2) > FileSize) {
+        break;
+      }
+      SectionSize = SECTION2_SIZE (Section);
+      HeaderSize  = sizeof (EFI_COMMON_SECTION_HEADER2);
+    } else {
+      SectionSize = SECTION_SIZE (Section);
+      HeaderSize  = sizeof (EFI_COMMON_SECTION_HEADER);
+    }
+
+    if ((SectionSize < HeaderSize) || (Offset + SectionSize > FileSize)) {
+      break;
+    }
+
+    if (Section->Type == EFI_SECTION_RAW) {
+      *Data     = (UINT8 *) Section + HeaderSize;
+      *DataSize = SectionSize - HeaderSize;
+      return EFI_SUCCESS;
+    }
+
+    Offset = ALIGN_VALUE (Offset + SectionSize, 4);
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Find the shared Brotli dictionary in a firmware volume.
+
+  @param  FwVolHeader     Pointer to the memory mapped firmware volume.
+  @param  Dictionary      On return, pointer to the dictionary.
+  @param  DictionarySize  On return, size of the dictionary.
+
+  @retval EFI_SUCCESS     The dictionary is found.
+  @retval EFI_NOT_FOUND   The firmware volume has no dictionary.
+**/
+EFI_STATUS
+BrFindDictionaryInFv (
+  IN  EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader,
+  OUT CONST VOID                  **Dictionary,
+  OUT UINTN                       *DictionarySize
+  )
+{
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *FwVolExtHeader;
+  EFI_FFS_FILE_HEADER             *FfsHeader;
+  UINT64                          Offset;
+  UINT64                          FileSize;
+  UINT8                           ErasePolarity;
+
+  if ((FwVolHeader->Signature != EFI_FVH_SIGNATURE) ||
+      (FwVolHeader->FvLength < FwVolHeader->HeaderLength) ||
+      (!CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem2Guid) &&
+       !CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid))) {
+    return EFI_NOT_FOUND;
+  }
+
+  ErasePolarity = (UINT8) (((FwVolHeader->Attributes & EFI_FVB2_ERASE_POLARITY) != 0) ? 1 : 0);
+
+  Offset = FwVolHeader->HeaderLength;
+  if (FwVolHeader->ExtHeaderOffset != 0) {
+    if ((UINT64) FwVolHeader->ExtHeaderOffset + sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER) > FwVolHeader->FvLength) {
+      return EFI_NOT_FOUND;
+    }
+    FwVolExtHeader = (EFI_FIRMWARE_VOLUME_EXT_HEADER *) ((UINT8 *) FwVolHeader + FwVolHeader->ExtHeaderOffset);
+    Offset         = (UINT64) FwVolHeader->ExtHeaderOffset + FwVolExtHeader->ExtHeaderSize;
+  }
+  Offset = ALIGN_VALUE (Offset, 8);
+
+  while (Offset + sizeof (EFI_FFS_FILE_HEADER) <= FwVolHeader->FvLength) {
+    FfsHeader = (EFI_FFS_FILE_HEADER *) ((UINT8 *) FwVolHeader + Offset);
+    if (IS_FFS_FILE2 (FfsHeader)) {
+      if (Offset + sizeof (EFI_FFS_FILE_HEADER2) > FwVolHeader->FvLength) {
+        break;
+      }
+      FileSize = FFS_FILE2_SIZE (FfsHeader);
+    } else {
+      FileSize = FFS_FILE_SIZE (FfsHeader);
+    }
+
+    //
+    // The free space, or a corrupted file, ends the search.
+    //
+    if ((FileSize < sizeof (EFI_FFS_FILE_HEADER)) || (Offset + FileSize > FwVolHeader->FvLength)) {
+      break;
+    }
+
+    if ((BrGetFileState (ErasePolarity, FfsHeader) == EFI_FILE_DATA_VALID) &&
+        CompareGuid (&FfsHeader->Name, &gBrotliDictionaryFileGuid)) {
+      return BrFindRawSection (FfsHeader, FileSize, Dictionary, DictionarySize);
+    }
+
+    Offset = ALIGN_VALUE (Offset + FileSize, 8);
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Find the shared Brotli dictionary of the platform in the firmware volumes
+  described by the FV HOBs.
+
+  @param  Dictionary      On return, pointer to the dictionary.
+  @param  DictionarySize  On return, size of the dictionary.
+
+  @retval EFI_SUCCESS     The dictionary is found.
+  @retval EFI_NOT_FOUND   No firmware volume has the dictionary.
+**/
+EFI_STATUS
+BrotliGetDictionary (
+  OUT CONST VOID  **Dictionary,
+  OUT UINTN       *DictionarySize
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+
+  for (Hob.Raw = GetFirstHob (EFI_HOB_TYPE_FV);
+       Hob.Raw != NULL;
+       Hob.Raw = GetNextHob (EFI_HOB_TYPE_FV, GET_NEXT_HOB (Hob))) {
+    if (Hob.FirmwareVolume->Length < sizeof (EFI_FIRMWARE_VOLUME_HEADER)) {
+      continue;
+    }
+    if (!EFI_ERROR (BrFindDictionaryInFv (
+                      (EFI_FIRMWARE_VOLUME_HEADER *) (UINTN) Hob.FirmwareVolume->BaseAddress,
+                      Dictionary,
+                      DictionarySize
+                      ))) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
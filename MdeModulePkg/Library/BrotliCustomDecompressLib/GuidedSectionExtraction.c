@@ -3,6 +3,9 @@
   It wraps Brotli decompress interfaces to GUIDed Section Extraction interfaces
   and registers them into GUIDed handler table.
 
+  The sections of type gBrotliDictionaryDecompressGuid are compressed with the
+  shared dictionary of the platform, see BrotliDictionary.c.
+
   Copyright (c) 2017, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -60,6 +63,9 @@ BrotliGuidedSectionGetInfo (
   if (IS_SECTION2 (InputSection)) {
     if (!CompareGuid (
         &gBrotliCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid)) &&
+        !CompareGuid (
+        &gBrotliDictionaryDecompressGuid,
         &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid))) {
       return RETURN_INVALID_PARAMETER;
     }
@@ -75,6 +81,9 @@ BrotliGuidedSectionGetInfo (
   } else {
     if (!CompareGuid (
         &gBrotliCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid)) &&
+        !CompareGuid (
+        &gBrotliDictionaryDecompressGuid,
         &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid))) {
       return RETURN_INVALID_PARAMETER;
     }
@@ -131,15 +140,31 @@ BrotliGuidedSectionExtraction (
   OUT       UINT32  *AuthenticationStatus
   )
 {
+  CONST EFI_GUID  *SectionGuid;
+  CONST VOID      *Dictionary;
+  UINTN           DictionarySize;
+
   ASSERT (OutputBuffer != NULL);
   ASSERT (InputSection != NULL);
 
   if (IS_SECTION2 (InputSection)) {
-    if (!CompareGuid (
-        &gBrotliCustomDecompressGuid,
-        &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid))) {
+    SectionGuid = &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid);
+  } else {
+    SectionGuid = &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid);
+  }
+
+  Dictionary     = NULL;
+  DictionarySize = 0;
+  if (CompareGuid (&gBrotliDictionaryDecompressGuid, SectionGuid)) {
+    if (EFI_ERROR (BrotliGetDictionary (&Dictionary, &DictionarySize))) {
+      DEBUG ((DEBUG_ERROR, "Brotli: the shared dictionary is not in a firmware volume\n"));
       return RETURN_INVALID_PARAMETER;
     }
+  } else if (!CompareGuid (&gBrotliCustomDecompressGuid, SectionGuid)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (IS_SECTION2 (InputSection)) {
     //
     // Authentication is set to Zero, which may be ignored.
     //
@@ -149,14 +174,11 @@ BrotliGuidedSectionExtraction (
              (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
              SECTION2_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset,
              *OutputBuffer,
-             ScratchBuffer
+             ScratchBuffer,
+             Dictionary,
+             DictionarySize
              );
   } else {
-    if (!CompareGuid (
-        &gBrotliCustomDecompressGuid,
-        &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid))) {
-      return RETURN_INVALID_PARAMETER;
-    }
     //
     // Authentication is set to Zero, which may be ignored.
     //
@@ -166,13 +188,16 @@ BrotliGuidedSectionExtraction (
              (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
              SECTION_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset,
              *OutputBuffer,
-             ScratchBuffer
+             ScratchBuffer,
+             Dictionary,
+             DictionarySize
     );
   }
 }
 
 /**
-  Register BrotliDecompress and BrotliDecompressGetInfo handlers with BrotliCustomerDecompressGuid.
+  Register BrotliDecompress and BrotliDecompressGetInfo handlers with BrotliCustomerDecompressGuid
+  and BrotliDictionaryDecompressGuid.
 
   @retval  EFI_SUCCESS            Register successfully.
   @retval  EFI_OUT_OF_RESOURCES   No enough memory to store this handler.
@@ -183,9 +208,20 @@ BrotliDecompressLibConstructor (
   VOID
   )
 {
+  EFI_STATUS  Status;
+
+  Status = ExtractGuidedSectionRegisterHandlers (
+             &gBrotliCustomDecompressGuid,
+             BrotliGuidedSectionGetInfo,
+             BrotliGuidedSectionExtraction
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   return ExtractGuidedSectionRegisterHandlers (
-          &gBrotliCustomDecompressGuid,
-          BrotliGuidedSectionGetInfo,
-          BrotliGuidedSectionExtraction
-          );
+           &gBrotliDictionaryDecompressGuid,
+           BrotliGuidedSectionGetInfo,
+           BrotliGuidedSectionExtraction
+           );
 }
@@ -82,6 +82,29 @@ CoreAllocatePool (
   OUT VOID            **Buffer
   );
 
+// MU_CHANGE [BEGIN] - Zeroed page cache for zero pool allocations
+/**
+  Allocate and clear pool of a particular type.
+
+  @param  PoolType               Type of pool to allocate
+  @param  Size                   The amount of pool to allocate
+  @param  Buffer                 The address to return a pointer to the allocated
+                                 pool
+
+  @retval EFI_INVALID_PARAMETER  PoolType not valid
+  @retval EFI_OUT_OF_RESOURCES   Size exceeds max pool size or allocation failed.
+  @retval EFI_SUCCESS            Pool successfully allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreAllocateZeroPool (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            Size,
+  OUT VOID            **Buffer
+  );
+// MU_CHANGE [END]
+
 /**
   Frees pool.
 
@@ -581,11 +581,17 @@ InternalAllocateZeroPool (
   IN UINTN            AllocationSize
   )
 {
-  VOID  *Memory;
+  EFI_STATUS  Status;
+  VOID        *Memory;
 
-  Memory = InternalAllocatePool (PoolType, AllocationSize);
-  if (Memory != NULL) {
-    Memory = ZeroMem (Memory, AllocationSize);
+  //
+  // MU_CHANGE - The DXE core clears the pool, and may take it from pages
+  //             that are already zero.
+  //
+  Memory = NULL;
+  Status = CoreAllocateZeroPool (PoolType, AllocationSize, &Memory);
+  if (EFI_ERROR (Status)) {
+    Memory = NULL;
   }
   return Memory;
 }
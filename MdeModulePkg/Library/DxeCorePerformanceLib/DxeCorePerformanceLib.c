@@ -26,6 +26,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define STRING_SIZE             (FPDT_STRING_EVENT_RECORD_NAME_LENGTH * sizeof (CHAR8))
 #define FIRMWARE_RECORD_BUFFER  0x10000
 #define CACHE_HANDLE_GUID_COUNT 0x800
+#define CACHE_HANDLE_HASH_SIZE  0x100
+#define CACHE_HANDLE_HASH(Handle) ((((UINTN) (Handle)) >> 3) & (CACHE_HANDLE_HASH_SIZE - 1))
 
 BOOT_PERFORMANCE_TABLE          *mAcpiBootPerformanceTable = NULL;
 BOOT_PERFORMANCE_TABLE          mBootPerformanceTableTemplate = {
@@ -55,10 +57,15 @@ typedef struct {
   EFI_HANDLE    Handle;
   CHAR8         NameString[FPDT_STRING_EVENT_RECORD_NAME_LENGTH];
   EFI_GUID      ModuleGuid;
+  UINT16        Next;           // 1-based index of the next pair in the same hash bucket, 0 for none.
 } HANDLE_GUID_MAP;
 
 HANDLE_GUID_MAP mCacheHandleGuidTable[CACHE_HANDLE_GUID_COUNT];
 UINTN           mCachePairCount = 0;
+//
+// 1-based index of the most recently cached pair for each hash bucket, 0 for none.
+//
+UINT16          mCacheHandleHashTable[CACHE_HANDLE_HASH_SIZE];
 
 UINT32  mLoadImageCount       = 0;
 UINT32  mPerformanceLength    = 0;
@@ -431,7 +438,7 @@ GetModuleInfoFromHandle (
   EFI_GUID                    *TempGuid;
   UINTN                       StartIndex;
   UINTN                       Index;
-  INTN                        Count;
+  UINTN                       Bucket;
   BOOLEAN                     ModuleGuidIsGet;
   UINTN                       StringSize;
   CHAR16                      *StringPtr;
@@ -443,14 +450,15 @@ GetModuleInfoFromHandle (
   }
   //
   // Try to get the ModuleGuid and name string form the caached array.
+  // Each bucket chains from the newest pair to the oldest one, so a reused
+  // handle still resolves to its latest module.
   //
-  if (mCachePairCount > 0) {
-    for (Count = mCachePairCount -1; Count >= 0; Count--) {
-      if (Handle == mCacheHandleGuidTable[Count].Handle) {
-        CopyGuid (ModuleGuid, &mCacheHandleGuidTable[Count].ModuleGuid);
-        AsciiStrCpyS (NameString, FPDT_STRING_EVENT_RECORD_NAME_LENGTH, mCacheHandleGuidTable[Count].NameString);
-        return EFI_SUCCESS;
-      }
+  Bucket = CACHE_HANDLE_HASH (Handle);
+  for (Index = mCacheHandleHashTable[Bucket]; Index != 0; Index = mCacheHandleGuidTable[Index - 1].Next) {
+    if (Handle == mCacheHandleGuidTable[Index - 1].Handle) {
+      CopyGuid (ModuleGuid, &mCacheHandleGuidTable[Index - 1].ModuleGuid);
+      AsciiStrCpyS (NameString, FPDT_STRING_EVENT_RECORD_NAME_LENGTH, mCacheHandleGuidTable[Index - 1].NameString);
+      return EFI_SUCCESS;
     }
   }
 
@@ -630,7 +638,9 @@ Done:
     mCacheHandleGuidTable[mCachePairCount].Handle = Handle;
     CopyGuid (&mCacheHandleGuidTable[mCachePairCount].ModuleGuid, ModuleGuid);
     AsciiStrCpyS (mCacheHandleGuidTable[mCachePairCount].NameString, FPDT_STRING_EVENT_RECORD_NAME_LENGTH, NameString);
+    mCacheHandleGuidTable[mCachePairCount].Next = mCacheHandleHashTable[Bucket];
     mCachePairCount ++;
+    mCacheHandleHashTable[Bucket] = (UINT16) mCachePairCount;
   }
 
   return Status;
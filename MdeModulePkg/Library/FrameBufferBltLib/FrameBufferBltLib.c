@@ -81,6 +81,36 @@ FrameBufferBltLibConfigurePixelFormat (
   DEBUG ((DEBUG_INFO, "Bytes per pixel: %d\n", *BytesPerPixel));
 }
 
+/**
+  Convert a line of pixels between the RGB8 and BGR8 formats.
+
+  The conversion only swaps the red and blue bytes, so it is its own inverse
+  and serves both directions. The reserved byte is cleared, matching the
+  result of the generic mask and shift conversion. Source and Destination
+  may be the same buffer.
+
+  @param[out] Destination  The converted pixels.
+  @param[in]  Source       The pixels to convert.
+  @param[in]  Width        Number of pixels to convert.
+**/
+VOID
+FrameBufferBltLibSwapRedBlue (
+  OUT UINT32        *Destination,
+  IN  CONST UINT32  *Source,
+  IN  UINTN         Width
+  )
+{
+  UINTN   IndexX;
+  UINT32  Uint32;
+
+  for (IndexX = 0; IndexX < Width; IndexX++) {
+    Uint32 = Source[IndexX];
+    Destination[IndexX] = ((Uint32 & 0x000000ff) << 16) |
+                          (Uint32 & 0x0000ff00) |
+                          ((Uint32 >> 16) & 0x000000ff);
+  }
+}
+
 /**
   Create the configuration for a video frame buffer.
 
@@ -398,7 +428,8 @@ FrameBufferBltLibVideoToBltBuffer (
     Offset = Configure->BytesPerPixel * Offset;
     Source = Configure->FrameBuffer + Offset;
 
-    if (Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) {
+    if ((Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) ||
+        (Configure->PixelFormat == PixelRedGreenBlueReserved8BitPerColor)) {
       Destination = (UINT8 *) BltBuffer + (DstY * Delta) + (DestinationX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
     } else {
       Destination = Configure->LineBuffer;
@@ -406,7 +437,13 @@ FrameBufferBltLibVideoToBltBuffer (
 
     CopyMem (Destination, Source, WidthInBytes);
 
-    if (Configure->PixelFormat != PixelBlueGreenRedReserved8BitPerColor) {
+    if (Configure->PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+      //
+      // The pixels are 32-bit on both sides, so convert them in place in the
+      // BltBuffer rather than going through the line buffer.
+      //
+      FrameBufferBltLibSwapRedBlue ((UINT32 *) Destination, (UINT32 *) Destination, Width);
+    } else if (Configure->PixelFormat != PixelBlueGreenRedReserved8BitPerColor) {
       for (IndexX = 0; IndexX < Width; IndexX++) {
         Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)
           ((UINT8 *) BltBuffer + (DstY * Delta) +
@@ -505,6 +542,17 @@ FrameBufferBltLibBufferToVideo (
 
     if (Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) {
       Source = (UINT8 *) BltBuffer + (SrcY * Delta) + SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+    } else if (Configure->PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+      //
+      // Still go through the line buffer so the frame buffer, which is
+      // usually write-combining, is only written by a single CopyMem.
+      //
+      FrameBufferBltLibSwapRedBlue (
+        (UINT32 *) Configure->LineBuffer,
+        (UINT32 *) ((UINT8 *) BltBuffer + (SrcY * Delta) + SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)),
+        Width
+        );
+      Source = Configure->LineBuffer;
     } else {
       for (IndexX = 0; IndexX < Width; IndexX++) {
         Blt =
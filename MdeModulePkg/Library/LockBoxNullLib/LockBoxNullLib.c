@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Uefi.h>
 #include <Library/DebugLib.h>
+#include <Library/LockBoxLib.h>
 
 /**
   This function will save confidential information to lockbox.
@@ -133,3 +134,30 @@ RestoreAllLockBoxInPlace (
 {
   return RETURN_SUCCESS;
 }
+
+// MU_CHANGE [BEGIN] - Restore several LockBoxes at once.
+/**
+  This function will restore confidential information from several lockboxes.
+
+  @param Entries  the lockboxes to restore, the status of each one is returned in its entry
+  @param Count    the number of entries
+
+  @retval RETURN_SUCCESS            all the lockboxes are restored successfully.
+  @retval RETURN_INVALID_PARAMETER  Entries is NULL and Count is not 0, or the Guid of an entry is NULL.
+  @return others                    the status of the first entry that failed to restore.
+**/
+RETURN_STATUS
+EFIAPI
+RestoreMultipleLockBox (
+  IN OUT LOCK_BOX_RESTORE_ENTRY   *Entries,
+  IN     UINTN                    Count
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    Entries[Index].Status = RETURN_SUCCESS;
+  }
+  return RETURN_SUCCESS;
+}
+// MU_CHANGE [END]
@@ -31,7 +31,13 @@ typedef int ptrdiff_t;
 #define memcpy CopyMem
 #define memmove CopyMem
 
-#define _LZMA_SIZE_OPT
+// MU_CHANGE [BEGIN] - Build the speed optimized LZMA decoder
+//
+// The size optimized decoder (_LZMA_SIZE_OPT) is about 10% slower, for 2.7 KB
+// less code. Platforms short of flash space can still select it with
+// -D_LZMA_SIZE_OPT in the build options of LzmaCustomDecompressLib.
+//
+// MU_CHANGE [END]
 
 #endif // __UEFILZMA_H__
 
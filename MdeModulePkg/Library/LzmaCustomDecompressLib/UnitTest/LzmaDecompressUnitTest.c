@@ -0,0 +1,365 @@
+/** @file
+  Unit tests and benchmark of the LzmaCustomDecompressLib decoder.
+
+  Copyright (C) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../LzmaDecompressLibInternal.h"
+
+#define UNIT_TEST_APP_NAME     "LzmaCustomDecompressLib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define LZMA_TEST_DATA_DECODED_SIZE  SIZE_32KB
+
+extern CONST UINT8  mLzmaTestData[];
+extern CONST UINTN  mLzmaTestDataSize;
+
+typedef struct {
+  VOID      *Destination;
+  VOID      *Scratch;
+  UINT32    DestinationSize;
+} LZMA_TEST_CONTEXT;
+
+STATIC LZMA_TEST_CONTEXT  mTestContext;
+
+//
+// Lines of code the test data is made of, so that it compresses like code.
+//
+STATIC CONST CHAR8  *mTestDataLines[] = {
+  "EFI_STATUS  Status;\r\n",
+  "  Status = gBS->LocateProtocol (",
+  "&gEfiPciIoProtocolGuid, NULL, ",
+  "(VOID **)&PciIo);\r\n",
+  "  if (EFI_ERROR (Status)) {\r\n",
+  "    return Status;\r\n",
+  "  }\r\n",
+  "  CopyMem (Buffer, Source, Size);\r\n"
+};
+
+/**
+  Generate the data compressed in mLzmaTestData.
+
+  @param[out] Buffer  The buffer to fill.
+  @param[in]  Size    The size of Buffer in bytes.
+**/
+STATIC
+VOID
+GenerateTestData (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Size
+  )
+{
+  UINT32  Seed;
+  UINTN   Offset;
+  UINTN   Length;
+
+  Seed   = 1;
+  Offset = 0;
+  while (Offset < Size) {
+    Seed   = Seed * 1103515245 + 12345;
+    Length = MIN (AsciiStrLen (mTestDataLines[(Seed >> 16) & 7]), Size - Offset);
+    CopyMem (Buffer + Offset, mTestDataLines[(Seed >> 16) & 7], Length);
+    Offset += Length;
+  }
+}
+
+/**
+  Allocate the destination and scratch buffers of the decoder.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED                   The buffers are allocated.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The test data can not be decoded.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+AllocateBuffers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         ScratchSize;
+
+  Status = LzmaUefiDecompressGetInfo (
+             mLzmaTestData,
+             (UINT32)mLzmaTestDataSize,
+             &mTestContext.DestinationSize,
+             &ScratchSize
+             );
+  if (RETURN_ERROR (Status)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mTestContext.Destination = AllocatePool (mTestContext.DestinationSize);
+  mTestContext.Scratch     = AllocatePool (ScratchSize);
+  if ((mTestContext.Destination == NULL) || (mTestContext.Scratch == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the buffers allocated by AllocateBuffers().
+
+  @param[in]  Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+FreeBuffers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mTestContext.Destination != NULL) {
+    FreePool (mTestContext.Destination);
+  }
+
+  if (mTestContext.Scratch != NULL) {
+    FreePool (mTestContext.Scratch);
+  }
+
+  ZeroMem (&mTestContext, sizeof (mTestContext));
+}
+
+/**
+  LzmaUefiDecompressGetInfo() should return the size in the LZMA header.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GetInfoShouldReturnTheDecodedSize (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  DestinationSize;
+  UINT32  ScratchSize;
+
+  UT_ASSERT_NOT_EFI_ERROR (
+    LzmaUefiDecompressGetInfo (mLzmaTestData, (UINT32)mLzmaTestDataSize, &DestinationSize, &ScratchSize)
+    );
+  UT_ASSERT_EQUAL (DestinationSize, LZMA_TEST_DATA_DECODED_SIZE);
+  UT_ASSERT_NOT_EQUAL (ScratchSize, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  LzmaUefiDecompress() should decode the test data into the destination.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressShouldRestoreTheData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  *Expected;
+
+  Expected = AllocatePool (LZMA_TEST_DATA_DECODED_SIZE);
+  UT_ASSERT_NOT_NULL (Expected);
+  GenerateTestData (Expected, LZMA_TEST_DATA_DECODED_SIZE);
+
+  SetMem (mTestContext.Destination, mTestContext.DestinationSize, 0xAF);
+  UT_ASSERT_NOT_EFI_ERROR (
+    LzmaUefiDecompress (mLzmaTestData, mLzmaTestDataSize, mTestContext.Destination, mTestContext.Scratch)
+    );
+  UT_ASSERT_MEM_EQUAL (mTestContext.Destination, Expected, LZMA_TEST_DATA_DECODED_SIZE);
+
+  FreePool (Expected);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  LzmaUefiDecompress() should reject a truncated stream.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressShouldRejectATruncatedStream (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_STATUS_EQUAL (
+    LzmaUefiDecompress (mLzmaTestData, mLzmaTestDataSize / 2, mTestContext.Destination, mTestContext.Scratch),
+    RETURN_INVALID_PARAMETER
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Decode the test data once.
+
+  @param[in]  Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+DecompressTestData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  LzmaUefiDecompress (mLzmaTestData, mLzmaTestDataSize, mTestContext.Destination, mTestContext.Scratch);
+}
+
+/**
+  Measure the speed of the decoder, in decoded bytes per second and, on
+  IA32 and X64, in decoded bytes per thousand cycles.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED   The decoder was measured.
+  @retval UNIT_TEST_SKIPPED  No performance counter is available.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS            Status;
+  UNIT_TEST_BENCHMARK_RESULT  Result;
+
+ #if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+  UINT64  Index;
+  UINT64  Cycles;
+ #endif
+
+  Status = RunBenchmark ("LzmaUefiDecompress", DecompressTestData, NULL, 0, 0, &Result);
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  UT_ASSERT_NOT_EQUAL (Result.MedianTime, 0);
+  UT_LOG_INFO (
+    "LzmaUefiDecompress: %ld KB/s\n",
+    DivU64x64Remainder (MultU64x32 (mTestContext.DestinationSize, 1000000000 / SIZE_1KB), Result.MedianTime, NULL)
+    );
+
+ #if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+  Cycles = AsmReadTsc ();
+  for (Index = 0; Index < Result.Iterations; Index++) {
+    DecompressTestData (NULL);
+  }
+
+  Cycles = AsmReadTsc () - Cycles;
+  UT_ASSERT_NOT_EQUAL (Cycles, 0);
+  UT_LOG_INFO (
+    "LzmaUefiDecompress: %ld bytes per 1000 cycles\n",
+    DivU64x64Remainder (MultU64x64 (MultU64x32 (mTestContext.DestinationSize, 1000), Result.Iterations), Cycles, NULL)
+    );
+ #endif
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  LzmaCustomDecompressLib decoder, and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DecompressTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the LzmaCustomDecompressLib Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&DecompressTests, Framework, "LzmaCustomDecompressLib Decode Tests", "LzmaCustomDecompressLib.Decode", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DecompressTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (DecompressTests, "GetInfo should return the decoded size", "GetInfo", GetInfoShouldReturnTheDecodedSize, NULL, NULL, NULL);
+  AddTestCase (DecompressTests, "Decompress should restore the data", "Decode", DecompressShouldRestoreTheData, AllocateBuffers, FreeBuffers, NULL);
+  AddTestCase (DecompressTests, "Decompress should reject a truncated stream", "Truncated", DecompressShouldRejectATruncatedStream, AllocateBuffers, FreeBuffers, NULL);
+  AddTestCase (DecompressTests, "Decompress speed", "Benchmark", DecompressBenchmark, AllocateBuffers, FreeBuffers, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,116 @@
+/** @file
+  LZMA compressed test data of the LzmaCustomDecompressLib unit tests.
+
+  It is the output of GenerateTestData() in LzmaDecompressUnitTest.c, compressed
+  in the LZMA "alone" format, the format of LzmaCompress, with a 64 KB dictionary.
+
+  Copyright (C) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+CONST UINT8  mLzmaTestData[] = {
+  0x5d, 0x00, 0x00, 0x01, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x61,
+  0xf0, 0x1a, 0x0a, 0xe2, 0x02, 0x2f, 0x4e, 0xe2, 0xfa, 0x11, 0xd6, 0x4a, 0xa9, 0x8e, 0x17, 0x66,
+  0x27, 0xe3, 0xcc, 0x22, 0xcb, 0xca, 0x27, 0x3e, 0x09, 0x8a, 0x28, 0x66, 0xf5, 0x09, 0x10, 0xdd,
+  0x35, 0x0e, 0x4f, 0xb8, 0x0a, 0xe5, 0x5b, 0x22, 0x9a, 0x91, 0x77, 0xf0, 0x5f, 0x39, 0x4a, 0x48,
+  0xdf, 0x07, 0xbd, 0xdf, 0x0f, 0xa2, 0xb0, 0x25, 0x6e, 0x52, 0xda, 0x13, 0xaf, 0x2b, 0xf8, 0xe8,
+  0x0b, 0xa0, 0x7b, 0x0d, 0x35, 0xb9, 0xfa, 0x1e, 0x5c, 0xe3, 0x62, 0x31, 0x27, 0x99, 0xa5, 0x55,
+  0x97, 0x83, 0x45, 0xa0, 0x11, 0xf7, 0x81, 0xe9, 0xdd, 0xec, 0x2f, 0xa6, 0x73, 0xed, 0x2a, 0xed,
+  0x3c, 0x0c, 0x91, 0xd3, 0x57, 0x7f, 0xb9, 0xa7, 0xc7, 0x3b, 0x4a, 0x7b, 0x90, 0xd4, 0x1d, 0x33,
+  0x49, 0x0d, 0xb8, 0xa5, 0x43, 0xe9, 0xd8, 0x01, 0xa5, 0x84, 0x13, 0x96, 0xe7, 0x52, 0x48, 0x15,
+  0x44, 0x0f, 0x16, 0xa0, 0xaa, 0xad, 0x5d, 0x66, 0x55, 0x91, 0x9d, 0xb5, 0x47, 0x9f, 0xa8, 0x06,
+  0x86, 0x34, 0xe9, 0xa9, 0xd9, 0x3a, 0xac, 0xd4, 0x49, 0xb6, 0x3a, 0x92, 0x1a, 0xd9, 0x34, 0x43,
+  0xcd, 0xb9, 0x32, 0x2a, 0xaf, 0x60, 0xf2, 0xbe, 0x0a, 0xf4, 0x8f, 0x4d, 0xed, 0xee, 0x80, 0xbd,
+  0x0b, 0x62, 0x3b, 0x3c, 0x63, 0xbd, 0x2d, 0xd5, 0x72, 0x81, 0xc0, 0xd8, 0x69, 0x8e, 0x5f, 0x15,
+  0xae, 0x89, 0xd7, 0xae, 0x00, 0x42, 0xac, 0xeb, 0x9e, 0x56, 0xd1, 0x16, 0x3a, 0x37, 0x93, 0x46,
+  0x8c, 0x0d, 0xed, 0x27, 0x41, 0x11, 0x72, 0x33, 0xf3, 0x95, 0x52, 0x09, 0xaf, 0x80, 0x87, 0xe6,
+  0xa7, 0xe1, 0xdd, 0x21, 0xb6, 0x73, 0x1e, 0xac, 0x6a, 0x2b, 0x7a, 0xae, 0x38, 0x5b, 0xd8, 0xb8,
+  0x72, 0x26, 0x49, 0x4c, 0xfc, 0x98, 0x58, 0xa4, 0x72, 0x9e, 0xae, 0x83, 0x3e, 0xc3, 0xab, 0x9a,
+  0x65, 0x67, 0x82, 0x8b, 0xdc, 0xc2, 0xc6, 0x24, 0xd1, 0xf0, 0x56, 0x18, 0x6e, 0xb4, 0x14, 0x91,
+  0x2d, 0xbb, 0x37, 0xa7, 0x95, 0x02, 0x0c, 0x9d, 0xed, 0x69, 0x97, 0xe3, 0xa1, 0x02, 0x63, 0x1c,
+  0xda, 0x23, 0xcd, 0x24, 0x27, 0x48, 0x33, 0x06, 0x9d, 0xdd, 0xb5, 0x6c, 0xe6, 0xc1, 0xcc, 0x72,
+  0x04, 0x6f, 0x18, 0xe8, 0xee, 0xfe, 0x4b, 0x45, 0xd3, 0xe8, 0x03, 0x0c, 0x54, 0x50, 0xf9, 0xe2,
+  0x3e, 0x12, 0x4f, 0x7f, 0x29, 0x2c, 0x24, 0xcb, 0xda, 0x09, 0xe2, 0x11, 0x85, 0x6f, 0xf4, 0x5b,
+  0xcd, 0x6a, 0x99, 0xd3, 0x86, 0xe5, 0x5c, 0x63, 0x32, 0xf1, 0x35, 0xae, 0x8b, 0x54, 0x30, 0x35,
+  0xe1, 0xb6, 0x9c, 0xc6, 0xb7, 0x69, 0xff, 0xb6, 0x5e, 0x31, 0x6e, 0xcf, 0xac, 0x19, 0x02, 0x46,
+  0x4b, 0x45, 0x6e, 0xcd, 0x29, 0x9a, 0x5f, 0x53, 0x19, 0x71, 0x02, 0x23, 0xdf, 0x05, 0x8e, 0x8f,
+  0x53, 0x6a, 0x0b, 0x21, 0x6a, 0x3c, 0x82, 0x59, 0x04, 0xdb, 0xcf, 0x1d, 0x60, 0x55, 0xc1, 0x8c,
+  0x3c, 0x95, 0x04, 0xde, 0x3c, 0x7b, 0xe5, 0x9d, 0x73, 0x9e, 0x6b, 0xa3, 0x45, 0xd6, 0xbd, 0xf9,
+  0xfc, 0x63, 0xab, 0x94, 0x2d, 0x60, 0x6b, 0x1f, 0xe5, 0x7f, 0x79, 0x6e, 0xeb, 0x85, 0x2f, 0xaf,
+  0xfc, 0x2d, 0x17, 0x84, 0xff, 0x1f, 0x66, 0x53, 0xae, 0xb7, 0xa1, 0x24, 0xfa, 0x72, 0x0b, 0x6d,
+  0x02, 0x81, 0x14, 0x20, 0x69, 0xb7, 0xe1, 0x71, 0x31, 0x86, 0x88, 0x54, 0xd5, 0x3b, 0x43, 0xc5,
+  0x51, 0x36, 0xd8, 0x82, 0xb8, 0x83, 0xea, 0xc1, 0x55, 0x62, 0xe0, 0xb6, 0x38, 0x3f, 0xeb, 0xdb,
+  0x2b, 0xab, 0xd0, 0xdb, 0xd9, 0xad, 0x08, 0xfe, 0x04, 0xf1, 0x5a, 0x3d, 0x70, 0x34, 0x75, 0x8a,
+  0xcc, 0x34, 0xa8, 0x6d, 0x4c, 0xf2, 0x6f, 0x01, 0x3c, 0xc0, 0x68, 0x08, 0xa9, 0x28, 0xa7, 0xd7,
+  0x89, 0xef, 0xce, 0xe4, 0x7a, 0x7f, 0x83, 0xe0, 0xb7, 0x2c, 0x0d, 0x86, 0x05, 0x78, 0x59, 0x47,
+  0xbb, 0xdd, 0xf6, 0x0a, 0x1f, 0x41, 0x22, 0x72, 0x66, 0x2e, 0x3b, 0x54, 0xba, 0x05, 0xb4, 0xcd,
+  0x05, 0x06, 0xc8, 0x83, 0xb5, 0x89, 0xdc, 0x72, 0x1d, 0xad, 0x2f, 0x84, 0xf3, 0xc4, 0xef, 0xec,
+  0x4d, 0xc1, 0xd9, 0x2e, 0x0a, 0x06, 0xde, 0x37, 0x7a, 0xa2, 0x8b, 0xc6, 0xb9, 0xbc, 0x21, 0x69,
+  0xd7, 0xc8, 0x06, 0x77, 0xc7, 0xf8, 0x4c, 0x13, 0x8a, 0x63, 0x15, 0xe1, 0xeb, 0x91, 0xfc, 0x57,
+  0xb2, 0xcf, 0x5a, 0x42, 0x0f, 0x6f, 0x4d, 0x24, 0xbb, 0xd4, 0x9b, 0x98, 0x23, 0xfc, 0x7b, 0x3f,
+  0x02, 0x76, 0xb6, 0x3b, 0xa9, 0xff, 0xd3, 0xd0, 0xef, 0x4f, 0xdd, 0x51, 0x8b, 0x68, 0x5f, 0x2d,
+  0xa0, 0x2d, 0x87, 0xcf, 0xcb, 0x11, 0x4e, 0x7f, 0xa9, 0xb6, 0xa7, 0x22, 0x77, 0xa1, 0x7b, 0x21,
+  0x01, 0x5a, 0x12, 0x41, 0x45, 0xc6, 0x94, 0x7d, 0x82, 0xb4, 0x79, 0xf3, 0xf6, 0x06, 0x6a, 0x3d,
+  0x18, 0xaf, 0xba, 0x13, 0x48, 0x44, 0xa1, 0xc6, 0x6b, 0x57, 0xd1, 0xd5, 0x5a, 0xec, 0x72, 0x03,
+  0x69, 0x28, 0xc7, 0x01, 0x99, 0xba, 0x37, 0x1e, 0x16, 0x5b, 0x4d, 0xe4, 0x0b, 0x20, 0xb6, 0xf7,
+  0x9d, 0x94, 0x07, 0x7b, 0xdd, 0x95, 0x0a, 0xa4, 0x86, 0x13, 0x43, 0xc5, 0x37, 0x7f, 0x7a, 0xa7,
+  0x9f, 0xb6, 0x21, 0x25, 0x99, 0x14, 0xa7, 0xb9, 0x1c, 0x69, 0xad, 0x20, 0x5a, 0x94, 0xd6, 0x84,
+  0x98, 0xb1, 0xb3, 0x7b, 0x7d, 0xc9, 0x23, 0xdf, 0xe2, 0x90, 0x65, 0x20, 0x93, 0x40, 0xd3, 0xf7,
+  0x01, 0xa3, 0x7d, 0xfd, 0x47, 0x7d, 0xe6, 0x53, 0x3b, 0x29, 0xbc, 0x69, 0xf0, 0x12, 0x99, 0x90,
+  0xbc, 0xe7, 0xac, 0x0b, 0x30, 0xd1, 0xc4, 0xa6, 0xa7, 0x6f, 0x51, 0xde, 0xb2, 0x9e, 0xd8, 0xb8,
+  0xf5, 0x80, 0x02, 0xc7, 0xbb, 0x6d, 0x63, 0xa8, 0xb1, 0x64, 0xe8, 0x1e, 0xbc, 0x53, 0x87, 0xcf,
+  0x05, 0xb2, 0xb6, 0x8b, 0xa0, 0x6e, 0x45, 0x2f, 0xa2, 0x3e, 0xd6, 0xce, 0xbe, 0x60, 0xd0, 0xd3,
+  0xe9, 0xbd, 0xd7, 0x65, 0xe1, 0x57, 0x53, 0xe4, 0x2c, 0x4c, 0x15, 0xe1, 0x54, 0xce, 0x0b, 0x64,
+  0x97, 0xa0, 0xb3, 0xfb, 0xa5, 0x78, 0xb4, 0x2e, 0x45, 0x02, 0x2f, 0x62, 0xde, 0x3d, 0xcc, 0x6f,
+  0xb3, 0x21, 0x3d, 0xc6, 0xba, 0xad, 0x15, 0xf1, 0xec, 0x61, 0x7a, 0x47, 0x58, 0x12, 0x9c, 0x0e,
+  0xe9, 0xc4, 0xc0, 0x3e, 0x24, 0x81, 0xf5, 0xca, 0x12, 0x45, 0x02, 0xbc, 0x0b, 0x86, 0x1d, 0x1e,
+  0xe6, 0x07, 0xcd, 0x89, 0x89, 0x90, 0x31, 0xe8, 0xb0, 0x94, 0xd6, 0xb6, 0x44, 0x25, 0xcf, 0xb2,
+  0xb7, 0x71, 0x3f, 0x7a, 0x90, 0xa5, 0xa5, 0xf8, 0xfe, 0x50, 0xb3, 0x9d, 0xa6, 0xce, 0x21, 0xe8,
+  0x0a, 0xc0, 0x7f, 0x82, 0x20, 0x7f, 0x84, 0xa8, 0xb0, 0x2f, 0x6c, 0x9c, 0x59, 0xc7, 0xb1, 0xfe,
+  0x7b, 0x64, 0x42, 0x74, 0xdf, 0xce, 0x6d, 0xf4, 0x2a, 0x6b, 0x41, 0xac, 0x99, 0x99, 0x91, 0xf2,
+  0xf5, 0xf4, 0xc0, 0x8b, 0xdf, 0xff, 0xb0, 0x6b, 0xe5, 0x1c, 0x07, 0xd7, 0xa9, 0xb4, 0x67, 0x17,
+  0x98, 0x35, 0x91, 0x33, 0x3a, 0x72, 0x41, 0xff, 0x21, 0xb4, 0x85, 0xbe, 0x58, 0x1e, 0x7b, 0xb6,
+  0x96, 0xd3, 0x18, 0x79, 0x99, 0xac, 0xb8, 0x46, 0x30, 0xf4, 0x9e, 0x8f, 0xa9, 0xd3, 0xf6, 0xd8,
+  0xe3, 0xd0, 0x22, 0x75, 0x42, 0xe1, 0xee, 0xbf, 0x5a, 0xc0, 0xad, 0xc7, 0x9f, 0xb3, 0x1d, 0x41,
+  0xd1, 0x37, 0x07, 0x9b, 0xb9, 0xe0, 0x95, 0x75, 0x55, 0x60, 0xfd, 0x6b, 0x78, 0x1e, 0xd4, 0xa6,
+  0xe8, 0xc5, 0xdf, 0xa0, 0xa6, 0xe4, 0x94, 0xa0, 0x9e, 0xd4, 0xbc, 0xa4, 0xc5, 0xda, 0xdb, 0x98,
+  0xa6, 0x0c, 0xbf, 0x60, 0x5a, 0xef, 0xb2, 0xec, 0x12, 0xcd, 0xf6, 0x7f, 0xe1, 0xfe, 0x62, 0x3a,
+  0xef, 0x52, 0x93, 0x04, 0x9f, 0x45, 0x8c, 0xcc, 0xea, 0x4f, 0xfe, 0xd0, 0x90, 0x61, 0xb3, 0xef,
+  0x74, 0x1e, 0xaa, 0xd9, 0x1c, 0x7d, 0x7e, 0xf7, 0x05, 0x16, 0x59, 0x93, 0x4b, 0x75, 0xb3, 0x9e,
+  0x1c, 0x91, 0x7f, 0xd5, 0x97, 0xa6, 0xcd, 0x53, 0x09, 0x08, 0x7b, 0x92, 0xfa, 0x80, 0xfd, 0xe2,
+  0x45, 0x37, 0x0f, 0xdd, 0x63, 0xcd, 0xf6, 0x62, 0xaa, 0x87, 0x33, 0xa8, 0x40, 0x88, 0x3b, 0x3a,
+  0xfa, 0xa3, 0x6a, 0x19, 0x57, 0x38, 0xd4, 0x2f, 0xb9, 0x9d, 0x38, 0xc2, 0x73, 0x3b, 0xcd, 0x34,
+  0x09, 0x52, 0xf2, 0xec, 0x85, 0x69, 0x9d, 0x84, 0x40, 0x0b, 0xe3, 0xae, 0x6f, 0x0a, 0xdb, 0xfb,
+  0x7f, 0x3c, 0xd2, 0x6b, 0x37, 0x74, 0x8a, 0x1b, 0x53, 0x22, 0x47, 0xa6, 0x49, 0x34, 0xd0, 0x4b,
+  0xf9, 0xa0, 0x16, 0x5f, 0xa1, 0x97, 0x23, 0xee, 0x09, 0x09, 0x18, 0xbb, 0xa5, 0xc8, 0x7d, 0x93,
+  0xe5, 0xce, 0x8f, 0x2a, 0x55, 0x65, 0xcb, 0x2e, 0xfb, 0xe7, 0x91, 0x38, 0xcc, 0xa2, 0x9a, 0x07,
+  0x2f, 0xbe, 0x42, 0x5c, 0x49, 0xfd, 0x1d, 0x79, 0x6c, 0x46, 0xa0, 0x8f, 0x55, 0x2a, 0x7e, 0xec,
+  0x29, 0xf6, 0x1d, 0x23, 0x8b, 0x38, 0xa6, 0x1a, 0xea, 0xaa, 0xb1, 0x82, 0x06, 0x3a, 0x7f, 0x91,
+  0x51, 0xa2, 0xd8, 0x71, 0x53, 0x4a, 0x82, 0x37, 0xb2, 0xd8, 0x11, 0xcf, 0x77, 0x06, 0xdf, 0xc9,
+  0x9a, 0xb8, 0xba, 0x51, 0x97, 0x4b, 0xb1, 0x0f, 0x63, 0x67, 0x8e, 0xaf, 0xd6, 0xfe, 0x26, 0x9c,
+  0x06, 0xa1, 0x61, 0x75, 0xfe, 0xc7, 0x16, 0xa4, 0xc7, 0x98, 0x25, 0x69, 0x8b, 0xcb, 0x79, 0x2f,
+  0x98, 0xe1, 0xad, 0xaf, 0x5c, 0x38, 0x79, 0xea, 0x57, 0x7f, 0x2d, 0x0d, 0x76, 0xa5, 0x9f, 0x40,
+  0xd3, 0xbe, 0xcc, 0x44, 0x13, 0x06, 0x7b, 0x39, 0x2d, 0xa9, 0x61, 0x80, 0xe4, 0xd3, 0x33, 0x27,
+  0x15, 0xbc, 0x8a, 0xe1, 0x5f, 0x05, 0xce, 0x78, 0xab, 0x77, 0x5b, 0xc8, 0xd3, 0xb2, 0x42, 0xfa,
+  0xb6, 0xe1, 0x02, 0xca, 0x82, 0xa1, 0xa9, 0xa7, 0xe8, 0xa6, 0x96, 0xe4, 0x06, 0xfd, 0x17, 0x1c,
+  0x4d, 0x7f, 0x75, 0xf4, 0xdc, 0xa8, 0xbf, 0xca, 0x01, 0xb8, 0x4d, 0x65, 0x1e, 0xbf, 0xbd, 0xeb,
+  0x28, 0x05, 0x31, 0x9a, 0xac, 0xa1, 0x3f, 0xc2, 0x64, 0xe2, 0x11, 0x65, 0x29, 0x48, 0x27, 0xee,
+  0xb0, 0x83, 0x0e, 0x04, 0x99, 0x6a, 0x51, 0xa8, 0xf3, 0x7d, 0xa5, 0x12, 0x28, 0x2a, 0xb2, 0x29,
+  0xac, 0xe3, 0xc3, 0x13, 0x06, 0x3d, 0x3e, 0x73, 0xc2, 0x5f, 0xbc, 0x44, 0x2b, 0x23, 0x8c, 0x43,
+  0x22, 0x82, 0x1b, 0x2a, 0xc8, 0xf6, 0xed, 0x88, 0x20, 0x5a, 0x48, 0x0d, 0x66, 0x6f, 0x91, 0xe1,
+  0x68, 0xe2, 0xba, 0x0b, 0x25, 0xcf, 0x05, 0xf7, 0xb0, 0x79, 0x77, 0xb1, 0xb7, 0xa8, 0x5f, 0x06,
+  0xec, 0x36, 0xc8, 0x04, 0x63, 0x0f, 0xdb, 0x4c, 0x22, 0x1c, 0x51, 0xa1, 0x3e, 0x21, 0x51, 0xfd,
+  0x89, 0x28, 0xdf, 0x47, 0x26, 0x59, 0x4c, 0xa6, 0x26, 0x82, 0x6c, 0x0e, 0x52, 0x89, 0x34, 0xc5,
+  0xae, 0x4a, 0xb4, 0x8c, 0xd4, 0x94, 0x8d, 0xe8, 0xf1, 0x63, 0xbf, 0x89, 0xa5, 0xe3, 0xfb, 0x4b,
+  0x9b, 0xf4, 0xea, 0x40, 0xbb, 0xdc, 0x88, 0x3d, 0x75, 0xc0, 0x68, 0x2d, 0xd3, 0xe9, 0x27, 0xb0,
+  0xa8, 0xb4, 0x65, 0x5c, 0xe7, 0x9e, 0x25, 0x05, 0x83, 0xe4, 0x50, 0xfa, 0x94, 0xfa, 0xa0, 0xa3,
+  0x69, 0x17, 0xeb, 0xa5, 0xe8, 0x41, 0x0f, 0xa6, 0xba, 0x2a, 0x1f, 0x31, 0x91, 0x0f, 0xd7, 0x3a,
+  0x2a, 0x85, 0x30, 0x9c, 0x02, 0x02, 0xf9, 0x48, 0x78, 0xf8, 0xeb, 0xb1, 0x6b, 0xd8, 0x8e, 0x32,
+  0xec, 0x5a, 0x51, 0x41, 0x09, 0xe0, 0x7e, 0xae, 0x38, 0xaf, 0x3c, 0x0c, 0x5b, 0x70, 0x41, 0xc8,
+  0x8b, 0x52, 0x80, 0x62, 0x44, 0x38, 0x37, 0xff, 0xc3, 0x55, 0x7b, 0x70
+};
+
+CONST UINTN  mLzmaTestDataSize = sizeof (mLzmaTestData);
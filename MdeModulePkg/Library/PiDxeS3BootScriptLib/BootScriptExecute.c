@@ -1585,6 +1585,311 @@ BootScriptPciCfg2Poll (
 
 }
 
+// MU_CHANGE [BEGIN] - Execute consecutive write nodes without re-dispatch.
+/**
+  Perform a single naturally aligned memory or PCI configuration write.
+
+  @param[in]  OpCode   EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE, EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE
+                       or EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE.
+  @param[in]  Width    Width of the operation, S3BootScriptWidthUint8 to S3BootScriptWidthUint64.
+  @param[in]  Segment  Pci segment number, 0 for memory and PCI configuration writes.
+  @param[in]  Address  Address of the operation.
+  @param[in]  Buffer   Pointer to the data to write, which may be unaligned.
+
+  @retval EFI_SUCCESS            The write succeed.
+  @retval EFI_INVALID_PARAMETER  The width is not supported for this operation.
+**/
+EFI_STATUS
+ScriptSingleWrite (
+  IN UINT16                    OpCode,
+  IN S3_BOOT_SCRIPT_LIB_WIDTH  Width,
+  IN UINT16                    Segment,
+  IN UINT64                    Address,
+  IN UINT8                     *Buffer
+  )
+{
+  UINT64  PciAddress;
+
+  if (OpCode == EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE) {
+    switch (Width) {
+      case S3BootScriptWidthUint8:
+        MmioWrite8 ((UINTN) Address, *Buffer);
+        break;
+      case S3BootScriptWidthUint16:
+        MmioWrite16 ((UINTN) Address, ReadUnaligned16 ((UINT16 *) Buffer));
+        break;
+      case S3BootScriptWidthUint32:
+        MmioWrite32 ((UINTN) Address, ReadUnaligned32 ((UINT32 *) Buffer));
+        break;
+      default:
+        MmioWrite64 ((UINTN) Address, ReadUnaligned64 ((UINT64 *) Buffer));
+        break;
+    }
+    return EFI_SUCCESS;
+  }
+
+  PciAddress = PCI_ADDRESS_ENCODE (Segment, Address);
+  switch (Width) {
+    case S3BootScriptWidthUint8:
+      PciSegmentWrite8 (PciAddress, *Buffer);
+      break;
+    case S3BootScriptWidthUint16:
+      PciSegmentWrite16 (PciAddress, ReadUnaligned16 ((UINT16 *) Buffer));
+      break;
+    case S3BootScriptWidthUint32:
+      PciSegmentWrite32 (PciAddress, ReadUnaligned32 ((UINT32 *) Buffer));
+      break;
+    default:
+      return EFI_INVALID_PARAMETER;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Interprete a run of consecutive boot script nodes with the same
+  EFI_BOOT_SCRIPT_MEM_WRITE, EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE or
+  EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE OP code.
+
+  Most of a boot script is made of such runs, and most of their nodes write a
+  single value. Those nodes are written directly, without going back to the
+  opcode dispatch and the width decoding loop of every node. The accesses are
+  never merged, as the order and width of device register accesses matter.
+
+  @param[in]   Script     The pointer of the first node of the run.
+  @param[in]   ScriptEnd  The end address of the boot script table.
+  @param[out]  RunLength  The length of the nodes of the run.
+
+  @retval EFI_SUCCESS  The nodes were executed successfully.
+  @return Others       The status of the node that failed.
+**/
+EFI_STATUS
+BootScriptExecuteWriteRun (
+  IN  UINT8  *Script,
+  IN  UINTN  ScriptEnd,
+  OUT UINTN  *RunLength
+  )
+{
+  EFI_STATUS                         Status;
+  EFI_BOOT_SCRIPT_GENERIC_HEADER     ScriptHeader;
+  EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE  WriteNode;
+  UINT8                              *Node;
+  UINT16                             OpCode;
+  UINTN                              NodeSize;
+  UINTN                              Count;
+
+  CopyMem ((VOID*)&ScriptHeader, Script, sizeof (EFI_BOOT_SCRIPT_GENERIC_HEADER));
+  OpCode = ScriptHeader.OpCode;
+
+  //
+  // The write nodes share the same layout, the PCI configuration 2 write node
+  // just has an additional Segment.
+  //
+  WriteNode.Segment = 0;
+  if (OpCode == EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE) {
+    NodeSize = sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE);
+  } else {
+    NodeSize = sizeof (EFI_BOOT_SCRIPT_MEM_WRITE);
+  }
+
+  Count = 0;
+  Node  = Script;
+  do {
+    CopyMem ((VOID*)&WriteNode, Node, NodeSize);
+    if ((WriteNode.Count == 1) &&
+        (WriteNode.Width <= S3BootScriptWidthUint64) &&
+        ((WriteNode.Address & ((1 << WriteNode.Width) - 1)) == 0)) {
+      Status = ScriptSingleWrite (
+                 OpCode,
+                 (S3_BOOT_SCRIPT_LIB_WIDTH) WriteNode.Width,
+                 WriteNode.Segment,
+                 WriteNode.Address,
+                 Node + NodeSize
+                 );
+    } else if (OpCode == EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE) {
+      Status = BootScriptExecuteMemoryWrite (Node);
+    } else if (OpCode == EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE) {
+      Status = BootScriptExecutePciCfgWrite (Node);
+    } else {
+      Status = BootScriptExecutePciCfg2Write (Node);
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_INFO, "BootScriptExecuteWriteRun - node 0x%08x failed\n", (UINTN) Node));
+      return Status;
+    }
+
+    Count++;
+    Node = Node + WriteNode.Length;
+    if ((UINTN) Node + sizeof (EFI_BOOT_SCRIPT_GENERIC_HEADER) > ScriptEnd) {
+      break;
+    }
+    CopyMem ((VOID*)&ScriptHeader, Node, sizeof (EFI_BOOT_SCRIPT_GENERIC_HEADER));
+  } while (ScriptHeader.OpCode == OpCode);
+
+  DEBUG ((EFI_D_INFO, "BootScriptExecuteWriteRun - 0x%04x, %d node(s)\n", (UINTN) OpCode, Count));
+  *RunLength = (UINTN) (Node - Script);
+  return EFI_SUCCESS;
+}
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Validate the boot script table when it is locked.
+/**
+  Get the size of the fixed part of a boot script node.
+
+  @param[in]  OpCode  The opcode of the node.
+
+  @return The size of the fixed part of the node, or 0 if the opcode is unknown.
+**/
+UINTN
+BootScriptGetNodeFixedSize (
+  IN UINT16  OpCode
+  )
+{
+  switch (OpCode) {
+  case EFI_BOOT_SCRIPT_IO_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_IO_WRITE);
+  case EFI_BOOT_SCRIPT_IO_READ_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_IO_READ_WRITE);
+  case EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_MEM_WRITE);
+  case EFI_BOOT_SCRIPT_MEM_READ_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_MEM_READ_WRITE);
+  case EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE);
+  case EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE);
+  case EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE);
+  case EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE);
+  case EFI_BOOT_SCRIPT_SMBUS_EXECUTE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_SMBUS_EXECUTE);
+  case EFI_BOOT_SCRIPT_STALL_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_STALL);
+  case EFI_BOOT_SCRIPT_DISPATCH_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_DISPATCH);
+  case EFI_BOOT_SCRIPT_DISPATCH_2_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_DISPATCH_2);
+  case EFI_BOOT_SCRIPT_MEM_POLL_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_MEM_POLL);
+  case EFI_BOOT_SCRIPT_IO_POLL_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_IO_POLL);
+  case EFI_BOOT_SCRIPT_PCI_CONFIG_POLL_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG_POLL);
+  case EFI_BOOT_SCRIPT_PCI_CONFIG2_POLL_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_POLL);
+  case EFI_BOOT_SCRIPT_INFORMATION_OPCODE:
+  case S3_BOOT_SCRIPT_LIB_LABEL_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_INFORMATION);
+  case S3_BOOT_SCRIPT_LIB_TERMINATE_OPCODE:
+    return sizeof (EFI_BOOT_SCRIPT_TERMINATE);
+  default:
+    return 0;
+  }
+}
+
+/**
+  Validate the nodes of a closed boot script table.
+
+  Every node must have a known opcode and lie within the table. The nodes
+  carrying data must have a valid width, and a length that covers their data.
+
+  @param[in]  TableBase  The base address of the boot script table.
+
+  @retval EFI_SUCCESS            All the nodes of the table are well formed.
+  @retval EFI_UNSUPPORTED        The table header or a node has an unknown opcode.
+  @retval EFI_INVALID_PARAMETER  A node has an invalid width or length.
+**/
+EFI_STATUS
+S3BootScriptInternalValidateTable (
+  IN UINT8  *TableBase
+  )
+{
+  EFI_BOOT_SCRIPT_TABLE_HEADER   TableHeader;
+  EFI_BOOT_SCRIPT_COMMON_HEADER  ScriptHeader;
+  EFI_BOOT_SCRIPT_MEM_WRITE      WriteNode;
+  EFI_BOOT_SCRIPT_INFORMATION    Information;
+  UINT8                          *Script;
+  UINTN                          TableEnd;
+  UINTN                          FixedSize;
+  UINTN                          DataSize;
+
+  if (TableBase == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem ((VOID*)&TableHeader, TableBase, sizeof (EFI_BOOT_SCRIPT_TABLE_HEADER));
+  if (TableHeader.OpCode != S3_BOOT_SCRIPT_LIB_TABLE_OPCODE) {
+    return EFI_UNSUPPORTED;
+  }
+
+  TableEnd = (UINTN) TableBase + TableHeader.TableLength;
+  Script   = TableBase + TableHeader.Length;
+  while ((UINTN) Script + sizeof (EFI_BOOT_SCRIPT_GENERIC_HEADER) <= TableEnd) {
+    CopyMem ((VOID*)&ScriptHeader, Script, sizeof (EFI_BOOT_SCRIPT_GENERIC_HEADER));
+    FixedSize = BootScriptGetNodeFixedSize (ScriptHeader.OpCode);
+    if (FixedSize == 0) {
+      DEBUG ((DEBUG_ERROR, "Boot script node 0x%08x has unknown opcode 0x%04x\n", (UINTN) Script, (UINTN) ScriptHeader.OpCode));
+      return EFI_UNSUPPORTED;
+    }
+    if ((ScriptHeader.Length < FixedSize) || ((UINTN) Script + ScriptHeader.Length > TableEnd)) {
+      DEBUG ((DEBUG_ERROR, "Boot script node 0x%08x has invalid length 0x%02x\n", (UINTN) Script, (UINTN) ScriptHeader.Length));
+      return EFI_INVALID_PARAMETER;
+    }
+    if (ScriptHeader.OpCode == S3_BOOT_SCRIPT_LIB_TERMINATE_OPCODE) {
+      return EFI_SUCCESS;
+    }
+
+    CopyMem ((VOID*)&ScriptHeader, Script, sizeof (EFI_BOOT_SCRIPT_COMMON_HEADER));
+    switch (ScriptHeader.OpCode) {
+    case EFI_BOOT_SCRIPT_IO_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE:
+      CopyMem ((VOID*)&WriteNode, Script, sizeof (EFI_BOOT_SCRIPT_MEM_WRITE));
+      DataSize = (UINTN) WriteNode.Count << (WriteNode.Width & 0x03);
+      break;
+
+    case EFI_BOOT_SCRIPT_IO_READ_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_MEM_READ_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_MEM_POLL_OPCODE:
+    case EFI_BOOT_SCRIPT_IO_POLL_OPCODE:
+    case EFI_BOOT_SCRIPT_PCI_CONFIG_POLL_OPCODE:
+    case EFI_BOOT_SCRIPT_PCI_CONFIG2_POLL_OPCODE:
+      //
+      // Data and mask.
+      //
+      DataSize = (UINTN) 2 << (ScriptHeader.Width & 0x03);
+      break;
+
+    case EFI_BOOT_SCRIPT_INFORMATION_OPCODE:
+    case S3_BOOT_SCRIPT_LIB_LABEL_OPCODE:
+      CopyMem ((VOID*)&Information, Script, sizeof (EFI_BOOT_SCRIPT_INFORMATION));
+      DataSize = Information.InformationLength;
+      ScriptHeader.Width = S3BootScriptWidthUint8;
+      break;
+
+    default:
+      DataSize = 0;
+      ScriptHeader.Width = S3BootScriptWidthUint8;
+      break;
+    }
+
+    if ((ScriptHeader.Width >= S3BootScriptWidthMaximum) ||
+        (DataSize > (UINTN) ScriptHeader.Length - FixedSize)) {
+      DEBUG ((DEBUG_ERROR, "Boot script node 0x%08x has invalid width or data\n", (UINTN) Script));
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Script = Script + ScriptHeader.Length;
+  }
+
+  return EFI_SUCCESS;
+}
+// MU_CHANGE [END]
+
 /**
   Executes the S3 boot script table.
 
@@ -1602,6 +1907,7 @@ S3BootScriptExecute (
   UINT8*                Script;
   UINTN                 StartAddress;
   UINT32                TableLength;
+  UINTN                 RunLength;    // MU_CHANGE - Execute consecutive write nodes without re-dispatch.
   UINT64                AndMask;
   UINT64                OrMask;
   EFI_BOOT_SCRIPT_COMMON_HEADER  ScriptHeader;
@@ -1636,10 +1942,18 @@ S3BootScriptExecute (
     CopyMem ((VOID*)&ScriptHeader, Script, sizeof(EFI_BOOT_SCRIPT_COMMON_HEADER));
     switch (ScriptHeader.OpCode) {
 
+    // MU_CHANGE [BEGIN] - Execute consecutive write nodes without re-dispatch.
     case EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE:
-      DEBUG ((EFI_D_INFO, "EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE\n"));
-      Status = BootScriptExecuteMemoryWrite (Script);
-      break;
+    case EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE:
+    case EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE:
+      Status = BootScriptExecuteWriteRun (Script, StartAddress + TableLength, &RunLength);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((EFI_D_INFO, "S3BootScriptDone - %r\n", Status));
+        return Status;
+      }
+      Script = Script + RunLength;
+      continue;
+    // MU_CHANGE [END]
 
     case EFI_BOOT_SCRIPT_MEM_READ_WRITE_OPCODE:
       DEBUG ((EFI_D_INFO, "EFI_BOOT_SCRIPT_MEM_READ_WRITE_OPCODE\n"));
@@ -1656,11 +1970,6 @@ S3BootScriptExecute (
       Status = BootScriptExecuteIoWrite (Script);
       break;
 
-    case EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE:
-      DEBUG ((EFI_D_INFO, "EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE\n"));
-      Status = BootScriptExecutePciCfgWrite (Script);
-      break;
-
     case EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE_OPCODE:
       DEBUG ((EFI_D_INFO, "EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE_OPCODE\n"));
       CheckAndOrMask (&ScriptHeader, &AndMask, &OrMask, Script);
@@ -1670,11 +1979,6 @@ S3BootScriptExecute (
                  OrMask
                  );
       break;
-    case EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE:
-      DEBUG ((EFI_D_INFO, "EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE\n"));
-      Status = BootScriptExecutePciCfg2Write (Script);
-      break;
-
     case EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE_OPCODE:
       DEBUG ((EFI_D_INFO, "EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE_OPCODE\n"));
       CheckAndOrMask (&ScriptHeader, &AndMask, &OrMask, Script);
@@ -254,6 +254,18 @@ S3BootScriptEventCallBack (
     S3BootScriptInternalCloseTable ();
     mS3BootScriptTablePtr->SmmLocked = TRUE;
 
+    // MU_CHANGE [BEGIN] - Validate the boot script table when it is locked.
+    //
+    // Report a malformed node in the boot that recorded it, rather than on
+    // S3 resume where the executor relies on the nodes being well formed.
+    //
+    Status = S3BootScriptInternalValidateTable (mS3BootScriptTablePtr->TableBase);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: Boot script table is invalid - %r\n", __FUNCTION__, Status));
+      ASSERT_EFI_ERROR (Status);
+    }
+    // MU_CHANGE [END]
+
     //
     // Save BootScript data to lockbox
     //
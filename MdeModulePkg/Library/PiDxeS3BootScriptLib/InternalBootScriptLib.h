@@ -86,6 +86,22 @@ EFI_STATUS
 
 extern SCRIPT_TABLE_PRIVATE_DATA       *mS3BootScriptTablePtr;
 
+// MU_CHANGE [BEGIN] - Validate the boot script table when it is locked.
+/**
+  Validate the nodes of a closed boot script table.
+
+  @param[in]  TableBase  The base address of the boot script table.
+
+  @retval EFI_SUCCESS            All the nodes of the table are well formed.
+  @retval EFI_UNSUPPORTED        The table header or a node has an unknown opcode.
+  @retval EFI_INVALID_PARAMETER  A node has an invalid width or length.
+**/
+EFI_STATUS
+S3BootScriptInternalValidateTable (
+  IN UINT8  *TableBase
+  );
+// MU_CHANGE [END]
+
 //
 // Define Opcode for Label which is implementation specific and no standard spec define.
 //
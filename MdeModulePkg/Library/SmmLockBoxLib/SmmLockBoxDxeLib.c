@@ -536,3 +536,47 @@ RestoreAllLockBoxInPlace (
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Restore several LockBoxes at once.
+/**
+  This function will restore confidential information from several lockboxes.
+
+  @param Entries  the lockboxes to restore, the status of each one is returned in its entry
+  @param Count    the number of entries
+
+  @retval RETURN_SUCCESS            all the lockboxes are restored successfully.
+  @retval RETURN_INVALID_PARAMETER  Entries is NULL and Count is not 0, or the Guid of an entry is NULL.
+  @return others                    the status of the first entry that failed to restore.
+**/
+RETURN_STATUS
+EFIAPI
+RestoreMultipleLockBox (
+  IN OUT LOCK_BOX_RESTORE_ENTRY   *Entries,
+  IN     UINTN                    Count
+  )
+{
+  RETURN_STATUS  Status;
+  UINTN          Index;
+
+  if ((Entries == NULL) && (Count != 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The SMM communication buffer of DXE is sized for one LockBox, and DXE
+  // restores few of them, so restore them one at a time.
+  //
+  Status = RETURN_SUCCESS;
+  for (Index = 0; Index < Count; Index++) {
+    if (Entries[Index].Buffer == NULL) {
+      Entries[Index].Status = RestoreLockBox (Entries[Index].Guid, NULL, NULL);
+    } else {
+      Entries[Index].Status = RestoreLockBox (Entries[Index].Guid, Entries[Index].Buffer, &Entries[Index].Length);
+    }
+    if (RETURN_ERROR (Entries[Index].Status) && !RETURN_ERROR (Status)) {
+      Status = Entries[Index].Status;
+    }
+  }
+
+  return Status;
+}
+// MU_CHANGE [END]
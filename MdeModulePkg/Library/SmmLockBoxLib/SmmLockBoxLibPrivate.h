@@ -23,6 +23,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct {
   UINT64                   Signature;
   EFI_PHYSICAL_ADDRESS     LockBoxDataAddress;
+  // MU_CHANGE [BEGIN] - Index the LockBoxes by GUID.
+  EFI_PHYSICAL_ADDRESS     LockBoxHashTableAddress;
+  // MU_CHANGE [END]
 } SMM_LOCK_BOX_CONTEXT;
 
 //
@@ -39,9 +42,27 @@ typedef struct {
   UINT64                         Attributes;
   EFI_PHYSICAL_ADDRESS           SmramBuffer;
   LIST_ENTRY                     Link;
+  // MU_CHANGE [BEGIN] - Index the LockBoxes by GUID.
+  LIST_ENTRY                     HashLink;
+  // MU_CHANGE [END]
 } SMM_LOCK_BOX_DATA;
 
 #pragma pack()
 
+// MU_CHANGE [BEGIN] - Index the LockBoxes by GUID.
+//
+// The number of buckets of the LockBox hash table, a power of 2.
+//
+#define SMM_LOCK_BOX_HASH_TABLE_SIZE  64
+// MU_CHANGE [END]
+
+// MU_CHANGE [BEGIN] - Restore several LockBoxes in one SMM communication.
+//
+// The maximum number of LockBoxes restored by one SMM communication, which
+// bounds the size of the communication buffer on the stack.
+//
+#define SMM_LOCK_BOX_RESTORE_MULTIPLE_MAX_COUNT  16
+// MU_CHANGE [END]
+
 #endif
 
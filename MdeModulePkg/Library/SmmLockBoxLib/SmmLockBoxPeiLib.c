@@ -740,3 +740,179 @@ RestoreAllLockBoxInPlace (
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Restore several LockBoxes in one SMM communication.
+/**
+  This function will restore confidential information from several lockboxes,
+  one at a time.
+
+  @param Entries  the lockboxes to restore, the status of each one is returned in its entry
+  @param Count    the number of entries
+
+  @retval RETURN_SUCCESS  all the lockboxes are restored successfully.
+  @return others          the status of the first entry that failed to restore.
+**/
+RETURN_STATUS
+InternalRestoreLockBoxOneByOne (
+  IN OUT LOCK_BOX_RESTORE_ENTRY   *Entries,
+  IN     UINTN                    Count
+  )
+{
+  RETURN_STATUS  Status;
+  UINTN          Index;
+
+  Status = RETURN_SUCCESS;
+  for (Index = 0; Index < Count; Index++) {
+    if (Entries[Index].Buffer == NULL) {
+      Entries[Index].Status = RestoreLockBox (Entries[Index].Guid, NULL, NULL);
+    } else {
+      Entries[Index].Status = RestoreLockBox (Entries[Index].Guid, Entries[Index].Buffer, &Entries[Index].Length);
+    }
+    if (RETURN_ERROR (Entries[Index].Status) && !RETURN_ERROR (Status)) {
+      Status = Entries[Index].Status;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  This function will restore confidential information from several lockboxes.
+
+  Up to SMM_LOCK_BOX_RESTORE_MULTIPLE_MAX_COUNT lockboxes are restored by each
+  SMM communication, instead of one.
+
+  @param Entries  the lockboxes to restore, the status of each one is returned in its entry
+  @param Count    the number of entries
+
+  @retval RETURN_SUCCESS            all the lockboxes are restored successfully.
+  @retval RETURN_INVALID_PARAMETER  Entries is NULL and Count is not 0, or the Guid of an entry is NULL.
+  @return others                    the status of the first entry that failed to restore.
+**/
+RETURN_STATUS
+EFIAPI
+RestoreMultipleLockBox (
+  IN OUT LOCK_BOX_RESTORE_ENTRY   *Entries,
+  IN     UINTN                    Count
+  )
+{
+  EFI_STATUS                                  Status;
+  EFI_STATUS                                  FirstStatus;
+  EFI_PEI_SMM_COMMUNICATION_PPI               *SmmCommunicationPpi;
+  EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE *LockBoxParameterRestoreMultiple;
+  EFI_SMM_LOCK_BOX_RESTORE_ENTRY              *LockBoxEntry;
+  EFI_SMM_COMMUNICATE_HEADER                  *CommHeader;
+  UINT8                                       CommBuffer[sizeof(EFI_GUID) + sizeof(UINT64) + sizeof(EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE) +
+                                                         SMM_LOCK_BOX_RESTORE_MULTIPLE_MAX_COUNT * sizeof(EFI_SMM_LOCK_BOX_RESTORE_ENTRY)];
+  UINTN                                       CommSize;
+  UINT64                                      MessageLength;
+  UINTN                                       Start;
+  UINTN                                       BatchCount;
+  UINTN                                       Index;
+
+  DEBUG ((DEBUG_INFO, "SmmLockBoxPeiLib RestoreMultipleLockBox - Enter\n"));
+
+  //
+  // Basic check
+  //
+  if ((Entries == NULL) && (Count != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+  for (Index = 0; Index < Count; Index++) {
+    if (Entries[Index].Guid == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  //
+  // Get needed resource
+  //
+  Status = PeiServicesLocatePpi (
+             &gEfiPeiSmmCommunicationPpiGuid,
+             0,
+             NULL,
+             (VOID **)&SmmCommunicationPpi
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "SmmLockBoxPeiLib LocatePpi - (%r)\n", Status));
+    Status = InternalRestoreLockBoxOneByOne (Entries, Count);
+    DEBUG ((DEBUG_INFO, "SmmLockBoxPeiLib RestoreMultipleLockBox - Exit (%r)\n", Status));
+    return Status;
+  }
+
+  FirstStatus = EFI_SUCCESS;
+  for (Start = 0; Start < Count; Start += BatchCount) {
+    BatchCount = MIN (Count - Start, SMM_LOCK_BOX_RESTORE_MULTIPLE_MAX_COUNT);
+
+    //
+    // Prepare parameter
+    //
+    CommHeader = (EFI_SMM_COMMUNICATE_HEADER *)&CommBuffer[0];
+    CopyMem (&CommHeader->HeaderGuid, &gEfiSmmLockBoxCommunicationGuid, sizeof(gEfiSmmLockBoxCommunicationGuid));
+    MessageLength = sizeof(*LockBoxParameterRestoreMultiple) + BatchCount * sizeof(*LockBoxEntry);
+    if ((sizeof(UINTN) == sizeof(UINT32)) && (FeaturePcdGet (PcdDxeIplSwitchToLongMode)) ) {
+      CopyMem (&CommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, MessageLength)], &MessageLength, sizeof(MessageLength));
+      LockBoxParameterRestoreMultiple = (EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE *)&CommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, MessageLength) + sizeof(UINT64)];
+    } else {
+      CommHeader->MessageLength = (UINTN)MessageLength;
+      LockBoxParameterRestoreMultiple = (EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE *)&CommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, MessageLength) + sizeof(UINTN)];
+    }
+    LockBoxParameterRestoreMultiple->Header.Command      = EFI_SMM_LOCK_BOX_COMMAND_RESTORE_MULTIPLE;
+    LockBoxParameterRestoreMultiple->Header.DataLength   = (UINT32)MessageLength;
+    LockBoxParameterRestoreMultiple->Header.ReturnStatus = (UINT64)-1;
+    LockBoxParameterRestoreMultiple->Count               = BatchCount;
+
+    LockBoxEntry = (EFI_SMM_LOCK_BOX_RESTORE_ENTRY *)(LockBoxParameterRestoreMultiple + 1);
+    for (Index = 0; Index < BatchCount; Index++) {
+      CopyMem (&LockBoxEntry[Index].Guid, Entries[Start + Index].Guid, sizeof(EFI_GUID));
+      LockBoxEntry[Index].Buffer       = (EFI_PHYSICAL_ADDRESS)(UINTN)Entries[Start + Index].Buffer;
+      LockBoxEntry[Index].Length       = (Entries[Start + Index].Buffer == NULL) ? 0 : (UINT64)Entries[Start + Index].Length;
+      LockBoxEntry[Index].ReturnStatus = (UINT64)-1;
+    }
+
+    //
+    // Send command
+    //
+    CommSize = sizeof(CommBuffer);
+    Status = SmmCommunicationPpi->Communicate (
+                                    SmmCommunicationPpi,
+                                    &CommBuffer[0],
+                                    &CommSize
+                                    );
+    if ((Status == EFI_NOT_STARTED) || (LockBoxParameterRestoreMultiple->Header.ReturnStatus == (UINT64)-1)) {
+      //
+      // Pei SMM communication not ready yet, or the SMM LockBox driver does not
+      // support this command, so we restore the LockBoxes one at a time.
+      //
+      DEBUG ((DEBUG_INFO, "SmmLockBoxPeiLib Communicate - (%r)\n", Status));
+      Status = InternalRestoreLockBoxOneByOne (&Entries[Start], BatchCount);
+      if (EFI_ERROR (Status) && !EFI_ERROR (FirstStatus)) {
+        FirstStatus = Status;
+      }
+      continue;
+    }
+
+    for (Index = 0; Index < BatchCount; Index++) {
+      Status = (EFI_STATUS)LockBoxEntry[Index].ReturnStatus;
+      if (Status != EFI_SUCCESS) {
+        // Need or MAX_BIT, because there might be case that SMM is X64 while PEI is IA32.
+        Status |= MAX_BIT;
+      }
+      if ((Entries[Start + Index].Buffer != NULL) &&
+          ((Status == EFI_SUCCESS) || (Status == EFI_BUFFER_TOO_SMALL))) {
+        Entries[Start + Index].Length = (UINTN)LockBoxEntry[Index].Length;
+      }
+      Entries[Start + Index].Status = Status;
+      if (EFI_ERROR (Status) && !EFI_ERROR (FirstStatus)) {
+        FirstStatus = Status;
+      }
+    }
+  }
+
+  DEBUG ((DEBUG_INFO, "SmmLockBoxPeiLib RestoreMultipleLockBox - Exit (%r)\n", FirstStatus));
+
+  //
+  // Done
+  //
+  return FirstStatus;
+}
+// MU_CHANGE [END]
@@ -26,6 +26,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 SMM_LOCK_BOX_CONTEXT mSmmLockBoxContext;
 LIST_ENTRY           mLockBoxQueue = INITIALIZE_LIST_HEAD_VARIABLE (mLockBoxQueue);
+// MU_CHANGE [BEGIN] - Index the LockBoxes by GUID.
+LIST_ENTRY           mLockBoxHashTable[SMM_LOCK_BOX_HASH_TABLE_SIZE];
+// MU_CHANGE [END]
 
 BOOLEAN              mSmmConfigurationTableInstalled = FALSE;
 VOID                 *mSmmLockBoxRegistrationSmmEndOfDxe = NULL;
@@ -206,6 +209,7 @@ SmmLockBoxSmmConstructor (
 {
   EFI_STATUS           Status;
   SMM_LOCK_BOX_CONTEXT *SmmLockBoxContext;
+  UINTN                Index;     // MU_CHANGE - Index the LockBoxes by GUID.
 
   DEBUG ((DEBUG_INFO, "SmmLockBoxSmmLib SmmLockBoxSmmConstructor - Enter\n"));
 
@@ -262,6 +266,12 @@ SmmLockBoxSmmConstructor (
     mSmmLockBoxContext.Signature = SMM_LOCK_BOX_SIGNATURE_32;
   }
   mSmmLockBoxContext.LockBoxDataAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)&mLockBoxQueue;
+  // MU_CHANGE [BEGIN] - Index the LockBoxes by GUID.
+  for (Index = 0; Index < SMM_LOCK_BOX_HASH_TABLE_SIZE; Index++) {
+    InitializeListHead (&mLockBoxHashTable[Index]);
+  }
+  mSmmLockBoxContext.LockBoxHashTableAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)mLockBoxHashTable;
+  // MU_CHANGE [END]
 
   Status = gSmst->SmmInstallConfigurationTable (
                     gSmst,
@@ -369,6 +379,41 @@ InternalGetLockBoxQueue (
   return (LIST_ENTRY *)(UINTN)SmmLockBoxContext->LockBoxDataAddress;
 }
 
+// MU_CHANGE [BEGIN] - Index the LockBoxes by GUID.
+/**
+  This function return the SmmLockBox hash table bucket of a GUID.
+
+  @param Guid The guid to indentify the LockBox
+
+  @return SmmLockBox hash table bucket address.
+**/
+LIST_ENTRY *
+InternalGetLockBoxHashBucket (
+  IN EFI_GUID   *Guid
+  )
+{
+  SMM_LOCK_BOX_CONTEXT        *SmmLockBoxContext;
+  LIST_ENTRY                  *LockBoxHashTable;
+  UINT32                      Hash;
+
+  SmmLockBoxContext = InternalGetSmmLockBoxContext ();
+  ASSERT (SmmLockBoxContext != NULL);
+  if (SmmLockBoxContext == NULL) {
+    return NULL;
+  }
+  LockBoxHashTable = (LIST_ENTRY *)(UINTN)SmmLockBoxContext->LockBoxHashTableAddress;
+
+  Hash = ReadUnaligned32 ((UINT32 *)Guid) ^
+         ReadUnaligned32 ((UINT32 *)Guid + 1) ^
+         ReadUnaligned32 ((UINT32 *)Guid + 2) ^
+         ReadUnaligned32 ((UINT32 *)Guid + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return &LockBoxHashTable[Hash & (SMM_LOCK_BOX_HASH_TABLE_SIZE - 1)];
+}
+// MU_CHANGE [END]
+
 /**
   This function find LockBox by GUID.
 
@@ -383,19 +428,21 @@ InternalFindLockBoxByGuid (
 {
   LIST_ENTRY                    *Link;
   SMM_LOCK_BOX_DATA             *LockBox;
-  LIST_ENTRY                    *LockBoxQueue;
+  LIST_ENTRY                    *LockBoxBucket;   // MU_CHANGE - Index the LockBoxes by GUID.
 
-  LockBoxQueue = InternalGetLockBoxQueue ();
-  ASSERT (LockBoxQueue != NULL);
+  // MU_CHANGE [BEGIN] - Index the LockBoxes by GUID.
+  LockBoxBucket = InternalGetLockBoxHashBucket (Guid);
+  ASSERT (LockBoxBucket != NULL);
 
-  for (Link = LockBoxQueue->ForwardLink;
-       Link != LockBoxQueue;
+  for (Link = LockBoxBucket->ForwardLink;
+       Link != LockBoxBucket;
        Link = Link->ForwardLink) {
     LockBox = BASE_CR (
                 Link,
                 SMM_LOCK_BOX_DATA,
-                Link
+                HashLink
                 );
+  // MU_CHANGE [END]
     if (CompareGuid (&LockBox->Guid, Guid)) {
       return LockBox;
     }
@@ -506,6 +553,7 @@ SaveLockBox (
   LockBoxQueue = InternalGetLockBoxQueue ();
   ASSERT (LockBoxQueue != NULL);
   InsertTailList (LockBoxQueue, &LockBox->Link);
+  InsertTailList (InternalGetLockBoxHashBucket (Guid), &LockBox->HashLink);    // MU_CHANGE - Index the LockBoxes by GUID.
 
   //
   // Done
@@ -869,3 +917,47 @@ RestoreAllLockBoxInPlace (
   return EFI_SUCCESS;
 }
 
+// MU_CHANGE [BEGIN] - Restore several LockBoxes at once.
+/**
+  This function will restore confidential information from several lockboxes.
+
+  @param Entries  the lockboxes to restore, the status of each one is returned in its entry
+  @param Count    the number of entries
+
+  @retval RETURN_SUCCESS            all the lockboxes are restored successfully.
+  @retval RETURN_INVALID_PARAMETER  Entries is NULL and Count is not 0, or the Guid of an entry is NULL.
+  @return others                    the status of the first entry that failed to restore.
+**/
+RETURN_STATUS
+EFIAPI
+RestoreMultipleLockBox (
+  IN OUT LOCK_BOX_RESTORE_ENTRY   *Entries,
+  IN     UINTN                    Count
+  )
+{
+  RETURN_STATUS  Status;
+  UINTN          Index;
+
+  if ((Entries == NULL) && (Count != 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The LockBoxes are found through the GUID hash table, so there is no need
+  // to batch them.
+  //
+  Status = RETURN_SUCCESS;
+  for (Index = 0; Index < Count; Index++) {
+    if (Entries[Index].Buffer == NULL) {
+      Entries[Index].Status = RestoreLockBox (Entries[Index].Guid, NULL, NULL);
+    } else {
+      Entries[Index].Status = RestoreLockBox (Entries[Index].Guid, Entries[Index].Buffer, &Entries[Index].Length);
+    }
+    if (RETURN_ERROR (Entries[Index].Status) && !RETURN_ERROR (Status)) {
+      Status = Entries[Index].Status;
+    }
+  }
+
+  return Status;
+}
+// MU_CHANGE [END]
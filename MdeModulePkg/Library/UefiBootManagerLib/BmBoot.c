@@ -625,9 +625,132 @@ BmExpandUsbDevicePath (
   return NextFullPath;
 }
 
+/**
+  Check whether two device paths are identical.
+
+  @param DevicePath1   The first device path.
+  @param DevicePath2   The second device path.
+
+  @retval TRUE   The device paths are identical.
+  @retval FALSE  The device paths are different.
+**/
+BOOLEAN
+BmIsSameDevicePath (
+  IN EFI_DEVICE_PATH_PROTOCOL     *DevicePath1,
+  IN EFI_DEVICE_PATH_PROTOCOL     *DevicePath2
+  )
+{
+  UINTN                           Size;
+
+  Size = GetDevicePathSize (DevicePath1);
+  return (BOOLEAN) ((Size == GetDevicePathSize (DevicePath2)) &&
+                    (CompareMem (DevicePath1, DevicePath2, Size) == 0));
+}
+
+/**
+  Get the full path that the File-path device path booted last time
+  expanded to, which is saved in the 'FPDP' variable.
+
+  @param FilePath      The device path starting with a File-path device path node.
+
+  @return The cached full path, or NULL if FilePath isn't the cached one.
+          Caller is responsible to free the memory.
+**/
+EFI_DEVICE_PATH_PROTOCOL *
+BmGetCachedFileDevicePath (
+  IN  EFI_DEVICE_PATH_PROTOCOL    *FilePath
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL        *CachedDevicePath;
+  UINTN                           CachedDevicePathSize;
+  EFI_DEVICE_PATH_PROTOCOL        *TempDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL        *ShortFormPath;
+  EFI_DEVICE_PATH_PROTOCOL        *CachedFullPath;
+  UINTN                           Size;
+
+  GetVariable2 (L"FPDP", &mBmHardDriveBootVariableGuid, (VOID **) &CachedDevicePath, &CachedDevicePathSize);
+  if (CachedDevicePath == NULL) {
+    return NULL;
+  }
+
+  //
+  // The variable holds two instances: the short-form path and its full path.
+  //
+  CachedFullPath = NULL;
+  if (IsDevicePathValid (CachedDevicePath, CachedDevicePathSize)) {
+    TempDevicePath = CachedDevicePath;
+    ShortFormPath  = GetNextDevicePathInstance (&TempDevicePath, &Size);
+    if ((ShortFormPath != NULL) && (TempDevicePath != NULL) && BmIsSameDevicePath (ShortFormPath, FilePath)) {
+      CachedFullPath = GetNextDevicePathInstance (&TempDevicePath, &Size);
+    }
+    if (ShortFormPath != NULL) {
+      FreePool (ShortFormPath);
+    }
+  }
+
+  FreePool (CachedDevicePath);
+  return CachedFullPath;
+}
+
+/**
+  Save the full path a File-path device path expanded to in the 'FPDP'
+  variable, so that the next boot of it only connects the controllers
+  of the full path instead of all controllers.
+
+  @param FilePath      The device path of the boot option.
+  @param FullPath      The full path the boot option was loaded from.
+**/
+VOID
+BmCacheFileDevicePath (
+  IN  EFI_DEVICE_PATH_PROTOCOL    *FilePath,
+  IN  EFI_DEVICE_PATH_PROTOCOL    *FullPath
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL        *CachedFullPath;
+  EFI_DEVICE_PATH_PROTOCOL        *CachedDevicePath;
+
+  if ((DevicePathType (FilePath) != MEDIA_DEVICE_PATH) ||
+      (DevicePathSubType (FilePath) != MEDIA_FILEPATH_DP)) {
+    return;
+  }
+
+  //
+  // Skip the variable write when the cache is already up to date.
+  //
+  CachedFullPath = BmGetCachedFileDevicePath (FilePath);
+  if (CachedFullPath != NULL) {
+    if (BmIsSameDevicePath (CachedFullPath, FullPath)) {
+      FreePool (CachedFullPath);
+      return;
+    }
+    FreePool (CachedFullPath);
+  }
+
+  CachedDevicePath = AppendDevicePathInstance (FilePath, FullPath);
+  if (CachedDevicePath == NULL) {
+    return;
+  }
+
+  //
+  // Failing to save only impacts performance next time expanding the short-form device path
+  //
+  gRT->SetVariable (
+         L"FPDP",
+         &mBmHardDriveBootVariableGuid,
+         EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_NON_VOLATILE,
+         GetDevicePathSize (CachedDevicePath),
+         CachedDevicePath
+         );
+  FreePool (CachedDevicePath);
+}
+
 /**
   Expand File-path device path node to be full device path in platform.
 
+  The full path saved in the 'FPDP' variable by the last boot of FilePath is
+  returned first, connecting only its controllers. The other full paths are
+  found after connecting all controllers.
+
   @param FilePath      The device path pointing to a load option.
                        It could be a short-form device path.
   @param FullPath      The full path returned by the routine in last call.
@@ -650,6 +773,31 @@ BmExpandFileDevicePath (
   UINTN                           MediaType;
   EFI_DEVICE_PATH_PROTOCOL        *NextFullPath;
   BOOLEAN                         GetNext;
+  EFI_DEVICE_PATH_PROTOCOL        *CachedFullPath;
+  EFI_DEVICE_PATH_PROTOCOL        *Node;
+  EFI_HANDLE                      Handle;
+
+  CachedFullPath = BmGetCachedFileDevicePath (FilePath);
+  if ((CachedFullPath != NULL) && (FullPath == NULL)) {
+    //
+    // Connect only the controllers of the cached full path and check that it
+    // still reaches a file system.
+    //
+    EfiBootManagerConnectDevicePath (CachedFullPath, NULL);
+    Node   = CachedFullPath;
+    Status = gBS->LocateDevicePath (&gEfiSimpleFileSystemProtocolGuid, &Node, &Handle);
+    if (!EFI_ERROR (Status) && BmIsSameDevicePath (Node, FilePath)) {
+      return CachedFullPath;
+    }
+
+    //
+    // Delete the stale 'FPDP' variable, so the full path is not skipped below
+    // in the next calls.
+    //
+    gRT->SetVariable (L"FPDP", &mBmHardDriveBootVariableGuid, 0, 0, NULL);
+    FreePool (CachedFullPath);
+    CachedFullPath = NULL;
+  }
 
   EfiBootManagerConnectAll ();
   Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiSimpleFileSystemProtocolGuid, NULL, &HandleCount, &Handles);
@@ -658,7 +806,12 @@ BmExpandFileDevicePath (
     Handles = NULL;
   }
 
-  GetNext = (BOOLEAN)(FullPath == NULL);
+  //
+  // The cached full path was returned by the first call, so it is skipped
+  // and the enumeration starts over after it.
+  //
+  GetNext = (BOOLEAN)(FullPath == NULL ||
+                      (CachedFullPath != NULL && BmIsSameDevicePath (FullPath, CachedFullPath)));
   NextFullPath = NULL;
   //
   // Enumerate all removable media devices followed by all fixed media devices,
@@ -675,6 +828,11 @@ BmExpandFileDevicePath (
           (MediaType == 2 && BlockIo == NULL)
           ) {
         NextFullPath = AppendDevicePath (DevicePathFromHandle (Handles[Index]), FilePath);
+        if ((CachedFullPath != NULL) && BmIsSameDevicePath (NextFullPath, CachedFullPath)) {
+          FreePool (NextFullPath);
+          NextFullPath = NULL;
+          continue;
+        }
         if (GetNext) {
           break;
         } else {
@@ -692,6 +850,9 @@ BmExpandFileDevicePath (
   if (Handles != NULL) {
     FreePool (Handles);
   }
+  if (CachedFullPath != NULL) {
+    FreePool (CachedFullPath);
+  }
 
   return NextFullPath;
 }
@@ -1916,6 +2077,9 @@ EfiBootManagerBoot (
       FreePool (FileBuffer);
     }
     if (FilePath != NULL) {
+      if (!EFI_ERROR (Status)) {
+        BmCacheFileDevicePath (BootOption->FilePath, FilePath);
+      }
       FreePool (FilePath);
     }
 
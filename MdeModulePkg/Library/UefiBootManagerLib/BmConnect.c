@@ -86,6 +86,38 @@ EfiBootManagerConnectAll (
   EfiBootManagerConnectAllDefaultConsoles ();
 }
 
+/**
+  This function will connect the platform default console and the devices
+  of the active boot options in BootOrder only. It can be used instead of
+  EfiBootManagerConnectAll() when the platform doesn't need the other
+  devices before booting; those can still be connected on demand later.
+  Boot options with short-form device paths are connected when booted.
+**/
+VOID
+EFIAPI
+EfiBootManagerConnectBootOrder (
+  VOID
+  )
+{
+  EFI_BOOT_MANAGER_LOAD_OPTION  *BootOptions;
+  UINTN                         BootOptionCount;
+  UINTN                         Index;
+
+  //
+  // Connect the platform console first
+  //
+  EfiBootManagerConnectAllDefaultConsoles ();
+
+  BootOptions = EfiBootManagerGetLoadOptions (&BootOptionCount, LoadOptionTypeBoot);
+  for (Index = 0; Index < BootOptionCount; Index++) {
+    if ((BootOptions[Index].Attributes & LOAD_OPTION_ACTIVE) == 0) {
+      continue;
+    }
+    EfiBootManagerConnectDevicePath (BootOptions[Index].FilePath, NULL);
+  }
+  EfiBootManagerFreeLoadOptions (BootOptions, BootOptionCount);
+}
+
 /**
   This function will create all handles associate with every device
   path node. If the handle associate with one device path node can not
@@ -3068,19 +3068,30 @@ InternalHiiGrowOpCodeHandle (
 {
   HII_LIB_OPCODE_BUFFER  *OpCodeBuffer;
   UINT8                  *Buffer;
+  UINTN                  NewBufferSize;  // MU_CHANGE
 
   ASSERT (OpCodeHandle != NULL);
 
   OpCodeBuffer = (HII_LIB_OPCODE_BUFFER *)OpCodeHandle;
   if (OpCodeBuffer->Position + Size > OpCodeBuffer->BufferSize) {
+    // MU_CHANGE [BEGIN] - Grow the opcode buffer geometrically.
+    //
+    // Double the buffer so that building a large form costs a logarithmic
+    // number of reallocations instead of one per HII_LIB_OPCODE_ALLOCATION_SIZE.
+    //
+    NewBufferSize = OpCodeBuffer->BufferSize * 2;
+    if (NewBufferSize < OpCodeBuffer->Position + Size + HII_LIB_OPCODE_ALLOCATION_SIZE) {
+      NewBufferSize = OpCodeBuffer->Position + Size + HII_LIB_OPCODE_ALLOCATION_SIZE;
+    }
     Buffer = ReallocatePool (
               OpCodeBuffer->BufferSize,
-              OpCodeBuffer->BufferSize + (Size + HII_LIB_OPCODE_ALLOCATION_SIZE),
+              NewBufferSize,
               OpCodeBuffer->Buffer
               );
     ASSERT (Buffer != NULL);
     OpCodeBuffer->Buffer = Buffer;
-    OpCodeBuffer->BufferSize += (Size + HII_LIB_OPCODE_ALLOCATION_SIZE);
+    OpCodeBuffer->BufferSize = NewBufferSize;
+    // MU_CHANGE [END]
   }
   Buffer = OpCodeBuffer->Buffer + OpCodeBuffer->Position;
   OpCodeBuffer->Position += Size;
@@ -4418,6 +4429,17 @@ HiiUpdateForm (
     CopyMem (&PackageHeader, Package, sizeof (EFI_HII_PACKAGE_HEADER));
     Offset += Package->Length;
 
+    // MU_CHANGE [BEGIN] - Send only the forms packages back to the HII Database.
+    //
+    // UpdatePackageList () only replaces the package types present in the new
+    // list, so leaving out the string, font, image and other packages keeps
+    // the HII Database from removing and re-adding them for a form update.
+    //
+    if ((PackageHeader.Type != EFI_HII_PACKAGE_FORMS) && (PackageHeader.Type != EFI_HII_PACKAGE_END)) {
+      continue;
+    }
+    // MU_CHANGE [END]
+
     if (Package->Type == EFI_HII_PACKAGE_FORMS) {
       //
       // Check this package is the matched package.
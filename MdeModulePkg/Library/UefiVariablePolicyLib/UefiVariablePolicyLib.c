@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Uefi.h>
 
+#include <Library/BaseLib.h>
 #include <Library/SafeIntLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -51,6 +52,20 @@ STATIC  UINT32              mCurrentTableCount = 0;
 
 #define POLICY_TABLE_STEP_SIZE        0x1000
 
+// Index of the policy table, built once the interface is locked and the table can no longer change.
+// Policies are hashed by namespace and name length, since a named policy can only match a variable
+// name of the same length. Namespace-wide policies use a name length of 0.
+#define POLICY_INDEX_BUCKETS          64
+#define POLICY_INDEX_END              MAX_UINT32
+
+typedef struct {
+  UINT32    Offset;     // Offset of the policy in mPolicyTable.
+  UINT32    Next;       // Next entry in the same bucket, in table order.
+} POLICY_INDEX_ENTRY;
+
+STATIC  POLICY_INDEX_ENTRY  *mPolicyIndex = NULL;
+STATIC  UINT32              mPolicyIndexHeads[POLICY_INDEX_BUCKETS];
+
 // NOTE: DO NOT USE THESE MACROS on any structure that has not been validated.
 //       Current table data has already been sanitized.
 #define GET_NEXT_POLICY(CurPolicy)    (VARIABLE_POLICY_ENTRY*)((UINT8*)CurPolicy + CurPolicy->Size)
@@ -259,11 +274,100 @@ Exit:
 } // EvaluatePolicyMatch()
 
 
+/**
+  This helper function returns the policy index bucket for a namespace and name length.
+
+  @param[in]  Namespace     Pointer to the namespace GUID. May be unaligned.
+  @param[in]  NameLength    Length of the name in characters, or 0 for a namespace-wide policy.
+
+  @retval     UINT32        Bucket index.
+
+**/
+STATIC
+UINT32
+GetPolicyIndexBucket (
+  IN CONST  EFI_GUID          *Namespace,
+  IN        UINTN             NameLength
+  )
+{
+  UINT32      Hash;
+
+  Hash = ReadUnaligned32( (CONST UINT32*)Namespace ) ^
+         ReadUnaligned32( (CONST UINT32*)Namespace + 1 ) ^
+         ReadUnaligned32( (CONST UINT32*)Namespace + 2 ) ^
+         ReadUnaligned32( (CONST UINT32*)Namespace + 3 );
+  Hash ^= (UINT32)NameLength * 0x9E3779B1;
+  Hash ^= Hash >> 16;
+
+  return Hash % POLICY_INDEX_BUCKETS;
+} // GetPolicyIndexBucket()
+
+
+/**
+  This helper function builds the policy index from the current policy table.
+
+  If the index cannot be allocated, lookups keep walking the whole table.
+
+**/
+STATIC
+VOID
+BuildPolicyIndex (
+  VOID
+  )
+{
+  VARIABLE_POLICY_ENTRY   *CurrentEntry;
+  UINT32                  Tails[POLICY_INDEX_BUCKETS];
+  UINT32                  Bucket;
+  UINTN                   NameLength;
+  UINT32                  Index;
+
+  if (mCurrentTableCount == 0) {
+    return;
+  }
+
+  mPolicyIndex = AllocatePool( mCurrentTableCount * sizeof(POLICY_INDEX_ENTRY) );
+  if (mPolicyIndex == NULL) {
+    DEBUG(( DEBUG_WARN, "%a - Failed to allocate the policy index.\n", __FUNCTION__ ));
+    return;
+  }
+
+  for (Bucket = 0; Bucket < POLICY_INDEX_BUCKETS; Bucket++) {
+    mPolicyIndexHeads[Bucket] = POLICY_INDEX_END;
+    Tails[Bucket] = POLICY_INDEX_END;
+  }
+
+  // Append the entries in table order, so each bucket stays in table order.
+  CurrentEntry = (VARIABLE_POLICY_ENTRY*)mPolicyTable;
+  for (Index = 0; Index < mCurrentTableCount; Index++) {
+    NameLength = 0;
+    if (CurrentEntry->Size != CurrentEntry->OffsetToName) {
+      NameLength = StrLen( GET_POLICY_NAME( CurrentEntry ) );
+    }
+    Bucket = GetPolicyIndexBucket( &CurrentEntry->Namespace, NameLength );
+
+    mPolicyIndex[Index].Offset = (UINT32)((UINT8*)CurrentEntry - mPolicyTable);
+    mPolicyIndex[Index].Next = POLICY_INDEX_END;
+    if (Tails[Bucket] == POLICY_INDEX_END) {
+      mPolicyIndexHeads[Bucket] = Index;
+    } else {
+      mPolicyIndex[Tails[Bucket]].Next = Index;
+    }
+    Tails[Bucket] = Index;
+
+    CurrentEntry = GET_NEXT_POLICY( CurrentEntry );
+  }
+} // BuildPolicyIndex()
+
+
 /**
   This helper function walks the current policy table and returns a pointer
   to the best match, if any are found. Leverages EvaluatePolicyMatch() to
   determine "best".
 
+  Once the policy index has been built, only the policies for the namespace that
+  are either namespace-wide or named with the same length as VariableName are
+  evaluated, still in table order.
+
   @param[in]  VariableName       Same as EFI_SET_VARIABLE.
   @param[in]  VendorGuid         Same as EFI_SET_VARIABLE.
   @param[out] ReturnPriority     [Optional] If pointer is provided, return the
@@ -287,6 +391,42 @@ GetBestPolicyMatch (
   UINT8                   MatchPriority;
   UINT8                   CurrentPriority;
   UINTN                   Index;
+  UINT32                  NamedIndex;
+  UINT32                  NamespaceIndex;
+
+  // If the table has been indexed, walk the two candidate buckets together in table order.
+  if (mPolicyIndex != NULL) {
+    NamedIndex = mPolicyIndexHeads[GetPolicyIndexBucket( VendorGuid, StrLen( VariableName ) )];
+    NamespaceIndex = mPolicyIndexHeads[GetPolicyIndexBucket( VendorGuid, 0 )];
+    if (NamedIndex == NamespaceIndex) {
+      NamespaceIndex = POLICY_INDEX_END;
+    }
+    while (NamedIndex != POLICY_INDEX_END || NamespaceIndex != POLICY_INDEX_END) {
+      if (NamespaceIndex == POLICY_INDEX_END ||
+          (NamedIndex != POLICY_INDEX_END && NamedIndex < NamespaceIndex)) {
+        CurrentEntry = (VARIABLE_POLICY_ENTRY*)(mPolicyTable + mPolicyIndex[NamedIndex].Offset);
+        NamedIndex = mPolicyIndex[NamedIndex].Next;
+      } else {
+        CurrentEntry = (VARIABLE_POLICY_ENTRY*)(mPolicyTable + mPolicyIndex[NamespaceIndex].Offset);
+        NamespaceIndex = mPolicyIndex[NamespaceIndex].Next;
+      }
+
+      if (EvaluatePolicyMatch( CurrentEntry, VariableName, VendorGuid, &CurrentPriority ) == TRUE) {
+        if (BestResult == NULL || CurrentPriority < MatchPriority) {
+          BestResult = CurrentEntry;
+          MatchPriority = CurrentPriority;
+        }
+        if (MatchPriority == 0) {
+          break;
+        }
+      }
+    }
+
+    if (ReturnPriority != NULL) {
+      *ReturnPriority = MatchPriority;
+    }
+    return BestResult;
+  }
 
   // Walk all entries in the table, looking for matches.
   CurrentEntry = (VARIABLE_POLICY_ENTRY*)mPolicyTable;
@@ -664,6 +804,10 @@ LockVariablePolicy (
     return EFI_WRITE_PROTECTED;
   }
   mInterfaceLocked = TRUE;
+
+  // The table cannot change anymore, so index it for faster lookups.
+  BuildPolicyIndex();
+
   return EFI_SUCCESS;
 } // LockVariablePolicy ()
 
@@ -721,6 +865,7 @@ InitVariablePolicyLib (
   mInterfaceLocked = FALSE;
   mProtectionDisabled = FALSE;
   mPolicyTable = NULL;
+  mPolicyIndex = NULL;
   mCurrentTableSize = 0;
   mCurrentTableUsage = 0;
   mCurrentTableCount = 0;
@@ -776,6 +921,10 @@ DeinitVariablePolicyLib (
     FreePool( mPolicyTable );
     mPolicyTable = NULL;
   }
+  if (mPolicyIndex != NULL) {
+    FreePool( mPolicyIndex );
+    mPolicyIndex = NULL;
+  }
 
   return EFI_SUCCESS;
 } // DeinitVariablePolicyLib()
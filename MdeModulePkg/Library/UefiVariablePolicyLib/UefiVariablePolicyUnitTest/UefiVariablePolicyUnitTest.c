@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <stdarg.h>
 #include <stddef.h>
 #include <setjmp.h>
+#include <time.h>
 #include <cmocka.h>
 
 #include <Uefi.h>
@@ -1938,6 +1939,96 @@ BestMatchPriorityShouldBeObeyed (
   return UNIT_TEST_PASSED;
 }
 
+#define BENCHMARK_POLICY_COUNT        500
+#define BENCHMARK_ITERATIONS          20
+
+/**
+  Test Case
+
+  Registers a large number of policies, then checks that lookups return the
+  same results once the interface is locked and the policy table is indexed.
+  Also reports the lookup throughput before and after the lock.
+*/
+UNIT_TEST_STATUS
+EFIAPI
+ManyPoliciesShouldBeHonoredAfterLock (
+  IN UNIT_TEST_CONTEXT      Context
+  )
+{
+  SIMPLE_VARIABLE_POLICY_ENTRY   ValidationPolicy = {
+    {
+      VARIABLE_POLICY_ENTRY_REVISION,
+      sizeof(VARIABLE_POLICY_ENTRY) + sizeof(L"BenchVar0000"),
+      sizeof(VARIABLE_POLICY_ENTRY),
+      TEST_GUID_1,
+      TEST_POLICY_MIN_SIZE_NULL,
+      10,
+      TEST_POLICY_ATTRIBUTES_NULL,
+      TEST_POLICY_ATTRIBUTES_NULL,
+      VARIABLE_POLICY_TYPE_NO_LOCK
+    },
+    L"BenchVar0000"
+  };
+  CHAR16      VariableName[sizeof(L"BenchVar0000")/sizeof(CHAR16)];
+  UINT8       DummyData[40];
+  UINTN       Pass;
+  UINTN       Index;
+  UINTN       Count;
+  clock_t     Start;
+  clock_t     Ticks[2];
+
+  // Register exact policies for the even numbers, a wildcard policy for all
+  // other names of the same shape, and a namespace policy in another GUID.
+  for (Index = 0; Index < BENCHMARK_POLICY_COUNT; Index++) {
+    UnicodeSPrint( ValidationPolicy.Name, sizeof(ValidationPolicy.Name), L"BenchVar%04d", Index * 2 );
+    UT_ASSERT_NOT_EFI_ERROR( RegisterVariablePolicy( &ValidationPolicy.Header ) );
+  }
+  StrCpyS( ValidationPolicy.Name, SIMPLE_VARIABLE_POLICY_ENTRY_VAR_NAME_LENGTH, L"BenchVar####" );
+  ValidationPolicy.Header.MaxSize = 20;
+  UT_ASSERT_NOT_EFI_ERROR( RegisterVariablePolicy( &ValidationPolicy.Header ) );
+  CopyGuid( &ValidationPolicy.Header.Namespace, &mTestGuid2 );
+  ValidationPolicy.Header.Size = ValidationPolicy.Header.OffsetToName;
+  ValidationPolicy.Header.MaxSize = 30;
+  UT_ASSERT_NOT_EFI_ERROR( RegisterVariablePolicy( &ValidationPolicy.Header ) );
+
+  // Run the same checks before and after the lock.
+  for (Pass = 0; Pass < 2; Pass++) {
+    if (Pass == 1) {
+      UT_ASSERT_NOT_EFI_ERROR( LockVariablePolicy() );
+    }
+
+    Count = 0;
+    Start = clock();
+    for (Index = 0; Index < BENCHMARK_ITERATIONS * BENCHMARK_POLICY_COUNT; Index++) {
+      UnicodeSPrint( VariableName, sizeof(VariableName), L"BenchVar%04d", Index % (BENCHMARK_POLICY_COUNT * 2) );
+      if ((Index % 2) == 0) {
+        // Exact match.
+        UT_ASSERT_NOT_EFI_ERROR( ValidateSetVariable( VariableName, &mTestGuid1, VARIABLE_ATTRIBUTE_NV_BS, 10, DummyData ) );
+        UT_ASSERT_TRUE( EFI_ERROR( ValidateSetVariable( VariableName, &mTestGuid1, VARIABLE_ATTRIBUTE_NV_BS, 15, DummyData ) ) );
+      } else {
+        // Wildcard match.
+        UT_ASSERT_NOT_EFI_ERROR( ValidateSetVariable( VariableName, &mTestGuid1, VARIABLE_ATTRIBUTE_NV_BS, 15, DummyData ) );
+        UT_ASSERT_TRUE( EFI_ERROR( ValidateSetVariable( VariableName, &mTestGuid1, VARIABLE_ATTRIBUTE_NV_BS, 25, DummyData ) ) );
+      }
+      // Namespace match.
+      UT_ASSERT_NOT_EFI_ERROR( ValidateSetVariable( VariableName, &mTestGuid2, VARIABLE_ATTRIBUTE_NV_BS, 25, DummyData ) );
+      UT_ASSERT_TRUE( EFI_ERROR( ValidateSetVariable( VariableName, &mTestGuid2, VARIABLE_ATTRIBUTE_NV_BS, 35, DummyData ) ) );
+      // No match.
+      UT_ASSERT_NOT_EFI_ERROR( ValidateSetVariable( TEST_VAR_1_NAME, &mTestGuid1, VARIABLE_ATTRIBUTE_NV_BS, 35, DummyData ) );
+      UT_ASSERT_NOT_EFI_ERROR( ValidateSetVariable( VariableName, &mTestGuid3, VARIABLE_ATTRIBUTE_NV_BS, 35, DummyData ) );
+      Count += 6;
+    }
+    Ticks[Pass] = clock() - Start;
+    UT_LOG_INFO( "%a: %d lookups against %d policies in %d ms.\n",
+                 Pass == 0 ? "Unlocked" : "Locked",
+                 (UINT32)Count,
+                 BENCHMARK_POLICY_COUNT + 2,
+                 (UINT32)(Ticks[Pass] * 1000 / CLOCKS_PER_SEC) );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
 
 ///=== POLICY UTILITY SUITE ===================================================
 
@@ -2422,6 +2513,9 @@ main (
   AddTestCase( PolicyTests,
                 "BestMatchPriorityShouldBeObeyed", "VarPolicy.Policy.BestMatch",
                 BestMatchPriorityShouldBeObeyed, LibInitMocked, LibCleanup, NULL );
+  AddTestCase( PolicyTests,
+                "ManyPoliciesShouldBeHonoredAfterLock", "VarPolicy.Policy.ManyPolicies",
+                ManyPoliciesShouldBeHonoredAfterLock, LibInitMocked, LibCleanup, NULL );
 
   Status = CreateUnitTestSuite( &UtilityTests, Framework, "Variable Policy Utility Tests", "VarPolicy.Utility", NULL, NULL );
   if (EFI_ERROR( Status ))
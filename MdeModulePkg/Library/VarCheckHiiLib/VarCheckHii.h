@@ -54,4 +54,48 @@ DumpVarCheckHii (
 extern VAR_CHECK_HII_VARIABLE_HEADER    *mVarCheckHiiBin;
 extern UINTN                            mVarCheckHiiBinSize;
 
+// MU_CHANGE [BEGIN] - Index the bin by variable and sort question options
+//
+// Open-addressed index over the variables in mVarCheckHiiBin, keyed by
+// VarCheckHiiHashVariable (). Each slot holds the offset of a variable
+// header in the bin plus one; 0 marks an empty slot. NULL if not built.
+//
+extern UINT32                           *mVarCheckHiiIndex;
+extern UINT32                           mVarCheckHiiIndexSlots;
+
+/**
+  Hash a variable name and vendor GUID for mVarCheckHiiIndex.
+
+  @param[in] VariableName       Name of Variable.
+  @param[in] VendorGuid         Variable vendor GUID.
+
+  @return The hash value.
+
+**/
+UINT32
+VarCheckHiiHashVariable (
+  IN CHAR16     *VariableName,
+  IN EFI_GUID   *VendorGuid
+  );
+
+/**
+  Get the option list of a OneOf or OrderedList Hii Question.
+
+  The options are sorted in ascending order when VarCheckHiiBin is built.
+
+  @param[in]  HiiQuestion   Pointer to Hii Question.
+  @param[out] Width         Size in bytes of one option value.
+  @param[out] Count         Number of option values.
+
+  @return Pointer to the first option value, or NULL if HiiQuestion has no option list.
+
+**/
+UINT8 *
+VarCheckHiiGetOptions (
+  IN  VAR_CHECK_HII_QUESTION_HEADER  *HiiQuestion,
+  OUT UINTN                          *Width,
+  OUT UINTN                          *Count
+  );
+// MU_CHANGE [END]
+
 #endif
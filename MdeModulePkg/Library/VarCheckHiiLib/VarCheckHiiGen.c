@@ -1448,6 +1448,108 @@ DestroyHiiVariableNode (
   }
 }
 
+// MU_CHANGE [BEGIN] - Index the bin by variable and sort question options
+/**
+  Sort the option list of a OneOf or OrderedList Hii Question in ascending
+  order so the SetVariable check handler can binary search it.
+
+  @param[in, out] HiiQuestion   Pointer to Hii Question.
+
+**/
+VOID
+SortHiiQuestionOptions (
+  IN OUT VAR_CHECK_HII_QUESTION_HEADER  *HiiQuestion
+  )
+{
+  UINT8     *Options;
+  UINTN     Width;
+  UINTN     Count;
+  UINTN     Index;
+  UINTN     Insert;
+  UINT64    Value;
+  UINT64    OtherValue;
+
+  Options = VarCheckHiiGetOptions (HiiQuestion, &Width, &Count);
+  if (Options == NULL) {
+    return;
+  }
+
+  //
+  // Option lists are bounded by the UINT8 question length, so an insertion
+  // sort is enough.
+  //
+  for (Index = 1; Index < Count; Index++) {
+    Value = 0;
+    CopyMem (&Value, Options + Index * Width, Width);
+    for (Insert = Index; Insert > 0; Insert--) {
+      OtherValue = 0;
+      CopyMem (&OtherValue, Options + (Insert - 1) * Width, Width);
+      if (OtherValue <= Value) {
+        break;
+      }
+
+      CopyMem (Options + Insert * Width, Options + (Insert - 1) * Width, Width);
+    }
+
+    CopyMem (Options + Insert * Width, &Value, Width);
+  }
+}
+
+/**
+  Build mVarCheckHiiIndex over the variables in VarCheckHiiBin.
+
+  If the index cannot be allocated, the SetVariable check handler falls back
+  to scanning VarCheckHiiBin.
+
+  @param[in] Bin        Pointer to VarCheckHiiBin.
+  @param[in] BinSize    VarCheckHiiBin size.
+
+**/
+VOID
+BuildVarCheckHiiIndex (
+  IN VAR_CHECK_HII_VARIABLE_HEADER  *Bin,
+  IN UINTN                          BinSize
+  )
+{
+  VAR_CHECK_HII_VARIABLE_HEADER     *HiiVariable;
+  UINT32                            *Index;
+  UINT32                            Slots;
+  UINT32                            Slot;
+  UINT32                            Count;
+
+  Count = 0;
+  HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (Bin);
+  while ((UINTN) HiiVariable < ((UINTN) Bin + BinSize)) {
+    Count++;
+    HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (((UINTN) HiiVariable + HiiVariable->Length));
+  }
+
+  //
+  // Keep the index at most half full so probe chains stay short.
+  //
+  Slots = GetPowerOfTwo32 (Count) * 4;
+  Index = AllocateRuntimeZeroPool (Slots * sizeof (UINT32));
+  if (Index == NULL) {
+    return;
+  }
+
+  HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (Bin);
+  while ((UINTN) HiiVariable < ((UINTN) Bin + BinSize)) {
+    Slot = VarCheckHiiHashVariable ((CHAR16 *) (HiiVariable + 1), &HiiVariable->Guid) & (Slots - 1);
+    while (Index[Slot] != 0) {
+      Slot = (Slot + 1) & (Slots - 1);
+    }
+
+    Index[Slot] = (UINT32) ((UINTN) HiiVariable - (UINTN) Bin) + 1;
+    HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (((UINTN) HiiVariable + HiiVariable->Length));
+  }
+
+  DEBUG ((DEBUG_INFO, "VarCheckHiiIndex - %d variables in %d slots\n", Count, Slots));
+  mVarCheckHiiIndexSlots = Slots;
+  mVarCheckHiiIndex      = Index;
+}
+// MU_CHANGE [END]
+
 /**
   Build VarCheckHiiBin.
 
@@ -1541,6 +1643,7 @@ BuildVarCheckHiiBin (
         //
         Ptr = (UINT8 *) HEADER_ALIGN (Ptr);
         CopyMem (Ptr, HiiVariableNode->HiiQuestionArray[Index], HiiVariableNode->HiiQuestionArray[Index]->Length);
+        SortHiiQuestionOptions ((VAR_CHECK_HII_QUESTION_HEADER *) Ptr);   // MU_CHANGE
         Ptr += HiiVariableNode->HiiQuestionArray[Index]->Length;
       }
     }
@@ -1569,6 +1672,8 @@ VarCheckHiiGen (
     return;
   }
 
+  BuildVarCheckHiiIndex (mVarCheckHiiBin, mVarCheckHiiBinSize);   // MU_CHANGE
+
   DestroyHiiVariableNode ();
   if (mVarName != NULL) {
     InternalVarCheckFreePool (mVarName);
@@ -62,6 +62,142 @@ VarCheckHiiInternalDumpHex (
   }
 }
 
+// MU_CHANGE [BEGIN] - Index the bin by variable and sort question options
+UINT32  *mVarCheckHiiIndex = NULL;
+UINT32  mVarCheckHiiIndexSlots = 0;
+
+/**
+  Hash a variable name and vendor GUID for mVarCheckHiiIndex.
+
+  @param[in] VariableName       Name of Variable.
+  @param[in] VendorGuid         Variable vendor GUID.
+
+  @return The hash value.
+
+**/
+UINT32
+VarCheckHiiHashVariable (
+  IN CHAR16     *VariableName,
+  IN EFI_GUID   *VendorGuid
+  )
+{
+  UINT32    Hash;
+  UINTN     Index;
+  UINT8     *Bytes;
+
+  //
+  // FNV-1a over the name characters and the GUID bytes.
+  //
+  Hash = 0x811C9DC5;
+  for (Index = 0; VariableName[Index] != L'\0'; Index++) {
+    Hash = (Hash ^ VariableName[Index]) * 0x01000193;
+  }
+
+  Bytes = (UINT8 *) VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Get the option list of a OneOf or OrderedList Hii Question.
+
+  The options are sorted in ascending order when VarCheckHiiBin is built.
+
+  @param[in]  HiiQuestion   Pointer to Hii Question.
+  @param[out] Width         Size in bytes of one option value.
+  @param[out] Count         Number of option values.
+
+  @return Pointer to the first option value, or NULL if HiiQuestion has no option list.
+
+**/
+UINT8 *
+VarCheckHiiGetOptions (
+  IN  VAR_CHECK_HII_QUESTION_HEADER  *HiiQuestion,
+  OUT UINTN                          *Width,
+  OUT UINTN                          *Count
+  )
+{
+  UINT8     *Options;
+
+  switch (HiiQuestion->OpCode) {
+    case EFI_IFR_ONE_OF_OP:
+      Options = (UINT8 *) ((VAR_CHECK_HII_QUESTION_ONEOF *) HiiQuestion + 1);
+      //
+      // For OneOf stored in bit field, the value of options are saved as UINT32 type.
+      //
+      *Width  = HiiQuestion->BitFieldStore ? sizeof (UINT32) : HiiQuestion->StorageWidth;
+      break;
+
+    case EFI_IFR_ORDERED_LIST_OP:
+      Options = (UINT8 *) ((VAR_CHECK_HII_QUESTION_ORDEREDLIST *) HiiQuestion + 1);
+      *Width  = HiiQuestion->StorageWidth;
+      break;
+
+    default:
+      return NULL;
+  }
+
+  if ((*Width == 0) || ((UINTN) Options > (UINTN) HiiQuestion + HiiQuestion->Length)) {
+    *Count = 0;
+  } else {
+    *Count = ((UINTN) HiiQuestion + HiiQuestion->Length - (UINTN) Options) / *Width;
+  }
+
+  return Options;
+}
+
+/**
+  Binary search the sorted option list of a Hii Question for a value.
+
+  @param[in] HiiQuestion    Pointer to Hii Question.
+  @param[in] Value          The value to look for.
+
+  @retval TRUE  Value is one of the options.
+  @retval FALSE Value is not one of the options.
+
+**/
+STATIC
+BOOLEAN
+VarCheckHiiMatchOption (
+  IN VAR_CHECK_HII_QUESTION_HEADER  *HiiQuestion,
+  IN UINT64                         Value
+  )
+{
+  UINT8     *Options;
+  UINTN     Width;
+  UINTN     Low;
+  UINTN     High;
+  UINTN     Middle;
+  UINT64    OneValue;
+
+  Options = VarCheckHiiGetOptions (HiiQuestion, &Width, &High);
+  if (Options == NULL) {
+    return FALSE;
+  }
+
+  Low = 0;
+  while (Low < High) {
+    Middle   = Low + (High - Low) / 2;
+    OneValue = 0;
+    CopyMem (&OneValue, Options + Middle * Width, Width);
+    if (OneValue == Value) {
+      return TRUE;
+    }
+
+    if (OneValue < Value) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return FALSE;
+}
+// MU_CHANGE [END]
+
 /**
   Var Check Hii Question.
 
@@ -83,7 +219,6 @@ VarCheckHiiQuestion (
   UINT64   OneData;
   UINT64   Minimum;
   UINT64   Maximum;
-  UINT64   OneValue;
   UINT8    *Ptr;
   UINT8    Index;
   UINT8    MaxContainers;
@@ -120,30 +255,7 @@ VarCheckHiiQuestion (
 
   switch (HiiQuestion->OpCode) {
     case EFI_IFR_ONE_OF_OP:
-      Ptr = (UINT8 *) ((VAR_CHECK_HII_QUESTION_ONEOF *) HiiQuestion + 1);
-      while ((UINTN) Ptr < (UINTN) HiiQuestion + HiiQuestion->Length) {
-        OneValue = 0;
-        if (HiiQuestion->BitFieldStore) {
-          //
-          // For OneOf stored in bit field, the value of options are saved as UINT32 type.
-          //
-          CopyMem (&OneValue, Ptr, sizeof (UINT32));
-        } else {
-          CopyMem (&OneValue, Ptr, HiiQuestion->StorageWidth);
-        }
-        if (OneData == OneValue) {
-          //
-          // Match
-          //
-          break;
-        }
-        if (HiiQuestion->BitFieldStore) {
-          Ptr += sizeof (UINT32);
-        } else {
-          Ptr += HiiQuestion->StorageWidth;
-        }
-      }
-      if ((UINTN) Ptr >= ((UINTN) HiiQuestion + HiiQuestion->Length)) {
+      if (!VarCheckHiiMatchOption (HiiQuestion, OneData)) {   // MU_CHANGE - Binary search sorted options
         //
         // No match
         //
@@ -206,19 +318,7 @@ VarCheckHiiQuestion (
           continue;
         }
 
-        Ptr = (UINT8 *) ((VAR_CHECK_HII_QUESTION_ORDEREDLIST *) HiiQuestion + 1);
-        while ((UINTN) Ptr < ((UINTN) HiiQuestion + HiiQuestion->Length)) {
-          OneValue = 0;
-          CopyMem (&OneValue, Ptr, HiiQuestion->StorageWidth);
-          if (OneData == OneValue) {
-            //
-            // Match
-            //
-            break;
-          }
-          Ptr += HiiQuestion->StorageWidth;
-        }
-        if ((UINTN) Ptr >= ((UINTN) HiiQuestion + HiiQuestion->Length)) {
+        if (!VarCheckHiiMatchOption (HiiQuestion, OneData)) {   // MU_CHANGE - Binary search sorted options
           //
           // No match
           //
@@ -241,6 +341,60 @@ VarCheckHiiQuestion (
 VAR_CHECK_HII_VARIABLE_HEADER   *mVarCheckHiiBin = NULL;
 UINTN                           mVarCheckHiiBinSize = 0;
 
+// MU_CHANGE [BEGIN] - Index the bin by variable and sort question options
+/**
+  Find the Hii Variable for a variable name and vendor GUID in VarCheckHiiBin.
+
+  @param[in] VariableName       Name of Variable.
+  @param[in] VendorGuid         Variable vendor GUID.
+
+  @return Pointer to the Hii Variable, or NULL if it is not in VarCheckHiiBin.
+
+**/
+STATIC
+VAR_CHECK_HII_VARIABLE_HEADER *
+FindHiiVariable (
+  IN CHAR16     *VariableName,
+  IN EFI_GUID   *VendorGuid
+  )
+{
+  VAR_CHECK_HII_VARIABLE_HEADER     *HiiVariable;
+  UINT32                            Slot;
+
+  if (mVarCheckHiiIndex != NULL) {
+    Slot = VarCheckHiiHashVariable (VariableName, VendorGuid) & (mVarCheckHiiIndexSlots - 1);
+    while (mVarCheckHiiIndex[Slot] != 0) {
+      HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) ((UINTN) mVarCheckHiiBin + mVarCheckHiiIndex[Slot] - 1);
+      if ((StrCmp ((CHAR16 *) (HiiVariable + 1), VariableName) == 0) &&
+          (CompareGuid (&HiiVariable->Guid, VendorGuid))) {
+        return HiiVariable;
+      }
+
+      Slot = (Slot + 1) & (mVarCheckHiiIndexSlots - 1);
+    }
+
+    return NULL;
+  }
+
+  //
+  // For Hii Variable header align.
+  //
+  HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (mVarCheckHiiBin);
+  while ((UINTN) HiiVariable < ((UINTN) mVarCheckHiiBin + mVarCheckHiiBinSize)) {
+    if ((StrCmp ((CHAR16 *) (HiiVariable + 1), VariableName) == 0) &&
+        (CompareGuid (&HiiVariable->Guid, VendorGuid))) {
+      return HiiVariable;
+    }
+    //
+    // For Hii Variable header align.
+    //
+    HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (((UINTN) HiiVariable + HiiVariable->Length));
+  }
+
+  return NULL;
+}
+// MU_CHANGE [END]
+
 /**
   SetVariable check handler HII.
 
@@ -278,57 +432,49 @@ SetVariableCheckHandlerHii (
     return EFI_SUCCESS;
   }
 
+  // MU_CHANGE [BEGIN] - Look the variable up through mVarCheckHiiIndex
+  HiiVariable = FindHiiVariable (VariableName, VendorGuid);
+  if (HiiVariable == NULL) {
+    // Not found, so pass.
+    return EFI_SUCCESS;
+  }
+  // MU_CHANGE [END]
+
   //
-  // For Hii Variable header align.
+  // Found the Hii Variable that could be used to do check.
   //
-  HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (mVarCheckHiiBin);
-  while ((UINTN) HiiVariable < ((UINTN) mVarCheckHiiBin + mVarCheckHiiBinSize)) {
-    if ((StrCmp ((CHAR16 *) (HiiVariable + 1), VariableName) == 0) &&
-        (CompareGuid (&HiiVariable->Guid, VendorGuid))) {
-      //
-      // Found the Hii Variable that could be used to do check.
-      //
-      DEBUG ((DEBUG_INFO , "VarCheckHiiVariable - %s:%g with Attributes = 0x%08x Size = 0x%x\n", VariableName, VendorGuid, Attributes, DataSize));
-      if (HiiVariable->Attributes != Attributes) {
-        DEBUG ((DEBUG_INFO, "VarCheckHiiVariable fail for Attributes - 0x%08x\n", HiiVariable->Attributes));
-        return EFI_SECURITY_VIOLATION;
-      }
-
-      if (DataSize == 0) {
-        DEBUG ((DEBUG_INFO, "VarCheckHiiVariable - CHECK PASS with DataSize == 0 !\n"));
-        return EFI_SUCCESS;
-      }
+  DEBUG ((DEBUG_INFO , "VarCheckHiiVariable - %s:%g with Attributes = 0x%08x Size = 0x%x\n", VariableName, VendorGuid, Attributes, DataSize));
+  if (HiiVariable->Attributes != Attributes) {
+    DEBUG ((DEBUG_INFO, "VarCheckHiiVariable fail for Attributes - 0x%08x\n", HiiVariable->Attributes));
+    return EFI_SECURITY_VIOLATION;
+  }
 
-      if (HiiVariable->Size != DataSize) {
-        DEBUG ((DEBUG_INFO, "VarCheckHiiVariable fail for Size - 0x%x\n", HiiVariable->Size));
-        return EFI_SECURITY_VIOLATION;
-      }
+  if (DataSize == 0) {
+    DEBUG ((DEBUG_INFO, "VarCheckHiiVariable - CHECK PASS with DataSize == 0 !\n"));
+    return EFI_SUCCESS;
+  }
 
-      //
-      // Do the check.
-      // For Hii Question header align.
-      //
-      HiiQuestion = (VAR_CHECK_HII_QUESTION_HEADER *) HEADER_ALIGN (((UINTN) HiiVariable + HiiVariable->HeaderLength));
-      while ((UINTN) HiiQuestion < ((UINTN) HiiVariable + HiiVariable->Length)) {
-        if (!VarCheckHiiQuestion (HiiQuestion, Data, DataSize)) {
-          return EFI_SECURITY_VIOLATION;
-        }
-        //
-        // For Hii Question header align.
-        //
-        HiiQuestion = (VAR_CHECK_HII_QUESTION_HEADER *) HEADER_ALIGN (((UINTN) HiiQuestion + HiiQuestion->Length));
-      }
+  if (HiiVariable->Size != DataSize) {
+    DEBUG ((DEBUG_INFO, "VarCheckHiiVariable fail for Size - 0x%x\n", HiiVariable->Size));
+    return EFI_SECURITY_VIOLATION;
+  }
 
-      DEBUG ((DEBUG_INFO, "VarCheckHiiVariable - ALL CHECK PASS!\n"));
-      return EFI_SUCCESS;
+  //
+  // Do the check.
+  // For Hii Question header align.
+  //
+  HiiQuestion = (VAR_CHECK_HII_QUESTION_HEADER *) HEADER_ALIGN (((UINTN) HiiVariable + HiiVariable->HeaderLength));
+  while ((UINTN) HiiQuestion < ((UINTN) HiiVariable + HiiVariable->Length)) {
+    if (!VarCheckHiiQuestion (HiiQuestion, Data, DataSize)) {
+      return EFI_SECURITY_VIOLATION;
     }
     //
-    // For Hii Variable header align.
+    // For Hii Question header align.
     //
-    HiiVariable = (VAR_CHECK_HII_VARIABLE_HEADER *) HEADER_ALIGN (((UINTN) HiiVariable + HiiVariable->Length));
+    HiiQuestion = (VAR_CHECK_HII_QUESTION_HEADER *) HEADER_ALIGN (((UINTN) HiiQuestion + HiiQuestion->Length));
   }
 
-  // Not found, so pass.
+  DEBUG ((DEBUG_INFO, "VarCheckHiiVariable - ALL CHECK PASS!\n"));
   return EFI_SUCCESS;
 }
 
@@ -594,6 +740,7 @@ VarCheckHiiLibNullClassConstructor (
 {
   VarCheckLibRegisterEndOfDxeCallback (VarCheckHiiGen);
   VarCheckLibRegisterAddressPointer ((VOID **) &mVarCheckHiiBin);
+  VarCheckLibRegisterAddressPointer ((VOID **) &mVarCheckHiiIndex);    // MU_CHANGE
   VarCheckLibRegisterSetVariableCheckHandler (SetVariableCheckHandlerHii);
 
   return EFI_SUCCESS;
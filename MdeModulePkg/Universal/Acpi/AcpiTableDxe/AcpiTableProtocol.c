@@ -25,6 +25,8 @@ STATIC EFI_ALLOCATE_TYPE      mAcpiTableAllocType;
 /**
   This function adds an ACPI table to the table list.  It will detect FACS and
   allocate the correct type of memory and properly align the table.
+  The RSDP, RSDT and XSDT are not checksummed here, the caller must publish
+  the tables with PublishTables() which checksums them.
 
   @param  AcpiTableInstance         Instance of the protocol.
   @param  Table                     Table to add.
@@ -431,6 +433,8 @@ ReallocateAcpiTableBuffer (
 /**
   This function adds an ACPI table to the table list.  It will detect FACS and
   allocate the correct type of memory and properly align the table.
+  The RSDP, RSDT and XSDT are not checksummed here, the caller must publish
+  the tables with PublishTables() which checksums them.
 
   @param  AcpiTableInstance         Instance of the protocol.
   @param  Table                     Table to add.
@@ -1032,7 +1036,6 @@ AddTableToList (
     }
   }
 
-  ChecksumCommonTables (AcpiTableInstance);
   return EFI_SUCCESS;
 }
 
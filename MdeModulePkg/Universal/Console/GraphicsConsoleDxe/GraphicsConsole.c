@@ -59,8 +59,6 @@ static BOOLEAN              mClearScreen = FALSE;
 
 EFI_GUID             mFontPackageListGuid = {0xf5f219d3, 0x7006, 0x4648, {0xac, 0x8d, 0xd6, 0x1d, 0xfb, 0x7b, 0xc6, 0xad}};
 
-CHAR16               mCrLfString[3] = { CHAR_CARRIAGE_RETURN, CHAR_LINEFEED, CHAR_NULL };
-
 EFI_GRAPHICS_OUTPUT_BLT_PIXEL        mGraphicsEfiColors[16] = {
   //
   // B    G    R   reserved
@@ -908,20 +906,10 @@ GraphicsConsoleConOutOutputString (
   )
 {
   GRAPHICS_CONSOLE_DEV  *Private;
-  EFI_GRAPHICS_OUTPUT_PROTOCOL   *GraphicsOutput;
-  EFI_UGA_DRAW_PROTOCOL *UgaDraw;
   INTN                  Mode;
   UINTN                 MaxColumn;
-  UINTN                 MaxRow;
-  UINTN                 Width;
-  UINTN                 Height;
-  UINTN                 Delta;
   EFI_STATUS            Status;
   BOOLEAN               Warning;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Foreground;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Background;
-  UINTN                 DeltaX;
-  UINTN                 DeltaY;
   UINTN                 Count;
   UINTN                 Index;
   INT32                 OriginAttribute;
@@ -942,21 +930,8 @@ GraphicsConsoleConOutOutputString (
   //
   Mode      = This->Mode->Mode;
   Private   = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
-  GraphicsOutput = Private->GraphicsOutput;
-  UgaDraw   = Private->UgaDraw;
 
   MaxColumn = Private->ModeData[Mode].Columns;
-  MaxRow    = Private->ModeData[Mode].Rows;
-  DeltaX    = (UINTN) Private->ModeData[Mode].DeltaX;
-  DeltaY    = (UINTN) Private->ModeData[Mode].DeltaY;
-  Width     = MaxColumn * EFI_GLYPH_WIDTH;
-  Height    = (MaxRow - 1) * EFI_GLYPH_HEIGHT;
-  Delta     = Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
-
-  //
-  // The Attributes won't change when during the time OutputString is called
-  //
-  GetTextColors (This, &Foreground, &Background);
 
   FlushCursor (This);
 
@@ -1000,75 +975,7 @@ GraphicsConsoleConOutOutputString (
       // row, and do not update the cursor position. Otherwise, move the cursor
       // down one row.
       //
-      if (This->Mode->CursorRow == (INT32) (MaxRow - 1)) {
-        if (GraphicsOutput != NULL) {
-          //
-          // Scroll Screen Up One Row
-          //
-          GraphicsOutput->Blt (
-                    GraphicsOutput,
-                    NULL,
-                    EfiBltVideoToVideo,
-                    DeltaX,
-                    DeltaY + EFI_GLYPH_HEIGHT,
-                    DeltaX,
-                    DeltaY,
-                    Width,
-                    Height,
-                    Delta
-                    );
-
-          //
-          // Print Blank Line at last line
-          //
-          GraphicsOutput->Blt (
-                    GraphicsOutput,
-                    &Background,
-                    EfiBltVideoFill,
-                    0,
-                    0,
-                    DeltaX,
-                    DeltaY + Height,
-                    Width,
-                    EFI_GLYPH_HEIGHT,
-                    Delta
-                    );
-        } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
-          //
-          // Scroll Screen Up One Row
-          //
-          UgaDraw->Blt (
-                    UgaDraw,
-                    NULL,
-                    EfiUgaVideoToVideo,
-                    DeltaX,
-                    DeltaY + EFI_GLYPH_HEIGHT,
-                    DeltaX,
-                    DeltaY,
-                    Width,
-                    Height,
-                    Delta
-                    );
-
-          //
-          // Print Blank Line at last line
-          //
-          UgaDraw->Blt (
-                    UgaDraw,
-                    (EFI_UGA_PIXEL *) (UINTN) &Background,
-                    EfiUgaVideoFill,
-                    0,
-                    0,
-                    DeltaX,
-                    DeltaY + Height,
-                    Width,
-                    EFI_GLYPH_HEIGHT,
-                    Delta
-                    );
-        }
-      } else {
-        This->Mode->CursorRow++;
-      }
+      LineFeed (This);
 
       WString++;
 
@@ -1147,9 +1054,13 @@ GraphicsConsoleConOutOutputString (
       }
 
       if (This->Mode->CursorColumn >= (INT32) MaxColumn) {
-        FlushCursor (This);
-        This->OutputString (This, mCrLfString);
-        FlushCursor (This);
+        //
+        // Wrap to the next line directly. Outputting a CR/LF string here
+        // would show and hide the cursor twice for no visible change, each
+        // time reading the glyph cell back from the frame buffer.
+        //
+        This->Mode->CursorColumn = 0;
+        LineFeed (This);
       }
     }
   }
@@ -2022,6 +1933,116 @@ FlushCursor (
   return EFI_SUCCESS;
 }
 
+/**
+  Move the cursor down one row. If the cursor is on the last row, scroll the
+  screen up one row and leave the cursor where it is instead.
+
+  @param  This                  Protocol instance pointer.
+
+**/
+VOID
+LineFeed (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
+  )
+{
+  GRAPHICS_CONSOLE_DEV           *Private;
+  EFI_GRAPHICS_OUTPUT_PROTOCOL   *GraphicsOutput;
+  EFI_UGA_DRAW_PROTOCOL          *UgaDraw;
+  INTN                           Mode;
+  UINTN                          MaxRow;
+  UINTN                          Width;
+  UINTN                          Height;
+  UINTN                          Delta;
+  UINTN                          DeltaX;
+  UINTN                          DeltaY;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Foreground;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Background;
+
+  Mode           = This->Mode->Mode;
+  Private        = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
+  GraphicsOutput = Private->GraphicsOutput;
+  UgaDraw        = Private->UgaDraw;
+
+  MaxRow    = Private->ModeData[Mode].Rows;
+  DeltaX    = (UINTN) Private->ModeData[Mode].DeltaX;
+  DeltaY    = (UINTN) Private->ModeData[Mode].DeltaY;
+  Width     = Private->ModeData[Mode].Columns * EFI_GLYPH_WIDTH;
+  Height    = (MaxRow - 1) * EFI_GLYPH_HEIGHT;
+  Delta     = Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+
+  GetTextColors (This, &Foreground, &Background);
+
+  if (This->Mode->CursorRow == (INT32) (MaxRow - 1)) {
+    if (GraphicsOutput != NULL) {
+      //
+      // Scroll Screen Up One Row
+      //
+      GraphicsOutput->Blt (
+                GraphicsOutput,
+                NULL,
+                EfiBltVideoToVideo,
+                DeltaX,
+                DeltaY + EFI_GLYPH_HEIGHT,
+                DeltaX,
+                DeltaY,
+                Width,
+                Height,
+                Delta
+                );
+
+      //
+      // Print Blank Line at last line
+      //
+      GraphicsOutput->Blt (
+                GraphicsOutput,
+                &Background,
+                EfiBltVideoFill,
+                0,
+                0,
+                DeltaX,
+                DeltaY + Height,
+                Width,
+                EFI_GLYPH_HEIGHT,
+                Delta
+                );
+    } else if (FeaturePcdGet (PcdUgaConsumeSupport)) {
+      //
+      // Scroll Screen Up One Row
+      //
+      UgaDraw->Blt (
+                UgaDraw,
+                NULL,
+                EfiUgaVideoToVideo,
+                DeltaX,
+                DeltaY + EFI_GLYPH_HEIGHT,
+                DeltaX,
+                DeltaY,
+                Width,
+                Height,
+                Delta
+                );
+
+      //
+      // Print Blank Line at last line
+      //
+      UgaDraw->Blt (
+                UgaDraw,
+                (EFI_UGA_PIXEL *) (UINTN) &Background,
+                EfiUgaVideoFill,
+                0,
+                0,
+                DeltaX,
+                DeltaY + Height,
+                Width,
+                EFI_GLYPH_HEIGHT,
+                Delta
+                );
+    }
+  } else {
+    This->Mode->CursorRow++;
+  }
+}
+
 /**
   HII Database Protocol notification event handler.
 
@@ -564,6 +564,18 @@ FlushCursor (
   IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
   );
 
+/**
+  Move the cursor down one row. If the cursor is on the last row, scroll the
+  screen up one row and leave the cursor where it is instead.
+
+  @param  This                  Protocol instance pointer.
+
+**/
+VOID
+LineFeed (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This
+  );
+
 /**
   Check if the current specific mode supported the user defined resolution
   for the Graphics Console device based on Graphics Output Protocol.
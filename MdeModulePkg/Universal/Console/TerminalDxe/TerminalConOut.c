@@ -9,6 +9,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Terminal.h"
 
+//
+// OutputString collects the bytes it sends to the serial device and writes
+// them in blocks of up to TERMINAL_OUTPUT_BUFFER_SIZE bytes. One character
+// produces at most TERMINAL_OUTPUT_MAX_CHAR_BYTES bytes: a 3-byte UTF-8
+// sequence, or a character followed by the CR LF of a TTY line wrap.
+//
+#define TERMINAL_OUTPUT_BUFFER_SIZE     64
+#define TERMINAL_OUTPUT_MAX_CHAR_BYTES  5
+
 //
 // This list is used to define the valid extend chars.
 // It also provides a mapping from Unicode to PCANSI or
@@ -176,13 +185,13 @@ TerminalConOutOutputString (
   EFI_SIMPLE_TEXT_OUTPUT_MODE *Mode;
   UINTN                       MaxColumn;
   UINTN                       MaxRow;
-  UINTN                       Length;
   UTF8_CHAR                   Utf8Char;
   CHAR8                       GraphicChar;
   CHAR8                       AsciiChar;
   EFI_STATUS                  Status;
   UINT8                       ValidBytes;
-  CHAR8                       CrLfStr[2];
+  UINT8                       OutputBuffer[TERMINAL_OUTPUT_BUFFER_SIZE];
+  UINTN                       OutputLength;
   //
   //  flag used to indicate whether condition happens which will cause
   //  return EFI_WARN_UNKNOWN_GLYPH
@@ -214,7 +223,24 @@ TerminalConOutOutputString (
           &MaxRow
           );
 
+  OutputLength = 0;
   for (; *WString != CHAR_NULL; WString++) {
+    //
+    // Send the collected bytes once there may not be room for this character.
+    // Writing whole blocks keeps the UART FIFO filled instead of waiting for
+    // it to drain after every byte.
+    //
+    if (OutputLength + TERMINAL_OUTPUT_MAX_CHAR_BYTES > sizeof (OutputBuffer)) {
+      Status = TerminalDevice->SerialIo->Write (
+                                          TerminalDevice->SerialIo,
+                                          &OutputLength,
+                                          OutputBuffer
+                                          );
+      if (EFI_ERROR (Status)) {
+        goto OutputError;
+      }
+      OutputLength = 0;
+    }
 
     switch (TerminalDevice->TerminalType) {
 
@@ -255,31 +281,13 @@ TerminalConOutOutputString (
         GraphicChar = AsciiChar;
       }
 
-      Length = 1;
-
-      Status = TerminalDevice->SerialIo->Write (
-                                          TerminalDevice->SerialIo,
-                                          &Length,
-                                          &GraphicChar
-                                          );
-
-      if (EFI_ERROR (Status)) {
-        goto OutputError;
-      }
-
+      OutputBuffer[OutputLength++] = (UINT8) GraphicChar;
       break;
 
     case TerminalTypeVtUtf8:
       UnicodeToUtf8 (*WString, &Utf8Char, &ValidBytes);
-      Length = ValidBytes;
-      Status = TerminalDevice->SerialIo->Write (
-                                          TerminalDevice->SerialIo,
-                                          &Length,
-                                          (UINT8 *) &Utf8Char
-                                          );
-      if (EFI_ERROR (Status)) {
-        goto OutputError;
-      }
+      CopyMem (&OutputBuffer[OutputLength], &Utf8Char, ValidBytes);
+      OutputLength += ValidBytes;
       break;
     }
     //
@@ -325,20 +333,8 @@ TerminalConOutOutputString (
           // the driver, but only if we're not in the middle of
           // printing an escape sequence.
           //
-          CrLfStr[0] = '\r';
-          CrLfStr[1] = '\n';
-
-          Length = sizeof(CrLfStr);
-
-          Status = TerminalDevice->SerialIo->Write (
-                                                TerminalDevice->SerialIo,
-                                                &Length,
-                                                CrLfStr
-                                                );
-
-          if (EFI_ERROR (Status)) {
-            goto OutputError;
-          }
+          OutputBuffer[OutputLength++] = '\r';
+          OutputBuffer[OutputLength++] = '\n';
         }
       }
       break;
@@ -347,6 +343,17 @@ TerminalConOutOutputString (
 
   }
 
+  if (OutputLength != 0) {
+    Status = TerminalDevice->SerialIo->Write (
+                                        TerminalDevice->SerialIo,
+                                        &OutputLength,
+                                        OutputBuffer
+                                        );
+    if (EFI_ERROR (Status)) {
+      goto OutputError;
+    }
+  }
+
   if (Warning) {
     return EFI_WARN_UNKNOWN_GLYPH;
   }
@@ -805,6 +812,15 @@ TerminalConOutSetCursorPosition (
       String = L"";  // No cursor motion necessary
     }
   }
+  else if ((UINTN)Mode->CursorRow == Row && (UINTN)Mode->CursorColumn == Column && Column != 0) {
+    //
+    // The cursor is already there, so don't send the sequence. Column 0 is
+    // excluded because after the last column of a line is written the
+    // driver already reports column 0 of the next row, while the terminal
+    // may still have the wrap pending.
+    //
+    String = L"";
+  }
   else {
     mSetCursorPositionString[ROW_OFFSET + 0]    = (CHAR16) ('0' + ((Row + 1) / 10));
     mSetCursorPositionString[ROW_OFFSET + 1]    = (CHAR16) ('0' + ((Row + 1) % 10));
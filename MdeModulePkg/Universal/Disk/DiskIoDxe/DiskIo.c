@@ -185,6 +185,8 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  DiskIoCacheInitialize (Instance);  // MU_CHANGE
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -213,6 +215,7 @@ ErrorExit:
     }
 
     if (Instance != NULL) {
+      DiskIoCacheFree (Instance);  // MU_CHANGE
       FreePool (Instance);
     }
 
@@ -320,6 +323,7 @@ DiskIoDriverBindingStop (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
       );
+    DiskIoCacheFree (Instance);  // MU_CHANGE
 
     Status = gBS->CloseProtocol (
                     ControllerHandle,
@@ -420,6 +424,12 @@ DiskIo2OnReadWriteComplete (
     CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
   }
 
+  // MU_CHANGE [BEGIN] - Block cache with read-ahead
+  if (Subtask->Write) {
+    DiskIoCacheWriteComplete ();
+  }
+  // MU_CHANGE [END]
+
   DiskIoDestroySubtask (Instance, Subtask);
 
   if (EFI_ERROR (TransactionStatus) || IsListEmpty (&Task->Subtasks)) {
@@ -853,6 +863,19 @@ DiskIo2ReadWriteDisk (
     SubtasksPtr = &Task->Subtasks;
   }
 
+  // MU_CHANGE [BEGIN] - Block cache with read-ahead
+  //
+  // Small blocking reads are served from the block cache when there is one.
+  //
+  if (!Write && Blocking && (Instance->Cache != NULL)) {
+    Status = DiskIoCacheRead (Instance, MediaId, Offset, BufferSize, Buffer);
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+    Status = EFI_SUCCESS;
+  }
+  // MU_CHANGE [END]
+
   InitializeListHead (SubtasksPtr);
   if (!DiskIoCreateSubtaskList (Instance, Write, Offset, BufferSize, Buffer, Blocking, Instance->SharedWorkingBuffer, SubtasksPtr)) {
     if (Task != NULL) {
@@ -863,6 +886,16 @@ DiskIo2ReadWriteDisk (
   ASSERT (!IsListEmpty (SubtasksPtr));
 
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  // MU_CHANGE [BEGIN] - Block cache with read-ahead
+  //
+  // Nothing can fill a cache at TPL_CALLBACK before the writes are done.
+  //
+  if (Write) {
+    DiskIoCacheWrite (Instance, Offset, BufferSize);
+  }
+  // MU_CHANGE [END]
+
   for ( Link = GetFirstNode (SubtasksPtr), NextLink = GetNextNode (SubtasksPtr, Link)
       ; !IsNull (SubtasksPtr, Link)
       ; Link = NextLink, NextLink = GetNextNode (SubtasksPtr, NextLink)
@@ -1114,6 +1147,8 @@ DiskIo2FlushDiskEx (
 
   Private = DISK_IO_PRIVATE_DATA_FROM_DISK_IO2 (This);
 
+  DiskIoCacheFlush (Private);  // MU_CHANGE
+
   if ((Token != NULL) && (Token->Event != NULL)) {
     Task = AllocatePool (sizeof (DISK_IO2_FLUSH_TASK));
     if (Task == NULL) {
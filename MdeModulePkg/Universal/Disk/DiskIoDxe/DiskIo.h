@@ -24,6 +24,53 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+// MU_CHANGE [BEGIN] - Block cache with read-ahead
+//
+// The block cache is made of lines of DISK_IO_CACHE_LINE_SIZE bytes, or of
+// one block when blocks are larger.
+//
+#define DISK_IO_CACHE_LINE_SIZE         SIZE_4KB
+#define DISK_IO_CACHE_HASH_BUCKETS      64
+#define DISK_IO_CACHE_NO_LINE           MAX_UINT64
+
+//
+// A miss on the line that follows the previous miss reads up to this many
+// more lines.
+//
+#define DISK_IO_CACHE_READ_AHEAD_LINES  15
+
+//
+// Blocking reads of at most this many lines go through the cache.
+//
+#define DISK_IO_CACHE_MAX_READ_LINES    4
+
+typedef struct {
+  LIST_ENTRY                      LruLink;
+  LIST_ENTRY                      HashLink;  /// < Not in a bucket when Line is DISK_IO_CACHE_NO_LINE
+  UINT64                          Line;
+  UINT8                           *Data;
+} DISK_IO_CACHE_LINE;
+
+typedef struct {
+  UINT32                          MediaId;
+  UINT32                          Generation;
+  UINT32                          LineBlocks;
+  UINT32                          LineSize;
+  UINTN                           LineCount;
+  UINTN                           MaxFillLines;
+  UINT64                          NextLine;  /// < The line after the last fill
+  DISK_IO_CACHE_LINE              *Lines;
+  UINT8                           *Data;
+  UINT8                           *FillBuffer;
+  LIST_ENTRY                      Lru;       /// < Most recently used first
+  LIST_ENTRY                      Hash[DISK_IO_CACHE_HASH_BUCKETS];
+
+  UINT64                          Hits;
+  UINT64                          Misses;
+  UINT64                          ReadAheadLines;
+} DISK_IO_CACHE;
+// MU_CHANGE [END]
+
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
   UINT32                          Signature;
@@ -37,6 +84,8 @@ typedef struct {
 
   EFI_LOCK                        TaskQueueLock;
   LIST_ENTRY                      TaskQueue;
+
+  DISK_IO_CACHE                   *Cache;      // MU_CHANGE - NULL when the instance has no block cache
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a) CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -463,5 +512,89 @@ DiskIoComponentNameGetControllerName (
   OUT CHAR16                                          **ControllerName
   );
 
+// MU_CHANGE [BEGIN] - Block cache with read-ahead
+/**
+  Set up the block cache of a Disk I/O instance.
+
+  Nothing is done when PcdDiskIoCacheSize is 0 or the medium is removable.
+  The instance works without a cache when the cache cannot be allocated.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheInitialize (
+  IN OUT DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Free the block cache of a Disk I/O instance.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFree (
+  IN OUT DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Read from the block cache of a Disk I/O instance.
+
+  The lines that are not cached are read from the device.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium to read.
+  @param Offset      The starting byte offset on the device.
+  @param BufferSize  The number of bytes to read.
+  @param Buffer      The buffer that receives the data.
+
+  @retval EFI_SUCCESS      The data was read.
+  @retval EFI_UNSUPPORTED  The read does not go through the cache. Nothing
+                           was read.
+  @retval Others           The device failed to read the missing lines.
+**/
+EFI_STATUS
+DiskIoCacheRead (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer
+  );
+
+/**
+  Invalidate the cached data that a write through a Disk I/O instance
+  changes.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Offset      The starting byte offset on the device.
+  @param BufferSize  The number of bytes written.
+**/
+VOID
+DiskIoCacheWrite (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  );
+
+/**
+  Invalidate the cached data after a non-blocking write completes.
+
+  This is called at TPL_NOTIFY.
+**/
+VOID
+DiskIoCacheWriteComplete (
+  VOID
+  );
+
+/**
+  Invalidate the block cache of a Disk I/O instance.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFlush (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+// MU_CHANGE [END]
 
 #endif
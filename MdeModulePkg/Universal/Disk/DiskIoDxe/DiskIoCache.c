@@ -0,0 +1,502 @@
+/** @file
+  Block cache of the Disk I/O driver.
+
+  When PcdDiskIoCacheSize is not 0, each Disk I/O instance of a non removable
+  medium keeps the lines that small blocking reads touched, and drops the
+  least recently used one when it needs room. A miss on the line that follows
+  the previous miss also reads the next lines in the same device request.
+
+  A write through any Disk I/O instance invalidates the caches of the other
+  instances, because the same blocks may be cached at other offsets by the
+  instances of the disk and of its partitions. Its own cache only loses the
+  written lines. A flush or a new MediaId invalidates the cache of the
+  instance. Writes that do not go through a Disk I/O instance are not seen.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DiskIo.h"
+
+#define DISK_IO_CACHE_BUCKET(Line)  ((UINTN)(Line) & (DISK_IO_CACHE_HASH_BUCKETS - 1))
+
+//
+// Incremented by every write, at TPL_NOTIFY. A cache whose Generation is
+// different is invalidated before it is used.
+//
+UINT32  mDiskIoCacheGeneration = 0;
+
+/**
+  Find a line in the cache.
+
+  @param Cache       The block cache.
+  @param Line        The line number on the device.
+
+  @return The cached line, or NULL if the line is not cached.
+**/
+STATIC
+DISK_IO_CACHE_LINE *
+DiskIoCacheFindLine (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Line
+  )
+{
+  LIST_ENTRY          *Head;
+  LIST_ENTRY          *Link;
+  DISK_IO_CACHE_LINE  *CacheLine;
+
+  Head = &Cache->Hash[DISK_IO_CACHE_BUCKET (Line)];
+  for (Link = GetFirstNode (Head); !IsNull (Head, Link); Link = GetNextNode (Head, Link)) {
+    CacheLine = BASE_CR (Link, DISK_IO_CACHE_LINE, HashLink);
+    if (CacheLine->Line == Line) {
+      return CacheLine;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Drop a line from the cache. Its entry becomes the least recently used one.
+
+  @param Cache       The block cache.
+  @param CacheLine   The line to drop.
+**/
+STATIC
+VOID
+DiskIoCacheDropLine (
+  IN DISK_IO_CACHE       *Cache,
+  IN DISK_IO_CACHE_LINE  *CacheLine
+  )
+{
+  if (CacheLine->Line != DISK_IO_CACHE_NO_LINE) {
+    RemoveEntryList (&CacheLine->HashLink);
+    CacheLine->Line = DISK_IO_CACHE_NO_LINE;
+  }
+
+  RemoveEntryList (&CacheLine->LruLink);
+  InsertTailList (&Cache->Lru, &CacheLine->LruLink);
+}
+
+/**
+  Drop all the lines from the cache.
+
+  @param Cache       The block cache.
+**/
+STATIC
+VOID
+DiskIoCacheDropAll (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Cache->LineCount; Index++) {
+    DiskIoCacheDropLine (Cache, &Cache->Lines[Index]);
+  }
+
+  Cache->NextLine = DISK_IO_CACHE_NO_LINE;
+}
+
+/**
+  Invalidate the cache if a write or a media change happened since it was
+  last used.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+STATIC
+VOID
+DiskIoCacheValidate (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  DISK_IO_CACHE  *Cache;
+
+  Cache = Instance->Cache;
+  if ((Cache->Generation != mDiskIoCacheGeneration) ||
+      (Cache->MediaId != Instance->BlockIo->Media->MediaId)) {
+    DiskIoCacheDropAll (Cache);
+    Cache->Generation = mDiskIoCacheGeneration;
+    Cache->MediaId    = Instance->BlockIo->Media->MediaId;
+  }
+}
+
+/**
+  Read a missing line, and the lines after it when the reads are sequential.
+
+  The caller must be at TPL_CALLBACK.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Line        The missing line.
+  @param CacheLine   On return, the cached line.
+
+  @retval EFI_SUCCESS The line was read.
+  @retval Others      The device failed to read the line.
+**/
+STATIC
+EFI_STATUS
+DiskIoCacheFill (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT64                Line,
+  OUT DISK_IO_CACHE_LINE    **CacheLine
+  )
+{
+  DISK_IO_CACHE          *Cache;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  EFI_BLOCK_IO_MEDIA     *Media;
+  EFI_STATUS             Status;
+  UINT64                 LastLine;
+  UINT64                 Lba;
+  UINT64                 Blocks;
+  UINTN                  Count;
+  UINTN                  Index;
+  DISK_IO_CACHE_LINE     *Entry;
+
+  Cache    = Instance->Cache;
+  BlockIo  = Instance->BlockIo;
+  Media    = BlockIo->Media;
+  LastLine = DivU64x32 (Media->LastBlock, Cache->LineBlocks);
+  Lba      = MultU64x32 (Line, Cache->LineBlocks);
+
+  Count = 1;
+  if (Line == Cache->NextLine) {
+    while ((Count < Cache->MaxFillLines) &&
+           (Line + Count <= LastLine) &&
+           (DiskIoCacheFindLine (Cache, Line + Count) == NULL)) {
+      Count++;
+    }
+  }
+
+  Blocks = MIN (MultU64x32 (Count, Cache->LineBlocks), Media->LastBlock + 1 - Lba);
+  Status = BlockIo->ReadBlocks (
+                      BlockIo,
+                      Media->MediaId,
+                      Lba,
+                      (UINTN)Blocks * Media->BlockSize,
+                      Cache->FillBuffer
+                      );
+  if (EFI_ERROR (Status) && (Count > 1)) {
+    //
+    // Do not fail the read for blocks that it does not need.
+    //
+    Count  = 1;
+    Blocks = MIN (Cache->LineBlocks, Media->LastBlock + 1 - Lba);
+    Status = BlockIo->ReadBlocks (
+                        BlockIo,
+                        Media->MediaId,
+                        Lba,
+                        (UINTN)Blocks * Media->BlockSize,
+                        Cache->FillBuffer
+                        );
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Take the least recently used entries. The missing line is inserted last,
+  // so it is the most recently used one.
+  //
+  Entry = NULL;
+  for (Index = Count; Index > 0; Index--) {
+    Entry = BASE_CR (GetPreviousNode (&Cache->Lru, &Cache->Lru), DISK_IO_CACHE_LINE, LruLink);
+    DiskIoCacheDropLine (Cache, Entry);
+
+    Entry->Line = Line + Index - 1;
+    CopyMem (Entry->Data, Cache->FillBuffer + (Index - 1) * Cache->LineSize, Cache->LineSize);
+    InsertTailList (&Cache->Hash[DISK_IO_CACHE_BUCKET (Entry->Line)], &Entry->HashLink);
+    RemoveEntryList (&Entry->LruLink);
+    InsertHeadList (&Cache->Lru, &Entry->LruLink);
+  }
+
+  Cache->ReadAheadLines += Count - 1;
+  Cache->NextLine        = Line + Count;
+  *CacheLine             = Entry;
+  return EFI_SUCCESS;
+}
+
+/**
+  Set up the block cache of a Disk I/O instance.
+
+  Nothing is done when PcdDiskIoCacheSize is 0 or the medium is removable.
+  The instance works without a cache when the cache cannot be allocated.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheInitialize (
+  IN OUT DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+  DISK_IO_CACHE       *Cache;
+  UINTN               Index;
+
+  //
+  // A removable medium may only report a change when it is accessed.
+  //
+  Media = Instance->BlockIo->Media;
+  if ((PcdGet32 (PcdDiskIoCacheSize) == 0) || Media->RemovableMedia || (Media->BlockSize == 0)) {
+    return;
+  }
+
+  Cache = AllocateZeroPool (sizeof (DISK_IO_CACHE));
+  if (Cache == NULL) {
+    return;
+  }
+
+  Cache->LineBlocks = MAX (DISK_IO_CACHE_LINE_SIZE / Media->BlockSize, 1);
+  Cache->LineSize   = Cache->LineBlocks * Media->BlockSize;
+  Cache->LineCount  = PcdGet32 (PcdDiskIoCacheSize) / Cache->LineSize;
+  if (Cache->LineCount == 0) {
+    FreePool (Cache);
+    return;
+  }
+
+  Cache->MaxFillLines = MIN (DISK_IO_CACHE_READ_AHEAD_LINES + 1, Cache->LineCount);
+  Cache->Generation   = mDiskIoCacheGeneration;
+  Cache->MediaId      = Media->MediaId;
+  Cache->NextLine     = DISK_IO_CACHE_NO_LINE;
+  Cache->Lines        = AllocateZeroPool (Cache->LineCount * sizeof (DISK_IO_CACHE_LINE));
+  Cache->Data         = AllocatePages (EFI_SIZE_TO_PAGES (Cache->LineCount * Cache->LineSize));
+  Cache->FillBuffer   = AllocateAlignedPages (
+                          EFI_SIZE_TO_PAGES (Cache->MaxFillLines * Cache->LineSize),
+                          Media->IoAlign
+                          );
+  Instance->Cache = Cache;
+  if ((Cache->Lines == NULL) || (Cache->Data == NULL) || (Cache->FillBuffer == NULL)) {
+    DEBUG ((DEBUG_WARN, "DiskIo: Block cache of %ld lines cannot be allocated\n", (UINT64)Cache->LineCount));
+    DiskIoCacheFree (Instance);
+    return;
+  }
+
+  InitializeListHead (&Cache->Lru);
+  for (Index = 0; Index < DISK_IO_CACHE_HASH_BUCKETS; Index++) {
+    InitializeListHead (&Cache->Hash[Index]);
+  }
+
+  for (Index = 0; Index < Cache->LineCount; Index++) {
+    Cache->Lines[Index].Line = DISK_IO_CACHE_NO_LINE;
+    Cache->Lines[Index].Data = Cache->Data + Index * Cache->LineSize;
+    InsertTailList (&Cache->Lru, &Cache->Lines[Index].LruLink);
+  }
+}
+
+/**
+  Free the block cache of a Disk I/O instance.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFree (
+  IN OUT DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  DISK_IO_CACHE  *Cache;
+
+  Cache = Instance->Cache;
+  if (Cache == NULL) {
+    return;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "DiskIo: Block cache hits/misses/read-ahead lines = %ld/%ld/%ld\n",
+    Cache->Hits,
+    Cache->Misses,
+    Cache->ReadAheadLines
+    ));
+
+  if (Cache->FillBuffer != NULL) {
+    FreeAlignedPages (Cache->FillBuffer, EFI_SIZE_TO_PAGES (Cache->MaxFillLines * Cache->LineSize));
+  }
+
+  if (Cache->Data != NULL) {
+    FreePages (Cache->Data, EFI_SIZE_TO_PAGES (Cache->LineCount * Cache->LineSize));
+  }
+
+  if (Cache->Lines != NULL) {
+    FreePool (Cache->Lines);
+  }
+
+  FreePool (Cache);
+  Instance->Cache = NULL;
+}
+
+/**
+  Read from the block cache of a Disk I/O instance.
+
+  The lines that are not cached are read from the device.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium to read.
+  @param Offset      The starting byte offset on the device.
+  @param BufferSize  The number of bytes to read.
+  @param Buffer      The buffer that receives the data.
+
+  @retval EFI_SUCCESS      The data was read.
+  @retval EFI_UNSUPPORTED  The read does not go through the cache. Nothing
+                           was read.
+  @retval Others           The device failed to read the missing lines.
+**/
+EFI_STATUS
+DiskIoCacheRead (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  DISK_IO_CACHE_LINE  *CacheLine;
+  EFI_STATUS          Status;
+  EFI_TPL             OldTpl;
+  UINT64              MediaSize;
+  UINT64              Line;
+  UINT32              LineOffset;
+  UINTN               Length;
+
+  Cache = Instance->Cache;
+  Media = Instance->BlockIo->Media;
+
+  //
+  // Large reads, and reads that the device must fail, are not cached.
+  //
+  if ((BufferSize == 0) ||
+      (BufferSize > DISK_IO_CACHE_MAX_READ_LINES * Cache->LineSize) ||
+      (MediaId != Media->MediaId) ||
+      !Media->MediaPresent) {
+    return EFI_UNSUPPORTED;
+  }
+
+  MediaSize = MultU64x32 (Media->LastBlock + 1, Media->BlockSize);
+  if ((Offset > MediaSize) || (BufferSize > MediaSize - Offset)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  DiskIoCacheValidate (Instance);
+
+  Status = EFI_SUCCESS;
+  while (BufferSize > 0) {
+    Line      = DivU64x32Remainder (Offset, Cache->LineSize, &LineOffset);
+    CacheLine = DiskIoCacheFindLine (Cache, Line);
+    if (CacheLine != NULL) {
+      Cache->Hits++;
+      RemoveEntryList (&CacheLine->LruLink);
+      InsertHeadList (&Cache->Lru, &CacheLine->LruLink);
+    } else {
+      Cache->Misses++;
+      Status = DiskIoCacheFill (Instance, Line, &CacheLine);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+
+    Length = MIN (BufferSize, Cache->LineSize - LineOffset);
+    CopyMem (Buffer, CacheLine->Data + LineOffset, Length);
+    Buffer     += Length;
+    Offset     += Length;
+    BufferSize -= Length;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Invalidate the cached data that a write through a Disk I/O instance
+  changes.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Offset      The starting byte offset on the device.
+  @param BufferSize  The number of bytes written.
+**/
+VOID
+DiskIoCacheWrite (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  DISK_IO_CACHE_LINE  *CacheLine;
+  EFI_TPL             OldTpl;
+  UINT64              Line;
+  UINT64              LastLine;
+
+  if ((PcdGet32 (PcdDiskIoCacheSize) == 0) || (BufferSize == 0)) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Cache = Instance->Cache;
+  if (Cache != NULL) {
+    DiskIoCacheValidate (Instance);
+
+    Line     = DivU64x32 (Offset, Cache->LineSize);
+    LastLine = (Offset + BufferSize - 1 < Offset)
+               ? DISK_IO_CACHE_NO_LINE
+               : DivU64x32 (Offset + BufferSize - 1, Cache->LineSize);
+    if (LastLine - Line >= Cache->LineCount) {
+      DiskIoCacheDropAll (Cache);
+    } else {
+      for ( ; Line <= LastLine; Line++) {
+        CacheLine = DiskIoCacheFindLine (Cache, Line);
+        if (CacheLine != NULL) {
+          DiskIoCacheDropLine (Cache, CacheLine);
+        }
+      }
+    }
+  }
+
+  //
+  // The other instances drop everything. This one is up to date again.
+  //
+  gBS->RaiseTPL (TPL_NOTIFY);
+  mDiskIoCacheGeneration++;
+  if ((Cache != NULL) && (Cache->Generation + 1 == mDiskIoCacheGeneration)) {
+    Cache->Generation = mDiskIoCacheGeneration;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Invalidate the cached data after a non-blocking write completes.
+
+  This is called at TPL_NOTIFY.
+**/
+VOID
+DiskIoCacheWriteComplete (
+  VOID
+  )
+{
+  mDiskIoCacheGeneration++;
+}
+
+/**
+  Invalidate the block cache of a Disk I/O instance.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheFlush (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (Instance->Cache == NULL) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  DiskIoCacheDropAll (Instance->Cache);
+  gBS->RestoreTPL (OldTpl);
+}
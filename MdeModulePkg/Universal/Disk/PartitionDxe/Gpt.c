@@ -22,6 +22,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Partition.h"
 
+//
+// Size of the partition entry array most partitioning tools create: 128
+// entries of 128 bytes.
+//
+#define GPT_DEFAULT_ENTRY_ARRAY_SIZE  (128 * sizeof (EFI_PARTITION_ENTRY))
+
 /**
   Install child handles if the Handle supports GPT partition structure.
 
@@ -33,6 +39,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   @param[in]  DiskIo      Disk Io protocol.
   @param[in]  Lba         The starting Lba of the Partition Table
   @param[out] PartHeader  Stores the partition table that is read
+  @param[out] PartEntry   If not NULL, returns the partition entry array of
+                          the valid partition table, allocated by this function.
 
   @retval TRUE      The partition table is valid
   @retval FALSE     The partition table is not valid
@@ -43,16 +51,16 @@ PartitionValidGptTable (
   IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
   IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
   IN  EFI_LBA                     Lba,
-  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT EFI_PARTITION_ENTRY         **PartEntry OPTIONAL
   );
 
 /**
   Check if the CRC field in the Partition table header is valid
   for Partition entry array.
 
-  @param[in]  BlockIo     Parent BlockIo interface
-  @param[in]  DiskIo      Disk Io Protocol.
   @param[in]  PartHeader  Partition table header structure
+  @param[in]  PartEntry   The partition entry array
 
   @retval TRUE      the CRC is valid
   @retval FALSE     the CRC is invalid
@@ -60,9 +68,8 @@ PartitionValidGptTable (
 **/
 BOOLEAN
 PartitionCheckGptEntryArrayCRC (
-  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
-  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
-  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  IN  VOID                        *PartEntry
   );
 
 
@@ -291,10 +298,10 @@ PartitionInstallGptChildHandles (
   //
   // Check primary and backup partition tables
   //
-  if (!PartitionValidGptTable (BlockIo, DiskIo, PRIMARY_PART_HEADER_LBA, PrimaryHeader)) {
+  if (!PartitionValidGptTable (BlockIo, DiskIo, PRIMARY_PART_HEADER_LBA, PrimaryHeader, &PartEntry)) {
     DEBUG ((EFI_D_INFO, " Not Valid primary partition table\n"));
 
-    if (!PartitionValidGptTable (BlockIo, DiskIo, LastBlock, BackupHeader)) {
+    if (!PartitionValidGptTable (BlockIo, DiskIo, LastBlock, BackupHeader, NULL)) {
       DEBUG ((EFI_D_INFO, " Not Valid backup partition table\n"));
       goto Done;
     } else {
@@ -304,18 +311,18 @@ PartitionInstallGptChildHandles (
         DEBUG ((EFI_D_INFO, " Restore primary partition table error\n"));
       }
 
-      if (PartitionValidGptTable (BlockIo, DiskIo, BackupHeader->AlternateLBA, PrimaryHeader)) {
+      if (PartitionValidGptTable (BlockIo, DiskIo, BackupHeader->AlternateLBA, PrimaryHeader, &PartEntry)) {
         DEBUG ((EFI_D_INFO, " Restore backup partition table success\n"));
       }
     }
-  } else if (!PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
+  } else if (!PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader, NULL)) {
     DEBUG ((EFI_D_INFO, " Valid primary and !Valid backup partition table\n"));
     DEBUG ((EFI_D_INFO, " Restore backup partition table by the primary\n"));
     if (!PartitionRestoreGptTable (BlockIo, DiskIo, PrimaryHeader)) {
       DEBUG ((EFI_D_INFO, " Restore backup partition table error\n"));
     }
 
-    if (PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
+    if (PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader, NULL)) {
       DEBUG ((EFI_D_INFO, " Restore backup partition table success\n"));
     }
 
@@ -324,28 +331,31 @@ PartitionInstallGptChildHandles (
   DEBUG ((EFI_D_INFO, " Valid primary and Valid backup partition table\n"));
 
   //
-  // Read the EFI Partition Entries
+  // Read the EFI Partition Entries, unless they were already read along with
+  // the valid primary partition table header.
   //
-  PartEntry = AllocatePool (PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry);
   if (PartEntry == NULL) {
-    DEBUG ((EFI_D_ERROR, "Allocate pool error\n"));
-    goto Done;
-  }
+    PartEntry = AllocatePool (PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry);
+    if (PartEntry == NULL) {
+      DEBUG ((EFI_D_ERROR, "Allocate pool error\n"));
+      goto Done;
+    }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32(PrimaryHeader->PartitionEntryLBA, BlockSize),
-                     PrimaryHeader->NumberOfPartitionEntries * (PrimaryHeader->SizeOfPartitionEntry),
-                     PartEntry
-                     );
-  if (EFI_ERROR (Status)) {
-    GptValidStatus = Status;
-    DEBUG ((EFI_D_ERROR, " Partition Entry ReadDisk error\n"));
-    goto Done;
-  }
+    Status = DiskIo->ReadDisk (
+                       DiskIo,
+                       MediaId,
+                       MultU64x32(PrimaryHeader->PartitionEntryLBA, BlockSize),
+                       PrimaryHeader->NumberOfPartitionEntries * (PrimaryHeader->SizeOfPartitionEntry),
+                       PartEntry
+                       );
+    if (EFI_ERROR (Status)) {
+      GptValidStatus = Status;
+      DEBUG ((EFI_D_ERROR, " Partition Entry ReadDisk error\n"));
+      goto Done;
+    }
 
-  DEBUG ((EFI_D_INFO, " Partition entries read block success\n"));
+    DEBUG ((EFI_D_INFO, " Partition entries read block success\n"));
+  }
 
   DEBUG ((EFI_D_INFO, " Number of partition entries: %d\n", PrimaryHeader->NumberOfPartitionEntries));
 
@@ -451,6 +461,12 @@ Done:
 /**
   This routine will read GPT partition table header and return it.
 
+  The partition entry array normally directly follows the primary header and
+  directly precedes the backup header. The blocks a default sized array
+  occupies there are read along with the header in a single I/O, so a valid
+  table usually costs one read instead of two, which is noticeable on slow
+  virtual media and network disks.
+
   Caution: This function may receive untrusted input.
   The GPT partition table header is external input, so this routine
   will do basic validation for GPT partition table header before return.
@@ -459,6 +475,8 @@ Done:
   @param[in]  DiskIo      Disk Io protocol.
   @param[in]  Lba         The starting Lba of the Partition Table
   @param[out] PartHeader  Stores the partition table that is read
+  @param[out] PartEntry   If not NULL, returns the partition entry array of
+                          the valid partition table, allocated by this function.
 
   @retval TRUE      The partition table is valid
   @retval FALSE     The partition table is not valid
@@ -469,19 +487,52 @@ PartitionValidGptTable (
   IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
   IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
   IN  EFI_LBA                     Lba,
-  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT EFI_PARTITION_ENTRY         **PartEntry OPTIONAL
   )
 {
   EFI_STATUS                  Status;
   UINT32                      BlockSize;
   EFI_PARTITION_TABLE_HEADER  *PartHdr;
   UINT32                      MediaId;
+  UINT8                       *Buffer;
+  UINTN                       EntryBlocks;
+  EFI_LBA                     ReadLba;
+  EFI_LBA                     EntryLba;
+  UINTN                       HeaderOffset;
+  UINTN                       EntryOffset;
+  UINTN                       EntryArraySize;
+  VOID                        *Entries;
+  BOOLEAN                     Valid;
 
   BlockSize = BlockIo->Media->BlockSize;
   MediaId   = BlockIo->Media->MediaId;
-  PartHdr   = AllocateZeroPool (BlockSize);
 
-  if (PartHdr == NULL) {
+  //
+  // Work out where a default sized entry array sits next to the header.
+  //
+  EntryBlocks = (GPT_DEFAULT_ENTRY_ARRAY_SIZE + BlockSize - 1) / BlockSize;
+  if ((Lba == PRIMARY_PART_HEADER_LBA) &&
+      (Lba + EntryBlocks <= BlockIo->Media->LastBlock)) {
+    ReadLba      = Lba;
+    EntryLba     = Lba + 1;
+    HeaderOffset = 0;
+    EntryOffset  = BlockSize;
+  } else if ((Lba != PRIMARY_PART_HEADER_LBA) && (Lba > EntryBlocks)) {
+    ReadLba      = Lba - EntryBlocks;
+    EntryLba     = ReadLba;
+    HeaderOffset = EntryBlocks * BlockSize;
+    EntryOffset  = 0;
+  } else {
+    EntryBlocks  = 0;
+    ReadLba      = Lba;
+    EntryLba     = 0;
+    HeaderOffset = 0;
+    EntryOffset  = 0;
+  }
+
+  Buffer = AllocateZeroPool ((EntryBlocks + 1) * BlockSize);
+  if (Buffer == NULL) {
     DEBUG ((EFI_D_ERROR, "Allocate pool error\n"));
     return FALSE;
   }
@@ -491,22 +542,23 @@ PartitionValidGptTable (
   Status = DiskIo->ReadDisk (
                      DiskIo,
                      MediaId,
-                     MultU64x32 (Lba, BlockSize),
-                     BlockSize,
-                     PartHdr
+                     MultU64x32 (ReadLba, BlockSize),
+                     (EntryBlocks + 1) * BlockSize,
+                     Buffer
                      );
   if (EFI_ERROR (Status)) {
-    FreePool (PartHdr);
+    FreePool (Buffer);
     return FALSE;
   }
 
+  PartHdr = (EFI_PARTITION_TABLE_HEADER *) (Buffer + HeaderOffset);
   if ((PartHdr->Header.Signature != EFI_PTAB_HEADER_ID) ||
       !PartitionCheckCrc (BlockSize, &PartHdr->Header) ||
       PartHdr->MyLBA != Lba ||
       (PartHdr->SizeOfPartitionEntry < sizeof (EFI_PARTITION_ENTRY))
       ) {
     DEBUG ((EFI_D_INFO, "Invalid efi partition table header\n"));
-    FreePool (PartHdr);
+    FreePool (Buffer);
     return FALSE;
   }
 
@@ -514,28 +566,72 @@ PartitionValidGptTable (
   // Ensure the NumberOfPartitionEntries * SizeOfPartitionEntry doesn't overflow.
   //
   if (PartHdr->NumberOfPartitionEntries > DivU64x32 (MAX_UINTN, PartHdr->SizeOfPartitionEntry)) {
-    FreePool (PartHdr);
+    FreePool (Buffer);
     return FALSE;
   }
 
   CopyMem (PartHeader, PartHdr, sizeof (EFI_PARTITION_TABLE_HEADER));
-  if (!PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PartHeader)) {
-    FreePool (PartHdr);
-    return FALSE;
+
+  //
+  // Take the entry array from the blocks already read if it is there,
+  // otherwise read it.
+  //
+  EntryArraySize = PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry;
+  if ((EntryBlocks != 0) &&
+      (PartHeader->PartitionEntryLBA == EntryLba) &&
+      (EntryArraySize <= EntryBlocks * BlockSize)) {
+    Entries = AllocateCopyPool (EntryArraySize, Buffer + EntryOffset);
+    if (Entries == NULL) {
+      DEBUG ((EFI_D_ERROR, " Allocate pool error\n"));
+      FreePool (Buffer);
+      return FALSE;
+    }
+  } else {
+    Entries = AllocatePool (EntryArraySize);
+    if (Entries == NULL) {
+      DEBUG ((EFI_D_ERROR, " Allocate pool error\n"));
+      FreePool (Buffer);
+      return FALSE;
+    }
+
+    Status = DiskIo->ReadDisk (
+                       DiskIo,
+                       MediaId,
+                       MultU64x32 (PartHeader->PartitionEntryLBA, BlockSize),
+                       EntryArraySize,
+                       Entries
+                       );
+    if (EFI_ERROR (Status)) {
+      FreePool (Entries);
+      FreePool (Buffer);
+      return FALSE;
+    }
   }
 
-  DEBUG ((EFI_D_INFO, " Valid efi partition table header\n"));
-  FreePool (PartHdr);
-  return TRUE;
+  FreePool (Buffer);
+
+  Valid = PartitionCheckGptEntryArrayCRC (PartHeader, Entries);
+  if (Valid && (PartEntry != NULL)) {
+    if (*PartEntry != NULL) {
+      FreePool (*PartEntry);
+    }
+    *PartEntry = Entries;
+  } else {
+    FreePool (Entries);
+  }
+
+  if (Valid) {
+    DEBUG ((EFI_D_INFO, " Valid efi partition table header\n"));
+  }
+  return Valid;
 }
 
 /**
   Check if the CRC field in the Partition table header is valid
   for Partition entry array.
 
-  @param[in]  BlockIo     Parent BlockIo interface
-  @param[in]  DiskIo      Disk Io Protocol.
   @param[in]  PartHeader  Partition table header structure
+  @param[in]  PartEntry   The partition entry array
 
   @retval TRUE      the CRC is valid
   @retval FALSE     the CRC is invalid
@@ -543,48 +639,22 @@ PartitionValidGptTable (
 **/
 BOOLEAN
 PartitionCheckGptEntryArrayCRC (
-  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
-  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
-  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  IN  VOID                        *PartEntry
   )
 {
   EFI_STATUS  Status;
-  UINT8       *Ptr;
   UINT32      Crc;
   UINTN       Size;
 
-  //
-  // Read the EFI Partition Entries
-  //
-  Ptr = AllocatePool (PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry);
-  if (Ptr == NULL) {
-    DEBUG ((EFI_D_ERROR, " Allocate pool error\n"));
-    return FALSE;
-  }
-
-  Status = DiskIo->ReadDisk (
-                    DiskIo,
-                    BlockIo->Media->MediaId,
-                    MultU64x32(PartHeader->PartitionEntryLBA, BlockIo->Media->BlockSize),
-                    PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry,
-                    Ptr
-                    );
-  if (EFI_ERROR (Status)) {
-    FreePool (Ptr);
-    return FALSE;
-  }
-
   Size    = PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry;
 
-  Status  = gBS->CalculateCrc32 (Ptr, Size, &Crc);
+  Status  = gBS->CalculateCrc32 (PartEntry, Size, &Crc);
   if (EFI_ERROR (Status)) {
     DEBUG ((EFI_D_ERROR, "CheckPEntryArrayCRC: Crc calculation failed\n"));
-    FreePool (Ptr);
     return FALSE;
   }
 
-  FreePool (Ptr);
-
   return (BOOLEAN) (PartHeader->PartitionEntryArrayCRC32 == Crc);
 }
 
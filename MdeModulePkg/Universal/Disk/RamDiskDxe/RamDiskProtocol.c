@@ -557,6 +557,10 @@ RamDiskUnpublishNfit (
 /**
   Register a RAM disk with specified address, size and type.
 
+  The RAM disk is backed by the memory at RamDiskBase in place, its content is
+  not copied. The caller, e.g. a network boot driver that downloaded an image,
+  must keep that memory allocated until the RAM disk is unregistered.
+
   @param[in]  RamDiskBase    The base address of registered RAM disk.
   @param[in]  RamDiskSize    The size of registered RAM disk.
   @param[in]  RamDiskType    The type of registered RAM disk. The GUID can be
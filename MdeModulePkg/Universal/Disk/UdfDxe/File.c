@@ -264,6 +264,8 @@ UdfOpen (
   NewPrivFileData->FilePosition = 0;
   ZeroMem ((VOID *)&NewPrivFileData->ReadDirInfo,
            sizeof (UDF_READ_DIRECTORY_INFO));
+  ZeroMem ((VOID *)&NewPrivFileData->ExtentMap,
+           sizeof (UDF_EXTENT_MAP));
 
   *NewHandle = &NewPrivFileData->FileIo;
 
@@ -373,6 +375,7 @@ UdfRead (
       Volume,
       Parent,
       PrivFileData->FileSize,
+      &PrivFileData->ExtentMap,
       &PrivFileData->FilePosition,
       Buffer,
       &BufferSizeUint64
@@ -558,6 +561,10 @@ UdfClose (
     if (PrivFileData->ReadDirInfo.DirectoryData != NULL) {
       FreePool (PrivFileData->ReadDirInfo.DirectoryData);
     }
+
+    if (PrivFileData->ExtentMap.Extents != NULL) {
+      FreePool (PrivFileData->ExtentMap.Extents);
+    }
   }
 
   FreePool ((VOID *)PrivFileData);
@@ -1086,6 +1086,7 @@ ReadFile (
   BOOLEAN                 FinishedSeeking;
   UINT32                  ExtentLength;
   UDF_FE_RECORDING_FLAGS  RecordingFlags;
+  UDF_EXTENT              *Extents;
 
   LogicalBlockSize  = Volume->LogicalVolDesc.LogicalBlockSize;
   DoFreeAed         = FALSE;
@@ -1109,6 +1110,14 @@ ReadFile (
     ReadFileInfo->ReadLength = 0;
     ReadFileInfo->FileData = NULL;
     break;
+  case ReadFileGetExtentMap:
+    //
+    // Initialise ReadFileInfo structure for collecting file's extents.
+    //
+    ReadFileInfo->ReadLength = 0;
+    ReadFileInfo->FileData = NULL;
+    ReadFileInfo->ExtentCount = 0;
+    break;
   case ReadFileSeekAndRead:
     //
     // About to seek a file and/or read its data.
@@ -1138,6 +1147,10 @@ ReadFile (
     //
     // There are no extents for this FE/EFE. All data is inline.
     //
+    if (ReadFileInfo->Flags == ReadFileGetExtentMap) {
+      return EFI_UNSUPPORTED;
+    }
+
     Status = GetFileEntryData (FileEntryData, Volume->FileEntrySize, &Data, &Length);
     if (EFI_ERROR (Status)) {
       return Status;
@@ -1284,6 +1297,36 @@ ReadFile (
           goto Error_Read_Disk_Blk;
         }
 
+        ReadFileInfo->ReadLength += ExtentLength;
+        break;
+      case ReadFileGetExtentMap:
+        if (ExtentLength == 0) {
+          break;
+        }
+
+        //
+        // Grow the extent map (if necessary) to hold the next extent.
+        //
+        if ((ReadFileInfo->ExtentCount % UDF_EXTENT_MAP_GROW_COUNT) == 0) {
+          Extents = ReallocatePool (
+                      ReadFileInfo->ExtentCount * sizeof (UDF_EXTENT),
+                      (ReadFileInfo->ExtentCount + UDF_EXTENT_MAP_GROW_COUNT) * sizeof (UDF_EXTENT),
+                      ReadFileInfo->FileData
+                      );
+          if (Extents == NULL) {
+            Status = EFI_OUT_OF_RESOURCES;
+            goto Error_Alloc_Buffer_To_Next_Ad;
+          }
+
+          ReadFileInfo->FileData = Extents;
+        }
+
+        Extents = (UDF_EXTENT *)ReadFileInfo->FileData;
+        Extents[ReadFileInfo->ExtentCount].FileOffset = ReadFileInfo->ReadLength;
+        Extents[ReadFileInfo->ExtentCount].Lsn        = Lsn;
+        Extents[ReadFileInfo->ExtentCount].Length     = ExtentLength;
+        ReadFileInfo->ExtentCount++;
+
         ReadFileInfo->ReadLength += ExtentLength;
         break;
       case ReadFileSeekAndRead:
@@ -1386,8 +1429,10 @@ Done:
 
 Error_Read_Disk_Blk:
 Error_Alloc_Buffer_To_Next_Ad:
-  if (ReadFileInfo->Flags != ReadFileSeekAndRead) {
+  if ((ReadFileInfo->Flags != ReadFileSeekAndRead) &&
+      (ReadFileInfo->FileData != NULL)) {
     FreePool (ReadFileInfo->FileData);
+    ReadFileInfo->FileData = NULL;
   }
 
   if (DoFreeAed) {
@@ -1612,6 +1657,11 @@ ReadUdfVolumeInformation (
 {
   EFI_STATUS Status;
 
+  //
+  // Directories cached for a previous read of the volume may be stale.
+  //
+  FreeDirectoryCache (Volume);
+
   //
   // Read all necessary UDF volume information and keep it private to the driver
   //
@@ -1918,6 +1968,127 @@ FindFile (
   return Status;
 }
 
+/**
+  Free the directory data cached for an UDF volume.
+
+  @param[in]  Volume  UDF volume information structure.
+
+**/
+VOID
+FreeDirectoryCache (
+  IN UDF_VOLUME_INFO  *Volume
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < UDF_DIRECTORY_CACHE_ENTRIES; Index++) {
+    if (Volume->DirectoryCache[Index].Data != NULL) {
+      FreePool (Volume->DirectoryCache[Index].Data);
+    }
+  }
+
+  ZeroMem (Volume->DirectoryCache, sizeof (Volume->DirectoryCache));
+  Volume->DirectoryCacheNext = 0;
+}
+
+/**
+  Read the recorded data of a directory, that is, its File Identifier
+  Descriptors, on an UDF volume.
+
+  The data of recently read directories is cached in the volume, so the lookup
+  of every path component on each Open doesn't read the directories again.
+
+  @param[in]   BlockIo        BlockIo interface.
+  @param[in]   DiskIo         DiskIo interface.
+  @param[in]   Volume         UDF volume information structure.
+  @param[in]   ParentIcb      ICB of the directory.
+  @param[in]   FileEntryData  FE/EFE of the directory.
+  @param[out]  Data           The directory data, allocated by this function.
+  @param[out]  Length         The length of the directory data.
+
+  @retval EFI_SUCCESS          Directory data read.
+  @retval EFI_OUT_OF_RESOURCES The directory data was not read due to lack of
+                               resources.
+  @retval other                The directory data was not read.
+
+**/
+EFI_STATUS
+ReadDirectoryData (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  OUT  VOID                            **Data,
+  OUT  UINT64                          *Length
+  )
+{
+  EFI_STATUS                 Status;
+  UDF_READ_FILE_INFO         ReadFileInfo;
+  UDF_DIRECTORY_CACHE_ENTRY  *CacheEntry;
+  UINT64                     Lsn;
+  UINTN                      Index;
+
+  Status = GetLongAdLsn (Volume, ParentIcb, &Lsn);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < UDF_DIRECTORY_CACHE_ENTRIES; Index++) {
+    CacheEntry = &Volume->DirectoryCache[Index];
+    if ((CacheEntry->Data != NULL) &&
+        (CacheEntry->Lsn == Lsn) &&
+        (CacheEntry->MediaId == BlockIo->Media->MediaId)) {
+      *Data = AllocateCopyPool ((UINTN) CacheEntry->Length, CacheEntry->Data);
+      if (*Data == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      *Length = CacheEntry->Length;
+      return EFI_SUCCESS;
+    }
+  }
+
+  ReadFileInfo.Flags = ReadFileAllocateAndRead;
+
+  Status = ReadFile (
+    BlockIo,
+    DiskIo,
+    Volume,
+    ParentIcb,
+    FileEntryData,
+    &ReadFileInfo
+    );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *Data   = ReadFileInfo.FileData;
+  *Length = ReadFileInfo.ReadLength;
+
+  //
+  // Keep a copy of the directory data, replacing the oldest cached one. Not
+  // being able to cache it isn't an error.
+  //
+  if ((ReadFileInfo.ReadLength != 0) &&
+      (ReadFileInfo.ReadLength <= UDF_DIRECTORY_CACHE_MAX_SIZE)) {
+    CacheEntry = &Volume->DirectoryCache[Volume->DirectoryCacheNext];
+    if (CacheEntry->Data != NULL) {
+      FreePool (CacheEntry->Data);
+    }
+
+    CacheEntry->Data = AllocateCopyPool ((UINTN) ReadFileInfo.ReadLength, ReadFileInfo.FileData);
+    if (CacheEntry->Data != NULL) {
+      CacheEntry->MediaId = BlockIo->Media->MediaId;
+      CacheEntry->Lsn     = Lsn;
+      CacheEntry->Length  = ReadFileInfo.ReadLength;
+      Volume->DirectoryCacheNext = (Volume->DirectoryCacheNext + 1) % UDF_DIRECTORY_CACHE_ENTRIES;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read a directory entry at a time on an UDF volume.
 
@@ -1951,7 +2122,6 @@ ReadDirectoryEntry (
   )
 {
   EFI_STATUS                      Status;
-  UDF_READ_FILE_INFO              ReadFileInfo;
   UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
 
   if (ReadDirInfo->DirectoryData == NULL) {
@@ -1959,25 +2129,18 @@ ReadDirectoryEntry (
     // The directory's recorded data has not been read yet. So let's cache it
     // into memory and the next calls won't need to read it again.
     //
-    ReadFileInfo.Flags = ReadFileAllocateAndRead;
-
-    Status = ReadFile (
+    Status = ReadDirectoryData (
       BlockIo,
       DiskIo,
       Volume,
       ParentIcb,
       FileEntryData,
-      &ReadFileInfo
+      &ReadDirInfo->DirectoryData,
+      &ReadDirInfo->DirectoryLength
       );
     if (EFI_ERROR (Status)) {
       return Status;
     }
-
-    //
-    // Fill in ReadDirInfo structure with the read directory's data information.
-    //
-    ReadDirInfo->DirectoryData = ReadFileInfo.FileData;
-    ReadDirInfo->DirectoryLength = ReadFileInfo.ReadLength;
   }
 
   do {
@@ -2801,6 +2964,8 @@ Out_Free:
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Extent map of the file. It is built on the
+                                first call and reused by the next ones.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -2821,6 +2986,7 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_EXTENT_MAP         *ExtentMap,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
@@ -2828,6 +2994,92 @@ ReadFileData (
 {
   EFI_STATUS          Status;
   UDF_READ_FILE_INFO  ReadFileInfo;
+  UDF_EXTENT          *Extent;
+  UINTN               Index;
+  UINT64              Position;
+  UINT64              BytesLeft;
+  UINT64              Offset;
+  UINT64              DataLength;
+  UINT32              LogicalBlockSize;
+
+  //
+  // Collect the file's extents on the first read. Files with inline data have
+  // none, they are read from their FE/EFE as before.
+  //
+  if ((ExtentMap->Extents == NULL) &&
+      (GET_FE_RECORDING_FLAGS (File->FileEntry) != InlineData)) {
+    ReadFileInfo.Flags = ReadFileGetExtentMap;
+
+    Status = ReadFile (
+                   BlockIo,
+                   DiskIo,
+                   Volume,
+                   &File->FileIdentifierDesc->Icb,
+                   File->FileEntry,
+                   &ReadFileInfo
+                   );
+    if (!EFI_ERROR (Status) && (ReadFileInfo.ExtentCount != 0)) {
+      ExtentMap->Extents   = ReadFileInfo.FileData;
+      ExtentMap->Count     = ReadFileInfo.ExtentCount;
+      ExtentMap->LastIndex = 0;
+    } else if (ReadFileInfo.FileData != NULL) {
+      FreePool (ReadFileInfo.FileData);
+    }
+  }
+
+  if (ExtentMap->Extents != NULL) {
+    LogicalBlockSize = Volume->LogicalVolDesc.LogicalBlockSize;
+    Position         = *FilePosition;
+    BytesLeft        = MIN (*BufferSize, FileSize - Position);
+
+    //
+    // Sequential reads continue in the extent of the previous one, so start
+    // looking from there.
+    //
+    Index = ExtentMap->LastIndex;
+    if ((Index >= ExtentMap->Count) ||
+        (ExtentMap->Extents[Index].FileOffset > Position)) {
+      Index = 0;
+    }
+
+    while (BytesLeft != 0) {
+      while ((Index < ExtentMap->Count) &&
+             (ExtentMap->Extents[Index].FileOffset + ExtentMap->Extents[Index].Length <= Position)) {
+        Index++;
+      }
+
+      if (Index >= ExtentMap->Count) {
+        //
+        // The extents don't cover the file size.
+        //
+        break;
+      }
+
+      Extent     = &ExtentMap->Extents[Index];
+      Offset     = Position - Extent->FileOffset;
+      DataLength = MIN (BytesLeft, Extent->Length - Offset);
+
+      Status = DiskIo->ReadDisk (
+        DiskIo,
+        BlockIo->Media->MediaId,
+        Offset + MultU64x32 (Extent->Lsn, LogicalBlockSize),
+        (UINTN) DataLength,
+        (UINT8 *)Buffer + (Position - *FilePosition)
+        );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Position  += DataLength;
+      BytesLeft -= DataLength;
+    }
+
+    ExtentMap->LastIndex = Index;
+    *BufferSize   = Position - *FilePosition;
+    *FilePosition = Position;
+
+    return EFI_SUCCESS;
+  }
 
   ReadFileInfo.Flags         = ReadFileSeekAndRead;
   ReadFileInfo.FilePosition  = *FilePosition;
@@ -270,6 +270,7 @@ UdfDriverBindingStop (
       NULL
       );
 
+    FreeDirectoryCache (&PrivFsData->Volume);
     FreePool ((VOID *)PrivFsData);
   }
 
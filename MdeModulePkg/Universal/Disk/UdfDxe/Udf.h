@@ -114,6 +114,18 @@ typedef enum {
 #define UDF_FILENAME_LENGTH  128
 #define UDF_PATH_LENGTH      512
 
+//
+// Number of directories whose recorded data is kept per volume, and the
+// largest directory that is kept.
+//
+#define UDF_DIRECTORY_CACHE_ENTRIES   16
+#define UDF_DIRECTORY_CACHE_MAX_SIZE  SIZE_256KB
+
+//
+// Number of extents the extent map of a file grows by.
+//
+#define UDF_EXTENT_MAP_GROW_COUNT     16
+
 #define GET_FID_FROM_ADS(_Data, _Offs) \
   ((UDF_FILE_IDENTIFIER_DESCRIPTOR *)((UINT8 *)(_Data) + (_Offs)))
 
@@ -134,6 +146,7 @@ typedef enum {
   ReadFileGetFileSize,
   ReadFileAllocateAndRead,
   ReadFileSeekAndRead,
+  ReadFileGetExtentMap,
 } UDF_READ_FILE_FLAGS;
 
 typedef struct {
@@ -143,8 +156,29 @@ typedef struct {
   UINT64               FilePosition;
   UINT64               FileSize;
   UINT64               ReadLength;
+  UINTN                ExtentCount;
 } UDF_READ_FILE_INFO;
 
+//
+// A recorded extent of a file, with its offset in the file.
+//
+typedef struct {
+  UINT64               FileOffset;
+  UINT64               Lsn;
+  UINT32               Length;
+} UDF_EXTENT;
+
+//
+// Extents of a file, collected from its Allocation Descriptors (including the
+// ones in Allocation Extent Descriptors) the first time the file is read, so
+// that later reads don't have to walk them again.
+//
+typedef struct {
+  UDF_EXTENT           *Extents;
+  UINTN                Count;
+  UINTN                LastIndex;
+} UDF_EXTENT_MAP;
+
 #pragma pack(1)
 
 typedef struct {
@@ -309,6 +343,17 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Recorded data (File Identifier Descriptors) of a directory, identified by
+// the logical sector of its FE/EFE.
+//
+typedef struct {
+  UINT32                         MediaId;
+  UINT64                         Lsn;
+  VOID                           *Data;
+  UINT64                         Length;
+} UDF_DIRECTORY_CACHE_ENTRY;
+
 //
 // UDF filesystem driver's private data
 //
@@ -318,6 +363,12 @@ typedef struct {
   UDF_PARTITION_DESCRIPTOR       PartitionDesc;
   UDF_FILE_SET_DESCRIPTOR        FileSetDesc;
   UINTN                          FileEntrySize;
+  //
+  // Directories looked up recently, so opening files in deep directory trees
+  // doesn't read every directory of the path again.
+  //
+  UDF_DIRECTORY_CACHE_ENTRY      DirectoryCache[UDF_DIRECTORY_CACHE_ENTRIES];
+  UINTN                          DirectoryCacheNext;
 } UDF_VOLUME_INFO;
 
 typedef struct {
@@ -353,6 +404,7 @@ typedef struct {
   CHAR16                           FileName[UDF_FILENAME_LENGTH];
   UINT64                           FileSize;
   UINT64                           FilePosition;
+  UDF_EXTENT_MAP                   ExtentMap;
 } PRIVATE_UDF_FILE_DATA;
 
 #define PRIVATE_UDF_SIMPLE_FS_DATA_SIGNATURE SIGNATURE_32 ('U', 'd', 'f', 's')
@@ -962,6 +1014,8 @@ GetVolumeSize (
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Extent map of the file. It is built on the
+                                first call and reused by the next ones.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -982,11 +1036,23 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_EXTENT_MAP         *ExtentMap,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
   );
 
+/**
+  Free the directory data cached for an UDF volume.
+
+  @param[in]  Volume  UDF volume information structure.
+
+**/
+VOID
+FreeDirectoryCache (
+  IN UDF_VOLUME_INFO  *Volume
+  );
+
 /**
   Check if ControllerHandle supports an UDF file system.
 
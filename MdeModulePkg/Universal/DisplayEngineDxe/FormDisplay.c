@@ -2625,6 +2625,7 @@ UiDisplayMenu (
   CHAR16                          *HelpString;
   CHAR16                          *HelpHeaderString;
   CHAR16                          *HelpBottomString;
+  CHAR16                          *ShownHelpString;
   BOOLEAN                         NewLine;
   BOOLEAN                         Repaint;
   BOOLEAN                         UpArrow;
@@ -2662,6 +2663,7 @@ UiDisplayMenu (
   HelpString          = NULL;
   HelpHeaderString    = NULL;
   HelpBottomString    = NULL;
+  ShownHelpString     = NULL;
   OptionString        = NULL;
   ScreenOperation     = UiNoOperation;
   NewLine             = TRUE;
@@ -2986,6 +2988,20 @@ UiDisplayMenu (
           }
         }
 
+        //
+        // When only the highlight moved and the new statement has the same
+        // help text as the one shown, the help area is already up to date.
+        //
+        if (!Repaint && !MultiHelpPage && (ShownHelpString != NULL) && (StrCmp (StringPtr, ShownHelpString) == 0)) {
+          FreePool (StringPtr);
+          NewLine = FALSE;
+          break;
+        }
+        if (ShownHelpString != NULL) {
+          FreePool (ShownHelpString);
+        }
+        ShownHelpString = AllocateCopyPool (StrSize (StringPtr), StringPtr);
+
         RowCount      = BottomRow - TopRow + 1;
         HelpPageIndex = 0;
         //
@@ -3791,6 +3807,9 @@ UiDisplayMenu (
       if (HelpBottomString != NULL) {
         FreePool (HelpBottomString);
       }
+      if (ShownHelpString != NULL) {
+        FreePool (ShownHelpString);
+      }
       return EFI_SUCCESS;
 
     default:
@@ -7,6 +7,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "Edb.h"
+#include "EbcExecute.h"   // MU_CHANGE - Decoded-instruction cache control
 
 /**
 
@@ -322,6 +323,13 @@ EbcDebuggerHookInit (
   EFI_DEBUGGER_SYMBOL_OBJECT *Object;
   EFI_DEBUGGER_SYMBOL_ENTRY  *Entry;
 
+  // MU_CHANGE [BEGIN] - Disable the decoded-instruction cache
+  //
+  // Breakpoints and memory edits patch EBC code in place without invalidating
+  // the instruction cache, so always decode from memory under the debugger.
+  //
+  EbcEnableDecodeCache (FALSE);
+  // MU_CHANGE [END]
 
   //
   // Register all exception handler
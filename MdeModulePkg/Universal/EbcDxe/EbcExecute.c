@@ -1339,6 +1339,40 @@ CONST VM_TABLE_ENTRY           mVmOpcodeTable[] = {
 //
 CONST UINT8                    mJMPLen[] = { 2, 2, 6, 10 };
 
+// MU_CHANGE [BEGIN] - Cache pre-decoded forms of the hottest instructions
+//
+// Kinds of instruction held in the decoded-instruction cache. NONE marks an
+// instruction that was looked at and must always go through mVmOpcodeTable,
+// so it is not decoded again on every execution.
+//
+#define EBC_DECODED_NONE        0
+#define EBC_DECODED_DATA_MANIP  1   // NOT..EXTNDD  R1, R2 {Immed16}
+#define EBC_DECODED_MOVI        2   // MOVIxx       R1, ImmData
+#define EBC_DECODED_MOV         3   // MOVxx        R1, R2 {Index}
+
+#define EBC_DECODED_FLAG_64     0x01
+#define EBC_DECODED_FLAG_SIGNED 0x02
+
+#define EBC_DECODE_CACHE_SIZE   256   // Must be a power of 2
+
+typedef struct {
+  UINTN   Ip;         // Address of the instruction, 0 if the slot is free
+  UINT8   Opcode;     // Raw opcode byte, re-checked on every hit
+  UINT8   Operands;   // Raw operands byte, re-checked on every hit
+  UINT8   Kind;
+  UINT8   Size;
+  UINT8   Reg1;
+  UINT8   Reg2;
+  UINT8   Flags;
+  UINT8   DispatchIndex;
+  UINT64  Immediate;
+  UINT64  Mask;
+} EBC_DECODED_INSTRUCTION;
+
+EBC_DECODED_INSTRUCTION  mEbcDecodeCache[EBC_DECODE_CACHE_SIZE];
+BOOLEAN                  mEbcDecodeCacheEnabled = TRUE;
+// MU_CHANGE [END]
+
 /**
   Given a pointer to a new VM context, execute one or more instructions. This
   function is only used for test purposes via the EBC VM test protocol.
@@ -1492,7 +1526,10 @@ EbcExecute (
     //
     MemoryFence ();
 
-    mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction (VmPtr);
+    // MU_CHANGE - Execute pre-decoded instructions without the full decode
+    if (!EbcExecuteDecodedInstruction (VmPtr)) {
+      mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction (VmPtr);
+    }
 
     MemoryFence ();
 
@@ -1524,6 +1561,264 @@ Done:
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Cache pre-decoded forms of the hottest instructions
+/**
+  Discard every entry of the decoded-instruction cache.
+
+  Must be called whenever EBC code that may have been executed is modified or
+  released, so that stale decodings are never used.
+
+**/
+VOID
+EbcFlushDecodeCache (
+  VOID
+  )
+{
+  ZeroMem (mEbcDecodeCache, sizeof (mEbcDecodeCache));
+}
+
+/**
+  Enable or disable the decoded-instruction cache.
+
+  A debugger that patches or edits EBC code without going through the
+  InvalidateInstructionCache() service disables the cache so that every
+  instruction is decoded from memory.
+
+  @param  Enable            TRUE to use the cache, FALSE to decode every
+                            instruction through mVmOpcodeTable.
+
+**/
+VOID
+EbcEnableDecodeCache (
+  IN BOOLEAN  Enable
+  )
+{
+  EbcFlushDecodeCache ();
+  mEbcDecodeCacheEnabled = Enable;
+}
+
+/**
+  Decode the instruction at the current IP into a cache entry.
+
+  Only register-direct forms with no side effects beyond the general purpose
+  registers and the IP are decoded. Everything else, including all encodings
+  that raise an exception in their execute function, is recorded as
+  EBC_DECODED_NONE so that it keeps running through mVmOpcodeTable.
+
+  @param  VmPtr             A pointer to a VM context.
+  @param  Entry             The cache entry to fill in.
+
+**/
+VOID
+EbcDecodeInstruction (
+  IN  VM_CONTEXT               *VmPtr,
+  OUT EBC_DECODED_INSTRUCTION  *Entry
+  )
+{
+  UINT8   Opcode;
+  UINT8   OpcMasked;
+  UINT8   Operands;
+
+  Opcode    = GETOPCODE (VmPtr);
+  OpcMasked = (UINT8) (Opcode & OPCODE_M_OPCODE);
+  Operands  = GETOPERANDS (VmPtr);
+
+  ZeroMem (Entry, sizeof (*Entry));
+  Entry->Opcode   = Opcode;
+  Entry->Operands = Operands;
+  Entry->Kind     = EBC_DECODED_NONE;
+  Entry->Reg1     = (UINT8) OPERAND1_REGNUM (Operands);
+  Entry->Reg2     = (UINT8) OPERAND2_REGNUM (Operands);
+
+  if (OPERAND1_INDIRECT (Operands)) {
+    return;
+  }
+
+  if ((OpcMasked >= OPCODE_NOT) && (OpcMasked <= OPCODE_EXTNDD)) {
+    //
+    // NOT..EXTNDD R1, R2 {Immed16}. Immediate data is an Index16 when R2 is
+    // indirect, so only the direct form is decoded.
+    //
+    if (OPERAND2_INDIRECT (Operands)) {
+      return;
+    }
+
+    Entry->Size = 2;
+    if ((Opcode & DATAMANIP_M_IMMDATA) != 0) {
+      Entry->Immediate = (UINT64) (INT64) VmReadImmed16 (VmPtr, 2);
+      Entry->Size      = 4;
+    }
+
+    if ((Opcode & DATAMANIP_M_64) != 0) {
+      Entry->Flags |= EBC_DECODED_FLAG_64;
+    }
+
+    if (mVmOpcodeTable[OpcMasked].ExecuteFunction == ExecuteSignedDataManip) {
+      Entry->Flags |= EBC_DECODED_FLAG_SIGNED;
+    }
+
+    Entry->DispatchIndex = (UINT8) (OpcMasked - OPCODE_NOT);
+    Entry->Kind          = EBC_DECODED_DATA_MANIP;
+  } else if (OpcMasked == OPCODE_MOVI) {
+    //
+    // MOVIxx R1, ImmData. Operand1 direct with an index is an invalid encoding.
+    //
+    if ((Operands & MOVI_M_IMMDATA) != 0) {
+      return;
+    }
+
+    if ((Opcode & MOVI_M_DATAWIDTH) == MOVI_DATAWIDTH16) {
+      Entry->Immediate = (UINT64) (INT64) (INT16) VmReadImmed16 (VmPtr, 2);
+      Entry->Size      = 4;
+    } else if ((Opcode & MOVI_M_DATAWIDTH) == MOVI_DATAWIDTH32) {
+      Entry->Immediate = (UINT64) (INT64) (INT32) VmReadImmed32 (VmPtr, 2);
+      Entry->Size      = 6;
+    } else if ((Opcode & MOVI_M_DATAWIDTH) == MOVI_DATAWIDTH64) {
+      Entry->Immediate = (UINT64) VmReadImmed64 (VmPtr, 2);
+      Entry->Size      = 10;
+    } else {
+      return;
+    }
+
+    if ((Operands & MOVI_M_MOVEWIDTH) == MOVI_MOVEWIDTH8) {
+      Entry->Immediate &= 0x000000FF;
+    } else if ((Operands & MOVI_M_MOVEWIDTH) == MOVI_MOVEWIDTH16) {
+      Entry->Immediate &= 0x0000FFFF;
+    } else if ((Operands & MOVI_M_MOVEWIDTH) == MOVI_MOVEWIDTH32) {
+      Entry->Immediate &= 0xFFFFFFFF;
+    }
+
+    Entry->Kind = EBC_DECODED_MOVI;
+  } else if (((OpcMasked >= OPCODE_MOVBW) && (OpcMasked <= OPCODE_MOVQD)) ||
+             (OpcMasked == OPCODE_MOVQQ) ||
+             (OpcMasked == OPCODE_MOVNW) ||
+             (OpcMasked == OPCODE_MOVND)) {
+    //
+    // MOVxx R1, R2 {Index}. Operand1 direct with an index is an invalid
+    // encoding.
+    //
+    if (OPERAND2_INDIRECT (Operands) || ((Opcode & OPCODE_M_IMMED_OP1) != 0)) {
+      return;
+    }
+
+    Entry->Size = 2;
+    if ((Opcode & OPCODE_M_IMMED_OP2) != 0) {
+      if ((OpcMasked <= OPCODE_MOVQW) || (OpcMasked == OPCODE_MOVNW)) {
+        Entry->Immediate = (UINT64) (INT64) VmReadIndex16 (VmPtr, 2);
+        Entry->Size      = 4;
+      } else if ((OpcMasked <= OPCODE_MOVQD) || (OpcMasked == OPCODE_MOVND)) {
+        Entry->Immediate = (UINT64) (INT64) VmReadIndex32 (VmPtr, 2);
+        Entry->Size      = 6;
+      } else {
+        Entry->Immediate = (UINT64) VmReadIndex64 (VmPtr, 2);
+        Entry->Size      = 10;
+      }
+    }
+
+    if ((OpcMasked == OPCODE_MOVBW) || (OpcMasked == OPCODE_MOVBD)) {
+      Entry->Mask = 0xFF;
+    } else if ((OpcMasked == OPCODE_MOVWW) || (OpcMasked == OPCODE_MOVWD)) {
+      Entry->Mask = 0xFFFF;
+    } else if ((OpcMasked == OPCODE_MOVDW) || (OpcMasked == OPCODE_MOVDD)) {
+      Entry->Mask = 0xFFFFFFFF;
+    } else if ((OpcMasked == OPCODE_MOVNW) || (OpcMasked == OPCODE_MOVND)) {
+      Entry->Mask = (UINT64)~0 >> (64 - 8 * sizeof (UINTN));
+    } else {
+      Entry->Mask = (UINT64)~0;
+    }
+
+    Entry->Kind = EBC_DECODED_MOV;
+  }
+}
+
+/**
+  Execute the instruction at the current IP from its pre-decoded form.
+
+  The cache is a direct-mapped table indexed by IP. A slot is published by
+  writing its Ip field last, and a reader re-checks the Ip field after copying
+  the slot, so an EBC callback that runs at a higher TPL and refills the same
+  slot cannot hand a torn entry to the interrupted interpreter.
+
+  The instruction is executed with the same semantics as its handler in
+  mVmOpcodeTable; the caller keeps running the debugger hooks, fences and
+  stack checks around it.
+
+  @param  VmPtr             A pointer to a VM context.
+
+  @retval TRUE              The instruction was executed and the IP advanced.
+  @retval FALSE             The instruction must be executed through
+                            mVmOpcodeTable.
+
+**/
+BOOLEAN
+EbcExecuteDecodedInstruction (
+  IN VM_CONTEXT *VmPtr
+  )
+{
+  EBC_DECODED_INSTRUCTION  *Slot;
+  EBC_DECODED_INSTRUCTION  Entry;
+  UINTN                    Ip;
+  UINT64                   Op1;
+  UINT64                   Op2;
+
+  if (!mEbcDecodeCacheEnabled) {
+    return FALSE;
+  }
+
+  Ip   = (UINTN) VmPtr->Ip;
+  Slot = &mEbcDecodeCache[(Ip >> 1) & (EBC_DECODE_CACHE_SIZE - 1)];
+
+  CopyMem (&Entry, Slot, sizeof (Entry));
+  MemoryFence ();
+  if ((Entry.Ip != Ip) || (Slot->Ip != Ip) ||
+      (Entry.Opcode != GETOPCODE (VmPtr)) || (Entry.Operands != GETOPERANDS (VmPtr))) {
+    EbcDecodeInstruction (VmPtr, &Entry);
+    Slot->Ip = 0;
+    MemoryFence ();
+    CopyMem (Slot, &Entry, sizeof (Entry));
+    MemoryFence ();
+    Slot->Ip = Ip;
+  }
+
+  switch (Entry.Kind) {
+  case EBC_DECODED_DATA_MANIP:
+    Op2 = (UINT64) VmPtr->Gpr[Entry.Reg2] + Entry.Immediate;
+    Op1 = (UINT64) VmPtr->Gpr[Entry.Reg1];
+    if ((Entry.Flags & EBC_DECODED_FLAG_64) == 0) {
+      if ((Entry.Flags & EBC_DECODED_FLAG_SIGNED) != 0) {
+        Op2 = (UINT64) (INT64) ((INT32) Op2);
+        Op1 = (UINT64) (INT64) ((INT32) Op1);
+      } else {
+        Op2 = (UINT64) ((UINT32) Op2);
+        Op1 = (UINT64) ((UINT32) Op1);
+      }
+    }
+
+    Op2 = mDataManipDispatchTable[Entry.DispatchIndex](VmPtr, Op1, Op2);
+    if ((Entry.Flags & EBC_DECODED_FLAG_64) == 0) {
+      Op2 &= 0xFFFFFFFF;
+    }
+
+    VmPtr->Gpr[Entry.Reg1] = Op2;
+    break;
+
+  case EBC_DECODED_MOVI:
+    VmPtr->Gpr[Entry.Reg1] = Entry.Immediate;
+    break;
+
+  case EBC_DECODED_MOV:
+    VmPtr->Gpr[Entry.Reg1] = ((UINT64) VmPtr->Gpr[Entry.Reg2] + Entry.Immediate) & Entry.Mask;
+    break;
+
+  default:
+    return FALSE;
+  }
+
+  VmPtr->Ip += Entry.Size;
+  return TRUE;
+}
+// MU_CHANGE [END]
+
 
 /**
   Execute the MOVxx instructions.
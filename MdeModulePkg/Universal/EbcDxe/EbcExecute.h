@@ -132,4 +132,45 @@ EbcExecuteInstructions (
   IN OUT UINTN                *InstructionCount
   );
 
+// MU_CHANGE [BEGIN] - Cache pre-decoded forms of the hottest instructions
+/**
+  Discard every entry of the decoded-instruction cache.
+
+  Must be called whenever EBC code that may have been executed is modified or
+  released, so that stale decodings are never used.
+
+**/
+VOID
+EbcFlushDecodeCache (
+  VOID
+  );
+
+/**
+  Enable or disable the decoded-instruction cache.
+
+  @param  Enable            TRUE to use the cache, FALSE to decode every
+                            instruction through mVmOpcodeTable.
+
+**/
+VOID
+EbcEnableDecodeCache (
+  IN BOOLEAN  Enable
+  );
+
+/**
+  Execute the instruction at the current IP from its pre-decoded form.
+
+  @param  VmPtr             A pointer to a VM context.
+
+  @retval TRUE              The instruction was executed and the IP advanced.
+  @retval FALSE             The instruction must be executed through
+                            mVmOpcodeTable.
+
+**/
+BOOLEAN
+EbcExecuteDecodedInstruction (
+  IN VM_CONTEXT *VmPtr
+  );
+// MU_CHANGE [END]
+
 #endif // ifndef _EBC_EXECUTE_H_
@@ -291,7 +291,8 @@ EbcDebugRegisterExceptionCallback (
 
 /**
   This EBC debugger protocol service is called by the debug agent.  Required
-  for DebugSupport compliance but is only stubbed out for EBC.
+  for DebugSupport compliance. EBC has no processor instruction cache, but the
+  interpreter's decoded-instruction cache is flushed.
 
   @param  This                  A pointer to the EFI_DEBUG_SUPPORT_PROTOCOL
                                 instance.
@@ -827,6 +828,8 @@ EbcDebugInvalidateInstructionCache (
   IN UINT64                              Length
   )
 {
+  // MU_CHANGE - Re-decode EBC code patched by the debug agent
+  EbcFlushDecodeCache ();
   return EFI_SUCCESS;
 }
 
@@ -1205,6 +1208,9 @@ EbcUnloadImage (
   //
   FreePool (ImageList);
 
+  // MU_CHANGE - The image memory is about to be released
+  EbcFlushDecodeCache ();
+
   EbcDebuggerHookEbcUnloadImage (ImageHandle);
 
   return EFI_SUCCESS;
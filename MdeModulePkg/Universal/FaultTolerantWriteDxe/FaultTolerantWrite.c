@@ -332,6 +332,7 @@ FtwWrite (
   UINTN                               NumberOfBlocks;
   UINTN                               NumberOfWriteBlocks;
   UINTN                               WriteLength;
+  BOOLEAN                             SpareErased;  // MU_CHANGE
 
   FtwDevice = FTW_CONTEXT_FROM_THIS (This);
 
@@ -515,16 +516,29 @@ FtwWrite (
 
     Ptr += MyLength;
   }
+
+  // MU_CHANGE [BEGIN] - Skip the spare block erase and restore when the spare block is already erased.
+  //
+  // The spare block is left erased by the previous write in the common case.
+  // Writing an erased block gives the same result as erasing it first, and
+  // restoring an erased spare block only needs the erase.
+  //
+  SpareErased = IsErasedFlashBuffer (SpareBuffer, SpareBufferSize);
+
   //
   // Write the memory buffer to spare block
   // Do not assume Spare Block and Target Block have same block size
   //
-  Status  = FtwEraseSpareBlock (FtwDevice);
-  if (EFI_ERROR (Status)) {
-    FreePool (MyBuffer);
-    FreePool (SpareBuffer);
-    return EFI_ABORTED;
+  if (!SpareErased) {
+    Status  = FtwEraseSpareBlock (FtwDevice);
+    if (EFI_ERROR (Status)) {
+      FreePool (MyBuffer);
+      FreePool (SpareBuffer);
+      return EFI_ABORTED;
+    }
   }
+  // MU_CHANGE [END]
+
   Ptr     = MyBuffer;
   for (Index = 0; MyBufferSize > 0; Index += 1) {
     if (MyBufferSize > FtwDevice->SpareBlockSize) {
@@ -589,7 +603,7 @@ FtwWrite (
     return EFI_ABORTED;
   }
   Ptr     = SpareBuffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
+  for (Index = 0; !SpareErased && (Index < FtwDevice->NumberOfSpareBlock); Index += 1) {  // MU_CHANGE
     MyLength = FtwDevice->SpareBlockSize;
     Status = FtwDevice->FtwBackupFvb->Write (
                                         FtwDevice->FtwBackupFvb,
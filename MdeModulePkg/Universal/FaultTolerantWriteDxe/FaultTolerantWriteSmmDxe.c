@@ -13,6 +13,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 EFI_HANDLE                         mHandle                   = NULL;
 EFI_MM_COMMUNICATION2_PROTOCOL     *mMmCommunication2        = NULL;
 UINTN                              mPrivateDataSize          = 0;
+// MU_CHANGE [BEGIN] - Cache the SMM FTW max block size.
+//
+// The SMM FTW max block size is the spare area length, which is fixed once
+// the SMM driver has initialized. 0 means it has not been read yet.
+//
+UINTN                              mMaxBlockSize             = 0;
+// MU_CHANGE [END]
 
 EFI_FAULT_TOLERANT_WRITE_PROTOCOL  mFaultTolerantWriteDriver = {
   FtwGetMaxBlockSize,
@@ -154,6 +161,13 @@ FtwGetMaxBlockSize (
   EFI_MM_COMMUNICATE_HEADER                 *SmmCommunicateHeader;
   SMM_FTW_GET_MAX_BLOCK_SIZE_HEADER         *SmmFtwBlockSizeHeader;
 
+  // MU_CHANGE [BEGIN] - Answer from the cached value without an SMI.
+  if (mMaxBlockSize != 0) {
+    *BlockSize = mMaxBlockSize;
+    return EFI_SUCCESS;
+  }
+  // MU_CHANGE [END]
+
   //
   // Initialize the communicate buffer.
   //
@@ -171,6 +185,12 @@ FtwGetMaxBlockSize (
   *BlockSize = SmmFtwBlockSizeHeader->BlockSize;
   FreePool (SmmCommunicateHeader);
 
+  // MU_CHANGE [BEGIN] - Cache the SMM FTW max block size.
+  if (!EFI_ERROR (Status)) {
+    mMaxBlockSize = *BlockSize;
+  }
+  // MU_CHANGE [END]
+
   return Status;
 }
 
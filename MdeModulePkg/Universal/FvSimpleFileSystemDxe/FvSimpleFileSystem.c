@@ -432,6 +432,165 @@ TrimFilePathToAbsolutePath (
   return Path;
 }
 
+// MU_CHANGE [BEGIN] - Index the file names of the FV.
+/**
+  Hash an upper cased file name for the FV file name index.
+
+  @param  UpperName                   The file name, upper cased with the Unicode
+                                      Collation protocol.
+
+  @return The FNV-1a hash of the name.
+
+**/
+STATIC
+UINT32
+FvFsHashUpperName (
+  IN CONST CHAR16                          *UpperName
+  )
+{
+  UINT32  Hash;
+
+  Hash = 0x811C9DC5;
+  for ( ; *UpperName != L'\0'; UpperName++) {
+    Hash = (Hash ^ *UpperName) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Build the file name index of an FV instance from its file info list.
+
+  If the index cannot be allocated, FileInfoIndex stays NULL and file opens
+  search the list linearly.
+
+  @param  Instance                    A pointer to the FV_FILESYSTEM_INSTANCE whose
+                                      FileInfoHead list has been populated.
+
+**/
+VOID
+FvFsBuildFileNameIndex (
+  IN OUT FV_FILESYSTEM_INSTANCE            *Instance
+  )
+{
+  LIST_ENTRY               *FvFileInfoLink;
+  FV_FILESYSTEM_FILE_INFO  *FvFileInfo;
+  FV_FILESYSTEM_FILE_INFO  **Index;
+  CHAR16                   *UpperName;
+  UINTN                    Count;
+  UINTN                    MaxNameSize;
+  UINTN                    Slots;
+  UINTN                    Slot;
+
+  Count       = 0;
+  MaxNameSize = 0;
+  for (FvFileInfoLink = GetFirstNode (&Instance->FileInfoHead);
+      !IsNull (&Instance->FileInfoHead, FvFileInfoLink);
+       FvFileInfoLink = GetNextNode (&Instance->FileInfoHead, FvFileInfoLink)) {
+    FvFileInfo  = FVFS_FILE_INFO_FROM_LINK (FvFileInfoLink);
+    MaxNameSize = MAX (MaxNameSize, StrSize (&FvFileInfo->FileInfo.FileName[0]));
+    Count++;
+  }
+
+  if ((Count == 0) || (Count > MAX_UINT16)) {
+    return;
+  }
+
+  //
+  // Keep the table at most half full so probe sequences stay short.
+  //
+  Slots     = (UINTN)GetPowerOfTwo32 ((UINT32)Count) * 4;
+  Index     = AllocateZeroPool (Slots * sizeof (FV_FILESYSTEM_FILE_INFO *));
+  UpperName = AllocatePool (MaxNameSize);
+  if ((Index == NULL) || (UpperName == NULL)) {
+    if (Index != NULL) {
+      FreePool (Index);
+    }
+    if (UpperName != NULL) {
+      FreePool (UpperName);
+    }
+    return;
+  }
+
+  //
+  // Insert in list order, so that among files with the same name the one the
+  // linear search would find first is also the first one on its probe path.
+  //
+  for (FvFileInfoLink = GetFirstNode (&Instance->FileInfoHead);
+      !IsNull (&Instance->FileInfoHead, FvFileInfoLink);
+       FvFileInfoLink = GetNextNode (&Instance->FileInfoHead, FvFileInfoLink)) {
+    FvFileInfo = FVFS_FILE_INFO_FROM_LINK (FvFileInfoLink);
+    CopyMem (UpperName, &FvFileInfo->FileInfo.FileName[0], StrSize (&FvFileInfo->FileInfo.FileName[0]));
+    mUnicodeCollation->StrUpr (mUnicodeCollation, UpperName);
+    FvFileInfo->NameHash = FvFsHashUpperName (UpperName);
+
+    Slot = FvFileInfo->NameHash & (Slots - 1);
+    while (Index[Slot] != NULL) {
+      Slot = (Slot + 1) & (Slots - 1);
+    }
+    Index[Slot] = FvFileInfo;
+  }
+
+  FreePool (UpperName);
+  Instance->FileInfoIndex      = Index;
+  Instance->FileInfoIndexSlots = Slots;
+}
+
+/**
+  Find the file info of a file in an FV by name, ignoring case.
+
+  @param  Instance                    A pointer to the FV_FILESYSTEM_INSTANCE to search.
+  @param  FileName                    The file name to look for.
+  @param  UpperName                   FileName upper cased with the Unicode Collation
+                                      protocol, or NULL to search the list linearly.
+
+  @return The first matching file info, or NULL if there is none.
+
+**/
+STATIC
+FV_FILESYSTEM_FILE_INFO *
+FvFsFindFileInfo (
+  IN FV_FILESYSTEM_INSTANCE                *Instance,
+  IN CHAR16                                *FileName,
+  IN CONST CHAR16                          *UpperName OPTIONAL
+  )
+{
+  LIST_ENTRY               *FvFileInfoLink;
+  FV_FILESYSTEM_FILE_INFO  *FvFileInfo;
+  UINT32                   Hash;
+  UINTN                    Slot;
+
+  if ((Instance->FileInfoIndex != NULL) && (UpperName != NULL)) {
+    Hash = FvFsHashUpperName (UpperName);
+    for (Slot = Hash & (Instance->FileInfoIndexSlots - 1);
+         Instance->FileInfoIndex[Slot] != NULL;
+         Slot = (Slot + 1) & (Instance->FileInfoIndexSlots - 1)) {
+      FvFileInfo = Instance->FileInfoIndex[Slot];
+      if ((FvFileInfo->NameHash == Hash) &&
+          (mUnicodeCollation->StriColl (mUnicodeCollation, &FvFileInfo->FileInfo.FileName[0], FileName) == 0)) {
+        return FvFileInfo;
+      }
+    }
+
+    return NULL;
+  }
+
+  //
+  // Do a linear search for a file in the FV with a matching filename
+  //
+  for (FvFileInfoLink = GetFirstNode (&Instance->FileInfoHead);
+      !IsNull (&Instance->FileInfoHead, FvFileInfoLink);
+       FvFileInfoLink = GetNextNode (&Instance->FileInfoHead, FvFileInfoLink)) {
+    FvFileInfo = FVFS_FILE_INFO_FROM_LINK (FvFileInfoLink);
+    if (mUnicodeCollation->StriColl (mUnicodeCollation, &FvFileInfo->FileInfo.FileName[0], FileName) == 0) {
+      return FvFileInfo;
+    }
+  }
+
+  return NULL;
+}
+// MU_CHANGE [END]
+
 /**
   Opens a new file relative to the source file's location.
 
@@ -476,11 +635,11 @@ FvSimpleFileSystemOpen (
   FV_FILESYSTEM_FILE          *File;
   FV_FILESYSTEM_FILE          *NewFile;
   FV_FILESYSTEM_FILE_INFO     *FvFileInfo;
-  LIST_ENTRY                  *FvFileInfoLink;
   EFI_STATUS                  Status;
   UINTN                       FileNameLength;
   UINTN                       NewFileNameLength;
   CHAR16                      *FileNameWithExtension;
+  CHAR16                      *UpperName;  // MU_CHANGE
 
   //
   // Check for a valid mode
@@ -529,49 +688,60 @@ FvSimpleFileSystemOpen (
     return EFI_SUCCESS;
   }
 
-  //
-  // Do a linear search for a file in the FV with a matching filename
-  //
-  Status     = EFI_NOT_FOUND;
-  FvFileInfo = NULL;
-  for (FvFileInfoLink = GetFirstNode (&Instance->FileInfoHead);
-      !IsNull (&Instance->FileInfoHead, FvFileInfoLink);
-       FvFileInfoLink = GetNextNode (&Instance->FileInfoHead, FvFileInfoLink)) {
-    FvFileInfo = FVFS_FILE_INFO_FROM_LINK (FvFileInfoLink);
-    if (mUnicodeCollation->StriColl (mUnicodeCollation, &FvFileInfo->FileInfo.FileName[0], FileName) == 0) {
-      Status = EFI_SUCCESS;
-      break;
+  // MU_CHANGE [BEGIN] - Look the file name up through the FV file name index.
+  FileNameLength    = StrLen (FileName);
+  NewFileNameLength = FileNameLength + 1 + 4;
+  UpperName         = NULL;
+  if (Instance->FileInfoIndex != NULL) {
+    UpperName = AllocatePool (NewFileNameLength * sizeof (CHAR16));
+    if (UpperName != NULL) {
+      StrCpyS (UpperName, NewFileNameLength, FileName);
+      mUnicodeCollation->StrUpr (mUnicodeCollation, UpperName);
     }
   }
 
+  Status     = EFI_SUCCESS;
+  FvFileInfo = FvFsFindFileInfo (Instance, FileName, UpperName);
+
   // If the file has not been found check if the filename exists with an extension
   // in case there was no extension present.
   // FvFileSystem adds a 'virtual' extension '.EFI' to EFI applications and drivers
   // present in the Firmware Volume
-  if (Status == EFI_NOT_FOUND) {
-    FileNameLength = StrLen (FileName);
-
+  if (FvFileInfo == NULL) {
     // Does the filename already contain the '.EFI' extension?
-    if (mUnicodeCollation->StriColl (mUnicodeCollation, FileName + FileNameLength - 4, L".efi") != 0) {
+    if ((FileNameLength < 4) ||
+        (mUnicodeCollation->StriColl (mUnicodeCollation, FileName + FileNameLength - 4, L".efi") != 0)) {
       // No, there was no extension. So add one and search again for the file
       // NewFileNameLength = FileNameLength + 1 + 4 = (Number of non-null character) + (file extension) + (a null character)
-      NewFileNameLength = FileNameLength + 1 + 4;
-      FileNameWithExtension = AllocatePool (NewFileNameLength * 2);
-      StrCpyS (FileNameWithExtension, NewFileNameLength, FileName);
-      StrCatS (FileNameWithExtension, NewFileNameLength, L".EFI");
-
-      for (FvFileInfoLink = GetFirstNode (&Instance->FileInfoHead);
-          !IsNull (&Instance->FileInfoHead, FvFileInfoLink);
-           FvFileInfoLink = GetNextNode (&Instance->FileInfoHead, FvFileInfoLink)) {
-        FvFileInfo = FVFS_FILE_INFO_FROM_LINK (FvFileInfoLink);
-        if (mUnicodeCollation->StriColl (mUnicodeCollation, &FvFileInfo->FileInfo.FileName[0], FileNameWithExtension) == 0) {
-          Status = EFI_SUCCESS;
-          break;
+      FileNameWithExtension = AllocatePool (NewFileNameLength * sizeof (CHAR16));
+      if (FileNameWithExtension == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+      } else {
+        StrCpyS (FileNameWithExtension, NewFileNameLength, FileName);
+        StrCatS (FileNameWithExtension, NewFileNameLength, L".EFI");
+        if (UpperName != NULL) {
+          StrCatS (UpperName, NewFileNameLength, L".EFI");
         }
+
+        FvFileInfo = FvFsFindFileInfo (Instance, FileNameWithExtension, UpperName);
+        FreePool (FileNameWithExtension);
       }
     }
   }
 
+  if (UpperName != NULL) {
+    FreePool (UpperName);
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (FvFileInfo == NULL) {
+    Status = EFI_NOT_FOUND;
+  }
+  // MU_CHANGE [END]
+
   if (!EFI_ERROR (Status)) {
     NewFile = AllocateZeroPool (sizeof (FV_FILESYSTEM_FILE));
     if (NewFile == NULL) {
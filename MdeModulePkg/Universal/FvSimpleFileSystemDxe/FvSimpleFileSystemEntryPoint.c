@@ -215,6 +215,8 @@ FvSimpleFileSystemOpenVolume (
     if (Status == EFI_NOT_FOUND) {
       Status = EFI_SUCCESS;
     }
+
+    FvFsBuildFileNameIndex (Instance);  // MU_CHANGE - Index the file names of the FV.
   }
 
   Instance->Root->DirReadNext = NULL;
@@ -616,6 +618,12 @@ FvSimpleFileSystemDriverStop (
     }
   }
 
+  // MU_CHANGE [BEGIN] - Index the file names of the FV.
+  if (Instance->FileInfoIndex != NULL) {
+    FreePool (Instance->FileInfoIndex);
+  }
+  // MU_CHANGE [END]
+
   if (Instance->Root != NULL) {
     //
     // Root->Name is statically allocated, no need to free.
@@ -49,6 +49,14 @@ struct _FV_FILESYSTEM_INSTANCE {
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  SimpleFs;
   FV_FILESYSTEM_FILE               *Root;
   CHAR16                           *VolumeLabel;
+  // MU_CHANGE [BEGIN] - Index the file names of the FV.
+  //
+  // Open addressed hash of FileInfoHead by upper cased file name, with
+  // FileInfoIndexSlots entries. NULL when the index could not be built.
+  //
+  FV_FILESYSTEM_FILE_INFO          **FileInfoIndex;
+  UINTN                            FileInfoIndexSlots;
+  // MU_CHANGE [END]
 };
 
 //
@@ -74,6 +82,7 @@ struct _FV_FILESYSTEM_FILE_INFO {
   LIST_ENTRY                       Link;
   EFI_GUID                         NameGuid;
   EFI_FV_FILETYPE                  Type;
+  UINT32                           NameHash;  // MU_CHANGE - Hash of the upper cased FileName.
   EFI_FILE_INFO                    FileInfo;
 };
 
@@ -483,6 +492,23 @@ FvFsGetFileSize (
   IN OUT FV_FILESYSTEM_FILE_INFO           *FvFileInfo
   );
 
+// MU_CHANGE [BEGIN] - Index the file names of the FV.
+/**
+  Build the file name index of an FV instance from its file info list.
+
+  If the index cannot be allocated, FileInfoIndex stays NULL and file opens
+  search the list linearly.
+
+  @param  Instance                    A pointer to the FV_FILESYSTEM_INSTANCE whose
+                                      FileInfoHead list has been populated.
+
+**/
+VOID
+FvFsBuildFileNameIndex (
+  IN OUT FV_FILESYSTEM_INSTANCE            *Instance
+  );
+// MU_CHANGE [END]
+
 /**
   Retrieves a Unicode string that is the user readable name of the driver.
 
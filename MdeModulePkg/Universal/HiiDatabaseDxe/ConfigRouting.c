@@ -387,14 +387,21 @@ OutputConfigBody (
 
   This is a internal function.
 
+  The buffer of MultiString is always MAX_STRING_LENGTH bytes doubled as many
+  times as needed to hold the string, so its size is known from the string
+  length alone and appending many strings costs linear rather than quadratic
+  time.
+
   @param  MultiString            String in <MultiConfigRequest>,
                                  <MultiConfigAltResp>, or <MultiConfigResp>. On
-                                 input, the buffer length of  this string is
-                                 MAX_STRING_LENGTH. On output, the  buffer length
-                                 might be updated.
+                                 input, the buffer was allocated with
+                                 MAX_STRING_LENGTH bytes and only grown by this
+                                 function. On output, the buffer might be
+                                 reallocated.
   @param  AppendString           NULL-terminated Unicode string.
 
   @retval EFI_INVALID_PARAMETER  Any incoming parameter is invalid.
+  @retval EFI_OUT_OF_RESOURCES   Unable to grow the buffer of MultiString.
   @retval EFI_SUCCESS            AppendString is append to the end of MultiString
 
 **/
@@ -406,7 +413,10 @@ AppendToMultiString (
 {
   UINTN AppendStringSize;
   UINTN MultiStringSize;
-  UINTN MaxLen;
+  UINTN NewStringSize;
+  UINTN BufferSize;
+  UINTN NewBufferSize;
+  EFI_STRING NewString;
 
   if (MultiString == NULL || *MultiString == NULL || AppendString == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -414,25 +424,41 @@ AppendToMultiString (
 
   AppendStringSize = StrSize (AppendString);
   MultiStringSize  = StrSize (*MultiString);
-  MaxLen = MAX_STRING_LENGTH / sizeof (CHAR16);
+  NewStringSize    = MultiStringSize + AppendStringSize - sizeof (CHAR16);
+
+  BufferSize = MAX_STRING_LENGTH;
+  while (BufferSize < MultiStringSize) {
+    BufferSize *= 2;
+  }
 
   //
-  // Enlarge the buffer each time when length exceeds MAX_STRING_LENGTH.
+  // Double the buffer until the result fits.
   //
-  if (MultiStringSize + AppendStringSize > MAX_STRING_LENGTH ||
-      MultiStringSize > MAX_STRING_LENGTH) {
-    *MultiString = (EFI_STRING) ReallocatePool (
-                                  MultiStringSize,
-                                  MultiStringSize + AppendStringSize,
-                                  (VOID *) (*MultiString)
-                                  );
-    MaxLen = (MultiStringSize + AppendStringSize) / sizeof (CHAR16);
-    ASSERT (*MultiString != NULL);
+  if (NewStringSize > BufferSize) {
+    NewBufferSize = BufferSize;
+    while (NewBufferSize < NewStringSize) {
+      NewBufferSize *= 2;
+    }
+    NewString = (EFI_STRING) ReallocatePool (
+                               BufferSize,
+                               NewBufferSize,
+                               (VOID *) (*MultiString)
+                               );
+    ASSERT (NewString != NULL);
+    if (NewString == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    *MultiString = NewString;
   }
   //
-  // Append the incoming string
+  // Append the incoming string, including its terminator, over the
+  // terminator of MultiString.
   //
-  StrCatS (*MultiString, MaxLen, AppendString);
+  CopyMem (
+    (UINT8 *) *MultiString + MultiStringSize - sizeof (CHAR16),
+    AppendString,
+    AppendStringSize
+    );
 
   return EFI_SUCCESS;
 }
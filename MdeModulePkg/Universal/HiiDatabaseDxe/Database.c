@@ -1497,6 +1497,7 @@ AdjustStringPackage (
       *BlockPtr = EFI_HII_SIBT_END;
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      InvalidateStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += Skip2BlockSize;
       PackageList->PackageListHdr.PackageLength += Skip2BlockSize;
       StringPackage->MaxStringId = MaxStringId;
@@ -1636,6 +1637,7 @@ RemoveStringPackages (
 
     RemoveEntryList (&Package->StringEntry);
     PackageList->PackageListHdr.PackageLength -= Package->StringPkgHdr->Header.Length;
+    InvalidateStringIndex (Package);
     FreePool (Package->StringBlock);
     FreePool (Package->StringPkgHdr);
     //
@@ -2319,6 +2321,7 @@ InsertSimpleFontPackage (
   //
   InsertTailList (&PackageList->SimpleFontPkgHdr, &SimpleFontPackage->SimpleFontEntry);
   *Package = SimpleFontPackage;
+  InvalidateSimpleGlyphCache ();
 
   if (NotifyType == EFI_HII_DATABASE_NOTIFY_ADD_PACK) {
     PackageList->PackageListHdr.PackageLength += Header.Length;
@@ -2460,6 +2463,7 @@ RemoveSimpleFontPackages (
     PackageList->PackageListHdr.PackageLength -= Package->SimpleFontPkgHdr->Header.Length;
     FreePool (Package->SimpleFontPkgHdr);
     FreePool (Package);
+    InvalidateSimpleGlyphCache ();
   }
 
   return EFI_SUCCESS;
@@ -32,6 +32,13 @@ EFI_GRAPHICS_OUTPUT_BLT_PIXEL        mHiiEfiColors[16] = {
   {0xff, 0xff, 0xff, 0x00},  // WHITE
 };
 
+//
+// Result of the simple font lookup for the characters below
+// HII_SIMPLE_GLYPH_CACHE_SIZE. Zeroed whenever a simple font package is added
+// or removed, since the glyph pointers point into the package data.
+//
+HII_SIMPLE_GLYPH_CACHE_ENTRY         mSimpleGlyphCache[HII_SIMPLE_GLYPH_CACHE_SIZE];
+
 
 /**
   Insert a character cell information to the list specified by GlyphInfoList.
@@ -130,6 +137,124 @@ GetCell (
 }
 
 
+/**
+  Invalidate the cached simple font lookups.
+
+  This is a internal function. It must be called whenever a simple font
+  package is added to or removed from the database.
+
+**/
+VOID
+InvalidateSimpleGlyphCache (
+  VOID
+  )
+{
+  ZeroMem (mSimpleGlyphCache, sizeof (mSimpleGlyphCache));
+}
+
+
+/**
+  Find a character in the simple font packages of the database.
+
+  This is a internal function. The packages are searched in database order,
+  the narrow glyphs of a package before its wide glyphs, and the first match
+  is returned. Results for the characters below HII_SIMPLE_GLYPH_CACHE_SIZE,
+  including misses, are remembered so the packages are only searched once
+  for each of them.
+
+  @param  Private                 HII database driver private data.
+  @param  Char                    Character to find.
+  @param  NarrowPtr               Output the narrow glyph, or NULL if the
+                                  character was found as a wide glyph.
+  @param  WidePtr                 Output the wide glyph, or NULL if the
+                                  character was found as a narrow glyph.
+
+  @retval TRUE                    The character was found.
+  @retval FALSE                   No simple font package has this character.
+
+**/
+BOOLEAN
+FindSimpleGlyph (
+  IN  HII_DATABASE_PRIVATE_DATA      *Private,
+  IN  CHAR16                         Char,
+  OUT EFI_NARROW_GLYPH               **NarrowPtr,
+  OUT EFI_WIDE_GLYPH                 **WidePtr
+  )
+{
+  HII_DATABASE_RECORD                *Node;
+  LIST_ENTRY                         *Link;
+  HII_SIMPLE_FONT_PACKAGE_INSTANCE   *SimpleFont;
+  LIST_ENTRY                         *Link1;
+  UINT16                             Index;
+  EFI_NARROW_GLYPH                   *Narrow;
+  EFI_WIDE_GLYPH                     *Wide;
+  HII_SIMPLE_GLYPH_CACHE_ENTRY       *CacheEntry;
+
+  *NarrowPtr = NULL;
+  *WidePtr   = NULL;
+
+  CacheEntry = NULL;
+  if (Char < HII_SIMPLE_GLYPH_CACHE_SIZE) {
+    CacheEntry = &mSimpleGlyphCache[Char];
+    switch (CacheEntry->State) {
+    case HII_SIMPLE_GLYPH_CACHE_NARROW:
+      *NarrowPtr = (EFI_NARROW_GLYPH *) CacheEntry->Glyph;
+      return TRUE;
+    case HII_SIMPLE_GLYPH_CACHE_WIDE:
+      *WidePtr = (EFI_WIDE_GLYPH *) CacheEntry->Glyph;
+      return TRUE;
+    case HII_SIMPLE_GLYPH_CACHE_MISSING:
+      return FALSE;
+    default:
+      break;
+    }
+  }
+
+  for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
+    Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
+         Link1 != &Node->PackageList->SimpleFontPkgHdr;
+         Link1 = Link1->ForwardLink
+        ) {
+      SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
+      //
+      // Search the narrow glyph array
+      //
+      Narrow = (EFI_NARROW_GLYPH *) ((UINT8 *) (SimpleFont->SimpleFontPkgHdr) + sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR));
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
+        if (ReadUnaligned16 (&Narrow[Index].UnicodeWeight) == Char) {
+          *NarrowPtr = Narrow + Index;
+          if (CacheEntry != NULL) {
+            CacheEntry->Glyph = *NarrowPtr;
+            CacheEntry->State = HII_SIMPLE_GLYPH_CACHE_NARROW;
+          }
+          return TRUE;
+        }
+      }
+      //
+      // Search the wide glyph array
+      //
+      Wide = (EFI_WIDE_GLYPH *) (Narrow + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
+        if (ReadUnaligned16 (&Wide[Index].UnicodeWeight) == Char) {
+          *WidePtr = Wide + Index;
+          if (CacheEntry != NULL) {
+            CacheEntry->Glyph = *WidePtr;
+            CacheEntry->State = HII_SIMPLE_GLYPH_CACHE_WIDE;
+          }
+          return TRUE;
+        }
+      }
+    }
+  }
+
+  if (CacheEntry != NULL) {
+    CacheEntry->State = HII_SIMPLE_GLYPH_CACHE_MISSING;
+  }
+  return FALSE;
+}
+
+
 /**
   Convert the glyph for a single character into a bitmap.
 
@@ -160,15 +285,9 @@ GetGlyphBuffer (
   OUT UINT8                          *Attributes OPTIONAL
   )
 {
-  HII_DATABASE_RECORD                *Node;
-  LIST_ENTRY                         *Link;
-  HII_SIMPLE_FONT_PACKAGE_INSTANCE   *SimpleFont;
-  LIST_ENTRY                         *Link1;
-  UINT16                             Index;
   EFI_NARROW_GLYPH                   Narrow;
   EFI_WIDE_GLYPH                     Wide;
   HII_GLOBAL_FONT_INFO               *GlobalFont;
-  UINTN                              HeaderSize;
   EFI_NARROW_GLYPH                   *NarrowPtr;
   EFI_WIDE_GLYPH                     *WidePtr;
 
@@ -195,64 +314,42 @@ GetGlyphBuffer (
       *Attributes = PROPORTIONAL_GLYPH;
     }
     return FindGlyphBlock (GlobalFont->FontPackage, Char, GlyphBuffer, Cell, NULL);
-  } else {
-    HeaderSize = sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR);
-
-    for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
-      Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
-      for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
-           Link1 != &Node->PackageList->SimpleFontPkgHdr;
-           Link1 = Link1->ForwardLink
-          ) {
-        SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
-        //
-        // Search the narrow glyph array
-        //
-        NarrowPtr = (EFI_NARROW_GLYPH *) ((UINT8 *) (SimpleFont->SimpleFontPkgHdr) + HeaderSize);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
-          CopyMem (&Narrow, NarrowPtr + Index,sizeof (EFI_NARROW_GLYPH));
-          if (Narrow.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-            Cell->Width    = EFI_GLYPH_WIDTH;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8) (Narrow.Attributes | NARROW_GLYPH);
-            }
-            return EFI_SUCCESS;
-          }
-        }
-        //
-        // Search the wide glyph array
-        //
-        WidePtr = (EFI_WIDE_GLYPH *) (NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
-          CopyMem (&Wide, WidePtr + Index, sizeof (EFI_WIDE_GLYPH));
-          if (Wide.UnicodeWeight == Char) {
-            *GlyphBuffer    = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-            Cell->Width    = EFI_GLYPH_WIDTH * 2;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
-            CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8) (Wide.Attributes | EFI_GLYPH_WIDE);
-            }
-            return EFI_SUCCESS;
-          }
-        }
-      }
+  }
+
+  if (!FindSimpleGlyph (Private, Char, &NarrowPtr, &WidePtr)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (NarrowPtr != NULL) {
+    CopyMem (&Narrow, NarrowPtr, sizeof (EFI_NARROW_GLYPH));
+    *GlyphBuffer = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT);
+    if (*GlyphBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
+    Cell->Width    = EFI_GLYPH_WIDTH;
+    Cell->Height   = EFI_GLYPH_HEIGHT;
+    Cell->AdvanceX = Cell->Width;
+    CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
+    if (Attributes != NULL) {
+      *Attributes = (UINT8) (Narrow.Attributes | NARROW_GLYPH);
+    }
+    return EFI_SUCCESS;
   }
 
-  return EFI_NOT_FOUND;
+  CopyMem (&Wide, WidePtr, sizeof (EFI_WIDE_GLYPH));
+  *GlyphBuffer    = (UINT8 *) AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
+  if (*GlyphBuffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Cell->Width    = EFI_GLYPH_WIDTH * 2;
+  Cell->Height   = EFI_GLYPH_HEIGHT;
+  Cell->AdvanceX = Cell->Width;
+  CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
+  CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
+  if (Attributes != NULL) {
+    *Attributes = (UINT8) (Wide.Attributes | EFI_GLYPH_WIDE);
+  }
+  return EFI_SUCCESS;
 }
 
 /**
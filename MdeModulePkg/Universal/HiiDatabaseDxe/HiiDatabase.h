@@ -153,6 +153,16 @@ typedef struct {
 // String Package definitions
 //
 #define HII_STRING_PACKAGE_SIGNATURE    SIGNATURE_32 ('h','i','s','p')
+
+//
+// Location of one string in the string blocks, indexed by StringId.
+// TextOffset is 0 if the string is not indexed.
+//
+typedef struct {
+  UINT32                                BlockOffset;   // offset of the block from StringBlock
+  UINT32                                TextOffset;    // offset of the string text from the block
+} HII_STRING_INDEX_ENTRY;
+
 typedef struct _HII_STRING_PACKAGE_INSTANCE {
   UINTN                                 Signature;
   EFI_HII_STRING_PACKAGE_HDR            *StringPkgHdr;
@@ -161,6 +171,8 @@ typedef struct _HII_STRING_PACKAGE_INSTANCE {
   LIST_ENTRY                            FontInfoList;  // local font info list
   UINT8                                 FontId;
   EFI_STRING_ID                         MaxStringId;   // record StringId
+  HII_STRING_INDEX_ENTRY                *StringIndex;  // built on first lookup
+  UINTN                                 StringIndexCount;
 } HII_STRING_PACKAGE_INSTANCE;
 
 //
@@ -184,6 +196,21 @@ typedef struct _HII_SIMPLE_FONT_PACKAGE_INSTANCE {
   LIST_ENTRY                            SimpleFontEntry;
 } HII_SIMPLE_FONT_PACKAGE_INSTANCE;
 
+//
+// Cached simple font lookup of one character
+//
+#define HII_SIMPLE_GLYPH_CACHE_SIZE     0x100
+
+#define HII_SIMPLE_GLYPH_CACHE_UNKNOWN  0
+#define HII_SIMPLE_GLYPH_CACHE_NARROW   1
+#define HII_SIMPLE_GLYPH_CACHE_WIDE     2
+#define HII_SIMPLE_GLYPH_CACHE_MISSING  3
+
+typedef struct {
+  UINT8                                 State;
+  VOID                                  *Glyph;  // EFI_NARROW_GLYPH or EFI_WIDE_GLYPH in the package
+} HII_SIMPLE_GLYPH_CACHE_ENTRY;
+
 //
 // Font Package definitions
 //
@@ -540,6 +567,20 @@ FindStringBlock (
   OUT EFI_STRING_ID                   *StartStringId OPTIONAL
   );
 
+/**
+  Free the StringId index of a string package.
+
+  This is a internal function. It must be called whenever the string blocks
+  of the package are reallocated.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+InvalidateStringIndex (
+  IN  HII_STRING_PACKAGE_INSTANCE     *StringPackage
+  );
+
 
 /**
   Parse all glyph blocks to find a glyph block specified by CharValue.
@@ -571,6 +612,18 @@ FindGlyphBlock (
   OUT UINTN                          *GlyphBufferLen OPTIONAL
   );
 
+/**
+  Invalidate the cached simple font lookups.
+
+  This is a internal function. It must be called whenever a simple font
+  package is added to or removed from the database.
+
+**/
+VOID
+InvalidateSimpleGlyphCache (
+  VOID
+  );
+
 /**
   This function exports Form packages to a buffer.
   This is a internal function.
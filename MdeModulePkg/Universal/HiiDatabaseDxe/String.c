@@ -227,6 +227,192 @@ GetStringFontInfo (
 }
 
 
+/**
+  Free the StringId index of a string package.
+
+  This is a internal function. It must be called whenever the string blocks
+  of the package are reallocated.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+InvalidateStringIndex (
+  IN  HII_STRING_PACKAGE_INSTANCE     *StringPackage
+  )
+{
+  if (StringPackage->StringIndex != NULL) {
+    FreePool (StringPackage->StringIndex);
+    StringPackage->StringIndex = NULL;
+  }
+  StringPackage->StringIndexCount = 0;
+}
+
+
+/**
+  Parse all string blocks once and record the location of every string, so
+  that later lookups by StringId don't walk the string blocks again.
+
+  Strings that are only reachable through a forward EFI_HII_SIBT_DUPLICATE
+  block or lie in a skip block are not indexed, FindStringBlock falls back
+  to parsing the string blocks for them.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+
+  @retval EFI_SUCCESS             The index is built.
+  @retval EFI_UNSUPPORTED         An unknown string block type is found.
+  @retval EFI_OUT_OF_RESOURCES    The system is out of resources to accomplish the
+                                  task.
+
+**/
+EFI_STATUS
+BuildStringIndex (
+  IN  HII_STRING_PACKAGE_INSTANCE     *StringPackage
+  )
+{
+  HII_STRING_INDEX_ENTRY               *StringIndex;
+  UINTN                                Count;
+  UINT8                                *BlockHdr;
+  UINT8                                *StringTextPtr;
+  EFI_STRING_ID                        CurrentStringId;
+  EFI_STRING_ID                        DuplicateId;
+  UINT16                               StringCount;
+  UINT16                               SkipCount;
+  UINT8                                Length8;
+  EFI_HII_SIBT_EXT2_BLOCK              Ext2;
+  UINT32                               Length32;
+  UINTN                                StringSize;
+  BOOLEAN                              Ascii;
+  UINTN                                Index;
+
+  InvalidateStringIndex (StringPackage);
+
+  Count       = (UINTN) StringPackage->MaxStringId + 1;
+  StringIndex = (HII_STRING_INDEX_ENTRY *) AllocateZeroPool (Count * sizeof (HII_STRING_INDEX_ENTRY));
+  if (StringIndex == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CurrentStringId = 1;
+  BlockHdr        = StringPackage->StringBlock;
+  while (*BlockHdr != EFI_HII_SIBT_END) {
+    StringTextPtr = NULL;
+    StringCount   = 1;
+    Ascii         = TRUE;
+
+    switch (*BlockHdr) {
+    case EFI_HII_SIBT_STRING_SCSU:
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_STRING_BLOCK);
+      break;
+
+    case EFI_HII_SIBT_STRING_SCSU_FONT:
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRING_SCSU_FONT_BLOCK) - sizeof (UINT8);
+      break;
+
+    case EFI_HII_SIBT_STRINGS_SCSU:
+      CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_SCSU_BLOCK) - sizeof (UINT8);
+      break;
+
+    case EFI_HII_SIBT_STRINGS_SCSU_FONT:
+      CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_SCSU_FONT_BLOCK) - sizeof (UINT8);
+      break;
+
+    case EFI_HII_SIBT_STRING_UCS2:
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_STRING_BLOCK);
+      Ascii         = FALSE;
+      break;
+
+    case EFI_HII_SIBT_STRING_UCS2_FONT:
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRING_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+      Ascii         = FALSE;
+      break;
+
+    case EFI_HII_SIBT_STRINGS_UCS2:
+      CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_UCS2_BLOCK) - sizeof (CHAR16);
+      Ascii         = FALSE;
+      break;
+
+    case EFI_HII_SIBT_STRINGS_UCS2_FONT:
+      CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+      StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+      Ascii         = FALSE;
+      break;
+
+    case EFI_HII_SIBT_DUPLICATE:
+      //
+      // A duplicate of an earlier string shares its location.
+      //
+      CopyMem (&DuplicateId, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (EFI_STRING_ID));
+      if (CurrentStringId < Count && DuplicateId < CurrentStringId) {
+        StringIndex[CurrentStringId] = StringIndex[DuplicateId];
+      }
+      CurrentStringId++;
+      BlockHdr += sizeof (EFI_HII_SIBT_DUPLICATE_BLOCK);
+      break;
+
+    case EFI_HII_SIBT_SKIP1:
+      SkipCount = (UINT16) (*(BlockHdr + sizeof (EFI_HII_STRING_BLOCK)));
+      CurrentStringId = (UINT16) (CurrentStringId + SkipCount);
+      BlockHdr += sizeof (EFI_HII_SIBT_SKIP1_BLOCK);
+      break;
+
+    case EFI_HII_SIBT_SKIP2:
+      CopyMem (&SkipCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+      CurrentStringId = (UINT16) (CurrentStringId + SkipCount);
+      BlockHdr += sizeof (EFI_HII_SIBT_SKIP2_BLOCK);
+      break;
+
+    case EFI_HII_SIBT_EXT1:
+      CopyMem (&Length8, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT8));
+      BlockHdr += Length8;
+      break;
+
+    case EFI_HII_SIBT_EXT2:
+      CopyMem (&Ext2, BlockHdr, sizeof (EFI_HII_SIBT_EXT2_BLOCK));
+      BlockHdr += Ext2.Length;
+      break;
+
+    case EFI_HII_SIBT_EXT4:
+      CopyMem (&Length32, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT32));
+      BlockHdr += Length32;
+      break;
+
+    default:
+      FreePool (StringIndex);
+      return EFI_UNSUPPORTED;
+    }
+
+    if (StringTextPtr == NULL) {
+      continue;
+    }
+
+    for (Index = 0; Index < StringCount; Index++) {
+      if (CurrentStringId < Count) {
+        StringIndex[CurrentStringId].BlockOffset = (UINT32) (BlockHdr - StringPackage->StringBlock);
+        StringIndex[CurrentStringId].TextOffset  = (UINT32) (StringTextPtr - BlockHdr);
+      }
+      if (Ascii) {
+        StringTextPtr += AsciiStrSize ((CHAR8 *) StringTextPtr);
+      } else {
+        GetUnicodeStringTextOrSize (NULL, StringTextPtr, &StringSize);
+        StringTextPtr += StringSize;
+      }
+      CurrentStringId++;
+    }
+    BlockHdr = StringTextPtr;
+  }
+
+  StringPackage->StringIndex      = StringIndex;
+  StringPackage->StringIndexCount = Count;
+  return EFI_SUCCESS;
+}
+
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -297,6 +483,23 @@ FindStringBlock (
     if (StringId > StringPackage->MaxStringId) {
       return EFI_NOT_FOUND;
     }
+
+    //
+    // Look the string up in the index of the package, building it on first
+    // use. Strings that are not indexed are searched below.
+    //
+    if (StartStringId == NULL) {
+      if (StringPackage->StringIndex == NULL) {
+        BuildStringIndex (StringPackage);
+      }
+      if (StringId < StringPackage->StringIndexCount &&
+          StringPackage->StringIndex[StringId].TextOffset != 0) {
+        *StringBlockAddr  = StringPackage->StringBlock + StringPackage->StringIndex[StringId].BlockOffset;
+        *BlockType        = **StringBlockAddr;
+        *StringTextOffset = StringPackage->StringIndex[StringId].TextOffset;
+        return EFI_SUCCESS;
+      }
+    }
   } else {
     ASSERT (Private != NULL && Private->Signature == HII_DATABASE_PRIVATE_DATA_SIGNATURE);
     if (StringId == 0 && LastStringId != NULL) {
@@ -841,6 +1044,7 @@ InsertLackStringBlock (
   }
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock = StringBlock;
+  InvalidateStringIndex (StringPackage);
   StringPackage->StringPkgHdr->Header.Length += NewBlockSize - OldBlockSize;
 
   return EFI_SUCCESS;
@@ -1009,6 +1213,7 @@ SetStringWorker (
     ZeroMem (StringPackage->StringBlock, OldBlockSize);
     FreePool (StringPackage->StringBlock);
     StringPackage->StringBlock = Block;
+    InvalidateStringIndex (StringPackage);
     StringPackage->StringPkgHdr->Header.Length += (UINT32) (BlockSize - OldBlockSize);
     break;
 
@@ -1043,6 +1248,7 @@ SetStringWorker (
     ZeroMem (StringPackage->StringBlock, OldBlockSize);
     FreePool (StringPackage->StringBlock);
     StringPackage->StringBlock = Block;
+    InvalidateStringIndex (StringPackage);
     StringPackage->StringPkgHdr->Header.Length += (UINT32) (BlockSize - OldBlockSize);
     break;
 
@@ -1095,6 +1301,7 @@ SetStringWorker (
   ZeroMem (StringPackage->StringBlock, OldBlockSize);
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock = Block;
+  InvalidateStringIndex (StringPackage);
   StringPackage->StringPkgHdr->Header.Length += Ext2.Length;
 
   return EFI_SUCCESS;
@@ -1281,6 +1488,7 @@ HiiNewString (
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      InvalidateStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += Ucs2BlockSize;
       PackageListNode->PackageListHdr.PackageLength += Ucs2BlockSize;
     }
@@ -1413,6 +1621,7 @@ HiiNewString (
     ZeroMem (StringPackage->StringBlock, OldBlockSize);
     FreePool (StringPackage->StringBlock);
     StringPackage->StringBlock = StringBlock;
+    InvalidateStringIndex (StringPackage);
     StringPackage->StringPkgHdr->Header.Length += Ucs2BlockSize;
     PackageListNode->PackageListHdr.PackageLength += Ucs2BlockSize;
 
@@ -1456,6 +1665,7 @@ HiiNewString (
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      InvalidateStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += Ucs2FontBlockSize;
       PackageListNode->PackageListHdr.PackageLength += Ucs2FontBlockSize;
 
@@ -1518,6 +1728,7 @@ HiiNewString (
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock = StringBlock;
+      InvalidateStringIndex (StringPackage);
       StringPackage->StringPkgHdr->Header.Length += FontBlockSize + Ucs2FontBlockSize;
       PackageListNode->PackageListHdr.PackageLength += FontBlockSize + Ucs2FontBlockSize;
 
@@ -1559,6 +1770,7 @@ Done:
     // Free the allocated new string Package when new string can't be added.
     //
     RemoveEntryList (&StringPackage->StringEntry);
+    InvalidateStringIndex (StringPackage);
     FreePool (StringPackage->StringBlock);
     FreePool (StringPackage->StringPkgHdr);
     FreePool (StringPackage);
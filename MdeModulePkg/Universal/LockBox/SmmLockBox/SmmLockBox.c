@@ -6,8 +6,8 @@
   This external input must be validated carefully to avoid security issue like
   buffer overflow, integer overflow.
 
-  SmmLockBoxHandler(), SmmLockBoxRestore(), SmmLockBoxUpdate(), SmmLockBoxSave()
-  will receive untrusted input and do basic validation.
+  SmmLockBoxHandler(), SmmLockBoxRestore(), SmmLockBoxUpdate(), SmmLockBoxSave(),
+  SmmLockBoxRestoreMultiple() will receive untrusted input and do basic validation.
 
 Copyright (c) 2010 - 2018, Intel Corporation. All rights reserved.<BR>
 
@@ -248,6 +248,81 @@ SmmLockBoxRestoreAllInPlace (
   return ;
 }
 
+// MU_CHANGE [BEGIN] - Restore several LockBoxes at once.
+/**
+  Dispatch function for SMM lock box restore multiple.
+
+  Caution: This function may receive untrusted input.
+  Entry count, restore buffers and lengths are external input, so this function
+  will validate the entries are within the communicate buffer, and the restore
+  buffers are outside of SMRAM.
+
+  @param LockBoxParameterRestoreMultiple  parameter of lock box restore multiple
+  @param CommBufferSize                   size of the communicate buffer
+**/
+VOID
+SmmLockBoxRestoreMultiple (
+  IN EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE *LockBoxParameterRestoreMultiple,
+  IN UINTN                                       CommBufferSize
+  )
+{
+  EFI_STATUS                      Status;
+  EFI_STATUS                      FirstStatus;
+  EFI_SMM_LOCK_BOX_RESTORE_ENTRY  *LockBoxEntry;
+  EFI_SMM_LOCK_BOX_RESTORE_ENTRY  TempLockBoxEntry;
+  UINT64                          Count;
+  UINTN                           Index;
+
+  Count = LockBoxParameterRestoreMultiple->Count;
+
+  //
+  // Sanity check
+  //
+  if (Count > (CommBufferSize - sizeof (EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE)) / sizeof (EFI_SMM_LOCK_BOX_RESTORE_ENTRY)) {
+    DEBUG ((EFI_D_ERROR, "SmmLockBox Command Buffer Size for RESTORE_MULTIPLE invalid!\n"));
+    LockBoxParameterRestoreMultiple->Header.ReturnStatus = (UINT64)EFI_INVALID_PARAMETER;
+    return ;
+  }
+
+  FirstStatus  = EFI_SUCCESS;
+  LockBoxEntry = (EFI_SMM_LOCK_BOX_RESTORE_ENTRY *)(LockBoxParameterRestoreMultiple + 1);
+  for (Index = 0; Index < (UINTN)Count; Index++, LockBoxEntry++) {
+    CopyMem (&TempLockBoxEntry, LockBoxEntry, sizeof (EFI_SMM_LOCK_BOX_RESTORE_ENTRY));
+
+    if (!SmmIsBufferOutsideSmmValid ((UINTN)TempLockBoxEntry.Buffer, (UINTN)TempLockBoxEntry.Length)) {
+      DEBUG ((EFI_D_ERROR, "SmmLockBox Restore address in SMRAM or buffer overflow!\n"));
+      Status = EFI_ACCESS_DENIED;
+    } else if ((TempLockBoxEntry.Length == 0) && (TempLockBoxEntry.Buffer == 0)) {
+      Status = RestoreLockBox (
+                 &TempLockBoxEntry.Guid,
+                 NULL,
+                 NULL
+                 );
+    } else {
+      Status = RestoreLockBox (
+                 &TempLockBoxEntry.Guid,
+                 (VOID *)(UINTN)TempLockBoxEntry.Buffer,
+                 (UINTN *)&TempLockBoxEntry.Length
+                 );
+      if ((Status == EFI_BUFFER_TOO_SMALL) || (Status == EFI_SUCCESS)) {
+        //
+        // Return the actual Length value.
+        //
+        LockBoxEntry->Length = TempLockBoxEntry.Length;
+      }
+    }
+
+    LockBoxEntry->ReturnStatus = (UINT64)Status;
+    if (EFI_ERROR (Status) && !EFI_ERROR (FirstStatus)) {
+      FirstStatus = Status;
+    }
+  }
+
+  LockBoxParameterRestoreMultiple->Header.ReturnStatus = (UINT64)FirstStatus;
+  return ;
+}
+// MU_CHANGE [END]
+
 /**
   Dispatch function for a Software SMI handler.
 
@@ -343,6 +418,15 @@ SmmLockBoxHandler (
     }
     SmmLockBoxRestoreAllInPlace ((EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_ALL_IN_PLACE *)(UINTN)LockBoxParameterHeader);
     break;
+  // MU_CHANGE [BEGIN] - Restore several LockBoxes at once.
+  case EFI_SMM_LOCK_BOX_COMMAND_RESTORE_MULTIPLE:
+    if (TempCommBufferSize < sizeof(EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE)) {
+      DEBUG ((EFI_D_ERROR, "SmmLockBox Command Buffer Size for RESTORE_MULTIPLE invalid!\n"));
+      break;
+    }
+    SmmLockBoxRestoreMultiple ((EFI_SMM_LOCK_BOX_PARAMETER_RESTORE_MULTIPLE *)(UINTN)LockBoxParameterHeader, TempCommBufferSize);
+    break;
+  // MU_CHANGE [END]
   default:
     DEBUG ((EFI_D_ERROR, "SmmLockBox Command invalid!\n"));
     break;
@@ -225,13 +225,9 @@ DirectRangeTest (
 
   //
   // Perform a dummy memory test, so directly write the pattern to all range
+  // and verify it
   //
-  WriteMemory (Private, StartAddress, Length);
-
-  //
-  // Verify the memory range
-  //
-  Status = VerifyMemory (Private, StartAddress, Length);
+  Status = TestMemoryRange (Private, StartAddress, Length);   // MU_CHANGE
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -376,10 +372,8 @@ VerifyMemory (
 {
   EFI_PHYSICAL_ADDRESS            Address;
   INTN                            ErrorFound;
-  EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
 
   Address           = Start;
-  ExtendedErrorData = NULL;
 
   //
   // Add 4G memory address check for IA32 platform
@@ -404,37 +398,268 @@ VerifyMemory (
       //
       // Report uncorrectable errors
       //
-      ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
-      if (ExtendedErrorData == NULL) {
-        return EFI_OUT_OF_RESOURCES;
+      return ReportMemoryError (Address);   // MU_CHANGE
+    }
+
+    Address += Private->CoverageSpan;
+  }
+
+  return EFI_SUCCESS;
+}
+
+// MU_CHANGE [BEGIN] - Test memory blocks on all processors.
+/**
+  Report an uncorrectable memory error found by the memory test.
+
+  @param[in] Address  The start of the test location that miscompared.
+
+  @retval EFI_DEVICE_ERROR      The error was reported.
+  @retval EFI_OUT_OF_RESOURCES  The error data could not be allocated.
+
+**/
+EFI_STATUS
+ReportMemoryError (
+  IN  EFI_PHYSICAL_ADDRESS         Address
+  )
+{
+  EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
+
+  ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
+  if (ExtendedErrorData == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ExtendedErrorData->DataHeader.HeaderSize  = (UINT16) sizeof (EFI_STATUS_CODE_DATA);
+  ExtendedErrorData->DataHeader.Size        = (UINT16) (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
+  ExtendedErrorData->Granularity            = EFI_MEMORY_ERROR_DEVICE;
+  ExtendedErrorData->Operation              = EFI_MEMORY_OPERATION_READ;
+  ExtendedErrorData->Syndrome               = 0x0;
+  ExtendedErrorData->Address                = Address;
+  ExtendedErrorData->Resolution             = 0x40;
+
+  REPORT_STATUS_CODE_EX (
+      EFI_ERROR_CODE,
+      EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
+      0,
+      &gEfiGenericMemTestProtocolGuid,
+      NULL,
+      (UINT8 *) ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
+      ExtendedErrorData->DataHeader.Size
+      );
+
+  return EFI_DEVICE_ERROR;
+}
+
+/**
+  Check if every byte of a range is tested with the generic pattern.
+
+  In that case the whole range can be written with SetMem64(), which the SSE2
+  BaseMemoryLib instances implement with non-temporal stores, and can be
+  flushed and compared in one pass.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Size     The memory range's size.
+
+  @retval TRUE   The range is tested contiguously with the generic pattern.
+  @retval FALSE  The range must be tested one location at a time.
+
+**/
+STATIC
+BOOLEAN
+IsContiguousGenericPattern (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  UINT64                       Size
+  )
+{
+  return (BOOLEAN) ((Private->MonoPattern == GenericMemoryTestMonoPattern) &&
+                    (Private->MonoTestSize == GENERIC_CACHELINE_SIZE) &&
+                    (Private->CoverageSpan == GENERIC_CACHELINE_SIZE) &&
+                    ((Size & (GENERIC_CACHELINE_SIZE - 1)) == 0));
+}
+
+/**
+  Write, flush and verify the memory test pattern in one chunk of a block.
+
+  This function runs on APs, so it does not use any boot service or
+  protocol. The caller reports the error.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The chunk's start address.
+  @param[in] Size     The chunk's size.
+
+  @return The address of the first location that miscompared, or
+          PARALLEL_TEST_NO_ERROR if the chunk passed.
+
+**/
+STATIC
+EFI_PHYSICAL_ADDRESS
+TestMemoryChunk (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Address;
+  UINT64                *Qword;
+  UINTN                 Index;
+
+  if (IsContiguousGenericPattern (Private, Size)) {
+    SetMem64 ((VOID *) (UINTN) Start, (UINTN) Size, GENERIC_MONO_PATTERN_QWORD);
+    WriteBackInvalidateDataCacheRange ((VOID *) (UINTN) Start, (UINTN) Size);
+
+    Qword = (UINT64 *) (UINTN) Start;
+    for (Index = 0; Index < (UINTN) Size / sizeof (UINT64); Index++) {
+      if (Qword[Index] != GENERIC_MONO_PATTERN_QWORD) {
+        return (Start + Index * sizeof (UINT64)) & ~((EFI_PHYSICAL_ADDRESS) GENERIC_CACHELINE_SIZE - 1);
       }
+    }
+    return PARALLEL_TEST_NO_ERROR;
+  }
 
-      ExtendedErrorData->DataHeader.HeaderSize  = (UINT16) sizeof (EFI_STATUS_CODE_DATA);
-      ExtendedErrorData->DataHeader.Size        = (UINT16) (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
-      ExtendedErrorData->Granularity            = EFI_MEMORY_ERROR_DEVICE;
-      ExtendedErrorData->Operation              = EFI_MEMORY_OPERATION_READ;
-      ExtendedErrorData->Syndrome               = 0x0;
-      ExtendedErrorData->Address                = Address;
-      ExtendedErrorData->Resolution             = 0x40;
+  for (Address = Start; Address < Start + Size; Address += Private->CoverageSpan) {
+    CopyMem ((VOID *) (UINTN) Address, Private->MonoPattern, Private->MonoTestSize);
+    WriteBackInvalidateDataCacheRange ((VOID *) (UINTN) Address, Private->MonoTestSize);
+  }
 
-      REPORT_STATUS_CODE_EX (
-          EFI_ERROR_CODE,
-          EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
-          0,
-          &gEfiGenericMemTestProtocolGuid,
-          NULL,
-          (UINT8 *) ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
-          ExtendedErrorData->DataHeader.Size
-          );
+  for (Address = Start; Address < Start + Size; Address += Private->CoverageSpan) {
+    if (CompareMemWithoutCheckArgument (
+          (VOID *) (UINTN) Address,
+          Private->MonoPattern,
+          Private->MonoTestSize
+          ) != 0) {
+      return Address;
+    }
+  }
+  return PARALLEL_TEST_NO_ERROR;
+}
+
+/**
+  Test chunks of a block until none is left. This is the procedure started on
+  every enabled AP, and it is also run on the BSP.
 
-      return EFI_DEVICE_ERROR;
+  @param[in, out] Buffer  Point to the PARALLEL_MEMORY_TEST_CONTEXT.
+
+**/
+STATIC
+VOID
+EFIAPI
+ParallelMemoryTestProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  PARALLEL_MEMORY_TEST_CONTEXT  *Context;
+  UINT32                        ChunkIndex;
+  EFI_PHYSICAL_ADDRESS          ChunkStart;
+  UINT64                        ChunkLength;
+  EFI_PHYSICAL_ADDRESS          ErrorAddress;
+
+  Context = (PARALLEL_MEMORY_TEST_CONTEXT *) Buffer;
+
+  while (Context->ErrorAddress == PARALLEL_TEST_NO_ERROR) {
+    ChunkIndex = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (ChunkIndex >= Context->ChunkCount) {
+      break;
     }
 
-    Address += Private->CoverageSpan;
+    ChunkStart  = Context->Start + MultU64x32 (Context->ChunkSize, ChunkIndex);
+    ChunkLength = MIN (Context->ChunkSize, Context->Start + Context->Size - ChunkStart);
+
+    ErrorAddress = TestMemoryChunk (Context->Private, ChunkStart, ChunkLength);
+    if (ErrorAddress != PARALLEL_TEST_NO_ERROR) {
+      InterlockedCompareExchange64 (&Context->ErrorAddress, PARALLEL_TEST_NO_ERROR, ErrorAddress);
+    }
+  }
+}
+
+/**
+  Write and verify the memory test pattern in a range of physical memory.
+
+  The range is split across all enabled processors when MP services are
+  available and the range is large enough. Otherwise it is tested on the
+  calling processor with WriteMemory() and VerifyMemory().
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+  @retval EFI_SUCCESS Successful test the range of memory, no errors' location found.
+  @retval Others      The range of memory have errors contained.
+
+**/
+EFI_STATUS
+TestMemoryRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_STATUS                    Status;
+  PARALLEL_MEMORY_TEST_CONTEXT  Context;
+  EFI_EVENT                     ApsDoneEvent;
+  UINT64                        ChunkCount;
+
+  if ((Private->MpServices == NULL) ||
+      (Private->EnabledProcessorCount < 2) ||
+      (Start + Size > MAX_ADDRESS) ||
+      (DivU64x64Remainder (Size, Private->CoverageSpan, NULL) < PARALLEL_TEST_MIN_LOCATIONS)) {
+    WriteMemory (Private, Start, Size);
+    return VerifyMemory (Private, Start, Size);
+  }
+
+  //
+  // Split the range into chunks of whole test locations.
+  //
+  ChunkCount        = MultU64x32 (Private->EnabledProcessorCount, PARALLEL_TEST_CHUNKS_PER_CPU);
+  Context.ChunkSize = DivU64x64Remainder (Size + ChunkCount - 1, ChunkCount, NULL);
+  Context.ChunkSize = DivU64x64Remainder (
+                        Context.ChunkSize + Private->CoverageSpan - 1,
+                        Private->CoverageSpan,
+                        NULL
+                        );
+  Context.ChunkSize = MultU64x64 (Context.ChunkSize, Private->CoverageSpan);
+
+  Context.Private      = Private;
+  Context.Start        = Start;
+  Context.Size         = Size;
+  Context.ChunkCount   = (UINT32) DivU64x64Remainder (Size + Context.ChunkSize - 1, Context.ChunkSize, NULL);
+  Context.NextChunk    = 0;
+  Context.ErrorAddress = PARALLEL_TEST_NO_ERROR;
+
+  Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &ApsDoneEvent);
+  if (EFI_ERROR (Status)) {
+    WriteMemory (Private, Start, Size);
+    return VerifyMemory (Private, Start, Size);
+  }
+
+  Status = Private->MpServices->StartupAllAPs (
+                                  Private->MpServices,
+                                  ParallelMemoryTestProcedure,
+                                  FALSE,
+                                  ApsDoneEvent,
+                                  0,
+                                  &Context,
+                                  NULL
+                                  );
+
+  //
+  // The BSP takes chunks as well. If no AP was started, it tests them all.
+  //
+  ParallelMemoryTestProcedure (&Context);
+
+  if (!EFI_ERROR (Status)) {
+    while (gBS->CheckEvent (ApsDoneEvent) == EFI_NOT_READY) {
+      CpuPause ();
+    }
+  }
+  gBS->CloseEvent (ApsDoneEvent);
+
+  if (Context.ErrorAddress != PARALLEL_TEST_NO_ERROR) {
+    return ReportMemoryError (Context.ErrorAddress);
   }
 
   return EFI_SUCCESS;
 }
+// MU_CHANGE [END]
 
 /**
   Initialize the generic memory test.
@@ -458,6 +683,9 @@ InitializeMemoryTest (
   EFI_STATUS                  Status;
   GENERIC_MEMORY_TEST_PRIVATE *Private;
   EFI_CPU_ARCH_PROTOCOL       *Cpu;
+  EFI_MP_SERVICES_PROTOCOL    *MpServices;              // MU_CHANGE
+  UINTN                       ProcessorCount;           // MU_CHANGE
+  UINTN                       EnabledProcessorCount;    // MU_CHANGE
 
   Private             = GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This);
   *RequireSoftECCInit = FALSE;
@@ -492,6 +720,29 @@ InitializeMemoryTest (
   if (!EFI_ERROR (Status)) {
     Private->Cpu = Cpu;
   }
+
+  // MU_CHANGE [BEGIN] - Test memory blocks on all processors.
+  //
+  // Get the MP services protocol to spread every block across the enabled
+  // processors. The block grows with the processor count, so that each
+  // processor still tests about TEST_BLOCK_SIZE per progress report.
+  //
+  Private->MpServices            = NULL;
+  Private->EnabledProcessorCount = 1;
+  Status = gBS->LocateProtocol (
+                  &gEfiMpServiceProtocolGuid,
+                  NULL,
+                  (VOID **) &MpServices
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->GetNumberOfProcessors (MpServices, &ProcessorCount, &EnabledProcessorCount);
+    if (!EFI_ERROR (Status) && (EnabledProcessorCount > 1)) {
+      Private->MpServices            = MpServices;
+      Private->EnabledProcessorCount = EnabledProcessorCount;
+      Private->BdsBlockSize          = MultU64x32 (TEST_BLOCK_SIZE, (UINT32) EnabledProcessorCount);
+    }
+  }
+  // MU_CHANGE [END]
   //
   // Create the CoverageSpan of the memory test base on the coverage level
   //
@@ -608,9 +859,7 @@ GenPerformMemoryTest (
       // The software memory test (R/W/V) perform here. It will detect the
       // memory mis-compare error.
       //
-      WriteMemory (Private, mCurrentAddress, BlockBoundary);
-
-      Status = VerifyMemory (Private, mCurrentAddress, BlockBoundary);
+      Status = TestMemoryRange (Private, mCurrentAddress, BlockBoundary);   // MU_CHANGE
       if (EFI_ERROR (Status)) {
         //
         // If perform here, means there is mis-compare error, and no agent can
@@ -848,7 +1097,9 @@ GENERIC_MEMORY_TEST_PRIVATE mGenericMemoryTestPrivate = {
   {
     NULL,
     NULL
-  }
+  },
+  NULL,   // MU_CHANGE - MpServices
+  1       // MU_CHANGE - EnabledProcessorCount
 };
 
 /**
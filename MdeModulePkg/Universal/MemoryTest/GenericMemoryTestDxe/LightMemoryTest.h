@@ -13,6 +13,7 @@
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Protocol/GenericMemoryTest.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/MpService.h>                 // MU_CHANGE
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -23,6 +24,8 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/CacheMaintenanceLib.h>        // MU_CHANGE
+#include <Library/SynchronizationLib.h>         // MU_CHANGE
 
 //
 // Some global define
@@ -43,6 +46,24 @@
 #define QUICK_SPAN_SIZE   (TEST_BLOCK_SIZE >> 2)
 #define SPARSE_SPAN_SIZE  (TEST_BLOCK_SIZE >> 4)
 
+// MU_CHANGE [BEGIN] - Test memory blocks on all processors.
+//
+// A block is only split across the processors when it has at least this
+// many test locations, and each processor takes its share in this many
+// chunks so that a slow processor does not hold up the others.
+//
+#define PARALLEL_TEST_MIN_LOCATIONS    0x1000
+#define PARALLEL_TEST_CHUNKS_PER_CPU   4
+
+//
+// GenericMemoryTestMonoPattern seen as a repeating 64-bit value, used to fill
+// contiguous ranges with SetMem64().
+//
+#define GENERIC_MONO_PATTERN_QWORD     0xa5a5a5a55a5a5a5aULL
+
+#define PARALLEL_TEST_NO_ERROR         MAX_UINT64
+// MU_CHANGE [END]
+
 //
 // This structure records every nontested memory range parsed through GCD
 // service.
@@ -110,6 +131,15 @@ typedef struct {
   //
   LIST_ENTRY                    NonTestedMemRanList;
 
+  // MU_CHANGE [BEGIN] - Test memory blocks on all processors.
+  //
+  // MP services protocol's pointer and the number of enabled processors,
+  // used to split a block across the processors
+  //
+  EFI_MP_SERVICES_PROTOCOL          *MpServices;
+  UINTN                             EnabledProcessorCount;
+  // MU_CHANGE [END]
+
 } GENERIC_MEMORY_TEST_PRIVATE;
 
 #define GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS(a) \
@@ -120,6 +150,22 @@ typedef struct {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE \
   )
 
+// MU_CHANGE [BEGIN] - Test memory blocks on all processors.
+//
+// Shared state of one block tested by several processors. Each processor
+// takes the next untested chunk until all chunks are taken.
+//
+typedef struct {
+  GENERIC_MEMORY_TEST_PRIVATE       *Private;
+  EFI_PHYSICAL_ADDRESS              Start;
+  UINT64                            Size;
+  UINT64                            ChunkSize;
+  UINT32                            ChunkCount;
+  volatile UINT32                   NextChunk;
+  volatile UINT64                   ErrorAddress;
+} PARALLEL_MEMORY_TEST_CONTEXT;
+// MU_CHANGE [END]
+
 //
 // Function Prototypes
 //
@@ -234,6 +280,44 @@ VerifyMemory (
   IN  UINT64                       Size
   );
 
+// MU_CHANGE [BEGIN] - Test memory blocks on all processors.
+/**
+  Report an uncorrectable memory error found by the memory test.
+
+  @param[in] Address  The start of the test location that miscompared.
+
+  @retval EFI_DEVICE_ERROR      The error was reported.
+  @retval EFI_OUT_OF_RESOURCES  The error data could not be allocated.
+
+**/
+EFI_STATUS
+ReportMemoryError (
+  IN  EFI_PHYSICAL_ADDRESS         Address
+  );
+
+/**
+  Write and verify the memory test pattern in a range of physical memory.
+
+  The range is split across all enabled processors when MP services are
+  available and the range is large enough. Otherwise it is tested on the
+  calling processor with WriteMemory() and VerifyMemory().
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+  @retval EFI_SUCCESS Successful test the range of memory, no errors' location found.
+  @retval Others      The range of memory have errors contained.
+
+**/
+EFI_STATUS
+TestMemoryRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  );
+// MU_CHANGE [END]
+
 /**
   Test a range of the memory directly .
 
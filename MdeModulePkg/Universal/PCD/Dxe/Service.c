@@ -27,6 +27,12 @@ BOOLEAN        mPeiExMapTableEmpty;
 BOOLEAN        mDxeExMapTableEmpty;
 BOOLEAN        mPeiDatabaseEmpty;
 
+//
+// Copies of the ExMapTables sorted by {ExGuidIndex, ExTokenNumber}
+//
+DYNAMICEX_MAPPING  *mPeiSortedExMap;
+DYNAMICEX_MAPPING  *mDxeSortedExMap;
+
 LIST_ENTRY    *mCallbackFnTable;
 EFI_GUID     **TmpTokenSpaceBuffer;
 UINTN          TmpTokenSpaceBufferCount;
@@ -934,6 +940,120 @@ BuildPcdDxeDataBase (
   for (Index = 0; Index + 1 < mPcdTotalTokenCount + 1; Index++) {
     InitializeListHead (&mCallbackFnTable[Index]);
   }
+
+  mPeiSortedExMap = SortExMapTable (
+                      (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->ExMapTableOffset),
+                      mPcdDatabase.PeiDb->ExTokenCount
+                      );
+  mDxeSortedExMap = SortExMapTable (
+                      (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->ExMapTableOffset),
+                      mPcdDatabase.DxeDb->ExTokenCount
+                      );
+}
+
+/**
+  Create a copy of ExMapTable sorted by {ExGuidIndex, ExTokenNumber}, so that
+  GetExPcdTokenNumber() can binary search it.
+
+  @param ExMapTable      The ExMapTable of PEI or DXE PCD database.
+  @param ExTokenCount    The number of entries in ExMapTable.
+
+  @return The sorted copy, or NULL if ExMapTable is empty or the copy can't
+          be allocated.
+
+**/
+DYNAMICEX_MAPPING *
+SortExMapTable (
+  IN CONST DYNAMICEX_MAPPING  *ExMapTable,
+  IN UINTN                    ExTokenCount
+  )
+{
+  DYNAMICEX_MAPPING   *SortedExMap;
+  DYNAMICEX_MAPPING   Entry;
+  UINTN               Index;
+  UINTN               Index2;
+
+  if (ExTokenCount == 0) {
+    return NULL;
+  }
+
+  SortedExMap = AllocateCopyPool (ExTokenCount * sizeof (DYNAMICEX_MAPPING), ExMapTable);
+  if (SortedExMap == NULL) {
+    return NULL;
+  }
+
+  //
+  // Insertion sort, the ExMapTable generated by the build tool is mostly
+  // grouped by token space already.
+  //
+  for (Index = 1; Index < ExTokenCount; Index++) {
+    Entry = SortedExMap[Index];
+    for (Index2 = Index; Index2 > 0; Index2--) {
+      if ((SortedExMap[Index2 - 1].ExGuidIndex < Entry.ExGuidIndex) ||
+          ((SortedExMap[Index2 - 1].ExGuidIndex == Entry.ExGuidIndex) &&
+           (SortedExMap[Index2 - 1].ExTokenNumber <= Entry.ExTokenNumber))) {
+        break;
+      }
+      SortedExMap[Index2] = SortedExMap[Index2 - 1];
+    }
+    SortedExMap[Index2] = Entry;
+  }
+
+  return SortedExMap;
+}
+
+/**
+  Find the entry of {ExGuidIndex, ExTokenNumber} in ExMapTable.
+
+  @param ExMapTable      The ExMapTable, sorted if Sorted is TRUE.
+  @param ExTokenCount    The number of entries in ExMapTable.
+  @param Sorted          Whether ExMapTable is sorted by {ExGuidIndex, ExTokenNumber}.
+  @param ExGuidIndex     Index of the token space guid in the guid table.
+  @param ExTokenNumber   Dynamic-ex PCD token number.
+
+  @return The entry found, or NULL if there is no such entry.
+
+**/
+DYNAMICEX_MAPPING *
+FindExMapEntry (
+  IN DYNAMICEX_MAPPING        *ExMapTable,
+  IN UINTN                    ExTokenCount,
+  IN BOOLEAN                  Sorted,
+  IN UINTN                    ExGuidIndex,
+  IN UINT32                   ExTokenNumber
+  )
+{
+  UINTN               Index;
+  UINTN               Low;
+  UINTN               High;
+
+  if (!Sorted) {
+    for (Index = 0; Index < ExTokenCount; Index++) {
+      if ((ExTokenNumber == ExMapTable[Index].ExTokenNumber) &&
+          (ExGuidIndex == ExMapTable[Index].ExGuidIndex)) {
+        return &ExMapTable[Index];
+      }
+    }
+    return NULL;
+  }
+
+  Low  = 0;
+  High = ExTokenCount;
+  while (Low < High) {
+    Index = Low + (High - Low) / 2;
+    if ((ExMapTable[Index].ExGuidIndex < ExGuidIndex) ||
+        ((ExMapTable[Index].ExGuidIndex == ExGuidIndex) &&
+         (ExMapTable[Index].ExTokenNumber < ExTokenNumber))) {
+      Low = Index + 1;
+    } else if ((ExMapTable[Index].ExGuidIndex == ExGuidIndex) &&
+               (ExMapTable[Index].ExTokenNumber == ExTokenNumber)) {
+      return &ExMapTable[Index];
+    } else {
+      High = Index;
+    }
+  }
+
+  return NULL;
 }
 
 /**
@@ -1566,8 +1686,8 @@ GetExPcdTokenNumber (
   IN UINT32                     ExTokenNumber
   )
 {
-  UINT32              Index;
   DYNAMICEX_MAPPING   *ExMap;
+  DYNAMICEX_MAPPING   *ExMapEntry;
   EFI_GUID            *GuidTable;
   EFI_GUID            *MatchGuid;
   UINTN               MatchGuidIdx;
@@ -1582,11 +1702,15 @@ GetExPcdTokenNumber (
 
       MatchGuidIdx = MatchGuid - GuidTable;
 
-      for (Index = 0; Index < mPcdDatabase.PeiDb->ExTokenCount; Index++) {
-        if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-            (MatchGuidIdx == ExMap[Index].ExGuidIndex)) {
-            return ExMap[Index].TokenNumber;
-        }
+      ExMapEntry = FindExMapEntry (
+                     (mPeiSortedExMap != NULL) ? mPeiSortedExMap : ExMap,
+                     mPcdDatabase.PeiDb->ExTokenCount,
+                     (BOOLEAN) (mPeiSortedExMap != NULL),
+                     MatchGuidIdx,
+                     ExTokenNumber
+                     );
+      if (ExMapEntry != NULL) {
+        return ExMapEntry->TokenNumber;
       }
     }
   }
@@ -1603,11 +1727,15 @@ GetExPcdTokenNumber (
 
   MatchGuidIdx = MatchGuid - GuidTable;
 
-  for (Index = 0; Index < mPcdDatabase.DxeDb->ExTokenCount; Index++) {
-    if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-         (MatchGuidIdx == ExMap[Index].ExGuidIndex)) {
-        return ExMap[Index].TokenNumber;
-    }
+  ExMapEntry = FindExMapEntry (
+                 (mDxeSortedExMap != NULL) ? mDxeSortedExMap : ExMap,
+                 mPcdDatabase.DxeDb->ExTokenCount,
+                 (BOOLEAN) (mDxeSortedExMap != NULL),
+                 MatchGuidIdx,
+                 ExTokenNumber
+                 );
+  if (ExMapEntry != NULL) {
+    return ExMapEntry->TokenNumber;
   }
 
   ASSERT (FALSE);
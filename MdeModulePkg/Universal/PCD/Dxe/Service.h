@@ -1074,6 +1074,23 @@ GetExPcdTokenNumber (
   IN UINT32                     ExTokenNumber
   );
 
+/**
+  Create a copy of ExMapTable sorted by {ExGuidIndex, ExTokenNumber}, so that
+  GetExPcdTokenNumber() can binary search it.
+
+  @param ExMapTable      The ExMapTable of PEI or DXE PCD database.
+  @param ExTokenCount    The number of entries in ExMapTable.
+
+  @return The sorted copy, or NULL if ExMapTable is empty or the copy can't
+          be allocated.
+
+**/
+DYNAMICEX_MAPPING *
+SortExMapTable (
+  IN CONST DYNAMICEX_MAPPING  *ExMapTable,
+  IN UINTN                    ExTokenCount
+  );
+
 /**
   Get next token number in given token space.
 
@@ -240,7 +240,7 @@ GetSmbiosStructureSize (
 
   Determin whether an SmbiosHandle has already in use.
 
-  @param Head        Pointer to the beginning of SMBIOS structure.
+  @param Private     Pointer to the SMBIOS instance.
   @param Handle      A unique handle will be assigned to the SMBIOS record.
 
   @retval TRUE       Smbios handle already in use.
@@ -250,21 +250,34 @@ GetSmbiosStructureSize (
 BOOLEAN
 EFIAPI
 CheckSmbiosHandleExistance (
-  IN  LIST_ENTRY           *Head,
+  IN  SMBIOS_INSTANCE      *Private,
   IN  EFI_SMBIOS_HANDLE    Handle
   )
 {
-  LIST_ENTRY              *Link;
-  SMBIOS_HANDLE_ENTRY     *HandleEntry;
+  return (BOOLEAN) ((Private->AllocatedHandleBitmap[Handle / 8] & (1 << (Handle % 8))) != 0);
+}
 
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    HandleEntry = SMBIOS_HANDLE_ENTRY_FROM_LINK(Link);
-    if (HandleEntry->SmbiosHandle == Handle) {
-      return TRUE;
-    }
-  }
+/**
+
+  Mark an SmbiosHandle as in use or free.
+
+  @param Private     Pointer to the SMBIOS instance.
+  @param Handle      The handle of the SMBIOS record.
+  @param Allocated   TRUE if the handle is in use, FALSE if it is free.
 
-  return FALSE;
+**/
+VOID
+SetSmbiosHandleExistance (
+  IN  SMBIOS_INSTANCE      *Private,
+  IN  EFI_SMBIOS_HANDLE    Handle,
+  IN  BOOLEAN              Allocated
+  )
+{
+  if (Allocated) {
+    Private->AllocatedHandleBitmap[Handle / 8] |= (UINT8) (1 << (Handle % 8));
+  } else {
+    Private->AllocatedHandleBitmap[Handle / 8] &= (UINT8) ~(1 << (Handle % 8));
+  }
 }
 
 /**
@@ -307,7 +320,6 @@ GetAvailableSmbiosHandle (
   IN OUT   EFI_SMBIOS_HANDLE     *Handle
   )
 {
-  LIST_ENTRY              *Head;
   SMBIOS_INSTANCE         *Private;
   EFI_SMBIOS_HANDLE       MaxSmbiosHandle;
   EFI_SMBIOS_HANDLE       AvailableHandle;
@@ -315,9 +327,8 @@ GetAvailableSmbiosHandle (
   GetMaxSmbiosHandle(This, &MaxSmbiosHandle);
 
   Private = SMBIOS_INSTANCE_FROM_THIS (This);
-  Head = &Private->AllocatedHandleListHead;
   for (AvailableHandle = 0; AvailableHandle < MaxSmbiosHandle; AvailableHandle++) {
-    if (!CheckSmbiosHandleExistance(Head, AvailableHandle)) {
+    if (!CheckSmbiosHandleExistance(Private, AvailableHandle)) {
       *Handle = AvailableHandle;
       return EFI_SUCCESS;
     }
@@ -361,7 +372,6 @@ SmbiosAdd (
   UINTN                       StructureSize;
   UINTN                       NumberOfStrings;
   EFI_STATUS                  Status;
-  LIST_ENTRY                  *Head;
   SMBIOS_INSTANCE             *Private;
   EFI_SMBIOS_ENTRY            *SmbiosEntry;
   EFI_SMBIOS_HANDLE           MaxSmbiosHandle;
@@ -378,8 +388,7 @@ SmbiosAdd (
   //
   // Check whether SmbiosHandle is already in use
   //
-  Head = &Private->AllocatedHandleListHead;
-  if (*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED && CheckSmbiosHandleExistance(Head, *SmbiosHandle)) {
+  if (*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED && CheckSmbiosHandleExistance(Private, *SmbiosHandle)) {
     return EFI_ALREADY_STARTED;
   }
 
@@ -482,6 +491,7 @@ SmbiosAdd (
   HandleEntry->Signature     = SMBIOS_HANDLE_ENTRY_SIGNATURE;
   HandleEntry->SmbiosHandle  = *SmbiosHandle;
   InsertTailList(&Private->AllocatedHandleListHead, &HandleEntry->Link);
+  SetSmbiosHandleExistance (Private, *SmbiosHandle, TRUE);
 
   InternalRecord  = (EFI_SMBIOS_RECORD_HEADER *) (SmbiosEntry + 1);
   Raw     = (VOID *) (InternalRecord + 1);
@@ -836,6 +846,7 @@ SmbiosRemove (
         if (HandleEntry->SmbiosHandle == SmbiosHandle) {
           RemoveEntryList(Link);
           FreePool(HandleEntry);
+          SetSmbiosHandleExistance (Private, SmbiosHandle, FALSE);
           break;
         }
       }
@@ -45,6 +45,10 @@ typedef struct {
   // List of allocated SMBIOS handle.
   //
   LIST_ENTRY            AllocatedHandleListHead;
+  //
+  // Bitmap of the handles in AllocatedHandleListHead, one bit per handle.
+  //
+  UINT8                 AllocatedHandleBitmap[0x10000 / 8];
 } SMBIOS_INSTANCE;
 
 #define SMBIOS_INSTANCE_FROM_THIS(this)  CR (this, SMBIOS_INSTANCE, Smbios, SMBIOS_INSTANCE_SIGNATURE)
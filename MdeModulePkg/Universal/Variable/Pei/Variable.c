@@ -25,6 +25,14 @@ EFI_PEI_PPI_DESCRIPTOR     mPpiListVariable = {
   &mVariablePpi
 };
 
+// MU_CHANGE [BEGIN] - Copy the NV variable storage to memory and share it with DXE.
+EFI_PEI_NOTIFY_DESCRIPTOR  mMemoryDiscoveredNotifyList = {
+  (EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST),
+  &gEfiPeiMemoryDiscoveredPpiGuid,
+  MemoryDiscoveredPpiNotifyCallback
+};
+// MU_CHANGE [END]
+
 
 /**
   Provide the functionality of the variable services.
@@ -43,6 +51,15 @@ PeimInitializeVariableServices (
   IN CONST EFI_PEI_SERVICES          **PeiServices
   )
 {
+  // MU_CHANGE [BEGIN] - Copy the NV variable storage to memory and share it with DXE.
+  EFI_STATUS  Status;
+
+  if (FeaturePcdGet (PcdEnableVariablePeiStoreCache) && !PcdGetBool (PcdEmuVariableNvModeEnable)) {
+    Status = PeiServicesNotifyPpi (&mMemoryDiscoveredNotifyList);
+    ASSERT_EFI_ERROR (Status);
+  }
+  // MU_CHANGE [END]
+
   return PeiServicesInstallPpi (&mPpiListVariable);
 }
 
@@ -546,6 +563,104 @@ GetHobVariableStore (
   }
 }
 
+// MU_CHANGE [BEGIN] - Copy the NV variable storage to memory and share it with DXE.
+/**
+  Copy the NV variable storage to permanent memory once it is installed.
+
+  The copy already has the data of the last fault tolerant write merged in,
+  so later PEI reads and the DXE/SMM variable driver can use it instead of
+  reading the storage from flash again. It is published in a
+  gEdkiiVariableStoreCacheHobGuid HOB.
+
+  @param PeiServices       An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation
+  @param NotifyDescriptor  Address of the notification descriptor data structure.
+  @param Ppi               Address of the PPI that was installed.
+
+  @retval EFI_SUCCESS      The copy was published, or the storage is not valid and was left alone.
+  @retval Others           The memory for the copy could not be allocated.
+**/
+EFI_STATUS
+EFIAPI
+MemoryDiscoveredPpiNotifyCallback (
+  IN EFI_PEI_SERVICES           **PeiServices,
+  IN EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyDescriptor,
+  IN VOID                       *Ppi
+  )
+{
+  EFI_STATUS                            Status;
+  EFI_HOB_GUID_TYPE                     *GuidHob;
+  EFI_PHYSICAL_ADDRESS                  NvStorageBase;
+  UINT32                                NvStorageSize;
+  EFI_PHYSICAL_ADDRESS                  CacheBase;
+  UINT8                                 *NvStorageData;
+  FAULT_TOLERANT_WRITE_LAST_WRITE_DATA  *FtwLastWriteData;
+  UINT32                                BackUpOffset;
+  EFI_FIRMWARE_VOLUME_HEADER            *FvHeader;
+  VARIABLE_STORE_HEADER                 *VariableStoreHeader;
+  VARIABLE_INDEX_TABLE                  *IndexTable;
+  EDKII_VARIABLE_STORE_CACHE            StoreCache;
+
+  NvStorageSize = PcdGet32 (PcdFlashNvStorageVariableSize);
+  NvStorageBase = (EFI_PHYSICAL_ADDRESS) (PcdGet64 (PcdFlashNvStorageVariableBase64) != 0 ?
+                                          PcdGet64 (PcdFlashNvStorageVariableBase64) :
+                                          PcdGet32 (PcdFlashNvStorageVariableBase)
+                                         );
+  ASSERT (NvStorageBase != 0);
+
+  Status = PeiServicesAllocatePages (EfiBootServicesData, EFI_SIZE_TO_PAGES (NvStorageSize), &CacheBase);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  NvStorageData = (UINT8 *) (UINTN) CacheBase;
+  CopyMem (NvStorageData, (UINT8 *) (UINTN) NvStorageBase, NvStorageSize);
+
+  //
+  // Merge the part of the storage that is backed up in the spare block, the
+  // same way GetVariableStore () reads it from flash.
+  //
+  GuidHob = GetFirstGuidHob (&gEdkiiFaultTolerantWriteGuid);
+  if (GuidHob != NULL) {
+    FtwLastWriteData = (FAULT_TOLERANT_WRITE_LAST_WRITE_DATA *) GET_GUID_HOB_DATA (GuidHob);
+    if ((FtwLastWriteData->TargetAddress >= NvStorageBase) && (FtwLastWriteData->TargetAddress < (NvStorageBase + NvStorageSize))) {
+      BackUpOffset = (UINT32) (FtwLastWriteData->TargetAddress - NvStorageBase);
+      CopyMem (NvStorageData + BackUpOffset, (UINT8 *) (UINTN) FtwLastWriteData->SpareAddress, NvStorageSize - BackUpOffset);
+    }
+  }
+
+  FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *) NvStorageData;
+  if ((FvHeader->Signature != EFI_FVH_SIGNATURE) ||
+      (!CompareGuid (&gEfiSystemNvDataFvGuid, &FvHeader->FileSystemGuid)) ||
+      (FvHeader->HeaderLength + sizeof (VARIABLE_STORE_HEADER) > NvStorageSize)) {
+    DEBUG ((DEBUG_ERROR, "PeiVariable: NV storage is corrupted, not caching it\n"));
+    PeiServicesFreePages (CacheBase, EFI_SIZE_TO_PAGES (NvStorageSize));
+    return EFI_SUCCESS;
+  }
+
+  StoreCache.NvStorageBase = NvStorageBase;
+  StoreCache.NvStorageSize = NvStorageSize;
+  StoreCache.CacheBase     = CacheBase;
+  BuildGuidDataHob (&gEdkiiVariableStoreCacheHobGuid, &StoreCache, sizeof (StoreCache));
+
+  //
+  // The index table built by earlier reads points into flash, restart it on
+  // the copy.
+  //
+  GuidHob = GetFirstGuidHob (&gEfiVariableIndexTableGuid);
+  if (GuidHob != NULL) {
+    VariableStoreHeader     = (VARIABLE_STORE_HEADER *) (NvStorageData + FvHeader->HeaderLength);
+    IndexTable              = GET_GUID_HOB_DATA (GuidHob);
+    IndexTable->Length      = 0;
+    IndexTable->GoneThrough = 0;
+    IndexTable->StartPtr    = GetStartPointer (VariableStoreHeader);
+    IndexTable->EndPtr      = GetEndPointer   (VariableStoreHeader);
+  }
+
+  DEBUG ((DEBUG_INFO, "PeiVariable: NV storage cached at 0x%lx\n", CacheBase));
+  return EFI_SUCCESS;
+}
+// MU_CHANGE [END]
+
 /**
   Return the variable store header and the store info based on the Index.
 
@@ -596,11 +711,26 @@ GetVariableStore (
         //
         FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *) (UINTN) NvStorageBase;
 
+        // MU_CHANGE [BEGIN] - Read from the memory copy of the NV storage once it exists.
+        //
+        // The copy already has the FTW last write data merged in.
+        //
+        GuidHob = NULL;
+        if (FeaturePcdGet (PcdEnableVariablePeiStoreCache)) {
+          GuidHob = GetFirstGuidHob (&gEdkiiVariableStoreCacheHobGuid);
+        }
+        if (GuidHob != NULL) {
+          FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *) (UINTN) ((EDKII_VARIABLE_STORE_CACHE *) GET_GUID_HOB_DATA (GuidHob))->CacheBase;
+          GuidHob  = NULL;
+        } else {
+          GuidHob = GetFirstGuidHob (&gEdkiiFaultTolerantWriteGuid);
+        }
+        // MU_CHANGE [END]
+
         //
         // Check the FTW last write data hob.
         //
         BackUpOffset = 0;
-        GuidHob = GetFirstGuidHob (&gEdkiiFaultTolerantWriteGuid);
         if (GuidHob != NULL) {
           FtwLastWriteData = (FAULT_TOLERANT_WRITE_LAST_WRITE_DATA *) GET_GUID_HOB_DATA (GuidHob);
           if (FtwLastWriteData->TargetAddress == NvStorageBase) {
@@ -25,6 +25,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/VariableIndexTable.h>
 #include <Guid/SystemNvDataGuid.h>
 #include <Guid/FaultTolerantWrite.h>
+#include <Guid/VariableStoreCacheHob.h>         // MU_CHANGE
+#include <Ppi/MemoryDiscovered.h>               // MU_CHANGE
 
 typedef enum {
   VariableStoreTypeHob,
@@ -65,6 +67,26 @@ PeimInitializeVariableServices (
   IN CONST EFI_PEI_SERVICES          **PeiServices
   );
 
+// MU_CHANGE [BEGIN] - Copy the NV variable storage to memory and share it with DXE.
+/**
+  Copy the NV variable storage to permanent memory once it is installed.
+
+  @param PeiServices       An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation
+  @param NotifyDescriptor  Address of the notification descriptor data structure.
+  @param Ppi               Address of the PPI that was installed.
+
+  @retval EFI_SUCCESS      The copy was published, or the storage is not valid and was left alone.
+  @retval Others           The memory for the copy could not be allocated.
+**/
+EFI_STATUS
+EFIAPI
+MemoryDiscoveredPpiNotifyCallback (
+  IN EFI_PEI_SERVICES           **PeiServices,
+  IN EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyDescriptor,
+  IN VOID                       *Ppi
+  );
+// MU_CHANGE [END]
+
 /**
   This service retrieves a variable's value using its name and GUID.
 
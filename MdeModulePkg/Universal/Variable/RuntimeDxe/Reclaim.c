@@ -92,6 +92,11 @@ GetLbaAndOffsetByAddress (
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
+  Only the range from the first to the last byte that differs from the
+  current content of the variable storage space is written, so the blocks
+  outside that range (typically the unchanged variables at the start of
+  the store and the erased space at its end) are not erased again.
+
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
 
@@ -112,6 +117,9 @@ FtwVariableSpace (
   UINTN                              VarOffset;
   UINTN                              FtwBufferSize;
   EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
+  UINT8                              *CurrentBuffer;   // MU_CHANGE
+  UINTN                              WriteStart;       // MU_CHANGE
+  UINTN                              WriteEnd;         // MU_CHANGE
 
   //
   // Locate fault tolerant write protocol.
@@ -127,29 +135,50 @@ FtwVariableSpace (
   if (EFI_ERROR (Status)) {
     return Status;
   }
+  FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
+  ASSERT (FtwBufferSize == VariableBuffer->Size);
+
+  // MU_CHANGE [BEGIN] - Only rewrite the part of the store that changed.
+  //
+  // Find the range that differs from the current variable storage space.
+  //
+  CurrentBuffer = (UINT8 *) (UINTN) VariableBase;
+  WriteStart    = 0;
+  while ((WriteStart < FtwBufferSize) && (CurrentBuffer[WriteStart] == ((UINT8 *) VariableBuffer)[WriteStart])) {
+    WriteStart++;
+  }
+  if (WriteStart == FtwBufferSize) {
+    //
+    // Nothing to write.
+    //
+    return EFI_SUCCESS;
+  }
+  WriteEnd = FtwBufferSize;
+  while (CurrentBuffer[WriteEnd - 1] == ((UINT8 *) VariableBuffer)[WriteEnd - 1]) {
+    WriteEnd--;
+  }
+
   //
   // Get LBA and Offset by address.
   //
-  Status = GetLbaAndOffsetByAddress (VariableBase, &VarLba, &VarOffset);
+  Status = GetLbaAndOffsetByAddress (VariableBase + WriteStart, &VarLba, &VarOffset);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
 
-  FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
-  ASSERT (FtwBufferSize == VariableBuffer->Size);
-
   //
   // FTW write record.
   //
   Status = FtwProtocol->Write (
                           FtwProtocol,
-                          VarLba,         // LBA
-                          VarOffset,      // Offset
-                          FtwBufferSize,  // NumBytes
-                          NULL,           // PrivateData NULL
-                          FvbHandle,      // Fvb Handle
-                          (VOID *) VariableBuffer // write buffer
+                          VarLba,                   // LBA
+                          VarOffset,                // Offset
+                          WriteEnd - WriteStart,    // NumBytes
+                          NULL,                     // PrivateData NULL
+                          FvbHandle,                // Fvb Handle
+                          (UINT8 *) VariableBuffer + WriteStart  // write buffer
                           );
+  // MU_CHANGE [END]
 
   return Status;
 }
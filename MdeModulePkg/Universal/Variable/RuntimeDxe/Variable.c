@@ -37,6 +37,12 @@ VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
 ///
 VARIABLE_STORE_HEADER  *mNvVariableCache      = NULL;
 
+///
+/// Hash indexes over the volatile store and mNvVariableCache used by FindVariable().
+///
+VARIABLE_STORE_INDEX   mVolatileVariableIndex;
+VARIABLE_STORE_INDEX   mNvVariableIndex;
+
 ///
 /// Memory cache of Fv Header.
 ///
@@ -605,6 +611,8 @@ Reclaim (
   // MS_CHANGE_? - This may be specific to the MS implementation.
   DEBUG((DEBUG_INFO, "%a Reclaim variables started.\n", __FUNCTION__));
 
+  InvalidateVariableStoreIndex ();
+
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     //
     // Start Pointers for the variable.
@@ -827,6 +835,11 @@ Reclaim (
   }
 
 Done:
+  //
+  // The variables have moved, so any offsets already in the indexes are stale.
+  //
+  InvalidateVariableStoreIndex ();
+
   DoneStatus = EFI_SUCCESS;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     DoneStatus = SynchronizeRuntimeVariableCache (
@@ -856,6 +869,189 @@ Done:
   return Status;
 }
 
+/**
+  Drop the volatile and non-volatile variable indexes. They are rebuilt by
+  the next FindVariable() call.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  VOID
+  )
+{
+  mVolatileVariableIndex.Store = NULL;
+  mNvVariableIndex.Store       = NULL;
+}
+
+/**
+  Compute the variable index bucket for a variable name and vendor GUID.
+
+  @param[in]  VariableName      Name of the variable.
+  @param[in]  MaxNameSize       Maximum size in bytes of VariableName to hash.
+  @param[in]  VendorGuid        Vendor GUID of the variable.
+
+  @return The bucket number.
+
+**/
+UINT32
+GetVariableIndexBucket (
+  IN CONST CHAR16     *VariableName,
+  IN UINTN            MaxNameSize,
+  IN CONST EFI_GUID   *VendorGuid
+  )
+{
+  UINT32    Hash;
+  UINTN     Index;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *) VendorGuid);
+  for (Index = 0; Index < MaxNameSize / sizeof (CHAR16) && VariableName[Index] != 0; Index++) {
+    Hash = Hash * 31 + VariableName[Index];
+  }
+  Hash ^= Hash >> 16;
+
+  return Hash & (VARIABLE_INDEX_BUCKETS - 1);
+}
+
+/**
+  Find the variable in the specified variable store through its hash index.
+
+  The result is the same as FindVariableEx() walking the whole store: the
+  index only narrows the walk down to the headers whose name and GUID hash to
+  the same bucket, and each of them is still checked by FindVariableEx().
+
+  @param[in]       VariableName        Name of the variable to be found
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       VariableStoreHeader The variable store that PtrTrack covers.
+  @param[in]       LastVariableOffset  Offset of the end of the last variable
+                                       completely written to the store.
+  @param[in, out]  StoreIndex          The index of VariableStoreHeader.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+EFI_STATUS
+FindVariableInIndex (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     VARIABLE_STORE_HEADER   *VariableStoreHeader,
+  IN     UINTN                   LastVariableOffset,
+  IN OUT VARIABLE_STORE_INDEX    *StoreIndex
+  )
+{
+  EFI_STATUS              Status;
+  BOOLEAN                 AuthFormat;
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_HEADER         *StartPtr;
+  VARIABLE_HEADER         *EndPtr;
+  VARIABLE_HEADER         *InDeletedVariable;
+  VARIABLE_INDEX_ENTRY    *Entry;
+  UINT32                  Bucket;
+  UINT32                  Next;
+
+  AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
+
+  //
+  // The first-variable lookup does not use a name, and a reentrant call
+  // (MCA/INIT/NMI) must not see an index that is half way through an update.
+  //
+  if (VariableName[0] == 0 || StoreIndex->Busy) {
+    return FindVariableEx (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+  }
+  StoreIndex->Busy = TRUE;
+
+  StartPtr = PtrTrack->StartPtr;
+  EndPtr   = PtrTrack->EndPtr;
+
+  //
+  // Rebuild the index from scratch after a reclaim or when the store moved,
+  // for example after SetVirtualAddressMap().
+  //
+  if (StoreIndex->Store != VariableStoreHeader) {
+    ZeroMem (StoreIndex->Head, sizeof (StoreIndex->Head));
+    StoreIndex->Store      = VariableStoreHeader;
+    StoreIndex->Count      = 0;
+    StoreIndex->IndexedEnd = (UINTN) StartPtr - (UINTN) VariableStoreHeader;
+  }
+
+  //
+  // Add the variables appended to the store since the last lookup. Stop at
+  // LastVariableOffset so a variable still being written is never indexed.
+  //
+  Variable = (VARIABLE_HEADER *) ((UINTN) VariableStoreHeader + StoreIndex->IndexedEnd);
+  while (StoreIndex->Count < VARIABLE_INDEX_MAX_ENTRIES && IsValidVariableHeader (Variable, EndPtr)) {
+    if ((UINTN) GetNextVariablePtr (Variable, AuthFormat) - (UINTN) VariableStoreHeader > LastVariableOffset) {
+      break;
+    }
+    Bucket = GetVariableIndexBucket (
+               GetVariableNamePtr (Variable, AuthFormat),
+               NameSizeOfVariable (Variable, AuthFormat),
+               GetVendorGuidPtr (Variable, AuthFormat)
+               );
+    Entry         = &StoreIndex->Entries[StoreIndex->Count];
+    Entry->Offset = (UINT32) StoreIndex->IndexedEnd;
+    Entry->Next   = 0;
+    StoreIndex->Count++;
+    if (StoreIndex->Head[Bucket] == 0) {
+      StoreIndex->Head[Bucket] = StoreIndex->Count;
+    } else {
+      StoreIndex->Entries[StoreIndex->Tail[Bucket] - 1].Next = StoreIndex->Count;
+    }
+    StoreIndex->Tail[Bucket] = StoreIndex->Count;
+
+    Variable = GetNextVariablePtr (Variable, AuthFormat);
+    StoreIndex->IndexedEnd = (UINTN) Variable - (UINTN) VariableStoreHeader;
+  }
+
+  //
+  // Check each indexed header in the bucket in store order.
+  //
+  InDeletedVariable = NULL;
+  Status            = EFI_NOT_FOUND;
+  Bucket            = GetVariableIndexBucket (VariableName, MAX_UINTN, VendorGuid);
+  for (Next = StoreIndex->Head[Bucket]; Next != 0; Next = Entry->Next) {
+    Entry    = &StoreIndex->Entries[Next - 1];
+    Variable = (VARIABLE_HEADER *) ((UINTN) VariableStoreHeader + Entry->Offset);
+
+    PtrTrack->StartPtr = Variable;
+    PtrTrack->EndPtr   = GetNextVariablePtr (Variable, AuthFormat);
+    Status = FindVariableEx (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    if (!EFI_ERROR (Status)) {
+      if (PtrTrack->CurrPtr->State == VAR_ADDED) {
+        PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+        break;
+      }
+      InDeletedVariable = PtrTrack->CurrPtr;
+      Status = EFI_NOT_FOUND;
+    }
+  }
+
+  //
+  // Walk the part of the store that did not fit in the index.
+  //
+  if (EFI_ERROR (Status)) {
+    PtrTrack->StartPtr = (VARIABLE_HEADER *) ((UINTN) VariableStoreHeader + StoreIndex->IndexedEnd);
+    PtrTrack->EndPtr   = EndPtr;
+    Status = FindVariableEx (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    if (EFI_ERROR (Status)) {
+      PtrTrack->CurrPtr = InDeletedVariable;
+      Status = (InDeletedVariable == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+    } else if (PtrTrack->InDeletedTransitionPtr == NULL && PtrTrack->CurrPtr->State == VAR_ADDED) {
+      PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+    }
+  }
+
+  PtrTrack->StartPtr = StartPtr;
+  PtrTrack->EndPtr   = EndPtr;
+  StoreIndex->Busy   = FALSE;
+
+  return Status;
+}
+
 /**
   Finds variable in storage blocks of volatile and non-volatile storage areas.
 
@@ -920,13 +1116,35 @@ FindVariable (
     PtrTrack->EndPtr   = GetEndPointer   (VariableStoreHeader[Type]);
     PtrTrack->Volatile = (BOOLEAN) (Type == VariableStoreTypeVolatile);
 
-    Status =  FindVariableEx (
-                VariableName,
-                VendorGuid,
-                IgnoreRtCheck,
-                PtrTrack,
-                mVariableModuleGlobal->VariableGlobal.AuthFormat
-                );
+    if (Type == VariableStoreTypeVolatile) {
+      Status = FindVariableInIndex (
+                 VariableName,
+                 VendorGuid,
+                 IgnoreRtCheck,
+                 PtrTrack,
+                 VariableStoreHeader[Type],
+                 mVariableModuleGlobal->VolatileLastVariableOffset,
+                 &mVolatileVariableIndex
+                 );
+    } else if (Type == VariableStoreTypeNv) {
+      Status = FindVariableInIndex (
+                 VariableName,
+                 VendorGuid,
+                 IgnoreRtCheck,
+                 PtrTrack,
+                 VariableStoreHeader[Type],
+                 mVariableModuleGlobal->NonVolatileLastVariableOffset,
+                 &mNvVariableIndex
+                 );
+    } else {
+      Status =  FindVariableEx (
+                  VariableName,
+                  VendorGuid,
+                  IgnoreRtCheck,
+                  PtrTrack,
+                  mVariableModuleGlobal->VariableGlobal.AuthFormat
+                  );
+    }
     if (!EFI_ERROR (Status)) {
       return Status;
     }
@@ -3213,10 +3431,13 @@ ReclaimForOS(
   if (((RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxVariableSize) ||
         // MS_CHANGE Starts: HwError record quata state should not trigger variable store reclaim
       // (RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxAuthVariableSize)) ||
-       (RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxAuthVariableSize))){
+       (RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxAuthVariableSize)) ||
       //((PcdGet32 (PcdHwErrStorageSize) != 0) &&
       // (RemainingHwErrVariableSpace < PcdGet32 (PcdMaxHardwareErrorVariableSize)))){
       // MS_CHANGE Ends
+      // MU_CHANGE - Also reclaim while still at boot time if the OS would start with less free
+      //             space than the platform wants in reserve for runtime writes.
+      (RemainingCommonRuntimeVariableSpace < PcdGet32 (PcdVariableReclaimHeadroom))) {
     Status = Reclaim (
             mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase,
             &mVariableModuleGlobal->NonVolatileLastVariableOffset,
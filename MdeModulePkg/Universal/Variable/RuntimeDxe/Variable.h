@@ -36,6 +36,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/VariableFormat.h>
 #include <Guid/SystemNvDataGuid.h>
 #include <Guid/FaultTolerantWrite.h>
+#include <Guid/VariableStoreCacheHob.h>           // MU_CHANGE
 #include <Guid/VarErrorFlag.h>
 
 #include "PrivilegePolymorphic.h"
@@ -93,6 +94,40 @@ typedef struct {
   BOOLEAN         Volatile;
 } VARIABLE_POINTER_TRACK;
 
+///
+/// Number of buckets and entries in the per-store variable index used by
+/// FindVariable(). Buckets must be a power of 2. Variables beyond the entry
+/// limit are still found by walking the rest of the store.
+///
+#define VARIABLE_INDEX_BUCKETS       128
+#define VARIABLE_INDEX_MAX_ENTRIES   1024
+
+typedef struct {
+  ///
+  /// Offset of the variable header from the start of the variable store.
+  ///
+  UINT32                  Offset;
+  ///
+  /// One-based number of the next entry in the same bucket, 0 ends the chain.
+  ///
+  UINT32                  Next;
+} VARIABLE_INDEX_ENTRY;
+
+///
+/// Hash index from (VariableName, VendorGuid) to the variable headers in one
+/// variable store. Every header in the store before IndexedEnd is in the index
+/// in store order. The index is dropped when the store is reclaimed.
+///
+typedef struct {
+  VARIABLE_STORE_HEADER   *Store;
+  UINTN                   IndexedEnd;
+  UINT32                  Count;
+  BOOLEAN                 Busy;
+  UINT32                  Head[VARIABLE_INDEX_BUCKETS];
+  UINT32                  Tail[VARIABLE_INDEX_BUCKETS];
+  VARIABLE_INDEX_ENTRY    Entries[VARIABLE_INDEX_MAX_ENTRIES];
+} VARIABLE_STORE_INDEX;
+
 typedef struct {
   EFI_PHYSICAL_ADDRESS            HobVariableBase;
   EFI_PHYSICAL_ADDRESS            VolatileVariableBase;
@@ -195,6 +230,16 @@ FindVariable (
   IN  BOOLEAN                 IgnoreRtCheck
   );
 
+/**
+  Drop the volatile and non-volatile variable indexes. They are rebuilt by
+  the next FindVariable() call.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  VOID
+  );
+
 /**
   This function is to check if the remaining variable space is enough to set
   all Variables from argument list successfully. The purpose of the check
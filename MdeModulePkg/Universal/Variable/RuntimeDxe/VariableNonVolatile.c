@@ -147,6 +147,7 @@ InitRealNonVolatileVariableStore (
   UINT32                                BoottimeReservedNvVariableSpaceSize;
   EFI_STATUS                            Status;
   VOID                                  *FtwProtocol;
+  EDKII_VARIABLE_STORE_CACHE            *StoreCache;      // MU_CHANGE
 
   mVariableModuleGlobal->FvbInstance = NULL;
 
@@ -163,16 +164,37 @@ InitRealNonVolatileVariableStore (
   NvStorageBase = NV_STORAGE_VARIABLE_BASE;
   ASSERT (NvStorageBase != 0);
 
+  // MU_CHANGE [BEGIN] - Reuse the memory copy of the NV storage made by the variable PEIM.
+  //
+  // The PEI copy already has the FTW last write data merged in.
+  //
+  StoreCache = NULL;
+  if (FeaturePcdGet (PcdEnableVariablePeiStoreCache)) {
+    GuidHob = GetFirstGuidHob (&gEdkiiVariableStoreCacheHobGuid);
+    if (GuidHob != NULL) {
+      StoreCache = (EDKII_VARIABLE_STORE_CACHE *) GET_GUID_HOB_DATA (GuidHob);
+      if ((StoreCache->NvStorageBase != NvStorageBase) || (StoreCache->NvStorageSize != NvStorageSize)) {
+        DEBUG ((DEBUG_WARN, "Variable: PEI copy of NV storage does not match the NV storage, ignoring it\n"));
+        StoreCache = NULL;
+      }
+    }
+  }
+
   //
   // Copy NV storage data to the memory buffer.
   //
-  CopyMem (NvStorageData, (UINT8 *) (UINTN) NvStorageBase, NvStorageSize);
+  if (StoreCache != NULL) {
+    CopyMem (NvStorageData, (UINT8 *) (UINTN) StoreCache->CacheBase, NvStorageSize);
+  } else {
+    CopyMem (NvStorageData, (UINT8 *) (UINTN) NvStorageBase, NvStorageSize);
+  }
+  // MU_CHANGE [END]
 
   Status = GetFtwProtocol ((VOID **)&FtwProtocol);
   //
   // If FTW protocol has been installed, no need to check FTW last write data hob.
   //
-  if (EFI_ERROR (Status)) {
+  if (EFI_ERROR (Status) && (StoreCache == NULL)) {   // MU_CHANGE
     //
     // Check the FTW last write data hob.
     //
@@ -9,6 +9,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "VariableParsing.h"
 
+VARIABLE_NEXT_CURSOR  mNextVariableCursor;     // MU_CHANGE
+
 /**
 
   This code checks if variable header is valid or not.
@@ -553,6 +555,32 @@ VariableServiceGetNextVariableInternal (
 
   ZeroMem (&Variable, sizeof (Variable));
 
+  // MU_CHANGE [BEGIN] - Continue GetNextVariableName from the last result.
+  //
+  // A full enumeration passes back the variable returned by the previous call.
+  // If it is still the valid instance of that variable in the same stores,
+  // continue from there instead of searching all the stores for it again.
+  //
+  if ((VariableName[0] != 0) && (VendorGuid != NULL) &&
+      (mNextVariableCursor.Variable != NULL) &&
+      (CompareMem (mNextVariableCursor.StoreList, VariableStoreList, sizeof (mNextVariableCursor.StoreList)) == 0)) {
+    Variable.StartPtr = GetStartPointer (VariableStoreList[mNextVariableCursor.StoreType]);
+    Variable.EndPtr   = GetEndPointer   (VariableStoreList[mNextVariableCursor.StoreType]);
+    Variable.Volatile = (BOOLEAN) (mNextVariableCursor.StoreType == VariableStoreTypeVolatile);
+    Variable.CurrPtr  = mNextVariableCursor.Variable;
+    if ((Variable.CurrPtr >= Variable.StartPtr) &&
+        IsValidVariableHeader (Variable.CurrPtr, Variable.EndPtr) &&
+        (Variable.CurrPtr->State == VAR_ADDED) &&
+        (!AtRuntime () || ((Variable.CurrPtr->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) != 0)) &&
+        CompareGuid (VendorGuid, GetVendorGuidPtr (Variable.CurrPtr, AuthFormat)) &&
+        (CompareMem (VariableName, GetVariableNamePtr (Variable.CurrPtr, AuthFormat), NameSizeOfVariable (Variable.CurrPtr, AuthFormat)) == 0)) {
+      Variable.CurrPtr = GetNextVariablePtr (Variable.CurrPtr, AuthFormat);
+      goto FindNext;
+    }
+    ZeroMem (&Variable, sizeof (Variable));
+  }
+  // MU_CHANGE [END]
+
   // Check if the variable exists in the given variable store list
   for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
     if (VariableStoreList[StoreType] == NULL) {
@@ -593,6 +621,7 @@ VariableServiceGetNextVariableInternal (
     Variable.CurrPtr = GetNextVariablePtr (Variable.CurrPtr, AuthFormat);
   }
 
+FindNext:     // MU_CHANGE
   while (TRUE) {
     //
     // Switch to the next variable store if needed
@@ -686,6 +715,19 @@ VariableServiceGetNextVariableInternal (
   }
 
 Done:
+  // MU_CHANGE [BEGIN] - Continue GetNextVariableName from the last result.
+  mNextVariableCursor.Variable = NULL;
+  if (Status == EFI_SUCCESS) {
+    for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+      if ((VariableStoreList[StoreType] != NULL) && (Variable.StartPtr == GetStartPointer (VariableStoreList[StoreType]))) {
+        CopyMem (mNextVariableCursor.StoreList, VariableStoreList, sizeof (mNextVariableCursor.StoreList));
+        mNextVariableCursor.StoreType = StoreType;
+        mNextVariableCursor.Variable  = *VariablePtr;
+        break;
+      }
+    }
+  }
+  // MU_CHANGE [END]
   return Status;
 }
 
@@ -13,6 +13,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/ImageAuthentication.h>
 #include "Variable.h"
 
+// MU_CHANGE [BEGIN] - Continue GetNextVariableName from the last result.
+///
+/// The variable returned by the last VariableServiceGetNextVariableInternal () call,
+/// so a following call for that variable can continue from it instead of searching
+/// all the variable stores for it again.
+///
+typedef struct {
+  VARIABLE_STORE_HEADER   *StoreList[VariableStoreTypeMax];
+  VARIABLE_STORE_TYPE     StoreType;
+  VARIABLE_HEADER         *Variable;
+} VARIABLE_NEXT_CURSOR;
+// MU_CHANGE [END]
+
 /**
 
   This code checks if variable header is valid or not.
@@ -471,6 +471,11 @@ SmmVariableHandler (
   SMM_VARIABLE_COMMUNICATE_GET_PAYLOAD_SIZE               *GetPayloadSize;
   SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT *RuntimeVariableCacheContext;
   SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO         *GetRuntimeCacheInfo;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH             *SetVariableBatch;    // MU_CHANGE
+  SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS *QueryInfoLimits;     // MU_CHANGE
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY       *BatchEntry;          // MU_CHANGE
+  UINTN                                                   BatchIndex;           // MU_CHANGE
+  UINTN                                                   BatchOffset;          // MU_CHANGE
   // MU_CHANGE - Remove VariableLockRequestToLock() in lieu of VariablePolicy.
   // SMM_VARIABLE_COMMUNICATE_LOCK_VARIABLE                  *VariableToLock;
   SMM_VARIABLE_COMMUNICATE_VAR_CHECK_VARIABLE_PROPERTY    *CommVariableProperty;
@@ -986,6 +991,112 @@ SmmVariableHandler (
       Status = EFI_SUCCESS;
       break;
 
+    // MU_CHANGE [BEGIN] - Apply several SetVariable() requests from one SMI.
+    case SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH:
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH)) {
+        DEBUG ((DEBUG_ERROR, "SetVariableBatch: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+      //
+      // Copy the input communicate buffer payload to pre-allocated SMM variable buffer payload.
+      //
+      CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
+      SetVariableBatch = (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH *) mVariableBufferPayload;
+
+      Status      = EFI_SUCCESS;
+      BatchOffset = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+      for (BatchIndex = 0; BatchIndex < SetVariableBatch->EntryCount; BatchIndex++) {
+        if (CommBufferPayloadSize - BatchOffset < SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE) {
+          DEBUG ((DEBUG_ERROR, "SetVariableBatch: Entry exceeds communication buffer size limit!\n"));
+          Status = EFI_ACCESS_DENIED;
+          break;
+        }
+        BatchEntry        = (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY *) (mVariableBufferPayload + BatchOffset);
+        SmmVariableHeader = &BatchEntry->Variable;
+        if (((UINTN)(~0) - SmmVariableHeader->DataSize < SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE) ||
+           ((UINTN)(~0) - SmmVariableHeader->NameSize < SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE + SmmVariableHeader->DataSize)) {
+          //
+          // Prevent InfoSize overflow happen
+          //
+          Status = EFI_ACCESS_DENIED;
+          break;
+        }
+        InfoSize = SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE + SmmVariableHeader->DataSize + SmmVariableHeader->NameSize;
+
+        //
+        // SMRAM range check already covered before
+        // Data buffer should not contain SMM range
+        //
+        if (InfoSize > CommBufferPayloadSize - BatchOffset) {
+          DEBUG ((DEBUG_ERROR, "SetVariableBatch: Data size exceed communication buffer size limit!\n"));
+          Status = EFI_ACCESS_DENIED;
+          break;
+        }
+
+        //
+        // The VariableSpeculationBarrier() call here is to ensure the previous
+        // range/content checks for the CommBuffer have been completed before the
+        // subsequent consumption of the CommBuffer content.
+        //
+        VariableSpeculationBarrier ();
+        if (SmmVariableHeader->NameSize < sizeof (CHAR16) || SmmVariableHeader->Name[SmmVariableHeader->NameSize/sizeof (CHAR16) - 1] != L'\0') {
+          //
+          // Make sure VariableName is A Null-terminated string.
+          //
+          BatchEntry->Status = EFI_ACCESS_DENIED;
+        } else if (CompareGuid (&SmmVariableHeader->Guid, &gAdvLoggerAccessGuid)) {
+          BatchEntry->Status = EFI_ACCESS_DENIED;
+        } else {
+          BatchEntry->Status = VariableServiceSetVariable (
+                                 SmmVariableHeader->Name,
+                                 &SmmVariableHeader->Guid,
+                                 SmmVariableHeader->Attributes,
+                                 SmmVariableHeader->DataSize,
+                                 (UINT8 *)SmmVariableHeader->Name + SmmVariableHeader->NameSize
+                                 );
+        }
+
+        BatchOffset += ALIGN_VALUE (InfoSize, sizeof (UINTN));
+        if (BatchOffset > CommBufferPayloadSize) {
+          BatchOffset = CommBufferPayloadSize;
+        }
+      }
+
+      //
+      // Return the per entry status even if a malformed entry stopped the batch,
+      // so the caller knows which of the earlier entries were applied.
+      //
+      CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
+      break;
+
+    case SMM_VARIABLE_FUNCTION_GET_QUERY_VARIABLE_INFO_LIMITS:
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS)) {
+        DEBUG ((DEBUG_ERROR, "GetQueryVariableInfoLimits: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+      if (!mEndOfDxe) {
+        //
+        // The variable quota is not initialized until end of DXE.
+        //
+        Status = EFI_NOT_READY;
+        break;
+      }
+      QueryInfoLimits = (SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS *) SmmVariableFunctionHeader->Data;
+
+      VariableCache = (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
+      QueryInfoLimits->CommonRuntimeVariableSpace   = mVariableModuleGlobal->CommonRuntimeVariableSpace;
+      QueryInfoLimits->HwErrStorageSize             = PcdGet32 (PcdHwErrStorageSize);
+      QueryInfoLimits->VolatileStorageSize          = VariableCache->Size - sizeof (VARIABLE_STORE_HEADER);
+      QueryInfoLimits->MaxVariableSize              = mVariableModuleGlobal->MaxVariableSize;
+      QueryInfoLimits->MaxAuthVariableSize          = mVariableModuleGlobal->MaxAuthVariableSize;
+      QueryInfoLimits->MaxVolatileVariableSize      = mVariableModuleGlobal->MaxVolatileVariableSize;
+      QueryInfoLimits->MaxHardwareErrorVariableSize = PcdGet32 (PcdMaxHardwareErrorVariableSize);
+      QueryInfoLimits->AuthSupport                  = mVariableModuleGlobal->VariableGlobal.AuthSupport;
+
+      Status = EFI_SUCCESS;
+      break;
+    // MU_CHANGE [END]
+
     default:
       Status = EFI_UNSUPPORTED;
   }
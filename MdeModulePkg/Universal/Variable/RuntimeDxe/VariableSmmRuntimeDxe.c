@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SmmVariable.h>
 #include <Protocol/VariableLock.h>
 #include <Protocol/VarCheck.h>
+#include <Protocol/VariableWriteBatch.h>      // MU_CHANGE
 
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -64,6 +65,13 @@ BOOLEAN                          mHobFlushComplete;
 EFI_LOCK                         mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL     mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL         mVarCheck;
+EDKII_VARIABLE_WRITE_BATCH_PROTOCOL  mVariableWriteBatch;   // MU_CHANGE
+// MU_CHANGE [BEGIN] - Serve QueryVariableInfo from the runtime cache.
+SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS  mQueryVariableInfoLimits;
+BOOLEAN                          mQueryVariableInfoLimitsValid = FALSE;
+UINTN                            mQueryVariableInfoCacheHits   = 0;
+UINTN                            mQueryVariableInfoSmmCalls    = 0;
+// MU_CHANGE [END]
 
 /**
   Some Secure Boot Policy Variable may update following other variable changes(SecureBoot follows PK change, etc).
@@ -1152,6 +1160,311 @@ Done:
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Set several variables with one SMM communicate call.
+/**
+  Set a list of variables.
+
+  The entries are packed into the communicate buffer in order, and each
+  buffer full is sent to SMM with one call. Each entry behaves like a separate
+  call to RuntimeServiceSetVariable() with the same parameters.
+
+  @param[in]      This          The EDKII_VARIABLE_WRITE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    Number of entries in Entries.
+  @param[in, out] Entries       The requests. On return, the Status field of
+                                each entry holds its SetVariable() result.
+
+  @retval EFI_SUCCESS           Every entry was set successfully.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+  @retval Others                The Status of the first entry that failed.
+**/
+EFI_STATUS
+EFIAPI
+VariableWriteBatchSetVariables (
+  IN CONST EDKII_VARIABLE_WRITE_BATCH_PROTOCOL  *This,
+  IN       UINTN                                EntryCount,
+  IN OUT   EDKII_VARIABLE_WRITE_BATCH_ENTRY     *Entries
+  )
+{
+  EFI_STATUS                                          Status;
+  EFI_STATUS                                          ReturnStatus;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH         *SetVariableBatch;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY   *BatchEntry;
+  UINTN                                               PayloadSize;
+  UINTN                                               EntrySize;
+  UINTN                                               VariableNameSize;
+  UINTN                                               First;
+  UINTN                                               Index;
+  UINTN                                               Packed;
+  BOOLEAN                                             SendAlone;
+
+  if (Entries == NULL && EntryCount != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ReturnStatus = EFI_SUCCESS;
+  Index        = 0;
+  while (Index < EntryCount) {
+    AcquireLockOnlyAtBootTime (&mVariableServicesLock);
+
+    SetVariableBatch = NULL;
+    Status = InitCommunicateBuffer ((VOID **)&SetVariableBatch, 0, SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH);
+    ASSERT_EFI_ERROR (Status);
+    ASSERT (SetVariableBatch != NULL);
+
+    //
+    // Pack as many of the remaining entries as fit in one communicate buffer.
+    //
+    SetVariableBatch->EntryCount = 0;
+    PayloadSize = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+    First       = Index;
+    SendAlone   = FALSE;
+    for ( ; Index < EntryCount; Index++) {
+      if (Entries[Index].VariableName == NULL || Entries[Index].VariableName[0] == 0 ||
+          Entries[Index].VendorGuid == NULL ||
+          (Entries[Index].DataSize != 0 && Entries[Index].Data == NULL)) {
+        Entries[Index].Status = EFI_INVALID_PARAMETER;
+        continue;
+      }
+
+      VariableNameSize = StrSize (Entries[Index].VariableName);
+      if ((VariableNameSize > mVariableBufferPayloadSize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name)) ||
+          (Entries[Index].DataSize > mVariableBufferPayloadSize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name) - VariableNameSize)) {
+        Entries[Index].Status = EFI_INVALID_PARAMETER;
+        continue;
+      }
+
+      EntrySize = ALIGN_VALUE (SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE + VariableNameSize + Entries[Index].DataSize, sizeof (UINTN));
+      if (EntrySize > mVariableBufferPayloadSize - sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH)) {
+        //
+        // Too large to share a buffer with the batch header, so send it by
+        // itself once the entries packed so far are done.
+        //
+        SendAlone = TRUE;
+        break;
+      }
+      if (EntrySize > mVariableBufferPayloadSize - PayloadSize) {
+        break;
+      }
+
+      BatchEntry = (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY *) ((UINT8 *) SetVariableBatch + PayloadSize);
+      BatchEntry->Status = EFI_NOT_STARTED;
+      CopyGuid (&BatchEntry->Variable.Guid, Entries[Index].VendorGuid);
+      BatchEntry->Variable.DataSize   = Entries[Index].DataSize;
+      BatchEntry->Variable.NameSize   = VariableNameSize;
+      BatchEntry->Variable.Attributes = Entries[Index].Attributes;
+      CopyMem (BatchEntry->Variable.Name, Entries[Index].VariableName, VariableNameSize);
+      CopyMem ((UINT8 *) BatchEntry->Variable.Name + VariableNameSize, Entries[Index].Data, Entries[Index].DataSize);
+
+      Entries[Index].Status = EFI_NOT_STARTED;
+      SetVariableBatch->EntryCount++;
+      PayloadSize += EntrySize;
+    }
+
+    if (SetVariableBatch->EntryCount != 0) {
+      Status = InitCommunicateBuffer (NULL, PayloadSize, SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH);
+      ASSERT_EFI_ERROR (Status);
+      Status = SendCommunicateBuffer (PayloadSize);
+
+      //
+      // Collect the per entry results. An entry SMM did not get to takes the
+      // status of the whole call.
+      //
+      PayloadSize = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+      for (Packed = First; Packed < Index; Packed++) {
+        if (Entries[Packed].Status != EFI_NOT_STARTED) {
+          continue;
+        }
+        BatchEntry = (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH_ENTRY *) ((UINT8 *) SetVariableBatch + PayloadSize);
+        Entries[Packed].Status = BatchEntry->Status;
+        if (Entries[Packed].Status == EFI_NOT_STARTED) {
+          Entries[Packed].Status = EFI_ERROR (Status) ? Status : EFI_ABORTED;
+        }
+        PayloadSize += ALIGN_VALUE (SMM_VARIABLE_BATCH_ENTRY_HEADER_SIZE + BatchEntry->Variable.NameSize + BatchEntry->Variable.DataSize, sizeof (UINTN));
+      }
+    }
+
+    ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+
+    for (Packed = First; Packed < Index; Packed++) {
+      if (!EFI_ERROR (Entries[Packed].Status)) {
+        SecureBootHook (Entries[Packed].VariableName, Entries[Packed].VendorGuid);
+      } else if (!EFI_ERROR (ReturnStatus)) {
+        ReturnStatus = Entries[Packed].Status;
+      }
+    }
+
+    if (SendAlone) {
+      Entries[Index].Status = RuntimeServiceSetVariable (
+                                Entries[Index].VariableName,
+                                Entries[Index].VendorGuid,
+                                Entries[Index].Attributes,
+                                Entries[Index].DataSize,
+                                Entries[Index].Data
+                                );
+      if (EFI_ERROR (Entries[Index].Status) && !EFI_ERROR (ReturnStatus)) {
+        ReturnStatus = Entries[Index].Status;
+      }
+      Index++;
+    }
+  }
+
+  return ReturnStatus;
+}
+
+/**
+  Returns information about the EFI variables from the runtime cache.
+
+  The validation follows VariableServiceQueryVariableInfo () and the size
+  calculation follows the runtime path of VariableServiceQueryVariableInfoInternal (),
+  with the fixed limits retrieved from SMM at ExitBootServices ().
+
+  @param[in]  Attributes                   Attributes bitmask to specify the type of variables
+                                           on which to return information.
+  @param[out] MaximumVariableStorageSize   Pointer to the maximum size of the storage space available
+                                           for the EFI variables associated with the attributes specified.
+  @param[out] RemainingVariableStorageSize Pointer to the remaining size of the storage space available
+                                           for EFI variables associated with the attributes specified.
+  @param[out] MaximumVariableSize          Pointer to the maximum size of an individual EFI variables
+                                           associated with the attributes specified.
+
+  @retval EFI_INVALID_PARAMETER            An invalid combination of attribute bits was supplied.
+  @retval EFI_SUCCESS                      Query successfully.
+  @retval EFI_UNSUPPORTED                  The attribute is not supported on this platform.
+  @retval EFI_NOT_READY                    The runtime cache could not be synchronized, the query must be sent to SMM.
+
+**/
+EFI_STATUS
+QueryVariableInfoInRuntimeCache (
+  IN  UINT32                                Attributes,
+  OUT UINT64                                *MaximumVariableStorageSize,
+  OUT UINT64                                *RemainingVariableStorageSize,
+  OUT UINT64                                *MaximumVariableSize
+  )
+{
+  VARIABLE_STORE_HEADER   *VariableStoreHeader;
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_HEADER         *NextVariable;
+  UINT64                  VariableSize;
+  UINT64                  CommonVariableTotalSize;
+  UINT64                  HwErrVariableTotalSize;
+  UINTN                   HeaderSize;
+  EFI_STATUS              Status;
+
+  if ((Attributes & EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((Attributes & EFI_VARIABLE_ATTRIBUTES_MASK) == 0) {
+    return EFI_UNSUPPORTED;
+  } else if ((Attributes & (EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_BOOTSERVICE_ACCESS)) == EFI_VARIABLE_RUNTIME_ACCESS) {
+    return EFI_INVALID_PARAMETER;
+  } else if ((Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0) {
+    //
+    // This path is only taken at runtime.
+    //
+    return EFI_INVALID_PARAMETER;
+  } else if ((Attributes & (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_HARDWARE_ERROR_RECORD)) == EFI_VARIABLE_HARDWARE_ERROR_RECORD) {
+    return EFI_INVALID_PARAMETER;
+  } else if ((Attributes & VARIABLE_ATTRIBUTE_AT_AW) != 0) {
+    if (!mQueryVariableInfoLimits.AuthSupport) {
+      return EFI_UNSUPPORTED;
+    }
+  } else if ((Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) != 0) {
+    if (mQueryVariableInfoLimits.HwErrStorageSize == 0) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  if ((Attributes & EFI_VARIABLE_NON_VOLATILE) == 0) {
+    VariableStoreHeader = mVariableRuntimeVolatileCacheBuffer;
+  } else {
+    VariableStoreHeader = mVariableRuntimeNvCacheBuffer;
+  }
+  if (VariableStoreHeader == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  HeaderSize = GetVariableHeaderSize (mVariableAuthFormat);
+  if ((Attributes & (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_HARDWARE_ERROR_RECORD)) == (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_HARDWARE_ERROR_RECORD)) {
+    *MaximumVariableStorageSize = mQueryVariableInfoLimits.HwErrStorageSize;
+    *MaximumVariableSize        = mQueryVariableInfoLimits.MaxHardwareErrorVariableSize - HeaderSize;
+  } else {
+    if ((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0) {
+      *MaximumVariableStorageSize = mQueryVariableInfoLimits.CommonRuntimeVariableSpace;
+    } else {
+      *MaximumVariableStorageSize = mQueryVariableInfoLimits.VolatileStorageSize;
+    }
+
+    if ((Attributes & VARIABLE_ATTRIBUTE_AT_AW) != 0) {
+      *MaximumVariableSize = mQueryVariableInfoLimits.MaxAuthVariableSize - HeaderSize;
+    } else if ((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0) {
+      *MaximumVariableSize = mQueryVariableInfoLimits.MaxVariableSize - HeaderSize;
+    } else {
+      *MaximumVariableSize = mQueryVariableInfoLimits.MaxVolatileVariableSize - HeaderSize;
+    }
+  }
+
+  CommonVariableTotalSize = 0;
+  HwErrVariableTotalSize  = 0;
+
+  //
+  // See FindVariableInRuntimeCache () for the runtime cache read lock usage.
+  //
+  ASSERT (!mVariableRuntimeCacheReadLock);
+
+  mVariableRuntimeCacheReadLock = TRUE;
+  CheckForRuntimeCacheSync ();
+
+  Status = EFI_NOT_READY;
+  if (!mVariableRuntimeCachePendingUpdate) {
+    //
+    // The state of the variables is not taken into account, since the space
+    // occupied by variables not marked with VAR_ADDED cannot be reclaimed at runtime.
+    // Deleted hardware error records count towards the common variable space.
+    //
+    Variable = GetStartPointer (VariableStoreHeader);
+    while (IsValidVariableHeader (Variable, GetEndPointer (VariableStoreHeader))) {
+      NextVariable = GetNextVariablePtr (Variable, mVariableAuthFormat);
+      VariableSize = (UINT64) (UINTN) NextVariable - (UINT64) (UINTN) Variable;
+
+      if (((Variable->Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) == EFI_VARIABLE_HARDWARE_ERROR_RECORD) &&
+          ((Variable->State | VAR_DELETED) != VAR_DELETED)) {
+        HwErrVariableTotalSize += VariableSize;
+      } else {
+        CommonVariableTotalSize += VariableSize;
+      }
+
+      Variable = NextVariable;
+    }
+    Status = EFI_SUCCESS;
+  }
+
+  mVariableRuntimeCacheReadLock = FALSE;
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) == EFI_VARIABLE_HARDWARE_ERROR_RECORD) {
+    *RemainingVariableStorageSize = *MaximumVariableStorageSize - HwErrVariableTotalSize;
+  } else {
+    if (*MaximumVariableStorageSize < CommonVariableTotalSize) {
+      *RemainingVariableStorageSize = 0;
+    } else {
+      *RemainingVariableStorageSize = *MaximumVariableStorageSize - CommonVariableTotalSize;
+    }
+  }
+
+  if (*RemainingVariableStorageSize < HeaderSize) {
+    *MaximumVariableSize = 0;
+  } else if ((*RemainingVariableStorageSize - HeaderSize) < *MaximumVariableSize) {
+    *MaximumVariableSize = *RemainingVariableStorageSize - HeaderSize;
+  }
+
+  return EFI_SUCCESS;
+}
+// MU_CHANGE [END]
+
 
 /**
   This code returns information about the EFI variables.
@@ -1189,6 +1502,22 @@ RuntimeServiceQueryVariableInfo (
     return EFI_INVALID_PARAMETER;
   }
 
+  // MU_CHANGE [BEGIN] - Serve QueryVariableInfo from the runtime cache.
+  if (FeaturePcdGet (PcdEnableVariableRuntimeCache) && mQueryVariableInfoLimitsValid && AtRuntime ()) {
+    Status = QueryVariableInfoInRuntimeCache (
+               Attributes,
+               MaximumVariableStorageSize,
+               RemainingVariableStorageSize,
+               MaximumVariableSize
+               );
+    if (Status != EFI_NOT_READY) {
+      mQueryVariableInfoCacheHits++;
+      return Status;
+    }
+  }
+  mQueryVariableInfoSmmCalls++;
+  // MU_CHANGE [END]
+
   AcquireLockOnlyAtBootTime(&mVariableServicesLock);
 
   //
@@ -1224,6 +1553,56 @@ Done:
   return Status;
 }
 
+// MU_CHANGE [BEGIN] - Serve QueryVariableInfo from the runtime cache.
+/**
+  Retrieves the fixed limits used by QueryVariableInfo () at runtime from SMM.
+
+  @retval EFI_SUCCESS               The limits were retrieved into mQueryVariableInfoLimits.
+  @retval Others                    The limits could not be retrieved.
+
+**/
+EFI_STATUS
+GetQueryVariableInfoLimits (
+  VOID
+  )
+{
+  EFI_STATUS                                               Status;
+  UINTN                                                    PayloadSize;
+  SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS  *SmmQueryInfoLimits;
+
+  SmmQueryInfoLimits = NULL;
+
+  AcquireLockOnlyAtBootTime (&mVariableServicesLock);
+
+  //
+  // Init the communicate buffer. The buffer data size is:
+  // SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + PayloadSize;
+  //
+  PayloadSize = sizeof (SMM_VARIABLE_COMMUNICATE_GET_QUERY_VARIABLE_INFO_LIMITS);
+  Status = InitCommunicateBuffer ((VOID **)&SmmQueryInfoLimits, PayloadSize, SMM_VARIABLE_FUNCTION_GET_QUERY_VARIABLE_INFO_LIMITS);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+  ASSERT (SmmQueryInfoLimits != NULL);
+
+  //
+  // Send data to SMM.
+  //
+  Status = SendCommunicateBuffer (PayloadSize);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  //
+  // Get data from SMM.
+  //
+  CopyMem (&mQueryVariableInfoLimits, SmmQueryInfoLimits, sizeof (mQueryVariableInfoLimits));
+
+Done:
+  ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+  return Status;
+}
+// MU_CHANGE [END]
 
 /**
   Exit Boot Services Event notification handler.
@@ -1241,6 +1620,14 @@ OnExitBootServices (
   IN      VOID                              *Context
   )
 {
+  // MU_CHANGE [BEGIN] - Serve QueryVariableInfo from the runtime cache.
+  if (FeaturePcdGet (PcdEnableVariableRuntimeCache) &&
+      (mVariableRuntimeNvCacheBuffer != NULL) &&
+      (mVariableRuntimeVolatileCacheBuffer != NULL)) {
+    mQueryVariableInfoLimitsValid = !EFI_ERROR (GetQueryVariableInfoLimits ());
+  }
+  // MU_CHANGE [END]
+
   //
   // Init the communicate buffer. The buffer data size is:
   // SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE.
@@ -1712,6 +2099,18 @@ SmmVariableWriteReady (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  // MU_CHANGE [BEGIN] - Set several variables with one SMM communicate call.
+  mVariableWriteBatch.Revision     = EDKII_VARIABLE_WRITE_BATCH_PROTOCOL_REVISION;
+  mVariableWriteBatch.SetVariables = VariableWriteBatchSetVariables;
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &mHandle,
+                  &gEdkiiVariableWriteBatchProtocolGuid,
+                  &mVariableWriteBatch,
+                  NULL
+                  );
+  ASSERT_EFI_ERROR (Status);
+  // MU_CHANGE [END]
+
   gBS->CloseEvent (Event);
 }
 
@@ -0,0 +1,75 @@
+/** @file
+  GUID and data structure of the GUID HOB index configuration table.
+
+  The DXE Core builds this index over the GUID extension HOBs of the HOB list
+  and installs it into the EFI System Configuration Table, so GetFirstGuidHob()
+  and GetNextGuidHob() in DXE do not have to walk the whole HOB list.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __GUID_HOB_INDEX_GUID_H__
+#define __GUID_HOB_INDEX_GUID_H__
+
+#define GUID_HOB_INDEX_TABLE_GUID \
+  { \
+    0x9131eea2, 0xfe3d, 0x4b82, {0xab, 0xbc, 0x09, 0x35, 0x8e, 0xe6, 0xb9, 0x50 } \
+  }
+
+#define GUID_HOB_INDEX_TABLE_REVISION   1
+
+///
+/// Terminates a bucket chain.
+///
+#define GUID_HOB_INDEX_NONE             MAX_UINT32
+
+///
+/// One GUID extension HOB of the indexed HOB list.
+///
+typedef struct {
+  ///
+  /// The GUID extension HOB.
+  ///
+  EFI_HOB_GUID_TYPE   *Hob;
+  ///
+  /// Index of the next entry in the same bucket, or GUID_HOB_INDEX_NONE.
+  /// The entries of a bucket are linked in HOB list order.
+  ///
+  UINT32              Next;
+  UINT32              Reserved;
+} GUID_HOB_INDEX_ENTRY;
+
+///
+/// The table is followed by EntryCount GUID_HOB_INDEX_ENTRY structures and
+/// then by BucketCount UINT32 indexes of the first entry of each bucket.
+///
+typedef struct {
+  UINT32              Revision;
+  ///
+  /// Number of hash buckets. It is a power of two.
+  ///
+  UINT32              BucketCount;
+  UINT32              EntryCount;
+  UINT32              Reserved;
+  ///
+  /// First HOB and end of list HOB of the indexed HOB list.
+  ///
+  VOID                *HobList;
+  VOID                *HobListEnd;
+} GUID_HOB_INDEX_TABLE;
+
+#define GUID_HOB_INDEX_ENTRIES(Table) \
+  ((GUID_HOB_INDEX_ENTRY *) ((GUID_HOB_INDEX_TABLE *) (Table) + 1))
+
+#define GUID_HOB_INDEX_BUCKETS(Table) \
+  ((UINT32 *) (GUID_HOB_INDEX_ENTRIES (Table) + (Table)->EntryCount))
+
+#define GUID_HOB_INDEX_BUCKET(Table, Guid) \
+  ((((CONST UINT32 *) (Guid))[0] ^ ((CONST UINT32 *) (Guid))[1] ^ \
+    ((CONST UINT32 *) (Guid))[2] ^ ((CONST UINT32 *) (Guid))[3]) & ((Table)->BucketCount - 1))
+
+extern EFI_GUID gMuGuidHobIndexTableGuid;
+
+#endif
@@ -76,6 +76,21 @@
 ///
 #define HTTP_HEADER_ACCEPT_RANGES      "Accept-Ranges"
 
+///
+/// Range Request Header
+/// The Range request-header field requests that the server transfers only
+/// the specified byte ranges of the selected representation.
+///
+#define HTTP_HEADER_RANGE              "Range"
+
+///
+/// Content-Range Header
+/// The Content-Range header field is sent in a 206 (Partial Content) response
+/// to indicate the byte range of the selected representation that is enclosed
+/// as the payload.
+///
+#define HTTP_HEADER_CONTENT_RANGE      "Content-Range"
+
 
 ///
 /// Accept-Encoding Request Header
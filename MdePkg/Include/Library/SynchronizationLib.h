@@ -14,6 +14,40 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 typedef volatile UINTN              SPIN_LOCK;
 
+///
+/// Definitions for TICKET_LOCK. Processors acquire a ticket lock in the order
+/// in which they started waiting for it.
+///
+typedef struct {
+  volatile UINT32                   NextTicket;
+  volatile UINT32                   NowServing;
+} TICKET_LOCK;
+
+///
+/// Definitions for MCS_LOCK. Every processor waiting for an MCS lock spins on
+/// its own MCS_LOCK_NODE, so a release only touches the cache line of the
+/// next waiter.
+///
+typedef struct _MCS_LOCK_NODE MCS_LOCK_NODE;
+
+struct _MCS_LOCK_NODE {
+  MCS_LOCK_NODE * volatile          Next;
+  volatile BOOLEAN                  Locked;
+};
+
+typedef MCS_LOCK_NODE * volatile    MCS_LOCK;
+
+///
+/// Definitions for SPMC_QUEUE, a bounded lock-free queue of UINTN values with
+/// a single producer and any number of consumers.
+///
+typedef struct {
+  volatile UINT32                   Head;
+  volatile UINT32                   Tail;
+  UINT32                            Mask;
+  volatile UINTN                    *Entries;
+} SPMC_QUEUE;
+
 
 /**
   Retrieves the architecture-specific spin lock alignment requirements for
@@ -282,6 +316,214 @@ InterlockedCompareExchangePointer (
   IN      VOID                      *ExchangeValue
   );
 
+
+/**
+  Initializes a ticket lock to the released state and returns the ticket lock.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to initialize to the
+                      released state.
+
+  @return TicketLock in release state.
+
+**/
+TICKET_LOCK *
+EFIAPI
+InitializeTicketLock (
+  OUT      TICKET_LOCK               *TicketLock
+  );
+
+
+/**
+  Waits until a ticket lock can be placed in the acquired state.
+
+  This function takes the next ticket of TicketLock and waits, with CpuPause(),
+  until that ticket is served. Processors are granted the lock in the order in
+  which they called this function.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired
+                      state.
+
+  @return TicketLock acquired the lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+AcquireTicketLock (
+  IN OUT  TICKET_LOCK               *TicketLock
+  );
+
+
+/**
+  Attempts to place a ticket lock in the acquired state.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired
+                      state.
+
+  @retval TRUE  TicketLock was placed in the acquired state.
+  @retval FALSE TicketLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireTicketLockOrFail (
+  IN OUT  TICKET_LOCK               *TicketLock
+  );
+
+
+/**
+  Releases a ticket lock and hands it to the next waiting processor.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to release.
+
+  @return TicketLock released the lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+ReleaseTicketLock (
+  IN OUT  TICKET_LOCK               *TicketLock
+  );
+
+
+/**
+  Initializes an MCS lock to the released state and returns the MCS lock.
+
+  If McsLock is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to initialize to the released
+                   state.
+
+  @return McsLock in release state.
+
+**/
+MCS_LOCK *
+EFIAPI
+InitializeMcsLock (
+  OUT      MCS_LOCK                  *McsLock
+  );
+
+
+/**
+  Waits until an MCS lock can be placed in the acquired state.
+
+  The caller provides a queue node that must stay valid, and must not be used
+  for another lock, until the matching ReleaseMcsLock(). The caller spins only
+  on Node while it waits.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to place in the acquired state.
+  @param  Node     The queue node of the calling processor.
+
+  @return McsLock acquired the lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+AcquireMcsLock (
+  IN OUT  MCS_LOCK                  *McsLock,
+  IN OUT  MCS_LOCK_NODE             *Node
+  );
+
+
+/**
+  Releases an MCS lock and hands it to the next waiting processor.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to release.
+  @param  Node     The queue node that was passed to AcquireMcsLock().
+
+  @return McsLock released the lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+ReleaseMcsLock (
+  IN OUT  MCS_LOCK                  *McsLock,
+  IN OUT  MCS_LOCK_NODE             *Node
+  );
+
+
+/**
+  Initializes an empty single producer, multiple consumer queue.
+
+  If Queue is NULL, then ASSERT().
+  If Entries is NULL, then ASSERT().
+  If Capacity is zero or not a power of two, then ASSERT().
+
+  @param  Queue     A pointer to the queue to initialize.
+  @param  Entries   The storage of the queue, Capacity UINTN values.
+  @param  Capacity  The number of values the queue can hold. Must be a power
+                    of two.
+
+  @return Queue, empty.
+
+**/
+SPMC_QUEUE *
+EFIAPI
+SpmcQueueInitialize (
+  OUT      SPMC_QUEUE                *Queue,
+  IN       UINTN                     *Entries,
+  IN       UINT32                    Capacity
+  );
+
+
+/**
+  Adds a value to the tail of a single producer, multiple consumer queue.
+
+  Only one processor may call this function for a given Queue at a time.
+
+  If Queue is NULL, then ASSERT().
+
+  @param  Queue  A pointer to the queue.
+  @param  Value  The value to add.
+
+  @retval TRUE  Value was added.
+  @retval FALSE The queue is full.
+
+**/
+BOOLEAN
+EFIAPI
+SpmcQueueEnqueue (
+  IN OUT  SPMC_QUEUE                *Queue,
+  IN      UINTN                     Value
+  );
+
+
+/**
+  Removes a value from the head of a single producer, multiple consumer queue.
+
+  Any number of processors may call this function at the same time. Each value
+  is returned to exactly one of them.
+
+  If Queue is NULL, then ASSERT().
+  If Value is NULL, then ASSERT().
+
+  @param  Queue  A pointer to the queue.
+  @param  Value  The value removed.
+
+  @retval TRUE  A value was removed.
+  @retval FALSE The queue is empty.
+
+**/
+BOOLEAN
+EFIAPI
+SpmcQueueDequeue (
+  IN OUT  SPMC_QUEUE                *Queue,
+  OUT     UINTN                     *Value
+  );
+
 #endif
 
 
@@ -564,6 +564,29 @@ InternalAsciiHexCharToUintn (
   IN      CHAR8                    Char
   );
 
+//
+// CRC32 functions
+//
+
+extern CONST UINT32  mCrcTable[256];
+
+/**
+  Updates a running CRC32 with the fastest method the processor supports.
+
+  @param[in]  Crc       The running CRC before its final inversion.
+  @param[in]  Buffer    A pointer to the data.
+  @param[in]  Length    The number of bytes in Buffer.
+
+  @return The running CRC after Buffer.
+
+**/
+UINT32
+InternalCalculateCrc32Fast (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
 
 //
 // Ia32 and x64 specific functions
@@ -862,6 +885,29 @@ InternalX86RdRand64  (
   OUT     UINT64                    *Rand
   );
 
+#if defined (MDE_CPU_X64)
+/**
+  Updates a running CRC32 by carry-less multiplication folding.
+
+  The processor must support PCLMULQDQ.
+
+  @param[in]  Crc       The running CRC before its final inversion.
+  @param[in]  Buffer    A pointer to the data, 16-byte aligned.
+  @param[in]  Length    The number of bytes in Buffer, a multiple of 16 and
+                        at least 64.
+
+  @return The running CRC after Buffer.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Pclmul (
+  IN UINT32      Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+#endif
+
 #else
 
 #endif
@@ -591,6 +591,10 @@ GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT32  mCrcTable[256] = {
   Computes and returns a 32-bit CRC for a data buffer.
   CRC32 value bases on ITU-T V.42.
 
+  When PcdFastCrc32Enable is TRUE the CRC is computed eight bytes at a time,
+  and on X64 processors that support PCLMULQDQ by carry-less multiplication
+  folding.
+
   If Buffer is NULL, then ASSERT().
   If Length is greater than (MAX_ADDRESS - Buffer + 1), then ASSERT().
 
@@ -614,6 +618,10 @@ CalculateCrc32(
   ASSERT (Buffer != NULL);
   ASSERT (Length <= (MAX_ADDRESS - ((UINTN) Buffer) + 1));
 
+  if (FeaturePcdGet (PcdFastCrc32Enable)) {
+    return InternalCalculateCrc32Fast (0xffffffff, Buffer, Length) ^ 0xffffffff;
+  }
+
   //
   // Compute CRC
   //
@@ -0,0 +1,321 @@
+/** @file
+  Pick the CopyMem(), SetMem(), ZeroMem() and CompareMem() implementation
+  from the CPU features.
+
+  The features are read with CPUID on the first call and kept for the later
+  calls. Short requests and CPUs without the features use the routines of
+  BaseMemoryLibOptDxe.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "MemLibInternals.h"
+#include <Register/Intel/Cpuid.h>
+
+#define MEM_LIB_CPU_FEATURE_VALID   BIT0
+#define MEM_LIB_CPU_FEATURE_ERMS    BIT1
+#define MEM_LIB_CPU_FEATURE_FSRM    BIT2
+#define MEM_LIB_CPU_FEATURE_AVX2    BIT3
+
+//
+// CPUID.(EAX=07H, ECX=0):EDX[4] - Fast Short REP MOVSB.
+//
+#define CPUID_EXTENDED_FEATURE_FLAGS_EDX_FSRM  BIT4
+
+//
+// Requests of at least this many bytes use REP MOVSB/STOSB when the CPU
+// reports ERMS. With FSRM, short REP MOVSB copies are fast as well.
+//
+#define MEM_LIB_ERMS_MIN_LENGTH          128
+#define MEM_LIB_FSRM_MIN_LENGTH          16
+
+//
+// Copies and fills of at least this many bytes use AVX2.
+//
+#define MEM_LIB_AVX2_MIN_LENGTH          SIZE_4KB
+
+//
+// Compares of at least this many bytes use AVX2.
+//
+#define MEM_LIB_AVX2_COMPARE_MIN_LENGTH  64
+
+//
+// AVX2 copies and fills of at least this many bytes use non-temporal stores,
+// so that they do not evict the whole cache.
+//
+#define MEM_LIB_NON_TEMPORAL_MIN_LENGTH  SIZE_1MB
+
+UINT32  mMemLibCpuFeatures = 0;
+
+VOID *
+EFIAPI
+InternalMemCopyMemGeneric (
+  OUT     VOID                      *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  );
+
+VOID *
+EFIAPI
+InternalMemCopyMemErms (
+  OUT     VOID                      *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  );
+
+VOID *
+EFIAPI
+InternalMemCopyMemAvx2 (
+  OUT     VOID                      *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length,
+  IN      BOOLEAN                   NonTemporal
+  );
+
+VOID *
+EFIAPI
+InternalMemSetMemGeneric (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT8                     Value
+  );
+
+VOID *
+EFIAPI
+InternalMemSetMemErms (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT8                     Value
+  );
+
+VOID *
+EFIAPI
+InternalMemSetMemAvx2 (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT8                     Value,
+  IN      BOOLEAN                   NonTemporal
+  );
+
+VOID *
+EFIAPI
+InternalMemZeroMemGeneric (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length
+  );
+
+INTN
+EFIAPI
+InternalMemCompareMemGeneric (
+  IN      CONST VOID                *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  );
+
+INTN
+EFIAPI
+InternalMemCompareMemAvx2 (
+  IN      CONST VOID                *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  );
+
+/**
+  Return the CPU features that select the implementation.
+
+  Several processors may call this at the same time before the features are
+  cached. They all compute the same value.
+
+  @return A bit mask of MEM_LIB_CPU_FEATURE_* values.
+
+**/
+STATIC
+UINT32
+InternalMemGetCpuFeatures (
+  VOID
+  )
+{
+  UINT32                                       Features;
+  UINT32                                       MaxLeaf;
+  CPUID_VERSION_INFO_ECX                       VersionEcx;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EBX  ExtendedEbx;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EDX  ExtendedEdx;
+
+  Features = mMemLibCpuFeatures;
+  if ((Features & MEM_LIB_CPU_FEATURE_VALID) != 0) {
+    return Features;
+  }
+
+  Features = MEM_LIB_CPU_FEATURE_VALID;
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf >= CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+    AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionEcx.Uint32, NULL);
+    AsmCpuidEx (
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS,
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_SUB_LEAF_INFO,
+      NULL,
+      &ExtendedEbx.Uint32,
+      NULL,
+      &ExtendedEdx.Uint32
+      );
+
+    if (ExtendedEbx.Bits.EnhancedRepMovsbStosb != 0) {
+      Features |= MEM_LIB_CPU_FEATURE_ERMS;
+      if ((ExtendedEdx.Uint32 & CPUID_EXTENDED_FEATURE_FLAGS_EDX_FSRM) != 0) {
+        Features |= MEM_LIB_CPU_FEATURE_FSRM;
+      }
+    }
+
+    //
+    // AVX2 instructions fault unless XCR0 enables the SSE and AVX state.
+    //
+    if ((ExtendedEbx.Bits.AVX2 != 0) &&
+        (VersionEcx.Bits.AVX != 0) &&
+        (VersionEcx.Bits.OSXSAVE != 0) &&
+        ((AsmXGetBv (0) & (BIT1 | BIT2)) == (BIT1 | BIT2))) {
+      Features |= MEM_LIB_CPU_FEATURE_AVX2;
+    }
+  }
+
+  mMemLibCpuFeatures = Features;
+  return Features;
+}
+
+/**
+  Copy Length bytes from Source to Destination.
+
+  @param  DestinationBuffer The target of the copy request.
+  @param  SourceBuffer      The place to copy from.
+  @param  Length            The number of bytes to copy.
+
+  @return Destination.
+
+**/
+VOID *
+EFIAPI
+InternalMemCopyMem (
+  OUT     VOID                      *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  )
+{
+  UINT32  Features;
+
+  //
+  // The ERMS and AVX2 routines only copy forward, which is safe unless the
+  // destination starts inside the source.
+  //
+  if ((UINTN)DestinationBuffer - (UINTN)SourceBuffer >= Length) {
+    Features = InternalMemGetCpuFeatures ();
+    if (((Features & MEM_LIB_CPU_FEATURE_AVX2) != 0) &&
+        (Length >= MEM_LIB_AVX2_MIN_LENGTH)) {
+      return InternalMemCopyMemAvx2 (
+               DestinationBuffer,
+               SourceBuffer,
+               Length,
+               (BOOLEAN)(Length >= MEM_LIB_NON_TEMPORAL_MIN_LENGTH)
+               );
+    }
+
+    if (((Features & MEM_LIB_CPU_FEATURE_ERMS) != 0) &&
+        (Length >= (((Features & MEM_LIB_CPU_FEATURE_FSRM) != 0) ?
+                    MEM_LIB_FSRM_MIN_LENGTH : MEM_LIB_ERMS_MIN_LENGTH))) {
+      return InternalMemCopyMemErms (DestinationBuffer, SourceBuffer, Length);
+    }
+  }
+
+  return InternalMemCopyMemGeneric (DestinationBuffer, SourceBuffer, Length);
+}
+
+/**
+  Set Buffer to Value for Size bytes.
+
+  @param  Buffer   The memory to set.
+  @param  Length   The number of bytes to set.
+  @param  Value    The value of the set operation.
+
+  @return Buffer
+
+**/
+VOID *
+EFIAPI
+InternalMemSetMem (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length,
+  IN      UINT8                     Value
+  )
+{
+  UINT32  Features;
+
+  Features = InternalMemGetCpuFeatures ();
+  if (((Features & MEM_LIB_CPU_FEATURE_AVX2) != 0) &&
+      (Length >= MEM_LIB_AVX2_MIN_LENGTH)) {
+    return InternalMemSetMemAvx2 (
+             Buffer,
+             Length,
+             Value,
+             (BOOLEAN)(Length >= MEM_LIB_NON_TEMPORAL_MIN_LENGTH)
+             );
+  }
+
+  if (((Features & MEM_LIB_CPU_FEATURE_ERMS) != 0) &&
+      (Length >= MEM_LIB_ERMS_MIN_LENGTH)) {
+    return InternalMemSetMemErms (Buffer, Length, Value);
+  }
+
+  return InternalMemSetMemGeneric (Buffer, Length, Value);
+}
+
+/**
+  Set Buffer to 0 for Size bytes.
+
+  @param  Buffer The memory to set.
+  @param  Length The number of bytes to set
+
+  @return Buffer.
+
+**/
+VOID *
+EFIAPI
+InternalMemZeroMem (
+  OUT     VOID                      *Buffer,
+  IN      UINTN                     Length
+  )
+{
+  if (Length >= MEM_LIB_ERMS_MIN_LENGTH) {
+    return InternalMemSetMem (Buffer, Length, 0);
+  }
+
+  return InternalMemZeroMemGeneric (Buffer, Length);
+}
+
+/**
+  Compares two memory buffers of a given length.
+
+  @param  DestinationBuffer The first memory buffer.
+  @param  SourceBuffer      The second memory buffer.
+  @param  Length            The length of DestinationBuffer and SourceBuffer memory
+                            regions to compare. Must be non-zero.
+
+  @return 0                 All Length bytes of the two buffers are identical.
+  @retval Non-zero          The first mismatched byte in SourceBuffer subtracted from the first
+                            mismatched byte in DestinationBuffer.
+
+**/
+INTN
+EFIAPI
+InternalMemCompareMem (
+  IN      CONST VOID                *DestinationBuffer,
+  IN      CONST VOID                *SourceBuffer,
+  IN      UINTN                     Length
+  )
+{
+  if ((Length >= MEM_LIB_AVX2_COMPARE_MIN_LENGTH) &&
+      ((InternalMemGetCpuFeatures () & MEM_LIB_CPU_FEATURE_AVX2) != 0)) {
+    return InternalMemCompareMemAvx2 (DestinationBuffer, SourceBuffer, Length);
+  }
+
+  return InternalMemCompareMemGeneric (DestinationBuffer, SourceBuffer, Length);
+}
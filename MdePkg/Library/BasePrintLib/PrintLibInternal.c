@@ -153,6 +153,68 @@ BasePrintLibValueToString (
   return Buffer;
 }
 
+/**
+  Internal function that converts a GUID to the string printed for %g.
+
+  The GUID is converted directly to lower case hexadecimal digits in registry
+  format, instead of formatting it with a nested BasePrintLibSPrint() call.
+
+  @param  Buffer    Location to place the Null-terminated ASCII string. It must
+                    hold at least 37 characters.
+  @param  Guid      The GUID to convert.
+
+  @return Buffer.
+
+**/
+STATIC
+CHAR8 *
+BasePrintLibGuidToString (
+  OUT CHAR8       *Buffer,
+  IN  CONST GUID  *Guid
+  )
+{
+  UINT64  Fields[5];
+  UINT8   Digits[5];
+  UINTN   FieldIndex;
+  UINTN   Index;
+  CHAR8   *String;
+
+  Fields[0] = ReadUnaligned32 (&Guid->Data1);
+  Fields[1] = ReadUnaligned16 (&Guid->Data2);
+  Fields[2] = ReadUnaligned16 (&Guid->Data3);
+  Fields[3] = ((UINT64)Guid->Data4[0] << 8) | Guid->Data4[1];
+  Fields[4] = 0;
+  for (Index = 2; Index < 8; Index++) {
+    Fields[4] = LShiftU64 (Fields[4], 8) | Guid->Data4[Index];
+  }
+
+  Digits[0] = 8;
+  Digits[1] = 4;
+  Digits[2] = 4;
+  Digits[3] = 4;
+  Digits[4] = 12;
+
+  String = Buffer;
+  for (FieldIndex = 0; FieldIndex < 5; FieldIndex++) {
+    if (FieldIndex != 0) {
+      *(String++) = '-';
+    }
+
+    //
+    // The letters of mHexStr are upper case. Setting bit 5 turns them to lower
+    // case and leaves the digits as they are.
+    //
+    for (Index = Digits[FieldIndex]; Index > 0; Index--) {
+      String[Index - 1] = (CHAR8)(mHexStr[(UINTN)Fields[FieldIndex] & 0xF] | 0x20);
+      Fields[FieldIndex] = RShiftU64 (Fields[FieldIndex], 4);
+    }
+    String += Digits[FieldIndex];
+  }
+  *String = '\0';
+
+  return Buffer;
+}
+
 /**
   Internal function that converts a decimal value to a Null-terminated string.
 
@@ -562,9 +624,6 @@ BasePrintLibSPrintMarker (
   UINTN             Digits;
   UINTN             Radix;
   RETURN_STATUS     Status;
-  UINT32            GuidData1;
-  UINT16            GuidData2;
-  UINT16            GuidData3;
   UINTN             LengthToReturn;
 
   //
@@ -944,27 +1003,7 @@ BasePrintLibSPrintMarker (
         if (TmpGuid == NULL) {
           ArgumentString = "<null guid>";
         } else {
-          GuidData1 = ReadUnaligned32 (&(TmpGuid->Data1));
-          GuidData2 = ReadUnaligned16 (&(TmpGuid->Data2));
-          GuidData3 = ReadUnaligned16 (&(TmpGuid->Data3));
-          BasePrintLibSPrint (
-            ValueBuffer,
-            MAXIMUM_VALUE_CHARACTERS,
-            0,
-            "%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-            GuidData1,
-            GuidData2,
-            GuidData3,
-            TmpGuid->Data4[0],
-            TmpGuid->Data4[1],
-            TmpGuid->Data4[2],
-            TmpGuid->Data4[3],
-            TmpGuid->Data4[4],
-            TmpGuid->Data4[5],
-            TmpGuid->Data4[6],
-            TmpGuid->Data4[7]
-            );
-          ArgumentString = ValueBuffer;
+          ArgumentString = BasePrintLibGuidToString (ValueBuffer, TmpGuid);
         }
         break;
 
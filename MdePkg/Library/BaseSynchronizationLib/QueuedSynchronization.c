@@ -0,0 +1,383 @@
+/** @file
+  Queued spin locks and a lock-free queue built on the interlocked primitives.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseSynchronizationLibInternals.h"
+
+/**
+  Initializes a ticket lock to the released state and returns the ticket lock.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to initialize to the
+                      released state.
+
+  @return TicketLock in release state.
+
+**/
+TICKET_LOCK *
+EFIAPI
+InitializeTicketLock (
+  OUT      TICKET_LOCK               *TicketLock
+  )
+{
+  ASSERT (TicketLock != NULL);
+
+  TicketLock->NextTicket = 0;
+  TicketLock->NowServing = 0;
+  MemoryFence ();
+
+  return TicketLock;
+}
+
+/**
+  Waits until a ticket lock can be placed in the acquired state.
+
+  This function takes the next ticket of TicketLock and waits, with CpuPause(),
+  until that ticket is served. Processors are granted the lock in the order in
+  which they called this function.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired
+                      state.
+
+  @return TicketLock acquired the lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+AcquireTicketLock (
+  IN OUT  TICKET_LOCK               *TicketLock
+  )
+{
+  UINT32  Ticket;
+
+  ASSERT (TicketLock != NULL);
+
+  Ticket = InterlockedIncrement (&TicketLock->NextTicket) - 1;
+  while (TicketLock->NowServing != Ticket) {
+    CpuPause ();
+  }
+  MemoryFence ();
+
+  return TicketLock;
+}
+
+/**
+  Attempts to place a ticket lock in the acquired state.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired
+                      state.
+
+  @retval TRUE  TicketLock was placed in the acquired state.
+  @retval FALSE TicketLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireTicketLockOrFail (
+  IN OUT  TICKET_LOCK               *TicketLock
+  )
+{
+  UINT32  Ticket;
+
+  ASSERT (TicketLock != NULL);
+
+  //
+  // The lock is free when the next ticket is the one being served. Take that
+  // ticket only if nobody else took it in the meantime.
+  //
+  Ticket = TicketLock->NowServing;
+  if (InterlockedCompareExchange32 (&TicketLock->NextTicket, Ticket, Ticket + 1) != Ticket) {
+    return FALSE;
+  }
+  MemoryFence ();
+
+  return TRUE;
+}
+
+/**
+  Releases a ticket lock and hands it to the next waiting processor.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to release.
+
+  @return TicketLock released the lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+ReleaseTicketLock (
+  IN OUT  TICKET_LOCK               *TicketLock
+  )
+{
+  ASSERT (TicketLock != NULL);
+  ASSERT (TicketLock->NextTicket != TicketLock->NowServing);
+
+  //
+  // Only the owner writes NowServing, so no interlocked operation is needed.
+  //
+  MemoryFence ();
+  TicketLock->NowServing = TicketLock->NowServing + 1;
+  MemoryFence ();
+
+  return TicketLock;
+}
+
+/**
+  Initializes an MCS lock to the released state and returns the MCS lock.
+
+  If McsLock is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to initialize to the released
+                   state.
+
+  @return McsLock in release state.
+
+**/
+MCS_LOCK *
+EFIAPI
+InitializeMcsLock (
+  OUT      MCS_LOCK                  *McsLock
+  )
+{
+  ASSERT (McsLock != NULL);
+
+  *McsLock = NULL;
+  MemoryFence ();
+
+  return McsLock;
+}
+
+/**
+  Waits until an MCS lock can be placed in the acquired state.
+
+  The caller provides a queue node that must stay valid, and must not be used
+  for another lock, until the matching ReleaseMcsLock(). The caller spins only
+  on Node while it waits.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to place in the acquired state.
+  @param  Node     The queue node of the calling processor.
+
+  @return McsLock acquired the lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+AcquireMcsLock (
+  IN OUT  MCS_LOCK                  *McsLock,
+  IN OUT  MCS_LOCK_NODE             *Node
+  )
+{
+  MCS_LOCK_NODE  *Tail;
+  MCS_LOCK_NODE  *Predecessor;
+
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+
+  Node->Next   = NULL;
+  Node->Locked = TRUE;
+  MemoryFence ();
+
+  //
+  // Append Node to the queue of waiters.
+  //
+  do {
+    Tail        = *McsLock;
+    Predecessor = InterlockedCompareExchangePointer ((VOID **)McsLock, Tail, Node);
+  } while (Predecessor != Tail);
+
+  if (Predecessor != NULL) {
+    Predecessor->Next = Node;
+    while (Node->Locked) {
+      CpuPause ();
+    }
+  }
+  MemoryFence ();
+
+  return McsLock;
+}
+
+/**
+  Releases an MCS lock and hands it to the next waiting processor.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to release.
+  @param  Node     The queue node that was passed to AcquireMcsLock().
+
+  @return McsLock released the lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+ReleaseMcsLock (
+  IN OUT  MCS_LOCK                  *McsLock,
+  IN OUT  MCS_LOCK_NODE             *Node
+  )
+{
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+  ASSERT (*McsLock != NULL);
+
+  MemoryFence ();
+  if (Node->Next == NULL) {
+    //
+    // No known waiter. Release the lock, unless a waiter has just replaced
+    // Node as the tail and is about to link itself behind Node.
+    //
+    if (InterlockedCompareExchangePointer ((VOID **)McsLock, Node, NULL) == Node) {
+      return McsLock;
+    }
+
+    while (Node->Next == NULL) {
+      CpuPause ();
+    }
+  }
+
+  Node->Next->Locked = FALSE;
+  MemoryFence ();
+
+  return McsLock;
+}
+
+/**
+  Initializes an empty single producer, multiple consumer queue.
+
+  If Queue is NULL, then ASSERT().
+  If Entries is NULL, then ASSERT().
+  If Capacity is zero or not a power of two, then ASSERT().
+
+  @param  Queue     A pointer to the queue to initialize.
+  @param  Entries   The storage of the queue, Capacity UINTN values.
+  @param  Capacity  The number of values the queue can hold. Must be a power
+                    of two.
+
+  @return Queue, empty.
+
+**/
+SPMC_QUEUE *
+EFIAPI
+SpmcQueueInitialize (
+  OUT      SPMC_QUEUE                *Queue,
+  IN       UINTN                     *Entries,
+  IN       UINT32                    Capacity
+  )
+{
+  ASSERT (Queue != NULL);
+  ASSERT (Entries != NULL);
+  ASSERT (Capacity != 0);
+  ASSERT ((Capacity & (Capacity - 1)) == 0);
+
+  Queue->Head    = 0;
+  Queue->Tail    = 0;
+  Queue->Mask    = Capacity - 1;
+  Queue->Entries = Entries;
+  MemoryFence ();
+
+  return Queue;
+}
+
+/**
+  Adds a value to the tail of a single producer, multiple consumer queue.
+
+  Only one processor may call this function for a given Queue at a time.
+
+  If Queue is NULL, then ASSERT().
+
+  @param  Queue  A pointer to the queue.
+  @param  Value  The value to add.
+
+  @retval TRUE  Value was added.
+  @retval FALSE The queue is full.
+
+**/
+BOOLEAN
+EFIAPI
+SpmcQueueEnqueue (
+  IN OUT  SPMC_QUEUE                *Queue,
+  IN      UINTN                     Value
+  )
+{
+  UINT32  Tail;
+
+  ASSERT (Queue != NULL);
+
+  Tail = Queue->Tail;
+  if (Tail - Queue->Head > Queue->Mask) {
+    return FALSE;
+  }
+
+  //
+  // Publish the entry before the new tail makes it visible to consumers.
+  //
+  Queue->Entries[Tail & Queue->Mask] = Value;
+  MemoryFence ();
+  Queue->Tail = Tail + 1;
+
+  return TRUE;
+}
+
+/**
+  Removes a value from the head of a single producer, multiple consumer queue.
+
+  Any number of processors may call this function at the same time. Each value
+  is returned to exactly one of them.
+
+  If Queue is NULL, then ASSERT().
+  If Value is NULL, then ASSERT().
+
+  @param  Queue  A pointer to the queue.
+  @param  Value  The value removed.
+
+  @retval TRUE  A value was removed.
+  @retval FALSE The queue is empty.
+
+**/
+BOOLEAN
+EFIAPI
+SpmcQueueDequeue (
+  IN OUT  SPMC_QUEUE                *Queue,
+  OUT     UINTN                     *Value
+  )
+{
+  UINT32  Head;
+  UINTN   Entry;
+
+  ASSERT (Queue != NULL);
+  ASSERT (Value != NULL);
+
+  for ( ; ;) {
+    Head = Queue->Head;
+    MemoryFence ();
+    if (Head == Queue->Tail) {
+      return FALSE;
+    }
+
+    //
+    // Read the entry before claiming it. The producer cannot reuse the slot
+    // while Head still points at it, so the entry is valid if the claim
+    // succeeds.
+    //
+    MemoryFence ();
+    Entry = Queue->Entries[Head & Queue->Mask];
+    if (InterlockedCompareExchange32 (&Queue->Head, Head, Head + 1) == Head) {
+      *Value = Entry;
+      return TRUE;
+    }
+
+    CpuPause ();
+  }
+}
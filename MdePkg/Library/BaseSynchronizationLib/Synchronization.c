@@ -98,8 +98,12 @@ AcquireSpinLock (
   INT64   Cycle;
   INT64   Delta;
 
+  //
+  // Wait for the lock to read as released before trying the compare exchange,
+  // so that waiting processors share the cache line instead of bouncing it.
+  //
   if (PcdGet32 (PcdSpinLockTimeout) == 0) {
-    while (!AcquireSpinLockOrFail (SpinLock)) {
+    while ((*SpinLock != SPIN_LOCK_RELEASED) || !AcquireSpinLockOrFail (SpinLock)) {
       CpuPause ();
     }
   } else if (!AcquireSpinLockOrFail (SpinLock)) {
@@ -132,7 +136,7 @@ AcquireSpinLock (
     }
     Cycle++;
 
-    while (!AcquireSpinLockOrFail (SpinLock)) {
+    while ((*SpinLock != SPIN_LOCK_RELEASED) || !AcquireSpinLockOrFail (SpinLock)) {
       CpuPause ();
       Previous = Current;
       Current  = GetPerformanceCounter();
@@ -9,6 +9,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <PiDxe.h>
 
 #include <Guid/HobList.h>
+#include <Guid/GuidHobIndex.h>      // MU_CHANGE
 
 #include <Library/HobLib.h>
 #include <Library/UefiLib.h>
@@ -16,6 +17,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseMemoryLib.h>
 
 VOID  *mHobList = NULL;
+GUID_HOB_INDEX_TABLE  *mGuidHobIndex = NULL;  // MU_CHANGE
 
 /**
   Returns the pointer to the HOB list.
@@ -47,6 +49,15 @@ GetHobList (
     Status = EfiGetSystemConfigurationTable (&gEfiHobListGuid, &mHobList);
     ASSERT_EFI_ERROR (Status);
     ASSERT (mHobList != NULL);
+
+    // MU_CHANGE [BEGIN] - Use the GUID HOB index of the DXE Core when it exists.
+    Status = EfiGetSystemConfigurationTable (&gMuGuidHobIndexTableGuid, (VOID **) &mGuidHobIndex);
+    if (EFI_ERROR (Status) ||
+        (mGuidHobIndex->Revision < GUID_HOB_INDEX_TABLE_REVISION) ||
+        (mGuidHobIndex->HobList != mHobList)) {
+      mGuidHobIndex = NULL;
+    }
+    // MU_CHANGE [END]
   }
   return mHobList;
 }
@@ -169,6 +180,38 @@ GetNextGuidHob (
   )
 {
   EFI_PEI_HOB_POINTERS  GuidHob;
+  // MU_CHANGE [BEGIN] - Use the GUID HOB index of the DXE Core when it exists.
+  GUID_HOB_INDEX_ENTRY  *Entries;
+  UINT32                Index;
+
+  //
+  // The index only covers the HOB list it was built from. The entries of a
+  // bucket are in HOB list order, so the first matching entry at or after
+  // HobStart is the HOB the walk below would find.
+  //
+  if ((mGuidHobIndex != NULL) &&
+      ((UINTN) HobStart >= (UINTN) mGuidHobIndex->HobList) &&
+      ((UINTN) HobStart <= (UINTN) mGuidHobIndex->HobListEnd)) {
+    Entries = GUID_HOB_INDEX_ENTRIES (mGuidHobIndex);
+    for (Index = GUID_HOB_INDEX_BUCKETS (mGuidHobIndex)[GUID_HOB_INDEX_BUCKET (mGuidHobIndex, Guid)];
+         Index != GUID_HOB_INDEX_NONE;
+         Index = Entries[Index].Next) {
+      GuidHob.Guid = Entries[Index].Hob;
+      if ((UINTN) GuidHob.Raw < (UINTN) HobStart) {
+        continue;
+      }
+
+      //
+      // Skip HOBs that were changed to another type after the index was built.
+      //
+      if ((GuidHob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) &&
+          CompareGuid (Guid, &GuidHob.Guid->Name)) {
+        return GuidHob.Raw;
+      }
+    }
+    return NULL;
+  }
+  // MU_CHANGE [END]
 
   GuidHob.Raw = (UINT8 *) HobStart;
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
@@ -25,73 +25,6 @@ UefiDevicePathLibStrDuplicate (
   return AllocateCopyPool (StrSize (Src), Src);
 }
 
-/**
-
-  Get parameter in a pair of parentheses follow the given node name.
-  For example, given the "Pci(0,1)" and NodeName "Pci", it returns "0,1".
-
-  @param  Str      Device Path Text.
-  @param  NodeName Name of the node.
-
-  @return Parameter text for the node.
-
-**/
-CHAR16 *
-GetParamByNodeName (
-  IN CHAR16 *Str,
-  IN CHAR16 *NodeName
-  )
-{
-  CHAR16  *ParamStr;
-  CHAR16  *StrPointer;
-  UINTN   NodeNameLength;
-  UINTN   ParameterLength;
-
-  //
-  // Check whether the node name matchs
-  //
-  NodeNameLength = StrLen (NodeName);
-  if (StrnCmp (Str, NodeName, NodeNameLength) != 0) {
-    return NULL;
-  }
-
-  ParamStr = Str + NodeNameLength;
-  if (!IS_LEFT_PARENTH (*ParamStr)) {
-    return NULL;
-  }
-
-  //
-  // Skip the found '(' and find first occurrence of ')'
-  //
-  ParamStr++;
-  ParameterLength = 0;
-  StrPointer = ParamStr;
-  while (!IS_NULL (*StrPointer)) {
-    if (IS_RIGHT_PARENTH (*StrPointer)) {
-      break;
-    }
-    StrPointer++;
-    ParameterLength++;
-  }
-  if (IS_NULL (*StrPointer)) {
-    //
-    // ')' not found
-    //
-    return NULL;
-  }
-
-  ParamStr = AllocateCopyPool ((ParameterLength + 1) * sizeof (CHAR16), ParamStr);
-  if (ParamStr == NULL) {
-    return NULL;
-  }
-  //
-  // Terminate the parameter string
-  //
-  ParamStr[ParameterLength] = L'\0';
-
-  return ParamStr;
-}
-
 /**
   Gets current sub-string from a string list, before return
   the list header is moved to next sub-string. The sub-string is separated
@@ -3547,6 +3480,154 @@ GLOBAL_REMOVE_IF_UNREFERENCED DEVICE_PATH_FROM_TEXT_TABLE mUefiDevicePathLibDevP
   {NULL, NULL}
 };
 
+//
+// Lazily built chained hash index over mUefiDevicePathLibDevPathFromTextTable,
+// keyed by node name. Entries hold table index + 1; 0 ends a chain.
+//
+STATIC UINT8    mDevPathFromTextHashHead[DEVICE_PATH_FROM_TEXT_BUCKETS];
+STATIC UINT8    mDevPathFromTextHashNext[ARRAY_SIZE (mUefiDevicePathLibDevPathFromTextTable)];
+STATIC BOOLEAN  mDevPathFromTextHashReady = FALSE;
+
+/**
+  Hash a device node name (FNV-1a) into a FromText bucket.
+
+  @param  Name        The node name; it need not be Null-terminated.
+  @param  NameLength  The number of characters in Name.
+
+  @return The bucket index.
+
+**/
+STATIC
+UINTN
+DevPathFromTextHash (
+  IN CONST CHAR16  *Name,
+  IN UINTN         NameLength
+  )
+{
+  UINT32  Hash;
+  UINTN   Index;
+
+  Hash = 0x811C9DC5;
+  for (Index = 0; Index < NameLength; Index++) {
+    Hash = (Hash ^ Name[Index]) * 0x01000193;
+  }
+
+  return Hash & (DEVICE_PATH_FROM_TEXT_BUCKETS - 1);
+}
+
+/**
+  Find the FromText table entry whose node name matches the text up to the
+  first '(' of a device node.
+
+  The index is built on first use into locals and then copied out, so a
+  caller that interrupts the build only ever writes the same final values.
+
+  @param  DeviceNodeStr  The text of one device node.
+
+  @return Index of the matching entry, or the index of the terminating
+          NULL entry if no node name matches.
+
+**/
+STATIC
+UINTN
+DevPathFromTextFindEntry (
+  IN CONST CHAR16  *DeviceNodeStr
+  )
+{
+  UINT8   Head[DEVICE_PATH_FROM_TEXT_BUCKETS];
+  UINT8   Next[ARRAY_SIZE (mUefiDevicePathLibDevPathFromTextTable)];
+  CHAR16  *Name;
+  UINTN   NameLength;
+  UINTN   Bucket;
+  UINTN   Index;
+
+  if (!mDevPathFromTextHashReady) {
+    ZeroMem (Head, sizeof (Head));
+    ZeroMem (Next, sizeof (Next));
+    //
+    // Insert in reverse so each chain keeps table order and the first match wins.
+    //
+    for (Index = ARRAY_SIZE (mUefiDevicePathLibDevPathFromTextTable) - 1; Index > 0; Index--) {
+      Name   = mUefiDevicePathLibDevPathFromTextTable[Index - 1].DevicePathNodeText;
+      Bucket = DevPathFromTextHash (Name, StrLen (Name));
+      Next[Index - 1] = Head[Bucket];
+      Head[Bucket]    = (UINT8) Index;
+    }
+
+    CopyMem (mDevPathFromTextHashHead, Head, sizeof (Head));
+    CopyMem (mDevPathFromTextHashNext, Next, sizeof (Next));
+    mDevPathFromTextHashReady = TRUE;
+  }
+
+  NameLength = 0;
+  while (!IS_NULL (DeviceNodeStr[NameLength]) && !IS_LEFT_PARENTH (DeviceNodeStr[NameLength])) {
+    NameLength++;
+  }
+
+  Index = mDevPathFromTextHashHead[DevPathFromTextHash (DeviceNodeStr, NameLength)];
+  while (Index != 0) {
+    Name = mUefiDevicePathLibDevPathFromTextTable[Index - 1].DevicePathNodeText;
+    if ((StrnCmp (DeviceNodeStr, Name, NameLength) == 0) && IS_NULL (Name[NameLength])) {
+      return Index - 1;
+    }
+
+    Index = mDevPathFromTextHashNext[Index - 1];
+  }
+
+  return ARRAY_SIZE (mUefiDevicePathLibDevPathFromTextTable) - 1;
+}
+
+/**
+  Convert the text of one device node to its binary representation.
+
+  The parameter text is Null-terminated in place, so no copy of it is made.
+
+  @param DeviceNodeStr   The text of one device node. It is modified.
+
+  @return A pointer to the EFI device node or NULL if there was insufficient
+          memory or text unsupported.
+
+**/
+STATIC
+EFI_DEVICE_PATH_PROTOCOL *
+DevPathFromTextNodeWorker (
+  IN OUT CHAR16  *DeviceNodeStr
+  )
+{
+  DEVICE_PATH_FROM_TEXT    FromText;
+  CHAR16                   *ParamStr;
+  CHAR16                   *StrPointer;
+  UINTN                    Index;
+
+  FromText = NULL;
+  ParamStr = NULL;
+  Index    = DevPathFromTextFindEntry (DeviceNodeStr);
+  if (mUefiDevicePathLibDevPathFromTextTable[Index].Function != NULL) {
+    //
+    // Skip the node name and '(' and terminate the parameter at the first ')'
+    //
+    ParamStr   = DeviceNodeStr + StrLen (mUefiDevicePathLibDevPathFromTextTable[Index].DevicePathNodeText) + 1;
+    StrPointer = ParamStr;
+    while (!IS_NULL (*StrPointer) && !IS_RIGHT_PARENTH (*StrPointer)) {
+      StrPointer++;
+    }
+
+    if (IS_RIGHT_PARENTH (*StrPointer)) {
+      *StrPointer = L'\0';
+      FromText    = mUefiDevicePathLibDevPathFromTextTable[Index].Function;
+    }
+  }
+
+  if (FromText == NULL) {
+    //
+    // A file path
+    //
+    return DevPathFromTextFilePath (DeviceNodeStr);
+  }
+
+  return FromText (ParamStr);
+}
+
 /**
   Convert text to the binary representation of a device node.
 
@@ -3564,45 +3645,66 @@ UefiDevicePathLibConvertTextToDeviceNode (
   IN CONST CHAR16 *TextDeviceNode
   )
 {
-  DEVICE_PATH_FROM_TEXT    FromText;
-  CHAR16                   *ParamStr;
   EFI_DEVICE_PATH_PROTOCOL *DeviceNode;
   CHAR16                   *DeviceNodeStr;
-  UINTN                    Index;
 
   if ((TextDeviceNode == NULL) || (IS_NULL (*TextDeviceNode))) {
     return NULL;
   }
 
-  ParamStr      = NULL;
-  FromText      = NULL;
   DeviceNodeStr = UefiDevicePathLibStrDuplicate (TextDeviceNode);
   ASSERT (DeviceNodeStr != NULL);
 
-  for (Index = 0; mUefiDevicePathLibDevPathFromTextTable[Index].Function != NULL; Index++) {
-    ParamStr = GetParamByNodeName (DeviceNodeStr, mUefiDevicePathLibDevPathFromTextTable[Index].DevicePathNodeText);
-    if (ParamStr != NULL) {
-      FromText = mUefiDevicePathLibDevPathFromTextTable[Index].Function;
-      break;
-    }
-  }
-
-  if (FromText == NULL) {
-    //
-    // A file path
-    //
-    FromText = DevPathFromTextFilePath;
-    DeviceNode = FromText (DeviceNodeStr);
-  } else {
-    DeviceNode = FromText (ParamStr);
-    FreePool (ParamStr);
-  }
+  DeviceNode = DevPathFromTextNodeWorker (DeviceNodeStr);
 
   FreePool (DeviceNodeStr);
 
   return DeviceNode;
 }
 
+/**
+  Append a device node to a device path under construction, growing the
+  buffer geometrically.
+
+  @param DevicePath      The device path being built, without an end node.
+  @param Size            The number of bytes in use in DevicePath.
+  @param Capacity        The size of DevicePath in bytes.
+  @param DeviceNode      The node to append.
+
+  @retval TRUE   The node was appended.
+  @retval FALSE  There was insufficient memory.
+
+**/
+STATIC
+BOOLEAN
+DevPathFromTextAppendNode (
+  IN OUT UINT8                           **DevicePath,
+  IN OUT UINTN                           *Size,
+  IN OUT UINTN                           *Capacity,
+  IN     CONST EFI_DEVICE_PATH_PROTOCOL  *DeviceNode
+  )
+{
+  UINTN  NodeLength;
+  UINTN  NewCapacity;
+  UINT8  *NewDevicePath;
+
+  NodeLength = DevicePathNodeLength (DeviceNode);
+  if (*Size + NodeLength + END_DEVICE_PATH_LENGTH > *Capacity) {
+    NewCapacity   = MAX (*Capacity * 2, *Size + NodeLength + END_DEVICE_PATH_LENGTH);
+    NewDevicePath = ReallocatePool (*Size, NewCapacity, *DevicePath);
+    if (NewDevicePath == NULL) {
+      return FALSE;
+    }
+
+    *DevicePath = NewDevicePath;
+    *Capacity   = NewCapacity;
+  }
+
+  CopyMem (*DevicePath + *Size, DeviceNode, NodeLength);
+  *Size += NodeLength;
+  return TRUE;
+}
+
 /**
   Convert text to the binary representation of a device path.
 
@@ -3622,45 +3724,68 @@ UefiDevicePathLibConvertTextToDevicePath (
   )
 {
   EFI_DEVICE_PATH_PROTOCOL *DeviceNode;
-  EFI_DEVICE_PATH_PROTOCOL *NewDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL EndInstance;
   CHAR16                   *DevicePathStr;
   CHAR16                   *Str;
   CHAR16                   *DeviceNodeStr;
   BOOLEAN                  IsInstanceEnd;
-  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  BOOLEAN                  Appended;
+  UINT8                    *DevicePath;
+  UINTN                    Size;
+  UINTN                    Capacity;
 
   if ((TextDevicePath == NULL) || (IS_NULL (*TextDevicePath))) {
     return NULL;
   }
 
-  DevicePath = (EFI_DEVICE_PATH_PROTOCOL *) AllocatePool (END_DEVICE_PATH_LENGTH);
-  ASSERT (DevicePath != NULL);
-  SetDevicePathEndNode (DevicePath);
+  //
+  // Nodes are appended to one buffer that grows geometrically instead of
+  // reallocating the whole device path for every node.
+  //
+  Size       = 0;
+  Capacity   = MAX (StrLen (TextDevicePath) * sizeof (CHAR16), END_DEVICE_PATH_LENGTH);
+  DevicePath = AllocatePool (Capacity);
+  if (DevicePath == NULL) {
+    return NULL;
+  }
+
+  SetDevicePathEndNode (&EndInstance);
+  EndInstance.SubType = END_INSTANCE_DEVICE_PATH_SUBTYPE;
 
   DevicePathStr = UefiDevicePathLibStrDuplicate (TextDevicePath);
+  if (DevicePathStr == NULL) {
+    FreePool (DevicePath);
+    return NULL;
+  }
 
   Str           = DevicePathStr;
   while ((DeviceNodeStr = GetNextDeviceNodeStr (&Str, &IsInstanceEnd)) != NULL) {
-    DeviceNode = UefiDevicePathLibConvertTextToDeviceNode (DeviceNodeStr);
-
-    NewDevicePath = AppendDevicePathNode (DevicePath, DeviceNode);
-    FreePool (DevicePath);
-    FreePool (DeviceNode);
-    DevicePath = NewDevicePath;
+    DeviceNode = DevPathFromTextNodeWorker (DeviceNodeStr);
+    if (DeviceNode != NULL) {
+      Appended = DevPathFromTextAppendNode (&DevicePath, &Size, &Capacity, DeviceNode);
+      FreePool (DeviceNode);
+      if (!Appended) {
+        FreePool (DevicePath);
+        DevicePath = NULL;
+        break;
+      }
+    }
 
     if (IsInstanceEnd) {
-      DeviceNode = (EFI_DEVICE_PATH_PROTOCOL *) AllocatePool (END_DEVICE_PATH_LENGTH);
-      ASSERT (DeviceNode != NULL);
-      SetDevicePathEndNode (DeviceNode);
-      DeviceNode->SubType = END_INSTANCE_DEVICE_PATH_SUBTYPE;
-
-      NewDevicePath = AppendDevicePathNode (DevicePath, DeviceNode);
-      FreePool (DevicePath);
-      FreePool (DeviceNode);
-      DevicePath = NewDevicePath;
+      if (!DevPathFromTextAppendNode (&DevicePath, &Size, &Capacity, &EndInstance)) {
+        FreePool (DevicePath);
+        DevicePath = NULL;
+        break;
+      }
     }
   }
 
   FreePool (DevicePathStr);
-  return DevicePath;
+
+  if (DevicePath == NULL) {
+    return NULL;
+  }
+
+  SetDevicePathEndNode (DevicePath + Size);
+  return (EFI_DEVICE_PATH_PROTOCOL *) DevicePath;
 }
@@ -18,6 +18,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   @param Fmt             The format string
   @param ...             Variable arguments based on the format string.
 
+  The pool grows geometrically, so building a string from many small pieces
+  costs amortized O(1) copies per piece. If Str tracks a fixed caller buffer,
+  the text that does not fit is dropped and only Str->Count keeps growing.
+
   @return Allocated buffer with the formatted string printed in it.
           The caller must free the allocated buffer. The buffer
           allocation is not packed.
@@ -32,6 +36,7 @@ UefiDevicePathLibCatPrint (
   )
 {
   UINTN   Count;
+  UINTN   Capacity;
   VA_LIST Args;
 
   VA_START (Args, Fmt);
@@ -39,13 +44,20 @@ UefiDevicePathLibCatPrint (
   VA_END(Args);
 
   if ((Str->Count + (Count + 1)) * sizeof (CHAR16) > Str->Capacity) {
-    Str->Capacity = (Str->Count + (Count + 1) * 2) * sizeof (CHAR16);
+    if (Str->CallerBuffer) {
+      Str->Count += Count;
+      return Str->Str;
+    }
+
+    Capacity = MAX (Str->Capacity * 2, DEVICE_PATH_TEXT_MIN_CAPACITY);
+    Capacity = MAX (Capacity, (Str->Count + (Count + 1)) * sizeof (CHAR16));
     Str->Str = ReallocatePool (
                  Str->Count * sizeof (CHAR16),
-                 Str->Capacity,
+                 Capacity,
                  Str->Str
                  );
     ASSERT (Str->Str != NULL);
+    Str->Capacity = Capacity;
   }
   VA_START (Args, Fmt);
   UnicodeVSPrint (&Str->Str[Str->Count], Str->Capacity - Str->Count * sizeof (CHAR16), Fmt, Args);
@@ -959,29 +971,23 @@ DevPathToTextUsbWWID (
 {
   USB_WWID_DEVICE_PATH  *UsbWWId;
   CHAR16                *SerialNumberStr;
-  CHAR16                *NewStr;
-  UINT16                Length;
+  UINTN                 Length;
 
   UsbWWId = DevPath;
 
+  //
+  // The serial number may not be Null-terminated, so bound it by the node length.
+  //
   SerialNumberStr = (CHAR16 *) ((UINT8 *) UsbWWId + sizeof (USB_WWID_DEVICE_PATH));
-  Length = (UINT16) ((DevicePathNodeLength ((EFI_DEVICE_PATH_PROTOCOL *) UsbWWId) - sizeof (USB_WWID_DEVICE_PATH)) / sizeof (CHAR16));
-  if (Length >= 1 && SerialNumberStr [Length - 1] != 0) {
-    //
-    // In case no NULL terminator in SerialNumber, create a new one with NULL terminator
-    //
-    NewStr = AllocateCopyPool ((Length + 1) * sizeof (CHAR16), SerialNumberStr);
-    ASSERT (NewStr != NULL);
-    NewStr [Length] = 0;
-    SerialNumberStr = NewStr;
-  }
+  Length = (DevicePathNodeLength ((EFI_DEVICE_PATH_PROTOCOL *) UsbWWId) - sizeof (USB_WWID_DEVICE_PATH)) / sizeof (CHAR16);
 
   UefiDevicePathLibCatPrint (
     Str,
-    L"UsbWwid(0x%x,0x%x,0x%x,\"%s\")",
+    L"UsbWwid(0x%x,0x%x,0x%x,\"%.*s\")",
     UsbWWId->VendorId,
     UsbWWId->ProductId,
     UsbWWId->InterfaceNumber,
+    Length,
     SerialNumberStr
     );
 }
@@ -1790,20 +1796,13 @@ DevPathToTextUri (
 {
   URI_DEVICE_PATH    *Uri;
   UINTN              UriLength;
-  CHAR8              *UriStr;
 
   //
   // Uri in the device path may not be null terminated.
   //
   Uri       = DevPath;
   UriLength = DevicePathNodeLength (Uri) - sizeof (URI_DEVICE_PATH);
-  UriStr = AllocatePool (UriLength + 1);
-  ASSERT (UriStr != NULL);
-
-  CopyMem (UriStr, Uri->Uri, UriLength);
-  UriStr[UriLength] = '\0';
-  UefiDevicePathLibCatPrint (Str, L"Uri(%a)", UriStr);
-  FreePool (UriStr);
+  UefiDevicePathLibCatPrint (Str, L"Uri(%.*a)", UriLength, Uri->Uri);
 }
 
 /**
@@ -2315,6 +2314,90 @@ GLOBAL_REMOVE_IF_UNREFERENCED const DEVICE_PATH_TO_TEXT_TABLE mUefiDevicePathLib
   {0, 0, NULL}
 };
 
+//
+// Lazily built chained hash index over mUefiDevicePathLibToTextTable, keyed
+// by node type and subtype. Entries hold table index + 1; 0 ends a chain.
+//
+STATIC UINT8    mDevPathToTextHashHead[DEVICE_PATH_TO_TEXT_BUCKETS];
+STATIC UINT8    mDevPathToTextHashNext[ARRAY_SIZE (mUefiDevicePathLibToTextTable)];
+STATIC BOOLEAN  mDevPathToTextHashReady = FALSE;
+
+/**
+  Hash a device node type and subtype into a ToText bucket.
+
+  @param Type     The device node type.
+  @param SubType  The device node subtype.
+
+  @return The bucket index.
+
+**/
+STATIC
+UINTN
+DevPathToTextHash (
+  IN UINT8  Type,
+  IN UINT8  SubType
+  )
+{
+  return ((UINTN) Type * 33 + SubType) & (DEVICE_PATH_TO_TEXT_BUCKETS - 1);
+}
+
+/**
+  Find the function that converts a device node to text.
+
+  The index is built on first use into locals and then copied out, so a
+  caller that interrupts the build only ever writes the same final values.
+
+  @param Node  The device node.
+
+  @return The ToText handler, or DevPathToTextNodeGeneric if the node type
+          is not in mUefiDevicePathLibToTextTable.
+
+**/
+STATIC
+DEVICE_PATH_TO_TEXT
+DevPathToTextGetHandler (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *Node
+  )
+{
+  UINT8  Head[DEVICE_PATH_TO_TEXT_BUCKETS];
+  UINT8  Next[ARRAY_SIZE (mUefiDevicePathLibToTextTable)];
+  UINTN  Bucket;
+  UINTN  Index;
+
+  if (!mDevPathToTextHashReady) {
+    ZeroMem (Head, sizeof (Head));
+    ZeroMem (Next, sizeof (Next));
+    //
+    // Insert in reverse so each chain keeps table order and the first match wins.
+    //
+    for (Index = ARRAY_SIZE (mUefiDevicePathLibToTextTable) - 1; Index > 0; Index--) {
+      Bucket = DevPathToTextHash (
+                 mUefiDevicePathLibToTextTable[Index - 1].Type,
+                 mUefiDevicePathLibToTextTable[Index - 1].SubType
+                 );
+      Next[Index - 1] = Head[Bucket];
+      Head[Bucket]    = (UINT8) Index;
+    }
+
+    CopyMem (mDevPathToTextHashHead, Head, sizeof (Head));
+    CopyMem (mDevPathToTextHashNext, Next, sizeof (Next));
+    mDevPathToTextHashReady = TRUE;
+  }
+
+  Index = mDevPathToTextHashHead[DevPathToTextHash (DevicePathType (Node), DevicePathSubType (Node))];
+  while (Index != 0) {
+    if (DevicePathType (Node) == mUefiDevicePathLibToTextTable[Index - 1].Type &&
+        DevicePathSubType (Node) == mUefiDevicePathLibToTextTable[Index - 1].SubType
+        ) {
+      return mUefiDevicePathLibToTextTable[Index - 1].Function;
+    }
+
+    Index = mDevPathToTextHashNext[Index - 1];
+  }
+
+  return DevPathToTextNodeGeneric;
+}
+
 /**
   Converts a device node to its string representation.
 
@@ -2339,7 +2422,6 @@ UefiDevicePathLibConvertDeviceNodeToText (
   )
 {
   POOL_PRINT          Str;
-  UINTN               Index;
   DEVICE_PATH_TO_TEXT ToText;
 
   if (DeviceNode == NULL) {
@@ -2352,15 +2434,7 @@ UefiDevicePathLibConvertDeviceNodeToText (
   // Process the device path node
   // If not found, use a generic function
   //
-  ToText = DevPathToTextNodeGeneric;
-  for (Index = 0; mUefiDevicePathLibToTextTable[Index].Function != NULL; Index++) {
-    if (DevicePathType (DeviceNode) == mUefiDevicePathLibToTextTable[Index].Type &&
-        DevicePathSubType (DeviceNode) == mUefiDevicePathLibToTextTable[Index].SubType
-        ) {
-      ToText = mUefiDevicePathLibToTextTable[Index].Function;
-      break;
-    }
-  }
+  ToText = DevPathToTextGetHandler (DeviceNode);
 
   //
   // Print this node
@@ -2372,8 +2446,12 @@ UefiDevicePathLibConvertDeviceNodeToText (
 }
 
 /**
-  Converts a device path to its text representation.
+  Append the text representation of every node of a device path to Str.
+
+  Nodes that are not 8-byte aligned are realigned on the stack, or in pool
+  if they are larger than DEVICE_PATH_NODE_STACK_SIZE.
 
+  @param Str             The string representative being built.
   @param DevicePath      A Pointer to the device to be converted.
   @param DisplayOnly     If DisplayOnly is TRUE, then the shorter text representation
                          of the display node is used, where applicable. If DisplayOnly
@@ -2382,30 +2460,22 @@ UefiDevicePathLibConvertDeviceNodeToText (
   @param AllowShortcuts  If AllowShortcuts is TRUE, then the shortcut forms of text
                          representation for a device node can be used, where applicable.
 
-  @return A pointer to the allocated text representation of the device path or
-          NULL if DeviceNode is NULL or there was insufficient memory.
-
 **/
-CHAR16 *
-EFIAPI
-UefiDevicePathLibConvertDevicePathToText (
+STATIC
+VOID
+DevPathToTextWorker (
+  IN OUT POOL_PRINT                   *Str,
   IN CONST EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
   IN BOOLEAN                          DisplayOnly,
   IN BOOLEAN                          AllowShortcuts
   )
 {
-  POOL_PRINT               Str;
   EFI_DEVICE_PATH_PROTOCOL *Node;
   EFI_DEVICE_PATH_PROTOCOL *AlignedNode;
-  UINTN                    Index;
+  UINT64                   NodeBuffer[DEVICE_PATH_NODE_STACK_SIZE / sizeof (UINT64)];
+  UINTN                    NodeLength;
   DEVICE_PATH_TO_TEXT      ToText;
 
-  if (DevicePath == NULL) {
-    return NULL;
-  }
-
-  ZeroMem (&Str, sizeof (Str));
-
   //
   // Process each device path node
   //
@@ -2415,37 +2485,74 @@ UefiDevicePathLibConvertDevicePathToText (
     // Find the handler to dump this device path node
     // If not found, use a generic function
     //
-    ToText = DevPathToTextNodeGeneric;
-    for (Index = 0; mUefiDevicePathLibToTextTable[Index].Function != NULL; Index += 1) {
-
-      if (DevicePathType (Node) == mUefiDevicePathLibToTextTable[Index].Type &&
-          DevicePathSubType (Node) == mUefiDevicePathLibToTextTable[Index].SubType
-          ) {
-        ToText = mUefiDevicePathLibToTextTable[Index].Function;
-        break;
-      }
-    }
+    ToText = DevPathToTextGetHandler (Node);
+
     //
     //  Put a path separator in if needed
     //
-    if ((Str.Count != 0) && (ToText != DevPathToTextEndInstance)) {
-      if (Str.Str[Str.Count] != L',') {
-        UefiDevicePathLibCatPrint (&Str, L"/");
+    if ((Str->Count != 0) && (ToText != DevPathToTextEndInstance)) {
+      if ((Str->Count * sizeof (CHAR16) >= Str->Capacity) || (Str->Str[Str->Count] != L',')) {
+        UefiDevicePathLibCatPrint (Str, L"/");
       }
     }
 
-    AlignedNode = AllocateCopyPool (DevicePathNodeLength (Node), Node);
+    NodeLength = DevicePathNodeLength (Node);
+    if (((UINTN) Node & (sizeof (UINT64) - 1)) == 0) {
+      AlignedNode = Node;
+    } else if (NodeLength <= sizeof (NodeBuffer)) {
+      AlignedNode = CopyMem (NodeBuffer, Node, NodeLength);
+    } else {
+      AlignedNode = AllocateCopyPool (NodeLength, Node);
+      ASSERT (AlignedNode != NULL);
+    }
+
     //
     // Print this node of the device path
     //
-    ToText (&Str, AlignedNode, DisplayOnly, AllowShortcuts);
-    FreePool (AlignedNode);
+    ToText (Str, AlignedNode, DisplayOnly, AllowShortcuts);
+    if ((AlignedNode != Node) && (AlignedNode != (VOID *) NodeBuffer)) {
+      FreePool (AlignedNode);
+    }
 
     //
     // Next device path node
     //
     Node = NextDevicePathNode (Node);
   }
+}
+
+/**
+  Converts a device path to its text representation.
+
+  @param DevicePath      A Pointer to the device to be converted.
+  @param DisplayOnly     If DisplayOnly is TRUE, then the shorter text representation
+                         of the display node is used, where applicable. If DisplayOnly
+                         is FALSE, then the longer text representation of the display node
+                         is used.
+  @param AllowShortcuts  If AllowShortcuts is TRUE, then the shortcut forms of text
+                         representation for a device node can be used, where applicable.
+
+  @return A pointer to the allocated text representation of the device path or
+          NULL if DeviceNode is NULL or there was insufficient memory.
+
+**/
+CHAR16 *
+EFIAPI
+UefiDevicePathLibConvertDevicePathToText (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN BOOLEAN                          DisplayOnly,
+  IN BOOLEAN                          AllowShortcuts
+  )
+{
+  POOL_PRINT               Str;
+
+  if (DevicePath == NULL) {
+    return NULL;
+  }
+
+  ZeroMem (&Str, sizeof (Str));
+
+  DevPathToTextWorker (&Str, DevicePath, DisplayOnly, AllowShortcuts);
 
   if (Str.Str == NULL) {
     return AllocateZeroPool (sizeof (CHAR16));
@@ -2453,3 +2560,63 @@ UefiDevicePathLibConvertDevicePathToText (
     return Str.Str;
   }
 }
+
+/**
+  Converts a device path to its text representation in a caller supplied buffer.
+
+  No memory is allocated unless the device path holds a node that is both
+  misaligned and larger than DEVICE_PATH_NODE_STACK_SIZE.
+
+  @param DevicePath      A Pointer to the device to be converted.
+  @param DisplayOnly     If DisplayOnly is TRUE, then the shorter text representation
+                         of the display node is used, where applicable. If DisplayOnly
+                         is FALSE, then the longer text representation of the display node
+                         is used.
+  @param AllowShortcuts  If AllowShortcuts is TRUE, then the shortcut forms of text
+                         representation for a device node can be used, where applicable.
+  @param Buffer          The buffer that receives the Null-terminated text.
+  @param BufferSize      On input, the size of Buffer in bytes. On output, the size
+                         in bytes needed to hold the complete text.
+
+  @retval EFI_SUCCESS            The text was written to Buffer.
+  @retval EFI_BUFFER_TOO_SMALL   Buffer is too small. BufferSize holds the required size.
+  @retval EFI_INVALID_PARAMETER  DevicePath or BufferSize is NULL, or Buffer is NULL
+                                 and BufferSize is not zero.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiDevicePathLibConvertDevicePathToTextBuffer (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN BOOLEAN                          DisplayOnly,
+  IN BOOLEAN                          AllowShortcuts,
+  OUT CHAR16                          *Buffer,
+  IN OUT UINTN                        *BufferSize
+  )
+{
+  POOL_PRINT  Str;
+  UINTN       RequiredSize;
+
+  if ((DevicePath == NULL) || (BufferSize == NULL) || ((Buffer == NULL) && (*BufferSize != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Str.Str          = Buffer;
+  Str.Count        = 0;
+  Str.Capacity     = *BufferSize;
+  Str.CallerBuffer = TRUE;
+  if (Str.Capacity >= sizeof (CHAR16)) {
+    Buffer[0] = L'\0';
+  }
+
+  DevPathToTextWorker (&Str, DevicePath, DisplayOnly, AllowShortcuts);
+
+  RequiredSize = (Str.Count + 1) * sizeof (CHAR16);
+  if (RequiredSize > *BufferSize) {
+    *BufferSize = RequiredSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *BufferSize = RequiredSize;
+  return EFI_SUCCESS;
+}
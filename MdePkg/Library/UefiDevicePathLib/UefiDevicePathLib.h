@@ -32,6 +32,24 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define IS_SLASH(a)                ((a) == L'/')
 #define IS_NULL(a)                 ((a) == L'\0')
 
+//
+// Minimum size in bytes of a growable POOL_PRINT buffer. Growth beyond this
+// doubles the capacity so that appending N nodes costs O(N) copies overall.
+//
+#define DEVICE_PATH_TEXT_MIN_CAPACITY    (64 * sizeof (CHAR16))
+
+//
+// Nodes up to this size that need realigning are copied to the stack rather
+// than to pool.
+//
+#define DEVICE_PATH_NODE_STACK_SIZE      256
+
+//
+// Bucket counts of the lazily built lookup indexes over the ToText and
+// FromText tables. Both must be powers of two.
+//
+#define DEVICE_PATH_TO_TEXT_BUCKETS      64
+#define DEVICE_PATH_FROM_TEXT_BUCKETS    128
 
 //
 // Private Data structure
@@ -40,6 +58,11 @@ typedef struct {
   CHAR16  *Str;
   UINTN   Count;
   UINTN   Capacity;
+  //
+  // TRUE if Str is a fixed caller buffer of Capacity bytes. Count keeps
+  // growing past Capacity so the caller learns the required size.
+  //
+  BOOLEAN CallerBuffer;
 } POOL_PRINT;
 
 typedef
@@ -390,6 +413,36 @@ UefiDevicePathLibConvertDevicePathToText (
   IN BOOLEAN                          AllowShortcuts
   );
 
+/**
+  Converts a device path to its text representation in a caller supplied buffer.
+
+  @param DevicePath      A Pointer to the device to be converted.
+  @param DisplayOnly     If DisplayOnly is TRUE, then the shorter text representation
+                         of the display node is used, where applicable. If DisplayOnly
+                         is FALSE, then the longer text representation of the display node
+                         is used.
+  @param AllowShortcuts  If AllowShortcuts is TRUE, then the shortcut forms of text
+                         representation for a device node can be used, where applicable.
+  @param Buffer          The buffer that receives the Null-terminated text.
+  @param BufferSize      On input, the size of Buffer in bytes. On output, the size
+                         in bytes needed to hold the complete text.
+
+  @retval EFI_SUCCESS            The text was written to Buffer.
+  @retval EFI_BUFFER_TOO_SMALL   Buffer is too small. BufferSize holds the required size.
+  @retval EFI_INVALID_PARAMETER  DevicePath or BufferSize is NULL, or Buffer is NULL
+                                 and BufferSize is not zero.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiDevicePathLibConvertDevicePathToTextBuffer (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN BOOLEAN                          DisplayOnly,
+  IN BOOLEAN                          AllowShortcuts,
+  OUT CHAR16                          *Buffer,
+  IN OUT UINTN                        *BufferSize
+  );
+
 /**
   Converts a device node to its string representation.
 
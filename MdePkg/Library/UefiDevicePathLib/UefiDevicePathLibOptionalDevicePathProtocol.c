@@ -421,6 +421,96 @@ ConvertDevicePathToText (
   return UefiDevicePathLibConvertDevicePathToText (DevicePath, DisplayOnly, AllowShortcuts);
 }
 
+/**
+  Copy text produced by the DevicePathToText protocol to a caller buffer and
+  free it.
+
+  @param Text        The text from the protocol, or NULL on failure.
+  @param Buffer      The buffer that receives the Null-terminated text.
+  @param BufferSize  On input, the size of Buffer in bytes. On output, the size
+                     in bytes needed to hold the complete text.
+
+  @retval EFI_SUCCESS            The text was copied to Buffer.
+  @retval EFI_BUFFER_TOO_SMALL   Buffer is too small. BufferSize holds the required size.
+  @retval EFI_OUT_OF_RESOURCES   Text is NULL.
+
+**/
+STATIC
+EFI_STATUS
+UefiDevicePathLibCopyTextToBuffer (
+  IN     CHAR16  *Text,
+  OUT    CHAR16  *Buffer,
+  IN OUT UINTN   *BufferSize
+  )
+{
+  UINTN  TextSize;
+
+  if (Text == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  TextSize = StrSize (Text);
+  if (TextSize > *BufferSize) {
+    FreePool (Text);
+    *BufferSize = TextSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem (Buffer, Text, TextSize);
+  FreePool (Text);
+  *BufferSize = TextSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Converts a device path to its text representation in a caller supplied buffer.
+
+  @param DevicePath      A Pointer to the device to be converted.
+  @param DisplayOnly     If DisplayOnly is TRUE, then the shorter text representation
+                         of the display node is used, where applicable. If DisplayOnly
+                         is FALSE, then the longer text representation of the display node
+                         is used.
+  @param AllowShortcuts  If AllowShortcuts is TRUE, then the shortcut forms of text
+                         representation for a device node can be used, where applicable.
+  @param Buffer          The buffer that receives the Null-terminated text.
+  @param BufferSize      On input, the size of Buffer in bytes. On output, the size
+                         in bytes needed to hold the complete text.
+
+  @retval EFI_SUCCESS            The text was written to Buffer.
+  @retval EFI_BUFFER_TOO_SMALL   Buffer is too small. BufferSize holds the required size.
+  @retval EFI_INVALID_PARAMETER  DevicePath or BufferSize is NULL, or Buffer is NULL
+                                 and BufferSize is not zero.
+  @retval EFI_OUT_OF_RESOURCES   The text could not be generated.
+
+**/
+EFI_STATUS
+EFIAPI
+ConvertDevicePathToTextBuffer (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL   *DevicePath,
+  IN BOOLEAN                          DisplayOnly,
+  IN BOOLEAN                          AllowShortcuts,
+  OUT CHAR16                          *Buffer,
+  IN OUT UINTN                        *BufferSize
+  )
+{
+  if ((DevicePath == NULL) || (BufferSize == NULL) || ((Buffer == NULL) && (*BufferSize != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (mDevicePathLibDevicePathToText == NULL) {
+    mDevicePathLibDevicePathToText = UefiDevicePathLibLocateProtocol (&gEfiDevicePathToTextProtocolGuid);
+  }
+  if (mDevicePathLibDevicePathToText != NULL) {
+    return UefiDevicePathLibCopyTextToBuffer (
+             mDevicePathLibDevicePathToText->ConvertDevicePathToText (DevicePath, DisplayOnly, AllowShortcuts),
+             Buffer,
+             BufferSize
+             );
+  }
+
+  return UefiDevicePathLibConvertDevicePathToTextBuffer (DevicePath, DisplayOnly, AllowShortcuts, Buffer, BufferSize);
+}
+
 /**
   Convert text to the binary representation of a device node.
 
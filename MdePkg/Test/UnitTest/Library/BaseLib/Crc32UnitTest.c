@@ -0,0 +1,371 @@
+/** @file
+  Conformance tests and throughput measurements of CalculateCrc32() in BaseLib.
+
+  The conformance tests check CalculateCrc32() against known CRC32 values and
+  against a bit at a time reference, over lengths and alignments that reach
+  every path of the slice-by-8 and PCLMULQDQ methods. The benchmark logs the
+  time stamp counter ticks per KB for several buffer sizes. Build the
+  application once with PcdFastCrc32Enable FALSE and once with it TRUE to
+  compare the methods.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "BaseLib CRC32 Unit Test Application"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define CRC32_TEST_MAX_SIZE          SIZE_1MB
+
+//
+// The buffer has room for starting the data at any offset within 16 bytes.
+//
+#define CRC32_TEST_BUFFER_SIZE       (CRC32_TEST_MAX_SIZE + 16)
+
+//
+// Each size is timed over about this many bytes.
+//
+#define CRC32_BENCHMARK_BYTES_PER_SIZE  SIZE_64MB
+
+typedef struct {
+  CHAR8   *Data;
+  UINT32  Crc32;
+} CRC32_TEST_VECTOR;
+
+typedef struct {
+  CHAR8  *Description;
+  CHAR8  *ClassName;
+  UINTN  Size;
+} CRC32_BENCHMARK_CONTEXT;
+
+UINT8  *mCrc32Buffer = NULL;
+
+CRC32_TEST_VECTOR  mCrc32TestVectors[] = {
+  { "",                                            0x00000000 },
+  { "a",                                           0xE8B7BE43 },
+  { "123456789",                                   0xCBF43926 },
+  { "The quick brown fox jumps over the lazy dog", 0x414FA339 }
+};
+
+//
+// Lengths above the byte by byte range, around the 64-byte folding block and
+// the size from which PCLMULQDQ is used.
+//
+UINTN  mCrc32TestLengths[] = {
+  1023, 1024, 1025, 1087, 1088, 1103, 4096, 4099, 65536 + 15, CRC32_TEST_MAX_SIZE
+};
+
+CRC32_BENCHMARK_CONTEXT  mCrc32BenchmarkContext[] = {
+  { "64 bytes",  "Size64",    64         },
+  { "512 bytes", "Size512",   512        },
+  { "4KB",       "Size4KB",   SIZE_4KB   },
+  { "64KB",      "Size64KB",  SIZE_64KB  },
+  { "1MB",       "Size1MB",   SIZE_1MB   }
+};
+
+/**
+  Fill a buffer with a pseudo random pattern.
+
+  @param[out] Buffer    The buffer to fill.
+  @param[in]  Length    The length of the buffer.
+**/
+STATIC
+VOID
+FillPattern (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Length
+  )
+{
+  UINTN   Index;
+  UINT32  Seed;
+
+  Seed = 0x12345678;
+  for (Index = 0; Index < Length; Index++) {
+    Seed          = Seed * 1103515245 + 12345;
+    Buffer[Index] = (UINT8)(Seed >> 16);
+  }
+}
+
+/**
+  Compute the CRC32 of a buffer one bit at a time, independently of the
+  tables that BaseLib uses.
+
+  @param[in]  Buffer    The data.
+  @param[in]  Length    The number of bytes in Buffer.
+
+  @return The CRC32 of Buffer.
+**/
+STATIC
+UINT32
+ReferenceCrc32 (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  UINT32  Crc;
+  UINTN   Index;
+  UINTN   Bit;
+
+  Crc = 0xFFFFFFFF;
+  for (Index = 0; Index < Length; Index++) {
+    Crc ^= Buffer[Index];
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ ((Crc & 1) != 0 ? 0xEDB88320 : 0);
+    }
+  }
+
+  return Crc ^ 0xFFFFFFFF;
+}
+
+/**
+  Check CalculateCrc32() against known CRC32 values.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             All the CRCs matched.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A CRC did not match.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32KnownValuesTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mCrc32TestVectors); Index++) {
+    UT_ASSERT_EQUAL (
+      CalculateCrc32 (mCrc32TestVectors[Index].Data, AsciiStrLen (mCrc32TestVectors[Index].Data)),
+      mCrc32TestVectors[Index].Crc32
+      );
+  }
+
+  //
+  // 4KB of the byte values 0 - 255, aligned and misaligned.
+  //
+  for (Index = 0; Index < SIZE_4KB; Index++) {
+    mCrc32Buffer[Index] = (UINT8)Index;
+  }
+  UT_ASSERT_EQUAL (CalculateCrc32 (mCrc32Buffer, SIZE_4KB), 0xA2912082);
+
+  CopyMem (mCrc32Buffer + 5, mCrc32Buffer, SIZE_4KB);
+  UT_ASSERT_EQUAL (CalculateCrc32 (mCrc32Buffer + 5, SIZE_4KB), 0xA2912082);
+
+  SetMem (mCrc32Buffer, 32, 0x00);
+  UT_ASSERT_EQUAL (CalculateCrc32 (mCrc32Buffer, 32), 0x190A55AD);
+  SetMem (mCrc32Buffer, 32, 0xFF);
+  UT_ASSERT_EQUAL (CalculateCrc32 (mCrc32Buffer, 32), 0xFF6CAB0B);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check CalculateCrc32() against the bit at a time reference for every
+  length up to 300 bytes and for selected larger lengths, at every offset
+  within 16 bytes.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             All the CRCs matched.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A CRC did not match.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32ReferenceTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Offset;
+  UINTN  Length;
+  UINTN  Index;
+
+  FillPattern (mCrc32Buffer, CRC32_TEST_BUFFER_SIZE);
+
+  for (Offset = 0; Offset < 16; Offset++) {
+    for (Length = 0; Length <= 300; Length++) {
+      UT_ASSERT_EQUAL (
+        CalculateCrc32 (mCrc32Buffer + Offset, Length),
+        ReferenceCrc32 (mCrc32Buffer + Offset, Length)
+        );
+    }
+
+    for (Index = 0; Index < ARRAY_SIZE (mCrc32TestLengths); Index++) {
+      UT_ASSERT_EQUAL (
+        CalculateCrc32 (mCrc32Buffer + Offset, mCrc32TestLengths[Index]),
+        ReferenceCrc32 (mCrc32Buffer + Offset, mCrc32TestLengths[Index])
+        );
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Time CalculateCrc32() for one buffer size and log the ticks per KB.
+
+  @param[in]  Context    A CRC32_BENCHMARK_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The CRC matched the reference.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The CRC did not match the reference.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32BenchmarkTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Size;
+  UINTN   Iterations;
+  UINTN   Index;
+  UINT64  Start;
+  UINT64  Ticks;
+
+  Size       = ((CRC32_BENCHMARK_CONTEXT *)Context)->Size;
+  Iterations = MAX (CRC32_BENCHMARK_BYTES_PER_SIZE / Size, 1);
+
+  FillPattern (mCrc32Buffer, Size);
+  UT_ASSERT_EQUAL (CalculateCrc32 (mCrc32Buffer, Size), ReferenceCrc32 (mCrc32Buffer, Size));
+
+  Start = AsmReadTsc ();
+  for (Index = 0; Index < Iterations; Index++) {
+    CalculateCrc32 (mCrc32Buffer, Size);
+  }
+  Ticks = AsmReadTsc () - Start;
+
+  UT_LOG_INFO (
+    "CalculateCrc32 %ld bytes: %ld ticks per KB\n",
+    (UINT64)Size,
+    DivU64x64Remainder (MultU64x32 (Ticks, SIZE_1KB), MultU64x64 (Size, Iterations), NULL)
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  CRC32 function and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Fw;
+  UNIT_TEST_SUITE_HANDLE      Crc32Tests;
+  UNIT_TEST_SUITE_HANDLE      Crc32Benchmark;
+  UINTN                       Index;
+
+  Fw = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  mCrc32Buffer = AllocatePool (CRC32_TEST_BUFFER_SIZE);
+  if (mCrc32Buffer == NULL) {
+    DEBUG ((DEBUG_ERROR, "Failed to allocate the test buffer\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Fw, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the CRC32 conformance unit test suite.
+  //
+  Status = CreateUnitTestSuite (&Crc32Tests, Fw, "CRC32 conformance", "BaseLib.Crc32", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Crc32Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  // --------------Suite-------Description-------------------------Class Name-----------Function--------------Pre---Post---Context---
+  AddTestCase (Crc32Tests, "Known CRC32 values",                   "KnownValues",       Crc32KnownValuesTest, NULL, NULL, NULL);
+  AddTestCase (Crc32Tests, "Lengths and offsets against reference", "Reference",         Crc32ReferenceTest,   NULL, NULL, NULL);
+
+  //
+  // Populate the CRC32 benchmark suite.
+  //
+  Status = CreateUnitTestSuite (&Crc32Benchmark, Fw, "CRC32 throughput", "BaseLib.Crc32.Benchmark", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Crc32Benchmark\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mCrc32BenchmarkContext); Index++) {
+    AddTestCase (
+      Crc32Benchmark,
+      mCrc32BenchmarkContext[Index].Description,
+      mCrc32BenchmarkContext[Index].ClassName,
+      Crc32BenchmarkTest,
+      NULL,
+      NULL,
+      &mCrc32BenchmarkContext[Index]
+      );
+  }
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Fw);
+
+EXIT:
+  if (Fw) {
+    FreeUnitTestFramework (Fw);
+  }
+  if (mCrc32Buffer != NULL) {
+    FreePool (mCrc32Buffer);
+  }
+
+  return Status;
+}
+
+/**
+  Standard UEFI entry point for target based unit test execution from UEFI Shell.
+**/
+EFI_STATUS
+EFIAPI
+BaseLibCrc32UnitTestAppEntry (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return UnitTestingEntry ();
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,311 @@
+/** @file
+  Correctness checks and throughput measurements of the BaseMemoryLib
+  instance that the application is built with.
+
+  Each test case checks CopyMem(), SetMem(), ZeroMem() and CompareMem() for one
+  buffer size against byte by byte references, then logs the time stamp
+  counter ticks per KB of each function. Build the application once per
+  BaseMemoryLib instance to compare them.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "BaseMemoryLib Benchmark Application"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define BENCHMARK_MAX_SIZE         SIZE_16MB
+
+//
+// Each function is timed over about this many bytes.
+//
+#define BENCHMARK_BYTES_PER_SIZE   SIZE_64MB
+
+//
+// The buffers have room for a misaligned start.
+//
+#define BENCHMARK_BUFFER_SIZE      (BENCHMARK_MAX_SIZE + SIZE_4KB)
+#define BENCHMARK_MISALIGNMENT     3
+
+typedef struct {
+  CHAR8  *Description;
+  CHAR8  *ClassName;
+  UINTN  Size;
+} BENCHMARK_CONTEXT;
+
+UINT8              *mSource      = NULL;
+UINT8              *mDestination = NULL;
+
+//
+// Sizes from 16 bytes to 16MB, 4 times apart.
+//
+BENCHMARK_CONTEXT  mBenchmarkContext[] = {
+  { "16 bytes",  "Size16",    16         },
+  { "64 bytes",  "Size64",    64         },
+  { "256 bytes", "Size256",   256        },
+  { "1KB",       "Size1KB",   SIZE_1KB   },
+  { "4KB",       "Size4KB",   SIZE_4KB   },
+  { "16KB",      "Size16KB",  SIZE_16KB  },
+  { "64KB",      "Size64KB",  SIZE_64KB  },
+  { "256KB",     "Size256KB", SIZE_256KB },
+  { "1MB",       "Size1MB",   SIZE_1MB   },
+  { "4MB",       "Size4MB",   SIZE_4MB   },
+  { "16MB",      "Size16MB",  SIZE_16MB  }
+};
+
+/**
+  Fill a buffer with a pattern that depends on the seed.
+
+  @param[out] Buffer    The buffer to fill.
+  @param[in]  Length    The length of the buffer.
+  @param[in]  Seed      The seed of the pattern.
+**/
+STATIC
+VOID
+FillPattern (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Length,
+  IN  UINT8  Seed
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Length; Index++) {
+    Buffer[Index] = (UINT8)(Index * 7 + Seed);
+  }
+}
+
+/**
+  Log the ticks per KB of a run.
+
+  @param[in]  Name        The name of the function.
+  @param[in]  Size        The size of each call.
+  @param[in]  Iterations  The number of calls.
+  @param[in]  Ticks       The time stamp counter ticks of all the calls.
+**/
+STATIC
+VOID
+LogThroughput (
+  IN CONST CHAR8  *Name,
+  IN UINTN        Size,
+  IN UINTN        Iterations,
+  IN UINT64       Ticks
+  )
+{
+  UT_LOG_INFO (
+    "%a %ld bytes: %ld ticks per KB\n",
+    Name,
+    (UINT64)Size,
+    DivU64x64Remainder (MultU64x32 (Ticks, SIZE_1KB), MultU64x64 (Size, Iterations), NULL)
+    );
+}
+
+/**
+  Check and time the memory functions for one buffer size.
+
+  @param[in]  Context    A BENCHMARK_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The functions returned the expected results.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A function returned a wrong result.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MemoryFunctionsTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Size;
+  UINTN   Iterations;
+  UINTN   Index;
+  UINT64  Start;
+  UINT8   *Source;
+  UINT8   *Destination;
+
+  Size        = ((BENCHMARK_CONTEXT *)Context)->Size;
+  Iterations  = MAX (BENCHMARK_BYTES_PER_SIZE / Size, 1);
+  Source      = mSource + BENCHMARK_MISALIGNMENT;
+  Destination = mDestination;
+
+  //
+  // CopyMem(), with a misaligned source, and overlapped in both directions.
+  //
+  FillPattern (mSource, BENCHMARK_BUFFER_SIZE, 1);
+  SetMem (mDestination, BENCHMARK_BUFFER_SIZE, 0x5A);
+  UT_ASSERT_EQUAL ((UINTN)CopyMem (Destination, Source, Size), (UINTN)Destination);
+  for (Index = 0; Index < Size; Index++) {
+    UT_ASSERT_EQUAL (Destination[Index], (UINT8)((Index + BENCHMARK_MISALIGNMENT) * 7 + 1));
+  }
+  UT_ASSERT_EQUAL (Destination[Size], 0x5A);
+
+  FillPattern (mSource, Size + BENCHMARK_MISALIGNMENT, 2);
+  CopyMem (mSource + BENCHMARK_MISALIGNMENT, mSource, Size);
+  for (Index = 0; Index < Size; Index++) {
+    UT_ASSERT_EQUAL (mSource[Index + BENCHMARK_MISALIGNMENT], (UINT8)(Index * 7 + 2));
+  }
+
+  FillPattern (mSource, Size + BENCHMARK_MISALIGNMENT, 3);
+  CopyMem (mSource, mSource + BENCHMARK_MISALIGNMENT, Size);
+  for (Index = 0; Index < Size; Index++) {
+    UT_ASSERT_EQUAL (mSource[Index], (UINT8)((Index + BENCHMARK_MISALIGNMENT) * 7 + 3));
+  }
+
+  //
+  // SetMem() and ZeroMem(), with a misaligned buffer.
+  //
+  SetMem (mDestination, BENCHMARK_BUFFER_SIZE, 0x5A);
+  SetMem (Destination + BENCHMARK_MISALIGNMENT, Size, 0xC3);
+  for (Index = 0; Index < Size; Index++) {
+    UT_ASSERT_EQUAL (Destination[Index + BENCHMARK_MISALIGNMENT], 0xC3);
+  }
+  UT_ASSERT_EQUAL (Destination[BENCHMARK_MISALIGNMENT - 1], 0x5A);
+  UT_ASSERT_EQUAL (Destination[Size + BENCHMARK_MISALIGNMENT], 0x5A);
+
+  ZeroMem (Destination + BENCHMARK_MISALIGNMENT, Size);
+  for (Index = 0; Index < Size; Index++) {
+    UT_ASSERT_EQUAL (Destination[Index + BENCHMARK_MISALIGNMENT], 0);
+  }
+  UT_ASSERT_EQUAL (Destination[Size + BENCHMARK_MISALIGNMENT], 0x5A);
+
+  //
+  // CompareMem(), equal and with a mismatch in the first and the last byte.
+  //
+  FillPattern (Source, Size, 4);
+  FillPattern (Destination, Size, 4);
+  UT_ASSERT_EQUAL (CompareMem (Destination, Source, Size), 0);
+  Destination[Size - 1]++;
+  UT_ASSERT_EQUAL (CompareMem (Destination, Source, Size), 1);
+  Destination[Size - 1]--;
+  Destination[0] -= 2;
+  UT_ASSERT_EQUAL (CompareMem (Destination, Source, Size), -2);
+  Destination[0] += 2;
+
+  //
+  // Time each function.
+  //
+  Start = AsmReadTsc ();
+  for (Index = 0; Index < Iterations; Index++) {
+    CopyMem (Destination, Source, Size);
+  }
+  LogThroughput ("CopyMem", Size, Iterations, AsmReadTsc () - Start);
+
+  Start = AsmReadTsc ();
+  for (Index = 0; Index < Iterations; Index++) {
+    SetMem (Destination, Size, (UINT8)Index);
+  }
+  LogThroughput ("SetMem", Size, Iterations, AsmReadTsc () - Start);
+
+  Start = AsmReadTsc ();
+  for (Index = 0; Index < Iterations; Index++) {
+    ZeroMem (Destination, Size);
+  }
+  LogThroughput ("ZeroMem", Size, Iterations, AsmReadTsc () - Start);
+
+  FillPattern (Destination, Size, 4);
+  Start = AsmReadTsc ();
+  for (Index = 0; Index < Iterations; Index++) {
+    CompareMem (Destination, Source, Size);
+  }
+  LogThroughput ("CompareMem", Size, Iterations, AsmReadTsc () - Start);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Fw;
+  UNIT_TEST_SUITE_HANDLE      BenchmarkTests;
+  UINTN                       Index;
+
+  Fw = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  mSource      = AllocatePages (EFI_SIZE_TO_PAGES (BENCHMARK_BUFFER_SIZE));
+  mDestination = AllocatePages (EFI_SIZE_TO_PAGES (BENCHMARK_BUFFER_SIZE));
+  if ((mSource == NULL) || (mDestination == NULL)) {
+    DEBUG ((DEBUG_ERROR, "Failed to allocate the benchmark buffers\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Fw, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&BenchmarkTests, Fw, "Memory functions", "BaseMemoryLib.Benchmark", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BenchmarkTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarkContext); Index++) {
+    AddTestCase (
+      BenchmarkTests,
+      mBenchmarkContext[Index].Description,
+      mBenchmarkContext[Index].ClassName,
+      MemoryFunctionsTest,
+      NULL,
+      NULL,
+      &mBenchmarkContext[Index]
+      );
+  }
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Fw);
+
+EXIT:
+  if (Fw) {
+    FreeUnitTestFramework (Fw);
+  }
+  if (mSource != NULL) {
+    FreePages (mSource, EFI_SIZE_TO_PAGES (BENCHMARK_BUFFER_SIZE));
+  }
+  if (mDestination != NULL) {
+    FreePages (mDestination, EFI_SIZE_TO_PAGES (BENCHMARK_BUFFER_SIZE));
+  }
+
+  return Status;
+}
+
+/**
+  Standard UEFI entry point for target based unit test execution from UEFI Shell.
+**/
+EFI_STATUS
+EFIAPI
+BaseMemoryLibBenchmarkAppEntry (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return UnitTestingEntry ();
+}
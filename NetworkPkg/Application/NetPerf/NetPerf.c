@@ -0,0 +1,1297 @@
+/** @file
+  A shell application that measures the throughput of the network stack.
+
+  Three tests are supported:
+  - TCP stream: data is sent to an iperf version 2 server ("iperf -s") for the
+    requested time, with several transmit tokens kept outstanding.
+  - UDP blast: iperf version 2 datagrams are sent to an iperf UDP server
+    ("iperf -s -u") as fast as the stack accepts them for the requested time.
+  - HTTP GET: a URL is downloaded through the HTTP protocol and the body is
+    discarded.
+
+  Throughput is measured with the performance counter. The statistics of the
+  SNP instance below the test child are sampled before and after each test if
+  the driver supports them, and every test is bracketed by PERF_START/PERF_END
+  so that it lines up with the records of the network drivers in the firmware
+  performance table.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <IndustryStandard/Http11.h>
+
+#include <Protocol/ServiceBinding.h>
+#include <Protocol/SimpleNetwork.h>
+#include <Protocol/Tcp4.h>
+#include <Protocol/Udp4.h>
+#include <Protocol/Http.h>
+
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiLib.h>
+#include <Library/ShellLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/NetLib.h>
+#include <Library/HttpLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PerformanceLib.h>
+
+#define NET_PERF_DEFAULT_PORT        5001
+#define NET_PERF_DEFAULT_DURATION    10
+#define NET_PERF_DEFAULT_TCP_LENGTH  0x10000
+#define NET_PERF_DEFAULT_UDP_LENGTH  1470
+#define NET_PERF_MAX_TCP_LENGTH      0x100000
+#define NET_PERF_MAX_UDP_LENGTH      65507
+#define NET_PERF_TX_WINDOW           8
+#define NET_PERF_IO_TIMEOUT          10           ///< Seconds to wait for connect, drain and close
+#define NET_PERF_HTTP_TIMEOUT        5000         ///< Milliseconds, passed to HTTP Configure ()
+#define NET_PERF_HTTP_BODY_SIZE      0x10000
+#define NET_PERF_UDP_FIN_COUNT       10
+
+#pragma pack(1)
+///
+/// The header iperf version 2 expects at the start of every UDP datagram.
+/// All fields are in network byte order, a negative Id ends the test.
+///
+typedef struct {
+  INT32     Id;
+  UINT32    Sec;
+  UINT32    USec;
+} NET_PERF_IPERF_UDP_HEADER;
+#pragma pack()
+
+///
+/// A child of one of the network service bindings, only the protocol of the
+/// test is set.
+///
+typedef struct {
+  EFI_HANDLE           Controller;
+  EFI_GUID             *ServiceBindingGuid;
+  EFI_HANDLE           Handle;
+  EFI_TCP4_PROTOCOL    *Tcp4;
+  EFI_UDP4_PROTOCOL    *Udp4;
+  EFI_HTTP_PROTOCOL    *Http;
+} NET_PERF_CHILD;
+
+///
+/// One transmit request of the window kept outstanding by the TCP and UDP tests.
+///
+typedef struct {
+  BOOLEAN    Done;
+  BOOLEAN    Pending;
+  UINT8      *Buffer;
+  union {
+    EFI_TCP4_IO_TOKEN            Tcp4;
+    EFI_UDP4_COMPLETION_TOKEN    Udp4;
+  } Token;
+  union {
+    EFI_TCP4_TRANSMIT_DATA       Tcp4;
+    EFI_UDP4_TRANSMIT_DATA       Udp4;
+  } Data;
+} NET_PERF_TX_SLOT;
+
+typedef struct {
+  UINT64    Bytes;
+  UINT64    Packets;
+  UINT64    Nanoseconds;
+  UINT64    FirstByteNanoseconds;    ///< HTTP only, time until the response header arrived
+} NET_PERF_RESULT;
+
+EFI_HANDLE  mImageHandle;
+UINT64      mCounterStart;
+UINT64      mCounterEnd;
+
+SHELL_PARAM_ITEM  mParamList[] = {
+  {
+    L"-s",
+    TypeValue
+  },
+  {
+    L"-p",
+    TypeValue
+  },
+  {
+    L"-t",
+    TypeValue
+  },
+  {
+    L"-l",
+    TypeValue
+  },
+  {
+    L"-u",
+    TypeFlag
+  },
+  {
+    L"-g",
+    TypeValue
+  },
+  {
+    NULL,
+    TypeMax
+  }
+};
+
+/**
+  Print the usage of the application.
+
+**/
+VOID
+PrintUsage (
+  VOID
+  )
+{
+  Print (L"Usage: NetPerf -s <server> [-u] [-p <port>] [-t <seconds>] [-l <length>]\n");
+  Print (L"       NetPerf -g <url>\n");
+  Print (L"  -s  Send a TCP stream to the iperf (version 2) server at the IPv4 address.\n");
+  Print (L"  -u  Send UDP datagrams instead of a TCP stream.\n");
+  Print (L"  -p  Server port, %d by default.\n", NET_PERF_DEFAULT_PORT);
+  Print (L"  -t  Test duration in seconds, %d by default.\n", NET_PERF_DEFAULT_DURATION);
+  Print (L"  -l  Length of each transmit, %d (TCP) or %d (UDP) by default.\n", NET_PERF_DEFAULT_TCP_LENGTH, NET_PERF_DEFAULT_UDP_LENGTH);
+  Print (L"  -g  Download the URL with HTTP GET and discard the body.\n");
+}
+
+/**
+  Return the time between two performance counter values.
+
+  @param[in] Start    Counter value at the start of the interval.
+  @param[in] End      Counter value at the end of the interval.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+ElapsedNanoSeconds (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  if (mCounterEnd >= mCounterStart) {
+    return GetTimeInNanoSecond (End - Start);
+  }
+
+  return GetTimeInNanoSecond (Start - End);
+}
+
+/**
+  Notify function of all the tokens used by the tests.
+
+  @param[in]  Event      The event signaled.
+  @param[in]  Context    Points to the BOOLEAN to set.
+
+**/
+VOID
+EFIAPI
+NetPerfCommonNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  *((BOOLEAN *)Context) = TRUE;
+}
+
+/**
+  Poll the protocol of a test child.
+
+  @param[in]  Child    The test child.
+
+**/
+VOID
+NetPerfPoll (
+  IN NET_PERF_CHILD  *Child
+  )
+{
+  if (Child->Tcp4 != NULL) {
+    Child->Tcp4->Poll (Child->Tcp4);
+  } else if (Child->Udp4 != NULL) {
+    Child->Udp4->Poll (Child->Udp4);
+  } else if (Child->Http != NULL) {
+    Child->Http->Poll (Child->Http);
+  }
+}
+
+/**
+  Poll a test child until a token completes or the timeout expires.
+
+  @param[in]  Child      The test child.
+  @param[in]  Done       The flag set by the notify function of the token.
+  @param[in]  Seconds    The time to wait.
+
+  @retval EFI_SUCCESS    The token completed.
+  @retval EFI_TIMEOUT    The token didn't complete in time.
+  @retval Others         Failed to create the timer.
+
+**/
+EFI_STATUS
+NetPerfWait (
+  IN NET_PERF_CHILD  *Child,
+  IN BOOLEAN         *Done,
+  IN UINTN           Seconds
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   Timer;
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &Timer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->SetTimer (Timer, TimerRelative, MultU64x32 (Seconds, 10000000));
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Timer);
+    return Status;
+  }
+
+  while (!*Done && EFI_ERROR (gBS->CheckEvent (Timer))) {
+    NetPerfPoll (Child);
+  }
+
+  gBS->CloseEvent (Timer);
+  return *Done ? EFI_SUCCESS : EFI_TIMEOUT;
+}
+
+/**
+  Find the first network device that produces a service binding protocol.
+
+  @param[in]  ServiceBindingGuid    The service binding protocol to look for.
+
+  @return The device handle, or NULL if none is found.
+
+**/
+EFI_HANDLE
+NetPerfLocateController (
+  IN EFI_GUID  *ServiceBindingGuid
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       NumberOfHandles;
+  EFI_HANDLE  *HandleBuffer;
+  EFI_HANDLE  Controller;
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  ServiceBindingGuid,
+                  NULL,
+                  &NumberOfHandles,
+                  &HandleBuffer
+                  );
+  if (EFI_ERROR (Status) || (NumberOfHandles == 0)) {
+    return NULL;
+  }
+
+  Controller = HandleBuffer[0];
+  FreePool (HandleBuffer);
+  return Controller;
+}
+
+/**
+  Create a child of a network service binding on the first device that has it.
+
+  @param[in]  ServiceBindingGuid    The service binding protocol.
+  @param[in]  ProtocolGuid          The protocol of the child.
+  @param[out] Child                 Returns the child.
+  @param[out] Interface             Returns the protocol of the child.
+
+  @retval EFI_SUCCESS       The child was created.
+  @retval EFI_NOT_FOUND     No network device produces the service binding protocol.
+  @retval Others            Failed to create the child.
+
+**/
+EFI_STATUS
+NetPerfCreateChild (
+  IN  EFI_GUID        *ServiceBindingGuid,
+  IN  EFI_GUID        *ProtocolGuid,
+  OUT NET_PERF_CHILD  *Child,
+  OUT VOID            **Interface
+  )
+{
+  EFI_STATUS  Status;
+
+  ZeroMem (Child, sizeof (NET_PERF_CHILD));
+  Child->ServiceBindingGuid = ServiceBindingGuid;
+  Child->Controller         = NetPerfLocateController (ServiceBindingGuid);
+  if (Child->Controller == NULL) {
+    Print (L"No network device supports the test, is the network stack connected?\n");
+    return EFI_NOT_FOUND;
+  }
+
+  Status = NetLibCreateServiceChild (
+             Child->Controller,
+             mImageHandle,
+             ServiceBindingGuid,
+             &Child->Handle
+             );
+  if (EFI_ERROR (Status)) {
+    Print (L"Failed to create the network child - %r\n", Status);
+    return Status;
+  }
+
+  Status = gBS->HandleProtocol (Child->Handle, ProtocolGuid, Interface);
+  if (EFI_ERROR (Status)) {
+    NetLibDestroyServiceChild (Child->Controller, mImageHandle, ServiceBindingGuid, Child->Handle);
+    Child->Handle = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  Destroy a child created by NetPerfCreateChild ().
+
+  @param[in]  Child    The child to destroy.
+
+**/
+VOID
+NetPerfDestroyChild (
+  IN NET_PERF_CHILD  *Child
+  )
+{
+  if (Child->Handle != NULL) {
+    NetLibDestroyServiceChild (Child->Controller, mImageHandle, Child->ServiceBindingGuid, Child->Handle);
+    Child->Handle = NULL;
+  }
+}
+
+/**
+  Read the statistics of the SNP instance of a network device.
+
+  @param[in]  Controller    The network device.
+  @param[out] Statistics    Returns the statistics.
+
+  @retval EFI_SUCCESS       The statistics were read.
+  @retval Others            The device has no SNP or doesn't collect statistics.
+
+**/
+EFI_STATUS
+NetPerfGetStatistics (
+  IN  EFI_HANDLE              Controller,
+  OUT EFI_NETWORK_STATISTICS  *Statistics
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
+  UINTN                        Size;
+
+  Status = gBS->HandleProtocol (Controller, &gEfiSimpleNetworkProtocolGuid, (VOID **)&Snp);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Counters the driver doesn't collect are left at all ones.
+  //
+  SetMem (Statistics, sizeof (EFI_NETWORK_STATISTICS), 0xFF);
+  Size = sizeof (EFI_NETWORK_STATISTICS);
+  return Snp->Statistics (Snp, FALSE, &Size, Statistics);
+}
+
+/**
+  Print the difference of one SNP counter.
+
+  @param[in]  Name      The name of the counter.
+  @param[in]  Before    The counter before the test.
+  @param[in]  After     The counter after the test.
+
+**/
+VOID
+PrintCounter (
+  IN CHAR16  *Name,
+  IN UINT64  Before,
+  IN UINT64  After
+  )
+{
+  if ((Before == MAX_UINT64) || (After == MAX_UINT64)) {
+    return;
+  }
+
+  Print (L" %s=%ld", Name, After - Before);
+}
+
+/**
+  Print the throughput of a test and what the NIC counted meanwhile.
+
+  @param[in]  Name            The name of the test.
+  @param[in]  Result          The result of the test.
+  @param[in]  HaveStatistics  Whether Before and After are valid.
+  @param[in]  Before          The SNP statistics before the test.
+  @param[in]  After           The SNP statistics after the test.
+
+**/
+VOID
+PrintResult (
+  IN CHAR16                  *Name,
+  IN NET_PERF_RESULT         *Result,
+  IN BOOLEAN                 HaveStatistics,
+  IN EFI_NETWORK_STATISTICS  *Before,
+  IN EFI_NETWORK_STATISTICS  *After
+  )
+{
+  UINT64  MicroSeconds;
+  UINT64  MilliSeconds;
+  UINT64  Kbps;
+  UINT32  KbpsRemainder;
+  UINT32  MilliSecondsRemainder;
+
+  MicroSeconds = DivU64x32 (Result->Nanoseconds, 1000);
+  if (MicroSeconds == 0) {
+    MicroSeconds = 1;
+  }
+
+  Kbps         = DivU64x64Remainder (MultU64x32 (Result->Bytes, 8000), MicroSeconds, NULL);
+  Kbps         = DivU64x32Remainder (Kbps, 1000, &KbpsRemainder);
+  MilliSeconds = DivU64x32Remainder (DivU64x32 (MicroSeconds, 1000), 1000, &MilliSecondsRemainder);
+
+  Print (
+    L"%s: %ld bytes in %ld packets, %ld.%03ds, %ld.%03d Mbit/s\n",
+    Name,
+    Result->Bytes,
+    Result->Packets,
+    MilliSeconds,
+    MilliSecondsRemainder,
+    Kbps,
+    KbpsRemainder
+    );
+
+  if (Result->FirstByteNanoseconds != 0) {
+    Print (L"  time to response header: %ldus\n", DivU64x32 (Result->FirstByteNanoseconds, 1000));
+  }
+
+  if (!HaveStatistics) {
+    Print (L"  NIC statistics are not supported by the SNP driver.\n");
+    return;
+  }
+
+  Print (L"  NIC:");
+  PrintCounter (L"TxFrames", Before->TxTotalFrames, After->TxTotalFrames);
+  PrintCounter (L"TxDropped", Before->TxDroppedFrames, After->TxDroppedFrames);
+  PrintCounter (L"TxRetry", Before->TxRetryFrames, After->TxRetryFrames);
+  PrintCounter (L"TxError", Before->TxErrorFrames, After->TxErrorFrames);
+  PrintCounter (L"RxFrames", Before->RxTotalFrames, After->RxTotalFrames);
+  PrintCounter (L"RxDropped", Before->RxDroppedFrames, After->RxDroppedFrames);
+  PrintCounter (L"RxCrcError", Before->RxCrcErrorFrames, After->RxCrcErrorFrames);
+  Print (L"\n");
+}
+
+/**
+  Create the events of the transmit window.
+
+  @param[in, out] Slots    The transmit window.
+
+  @retval EFI_SUCCESS      The events were created.
+  @retval Others           Failed to create an event.
+
+**/
+EFI_STATUS
+NetPerfCreateSlots (
+  IN OUT NET_PERF_TX_SLOT  *Slots
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  ZeroMem (Slots, sizeof (NET_PERF_TX_SLOT) * NET_PERF_TX_WINDOW);
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    //
+    // The TCP4 and UDP4 completion tokens both start with the event.
+    //
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    NetPerfCommonNotify,
+                    &Slots[Index].Done,
+                    &Slots[Index].Token.Tcp4.CompletionToken.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Close the events and free the buffers of the transmit window.
+
+  No transmit may be pending any more.
+
+  @param[in]  Slots    The transmit window.
+
+**/
+VOID
+NetPerfFreeSlots (
+  IN NET_PERF_TX_SLOT  *Slots
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    ASSERT (!Slots[Index].Pending);
+    if (Slots[Index].Token.Tcp4.CompletionToken.Event != NULL) {
+      gBS->CloseEvent (Slots[Index].Token.Tcp4.CompletionToken.Event);
+    }
+
+    if (Slots[Index].Buffer != NULL) {
+      FreePool (Slots[Index].Buffer);
+    }
+  }
+}
+
+/**
+  Account a completed transmit of the window.
+
+  @param[in, out] Slot      The transmit slot that completed.
+  @param[in]      Status    The completion status of the token.
+  @param[in]      Length    The length of the transmit.
+  @param[in, out] Result    The result to update.
+
+  @return The completion status of the token.
+
+**/
+EFI_STATUS
+NetPerfCompleteSlot (
+  IN OUT NET_PERF_TX_SLOT  *Slot,
+  IN     EFI_STATUS        Status,
+  IN     UINT32            Length,
+  IN OUT NET_PERF_RESULT   *Result
+  )
+{
+  Slot->Pending = FALSE;
+  if (!EFI_ERROR (Status)) {
+    Result->Bytes += Length;
+    Result->Packets++;
+  }
+
+  return Status;
+}
+
+/**
+  Send a TCP stream to an iperf server.
+
+  @param[in]  Server      The IPv4 address of the server.
+  @param[in]  Port        The port of the server.
+  @param[in]  Duration    The test duration in seconds.
+  @param[in]  Length      The length of each transmit.
+
+  @retval EFI_SUCCESS     The test completed.
+  @retval Others          The test failed.
+
+**/
+EFI_STATUS
+RunTcpStream (
+  IN EFI_IPv4_ADDRESS  *Server,
+  IN UINT16            Port,
+  IN UINTN             Duration,
+  IN UINT32            Length
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_STATUS                 TxStatus;
+  NET_PERF_CHILD             Child;
+  EFI_TCP4_PROTOCOL          *Tcp4;
+  EFI_TCP4_CONFIG_DATA       ConfigData;
+  EFI_TCP4_OPTION            Option;
+  EFI_TCP4_CONNECTION_TOKEN  ConnToken;
+  EFI_TCP4_CLOSE_TOKEN       CloseToken;
+  BOOLEAN                    IsConnDone;
+  BOOLEAN                    IsCloseDone;
+  NET_PERF_TX_SLOT           Slots[NET_PERF_TX_WINDOW];
+  UINT8                      *Buffer;
+  UINTN                      Index;
+  UINT64                     Start;
+  UINT64                     DurationNs;
+  NET_PERF_RESULT            Result;
+  EFI_NETWORK_STATISTICS     Before;
+  EFI_NETWORK_STATISTICS     After;
+  BOOLEAN                    HaveStatistics;
+
+  ZeroMem (&Result, sizeof (Result));
+  ConnToken.CompletionToken.Event  = NULL;
+  CloseToken.CompletionToken.Event = NULL;
+  Buffer                           = NULL;
+
+  Status = NetPerfCreateChild (&gEfiTcp4ServiceBindingProtocolGuid, &gEfiTcp4ProtocolGuid, &Child, (VOID **)&Tcp4);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Child.Tcp4 = Tcp4;
+
+  Status = NetPerfCreateSlots (Slots);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  ZeroMem (&Option, sizeof (Option));
+  Option.ReceiveBufferSize   = 0x200000;
+  Option.SendBufferSize      = 0x200000;
+  Option.DataRetries         = 6;
+  Option.EnableNagle         = FALSE;
+  Option.EnableWindowScaling = TRUE;
+
+  ZeroMem (&ConfigData, sizeof (ConfigData));
+  ConfigData.TimeToLive                    = 64;
+  ConfigData.AccessPoint.UseDefaultAddress = TRUE;
+  ConfigData.AccessPoint.RemotePort        = Port;
+  ConfigData.AccessPoint.ActiveFlag        = TRUE;
+  ConfigData.ControlOption                 = &Option;
+  IP4_COPY_ADDRESS (&ConfigData.AccessPoint.RemoteAddress, Server);
+
+  Status = Tcp4->Configure (Tcp4, &ConfigData);
+  if (Status == EFI_NO_MAPPING) {
+    Print (L"The interface has no IPv4 address yet, configure it with ifconfig first.\n");
+    goto ON_EXIT;
+  } else if (EFI_ERROR (Status)) {
+    Print (L"Failed to configure TCP - %r\n", Status);
+    goto ON_EXIT;
+  }
+
+  Status = gBS->CreateEvent (EVT_NOTIFY_SIGNAL, TPL_CALLBACK, NetPerfCommonNotify, &IsConnDone, &ConnToken.CompletionToken.Event);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  IsConnDone = FALSE;
+  Status     = Tcp4->Connect (Tcp4, &ConnToken);
+  if (!EFI_ERROR (Status)) {
+    Status = NetPerfWait (&Child, &IsConnDone, NET_PERF_IO_TIMEOUT);
+    if (!EFI_ERROR (Status)) {
+      Status = ConnToken.CompletionToken.Status;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    Print (L"Failed to connect to %d.%d.%d.%d:%d - %r\n", Server->Addr[0], Server->Addr[1], Server->Addr[2], Server->Addr[3], Port, Status);
+    goto ON_EXIT;
+  }
+
+  //
+  // All the transmits send the same buffer, the content is irrelevant to iperf.
+  //
+  Buffer = AllocatePool (Length);
+  if (Buffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  SetMem (Buffer, Length, 0x5A);
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    Slots[Index].Data.Tcp4.DataLength                      = Length;
+    Slots[Index].Data.Tcp4.FragmentCount                   = 1;
+    Slots[Index].Data.Tcp4.FragmentTable[0].FragmentLength = Length;
+    Slots[Index].Data.Tcp4.FragmentTable[0].FragmentBuffer = Buffer;
+    Slots[Index].Token.Tcp4.Packet.TxData                  = &Slots[Index].Data.Tcp4;
+  }
+
+  HaveStatistics = (BOOLEAN)!EFI_ERROR (NetPerfGetStatistics (Child.Controller, &Before));
+  DurationNs     = MultU64x32 (Duration, 1000000000);
+
+  PERF_START (mImageHandle, "NetPerfTcp", NULL, 0);
+  Start    = GetPerformanceCounter ();
+  TxStatus = EFI_SUCCESS;
+  while (!EFI_ERROR (TxStatus) && (ElapsedNanoSeconds (Start, GetPerformanceCounter ()) < DurationNs)) {
+    for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+      if (Slots[Index].Pending) {
+        if (!Slots[Index].Done) {
+          continue;
+        }
+
+        TxStatus = NetPerfCompleteSlot (&Slots[Index], Slots[Index].Token.Tcp4.CompletionToken.Status, Length, &Result);
+        if (EFI_ERROR (TxStatus)) {
+          break;
+        }
+      }
+
+      Slots[Index].Done    = FALSE;
+      Slots[Index].Pending = TRUE;
+      TxStatus             = Tcp4->Transmit (Tcp4, &Slots[Index].Token.Tcp4);
+      if (EFI_ERROR (TxStatus)) {
+        Slots[Index].Pending = FALSE;
+        break;
+      }
+    }
+
+    Tcp4->Poll (Tcp4);
+  }
+
+  //
+  // Let the window drain so that the time covers all the data that was sent.
+  //
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    if (Slots[Index].Pending && !EFI_ERROR (NetPerfWait (&Child, &Slots[Index].Done, NET_PERF_IO_TIMEOUT))) {
+      NetPerfCompleteSlot (&Slots[Index], Slots[Index].Token.Tcp4.CompletionToken.Status, Length, &Result);
+    }
+  }
+
+  Result.Nanoseconds = ElapsedNanoSeconds (Start, GetPerformanceCounter ());
+  PERF_END (mImageHandle, "NetPerfTcp", NULL, 0);
+
+  if (HaveStatistics) {
+    HaveStatistics = (BOOLEAN)!EFI_ERROR (NetPerfGetStatistics (Child.Controller, &After));
+  }
+
+  if (EFI_ERROR (TxStatus)) {
+    Print (L"Transmit failed - %r\n", TxStatus);
+  }
+
+  PrintResult (L"TCP stream", &Result, HaveStatistics, &Before, &After);
+
+  Status = gBS->CreateEvent (EVT_NOTIFY_SIGNAL, TPL_CALLBACK, NetPerfCommonNotify, &IsCloseDone, &CloseToken.CompletionToken.Event);
+  if (!EFI_ERROR (Status)) {
+    IsCloseDone             = FALSE;
+    CloseToken.AbortOnClose = FALSE;
+    if (!EFI_ERROR (Tcp4->Close (Tcp4, &CloseToken))) {
+      NetPerfWait (&Child, &IsCloseDone, NET_PERF_IO_TIMEOUT);
+    }
+  }
+
+  Status = TxStatus;
+
+ON_EXIT:
+  //
+  // Resetting the instance aborts whatever is still pending, so nothing
+  // refers to the tokens on the stack afterwards.
+  //
+  Tcp4->Configure (Tcp4, NULL);
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    Slots[Index].Pending = FALSE;
+  }
+
+  NetPerfFreeSlots (Slots);
+  if (ConnToken.CompletionToken.Event != NULL) {
+    gBS->CloseEvent (ConnToken.CompletionToken.Event);
+  }
+
+  if (CloseToken.CompletionToken.Event != NULL) {
+    gBS->CloseEvent (CloseToken.CompletionToken.Event);
+  }
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+
+  NetPerfDestroyChild (&Child);
+  return Status;
+}
+
+/**
+  Fill the iperf header of a UDP datagram.
+
+  @param[out] Buffer     The datagram.
+  @param[in]  Id         The sequence number of the datagram, negative for the last one.
+  @param[in]  Elapsed    The time since the start of the test in nanoseconds.
+
+**/
+VOID
+NetPerfFillUdpHeader (
+  OUT UINT8   *Buffer,
+  IN  INT32   Id,
+  IN  UINT64  Elapsed
+  )
+{
+  NET_PERF_IPERF_UDP_HEADER  Header;
+  UINT32                     Remainder;
+
+  Header.Id   = (INT32)HTONL ((UINT32)Id);
+  Header.Sec  = HTONL ((UINT32)DivU64x32Remainder (Elapsed, 1000000000, &Remainder));
+  Header.USec = HTONL (Remainder / 1000);
+  CopyMem (Buffer, &Header, sizeof (Header));
+}
+
+/**
+  Send UDP datagrams to an iperf server.
+
+  @param[in]  Server      The IPv4 address of the server.
+  @param[in]  Port        The port of the server.
+  @param[in]  Duration    The test duration in seconds.
+  @param[in]  Length      The length of each datagram.
+
+  @retval EFI_SUCCESS     The test completed.
+  @retval Others          The test failed.
+
+**/
+EFI_STATUS
+RunUdpBlast (
+  IN EFI_IPv4_ADDRESS  *Server,
+  IN UINT16            Port,
+  IN UINTN             Duration,
+  IN UINT32            Length
+  )
+{
+  EFI_STATUS              Status;
+  EFI_STATUS              TxStatus;
+  NET_PERF_CHILD          Child;
+  EFI_UDP4_PROTOCOL       *Udp4;
+  EFI_UDP4_CONFIG_DATA    ConfigData;
+  NET_PERF_TX_SLOT        Slots[NET_PERF_TX_WINDOW];
+  UINTN                   Index;
+  INT32                   Id;
+  UINT64                  Start;
+  UINT64                  Elapsed;
+  UINT64                  DurationNs;
+  NET_PERF_RESULT         Result;
+  EFI_NETWORK_STATISTICS  Before;
+  EFI_NETWORK_STATISTICS  After;
+  BOOLEAN                 HaveStatistics;
+
+  ZeroMem (&Result, sizeof (Result));
+
+  Status = NetPerfCreateChild (&gEfiUdp4ServiceBindingProtocolGuid, &gEfiUdp4ProtocolGuid, &Child, (VOID **)&Udp4);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Child.Udp4 = Udp4;
+
+  Status = NetPerfCreateSlots (Slots);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  ZeroMem (&ConfigData, sizeof (ConfigData));
+  ConfigData.TimeToLive        = 64;
+  ConfigData.UseDefaultAddress = TRUE;
+  ConfigData.RemotePort        = Port;
+  IP4_COPY_ADDRESS (&ConfigData.RemoteAddress, Server);
+
+  Status = Udp4->Configure (Udp4, &ConfigData);
+  if (Status == EFI_NO_MAPPING) {
+    Print (L"The interface has no IPv4 address yet, configure it with ifconfig first.\n");
+    goto ON_EXIT;
+  } else if (EFI_ERROR (Status)) {
+    Print (L"Failed to configure UDP - %r\n", Status);
+    goto ON_EXIT;
+  }
+
+  //
+  // Every datagram carries its own sequence number, so each slot has a buffer.
+  //
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    Slots[Index].Buffer = AllocatePool (Length);
+    if (Slots[Index].Buffer == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ON_EXIT;
+    }
+
+    SetMem (Slots[Index].Buffer, Length, 0x5A);
+    Slots[Index].Data.Udp4.DataLength                      = Length;
+    Slots[Index].Data.Udp4.FragmentCount                   = 1;
+    Slots[Index].Data.Udp4.FragmentTable[0].FragmentLength = Length;
+    Slots[Index].Data.Udp4.FragmentTable[0].FragmentBuffer = Slots[Index].Buffer;
+    Slots[Index].Token.Udp4.Packet.TxData                  = &Slots[Index].Data.Udp4;
+  }
+
+  HaveStatistics = (BOOLEAN)!EFI_ERROR (NetPerfGetStatistics (Child.Controller, &Before));
+  DurationNs     = MultU64x32 (Duration, 1000000000);
+
+  PERF_START (mImageHandle, "NetPerfUdp", NULL, 0);
+  Id       = 0;
+  Start    = GetPerformanceCounter ();
+  Elapsed  = 0;
+  TxStatus = EFI_SUCCESS;
+  while (!EFI_ERROR (TxStatus) && (Elapsed < DurationNs)) {
+    for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+      if (Slots[Index].Pending) {
+        if (!Slots[Index].Done) {
+          continue;
+        }
+
+        TxStatus = NetPerfCompleteSlot (&Slots[Index], Slots[Index].Token.Udp4.Status, Length, &Result);
+        if (EFI_ERROR (TxStatus)) {
+          break;
+        }
+      }
+
+      NetPerfFillUdpHeader (Slots[Index].Buffer, Id++, Elapsed);
+      Slots[Index].Done    = FALSE;
+      Slots[Index].Pending = TRUE;
+      TxStatus             = Udp4->Transmit (Udp4, &Slots[Index].Token.Udp4);
+      if (EFI_ERROR (TxStatus)) {
+        Slots[Index].Pending = FALSE;
+        break;
+      }
+    }
+
+    Udp4->Poll (Udp4);
+    Elapsed = ElapsedNanoSeconds (Start, GetPerformanceCounter ());
+  }
+
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    if (Slots[Index].Pending && !EFI_ERROR (NetPerfWait (&Child, &Slots[Index].Done, NET_PERF_IO_TIMEOUT))) {
+      NetPerfCompleteSlot (&Slots[Index], Slots[Index].Token.Udp4.Status, Length, &Result);
+    }
+  }
+
+  Result.Nanoseconds = ElapsedNanoSeconds (Start, GetPerformanceCounter ());
+  PERF_END (mImageHandle, "NetPerfUdp", NULL, 0);
+
+  if (HaveStatistics) {
+    HaveStatistics = (BOOLEAN)!EFI_ERROR (NetPerfGetStatistics (Child.Controller, &After));
+  }
+
+  //
+  // Tell the server the test is over. iperf answers with a report which isn't
+  // needed here, the loss the server saw is printed on its side.
+  //
+  if (!Slots[0].Pending) {
+    for (Index = 0; Index < NET_PERF_UDP_FIN_COUNT; Index++) {
+      NetPerfFillUdpHeader (Slots[0].Buffer, -Id, Result.Nanoseconds);
+      Slots[0].Done    = FALSE;
+      Slots[0].Pending = TRUE;
+      if (EFI_ERROR (Udp4->Transmit (Udp4, &Slots[0].Token.Udp4)) ||
+          EFI_ERROR (NetPerfWait (&Child, &Slots[0].Done, NET_PERF_IO_TIMEOUT)))
+      {
+        break;
+      }
+
+      Slots[0].Pending = FALSE;
+    }
+  }
+
+  if (EFI_ERROR (TxStatus)) {
+    Print (L"Transmit failed - %r\n", TxStatus);
+  }
+
+  PrintResult (L"UDP blast", &Result, HaveStatistics, &Before, &After);
+  Status = TxStatus;
+
+ON_EXIT:
+  Udp4->Configure (Udp4, NULL);
+  for (Index = 0; Index < NET_PERF_TX_WINDOW; Index++) {
+    Slots[Index].Pending = FALSE;
+  }
+
+  NetPerfFreeSlots (Slots);
+  NetPerfDestroyChild (&Child);
+  return Status;
+}
+
+/**
+  Download a URL with HTTP GET and discard the body.
+
+  @param[in]  Url         The URL to download.
+
+  @retval EFI_SUCCESS     The test completed.
+  @retval Others          The test failed.
+
+**/
+EFI_STATUS
+RunHttpGet (
+  IN CHAR16  *Url
+  )
+{
+  EFI_STATUS               Status;
+  NET_PERF_CHILD           Child;
+  EFI_HTTP_PROTOCOL        *Http;
+  EFI_HTTP_CONFIG_DATA     ConfigData;
+  EFI_HTTPv4_ACCESS_POINT  Ipv4Node;
+  CHAR8                    *AsciiUrl;
+  UINTN                    UrlSize;
+  VOID                     *UrlParser;
+  CHAR8                    *HostName;
+  EFI_HTTP_HEADER          RequestHeaders[3];
+  EFI_HTTP_REQUEST_DATA    RequestData;
+  EFI_HTTP_RESPONSE_DATA   ResponseData;
+  EFI_HTTP_MESSAGE         RequestMessage;
+  EFI_HTTP_MESSAGE         ResponseMessage;
+  EFI_HTTP_TOKEN           Token;
+  BOOLEAN                  IsDone;
+  EFI_HTTP_HEADER          *Header;
+  UINT8                    *Body;
+  UINT64                   ContentLength;
+  UINT64                   Start;
+  NET_PERF_RESULT          Result;
+  EFI_NETWORK_STATISTICS   Before;
+  EFI_NETWORK_STATISTICS   After;
+  BOOLEAN                  HaveStatistics;
+
+  ZeroMem (&Result, sizeof (Result));
+  Token.Event = NULL;
+  UrlParser   = NULL;
+  HostName    = NULL;
+  Body        = NULL;
+
+  UrlSize  = StrLen (Url) + 1;
+  AsciiUrl = AllocatePool (UrlSize);
+  if (AsciiUrl == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  UnicodeStrToAsciiStrS (Url, AsciiUrl, UrlSize);
+  Status = HttpParseUrl (AsciiUrl, (UINT32)AsciiStrLen (AsciiUrl), FALSE, &UrlParser);
+  if (!EFI_ERROR (Status)) {
+    Status = HttpUrlGetHostName (AsciiUrl, UrlParser, &HostName);
+  }
+
+  if (EFI_ERROR (Status)) {
+    Print (L"Invalid URL %s - %r\n", Url, Status);
+    FreePool (AsciiUrl);
+    if (UrlParser != NULL) {
+      HttpUrlFreeParser (UrlParser);
+    }
+
+    return Status;
+  }
+
+  Status = NetPerfCreateChild (&gEfiHttpServiceBindingProtocolGuid, &gEfiHttpProtocolGuid, &Child, (VOID **)&Http);
+  if (EFI_ERROR (Status)) {
+    goto ON_FREE_URL;
+  }
+
+  Child.Http = Http;
+
+  ZeroMem (&Ipv4Node, sizeof (Ipv4Node));
+  Ipv4Node.UseDefaultAddress = TRUE;
+
+  ZeroMem (&ConfigData, sizeof (ConfigData));
+  ConfigData.HttpVersion          = HttpVersion11;
+  ConfigData.TimeOutMillisec      = NET_PERF_HTTP_TIMEOUT;
+  ConfigData.LocalAddressIsIPv6   = FALSE;
+  ConfigData.AccessPoint.IPv4Node = &Ipv4Node;
+
+  Status = Http->Configure (Http, &ConfigData);
+  if (EFI_ERROR (Status)) {
+    Print (L"Failed to configure HTTP - %r\n", Status);
+    goto ON_EXIT;
+  }
+
+  Body = AllocatePool (NET_PERF_HTTP_BODY_SIZE);
+  if (Body == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  Status = gBS->CreateEvent (EVT_NOTIFY_SIGNAL, TPL_CALLBACK, NetPerfCommonNotify, &IsDone, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  RequestHeaders[0].FieldName  = (CHAR8 *)HTTP_HEADER_HOST;
+  RequestHeaders[0].FieldValue = HostName;
+  RequestHeaders[1].FieldName  = (CHAR8 *)HTTP_HEADER_ACCEPT;
+  RequestHeaders[1].FieldValue = (CHAR8 *)"*/*";
+  RequestHeaders[2].FieldName  = (CHAR8 *)HTTP_HEADER_USER_AGENT;
+  RequestHeaders[2].FieldValue = (CHAR8 *)"UefiNetPerf";
+
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+
+  ZeroMem (&RequestMessage, sizeof (RequestMessage));
+  RequestMessage.Data.Request = &RequestData;
+  RequestMessage.HeaderCount  = ARRAY_SIZE (RequestHeaders);
+  RequestMessage.Headers      = RequestHeaders;
+
+  HaveStatistics = (BOOLEAN)!EFI_ERROR (NetPerfGetStatistics (Child.Controller, &Before));
+
+  PERF_START (mImageHandle, "NetPerfHttp", NULL, 0);
+  Start         = GetPerformanceCounter ();
+  IsDone        = FALSE;
+  Token.Status  = EFI_NOT_READY;
+  Token.Message = &RequestMessage;
+  Status        = Http->Request (Http, &Token);
+  if (!EFI_ERROR (Status)) {
+    Status = NetPerfWait (&Child, &IsDone, NET_PERF_IO_TIMEOUT);
+    if (!EFI_ERROR (Status)) {
+      Status = Token.Status;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    Print (L"Failed to send the request - %r\n", Status);
+    goto ON_EXIT;
+  }
+
+  //
+  // The first response carries the header and the start of the body, the
+  // body is then read until Content-Length bytes arrived or the server
+  // closed the connection.
+  //
+  ZeroMem (&ResponseMessage, sizeof (ResponseMessage));
+  ResponseMessage.Data.Response = &ResponseData;
+  ContentLength                 = MAX_UINT64;
+  while (Result.Bytes < ContentLength) {
+    ResponseMessage.BodyLength = NET_PERF_HTTP_BODY_SIZE;
+    ResponseMessage.Body       = Body;
+    IsDone                     = FALSE;
+    Token.Status               = EFI_NOT_READY;
+    Token.Message              = &ResponseMessage;
+    Status                     = Http->Response (Http, &Token);
+    if (!EFI_ERROR (Status)) {
+      Status = NetPerfWait (&Child, &IsDone, NET_PERF_IO_TIMEOUT);
+      if (!EFI_ERROR (Status)) {
+        Status = Token.Status;
+      }
+    }
+
+    if (EFI_ERROR (Status)) {
+      if ((Status == EFI_CONNECTION_FIN) && (ContentLength == MAX_UINT64)) {
+        Status = EFI_SUCCESS;
+      }
+
+      break;
+    }
+
+    if (ResponseMessage.Data.Response != NULL) {
+      Result.FirstByteNanoseconds = ElapsedNanoSeconds (Start, GetPerformanceCounter ());
+      if (ResponseData.StatusCode != HTTP_STATUS_200_OK) {
+        Print (L"The server answered with status code %d\n", ResponseData.StatusCode);
+        Status = EFI_PROTOCOL_ERROR;
+      }
+
+      Header = HttpFindHeader (ResponseMessage.HeaderCount, ResponseMessage.Headers, HTTP_HEADER_CONTENT_LENGTH);
+      if (Header != NULL) {
+        ContentLength = AsciiStrDecimalToUint64 (Header->FieldValue);
+      }
+
+      if (ResponseMessage.Headers != NULL) {
+        HttpFreeHeaderFields (ResponseMessage.Headers, ResponseMessage.HeaderCount);
+      }
+
+      ResponseMessage.Data.Response = NULL;
+      ResponseMessage.HeaderCount   = 0;
+      ResponseMessage.Headers       = NULL;
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+
+    Result.Bytes += ResponseMessage.BodyLength;
+    Result.Packets++;
+  }
+
+  Result.Nanoseconds = ElapsedNanoSeconds (Start, GetPerformanceCounter ());
+  PERF_END (mImageHandle, "NetPerfHttp", NULL, 0);
+
+  if (HaveStatistics) {
+    HaveStatistics = (BOOLEAN)!EFI_ERROR (NetPerfGetStatistics (Child.Controller, &After));
+  }
+
+  if (EFI_ERROR (Status)) {
+    Print (L"Failed to receive the response - %r\n", Status);
+  }
+
+  PrintResult (L"HTTP GET", &Result, HaveStatistics, &Before, &After);
+
+ON_EXIT:
+  //
+  // Resetting the instance cancels a request or response still in progress.
+  //
+  Http->Configure (Http, NULL);
+  if (Token.Event != NULL) {
+    gBS->CloseEvent (Token.Event);
+  }
+
+  if (Body != NULL) {
+    FreePool (Body);
+  }
+
+  NetPerfDestroyChild (&Child);
+
+ON_FREE_URL:
+  FreePool (HostName);
+  HttpUrlFreeParser (UrlParser);
+  FreePool (AsciiUrl);
+  return Status;
+}
+
+/**
+  The entry point of the application.
+
+  @param[in]  ImageHandle    The image handle of this application.
+  @param[in]  SystemTable    The pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS            The test completed.
+  @retval EFI_INVALID_PARAMETER  The command line is invalid.
+  @retval Others                 The test failed.
+
+**/
+EFI_STATUS
+EFIAPI
+NetPerfMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS        Status;
+  LIST_ENTRY        *List;
+  CONST CHAR16      *Value;
+  EFI_IPv4_ADDRESS  Server;
+  UINTN             Port;
+  UINTN             Duration;
+  UINTN             Length;
+  BOOLEAN           IsUdp;
+
+  mImageHandle = ImageHandle;
+  GetPerformanceCounterProperties (&mCounterStart, &mCounterEnd);
+
+  List   = NULL;
+  Status = ShellCommandLineParse (mParamList, &List, NULL, FALSE);
+  if (EFI_ERROR (Status) || (List == NULL)) {
+    PrintUsage ();
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = EFI_INVALID_PARAMETER;
+
+  if (ShellCommandLineGetFlag (List, L"-g")) {
+    Value = ShellCommandLineGetValue (List, L"-g");
+    if (Value == NULL) {
+      PrintUsage ();
+      goto Exit;
+    }
+
+    Status = RunHttpGet ((CHAR16 *)Value);
+    goto Exit;
+  }
+
+  Value = ShellCommandLineGetValue (List, L"-s");
+  if ((Value == NULL) || EFI_ERROR (NetLibStrToIp4 (Value, &Server))) {
+    PrintUsage ();
+    goto Exit;
+  }
+
+  IsUdp    = ShellCommandLineGetFlag (List, L"-u");
+  Port     = NET_PERF_DEFAULT_PORT;
+  Duration = NET_PERF_DEFAULT_DURATION;
+  Length   = IsUdp ? NET_PERF_DEFAULT_UDP_LENGTH : NET_PERF_DEFAULT_TCP_LENGTH;
+
+  Value = ShellCommandLineGetValue (List, L"-p");
+  if (Value != NULL) {
+    Port = StrDecimalToUintn (Value);
+  }
+
+  Value = ShellCommandLineGetValue (List, L"-t");
+  if (Value != NULL) {
+    Duration = StrDecimalToUintn (Value);
+  }
+
+  Value = ShellCommandLineGetValue (List, L"-l");
+  if (Value != NULL) {
+    Length = StrDecimalToUintn (Value);
+  }
+
+  if ((Port == 0) || (Port > MAX_UINT16) || (Duration == 0) || (Duration > MAX_UINT32) ||
+      (Length > (IsUdp ? NET_PERF_MAX_UDP_LENGTH : NET_PERF_MAX_TCP_LENGTH)) ||
+      (Length < (IsUdp ? sizeof (NET_PERF_IPERF_UDP_HEADER) : 1)))
+  {
+    PrintUsage ();
+    goto Exit;
+  }
+
+  if (IsUdp) {
+    Status = RunUdpBlast (&Server, (UINT16)Port, Duration, (UINT32)Length);
+  } else {
+    Status = RunTcpStream (&Server, (UINT16)Port, Duration, (UINT32)Length);
+  }
+
+Exit:
+  ShellCommandLineFreeVarList (List);
+  return Status;
+}
@@ -227,6 +227,12 @@ ArpOnFrameRcvdDpc (
     ArpFillAddressInCacheEntry (CacheEntry, &SenderAddress[Hardware], NULL);
     CacheEntry->DecayTime = CacheEntry->DefaultDecayTime;
     MergeFlag = TRUE;
+
+    //
+    // Promote the entry to the head of the table. LRU
+    //
+    RemoveEntryList (&CacheEntry->List);
+    InsertHeadList (&ArpService->ResolvedCacheTable, &CacheEntry->List);
   }
 
   if (!IsTarget) {
@@ -577,6 +577,14 @@ ArpRequest (
       CacheEntry->Addresses[Hardware].Length
       );
 
+    //
+    // IP consults the cache for every unicast frame it sends. Promote the
+    // entry to the head of the table so the peers in use are found first,
+    // however many other neighbors the cache has learned. LRU
+    //
+    RemoveEntryList (&CacheEntry->List);
+    InsertHeadList (&ArpService->ResolvedCacheTable, &CacheEntry->List);
+
     goto UNLOCK_EXIT;
   }
 
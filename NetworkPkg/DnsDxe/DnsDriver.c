@@ -53,6 +53,10 @@ DnsDestroyInstance (
 
   ZeroMem (&Instance->Dns6CfgData, sizeof (EFI_DNS6_CONFIG_DATA));
 
+  if (Instance->SessionDnsServerList != NULL) {
+    FreePool (Instance->SessionDnsServerList);
+  }
+
   if (!NetMapIsEmpty (&Instance->Dns4TxTokens)) {
     Dns4InstanceCancelToken (Instance, NULL);
   }
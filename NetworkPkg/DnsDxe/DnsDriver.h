@@ -80,6 +80,13 @@ struct _DNS_INSTANCE {
 
   EFI_IP_ADDRESS                SessionDnsServer;
 
+  //
+  // All servers the queries of this session are sent to. With more than
+  // one server, every query goes to all of them and the first answer wins.
+  //
+  UINT32                        SessionDnsServerCount;
+  EFI_IP_ADDRESS                *SessionDnsServerList;
+
   NET_MAP                       Dns4TxTokens;
   NET_MAP                       Dns6TxTokens;
 
@@ -686,7 +686,16 @@ Dns4ConfigUdp (
   UdpConfig.RemotePort         = DNS_SERVER_PORT;
 
   CopyMem (&UdpConfig.StationAddress, &Config->StationIp, sizeof (EFI_IPv4_ADDRESS));
-  CopyMem (&UdpConfig.RemoteAddress, &Instance->SessionDnsServer.v4, sizeof (EFI_IPv4_ADDRESS));
+
+  //
+  // With several session servers the destination is given per datagram, and
+  // the answers are accepted from any address and filtered on receive.
+  //
+  if (Instance->SessionDnsServerCount > 1) {
+    ZeroMem (&UdpConfig.RemoteAddress, sizeof (EFI_IPv4_ADDRESS));
+  } else {
+    CopyMem (&UdpConfig.RemoteAddress, &Instance->SessionDnsServer.v4, sizeof (EFI_IPv4_ADDRESS));
+  }
 
   Status = UdpIo->Protocol.Udp4->Configure (UdpIo->Protocol.Udp4, &UdpConfig);
 
@@ -729,7 +738,11 @@ Dns6ConfigUdp (
   UdpConfig.StationPort        = Config->LocalPort;
   UdpConfig.RemotePort         = DNS_SERVER_PORT;
   CopyMem (&UdpConfig.StationAddress, &Config->StationIp, sizeof (EFI_IPv6_ADDRESS));
-  CopyMem (&UdpConfig.RemoteAddress, &Instance->SessionDnsServer.v6, sizeof (EFI_IPv6_ADDRESS));
+  if (Instance->SessionDnsServerCount > 1) {
+    ZeroMem (&UdpConfig.RemoteAddress, sizeof (EFI_IPv6_ADDRESS));
+  } else {
+    CopyMem (&UdpConfig.RemoteAddress, &Instance->SessionDnsServer.v6, sizeof (EFI_IPv6_ADDRESS));
+  }
 
   Status = UdpIo->Protocol.Udp6->Configure (UdpIo->Protocol.Udp6, &UdpConfig);
 
@@ -740,6 +753,108 @@ Dns6ConfigUdp (
   return Status;
 }
 
+/**
+  Record the DNS servers the queries of this session are sent to.
+
+  @param  Instance               The DNS session
+  @param  ServerCount            The number of servers in ServerList
+  @param  ServerList             The EFI_IPv4_ADDRESS or EFI_IPv6_ADDRESS array of
+                                 the servers, according to the IP version.
+
+  @retval EFI_SUCCESS            The servers are recorded.
+  @retval EFI_INVALID_PARAMETER  ServerCount is zero.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate memory.
+
+**/
+EFI_STATUS
+DnsSetSessionServers (
+  IN DNS_INSTANCE           *Instance,
+  IN UINT32                 ServerCount,
+  IN VOID                   *ServerList
+  )
+{
+  EFI_IP_ADDRESS            *List;
+  UINT32                    Index;
+
+  if (ServerCount == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  List = AllocateZeroPool (ServerCount * sizeof (EFI_IP_ADDRESS));
+  if (List == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < ServerCount; Index++) {
+    if (Instance->Service->IpVersion == IP_VERSION_4) {
+      CopyMem (&List[Index].v4, (EFI_IPv4_ADDRESS *) ServerList + Index, sizeof (EFI_IPv4_ADDRESS));
+    } else {
+      CopyMem (&List[Index].v6, (EFI_IPv6_ADDRESS *) ServerList + Index, sizeof (EFI_IPv6_ADDRESS));
+    }
+  }
+
+  if (Instance->SessionDnsServerList != NULL) {
+    FreePool (Instance->SessionDnsServerList);
+  }
+
+  Instance->SessionDnsServerList  = List;
+  Instance->SessionDnsServerCount = ServerCount;
+  CopyMem (&Instance->SessionDnsServer, &List[0], sizeof (EFI_IP_ADDRESS));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether a received datagram comes from one of the session servers.
+
+  @param  Instance               The DNS session
+  @param  EndPoint               The UDP address pair of the received datagram
+
+  @retval TRUE                   The datagram comes from a session server.
+  @retval FALSE                  The datagram comes from somewhere else.
+
+**/
+BOOLEAN
+DnsIsSessionServer (
+  IN DNS_INSTANCE           *Instance,
+  IN UDP_END_POINT          *EndPoint
+  )
+{
+  EFI_IPv6_ADDRESS          Ip6;
+  IP4_ADDR                  Ip4;
+  UINT32                    Index;
+
+  //
+  // With a single server, UDP only delivers the datagrams from it.
+  //
+  if (Instance->SessionDnsServerCount <= 1) {
+    return TRUE;
+  }
+
+  //
+  // UdpIo reports the remote address in host byte order.
+  //
+  Ip4 = 0;
+  if (Instance->Service->IpVersion == IP_VERSION_4) {
+    Ip4 = HTONL (EndPoint->RemoteAddr.Addr[0]);
+  } else {
+    IP6_COPY_ADDRESS (&Ip6, &EndPoint->RemoteAddr.v6);
+    Ip6Swap128 (&Ip6);
+  }
+
+  for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+    if (Instance->Service->IpVersion == IP_VERSION_4) {
+      if (Instance->SessionDnsServerList[Index].Addr[0] == Ip4) {
+        return TRUE;
+      }
+    } else if (EFI_IP6_EQUAL (&Instance->SessionDnsServerList[Index].v6, &Ip6)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 /**
   Update Dns4 cache to shared list of caches of all DNSv4 instances.
 
@@ -1278,6 +1393,14 @@ ParseDnsResponse (
     //
     if (DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) {
       Status = EFI_NOT_FOUND;
+    } else if (Instance->SessionDnsServerCount > 1) {
+      //
+      // A failing server doesn't end the query while other servers may
+      // still answer it, the retransmission timer bounds the wait.
+      //
+      *Completed = FALSE;
+      gBS->RestoreTPL (OldTpl);
+      return EFI_ABORTED;
     } else {
       Status = EFI_DEVICE_ERROR;
     }
@@ -1801,6 +1924,10 @@ DnsOnPacketReceived (
 
   ASSERT (Packet != NULL);
 
+  if (!DnsIsSessionServer (Instance, EndPoint)) {
+    goto ON_EXIT;
+  }
+
   Len = Packet->TotalSize;
 
   RcvString = NetbufGetByte (Packet, 0, NULL);
@@ -1906,11 +2033,7 @@ DoDnsQuery (
   //
   // Transmit the DNS packet.
   //
-  NET_GET_REF (Packet);
-
-  Status = UdpIoSendDatagram (Instance->UdpIo, Packet, NULL, NULL, DnsOnPacketSent, Instance);
-
-  return Status;
+  return DnsSendToServers (Instance, Packet);
 }
 
 /**
@@ -2021,32 +2144,70 @@ DnsRetransmit (
   IN DNS_INSTANCE        *Instance,
   IN NET_BUF             *Packet
   )
+{
+  ASSERT (Packet != NULL);
+
+  return DnsSendToServers (Instance, Packet);
+}
+
+/**
+  Send the packet to all the session servers.
+
+  @param  Instance              The DNS instance
+  @param  Packet                The packet to send
+
+  @retval EFI_SUCCESS           The packet is sent to at least one server.
+  @retval Others                Failed to send the packet to any server.
+
+**/
+EFI_STATUS
+DnsSendToServers (
+  IN DNS_INSTANCE        *Instance,
+  IN NET_BUF             *Packet
+  )
 {
   EFI_STATUS      Status;
+  EFI_STATUS      SendStatus;
+  UDP_END_POINT   EndPoint;
+  UINT32          Index;
 
-  UINT8           *Buffer;
+  if (Instance->SessionDnsServerCount <= 1) {
+    NET_GET_REF (Packet);
 
-  ASSERT (Packet != NULL);
+    Status = UdpIoSendDatagram (Instance->UdpIo, Packet, NULL, NULL, DnsOnPacketSent, Instance);
+    if (EFI_ERROR (Status)) {
+      NET_PUT_REF (Packet);
+    }
+
+    return Status;
+  }
 
   //
-  // Set the requests to the listening port, other packets to the connected port
+  // Query all the servers at once, so that a server which doesn't answer
+  // costs nothing as long as another one does.
   //
-  Buffer = NetbufGetByte (Packet, 0, NULL);
-  ASSERT (Buffer != NULL);
+  Status = EFI_DEVICE_ERROR;
+  for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+    ZeroMem (&EndPoint, sizeof (UDP_END_POINT));
+    EndPoint.RemotePort = DNS_SERVER_PORT;
 
-  NET_GET_REF (Packet);
+    if (Instance->Service->IpVersion == IP_VERSION_4) {
+      EndPoint.RemoteAddr.Addr[0] = NTOHL (Instance->SessionDnsServerList[Index].Addr[0]);
+    } else {
+      IP6_COPY_ADDRESS (&EndPoint.RemoteAddr.v6, &Instance->SessionDnsServerList[Index].v6);
+    }
 
-  Status = UdpIoSendDatagram (
-             Instance->UdpIo,
-             Packet,
-             NULL,
-             NULL,
-             DnsOnPacketSent,
-             Instance
-             );
+    NET_GET_REF (Packet);
 
-  if (EFI_ERROR (Status)) {
-    NET_PUT_REF (Packet);
+    SendStatus = UdpIoSendDatagram (Instance->UdpIo, Packet, &EndPoint, NULL, DnsOnPacketSent, Instance);
+    if (EFI_ERROR (SendStatus)) {
+      NET_PUT_REF (Packet);
+      if (EFI_ERROR (Status)) {
+        Status = SendStatus;
+      }
+    } else {
+      Status = EFI_SUCCESS;
+    }
   }
 
   return Status;
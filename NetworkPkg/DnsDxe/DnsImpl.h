@@ -471,6 +471,42 @@ Dns6ConfigUdp (
   IN UDP_IO                 *UdpIo
   );
 
+/**
+  Record the DNS servers the queries of this session are sent to.
+
+  @param  Instance               The DNS session
+  @param  ServerCount            The number of servers in ServerList
+  @param  ServerList             The EFI_IPv4_ADDRESS or EFI_IPv6_ADDRESS array of
+                                 the servers, according to the IP version.
+
+  @retval EFI_SUCCESS            The servers are recorded.
+  @retval EFI_INVALID_PARAMETER  ServerCount is zero.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate memory.
+
+**/
+EFI_STATUS
+DnsSetSessionServers (
+  IN DNS_INSTANCE           *Instance,
+  IN UINT32                 ServerCount,
+  IN VOID                   *ServerList
+  );
+
+/**
+  Check whether a received datagram comes from one of the session servers.
+
+  @param  Instance               The DNS session
+  @param  EndPoint               The UDP address pair of the received datagram
+
+  @retval TRUE                   The datagram comes from a session server.
+  @retval FALSE                  The datagram comes from somewhere else.
+
+**/
+BOOLEAN
+DnsIsSessionServer (
+  IN DNS_INSTANCE           *Instance,
+  IN UDP_END_POINT          *EndPoint
+  );
+
 /**
   Update Dns4 cache to shared list of caches of all DNSv4 instances.
 
@@ -682,6 +718,22 @@ DnsRetransmit (
   IN NET_BUF             *Packet
   );
 
+/**
+  Send the packet to all the session servers.
+
+  @param  Instance              The DNS instance
+  @param  Packet                The packet to send
+
+  @retval EFI_SUCCESS           The packet is sent to at least one server.
+  @retval Others                Failed to send the packet to any server.
+
+**/
+EFI_STATUS
+DnsSendToServers (
+  IN DNS_INSTANCE        *Instance,
+  IN NET_BUF             *Packet
+  );
+
 /**
   The timer ticking function for the DNS service.
 
@@ -189,6 +189,7 @@ Dns4Configure (
 
   UINT32                    ServerListCount;
   EFI_IPv4_ADDRESS          *ServerList;
+  UINT32                    Index;
 
   Status     = EFI_SUCCESS;
   ServerList = NULL;
@@ -226,6 +227,12 @@ Dns4Configure (
     }
     ZeroMem (&Instance->Dns4CfgData, sizeof (EFI_DNS4_CONFIG_DATA));
 
+    if (Instance->SessionDnsServerList != NULL) {
+      FreePool (Instance->SessionDnsServerList);
+      Instance->SessionDnsServerList = NULL;
+    }
+    Instance->SessionDnsServerCount = 0;
+
     Instance->State = DNS_STATE_UNCONFIGED;
   } else {
     //
@@ -267,9 +274,18 @@ Dns4Configure (
 
       OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-      CopyMem (&Instance->SessionDnsServer.v4, &ServerList[0], sizeof (EFI_IPv4_ADDRESS));
+      Status = DnsSetSessionServers (Instance, ServerListCount, ServerList);
+      FreePool (ServerList);
     } else {
-      CopyMem (&Instance->SessionDnsServer.v4, &DnsConfigData->DnsServerList[0], sizeof (EFI_IPv4_ADDRESS));
+      Status = DnsSetSessionServers (Instance, DnsConfigData->DnsServerListCount, DnsConfigData->DnsServerList);
+    }
+
+    if (EFI_ERROR (Status)) {
+      if (Instance->Dns4CfgData.DnsServerList != NULL) {
+        FreePool (Instance->Dns4CfgData.DnsServerList);
+        Instance->Dns4CfgData.DnsServerList = NULL;
+      }
+      goto ON_EXIT;
     }
 
     //
@@ -285,9 +301,14 @@ Dns4Configure (
     }
 
     //
-    // Add configured DNS server used by this instance to ServerList.
+    // Add configured DNS servers used by this instance to ServerList.
     //
-    Status = AddDns4ServerIp (&mDriverData->Dns4ServerList, Instance->SessionDnsServer.v4);
+    for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+      Status = AddDns4ServerIp (&mDriverData->Dns4ServerList, Instance->SessionDnsServerList[Index].v4);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
     if (EFI_ERROR (Status)) {
       if (Instance->Dns4CfgData.DnsServerList != NULL) {
         FreePool (Instance->Dns4CfgData.DnsServerList);
@@ -1033,6 +1054,7 @@ Dns6Configure (
 
   UINT32                    ServerListCount;
   EFI_IPv6_ADDRESS          *ServerList;
+  UINT32                    Index;
 
   Status     = EFI_SUCCESS;
   ServerList = NULL;
@@ -1070,6 +1092,12 @@ Dns6Configure (
     }
     ZeroMem (&Instance->Dns6CfgData, sizeof (EFI_DNS6_CONFIG_DATA));
 
+    if (Instance->SessionDnsServerList != NULL) {
+      FreePool (Instance->SessionDnsServerList);
+      Instance->SessionDnsServerList = NULL;
+    }
+    Instance->SessionDnsServerCount = 0;
+
     Instance->State = DNS_STATE_UNCONFIGED;
   } else {
     //
@@ -1105,9 +1133,18 @@ Dns6Configure (
 
       OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-      CopyMem (&Instance->SessionDnsServer.v6, &ServerList[0], sizeof (EFI_IPv6_ADDRESS));
+      Status = DnsSetSessionServers (Instance, ServerListCount, ServerList);
+      FreePool (ServerList);
     } else {
-      CopyMem (&Instance->SessionDnsServer.v6, &DnsConfigData->DnsServerList[0], sizeof (EFI_IPv6_ADDRESS));
+      Status = DnsSetSessionServers (Instance, DnsConfigData->DnsServerCount, DnsConfigData->DnsServerList);
+    }
+
+    if (EFI_ERROR (Status)) {
+      if (Instance->Dns6CfgData.DnsServerList != NULL) {
+        FreePool (Instance->Dns6CfgData.DnsServerList);
+        Instance->Dns6CfgData.DnsServerList = NULL;
+      }
+      goto ON_EXIT;
     }
 
     //
@@ -1125,9 +1162,14 @@ Dns6Configure (
     }
 
     //
-    // Add configured DNS server used by this instance to ServerList.
+    // Add configured DNS servers used by this instance to ServerList.
     //
-    Status = AddDns6ServerIp (&mDriverData->Dns6ServerList, Instance->SessionDnsServer.v6);
+    for (Index = 0; Index < Instance->SessionDnsServerCount; Index++) {
+      Status = AddDns6ServerIp (&mDriverData->Dns6ServerList, Instance->SessionDnsServerList[Index].v6);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
     if (EFI_ERROR (Status)) {
       if (Instance->Dns6CfgData.DnsServerList != NULL) {
         FreePool (Instance->Dns6CfgData.DnsServerList);
@@ -36,8 +36,9 @@ UINTN  mMaxDpcQueueDepth = 0;
 //
 // Free list of DPC entries.  As DPCs are queued, entries are removed from this
 // free list.  As DPC entries are dispatched, DPC entries are added to the free list.
-// If the free list is empty and a DPC is queued, the free list is grown by allocating
-// an additional set of DPC entries.
+// The free list is filled with DPC_INITIAL_ENTRIES entries when the driver is
+// loaded. If the free list is empty and a DPC is queued, the free list is grown
+// by allocating an additional array of DPC_GROW_ENTRIES entries.
 //
 LIST_ENTRY      mDpcEntryFreeList = INITIALIZE_LIST_HEAD_VARIABLE(mDpcEntryFreeList);
 
@@ -48,6 +49,34 @@ LIST_ENTRY      mDpcEntryFreeList = INITIALIZE_LIST_HEAD_VARIABLE(mDpcEntryFreeL
 //
 LIST_ENTRY      mDpcQueue[TPL_HIGH_LEVEL + 1];
 
+//
+// Bit N is set when the DPC queue of EFI_TPL N is not empty, so that dispatching
+// finds the queued DPCs without walking all the queues.
+//
+UINT32          mDpcQueueBitmap = 0;
+
+/**
+  Add an array of DPC entries to the DPC free list.
+
+  The caller must be at TPL_HIGH_LEVEL.
+
+  @param  DpcEntries  The array of DPC entries.
+  @param  Count       The number of entries in DpcEntries.
+
+**/
+VOID
+DpcAddFreeEntries (
+  IN DPC_ENTRY  *DpcEntries,
+  IN UINTN      Count
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    InsertTailList (&mDpcEntryFreeList, &DpcEntries[Index].ListEntry);
+  }
+}
+
 /**
   Add a Deferred Procedure Call to the end of the DPC queue.
 
@@ -76,7 +105,6 @@ DpcQueueDpc (
   EFI_STATUS  ReturnStatus;
   EFI_TPL     OriginalTpl;
   DPC_ENTRY   *DpcEntry;
-  UINTN       Index;
 
   //
   // Make sure DpcTpl is valid
@@ -118,39 +146,31 @@ DpcQueueDpc (
     }
 
     //
-    // Add 64 DPC entries to the free list
+    // Lower the TPL level to perform a memory allocation
+    //
+    gBS->RestoreTPL (OriginalTpl);
+
+    //
+    // Allocate an array of DPC_GROW_ENTRIES new DPC entries
+    //
+    DpcEntry = AllocatePool (DPC_GROW_ENTRIES * sizeof (DPC_ENTRY));
+
+    //
+    // Raise the TPL level back to TPL_HIGH_LEVEL for DPC list operations
+    //
+    gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+    if (DpcEntry != NULL) {
+      DpcAddFreeEntries (DpcEntry, DPC_GROW_ENTRIES);
+    }
+
+    //
+    // If the allocation of the DPC entries fails, and the free list is still
+    // empty, then return EFI_OUT_OF_RESOURCES.
     //
-    for (Index = 0; Index < 64; Index++) {
-      //
-      // Lower the TPL level to perform a memory allocation
-      //
-      gBS->RestoreTPL (OriginalTpl);
-
-      //
-      // Allocate a new DPC entry
-      //
-      DpcEntry = AllocatePool (sizeof (DPC_ENTRY));
-
-      //
-      // Raise the TPL level back to TPL_HIGH_LEVEL for DPC list operations
-      //
-      gBS->RaiseTPL (TPL_HIGH_LEVEL);
-
-      //
-      // If the allocation of a DPC entry fails, and the free list is empty,
-      // then return EFI_OUT_OF_RESOURCES.
-      //
-      if (DpcEntry == NULL) {
-        if (IsListEmpty (&mDpcEntryFreeList)) {
-          ReturnStatus = EFI_OUT_OF_RESOURCES;
-          goto Done;
-        }
-      }
-
-      //
-      // Add the newly allocated DPC entry to the DPC free list
-      //
-      InsertTailList (&mDpcEntryFreeList, &DpcEntry->ListEntry);
+    if (IsListEmpty (&mDpcEntryFreeList)) {
+      ReturnStatus = EFI_OUT_OF_RESOURCES;
+      goto Done;
     }
   }
 
@@ -174,6 +194,7 @@ DpcQueueDpc (
   // Add the DPC entry to the end of the list for the specified DplTpl.
   //
   InsertTailList (&mDpcQueue[DpcTpl], &DpcEntry->ListEntry);
+  mDpcQueueBitmap |= (UINT32) (1U << DpcTpl);
 
   //
   // Increment the measured DPC queue depth across all TPLs
@@ -231,58 +252,58 @@ DpcDispatchDpc (
   OriginalTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
 
   //
-  // Check to see if there are 1 or more DPCs currently queued
+  // Dispatch from the highest non-empty DPC queue whose TPL is not lower than
+  // the current TPL value, until all of those queues are empty. A DPC queued
+  // by an invoked DPC at a higher TPL is therefore invoked next.
   //
-  if (mDpcQueueDepth > 0) {
+  while (mDpcQueueBitmap != 0) {
+    Tpl = (EFI_TPL) HighBitSet32 (mDpcQueueBitmap);
+    if (Tpl < OriginalTpl) {
+      break;
+    }
+
     //
-    // Loop from TPL_HIGH_LEVEL down to the current TPL value
+    // Retrieve the first DPC entry from the DPC queue specified by Tpl
+    //
+    DpcEntry = (DPC_ENTRY *)(GetFirstNode (&mDpcQueue[Tpl]));
+
     //
-    for (Tpl = TPL_HIGH_LEVEL; Tpl >= OriginalTpl; Tpl--) {
-      //
-      // Check to see if the DPC queue is empty
-      //
-      while (!IsListEmpty (&mDpcQueue[Tpl])) {
-        //
-        // Retrieve the first DPC entry from the DPC queue specified by Tpl
-        //
-        DpcEntry = (DPC_ENTRY *)(GetFirstNode (&mDpcQueue[Tpl]));
-
-        //
-        // Remove the first DPC entry from the DPC queue specified by Tpl
-        //
-        RemoveEntryList (&DpcEntry->ListEntry);
-
-        //
-        // Decrement the measured DPC Queue Depth across all TPLs
-        //
-        mDpcQueueDepth--;
-
-        //
-        // Lower the TPL to TPL value of the current DPC queue
-        //
-        gBS->RestoreTPL (Tpl);
-
-        //
-        // Invoke the DPC passing in its context
-        //
-        (DpcEntry->DpcProcedure) (DpcEntry->DpcContext);
-
-        //
-        // At least one DPC has been invoked, so set the return status to EFI_SUCCESS
-        //
-        ReturnStatus = EFI_SUCCESS;
-
-        //
-        // Raise the TPL level back to TPL_HIGH_LEVEL for DPC list operations
-        //
-        gBS->RaiseTPL (TPL_HIGH_LEVEL);
-
-        //
-        // Add the invoked DPC entry to the DPC free list
-        //
-        InsertTailList (&mDpcEntryFreeList, &DpcEntry->ListEntry);
-      }
+    // Remove the first DPC entry from the DPC queue specified by Tpl
+    //
+    RemoveEntryList (&DpcEntry->ListEntry);
+    if (IsListEmpty (&mDpcQueue[Tpl])) {
+      mDpcQueueBitmap &= ~(UINT32) (1U << Tpl);
     }
+
+    //
+    // Decrement the measured DPC Queue Depth across all TPLs
+    //
+    mDpcQueueDepth--;
+
+    //
+    // Lower the TPL to TPL value of the current DPC queue
+    //
+    gBS->RestoreTPL (Tpl);
+
+    //
+    // Invoke the DPC passing in its context
+    //
+    (DpcEntry->DpcProcedure) (DpcEntry->DpcContext);
+
+    //
+    // At least one DPC has been invoked, so set the return status to EFI_SUCCESS
+    //
+    ReturnStatus = EFI_SUCCESS;
+
+    //
+    // Raise the TPL level back to TPL_HIGH_LEVEL for DPC list operations
+    //
+    gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+    //
+    // Add the invoked DPC entry to the DPC free list
+    //
+    InsertTailList (&mDpcEntryFreeList, &DpcEntry->ListEntry);
   }
 
   //
@@ -313,6 +334,7 @@ DpcDriverEntryPoint (
 {
   EFI_STATUS  Status;
   UINTN       Index;
+  DPC_ENTRY   *DpcEntries;
 
   //
   // ASSERT() if the EFI_DPC_PROTOCOL is already present in the handle database
@@ -326,6 +348,16 @@ DpcDriverEntryPoint (
     InitializeListHead (&mDpcQueue[Index]);
   }
 
+  //
+  // Preallocate the DPC entries, so that queuing DPCs doesn't need to allocate
+  // memory unless more than DPC_INITIAL_ENTRIES DPCs are queued at once. DPCs
+  // can't be queued yet, so the free list is updated without raising the TPL.
+  //
+  DpcEntries = AllocatePool (DPC_INITIAL_ENTRIES * sizeof (DPC_ENTRY));
+  if (DpcEntries != NULL) {
+    DpcAddFreeEntries (DpcEntries, DPC_INITIAL_ENTRIES);
+  }
+
   //
   // Install the EFI_DPC_PROTOCOL instance onto a new handle
   //
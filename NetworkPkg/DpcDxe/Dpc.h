@@ -33,6 +33,13 @@ typedef struct {
   VOID               *DpcContext;
 } DPC_ENTRY;
 
+//
+// Number of DPC entries preallocated when the driver is loaded, and number of
+// DPC entries added at once when the free list runs empty.
+//
+#define DPC_INITIAL_ENTRIES  256
+#define DPC_GROW_ENTRIES     64
+
 /**
   Add a Deferred Procedure Call to the end of the DPC queue.
 
@@ -580,17 +580,19 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance to the boot file server.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+HttpBootOpenHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private,
+     OUT HTTP_IO                      *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA          ConfigData;
@@ -620,8 +622,30 @@ HttpBootCreateHttpIo (
              &ConfigData,
              HttpBootHttpIoCallback,
              (VOID *) Private,
-             &Private->HttpIo
+             HttpIo
              );
+  return Status;
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+  )
+{
+  EFI_STATUS                   Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootOpenHttpIo (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -870,6 +894,337 @@ HttpBootGetBootFileCallback (
   return EFI_SUCCESS;
 }
 
+/**
+  Check the response header received on a connection of the parallel download.
+
+  @param[in]  Connection         The connection which received the response header.
+  @param[in]  Message            The received response message.
+
+  @retval EFI_SUCCESS            The server sent the byte range requested on the connection.
+  @retval EFI_UNSUPPORTED        The server didn't send the requested byte range.
+
+**/
+EFI_STATUS
+HttpBootCheckRangeResponse (
+  IN     HTTP_BOOT_RANGE_CONNECTION   *Connection,
+  IN     EFI_HTTP_MESSAGE             *Message
+  )
+{
+  EFI_HTTP_HEADER            *Header;
+  CHAR8                      *RangeEnd;
+
+  if (Connection->Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The Content-Range of the response should be "bytes <first>-<last>/<length>".
+  //
+  Header = HttpFindHeader (Message->HeaderCount, Message->Headers, HTTP_HEADER_CONTENT_RANGE);
+  if ((Header == NULL) || (AsciiStrnCmp (Header->FieldValue, "bytes ", 6) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  RangeEnd = AsciiStrStr (Header->FieldValue, "-");
+  if ((RangeEnd == NULL) ||
+      (AsciiStrDecimalToUintn (Header->FieldValue + 6) != Connection->RangeStart) ||
+      (AsciiStrDecimalToUintn (RangeEnd + 1) != Connection->RangeStart + Connection->RangeLength - 1)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  This function downloads the boot file over several HTTP connections in parallel.
+  Each connection requests a separate byte range of the file, and receives the
+  message-body into its part of Buffer directly.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in]       FileSize        The size of the boot file in bytes.
+  @param[out]      Buffer          The memory buffer to transfer the file to, which is at
+                                   least FileSize bytes.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The parallel download is disabled, the file is too small for
+                                   it, or the server doesn't serve byte ranges of the file. The
+                                   file should be downloaded over a single connection instead.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_TIMEOUT              No response data was received in HTTP_BOOT_RESPONSE_TIMEOUT.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileParallel (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN     CHAR16                   *Url,
+  IN     UINTN                    FileSize,
+     OUT UINT8                    *Buffer,
+     OUT HTTP_BOOT_IMAGE_TYPE     *ImageType
+  )
+{
+  EFI_STATUS                   Status;
+  UINTN                        ConnectionCount;
+  UINTN                        DoneCount;
+  UINTN                        Index;
+  HTTP_BOOT_RANGE_CONNECTION   *Connections;
+  HTTP_BOOT_RANGE_CONNECTION   *Connection;
+  HTTP_IO                      *HttpIo;
+  EFI_HTTP_MESSAGE             *Message;
+  HTTP_IO_HEADER               *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA        RequestData;
+  CHAR8                        *HostName;
+  CHAR8                        RangeValue[48];
+  EFI_EVENT                    TimeoutEvent;
+
+  ConnectionCount = MIN (PcdGet8 (PcdHttpBootParallelConnections), HTTP_BOOT_MAX_PARALLEL_CONNECTIONS);
+  ConnectionCount = MIN (ConnectionCount, FileSize / HTTP_BOOT_MIN_RANGE_SIZE);
+  if (ConnectionCount < 2) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Connections = AllocateZeroPool (ConnectionCount * sizeof (HTTP_BOOT_RANGE_CONNECTION));
+  if (Connections == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  TimeoutEvent = NULL;
+
+  //
+  // Build the HTTP header for the requests, 4 header is needed:
+  //       Host
+  //       Accept
+  //       User-Agent
+  //       Range
+  //
+  HttpIoHeader = HttpBootCreateHeader (4);
+  if (HttpIoHeader == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  HostName = NULL;
+  Status = HttpUrlGetHostName (
+             Private->BootFileUri,
+             Private->BootFileUriParser,
+             &HostName
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+  Status = HttpBootSetHeader (HttpIoHeader, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpBootSetHeader (HttpIoHeader, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpBootSetHeader (HttpIoHeader, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+
+  //
+  // Split the file into byte ranges, and send the request for each range on
+  // a connection of its own. The driver's HttpIo isn't used, so that it's
+  // still usable if the file has to be downloaded in a single request.
+  //
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Connection = &Connections[Index];
+    Connection->RangeStart  = Index * (FileSize / ConnectionCount);
+    if (Index == ConnectionCount - 1) {
+      Connection->RangeLength = FileSize - Connection->RangeStart;
+    } else {
+      Connection->RangeLength = FileSize / ConnectionCount;
+    }
+
+    Status = HttpBootOpenHttpIo (Private, &Connection->HttpIo);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+    Connection->HttpCreated = TRUE;
+
+    AsciiSPrint (
+      RangeValue,
+      sizeof (RangeValue),
+      "bytes=%Lu-%Lu",
+      (UINT64) Connection->RangeStart,
+      (UINT64) (Connection->RangeStart + Connection->RangeLength - 1)
+      );
+    Status = HttpBootSetHeader (HttpIoHeader, HTTP_HEADER_RANGE, RangeValue);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Status = HttpIoSendRequest (
+               &Connection->HttpIo,
+               &RequestData,
+               HttpIoHeader->HeaderCount,
+               HttpIoHeader->Headers,
+               0,
+               NULL
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Receive the responses on all the connections at the same time. Once the
+  // response token of a connection completes, the next one is queued to it,
+  // and the message-body is received into its range of Buffer directly.
+  //
+  TimeoutEvent = Connections[0].HttpIo.TimeoutEvent;
+  Status = gBS->SetTimer (TimeoutEvent, TimerRelative, HTTP_BOOT_RESPONSE_TIMEOUT * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  DoneCount = 0;
+  while (DoneCount < ConnectionCount) {
+    for (Index = 0; Index < ConnectionCount; Index++) {
+      Connection = &Connections[Index];
+      if (Connection->HeaderReceived && (Connection->ReceivedSize == Connection->RangeLength)) {
+        continue;
+      }
+
+      HttpIo  = &Connection->HttpIo;
+      Message = HttpIo->RspToken.Message;
+      if (!Connection->RxPending) {
+        HttpIo->RspToken.Status = EFI_NOT_READY;
+        Message->HeaderCount    = 0;
+        Message->Headers        = NULL;
+        if (!Connection->HeaderReceived) {
+          Message->Data.Response = &Connection->Response;
+          Message->BodyLength    = 0;
+          Message->Body          = NULL;
+        } else {
+          Message->Data.Response = NULL;
+          Message->BodyLength    = Connection->RangeLength - Connection->ReceivedSize;
+          Message->Body          = Buffer + Connection->RangeStart + Connection->ReceivedSize;
+        }
+
+        HttpIo->IsRxDone = FALSE;
+        Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+        Connection->RxPending = TRUE;
+      }
+
+      HttpIo->Http->Poll (HttpIo->Http);
+      if (!HttpIo->IsRxDone) {
+        continue;
+      }
+
+      HttpIo->IsRxDone      = FALSE;
+      Connection->RxPending = FALSE;
+
+      Status = HttpIo->RspToken.Status;
+      if (!Connection->HeaderReceived) {
+        if (Status == EFI_HTTP_ERROR) {
+          //
+          // Let the single request report the error status code to the user.
+          //
+          Status = EFI_UNSUPPORTED;
+        }
+
+        if (!EFI_ERROR (Status) && (HttpIo->Callback != NULL)) {
+          Status = HttpIo->Callback (HttpIoResponse, Message, HttpIo->Context);
+        }
+
+        if (!EFI_ERROR (Status)) {
+          Status = HttpBootCheckRangeResponse (Connection, Message);
+        }
+
+        if (!EFI_ERROR (Status) && (Index == 0)) {
+          Status = HttpBootCheckImageType (
+                     Private->BootFileUri,
+                     Private->BootFileUriParser,
+                     Message->HeaderCount,
+                     Message->Headers,
+                     ImageType
+                     );
+        }
+
+        HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+        Message->Headers     = NULL;
+        Message->HeaderCount = 0;
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+
+        Connection->HeaderReceived = TRUE;
+      } else {
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+
+        Connection->ReceivedSize += Message->BodyLength;
+        if (Private->HttpBootCallback != NULL) {
+          Status = Private->HttpBootCallback->Callback (
+                     Private->HttpBootCallback,
+                     HttpBootHttpEntityBody,
+                     TRUE,
+                     (UINT32) Message->BodyLength,
+                     Message->Body
+                     );
+          if (EFI_ERROR (Status)) {
+            goto ON_EXIT;
+          }
+        }
+
+        if (Connection->ReceivedSize == Connection->RangeLength) {
+          DoneCount++;
+        }
+      }
+
+      //
+      // Restart the timer as long as the server keeps sending data.
+      //
+      gBS->SetTimer (TimeoutEvent, TimerRelative, HTTP_BOOT_RESPONSE_TIMEOUT * TICKS_PER_MS);
+    }
+
+    if (!EFI_ERROR (gBS->CheckEvent (TimeoutEvent))) {
+      Status = EFI_TIMEOUT;
+      goto ON_EXIT;
+    }
+  }
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  if (TimeoutEvent != NULL) {
+    gBS->SetTimer (TimeoutEvent, TimerCancel, 0);
+  }
+
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Connection = &Connections[Index];
+    if (Connection->HttpCreated) {
+      if (Connection->RxPending) {
+        Connection->HttpIo.Http->Cancel (Connection->HttpIo.Http, &Connection->HttpIo.RspToken);
+      }
+      HttpIoDestroyIo (&Connection->HttpIo);
+    }
+  }
+
+  if (HttpIoHeader != NULL) {
+    HttpBootFreeHeader (HttpIoHeader);
+  }
+  FreePool (Connections);
+
+  return Status;
+}
+
 /**
   This function download the boot file by using UEFI HTTP protocol.
 
@@ -920,6 +1275,7 @@ HttpBootGetBootFile (
   CHAR16                     *Url;
   BOOLEAN                    IdentityMode;
   UINTN                      ReceivedSize;
+  BOOLEAN                    CacheBody;
 
   ASSERT (Private != NULL);
   ASSERT (Private->HttpCreated);
@@ -950,8 +1306,20 @@ HttpBootGetBootFile (
   }
 
   //
-  // Not found in cache, try to download it through HTTP.
+  // Not found in cache, try to download it through HTTP. If the file size is
+  // already known, try to download it over several connections in parallel.
   //
+  if (!HeaderOnly && (Buffer != NULL) &&
+      (Private->BootFileSize != 0) && (Private->BootFileSize <= *BufferSize)) {
+    Status = HttpBootGetBootFileParallel (Private, Url, Private->BootFileSize, Buffer, ImageType);
+    if (Status != EFI_UNSUPPORTED) {
+      if (!EFI_ERROR (Status)) {
+        *BufferSize = Private->BootFileSize;
+      }
+      FreePool (Url);
+      return Status;
+    }
+  }
 
   //
   // 1. Create a temp cache item for the requested URI if caller doesn't provide buffer.
@@ -1111,6 +1479,19 @@ HttpBootGetBootFile (
     Cache->ImageType = *ImageType;
   }
 
+  //
+  // RAM disk images may be several GB large. Their message-body isn't kept in
+  // the cache, otherwise the whole image would be held in pool while the
+  // caller allocates the RAM disk buffer for it. The caller downloads it
+  // again straight into that buffer instead, which is registered as the RAM
+  // disk in place.
+  //
+  if ((*ImageType == ImageTypeVirtualCd) || (*ImageType == ImageTypeVirtualDisk)) {
+    CacheBody = FALSE;
+  } else {
+    CacheBody = (BOOLEAN) (Cache != NULL);
+  }
+
   //
   // 3.3 Init a message-body parser from the header information.
   //
@@ -1120,7 +1501,7 @@ HttpBootGetBootFile (
   Context.CopyedSize = 0;
   Context.Buffer     = Buffer;
   Context.BufferSize = *BufferSize;
-  Context.Cache      = Cache;
+  Context.Cache      = CacheBody ? Cache : NULL;
   Context.Private    = Private;
   Status = HttpInitMsgParser (
              HeaderOnly ? HttpMethodHead : HttpMethodGet,
@@ -1199,11 +1580,11 @@ HttpBootGetBootFile (
       while (!HttpIsMessageComplete (Parser)) {
         //
         // Allocate a buffer in Block to hold the message-body.
-        // If caller provides a buffer, this Block will be reused in every HttpIoRecvResponse().
-        // Otherwise a buffer, the buffer in Block will be cached and we should allocate a new before
+        // If the message-body isn't cached, this Block will be reused in every HttpIoRecvResponse().
+        // Otherwise the buffer in Block will be cached and we should allocate a new before
         // every HttpIoRecvResponse().
         //
-        if (Block == NULL || Context.BufferSize == 0) {
+        if (Block == NULL || Context.Cache != NULL) {
           Block = AllocatePool (HTTP_BOOT_BLOCK_SIZE);
           if (Block == NULL) {
             Status = EFI_OUT_OF_RESOURCES;
@@ -1263,13 +1644,20 @@ HttpBootGetBootFile (
   // 4. Save the cache item to driver's cache list and return.
   //
   if (Cache != NULL) {
-    Cache->EntityLength = ContentLength;
-    InsertTailList (&Private->CacheList, &Cache->Link);
+    if (CacheBody) {
+      Cache->EntityLength = ContentLength;
+      InsertTailList (&Private->CacheList, &Cache->Link);
+    } else {
+      HttpBootFreeCache (Cache);
+    }
   }
 
   if (Parser != NULL) {
     HttpFreeMsgParser (Parser);
   }
+  if (Context.Block != NULL) {
+    FreePool (Context.Block);
+  }
 
   return Status;
 
@@ -13,6 +13,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_REQUEST_TIMEOUT            5000      // 5 seconds in uints of millisecond.
 #define HTTP_BOOT_RESPONSE_TIMEOUT           5000      // 5 seconds in uints of millisecond.
 #define HTTP_BOOT_BLOCK_SIZE                 1500
+#define HTTP_BOOT_MAX_PARALLEL_CONNECTIONS   8
+#define HTTP_BOOT_MIN_RANGE_SIZE             SIZE_1MB  // Smallest byte range downloaded by one parallel connection.
 
 
 
@@ -62,6 +64,21 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// A connection of the parallel download, which receives the bytes
+// [RangeStart, RangeStart + RangeLength) of the boot file.
+//
+typedef struct {
+  HTTP_IO                    HttpIo;
+  BOOLEAN                    HttpCreated;
+  EFI_HTTP_RESPONSE_DATA     Response;
+  UINTN                      RangeStart;
+  UINTN                      RangeLength;
+  UINTN                      ReceivedSize;
+  BOOLEAN                    HeaderReceived;
+  BOOLEAN                    RxPending;       // A response token is queued to HttpIo.
+} HTTP_BOOT_RANGE_CONNECTION;
+
 /**
   Discover all the boot information for boot file.
 
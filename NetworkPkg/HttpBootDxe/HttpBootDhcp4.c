@@ -570,6 +570,29 @@ HttpBootSelectDhcpOffer (
   }
 }
 
+/**
+  Check whether an offer of the highest priority HttpBootSelectDhcpOffer() selects
+  by has been cached already, so that waiting for more offers can't change the
+  selection.
+
+  @param[in]  Private             Pointer to HTTP boot driver private data.
+
+  @retval TRUE                    The offer HttpBootSelectDhcpOffer() will select is cached.
+  @retval FALSE                   A preferred offer may still be received.
+
+**/
+BOOLEAN
+HttpBootHasPreferredDhcpOffer (
+  IN HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  if (Private->FilePathUri != NULL) {
+    return (BOOLEAN) (Private->OfferCount[HttpOfferTypeDhcpDns] > 0);
+  }
+
+  return (BOOLEAN) (Private->OfferCount[HttpOfferTypeDhcpIpUri] > 0);
+}
+
 
 /**
   EFI_DHCP4_CALLBACK is provided by the consumer of the EFI DHCPv4 Protocol driver
@@ -665,6 +688,14 @@ HttpBootDhcp4CallBack (
       // If error happens, just ignore this packet and continue to wait more offer.
       //
       HttpBootCacheDhcp4Offer (Private, Packet);
+
+      //
+      // Select the offers right away once the preferred one is received,
+      // instead of waiting for more offers until the discover timeout expires.
+      //
+      if (HttpBootHasPreferredDhcpOffer (Private)) {
+        Status = EFI_SUCCESS;
+      }
     }
     break;
 
@@ -217,6 +217,22 @@ HttpBootSelectDhcpOffer (
   IN HTTP_BOOT_PRIVATE_DATA  *Private
   );
 
+/**
+  Check whether an offer of the highest priority HttpBootSelectDhcpOffer() selects
+  by has been cached already, so that waiting for more offers can't change the
+  selection.
+
+  @param[in]  Private             Pointer to HTTP boot driver private data.
+
+  @retval TRUE                    The offer HttpBootSelectDhcpOffer() will select is cached.
+  @retval FALSE                   A preferred offer may still be received.
+
+**/
+BOOLEAN
+HttpBootHasPreferredDhcpOffer (
+  IN HTTP_BOOT_PRIVATE_DATA  *Private
+  );
+
 /**
   Start the D.O.R.A DHCPv4 process to acquire the IPv4 address and other Http boot information.
 
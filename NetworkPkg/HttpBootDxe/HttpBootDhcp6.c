@@ -472,6 +472,14 @@ HttpBootDhcp6CallBack (
       // If error happens, just ignore this packet and continue to wait more offer.
       //
       HttpBootCacheDhcp6Offer (Private, Packet);
+
+      //
+      // Select the offers right away once the preferred one is received,
+      // instead of waiting for more advertisements until the first RT elapses.
+      //
+      if (HttpBootHasPreferredDhcpOffer (Private)) {
+        Status = EFI_SUCCESS;
+      }
     }
     break;
 
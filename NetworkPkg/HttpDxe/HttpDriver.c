@@ -67,6 +67,7 @@ HttpCreateService (
   HttpService->ControllerHandle = Controller;
   HttpService->ChildrenNumber = 0;
   InitializeListHead (&HttpService->ChildrenList);
+  InitializeListHead (&HttpService->IdleConnections);
 
   *ServiceData = HttpService;
   return EFI_SUCCESS;
@@ -559,6 +560,8 @@ HttpDxeStop (
                  );
     } else {
 
+      HttpFlushIdleConnections (HttpService, UsingIpv6);
+
       HttpCleanService (HttpService, UsingIpv6);
 
       if (HttpService->Tcp4ChildHandle == NULL && HttpService->Tcp6ChildHandle == NULL) {
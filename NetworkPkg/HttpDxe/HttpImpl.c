@@ -438,6 +438,17 @@ EfiHttpRequest (
       // Request() is called the first time.
       //
       ReConfigure = FALSE;
+
+      //
+      // Take over an idle connection to the same server if the HTTP service
+      // kept one, it needs neither DNS resolution nor TCP and TLS handshakes.
+      //
+      if (HttpTakeIdleConnection (HttpInstance, HostName, RemotePort)) {
+        FreePool (HostName);
+        HostName     = NULL;
+        Configure    = FALSE;
+        TlsConfigure = FALSE;
+      }
     } else {
       if ((HttpInstance->RemotePort == RemotePort) &&
           (AsciiStrCmp (HttpInstance->RemoteHost, HostName) == 0) &&
@@ -835,6 +835,8 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL          *HttpInstance
   )
 {
+  HttpKeepIdleConnection (HttpInstance);
+
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -873,6 +875,7 @@ HttpCleanProtocol (
     // Destroy the TLS instance.
     //
     HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
+    HttpInstance->TlsChildHandle = NULL;
   }
 
   if (HttpInstance->Tcp4ChildHandle != NULL) {
@@ -942,6 +945,446 @@ HttpCleanProtocol (
   TlsCloseTxRxEvent (HttpInstance);
 }
 
+/**
+  Check whether the TCP connection of an idle connection is still established.
+
+  @param[in]  IdleConn           The idle connection.
+
+  @retval TRUE                   The TCP connection is established.
+  @retval FALSE                  The TCP connection is closing or closed.
+
+**/
+BOOLEAN
+HttpIdleConnectionAlive (
+  IN  HTTP_IDLE_CONNECTION   *IdleConn
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+
+  if (!IdleConn->LocalAddressIsIPv6) {
+    Status = IdleConn->Tcp4->GetModeData (IdleConn->Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+    return (BOOLEAN) (!EFI_ERROR (Status) && Tcp4State == Tcp4StateEstablished);
+  } else {
+    Status = IdleConn->Tcp6->GetModeData (IdleConn->Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+    return (BOOLEAN) (!EFI_ERROR (Status) && Tcp6State == Tcp6StateEstablished);
+  }
+}
+
+/**
+  Destroy the TLS and TCP child of an idle connection and free it. Destroying
+  the TCP child aborts the TCP connection.
+
+  @param[in]  HttpService        The HTTP service owning the idle connection.
+  @param[in]  IdleConn           The idle connection, already removed from the list.
+
+**/
+VOID
+HttpFreeIdleConnection (
+  IN  HTTP_SERVICE           *HttpService,
+  IN  HTTP_IDLE_CONNECTION   *IdleConn
+  )
+{
+  if (IdleConn->TlsSb != NULL && IdleConn->TlsChildHandle != NULL) {
+    IdleConn->TlsSb->DestroyChild (IdleConn->TlsSb, IdleConn->TlsChildHandle);
+  }
+
+  if (!IdleConn->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           IdleConn->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      IdleConn->TcpChildHandle
+      );
+  } else {
+    gBS->CloseProtocol (
+           IdleConn->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      IdleConn->TcpChildHandle
+      );
+  }
+
+  FreePool (IdleConn->RemoteHost);
+  FreePool (IdleConn);
+}
+
+/**
+  Move the connection of the HTTP instance to the idle connection pool of its
+  HTTP service, so that it can be reused by a later HTTP instance.
+
+  The connection is only kept if it is established, no request or response is
+  pending on it and the last response was received completely.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval TRUE                   The connection is kept, the HTTP instance no longer
+                                 owns its TCP and TLS child.
+  @retval FALSE                  The connection is not kept.
+
+**/
+BOOLEAN
+HttpKeepIdleConnection (
+  IN  HTTP_PROTOCOL          *HttpInstance
+  )
+{
+  HTTP_SERVICE               *HttpService;
+  HTTP_IDLE_CONNECTION       *IdleConn;
+  EFI_TPL                    OldTpl;
+
+  HttpService = HttpInstance->Service;
+
+  if (HttpService->IdleConnectionNumber >= PcdGet8 (PcdHttpIdleConnectionNumber)) {
+    return FALSE;
+  }
+
+  if (HttpInstance->State != HTTP_STATE_TCP_CONNECTED || HttpInstance->RemoteHost == NULL) {
+    return FALSE;
+  }
+
+  if (!NetMapIsEmpty (&HttpInstance->TxTokens) || !NetMapIsEmpty (&HttpInstance->RxTokens)) {
+    return FALSE;
+  }
+
+  //
+  // Any unread part of the last response would be taken as the start of the
+  // next response on this connection.
+  //
+  if ((HttpInstance->MsgParser != NULL && !HttpIsMessageComplete (HttpInstance->MsgParser)) ||
+      (HttpInstance->CacheBody != NULL && HttpInstance->CacheOffset < HttpInstance->CacheLen)) {
+    return FALSE;
+  }
+
+  if (HttpInstance->UseHttps && HttpInstance->TlsSessionState != EfiTlsSessionDataTransferring) {
+    return FALSE;
+  }
+
+  IdleConn = AllocateZeroPool (sizeof (HTTP_IDLE_CONNECTION));
+  if (IdleConn == NULL) {
+    return FALSE;
+  }
+
+  IdleConn->LocalAddressIsIPv6 = HttpInstance->LocalAddressIsIPv6;
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    IdleConn->TcpChildHandle = HttpInstance->Tcp4ChildHandle;
+    IdleConn->Tcp4           = HttpInstance->Tcp4;
+    CopyMem (&IdleConn->IPv4Node, &HttpInstance->IPv4Node, sizeof (IdleConn->IPv4Node));
+    IP4_COPY_ADDRESS (&IdleConn->RemoteAddr, &HttpInstance->RemoteAddr);
+  } else {
+    IdleConn->TcpChildHandle = HttpInstance->Tcp6ChildHandle;
+    IdleConn->Tcp6           = HttpInstance->Tcp6;
+    CopyMem (&IdleConn->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (IdleConn->Ipv6Node));
+    IP6_COPY_ADDRESS (&IdleConn->RemoteIpv6Addr, &HttpInstance->RemoteIpv6Addr);
+  }
+
+  if (!HttpIdleConnectionAlive (IdleConn)) {
+    FreePool (IdleConn);
+    return FALSE;
+  }
+
+  //
+  // The TCP child stays opened BY_DRIVER on the controller, only the HTTP
+  // instance stops being its child controller.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+  }
+
+  IdleConn->RemoteHost     = HttpInstance->RemoteHost;
+  IdleConn->RemotePort     = HttpInstance->RemotePort;
+  HttpInstance->RemoteHost = NULL;
+  HttpInstance->RemotePort = 0;
+
+  IdleConn->UseHttps = HttpInstance->UseHttps;
+  if (HttpInstance->UseHttps) {
+    IdleConn->TlsSb            = HttpInstance->TlsSb;
+    IdleConn->TlsChildHandle   = HttpInstance->TlsChildHandle;
+    IdleConn->Tls              = HttpInstance->Tls;
+    IdleConn->TlsConfiguration = HttpInstance->TlsConfiguration;
+    IdleConn->TlsSessionState  = HttpInstance->TlsSessionState;
+    CopyMem (&IdleConn->TlsConfigData, &HttpInstance->TlsConfigData, sizeof (TLS_CONFIG_DATA));
+
+    HttpInstance->TlsChildHandle   = NULL;
+    HttpInstance->Tls              = NULL;
+    HttpInstance->TlsConfiguration = NULL;
+  }
+
+  HttpInstance->State = HTTP_STATE_TCP_CLOSED;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  InsertTailList (&HttpService->IdleConnections, &IdleConn->Link);
+  HttpService->IdleConnectionNumber++;
+  gBS->RestoreTPL (OldTpl);
+
+  return TRUE;
+}
+
+/**
+  Take over an idle connection to the given server from the HTTP service.
+
+  On success the unused TCP and TLS child of the HTTP instance are destroyed
+  and replaced by the ones of the idle connection, and the HTTP instance is
+  in HTTP_STATE_TCP_CONNECTED state with RemoteHost and RemotePort set.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  HostName           The host name of the request URL.
+  @param[in]  RemotePort         The port of the request URL.
+
+  @retval TRUE                   An idle connection has been taken over.
+  @retval FALSE                  No usable idle connection to the server exists.
+
+**/
+BOOLEAN
+HttpTakeIdleConnection (
+  IN  HTTP_PROTOCOL          *HttpInstance,
+  IN  CHAR8                  *HostName,
+  IN  UINT16                 RemotePort
+  )
+{
+  HTTP_SERVICE               *HttpService;
+  HTTP_IDLE_CONNECTION       *IdleConn;
+  LIST_ENTRY                 *Entry;
+  LIST_ENTRY                 *Next;
+  BOOLEAN                    Found;
+  EFI_TPL                    OldTpl;
+  EFI_STATUS                 Status;
+  VOID                       *Interface;
+
+  HttpService = HttpInstance->Service;
+
+  if (HttpInstance->State != HTTP_STATE_HTTP_CONFIGED || IsListEmpty (&HttpService->IdleConnections)) {
+    return FALSE;
+  }
+
+  Found    = FALSE;
+  IdleConn = NULL;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->IdleConnections) {
+    IdleConn = NET_LIST_USER_STRUCT (Entry, HTTP_IDLE_CONNECTION, Link);
+
+    if (IdleConn->LocalAddressIsIPv6 != HttpInstance->LocalAddressIsIPv6 ||
+        IdleConn->UseHttps != HttpInstance->UseHttps ||
+        IdleConn->RemotePort != RemotePort ||
+        AsciiStrCmp (IdleConn->RemoteHost, HostName) != 0) {
+      continue;
+    }
+
+    if (!IdleConn->LocalAddressIsIPv6) {
+      if (CompareMem (&IdleConn->IPv4Node, &HttpInstance->IPv4Node, sizeof (IdleConn->IPv4Node)) != 0) {
+        continue;
+      }
+    } else {
+      if (CompareMem (&IdleConn->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (IdleConn->Ipv6Node)) != 0) {
+        continue;
+      }
+    }
+
+    RemoveEntryList (&IdleConn->Link);
+    HttpService->IdleConnectionNumber--;
+
+    if (HttpIdleConnectionAlive (IdleConn)) {
+      Found = TRUE;
+      break;
+    }
+
+    //
+    // The server has closed the connection in the meantime.
+    //
+    HttpFreeIdleConnection (HttpService, IdleConn);
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (!Found) {
+    return FALSE;
+  }
+
+  //
+  // Create the events of the HTTP instance the existing TCP and TLS session
+  // is driven with, which are otherwise created when they are configured.
+  //
+  Status = HttpCreateTcpConnCloseEvent (HttpInstance);
+  if (EFI_ERROR (Status)) {
+    HttpFreeIdleConnection (HttpService, IdleConn);
+    return FALSE;
+  }
+
+  if (IdleConn->UseHttps) {
+    Status = TlsCreateTxRxEvent (HttpInstance);
+    if (EFI_ERROR (Status)) {
+      HttpCloseTcpConnCloseEvent (HttpInstance);
+      HttpFreeIdleConnection (HttpService, IdleConn);
+      return FALSE;
+    }
+  }
+
+  if (!IdleConn->LocalAddressIsIPv6) {
+    Status = gBS->OpenProtocol (
+                    IdleConn->TcpChildHandle,
+                    &gEfiTcp4ProtocolGuid,
+                    &Interface,
+                    HttpService->Ip4DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  } else {
+    Status = gBS->OpenProtocol (
+                    IdleConn->TcpChildHandle,
+                    &gEfiTcp6ProtocolGuid,
+                    &Interface,
+                    HttpService->Ip6DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+  }
+
+  if (EFI_ERROR (Status)) {
+    TlsCloseTxRxEvent (HttpInstance);
+    HttpCloseTcpConnCloseEvent (HttpInstance);
+    HttpFreeIdleConnection (HttpService, IdleConn);
+    return FALSE;
+  }
+
+  //
+  // Destroy the TCP child created by Configure() and the TLS child created
+  // for this request, both are still unused.
+  //
+  if (!IdleConn->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      HttpInstance->Tcp4ChildHandle
+      );
+
+    HttpInstance->Tcp4ChildHandle = IdleConn->TcpChildHandle;
+    HttpInstance->Tcp4            = IdleConn->Tcp4;
+    IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &IdleConn->RemoteAddr);
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      HttpInstance->Tcp6ChildHandle
+      );
+
+    HttpInstance->Tcp6ChildHandle = IdleConn->TcpChildHandle;
+    HttpInstance->Tcp6            = IdleConn->Tcp6;
+    IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &IdleConn->RemoteIpv6Addr);
+  }
+
+  if (IdleConn->UseHttps) {
+    if (HttpInstance->TlsSb != NULL && HttpInstance->TlsChildHandle != NULL) {
+      HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
+    }
+
+    HttpInstance->TlsSb            = IdleConn->TlsSb;
+    HttpInstance->TlsChildHandle   = IdleConn->TlsChildHandle;
+    HttpInstance->Tls              = IdleConn->Tls;
+    HttpInstance->TlsConfiguration = IdleConn->TlsConfiguration;
+    HttpInstance->TlsSessionState  = IdleConn->TlsSessionState;
+    CopyMem (&HttpInstance->TlsConfigData, &IdleConn->TlsConfigData, sizeof (TLS_CONFIG_DATA));
+  }
+
+  HttpInstance->RemoteHost = IdleConn->RemoteHost;
+  HttpInstance->RemotePort = IdleConn->RemotePort;
+  HttpInstance->State      = HTTP_STATE_TCP_CONNECTED;
+
+  FreePool (IdleConn);
+
+  return TRUE;
+}
+
+/**
+  Close and release all the idle connections of the HTTP service which use
+  the given IP version.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          Release the TCP6 connections if TRUE, the TCP4
+                                 connections otherwise.
+
+**/
+VOID
+HttpFlushIdleConnections (
+  IN  HTTP_SERVICE           *HttpService,
+  IN  BOOLEAN                UsingIpv6
+  )
+{
+  HTTP_IDLE_CONNECTION       *IdleConn;
+  LIST_ENTRY                 *Entry;
+  LIST_ENTRY                 *Next;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->IdleConnections) {
+    IdleConn = NET_LIST_USER_STRUCT (Entry, HTTP_IDLE_CONNECTION, Link);
+    if (IdleConn->LocalAddressIsIPv6 != UsingIpv6) {
+      continue;
+    }
+
+    RemoveEntryList (&IdleConn->Link);
+    HttpService->IdleConnectionNumber--;
+    HttpFreeIdleConnection (HttpService, IdleConn);
+  }
+}
+
 /**
   Establish TCP connection with HTTP server.
 
@@ -1102,6 +1545,7 @@ HttpConfigureTcp4 (
   Tcp4Option->KeepAliveTime          = HTTP_KEEP_ALIVE_TIME;
   Tcp4Option->KeepAliveInterval      = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp4Option->EnableNagle            = TRUE;
+  Tcp4Option->EnableSelectiveAck     = PcdGetBool (PcdTcpSelectiveAck);
   Tcp4CfgData->ControlOption         = Tcp4Option;
 
   Status = HttpInstance->Tcp4->Configure (HttpInstance->Tcp4, Tcp4CfgData);
@@ -1173,6 +1617,7 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveTime      = HTTP_KEEP_ALIVE_TIME;
   Tcp6Option->KeepAliveInterval  = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle        = TRUE;
+  Tcp6Option->EnableSelectiveAck = PcdGetBool (PcdTcpSelectiveAck);
 
   Status = HttpInstance->Tcp6->Configure (HttpInstance->Tcp6, Tcp6CfgData);
   if (EFI_ERROR (Status)) {
@@ -61,6 +61,8 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                    ChildrenList;
   UINTN                         ChildrenNumber;
   INTN                          State;
+  LIST_ENTRY                    IdleConnections;      // List of HTTP_IDLE_CONNECTION.
+  UINTN                         IdleConnectionNumber;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -86,6 +88,35 @@ typedef struct {
   EFI_TLS_SESSION_STATE         SessionState;
 } TLS_CONFIG_DATA;
 
+//
+// An established connection kept by the HTTP service after the HTTP instance
+// which opened it was reset or destroyed. It is handed over to the next HTTP
+// instance requesting the same server from the same local access point.
+//
+typedef struct {
+  LIST_ENTRY                       Link;   // Link to IdleConnections of the service.
+  BOOLEAN                          LocalAddressIsIPv6;
+  EFI_HTTPv4_ACCESS_POINT          IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT          Ipv6Node;
+
+  CHAR8                            *RemoteHost;
+  UINT16                           RemotePort;
+  EFI_IPv4_ADDRESS                 RemoteAddr;
+  EFI_IPv6_ADDRESS                 RemoteIpv6Addr;
+
+  EFI_HANDLE                       TcpChildHandle;
+  EFI_TCP4_PROTOCOL                *Tcp4;
+  EFI_TCP6_PROTOCOL                *Tcp6;
+
+  BOOLEAN                          UseHttps;
+  EFI_SERVICE_BINDING_PROTOCOL     *TlsSb;
+  EFI_HANDLE                       TlsChildHandle;
+  TLS_CONFIG_DATA                  TlsConfigData;
+  EFI_TLS_PROTOCOL                 *Tls;
+  EFI_TLS_CONFIGURATION_PROTOCOL   *TlsConfiguration;
+  EFI_TLS_SESSION_STATE            TlsSessionState;
+} HTTP_IDLE_CONNECTION;
+
 //
 // Callback data for HTTP_PARSER_CALLBACK()
 //
@@ -334,6 +365,62 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL          *HttpInstance
   );
 
+/**
+  Move the connection of the HTTP instance to the idle connection pool of its
+  HTTP service, so that it can be reused by a later HTTP instance.
+
+  The connection is only kept if it is established, no request or response is
+  pending on it and the last response was received completely.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval TRUE                   The connection is kept, the HTTP instance no longer
+                                 owns its TCP and TLS child.
+  @retval FALSE                  The connection is not kept.
+
+**/
+BOOLEAN
+HttpKeepIdleConnection (
+  IN  HTTP_PROTOCOL          *HttpInstance
+  );
+
+/**
+  Take over an idle connection to the given server from the HTTP service.
+
+  On success the unused TCP and TLS child of the HTTP instance are destroyed
+  and replaced by the ones of the idle connection, and the HTTP instance is
+  in HTTP_STATE_TCP_CONNECTED state with RemoteHost and RemotePort set.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  HostName           The host name of the request URL.
+  @param[in]  RemotePort         The port of the request URL.
+
+  @retval TRUE                   An idle connection has been taken over.
+  @retval FALSE                  No usable idle connection to the server exists.
+
+**/
+BOOLEAN
+HttpTakeIdleConnection (
+  IN  HTTP_PROTOCOL          *HttpInstance,
+  IN  CHAR8                  *HostName,
+  IN  UINT16                 RemotePort
+  );
+
+/**
+  Close and release all the idle connections of the HTTP service which use
+  the given IP version.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          Release the TCP6 connections if TRUE, the TCP4
+                                 connections otherwise.
+
+**/
+VOID
+HttpFlushIdleConnections (
+  IN  HTTP_SERVICE           *HttpService,
+  IN  BOOLEAN                UsingIpv6
+  );
+
 /**
   Establish TCP connection with HTTP server.
 
@@ -1614,6 +1614,12 @@ IScsiCheckOpParams (
     Session->FirstBurstLength = (UINT32) MIN (Session->FirstBurstLength, NumericValue);
   }
 
+  //
+  // FirstBurstLength can't exceed MaxBurstLength, which the target may have
+  // lowered below the offered FirstBurstLength.
+  //
+  Session->FirstBurstLength = MIN (Session->FirstBurstLength, Session->MaxBurstLength);
+
   //
   // MaxConnections: result function is Minimum.
   //
@@ -3116,11 +3122,11 @@ IScsiSessionInit (
   Session->MaxConnections       = ISCSI_MAX_CONNS_PER_SESSION;
   Session->InitialR2T           = FALSE;
   Session->ImmediateData        = TRUE;
-  Session->MaxBurstLength       = 262144;
-  Session->FirstBurstLength     = MAX_RECV_DATA_SEG_LEN_IN_FFP;
+  Session->MaxBurstLength       = ISCSI_OFFERED_MAX_BURST_LENGTH;
+  Session->FirstBurstLength     = ISCSI_OFFERED_FIRST_BURST_LENGTH;
   Session->DefaultTime2Wait     = 2;
   Session->DefaultTime2Retain   = 20;
-  Session->MaxOutstandingR2T    = DEFAULT_MAX_OUTSTANDING_R2T;
+  Session->MaxOutstandingR2T    = ISCSI_OFFERED_MAX_OUTSTANDING_R2T;
   Session->DataPDUInOrder       = TRUE;
   Session->DataSequenceInOrder  = TRUE;
   Session->ErrorRecoveryLevel   = 0;
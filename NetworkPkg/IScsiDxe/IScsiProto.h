@@ -28,8 +28,17 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define ISCSI_MAX_CONNS_PER_SESSION             1
 
 #define DEFAULT_MAX_RECV_DATA_SEG_LEN           8192
-#define MAX_RECV_DATA_SEG_LEN_IN_FFP            65536
-#define DEFAULT_MAX_OUTSTANDING_R2T             1
+#define MAX_RECV_DATA_SEG_LEN_IN_FFP            262144
+
+//
+// Values offered in the operational parameter negotiation. Data-In is
+// received straight into the caller's buffer, and the R2Ts of a task are
+// served one after another, so larger bursts and several outstanding R2Ts
+// only cut the number of round trips per transfer.
+//
+#define ISCSI_OFFERED_MAX_BURST_LENGTH          1048576
+#define ISCSI_OFFERED_FIRST_BURST_LENGTH        MAX_RECV_DATA_SEG_LEN_IN_FFP
+#define ISCSI_OFFERED_MAX_OUTSTANDING_R2T       4
 
 #define ISCSI_VERSION_MAX                       0x00
 #define ISCSI_VERSION_MIN                       0x00
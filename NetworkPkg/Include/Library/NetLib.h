@@ -1547,6 +1547,7 @@ NetLibIp6ToStr (
 #define  NET_BUF_HEAD         1    // Trim or allocate space from head
 #define  NET_BUF_TAIL         0    // Trim or allocate space from tail
 #define  NET_VECTOR_OWN_FIRST 0x01  // We allocated the 1st block in the vector
+#define  NET_VECTOR_CACHED_FIRST 0x02  // The 1st block is from the net buffer block cache
 
 #define NET_CHECK_SIGNATURE(PData, SIGNATURE) \
   ASSERT (((PData) != NULL) && ((PData)->Signature == (SIGNATURE)))
@@ -141,6 +141,7 @@ struct _UDP_IO {
 
   LIST_ENTRY                SentDatagram;   ///< A list of UDP_TX_TOKEN.
   UDP_RX_TOKEN              *RecvRequest;
+  UDP_RX_TOKEN              *FreeRxToken;   ///< A recycled UDP_RX_TOKEN kept for the next receive.
 
   union {
     EFI_UDP4_PROTOCOL       *Udp4;
@@ -117,6 +117,7 @@ typedef struct {
   LIST_ENTRY                Link;
   IP4_PROTOCOL              *IpInstance;
   NET_BUF                   *Packet;
+  UINT8                     Head[IP4_MAX_HEADLEN];  ///< Private IP head of a shared packet
   EFI_IP4_RECEIVE_DATA      RxData;
 } IP4_RXDATA_WRAP;
 
@@ -49,11 +49,12 @@ Ip4CreateAssembleEntry (
   Assemble->Src      = Src;
   Assemble->Id       = Id;
   Assemble->Protocol = Protocol;
-  Assemble->TotalLen = 0;
-  Assemble->CurLen   = 0;
-  Assemble->Head     = NULL;
-  Assemble->Info     = NULL;
-  Assemble->Life     = IP4_FRAGMENT_LIFE;
+  Assemble->TotalLen    = 0;
+  Assemble->CurLen      = 0;
+  Assemble->FragmentNum = 0;
+  Assemble->Head        = NULL;
+  Assemble->Info        = NULL;
+  Assemble->Life        = IP4_FRAGMENT_LIFE;
 
   return Assemble;
 }
@@ -272,13 +273,27 @@ Ip4Reassemble (
   // fragment with THIS.Start < CUR.Start. the previous one
   // has PREV.Start <= THIS.Start < CUR.Start.
   //
+  // Fragments normally arrive in order, or in reverse order. So check the
+  // first fragment, then search backward from the last one: either way the
+  // point is found right away instead of walking the whole list for each
+  // fragment.
+  //
   Head = &Assemble->Fragments;
+  Cur  = Head->ForwardLink;
 
-  NET_LIST_FOR_EACH (Cur, Head) {
+  if (Cur != Head) {
     Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
 
-    if (This->Start < IP4_GET_CLIP_INFO (Fragment)->Start) {
-      break;
+    if (This->Start >= IP4_GET_CLIP_INFO (Fragment)->Start) {
+      for (Prev = Head->BackLink; Prev != Cur; Prev = Prev->BackLink) {
+        Fragment = NET_LIST_USER_STRUCT (Prev, NET_BUF, List);
+
+        if (IP4_GET_CLIP_INFO (Fragment)->Start <= This->Start) {
+          break;
+        }
+      }
+
+      Cur = Prev->ForwardLink;
     }
   }
 
@@ -306,7 +321,12 @@ Ip4Reassemble (
   // Insert the fragment into the packet. The fragment may be removed
   // from the list by the following checks.
   //
+  if (Assemble->FragmentNum >= IP4_MAX_FRAGMENT_NUM) {
+    goto DROP;
+  }
+
   NetListInsertBefore (Cur, &Packet->List);
+  Assemble->FragmentNum++;
 
   //
   // Check the packets after the insert point. It holds that:
@@ -326,6 +346,7 @@ Ip4Reassemble (
 
       RemoveEntryList (&Fragment->List);
       Assemble->CurLen -= Node->Length;
+      Assemble->FragmentNum--;
 
       NetbufFree (Fragment);
       continue;
@@ -340,6 +361,7 @@ Ip4Reassemble (
     if (Node->Start < This->End) {
       if (This->Start == Node->Start) {
         RemoveEntryList (&Packet->List);
+        Assemble->FragmentNum--;
         goto DROP;
       }
 
@@ -1158,7 +1180,7 @@ Ip4OnRecyclePacket (
   RemoveEntryList (&Wrap->Link);
   EfiReleaseLock (&Wrap->IpInstance->RecycleLock);
 
-  ASSERT (!NET_BUF_SHARED (Wrap->Packet));
+  ASSERT (Wrap->Packet->RefCnt == 1);
   NetbufFree (Wrap->Packet);
 
   gBS->CloseEvent (Wrap->RxData.RecycleSignal);
@@ -1228,6 +1250,15 @@ Ip4WrapRxData (
   // The application expects a network byte order header.
   //
   if (!RawData) {
+    //
+    // The head of a shared packet is also seen by the other IP children,
+    // convert a private copy of it instead.
+    //
+    if (NET_BUF_SHARED (Packet)) {
+      CopyMem (Wrap->Head, Packet->Ip.Ip4, Packet->Ip.Ip4->HeadLen << 2);
+      Packet->Ip.Ip4 = (IP4_HEAD *) Wrap->Head;
+    }
+
     RxData->HeaderLength  = (Packet->Ip.Ip4->HeadLen << 2);
     RxData->Header        = (EFI_IP4_HEADER *) Ip4NtohHead (Packet->Ip.Ip4);
     RxData->OptionsLength = RxData->HeaderLength - IP4_MIN_HEADLEN;
@@ -1252,9 +1283,11 @@ Ip4WrapRxData (
 
 /**
   Deliver the received packets to upper layer if there are both received
-  requests and enqueued packets. If the enqueued packet is shared, it will
-  duplicate it to a non-shared packet, release the shared packet, then
-  deliver the non-shared packet up.
+  requests and enqueued packets. A shared packet is delivered up with a
+  private IP head while its payload stays shared with the other IP children.
+  For a raw data instance, the shared packet is duplicated to a non-shared
+  packet, the shared packet is released, then the non-shared packet is
+  delivered up.
 
   @param[in]  IpInstance         The IP child to deliver the packet up.
 
@@ -1273,8 +1306,6 @@ Ip4InstanceDeliverPacket (
   IP4_RXDATA_WRAP           *Wrap;
   NET_BUF                   *Packet;
   NET_BUF                   *Dup;
-  UINT8                     *Head;
-  UINT32                    HeadLen;
 
   //
   // Deliver a packet if there are both a packet and a receive token.
@@ -1284,9 +1315,11 @@ Ip4InstanceDeliverPacket (
 
     Packet = NET_LIST_HEAD (&IpInstance->Received, NET_BUF, List);
 
-    if (!NET_BUF_SHARED (Packet)) {
+    if (!NET_BUF_SHARED (Packet) || !IpInstance->ConfigData.RawData) {
       //
-      // If this is the only instance that wants the packet, wrap it up.
+      // If this is the only instance that wants the packet, or the upper
+      // layer only gets the payload, wrap it up. The payload is read only
+      // to the upper layer, so it needn't be copied even if it's shared.
       //
       Wrap = Ip4WrapRxData (IpInstance, Packet);
 
@@ -1298,35 +1331,15 @@ Ip4InstanceDeliverPacket (
 
     } else {
       //
-      // Create a duplicated packet if this packet is shared
+      // Create a duplicated packet if this packet is shared, the raw
+      // data delivered up includes the IP head.
       //
-      if (IpInstance->ConfigData.RawData) {
-        HeadLen = 0;
-      } else {
-        HeadLen = IP4_MAX_HEADLEN;
-      }
-
-      Dup = NetbufDuplicate (Packet, NULL, HeadLen);
+      Dup = NetbufDuplicate (Packet, NULL, 0);
 
       if (Dup == NULL) {
         return EFI_OUT_OF_RESOURCES;
       }
 
-      if (!IpInstance->ConfigData.RawData) {
-        //
-        // Copy the IP head over. The packet to deliver up is
-        // headless. Trim the head off after copy. The IP head
-        // may be not continuous before the data.
-        //
-        Head = NetbufAllocSpace (Dup, IP4_MAX_HEADLEN, NET_BUF_HEAD);
-        ASSERT (Head != NULL);
-
-        Dup->Ip.Ip4 = (IP4_HEAD *) Head;
-
-        CopyMem (Head, Packet->Ip.Ip4, Packet->Ip.Ip4->HeadLen << 2);
-        NetbufTrim (Dup, IP4_MAX_HEADLEN, TRUE);
-      }
-
       Wrap = Ip4WrapRxData (IpInstance, Dup);
 
       if (Wrap == NULL) {
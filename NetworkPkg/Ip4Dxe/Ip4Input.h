@@ -19,6 +19,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define IP4_FRAGMENT_LIFE      120
 #define IP4_MAX_PACKET_SIZE    65535
 
+///
+/// Max NO. of fragments queued for one packet. Each fragment holds a whole
+/// received frame, so this bounds the memory a single packet being
+/// reassembled can take.
+///
+#define IP4_MAX_FRAGMENT_NUM   256
+
 ///
 /// Per packet information for input process. LinkFlag specifies whether
 /// the packet is received as Link layer unicast, multicast or broadcast.
@@ -56,6 +63,7 @@ typedef struct {
 
   INTN                      TotalLen;
   INTN                      CurLen;
+  UINT32                    FragmentNum; // Number of fragments in Fragments
   LIST_ENTRY                Fragments;  // List of all the fragments of this packet
 
   IP4_HEAD                  *Head;      // IP head of the first fragment
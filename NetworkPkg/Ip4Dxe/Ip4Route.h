@@ -13,10 +13,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define IP4_DIRECT_ROUTE       0x00000001
 
-#define IP4_ROUTE_CACHE_HASH_VALUE 31
+#define IP4_ROUTE_CACHE_HASH_BITS  6
+#define IP4_ROUTE_CACHE_HASH_VALUE (1 << IP4_ROUTE_CACHE_HASH_BITS)
 #define IP4_ROUTE_CACHE_MAX        64  // Max NO. of cache entry per hash bucket
 
-#define IP4_ROUTE_CACHE_HASH(Dst, Src)  (((Dst) ^ (Src)) % IP4_ROUTE_CACHE_HASH_VALUE)
+//
+// Multiplicative hash of the (Dst, Src) pair. The source is rotated so that
+// addresses sharing the same subnet bits don't cancel each other out, and
+// the top bits of the product, which depend on all the input bits, are used
+// as the bucket index.
+//
+#define IP4_ROUTE_CACHE_HASH(Dst, Src)  \
+  ((UINT32) (((UINT32) ((Dst) ^ (((Src) << 16) | ((Src) >> 16))) * 0x9E3779B1U) >> (32 - IP4_ROUTE_CACHE_HASH_BITS)))
 
 ///
 /// The route entry in the route table. Dest/Netmask is the destion
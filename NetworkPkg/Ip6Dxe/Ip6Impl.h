@@ -124,6 +124,7 @@ typedef struct {
   LIST_ENTRY                Link;
   IP6_PROTOCOL              *IpInstance;
   NET_BUF                   *Packet;
+  EFI_IP6_HEADER            Head;     ///< Private IP head of a shared packet
   EFI_IP6_RECEIVE_DATA      RxData;
 } IP6_RXDATA_WRAP;
 
@@ -43,9 +43,10 @@ Ip6CreateAssembleEntry (
   Assemble->Id       = Id;
   Assemble->Life     = IP6_FRAGMENT_LIFE + 1;
 
-  Assemble->TotalLen = 0;
-  Assemble->CurLen   = 0;
-  Assemble->Head     = NULL;
+  Assemble->TotalLen    = 0;
+  Assemble->CurLen      = 0;
+  Assemble->FragmentNum = 0;
+  Assemble->Head        = NULL;
   Assemble->Info     = NULL;
   Assemble->Packet   = NULL;
 
@@ -222,13 +223,27 @@ Ip6Reassemble (
   // fragment with THIS.Start < CUR.Start. the previous one
   // has PREV.Start <= THIS.Start < CUR.Start.
   //
+  // Fragments normally arrive in order, or in reverse order. So check the
+  // first fragment, then search backward from the last one: either way the
+  // point is found right away instead of walking the whole list for each
+  // fragment.
+  //
   ListHead = &Assemble->Fragments;
+  Cur      = ListHead->ForwardLink;
 
-  NET_LIST_FOR_EACH (Cur, ListHead) {
+  if (Cur != ListHead) {
     Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
 
-    if (This->Start < IP6_GET_CLIP_INFO (Fragment)->Start) {
-      break;
+    if (This->Start >= IP6_GET_CLIP_INFO (Fragment)->Start) {
+      for (Prev = ListHead->BackLink; Prev != Cur; Prev = Prev->BackLink) {
+        Fragment = NET_LIST_USER_STRUCT (Prev, NET_BUF, List);
+
+        if (IP6_GET_CLIP_INFO (Fragment)->Start <= This->Start) {
+          break;
+        }
+      }
+
+      Cur = Prev->ForwardLink;
     }
   }
 
@@ -258,7 +273,12 @@ Ip6Reassemble (
   // Insert the fragment into the packet. The fragment may be removed
   // from the list by the following checks.
   //
+  if (Assemble->FragmentNum >= IP6_MAX_FRAGMENT_NUM) {
+    goto Error;
+  }
+
   NetListInsertBefore (Cur, &Packet->List);
+  Assemble->FragmentNum++;
 
   //
   // Check the packets after the insert point. It holds that:
@@ -278,6 +298,7 @@ Ip6Reassemble (
 
       RemoveEntryList (&Fragment->List);
       Assemble->CurLen -= Node->Length;
+      Assemble->FragmentNum--;
 
       NetbufFree (Fragment);
       continue;
@@ -292,6 +313,7 @@ Ip6Reassemble (
     if (Node->Start < This->End) {
       if (This->Start == Node->Start) {
         RemoveEntryList (&Packet->List);
+        Assemble->FragmentNum--;
         goto Error;
       }
 
@@ -1176,7 +1198,7 @@ Ip6OnRecyclePacket (
   RemoveEntryList (&Wrap->Link);
   EfiReleaseLock (&Wrap->IpInstance->RecycleLock);
 
-  ASSERT (!NET_BUF_SHARED (Wrap->Packet));
+  ASSERT (Wrap->Packet->RefCnt == 1);
   NetbufFree (Wrap->Packet);
 
   gBS->CloseEvent (Wrap->RxData.RecycleSignal);
@@ -1236,6 +1258,15 @@ Ip6WrapRxData (
 
   ASSERT (Packet->Ip.Ip6 != NULL);
 
+  //
+  // The head of a shared packet is also seen by the other IP children,
+  // convert a private copy of it instead.
+  //
+  if (NET_BUF_SHARED (Packet)) {
+    CopyMem (&Wrap->Head, Packet->Ip.Ip6, sizeof (EFI_IP6_HEADER));
+    Packet->Ip.Ip6 = &Wrap->Head;
+  }
+
   //
   // The application expects a network byte order header.
   //
@@ -1449,9 +1480,9 @@ Ip6InstanceEnquePacket (
 
 /**
   Deliver the received packets to the upper layer if there are both received
-  requests and enqueued packets. If the enqueued packet is shared, it will
-  duplicate it to a non-shared packet, release the shared packet, then
-  deliver the non-shared packet up.
+  requests and enqueued packets. A shared packet is delivered up with a
+  private IP head while its payload stays shared with the other IP children,
+  which only read it.
 
   @param[in]  IpInstance         The IP child to deliver the packet up.
 
@@ -1469,8 +1500,6 @@ Ip6InstanceDeliverPacket (
   EFI_IP6_COMPLETION_TOKEN  *Token;
   IP6_RXDATA_WRAP           *Wrap;
   NET_BUF                   *Packet;
-  NET_BUF                   *Dup;
-  UINT8                     *Head;
 
   //
   // Deliver a packet if there are both a packet and a receive token.
@@ -1479,53 +1508,18 @@ Ip6InstanceDeliverPacket (
 
     Packet = NET_LIST_HEAD (&IpInstance->Received, NET_BUF, List);
 
-    if (!NET_BUF_SHARED (Packet)) {
-      //
-      // If this is the only instance that wants the packet, wrap it up.
-      //
-      Wrap = Ip6WrapRxData (IpInstance, Packet);
-
-      if (Wrap == NULL) {
-        return EFI_OUT_OF_RESOURCES;
-      }
-
-      RemoveEntryList (&Packet->List);
-
-    } else {
-      //
-      // Create a duplicated packet if this packet is shared
-      //
-      Dup = NetbufDuplicate (Packet, NULL, sizeof (EFI_IP6_HEADER));
-
-      if (Dup == NULL) {
-        return EFI_OUT_OF_RESOURCES;
-      }
-
-      //
-      // Copy the IP head over. The packet to deliver up is
-      // headless. Trim the head off after copy. The IP head
-      // may be not continuous before the data.
-      //
-      Head        = NetbufAllocSpace (Dup, sizeof (EFI_IP6_HEADER), NET_BUF_HEAD);
-      ASSERT (Head != NULL);
-      Dup->Ip.Ip6 = (EFI_IP6_HEADER *) Head;
-
-      CopyMem (Head, Packet->Ip.Ip6, sizeof (EFI_IP6_HEADER));
-      NetbufTrim (Dup, sizeof (EFI_IP6_HEADER), TRUE);
-
-      Wrap = Ip6WrapRxData (IpInstance, Dup);
-
-      if (Wrap == NULL) {
-        NetbufFree (Dup);
-        return EFI_OUT_OF_RESOURCES;
-      }
-
-      RemoveEntryList (&Packet->List);
-      NetbufFree (Packet);
+    //
+    // Wrap the packet up. The payload is read only to the upper layer,
+    // so it needn't be copied even if it's shared.
+    //
+    Wrap = Ip6WrapRxData (IpInstance, Packet);
 
-      Packet = Dup;
+    if (Wrap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
 
+    RemoveEntryList (&Packet->List);
+
     //
     // Insert it into the delivered packet, then get a user's
     // receive token, pass the wrapped packet up.
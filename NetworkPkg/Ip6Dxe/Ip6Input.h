@@ -24,6 +24,12 @@
 ///
 #define IP6_FRAGMENT_LIFE     60
 #define IP6_MAX_PACKET_SIZE   65535
+///
+/// Max NO. of fragments queued for one packet. Each fragment holds a whole
+/// received frame, so this bounds the memory a single packet being
+/// reassembled can take.
+///
+#define IP6_MAX_FRAGMENT_NUM  256
 
 
 #define IP6_GET_CLIP_INFO(Packet) ((IP6_CLIP_INFO *) ((Packet)->ProtoData))
@@ -76,6 +82,7 @@ typedef struct {
 
   UINT32                    TotalLen;
   UINT32                    CurLen;
+  UINT32                    FragmentNum; // Number of fragments in Fragments
   UINT32                    Life;       // Count down life for the packet.
 
   EFI_IP6_HEADER            *Head;      // IP head of the first fragment
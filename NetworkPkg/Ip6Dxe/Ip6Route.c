@@ -11,12 +11,16 @@
 
 /**
   This is the worker function for IP6_ROUTE_CACHE_HASH(). It calculates the value
-  as the index of the route cache bucket according to the prefix of two IPv6 addresses.
+  as the index of the route cache bucket according to two full IPv6 addresses.
+
+  Hashing only the prefixes puts all the destinations of one network, reached
+  from the same source, into a single bucket. So every 32-bit word of both
+  addresses is mixed in, and the top bits of the result are used as the index.
 
   @param[in]  Ip1     The IPv6 address.
   @param[in]  Ip2     The IPv6 address.
 
-  @return The hash value of the prefix of two IPv6 addresses.
+  @return The hash value of the two IPv6 addresses.
 
 **/
 UINT32
@@ -25,13 +29,19 @@ Ip6RouteCacheHash (
   IN EFI_IPv6_ADDRESS       *Ip2
   )
 {
-  UINT32 Prefix1;
-  UINT32 Prefix2;
+  UINT32 Hash;
+  UINT32 Index;
+
+  Hash = 0;
 
-  Prefix1 = *((UINT32 *) ((UINTN *) (Ip1)));
-  Prefix2 = *((UINT32 *) ((UINTN *) (Ip2)));
+  for (Index = 0; Index < sizeof (EFI_IPv6_ADDRESS); Index += sizeof (UINT32)) {
+    Hash ^= ReadUnaligned32 ((UINT32 *) &Ip1->Addr[Index]);
+    Hash  = (Hash << 5) | (Hash >> 27);
+    Hash ^= ReadUnaligned32 ((UINT32 *) &Ip2->Addr[Index]);
+    Hash *= 0x9E3779B1U;
+  }
 
-  return ((UINT32) (Prefix1 ^ Prefix2) % IP6_ROUTE_CACHE_HASH_SIZE);
+  return Hash >> (32 - IP6_ROUTE_CACHE_HASH_BITS);
 }
 
 /**
@@ -13,7 +13,8 @@
 #define IP6_DIRECT_ROUTE          0x00000001
 #define IP6_PACKET_TOO_BIG        0x00000010
 
-#define IP6_ROUTE_CACHE_HASH_SIZE 31
+#define IP6_ROUTE_CACHE_HASH_BITS 6
+#define IP6_ROUTE_CACHE_HASH_SIZE (1 << IP6_ROUTE_CACHE_HASH_BITS)
 ///
 /// Max NO. of cache entry per hash bucket
 ///
@@ -62,12 +63,12 @@ typedef struct _IP6_ROUTE_TABLE {
 
 /**
   This is the worker function for IP6_ROUTE_CACHE_HASH(). It calculates the value
-  as the index of the route cache bucket according to the prefix of two IPv6 addresses.
+  as the index of the route cache bucket according to two full IPv6 addresses.
 
   @param[in]  Ip1     The IPv6 address.
   @param[in]  Ip2     The IPv6 address.
 
-  @return The hash value of the prefix of two IPv6 addresses.
+  @return The hash value of the two IPv6 addresses.
 
 **/
 UINT32
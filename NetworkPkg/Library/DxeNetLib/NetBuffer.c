@@ -14,6 +14,113 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+//
+// Every packet allocates a NET_BUF with a single NET_BLOCK_OP, a NET_VECTOR
+// with a single NET_BLOCK and a data block of at most a frame's size. Up to
+// NET_BUF_CACHE_DEPTH of each of them are kept on a free list when released
+// and handed out again, instead of going through the pool allocator for every
+// packet. The data blocks are NET_BUF_CACHE_BLOCK_SIZE bytes, which holds a
+// full Ethernet frame.
+//
+#define NET_BUF_CACHE_DEPTH       64
+#define NET_BUF_CACHE_BLOCK_SIZE  2048
+
+typedef struct {
+  VOID                      *Head;   // The first pointer of each entry links to the next one.
+  UINT32                    Count;
+} NET_BUF_FREE_LIST;
+
+NET_BUF_FREE_LIST           mNetbufFreeList;
+NET_BUF_FREE_LIST           mNetVectorFreeList;
+NET_BUF_FREE_LIST           mNetBlockFreeList;
+
+/**
+  Take an entry from a net buffer free list.
+
+  The free lists are shared by all the TPLs net buffers are used at, so they
+  are updated at TPL_NOTIFY, as the pool allocator does.
+
+  @param[in, out]  List      The free list.
+
+  @return                    The entry taken, or NULL if the list is empty.
+
+**/
+VOID *
+NetbufCacheGet (
+  IN OUT NET_BUF_FREE_LIST  *List
+  )
+{
+  VOID                      *Entry;
+  EFI_TPL                   OldTpl;
+
+  if (List->Head == NULL) {
+    return NULL;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Entry  = List->Head;
+  if (Entry != NULL) {
+    List->Head = *(VOID **) Entry;
+    List->Count--;
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  return Entry;
+}
+
+/**
+  Put an entry back to a net buffer free list if it isn't full. The entry
+  must have been allocated from pool with the size of the list's entries.
+
+  @param[in, out]  List      The free list.
+  @param[in]       Entry     The entry to release.
+
+  @retval TRUE               The entry is kept on the free list.
+  @retval FALSE              The free list is full, the caller should free the entry.
+
+**/
+BOOLEAN
+NetbufCachePut (
+  IN OUT NET_BUF_FREE_LIST  *List,
+  IN     VOID               *Entry
+  )
+{
+  BOOLEAN                   Kept;
+  EFI_TPL                   OldTpl;
+
+  if (List->Count >= NET_BUF_CACHE_DEPTH) {
+    return FALSE;
+  }
+
+  Kept   = FALSE;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (List->Count < NET_BUF_CACHE_DEPTH) {
+    *(VOID **) Entry = List->Head;
+    List->Head       = Entry;
+    List->Count++;
+    Kept             = TRUE;
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  return Kept;
+}
+
+/**
+  Release the memory of a NET_BUF whose reference count dropped to 0.
+
+  @param[in]  Nbuf           Pointer to the NET_BUF to be released.
+
+**/
+VOID
+NetbufFreeStruct (
+  IN NET_BUF                *Nbuf
+  )
+{
+  if ((Nbuf->BlockOpNum != 1) || !NetbufCachePut (&mNetbufFreeList, Nbuf)) {
+    FreePool (Nbuf);
+  }
+}
+
 
 /**
   Allocate and build up the sketch for a NET_BUF.
@@ -43,7 +150,17 @@ NetbufAllocStruct (
   //
   // Allocate three memory blocks.
   //
-  Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  Nbuf = NULL;
+  if (BlockOpNum == 1) {
+    Nbuf = NetbufCacheGet (&mNetbufFreeList);
+    if (Nbuf != NULL) {
+      ZeroMem (Nbuf, NET_BUF_SIZE (1));
+    }
+  }
+
+  if (Nbuf == NULL) {
+    Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  }
 
   if (Nbuf == NULL) {
     return NULL;
@@ -55,7 +172,17 @@ NetbufAllocStruct (
   InitializeListHead (&Nbuf->List);
 
   if (BlockNum != 0) {
-    Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    Vector = NULL;
+    if (BlockNum == 1) {
+      Vector = NetbufCacheGet (&mNetVectorFreeList);
+      if (Vector != NULL) {
+        ZeroMem (Vector, NET_VECTOR_SIZE (1));
+      }
+    }
+
+    if (Vector == NULL) {
+      Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    }
 
     if (Vector == NULL) {
       goto FreeNbuf;
@@ -71,7 +198,7 @@ NetbufAllocStruct (
 
 FreeNbuf:
 
-  FreePool (Nbuf);
+  NetbufFreeStruct (Nbuf);
   return NULL;
 }
 
@@ -104,13 +231,23 @@ NetbufAlloc (
     return NULL;
   }
 
-  Bulk = AllocatePool (Len);
+  Vector = Nbuf->Vector;
+
+  if (Len <= NET_BUF_CACHE_BLOCK_SIZE) {
+    Bulk = NetbufCacheGet (&mNetBlockFreeList);
+    if (Bulk == NULL) {
+      Bulk = AllocatePool (NET_BUF_CACHE_BLOCK_SIZE);
+    }
+
+    Vector->Flag = NET_VECTOR_CACHED_FIRST;
+  } else {
+    Bulk = AllocatePool (Len);
+  }
 
   if (Bulk == NULL) {
     goto FreeNBuf;
   }
 
-  Vector = Nbuf->Vector;
   Vector->Len                 = Len;
 
   Vector->Block[0].Bulk       = Bulk;
@@ -126,7 +263,11 @@ NetbufAlloc (
   return Nbuf;
 
 FreeNBuf:
-  FreePool (Nbuf);
+  if (!NetbufCachePut (&mNetVectorFreeList, Vector)) {
+    FreePool (Vector);
+  }
+
+  NetbufFreeStruct (Nbuf);
   return NULL;
 }
 
@@ -174,11 +315,18 @@ NetbufFreeVector (
     // Free each memory block associated with the Vector
     //
     for (Index = 0; Index < Vector->BlockNum; Index++) {
+      if ((Index == 0) && ((Vector->Flag & NET_VECTOR_CACHED_FIRST) != 0) &&
+          NetbufCachePut (&mNetBlockFreeList, Vector->Block[0].Bulk)) {
+        continue;
+      }
+
       gBS->FreePool (Vector->Block[Index].Bulk);
     }
   }
 
-  FreePool (Vector);
+  if ((Vector->BlockNum != 1) || !NetbufCachePut (&mNetVectorFreeList, Vector)) {
+    FreePool (Vector);
+  }
 }
 
 
@@ -212,7 +360,7 @@ NetbufFree (
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeStruct (Nbuf);
   }
 }
 
@@ -1655,7 +1803,9 @@ NetblockChecksum (
   IN UINT32                 Len
   )
 {
-  register UINT32           Sum;
+  register UINT64           Sum;
+  UINT32                    Sum32;
+  UINT32                    *Bulk32;
 
   Sum = 0;
 
@@ -1666,6 +1816,37 @@ NetblockChecksum (
     Sum += *(Bulk + Len - 1);
   }
 
+  //
+  // The one's complement sum doesn't depend on the word size it is computed
+  // with, so sum 32-bit words into a 64-bit accumulator which can't overflow
+  // for any UINT32 length. Headers usually start 2 bytes past a 4-byte
+  // boundary behind the 14-byte Ethernet header, add one 16-bit word first
+  // to align them.
+  //
+  if ((((UINTN) Bulk & 0x03) == 0x02) && (Len > 1)) {
+    Sum += *(UINT16 *) Bulk;
+    Bulk += 2;
+    Len -= 2;
+  }
+
+  if (((UINTN) Bulk & 0x03) == 0) {
+    Bulk32 = (UINT32 *) Bulk;
+
+    while (Len >= 16) {
+      Sum += (UINT64) Bulk32[0] + Bulk32[1] + Bulk32[2] + Bulk32[3];
+      Bulk32 += 4;
+      Len -= 16;
+    }
+
+    while (Len >= 4) {
+      Sum += *Bulk32;
+      Bulk32++;
+      Len -= 4;
+    }
+
+    Bulk = (UINT8 *) Bulk32;
+  }
+
   while (Len > 1) {
     Sum += *(UINT16 *) Bulk;
     Bulk += 2;
@@ -1673,14 +1854,18 @@ NetblockChecksum (
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Fold 64-bit sum to 16 bits
   //
-  while ((Sum >> 16) != 0) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+  Sum   = (Sum & 0xffffffff) + RShiftU64 (Sum, 32);
+  Sum   = (Sum & 0xffffffff) + RShiftU64 (Sum, 32);
+  Sum32 = (UINT32) Sum;
+
+  while ((Sum32 >> 16) != 0) {
+    Sum32 = (Sum32 & 0xffff) + (Sum32 >> 16);
 
   }
 
-  return (UINT16) Sum;
+  return (UINT16) Sum32;
 }
 
 
@@ -64,6 +64,28 @@ UdpIoFreeRxToken (
   FreePool (RxToken);
 }
 
+/**
+  Release a UDP_RX_TOKEN whose datagram has been recycled.
+
+  The token is kept in the UDP_IO for the next UdpIoRecvDatagram() if no
+  token is cached yet, so a steady stream of receives doesn't allocate a
+  pool buffer and create an event for every datagram. Otherwise it's freed.
+
+  @param[in]  RxToken                 The UDP_RX_TOKEN to release.
+
+**/
+VOID
+UdpIoRecycleRxToken (
+  IN UDP_RX_TOKEN           *RxToken
+  )
+{
+  if (RxToken->UdpIo->FreeRxToken == NULL) {
+    RxToken->UdpIo->FreeRxToken = RxToken;
+  } else {
+    UdpIoFreeRxToken (RxToken);
+  }
+}
+
 /**
   The callback function when the packet is sent by UDP.
 
@@ -141,7 +163,7 @@ UdpIoRecycleDgram (
     ASSERT (FALSE);
   }
 
-  UdpIoFreeRxToken (RxToken);
+  UdpIoRecycleRxToken (RxToken);
 }
 
 /**
@@ -330,7 +352,8 @@ UdpIoOnDgramRcvd (
 }
 
 /**
-  Create a UDP_RX_TOKEN to wrap the request.
+  Create a UDP_RX_TOKEN to wrap the request, reusing the token cached in
+  the UDP_IO if there is one.
 
   @param[in]  UdpIo                 The UdpIo to receive packets from.
   @param[in]  CallBack              The function to call when receive finished.
@@ -354,6 +377,30 @@ UdpIoCreateRxToken (
   ASSERT ((UdpIo->UdpVersion == UDP_IO_UDP4_VERSION) ||
           (UdpIo->UdpVersion == UDP_IO_UDP6_VERSION));
 
+  if (UdpIo->FreeRxToken != NULL) {
+    //
+    // The cached token still owns its receive event, only the
+    // request specific fields need to be refreshed.
+    //
+    Token              = UdpIo->FreeRxToken;
+    UdpIo->FreeRxToken = NULL;
+
+    ASSERT (Token->Signature == UDP_IO_RX_SIGNATURE);
+    Token->CallBack = CallBack;
+    Token->Context  = Context;
+    Token->HeadLen  = HeadLen;
+
+    if (UdpIo->UdpVersion == UDP_IO_UDP4_VERSION) {
+      Token->Token.Udp4.Status        = EFI_NOT_READY;
+      Token->Token.Udp4.Packet.RxData = NULL;
+    } else {
+      Token->Token.Udp6.Status        = EFI_NOT_READY;
+      Token->Token.Udp6.Packet.RxData = NULL;
+    }
+
+    return Token;
+  }
+
   Token = AllocatePool (sizeof (UDP_RX_TOKEN));
 
   if (Token == NULL) {
@@ -627,6 +674,7 @@ UdpIoCreateIo (
 
   InitializeListHead (&UdpIo->SentDatagram);
   UdpIo->RecvRequest  = NULL;
+  UdpIo->FreeRxToken  = NULL;
   UdpIo->UdpHandle    = NULL;
 
   if (UdpVersion == UDP_IO_UDP4_VERSION) {
@@ -890,6 +938,10 @@ UdpIoFreeIo (
     }
   }
 
+  if (UdpIo->FreeRxToken != NULL) {
+    UdpIoFreeRxToken (UdpIo->FreeRxToken);
+  }
+
   if (!IsListEmpty(&UdpIo->Link)) {
     RemoveEntryList (&UdpIo->Link);
   }
@@ -1279,7 +1279,9 @@ MnpStart (
       goto ErrorExit;
     }
 
-    MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->EnableSystemPoll    = EnableSystemPoll;
+    MnpDeviceData->FastSystemPoll      = FALSE;
+    MnpDeviceData->SystemPollIdleCount = 0;
   }
 
   //
@@ -1340,6 +1342,7 @@ MnpStop (
     //
     Status  = gBS->SetTimer (MnpDeviceData->PollTimer, TimerCancel, 0);
     MnpDeviceData->EnableSystemPoll = FALSE;
+    MnpDeviceData->FastSystemPoll   = FALSE;
   }
 
   //
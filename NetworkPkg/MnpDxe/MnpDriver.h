@@ -69,6 +69,12 @@ typedef struct {
 
   EFI_EVENT                     PollTimer;
   BOOLEAN                       EnableSystemPoll;
+  //
+  // The poll timer runs at MNP_SYS_POLL_FAST_INTERVAL while packets keep
+  // arriving, and backs off after MNP_SYS_POLL_IDLE_COUNT idle polls.
+  //
+  BOOLEAN                       FastSystemPoll;
+  UINT32                        SystemPollIdleCount;
 
   EFI_EVENT                     TimeoutCheckTimer;
   EFI_EVENT                     MediaDetectTimer;
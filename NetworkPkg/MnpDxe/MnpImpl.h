@@ -14,6 +14,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE            4
 
 #define MNP_SYS_POLL_INTERVAL         (10 * TICKS_PER_MS)   // 10 milliseconds
+#define MNP_SYS_POLL_FAST_INTERVAL    (1 * TICKS_PER_MS)    // 1 millisecond, used while packets keep arriving
+#define MNP_SYS_POLL_IDLE_COUNT       10    // Idle fast polls before backing off to MNP_SYS_POLL_INTERVAL
+#define MNP_SYS_POLL_RX_BUDGET        32    // Max packets received by one system poll
 #define MNP_TIMEOUT_CHECK_INTERVAL    (50 * TICKS_PER_MS)   // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL     (500 * TICKS_PER_MS)  // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME           (500 * TICKS_PER_MS)  // 500 milliseconds
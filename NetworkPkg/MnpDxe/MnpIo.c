@@ -1105,6 +1105,11 @@ MnpCheckMediaStatus (
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
 
+  Up to MNP_SYS_POLL_RX_BUDGET packets are drained from Snp per poll. While
+  packets keep arriving, the poll timer is switched to
+  MNP_SYS_POLL_FAST_INTERVAL, and it is switched back to MNP_SYS_POLL_INTERVAL
+  after MNP_SYS_POLL_IDLE_COUNT polls that receive nothing.
+
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
 
@@ -1117,17 +1122,45 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINT32           Received;
 
   MnpDeviceData = (MNP_DEVICE_DATA *) Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
-  //
-  // Try to receive packets from Snp.
-  //
-  MnpReceivePacket (MnpDeviceData);
+  for (Received = 0; Received < MNP_SYS_POLL_RX_BUDGET; Received++) {
+    //
+    // Try to receive packets from Snp.
+    //
+    if (EFI_ERROR (MnpReceivePacket (MnpDeviceData))) {
+      break;
+    }
 
-  //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
-  //
-  DispatchDpc ();
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events,
+    // so that the upper layers can queue new rx tokens before the next packet.
+    //
+    DispatchDpc ();
+  }
+
+  if (Received == 0) {
+    DispatchDpc ();
+  }
+
+  if (!MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
+
+  if (Received != 0) {
+    MnpDeviceData->SystemPollIdleCount = 0;
+
+    if (!MnpDeviceData->FastSystemPoll &&
+        !EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, MNP_SYS_POLL_FAST_INTERVAL))) {
+      MnpDeviceData->FastSystemPoll = TRUE;
+    }
+  } else if (MnpDeviceData->FastSystemPoll &&
+             (++MnpDeviceData->SystemPollIdleCount >= MNP_SYS_POLL_IDLE_COUNT)) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, MNP_SYS_POLL_INTERVAL))) {
+      MnpDeviceData->FastSystemPoll = FALSE;
+    }
+  }
 }
@@ -760,6 +760,7 @@ MnpPoll (
   EFI_STATUS         Status;
   MNP_INSTANCE_DATA  *Instance;
   EFI_TPL            OldTpl;
+  UINT32             Received;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -775,14 +776,27 @@ MnpPoll (
   }
 
   //
-  // Try to receive packets.
+  // Try to receive packets. Drain up to the same budget as the system poll,
+  // so a caller polling in a tight loop doesn't take one round trip per frame.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  for (Received = 0; Received < MNP_SYS_POLL_RX_BUDGET; Received++) {
+    Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
 
-  //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
-  //
-  DispatchDpc ();
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events,
+    // so that the upper layers can queue new rx tokens before the next packet.
+    //
+    DispatchDpc ();
+  }
+
+  if (Received != 0) {
+    Status = EFI_SUCCESS;
+  } else {
+    DispatchDpc ();
+  }
 
 ON_EXIT:
   gBS->RestoreTPL (OldTpl);
@@ -29,6 +29,166 @@ TcpSeqAcceptable (
           TCP_SEQ_LT (Seg->Seq, Tcb->RcvWl2 + Tcb->RcvWnd));
 }
 
+/**
+  Update the SACK scoreboard with the ACK and the SACK option of a segment.
+
+  Ranges at or below the ACK are dropped. The blocks in the option that lie
+  between the ACK and SND.NXT are merged into the scoreboard. When the
+  scoreboard is full, the highest range is dropped, so that the holes near
+  SND.UNA are still known.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the segment.
+  @param[in]       Option   Pointer to the options parsed from the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack,
+  IN     TCP_OPTION *Option
+  )
+{
+  TCP_SACK_BLOCK  Block;
+  UINT8           Index;
+  UINT8           Count;
+  UINT8           First;
+  UINT8           Last;
+
+  Count = 0;
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].End, Ack)) {
+      continue;
+    }
+
+    Tcb->SackBlock[Count] = Tcb->SackBlock[Index];
+    if (TCP_SEQ_LT (Tcb->SackBlock[Count].Start, Ack)) {
+      Tcb->SackBlock[Count].Start = Ack;
+    }
+
+    Count++;
+  }
+
+  Tcb->SackCount = Count;
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackCount; Index++) {
+    Block = Option->SackBlock[Index];
+
+    if (!TCP_SEQ_LT (Block.Start, Block.End) ||
+        TCP_SEQ_LEQ (Block.End, Ack) ||
+        TCP_SEQ_GT (Block.End, Tcb->SndNxt)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Block.Start, Ack)) {
+      Block.Start = Ack;
+    }
+
+    //
+    // Find the ranges that overlap or touch the block, merge them
+    // into the block and replace them with it.
+    //
+    for (First = 0; First < Tcb->SackCount; First++) {
+      if (TCP_SEQ_GEQ (Tcb->SackBlock[First].End, Block.Start)) {
+        break;
+      }
+    }
+
+    for (Last = First; Last < Tcb->SackCount; Last++) {
+      if (TCP_SEQ_GT (Tcb->SackBlock[Last].Start, Block.End)) {
+        break;
+      }
+
+      if (TCP_SEQ_LT (Tcb->SackBlock[Last].Start, Block.Start)) {
+        Block.Start = Tcb->SackBlock[Last].Start;
+      }
+
+      if (TCP_SEQ_GT (Tcb->SackBlock[Last].End, Block.End)) {
+        Block.End = Tcb->SackBlock[Last].End;
+      }
+    }
+
+    if (Last == First) {
+      //
+      // Nothing to merge with, make room for the block.
+      //
+      if (First == TCP_SACK_SCOREBOARD_SIZE) {
+        continue;
+      }
+
+      if (Tcb->SackCount == TCP_SACK_SCOREBOARD_SIZE) {
+        Tcb->SackCount--;
+      }
+
+      CopyMem (
+        &Tcb->SackBlock[First + 1],
+        &Tcb->SackBlock[First],
+        (Tcb->SackCount - First) * sizeof (TCP_SACK_BLOCK)
+        );
+      Tcb->SackCount++;
+    } else {
+      CopyMem (
+        &Tcb->SackBlock[First + 1],
+        &Tcb->SackBlock[Last],
+        (Tcb->SackCount - Last) * sizeof (TCP_SACK_BLOCK)
+        );
+      Tcb->SackCount = (UINT8) (Tcb->SackCount - (Last - First - 1));
+    }
+
+    Tcb->SackBlock[First] = Block;
+  }
+}
+
+/**
+  Retransmit the next hole reported by the SACK scoreboard.
+
+  A hole is a range above SND.UNA that isn't SACKed and is below the highest
+  SACKed sequence. The holes are retransmitted in order during one fast
+  recovery, each of them once.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @retval TRUE     A hole was retransmitted.
+  @retval FALSE    There is no hole left to retransmit.
+
+**/
+BOOLEAN
+TcpSackRetransmitHole (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  TCP_SEQNO Seq;
+  UINT8     Index;
+
+  Seq = Tcb->SndUna;
+  if (TCP_SEQ_LT (Seq, Tcb->SackRexmitNxt)) {
+    Seq = Tcb->SackRexmitNxt;
+  }
+
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].End, Seq)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Start)) {
+      if (TcpRetransmit (Tcb, Seq) != 0) {
+        return FALSE;
+      }
+
+      Tcb->SackRexmitNxt = Seq + MIN (Tcb->SndMss, TCP_SUB_SEQ (Tcb->SackBlock[Index].Start, Seq));
+      return TRUE;
+    }
+
+    Seq = Tcb->SackBlock[Index].End;
+  }
+
+  return FALSE;
+}
+
 /**
   NewReno fast recovery defined in RFC3782.
 
@@ -66,6 +226,7 @@ TcpFastRecover (
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
     Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->SackRexmitNxt = Tcb->SndUna + Tcb->SndMss;
 
     DEBUG (
       (EFI_D_NET,
@@ -84,12 +245,17 @@ TcpFastRecover (
     //
     // Step 3: Fast Recovery,
     // If this is a duplicated ACK, increse Cwnd by SMSS.
+    // When the peer reports the received data with SACK,
+    // the next hole is retransmitted for the segment that
+    // has left the network instead.
     //
 
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) || !TcpSackRetransmitHole (Tcb)) {
+      Tcb->CWnd += Tcb->SndMss;
+    }
     DEBUG (
       (EFI_D_NET,
       "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -129,6 +295,10 @@ TcpFastRecover (
       // , then deflate the CWnd
       //
       TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_SEQ_LT (Tcb->SackRexmitNxt, Seg->Ack + Tcb->SndMss)) {
+        Tcb->SackRexmitNxt = Seg->Ack + Tcb->SndMss;
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -593,6 +763,8 @@ TcpQueueData (
   Seg   = TCPSEG_NETBUF (Nbuf);
   Head  = &Tcb->RcvQue;
 
+  Tcb->RcvRecentSeq = Seg->Seq;
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1254,6 +1426,10 @@ TcpInput (
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
   if (Seg->Ack == Tcb->SndNxt) {
 
     TcpClearTimer (Tcb, TCP_TIMER_REXMIT);
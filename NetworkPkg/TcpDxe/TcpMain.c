@@ -163,7 +163,8 @@ Tcp4Configure (
     }
 
     Option = TcpConfigData->ControlOption;
-    if ((NULL != Option) && (Option->EnableSelectiveAck || Option->EnablePathMtuDiscovery)) {
+    if ((NULL != Option) &&
+        ((Option->EnableSelectiveAck && !PcdGetBool (PcdTcpSelectiveAck)) || Option->EnablePathMtuDiscovery)) {
       return EFI_UNSUPPORTED;
     }
   }
@@ -697,7 +698,8 @@ Tcp6Configure (
     }
 
     Option = Tcp6ConfigData->ControlOption;
-    if ((NULL != Option) && (Option->EnableSelectiveAck || Option->EnablePathMtuDiscovery)) {
+    if ((NULL != Option) &&
+        ((Option->EnableSelectiveAck && !PcdGetBool (PcdTcpSelectiveAck)) || Option->EnablePathMtuDiscovery)) {
       return EFI_UNSUPPORTED;
     }
   }
@@ -81,6 +81,7 @@ TcpInitTcbLocal (
   //
   Tcb->RcvWndScale  = 0;
   Tcb->RetxmitSeqMax = 0;
+  Tcb->SackCount     = 0;
 
   Tcb->ProbeTimerOn = FALSE;
 }
@@ -165,6 +166,14 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  }
+
+  Tcb->RcvTuneSeq  = Tcb->RcvNxt;
+  Tcb->RcvTuneTime = mTcpTick;
 }
 
 /**
@@ -835,6 +844,51 @@ TcpOnAppSend (
   return 0;
 }
 
+/**
+  Grow the receive buffer when the connection is limited by it.
+
+  Once per smoothed RTT, but at least one tick, the amount of data received
+  in the period is compared with the receive buffer. If more than half of
+  the buffer was received, the buffer is doubled, up to TCP_RCV_BUF_SIZE
+  and to the largest window the negotiated scale can advertise.
+
+  @param[in, out]  Tcb        Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpTuneRcvBuffer (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  UINT32  Period;
+  UINT32  Rcvd;
+  UINT32  BufSize;
+  UINT32  MaxSize;
+
+  Period = MAX (Tcb->SRtt >> TCP_RTT_SHIFT, 1);
+  if (TCP_SUB_TIME (mTcpTick, Tcb->RcvTuneTime) < Period) {
+    return;
+  }
+
+  Rcvd    = TCP_SUB_SEQ (Tcb->RcvNxt, Tcb->RcvTuneSeq);
+  BufSize = GET_RCV_BUFFSIZE (Tcb->Sk);
+  MaxSize = MIN (TCP_RCV_BUF_SIZE, (UINT32) TCP_OPTION_MAX_WIN << Tcb->RcvWndScale);
+
+  if ((Rcvd > BufSize / 2) && (BufSize < MaxSize)) {
+    SET_RCV_BUFFSIZE (Tcb->Sk, MIN (2 * BufSize, MaxSize));
+
+    DEBUG (
+      (EFI_D_NET,
+      "TcpTuneRcvBuffer: receive buffer of Tcb %p grown to %d\n",
+      Tcb,
+      GET_RCV_BUFFSIZE (Tcb->Sk))
+      );
+  }
+
+  Tcb->RcvTuneSeq  = Tcb->RcvNxt;
+  Tcb->RcvTuneTime = mTcpTick;
+}
+
 /**
   Application has consumed some data. Check whether
   to send a window update ack or a delayed ack.
@@ -851,6 +905,10 @@ TcpOnAppConsume (
 
   switch (Tcb->State) {
   case TCP_ESTABLISHED:
+    if (PcdGetBool (PcdTcpRcvBufferAutoTune)) {
+      TcpTuneRcvBuffer (Tcb);
+    }
+
     TcpOld = TcpRcvWinOld (Tcb);
     if (TcpRcvWinNow (Tcb) > TcpOld) {
 
@@ -82,6 +82,14 @@ TcpComputeScale (
 
   BufSize = GET_RCV_BUFFSIZE (Tcb->Sk);
 
+  //
+  // The scale can't change once the connection is established, so leave
+  // room for the receive buffer to be grown by auto-tuning.
+  //
+  if (PcdGetBool (PcdTcpRcvBufferAutoTune)) {
+    BufSize = MAX (BufSize, TCP_RCV_BUF_SIZE);
+  }
+
   Scale   = 0;
   while ((Scale < TCP_OPTION_MAX_WS) && ((UINT32) (TCP_OPTION_MAX_WIN << Scale) < BufSize)) {
 
@@ -159,6 +167,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when SACK is enabled,
+  // and either we are doing active open or we have received
+  // SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+        TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      ) {
+
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -171,6 +201,89 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Collect the out-of-order data in the reassemble queue as SACK blocks.
+
+  The block that contains the most recently received segment is reported
+  first, followed by the lowest other blocks, as RFC2018 recommends.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the blocks.
+  @param[in]   MaxCount  The maximum number of blocks to store.
+
+  @return                The number of blocks stored.
+
+**/
+UINT8
+TcpCollectSackBlock (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxCount
+  )
+{
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Run;
+  BOOLEAN         InRun;
+  BOOLEAN         HasRecent;
+  UINT8           Count;
+
+  //
+  // Block[0] is reserved for the block that contains RcvRecentSeq.
+  //
+  Count     = 1;
+  InRun     = FALSE;
+  HasRecent = FALSE;
+  Run.Start = 0;
+  Run.End   = 0;
+
+  for (Entry = Tcb->RcvQue.ForwardLink; ; Entry = Entry->ForwardLink) {
+    Seg = NULL;
+    if (Entry != &Tcb->RcvQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+      if (TCP_SEQ_LEQ (Seg->Seq, Tcb->RcvNxt)) {
+        continue;
+      }
+
+      if (InRun && TCP_SEQ_LEQ (Seg->Seq, Run.End)) {
+        if (TCP_SEQ_GT (Seg->End, Run.End)) {
+          Run.End = Seg->End;
+        }
+
+        continue;
+      }
+    }
+
+    //
+    // The current run ends here.
+    //
+    if (InRun) {
+      if (!HasRecent && TCP_SEQ_LEQ (Run.Start, Tcb->RcvRecentSeq) &&
+          TCP_SEQ_LT (Tcb->RcvRecentSeq, Run.End)) {
+        Block[0]  = Run;
+        HasRecent = TRUE;
+      } else if (Count < MaxCount) {
+        Block[Count++] = Run;
+      }
+    }
+
+    if (Seg == NULL) {
+      break;
+    }
+
+    Run.Start = Seg->Seq;
+    Run.End   = Seg->End;
+    InRun     = TRUE;
+  }
+
+  if (HasRecent) {
+    return Count;
+  }
+
+  CopyMem (Block, Block + 1, (Count - 1) * sizeof (TCP_SACK_BLOCK));
+  return (UINT8) (Count - 1);
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -186,11 +299,16 @@ TcpBuildOption (
   IN NET_BUF *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  UINT32          DataLen;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK_BLOCK];
+  UINT8           Count;
+  UINT8           Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
-  Len = 0;
+  Len     = 0;
+  DataLen = Nbuf->TotalSize;
 
   //
   // Build the Timestamp option.
@@ -213,6 +331,40 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Report the out-of-order data with a SACK option. It is only added to
+  // segments without data, so that the data segments still fit in SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      (DataLen == 0) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      ) {
+
+    Count = TcpCollectSackBlock (
+              Tcb,
+              Block,
+              (UINT8) (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_TS) ? 3 : TCP_OPTION_MAX_SACK_BLOCK)
+              );
+
+    if (Count != 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               4 + Count * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16) (Len + 4 + Count * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Count * TCP_OPTION_SACK_BLOCK_LEN));
+      for (Index = 0; Index < Count; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Start);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].End);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -238,10 +390,12 @@ TcpParseOption (
   UINT8 Cur;
   UINT8 Type;
   UINT8 Len;
+  UINT8 Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag  = 0;
+  Option->Flag      = 0;
+  Option->SackCount = 0;
 
   TotalLen      = (UINT8) ((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -313,6 +467,40 @@ TcpParseOption (
       Cur += TCP_OPTION_TS_LEN;
       break;
 
+    case TCP_OPTION_SACK_PERM:
+      Len = Head[Cur + 1];
+
+      if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+
+        return -1;
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+      Cur += TCP_OPTION_SACK_PERM_LEN;
+      break;
+
+    case TCP_OPTION_SACK:
+      Len = Head[Cur + 1];
+
+      if ((TotalLen - Cur) < Len || Len < 2 + TCP_OPTION_SACK_BLOCK_LEN ||
+          ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN) != 0) {
+
+        return -1;
+      }
+
+      for (Index = 0; (Index < (Len - 2) / TCP_OPTION_SACK_BLOCK_LEN) &&
+                      (Index < TCP_OPTION_MAX_SACK_BLOCK); Index++) {
+        Option->SackBlock[Index].Start = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        Option->SackBlock[Index].End   = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+      }
+
+      Option->SackCount = Index;
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+      Cur = (UINT8) (Cur + Len);
+      break;
+
     case TCP_OPTION_NOP:
       Cur++;
       break;
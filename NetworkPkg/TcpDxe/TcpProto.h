@@ -72,6 +72,8 @@
 #define TCP_CTRL_TIMER_ON        0x1000 ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON          0x2000 ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW         0x4000 ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK         0x8000 ///< Disable selective acknowledgment.
+#define TCP_CTRL_RCVD_SACK       0x10000 ///< Received a SACK permitted option in syn.
 
 //
 // Timer related values
@@ -207,6 +209,19 @@
 
 #define TCP_MAX_WIN                   0xFFFFU
 
+//
+// Number of SACKed ranges the sender remembers above SND.UNA.
+//
+#define TCP_SACK_SCOREBOARD_SIZE      8
+
+///
+/// A range of sequence numbers reported in a SACK option, End is exclusive.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO Start;
+  TCP_SEQNO End;
+} TCP_SACK_BLOCK;
+
 ///
 /// TCP segmentation data.
 ///
@@ -315,6 +330,20 @@ struct _TCP_CONTROL_BLOCK {
   //
   TCP_SEQNO         RetxmitSeqMax;       ///< Max Seq number in previous retransmission.
 
+  //
+  // RFC2018 selective acknowledgment.
+  //
+  TCP_SACK_BLOCK    SackBlock[TCP_SACK_SCOREBOARD_SIZE]; ///< Ranges SACKed by the peer, ascending.
+  UINT8             SackCount;     ///< Number of valid entries in SackBlock.
+  TCP_SEQNO         SackRexmitNxt; ///< Next seq to consider for retxmit in fast recovery.
+  TCP_SEQNO         RcvRecentSeq;  ///< Seq of the last queued segment, reported first in SACK.
+
+  //
+  // Receive buffer auto-tuning.
+  //
+  TCP_SEQNO         RcvTuneSeq;    ///< RcvNxt at the start of the measurement period.
+  UINT32            RcvTuneTime;   ///< Tick at the start of the measurement period.
+
   //
   // configuration parameters, for EFI_TCP4_PROTOCOL specification
   //
@@ -203,6 +203,11 @@ TcpRexmitTimeout (
   Tcb->CWnd         = Tcb->SndMss;
   Tcb->LossRecover  = Tcb->SndNxt;
 
+  //
+  // The peer may have discarded the data it SACKed (RFC2018 section 8).
+  //
+  Tcb->SackCount    = 0;
+
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) && !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
 
@@ -1299,6 +1299,15 @@ PxeBcDhcp4CallBack (
       // If error happens, just ignore this packet and continue to wait more offer.
       //
       PxeBcCacheDhcp4Offer (Private, Packet);
+
+      //
+      // Select the offers right away once an offer of the highest priority
+      // in PxeBcSelectDhcp4Offer() is received, more offers can't change the
+      // selection.
+      //
+      if (Private->IsOfferSorted && (Private->OfferCount[PxeOfferTypeDhcpPxe10] > 0)) {
+        Status = EFI_SUCCESS;
+      }
     }
     break;
 
@@ -1971,6 +1971,15 @@ PxeBcDhcp6CallBack (
       // the OfferIndex and OfferCount.
       //
       PxeBcCacheDhcp6Offer (Private, Packet);
+
+      //
+      // Select the offers right away once an offer of the highest priority
+      // in PxeBcSelectDhcp6Offer() is received, more advertisements can't
+      // change the selection.
+      //
+      if (Private->IsOfferSorted && (Private->OfferCount[PxeOfferTypeDhcpPxe10] > 0)) {
+        Status = EFI_SUCCESS;
+      }
     }
     break;
 
@@ -10,6 +10,7 @@
 
 #include <Protocol/Cpu.h>
 #include <Protocol/Timer.h>
+#include <Protocol/TicklessTimer.h>
 
 #include <Library/IoLib.h>
 #include <Library/PcdLib.h>
@@ -28,6 +29,13 @@
 ///
 #define HPET_INVALID_TIMER_INDEX  0xff
 
+///
+/// Shortest interval between two HPET timer interrupts in tickless mode, in
+/// 100 ns units. The comparator is written while the main counter runs, so it
+/// must be far enough ahead of the main counter to never be missed.
+///
+#define HPET_TICKLESS_MIN_PERIOD  100
+
 ///
 /// Timer Architectural Protocol function prototypes.
 ///
@@ -146,6 +154,26 @@ TimerDriverGenerateSoftInterrupt (
   IN EFI_TIMER_ARCH_PROTOCOL  *This
   );
 
+/**
+  Program the timer interrupt for the next due timer event.
+
+  @param  This             The EDKII_TICKLESS_TIMER_PROTOCOL instance.
+  @param  TimeToNextEvent  The time until the next timer event is due in 100 ns
+                           units, relative to the time last passed to the
+                           registered notification function, or
+                           EDKII_TICKLESS_TIMER_NO_EVENT.
+
+  @retval  EFI_SUCCESS     The timer interrupt was programmed.
+  @retval  EFI_NOT_READY   The timer interrupt is disabled.
+
+**/
+EFI_STATUS
+EFIAPI
+TimerDriverSetNextEvent (
+  IN EDKII_TICKLESS_TIMER_PROTOCOL  *This,
+  IN UINT64                         TimeToNextEvent
+  );
+
 ///
 /// The handle onto which the Timer Architectural Protocol will be installed.
 ///
@@ -161,6 +189,15 @@ EFI_TIMER_ARCH_PROTOCOL  mTimer = {
   TimerDriverGenerateSoftInterrupt
 };
 
+///
+/// The Tickless Timer Protocol that this driver produces when
+/// PcdHpetTicklessMaxIdlePeriod is not 0.
+///
+EDKII_TICKLESS_TIMER_PROTOCOL  mTicklessTimer = {
+  EDKII_TICKLESS_TIMER_PROTOCOL_REVISION,
+  TimerDriverSetNextEvent
+};
+
 ///
 /// Pointer to the CPU Architectural Protocol instance.
 ///
@@ -193,6 +230,32 @@ volatile UINT64  mPreviousMainCounter;
 
 volatile UINT64  mPreviousComparator;
 
+///
+/// The maximum number of HPET timer ticks between two HPET timer interrupts
+/// in tickless mode.  0 if tickless mode is disabled.
+///
+UINT64  mTicklessMaxIdleCount = 0;
+
+///
+/// The minimum number of HPET timer ticks between two HPET timer interrupts
+/// in tickless mode.
+///
+UINT64  mTicklessMinCount;
+
+///
+/// The number of HPET timer ticks for the timer period set by
+/// TimerDriverSetTimerPeriod().  Used in tickless mode once the next event is
+/// due, until the DXE Core reports the one after it.
+///
+UINT64  mTicklessPeriodCount;
+
+///
+/// The number of HPET timer ticks from mPreviousMainCounter until the next
+/// timer event is due.  MAX_UINT64 if no timer event is pending, 0 if the
+/// event is due and the DXE Core has not reported the next one yet.
+///
+volatile UINT64  mTicklessEventCount = 0;
+
 ///
 /// The index of the HPET timer being managed by this driver.
 ///
@@ -275,6 +338,28 @@ HpetEnable (
   HpetWrite (HPET_GENERAL_CONFIGURATION_OFFSET, mHpetGeneralConfiguration.Uint64);
 }
 
+/**
+  Account for HPET timer ticks that have been reported to the registered
+  notification function in the time until the next timer event.
+
+  @param  Delta  The number of HPET timer ticks since mPreviousMainCounter.
+**/
+VOID
+HpetTicklessConsume (
+  IN UINT64  Delta
+  )
+{
+  if (mTicklessEventCount == MAX_UINT64) {
+    return;
+  }
+
+  if (mTicklessEventCount > Delta) {
+    mTicklessEventCount -= Delta;
+  } else {
+    mTicklessEventCount = 0;
+  }
+}
+
 /**
   The interrupt handler for the HPET timer.  This handler clears the HPET interrupt
   and computes the amount of time that has passed since the last HPET timer interrupt.
@@ -327,29 +412,48 @@ TimerInterruptHandler (
   //
   mPreviousComparator = HpetRead (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE);
 
-  //
-  // Set HPET COMPARATOR to the value required for the next timer tick
-  //
-  Comparator = (mPreviousComparator + mTimerCount) & mCounterMask;
-
-  if ((mPreviousMainCounter < MainCounter) && (mPreviousComparator > Comparator)) {
-    //
-    // When comparator overflows
+  if (mTicklessMaxIdleCount != 0) {
     //
-    HpetWrite (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE, Comparator);
-  } else if ((mPreviousMainCounter > MainCounter) && (mPreviousComparator < Comparator)) {
-    //
-    // When main counter overflows
+    // Tickless mode.  Set HPET COMPARATOR to the time the next timer event is
+    // due.  Once it is due, tick at the timer period until the DXE Core
+    // reports the next one, and wait up to the maximum idle period if there
+    // is none.
     //
+    HpetTicklessConsume ((MainCounter - mPreviousMainCounter) & mCounterMask);
+    if (mTicklessEventCount == MAX_UINT64) {
+      mTimerCount = mTicklessMaxIdleCount;
+    } else if (mTicklessEventCount == 0) {
+      mTimerCount = MIN (mTicklessPeriodCount, mTicklessMaxIdleCount);
+    } else {
+      mTimerCount = MIN (mTicklessEventCount, mTicklessMaxIdleCount);
+    }
+    mTimerCount = MAX (mTimerCount, mTicklessMinCount);
     HpetWrite (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE, (MainCounter + mTimerCount) & mCounterMask);
   } else {
     //
-    // When both main counter and comparator do not overflow or both do overflow
+    // Set HPET COMPARATOR to the value required for the next timer tick
     //
-    if (Comparator > MainCounter) {
+    Comparator = (mPreviousComparator + mTimerCount) & mCounterMask;
+
+    if ((mPreviousMainCounter < MainCounter) && (mPreviousComparator > Comparator)) {
+      //
+      // When comparator overflows
+      //
       HpetWrite (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE, Comparator);
-    } else {
+    } else if ((mPreviousMainCounter > MainCounter) && (mPreviousComparator < Comparator)) {
+      //
+      // When main counter overflows
+      //
       HpetWrite (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE, (MainCounter + mTimerCount) & mCounterMask);
+    } else {
+      //
+      // When both main counter and comparator do not overflow or both do overflow
+      //
+      if (Comparator > MainCounter) {
+        HpetWrite (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE, Comparator);
+      } else {
+        HpetWrite (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE, (MainCounter + mTimerCount) & mCounterMask);
+      }
     }
   }
 
@@ -557,6 +661,7 @@ TimerDriverSetTimerPeriod (
                     MultU64x32 (TimerPeriod, 100000000),
                     mHpetGeneralCapabilities.Bits.CounterClockPeriod
                     );
+    mTicklessPeriodCount = mTimerCount;
 
     //
     // Program the HPET Comparator with the number of ticks till the next interrupt
@@ -726,6 +831,12 @@ TimerDriverGenerateSoftInterrupt (
     mTimerNotifyFunction (TimerPeriod);
   }
 
+  //
+  // The time to the next timer event is relative to the main counter value
+  // last reported to the notification function
+  //
+  HpetTicklessConsume ((MainCounter - mPreviousMainCounter) & mCounterMask);
+
   //
   // Save main counter value
   //
@@ -739,6 +850,92 @@ TimerDriverGenerateSoftInterrupt (
   return EFI_SUCCESS;
 }
 
+/**
+  Program the timer interrupt for the next due timer event.
+
+  The HPET comparator is set to the time the event is due, capped by the
+  maximum idle period, so that no timer interrupt is taken while nothing is
+  due.  TimerInterruptHandler() keeps the comparator programmed for the same
+  event until it is due.
+
+  @param  This             The EDKII_TICKLESS_TIMER_PROTOCOL instance.
+  @param  TimeToNextEvent  The time until the next timer event is due in 100 ns
+                           units, relative to the time last passed to the
+                           registered notification function, or
+                           EDKII_TICKLESS_TIMER_NO_EVENT.
+
+  @retval  EFI_SUCCESS     The timer interrupt was programmed.
+  @retval  EFI_NOT_READY   The timer interrupt is disabled.
+
+**/
+EFI_STATUS
+EFIAPI
+TimerDriverSetNextEvent (
+  IN EDKII_TICKLESS_TIMER_PROTOCOL  *This,
+  IN UINT64                         TimeToNextEvent
+  )
+{
+  EFI_TPL  Tpl;
+  UINT64   MainCounter;
+  UINT64   Elapsed;
+  UINT64   Count;
+
+  //
+  // Disable interrupts
+  //
+  Tpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+  //
+  // Convert TimeToNextEvent to HPET counter ticks, rounded up so that the
+  // interrupt does not fire before the event is due.
+  //
+  if (TimeToNextEvent > DivU64x32 (MAX_UINT64 >> 1, 100000000)) {
+    mTicklessEventCount = MAX_UINT64;
+  } else {
+    mTicklessEventCount = DivU64x32 (
+                            MultU64x32 (TimeToNextEvent, 100000000) +
+                            mHpetGeneralCapabilities.Bits.CounterClockPeriod - 1,
+                            mHpetGeneralCapabilities.Bits.CounterClockPeriod
+                            );
+  }
+
+  if (mTimerPeriod == 0) {
+    gBS->RestoreTPL (Tpl);
+    return EFI_NOT_READY;
+  }
+
+  //
+  // Program the HPET comparator with the number of ticks till the event.  If
+  // it is already due, interrupt as soon as possible.
+  //
+  MainCounter = HpetRead (HPET_MAIN_COUNTER_OFFSET);
+  Elapsed     = (MainCounter - mPreviousMainCounter) & mCounterMask;
+  if (mTicklessEventCount == MAX_UINT64) {
+    Count = mTicklessMaxIdleCount;
+  } else if (mTicklessEventCount > Elapsed) {
+    Count = MIN (mTicklessEventCount - Elapsed, mTicklessMaxIdleCount);
+  } else {
+    Count = mTicklessMinCount;
+  }
+  Count = MAX (Count, mTicklessMinCount);
+
+  mPreviousComparator = (MainCounter + Count) & mCounterMask;
+  HpetWrite (HPET_TIMER_COMPARATOR_OFFSET + mTimerIndex * HPET_TIMER_STRIDE, mPreviousComparator);
+
+  //
+  // Keep mTimerCount relative to mPreviousMainCounter, so that
+  // TimerDriverSetTimerPeriod() can tell whether an interrupt is pending.
+  //
+  mTimerCount = Elapsed + Count;
+
+  //
+  // Restore interrupts
+  //
+  gBS->RestoreTPL (Tpl);
+
+  return EFI_SUCCESS;
+}
+
 /**
   Initialize the Timer Architectural Protocol driver
 
@@ -935,6 +1132,24 @@ TimerDriverInitialize (
     mCounterMask = 0x00000000ffffffffULL;
   }
 
+  //
+  // Use tickless mode if the platform sets a maximum idle period.  The
+  // maximum idle count stays well below the counter range so that a passed
+  // comparator value is never mistaken for a future one.
+  //
+  if (PcdGet64 (PcdHpetTicklessMaxIdlePeriod) != 0) {
+    mTicklessMinCount = DivU64x32 (
+                          MultU64x32 (HPET_TICKLESS_MIN_PERIOD, 100000000),
+                          mHpetGeneralCapabilities.Bits.CounterClockPeriod
+                          );
+    mTicklessMaxIdleCount = DivU64x32 (
+                              MultU64x32 (PcdGet64 (PcdHpetTicklessMaxIdlePeriod), 100000000),
+                              mHpetGeneralCapabilities.Bits.CounterClockPeriod
+                              );
+    mTicklessMaxIdleCount = MIN (mTicklessMaxIdleCount, mCounterMask >> 2);
+    mTicklessMaxIdleCount = MAX (mTicklessMaxIdleCount, mTicklessMinCount);
+  }
+
   //
   // Install interrupt handler for selected HPET Timer
   //
@@ -969,6 +1184,7 @@ TimerDriverInitialize (
     DEBUG ((DEBUG_INFO, "HPET Counter Mask         = 0x%016lx\n",  mCounterMask));
     DEBUG ((DEBUG_INFO, "HPET Timer Period         = %d\n",        mTimerPeriod));
     DEBUG ((DEBUG_INFO, "HPET Timer Count          = 0x%016lx\n",  mTimerCount));
+    DEBUG ((DEBUG_INFO, "HPET Tickless Idle Count  = 0x%016lx\n",  mTicklessMaxIdleCount));
     DEBUG ((DEBUG_INFO, "HPET_TIMER%d_CONFIGURATION = 0x%016lx\n", mTimerIndex, HpetRead (HPET_TIMER_CONFIGURATION_OFFSET + mTimerIndex * HPET_TIMER_STRIDE)));
     DEBUG ((DEBUG_INFO, "HPET_TIMER%d_COMPARATOR    = 0x%016lx\n", mTimerIndex, HpetRead (HPET_TIMER_COMPARATOR_OFFSET    + mTimerIndex * HPET_TIMER_STRIDE)));
     DEBUG ((DEBUG_INFO, "HPET_TIMER%d_MSI_ROUTE     = 0x%016lx\n", mTimerIndex, HpetRead (HPET_TIMER_MSI_ROUTE_OFFSET     + mTimerIndex * HPET_TIMER_STRIDE)));
@@ -980,13 +1196,23 @@ TimerDriverInitialize (
   );
 
   //
-  // Install the Timer Architectural Protocol onto a new handle
+  // Install the Timer Architectural Protocol onto a new handle, along with the
+  // Tickless Timer Protocol in tickless mode
   //
-  Status = gBS->InstallMultipleProtocolInterfaces (
-                  &mTimerHandle,
-                  &gEfiTimerArchProtocolGuid, &mTimer,
-                  NULL
-                  );
+  if (mTicklessMaxIdleCount != 0) {
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    &mTimerHandle,
+                    &gEfiTimerArchProtocolGuid, &mTimer,
+                    &gEdkiiTicklessTimerProtocolGuid, &mTicklessTimer,
+                    NULL
+                    );
+  } else {
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    &mTimerHandle,
+                    &gEfiTimerArchProtocolGuid, &mTimer,
+                    NULL
+                    );
+  }
   ASSERT_EFI_ERROR (Status);
 
   return Status;
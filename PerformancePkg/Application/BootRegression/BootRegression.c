@@ -0,0 +1,860 @@
+/** @file -- BootRegression.c
+ This user-facing application measures the boot time over repeated warm
+ reboots, to catch boot time regressions.
+
+ Each run reads the performance records of the current boot from the FBPT,
+ saves them with the unit test framework state and warm resets the system.
+ Once BOOT_REGRESSION_ITERATIONS boots are measured, the medians of the SEC,
+ PEI, DXE and BDS phases and of the StartImage() time of each module are
+ written to BootRegression.json, and to BootRegression.bin. Renamed to
+ BootRegressionBaseline.bin, the latter is the baseline a later run, for
+ example with a new firmware, reports its deltas against. The test fails when
+ the median of a phase exceeds its baseline by more than
+ BOOT_REGRESSION_TOLERANCE_PERCENT.
+
+ The application must be started again after each reboot, for example from
+ startup.nsh, and writes its files in the current directory.
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ShellLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/SafeIntLib.h>
+#include <Library/PerformanceLib.h>
+#include <Guid/FirmwarePerformance.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+#include <Protocol/AcpiSystemDescriptionTable.h>
+
+#define UNIT_TEST_NAME     "Boot Regression"
+#define UNIT_TEST_VERSION  "1.0"
+
+//
+// Number of boots measured, the boot the first run happens in excluded.
+//
+#define BOOT_REGRESSION_ITERATIONS          10
+
+//
+// A phase regresses when its median exceeds the baseline by this percentage.
+//
+#define BOOT_REGRESSION_TOLERANCE_PERCENT   5
+
+#define BOOT_REGRESSION_MAX_DRIVERS         256
+#define BOOT_REGRESSION_MAX_OPEN_MODULES    32
+
+#define BOOT_REGRESSION_REPORT_FILE         L"BootRegression.json"
+#define BOOT_REGRESSION_SUMMARY_FILE        L"BootRegression.bin"
+#define BOOT_REGRESSION_BASELINE_FILE       L"BootRegressionBaseline.bin"
+
+//
+// Upper bound of one line of the JSON report.
+//
+#define BOOT_REGRESSION_JSON_LINE_SIZE      0x100
+
+typedef enum {
+  BootPhaseSec,
+  BootPhasePei,
+  BootPhaseDxe,
+  BootPhaseBds,
+  BootPhaseTotal,       ///< From reset to the end of BDS.
+  BootPhaseMax
+} BOOT_PHASE;
+
+STATIC CONST CHAR8  *mBootPhaseName[BootPhaseMax] = { "SEC", "PEI", "DXE", "BDS", "Total" };
+
+///
+/// The measurements, saved with the framework state across the reboots.
+/// Times are in nanoseconds.
+///
+typedef struct {
+  UINT32      BootCount;
+  UINT32      DriverCount;
+  EFI_GUID    DriverGuid[BOOT_REGRESSION_MAX_DRIVERS];
+  UINT64      PhaseTime[BOOT_REGRESSION_ITERATIONS][BootPhaseMax];
+  UINT64      DriverTime[BOOT_REGRESSION_ITERATIONS][BOOT_REGRESSION_MAX_DRIVERS];
+} BOOT_REGRESSION_CONTEXT;
+
+typedef struct {
+  EFI_GUID    Guid;
+  UINT64      Time;
+} BOOT_REGRESSION_DRIVER;
+
+#define BOOT_REGRESSION_SUMMARY_SIGNATURE  SIGNATURE_32 ('B', 'R', 'S', 'M')
+
+///
+/// The medians of a run, followed by DriverCount BOOT_REGRESSION_DRIVER.
+///
+typedef struct {
+  UINT32      Signature;
+  UINT32      DriverCount;
+  UINT64      PhaseTime[BootPhaseMax];
+} BOOT_REGRESSION_SUMMARY;
+
+/**
+  This function uses the ACPI SDT protocol to locate an ACPI table.
+  It is really only useful for finding tables that only have a single instance,
+  e.g. FADT, FACS, MADT, etc.  It is not good for locating SSDT, etc.
+
+  @param[in]      Signature      The signature of the table.
+  @param[in, out] Table          Updated with a pointer to the table.
+  @param[in, out] Handle         AcpiSupport protocol table handle for the table found.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+**/
+STATIC
+EFI_STATUS
+LocateAcpiTableBySignature (
+  IN      UINT32                        Signature,
+  IN OUT  EFI_ACPI_DESCRIPTION_HEADER   **Table,
+  IN OUT  UINTN                         *Handle
+  )
+{
+  EFI_STATUS              Status;
+  INTN                    Index;
+  EFI_ACPI_TABLE_VERSION  Version;
+  EFI_ACPI_SDT_PROTOCOL   *AcpiSdt;
+
+  AcpiSdt = NULL;
+  Status  = gBS->LocateProtocol (&gEfiAcpiSdtProtocolGuid, NULL, (VOID **) &AcpiSdt);
+  if (EFI_ERROR (Status) || (AcpiSdt == NULL)) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Locate table with matching ID
+  //
+  Version = 0;
+  Index   = 0;
+  do {
+    Status = AcpiSdt->GetAcpiTable (Index, (EFI_ACPI_SDT_HEADER **)Table, &Version, Handle);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+    Index++;
+  } while ((*Table)->Signature != Signature);
+
+  return Status;
+}
+
+/**
+  Locate the Firmware Basic Boot Performance Table of the current boot.
+
+  @param[out] Fbpt        The FBPT.
+
+  @retval EFI_SUCCESS     The FBPT was found.
+  @retval EFI_NOT_FOUND   The FPDT or the FBPT was not found.
+**/
+STATIC
+EFI_STATUS
+LocateFbpt (
+  OUT EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_TABLE  **Fbpt
+  )
+{
+  EFI_STATUS                  Status;
+  UINTN                       Handle;
+  FIRMWARE_PERFORMANCE_TABLE  *Fpdt;
+  UINTN                       FbptAddress;
+
+  Handle = 0;
+  Status = LocateAcpiTableBySignature (
+             EFI_ACPI_5_0_FIRMWARE_PERFORMANCE_DATA_TABLE_SIGNATURE,
+             (EFI_ACPI_DESCRIPTION_HEADER **) &Fpdt,
+             &Handle
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Unable to locate FPDT\n", __FUNCTION__));
+    return EFI_NOT_FOUND;
+  }
+
+  Status = SafeUint64ToUintn (Fpdt->BootPointerRecord.BootPerformanceTablePointer, &FbptAddress);
+  if (EFI_ERROR (Status) || (FbptAddress == 0)) {
+    DEBUG ((DEBUG_ERROR, "%a invalid BootPerformanceTablePointer\n", __FUNCTION__));
+    return EFI_NOT_FOUND;
+  }
+
+  *Fbpt = (EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_TABLE *) FbptAddress;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check the name of a string performance record.
+
+  @param[in] RecordHeader   The performance record.
+  @param[in] Name           The name.
+
+  @retval TRUE    The record is a string record with this name.
+  @retval FALSE   The record has another name, or no string.
+**/
+STATIC
+BOOLEAN
+IsRecordNamed (
+  IN EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER  *RecordHeader,
+  IN CONST CHAR8                                  *Name
+  )
+{
+  FPDT_RECORD_PTR   Record;
+  UINTN             Length;
+
+  if (RecordHeader->Type != FPDT_DYNAMIC_STRING_EVENT_TYPE) {
+    return FALSE;
+  }
+
+  Record.RecordHeader = RecordHeader;
+  Length              = AsciiStrLen (Name);
+
+  //
+  // The string isn't required to be terminated within the record.
+  //
+  if (RecordHeader->Length < OFFSET_OF (FPDT_DYNAMIC_STRING_EVENT_RECORD, String) + Length) {
+    return FALSE;
+  }
+
+  if (AsciiStrnCmp (Record.DynamicStringEvent->String, Name, Length) != 0) {
+    return FALSE;
+  }
+
+  return (BOOLEAN) ((RecordHeader->Length == OFFSET_OF (FPDT_DYNAMIC_STRING_EVENT_RECORD, String) + Length) ||
+                    (Record.DynamicStringEvent->String[Length] == 0));
+}
+
+/**
+  Find the index of a module in the measurements, adding it if it is new.
+
+  @param[in, out] Context   The measurements.
+  @param[in]      Guid      The module GUID.
+
+  @return The index of the module, or BOOT_REGRESSION_MAX_DRIVERS when there
+          is no room left.
+**/
+STATIC
+UINTN
+FindDriver (
+  IN OUT BOOT_REGRESSION_CONTEXT  *Context,
+  IN     CONST EFI_GUID           *Guid
+  )
+{
+  UINTN   Index;
+
+  for (Index = 0; Index < Context->DriverCount; Index++) {
+    if (CompareGuid (&Context->DriverGuid[Index], Guid)) {
+      return Index;
+    }
+  }
+
+  if (Context->DriverCount == BOOT_REGRESSION_MAX_DRIVERS) {
+    return BOOT_REGRESSION_MAX_DRIVERS;
+  }
+
+  CopyGuid (&Context->DriverGuid[Context->DriverCount], Guid);
+  return Context->DriverCount++;
+}
+
+/**
+  Add the phase and module times of the current boot to the measurements.
+
+  The SEC event and the PEI, DXE and BDS cross module records delimit the
+  phases. The time of a module is the time between its start and end image
+  records, nested modules included.
+
+  @param[in]      Fbpt      The FBPT of the current boot.
+  @param[in, out] Context   The measurements.
+**/
+STATIC
+VOID
+CollectBootSample (
+  IN     EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_TABLE  *Fbpt,
+  IN OUT BOOT_REGRESSION_CONTEXT                      *Context
+  )
+{
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER   *RecordHeader;
+  FPDT_RECORD_PTR                               Record;
+  UINT8                                         *RecordStart;
+  UINT8                                         *RecordEnd;
+  UINT64                                        PhaseStart[BootPhaseMax];
+  UINT64                                        PhaseEnd[BootPhaseMax];
+  EFI_GUID                                      OpenGuid[BOOT_REGRESSION_MAX_OPEN_MODULES];
+  UINT64                                        OpenStart[BOOT_REGRESSION_MAX_OPEN_MODULES];
+  UINTN                                         OpenCount;
+  UINT64                                        *PhaseTime;
+  UINT64                                        *DriverTime;
+  UINT64                                        Timestamp;
+  UINTN                                         Phase;
+  UINTN                                         Index;
+  UINTN                                         Driver;
+
+  ZeroMem (PhaseStart, sizeof (PhaseStart));
+  ZeroMem (PhaseEnd, sizeof (PhaseEnd));
+  OpenCount  = 0;
+  PhaseTime  = Context->PhaseTime[Context->BootCount];
+  DriverTime = Context->DriverTime[Context->BootCount];
+  ZeroMem (PhaseTime, sizeof (Context->PhaseTime[0]));
+  ZeroMem (DriverTime, sizeof (Context->DriverTime[0]));
+
+  RecordStart = (UINT8 *) Fbpt + sizeof (EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_TABLE);
+  RecordEnd   = (UINT8 *) Fbpt + Fbpt->Header.Length;
+
+  for (RecordHeader = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *) RecordStart;
+       (UINT8 *) RecordHeader + sizeof (*RecordHeader) <= RecordEnd && RecordHeader->Length >= sizeof (*RecordHeader);
+       RecordHeader = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *) ((UINT8 *) RecordHeader + RecordHeader->Length)) {
+    if ((UINT8 *) RecordHeader + RecordHeader->Length > RecordEnd) {
+      break;
+    }
+
+    if ((RecordHeader->Type < FPDT_GUID_EVENT_TYPE) ||
+        (RecordHeader->Type > FPDT_GUID_QWORD_STRING_EVENT_TYPE) ||
+        (RecordHeader->Length < sizeof (FPDT_GUID_EVENT_RECORD))) {
+      continue;
+    }
+
+    //
+    // All extended records share the ProgressID, ApicID, Timestamp and Guid layout.
+    //
+    Record.RecordHeader = RecordHeader;
+    Timestamp           = Record.GuidEvent->Timestamp;
+
+    switch (Record.GuidEvent->ProgressID) {
+      case PERF_EVENT_ID:
+        if (IsRecordNamed (RecordHeader, mBootPhaseName[BootPhaseSec]) && (PhaseEnd[BootPhaseSec] == 0)) {
+          PhaseEnd[BootPhaseSec] = Timestamp;
+        }
+        break;
+
+      case PERF_CROSSMODULE_START_ID:
+      case PERF_CROSSMODULE_END_ID:
+        for (Phase = BootPhasePei; Phase <= BootPhaseBds; Phase++) {
+          if (IsRecordNamed (RecordHeader, mBootPhaseName[Phase])) {
+            break;
+          }
+        }
+        if (Phase > BootPhaseBds) {
+          break;
+        }
+
+        //
+        // BDS is restarted when a boot option returns, only its first run is
+        // the boot path.
+        //
+        if (Record.GuidEvent->ProgressID == PERF_CROSSMODULE_START_ID) {
+          if (PhaseStart[Phase] == 0) {
+            PhaseStart[Phase] = Timestamp;
+          }
+        } else if ((PhaseStart[Phase] != 0) && (PhaseEnd[Phase] == 0)) {
+          PhaseEnd[Phase] = Timestamp;
+        }
+        break;
+
+      case MODULE_START_ID:
+        if (OpenCount < BOOT_REGRESSION_MAX_OPEN_MODULES) {
+          CopyGuid (&OpenGuid[OpenCount], &Record.GuidEvent->Guid);
+          OpenStart[OpenCount] = Timestamp;
+          OpenCount++;
+        }
+        break;
+
+      case MODULE_END_ID:
+        for (Index = OpenCount; Index > 0; Index--) {
+          if (CompareGuid (&OpenGuid[Index - 1], &Record.GuidEvent->Guid)) {
+            break;
+          }
+        }
+        if (Index == 0) {
+          break;
+        }
+
+        Index--;
+        Driver = FindDriver (Context, &OpenGuid[Index]);
+        if ((Driver < BOOT_REGRESSION_MAX_DRIVERS) && (Timestamp >= OpenStart[Index])) {
+          DriverTime[Driver] += Timestamp - OpenStart[Index];
+        }
+
+        OpenCount--;
+        CopyMem (&OpenGuid[Index], &OpenGuid[Index + 1], (OpenCount - Index) * sizeof (EFI_GUID));
+        CopyMem (&OpenStart[Index], &OpenStart[Index + 1], (OpenCount - Index) * sizeof (UINT64));
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  //
+  // Timestamps count from reset, which starts SEC.
+  //
+  PhaseTime[BootPhaseSec] = PhaseEnd[BootPhaseSec];
+  for (Phase = BootPhasePei; Phase <= BootPhaseBds; Phase++) {
+    if ((PhaseStart[Phase] != 0) && (PhaseEnd[Phase] > PhaseStart[Phase])) {
+      PhaseTime[Phase] = PhaseEnd[Phase] - PhaseStart[Phase];
+    }
+  }
+  PhaseTime[BootPhaseTotal] = PhaseEnd[BootPhaseBds];
+
+  Context->BootCount++;
+}
+
+/**
+  Get the median of samples.
+
+  @param[in, out] Samples   The samples, sorted on return.
+  @param[in]      Count     The number of samples, at least 1.
+
+  @return The median.
+**/
+STATIC
+UINT64
+GetMedian (
+  IN OUT UINT64   *Samples,
+  IN     UINTN    Count
+  )
+{
+  UINTN   Index;
+  UINTN   Index2;
+  UINT64  Sample;
+
+  for (Index = 1; Index < Count; Index++) {
+    Sample = Samples[Index];
+    for (Index2 = Index; Index2 > 0 && Samples[Index2 - 1] > Sample; Index2--) {
+      Samples[Index2] = Samples[Index2 - 1];
+    }
+    Samples[Index2] = Sample;
+  }
+
+  if ((Count & BIT0) != 0) {
+    return Samples[Count / 2];
+  }
+
+  return (Samples[Count / 2 - 1] + Samples[Count / 2]) / 2;
+}
+
+/**
+  Writes a buffer to file, replacing its previous content.
+
+  @param[in] FileName     The name of the file being written to.
+  @param[in] Buffer       The buffer to write to file.
+  @param[in] BufferSize   Size of the buffer.
+**/
+STATIC
+VOID
+WriteBufferToFile (
+  IN CONST CHAR16   *FileName,
+  IN       VOID     *Buffer,
+  IN       UINTN    BufferSize
+  )
+{
+  EFI_STATUS          Status;
+  SHELL_FILE_HANDLE   FileHandle;
+
+  //
+  // Delete the file if it exists, as the shell doesn't truncate it.
+  //
+  Status = ShellOpenFileByName (FileName, &FileHandle, EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE, 0);
+  if (!EFI_ERROR (Status)) {
+    Status = ShellDeleteFile (&FileHandle);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a failed to delete file %r\n", __FUNCTION__, Status));
+    }
+  }
+
+  Status = ShellOpenFileByName (
+             FileName,
+             &FileHandle,
+             EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ,
+             0
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a failed to create %s %r\n", __FUNCTION__, FileName, Status));
+    return;
+  }
+
+  ShellWriteFile (FileHandle, &BufferSize, Buffer);
+  ShellCloseFile (&FileHandle);
+
+  ShellPrintEx (-1, -1, L"Wrote to file %s\n", FileName);
+}
+
+/**
+  Read the baseline medians, if the baseline file exists.
+
+  @return The baseline, to free with FreePool(), or NULL.
+**/
+STATIC
+BOOT_REGRESSION_SUMMARY *
+ReadBaseline (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  SHELL_FILE_HANDLE         FileHandle;
+  UINT64                    FileSize;
+  UINTN                     ReadSize;
+  BOOT_REGRESSION_SUMMARY   *Baseline;
+
+  Status = ShellOpenFileByName (BOOT_REGRESSION_BASELINE_FILE, &FileHandle, EFI_FILE_MODE_READ, 0);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Baseline = NULL;
+  Status   = ShellGetFileSize (FileHandle, &FileSize);
+  if (!EFI_ERROR (Status) &&
+      (FileSize >= sizeof (BOOT_REGRESSION_SUMMARY)) &&
+      (FileSize <= sizeof (BOOT_REGRESSION_SUMMARY) + BOOT_REGRESSION_MAX_DRIVERS * sizeof (BOOT_REGRESSION_DRIVER))) {
+    ReadSize = (UINTN) FileSize;
+    Baseline = AllocatePool (ReadSize);
+    if (Baseline != NULL) {
+      Status = ShellReadFile (FileHandle, &ReadSize, Baseline);
+      if (EFI_ERROR (Status) ||
+          (ReadSize != FileSize) ||
+          (Baseline->Signature != BOOT_REGRESSION_SUMMARY_SIGNATURE) ||
+          (sizeof (BOOT_REGRESSION_SUMMARY) + Baseline->DriverCount * sizeof (BOOT_REGRESSION_DRIVER) > ReadSize)) {
+        FreePool (Baseline);
+        Baseline = NULL;
+      }
+    }
+  }
+
+  ShellCloseFile (&FileHandle);
+
+  if (Baseline == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a %s is not a valid baseline\n", __FUNCTION__, BOOT_REGRESSION_BASELINE_FILE));
+  }
+
+  return Baseline;
+}
+
+/**
+  Find the baseline median of a module.
+
+  @param[in]  Baseline  The baseline.
+  @param[in]  Guid      The module GUID.
+  @param[out] Time      The baseline median of the module.
+
+  @retval TRUE    The module is in the baseline.
+  @retval FALSE   The module is new.
+**/
+STATIC
+BOOLEAN
+GetBaselineDriverTime (
+  IN  BOOT_REGRESSION_SUMMARY   *Baseline,
+  IN  CONST EFI_GUID            *Guid,
+  OUT UINT64                    *Time
+  )
+{
+  BOOT_REGRESSION_DRIVER  *Drivers;
+  UINTN                   Index;
+
+  Drivers = (BOOT_REGRESSION_DRIVER *) (Baseline + 1);
+  for (Index = 0; Index < Baseline->DriverCount; Index++) {
+    if (CompareGuid (&Drivers[Index].Guid, Guid)) {
+      *Time = Drivers[Index].Time;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Format the delta of a median against its baseline, in microseconds.
+
+  @param[out] Buffer      The JSON fields.
+  @param[in]  BufferSize  Size of Buffer in bytes.
+  @param[in]  Median      The median.
+  @param[in]  Baseline    The baseline median.
+**/
+STATIC
+VOID
+FormatDelta (
+  OUT CHAR8     *Buffer,
+  IN  UINTN     BufferSize,
+  IN  UINT64    Median,
+  IN  UINT64    Baseline
+  )
+{
+  AsciiSPrint (
+    Buffer,
+    BufferSize,
+    ",\"BaselineUs\":%ld,\"DeltaUs\":%ld",
+    DivU64x32 (Baseline, 1000),
+    DivS64x64Remainder ((INT64) Median - (INT64) Baseline, 1000, NULL)
+    );
+}
+
+/**
+  Compute the medians of the measurements and write the JSON report and the
+  summary that may serve as the baseline of a later run.
+
+  @param[in] Context    The measurements.
+  @param[in] Baseline   The baseline, or NULL.
+
+  @return The number of phases that regressed against the baseline.
+**/
+STATIC
+UINTN
+WriteReport (
+  IN BOOT_REGRESSION_CONTEXT  *Context,
+  IN BOOT_REGRESSION_SUMMARY  *Baseline   OPTIONAL
+  )
+{
+  BOOT_REGRESSION_SUMMARY   *Summary;
+  BOOT_REGRESSION_DRIVER    *Drivers;
+  BOOT_REGRESSION_DRIVER    Driver;
+  UINT64                    Samples[BOOT_REGRESSION_ITERATIONS];
+  UINT64                    BaselineTime;
+  UINTN                     SummarySize;
+  UINTN                     Regressions;
+  BOOLEAN                   Regressed;
+  UINTN                     Phase;
+  UINTN                     Index;
+  UINTN                     Index2;
+  UINTN                     Boot;
+  CHAR8                     *Json;
+  UINTN                     JsonSize;
+  UINTN                     JsonLength;
+  CHAR8                     Delta[BOOT_REGRESSION_JSON_LINE_SIZE / 2];
+
+  SummarySize = sizeof (BOOT_REGRESSION_SUMMARY) + Context->DriverCount * sizeof (BOOT_REGRESSION_DRIVER);
+  Summary     = AllocateZeroPool (SummarySize);
+  JsonSize    = (BootPhaseMax + Context->DriverCount + 8) * BOOT_REGRESSION_JSON_LINE_SIZE;
+  Json        = AllocatePool (JsonSize);
+  if ((Summary == NULL) || (Json == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a unable to allocate the report buffers\n", __FUNCTION__));
+    if (Summary != NULL) {
+      FreePool (Summary);
+    }
+    if (Json != NULL) {
+      FreePool (Json);
+    }
+    return 0;
+  }
+
+  Summary->Signature   = BOOT_REGRESSION_SUMMARY_SIGNATURE;
+  Summary->DriverCount = Context->DriverCount;
+  Drivers              = (BOOT_REGRESSION_DRIVER *) (Summary + 1);
+
+  for (Phase = 0; Phase < BootPhaseMax; Phase++) {
+    for (Boot = 0; Boot < Context->BootCount; Boot++) {
+      Samples[Boot] = Context->PhaseTime[Boot][Phase];
+    }
+    Summary->PhaseTime[Phase] = GetMedian (Samples, Context->BootCount);
+  }
+
+  //
+  // Sort the modules from the highest median to the lowest, by insertion.
+  //
+  for (Index = 0; Index < Context->DriverCount; Index++) {
+    for (Boot = 0; Boot < Context->BootCount; Boot++) {
+      Samples[Boot] = Context->DriverTime[Boot][Index];
+    }
+    CopyGuid (&Driver.Guid, &Context->DriverGuid[Index]);
+    Driver.Time = GetMedian (Samples, Context->BootCount);
+
+    for (Index2 = Index; Index2 > 0 && Drivers[Index2 - 1].Time < Driver.Time; Index2--) {
+      CopyMem (&Drivers[Index2], &Drivers[Index2 - 1], sizeof (Driver));
+    }
+    CopyMem (&Drivers[Index2], &Driver, sizeof (Driver));
+  }
+
+  JsonLength = AsciiSPrint (
+                 Json,
+                 JsonSize,
+                 "{\n  \"Boots\":%d,\n  \"TolerancePercent\":%d,\n  \"Baseline\":%a,\n  \"Phases\":[",
+                 Context->BootCount,
+                 BOOT_REGRESSION_TOLERANCE_PERCENT,
+                 (Baseline != NULL) ? "true" : "false"
+                 );
+
+  Regressions = 0;
+  for (Phase = 0; Phase < BootPhaseMax; Phase++) {
+    Delta[0]  = 0;
+    Regressed = FALSE;
+    if (Baseline != NULL) {
+      FormatDelta (Delta, sizeof (Delta), Summary->PhaseTime[Phase], Baseline->PhaseTime[Phase]);
+      Regressed = (BOOLEAN) (Summary->PhaseTime[Phase] >
+                             DivU64x32 (MultU64x32 (Baseline->PhaseTime[Phase], 100 + BOOT_REGRESSION_TOLERANCE_PERCENT), 100));
+      if (Regressed) {
+        Regressions++;
+        UT_LOG_ERROR (
+          "%a median %ld us, baseline %ld us\n",
+          mBootPhaseName[Phase],
+          DivU64x32 (Summary->PhaseTime[Phase], 1000),
+          DivU64x32 (Baseline->PhaseTime[Phase], 1000)
+          );
+      }
+    }
+
+    for (Boot = 0; Boot < Context->BootCount; Boot++) {
+      Samples[Boot] = Context->PhaseTime[Boot][Phase];
+    }
+    GetMedian (Samples, Context->BootCount);
+
+    JsonLength += AsciiSPrint (
+                    Json + JsonLength,
+                    JsonSize - JsonLength,
+                    "%a\n    {\"Name\":\"%a\",\"MedianUs\":%ld,\"MinUs\":%ld,\"MaxUs\":%ld%a,\"Regression\":%a}",
+                    (Phase == 0) ? "" : ",",
+                    mBootPhaseName[Phase],
+                    DivU64x32 (Summary->PhaseTime[Phase], 1000),
+                    DivU64x32 (Samples[0], 1000),
+                    DivU64x32 (Samples[Context->BootCount - 1], 1000),
+                    Delta,
+                    Regressed ? "true" : "false"
+                    );
+  }
+
+  JsonLength += AsciiSPrint (Json + JsonLength, JsonSize - JsonLength, "\n  ],\n  \"Modules\":[");
+
+  for (Index = 0; Index < Context->DriverCount; Index++) {
+    Delta[0] = 0;
+    if (Baseline != NULL) {
+      if (!GetBaselineDriverTime (Baseline, &Drivers[Index].Guid, &BaselineTime)) {
+        BaselineTime = 0;
+      }
+      FormatDelta (Delta, sizeof (Delta), Drivers[Index].Time, BaselineTime);
+    }
+
+    JsonLength += AsciiSPrint (
+                    Json + JsonLength,
+                    JsonSize - JsonLength,
+                    "%a\n    {\"Guid\":\"%g\",\"MedianUs\":%ld%a}",
+                    (Index == 0) ? "" : ",",
+                    &Drivers[Index].Guid,
+                    DivU64x32 (Drivers[Index].Time, 1000),
+                    Delta
+                    );
+  }
+
+  JsonLength += AsciiSPrint (Json + JsonLength, JsonSize - JsonLength, "\n  ]\n}\n");
+
+  WriteBufferToFile (BOOT_REGRESSION_REPORT_FILE, Json, JsonLength);
+  WriteBufferToFile (BOOT_REGRESSION_SUMMARY_FILE, Summary, SummarySize);
+
+  FreePool (Json);
+  FreePool (Summary);
+  return Regressions;
+}
+
+/**
+  Measure the current boot, then reboot until all the boots are measured and
+  report the medians.
+
+  @param[in] Context    The measurements saved before the reboot, or NULL on
+                        the first run.
+
+  @retval UNIT_TEST_PASSED              No phase regressed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED   A phase regressed, or the boot could
+                                        not be measured.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MeasureBootTime (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                                   Status;
+  BOOT_REGRESSION_CONTEXT                      *BootContext;
+  EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_TABLE  *Fbpt;
+  BOOT_REGRESSION_SUMMARY                      *Baseline;
+  UINTN                                        Regressions;
+
+  BootContext = (BOOT_REGRESSION_CONTEXT *) Context;
+  if (BootContext == NULL) {
+    //
+    // The boot of the first run may be a cold boot, or include the setup of
+    // the test, so it is not measured.
+    //
+    BootContext = AllocateZeroPool (sizeof (BOOT_REGRESSION_CONTEXT));
+    UT_ASSERT_NOT_NULL (BootContext);
+  } else {
+    UT_ASSERT_TRUE (BootContext->BootCount < BOOT_REGRESSION_ITERATIONS);
+
+    Status = LocateFbpt (&Fbpt);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+
+    CollectBootSample (Fbpt, BootContext);
+    UT_LOG_INFO (
+      "Boot %d of %d: %ld us\n",
+      BootContext->BootCount,
+      BOOT_REGRESSION_ITERATIONS,
+      DivU64x32 (BootContext->PhaseTime[BootContext->BootCount - 1][BootPhaseTotal], 1000)
+      );
+  }
+
+  if (BootContext->BootCount < BOOT_REGRESSION_ITERATIONS) {
+    Status = SaveFrameworkState (BootContext, sizeof (BOOT_REGRESSION_CONTEXT));
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+
+    gRT->ResetSystem (EfiResetWarm, EFI_SUCCESS, 0, NULL);
+    UT_LOG_ERROR ("Warm reset failed\n");
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  Baseline    = ReadBaseline ();
+  Regressions = WriteReport (BootContext, Baseline);
+  if (Baseline != NULL) {
+    FreePool (Baseline);
+  }
+
+  UT_ASSERT_EQUAL (Regressions, 0);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  BootRegressionEntryPoint
+
+  @param[in] ImageHandle  The firmware allocated handle for the EFI image.
+  @param[in] SystemTable  A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS     The entry point executed successfully.
+  @retval other           Some error occured when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+BootRegressionEntryPoint (
+  IN     EFI_HANDLE         ImageHandle,
+  IN     EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      BootTime;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&BootTime, Framework, "Boot Time", "BootRegression.BootTime", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BootTime\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (BootTime, "Boot time over warm reboots", "MeasureBootTime", MeasureBootTime, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
@@ -16,12 +16,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiApplicationEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Guid/FirmwarePerformance.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+#include <Library/PerformanceLib.h>
 #include <Protocol/AcpiSystemDescriptionTable.h>
 #include <Library/SafeIntLib.h>
 #include <Protocol/Smbios.h>
 
 #define MAX_STRING_SIZE 0x1000
 
+//
+// Upper bound of one formatted trace event, including the longest record name.
+//
+#define MAX_TRACE_EVENT_SIZE 0x100
+
 /**
 
   Acquire the string associated with the Index from smbios structure and return it.
@@ -71,14 +78,15 @@ GetOptionalStringByIndex (
  * @param      FileName     The name of the file being written to.
  * @param      Buffer       The buffer to write to file.
  * @param[in]  BufferSize   Size of the buffer.
- * @param[in]  WriteCount   Number to append to the end of the file.
+ * @param[in]  Extension    Extension appended to the file name.
  */
 STATIC
 VOID
 WriteBufferToFile (
   IN CONST CHAR16                   *FileName,
   IN       VOID                     *Buffer,
-  IN       UINTN                    BufferSize
+  IN       UINTN                    BufferSize,
+  IN CONST CHAR16                   *Extension
   )
 {
   EFI_STATUS          Status;
@@ -88,7 +96,7 @@ WriteBufferToFile (
 
   // Calculate final file name.
   ZeroMem( FileNameAndExt, sizeof(CHAR16) * MAX_STRING_SIZE );
-  UnicodeSPrint( FileNameAndExt, MAX_STRING_SIZE, L"%s.bin", FileName );
+  UnicodeSPrint( FileNameAndExt, MAX_STRING_SIZE, L"%s.%s", FileName, Extension );
 
   // First, let's open the file if it exists so we can delete it...
   // This is the work around for truncation
@@ -115,6 +123,301 @@ WriteBufferToFile (
   }
 }
 
+/**
+  Get the trace event phase of a performance record from its progress ID.
+
+  Progress IDs below 0x10 use odd values for start records, while the
+  general IDs from 0x10 up use even values, see PerformanceLib.h.
+
+  @param[in] ProgressId   Progress ID of the record.
+
+  @retval 'B'   The record starts a measurement.
+  @retval 'E'   The record ends a measurement.
+  @retval 'i'   The record is a single event.
+**/
+STATIC
+CHAR8
+GetTraceEventPhase (
+  IN UINT16   ProgressId
+  )
+{
+  if (ProgressId == PERF_EVENT_ID) {
+    return 'i';
+  }
+
+  if (ProgressId < PERF_EVENTSIGNAL_START_ID) {
+    return ((ProgressId & BIT0) != 0) ? 'B' : 'E';
+  }
+
+  return ((ProgressId & BIT0) == 0) ? 'B' : 'E';
+}
+
+/**
+  Get the trace event category of a performance record from its progress ID.
+
+  @param[in] ProgressId   Progress ID of the record.
+
+  @return The category string.
+**/
+STATIC
+CONST CHAR8 *
+GetTraceEventCategory (
+  IN UINT16   ProgressId
+  )
+{
+  switch (ProgressId) {
+    case MODULE_START_ID:
+    case MODULE_END_ID:
+      return START_IMAGE_TOK;
+    case MODULE_LOADIMAGE_START_ID:
+    case MODULE_LOADIMAGE_END_ID:
+      return LOAD_IMAGE_TOK;
+    case MODULE_DB_START_ID:
+    case MODULE_DB_END_ID:
+      return DRIVERBINDING_START_TOK;
+    case MODULE_DB_SUPPORT_START_ID:
+    case MODULE_DB_SUPPORT_END_ID:
+      return DRIVERBINDING_SUPPORT_TOK;
+    case MODULE_DB_STOP_START_ID:
+    case MODULE_DB_STOP_END_ID:
+      return DRIVERBINDING_STOP_TOK;
+    default:
+      return "General";
+  }
+}
+
+/**
+  Copy the name of a performance record into a JSON safe ASCII string.
+
+  String records use their string, the other records use their GUID.
+  Quotes, backslashes and control characters are replaced with '_'.
+
+  @param[in]  RecordHeader  The performance record.
+  @param[out] Name          Buffer receiving the name.
+  @param[in]  NameSize      Size of the Name buffer in bytes.
+**/
+STATIC
+VOID
+GetTraceEventName (
+  IN  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER   *RecordHeader,
+  OUT CHAR8                                         *Name,
+  IN  UINTN                                         NameSize
+  )
+{
+  FPDT_RECORD_PTR   Record;
+  CHAR8             *String;
+  UINTN             StringOffset;
+  UINTN             Index;
+
+  Record.RecordHeader = RecordHeader;
+  String              = NULL;
+  StringOffset        = 0;
+
+  switch (RecordHeader->Type) {
+    case FPDT_DYNAMIC_STRING_EVENT_TYPE:
+      String       = Record.DynamicStringEvent->String;
+      StringOffset = OFFSET_OF (FPDT_DYNAMIC_STRING_EVENT_RECORD, String);
+      break;
+    case FPDT_DUAL_GUID_STRING_EVENT_TYPE:
+      String       = Record.DualGuidStringEvent->String;
+      StringOffset = OFFSET_OF (FPDT_DUAL_GUID_STRING_EVENT_RECORD, String);
+      break;
+    case FPDT_GUID_QWORD_STRING_EVENT_TYPE:
+      String       = Record.GuidQwordStringEvent->String;
+      StringOffset = OFFSET_OF (FPDT_GUID_QWORD_STRING_EVENT_RECORD, String);
+      break;
+    default:
+      break;
+  }
+
+  if ((String == NULL) || (RecordHeader->Length <= StringOffset) || (String[0] == 0)) {
+    //
+    // All extended records carry the GUID at the same offset.
+    //
+    AsciiSPrint (Name, NameSize, "%g", &Record.GuidEvent->Guid);
+    return;
+  }
+
+  //
+  // The string isn't required to be terminated within the record.
+  //
+  for (Index = 0; Index < NameSize - 1 && Index < RecordHeader->Length - StringOffset && String[Index] != 0; Index++) {
+    if ((String[Index] < ' ') || (String[Index] > '~') || (String[Index] == '"') || (String[Index] == '\\')) {
+      Name[Index] = '_';
+    } else {
+      Name[Index] = String[Index];
+    }
+  }
+  Name[Index] = 0;
+}
+
+/**
+  Append one trace event to the JSON buffer, following the events already in it.
+
+  @param[in]      Buffer        The JSON buffer.
+  @param[in]      BufferSize    Size of the JSON buffer in bytes.
+  @param[in, out] Length        Length of the JSON already in Buffer, updated on return.
+  @param[in]      Name          Name of the event.
+  @param[in]      Category      Category of the event.
+  @param[in]      Phase         Trace event phase, 'B', 'E' or 'i'.
+  @param[in]      Timestamp     Timestamp of the event in nanoseconds.
+  @param[in]      ApicId        APIC ID of the processor that logged the event.
+**/
+STATIC
+VOID
+AppendTraceEvent (
+  IN     CHAR8          *Buffer,
+  IN     UINTN          BufferSize,
+  IN OUT UINTN          *Length,
+  IN     CONST CHAR8    *Name,
+  IN     CONST CHAR8    *Category,
+  IN     CHAR8          Phase,
+  IN     UINT64         Timestamp,
+  IN     UINT32         ApicId
+  )
+{
+  UINT32  Nanoseconds;
+
+  if (BufferSize - *Length < MAX_TRACE_EVENT_SIZE) {
+    return;
+  }
+
+  //
+  // The trace event format uses microseconds, one track per processor.
+  //
+  *Length += AsciiSPrint (
+               Buffer + *Length,
+               BufferSize - *Length,
+               ",\n  {\"name\":\"%a\",\"cat\":\"%a\",\"ph\":\"%c\",\"ts\":%ld.%03d,\"pid\":1,\"tid\":%d%a}",
+               Name,
+               Category,
+               (UINTN) Phase,
+               DivU64x32Remainder (Timestamp, 1000, &Nanoseconds),
+               Nanoseconds,
+               ApicId,
+               (Phase == 'i') ? ",\"s\":\"g\"" : ""
+               );
+}
+
+/**
+  Export the FBPT records as a Chrome trace event JSON file.
+
+  Start and end records are written as begin and end events, so the viewer
+  nests them into spans such as StartImage, driver binding Start and the
+  measurements logged inside them. PEI and SMM records are already merged
+  into FBPT by the DXE core performance library. Records are placed on one
+  track per APIC ID.
+
+  @param[in] FileName     File name without extension.
+  @param[in] Fbpt         The Firmware Basic Boot Performance Table.
+**/
+STATIC
+VOID
+WriteTraceToFile (
+  IN CONST CHAR16                                 *FileName,
+  IN EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_TABLE  *Fbpt
+  )
+{
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER   *RecordHeader;
+  EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_RECORD  *BasicBoot;
+  FPDT_RECORD_PTR                               Record;
+  UINT8                                         *RecordStart;
+  UINT8                                         *RecordEnd;
+  UINTN                                         RecordCount;
+  CHAR8                                         *Json;
+  UINTN                                         JsonSize;
+  UINTN                                         JsonLength;
+  CHAR8                                         Name[MAX_TRACE_EVENT_SIZE / 2];
+
+  RecordStart = (UINT8 *) Fbpt + sizeof (EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_TABLE);
+  RecordEnd   = (UINT8 *) Fbpt + Fbpt->Header.Length;
+
+  //
+  // Count the records first, the basic boot record expands to up to five events.
+  //
+  RecordCount = 0;
+  for (RecordHeader = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *) RecordStart;
+       (UINT8 *) RecordHeader + sizeof (*RecordHeader) <= RecordEnd && RecordHeader->Length >= sizeof (*RecordHeader);
+       RecordHeader = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *) ((UINT8 *) RecordHeader + RecordHeader->Length)) {
+    RecordCount++;
+  }
+
+  JsonSize = (RecordCount + 7) * MAX_TRACE_EVENT_SIZE;
+  Json     = AllocatePool (JsonSize);
+  if (Json == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a unable to allocate the trace buffer\n", __FUNCTION__));
+    return;
+  }
+
+  //
+  // The metadata event naming the process leads the array, so that every
+  // following event is appended after a separator.
+  //
+  JsonLength = AsciiSPrint (
+                 Json,
+                 JsonSize,
+                 "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n  {\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Boot\"}}"
+                 );
+
+  for (RecordHeader = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *) RecordStart;
+       (UINT8 *) RecordHeader + sizeof (*RecordHeader) <= RecordEnd && RecordHeader->Length >= sizeof (*RecordHeader);
+       RecordHeader = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *) ((UINT8 *) RecordHeader + RecordHeader->Length)) {
+    if ((UINT8 *) RecordHeader + RecordHeader->Length > RecordEnd) {
+      break;
+    }
+
+    if (RecordHeader->Type == EFI_ACPI_5_0_FPDT_RUNTIME_RECORD_TYPE_FIRMWARE_BASIC_BOOT) {
+      if (RecordHeader->Length < sizeof (EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_RECORD)) {
+        continue;
+      }
+      BasicBoot = (EFI_ACPI_5_0_FPDT_FIRMWARE_BASIC_BOOT_RECORD *) RecordHeader;
+      if (BasicBoot->ResetEnd != 0) {
+        AppendTraceEvent (Json, JsonSize, &JsonLength, "ResetEnd", "BasicBoot", 'i', BasicBoot->ResetEnd, 0);
+      }
+      if (BasicBoot->OsLoaderLoadImageStart != 0) {
+        AppendTraceEvent (Json, JsonSize, &JsonLength, "OsLoaderLoadImageStart", "BasicBoot", 'i', BasicBoot->OsLoaderLoadImageStart, 0);
+      }
+      if (BasicBoot->OsLoaderStartImageStart != 0) {
+        AppendTraceEvent (Json, JsonSize, &JsonLength, "OsLoaderStartImageStart", "BasicBoot", 'i', BasicBoot->OsLoaderStartImageStart, 0);
+      }
+      if (BasicBoot->ExitBootServicesEntry != 0) {
+        AppendTraceEvent (Json, JsonSize, &JsonLength, "ExitBootServicesEntry", "BasicBoot", 'i', BasicBoot->ExitBootServicesEntry, 0);
+      }
+      if (BasicBoot->ExitBootServicesExit != 0) {
+        AppendTraceEvent (Json, JsonSize, &JsonLength, "ExitBootServicesExit", "BasicBoot", 'i', BasicBoot->ExitBootServicesExit, 0);
+      }
+      continue;
+    }
+
+    if ((RecordHeader->Type < FPDT_GUID_EVENT_TYPE) ||
+        (RecordHeader->Type > FPDT_GUID_QWORD_STRING_EVENT_TYPE) ||
+        (RecordHeader->Length < sizeof (FPDT_GUID_EVENT_RECORD))) {
+      continue;
+    }
+
+    //
+    // All extended records share the ProgressID, ApicID, Timestamp and Guid layout.
+    //
+    Record.RecordHeader = RecordHeader;
+    GetTraceEventName (RecordHeader, Name, sizeof (Name));
+    AppendTraceEvent (
+      Json,
+      JsonSize,
+      &JsonLength,
+      Name,
+      GetTraceEventCategory (Record.GuidEvent->ProgressID),
+      GetTraceEventPhase (Record.GuidEvent->ProgressID),
+      Record.GuidEvent->Timestamp,
+      Record.GuidEvent->ApicID
+      );
+  }
+
+  JsonLength += AsciiSPrint (Json + JsonLength, JsonSize - JsonLength, "\n]}\n");
+  WriteBufferToFile (FileName, Json, JsonLength, L"json");
+
+  FreePool (Json);
+}
+
 /**
   This function uses the ACPI SDT protocol to locate an ACPI table.
   It is really only useful for finding tables that only have a single instance,
@@ -270,7 +573,12 @@ FbptDumpEntryPoint (
   //
   // Save FBPT into a file
   //
-  WriteBufferToFile (FileName, (VOID*)pFBPT, (UINTN)FBPTLength);
+  WriteBufferToFile (FileName, (VOID*)pFBPT, (UINTN)FBPTLength, L"bin");
+
+  //
+  // Save the same records as a boot trace for trace event viewers
+  //
+  WriteTraceToFile (FileName, pFBPT);
 
   if (UefiVersion != NULL) {
     FreePool (UefiVersion);
@@ -93,6 +93,80 @@ InstallPreHashFvPpi (
   ASSERT_EFI_ERROR (Status);
 }
 
+/**
+  Hash FVs from the job queue until no job is left.
+
+  This function may run on APs, so it must not use PEI services, allocate
+  memory or print debug messages.
+
+  @param[in, out]  Buffer         Pointer to FV_HASH_JOB_QUEUE.
+**/
+STATIC
+VOID
+EFIAPI
+FvHashWorker (
+  IN OUT VOID             *Buffer
+  )
+{
+  FV_HASH_JOB_QUEUE     *Queue;
+  FV_HASH_JOB           *Job;
+  UINT32                JobIndex;
+
+  Queue = (FV_HASH_JOB_QUEUE *)Buffer;
+  while (TRUE) {
+    JobIndex = InterlockedIncrement (&Queue->NextJob) - 1;
+    if (JobIndex >= Queue->JobCount) {
+      break;
+    }
+
+    Job = &Queue->Jobs[JobIndex];
+    if (Job->Buffer != NULL) {
+      Job->Hashed = Queue->HashAll (Job->Buffer, Job->Length, Job->HashValue);
+    }
+  }
+}
+
+/**
+  Hash all FVs in the job queue.
+
+  If PcdFvReportParallelHash is TRUE and EDKII_PEI_MP_SERVICES2_PPI is
+  available, different FVs are hashed concurrently on all processors.
+  Otherwise, or if the APs cannot be started, the FVs are hashed on the BSP.
+
+  @param[in, out]  Queue          FVs to be hashed.
+**/
+STATIC
+VOID
+HashFvJobs (
+  IN OUT FV_HASH_JOB_QUEUE  *Queue
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_PEI_MP_SERVICES2_PPI  *MpServices2;
+
+  Queue->NextJob = 0;
+
+  if (PcdGetBool (PcdFvReportParallelHash) && Queue->JobCount > 1) {
+    Status = PeiServicesLocatePpi (
+               &gEdkiiPeiMpServices2PpiGuid,
+               0,
+               NULL,
+               (VOID **)&MpServices2
+               );
+    if (!EFI_ERROR (Status)) {
+      Status = MpServices2->StartupAllCPUs (MpServices2, FvHashWorker, 0, Queue);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_WARN, "Failed to hash FVs on APs - %r\r\n", Status));
+      }
+    }
+  }
+
+  //
+  // Hash on the BSP whatever is left, which is everything in serial mode.
+  //
+  FvHashWorker (Queue);
+}
+
 /**
   Calculate and verify hash value for given FV.
 
@@ -118,6 +192,8 @@ VerifyHashedFv (
   CONST HASH_ALG_INFO   *AlgInfo;
   UINT8                 *HashValue;
   UINT8                 *FvHashValue;
+  FV_HASH_JOB           *Jobs;
+  FV_HASH_JOB_QUEUE     Queue;
   VOID                  *FvBuffer;
   EFI_STATUS            Status;
 
@@ -145,9 +221,19 @@ VerifyHashedFv (
   ASSERT (HashValue != NULL);
 
   //
-  // Calculate hash value for each FV first.
+  // Each job hashes its FV into its own slot, so the FVs can be hashed in
+  // any order and on any processor.
+  //
+  Jobs = AllocateZeroPool ((sizeof (FV_HASH_JOB) + AlgInfo->HashSize) * FvNumber);
+  ASSERT (Jobs != NULL);
+
+  Queue.HashAll  = AlgInfo->HashAll;
+  Queue.Jobs     = Jobs;
+  Queue.JobCount = 0;
+
+  //
+  // Copy all FVs to be hashed first. Only the BSP may allocate memory.
   //
-  FvHashValue = HashValue;
   for (FvIndex = 0; FvIndex < FvNumber; ++FvIndex) {
     //
     // FV must be meant for verified boot and/or measured boot.
@@ -182,7 +268,28 @@ VerifyHashedFv (
     ASSERT (FvBuffer != NULL);
     CopyMem (FvBuffer, (CONST VOID *)(UINTN)FvInfo[FvIndex].Base, (UINTN)FvInfo[FvIndex].Length);
 
-    if (!AlgInfo->HashAll (FvBuffer, (UINTN)FvInfo[FvIndex].Length, FvHashValue)) {
+    Jobs[FvIndex].Buffer    = FvBuffer;
+    Jobs[FvIndex].Length    = (UINTN)FvInfo[FvIndex].Length;
+    Jobs[FvIndex].HashValue = (UINT8 *)&Jobs[FvNumber] + AlgInfo->HashSize * FvIndex;
+    Queue.JobCount          = (UINT32)FvIndex + 1;
+  }
+
+  //
+  // Calculate hash value for each FV.
+  //
+  HashFvJobs (&Queue);
+
+  FvHashValue = HashValue;
+  for (FvIndex = 0; FvIndex < Queue.JobCount; ++FvIndex) {
+    //
+    // Skipped FVs have no buffer.
+    //
+    FvBuffer = (VOID *)Jobs[FvIndex].Buffer;
+    if (FvBuffer == NULL) {
+      continue;
+    }
+
+    if (!Jobs[FvIndex].Hashed) {
       Status = EFI_ABORTED;
       goto Done;
     }
@@ -196,7 +303,7 @@ VerifyHashedFv (
         (UINTN)FvInfo[FvIndex].Length,
         HashInfo->HashAlgoId,
         HashInfo->HashSize,
-        FvHashValue
+        Jobs[FvIndex].HashValue
         );
     }
 
@@ -204,6 +311,7 @@ VerifyHashedFv (
     // Don't keep the hash value of current FV if we don't need to verify it.
     //
     if ((FvInfo[FvIndex].Flag & HASHED_FV_FLAG_VERIFIED_BOOT) != 0) {
+      CopyMem (FvHashValue, Jobs[FvIndex].HashValue, AlgInfo->HashSize);
       FvHashValue += AlgInfo->HashSize;
     }
 
@@ -225,6 +333,7 @@ VerifyHashedFv (
   }
 
 Done:
+  FreePool (Jobs);
   FreePool (HashValue);
   return Status;
 }
@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <IndustryStandard/Tpm20.h>
 
 #include <Ppi/FirmwareVolumeInfoStoredHashFv.h>
+#include <Ppi/MpServices2.h>
 
 #include <Library/PeiServicesLib.h>
 #include <Library/PcdLib.h>
@@ -23,6 +24,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/BaseCryptLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/SynchronizationLib.h>
 
 #define HASH_INFO_PTR(PreHashedFvPpi)  \
   (HASH_INFO *)((UINT8 *)(PreHashedFvPpi) + sizeof (EDKII_PEI_FIRMWARE_VOLUME_INFO_PREHASHED_FV_PPI))
@@ -118,5 +120,28 @@ typedef struct {
   HASH_ALL_METHOD     HashAll;
 } HASH_ALG_INFO;
 
+//
+// One FV to be hashed. Buffer is the permanent memory copy of the FV, or
+// NULL if the FV is skipped in current boot mode.
+//
+typedef struct {
+  CONST VOID          *Buffer;
+  UINTN               Length;
+  UINT8               *HashValue;
+  BOOLEAN             Hashed;
+} FV_HASH_JOB;
+
+//
+// FVs to be hashed, shared by all processors taking part in the hashing.
+// Each processor claims the next job by incrementing NextJob, so a job is
+// hashed exactly once no matter how many processors run FvHashWorker().
+//
+typedef struct {
+  HASH_ALL_METHOD     HashAll;
+  FV_HASH_JOB         *Jobs;
+  UINT32              JobCount;
+  volatile UINT32     NextJob;
+} FV_HASH_JOB_QUEUE;
+
 #endif //__FV_REPORT_PEI_H__
 
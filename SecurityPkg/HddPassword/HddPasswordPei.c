@@ -205,8 +205,6 @@ UnlockHddPassword (
   UINTN                          Length;
   UINT8                          DummyData;
   HDD_PASSWORD_DEVICE_INFO       *DevInfo;
-  UINT16                         Port;
-  UINT16                         PortMultiplierPort;
   EFI_DEVICE_PATH_PROTOCOL       *DevicePath;
   UINTN                          DevicePathLength;
 
@@ -235,61 +233,46 @@ UnlockHddPassword (
   }
 
   //
-  // Go through all the devices managed by the AtaPassThru PPI instance.
+  // The LockBox already records the port and port multiplier port of every
+  // device saved at boot time, so issue the commands to them directly rather
+  // than enumerating all the devices managed by the AtaPassThru PPI instance
+  // and searching the LockBox for each of them. Devices no longer attached
+  // to the controller are rejected by the PassThru service.
   //
-  Port = 0xFFFF;
-  while (TRUE) {
-    Status = AtaPassThruPpi->GetNextPort (AtaPassThruPpi, &Port);
-    if (EFI_ERROR (Status)) {
+  DevInfo = (HDD_PASSWORD_DEVICE_INFO *) Buffer;
+  while ((UINTN) DevInfo < ((UINTN) Buffer + Length)) {
+    //
+    // Only handle the devices behind the controller of this PPI instance.
+    //
+    if ((DevInfo->DevicePathLength >= DevicePathLength) &&
+        (CompareMem (
+          DevInfo->DevicePath,
+          DevicePath,
+          DevicePathLength - sizeof (EFI_DEVICE_PATH_PROTOCOL)) == 0)) {
       //
-      // We cannot find more legal port then we are done.
+      // If device locked, unlock first.
       //
-      break;
-    }
-
-    PortMultiplierPort = 0xFFFF;
-    while (TRUE) {
-      Status = AtaPassThruPpi->GetNextDevice (AtaPassThruPpi, Port, &PortMultiplierPort);
-      if (EFI_ERROR (Status)) {
-        //
-        // We cannot find more legal port multiplier port number for ATA device
-        // on the port, then we are done.
-        //
-        break;
+      if (!IsZeroBuffer (DevInfo->Password, HDD_PASSWORD_MAX_LENGTH)) {
+        UnlockDevice (
+          AtaPassThruPpi,
+          DevInfo->Device.Port,
+          DevInfo->Device.PortMultiplierPort,
+          0,
+          DevInfo->Password
+          );
       }
-
       //
-      // Search the device in the restored LockBox.
+      // Freeze lock the device.
       //
-      DevInfo = (HDD_PASSWORD_DEVICE_INFO *) Buffer;
-      while ((UINTN) DevInfo < ((UINTN) Buffer + Length)) {
-        //
-        // Find the matching device.
-        //
-        if ((DevInfo->Device.Port == Port) &&
-            (DevInfo->Device.PortMultiplierPort == PortMultiplierPort) &&
-            (DevInfo->DevicePathLength >= DevicePathLength) &&
-            (CompareMem (
-              DevInfo->DevicePath,
-              DevicePath,
-              DevicePathLength - sizeof (EFI_DEVICE_PATH_PROTOCOL)) == 0)) {
-          //
-          // If device locked, unlock first.
-          //
-          if (!IsZeroBuffer (DevInfo->Password, HDD_PASSWORD_MAX_LENGTH)) {
-            UnlockDevice (AtaPassThruPpi, Port, PortMultiplierPort, 0, DevInfo->Password);
-          }
-          //
-          // Freeze lock the device.
-          //
-          FreezeLockDevice (AtaPassThruPpi, Port, PortMultiplierPort);
-          break;
-        }
-
-        DevInfo = (HDD_PASSWORD_DEVICE_INFO *)
-                  ((UINTN) DevInfo + sizeof (HDD_PASSWORD_DEVICE_INFO) + DevInfo->DevicePathLength);
-      }
+      FreezeLockDevice (
+        AtaPassThruPpi,
+        DevInfo->Device.Port,
+        DevInfo->Device.PortMultiplierPort
+        );
     }
+
+    DevInfo = (HDD_PASSWORD_DEVICE_INFO *)
+              ((UINTN) DevInfo + sizeof (HDD_PASSWORD_DEVICE_INFO) + DevInfo->DevicePathLength);
   }
 
 Exit:
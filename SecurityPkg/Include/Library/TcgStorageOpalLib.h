@@ -569,6 +569,27 @@ OpalGetSupportedAttributesInfo(
   UINT16                       *OpalBaseComId
   );
 
+/**
+
+  Get the support attribute info, and the Locking info from the same level 0
+  discovery response. This saves the level 0 discovery round trip
+  OpalGetLockingInfo() would take when both are needed.
+
+  @param[in]      Session             OPAL_SESSION with OPAL_UID_LOCKING_SP to retrieve info.
+  @param[in/out]  SupportedAttributes Return the support attribute info.
+  @param[out]     OpalBaseComId       Return the base com id info.
+  @param[in/out]  LockingFeature      Return the Locking info, optional.
+
+**/
+TCG_RESULT
+EFIAPI
+OpalGetSupportedAttributesAndLockingInfo(
+  OPAL_SESSION                     *Session,
+  OPAL_DISK_SUPPORT_ATTRIBUTE      *SupportedAttributes,
+  UINT16                           *OpalBaseComId,
+  TCG_LOCKING_FEATURE_DESCRIPTOR   *LockingFeature OPTIONAL
+  );
+
 /**
   Creates a session with OPAL_UID_ADMIN_SP as OPAL_ADMIN_SP_PSID_AUTHORITY, then reverts device using Admin SP Revert method.
 
@@ -937,6 +937,179 @@ ProcessVariable (
 
 }
 
+// MU_CHANGE [BEGIN] - Hash index for signature list append filtering
+/**
+  Hash an EFI_SIGNATURE_DATA entry (FNV-1a) together with its signature type.
+
+  @param[in]  SignatureType   Type GUID of the EFI_SIGNATURE_LIST holding the entry.
+  @param[in]  Cert            Pointer to the EFI_SIGNATURE_DATA.
+  @param[in]  SignatureSize   Size of the entry in bytes.
+
+  @return The hash value.
+
+**/
+STATIC
+UINT32
+HashSignatureData (
+  IN CONST EFI_GUID            *SignatureType,
+  IN CONST EFI_SIGNATURE_DATA  *Cert,
+  IN UINT32                    SignatureSize
+  )
+{
+  UINT32        Hash;
+  UINTN         Index;
+  CONST UINT8   *Bytes;
+
+  Hash  = 0x811C9DC5 ^ SignatureSize;
+  Bytes = (CONST UINT8 *) SignatureType;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  Bytes = (CONST UINT8 *) Cert;
+  for (Index = 0; Index < SignatureSize; Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Build mSignatureIndex over every EFI_SIGNATURE_DATA in a signature database.
+
+  @param[in]  Data          Pointer to original EFI_SIGNATURE_LIST.
+  @param[in]  DataSize      Size of Data buffer.
+
+  @retval TRUE              Every entry of Data is indexed.
+  @retval FALSE             The index is unavailable or too small for Data.
+
+**/
+STATIC
+BOOLEAN
+BuildSignatureIndex (
+  IN VOID       *Data,
+  IN UINTN      DataSize
+  )
+{
+  EFI_SIGNATURE_LIST    *CertList;
+  EFI_SIGNATURE_DATA    *Cert;
+  UINTN                 CertCount;
+  UINTN                 Index;
+  UINTN                 Size;
+  UINTN                 Used;
+  UINT32                Slot;
+
+  if ((mSignatureIndex == NULL) || (DataSize >= MAX_UINT32)) {
+    return FALSE;
+  }
+
+  ZeroMem (mSignatureIndex, mSignatureIndexSlots * sizeof (AUTH_SIGNATURE_INDEX_SLOT));
+
+  Used     = 0;
+  Size     = DataSize;
+  CertList = (EFI_SIGNATURE_LIST *) Data;
+  while ((Size > 0) && (Size >= CertList->SignatureListSize)) {
+    Cert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    for (Index = 0; Index < CertCount; Index++) {
+      //
+      // Keep the load factor at or below one half so probe chains stay short.
+      //
+      if (++Used > mSignatureIndexSlots / 2) {
+        return FALSE;
+      }
+
+      Slot = HashSignatureData (&CertList->SignatureType, Cert, CertList->SignatureSize) & (mSignatureIndexSlots - 1);
+      while (mSignatureIndex[Slot].EntryOffset != 0) {
+        Slot = (Slot + 1) & (mSignatureIndexSlots - 1);
+      }
+
+      mSignatureIndex[Slot].ListOffset  = (UINT32) ((UINT8 *) CertList - (UINT8 *) Data);
+      mSignatureIndex[Slot].EntryOffset = (UINT32) ((UINT8 *) Cert - (UINT8 *) Data) + 1;
+      Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
+    }
+
+    Size -= CertList->SignatureListSize;
+    CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
+  }
+
+  return TRUE;
+}
+
+/**
+  Check whether an EFI_SIGNATURE_DATA is part of a signature database.
+
+  @param[in]  Data          Pointer to original EFI_SIGNATURE_LIST.
+  @param[in]  DataSize      Size of Data buffer.
+  @param[in]  UseIndex      TRUE to look NewCert up in mSignatureIndex, built over
+                            Data by BuildSignatureIndex; FALSE to scan Data.
+  @param[in]  NewCertList   The EFI_SIGNATURE_LIST holding NewCert.
+  @param[in]  NewCert       The EFI_SIGNATURE_DATA to look for.
+
+  @retval TRUE              Data already holds NewCert.
+  @retval FALSE             NewCert is not in Data.
+
+**/
+STATIC
+BOOLEAN
+IsSignatureInDatabase (
+  IN VOID                  *Data,
+  IN UINTN                 DataSize,
+  IN BOOLEAN               UseIndex,
+  IN EFI_SIGNATURE_LIST    *NewCertList,
+  IN EFI_SIGNATURE_DATA    *NewCert
+  )
+{
+  EFI_SIGNATURE_LIST    *CertList;
+  EFI_SIGNATURE_DATA    *Cert;
+  UINTN                 CertCount;
+  UINTN                 Index;
+  UINTN                 Size;
+  UINT32                Slot;
+
+  if (UseIndex) {
+    Slot = HashSignatureData (&NewCertList->SignatureType, NewCert, NewCertList->SignatureSize) & (mSignatureIndexSlots - 1);
+    while (mSignatureIndex[Slot].EntryOffset != 0) {
+      CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) Data + mSignatureIndex[Slot].ListOffset);
+      Cert     = (EFI_SIGNATURE_DATA *) ((UINT8 *) Data + mSignatureIndex[Slot].EntryOffset - 1);
+      if ((CertList->SignatureSize == NewCertList->SignatureSize) &&
+          CompareGuid (&CertList->SignatureType, &NewCertList->SignatureType) &&
+          (CompareMem (NewCert, Cert, CertList->SignatureSize) == 0)) {
+        return TRUE;
+      }
+
+      Slot = (Slot + 1) & (mSignatureIndexSlots - 1);
+    }
+
+    return FALSE;
+  }
+
+  Size = DataSize;
+  CertList = (EFI_SIGNATURE_LIST *) Data;
+  while ((Size > 0) && (Size >= CertList->SignatureListSize)) {
+    if (CompareGuid (&CertList->SignatureType, &NewCertList->SignatureType) &&
+       (CertList->SignatureSize == NewCertList->SignatureSize)) {
+      Cert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+      for (Index = 0; Index < CertCount; Index++) {
+        //
+        // Iterate each Signature Data in this Signature List.
+        //
+        if (CompareMem (NewCert, Cert, CertList->SignatureSize) == 0) {
+          return TRUE;
+        }
+        Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
+      }
+    }
+
+    Size -= CertList->SignatureListSize;
+    CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
+  }
+
+  return FALSE;
+}
+// MU_CHANGE [END]
+
 /**
   Filter out the duplicated EFI_SIGNATURE_DATA from the new data by comparing to the original data.
 
@@ -955,18 +1128,15 @@ FilterSignatureList (
   )
 {
   EFI_SIGNATURE_LIST    *CertList;
-  EFI_SIGNATURE_DATA    *Cert;
-  UINTN                 CertCount;
   EFI_SIGNATURE_LIST    *NewCertList;
   EFI_SIGNATURE_DATA    *NewCert;
   UINTN                 NewCertCount;
   UINTN                 Index;
-  UINTN                 Index2;
-  UINTN                 Size;
   UINT8                 *Tail;
   UINTN                 CopiedCount;
   UINTN                 SignatureListSize;
   BOOLEAN               IsNewCert;
+  BOOLEAN               UseIndex;   // MU_CHANGE
   UINT8                 *TempData;
   UINTN                 TempDataSize;
   EFI_STATUS            Status;
@@ -983,6 +1153,15 @@ FilterSignatureList (
 
   Tail = TempData;
 
+  // MU_CHANGE [BEGIN] - Look up existing signatures through a hash index
+  //
+  // Index the original data once so each new signature costs one probe
+  // instead of a scan of every existing signature. dbx appends carry
+  // thousands of entries, which made the scan quadratic.
+  //
+  UseIndex = BuildSignatureIndex (Data, DataSize);
+  // MU_CHANGE [END]
+
   NewCertList = (EFI_SIGNATURE_LIST *) NewData;
   while ((*NewDataSize > 0) && (*NewDataSize >= NewCertList->SignatureListSize)) {
     NewCert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) NewCertList + sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize);
@@ -990,33 +1169,7 @@ FilterSignatureList (
 
     CopiedCount = 0;
     for (Index = 0; Index < NewCertCount; Index++) {
-      IsNewCert = TRUE;
-
-      Size = DataSize;
-      CertList = (EFI_SIGNATURE_LIST *) Data;
-      while ((Size > 0) && (Size >= CertList->SignatureListSize)) {
-        if (CompareGuid (&CertList->SignatureType, &NewCertList->SignatureType) &&
-           (CertList->SignatureSize == NewCertList->SignatureSize)) {
-          Cert      = (EFI_SIGNATURE_DATA *) ((UINT8 *) CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-          CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-          for (Index2 = 0; Index2 < CertCount; Index2++) {
-            //
-            // Iterate each Signature Data in this Signature List.
-            //
-            if (CompareMem (NewCert, Cert, CertList->SignatureSize) == 0) {
-              IsNewCert = FALSE;
-              break;
-            }
-            Cert = (EFI_SIGNATURE_DATA *) ((UINT8 *) Cert + CertList->SignatureSize);
-          }
-        }
-
-        if (!IsNewCert) {
-          break;
-        }
-        Size -= CertList->SignatureListSize;
-        CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
-      }
+      IsNewCert = !IsSignatureInDatabase (Data, DataSize, UseIndex, NewCertList, NewCert);   // MU_CHANGE
 
       if (IsNewCert) {
         //
@@ -87,6 +87,22 @@ typedef struct {
 } AUTH_CERT_DB_DATA;
 #pragma pack()
 
+// MU_CHANGE [BEGIN] - Hash index for signature list append filtering
+///
+/// One slot of the open-addressed index over the EFI_SIGNATURE_DATA entries
+/// of an existing signature database. Offsets are relative to the start of
+/// the database and biased by one so that a zero EntryOffset marks an empty
+/// slot.
+///
+typedef struct {
+  UINT32    ListOffset;
+  UINT32    EntryOffset;
+} AUTH_SIGNATURE_INDEX_SLOT;
+
+extern AUTH_SIGNATURE_INDEX_SLOT  *mSignatureIndex;
+extern UINT32                     mSignatureIndexSlots;
+// MU_CHANGE [END]
+
 extern UINT8    *mCertDbStore;
 extern UINT32   mMaxCertDbSize;
 extern UINT32   mPlatformMode;
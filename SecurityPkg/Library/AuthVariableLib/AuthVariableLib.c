@@ -26,6 +26,14 @@ UINT32   mMaxCertDbSize;
 UINT32   mPlatformMode;
 UINT8    mVendorKeyState;
 
+// MU_CHANGE [BEGIN] - Hash index for signature list append filtering
+///
+/// Index used by FilterSignatureList to look up existing signatures.
+///
+AUTH_SIGNATURE_INDEX_SLOT  *mSignatureIndex = NULL;
+UINT32                     mSignatureIndexSlots;
+// MU_CHANGE [END]
+
 EFI_GUID mSignatureSupport[] = {EFI_CERT_SHA1_GUID, EFI_CERT_SHA256_GUID, EFI_CERT_RSA2048_GUID, EFI_CERT_X509_GUID};
 
 //
@@ -91,7 +99,7 @@ VARIABLE_ENTRY_PROPERTY mAuthVarEntry[] = {
   },
 };
 
-VOID **mAuthVarAddressPointer[9];
+VOID **mAuthVarAddressPointer[10];    // MU_CHANGE - Add mSignatureIndex
 
 AUTH_VAR_LIB_CONTEXT_IN *mAuthVarLibContextIn = NULL;
 
@@ -151,6 +159,18 @@ AuthVariableLibInitialize (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  // MU_CHANGE [BEGIN] - Hash index for signature list append filtering
+  //
+  // Reserve a signature index that stays at most half full for the largest
+  // database that fits in an authenticated variable.
+  //
+  mSignatureIndexSlots = GetPowerOfTwo32 ((UINT32) (mAuthVarLibContextIn->MaxAuthVariableSize / sizeof (EFI_SIGNATURE_DATA))) * 4;
+  mSignatureIndex      = AllocateRuntimePool (mSignatureIndexSlots * sizeof (AUTH_SIGNATURE_INDEX_SLOT));
+  if (mSignatureIndex == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  // MU_CHANGE [END]
+
   Status = AuthServiceInternalFindVariable (EFI_PLATFORM_KEY_NAME, &gEfiGlobalVariableGuid, (VOID **) &Data, &DataSize);
   if (EFI_ERROR (Status)) {
     DEBUG ((EFI_D_INFO, "Variable %s does not exist.\n", EFI_PLATFORM_KEY_NAME));
@@ -381,6 +401,7 @@ AuthVariableLibInitialize (
   mAuthVarAddressPointer[6] = (VOID **) &(mAuthVarLibContextIn->GetScratchBuffer),
   mAuthVarAddressPointer[7] = (VOID **) &(mAuthVarLibContextIn->CheckRemainingSpaceForConsistency),
   mAuthVarAddressPointer[8] = (VOID **) &(mAuthVarLibContextIn->AtRuntime),
+  mAuthVarAddressPointer[9] = (VOID **) &mSignatureIndex;   // MU_CHANGE - Add mSignatureIndex
   AuthVarLibContextOut->AddressPointer = mAuthVarAddressPointer;
   AuthVarLibContextOut->AddressPointerCount = ARRAY_SIZE (mAuthVarAddressPointer);
 
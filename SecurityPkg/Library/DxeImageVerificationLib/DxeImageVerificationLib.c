@@ -36,6 +36,26 @@ UINT8                               *mImageBase       = NULL;
 UINT8                               mImageDigest[MAX_DIGEST_SIZE];
 UINTN                               mImageDigestSize;
 
+//
+// Digests of the current PE/COFF image, per hash algorithm. An image signed
+// several times with the same algorithm is only hashed once. Reset for every
+// image DxeImageVerificationHandler() is called for.
+//
+UINT8                               mImageDigestCache[HASHALG_MAX][MAX_DIGEST_SIZE];
+BOOLEAN                             mImageDigestCached[HASHALG_MAX];
+
+//
+// Signature databases read for the current PE/COFF image. db, dbx and dbt are
+// each read at most once per DxeImageVerificationHandler() call, however many
+// signatures and hashes of the image are checked against them. Never kept
+// across images, so an update of the databases takes effect for the next image.
+//
+SIGNATURE_DATABASE                  mSignatureDatabase[] = {
+  { EFI_IMAGE_SECURITY_DATABASE,  NULL, 0, EFI_NOT_FOUND, FALSE },
+  { EFI_IMAGE_SECURITY_DATABASE1, NULL, 0, EFI_NOT_FOUND, FALSE },
+  { EFI_IMAGE_SECURITY_DATABASE2, NULL, 0, EFI_NOT_FOUND, FALSE }
+};
+
 //
 // Notify string for authorization UI.
 //
@@ -340,6 +360,12 @@ HashPeImage (
   }
 
   mHashTypeStr = mHash[HashAlg].Name;
+
+  if (mImageDigestCached[HashAlg]) {
+    CopyMem (mImageDigest, mImageDigestCache[HashAlg], mImageDigestSize);
+    return TRUE;
+  }
+
   CtxSize   = mHash[HashAlg].GetContextSize();
 
   HashCtx = AllocatePool (CtxSize);
@@ -583,6 +609,10 @@ HashPeImage (
   }
 
   Status  = mHash[HashAlg].HashFinal(HashCtx, mImageDigest);
+  if (Status) {
+    CopyMem (mImageDigestCache[HashAlg], mImageDigest, mImageDigestSize);
+    mImageDigestCached[HashAlg] = TRUE;
+  }
 
 Done:
   if (HashCtx != NULL) {
@@ -948,6 +978,111 @@ Done:
   return Status;
 }
 
+/**
+  Release the signature databases read for the previous image.
+
+**/
+VOID
+ReleaseSignatureDatabases (
+  VOID
+  )
+{
+  UINTN               Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDatabase); Index++) {
+    if (mSignatureDatabase[Index].Data != NULL) {
+      FreePool (mSignatureDatabase[Index].Data);
+    }
+
+    mSignatureDatabase[Index].Data     = NULL;
+    mSignatureDatabase[Index].DataSize = 0;
+    mSignatureDatabase[Index].Status   = EFI_NOT_FOUND;
+    mSignatureDatabase[Index].Cached   = FALSE;
+  }
+}
+
+/**
+  Get the content of a signature database variable for the current image.
+
+  The variable is read on first use only. The returned buffer is owned by
+  this library and must not be freed or modified by the caller.
+
+  @param[in]  VariableName        Name of database variable: db, dbx or dbt.
+  @param[out] Data                Content of the variable.
+  @param[out] DataSize            Size of the content in bytes.
+
+  @retval EFI_SUCCESS             The content of the variable is returned.
+  @retval EFI_NOT_FOUND           The variable doesn't exist.
+  @retval Others                  The variable could not be read.
+
+**/
+EFI_STATUS
+GetSignatureDatabase (
+  IN  CHAR16            *VariableName,
+  OUT UINT8             **Data,
+  OUT UINTN             *DataSize
+  )
+{
+  SIGNATURE_DATABASE  *Database;
+  UINTN               Index;
+  EFI_STATUS          Status;
+
+  *Data     = NULL;
+  *DataSize = 0;
+
+  Database = NULL;
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDatabase); Index++) {
+    if (StrCmp (VariableName, mSignatureDatabase[Index].VariableName) == 0) {
+      Database = &mSignatureDatabase[Index];
+      break;
+    }
+  }
+
+  ASSERT (Database != NULL);
+  if (Database == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!Database->Cached) {
+    Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &Database->DataSize, NULL);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      Database->Data = (UINT8 *) AllocateZeroPool (Database->DataSize);
+      if (Database->Data == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &Database->DataSize, Database->Data);
+    } else if (!EFI_ERROR (Status)) {
+      //
+      // A variable can't be empty.
+      //
+      Status = EFI_DEVICE_ERROR;
+    }
+
+    if (EFI_ERROR (Status)) {
+      if (Database->Data != NULL) {
+        FreePool (Database->Data);
+      }
+
+      Database->Data     = NULL;
+      Database->DataSize = 0;
+      if (Status != EFI_NOT_FOUND) {
+        //
+        // Try again next time, the error may be transient.
+        //
+        return Status;
+      }
+    }
+
+    Database->Status = Status;
+    Database->Cached = TRUE;
+  }
+
+  *Data     = Database->Data;
+  *DataSize = Database->DataSize;
+  return Database->Status;
+}
+
 /**
   Check whether signature is in specified database.
 
@@ -982,10 +1117,8 @@ IsSignatureFoundInDatabase (
   // Read signature database variable.
   //
   *IsFound  = FALSE;
-  Data      = NULL;
-  DataSize  = 0;
-  Status    = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  Status    = GetSignatureDatabase (VariableName, &Data, &DataSize);
+  if (EFI_ERROR (Status)) {
     if (Status == EFI_NOT_FOUND) {
       //
       // No database, no need to search.
@@ -996,15 +1129,6 @@ IsSignatureFoundInDatabase (
     return Status;
   }
 
-  Data = (UINT8 *) AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
   //
   // Enumerate all signature data in SigDB to check if signature exists for executable.
   //
@@ -1040,11 +1164,6 @@ IsSignatureFoundInDatabase (
     CertList = (EFI_SIGNATURE_LIST *) ((UINT8 *) CertList + CertList->SignatureListSize);
   }
 
-Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   return Status;
 }
 
@@ -1155,16 +1274,7 @@ PassTimestampCheck (
   // RevocationTime is non-zero, the certificate should be considered to be revoked from that time and onwards.
   // Using the dbt to get the trusted TSA certificates.
   //
-  DbtDataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    goto Done;
-  }
-  DbtData = (UINT8 *) AllocateZeroPool (DbtDataSize);
-  if (DbtData == NULL) {
-    goto Done;
-  }
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, (VOID *) DbtData);
+  Status = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE2, &DbtData, &DbtDataSize);
   if (EFI_ERROR (Status)) {
     goto Done;
   }
@@ -1200,10 +1310,6 @@ PassTimestampCheck (
   }
 
 Done:
-  if (DbtData != NULL) {
-    FreePool (DbtData);
-  }
-
   return VerifyStatus;
 }
 
@@ -1263,10 +1369,8 @@ IsForbiddenByDbx (
   //
   // The image will not be forbidden if dbx can't be got.
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  Status = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1, &Data, &DataSize);
+  if (EFI_ERROR (Status)) {
     if (Status == EFI_NOT_FOUND) {
       //
       // Evidently not in dbx if the database doesn't exist.
@@ -1275,15 +1379,6 @@ IsForbiddenByDbx (
     }
     return IsForbidden;
   }
-  Data = (UINT8 *) AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return IsForbidden;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *) Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
 
   //
   // Verify image signature with RAW X509 certificates in DBX database.
@@ -1392,10 +1487,6 @@ IsForbiddenByDbx (
   IsForbidden = FALSE;
 
 Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   Pkcs7FreeSigners (CertBuffer);
   Pkcs7FreeSigners (TrustedCert);
 
@@ -1446,21 +1537,9 @@ IsAllowedByDb (
   // Fetch 'db' content. If 'db' doesn't exist or encounters problem to get the
   // data, return not-allowed-by-db (FALSE).
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    return VerifyStatus;
-  }
-
-  Data = (UINT8 *) AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return VerifyStatus;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *) Data);
+  Status = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE, &Data, &DataSize);
   if (EFI_ERROR (Status)) {
-    goto Done;
+    return VerifyStatus;
   }
 
   //
@@ -1468,30 +1547,13 @@ IsAllowedByDb (
   // If any other errors occurred, no need to check 'db' but just return
   // not-allowed-by-db (FALSE) to avoid bypass.
   //
-  DbxDataSize = 0;
-  Status      = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status != EFI_NOT_FOUND) {
-      goto Done;
-    }
-    //
-    // 'dbx' does not exist. Continue to check 'db'.
-    //
-  } else {
-    //
-    // 'dbx' exists. Get its content.
-    //
-    DbxData = (UINT8 *) AllocateZeroPool (DbxDataSize);
-    if (DbxData == NULL) {
-      goto Done;
-    }
-
-    Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, (VOID *) DbxData);
-    if (EFI_ERROR (Status)) {
-      goto Done;
-    }
+  Status = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1, &DbxData, &DbxDataSize);
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND)) {
+    goto Done;
   }
+  //
+  // If 'dbx' does not exist, DbxData is NULL. Continue to check 'db'.
+  //
 
   //
   // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
@@ -1569,13 +1631,6 @@ Done:
     SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, CertData);
   }
 
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-  if (DbxData != NULL) {
-    FreePool (DbxData);
-  }
-
   return VerifyStatus;
 }
 
@@ -1740,6 +1795,8 @@ DxeImageVerificationHandler (
 
   mImageBase  = (UINT8 *) FileBuffer;
   mImageSize  = FileSize;
+  ZeroMem (mImageDigestCached, sizeof (mImageDigestCached));
+  ReleaseSignatureDatabases ();
 
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *) FileBuffer;
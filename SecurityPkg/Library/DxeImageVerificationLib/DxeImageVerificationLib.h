@@ -198,4 +198,24 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+//
+// Content of a signature database variable read for the current image
+//
+typedef struct {
+  //
+  // Name of the variable, e.g. "db"
+  //
+  CHAR16                   *VariableName;
+  //
+  // Content of the variable, NULL if it hasn't been read or doesn't exist
+  //
+  UINT8                    *Data;
+  UINTN                    DataSize;
+  //
+  // Result of reading the variable, only valid if Cached is TRUE
+  //
+  EFI_STATUS               Status;
+  BOOLEAN                  Cached;
+} SIGNATURE_DATABASE;
+
 #endif
@@ -15,6 +15,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+//
+// Size of the tiles HashUpdateInterleaved() feeds to the hash interfaces. It
+// is a multiple of the largest block size (SHA-512, 128 bytes), so the
+// interfaces never have to buffer a partial block between tiles, and small
+// enough to stay in the L1/L2 data cache while every bank hashes it.
+//
+#define HASH_UPDATE_TILE_SIZE  SIZE_16KB
+
 typedef struct {
   EFI_GUID  Guid;
   UINT32    Mask;
@@ -70,3 +78,63 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count ++;
 }
+
+/**
+  Update the hash sequences of all active hash interfaces.
+
+  The data is fed to the interfaces tile by tile, and each tile goes through
+  every active interface before the next one is read. With several PCR banks
+  enabled, a large buffer is then fetched from memory once instead of once per
+  bank.
+
+  @param HashInterface       Registered hash interfaces.
+  @param HashInterfaceCount  Number of registered hash interfaces.
+  @param HashCtx             Hash contexts, one per registered interface.
+  @param ActiveHashMask      Interfaces whose hash mask isn't in it are skipped.
+  @param DataToHash          Data to be hashed.
+  @param DataToHashLen       Data size.
+**/
+VOID
+EFIAPI
+HashUpdateInterleaved (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          ActiveHashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  BOOLEAN  Active[HASH_COUNT];
+  UINTN    ActiveCount;
+  UINTN    Index;
+  UINT8    *Tile;
+  UINTN    TileSize;
+
+  ASSERT (HashInterfaceCount <= HASH_COUNT);
+
+  ActiveCount = 0;
+  for (Index = 0; Index < HashInterfaceCount; Index++) {
+    Active[Index] = (BOOLEAN) ((Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid) & ActiveHashMask) != 0);
+    if (Active[Index]) {
+      ActiveCount++;
+    }
+  }
+
+  //
+  // A single bank reads the data once anyway, hand it over in one call.
+  //
+  TileSize = (ActiveCount > 1) ? HASH_UPDATE_TILE_SIZE : DataToHashLen;
+
+  Tile = (UINT8 *) DataToHash;
+  do {
+    TileSize = MIN (TileSize, DataToHashLen - (UINTN) (Tile - (UINT8 *) DataToHash));
+    for (Index = 0; Index < HashInterfaceCount; Index++) {
+      if (Active[Index]) {
+        HashInterface[Index].HashUpdate (HashCtx[Index], Tile, TileSize);
+      }
+    }
+
+    Tile += TileSize;
+  } while (Tile < (UINT8 *) DataToHash + DataToHashLen);
+}
@@ -35,4 +35,30 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES     *Digest
   );
 
+/**
+  Update the hash sequences of all active hash interfaces.
+
+  The data is fed to the interfaces tile by tile, and each tile goes through
+  every active interface before the next one is read. With several PCR banks
+  enabled, a large buffer is then fetched from memory once instead of once per
+  bank.
+
+  @param HashInterface       Registered hash interfaces.
+  @param HashInterfaceCount  Number of registered hash interfaces.
+  @param HashCtx             Hash contexts, one per registered interface.
+  @param ActiveHashMask      Interfaces whose hash mask isn't in it are skipped.
+  @param DataToHash          Data to be hashed.
+  @param DataToHashLen       Data size.
+**/
+VOID
+EFIAPI
+HashUpdateInterleaved (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          ActiveHashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
@@ -1619,19 +1619,22 @@ OpalGetTryLimit(
 
 /**
 
-  Get the support attribute info.
+  Get the support attribute info, and the Locking info from the same level 0
+  discovery response.
 
   @param[in]      Session             OPAL_SESSION with OPAL_UID_LOCKING_SP to retrieve info.
   @param[out]     SupportedAttributes Return the support attribute info.
   @param[out]     OpalBaseComId       Return the base com id info.
+  @param[in/out]  LockingFeature      Return the Locking info, optional.
 
 **/
 TCG_RESULT
 EFIAPI
-OpalGetSupportedAttributesInfo(
-  IN  OPAL_SESSION                 *Session,
-  OUT OPAL_DISK_SUPPORT_ATTRIBUTE  *SupportedAttributes,
-  OUT UINT16                       *OpalBaseComId
+OpalGetSupportedAttributesAndLockingInfo(
+  IN     OPAL_SESSION                    *Session,
+  OUT    OPAL_DISK_SUPPORT_ATTRIBUTE     *SupportedAttributes,
+  OUT    UINT16                          *OpalBaseComId,
+  IN OUT TCG_LOCKING_FEATURE_DESCRIPTOR  *LockingFeature OPTIONAL
   )
 {
   UINT8                              Buffer[BUFFER_SIZE];
@@ -1775,6 +1778,9 @@ OpalGetSupportedAttributesInfo(
   if (Feat != NULL && Size >= sizeof (TCG_LOCKING_FEATURE_DESCRIPTOR)) {
     SupportedAttributes->MediaEncryption = Feat->Locking.MediaEncryption;
     DEBUG ((DEBUG_INFO, "SupportedAttributes->MediaEncryption 0x%X \n", SupportedAttributes->MediaEncryption));
+    if (LockingFeature != NULL) {
+      CopyMem (LockingFeature, &Feat->Locking, sizeof (TCG_LOCKING_FEATURE_DESCRIPTOR));
+    }
   }
 
   Size = 0;
@@ -1805,6 +1811,26 @@ OpalGetSupportedAttributesInfo(
   return TcgResultSuccess;
 }
 
+/**
+
+  Get the support attribute info.
+
+  @param[in]      Session             OPAL_SESSION with OPAL_UID_LOCKING_SP to retrieve info.
+  @param[out]     SupportedAttributes Return the support attribute info.
+  @param[out]     OpalBaseComId       Return the base com id info.
+
+**/
+TCG_RESULT
+EFIAPI
+OpalGetSupportedAttributesInfo(
+  IN  OPAL_SESSION                 *Session,
+  OUT OPAL_DISK_SUPPORT_ATTRIBUTE  *SupportedAttributes,
+  OUT UINT16                       *OpalBaseComId
+  )
+{
+  return OpalGetSupportedAttributesAndLockingInfo (Session, SupportedAttributes, OpalBaseComId, NULL);
+}
+
 /**
 
   Get the support attribute info.
@@ -18,6 +18,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/Tpm2DeviceLib.h>
 #include <Library/PcdLib.h>
 #include <Library/Tpm2DebugLib.h>         // MS_CHANGE
+#include <Library/PerformanceLib.h>
 
 #include <IndustryStandard/TpmPtp.h>
 #include <IndustryStandard/TpmTis.h>
@@ -28,6 +29,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define PTP_TIMEOUT_MAX             (90000 * 1000)  // 90s
 
+//
+// Register polling starts with a short delay that doubles up to the maximum,
+// so that fast state transitions are noticed quickly without polling slow
+// ones any more often than a fixed 30us interval did.
+//
+#define PTP_POLL_DELAY_MIN          1               // 1us
+#define PTP_POLL_DELAY_MAX          30              // 30us
+
 //
 // Max TPM command/response length
 //
@@ -79,13 +88,18 @@ PtpCrbWaitRegisterBits (
 {
   UINT32                            RegRead;
   UINT32                            WaitTime;
+  UINT32                            Delay;
 
-  for (WaitTime = 0; WaitTime < TimeOut; WaitTime += 30){
+  WaitTime = 0;
+  Delay    = PTP_POLL_DELAY_MIN;
+  while (WaitTime < TimeOut) {
     RegRead = MmioRead32 ((UINTN)Register);
     if ((RegRead & BitSet) == BitSet && (RegRead & BitClear) == 0) {
       return EFI_SUCCESS;
     }
-    MicroSecondDelay (30);
+    MicroSecondDelay (Delay);
+    WaitTime += Delay;
+    Delay     = MIN (Delay * 2, PTP_POLL_DELAY_MAX);
   }
   return EFI_TIMEOUT;
 }
@@ -580,29 +594,57 @@ DTpm2SubmitCommand (
   )
 {
   TPM2_PTP_INTERFACE_TYPE  PtpInterface;
+  EFI_STATUS               Status;
+  UINT64                   StartTicker;
+  UINT64                   ElapsedTime;
+
+  StartTicker  = GetPerformanceCounter ();
+  PERF_INMODULE_BEGIN ("DTpm2SubmitCommand");
 
   PtpInterface = PcdGet8(PcdActiveTpmInterfaceType);
   switch (PtpInterface) {
   case Tpm2PtpInterfaceCrb:
-    return PtpCrbTpmCommand (
-           (PTP_CRB_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
-           InputParameterBlock,
-           InputParameterBlockSize,
-           OutputParameterBlock,
-           OutputParameterBlockSize
-           );
+    Status = PtpCrbTpmCommand (
+               (PTP_CRB_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
+               InputParameterBlock,
+               InputParameterBlockSize,
+               OutputParameterBlock,
+               OutputParameterBlockSize
+               );
+    break;
   case Tpm2PtpInterfaceFifo:
   case Tpm2PtpInterfaceTis:
-    return Tpm2TisTpmCommand (
-           (TIS_PC_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
-           InputParameterBlock,
-           InputParameterBlockSize,
-           OutputParameterBlock,
-           OutputParameterBlockSize
-           );
+    Status = Tpm2TisTpmCommand (
+               (TIS_PC_REGISTERS_PTR) (UINTN) PcdGet64 (PcdTpmBaseAddress),
+               InputParameterBlock,
+               InputParameterBlockSize,
+               OutputParameterBlock,
+               OutputParameterBlockSize
+               );
+    break;
   default:
     return EFI_NOT_FOUND;
   }
+
+  PERF_INMODULE_END ("DTpm2SubmitCommand");
+
+  //
+  // Report the latency of each command, so that slow TPMs can be spotted.
+  //
+  DEBUG_CODE (
+    if (InputParameterBlockSize >= sizeof (TPM2_COMMAND_HEADER)) {
+      ElapsedTime = GetTimeInNanoSecond (GetPerformanceCounter () - StartTicker);
+      DEBUG ((
+        DEBUG_VERBOSE,
+        "DTpm2SubmitCommand: CC 0x%x - %r, %ld us\n",
+        SwapBytes32 (ReadUnaligned32 (&((TPM2_COMMAND_HEADER *)InputParameterBlock)->commandCode)),
+        Status,
+        DivU64x32 (ElapsedTime, 1000)
+        ));
+    }
+  );
+
+  return Status;
 }
 
 /**
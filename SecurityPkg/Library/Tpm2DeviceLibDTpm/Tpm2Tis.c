@@ -24,6 +24,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define TIS_TIMEOUT_MAX             (90000 * 1000)  // 90s
 
+//
+// Register polling starts with a short delay that doubles up to the maximum,
+// so that fast state transitions are noticed quickly without polling slow
+// ones any more often than a fixed 30us interval did.
+//
+#define TIS_POLL_DELAY_MIN          1               // 1us
+#define TIS_POLL_DELAY_MAX          30              // 30us
+
 //
 // Max TPM command/response length
 //
@@ -69,12 +77,17 @@ TisPcWaitRegisterBits (
 {
   UINT8                             RegRead;
   UINT32                            WaitTime;
+  UINT32                            Delay;
 
-  for (WaitTime = 0; WaitTime < TimeOut; WaitTime += 30){
+  WaitTime = 0;
+  Delay    = TIS_POLL_DELAY_MIN;
+  while (WaitTime < TimeOut) {
     RegRead = MmioRead8 ((UINTN)Register);
     if ((RegRead & BitSet) == BitSet && (RegRead & BitClear) == 0)
       return EFI_SUCCESS;
-    MicroSecondDelay (30);
+    MicroSecondDelay (Delay);
+    WaitTime += Delay;
+    Delay     = MIN (Delay * 2, TIS_POLL_DELAY_MAX);
   }
   return EFI_TIMEOUT;
 }
@@ -97,6 +110,7 @@ TisPcReadBurstCount (
   )
 {
   UINT32                            WaitTime;
+  UINT32                            Delay;
   UINT8                             DataByte0;
   UINT8                             DataByte1;
 
@@ -105,6 +119,7 @@ TisPcReadBurstCount (
   }
 
   WaitTime = 0;
+  Delay    = TIS_POLL_DELAY_MIN;
   do {
     //
     // TIS_PC_REGISTERS_PTR->burstCount is UINT16, but it is not 2bytes aligned,
@@ -116,8 +131,9 @@ TisPcReadBurstCount (
     if (*BurstCount != 0) {
       return EFI_SUCCESS;
     }
-    MicroSecondDelay (30);
-    WaitTime += 30;
+    MicroSecondDelay (Delay);
+    WaitTime += Delay;
+    Delay     = MIN (Delay * 2, TIS_POLL_DELAY_MAX);
   } while (WaitTime < TIS_TIMEOUT_D);
 
   return EFI_TIMEOUT;
@@ -19,6 +19,163 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define MAX_DIGEST_SIZE  SHA512_DIGEST_SIZE
 
+//
+// Tags separating the different kinds of verification cache keys
+//
+#define VERIFY_CACHE_TAG_MESSAGE       0x01
+#define VERIFY_CACHE_TAG_PKCS7         0x02
+#define VERIFY_CACHE_TAG_AUTHENTICODE  0x03
+
+#define VERIFY_CACHE_ENTRIES           16
+
+//
+// Result of verifying one signedData and data against one certificate.
+// Key is the SHA256 over all inputs of the verification, which fully
+// determine its result.
+//
+typedef struct {
+  UINT8               Key[SHA256_DIGEST_SIZE];
+  BOOLEAN             Result;
+  BOOLEAN             InUse;
+} VERIFY_CACHE_ENTRY;
+
+//
+// Results of recent verifications, replaced round robin.
+//
+VERIFY_CACHE_ENTRY  mVerifyCache[VERIFY_CACHE_ENTRIES];
+UINTN               mVerifyCacheNext;
+
+/**
+  Calculates a verification cache key: the SHA256 hash over a tag and two
+  buffers, each preceded by its size.
+
+  @param[in]  Tag        VERIFY_CACHE_TAG_* value identifying the kind of key.
+  @param[in]  Data1      Pointer to the first buffer.
+  @param[in]  Data1Size  The size of the first buffer in bytes.
+  @param[in]  Data2      Pointer to the second buffer.
+  @param[in]  Data2Size  The size of the second buffer in bytes.
+  @param[out] Key        Pointer to a buffer that receives the key.
+
+  @retval TRUE           Key calculation succeeded.
+  @retval FALSE          Key calculation failed.
+
+**/
+BOOLEAN
+CalculateVerifyCacheKey (
+  IN  UINT8              Tag,
+  IN  CONST VOID         *Data1,
+  IN  UINTN              Data1Size,
+  IN  CONST VOID         *Data2,
+  IN  UINTN              Data2Size,
+  OUT UINT8              *Key
+  )
+{
+  BOOLEAN  Status;
+  VOID     *HashCtx;
+  UINT64   Size;
+
+  HashCtx = AllocatePool (Sha256GetContextSize ());
+  if (HashCtx == NULL) {
+    return FALSE;
+  }
+
+  Status = Sha256Init (HashCtx);
+  if (Status) {
+    Status = Sha256Update (HashCtx, &Tag, sizeof (Tag));
+  }
+  if (Status) {
+    Size   = Data1Size;
+    Status = Sha256Update (HashCtx, &Size, sizeof (Size)) &&
+             Sha256Update (HashCtx, Data1, Data1Size);
+  }
+  if (Status) {
+    Size   = Data2Size;
+    Status = Sha256Update (HashCtx, &Size, sizeof (Size)) &&
+             Sha256Update (HashCtx, Data2, Data2Size);
+  }
+  if (Status) {
+    Status = Sha256Final (HashCtx, Key);
+  }
+
+  FreePool (HashCtx);
+  return Status;
+}
+
+/**
+  Verifies the PKCS7 signedData against one certificate, reusing the result
+  of an earlier verification with the very same inputs.
+
+  @param[in]  Authenticode    TRUE to verify with AuthenticodeVerify() against
+                              the hash in Data, FALSE to verify with Pkcs7Verify()
+                              against the raw message in Data.
+  @param[in]  MessageKey      Verification cache key of SignedData and Data, or
+                              NULL to bypass the cache.
+  @param[in]  SignedData      Pointer to buffer containing ASN.1 DER-encoded PKCS7
+                              signature.
+  @param[in]  SignedDataSize  The size of SignedData buffer in bytes.
+  @param[in]  Cert            Pointer to the DER-encoded X.509 certificate.
+  @param[in]  CertSize        The size of Cert buffer in bytes.
+  @param[in]  Data            Pointer to the message data or its hash.
+  @param[in]  DataSize        The size of Data buffer in bytes.
+
+  @retval TRUE                The signedData is verified by the certificate.
+  @retval FALSE               The signedData is not verified by the certificate.
+
+**/
+BOOLEAN
+VerifyWithCache (
+  IN BOOLEAN             Authenticode,
+  IN CONST UINT8         *MessageKey     OPTIONAL,
+  IN UINT8               *SignedData,
+  IN UINTN               SignedDataSize,
+  IN UINT8               *Cert,
+  IN UINTN               CertSize,
+  IN UINT8               *Data,
+  IN UINTN               DataSize
+  )
+{
+  UINT8    Key[SHA256_DIGEST_SIZE];
+  BOOLEAN  KeyValid;
+  BOOLEAN  Result;
+  UINTN    Index;
+
+  KeyValid = FALSE;
+  if (MessageKey != NULL) {
+    KeyValid = CalculateVerifyCacheKey (
+                 Authenticode ? VERIFY_CACHE_TAG_AUTHENTICODE : VERIFY_CACHE_TAG_PKCS7,
+                 MessageKey,
+                 SHA256_DIGEST_SIZE,
+                 Cert,
+                 CertSize,
+                 Key
+                 );
+  }
+
+  if (KeyValid) {
+    for (Index = 0; Index < VERIFY_CACHE_ENTRIES; Index++) {
+      if (mVerifyCache[Index].InUse &&
+          (CompareMem (mVerifyCache[Index].Key, Key, SHA256_DIGEST_SIZE) == 0)) {
+        return mVerifyCache[Index].Result;
+      }
+    }
+  }
+
+  if (Authenticode) {
+    Result = AuthenticodeVerify (SignedData, SignedDataSize, Cert, CertSize, Data, DataSize);
+  } else {
+    Result = Pkcs7Verify (SignedData, SignedDataSize, Cert, CertSize, Data, DataSize);
+  }
+
+  if (KeyValid) {
+    CopyMem (mVerifyCache[mVerifyCacheNext].Key, Key, SHA256_DIGEST_SIZE);
+    mVerifyCache[mVerifyCacheNext].Result = Result;
+    mVerifyCache[mVerifyCacheNext].InUse  = TRUE;
+    mVerifyCacheNext = (mVerifyCacheNext + 1) % VERIFY_CACHE_ENTRIES;
+  }
+
+  return Result;
+}
+
 /**
   Calculates the hash of the given data based on the specified hash GUID.
 
@@ -528,6 +685,8 @@ IsValidTimestamp (
   @param[in]  TimeStampDb     Pointer to a list of pointers to EFI_SIGNATURE_LIST
                               structures which is used to pass a list of X.509
                               certificates of trusted timestamp signers.
+  @param[in]  MessageKey      Verification cache key of SignedData and the data
+                              to be verified, or NULL to bypass the cache.
 
   @retval  EFI_SUCCESS             The PKCS7 signedData is revoked.
   @retval  EFI_SECURITY_VIOLATION  Fail to verify the signature in PKCS7 signedData.
@@ -546,7 +705,8 @@ P7CheckRevocationByHash (
   IN UINT8                *InHash,
   IN UINTN                InHashSize,
   IN EFI_SIGNATURE_LIST   **RevokedDb,
-  IN EFI_SIGNATURE_LIST   **TimeStampDb
+  IN EFI_SIGNATURE_LIST   **TimeStampDb,
+  IN CONST UINT8          *MessageKey     OPTIONAL
   )
 {
   EFI_STATUS          Status;
@@ -609,7 +769,7 @@ P7CheckRevocationByHash (
     //
     // Verifying the PKCS#7 SignedData with the revoked certificate in RevokedDb
     //
-    if (AuthenticodeVerify (SignedData, SignedDataSize, RevokedCert, RevokedCertSize, InHash, InHashSize)) {
+    if (VerifyWithCache (TRUE, MessageKey, SignedData, SignedDataSize, RevokedCert, RevokedCertSize, InHash, InHashSize)) {
       //
       // The signedData was verified by one entry in Revoked Database
       //
@@ -693,6 +853,8 @@ _Exit:
   @param[in]  TimeStampDb     Pointer to a list of pointers to EFI_SIGNATURE_LIST
                               structures which is used to pass a list of X.509
                               certificates of trusted timestamp signers.
+  @param[in]  MessageKey      Verification cache key of SignedData and the data
+                              to be verified, or NULL to bypass the cache.
 
   @retval  EFI_SUCCESS             The PKCS7 signedData is revoked.
   @retval  EFI_SECURITY_VIOLATION  Fail to verify the signature in PKCS7 signedData.
@@ -711,7 +873,8 @@ P7CheckRevocation (
   IN UINT8                *InData,
   IN UINTN                InDataSize,
   IN EFI_SIGNATURE_LIST   **RevokedDb,
-  IN EFI_SIGNATURE_LIST   **TimeStampDb
+  IN EFI_SIGNATURE_LIST   **TimeStampDb,
+  IN CONST UINT8          *MessageKey     OPTIONAL
   )
 {
   EFI_STATUS          Status;
@@ -774,7 +937,7 @@ P7CheckRevocation (
     //
     // Verifying the PKCS#7 SignedData with the revoked certificate in RevokedDb
     //
-    if (Pkcs7Verify (SignedData, SignedDataSize, RevokedCert, RevokedCertSize, InData, InDataSize)) {
+    if (VerifyWithCache (FALSE, MessageKey, SignedData, SignedDataSize, RevokedCert, RevokedCertSize, InData, InDataSize)) {
       //
       // The signedData was verified by one entry in Revoked Database
       //
@@ -854,6 +1017,8 @@ _Exit:
   @param[in]  AllowedDb       Pointer to a list of pointers to EFI_SIGNATURE_LIST
                               structures which contains lists of X.509 certificates
                               of approved signers.
+  @param[in]  MessageKey      Verification cache key of SignedData and the data
+                              to be verified, or NULL to bypass the cache.
 
   @retval  EFI_SUCCESS             The PKCS7 signedData is trusted.
   @retval  EFI_SECURITY_VIOLATION  Fail to verify the signature in PKCS7 signedData.
@@ -874,7 +1039,8 @@ P7CheckTrustByHash (
   IN UINTN               SignedDataSize,
   IN UINT8               *InHash,
   IN UINTN               InHashSize,
-  IN EFI_SIGNATURE_LIST  **AllowedDb
+  IN EFI_SIGNATURE_LIST  **AllowedDb,
+  IN CONST UINT8         *MessageKey     OPTIONAL
   )
 {
   EFI_STATUS          Status;
@@ -923,7 +1089,7 @@ P7CheckTrustByHash (
     //
     // Verifying the PKCS#7 SignedData with the trusted certificate from AllowedDb
     //
-    if (AuthenticodeVerify (SignedData, SignedDataSize, TrustCert, TrustCertSize, InHash, InHashSize)) {
+    if (VerifyWithCache (TRUE, MessageKey, SignedData, SignedDataSize, TrustCert, TrustCertSize, InHash, InHashSize)) {
       //
       // The SignedData was verified successfully by one entry in Trusted Database
       //
@@ -948,6 +1114,8 @@ P7CheckTrustByHash (
   @param[in]  AllowedDb       Pointer to a list of pointers to EFI_SIGNATURE_LIST
                               structures which contains lists of X.509 certificates
                               of approved signers.
+  @param[in]  MessageKey      Verification cache key of SignedData and the data
+                              to be verified, or NULL to bypass the cache.
 
   @retval  EFI_SUCCESS             The PKCS7 signedData is trusted.
   @retval  EFI_SECURITY_VIOLATION  Fail to verify the signature in PKCS7 signedData.
@@ -968,7 +1136,8 @@ P7CheckTrust (
   IN UINTN               SignedDataSize,
   IN UINT8               *InData,
   IN UINTN               InDataSize,
-  IN EFI_SIGNATURE_LIST  **AllowedDb
+  IN EFI_SIGNATURE_LIST  **AllowedDb,
+  IN CONST UINT8         *MessageKey     OPTIONAL
   )
 {
   EFI_STATUS          Status;
@@ -1017,7 +1186,7 @@ P7CheckTrust (
     //
     // Verifying the PKCS#7 SignedData with the trusted certificate from AllowedDb
     //
-    if (Pkcs7Verify (SignedData, SignedDataSize, TrustCert, TrustCertSize, InData, InDataSize)) {
+    if (VerifyWithCache (FALSE, MessageKey, SignedData, SignedDataSize, TrustCert, TrustCertSize, InData, InDataSize)) {
       //
       // The SignedData was verified successfully by one entry in Trusted Database
       //
@@ -1137,6 +1306,8 @@ VerifyBuffer (
   UINTN               AttachedDataSize;
   UINT8               *DataPtr;
   UINTN               DataSize;
+  UINT8               MessageKey[SHA256_DIGEST_SIZE];
+  UINT8               *MessageKeyPtr;
 
   //
   // Parameters Checking
@@ -1247,6 +1418,15 @@ VerifyBuffer (
 
   Status = EFI_UNSUPPORTED;
 
+  //
+  // Hash the signedData and content once, so that verifications repeated
+  // against the same certificates are served from the cache.
+  //
+  MessageKeyPtr = NULL;
+  if (CalculateVerifyCacheKey (VERIFY_CACHE_TAG_MESSAGE, SignedData, SignedDataSize, DataPtr, DataSize, MessageKey)) {
+    MessageKeyPtr = MessageKey;
+  }
+
   //
   // Verify PKCS7 SignedData with Revoked database
   //
@@ -1257,7 +1437,8 @@ VerifyBuffer (
                DataPtr,
                DataSize,
                RevokedDb,
-               TimeStampDb
+               TimeStampDb,
+               MessageKeyPtr
                );
     if (!EFI_ERROR (Status)) {
       //
@@ -1276,7 +1457,8 @@ VerifyBuffer (
              SignedDataSize,
              DataPtr,
              DataSize,
-             AllowedDb
+             AllowedDb,
+             MessageKeyPtr
              );
   if (EFI_ERROR (Status)) {
       //
@@ -1389,6 +1571,8 @@ VerifySignature (
   )
 {
   EFI_STATUS  Status;
+  UINT8       MessageKey[SHA256_DIGEST_SIZE];
+  UINT8       *MessageKeyPtr;
 
   //
   // Parameters Checking
@@ -1398,6 +1582,11 @@ VerifySignature (
     return EFI_INVALID_PARAMETER;
   }
 
+  MessageKeyPtr = NULL;
+  if (CalculateVerifyCacheKey (VERIFY_CACHE_TAG_MESSAGE, Signature, SignatureSize, InHash, InHashSize, MessageKey)) {
+    MessageKeyPtr = MessageKey;
+  }
+
   //
   // Verify PKCS7 SignedData with Revoked database
   //
@@ -1408,7 +1597,8 @@ VerifySignature (
                InHash,
                InHashSize,
                RevokedDb,
-               TimeStampDb
+               TimeStampDb,
+               MessageKeyPtr
                );
 
     if (!EFI_ERROR (Status)) {
@@ -1427,7 +1617,8 @@ VerifySignature (
              SignatureSize,
              InHash,
              InHashSize,
-             AllowedDb
+             AllowedDb,
+             MessageKeyPtr
              );
 
   return Status;
@@ -1187,7 +1187,12 @@ OpalDiskInitialize (
   Session.Sscp = Dev->Sscp;
   Session.MediaId = Dev->MediaId;
 
-  TcgResult = OpalGetSupportedAttributesInfo (&Session, &Dev->OpalDisk.SupportedAttributes, &Dev->OpalDisk.OpalBaseComId);
+  TcgResult = OpalGetSupportedAttributesAndLockingInfo (
+                &Session,
+                &Dev->OpalDisk.SupportedAttributes,
+                &Dev->OpalDisk.OpalBaseComId,
+                &Dev->OpalDisk.LockingFeature
+                );
   if (TcgResult != TcgResultSuccess) {
     return EFI_DEVICE_ERROR;
   }
@@ -1212,7 +1217,10 @@ OpalDiskInitialize (
     Dev->OpalDisk.EstimateTimeCost = RemovalMechanishLists[ActiveDataRemovalMechanism];
   }
 
-  return OpalDiskUpdateStatus (&Dev->OpalDisk);
+  //
+  // The Locking info came with the supported attributes, only the ownership is left.
+  //
+  return OpalDiskUpdateOwnerShip (&Dev->OpalDisk);
 }
 
 /**
@@ -231,19 +231,14 @@ IsOpalDeviceLocked(
   Session.Sscp = &OpalDev->Sscp;
   Session.MediaId = 0;
 
-  Ret = OpalGetSupportedAttributesInfo (&Session, &SupportedAttributes, &OpalBaseComId);
+  ZeroMem (&LockingFeature, sizeof (LockingFeature));
+  Ret = OpalGetSupportedAttributesAndLockingInfo (&Session, &SupportedAttributes, &OpalBaseComId, &LockingFeature);
   if (Ret != TcgResultSuccess) {
     return FALSE;
   }
 
-  Session.OpalBaseComId  = OpalBaseComId;
   *BlockSidSupported     = SupportedAttributes.BlockSid == 1 ? TRUE : FALSE;
 
-  Ret = OpalGetLockingInfo(&Session, &LockingFeature);
-  if (Ret != TcgResultSuccess) {
-    return FALSE;
-  }
-
   return OpalDeviceLocked (&SupportedAttributes, &LockingFeature);
 }
 
@@ -19,14 +19,24 @@
 
 #define MMI_ENTRY_SIGNATURE  SIGNATURE_32('m','m','i','e')
 
-typedef struct {
+typedef struct _MMI_ENTRY {
   UINTN       Signature;
   LIST_ENTRY  AllEntries;  // All entries
 
   EFI_GUID    HandlerType; // Type of interrupt
   LIST_ENTRY  MmiHandlers; // All handlers
+  struct _MMI_ENTRY  *HashNext;    // Next entry in the same hash bucket  // MU_CHANGE
 } MMI_ENTRY;
 
+// MU_CHANGE [BEGIN] - Find MMI entries through a hash table.
+//
+// Number of hash buckets for MMI entries. It must be a power of two.
+//
+#define MMI_ENTRY_HASH_BUCKET_COUNT  32
+#define MMI_ENTRY_HASH_BUCKET(Guid) \
+  ((((CONST UINT32 *) (Guid))[0] ^ ((CONST UINT32 *) (Guid))[3]) & (MMI_ENTRY_HASH_BUCKET_COUNT - 1))
+// MU_CHANGE [END]
+
 #define MMI_HANDLER_SIGNATURE  SIGNATURE_32('m','m','i','h')
 
 typedef struct {
@@ -39,6 +49,12 @@ typedef struct {
 LIST_ENTRY  mRootMmiHandlerList = INITIALIZE_LIST_HEAD_VARIABLE (mRootMmiHandlerList);
 LIST_ENTRY  mMmiEntryList       = INITIALIZE_LIST_HEAD_VARIABLE (mMmiEntryList);
 
+//
+// MMI entries hashed by HandlerType. Each bucket keeps the entry found last
+// at its head, so the handler types that trigger most MMIs are found first.
+//
+MMI_ENTRY   *mMmiEntryHash[MMI_ENTRY_HASH_BUCKET_COUNT];  // MU_CHANGE
+
 /**
   Finds the MMI entry for the requested handler type.
 
@@ -55,27 +71,34 @@ MmCoreFindMmiEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY  *Link;
   MMI_ENTRY   *Item;
   MMI_ENTRY   *MmiEntry;
+  // MU_CHANGE [BEGIN] - Find MMI entries through a hash table.
+  MMI_ENTRY   *Previous;
+  UINTN       Bucket;
 
   //
-  // Search the MMI entry list for the matching GUID
+  // Search the hash bucket for the matching GUID
   //
   MmiEntry = NULL;
-  for (Link = mMmiEntryList.ForwardLink;
-       Link != &mMmiEntryList;
-       Link = Link->ForwardLink) {
-
-    Item = CR (Link, MMI_ENTRY, AllEntries, MMI_ENTRY_SIGNATURE);
+  Previous = NULL;
+  Bucket   = MMI_ENTRY_HASH_BUCKET (HandlerType);
+  for (Item = mMmiEntryHash[Bucket]; Item != NULL; Item = Item->HashNext) {
     if (CompareGuid (&Item->HandlerType, HandlerType)) {
       //
-      // This is the MMI entry
+      // This is the MMI entry. Move it to the head of the bucket.
       //
+      if (Previous != NULL) {
+        Previous->HashNext    = Item->HashNext;
+        Item->HashNext        = mMmiEntryHash[Bucket];
+        mMmiEntryHash[Bucket] = Item;
+      }
       MmiEntry = Item;
       break;
     }
+    Previous = Item;
   }
+  // MU_CHANGE [END]
 
   //
   // If the protocol entry was not found and Create is TRUE, then
@@ -95,6 +118,11 @@ MmCoreFindMmiEntry (
       // Add it to MMI entry list
       //
       InsertTailList (&mMmiEntryList, &MmiEntry->AllEntries);
+
+      // MU_CHANGE [BEGIN] - Find MMI entries through a hash table.
+      MmiEntry->HashNext    = mMmiEntryHash[Bucket];
+      mMmiEntryHash[Bucket] = MmiEntry;
+      // MU_CHANGE [END]
     }
   }
   return MmiEntry;
@@ -295,6 +323,7 @@ MmiHandlerUnRegister (
 {
   MMI_HANDLER  *MmiHandler;
   MMI_ENTRY    *MmiEntry;
+  MMI_ENTRY    **Previous;  // MU_CHANGE
 
   MmiHandler = (MMI_HANDLER *) DispatchHandle;
 
@@ -324,6 +353,17 @@ MmiHandlerUnRegister (
     //
     RemoveEntryList (&MmiEntry->AllEntries);
 
+    // MU_CHANGE [BEGIN] - Find MMI entries through a hash table.
+    for (Previous = &mMmiEntryHash[MMI_ENTRY_HASH_BUCKET (&MmiEntry->HandlerType)];
+         *Previous != NULL;
+         Previous = &(*Previous)->HashNext) {
+      if (*Previous == MmiEntry) {
+        *Previous = MmiEntry->HashNext;
+        break;
+      }
+    }
+    // MU_CHANGE [END]
+
     FreePool (MmiEntry);
   }
 
@@ -93,6 +93,13 @@ EFI_CPU_ARCH_PROTOCOL  gCpu = {
   4                           // DmaBufferAlignment
 };
 
+// MU_CHANGE [BEGIN] - Apply a list of ranges with one WP toggle and one TLB flush.
+EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  mCpuMemoryAttributeBatch = {
+  EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL_REVISION,
+  CpuSetMemoryAttributesList
+};
+// MU_CHANGE [END]
+
 //
 // CPU Arch Protocol Functions
 //
@@ -496,6 +503,45 @@ CpuSetMemoryAttributes (
   return AssignMemoryPageAttributes (NULL, BaseAddress, Length, MemoryAttributes, NULL);
 }
 
+// MU_CHANGE [BEGIN] - Apply a list of ranges with one WP toggle and one TLB flush.
+/**
+  Implementation of SetMemoryAttributes() service of CPU Memory Attribute Batch
+  Protocol.
+
+  This function assigns the paging attributes of every memory region in the
+  list, as CpuSetMemoryAttributes() does for a single region. The page table is
+  unlocked once and the TLB is flushed once for the whole list.
+
+  @param  This             The EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+  @param  EntryCount       Number of entries in Entries.
+  @param  Entries          The regions. On return, the Status field of each
+                           entry holds its result.
+
+  @retval EFI_SUCCESS           Every entry was applied successfully.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+  @retval Others                The Status of the first entry that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+CpuSetMemoryAttributesList (
+  IN CONST EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *This,
+  IN       UINTN                                      EntryCount,
+  IN OUT   EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY     *Entries
+  )
+{
+  if ((Entries == NULL) && (EntryCount != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (EntryCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  return AssignMemoryPageAttributesList (EntryCount, Entries);
+}
+// MU_CHANGE [END]
+
 /**
   Initializes the valid bits mask and valid address mask for MTRRs.
 
@@ -1181,6 +1227,7 @@ InitializeCpu (
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &mCpuHandle,
                   &gEfiCpuArchProtocolGuid, &gCpu,
+                  &gEdkiiCpuMemoryAttributeBatchProtocolGuid, &mCpuMemoryAttributeBatch,   // MU_CHANGE
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
@@ -13,6 +13,7 @@
 
 #include <Protocol/Cpu.h>
 #include <Protocol/MpService.h>
+#include <Protocol/CpuMemoryAttributeBatch.h>   // MU_CHANGE
 #include <Register/Intel/Msr.h>
 
 #include <Ppi/SecPlatformInformation.h>
@@ -220,6 +221,29 @@ CpuSetMemoryAttributes (
   IN UINT64                     Attributes
   );
 
+// MU_CHANGE [BEGIN] - Apply a list of ranges with one WP toggle and one TLB flush.
+/**
+  Set the paging attributes of a list of memory ranges.
+
+  @param  This             The EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+  @param  EntryCount       Number of entries in Entries.
+  @param  Entries          The regions. On return, the Status field of each
+                           entry holds its result.
+
+  @retval EFI_SUCCESS           Every entry was applied successfully.
+  @retval EFI_INVALID_PARAMETER Entries is NULL and EntryCount is not 0.
+  @retval Others                The Status of the first entry that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+CpuSetMemoryAttributesList (
+  IN CONST EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *This,
+  IN       UINTN                                      EntryCount,
+  IN OUT   EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY     *Entries
+  );
+// MU_CHANGE [END]
+
 /**
   Initialize Global Descriptor Table.
 
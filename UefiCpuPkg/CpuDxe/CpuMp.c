@@ -595,13 +595,16 @@ CollectBistDataFromHob (
   }
 }
 
+// MU_CHANGE [BEGIN] - Set up exception stack switch on all APs at once
 /**
   Get GDT register value.
 
   This function is mainly for AP purpose because AP may have different GDT
   table than BSP.
 
-  @param[in,out] Buffer  The pointer to private data buffer.
+  @param[in,out] Buffer  The pointer to an array of IA32_DESCRIPTOR, one per
+                         processor. The GDTR of the calling processor is
+                         stored at its processor number.
 
 **/
 VOID
@@ -610,7 +613,10 @@ GetGdtr (
   IN OUT VOID *Buffer
   )
 {
-  AsmReadGdtr ((IA32_DESCRIPTOR *)Buffer);
+  UINTN                             ProcessorNumber;
+
+  MpInitLibWhoAmI (&ProcessorNumber);
+  AsmReadGdtr ((IA32_DESCRIPTOR *)Buffer + ProcessorNumber);
 }
 
 /**
@@ -619,7 +625,9 @@ GetGdtr (
   This function is a wrapper of InitializeCpuExceptionHandlersEx. It's mainly
   for the sake of AP's init because of EFI_AP_PROCEDURE API requirement.
 
-  @param[in,out] Buffer  The pointer to private data buffer.
+  @param[in,out] Buffer  The pointer to an array of CPU_EXCEPTION_INIT_DATA,
+                         one per processor. The calling processor uses the
+                         entry at its processor number.
 
 **/
 VOID
@@ -631,8 +639,14 @@ InitializeExceptionStackSwitchHandlers (
   CPU_EXCEPTION_INIT_DATA           *EssData;
   IA32_DESCRIPTOR                   Idtr;
   EFI_STATUS                        Status;
+  UINTN                             ProcessorNumber;
+
+  MpInitLibWhoAmI (&ProcessorNumber);
+  EssData = (CPU_EXCEPTION_INIT_DATA *)Buffer + ProcessorNumber;
+  if (EssData->Ia32.GdtTable == NULL) {
+    return;
+  }
 
-  EssData = Buffer;
   //
   // We don't plan to replace IDT table with a new one, but we should not assume
   // the AP's IDT is the same as BSP's IDT either.
@@ -650,6 +664,11 @@ InitializeExceptionStackSwitchHandlers (
   This function will allocate required resources required to setup stack switch
   and pass them through CPU_EXCEPTION_INIT_DATA to each logic processor.
 
+  The GDTR of every processor is collected, and the new GDTs and TSSs are set
+  up on every processor, with a single StartupAllAPs() each. The exception
+  stacks, and the GDTs and TSSs, of all the processors are each allocated as
+  one block.
+
 **/
 VOID
 InitializeMpExceptionStackSwitchHandlers (
@@ -662,123 +681,150 @@ InitializeMpExceptionStackSwitchHandlers (
   UINTN                           OldGdtSize;
   UINTN                           NewGdtSize;
   UINTN                           NewStackSize;
-  IA32_DESCRIPTOR                 Gdtr;
-  CPU_EXCEPTION_INIT_DATA         EssData;
+  UINTN                           GdtBufferSize;
+  IA32_DESCRIPTOR                 *Gdtr;
+  CPU_EXCEPTION_INIT_DATA         *EssData;
   UINT8                           *GdtBuffer;
   UINT8                           *StackTop;
 
   ExceptionNumber = FixedPcdGetSize (PcdCpuStackSwitchExceptionList);
   NewStackSize = FixedPcdGet32 (PcdCpuKnownGoodStackSize) * ExceptionNumber;
 
+  Gdtr    = AllocateZeroPool (sizeof (*Gdtr) * mNumberOfProcessors);
+  EssData = AllocateZeroPool (sizeof (*EssData) * mNumberOfProcessors);
+  ASSERT (Gdtr != NULL && EssData != NULL);
+  if (Gdtr == NULL || EssData == NULL) {
+    goto Done;
+  }
+
   StackTop = AllocateRuntimeZeroPool (NewStackSize * mNumberOfProcessors);
   ASSERT (StackTop != NULL);
   StackTop += NewStackSize  * mNumberOfProcessors;
 
   //
-  // The default exception handlers must have been initialized. Let's just skip
-  // it in this method.
+  // To support stack switch, we need to re-construct GDT but not IDT. AP might
+  // have different size of GDT from BSP. An AP that is disabled does not run
+  // the procedure and keeps a zero GDTR.
   //
-  EssData.Ia32.Revision = CPU_EXCEPTION_INIT_DATA_REV;
-  EssData.Ia32.InitDefaultHandlers = FALSE;
-
-  EssData.Ia32.StackSwitchExceptions = FixedPcdGetPtr(PcdCpuStackSwitchExceptionList);
-  EssData.Ia32.StackSwitchExceptionNumber = ExceptionNumber;
-  EssData.Ia32.KnownGoodStackSize = FixedPcdGet32(PcdCpuKnownGoodStackSize);
+  MpInitLibWhoAmI (&Bsp);
+  GetGdtr (Gdtr);
+  if (mNumberOfProcessors > 1) {
+    MpInitLibStartupAllAPs (GetGdtr, FALSE, NULL, 0, (VOID *)Gdtr, NULL);
+  }
 
   //
-  // Initialize Gdtr to suppress incorrect compiler/analyzer warnings.
+  // X64 needs only one TSS of current task working for all exceptions
+  // because of its IST feature. IA32 needs one TSS for each exception
+  // in addition to current task. Since AP is not supposed to allocate
+  // memory, we have to do it in BSP. To simplify the code, we allocate
+  // memory for IA32 case to cover both IA32 and X64 exception stack
+  // switch.
   //
-  Gdtr.Base = 0;
-  Gdtr.Limit = 0;
-  MpInitLibWhoAmI (&Bsp);
+  // Layout of memory to allocate for each processor:
+  //    --------------------------------
+  //    |            Alignment         |  (just in case)
+  //    --------------------------------
+  //    |                              |
+  //    |        Original GDT          |
+  //    |                              |
+  //    --------------------------------
+  //    |    Current task descriptor   |
+  //    --------------------------------
+  //    |                              |
+  //    |  Exception task descriptors  |  X ExceptionNumber
+  //    |                              |
+  //    --------------------------------
+  //    |  Current task-state segment  |
+  //    --------------------------------
+  //    |                              |
+  //    | Exception task-state segment |  X ExceptionNumber
+  //    |                              |
+  //    --------------------------------
+  //
+  // The blocks of all the processors follow each other in one allocation.
+  //
+  GdtBufferSize = 0;
   for (Index = 0; Index < mNumberOfProcessors; ++Index) {
-    //
-    // To support stack switch, we need to re-construct GDT but not IDT.
-    //
-    if (Index == Bsp) {
-      GetGdtr (&Gdtr);
-    } else {
-      //
-      // AP might have different size of GDT from BSP.
-      //
-      MpInitLibStartupThisAP (GetGdtr, Index, NULL, 0, (VOID *)&Gdtr, NULL);
+    if (Gdtr[Index].Limit == 0) {
+      continue;
+    }
+    GdtBufferSize += sizeof (IA32_TSS_DESCRIPTOR) +
+                     Gdtr[Index].Limit + 1 +
+                     (sizeof (IA32_TSS_DESCRIPTOR) + sizeof (IA32_TASK_STATE_SEGMENT)) *
+                     (ExceptionNumber + 1);
+  }
+
+  GdtBuffer = AllocateRuntimeZeroPool (GdtBufferSize);
+  ASSERT (GdtBuffer != NULL);
+  if (GdtBuffer == NULL) {
+    goto Done;
+  }
+
+  for (Index = 0; Index < mNumberOfProcessors; ++Index, StackTop -= NewStackSize) {
+    if (Gdtr[Index].Limit == 0) {
+      continue;
     }
 
     //
-    // X64 needs only one TSS of current task working for all exceptions
-    // because of its IST feature. IA32 needs one TSS for each exception
-    // in addition to current task. Since AP is not supposed to allocate
-    // memory, we have to do it in BSP. To simplify the code, we allocate
-    // memory for IA32 case to cover both IA32 and X64 exception stack
-    // switch.
-    //
-    // Layout of memory to allocate for each processor:
-    //    --------------------------------
-    //    |            Alignment         |  (just in case)
-    //    --------------------------------
-    //    |                              |
-    //    |        Original GDT          |
-    //    |                              |
-    //    --------------------------------
-    //    |    Current task descriptor   |
-    //    --------------------------------
-    //    |                              |
-    //    |  Exception task descriptors  |  X ExceptionNumber
-    //    |                              |
-    //    --------------------------------
-    //    |  Current task-state segment  |
-    //    --------------------------------
-    //    |                              |
-    //    | Exception task-state segment |  X ExceptionNumber
-    //    |                              |
-    //    --------------------------------
+    // The default exception handlers must have been initialized. Let's just skip
+    // it in this method.
     //
-    OldGdtSize = Gdtr.Limit + 1;
-    EssData.Ia32.ExceptionTssDescSize = sizeof (IA32_TSS_DESCRIPTOR) *
-                                        (ExceptionNumber + 1);
-    EssData.Ia32.ExceptionTssSize = sizeof (IA32_TASK_STATE_SEGMENT) *
-                                    (ExceptionNumber + 1);
+    EssData[Index].Ia32.Revision = CPU_EXCEPTION_INIT_DATA_REV;
+    EssData[Index].Ia32.InitDefaultHandlers = FALSE;
+
+    EssData[Index].Ia32.StackSwitchExceptions = FixedPcdGetPtr(PcdCpuStackSwitchExceptionList);
+    EssData[Index].Ia32.StackSwitchExceptionNumber = ExceptionNumber;
+    EssData[Index].Ia32.KnownGoodStackSize = FixedPcdGet32(PcdCpuKnownGoodStackSize);
+
+    OldGdtSize = Gdtr[Index].Limit + 1;
+    EssData[Index].Ia32.ExceptionTssDescSize = sizeof (IA32_TSS_DESCRIPTOR) *
+                                               (ExceptionNumber + 1);
+    EssData[Index].Ia32.ExceptionTssSize = sizeof (IA32_TASK_STATE_SEGMENT) *
+                                           (ExceptionNumber + 1);
     NewGdtSize = sizeof (IA32_TSS_DESCRIPTOR) +
                  OldGdtSize +
-                 EssData.Ia32.ExceptionTssDescSize +
-                 EssData.Ia32.ExceptionTssSize;
-
-    GdtBuffer = AllocateRuntimeZeroPool (NewGdtSize);
-    ASSERT (GdtBuffer != NULL);
+                 EssData[Index].Ia32.ExceptionTssDescSize +
+                 EssData[Index].Ia32.ExceptionTssSize;
 
     //
     // Make sure GDT table alignment
     //
-    EssData.Ia32.GdtTable = ALIGN_POINTER(GdtBuffer, sizeof (IA32_TSS_DESCRIPTOR));
-    NewGdtSize -= ((UINT8 *)EssData.Ia32.GdtTable - GdtBuffer);
-    EssData.Ia32.GdtTableSize = NewGdtSize;
+    EssData[Index].Ia32.GdtTable = ALIGN_POINTER(GdtBuffer, sizeof (IA32_TSS_DESCRIPTOR));
+    EssData[Index].Ia32.GdtTableSize = NewGdtSize - ((UINT8 *)EssData[Index].Ia32.GdtTable - GdtBuffer);
+    GdtBuffer += NewGdtSize;
 
-    EssData.Ia32.ExceptionTssDesc = ((UINT8 *)EssData.Ia32.GdtTable + OldGdtSize);
-    EssData.Ia32.ExceptionTss = ((UINT8 *)EssData.Ia32.GdtTable + OldGdtSize +
-                                 EssData.Ia32.ExceptionTssDescSize);
+    EssData[Index].Ia32.ExceptionTssDesc = ((UINT8 *)EssData[Index].Ia32.GdtTable + OldGdtSize);
+    EssData[Index].Ia32.ExceptionTss = ((UINT8 *)EssData[Index].Ia32.GdtTable + OldGdtSize +
+                                        EssData[Index].Ia32.ExceptionTssDescSize);
 
-    EssData.Ia32.KnownGoodStackTop = (UINTN)StackTop;
+    EssData[Index].Ia32.KnownGoodStackTop = (UINTN)StackTop;
     DEBUG ((DEBUG_INFO,
             "Exception stack top[cpu%lu]: 0x%lX\n",
             (UINT64)(UINTN)Index,
             (UINT64)(UINTN)StackTop));
+  }
 
-    if (Index == Bsp) {
-      InitializeExceptionStackSwitchHandlers (&EssData);
-    } else {
-      MpInitLibStartupThisAP (
-        InitializeExceptionStackSwitchHandlers,
-        Index,
-        NULL,
-        0,
-        (VOID *)&EssData,
-        NULL
-        );
-    }
+  InitializeExceptionStackSwitchHandlers (EssData);
+  if (mNumberOfProcessors > 1) {
+    MpInitLibStartupAllAPs (
+      InitializeExceptionStackSwitchHandlers,
+      FALSE,
+      NULL,
+      0,
+      (VOID *)EssData,
+      NULL
+      );
+  }
 
-    StackTop  -= NewStackSize;
+Done:
+  if (Gdtr != NULL) {
+    FreePool (Gdtr);
+  }
+  if (EssData != NULL) {
+    FreePool (EssData);
   }
 }
+// MU_CHANGE [END]
 
 /**
   Initializes MP exceptions handlers for special features, such as Heap Guard
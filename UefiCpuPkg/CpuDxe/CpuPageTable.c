@@ -14,6 +14,7 @@
 #include <Library/SerialPortLib.h>
 #include <Library/SynchronizationLib.h>
 #include <Library/PrintLib.h>
+#include <Library/CpuPageTableLib.h>   // MU_CHANGE
 #include <Protocol/SmmBase2.h>
 #include <Register/Intel/Cpuid.h>
 #include <Register/Intel/Msr.h>
@@ -89,6 +90,11 @@ PAGE_TABLE_POOL                   *mPageTablePool = NULL;
 BOOLEAN                           mPageTablePoolLock = FALSE;
 PAGE_TABLE_LIB_PAGING_CONTEXT     mPagingContext;
 EFI_SMM_BASE2_PROTOCOL            *mSmmBase2 = NULL;
+//
+// MU_CHANGE - Page table pages retired by large page promotion. They stay in
+//             the read-only pool, so they are reused instead of freed.
+//
+VOID                              *mPageTableFreePageList = NULL;
 
 //
 // Record the page fault exception count for one instruction execution.
@@ -654,6 +660,79 @@ EnableReadOnlyPageWriteProtect (
   }
 }
 
+// MU_CHANGE [BEGIN] - Promote split pages back to large pages
+/**
+  Keep a page table page retired by PageTableCoalesce() for reuse.
+
+  The page is still part of the read-only page table pool, so the caller must
+  have disabled write protection.
+
+  @param[in]  Page      The page table page.
+**/
+STATIC
+VOID
+EFIAPI
+ReleasePageTableMemory (
+  IN VOID    *Page
+  )
+{
+  *(VOID **)Page         = mPageTableFreePageList;
+  mPageTableFreePageList = Page;
+}
+
+/**
+  Merge the page table entries around a range whose attributes just changed
+  back into large pages, where all the small pages are identical again.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  BaseAddress       The start address of the range.
+  @param[in]  Length            The length of the range.
+
+  @retval TRUE    Some entries were merged.
+  @retval FALSE   The page table was not modified.
+**/
+STATIC
+BOOLEAN
+CoalescePageTable (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT     *PagingContext,
+  IN  PHYSICAL_ADDRESS                  BaseAddress,
+  IN  UINT64                            Length
+  )
+{
+  UINTN                       PageTableBase;
+  CPU_PAGE_TABLE_PAGING_MODE  PagingMode;
+  BOOLEAN                     Enable1GPage;
+  BOOLEAN                     IsModified;
+
+  if (PagingContext->MachineType == IMAGE_FILE_MACHINE_I386) {
+    PageTableBase = PagingContext->ContextData.Ia32.PageTableBase;
+    PagingMode    = PagingPae;
+    Enable1GPage  = FALSE;
+  } else {
+    PageTableBase = (UINTN)PagingContext->ContextData.X64.PageTableBase;
+    if ((PagingContext->ContextData.X64.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_5_LEVEL) != 0) {
+      PagingMode = Paging5Level;
+    } else {
+      PagingMode = Paging4Level;
+    }
+    Enable1GPage = (BOOLEAN)((PagingContext->ContextData.X64.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAGE_1G_SUPPORT) != 0);
+  }
+
+  IsModified = FALSE;
+  PageTableCoalesce (
+    PageTableBase,
+    PagingMode,
+    Enable1GPage,
+    PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64,
+    BaseAddress,
+    Length,
+    ReleasePageTableMemory,
+    &IsModified
+    );
+  return IsModified;
+}
+// MU_CHANGE [END]
+
 /**
   This function modifies the page attributes for the memory region specified by BaseAddress and
   Length from their current attributes to the attributes specified by Attributes.
@@ -703,6 +782,9 @@ ConvertMemoryPageAttributes (
   RETURN_STATUS                     Status;
   BOOLEAN                           IsEntryModified;
   BOOLEAN                           IsWpEnabled;
+  PHYSICAL_ADDRESS                  OriginalBaseAddress;  // MU_CHANGE
+  UINT64                            OriginalLength;       // MU_CHANGE
+  BOOLEAN                           IsTableModified;      // MU_CHANGE
 
   if ((BaseAddress & (SIZE_4KB - 1)) != 0) {
     DEBUG ((DEBUG_ERROR, "BaseAddress(0x%lx) is not aligned!\n", BaseAddress));
@@ -766,6 +848,11 @@ ConvertMemoryPageAttributes (
   if (AllocatePagesFunc == NULL) {
     AllocatePagesFunc = AllocatePageTableMemory;
   }
+  // MU_CHANGE [BEGIN] - Promote split pages back to large pages
+  OriginalBaseAddress = BaseAddress;
+  OriginalLength      = Length;
+  IsTableModified     = FALSE;
+  // MU_CHANGE [END]
 
   //
   // Make sure that the page table is changeable.
@@ -790,6 +877,7 @@ ConvertMemoryPageAttributes (
     if (SplitAttribute == PageNone) {
       ConvertPageEntryAttribute (&CurrentPagingContext, PageEntry, Attributes, PageAction, &IsEntryModified);
       if (IsEntryModified) {
+        IsTableModified = TRUE;   // MU_CHANGE
         if (IsModified != NULL) {
           *IsModified = TRUE;
         }
@@ -822,6 +910,21 @@ ConvertMemoryPageAttributes (
     }
   }
 
+  // MU_CHANGE [BEGIN] - Promote split pages back to large pages
+  //
+  // The change may have made all the small pages of a split page identical
+  // again. Only do this for the page table pool owned by this driver, since
+  // the retired pages go back to it.
+  //
+  if (IsTableModified && (AllocatePagesFunc == AllocatePageTableMemory)) {
+    if (CoalescePageTable (&CurrentPagingContext, OriginalBaseAddress, OriginalLength)) {
+      if (IsModified != NULL) {
+        *IsModified = TRUE;
+      }
+    }
+  }
+  // MU_CHANGE [END]
+
 Done:
   //
   // Restore page table write protection, if any.
@@ -1166,6 +1269,14 @@ AllocatePageTableMemory (
     return NULL;
   }
 
+  // MU_CHANGE [BEGIN] - Reuse page table pages retired by large page promotion
+  if ((Pages == 1) && (mPageTableFreePageList != NULL)) {
+    Buffer                 = mPageTableFreePageList;
+    mPageTableFreePageList = *(VOID **)Buffer;
+    return Buffer;
+  }
+  // MU_CHANGE [END]
+
   //
   // Renew the pool if necessary.
   //
@@ -1184,6 +1295,154 @@ AllocatePageTableMemory (
   return Buffer;
 }
 
+// MU_CHANGE [BEGIN] - Apply a list of ranges with one WP toggle and one TLB flush.
+/**
+  Return the number of page table pages needed to split the page table so that
+  a range can start or end at the given address.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  Address           The start or end address of a range.
+
+  @return The number of page table pages.
+**/
+STATIC
+UINTN
+GetSplitPagesForBoundary (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT     *PagingContext,
+  IN  PHYSICAL_ADDRESS                  Address
+  )
+{
+  UINT64                            *PageEntry;
+  PAGE_ATTRIBUTE                    PageAttribute;
+
+  PageEntry = GetPageTableEntry (PagingContext, Address, &PageAttribute);
+  if (PageEntry == NULL) {
+    return 0;
+  }
+
+  switch (PageAttribute) {
+  case Page1G:
+    if ((Address & PAGING_1G_MASK) == 0) {
+      return 0;
+    }
+    return ((Address & PAGING_2M_MASK) == 0) ? 1 : 2;
+  case Page2M:
+    return ((Address & PAGING_2M_MASK) == 0) ? 0 : 1;
+  default:
+    return 0;
+  }
+}
+
+/**
+  This function assigns the page attributes for a list of memory regions in the
+  page table of the current CPU context.
+
+  Each entry is handled like a call to AssignMemoryPageAttributes(), but the
+  page table pool is grown once up front for all the splits the list may need,
+  write protection of the page table is lifted once for the whole list, and the
+  TLB is flushed once after the last entry.
+
+  Caller need guarantee the TPL <= TPL_NOTIFY, if there is split page request.
+
+  @param[in]      EntryCount    Number of entries in Entries.
+  @param[in, out] Entries       The regions. On return, the Status field of each
+                                entry holds its result.
+
+  @retval RETURN_SUCCESS        Every entry was applied successfully.
+  @retval Others                The Status of the first entry that failed.
+**/
+RETURN_STATUS
+AssignMemoryPageAttributesList (
+  IN     UINTN                                    EntryCount,
+  IN OUT EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY   *Entries
+  )
+{
+  PAGE_TABLE_LIB_PAGING_CONTEXT     PagingContext;
+  RETURN_STATUS                     Status;
+  UINTN                             Index;
+  UINTN                             SplitPages;
+  BOOLEAN                           IsModified;
+  BOOLEAN                           IsEntryModified;
+  BOOLEAN                           IsWpEnabled;
+
+  GetCurrentPagingContext (&PagingContext);
+
+  //
+  // Reserve the page table pages for the worst case up front, so that the
+  // pool is not renewed in the middle of the list.
+  //
+  if ((PagingContext.MachineType == IMAGE_FILE_MACHINE_X64) ||
+      ((PagingContext.ContextData.Ia32.PageTableBase != 0) &&
+       ((PagingContext.ContextData.Ia32.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAE) != 0))) {
+    SplitPages = 0;
+    for (Index = 0; Index < EntryCount; Index++) {
+      if (Entries[Index].Length == 0) {
+        continue;
+      }
+      SplitPages += GetSplitPagesForBoundary (&PagingContext, Entries[Index].BaseAddress);
+      SplitPages += GetSplitPagesForBoundary (&PagingContext, Entries[Index].BaseAddress + Entries[Index].Length);
+    }
+
+    if ((SplitPages != 0) &&
+        ((mPageTablePool == NULL) || (SplitPages > mPageTablePool->FreePages))) {
+      //
+      // A failure here is not fatal. AllocatePageTableMemory() will try again
+      // for the splits that really happen.
+      //
+      InitializePageTablePool (SplitPages);
+    }
+  }
+
+  //
+  // Make sure that the page table is changeable. ConvertMemoryPageAttributes()
+  // leaves WP alone when it is already disabled.
+  //
+  IsWpEnabled = IsReadOnlyPageWriteProtected ();
+  if (IsWpEnabled) {
+    DisableReadOnlyPageWriteProtect ();
+  }
+
+  Status     = RETURN_SUCCESS;
+  IsModified = FALSE;
+  for (Index = 0; Index < EntryCount; Index++) {
+    IsEntryModified       = FALSE;
+    Entries[Index].Status = ConvertMemoryPageAttributes (
+                              &PagingContext,
+                              Entries[Index].BaseAddress,
+                              Entries[Index].Length,
+                              Entries[Index].Attributes,
+                              PageActionAssign,
+                              NULL,
+                              NULL,
+                              &IsEntryModified
+                              );
+    if (IsEntryModified) {
+      IsModified = TRUE;
+    }
+    if (RETURN_ERROR (Entries[Index].Status) && !RETURN_ERROR (Status)) {
+      Status = Entries[Index].Status;
+    }
+  }
+
+  //
+  // Restore page table write protection, if any.
+  //
+  if (IsWpEnabled) {
+    EnableReadOnlyPageWriteProtect ();
+  }
+
+  //
+  // Flush TLB once for the whole list. APs don't need it for the same reason
+  // as in AssignMemoryPageAttributes().
+  //
+  if (IsModified) {
+    CpuFlushTlb ();
+  }
+
+  return Status;
+}
+// MU_CHANGE [END]
+
 /**
   Special handler for #DB exception, which will restore the page attributes
   (not-present). It should work with #PF handler which will set pages to
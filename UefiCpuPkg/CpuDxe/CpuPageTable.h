@@ -10,6 +10,7 @@
 #define _PAGE_TABLE_LIB_H_
 
 #include <IndustryStandard/PeImage.h>
+#include <Protocol/CpuMemoryAttributeBatch.h>  // MU_CHANGE
 
 #define PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PSE              BIT0
 #define PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAE              BIT1
@@ -110,6 +111,31 @@ AssignMemoryPageAttributes (
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES     AllocatePagesFunc OPTIONAL
   );
 
+// MU_CHANGE [BEGIN] - Apply a list of ranges with one WP toggle and one TLB flush.
+/**
+  This function assigns the page attributes for a list of memory regions in the
+  page table of the current CPU context.
+
+  Each entry is handled like a call to AssignMemoryPageAttributes(), but the
+  page table pool is grown once up front, write protection of the page table is
+  lifted once and the TLB is flushed once for the whole list.
+
+  Caller need guarantee the TPL <= TPL_NOTIFY, if there is split page request.
+
+  @param  EntryCount    Number of entries in Entries.
+  @param  Entries       The regions. On return, the Status field of each entry
+                        holds its result.
+
+  @retval RETURN_SUCCESS        Every entry was applied successfully.
+  @retval Others                The Status of the first entry that failed.
+**/
+RETURN_STATUS
+AssignMemoryPageAttributesList (
+  IN     UINTN                                    EntryCount,
+  IN OUT EDKII_CPU_MEMORY_ATTRIBUTE_BATCH_ENTRY   *Entries
+  );
+// MU_CHANGE [END]
+
 /**
   Initialize the Page Table lib.
 **/
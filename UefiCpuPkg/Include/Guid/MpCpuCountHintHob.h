@@ -0,0 +1,37 @@
+/** @file
+  The MP CPU count hint HOB lets a platform tell MpInitLib how many logical
+  processors it expects to find at boot.
+
+  Unlike PcdCpuBootLogicalProcessorNumber, the count is only a hint. MpInitLib
+  stops waiting for APs as soon as the expected number of APs has checked in,
+  but still gives up after PcdCpuApInitTimeOutInMicroSeconds if fewer APs show
+  up, so missing APs cost boot time instead of hanging the boot. The hint must
+  not be lower than the real count, or the extra APs may be missed.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _MP_CPU_COUNT_HINT_HOB_H_
+#define _MP_CPU_COUNT_HINT_HOB_H_
+
+#define EDKII_MP_CPU_COUNT_HINT_HOB_GUID \
+  { \
+    0x6bfe1058, 0xb6f4, 0x47b4, { 0x8d, 0xbf, 0x07, 0x09, 0xf5, 0x2f, 0x4c, 0xd8 } \
+  }
+
+extern EFI_GUID gEdkiiMpCpuCountHintHobGuid;
+
+//
+// The platform builds this HOB before MpInitLib runs in PEI.
+//
+typedef struct {
+  //
+  // The number of logical processors expected at boot, including the BSP.
+  // 0 means no hint.
+  //
+  UINT32    ExpectedCpuCount;
+} EDKII_MP_CPU_COUNT_HINT_HOB;
+
+#endif
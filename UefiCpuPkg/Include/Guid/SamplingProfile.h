@@ -0,0 +1,55 @@
+/** @file
+  The sampling profile table holds the instruction pointers sampled on the
+  BSP by SamplingProfilerDxe.
+
+  The driver installs the table as an EFI configuration table and keeps
+  appending samples to it until ExitBootServices(), so tools running from
+  the shell or a debugger can read the samples and symbolize them against
+  the EFI_DEBUG_IMAGE_INFO_TABLE.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _SAMPLING_PROFILE_H_
+#define _SAMPLING_PROFILE_H_
+
+#define EDKII_SAMPLING_PROFILE_TABLE_GUID \
+  { \
+    0x7ebd6ff8, 0x9dfe, 0x4b49, { 0x8a, 0xf2, 0x4e, 0x02, 0xe3, 0x40, 0xdc, 0x2e } \
+  }
+
+extern EFI_GUID gEdkiiSamplingProfileTableGuid;
+
+#define EDKII_SAMPLING_PROFILE_TABLE_SIGNATURE  SIGNATURE_32 ('S', 'P', 'R', 'F')
+
+typedef struct {
+  //
+  // EDKII_SAMPLING_PROFILE_TABLE_SIGNATURE.
+  //
+  UINT32             Signature;
+  //
+  // Number of samples taken per second.
+  //
+  UINT32             SamplingRate;
+  //
+  // Number of entries in Samples.
+  //
+  UINT32             MaxSampleCount;
+  //
+  // Number of valid entries in Samples, still growing while boot services run.
+  //
+  volatile UINT32    SampleCount;
+  //
+  // Number of samples dropped because Samples was full.
+  //
+  volatile UINT32    DroppedSampleCount;
+  UINT32             Reserved;
+  //
+  // Interrupted instruction pointers, in the order they were sampled.
+  //
+  UINT64             Samples[0];
+} EDKII_SAMPLING_PROFILE_TABLE;
+
+#endif
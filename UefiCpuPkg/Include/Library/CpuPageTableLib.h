@@ -0,0 +1,74 @@
+/** @file
+  Public header file for the CPU page table library class.
+
+  This library class provides helpers shared by the modules that own an IA32
+  or X64 page table. The helpers only work on the page table in memory; the
+  caller is responsible for making the page table writable and for flushing
+  the TLB afterwards.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CPU_PAGE_TABLE_LIB_H__
+#define __CPU_PAGE_TABLE_LIB_H__
+
+typedef enum {
+  PagingPae,
+  Paging4Level,
+  Paging5Level
+} CPU_PAGE_TABLE_PAGING_MODE;
+
+/**
+  Give back one 4KB page table page that is no longer referenced by the
+  page table.
+
+  @param[in]  Page      The base address of the page table page.
+**/
+typedef
+VOID
+(EFIAPI *CPU_PAGE_TABLE_FREE_PAGE) (
+  IN VOID    *Page
+  );
+
+/**
+  Merge page table entries in a range back into large pages.
+
+  A 2MB range mapped by a full page table of 4KB entries with identical
+  attributes and contiguous addresses is replaced by a single 2MB entry.
+  When Enable1GPage is TRUE, a 1GB range mapped by a full page directory of
+  such 2MB entries is replaced by a single 1GB entry. The range is rounded
+  out to 2MB, or to 1GB for the second step, before it is checked.
+
+  This is meant to be called after an attribute change made the entries of a
+  split page identical again.
+
+  @param[in]  PageTableBase   The base address of the top level page table.
+  @param[in]  PagingMode      The paging mode of the page table.
+  @param[in]  Enable1GPage    TRUE if 1GB pages may be created.
+  @param[in]  AddressEncMask  The memory encryption mask set in the entries.
+  @param[in]  BaseAddress     The start of the range to check.
+  @param[in]  Length          The length of the range to check.
+  @param[in]  FreePage        Called for each page table page that is no
+                              longer referenced. May be NULL.
+  @param[out] IsModified      TRUE if any entry was merged. May be NULL.
+
+  @retval RETURN_SUCCESS            The range has been checked.
+  @retval RETURN_INVALID_PARAMETER  PageTableBase is 0, Length is 0, or
+                                    PagingMode is not supported.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableCoalesce (
+  IN  UINTN                       PageTableBase,
+  IN  CPU_PAGE_TABLE_PAGING_MODE  PagingMode,
+  IN  BOOLEAN                     Enable1GPage,
+  IN  UINT64                      AddressEncMask,
+  IN  PHYSICAL_ADDRESS            BaseAddress,
+  IN  UINT64                      Length,
+  IN  CPU_PAGE_TABLE_FREE_PAGE    FreePage    OPTIONAL,
+  OUT BOOLEAN                     *IsModified OPTIONAL
+  );
+
+#endif
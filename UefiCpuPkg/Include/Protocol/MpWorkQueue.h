@@ -0,0 +1,86 @@
+/** @file -- MpWorkQueue.h
+  A protocol to run a set of independent jobs on all enabled processors.
+
+  The caller submits JobCount jobs and one procedure. Each processor runs jobs
+  from its own queue, and takes work from the other processors' queues once
+  its own queue is empty, so the load stays balanced when jobs take different
+  amounts of time.
+
+  The jobs run on the APs, so the same rules apply as for procedures passed to
+  EFI_MP_SERVICES_PROTOCOL.StartupAllAPs(): a job must not call UEFI services
+  other than the MP services that an AP is allowed to call.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _MP_WORK_QUEUE_PROTOCOL_H_
+#define _MP_WORK_QUEUE_PROTOCOL_H_
+
+// B8088C78-5B47-42A3-BF1F-E6CC66CF30C1
+#define EDKII_MP_WORK_QUEUE_PROTOCOL_GUID \
+  { \
+    0xb8088c78, 0x5b47, 0x42a3, { 0xbf, 0x1f, 0xe6, 0xcc, 0x66, 0xcf, 0x30, 0xc1 } \
+  }
+
+extern EFI_GUID gEdkiiMpWorkQueueProtocolGuid;
+
+typedef struct _EDKII_MP_WORK_QUEUE_PROTOCOL  EDKII_MP_WORK_QUEUE_PROTOCOL;
+
+/**
+  One job of a batch.
+
+  @param[in]  JobIndex          The index of the job, from 0 to JobCount - 1.
+  @param[in]  Context           The Context passed to SubmitJobs().
+**/
+typedef
+VOID
+(EFIAPI *EDKII_MP_WORK_QUEUE_JOB)(
+  IN UINTN  JobIndex,
+  IN VOID   *Context
+  );
+
+/**
+  Run JobCount jobs on all enabled processors.
+
+  Each job runs exactly once, on one processor, in no defined order.
+
+  If CompletionEvent is NULL, the BSP takes part in the work and the call
+  returns once every job is done. Otherwise the jobs run on the APs only, the
+  call returns right away, and CompletionEvent is signaled once every job is
+  done. If there is no enabled AP, the BSP runs all the jobs and signals
+  CompletionEvent before returning.
+
+  Only one batch may be in progress at a time.
+
+  @param[in]  This              The EDKII_MP_WORK_QUEUE_PROTOCOL instance.
+  @param[in]  Job               The procedure to run for each job.
+  @param[in]  Context           Passed to every call to Job.
+  @param[in]  JobCount          The number of jobs.
+  @param[in]  CompletionEvent   An optional event to signal once all the jobs
+                                are done, for non-blocking mode.
+
+  @retval EFI_SUCCESS           In blocking mode, all the jobs are done. In
+                                non-blocking mode, the jobs were started.
+  @retval EFI_INVALID_PARAMETER Job is NULL.
+  @retval EFI_NOT_READY         A batch or another MP services call is still
+                                in progress.
+  @retval EFI_DEVICE_ERROR      The caller is not the BSP.
+  @retval Others                The error returned by StartupAllAPs().
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_WORK_QUEUE_SUBMIT_JOBS)(
+  IN CONST EDKII_MP_WORK_QUEUE_PROTOCOL  *This,
+  IN       EDKII_MP_WORK_QUEUE_JOB       Job,
+  IN       VOID                          *Context OPTIONAL,
+  IN       UINTN                         JobCount,
+  IN       EFI_EVENT                     CompletionEvent OPTIONAL
+  );
+
+struct _EDKII_MP_WORK_QUEUE_PROTOCOL {
+  EDKII_MP_WORK_QUEUE_SUBMIT_JOBS    SubmitJobs;
+};
+
+#endif // _MP_WORK_QUEUE_PROTOCOL_H_
@@ -0,0 +1,54 @@
+/** @file -- SmmCpuApRelease.h
+  A protocol that lets an SMI handler release the APs early when the rest of
+  the current SMI only needs the BSP.
+
+  It is only supported in the relaxed-AP sync mode of PiSmmCpuDxeSmm. In this
+  mode the APs that entered SMM wait until the BSP has run all SMI handlers.
+  An SMI handler that knows that no AP work is pending for this SMI can send
+  them back to normal mode right away.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _SMM_CPU_AP_RELEASE_PROTOCOL_H_
+#define _SMM_CPU_AP_RELEASE_PROTOCOL_H_
+
+// 4F8AAB1C-EA50-4E1E-918F-02879254D2B3
+#define EDKII_SMM_CPU_AP_RELEASE_PROTOCOL_GUID \
+  { \
+    0x4f8aab1c, 0xea50, 0x4e1e, { 0x91, 0x8f, 0x02, 0x87, 0x92, 0x54, 0xd2, 0xb3 } \
+  }
+
+extern EFI_GUID gEdkiiSmmCpuApReleaseProtocolGuid;
+
+typedef struct _EDKII_SMM_CPU_AP_RELEASE_PROTOCOL  EDKII_SMM_CPU_AP_RELEASE_PROTOCOL;
+
+/**
+  Release the APs of the current SMI before the SMI handlers are done.
+
+  The call waits for the procedures already dispatched to the APs, and then
+  lets every AP that entered SMM for this SMI leave it. After it returns, the
+  rest of the SMI runs on the BSP only, and MM MP services fail for all APs
+  until the next SMI.
+
+  @param[in]  This              The EDKII_SMM_CPU_AP_RELEASE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The APs have left SMM.
+  @retval EFI_ALREADY_STARTED   The APs were already released during this SMI.
+  @retval EFI_NOT_READY         The caller is not running in an SMI on the BSP.
+  @retval EFI_UNSUPPORTED       The sync mode is not relaxed-AP, or the APs
+                                have to stay in SMM to restore their MTRRs.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SMM_CPU_RELEASE_APS)(
+  IN CONST EDKII_SMM_CPU_AP_RELEASE_PROTOCOL  *This
+  );
+
+struct _EDKII_SMM_CPU_AP_RELEASE_PROTOCOL {
+  EDKII_SMM_CPU_RELEASE_APS    ReleaseAps;
+};
+
+#endif // _SMM_CPU_AP_RELEASE_PROTOCOL_H_
@@ -0,0 +1,293 @@
+/** @file
+  CPU page table library.
+
+  Helpers to maintain IA32 PAE and X64 page tables in memory.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/CpuPageTableLib.h>
+
+#define IA32_PG_P                   BIT0
+#define IA32_PG_RW                  BIT1
+#define IA32_PG_U                   BIT2
+#define IA32_PG_A                   BIT5
+#define IA32_PG_D                   BIT6
+#define IA32_PG_PS                  BIT7
+#define IA32_PG_PAT_2M              BIT12
+#define IA32_PG_PAT_4K              IA32_PG_PS
+#define IA32_PG_NX                  BIT63
+
+#define PAGING_4K_ADDRESS_MASK_64   0x000FFFFFFFFFF000ull
+#define PAGING_2M_ADDRESS_MASK_64   0x000FFFFFFFE00000ull
+
+#define PAGING_PAE_INDEX_MASK       0x1FF
+#define PAGING_PAE_PDPTE_INDEX_MASK 0x3
+
+#define PAGING_ENTRIES_PER_TABLE    512
+
+//
+// Page table levels, counted from the 4KB page table entries.
+//
+#define PAGING_LEVEL_PTE            1
+#define PAGING_LEVEL_PDE            2
+#define PAGING_LEVEL_PDPTE          3
+
+/**
+  Return the number of bits covered by one entry of a page table level.
+
+  @param[in]  Level   The page table level.
+
+  @return The address shift of the level.
+**/
+STATIC
+UINTN
+LevelShift (
+  IN UINTN  Level
+  )
+{
+  return 12 + 9 * (Level - 1);
+}
+
+/**
+  Find the entry of a page table level that maps an address.
+
+  @param[in]  PageTableBase   The base address of the top level page table.
+  @param[in]  PagingMode      The paging mode of the page table.
+  @param[in]  AddressEncMask  The memory encryption mask set in the entries.
+  @param[in]  Address         The address to look up.
+  @param[in]  Level           The level of the entry to return.
+
+  @return The entry, or NULL if the address is mapped by a larger page or is
+          not mapped down to Level.
+**/
+STATIC
+UINT64 *
+GetEntry (
+  IN UINTN                       PageTableBase,
+  IN CPU_PAGE_TABLE_PAGING_MODE  PagingMode,
+  IN UINT64                      AddressEncMask,
+  IN PHYSICAL_ADDRESS            Address,
+  IN UINTN                       Level
+  )
+{
+  UINT64  *Table;
+  UINT64  *Entry;
+  UINTN   CurrentLevel;
+  UINTN   Index;
+
+  Table        = (UINT64 *)PageTableBase;
+  CurrentLevel = (PagingMode == Paging5Level) ? 5 : (PagingMode == Paging4Level) ? 4 : 3;
+
+  while (TRUE) {
+    Index = (UINTN)RShiftU64 (Address, LevelShift (CurrentLevel));
+    if ((PagingMode == PagingPae) && (CurrentLevel == PAGING_LEVEL_PDPTE)) {
+      Index &= PAGING_PAE_PDPTE_INDEX_MASK;
+    } else {
+      Index &= PAGING_PAE_INDEX_MASK;
+    }
+    Entry = &Table[Index];
+    if (CurrentLevel == Level) {
+      return Entry;
+    }
+
+    if ((*Entry & IA32_PG_P) == 0) {
+      return NULL;
+    }
+    if ((CurrentLevel <= PAGING_LEVEL_PDPTE) && ((*Entry & IA32_PG_PS) != 0)) {
+      return NULL;
+    }
+
+    Table = (UINT64 *)(UINTN)(*Entry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+    CurrentLevel--;
+  }
+}
+
+/**
+  Replace a page table entry that points to a full table of identical
+  leaf entries with a single leaf entry.
+
+  @param[in, out] Entry           The PDE or PDPTE to merge.
+  @param[in]      ChildLevel      The level of the table Entry points to.
+  @param[in]      AddressEncMask  The memory encryption mask set in the entries.
+  @param[in]      FreePage        Called for the retired table. May be NULL.
+
+  @retval TRUE    The entry has been merged.
+  @retval FALSE   The table cannot be merged.
+**/
+STATIC
+BOOLEAN
+TryMerge (
+  IN OUT UINT64                    *Entry,
+  IN     UINTN                     ChildLevel,
+  IN     UINT64                    AddressEncMask,
+  IN     CPU_PAGE_TABLE_FREE_PAGE  FreePage OPTIONAL
+  )
+{
+  UINT64  *Table;
+  UINT64  AddressMask;
+  UINT64  ChildSize;
+  UINT64  Base;
+  UINT64  Attributes;
+  UINT64  AccessedDirty;
+  UINT64  Child;
+  UINT64  NewEntry;
+  UINTN   Index;
+
+  Table       = (UINT64 *)(UINTN)(*Entry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  AddressMask = (ChildLevel == PAGING_LEVEL_PTE) ? PAGING_4K_ADDRESS_MASK_64 : PAGING_2M_ADDRESS_MASK_64;
+  ChildSize   = LShiftU64 (1, LevelShift (ChildLevel));
+
+  //
+  // A PDE leaf is a 2MB page with PS set. Anything else at that level points
+  // to another table and cannot be merged.
+  //
+  if ((ChildLevel == PAGING_LEVEL_PDE) && ((Table[0] & IA32_PG_PS) == 0)) {
+    return FALSE;
+  }
+  if ((Table[0] & IA32_PG_P) == 0) {
+    return FALSE;
+  }
+
+  Base          = Table[0] & ~AddressEncMask & AddressMask;
+  Attributes    = Table[0] & ~(AddressMask & ~AddressEncMask) & ~(UINT64)(IA32_PG_A | IA32_PG_D);
+  AccessedDirty = 0;
+  if ((Base & (LShiftU64 (ChildSize, 9) - 1)) != 0) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < PAGING_ENTRIES_PER_TABLE; Index++) {
+    Child = Table[Index];
+    if ((Child & ~(AddressMask & ~AddressEncMask) & ~(UINT64)(IA32_PG_A | IA32_PG_D)) != Attributes) {
+      return FALSE;
+    }
+    if ((Child & ~AddressEncMask & AddressMask) != Base + MultU64x32 (ChildSize, (UINT32)Index)) {
+      return FALSE;
+    }
+    AccessedDirty |= Child & (IA32_PG_A | IA32_PG_D);
+  }
+
+  NewEntry = Base | Attributes | AccessedDirty;
+  if (ChildLevel == PAGING_LEVEL_PTE) {
+    //
+    // The PAT bit of a 4KB entry sits where PS is in a large page entry.
+    //
+    if ((NewEntry & IA32_PG_PAT_4K) != 0) {
+      NewEntry |= IA32_PG_PAT_2M;
+    }
+    NewEntry |= IA32_PG_PS;
+  }
+
+  //
+  // The entry being replaced may restrict access to the whole range. Keep
+  // the effective permissions the same.
+  //
+  if ((*Entry & IA32_PG_RW) == 0) {
+    NewEntry &= ~(UINT64)IA32_PG_RW;
+  }
+  if ((*Entry & IA32_PG_U) == 0) {
+    NewEntry &= ~(UINT64)IA32_PG_U;
+  }
+  if ((*Entry & IA32_PG_NX) != 0) {
+    NewEntry |= IA32_PG_NX;
+  }
+
+  *Entry = NewEntry;
+  if (FreePage != NULL) {
+    FreePage (Table);
+  }
+  return TRUE;
+}
+
+/**
+  Merge page table entries in a range back into large pages.
+
+  A 2MB range mapped by a full page table of 4KB entries with identical
+  attributes and contiguous addresses is replaced by a single 2MB entry.
+  When Enable1GPage is TRUE, a 1GB range mapped by a full page directory of
+  such 2MB entries is replaced by a single 1GB entry. The range is rounded
+  out to 2MB, or to 1GB for the second step, before it is checked.
+
+  This is meant to be called after an attribute change made the entries of a
+  split page identical again.
+
+  @param[in]  PageTableBase   The base address of the top level page table.
+  @param[in]  PagingMode      The paging mode of the page table.
+  @param[in]  Enable1GPage    TRUE if 1GB pages may be created.
+  @param[in]  AddressEncMask  The memory encryption mask set in the entries.
+  @param[in]  BaseAddress     The start of the range to check.
+  @param[in]  Length          The length of the range to check.
+  @param[in]  FreePage        Called for each page table page that is no
+                              longer referenced. May be NULL.
+  @param[out] IsModified      TRUE if any entry was merged. May be NULL.
+
+  @retval RETURN_SUCCESS            The range has been checked.
+  @retval RETURN_INVALID_PARAMETER  PageTableBase is 0, Length is 0, or
+                                    PagingMode is not supported.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableCoalesce (
+  IN  UINTN                       PageTableBase,
+  IN  CPU_PAGE_TABLE_PAGING_MODE  PagingMode,
+  IN  BOOLEAN                     Enable1GPage,
+  IN  UINT64                      AddressEncMask,
+  IN  PHYSICAL_ADDRESS            BaseAddress,
+  IN  UINT64                      Length,
+  IN  CPU_PAGE_TABLE_FREE_PAGE    FreePage    OPTIONAL,
+  OUT BOOLEAN                     *IsModified OPTIONAL
+  )
+{
+  PHYSICAL_ADDRESS  Address;
+  PHYSICAL_ADDRESS  End;
+  UINT64            *Entry;
+  BOOLEAN           Modified;
+
+  if ((PageTableBase == 0) || (Length == 0) || (PagingMode > Paging5Level)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Modified = FALSE;
+
+  //
+  // Merge 4KB pages into 2MB pages first, so that the 1GB step below sees
+  // the result.
+  //
+  Address = BaseAddress & ~(UINT64)(SIZE_2MB - 1);
+  End     = (BaseAddress + Length + SIZE_2MB - 1) & ~(UINT64)(SIZE_2MB - 1);
+  for ( ; Address < End; Address += SIZE_2MB) {
+    Entry = GetEntry (PageTableBase, PagingMode, AddressEncMask, Address, PAGING_LEVEL_PDE);
+    if ((Entry == NULL) || ((*Entry & IA32_PG_P) == 0) || ((*Entry & IA32_PG_PS) != 0)) {
+      continue;
+    }
+    if (TryMerge (Entry, PAGING_LEVEL_PTE, AddressEncMask, FreePage)) {
+      Modified = TRUE;
+    }
+  }
+
+  //
+  // PAE paging has no 1GB pages.
+  //
+  if (Enable1GPage && (PagingMode != PagingPae)) {
+    Address = BaseAddress & ~(UINT64)(SIZE_1GB - 1);
+    End     = (BaseAddress + Length + SIZE_1GB - 1) & ~(UINT64)(SIZE_1GB - 1);
+    for ( ; Address < End; Address += SIZE_1GB) {
+      Entry = GetEntry (PageTableBase, PagingMode, AddressEncMask, Address, PAGING_LEVEL_PDPTE);
+      if ((Entry == NULL) || ((*Entry & IA32_PG_P) == 0) || ((*Entry & IA32_PG_PS) != 0)) {
+        continue;
+      }
+      if (TryMerge (Entry, PAGING_LEVEL_PDE, AddressEncMask, FreePage)) {
+        Modified = TRUE;
+      }
+    }
+  }
+
+  if (IsModified != NULL) {
+    *IsModified = Modified;
+  }
+  return RETURN_SUCCESS;
+}
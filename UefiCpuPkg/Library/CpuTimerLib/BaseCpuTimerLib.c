@@ -9,33 +9,26 @@
 #include <Base.h>
 #include <Library/TimerLib.h>
 #include <Library/BaseLib.h>
+#include "CpuTimerLib.h"
 
 /**
-  CPUID Leaf 0x15 for Core Crystal Clock Frequency.
+  Internal function to retrieve the TSC frequency and the constants derived
+  from it.
 
-  The TSC counting frequency is determined by using CPUID leaf 0x15. Frequency in MHz = Core XTAL frequency * EBX/EAX.
-  In newer flavors of the CPU, core xtal frequency is returned in ECX or 0 if not supported.
-  @return The number of TSC counts per second.
+  This instance has no writable global storage, so the frequency is read from
+  CPUID and the constants are computed into Buffer on every call.
 
-**/
-UINT64
-CpuidCoreClockCalculateTscFrequency (
-  VOID
-  );
-
-/**
-  Internal function to retrieves the 64-bit frequency in Hz.
-
-  Internal function to retrieves the 64-bit frequency in Hz.
+  @param[in]  Buffer  Caller storage that is filled in and returned.
 
-  @return The frequency in Hz.
+  @return The timer parameters.
 
 **/
-UINT64
-InternalGetPerformanceCounterFrequency (
-  VOID
+CONST CPU_TIMER_PARAMETERS *
+InternalGetCpuTimerParameters (
+  IN CPU_TIMER_PARAMETERS  *Buffer
   )
 {
-  return CpuidCoreClockCalculateTscFrequency ();
+  InternalInitializeCpuTimerParameters (CpuidCoreClockCalculateTscFrequency (), Buffer);
+  return Buffer;
 }
 
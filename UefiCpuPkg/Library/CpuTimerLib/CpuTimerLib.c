@@ -12,22 +12,10 @@
 #include <Library/PcdLib.h>
 #include <Library/DebugLib.h>
 #include <Register/Cpuid.h>
+#include "CpuTimerLib.h"
 
 GUID mCpuCrystalFrequencyHobGuid = { 0xe1ec5ad0, 0x8569, 0x46bd, { 0x8d, 0xcd, 0x3b, 0x9f, 0x6f, 0x45, 0x82, 0x7a } };
 
-/**
-  Internal function to retrieves the 64-bit frequency in Hz.
-
-  Internal function to retrieves the 64-bit frequency in Hz.
-
-  @return The frequency in Hz.
-
-**/
-UINT64
-InternalGetPerformanceCounterFrequency (
-  VOID
-  );
-
 /**
   CPUID Leaf 0x15 for Core Crystal Clock Frequency.
 
@@ -46,6 +34,7 @@ CpuidCoreClockCalculateTscFrequency (
   UINT32                 RegEax;
   UINT32                 RegEbx;
   UINT32                 RegEcx;
+  UINT32                 MaxLeaf;
 
   //
   // Use CPUID leaf 0x15 Time Stamp Counter and Nominal Core Crystal Clock Information
@@ -58,6 +47,17 @@ CpuidCoreClockCalculateTscFrequency (
   // If EAX or EBX returns 0, the XTAL ratio is not enumerated.
   //
   if (RegEax == 0 || RegEbx ==0 ) {
+    //
+    // Fall back to the processor base frequency of CPUID leaf 0x16, which
+    // matches the invariant TSC frequency on processors that report it.
+    //
+    AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+    if (MaxLeaf >= CPUID_PROCESSOR_FREQUENCY) {
+      AsmCpuid (CPUID_PROCESSOR_FREQUENCY, &RegEax, NULL, NULL, NULL);
+      if ((RegEax & 0xFFFF) != 0) {
+        return MultU64x32 ((UINT64)(RegEax & 0xFFFF), 1000000u);
+      }
+    }
     ASSERT (RegEax != 0);
     ASSERT (RegEbx != 0);
     return 0;
@@ -80,6 +80,61 @@ CpuidCoreClockCalculateTscFrequency (
   return TscFrequency;
 }
 
+/**
+  Compute the fixed-point timer constants for a TSC frequency.
+
+  @param[in]  Frequency   The TSC frequency in Hz.
+  @param[out] Parameters  The timer parameters to fill in.
+
+**/
+VOID
+InternalInitializeCpuTimerParameters (
+  IN  UINT64                Frequency,
+  OUT CPU_TIMER_PARAMETERS  *Parameters
+  )
+{
+  ASSERT (RShiftU64 (Frequency, 64 - CPU_TIMER_TICKS_SHIFT) == 0);
+
+  Parameters->Frequency = Frequency;
+
+  //
+  // Round the tick rates up so that a delay never ends early.
+  //
+  Parameters->TicksPerMicroSecond = DivU64x32 (LShiftU64 (Frequency, CPU_TIMER_TICKS_SHIFT) + 999999u, 1000000u);
+  Parameters->TicksPerNanoSecond  = DivU64x32 (LShiftU64 (Frequency, CPU_TIMER_TICKS_SHIFT) + 999999999u, 1000000000u);
+
+  if (Frequency == 0) {
+    Parameters->NanoSecondsPerTick  = 0;
+    Parameters->MaxFastMicroSeconds = MAX_UINT64;
+    Parameters->MaxFastNanoSeconds  = MAX_UINT64;
+    Parameters->MaxFastTicksHigh    = MAX_UINT64;
+    return;
+  }
+
+  Parameters->NanoSecondsPerTick  = DivU64x64Remainder (
+                                      LShiftU64 (1000000000u, CPU_TIMER_NANOSECONDS_SHIFT) + RShiftU64 (Frequency, 1),
+                                      Frequency,
+                                      NULL
+                                      );
+  Parameters->MaxFastMicroSeconds = DivU64x64Remainder (MAX_UINT64, Parameters->TicksPerMicroSecond, NULL);
+  Parameters->MaxFastNanoSeconds  = DivU64x64Remainder (MAX_UINT64, Parameters->TicksPerNanoSecond, NULL);
+
+  //
+  // The low 32 bits of a tick count are multiplied by NanoSecondsPerTick, so
+  // the fast conversion is only usable for counters of 1 GHz and above.
+  //
+  if (Parameters->NanoSecondsPerTick > MAX_UINT32) {
+    Parameters->NanoSecondsPerTick = 0;
+    Parameters->MaxFastTicksHigh   = 0;
+  } else {
+    Parameters->MaxFastTicksHigh = DivU64x64Remainder (
+                                     MAX_UINT64 - Parameters->NanoSecondsPerTick,
+                                     Parameters->NanoSecondsPerTick,
+                                     NULL
+                                     );
+  }
+}
+
 /**
   Stalls the CPU for at least the given number of ticks.
 
@@ -128,16 +183,29 @@ MicroSecondDelay (
   IN UINTN  MicroSeconds
   )
 {
-
-  InternalCpuDelay (
-    DivU64x32 (
-      MultU64x64 (
-        MicroSeconds,
-        InternalGetPerformanceCounterFrequency ()
-        ),
-      1000000u
-    )
-  );
+  CPU_TIMER_PARAMETERS        Buffer;
+  CONST CPU_TIMER_PARAMETERS  *Parameters;
+
+  Parameters = InternalGetCpuTimerParameters (&Buffer);
+
+  if (MicroSeconds <= Parameters->MaxFastMicroSeconds) {
+    InternalCpuDelay (
+      RShiftU64 (
+        MultU64x64 (MicroSeconds, Parameters->TicksPerMicroSecond),
+        CPU_TIMER_TICKS_SHIFT
+        )
+      );
+  } else {
+    InternalCpuDelay (
+      DivU64x32 (
+        MultU64x64 (
+          MicroSeconds,
+          Parameters->Frequency
+          ),
+        1000000u
+      )
+    );
+  }
 
   return MicroSeconds;
 }
@@ -158,16 +226,29 @@ NanoSecondDelay (
   IN UINTN  NanoSeconds
   )
 {
-
-  InternalCpuDelay (
-    DivU64x32 (
-      MultU64x64 (
-        NanoSeconds,
-        InternalGetPerformanceCounterFrequency ()
-        ),
-      1000000000u
-    )
-  );
+  CPU_TIMER_PARAMETERS        Buffer;
+  CONST CPU_TIMER_PARAMETERS  *Parameters;
+
+  Parameters = InternalGetCpuTimerParameters (&Buffer);
+
+  if (NanoSeconds <= Parameters->MaxFastNanoSeconds) {
+    InternalCpuDelay (
+      RShiftU64 (
+        MultU64x64 (NanoSeconds, Parameters->TicksPerNanoSecond),
+        CPU_TIMER_TICKS_SHIFT
+        )
+      );
+  } else {
+    InternalCpuDelay (
+      DivU64x32 (
+        MultU64x64 (
+          NanoSeconds,
+          Parameters->Frequency
+          ),
+        1000000000u
+      )
+    );
+  }
 
   return NanoSeconds;
 }
@@ -223,6 +304,8 @@ GetPerformanceCounterProperties (
   OUT UINT64  *EndValue     OPTIONAL
   )
 {
+  CPU_TIMER_PARAMETERS  Buffer;
+
   if (StartValue != NULL) {
     *StartValue = 0;
   }
@@ -230,7 +313,7 @@ GetPerformanceCounterProperties (
   if (EndValue != NULL) {
     *EndValue = 0xffffffffffffffffULL;
   }
-  return InternalGetPerformanceCounterFrequency ();
+  return InternalGetCpuTimerParameters (&Buffer)->Frequency;
 }
 
 /**
@@ -250,12 +333,28 @@ GetTimeInNanoSecond (
   IN UINT64  Ticks
   )
 {
-  UINT64  Frequency;
-  UINT64  NanoSeconds;
-  UINT64  Remainder;
-  INTN    Shift;
+  UINT64                      Frequency;
+  UINT64                      NanoSeconds;
+  UINT64                      Remainder;
+  INTN                        Shift;
+  CPU_TIMER_PARAMETERS        Buffer;
+  CONST CPU_TIMER_PARAMETERS  *Parameters;
+
+  Parameters = InternalGetCpuTimerParameters (&Buffer);
+
+  //
+  // Multiply the upper and lower 32 bits of Ticks by the fixed-point
+  // nanoseconds per tick separately, so that neither product overflows.
+  //
+  if ((Parameters->NanoSecondsPerTick != 0) && (RShiftU64 (Ticks, 32) <= Parameters->MaxFastTicksHigh)) {
+    return MultU64x64 (RShiftU64 (Ticks, 32), Parameters->NanoSecondsPerTick) +
+           RShiftU64 (
+             MultU64x64 (Ticks & MAX_UINT32, Parameters->NanoSecondsPerTick),
+             CPU_TIMER_NANOSECONDS_SHIFT
+             );
+  }
 
-  Frequency = GetPerformanceCounterProperties (NULL, NULL);
+  Frequency = Parameters->Frequency;
 
   //
   //          Ticks
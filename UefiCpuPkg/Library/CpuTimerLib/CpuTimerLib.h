@@ -0,0 +1,85 @@
+/** @file
+  Internal header file for the CPUID Leaf 0x15 instances of Timer Library.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _CPU_TIMER_LIB_H_
+#define _CPU_TIMER_LIB_H_
+
+//
+// Number of fractional bits of CPU_TIMER_PARAMETERS.TicksPerMicroSecond and
+// CPU_TIMER_PARAMETERS.TicksPerNanoSecond. The TSC frequency must be below
+// 2^(64 - CPU_TIMER_TICKS_SHIFT) Hz.
+//
+#define CPU_TIMER_TICKS_SHIFT        24
+
+//
+// Number of fractional bits of CPU_TIMER_PARAMETERS.NanoSecondsPerTick.
+//
+#define CPU_TIMER_NANOSECONDS_SHIFT  32
+
+///
+/// TSC frequency and the fixed-point constants derived from it, so that
+/// delays and tick conversions are a multiply and a shift.
+///
+/// The structure is the data of the HOB identified by
+/// mCpuCrystalFrequencyHobGuid. Frequency must stay the first field, because
+/// older instances only read a UINT64 frequency from the HOB.
+///
+typedef struct {
+  UINT64    Frequency;              ///< TSC frequency in Hz.
+  UINT64    TicksPerMicroSecond;    ///< Rounded up, CPU_TIMER_TICKS_SHIFT fractional bits.
+  UINT64    TicksPerNanoSecond;     ///< Rounded up, CPU_TIMER_TICKS_SHIFT fractional bits.
+  UINT64    NanoSecondsPerTick;     ///< Rounded, CPU_TIMER_NANOSECONDS_SHIFT fractional bits.
+  UINT64    MaxFastMicroSeconds;    ///< Largest delay that does not overflow TicksPerMicroSecond.
+  UINT64    MaxFastNanoSeconds;     ///< Largest delay that does not overflow TicksPerNanoSecond.
+  UINT64    MaxFastTicksHigh;       ///< Largest upper 32 bits of ticks that does not overflow NanoSecondsPerTick.
+} CPU_TIMER_PARAMETERS;
+
+extern GUID mCpuCrystalFrequencyHobGuid;
+
+/**
+  CPUID Leaf 0x15 for Core Crystal Clock Frequency.
+
+  The TSC counting frequency is determined by using CPUID leaf 0x15. Frequency in MHz = Core XTAL frequency * EBX/EAX.
+  In newer flavors of the CPU, core xtal frequency is returned in ECX or 0 if not supported.
+  @return The number of TSC counts per second.
+
+**/
+UINT64
+CpuidCoreClockCalculateTscFrequency (
+  VOID
+  );
+
+/**
+  Compute the fixed-point timer constants for a TSC frequency.
+
+  @param[in]  Frequency   The TSC frequency in Hz.
+  @param[out] Parameters  The timer parameters to fill in.
+
+**/
+VOID
+InternalInitializeCpuTimerParameters (
+  IN  UINT64                Frequency,
+  OUT CPU_TIMER_PARAMETERS  *Parameters
+  );
+
+/**
+  Internal function to retrieve the TSC frequency and the constants derived
+  from it.
+
+  @param[in]  Buffer  Caller storage that instances without a cached copy
+                      fill in and return.
+
+  @return The timer parameters.
+
+**/
+CONST CPU_TIMER_PARAMETERS *
+InternalGetCpuTimerParameters (
+  IN CPU_TIMER_PARAMETERS  *Buffer
+  );
+
+#endif
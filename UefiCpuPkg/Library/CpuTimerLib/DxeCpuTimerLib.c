@@ -10,42 +10,30 @@
 #include <Library/TimerLib.h>
 #include <Library/BaseLib.h>
 #include <Library/HobLib.h>
-
-extern GUID mCpuCrystalFrequencyHobGuid;
-
-/**
-  CPUID Leaf 0x15 for Core Crystal Clock Frequency.
-
-  The TSC counting frequency is determined by using CPUID leaf 0x15. Frequency in MHz = Core XTAL frequency * EBX/EAX.
-  In newer flavors of the CPU, core xtal frequency is returned in ECX or 0 if not supported.
-  @return The number of TSC counts per second.
-
-**/
-UINT64
-CpuidCoreClockCalculateTscFrequency (
-  VOID
-  );
+#include <Library/BaseMemoryLib.h>
+#include "CpuTimerLib.h"
 
 //
-// Cached CPU Crystal counter frequency
+// Cached CPU Crystal counter frequency and the constants derived from it
 //
-UINT64  mCpuCrystalCounterFrequency = 0;
+CPU_TIMER_PARAMETERS  mCpuTimerParameters;
 
 
 /**
-  Internal function to retrieves the 64-bit frequency in Hz.
+  Internal function to retrieve the TSC frequency and the constants derived
+  from it.
 
-  Internal function to retrieves the 64-bit frequency in Hz.
+  @param[in]  Buffer  Not used.
 
-  @return The frequency in Hz.
+  @return The timer parameters cached by the constructor.
 
 **/
-UINT64
-InternalGetPerformanceCounterFrequency (
-  VOID
+CONST CPU_TIMER_PARAMETERS *
+InternalGetCpuTimerParameters (
+  IN CPU_TIMER_PARAMETERS  *Buffer
   )
 {
-  return mCpuCrystalCounterFrequency;
+  return &mCpuTimerParameters;
 }
 
 /**
@@ -67,16 +55,19 @@ DxeCpuTimerLibConstructor (
   EFI_HOB_GUID_TYPE   *GuidHob;
 
   //
-  // Initialize CpuCrystalCounterFrequency
+  // Initialize CpuCrystalCounterFrequency. Use the constants computed in PEI
+  // if the HOB carries them, else derive them from the frequency.
   //
   GuidHob = GetFirstGuidHob (&mCpuCrystalFrequencyHobGuid);
-  if (GuidHob != NULL) {
-    mCpuCrystalCounterFrequency = *(UINT64*)GET_GUID_HOB_DATA (GuidHob);
+  if ((GuidHob != NULL) && (GET_GUID_HOB_DATA_SIZE (GuidHob) >= sizeof (CPU_TIMER_PARAMETERS))) {
+    CopyMem (&mCpuTimerParameters, GET_GUID_HOB_DATA (GuidHob), sizeof (CPU_TIMER_PARAMETERS));
+  } else if (GuidHob != NULL) {
+    InternalInitializeCpuTimerParameters (*(UINT64*)GET_GUID_HOB_DATA (GuidHob), &mCpuTimerParameters);
   } else {
-    mCpuCrystalCounterFrequency = CpuidCoreClockCalculateTscFrequency ();
+    InternalInitializeCpuTimerParameters (CpuidCoreClockCalculateTscFrequency (), &mCpuTimerParameters);
   }
 
-  if (mCpuCrystalCounterFrequency == 0) {
+  if (mCpuTimerParameters.Frequency == 0) {
     return EFI_UNSUPPORTED;
   }
 
@@ -11,48 +11,44 @@
 #include <Library/BaseLib.h>
 #include <Library/HobLib.h>
 #include <Library/DebugLib.h>
-
-extern GUID mCpuCrystalFrequencyHobGuid;
+#include "CpuTimerLib.h"
 
 /**
-  CPUID Leaf 0x15 for Core Crystal Clock Frequency.
-
-  The TSC counting frequency is determined by using CPUID leaf 0x15. Frequency in MHz = Core XTAL frequency * EBX/EAX.
-  In newer flavors of the CPU, core xtal frequency is returned in ECX or 0 if not supported.
-  @return The number of TSC counts per second.
+  Internal function to retrieve the TSC frequency and the constants derived
+  from it.
 
-**/
-UINT64
-CpuidCoreClockCalculateTscFrequency (
-  VOID
-  );
-
-/**
-  Internal function to retrieves the 64-bit frequency in Hz.
+  The frequency is calibrated once and published with its constants in a HOB,
+  which later PEIMs and the DXE instance reuse.
 
-  Internal function to retrieves the 64-bit frequency in Hz.
+  @param[in]  Buffer  Caller storage used if the HOB cannot be built, or if it
+                      was built by an instance that only stores the frequency.
 
-  @return The frequency in Hz.
+  @return The timer parameters.
 
 **/
-UINT64
-InternalGetPerformanceCounterFrequency (
-  VOID
+CONST CPU_TIMER_PARAMETERS *
+InternalGetCpuTimerParameters (
+  IN CPU_TIMER_PARAMETERS  *Buffer
   )
 {
-  UINT64              *CpuCrystalCounterFrequency;
-  EFI_HOB_GUID_TYPE   *GuidHob;
+  CPU_TIMER_PARAMETERS  *CpuTimerParameters;
+  EFI_HOB_GUID_TYPE     *GuidHob;
 
-  CpuCrystalCounterFrequency = NULL;
   GuidHob = GetFirstGuidHob (&mCpuCrystalFrequencyHobGuid);
   if (GuidHob == NULL) {
-    CpuCrystalCounterFrequency  = (UINT64*)BuildGuidHob(&mCpuCrystalFrequencyHobGuid, sizeof (*CpuCrystalCounterFrequency));
-    ASSERT (CpuCrystalCounterFrequency != NULL);
-    *CpuCrystalCounterFrequency = CpuidCoreClockCalculateTscFrequency ();
+    CpuTimerParameters = (CPU_TIMER_PARAMETERS *)BuildGuidHob (&mCpuCrystalFrequencyHobGuid, sizeof (*CpuTimerParameters));
+    ASSERT (CpuTimerParameters != NULL);
+    if (CpuTimerParameters == NULL) {
+      CpuTimerParameters = Buffer;
+    }
+    InternalInitializeCpuTimerParameters (CpuidCoreClockCalculateTscFrequency (), CpuTimerParameters);
+  } else if (GET_GUID_HOB_DATA_SIZE (GuidHob) < sizeof (*CpuTimerParameters)) {
+    CpuTimerParameters = Buffer;
+    InternalInitializeCpuTimerParameters (*(UINT64*)GET_GUID_HOB_DATA (GuidHob), CpuTimerParameters);
   } else {
-    CpuCrystalCounterFrequency = (UINT64*)GET_GUID_HOB_DATA (GuidHob);
+    CpuTimerParameters = (CPU_TIMER_PARAMETERS *)GET_GUID_HOB_DATA (GuidHob);
   }
 
-  return  *CpuCrystalCounterFrequency;
+  return CpuTimerParameters;
 }
 
@@ -1086,6 +1086,39 @@ FillExchangeInfoData (
   ExchangeInfo->ModeHighSegment = (UINT16)ExchangeInfo->CodeSegment;
 }
 
+// MU_CHANGE [BEGIN] - Let the platform end AP enumeration early
+/**
+  Get the number of APs to wait for during the first AP enumeration.
+
+  @return  ExpectedCpuCount - 1 from the CPU count hint HOB, or
+           PcdCpuMaxLogicalProcessorNumber - 1 if there is no usable hint.
+**/
+UINT32
+GetExpectedApCount (
+  VOID
+  )
+{
+  EFI_HOB_GUID_TYPE            *GuidHob;
+  EDKII_MP_CPU_COUNT_HINT_HOB  *Hint;
+  UINT32                       MaxCpuCount;
+
+  MaxCpuCount = PcdGet32 (PcdCpuMaxLogicalProcessorNumber);
+
+  GuidHob = GetFirstGuidHob (&gEdkiiMpCpuCountHintHobGuid);
+  if (GuidHob == NULL) {
+    return MaxCpuCount - 1;
+  }
+
+  Hint = (EDKII_MP_CPU_COUNT_HINT_HOB *) GET_GUID_HOB_DATA (GuidHob);
+  if ((Hint->ExpectedCpuCount == 0) || (Hint->ExpectedCpuCount > MaxCpuCount)) {
+    DEBUG ((DEBUG_WARN, "%a: ignoring CPU count hint %u\n", __FUNCTION__, Hint->ExpectedCpuCount));
+    return MaxCpuCount - 1;
+  }
+
+  return Hint->ExpectedCpuCount - 1;
+}
+// MU_CHANGE [END]
+
 /**
   Helper function that waits until the finished AP count reaches the specified
   limit, or the specified timeout elapses (whichever comes first).
@@ -1436,9 +1469,13 @@ WakeUpAP (
         //     at timeout. APs that miss the time-out may cause undefined
         //     behavior.
         //
+        // MU_CHANGE - A platform that knows how many CPUs to expect can stop
+        //     the wait early with the CPU count hint HOB. The timeout is
+        //     still the upper bound when fewer APs check in.
+        //
         TimedWaitForApFinish (
           CpuMpData,
-          PcdGet32 (PcdCpuMaxLogicalProcessorNumber) - 1,
+          GetExpectedApCount (),   // MU_CHANGE
           PcdGet32 (PcdCpuApInitTimeOutInMicroSeconds)
           );
 
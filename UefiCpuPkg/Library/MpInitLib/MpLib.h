@@ -34,6 +34,7 @@
 #include <Library/PcdLib.h>
 
 #include <Guid/MicrocodePatchHob.h>
+#include <Guid/MpCpuCountHintHob.h>   // MU_CHANGE
 
 #define WAKEUP_AP_SIGNAL SIGNATURE_32 ('S', 'T', 'A', 'P')
 
@@ -2529,6 +2529,130 @@ MtrrSetMemoryAttribute (
   return MtrrSetMemoryAttributeInMtrrSettings (NULL, BaseAddress, Length, Attribute);
 }
 
+// MU_CHANGE [BEGIN] - Batch MTRR updates so the layout is computed once
+/**
+  Initialize an empty batch of memory ranges.
+
+  @param[out]  Batch  The batch to initialize.
+**/
+VOID
+EFIAPI
+MtrrInitializeRangeBatch (
+  OUT MTRR_RANGE_BATCH       *Batch
+  )
+{
+  ASSERT (Batch != NULL);
+  Batch->RangeCount = 0;
+}
+
+/**
+  Add the attributes of a memory range to a batch, without computing or
+  programming any MTRR.
+
+  When ranges in the batch overlap, the one added last takes priority, the
+  same as when MtrrSetMemoryAttribute() is called once for each range.
+
+  @param[in, out]  Batch        The batch to add the range to.
+  @param[in]       BaseAddress  The physical address that is the start address
+                                of a memory range.
+  @param[in]       Length       The size in bytes of the memory range.
+  @param[in]       Attribute    The memory cache type of the memory range.
+
+  @retval RETURN_SUCCESS            The range was added to the batch.
+  @retval RETURN_INVALID_PARAMETER  Length is zero.
+  @retval RETURN_OUT_OF_RESOURCES   The batch is full. The caller should commit
+                                    it and start a new one.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrAddRangeToBatch (
+  IN OUT MTRR_RANGE_BATCH    *Batch,
+  IN PHYSICAL_ADDRESS        BaseAddress,
+  IN UINT64                  Length,
+  IN MTRR_MEMORY_CACHE_TYPE  Attribute
+  )
+{
+  MTRR_MEMORY_RANGE          *Last;
+
+  ASSERT (Batch != NULL);
+  if (Length == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Extend the last range instead of adding a new one when the caller
+  // walks a region in pieces, as GCD does.
+  //
+  if (Batch->RangeCount != 0) {
+    Last = &Batch->Ranges[Batch->RangeCount - 1];
+    if ((Last->Type == Attribute) && (Last->BaseAddress + Last->Length == BaseAddress)) {
+      Last->Length += Length;
+      return RETURN_SUCCESS;
+    }
+  }
+
+  if (Batch->RangeCount == ARRAY_SIZE (Batch->Ranges)) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  Batch->Ranges[Batch->RangeCount].BaseAddress = BaseAddress;
+  Batch->Ranges[Batch->RangeCount].Length      = Length;
+  Batch->Ranges[Batch->RangeCount].Type        = Attribute;
+  Batch->RangeCount++;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Apply all the memory ranges of a batch with one MTRR calculation.
+
+  Only the MTRRs of the calling processor, or MtrrSetting, are updated. A
+  caller that keeps the APs in sync should do so once after the commit, for
+  example by running MtrrSetAllMtrrs() on the APs with the settings returned
+  by MtrrGetAllMtrrs().
+
+  @param[in, out]  MtrrSetting  MTRR setting buffer to be set, or NULL to
+                                program the MTRRs of the calling processor.
+  @param[in, out]  Batch        The batch to apply. It is emptied when the
+                                commit succeeds, and left unchanged otherwise.
+
+  @retval RETURN_SUCCESS            The attributes were set for all the ranges,
+                                    or the batch was empty.
+  @retval RETURN_INVALID_PARAMETER  Length in any range is zero.
+  @retval RETURN_UNSUPPORTED        The processor does not support one or more bytes of the
+                                    memory resource range specified by BaseAddress and Length in any range.
+  @retval RETURN_OUT_OF_RESOURCES   There are not enough system resources to modify the attributes of
+                                    the memory resource ranges.
+  @retval RETURN_ACCESS_DENIED      The attributes for the memory resource range specified by
+                                    BaseAddress and Length cannot be modified.
+  @retval RETURN_BUFFER_TOO_SMALL   The fixed internal scratch buffer is too small for MTRR calculation.
+                                    Caller should use MtrrSetMemoryAttributesInMtrrSettings() to specify
+                                    external scratch buffer.
+**/
+RETURN_STATUS
+EFIAPI
+MtrrCommitRangeBatch (
+  IN OUT MTRR_SETTINGS       *MtrrSetting OPTIONAL,
+  IN OUT MTRR_RANGE_BATCH    *Batch
+  )
+{
+  RETURN_STATUS              Status;
+  UINT8                      Scratch[SCRATCH_BUFFER_SIZE];
+  UINTN                      ScratchSize;
+
+  ASSERT (Batch != NULL);
+  if (Batch->RangeCount == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  ScratchSize = sizeof (Scratch);
+  Status = MtrrSetMemoryAttributesInMtrrSettings (MtrrSetting, Scratch, &ScratchSize, Batch->Ranges, Batch->RangeCount);
+  if (!RETURN_ERROR (Status)) {
+    Batch->RangeCount = 0;
+  }
+  return Status;
+}
+// MU_CHANGE [END]
+
 /**
   Worker function setting variable MTRRs
 
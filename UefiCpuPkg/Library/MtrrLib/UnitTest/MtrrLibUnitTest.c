@@ -989,6 +989,213 @@ UnitTestMtrrSetMemoryAttributeInMtrrSettings (
   return UNIT_TEST_PASSED;
 }
 
+// MU_CHANGE [BEGIN] - Batch MTRR updates so the layout is computed once
+/**
+  Unit test of MtrrLib services MtrrAddRangeToBatch() and MtrrCommitRangeBatch().
+
+  @param[in]  Context    Pointer to MTRR_LIB_SYSTEM_PARAMETER.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnitTestMtrrCommitRangeBatch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST MTRR_LIB_SYSTEM_PARAMETER *SystemParameter;
+  RETURN_STATUS                   Status;
+  UINT32                          UcCount;
+  UINT32                          WtCount;
+  UINT32                          WbCount;
+  UINT32                          WpCount;
+  UINT32                          WcCount;
+
+  UINTN                           MtrrIndex;
+  UINTN                           Index;
+  MTRR_SETTINGS                   LocalMtrrs;
+  MTRR_RANGE_BATCH                Batch;
+
+  MTRR_MEMORY_RANGE               RawMtrrRange[MTRR_NUMBER_OF_VARIABLE_MTRR];
+  MTRR_MEMORY_RANGE               ExpectedMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINT32                          ExpectedVariableMtrrUsage;
+  UINTN                           ExpectedMemoryRangesCount;
+
+  MTRR_MEMORY_RANGE               ActualMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINT32                          ActualVariableMtrrUsage;
+  UINTN                           ActualMemoryRangesCount;
+
+  MTRR_SETTINGS                   *Mtrrs[2];
+
+  SystemParameter = (MTRR_LIB_SYSTEM_PARAMETER *) Context;
+  GenerateRandomMemoryTypeCombination (
+    SystemParameter->VariableMtrrCount - PatchPcdGet32 (PcdCpuNumberOfReservedVariableMtrrs),
+    &UcCount, &WtCount, &WbCount, &WpCount, &WcCount
+    );
+  GenerateValidAndConfigurableMtrrPairs (
+    SystemParameter->PhysicalAddressBits, RawMtrrRange,
+    UcCount, WtCount, WbCount, WpCount, WcCount
+    );
+
+  ExpectedVariableMtrrUsage = UcCount + WtCount + WbCount + WpCount + WcCount;
+  ExpectedMemoryRangesCount = ARRAY_SIZE (ExpectedMemoryRanges);
+  GetEffectiveMemoryRanges (
+    SystemParameter->DefaultCacheType,
+    SystemParameter->PhysicalAddressBits,
+    RawMtrrRange, ExpectedVariableMtrrUsage,
+    ExpectedMemoryRanges, &ExpectedMemoryRangesCount
+    );
+
+  UT_LOG_INFO ("--- Expected Memory Ranges [%d] ---\n", ExpectedMemoryRangesCount);
+  DumpMemoryRanges (ExpectedMemoryRanges, ExpectedMemoryRangesCount);
+
+  //
+  // An empty batch commits without touching anything.
+  //
+  MtrrInitializeRangeBatch (&Batch);
+  UT_ASSERT_STATUS_EQUAL (MtrrCommitRangeBatch (NULL, &Batch), RETURN_SUCCESS);
+  UT_ASSERT_STATUS_EQUAL (MtrrAddRangeToBatch (&Batch, 0, 0, CacheWriteBack), RETURN_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (Batch.RangeCount, 0);
+
+  //
+  // Default cache type is always an INPUT
+  //
+  ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+  LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+  Mtrrs[0]               = &LocalMtrrs;
+  Mtrrs[1]               = NULL;
+
+  for (MtrrIndex = 0; MtrrIndex < ARRAY_SIZE (Mtrrs); MtrrIndex++) {
+    MtrrInitializeRangeBatch (&Batch);
+    for (Index = 0; Index < ExpectedMemoryRangesCount; Index++) {
+      Status = MtrrAddRangeToBatch (
+                 &Batch,
+                 ExpectedMemoryRanges[Index].BaseAddress,
+                 ExpectedMemoryRanges[Index].Length,
+                 ExpectedMemoryRanges[Index].Type
+                 );
+      UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+    }
+
+    Status = MtrrCommitRangeBatch (Mtrrs[MtrrIndex], &Batch);
+    UT_ASSERT_TRUE (Status == RETURN_SUCCESS || Status == RETURN_BUFFER_TOO_SMALL);
+    if (Status == RETURN_BUFFER_TOO_SMALL) {
+      return UNIT_TEST_SKIPPED;
+    }
+    UT_ASSERT_EQUAL (Batch.RangeCount, 0);
+
+    if (Mtrrs[MtrrIndex] == NULL) {
+      ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+      MtrrGetAllMtrrs (&LocalMtrrs);
+    }
+    ActualMemoryRangesCount = ARRAY_SIZE (ActualMemoryRanges);
+    CollectTestResult (
+      SystemParameter->DefaultCacheType, SystemParameter->PhysicalAddressBits, SystemParameter->VariableMtrrCount,
+      &LocalMtrrs, ActualMemoryRanges, &ActualMemoryRangesCount, &ActualVariableMtrrUsage
+      );
+    UT_LOG_INFO ("--- Actual Memory Ranges [%d] ---\n", ActualMemoryRangesCount);
+    DumpMemoryRanges (ActualMemoryRanges, ActualMemoryRangesCount);
+    VerifyMemoryRanges (ExpectedMemoryRanges, ExpectedMemoryRangesCount, ActualMemoryRanges, ActualMemoryRangesCount);
+    UT_ASSERT_TRUE (ExpectedVariableMtrrUsage >= ActualVariableMtrrUsage);
+
+    ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure how long MtrrSetMemoryAttributesInMtrrSettings() takes to compute
+  the MTRR layout, for each number of variable MTRRs in use.
+
+  @param Iteration  Number of random layouts timed per variable MTRR count.
+**/
+STATIC
+VOID
+BenchmarkMtrrSetMemoryAttributesInMtrrSettings (
+  IN UINTN  Iteration
+  )
+{
+  CONST MTRR_LIB_SYSTEM_PARAMETER *SystemParameter;
+  RETURN_STATUS                   Status;
+  UINT32                          MtrrCount;
+  UINT32                          CountPerType[5];
+  UINTN                           Index;
+  UINTN                           Run;
+  MTRR_MEMORY_RANGE               RawMtrrRange[MTRR_NUMBER_OF_VARIABLE_MTRR];
+  MTRR_MEMORY_RANGE               Ranges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                           RangeCount;
+  UINTN                           TotalRangeCount;
+  MTRR_SETTINGS                   LocalMtrrs;
+  UINT8                           *Scratch;
+  UINTN                           ScratchSize;
+  clock_t                         Start;
+  clock_t                         Elapsed;
+
+  if (Iteration == 0) {
+    return;
+  }
+
+  SystemParameter = &mDefaultSystemParameter;
+  InitializeMtrrRegs ((MTRR_LIB_SYSTEM_PARAMETER *) SystemParameter);
+
+  ScratchSize = SCRATCH_BUFFER_SIZE;
+  Scratch     = NULL;
+
+  DEBUG ((DEBUG_INFO, "MTRRs  Ranges  Microseconds per call\n"));
+  for (MtrrCount = 1; MtrrCount <= SystemParameter->VariableMtrrCount - PatchPcdGet32 (PcdCpuNumberOfReservedVariableMtrrs); MtrrCount++) {
+    TotalRangeCount = 0;
+    Elapsed         = 0;
+    for (Run = 0; Run < Iteration; Run++) {
+      ZeroMem (CountPerType, sizeof (CountPerType));
+      for (Index = 0; Index < MtrrCount; Index++) {
+        CountPerType[Random32 (0, ARRAY_SIZE (CountPerType) - 1)]++;
+      }
+      GenerateValidAndConfigurableMtrrPairs (
+        SystemParameter->PhysicalAddressBits, RawMtrrRange,
+        CountPerType[0], CountPerType[1], CountPerType[2], CountPerType[3], CountPerType[4]
+        );
+      RangeCount = ARRAY_SIZE (Ranges);
+      GetEffectiveMemoryRanges (
+        SystemParameter->DefaultCacheType,
+        SystemParameter->PhysicalAddressBits,
+        RawMtrrRange, MtrrCount,
+        Ranges, &RangeCount
+        );
+      TotalRangeCount += RangeCount;
+
+      //
+      // Only time the call that had a large enough scratch buffer.
+      //
+      do {
+        Scratch = realloc (Scratch, ScratchSize);
+        ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+        LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+        Start  = clock ();
+        Status = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, Ranges, RangeCount);
+      } while (Status == RETURN_BUFFER_TOO_SMALL);
+      Elapsed += clock () - Start;
+
+      if (RETURN_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "MtrrSetMemoryAttributesInMtrrSettings() failed with %r\n", Status));
+      }
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "%5d  %6d  %21d\n",
+      MtrrCount,
+      (UINT32) (TotalRangeCount / Iteration),
+      (UINT32) ((UINT64) Elapsed * 1000000 / CLOCKS_PER_SEC / Iteration)
+      ));
+  }
+
+  free (Scratch);
+}
+// MU_CHANGE [END]
 
 /**
   Prep routine for UnitTestGetFirmwareVariableMtrrCount().
@@ -1093,6 +1300,7 @@ UnitTestingEntry (
       AddTestCase (MtrrApiTests, "Test InvalidMemoryLayouts",                  "InvalidMemoryLayouts",                  UnitTestInvalidMemoryLayouts,                  InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributeInMtrrSettings",  "MtrrSetMemoryAttributeInMtrrSettings",  UnitTestMtrrSetMemoryAttributeInMtrrSettings,  InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributesInMtrrSettings", "MtrrSetMemoryAttributesInMtrrSettings", UnitTestMtrrSetMemoryAttributesInMtrrSettings, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
+      AddTestCase (MtrrApiTests, "Test MtrrCommitRangeBatch",                  "MtrrCommitRangeBatch",                  UnitTestMtrrCommitRangeBatch,                  InitializeSystem, NULL, &mSystemParameters[SystemIndex]); // MU_CHANGE
     }
   }
   //
@@ -1137,6 +1345,22 @@ main (
     return 0;
   }
 
+  // MU_CHANGE [BEGIN] - Benchmark mode
+  //
+  // MtrrLibUnitTest benchmark [<iterations>] [fixed|random]
+  //   Prints the time MtrrSetMemoryAttributesInMtrrSettings() takes for each
+  //   count of variable MTRRs, averaged over <iterations> layouts.
+  //   Default <iterations> is 100.
+  //
+  if ((Argc >= 2) && (AsciiStriCmp ("benchmark", Argv[1]) == 0)) {
+    Count        = (Argc >= 3) ? atoi (Argv[2]) : 100;
+    mRandomInput = (Argc >= 4) && (AsciiStriCmp ("random", Argv[3]) == 0);
+    DEBUG ((DEBUG_INFO, "Benchmark iterations = %d\n", Count));
+    BenchmarkMtrrSetMemoryAttributesInMtrrSettings (Count);
+    return 0;
+  }
+  // MU_CHANGE [END]
+
   //
   // MtrrLibUnitTest [<iterations>]
   //                 <iterations> [fixed|random]
@@ -777,46 +777,45 @@ AnalysisProcessorFeatures (
   }
 }
 
+// MU_CHANGE [BEGIN] - Lock-free core and package barriers.
 /**
-  Increment semaphore by 1.
+  Wait in a barrier until all the threads of a core or package reached it.
 
-  @param      Sem            IN:  32-bit unsigned integer
+  Each thread increments the barrier once. The last thread clears the count and
+  moves the barrier to its next generation, which releases the other threads,
+  so the same barrier serves all the semaphores of a register table and is left
+  ready for the next time the register table is programmed.
 
-**/
-VOID
-LibReleaseSemaphore (
-  IN OUT  volatile UINT32           *Sem
-  )
-{
-  InterlockedIncrement (Sem);
-}
-
-/**
-  Decrement the semaphore by 1 if it is not zero.
-
-  Performs an atomic decrement operation for semaphore.
-  The compare exchange operation must be performed using
-  MP safe mechanisms.
-
-  @param      Sem            IN:  32-bit unsigned integer
+  @param[in, out]  Barrier      The barrier of the core or package.
+  @param[in]       ThreadCount  The number of threads that reach the barrier.
 
 **/
 VOID
-LibWaitForSemaphore (
-  IN OUT  volatile UINT32           *Sem
+LibWaitForBarrier (
+  IN OUT  volatile UINT32           *Barrier,
+  IN      UINT32                    ThreadCount
   )
 {
   UINT32  Value;
+  UINT32  Generation;
+
+  ASSERT (ThreadCount != 0 && ThreadCount <= CPU_BARRIER_COUNT_MASK);
 
-  do {
-    Value = *Sem;
-  } while (Value == 0 ||
-           InterlockedCompareExchange32 (
-             Sem,
-             Value,
-             Value - 1
-             ) != Value);
+  Value      = InterlockedIncrement (Barrier);
+  Generation = Value & CPU_BARRIER_GENERATION_MASK;
+  if ((Value & CPU_BARRIER_COUNT_MASK) == ThreadCount) {
+    //
+    // No thread increments the barrier again before its generation changes.
+    //
+    InterlockedCompareExchange32 ((UINT32 *) Barrier, Value, Generation + CPU_BARRIER_COUNT_MASK + 1);
+    return;
+  }
+
+  while ((*Barrier & CPU_BARRIER_GENERATION_MASK) == Generation) {
+    CpuPause ();
+  }
 }
+// MU_CHANGE [END]
 
 /**
   Read / write CR value.
@@ -870,6 +869,74 @@ ReadWriteCr (
   return EFI_SUCCESS;
 }
 
+// MU_CHANGE [BEGIN] - Program the consecutive writes of the same MSR at once.
+/**
+  Program the consecutive register table entries that write the same MSR.
+
+  The MSR is read at most once and written at most once for all of them, as
+  MSR accesses are serializing and some are slow. The entries that test the
+  MSR value before writing it start a new batch, so that they test the value
+  read from the processor.
+
+  @param[in]  RegisterTableEntry  The first entry, which writes an MSR.
+  @param[in]  EntryCount          The number of entries from RegisterTableEntry
+                                  to the end of the register table.
+
+  @return The number of entries programmed.
+**/
+UINTN
+ProgramMsrEntries (
+  IN CPU_REGISTER_TABLE_ENTRY     *RegisterTableEntry,
+  IN UINTN                        EntryCount
+  )
+{
+  CPU_REGISTER_TABLE_ENTRY  *Entry;
+  UINTN                     Count;
+  UINTN                     Index;
+  UINT64                    Value;
+  BOOLEAN                   WriteNeeded;
+
+  for (Count = 1; Count < EntryCount; Count++) {
+    Entry = &RegisterTableEntry[Count];
+    if ((Entry->RegisterType != Msr) || (Entry->Index != RegisterTableEntry->Index) || Entry->TestThenWrite) {
+      break;
+    }
+  }
+
+  //
+  // If the first entry sets the whole MSR, then there is no need to read it.
+  //
+  Value = 0;
+  if (RegisterTableEntry->TestThenWrite || (RegisterTableEntry->ValidBitLength < 64)) {
+    Value = AsmReadMsr64 (RegisterTableEntry->Index);
+  }
+
+  WriteNeeded = FALSE;
+  for (Index = 0; Index < Count; Index++) {
+    Entry = &RegisterTableEntry[Index];
+    if (Entry->ValidBitLength >= 64) {
+      if (Entry->TestThenWrite && (Value == Entry->Value)) {
+        continue;
+      }
+      Value = Entry->Value;
+    } else {
+      if (Entry->TestThenWrite &&
+          (BitFieldRead64 (Value, Entry->ValidBitStart, Entry->ValidBitStart + Entry->ValidBitLength - 1) == Entry->Value)) {
+        continue;
+      }
+      Value = BitFieldWrite64 (Value, Entry->ValidBitStart, Entry->ValidBitStart + Entry->ValidBitLength - 1, Entry->Value);
+    }
+    WriteNeeded = TRUE;
+  }
+
+  if (WriteNeeded) {
+    AsmWriteMsr64 (RegisterTableEntry->Index, Value);
+  }
+
+  return Count;
+}
+// MU_CHANGE [END]
+
 /**
   Initialize the CPU registers from a register table.
 
@@ -892,12 +959,8 @@ ProgramProcessorRegister (
   UINTN                     Index;
   UINTN                     Value;
   CPU_REGISTER_TABLE_ENTRY  *RegisterTableEntryHead;
-  volatile UINT32           *SemaphorePtr;
   UINT32                    FirstThread;
-  UINT32                    PackageThreadsCount;
-  UINT32                    CurrentThread;
-  UINTN                     ProcessorIndex;
-  UINTN                     ValidThreadCount;
+  UINT32                    ValidThreadCount;
   UINT32                    *ValidCoreCountPerPackage;
   EFI_STATUS                Status;
   UINT64                    CurrentValue;
@@ -946,43 +1009,9 @@ ProgramProcessorRegister (
     // The specified register is Model Specific Register
     //
     case Msr:
-      if (RegisterTableEntry->TestThenWrite) {
-        Value = (UINTN)AsmReadMsr64 (RegisterTableEntry->Index);
-        if (RegisterTableEntry->ValidBitLength >= 64) {
-          if (Value == RegisterTableEntry->Value) {
-            break;
-          }
-        } else {
-          CurrentValue = BitFieldRead64 (
-                           Value,
-                           RegisterTableEntry->ValidBitStart,
-                           RegisterTableEntry->ValidBitStart + RegisterTableEntry->ValidBitLength - 1
-                           );
-          if (CurrentValue == RegisterTableEntry->Value) {
-            break;
-          }
-        }
-      }
-
-      if (RegisterTableEntry->ValidBitLength >= 64) {
-        //
-        // If length is not less than 64 bits, then directly write without reading
-        //
-        AsmWriteMsr64 (
-          RegisterTableEntry->Index,
-          RegisterTableEntry->Value
-          );
-      } else {
-        //
-        // Set the bit section according to bit start and length
-        //
-        AsmMsrBitFieldWrite64 (
-          RegisterTableEntry->Index,
-          RegisterTableEntry->ValidBitStart,
-          RegisterTableEntry->ValidBitStart + RegisterTableEntry->ValidBitLength - 1,
-          RegisterTableEntry->Value
-          );
-      }
+      // MU_CHANGE [BEGIN] - Program the consecutive writes of the same MSR at once.
+      Index += ProgramMsrEntries (RegisterTableEntry, RegisterTable->TableLength - Index) - 1;
+      // MU_CHANGE [END]
       break;
     //
     // MemoryMapped operations
@@ -1012,84 +1041,35 @@ ProgramProcessorRegister (
       break;
 
     case Semaphore:
-      // Semaphore works logic like below:
-      //
-      //  V(x) = LibReleaseSemaphore (Semaphore[FirstThread + x]);
-      //  P(x) = LibWaitForSemaphore (Semaphore[FirstThread + x]);
-      //
-      //  All threads (T0...Tn) waits in P() line and continues running
-      //  together.
-      //
+      // MU_CHANGE [BEGIN] - Lock-free core and package barriers.
       //
-      //  T0             T1            ...           Tn
-      //
-      //  V(0...n)       V(0...n)      ...           V(0...n)
-      //  n * P(0)       n * P(1)      ...           n * P(n)
+      // All the threads of the core or package wait in the barrier of the
+      // first thread of the core or package, and continue running together
+      // once the last of them reached it.
       //
       switch (RegisterTableEntry->Value) {
       case CoreDepType:
-        SemaphorePtr = CpuFlags->CoreSemaphoreCount;
         //
         // Get Offset info for the first thread in the core which current thread belongs to.
         //
         FirstThread = (ApLocation->Package * CpuStatus->MaxCoreCount + ApLocation->Core) * CpuStatus->MaxThreadCount;
-        CurrentThread = FirstThread + ApLocation->Thread;
-        //
-        // First Notify all threads in current Core that this thread has ready.
-        //
-        for (ProcessorIndex = 0; ProcessorIndex < CpuStatus->MaxThreadCount; ProcessorIndex ++) {
-          LibReleaseSemaphore ((UINT32 *) &SemaphorePtr[FirstThread + ProcessorIndex]);
-        }
-        //
-        // Second, check whether all valid threads in current core have ready.
-        //
-        for (ProcessorIndex = 0; ProcessorIndex < CpuStatus->MaxThreadCount; ProcessorIndex ++) {
-          LibWaitForSemaphore (&SemaphorePtr[CurrentThread]);
-        }
+        LibWaitForBarrier (&CpuFlags->CoreSemaphoreCount[FirstThread], CpuStatus->MaxThreadCount);
         break;
 
       case PackageDepType:
-        SemaphorePtr = CpuFlags->PackageSemaphoreCount;
         ValidCoreCountPerPackage = (UINT32 *)(UINTN)CpuStatus->ValidCoreCountPerPackage;
         //
         // Get Offset info for the first thread in the package which current thread belongs to.
         //
         FirstThread = ApLocation->Package * CpuStatus->MaxCoreCount * CpuStatus->MaxThreadCount;
         //
-        // Get the possible threads count for current package.
-        //
-        PackageThreadsCount = CpuStatus->MaxThreadCount * CpuStatus->MaxCoreCount;
-        CurrentThread = FirstThread + CpuStatus->MaxThreadCount * ApLocation->Core + ApLocation->Thread;
-        //
-        // Get the valid thread count for current package.
+        // Different packages may have different valid cores in them, only the
+        // valid threads of the current package reach its barrier.
         //
         ValidThreadCount = CpuStatus->MaxThreadCount * ValidCoreCountPerPackage[ApLocation->Package];
-
-        //
-        // Different packages may have different valid cores in them. If driver maintail clearly
-        // cores number in different packages, the logic will be much complicated.
-        // Here driver just simply records the max core number in all packages and use it as expect
-        // core number for all packages.
-        // In below two steps logic, first current thread will Release semaphore for each thread
-        // in current package. Maybe some threads are not valid in this package, but driver don't
-        // care. Second, driver will let current thread wait semaphore for all valid threads in
-        // current package. Because only the valid threads will do release semaphore for this
-        // thread, driver here only need to wait the valid thread count.
-        //
-
-        //
-        // First Notify ALL THREADS in current package that this thread has ready.
-        //
-        for (ProcessorIndex = 0; ProcessorIndex < PackageThreadsCount ; ProcessorIndex ++) {
-          LibReleaseSemaphore ((UINT32 *) &SemaphorePtr[FirstThread + ProcessorIndex]);
-        }
-        //
-        // Second, check whether VALID THREADS (not all threads) in current package have ready.
-        //
-        for (ProcessorIndex = 0; ProcessorIndex < ValidThreadCount; ProcessorIndex ++) {
-          LibWaitForSemaphore (&SemaphorePtr[CurrentThread]);
-        }
+        LibWaitForBarrier (&CpuFlags->PackageSemaphoreCount[FirstThread], ValidThreadCount);
         break;
+      // MU_CHANGE [END]
 
       default:
         break;
@@ -59,10 +59,21 @@ typedef struct {
 //
 typedef struct {
   volatile UINTN           MemoryMappedLock;        // Spinlock used to program mmio
-  volatile UINT32          *CoreSemaphoreCount;     // Semaphore containers used to program Core semaphore.
-  volatile UINT32          *PackageSemaphoreCount;  // Semaphore containers used to program Package semaphore.
+  // MU_CHANGE [BEGIN] - Lock-free core and package barriers.
+  volatile UINT32          *CoreSemaphoreCount;     // Barriers used to program Core semaphore, indexed by the first thread of the core.
+  volatile UINT32          *PackageSemaphoreCount;  // Barriers used to program Package semaphore, indexed by the first thread of the package.
+  // MU_CHANGE [END]
 } PROGRAM_CPU_REGISTER_FLAGS;
 
+// MU_CHANGE [BEGIN] - Lock-free core and package barriers.
+//
+// A barrier counts the threads that reached it in its low 16 bits, and its
+// generation in the high 16 bits.
+//
+#define CPU_BARRIER_COUNT_MASK       0xFFFF
+#define CPU_BARRIER_GENERATION_MASK  0xFFFF0000
+// MU_CHANGE [END]
+
 typedef union {
   EFI_MP_SERVICES_PROTOCOL  *Protocol;
   EFI_PEI_MP_SERVICES_PPI   *Ppi;
@@ -0,0 +1,417 @@
+/** @file
+  MP work queue driver.
+
+  Produces EDKII_MP_WORK_QUEUE_PROTOCOL on top of EFI_MP_SERVICES_PROTOCOL.
+  The jobs of a batch are split evenly into one queue per processor. Every
+  processor runs the jobs of its own queue, and then takes half of the jobs
+  left in another processor's queue, until no queue has any job left.
+
+  A queue is a range of job indices packed into one 64-bit word, so the owner
+  and the other processors update it with a single compare exchange and no
+  lock is needed.
+
+  The APs are started with StartupAllAPs(), so they are woken up the way
+  MpInitLib does it for PcdCpuApLoopMode, with MWAIT when it is supported.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <Protocol/MpService.h>
+#include <Protocol/MpWorkQueue.h>
+
+//
+// Each queue gets its own cache line so that processors working on their
+// own queue do not share lines.
+//
+#define MP_WORK_QUEUE_ALIGNMENT  64
+
+#define MP_WORK_QUEUE_RANGE(Head, Tail)  (LShiftU64 ((UINT64)(Tail), 32) | (UINT32)(Head))
+#define MP_WORK_QUEUE_HEAD(Range)        ((UINT32)(Range))
+#define MP_WORK_QUEUE_TAIL(Range)        ((UINT32)RShiftU64 ((Range), 32))
+
+///
+/// The jobs [Head, Tail) of one processor, packed as MP_WORK_QUEUE_RANGE().
+///
+typedef struct {
+  volatile UINT64    Range;
+  UINT8              Reserved[MP_WORK_QUEUE_ALIGNMENT - sizeof (UINT64)];
+} MP_WORK_QUEUE;
+
+EFI_STATUS
+EFIAPI
+MpWorkQueueSubmitJobs (
+  IN CONST EDKII_MP_WORK_QUEUE_PROTOCOL  *This,
+  IN       EDKII_MP_WORK_QUEUE_JOB       Job,
+  IN       VOID                          *Context OPTIONAL,
+  IN       UINTN                         JobCount,
+  IN       EFI_EVENT                     CompletionEvent OPTIONAL
+  );
+
+EDKII_MP_WORK_QUEUE_PROTOCOL  mMpWorkQueue = {
+  MpWorkQueueSubmitJobs
+};
+
+EFI_MP_SERVICES_PROTOCOL      *mMpServices;
+UINTN                         mProcessorCount;
+MP_WORK_QUEUE                 *mQueues;
+
+EDKII_MP_WORK_QUEUE_JOB       mJob;
+VOID                          *mJobContext;
+volatile BOOLEAN              mBatchInProgress;
+EFI_EVENT                     mCompletionEvent;
+EFI_EVENT                     mApsDoneEvent;
+EFI_EVENT                     mApsDoneNotifyEvent;
+
+/**
+  Take the next job from a processor's own queue.
+
+  @param[in]  Queue     The queue of the calling processor.
+  @param[out] JobIndex  The job taken.
+
+  @retval TRUE    A job was taken.
+  @retval FALSE   The queue is empty.
+
+**/
+BOOLEAN
+MpWorkQueuePop (
+  IN  MP_WORK_QUEUE  *Queue,
+  OUT UINT32         *JobIndex
+  )
+{
+  UINT64  Range;
+  UINT32  Head;
+  UINT32  Tail;
+
+  do {
+    Range = Queue->Range;
+    Head  = MP_WORK_QUEUE_HEAD (Range);
+    Tail  = MP_WORK_QUEUE_TAIL (Range);
+    if (Head >= Tail) {
+      return FALSE;
+    }
+  } while (InterlockedCompareExchange64 (
+             (UINT64 *)&Queue->Range,
+             Range,
+             MP_WORK_QUEUE_RANGE (Head + 1, Tail)
+             ) != Range);
+
+  *JobIndex = Head;
+  return TRUE;
+}
+
+/**
+  Move half of the jobs left in another processor's queue to the empty queue
+  of the calling processor.
+
+  @param[in]  ProcessorNumber  The calling processor.
+
+  @retval TRUE    Jobs were moved to the queue of ProcessorNumber.
+  @retval FALSE   No other queue has any job left.
+
+**/
+BOOLEAN
+MpWorkQueueSteal (
+  IN UINTN  ProcessorNumber
+  )
+{
+  UINTN   Offset;
+  UINTN   Victim;
+  UINT64  Range;
+  UINT64  OwnRange;
+  UINT32  Head;
+  UINT32  Middle;
+  UINT32  Tail;
+
+  for (Offset = 1; Offset < mProcessorCount; Offset++) {
+    Victim = (ProcessorNumber + Offset) % mProcessorCount;
+    do {
+      Range = mQueues[Victim].Range;
+      Head  = MP_WORK_QUEUE_HEAD (Range);
+      Tail  = MP_WORK_QUEUE_TAIL (Range);
+      if (Head >= Tail) {
+        break;
+      }
+
+      Middle = Head + (Tail - Head) / 2;
+    } while (InterlockedCompareExchange64 (
+               (UINT64 *)&mQueues[Victim].Range,
+               Range,
+               MP_WORK_QUEUE_RANGE (Head, Middle)
+               ) != Range);
+
+    if (Head < Tail) {
+      //
+      // The own queue is empty, so nobody else changes it. The compare
+      // exchange only makes the 64-bit store atomic on IA32.
+      //
+      do {
+        OwnRange = mQueues[ProcessorNumber].Range;
+      } while (InterlockedCompareExchange64 (
+                 (UINT64 *)&mQueues[ProcessorNumber].Range,
+                 OwnRange,
+                 MP_WORK_QUEUE_RANGE (Middle, Tail)
+                 ) != OwnRange);
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Run jobs until no queue has any job left. Runs on the BSP and the APs.
+
+  @param[in]  Buffer  Not used.
+
+**/
+VOID
+EFIAPI
+MpWorkQueueWorker (
+  IN VOID  *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       ProcessorNumber;
+  UINT32      JobIndex;
+
+  Status = mMpServices->WhoAmI (mMpServices, &ProcessorNumber);
+  if (EFI_ERROR (Status) || (ProcessorNumber >= mProcessorCount)) {
+    return;
+  }
+
+  do {
+    while (MpWorkQueuePop (&mQueues[ProcessorNumber], &JobIndex)) {
+      mJob (JobIndex, mJobContext);
+    }
+  } while (MpWorkQueueSteal (ProcessorNumber));
+}
+
+/**
+  Notify function of mApsDoneNotifyEvent. Ends a non-blocking batch.
+
+  @param[in]  Event    The event signaled by the MP services.
+  @param[in]  Context  Not used.
+
+**/
+VOID
+EFIAPI
+MpWorkQueueApsDone (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  mBatchInProgress = FALSE;
+  gBS->SignalEvent (mCompletionEvent);
+}
+
+/**
+  Run JobCount jobs on all enabled processors.
+
+  Each job runs exactly once, on one processor, in no defined order.
+
+  If CompletionEvent is NULL, the BSP takes part in the work and the call
+  returns once every job is done. Otherwise the jobs run on the APs only, the
+  call returns right away, and CompletionEvent is signaled once every job is
+  done. If there is no enabled AP, the BSP runs all the jobs and signals
+  CompletionEvent before returning.
+
+  Only one batch may be in progress at a time.
+
+  @param[in]  This              The EDKII_MP_WORK_QUEUE_PROTOCOL instance.
+  @param[in]  Job               The procedure to run for each job.
+  @param[in]  Context           Passed to every call to Job.
+  @param[in]  JobCount          The number of jobs.
+  @param[in]  CompletionEvent   An optional event to signal once all the jobs
+                                are done, for non-blocking mode.
+
+  @retval EFI_SUCCESS           In blocking mode, all the jobs are done. In
+                                non-blocking mode, the jobs were started.
+  @retval EFI_INVALID_PARAMETER Job is NULL, or JobCount is larger than
+                                MAX_UINT32.
+  @retval EFI_NOT_READY         A batch or another MP services call is still
+                                in progress.
+  @retval EFI_UNSUPPORTED       Blocking mode was requested at TPL_NOTIFY or
+                                above, where the MP services cannot detect
+                                that the APs are done.
+  @retval EFI_DEVICE_ERROR      The caller is not the BSP.
+  @retval Others                The error returned by StartupAllAPs().
+**/
+EFI_STATUS
+EFIAPI
+MpWorkQueueSubmitJobs (
+  IN CONST EDKII_MP_WORK_QUEUE_PROTOCOL  *This,
+  IN       EDKII_MP_WORK_QUEUE_JOB       Job,
+  IN       VOID                          *Context OPTIONAL,
+  IN       UINTN                         JobCount,
+  IN       EFI_EVENT                     CompletionEvent OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       ProcessorNumber;
+  UINTN       Start;
+  UINTN       End;
+
+  if ((Job == NULL) || (JobCount > MAX_UINT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((CompletionEvent == NULL) && (EfiGetCurrentTpl () >= TPL_NOTIFY)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = mMpServices->WhoAmI (mMpServices, &ProcessorNumber);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (mBatchInProgress) {
+    return EFI_NOT_READY;
+  }
+
+  if (JobCount == 0) {
+    if (CompletionEvent != NULL) {
+      gBS->SignalEvent (CompletionEvent);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Split the jobs evenly; the queues of disabled processors are emptied by
+  // the others.
+  //
+  for (Index = 0; Index < mProcessorCount; Index++) {
+    Start                = (UINTN)DivU64x64Remainder (MultU64x64 (JobCount, Index), mProcessorCount, NULL);
+    End                  = (UINTN)DivU64x64Remainder (MultU64x64 (JobCount, Index + 1), mProcessorCount, NULL);
+    mQueues[Index].Range = MP_WORK_QUEUE_RANGE (Start, End);
+  }
+
+  mJob             = Job;
+  mJobContext      = Context;
+  mCompletionEvent = CompletionEvent;
+  mBatchInProgress = TRUE;
+
+  Status = mMpServices->StartupAllAPs (
+                          mMpServices,
+                          MpWorkQueueWorker,
+                          FALSE,
+                          (CompletionEvent == NULL) ? mApsDoneEvent : mApsDoneNotifyEvent,
+                          0,
+                          NULL,
+                          NULL
+                          );
+  if (Status == EFI_NOT_STARTED) {
+    //
+    // No enabled AP, so the BSP runs everything.
+    //
+    MpWorkQueueWorker (NULL);
+    mBatchInProgress = FALSE;
+    if (CompletionEvent != NULL) {
+      gBS->SignalEvent (CompletionEvent);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (Status)) {
+    mBatchInProgress = FALSE;
+    return Status;
+  }
+
+  if (CompletionEvent != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  MpWorkQueueWorker (NULL);
+  while (gBS->CheckEvent (mApsDoneEvent) == EFI_NOT_READY) {
+    CpuPause ();
+  }
+
+  mBatchInProgress = FALSE;
+  return EFI_SUCCESS;
+}
+
+/**
+  The entry point of the MP work queue driver.
+
+  @param[in] ImageHandle  The firmware allocated handle for the EFI image.
+  @param[in] SystemTable  A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS     The protocol was installed.
+  @retval Others          The driver could not be initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+MpWorkQueueDxeEntryPoint (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       EnabledProcessorCount;
+  EFI_HANDLE  Handle;
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&mMpServices);
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = mMpServices->GetNumberOfProcessors (mMpServices, &mProcessorCount, &EnabledProcessorCount);
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mQueues = AllocateAlignedPages (
+              EFI_SIZE_TO_PAGES (mProcessorCount * sizeof (MP_WORK_QUEUE)),
+              MP_WORK_QUEUE_ALIGNMENT
+              );
+  if (mQueues == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (mQueues, mProcessorCount * sizeof (MP_WORK_QUEUE));
+
+  Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &mApsDoneEvent);
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  MpWorkQueueApsDone,
+                  NULL,
+                  &mApsDoneNotifyEvent
+                  );
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  DEBUG ((DEBUG_INFO, "%a: %d processors, %d enabled\n", __FUNCTION__, mProcessorCount, EnabledProcessorCount));
+
+  Handle = NULL;
+  return gBS->InstallMultipleProtocolInterfaces (
+                &Handle,
+                &gEdkiiMpWorkQueueProtocolGuid,
+                &mMpWorkQueue,
+                NULL
+                );
+}
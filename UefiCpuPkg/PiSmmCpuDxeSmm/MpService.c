@@ -148,6 +148,35 @@ ReleaseAllAPs (
   }
 }
 
+// MU_CHANGE [BEGIN] - Shared by BSPHandler and InternalSmmReleaseAps
+/**
+  Wait until all APs which checked in for this SMI have their Present flag set.
+
+  @param   ApCount        The number of APs which checked in.
+
+**/
+VOID
+WaitForApsPresent (
+  IN      UINTN                     ApCount
+  )
+{
+  UINTN                             Index;
+  UINTN                             PresentCount;
+
+  while (TRUE) {
+    PresentCount = 0;
+    for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
+      if (*(mSmmMpSyncData->CpuData[Index].Present)) {
+        PresentCount ++;
+      }
+    }
+    if (PresentCount > ApCount) {
+      break;
+    }
+  }
+}
+// MU_CHANGE [END]
+
 /**
   Checks if all CPUs (with certain exceptions) have checked in for this SMI run
 
@@ -456,14 +485,19 @@ BSPHandler (
   IN      SMM_CPU_SYNC_MODE         SyncMode
   )
 {
-  UINTN                             Index;
   MTRR_SETTINGS                     Mtrrs;
   UINTN                             ApCount;
   BOOLEAN                           ClearTopLevelSmiResult;
-  UINTN                             PresentCount;
+  UINT64                            Timer;         // MU_CHANGE
+  UINT64                            ArrivalTicks;  // MU_CHANGE
+  UINT64                            ExitTicks;     // MU_CHANGE
 
   ASSERT (CpuIndex == mSmmMpSyncData->BspIndex);
   ApCount = 0;
+  // MU_CHANGE [BEGIN] - Time the rendezvous for SmmProfile
+  Timer        = 0;
+  ArrivalTicks = 0;
+  // MU_CHANGE [END]
 
   //
   // Flag BSP's presence
@@ -497,6 +531,11 @@ BSPHandler (
   // If Traditional Sync Mode or need to configure MTRRs: gather all available APs.
   //
   if (SyncMode == SmmCpuSyncModeTradition || SmmCpuFeaturesNeedConfigureMtrrs()) {
+    // MU_CHANGE [BEGIN] - Time the rendezvous for SmmProfile
+    if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+      Timer = StartSyncTimer ();
+    }
+    // MU_CHANGE [END]
 
     //
     // Wait for APs to arrive
@@ -514,6 +553,12 @@ BSPHandler (
     //
     WaitForAllAPs (ApCount);
 
+    // MU_CHANGE [BEGIN] - Time the rendezvous for SmmProfile
+    if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+      ArrivalTicks = GetSyncTimerElapsed (Timer);
+    }
+    // MU_CHANGE [END]
+
     if (SmmCpuFeaturesNeedConfigureMtrrs()) {
       //
       // Signal all APs it's time for backup MTRRs
@@ -579,12 +624,21 @@ BSPHandler (
   //
   PerformRemainingTasks ();
 
+  // MU_CHANGE [BEGIN] - Time the rendezvous for SmmProfile
+  if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+    Timer = StartSyncTimer ();
+  }
+  // MU_CHANGE [END]
+
   //
   // If Relaxed-AP Sync Mode: gather all available APs after BSP SMM handlers are done, and
   // make those APs to exit SMI synchronously. APs which arrive later will be excluded and
   // will run through freely.
+  // MU_CHANGE - If an SMI handler already released the APs, they have left SMM and the
+  // counter is already locked, so there is nobody left to gather.
   //
-  if (SyncMode != SmmCpuSyncModeTradition && !SmmCpuFeaturesNeedConfigureMtrrs()) {
+  if (SyncMode != SmmCpuSyncModeTradition && !SmmCpuFeaturesNeedConfigureMtrrs() &&
+      !mSmmMpSyncData->ApsReleased) {   // MU_CHANGE
 
     //
     // Lock the counter down and retrieve the number of APs
@@ -594,17 +648,7 @@ BSPHandler (
     //
     // Make sure all APs have their Present flag set
     //
-    while (TRUE) {
-      PresentCount = 0;
-      for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
-        if (*(mSmmMpSyncData->CpuData[Index].Present)) {
-          PresentCount ++;
-        }
-      }
-      if (PresentCount > ApCount) {
-        break;
-      }
-    }
+    WaitForApsPresent (ApCount);  // MU_CHANGE
   }
 
   //
@@ -668,6 +712,13 @@ BSPHandler (
   //
   ResetTokens ();
 
+  // MU_CHANGE [BEGIN] - Time the rendezvous for SmmProfile
+  if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+    ExitTicks = GetSyncTimerElapsed (Timer);
+    SmmProfileRecordRendezvous (ArrivalTicks, ExitTicks, mSmmMpSyncData->ApsReleased);
+  }
+  // MU_CHANGE [END]
+
   //
   // Reset BspIndex to -1, meaning BSP has not been elected.
   //
@@ -678,10 +729,84 @@ BSPHandler (
   //
   // Allow APs to check in from this point on
   //
+  mSmmMpSyncData->ApsReleased = FALSE;  // MU_CHANGE
   *mSmmMpSyncData->Counter = 0;
   *mSmmMpSyncData->AllCpusInSync = FALSE;
 }
 
+// MU_CHANGE [BEGIN] - Let SMI handlers release the APs early in relaxed-AP sync mode
+/**
+  Release the APs of the current SMI before the BSP has finished the SMI
+  handlers. Only supported in the relaxed-AP sync mode.
+
+  The APs run the same exit handshake as at the end of BSPHandler(). The
+  counter stays locked until BSPHandler() is done, so APs which arrive later
+  run through freely.
+
+  @retval EFI_SUCCESS           The APs have left SMM.
+  @retval EFI_ALREADY_STARTED   The APs were already released during this SMI.
+  @retval EFI_NOT_READY         Not called from an SMI on the BSP.
+  @retval EFI_UNSUPPORTED       The APs have to stay until the end of the SMI.
+**/
+EFI_STATUS
+InternalSmmReleaseAps (
+  VOID
+  )
+{
+  UINTN  ApCount;
+
+  if ((mSmmMpSyncData->EffectiveSyncMode != SmmCpuSyncModeRelaxedAp) ||
+      SmmCpuFeaturesNeedConfigureMtrrs ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!(*mSmmMpSyncData->InsideSmm) ||
+      (mSmmMpSyncData->BspIndex != gSmmCpuPrivate->SmmCoreEntryContext.CurrentlyExecutingCpu)) {
+    return EFI_NOT_READY;
+  }
+
+  if (mSmmMpSyncData->ApsReleased) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  //
+  // Make sure all APs have completed their pending none-block tasks
+  //
+  WaitForAllAPsNotBusy (TRUE);
+
+  //
+  // Lock the counter down and retrieve the number of APs
+  //
+  *mSmmMpSyncData->AllCpusInSync = TRUE;
+  ApCount = LockdownSemaphore (mSmmMpSyncData->Counter) - 1;
+  WaitForApsPresent (ApCount);
+
+  //
+  // Notify all APs to exit. InsideSmm stays TRUE for the BSP.
+  //
+  mSmmMpSyncData->ApsReleased = TRUE;
+  ReleaseAllAPs ();
+
+  //
+  // Wait for all APs to get ready to reset their states
+  //
+  WaitForAllAPs (ApCount);
+
+  //
+  // Signal APs to Reset states/semaphore for this processor
+  //
+  ReleaseAllAPs ();
+
+  //
+  // Gather APs to exit SMM. Note the Present flag is cleared by now but
+  // WaitForAllAps does not depend on the Present flag.
+  //
+  WaitForAllAPs (ApCount);
+
+  return EFI_SUCCESS;
+}
+// MU_CHANGE [END]
+
 /**
   SMI handler for AP.
 
@@ -813,7 +938,7 @@ APHandler (
     //
     // Check if BSP wants to exit SMM
     //
-    if (!(*mSmmMpSyncData->InsideSmm)) {
+    if (!(*mSmmMpSyncData->InsideSmm) || mSmmMpSyncData->ApsReleased) {   // MU_CHANGE
       break;
     }
 
@@ -1623,7 +1748,7 @@ SmiRendezvous (
       //
       // Wait for BSP's signal to finish SMI
       //
-      while (*mSmmMpSyncData->AllCpusInSync) {
+      while (*mSmmMpSyncData->AllCpusInSync && !mSmmMpSyncData->ApsReleased) {   // MU_CHANGE
         CpuPause ();
       }
       goto Exit;
@@ -1715,8 +1840,9 @@ SmiRendezvous (
 
     //
     // Wait for BSP's signal to exit SMI
+    // MU_CHANGE - APs released early by an SMI handler do not wait for the BSP.
     //
-    while (*mSmmMpSyncData->AllCpusInSync) {
+    while (*mSmmMpSyncData->AllCpusInSync && !mSmmMpSyncData->ApsReleased) {
       CpuPause ();
     }
   }
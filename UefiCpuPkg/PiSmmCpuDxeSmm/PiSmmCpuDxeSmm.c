@@ -121,6 +121,12 @@ SPIN_LOCK                *mConfigSmmCodeAccessCheckLock = NULL;
 //
 EFI_SMRAM_DESCRIPTOR     *mSmmCpuSmramRanges;
 UINTN                    mSmmCpuSmramRangeCount;
+
+//
+// MU_CHANGE - Page table pages retired by large page promotion.
+//
+VOID                     *mPageTableFreePageList = NULL;
+
 //
 // MSCHANGE [BEGIN] - Add flag to enable "test mode" for the SMM protections.
 //                    NOTE: "Test mode" will only be enabled in DEBUG builds.
@@ -1062,6 +1068,16 @@ PiCpuSmmEntry (
                     );
   ASSERT_EFI_ERROR (Status);
 
+  // MU_CHANGE [BEGIN] - Let SMI handlers release the APs early in relaxed-AP sync mode
+  Status = gSmst->SmmInstallProtocolInterface (
+                    &mSmmCpuHandle,
+                    &gEdkiiSmmCpuApReleaseProtocolGuid,
+                    EFI_NATIVE_INTERFACE,
+                    &mSmmCpuApRelease
+                    );
+  ASSERT_EFI_ERROR (Status);
+  // MU_CHANGE [END]
+
   //
   // Expose address of CPU Hot Plug Data structure if CPU hot plug is supported.
   //
@@ -1343,6 +1359,14 @@ AllocatePageTableMemory (
 {
   VOID  *Buffer;
 
+  // MU_CHANGE [BEGIN] - Reuse page table pages retired by large page promotion
+  if ((Pages == 1) && (mPageTableFreePageList != NULL)) {
+    Buffer                 = mPageTableFreePageList;
+    mPageTableFreePageList = *(VOID **)Buffer;
+    return Buffer;
+  }
+  // MU_CHANGE [END]
+
   Buffer = SmmCpuFeaturesAllocatePageTableMemory (Pages);
   if (Buffer != NULL) {
     return Buffer;
@@ -1350,6 +1374,27 @@ AllocatePageTableMemory (
   return AllocatePages (Pages);
 }
 
+// MU_CHANGE [BEGIN] - Promote split pages back to large pages
+/**
+  Keep a page table page that is no longer referenced for reuse by
+  AllocatePageTableMemory().
+
+  The page may come from SmmCpuFeaturesAllocatePageTableMemory(), which has
+  no matching free function, so it is kept on a list instead of being freed.
+
+  @param[in]  Page      The page table page.
+**/
+VOID
+EFIAPI
+ReleasePageTableMemory (
+  IN VOID    *Page
+  )
+{
+  *(VOID **)Page         = mPageTableFreePageList;
+  mPageTableFreePageList = Page;
+}
+// MU_CHANGE [END]
+
 /**
   Allocate pages for code.
 
@@ -22,6 +22,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SmmMemoryAttribute.h>
 #include <Protocol/MmMp.h>
 #include <Protocol/SmmExceptionTestProtocol.h> // MS_CHANGE
+#include <Protocol/SmmCpuApRelease.h>          // MU_CHANGE
 
 #include <Guid/AcpiS3Context.h>
 #include <Guid/MemoryAttributesTable.h>
@@ -50,6 +51,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/SmmCpuFeaturesLib.h>
 #include <Library/PeCoffGetEntryPointLib.h>
 #include <Library/RegisterCpuFeaturesLib.h>
+#include <Library/CpuPageTableLib.h>      // MU_CHANGE
 
 #include <AcpiCpuData.h>
 #include <CpuHotPlugData.h>
@@ -264,6 +266,7 @@ extern UINTN                  mMaxNumberOfCpus;
 extern UINTN                  mNumberOfCpus;
 extern EFI_SMM_CPU_PROTOCOL   mSmmCpu;
 extern EFI_MM_MP_PROTOCOL     mSmmMp;
+extern EDKII_SMM_CPU_AP_RELEASE_PROTOCOL  mSmmCpuApRelease;  // MU_CHANGE
 
 ///
 /// The mode of the CPU at the time an SMI occurs
@@ -388,6 +391,7 @@ X86_ASSEMBLY_PATCH_LABEL            gPatchSmmCr4;
 X86_ASSEMBLY_PATCH_LABEL            gPatchSmmInitStack;
 X86_ASSEMBLY_PATCH_LABEL            mPatchCetSupported;
 extern BOOLEAN                      mCetSupported;
+extern BOOLEAN                      mIsReadOnlyPageTable;   // MU_CHANGE
 
 /**
   Semaphore operation for all processor relocate SMMBase.
@@ -432,6 +436,7 @@ typedef struct {
   volatile BOOLEAN              *CandidateBsp;
   EFI_AP_PROCEDURE              StartupProcedure;
   VOID                          *StartupProcArgs;
+  volatile BOOLEAN              ApsReleased;       // MU_CHANGE - APs already left this SMI
 } SMM_DISPATCHER_MP_SYNC_DATA;
 
 #define SMM_PSD_OFFSET              0xfb00
@@ -549,6 +554,36 @@ IsSyncTimerTimeout (
   IN      UINT64                    Timer
   );
 
+// MU_CHANGE [BEGIN] - Rendezvous timing and early AP release
+/**
+  Get the ticks elapsed since the SMM AP Sync timer was started.
+
+  @param Timer  The start timer from the begin.
+
+  @return The number of performance counter ticks since Timer.
+
+**/
+UINT64
+EFIAPI
+GetSyncTimerElapsed (
+  IN      UINT64                    Timer
+  );
+
+/**
+  Release the APs of the current SMI before the BSP has finished the SMI
+  handlers. Only supported in the relaxed-AP sync mode.
+
+  @retval EFI_SUCCESS           The APs have left SMM.
+  @retval EFI_ALREADY_STARTED   The APs were already released during this SMI.
+  @retval EFI_NOT_READY         Not called from an SMI on the BSP.
+  @retval EFI_UNSUPPORTED       The APs have to stay until the end of the SMI.
+**/
+EFI_STATUS
+InternalSmmReleaseAps (
+  VOID
+  );
+// MU_CHANGE [END]
+
 /**
   Initialize IDT for SMM Stack Guard.
 
@@ -1038,6 +1073,20 @@ AllocatePageTableMemory (
   IN UINTN           Pages
   );
 
+// MU_CHANGE [BEGIN] - Promote split pages back to large pages
+/**
+  Keep a page table page that is no longer referenced for reuse by
+  AllocatePageTableMemory().
+
+  @param[in]  Page      The page table page.
+**/
+VOID
+EFIAPI
+ReleasePageTableMemory (
+  IN VOID    *Page
+  );
+// MU_CHANGE [END]
+
 /**
   Allocate pages for code.
 
@@ -26,6 +26,12 @@ UINTN                             mGcdMemNumberOfDesc = 0;
 
 EFI_MEMORY_ATTRIBUTES_TABLE  *mUefiMemoryAttributesTable = NULL;
 
+//
+// MU_CHANGE - Set once SetPageTableAttributes() starts marking the page table
+//             read-only. The layout of the page table is left alone from then on.
+//
+BOOLEAN                      mIsReadOnlyPageTable = FALSE;
+
 PAGE_ATTRIBUTE_TABLE mPageAttributeTable[] = {
   {Page4K,  SIZE_4KB, PAGING_4K_ADDRESS_MASK_64},
   {Page2M,  SIZE_2MB, PAGING_2M_ADDRESS_MASK_64},
@@ -389,6 +395,64 @@ SplitPage (
   }
 }
 
+// MU_CHANGE [BEGIN] - Promote split pages back to large pages
+/**
+  Merge the page table entries around a range whose attributes just changed
+  back into large pages, where all the small pages are identical again.
+
+  The page table is only changed this way while SMM owns all of it. With the
+  on-demand page table used when access to non-SMRAM memory is not restricted,
+  or once the page table is read-only, the layout is left alone.
+
+  @param[in]  BaseAddress       The start address of the range.
+  @param[in]  Length            The length of the range.
+
+  @retval TRUE    Some entries were merged.
+  @retval FALSE   The page table was not modified.
+**/
+STATIC
+BOOLEAN
+CoalescePageTable (
+  IN  PHYSICAL_ADDRESS                  BaseAddress,
+  IN  UINT64                            Length
+  )
+{
+  CPU_PAGE_TABLE_PAGING_MODE  PagingMode;
+  IA32_CR4                    Cr4;
+  BOOLEAN                     IsModified;
+
+  if (!IsRestrictedMemoryAccess () ||
+      FeaturePcdGet (PcdCpuSmmProfileEnable) ||
+      mIsReadOnlyPageTable) {
+    return FALSE;
+  }
+
+  if (sizeof (UINTN) == sizeof (UINT32)) {
+    PagingMode = PagingPae;
+  } else {
+    Cr4.UintN  = AsmReadCr4 ();
+    PagingMode = (Cr4.Bits.LA57 == 1) ? Paging5Level : Paging4Level;
+  }
+
+  //
+  // Only 2MB pages are rebuilt. 1GB page support is only tracked by the X64
+  // page table code.
+  //
+  IsModified = FALSE;
+  PageTableCoalesce (
+    GetPageTableBase (),
+    PagingMode,
+    FALSE,
+    mAddressEncMask,
+    BaseAddress,
+    Length,
+    ReleasePageTableMemory,
+    &IsModified
+    );
+  return IsModified;
+}
+// MU_CHANGE [END]
+
 /**
   This function modifies the page attributes for the memory region specified by BaseAddress and
   Length from their current attributes to the attributes specified by Attributes.
@@ -433,6 +497,9 @@ ConvertMemoryPageAttributes (
   RETURN_STATUS                     Status;
   BOOLEAN                           IsEntryModified;
   EFI_PHYSICAL_ADDRESS              MaximumSupportMemAddress;
+  PHYSICAL_ADDRESS                  OriginalBaseAddress;  // MU_CHANGE
+  UINT64                            OriginalLength;       // MU_CHANGE
+  BOOLEAN                           IsTableModified;      // MU_CHANGE
 
   ASSERT (Attributes != 0);
   ASSERT ((Attributes & ~EFI_MEMORY_ATTRIBUTE_MASK) == 0);
@@ -463,6 +530,11 @@ ConvertMemoryPageAttributes (
   if (IsModified != NULL) {
     *IsModified = FALSE;
   }
+  // MU_CHANGE [BEGIN] - Promote split pages back to large pages
+  OriginalBaseAddress = BaseAddress;
+  OriginalLength      = Length;
+  IsTableModified     = FALSE;
+  // MU_CHANGE [END]
 
   //
   // Below logic is to check 2M/4K page to make sure we do not waste memory.
@@ -477,6 +549,7 @@ ConvertMemoryPageAttributes (
     if (SplitAttribute == PageNone) {
       ConvertPageEntryAttribute (PageEntry, Attributes, IsSet, &IsEntryModified);
       if (IsEntryModified) {
+        IsTableModified = TRUE;   // MU_CHANGE
         if (IsModified != NULL) {
           *IsModified = TRUE;
         }
@@ -504,6 +577,14 @@ ConvertMemoryPageAttributes (
     }
   }
 
+  // MU_CHANGE [BEGIN] - Promote split pages back to large pages
+  if (IsTableModified && CoalescePageTable (OriginalBaseAddress, OriginalLength)) {
+    if (IsModified != NULL) {
+      *IsModified = TRUE;
+    }
+  }
+  // MU_CHANGE [END]
+
   return RETURN_SUCCESS;
 }
 
@@ -24,6 +24,35 @@ EFI_MM_MP_PROTOCOL  mSmmMp  = {
   SmmMpWaitForProcedure
 };
 
+// MU_CHANGE [BEGIN] - Let SMI handlers release the APs early in relaxed-AP sync mode
+///
+/// SMM CPU AP Release Protocol instance
+///
+EDKII_SMM_CPU_AP_RELEASE_PROTOCOL  mSmmCpuApRelease = {
+  SmmCpuReleaseAps
+};
+
+/**
+  Release the APs of the current SMI before the SMI handlers are done.
+
+  @param[in]  This              The EDKII_SMM_CPU_AP_RELEASE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The APs have left SMM.
+  @retval EFI_ALREADY_STARTED   The APs were already released during this SMI.
+  @retval EFI_NOT_READY         The caller is not running in an SMI on the BSP.
+  @retval EFI_UNSUPPORTED       The sync mode is not relaxed-AP, or the APs
+                                have to stay in SMM to restore their MTRRs.
+**/
+EFI_STATUS
+EFIAPI
+SmmCpuReleaseAps (
+  IN CONST EDKII_SMM_CPU_AP_RELEASE_PROTOCOL  *This
+  )
+{
+  return InternalSmmReleaseAps ();
+}
+// MU_CHANGE [END]
+
 /**
   Service to retrieves the number of logical processor in the platform.
 
@@ -908,6 +908,12 @@ InitSmmProfileInternal (
   mSmmProfileBase->TsegSize       = mCpuHotPlugData.SmrrSize;
   mSmmProfileBase->NumSmis        = 0;
   mSmmProfileBase->NumCpus        = gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus;
+  // MU_CHANGE [BEGIN] - Rendezvous timing
+  mSmmProfileBase->RendezvousArrivalTime = 0;
+  mSmmProfileBase->RendezvousExitTime    = 0;
+  mSmmProfileBase->RendezvousMaxTime     = 0;
+  mSmmProfileBase->NumEarlyApReleases    = 0;
+  // MU_CHANGE [END]
 
   if (mBtsSupported) {
     mMsrDsArea = (MSR_DS_AREA_STRUCT **)AllocateZeroPool (sizeof (MSR_DS_AREA_STRUCT *) * mMaxNumberOfCpus);
@@ -1122,6 +1128,45 @@ SmmProfileRecordSmiNum (
   }
 }
 
+// MU_CHANGE [BEGIN] - Rendezvous timing
+/**
+  Add the rendezvous time of one SMI to the SMM profile header.
+
+  @param  ArrivalTicks   Ticks the BSP waited for the APs to arrive.
+  @param  ExitTicks      Ticks the BSP waited for the APs to exit after the
+                         SMI handlers were done.
+  @param  EarlyRelease   TRUE if an SMI handler released the APs early.
+
+**/
+VOID
+SmmProfileRecordRendezvous (
+  IN UINT64   ArrivalTicks,
+  IN UINT64   ExitTicks,
+  IN BOOLEAN  EarlyRelease
+  )
+{
+  UINT64  ArrivalTime;
+  UINT64  ExitTime;
+
+  if (!mSmmProfileStart) {
+    return;
+  }
+
+  ArrivalTime = GetTimeInNanoSecond (ArrivalTicks);
+  ExitTime    = GetTimeInNanoSecond (ExitTicks);
+
+  mSmmProfileBase->RendezvousArrivalTime += ArrivalTime;
+  mSmmProfileBase->RendezvousExitTime    += ExitTime;
+  if (ArrivalTime + ExitTime > mSmmProfileBase->RendezvousMaxTime) {
+    mSmmProfileBase->RendezvousMaxTime = ArrivalTime + ExitTime;
+  }
+
+  if (EarlyRelease) {
+    mSmmProfileBase->NumEarlyApReleases++;
+  }
+}
+// MU_CHANGE [END]
+
 /**
   Initialize processor environment for SMM profile.
 
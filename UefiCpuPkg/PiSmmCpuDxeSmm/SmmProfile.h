@@ -46,6 +46,24 @@ SmmProfileRecordSmiNum (
   VOID
   );
 
+// MU_CHANGE [BEGIN] - Rendezvous timing
+/**
+  Add the rendezvous time of one SMI to the SMM profile header.
+
+  @param  ArrivalTicks   Ticks the BSP waited for the APs to arrive.
+  @param  ExitTicks      Ticks the BSP waited for the APs to exit after the
+                         SMI handlers were done.
+  @param  EarlyRelease   TRUE if an SMI handler released the APs early.
+
+**/
+VOID
+SmmProfileRecordRendezvous (
+  IN UINT64   ArrivalTicks,
+  IN UINT64   ExitTicks,
+  IN BOOLEAN  EarlyRelease
+  );
+// MU_CHANGE [END]
+
 /**
   The Page fault handler to save SMM profile data.
 
@@ -85,6 +85,12 @@ typedef struct {
   UINT64  TsegSize;
   UINT64  NumSmis;
   UINT64  NumCpus;
+  // MU_CHANGE [BEGIN] - Rendezvous timing, in nanoseconds
+  UINT64  RendezvousArrivalTime;
+  UINT64  RendezvousExitTime;
+  UINT64  RendezvousMaxTime;
+  UINT64  NumEarlyApReleases;
+  // MU_CHANGE [END]
 } SMM_PROFILE_HEADER;
 
 typedef struct {
@@ -59,15 +59,18 @@ StartSyncTimer (
 }
 
 
+// MU_CHANGE [BEGIN] - Split the elapsed time out of IsSyncTimerTimeout so SmmProfile can time the rendezvous
 /**
-  Check if the SMM AP Sync timer is timeout.
+  Get the ticks elapsed since the SMM AP Sync timer was started.
 
   @param Timer  The start timer from the begin.
 
+  @return The number of performance counter ticks since Timer.
+
 **/
-BOOLEAN
+UINT64
 EFIAPI
-IsSyncTimerTimeout (
+GetSyncTimerElapsed (
   IN      UINT64                    Timer
   )
 {
@@ -106,5 +109,21 @@ IsSyncTimerTimeout (
     }
   }
 
-  return (BOOLEAN) (Delta >= mTimeoutTicker);
+  return Delta;
+}
+
+/**
+  Check if the SMM AP Sync timer is timeout.
+
+  @param Timer  The start timer from the begin.
+
+**/
+BOOLEAN
+EFIAPI
+IsSyncTimerTimeout (
+  IN      UINT64                    Timer
+  )
+{
+  return (BOOLEAN) (GetSyncTimerElapsed (Timer) >= mTimeoutTicker);
 }
+// MU_CHANGE [END]
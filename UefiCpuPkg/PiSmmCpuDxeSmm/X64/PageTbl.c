@@ -1172,6 +1172,7 @@ SetPageTableAttributes (
   }
 
   DEBUG ((DEBUG_INFO, "SetPageTableAttributes\n"));
+  mIsReadOnlyPageTable = TRUE;    // MU_CHANGE
 
   //
   // Disable write protection, because we need mark page table to be write protected.
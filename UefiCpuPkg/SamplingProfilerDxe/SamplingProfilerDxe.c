@@ -0,0 +1,337 @@
+/** @file
+  Sampling profiler driver.
+
+  Programs the local APIC timer of the BSP in periodic mode and records the
+  instruction pointer interrupted by each timer interrupt. The interrupt
+  handler is registered through the CPU Architectural Protocol, which hooks
+  it into the IDT with CpuExceptionHandlerLib, and does nothing but store
+  the instruction pointer and send the EOI.
+
+  At ReadyToBoot the samples are attributed to the images listed in the
+  EFI_DEBUG_IMAGE_INFO_TABLE and a flat profile is written to the debug
+  output. The samples are also installed as the EDKII_SAMPLING_PROFILE_TABLE
+  configuration table, which keeps growing until ExitBootServices(), so the
+  shell and the applications it runs can be profiled by tools reading it.
+
+  Code running with interrupts disabled, for example at TPL_HIGH_LEVEL, is
+  never sampled; its time is charged to the code that enables interrupts
+  again. The driver leaves the platform alone if the local APIC timer is
+  already in use, since it would take over the timer.
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/LocalApicLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PeCoffGetEntryPointLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <Protocol/Cpu.h>
+
+#include <Guid/DebugImageInfoTable.h>
+#include <Guid/EventGroup.h>
+#include <Guid/SamplingProfile.h>
+
+//
+// Samples per second, and the number of samples kept, enough for about a
+// minute of boot.
+//
+#define SAMPLING_PROFILER_RATE         4000
+#define SAMPLING_PROFILER_MAX_SAMPLES  0x40000
+
+//
+// Interrupt vector of the local APIC timer, outside of the exception and
+// legacy 8259 ranges.
+//
+#define SAMPLING_PROFILER_VECTOR  0x4E
+
+///
+/// Number of samples hitting one image of the debug image info table.
+///
+typedef struct {
+  UINT32    TableIndex;
+  UINT32    SampleCount;
+} SAMPLING_PROFILER_IMAGE_COUNT;
+
+EFI_CPU_ARCH_PROTOCOL         *mCpu;
+EDKII_SAMPLING_PROFILE_TABLE  *mProfile;
+
+/**
+  Local APIC timer interrupt handler, records the interrupted instruction
+  pointer.
+
+  @param[in] InterruptType  The interrupt vector.
+  @param[in] SystemContext  The processor context when the interrupt happened.
+**/
+VOID
+EFIAPI
+SamplingProfilerInterruptHandler (
+  IN EFI_EXCEPTION_TYPE  InterruptType,
+  IN EFI_SYSTEM_CONTEXT  SystemContext
+  )
+{
+  UINT32  Index;
+
+  //
+  // Only the BSP takes this interrupt, so the counters need no lock.
+  //
+  Index = mProfile->SampleCount;
+  if (Index < mProfile->MaxSampleCount) {
+#if defined (MDE_CPU_X64)
+    mProfile->Samples[Index] = SystemContext.SystemContextX64->Rip;
+#else
+    mProfile->Samples[Index] = SystemContext.SystemContextIa32->Eip;
+#endif
+    mProfile->SampleCount = Index + 1;
+  } else {
+    mProfile->DroppedSampleCount++;
+  }
+
+  SendApicEoi ();
+}
+
+/**
+  Get the file name of an image from its PDB path.
+
+  @param[in] ImageBase  The base address of the image.
+
+  @return The file name, or NULL if the image has no PDB path.
+**/
+CONST CHAR8 *
+SamplingProfilerGetImageName (
+  IN VOID  *ImageBase
+  )
+{
+  CHAR8  *PdbFileName;
+  UINTN  StartIndex;
+  UINTN  Index;
+
+  PdbFileName = PeCoffLoaderGetPdbPointer (ImageBase);
+  if (PdbFileName == NULL) {
+    return NULL;
+  }
+
+  StartIndex = 0;
+  for (Index = 0; PdbFileName[Index] != 0; Index++) {
+    if ((PdbFileName[Index] == '\\') || (PdbFileName[Index] == '/')) {
+      StartIndex = Index + 1;
+    }
+  }
+
+  return &PdbFileName[StartIndex];
+}
+
+/**
+  Write a flat profile of the samples taken so far, one line per image
+  sorted by the number of samples, to the debug output.
+
+  @param[in] Event    The ReadyToBoot event.
+  @param[in] Context  Not used.
+**/
+VOID
+EFIAPI
+SamplingProfilerReport (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS                         Status;
+  EFI_DEBUG_IMAGE_INFO_TABLE_HEADER  *DebugImageInfoTableHeader;
+  EFI_DEBUG_IMAGE_INFO               *DebugImageInfo;
+  EFI_LOADED_IMAGE_PROTOCOL          *LoadedImage;
+  SAMPLING_PROFILER_IMAGE_COUNT      *ImageCounts;
+  SAMPLING_PROFILER_IMAGE_COUNT      ImageCount;
+  CONST CHAR8                        *ImageName;
+  UINT32                             SampleCount;
+  UINT32                             UnknownCount;
+  UINT32                             TableSize;
+  UINT32                             Sample;
+  UINT32                             Index;
+  UINT32                             Index2;
+  UINT64                             Address;
+
+  SampleCount = mProfile->SampleCount;
+  DEBUG ((
+    DEBUG_INFO,
+    "SamplingProfiler: %d samples at %d Hz, %d dropped\n",
+    SampleCount,
+    mProfile->SamplingRate,
+    mProfile->DroppedSampleCount
+    ));
+  if (SampleCount == 0) {
+    return;
+  }
+
+  Status = EfiGetSystemConfigurationTable (&gEfiDebugImageInfoTableGuid, (VOID **)&DebugImageInfoTableHeader);
+  if (EFI_ERROR (Status) || (DebugImageInfoTableHeader->EfiDebugImageInfoTable == NULL)) {
+    DEBUG ((DEBUG_ERROR, "SamplingProfiler: no debug image info table - %r\n", Status));
+    return;
+  }
+
+  DebugImageInfo = DebugImageInfoTableHeader->EfiDebugImageInfoTable;
+  TableSize      = DebugImageInfoTableHeader->TableSize;
+  ImageCounts    = AllocateZeroPool (TableSize * sizeof (SAMPLING_PROFILER_IMAGE_COUNT));
+  if (ImageCounts == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < TableSize; Index++) {
+    ImageCounts[Index].TableIndex = Index;
+  }
+
+  //
+  // Images unloaded before now are no longer in the table, so their
+  // samples are reported as unknown.
+  //
+  UnknownCount = 0;
+  for (Sample = 0; Sample < SampleCount; Sample++) {
+    Address = mProfile->Samples[Sample];
+    for (Index = 0; Index < TableSize; Index++) {
+      if ((DebugImageInfo[Index].NormalImage == NULL) ||
+          (DebugImageInfo[Index].NormalImage->ImageInfoType != EFI_DEBUG_IMAGE_INFO_TYPE_NORMAL))
+      {
+        continue;
+      }
+
+      LoadedImage = DebugImageInfo[Index].NormalImage->LoadedImageProtocolInstance;
+      if ((Address >= (UINTN)LoadedImage->ImageBase) &&
+          (Address - (UINTN)LoadedImage->ImageBase < LoadedImage->ImageSize))
+      {
+        ImageCounts[Index].SampleCount++;
+        break;
+      }
+    }
+
+    if (Index == TableSize) {
+      UnknownCount++;
+    }
+  }
+
+  //
+  // Sort the images by the number of samples, most sampled first.
+  //
+  for (Index = 1; Index < TableSize; Index++) {
+    ImageCount = ImageCounts[Index];
+    for (Index2 = Index; Index2 > 0 && ImageCounts[Index2 - 1].SampleCount < ImageCount.SampleCount; Index2--) {
+      ImageCounts[Index2] = ImageCounts[Index2 - 1];
+    }
+
+    ImageCounts[Index2] = ImageCount;
+  }
+
+  for (Index = 0; Index < TableSize && ImageCounts[Index].SampleCount != 0; Index++) {
+    LoadedImage = DebugImageInfo[ImageCounts[Index].TableIndex].NormalImage->LoadedImageProtocolInstance;
+    ImageName   = SamplingProfilerGetImageName (LoadedImage->ImageBase);
+    DEBUG ((
+      DEBUG_INFO,
+      "SamplingProfiler: %8d %3d%% 0x%lx %a\n",
+      ImageCounts[Index].SampleCount,
+      ImageCounts[Index].SampleCount * 100 / SampleCount,
+      (UINT64)(UINTN)LoadedImage->ImageBase,
+      (ImageName != NULL) ? ImageName : "<unknown>"
+      ));
+  }
+
+  if (UnknownCount != 0) {
+    DEBUG ((DEBUG_INFO, "SamplingProfiler: %8d %3d%% outside of loaded images\n", UnknownCount, UnknownCount * 100 / SampleCount));
+  }
+
+  FreePool (ImageCounts);
+}
+
+/**
+  Stop the local APIC timer before the OS takes over the interrupts.
+
+  @param[in] Event    The ExitBootServices event.
+  @param[in] Context  Not used.
+**/
+VOID
+EFIAPI
+SamplingProfilerExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  InitializeApicTimer (0, 0, FALSE, SAMPLING_PROFILER_VECTOR);
+  DisableApicTimerInterrupt ();
+}
+
+/**
+  Entry point of the sampling profiler driver.
+
+  @param[in] ImageHandle  The firmware allocated handle for the EFI image.
+  @param[in] SystemTable  A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS           The profiler is sampling.
+  @retval EFI_UNSUPPORTED       The local APIC timer or the vector is in use.
+  @retval EFI_OUT_OF_RESOURCES  The sample buffer can't be allocated.
+**/
+EFI_STATUS
+EFIAPI
+SamplingProfilerDxeEntryPoint (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   Event;
+
+  if (GetApicTimerInitCount () != 0) {
+    DEBUG ((DEBUG_WARN, "SamplingProfiler: the local APIC timer is already in use\n"));
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = gBS->LocateProtocol (&gEfiCpuArchProtocolGuid, NULL, (VOID **)&mCpu);
+  ASSERT_EFI_ERROR (Status);
+
+  mProfile = AllocateZeroPool (
+               sizeof (EDKII_SAMPLING_PROFILE_TABLE) +
+               SAMPLING_PROFILER_MAX_SAMPLES * sizeof (UINT64)
+               );
+  if (mProfile == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mProfile->Signature      = EDKII_SAMPLING_PROFILE_TABLE_SIGNATURE;
+  mProfile->SamplingRate   = SAMPLING_PROFILER_RATE;
+  mProfile->MaxSampleCount = SAMPLING_PROFILER_MAX_SAMPLES;
+
+  Status = mCpu->RegisterInterruptHandler (mCpu, SAMPLING_PROFILER_VECTOR, SamplingProfilerInterruptHandler);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "SamplingProfiler: vector 0x%x is in use - %r\n", SAMPLING_PROFILER_VECTOR, Status));
+    FreePool (mProfile);
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = gBS->InstallConfigurationTable (&gEdkiiSamplingProfileTableGuid, mProfile);
+  ASSERT_EFI_ERROR (Status);
+
+  Status = EfiCreateEventReadyToBootEx (TPL_CALLBACK, SamplingProfilerReport, NULL, &Event);
+  ASSERT_EFI_ERROR (Status);
+
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  SamplingProfilerExitBootServices,
+                  NULL,
+                  &gEfiEventExitBootServicesGuid,
+                  &Event
+                  );
+  ASSERT_EFI_ERROR (Status);
+
+  //
+  // The timer runs at the platform bus clock with a divide value of 1.
+  //
+  InitializeApicTimer (1, PcdGet32 (PcdFSBClock) / SAMPLING_PROFILER_RATE, TRUE, SAMPLING_PROFILER_VECTOR);
+
+  return EFI_SUCCESS;
+}
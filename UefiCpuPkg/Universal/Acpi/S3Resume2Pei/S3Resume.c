@@ -921,7 +921,7 @@ S3RestoreConfig2 (
   EFI_PHYSICAL_ADDRESS                          TempEfiBootScriptExecutorVariable;
   EFI_PHYSICAL_ADDRESS                          TempAcpiS3Context;
   BOOT_SCRIPT_EXECUTOR_VARIABLE                 *EfiBootScriptExecutorVariable;
-  UINTN                                         VarSize;
+  LOCK_BOX_RESTORE_ENTRY                        LockBoxEntries[4];    // MU_CHANGE - Restore the S3 LockBoxes at once
   EFI_SMRAM_DESCRIPTOR                          *SmramDescriptor;
   SMM_S3_RESUME_STATE                           *SmmS3ResumeState;
   VOID                                          *GuidHob;
@@ -934,39 +934,27 @@ S3RestoreConfig2 (
 
   DEBUG ((DEBUG_INFO, "Enter S3 PEIM\r\n"));
 
-  VarSize = sizeof (EFI_PHYSICAL_ADDRESS);
-  Status = RestoreLockBox (
-             &gEfiAcpiVariableGuid,
-             &TempAcpiS3Context,
-             &VarSize
-             );
-  ASSERT_EFI_ERROR (Status);
-
-  Status = RestoreLockBox (
-             &gEfiAcpiS3ContextGuid,
-             NULL,
-             NULL
-             );
+  // MU_CHANGE [BEGIN] - Restore the S3 LockBoxes at once
+  //
+  // Restore the ACPI S3 context and boot script executor LockBoxes with a
+  // single SMM communication.
+  //
+  ZeroMem (LockBoxEntries, sizeof (LockBoxEntries));
+  LockBoxEntries[0].Guid   = &gEfiAcpiVariableGuid;
+  LockBoxEntries[0].Buffer = &TempAcpiS3Context;
+  LockBoxEntries[0].Length = sizeof (EFI_PHYSICAL_ADDRESS);
+  LockBoxEntries[1].Guid   = &gEfiAcpiS3ContextGuid;
+  LockBoxEntries[2].Guid   = &gEfiBootScriptExecutorVariableGuid;
+  LockBoxEntries[2].Buffer = &TempEfiBootScriptExecutorVariable;
+  LockBoxEntries[2].Length = sizeof (EFI_PHYSICAL_ADDRESS);
+  LockBoxEntries[3].Guid   = &gEfiBootScriptExecutorContextGuid;
+  Status = RestoreMultipleLockBox (LockBoxEntries, ARRAY_SIZE (LockBoxEntries));
   ASSERT_EFI_ERROR (Status);
+  // MU_CHANGE [END]
 
   AcpiS3Context = (ACPI_S3_CONTEXT *)(UINTN)TempAcpiS3Context;
   ASSERT (AcpiS3Context != NULL);
 
-  VarSize   = sizeof (EFI_PHYSICAL_ADDRESS);
-  Status = RestoreLockBox (
-             &gEfiBootScriptExecutorVariableGuid,
-             &TempEfiBootScriptExecutorVariable,
-             &VarSize
-             );
-  ASSERT_EFI_ERROR (Status);
-
-  Status = RestoreLockBox (
-             &gEfiBootScriptExecutorContextGuid,
-             NULL,
-             NULL
-             );
-  ASSERT_EFI_ERROR (Status);
-
   EfiBootScriptExecutorVariable = (BOOT_SCRIPT_EXECUTOR_VARIABLE *) (UINTN) TempEfiBootScriptExecutorVariable;
   ASSERT (EfiBootScriptExecutorVariable != NULL);
 
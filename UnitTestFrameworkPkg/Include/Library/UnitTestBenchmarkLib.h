@@ -0,0 +1,83 @@
+/** @file
+  Provides a micro benchmark service to unit tests.
+
+  A benchmark calls a function repeatedly from within a unit test and reports
+  the time of one call. The number of calls timed together is scaled until
+  each sample lasts long enough for the performance counter, then several
+  samples are taken and summarized. The summary is logged with the unit test
+  log services, so it is part of the unit test report.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef _UNIT_TEST_BENCHMARK_LIB_H_
+#define _UNIT_TEST_BENCHMARK_LIB_H_
+
+#include <Library/UnitTestLib.h>
+
+/**
+  The function to benchmark.
+
+  @param[in]  Context  The context passed to RunBenchmark().
+**/
+typedef
+VOID
+(EFIAPI *UNIT_TEST_BENCHMARK_FUNCTION)(
+  IN UNIT_TEST_CONTEXT  Context
+  );
+
+///
+/// Summary of a benchmark. The times are the times of one call, in
+/// nanoseconds.
+///
+typedef struct {
+  UINT64    Iterations;   ///< Number of calls timed together in each sample.
+  UINT32    SampleCount;  ///< Number of samples taken.
+  UINT64    MinTime;
+  UINT64    MedianTime;
+  UINT64    MeanTime;
+  UINT64    MaxTime;
+  UINT64    StdDevTime;
+} UNIT_TEST_BENCHMARK_RESULT;
+
+/**
+  Benchmark a function from within a unit test.
+
+  The function is called a few times to warm up caches and branch predictors,
+  then the number of calls per sample is doubled until a sample lasts at
+  least one millisecond. The samples are summarized into the minimum, median,
+  mean, maximum and standard deviation of the time of one call, which are
+  logged with UT_LOG_INFO().
+
+  When BaselineTime is not zero, the median is compared with it, so that a
+  unit test can keep the baselines of the functions it measures and fail on
+  a regression.
+
+  @param[in]  Name              Name of the benchmark, used in the log.
+  @param[in]  Function          The function to benchmark.
+  @param[in]  Context           The context passed to Function.
+  @param[in]  BaselineTime      The expected time of one call in nanoseconds,
+                                or 0 for no regression check.
+  @param[in]  TolerancePercent  How much slower than BaselineTime the median
+                                may be, in percent.
+  @param[out] Result            The summary of the benchmark.
+
+  @retval UNIT_TEST_PASSED             The function was benchmarked, and its median
+                                       time is within the tolerance of the baseline.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The median time exceeds the baseline by more
+                                       than TolerancePercent.
+  @retval UNIT_TEST_SKIPPED            No performance counter is available.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RunBenchmark (
+  IN  CONST CHAR8                   *Name,
+  IN  UNIT_TEST_BENCHMARK_FUNCTION  Function,
+  IN  UNIT_TEST_CONTEXT             Context           OPTIONAL,
+  IN  UINT64                        BaselineTime,
+  IN  UINT32                        TolerancePercent,
+  OUT UNIT_TEST_BENCHMARK_RESULT    *Result           OPTIONAL
+  );
+
+#endif
@@ -0,0 +1,124 @@
+/** @file
+  Instance of Timer Library based on POSIX APIs
+
+  Uses POSIX APIs clock_gettime() and nanosleep() for the performance counter
+  and the delays. The performance counter counts nanoseconds.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/TimerLib.h>
+
+#define NANOSECONDS_PER_SECOND  1000000000ULL
+
+/**
+  Stalls the CPU for at least the given number of nanoseconds.
+
+  @param  NanoSeconds The minimum number of nanoseconds to delay.
+
+  @return NanoSeconds
+**/
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN  UINTN  NanoSeconds
+  )
+{
+  struct timespec  Request;
+  struct timespec  Remaining;
+
+  Request.tv_sec  = (time_t)(NanoSeconds / NANOSECONDS_PER_SECOND);
+  Request.tv_nsec = (long)(NanoSeconds % NANOSECONDS_PER_SECOND);
+  while (nanosleep (&Request, &Remaining) != 0) {
+    Request = Remaining;
+  }
+
+  return NanoSeconds;
+}
+
+/**
+  Stalls the CPU for at least the given number of microseconds.
+
+  @param  MicroSeconds  The minimum number of microseconds to delay.
+
+  @return MicroSeconds
+**/
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN  UINTN  MicroSeconds
+  )
+{
+  NanoSecondDelay (MicroSeconds * 1000);
+  return MicroSeconds;
+}
+
+/**
+  Retrieves the current value of a 64-bit free running performance counter.
+
+  @return The current value of the free running performance counter, in
+          nanoseconds of the monotonic clock.
+**/
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  if (clock_gettime (CLOCK_MONOTONIC, &Now) != 0) {
+    return 0;
+  }
+
+  return (UINT64)Now.tv_sec * NANOSECONDS_PER_SECOND + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Retrieves the 64-bit frequency in Hz and the range of performance counter
+  values.
+
+  @param  StartValue  The value the performance counter starts with when it
+                      rolls over.
+  @param  EndValue    The value that the performance counter ends with before
+                      it rolls over.
+
+  @return The frequency in Hz.
+**/
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT      UINT64  *StartValue   OPTIONAL,
+  OUT      UINT64  *EndValue     OPTIONAL
+  )
+{
+  if (StartValue != NULL) {
+    *StartValue = 0;
+  }
+
+  if (EndValue != NULL) {
+    *EndValue = MAX_UINT64;
+  }
+
+  return NANOSECONDS_PER_SECOND;
+}
+
+/**
+  Converts elapsed ticks of performance counter to time in nanoseconds.
+
+  @param  Ticks     The number of elapsed ticks of running performance counter.
+
+  @return The elapsed time in nanoseconds.
+**/
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN      UINT64  Ticks
+  )
+{
+  return Ticks;
+}
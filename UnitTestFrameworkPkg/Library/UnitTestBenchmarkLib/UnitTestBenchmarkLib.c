@@ -0,0 +1,221 @@
+/**
+  Implement UnitTestBenchmarkLib on top of TimerLib.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/TimerLib.h>
+
+#define BENCHMARK_WARMUP_CALLS      8
+#define BENCHMARK_SAMPLE_COUNT      15
+#define BENCHMARK_MIN_SAMPLE_TIME   1000000   // 1 ms, in nanoseconds
+#define BENCHMARK_MAX_ITERATIONS    BIT30
+
+/**
+  Time a number of calls of the benchmarked function.
+
+  @param[in]  Function          The function to benchmark.
+  @param[in]  Context           The context passed to Function.
+  @param[in]  Iterations        The number of calls.
+  @param[in]  CounterCountsUp   TRUE if the performance counter counts up.
+
+  @return The time of all the calls, in nanoseconds.
+**/
+STATIC
+UINT64
+TimeIterations (
+  IN UNIT_TEST_BENCHMARK_FUNCTION  Function,
+  IN UNIT_TEST_CONTEXT             Context,
+  IN UINT64                        Iterations,
+  IN BOOLEAN                       CounterCountsUp
+  )
+{
+  UINT64  Start;
+  UINT64  End;
+  UINT64  Index;
+
+  Start = GetPerformanceCounter ();
+  for (Index = 0; Index < Iterations; Index++) {
+    Function (Context);
+  }
+  End = GetPerformanceCounter ();
+
+  return GetTimeInNanoSecond (CounterCountsUp ? (End - Start) : (Start - End));
+}
+
+/**
+  Get the integer square root of a value.
+
+  @param[in]  Value  The value.
+
+  @return The largest integer whose square is not above Value.
+**/
+STATIC
+UINT64
+SquareRoot64 (
+  IN UINT64  Value
+  )
+{
+  UINT64  Root;
+  UINT64  Next;
+
+  if (Value < 2) {
+    return Value;
+  }
+
+  //
+  // Newton's method, starting above the root.
+  //
+  Root = LShiftU64 (1, (HighBitSet64 (Value) / 2) + 1);
+  Next = RShiftU64 (Root + DivU64x64Remainder (Value, Root, NULL), 1);
+  while (Next < Root) {
+    Root = Next;
+    Next = RShiftU64 (Root + DivU64x64Remainder (Value, Root, NULL), 1);
+  }
+
+  return Root;
+}
+
+/**
+  Benchmark a function from within a unit test.
+
+  The function is called a few times to warm up caches and branch predictors,
+  then the number of calls per sample is doubled until a sample lasts at
+  least one millisecond. The samples are summarized into the minimum, median,
+  mean, maximum and standard deviation of the time of one call, which are
+  logged with UT_LOG_INFO().
+
+  When BaselineTime is not zero, the median is compared with it, so that a
+  unit test can keep the baselines of the functions it measures and fail on
+  a regression.
+
+  @param[in]  Name              Name of the benchmark, used in the log.
+  @param[in]  Function          The function to benchmark.
+  @param[in]  Context           The context passed to Function.
+  @param[in]  BaselineTime      The expected time of one call in nanoseconds,
+                                or 0 for no regression check.
+  @param[in]  TolerancePercent  How much slower than BaselineTime the median
+                                may be, in percent.
+  @param[out] Result            The summary of the benchmark.
+
+  @retval UNIT_TEST_PASSED             The function was benchmarked, and its median
+                                       time is within the tolerance of the baseline.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The median time exceeds the baseline by more
+                                       than TolerancePercent.
+  @retval UNIT_TEST_SKIPPED            No performance counter is available.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RunBenchmark (
+  IN  CONST CHAR8                   *Name,
+  IN  UNIT_TEST_BENCHMARK_FUNCTION  Function,
+  IN  UNIT_TEST_CONTEXT             Context           OPTIONAL,
+  IN  UINT64                        BaselineTime,
+  IN  UINT32                        TolerancePercent,
+  OUT UNIT_TEST_BENCHMARK_RESULT    *Result           OPTIONAL
+  )
+{
+  UNIT_TEST_BENCHMARK_RESULT  Summary;
+  UINT64                      Samples[BENCHMARK_SAMPLE_COUNT];
+  UINT64                      Sample;
+  UINT64                      Total;
+  UINT64                      Variance;
+  UINT64                      Delta;
+  UINT64                      StartValue;
+  UINT64                      EndValue;
+  BOOLEAN                     CounterCountsUp;
+  UINTN                       Index;
+  UINTN                       Index2;
+
+  ASSERT (Name != NULL);
+  ASSERT (Function != NULL);
+
+  if ((GetPerformanceCounterProperties (&StartValue, &EndValue) == 0) || (StartValue == EndValue)) {
+    UT_LOG_WARNING ("%a: no performance counter, benchmark skipped\n", Name);
+    return UNIT_TEST_SKIPPED;
+  }
+
+  CounterCountsUp = (BOOLEAN)(EndValue >= StartValue);
+
+  TimeIterations (Function, Context, BENCHMARK_WARMUP_CALLS, CounterCountsUp);
+
+  //
+  // Scale the calls per sample so that the counter resolution and the
+  // timing overhead don't matter.
+  //
+  Summary.Iterations = 1;
+  while ((TimeIterations (Function, Context, Summary.Iterations, CounterCountsUp) < BENCHMARK_MIN_SAMPLE_TIME) &&
+         (Summary.Iterations < BENCHMARK_MAX_ITERATIONS))
+  {
+    Summary.Iterations = LShiftU64 (Summary.Iterations, 1);
+  }
+
+  //
+  // Take the samples, sorted by insertion.
+  //
+  Total = 0;
+  for (Index = 0; Index < BENCHMARK_SAMPLE_COUNT; Index++) {
+    Sample = DivU64x64Remainder (
+               TimeIterations (Function, Context, Summary.Iterations, CounterCountsUp),
+               Summary.Iterations,
+               NULL
+               );
+    Total += Sample;
+    for (Index2 = Index; Index2 > 0 && Samples[Index2 - 1] > Sample; Index2--) {
+      Samples[Index2] = Samples[Index2 - 1];
+    }
+
+    Samples[Index2] = Sample;
+  }
+
+  Summary.SampleCount = BENCHMARK_SAMPLE_COUNT;
+  Summary.MinTime     = Samples[0];
+  Summary.MedianTime  = Samples[BENCHMARK_SAMPLE_COUNT / 2];
+  Summary.MaxTime     = Samples[BENCHMARK_SAMPLE_COUNT - 1];
+  Summary.MeanTime    = DivU64x32 (Total, BENCHMARK_SAMPLE_COUNT);
+
+  Variance = 0;
+  for (Index = 0; Index < BENCHMARK_SAMPLE_COUNT; Index++) {
+    Delta     = (Samples[Index] > Summary.MeanTime) ? (Samples[Index] - Summary.MeanTime) : (Summary.MeanTime - Samples[Index]);
+    Variance += MultU64x64 (Delta, Delta);
+  }
+
+  Summary.StdDevTime = SquareRoot64 (DivU64x32 (Variance, BENCHMARK_SAMPLE_COUNT));
+
+  UT_LOG_INFO (
+    "%a: %ld calls x %d samples, per call min %ld ns, median %ld ns, mean %ld ns, max %ld ns, stddev %ld ns\n",
+    Name,
+    Summary.Iterations,
+    Summary.SampleCount,
+    Summary.MinTime,
+    Summary.MedianTime,
+    Summary.MeanTime,
+    Summary.MaxTime,
+    Summary.StdDevTime
+    );
+
+  if (Result != NULL) {
+    *Result = Summary;
+  }
+
+  if ((BaselineTime != 0) &&
+      (MultU64x32 (Summary.MedianTime, 100) > MultU64x32 (BaselineTime, 100 + TolerancePercent)))
+  {
+    UT_LOG_ERROR (
+      "%a: median %ld ns is more than %d%% above the baseline of %ld ns\n",
+      Name,
+      Summary.MedianTime,
+      TolerancePercent,
+      BaselineTime
+      );
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  return UNIT_TEST_PASSED;
+}